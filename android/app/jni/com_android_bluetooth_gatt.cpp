@@ -1075,6 +1075,33 @@ class JniScanningCallbacks : ScanningCallbacks {
         rssi, periodic_adv_int, jb.get(), fake_address.get());
   }
 
+  void OnScanResultBatch(int num_results, std::vector<uint8_t> results) {
+    std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
+    CallbackEnv sCallbackEnv(__func__);
+    if (!sCallbackEnv.valid() || !mCallbacksObj) return;
+
+    char empty_address[18] = "00:00:00:00:00:00";
+    ScopedLocalRef<jstring> fake_address(
+        sCallbackEnv.get(), sCallbackEnv->NewStringUTF(empty_address));
+
+    PackedScanResult result;
+    size_t offset = 0;
+    for (int i = 0; i < num_results && result.Unpack(results, offset); i++) {
+      ScopedLocalRef<jstring> address(
+          sCallbackEnv.get(), bdaddr2newjstr(sCallbackEnv.get(), &result.bda));
+      ScopedLocalRef<jbyteArray> jb(
+          sCallbackEnv.get(), sCallbackEnv->NewByteArray(result.adv_data_len));
+      sCallbackEnv->SetByteArrayRegion(jb.get(), 0, result.adv_data_len,
+                                       (jbyte*)result.adv_data);
+
+      sCallbackEnv->CallVoidMethod(
+          mCallbacksObj, method_onScanResult, result.event_type,
+          result.addr_type, address.get(), result.primary_phy,
+          result.secondary_phy, result.advertising_sid, result.tx_power,
+          result.rssi, result.periodic_adv_int, jb.get(), fake_address.get());
+    }
+  }
+
   void OnTrackAdvFoundLost(AdvertisingTrackInfo track_info) {
     std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
     CallbackEnv sCallbackEnv(__func__);
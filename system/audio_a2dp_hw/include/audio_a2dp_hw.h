@@ -85,6 +85,7 @@ typedef enum {
   A2DP_CTRL_GET_OUTPUT_AUDIO_CONFIG,
   A2DP_CTRL_SET_OUTPUT_AUDIO_CONFIG,
   A2DP_CTRL_GET_PRESENTATION_POSITION,
+  A2DP_CTRL_GET_AUDIO_RING,
 } tA2DP_CTRL_CMD;
 
 typedef enum {
@@ -20,6 +20,9 @@
 
 #include <android/binder_manager.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace bluetooth {
 namespace audio {
 namespace aidl {
@@ -428,14 +431,34 @@ void BluetoothAudioClientInterface::FlushAudioData() {
     LOG(WARNING) << __func__ << ", data_mq_ invalid";
     return;
   }
+  // Drop the queued data in place, there is no need to copy it out first
   size_t size = data_mq_->availableToRead();
-  std::vector<MqDataType> buffer(size);
-
-  if (data_mq_->read(buffer.data(), size) != size) {
+  DataMQ::MemTransaction transaction;
+  if (size != 0 && (!data_mq_->beginRead(size, &transaction) ||
+                    !data_mq_->commitRead(size))) {
     LOG(WARNING) << __func__ << ", failed to flush data queue!";
   }
 }
 
+size_t BluetoothAudioClientInterface::ReadFromDataMq(uint8_t* p_buf,
+                                                     size_t len) {
+  // Copy straight out of the one or two regions of the queue's shared memory
+  // that hold the data, then release them with a single commit
+  DataMQ::MemTransaction transaction;
+  if (!data_mq_->beginRead(len, &transaction)) {
+    return 0;
+  }
+  auto first_region = transaction.getFirstRegion();
+  auto second_region = transaction.getSecondRegion();
+  size_t first_length = std::min(first_region.getLength(), len);
+  memcpy(p_buf, first_region.getAddress(), first_length);
+  if (first_length < len) {
+    memcpy(p_buf + first_length, second_region.getAddress(),
+           len - first_length);
+  }
+  return data_mq_->commitRead(len) ? len : 0;
+}
+
 size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
                                                         uint32_t len) {
   if (!IsValid()) {
@@ -456,7 +479,7 @@ size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
       if (avail_to_read > len - total_read) {
         avail_to_read = len - total_read;
       }
-      if (data_mq_->read((MqDataType*)p_buf + total_read, avail_to_read) == 0) {
+      if (ReadFromDataMq(p_buf + total_read, avail_to_read) == 0) {
         LOG(WARNING) << __func__ << ": len=" << len
                      << " total_read=" << total_read << " failed";
         break;
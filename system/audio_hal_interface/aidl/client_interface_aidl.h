@@ -107,6 +107,10 @@ class BluetoothAudioClientInterface {
    ***/
   static void binderDiedCallbackAidl(void* cookie_ptr);
 
+  // Reads |len| bytes, which have to be available, without going through an
+  // intermediate buffer. Returns the number of bytes read.
+  size_t ReadFromDataMq(uint8_t* p_buf, size_t len);
+
   std::shared_ptr<IBluetoothAudioProvider> provider_;
 
   std::shared_ptr<IBluetoothAudioProviderFactory> provider_factory_;
@@ -85,6 +85,7 @@ typedef enum {
   HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG,
   HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG,
   HEARING_AID_CTRL_CMD_OFFLOAD_START,
+  HEARING_AID_CTRL_GET_AUDIO_RING,
 } tHEARING_AID_CTRL_CMD;
 
 typedef enum {
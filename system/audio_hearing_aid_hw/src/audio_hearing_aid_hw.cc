@@ -41,6 +41,7 @@
 #include "osi/include/hash_map_utils.h"
 #include "osi/include/osi.h"
 #include "osi/include/socket_utils/sockets.h"
+#include "udrv/include/uipc_ring.h"
 
 #include "audio_hearing_aid_hw/include/audio_hearing_aid_hw.h"
 
@@ -88,6 +89,7 @@ static const char* audio_ha_hw_dump_ctrl_event(tHEARING_AID_CTRL_CMD event) {
     CASE_RETURN_STR(HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_CMD_OFFLOAD_START)
+    CASE_RETURN_STR(HEARING_AID_CTRL_GET_AUDIO_RING)
     default:
       break;
   }
@@ -134,6 +136,9 @@ struct ha_stream_common {
   std::recursive_mutex* mutex;  // See note below on mutex acquisition order.
   int ctrl_fd;
   int audio_fd;
+  tUIPC_RING* audio_ring;  // Replaces the audio socket for the data if set
+  uint32_t audio_ring_size;
+  bool audio_ring_active;  // False once detached, the ring stays mapped
   size_t buffer_sz;
   struct ha_config cfg;
   ha_state_t state;
@@ -347,6 +352,24 @@ static int skt_write(int fd, const void* p, size_t len) {
   return (int)count;
 }
 
+static int ring_write(tUIPC_RING* ring, uint32_t size, const void* p,
+                      size_t len) {
+  FNLOG();
+
+  ts_log("ring_write", len, NULL);
+
+  ssize_t sent = uipc_ring_write(ring, size, p, len, SOCK_SEND_TIMEOUT_MS);
+  if (sent == -1) {
+    ERROR("write failed: ring closed by the stack");
+    return -1;
+  }
+  if ((size_t)sent < len) {
+    WARN("write timeout exceeded, sent %zd bytes", sent);
+    return -1;
+  }
+  return (int)sent;
+}
+
 static int skt_disconnect(int fd) {
   INFO("fd %d", fd);
 
@@ -807,19 +830,55 @@ static void ha_stream_common_init(struct ha_stream_common* common) {
 
   common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_ring = NULL;
+  common->audio_ring_size = 0;
+  common->audio_ring_active = false;
   common->state = AUDIO_HA_STATE_STOPPED;
 
   /* manages max capacity of socket pipe */
   common->buffer_sz = AUDIO_STREAM_OUTPUT_BUFFER_SZ;
 }
 
+static void ha_unmap_audio_ring(struct ha_stream_common* common) {
+  if (common->audio_ring == NULL) return;
+
+  uipc_ring_unmap(common->audio_ring, common->audio_ring_size);
+  common->audio_ring = NULL;
+  common->audio_ring_size = 0;
+  common->audio_ring_active = false;
+}
+
 static void ha_stream_common_destroy(struct ha_stream_common* common) {
   FNLOG();
 
+  ha_unmap_audio_ring(common);
   delete common->mutex;
   common->mutex = NULL;
 }
 
+// Asks the stack for a shared memory ring to write the output data to,
+// instead of the audio socket. The socket stays connected to track the
+// stream state. A stack without ring support keeps reading the socket.
+// Returns -1 if the ring was sent by the stack but could not be mapped.
+static int ha_open_audio_ring(struct ha_stream_common* common) {
+  ha_unmap_audio_ring(common);
+
+  if (ha_command(common, HEARING_AID_CTRL_GET_AUDIO_RING) < 0) {
+    INFO("audio ring not available, writing to the audio socket");
+    return 0;
+  }
+
+  common->audio_ring =
+      uipc_ring_receive(common->ctrl_fd, &common->audio_ring_size);
+  if (common->audio_ring == NULL) {
+    ERROR("failed to receive the audio ring");
+    return -1;
+  }
+
+  common->audio_ring_active = true;
+  return 0;
+}
+
 static int start_audio_datapath(struct ha_stream_common* common) {
   INFO("state %d", common->state);
 
@@ -871,6 +930,7 @@ static int stop_audio_datapath(struct ha_stream_common* common) {
   /* disconnect audio path */
   skt_disconnect(common->audio_fd);
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_ring_active = false;
 
   return 0;
 }
@@ -892,6 +952,7 @@ static int suspend_audio_datapath(struct ha_stream_common* common,
   skt_disconnect(common->audio_fd);
 
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_ring_active = false;
 
   return 0;
 }
@@ -923,6 +984,12 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
     if (start_audio_datapath(&out->common) < 0) {
       goto finish;
     }
+    if (ha_open_audio_ring(&out->common) < 0) {
+      skt_disconnect(out->common.audio_fd);
+      out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
+      out->common.state = AUDIO_HA_STATE_STOPPED;
+      goto finish;
+    }
   } else if (out->common.state != AUDIO_HA_STATE_STARTED) {
     ERROR("stream not in stopped or standby");
     goto finish;
@@ -942,12 +1009,18 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
   }
 
   lock.unlock();
-  sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+  if (out->common.audio_ring_active) {
+    sent = ring_write(out->common.audio_ring, out->common.audio_ring_size,
+                      buffer, write_bytes);
+  } else {
+    sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+  }
   lock.lock();
 
   if (sent == -1) {
     skt_disconnect(out->common.audio_fd);
     out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
+    out->common.audio_ring_active = false;
     if ((out->common.state != AUDIO_HA_STATE_SUSPENDED) &&
         (out->common.state != AUDIO_HA_STATE_STOPPING)) {
       out->common.state = AUDIO_HA_STATE_STOPPED;
@@ -98,6 +98,12 @@ class HciCaptures(object):
         return Capture(HciMatchers.EventWithCode(hci.EventCode.SIMPLE_PAIRING_COMPLETE),
                        lambda packet: hci.Event.parse_all(packet.payload))
 
+    @staticmethod
+    def LePhyUpdateCompleteCapture():
+        return Capture(
+            HciMatchers.LeEventWithCode(hci.SubeventCode.PHY_UPDATE_COMPLETE),
+            lambda packet: HciMatchers.ExtractLeEventWithCode(packet.payload, hci.SubeventCode.PHY_UPDATE_COMPLETE))
+
 
 class L2capCaptures(object):
 
@@ -14,7 +14,8 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from datetime import datetime
+from datetime import datetime, timedelta
+import math
 
 
 class PerformanceTestLogger(object):
@@ -61,6 +62,42 @@ class PerformanceTestLogger(object):
             intervals.append(interval)
         return intervals
 
+    def get_interval_statistics(self, label):
+        """
+        Return the count, mean, median, 90th percentile and maximum duration in milliseconds of the intervals with
+        specified label.
+        """
+        durations = sorted(interval / timedelta(milliseconds=1) for interval in self.get_duration_of_intervals(label))
+        if not durations:
+            raise KeyError("label %s doesn't have any interval" % label)
+        return {
+            'count': len(durations),
+            'mean_ms': sum(durations) / len(durations),
+            'p50_ms': self._percentile(durations, 50),
+            'p90_ms': self._percentile(durations, 90),
+            'max_ms': durations[-1],
+        }
+
+    def get_throughput(self, label, num_bytes):
+        """
+        Return the throughput in bytes per second of num_bytes transferred during the intervals with specified label.
+        """
+        duration = sum(self.get_duration_of_intervals(label), timedelta())
+        return num_bytes / duration.total_seconds()
+
+    @staticmethod
+    def _percentile(sorted_values, percentile):
+        # Nearest-rank percentile
+        rank = max(1, math.ceil(percentile / 100 * len(sorted_values)))
+        return sorted_values[rank - 1]
+
+    def record_results(self, test, results):
+        """
+        Record the results of the current test of the mobly test class in its summary, where they can be collected
+        to track performance over releases.
+        """
+        test.record_data({'Test Name': test.current_test_info.name, 'sponge_properties': results})
+
     def dump_intervals(self):
         """
         Gives an iterator of (iterator of label, start, end) over all labels
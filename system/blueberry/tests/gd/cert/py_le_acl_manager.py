@@ -63,6 +63,24 @@ class PyLeAclManagerAclConnection(IEventStream, Closable):
         assertThat(self.connection_event_stream).emits(disconnection_complete, timeout=timeout)
         self.disconnect_reason = disconnection_complete.get().reason
 
+    def set_phy(self, tx_phys, rx_phys, timeout=timedelta(seconds=10)):
+        """
+        Request the PHYs of the connection and wait for the controller to complete the PHY update procedure
+        :param tx_phys: Bitmask of the preferred transmitter PHYs, 0x01 for LE 1M, 0x02 for LE 2M, 0x04 for LE Coded
+        :param rx_phys: Bitmask of the preferred receiver PHYs
+        :return: The LE PHY Update Complete event, with the PHYs in use
+        """
+        packet_bytes = hci.LeSetPhy(connection_handle=self.handle,
+                                    all_phys_no_transmit_preference=0,
+                                    all_phys_no_receive_preference=0,
+                                    tx_phys_bitmask=tx_phys,
+                                    rx_phys_bitmask=rx_phys,
+                                    phy_options=hci.PhyOptions.NO_PREFERENCE).serialize()
+        self.le_acl_manager.ConnectionCommand(le_acl_manager_facade.LeConnectionCommandMsg(packet=packet_bytes))
+        phy_update_complete = HciCaptures.LePhyUpdateCompleteCapture()
+        assertThat(self.connection_event_stream).emits(phy_update_complete, timeout=timeout)
+        return phy_update_complete.get()
+
     def send(self, data):
         self.le_acl_manager.SendAclData(le_acl_manager_facade.LeAclData(handle=self.handle, payload=bytes(data)))
 
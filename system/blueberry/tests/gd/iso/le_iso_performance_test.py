@@ -0,0 +1,133 @@
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from datetime import datetime, timedelta
+import time
+
+from blueberry.tests.gd.cert.matchers import IsoMatchers
+from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
+from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.iso.le_iso_test import LeIsoTestBase
+from mobly import test_runner
+
+LE_1M_PHY = 0x01
+LE_2M_PHY = 0x02
+PHY_NAMES = {LE_1M_PHY: '1M', LE_2M_PHY: '2M'}
+
+# 10 ms SDU interval, as used by LC3 for LE audio
+SDU_INTERVAL_US = 10000
+
+
+class LeIsoPerformanceTest(gd_base_test.GdBaseTestClass, LeIsoTestBase):
+    """
+    Delivery of the SDUs sent by the DUT on a CIS, over the PHYs and SDU sizes. The SDUs are sent at the SDU interval,
+    like an audio source does.
+    """
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        LeIsoTestBase.setup_test(self, self.dut, self.cert)
+        self.performance_test_logger = PerformanceTestLogger()
+
+    def teardown_test(self):
+        LeIsoTestBase.teardown_test(self)
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+
+    def _setup_cis(self, phy, sdu_size):
+        self.skip_if_iso_not_supported()
+        self._setup_link_from_cert()
+        return self._setup_cis_from_cert(cig_id=0x01,
+                                         sdu_interval_m_to_s=SDU_INTERVAL_US,
+                                         sdu_interval_s_to_m=SDU_INTERVAL_US,
+                                         peripherals_clock_accuracy=0,
+                                         packing=0,
+                                         framing=0,
+                                         max_transport_latency_m_to_s=20,
+                                         max_transport_latency_s_to_m=20,
+                                         cis_id=0x01,
+                                         max_sdu_m_to_s=sdu_size,
+                                         max_sdu_s_to_m=sdu_size,
+                                         phy_m_to_s=phy,
+                                         phy_s_to_m=phy,
+                                         bn_m_to_s=2,
+                                         bn_s_to_m=2)
+
+    def _cis_tx(self, phy, sdu_size, sdus):
+        (dut_cis_stream, cert_cis_stream) = self._setup_cis(phy, sdu_size)
+        data = b'a' * sdu_size
+        sdu_interval = timedelta(microseconds=SDU_INTERVAL_US)
+        self.performance_test_logger.start_interval("TX")
+        start_time = datetime.now()
+        for i in range(sdus):
+            delay = start_time + i * sdu_interval - datetime.now()
+            if delay > timedelta():
+                time.sleep(delay.total_seconds())
+            dut_cis_stream.send(data)
+        assertThat(cert_cis_stream).emits(IsoMatchers.Data(data), at_least_times=sdus, timeout=timedelta(seconds=60))
+        self.performance_test_logger.end_interval("TX")
+
+        duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
+        self.log.info("Duration: %s" % str(duration))
+        self.performance_test_logger.record_results(
+            self, {
+                'phy': PHY_NAMES[phy],
+                'sdu_size': sdu_size,
+                'sdu_interval_us': SDU_INTERVAL_US,
+                'sdus': sdus,
+                'duration_ms': duration / timedelta(milliseconds=1),
+                'expected_duration_ms': sdus * sdu_interval / timedelta(milliseconds=1),
+                'throughput_bytes_per_second': self.performance_test_logger.get_throughput("TX", sdu_size * sdus),
+            })
+
+    def _cis_tx_latency(self, phy, sdu_size, sdus):
+        (dut_cis_stream, cert_cis_stream) = self._setup_cis(phy, sdu_size)
+        data = b'a' * sdu_size
+        for _ in range(sdus):
+            self.performance_test_logger.start_interval("TX")
+            dut_cis_stream.send(data)
+            assertThat(cert_cis_stream).emits(IsoMatchers.Data(data))
+            self.performance_test_logger.end_interval("TX")
+
+        results = self.performance_test_logger.get_interval_statistics("TX")
+        self.log.info("Latency: %s" % str(results))
+        results.update({'phy': PHY_NAMES[phy], 'sdu_size': sdu_size, 'sdu_interval_us': SDU_INTERVAL_US})
+        self.performance_test_logger.record_results(self, results)
+
+    # 40 and 120 bytes are the 10 ms LC3 frames at 32 and 96 kbps
+    def test_cis_tx_1m_40_500(self):
+        self._cis_tx(LE_1M_PHY, 40, 500)
+
+    def test_cis_tx_2m_40_500(self):
+        self._cis_tx(LE_2M_PHY, 40, 500)
+
+    def test_cis_tx_1m_120_500(self):
+        self._cis_tx(LE_1M_PHY, 120, 500)
+
+    def test_cis_tx_2m_120_500(self):
+        self._cis_tx(LE_2M_PHY, 120, 500)
+
+    def test_cis_tx_latency_1m_40_100(self):
+        self._cis_tx_latency(LE_1M_PHY, 40, 100)
+
+    def test_cis_tx_latency_2m_120_100(self):
+        self._cis_tx_latency(LE_2M_PHY, 120, 100)
+
+
+if __name__ == '__main__':
+    test_runner.main()
@@ -31,13 +31,11 @@ from mobly import test_runner
 import hci_packets as hci
 
 
-class LeIsoTest(gd_base_test.GdBaseTestClass):
+class LeIsoTestBase():
 
-    def setup_class(self):
-        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
-
-    def setup_test(self):
-        gd_base_test.GdBaseTestClass.setup_test(self)
+    def setup_test(self, dut, cert):
+        self.dut = dut
+        self.cert = cert
 
         self.dut_l2cap = PyLeL2cap(self.dut)
         self.cert_l2cap = CertLeL2cap(self.cert)
@@ -69,7 +67,6 @@ class LeIsoTest(gd_base_test.GdBaseTestClass):
 
         self.cert_l2cap.close()
         self.dut_l2cap.close()
-        gd_base_test.GdBaseTestClass.teardown_test(self)
 
     #cert becomes central of connection, dut peripheral
     def _setup_link_from_cert(self):
@@ -113,6 +110,20 @@ class LeIsoTest(gd_base_test.GdBaseTestClass):
         if (not supported.supported):
             asserts.skip("Skipping this test.  The chip doesn't support LE ISO")
 
+
+class LeIsoTest(gd_base_test.GdBaseTestClass, LeIsoTestBase):
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        LeIsoTestBase.setup_test(self, self.dut, self.cert)
+
+    def teardown_test(self):
+        LeIsoTestBase.teardown_test(self)
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+
     @metadata(pts_test_id="IAL/CIS/UNF/SLA/BV-01-C",
               pts_test_name="connected isochronous stream, unframed data, peripheral role")
     def test_iso_cis_unf_sla_bv_01_c(self):
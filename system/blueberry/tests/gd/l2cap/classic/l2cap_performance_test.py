@@ -43,6 +43,18 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         L2capTestBase.teardown_test(self)
         gd_base_test.GdBaseTestClass.teardown_test(self)
 
+    def _record_transfer(self, mode, label, mtu, packets):
+        duration = self.performance_test_logger.get_duration_of_intervals(label)[0]
+        self.performance_test_logger.record_results(
+            self, {
+                'mode': mode,
+                'direction': label,
+                'mtu': mtu,
+                'packets': packets,
+                'duration_ms': duration / timedelta(milliseconds=1),
+                'throughput_bytes_per_second': self.performance_test_logger.get_throughput(label, mtu * packets),
+            })
+
     def _basic_mode_tx(self, mtu, packets):
         """
         Send the specified number of packets and return the time interval in ms.
@@ -56,6 +68,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         assertThat(cert_channel).emits(
             L2capMatchers.Data(b'a' * mtu), at_least_times=packets, timeout=timedelta(seconds=60))
         self.performance_test_logger.end_interval("TX")
+        self._record_transfer('basic', "TX", mtu, packets)
 
         duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
         self.log.info("Duration: %s" % str(duration))
@@ -93,6 +106,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         assertThat(dut_channel).emits(
             L2capMatchers.PacketPayloadRawData(data), at_least_times=packets, timeout=timedelta(seconds=60))
         self.performance_test_logger.end_interval("RX")
+        self._record_transfer('basic', "RX", mtu, packets)
 
         duration = self.performance_test_logger.get_duration_of_intervals("RX")[0]
         self.log.info("Duration: %s" % str(duration))
@@ -122,6 +136,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
                 cert_channel.send_s_frame(req_seq=(i + 1) % 64, s=SupervisoryFunction.RECEIVER_READY)
 
         self.performance_test_logger.end_interval("TX")
+        self._record_transfer('ertm', "TX", mtu, packets)
 
         duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
         self.log.info("Duration: %s" % str(duration))
@@ -150,6 +165,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
             if i % tx_window_size == (tx_window_size - 1):
                 assertThat(cert_channel).emits(L2capMatchers.SFrame(req_seq=(i + 1) % 64))
         self.performance_test_logger.end_interval("RX")
+        self._record_transfer('ertm', "RX", mtu, packets)
 
         duration = self.performance_test_logger.get_duration_of_intervals("RX")[0]
         self.log.info("Duration: %s" % str(duration))
@@ -187,11 +203,13 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         duration = self.performance_test_logger.get_duration_of_intervals("RX")
         mean = sum(duration, timedelta()) / len(duration)
         self.log.info("Mean: %s" % str(mean))
+        self.performance_test_logger.record_results(self, self.performance_test_logger.get_interval_statistics("RX"))
 
     def test_basic_mode_number_of_packets_10_seconds_672(self):
         number_packets = self._basic_mode_tx_fixed_interval(672)
         # Requiring that 500 packets (20ms period on average) are sent
         self.log.info("Packets sent: %d" % number_packets)
+        self.performance_test_logger.record_results(self, {'mode': 'basic', 'mtu': 672, 'packets': number_packets})
         assertThat(number_packets > 500).isTrue()
 
 
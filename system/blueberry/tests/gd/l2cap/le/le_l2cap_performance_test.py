@@ -0,0 +1,187 @@
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from datetime import datetime, timedelta
+import time
+
+from blueberry.tests.gd.cert.matchers import L2capMatchers
+from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
+from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.l2cap.le.le_l2cap_test import LeL2capTestBase
+from bluetooth_packets_python3 import RawBuilder
+from mobly import asserts
+from mobly import test_runner
+import hci_packets as hci
+
+# LE Set PHY preference bits, and the PHY then reported by LE PHY Update Complete
+LE_1M_PHY = 0x01
+LE_2M_PHY = 0x02
+LE_CODED_PHY = 0x04
+PHY_IN_USE = {LE_1M_PHY: 1, LE_2M_PHY: 2, LE_CODED_PHY: 3}
+PHY_NAMES = {LE_1M_PHY: '1M', LE_2M_PHY: '2M', LE_CODED_PHY: 'Coded'}
+
+
+class LeL2capPerformanceTest(gd_base_test.GdBaseTestClass, LeL2capTestBase):
+    """
+    Throughput and latency of LE credit based channels, over the PHYs and SDU sizes. Each SDU is sent in a single
+    LE frame, so the measures are not skewed by the segmentation. The SDUs are at most 249 bytes, for their LE frame
+    to fit the 251 bytes MPS of the DUT.
+    """
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        LeL2capTestBase.setup_test(self, self.dut, self.cert)
+        self.performance_test_logger = PerformanceTestLogger()
+
+    def teardown_test(self):
+        LeL2capTestBase.teardown_test(self)
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+
+    def _setup_link_with_phy(self, phy):
+        """
+        Connect from cert, the central of the link, and switch the link to the specified PHY
+        """
+        self._setup_link_from_cert()
+        phy_update = self.cert_l2cap._le_acl.set_phy(phy, phy)
+        if phy_update.status != hci.ErrorCode.SUCCESS or phy_update.tx_phy != PHY_IN_USE[phy]:
+            asserts.skip("The controllers don't support the LE %s PHY" % PHY_NAMES[phy])
+
+    def _wait_for_credits(self, cert_channel, timeout=timedelta(seconds=10)):
+        """
+        Wait until the DUT gave credits back to cert, they are only counted by the cert control channel callback
+        """
+        deadline = datetime.now() + timeout
+        while cert_channel.credits_left() <= 0:
+            assertThat(datetime.now() < deadline).isTrue()
+            time.sleep(0.001)
+
+    def _record_transfer(self, label, phy, sdu_size, packets):
+        duration = self.performance_test_logger.get_duration_of_intervals(label)[0]
+        self.log.info("Duration: %s" % str(duration))
+        self.performance_test_logger.record_results(
+            self, {
+                'direction': label,
+                'phy': PHY_NAMES[phy],
+                'sdu_size': sdu_size,
+                'packets': packets,
+                'duration_ms': duration / timedelta(milliseconds=1),
+                'throughput_bytes_per_second': self.performance_test_logger.get_throughput(label, sdu_size * packets),
+            })
+
+    def _record_latency(self, label, phy, sdu_size):
+        results = self.performance_test_logger.get_interval_statistics(label)
+        self.log.info("Latency: %s" % str(results))
+        results.update({'direction': label, 'phy': PHY_NAMES[phy], 'sdu_size': sdu_size})
+        self.performance_test_logger.record_results(self, results)
+
+    def _coc_tx(self, phy, sdu_size, packets):
+        self._setup_link_with_phy(phy)
+        # Cert gives credits for the whole transfer upfront, only the link limits the throughput
+        (dut_channel, cert_channel) = self._open_channel_from_cert(mtu=sdu_size,
+                                                                   mps=sdu_size + 2,
+                                                                   initial_credit=packets)
+        data = b'a' * sdu_size
+        self.performance_test_logger.start_interval("TX")
+        for _ in range(packets):
+            dut_channel.send(data)
+        assertThat(cert_channel).emits(
+            L2capMatchers.FirstLeIFrame(data, sdu_size=sdu_size), at_least_times=packets, timeout=timedelta(seconds=60))
+        self.performance_test_logger.end_interval("TX")
+        self._record_transfer("TX", phy, sdu_size, packets)
+
+    def _coc_rx(self, phy, sdu_size, packets):
+        self._setup_link_with_phy(phy)
+        (dut_channel, cert_channel) = self._open_channel_from_cert(mtu=sdu_size, mps=sdu_size + 2)
+        data = b'a' * sdu_size
+        data_packet = RawBuilder([x for x in data])
+        self.performance_test_logger.start_interval("RX")
+        for _ in range(packets):
+            self._wait_for_credits(cert_channel)
+            cert_channel.send_first_le_i_frame(sdu_size, data_packet)
+        assertThat(dut_channel).emits(
+            L2capMatchers.PacketPayloadRawData(data), at_least_times=packets, timeout=timedelta(seconds=60))
+        self.performance_test_logger.end_interval("RX")
+        self._record_transfer("RX", phy, sdu_size, packets)
+
+    def _coc_tx_latency(self, phy, sdu_size, packets):
+        self._setup_link_with_phy(phy)
+        (dut_channel, cert_channel) = self._open_channel_from_cert(mtu=sdu_size,
+                                                                   mps=sdu_size + 2,
+                                                                   initial_credit=packets)
+        data = b'a' * sdu_size
+        for _ in range(packets):
+            self.performance_test_logger.start_interval("TX")
+            dut_channel.send(data)
+            assertThat(cert_channel).emits(L2capMatchers.FirstLeIFrame(data, sdu_size=sdu_size))
+            self.performance_test_logger.end_interval("TX")
+        self._record_latency("TX", phy, sdu_size)
+
+    def _coc_rx_latency(self, phy, sdu_size, packets):
+        self._setup_link_with_phy(phy)
+        (dut_channel, cert_channel) = self._open_channel_from_cert(mtu=sdu_size, mps=sdu_size + 2)
+        data = b'a' * sdu_size
+        data_packet = RawBuilder([x for x in data])
+        for _ in range(packets):
+            self._wait_for_credits(cert_channel)
+            self.performance_test_logger.start_interval("RX")
+            cert_channel.send_first_le_i_frame(sdu_size, data_packet)
+            assertThat(dut_channel).emits(L2capMatchers.PacketPayloadRawData(data))
+            self.performance_test_logger.end_interval("RX")
+        self._record_latency("RX", phy, sdu_size)
+
+    def test_coc_tx_1m_23_500(self):
+        self._coc_tx(LE_1M_PHY, 23, 500)
+
+    def test_coc_tx_2m_23_500(self):
+        self._coc_tx(LE_2M_PHY, 23, 500)
+
+    # 245 byte SDUs fill a 251 byte LL PDU with their L2CAP header and SDU length
+    def test_coc_tx_1m_245_500(self):
+        self._coc_tx(LE_1M_PHY, 245, 500)
+
+    def test_coc_tx_2m_245_500(self):
+        self._coc_tx(LE_2M_PHY, 245, 500)
+
+    def test_coc_tx_coded_245_100(self):
+        self._coc_tx(LE_CODED_PHY, 245, 100)
+
+    def test_coc_rx_1m_245_500(self):
+        self._coc_rx(LE_1M_PHY, 245, 500)
+
+    def test_coc_rx_2m_245_500(self):
+        self._coc_rx(LE_2M_PHY, 245, 500)
+
+    def test_coc_rx_coded_245_100(self):
+        self._coc_rx(LE_CODED_PHY, 245, 100)
+
+    def test_coc_tx_latency_1m_100(self):
+        self._coc_tx_latency(LE_1M_PHY, 100, 100)
+
+    def test_coc_tx_latency_2m_100(self):
+        self._coc_tx_latency(LE_2M_PHY, 100, 100)
+
+    def test_coc_rx_latency_1m_100(self):
+        self._coc_rx_latency(LE_1M_PHY, 100, 100)
+
+    def test_coc_rx_latency_2m_100(self):
+        self._coc_rx_latency(LE_2M_PHY, 100, 100)
+
+
+if __name__ == '__main__':
+    test_runner.main()
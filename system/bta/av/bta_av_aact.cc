@@ -30,6 +30,8 @@
 
 #include <cstdint>
 #include <cstring>
+#include <list>
+#include <map>
 #include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -60,6 +62,11 @@ namespace {
 
 constexpr char kBtmLogTag[] = "A2DP";
 
+/* set to false for peers that misbehave when the stream is configured without
+ * a fresh Get (All) Capabilities */
+constexpr char kPeerCapsCacheProperty[] =
+    "persist.bluetooth.a2dp.peer_caps_cache";
+
 }
 
 /*****************************************************************************
@@ -86,6 +93,12 @@ constexpr char kBtmLogTag[] = "A2DP";
 /* ACL quota we are letting FW use for A2DP Offload Tx. */
 #define BTA_AV_A2DP_OFFLOAD_XMIT_QUOTA 4
 
+/* number of peers whose stream end point capabilities are kept across
+ * connections */
+#ifndef BTA_AV_CAPS_CACHE_SIZE
+#define BTA_AV_CAPS_CACHE_SIZE 16
+#endif
+
 static void bta_av_offload_codec_builder(tBTA_AV_SCB* p_scb,
                                          tBT_A2DP_OFFLOAD* p_a2dp_offload);
 
@@ -289,6 +302,160 @@ void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
   }
 }
 
+/* The capabilities of the stream end points of recently connected peers,
+ * most recently used first. They are reused on reconnection, as long as the
+ * peer reports the same stream end points, instead of asking for them again
+ * one Get (All) Capabilities round trip at a time. */
+namespace {
+struct tBTA_AV_PEER_CAPS {
+  RawAddress peer_address;
+  std::vector<tAVDT_SEP_INFO> seps;
+  bool get_all_cap;
+  std::map<uint8_t, AvdtpSepConfig> caps; /* indexed by SEID */
+};
+
+std::list<tBTA_AV_PEER_CAPS> bta_av_peer_caps;
+
+std::list<tBTA_AV_PEER_CAPS>::iterator bta_av_find_peer_caps(
+    const RawAddress& peer_address) {
+  for (auto it = bta_av_peer_caps.begin(); it != bta_av_peer_caps.end();
+       it++) {
+    if (it->peer_address == peer_address) return it;
+  }
+  return bta_av_peer_caps.end();
+}
+
+bool bta_av_same_seps(const std::vector<tAVDT_SEP_INFO>& seps,
+                      const tAVDT_SEP_INFO* sep_info, uint8_t num_seps) {
+  if (seps.size() != num_seps) return false;
+  for (uint8_t i = 0; i < num_seps; i++) {
+    /* in_use changes with the streams the peer has open, the capabilities
+     * don't */
+    if (seps[i].seid != sep_info[i].seid ||
+        seps[i].media_type != sep_info[i].media_type ||
+        seps[i].tsep != sep_info[i].tsep)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_update_seps
+ *
+ * Description      Record the stream end points the peer reported in its
+ *                  discover response. The cached capabilities are dropped if
+ *                  they differ from the ones of the previous connection.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_update_seps(const RawAddress& peer_address,
+                                   const tAVDT_SEP_INFO* sep_info,
+                                   uint8_t num_seps) {
+  auto it = bta_av_find_peer_caps(peer_address);
+  if (it == bta_av_peer_caps.end()) {
+    tBTA_AV_PEER_CAPS entry;
+    entry.peer_address = peer_address;
+    entry.get_all_cap = false;
+    bta_av_peer_caps.push_front(entry);
+    if (bta_av_peer_caps.size() > BTA_AV_CAPS_CACHE_SIZE)
+      bta_av_peer_caps.pop_back();
+  } else {
+    bta_av_peer_caps.splice(bta_av_peer_caps.begin(), bta_av_peer_caps, it);
+  }
+
+  tBTA_AV_PEER_CAPS& entry = bta_av_peer_caps.front();
+  if (!bta_av_same_seps(entry.seps, sep_info, num_seps)) {
+    if (!entry.caps.empty()) {
+      LOG_INFO("%s: stream end points of peer %s changed", __func__,
+               ADDRESS_TO_LOGGABLE_CSTR(peer_address));
+    }
+    entry.seps.assign(sep_info, sep_info + num_seps);
+    entry.caps.clear();
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_get
+ *
+ * Description      Copy the cached capabilities of the stream end point seid
+ *                  of the peer to p_cap.
+ *
+ * Returns          true if they were cached, false otherwise.
+ *
+ ******************************************************************************/
+bool bta_av_caps_cache_get(const RawAddress& peer_address, uint8_t seid,
+                           bool get_all_cap, AvdtpSepConfig* p_cap) {
+  auto it = bta_av_find_peer_caps(peer_address);
+  if (it == bta_av_peer_caps.end() || it->get_all_cap != get_all_cap)
+    return false;
+  auto caps = it->caps.find(seid);
+  if (caps == it->caps.end()) return false;
+  *p_cap = caps->second;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_put
+ *
+ * Description      Cache the capabilities of the stream end point seid of the
+ *                  peer, whose stream end points were recorded by
+ *                  bta_av_caps_cache_update_seps.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_put(const RawAddress& peer_address, uint8_t seid,
+                           bool get_all_cap, const AvdtpSepConfig& cap) {
+  auto it = bta_av_find_peer_caps(peer_address);
+  if (it == bta_av_peer_caps.end()) return;
+  if (it->get_all_cap != get_all_cap) {
+    it->get_all_cap = get_all_cap;
+    it->caps.clear();
+  }
+  it->caps[seid] = cap;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_remove
+ *
+ * Description      Forget the cached capabilities of the peer.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_remove(const RawAddress& peer_address) {
+  auto it = bta_av_find_peer_caps(peer_address);
+  if (it != bta_av_peer_caps.end()) bta_av_peer_caps.erase(it);
+}
+
+static bool bta_av_get_all_cap(tBTA_AV_SCB* p_scb) {
+  return (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
+         (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_save_getcap_result
+ *
+ * Description      Cache the capabilities in a get capabilities confirm, so
+ *                  that they are not requested again on reconnection.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_save_getcap_result(tBTA_AV_SCB* p_scb) {
+  if (p_scb->sep_info_idx >= p_scb->num_seps) return;
+  bta_av_caps_cache_put(p_scb->PeerAddress(),
+                        p_scb->sep_info[p_scb->sep_info_idx].seid,
+                        bta_av_get_all_cap(p_scb), p_scb->peer_cap);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_next_getcap
@@ -318,10 +485,25 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
       p_scb->sep_info_idx = i;
 
       /* we got a stream; get its capabilities */
-      bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
-                         (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
-      AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info[i].seid,
-                     &p_scb->peer_cap, &bta_av_proc_stream_evt, get_all_cap);
+      bool get_all_cap = bta_av_get_all_cap(p_scb);
+      if (osi_property_get_bool(kPeerCapsCacheProperty, true) &&
+          bta_av_caps_cache_get(p_scb->PeerAddress(), p_scb->sep_info[i].seid,
+                                get_all_cap, &p_scb->peer_cap)) {
+        /* answer with the capabilities of the previous connection, through
+         * the event queue like the confirm from AVDT would */
+        APPL_TRACE_DEBUG("%s: peer %s seid %d: cached capabilities", __func__,
+                         ADDRESS_TO_LOGGABLE_CSTR(p_scb->PeerAddress()),
+                         p_scb->sep_info[i].seid);
+        tAVDT_CTRL avdt_ctrl;
+        avdt_ctrl.getcap_cfm.hdr = {};
+        avdt_ctrl.getcap_cfm.p_cfg = &p_scb->peer_cap;
+        bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_GETCAP_CFM_EVT,
+                               &avdt_ctrl, p_scb->hdi);
+      } else {
+        AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi,
+                       p_scb->sep_info[i].seid, &p_scb->peer_cap,
+                       &bta_av_proc_stream_evt, get_all_cap);
+      }
       sent_cmd = true;
       break;
     }
@@ -1445,6 +1627,8 @@ void bta_av_disc_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_caps_cache_update_seps(p_scb->PeerAddress(), p_scb->sep_info,
+                                p_scb->num_seps);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam not in use, is a sink, and is audio */
@@ -1500,6 +1684,8 @@ void bta_av_disc_res_as_acp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_caps_cache_update_seps(p_scb->PeerAddress(), p_scb->sep_info,
+                                p_scb->num_seps);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam is a sink, and is audio */
@@ -1552,6 +1738,7 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_DEBUG("%s: codec: %s", __func__,
                    A2DP_CodecInfoString(p_scb->peer_cap.codec_info).c_str());
 
+  bta_av_save_getcap_result(p_scb);
   cfg = p_scb->peer_cap;
   /* let application know the capability of the SNK */
   if (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1635,6 +1822,8 @@ void bta_av_open_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_ERROR("%s: peer_addr=%s", __func__,
                    ADDRESS_TO_LOGGABLE_CSTR(p_scb->PeerAddress()));
   p_scb->open_status = BTA_AV_FAIL_STREAM;
+  /* the cached capabilities may be why the stream could not be opened */
+  bta_av_caps_cache_remove(p_scb->PeerAddress());
   bta_av_cco_close(p_scb, p_data);
 
   /* check whether there is already an opened audio or video connection with the
@@ -1697,6 +1886,8 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   uint8_t media_type = A2DP_GetMediaType(p_scb->peer_cap.codec_info);
   tAVDT_SEP_INFO* p_info = &p_scb->sep_info[p_scb->sep_info_idx];
 
+  bta_av_save_getcap_result(p_scb);
+
   cfg.num_codec = 1;
   cfg.num_protect = p_scb->peer_cap.num_protect;
   memcpy(cfg.codec_info, p_scb->peer_cap.codec_info, AVDT_CODEC_SIZE);
@@ -768,6 +768,16 @@ void bta_av_proc_stream_evt(uint8_t handle, const RawAddress& bd_addr,
                             uint8_t event, tAVDT_CTRL* p_data,
                             uint8_t scb_index);
 
+/* stream end point capabilities of recently connected peers */
+void bta_av_caps_cache_update_seps(const RawAddress& peer_address,
+                                   const tAVDT_SEP_INFO* sep_info,
+                                   uint8_t num_seps);
+bool bta_av_caps_cache_get(const RawAddress& peer_address, uint8_t seid,
+                           bool get_all_cap, AvdtpSepConfig* p_cap);
+void bta_av_caps_cache_put(const RawAddress& peer_address, uint8_t seid,
+                           bool get_all_cap, const AvdtpSepConfig& cap);
+void bta_av_caps_cache_remove(const RawAddress& peer_address);
+
 /* ssm action functions */
 void bta_av_do_disc_a2dp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_cleanup(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
@@ -877,6 +877,24 @@ TEST_F(CsisClientTest, test_get_set_sirk) {
   ASSERT_EQ(g_1->GetSirk(), sirk);
 }
 
+TEST_F(CsisClientTest, test_rsi_match_follows_sirk_update) {
+  auto g_1 = std::make_shared<CsisGroup>(666, bluetooth::Uuid::kEmpty);
+  Octet16 sirk = {1};
+  g_1->SetSirk(sirk);
+
+  uint8_t prand[3] = {0x12, 0x34, 0x56};
+  Octet16 hash = crypto_toolbox::aes_128(sirk, prand, 3);
+  RawAddress rsi({prand[2], prand[1], prand[0], hash[2], hash[1], hash[0]});
+
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+  // Served from the cache
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+
+  Octet16 other_sirk = {2};
+  g_1->SetSirk(other_sirk);
+  ASSERT_FALSE(g_1->IsRsiMatching(rsi));
+}
+
 class CsisMultiClientTest : public CsisClientTest {
  protected:
   const RawAddress test_address_1 = GetTestAddress(1);
@@ -67,6 +67,7 @@ struct hdl_pair {
 static constexpr uint8_t kDefaultScanDurationS = 5;
 static constexpr uint8_t kDefaultCsisSetSize = 1;
 static constexpr uint8_t kUnknownRank = 0xff;
+static constexpr size_t kRsiMatchCacheSize = 64;
 
 /* Enums */
 enum class CsisLockState : uint8_t {
@@ -326,7 +327,17 @@ class CsisGroup {
         find_if(devices_.begin(), devices_.end(), CsisDevice::MatchAddress(csis_device->addr));
     return (it != devices_.end());
   }
-  bool IsRsiMatching(const RawAddress& rsi) const { return is_rsi_match_sirk(rsi, GetSirk()); }
+  /* Advertisers repeat the same RSI in every advertisement, so the result of
+   * resolving it against the SIRK is cached until the SIRK changes. */
+  bool IsRsiMatching(const RawAddress& rsi) const {
+    auto it = rsi_match_cache_.find(rsi);
+    if (it != rsi_match_cache_.end()) return it->second;
+
+    bool match = is_rsi_match_sirk(rsi, GetSirk());
+    if (rsi_match_cache_.size() >= kRsiMatchCacheSize) rsi_match_cache_.clear();
+    rsi_match_cache_[rsi] = match;
+    return match;
+  }
   bool IsSirkBelongsToGroup(Octet16 sirk) const { return (sirk_available_ && sirk_ == sirk); }
   Octet16 GetSirk(void) const { return sirk_; }
   void SetSirk(Octet16& sirk) {
@@ -335,6 +346,7 @@ class CsisGroup {
     }
     sirk_available_ = true;
     sirk_ = sirk;
+    rsi_match_cache_.clear();
   }
 
   int GetNumOfConnectedDevices(void) {
@@ -486,6 +498,7 @@ class CsisGroup {
   int group_id_;
   Octet16 sirk_ = {0};
   bool sirk_available_ = false;
+  mutable std::map<RawAddress, bool> rsi_match_cache_;
   int size_;
   bluetooth::Uuid uuid_;
 
@@ -28,11 +28,13 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_gatt_api.h"
 #include "bta/sys/bta_sys.h"
+#include "gd/common/circular_buffer.h"
 #include "main/shim/dumpsys.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_octets.h"
@@ -267,6 +269,7 @@ struct tBTA_DM_PEER_DEVICE {
   tBTM_PM_STATUS prev_low; /* previous low power mode used */
   tBTA_DM_PM_ACTION pm_mode_attempted;
   tBTA_DM_PM_ACTION pm_mode_failed;
+  uint8_t pm_sniff_deferrals; /* sniff attempts postponed by ongoing traffic */
   bool remove_dev_pending;
   tBT_TRANSPORT transport;
 };
@@ -326,6 +329,25 @@ typedef struct {
 
 extern tBTA_DM_CONNECTED_SRVCS bta_dm_conn_srvcs;
 
+/* Power mode transitions and adaptive decisions, with the idle gap statistics
+ * of the link at that time */
+struct tBTA_DM_PM_HISTORY {
+  RawAddress peer_bdaddr;
+  std::string event;
+  uint32_t idle_gap_ms;
+  uint32_t idle_gap_var_ms;
+  uint32_t num_idle_gaps;
+
+  std::string ToString() const {
+    return base::StringPrintf("peer:%s idle_gap:%ums+-%ums(%u) %s",
+                              ADDRESS_TO_LOGGABLE_CSTR(peer_bdaddr),
+                              idle_gap_ms, idle_gap_var_ms, num_idle_gaps,
+                              event.c_str());
+  }
+};
+std::vector<bluetooth::common::TimestampedEntry<tBTA_DM_PM_HISTORY>>
+bta_dm_pm_history();
+
 #define BTA_DM_NUM_PM_TIMER 7
 
 /* DM control block */
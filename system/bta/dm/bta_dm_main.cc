@@ -241,5 +241,11 @@ void DumpsysBtaDm(int fd) {
   }
   LOG_DUMPSYS(fd, " current bta_dm_search_state:%s",
               bta_dm_state_text(bta_dm_search_get_state()).c_str());
+  auto pm_history = bta_dm_pm_history();
+  LOG_DUMPSYS(fd, " last %zu power mode events", pm_history.size());
+  for (const auto& it : pm_history) {
+    LOG_DUMPSYS(fd, "   %s %s", EpochMillisToString(it.timestamp).c_str(),
+                it.entry.ToString().c_str());
+  }
 }
 #undef DUMPSYS_TAG
@@ -25,8 +25,10 @@
 
 #include <base/functional/bind.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "bta/dm/bta_dm_int.h"
@@ -35,6 +37,7 @@
 #include "bta/sys/bta_sys.h"
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/log.h"
@@ -77,6 +80,149 @@ static const char kPropertySniffAttempts[] =
     "bluetooth.core.classic.sniff_attempts";
 static const char kPropertySniffTimeouts[] =
     "bluetooth.core.classic.sniff_timeouts";
+/* Sysprop enabling the sniff adjustments driven by the ACL traffic */
+static const char kPropertySniffAdaptive[] =
+    "bluetooth.core.classic.sniff_adaptive";
+
+namespace {
+constexpr size_t kPmHistorySize = 50;
+/* Idle gaps to observe on a link before trusting its predicted idle time */
+constexpr uint32_t kAdaptiveMinIdleGaps = 4;
+/* A link with traffic this recent is in the middle of a burst */
+constexpr uint64_t kAdaptiveBurstQuietMs = 2 * ACL_TRAFFIC_MIN_IDLE_GAP_MS;
+constexpr uint8_t kAdaptiveMaxSniffDeferrals = 5;
+constexpr uint64_t kAdaptiveMinSniffTimeoutMs = 1000;
+}  // namespace
+
+static bluetooth::common::TimestampedCircularBuffer<tBTA_DM_PM_HISTORY>
+    pm_history_(kPmHistorySize);
+
+std::vector<bluetooth::common::TimestampedEntry<tBTA_DM_PM_HISTORY>>
+bta_dm_pm_history() {
+  return pm_history_.Pull();
+}
+
+static void bta_dm_pm_record(const RawAddress& peer_addr,
+                             const tACL_TRAFFIC_STATS& stats,
+                             std::string event) {
+  pm_history_.Push({
+      .peer_bdaddr = peer_addr,
+      .event = std::move(event),
+      .idle_gap_ms = stats.idle_gap_ms,
+      .idle_gap_var_ms = stats.idle_gap_var_ms,
+      .num_idle_gaps = stats.num_idle_gaps,
+  });
+}
+
+static bool bta_dm_pm_is_adaptive() {
+  static const bool adaptive =
+      osi_property_get_bool(kPropertySniffAdaptive, true);
+  return adaptive;
+}
+
+/* Idle time the link can be expected to have before its next burst of
+ * traffic: the smoothed idle gap minus twice its deviation, like the
+ * conservative side of an RFC 6298 estimate. 0 if it can't be predicted. */
+static uint64_t bta_dm_pm_predicted_idle_ms(const tACL_TRAFFIC_STATS& stats) {
+  if (stats.num_idle_gaps < kAdaptiveMinIdleGaps) return 0;
+  uint64_t margin_ms = 2 * static_cast<uint64_t>(stats.idle_gap_var_ms);
+  return stats.idle_gap_ms > margin_ms ? stats.idle_gap_ms - margin_ms : 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_adapt_sniff_timeout
+ *
+ * Description      Shortens the idle timeout before sniff of a link whose
+ *                  bursts of traffic are followed by idle periods much longer
+ *                  than the timeout, so that it spends less of them active.
+ *
+ * Returns          timeout to use in ms
+ *
+ ******************************************************************************/
+static uint64_t bta_dm_pm_adapt_sniff_timeout(const RawAddress& peer_addr,
+                                              uint64_t timeout_ms) {
+  tACL_TRAFFIC_STATS stats;
+  if (!bta_dm_pm_is_adaptive() || !acl_get_traffic_stats(peer_addr, &stats)) {
+    return timeout_ms;
+  }
+  if (bta_dm_pm_predicted_idle_ms(stats) < 2 * timeout_ms) return timeout_ms;
+
+  uint64_t adapted_ms = std::max(timeout_ms / 2, kAdaptiveMinSniffTimeoutMs);
+  if (adapted_ms >= timeout_ms) return timeout_ms;
+  bta_dm_pm_record(peer_addr, stats,
+                   base::StringPrintf("sniff timeout %llums => %llums",
+                                      (unsigned long long)timeout_ms,
+                                      (unsigned long long)adapted_ms));
+  return adapted_ms;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_defer_sniff
+ *
+ * Description      Checks if sniff should be postponed when its timer expires
+ *                  because the link is in the middle of a burst of traffic,
+ *                  which would have it exit sniff again right away.
+ *
+ * Returns          true if sniff should be attempted again later
+ *
+ ******************************************************************************/
+static bool bta_dm_pm_defer_sniff(tBTA_DM_PEER_DEVICE* p_peer_dev) {
+  tACL_TRAFFIC_STATS stats;
+  if (!bta_dm_pm_is_adaptive() ||
+      !acl_get_traffic_stats(p_peer_dev->peer_bdaddr, &stats) ||
+      stats.last_packet_ms == 0) {
+    return false;
+  }
+  uint64_t since_ms =
+      bluetooth::common::time_get_os_boottime_ms() - stats.last_packet_ms;
+  if (since_ms >= kAdaptiveBurstQuietMs ||
+      p_peer_dev->pm_sniff_deferrals >= kAdaptiveMaxSniffDeferrals) {
+    return false;
+  }
+  p_peer_dev->pm_sniff_deferrals++;
+  bta_dm_pm_record(
+      p_peer_dev->peer_bdaddr, stats,
+      base::StringPrintf("sniff deferred %hhu/%hhu, traffic %llums ago",
+                         p_peer_dev->pm_sniff_deferrals,
+                         kAdaptiveMaxSniffDeferrals,
+                         (unsigned long long)since_ms));
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_adapt_interval
+ *
+ * Description      Caps a sniff interval or subrating latency, in slots, to
+ *                  the predicted idle time of the link. A longer one saves
+ *                  nothing as traffic wakes the link up before it elapses,
+ *                  but adds up to its length to the latency of that traffic.
+ *
+ * Returns          interval to use in slots, never below |min_slots|
+ *
+ ******************************************************************************/
+static uint16_t bta_dm_pm_adapt_interval(const RawAddress& peer_addr,
+                                         const char* name, uint16_t slots,
+                                         uint16_t min_slots) {
+  tACL_TRAFFIC_STATS stats;
+  if (!bta_dm_pm_is_adaptive() || !acl_get_traffic_stats(peer_addr, &stats)) {
+    return slots;
+  }
+  uint64_t idle_ms = bta_dm_pm_predicted_idle_ms(stats);
+  if (idle_ms == 0) return slots;
+
+  /* 0.625ms slots, intervals have to be even */
+  uint64_t idle_slots = (idle_ms * 8 / 5) & ~1ull;
+  uint16_t adapted =
+      static_cast<uint16_t>(std::max<uint64_t>(idle_slots, min_slots));
+  if (adapted >= slots) return slots;
+  bta_dm_pm_record(
+      peer_addr, stats,
+      base::StringPrintf("%s %hu => %hu slots", name, slots, adapted));
+  return adapted;
+}
 
 /*******************************************************************************
  *
@@ -462,6 +608,7 @@ static void bta_dm_pm_cback(tBTA_SYS_CONN_STATUS status, uint8_t id,
   if (p_dev) {
     p_dev->pm_mode_attempted = 0;
     p_dev->pm_mode_failed = 0;
+    p_dev->pm_sniff_deferrals = 0;
   }
 
   if (p_bta_dm_ssr_spec[index].max_lat || index == BTA_DM_PM_SSR_HH) {
@@ -601,6 +748,17 @@ static void bta_dm_pm_set_mode(const RawAddress& peer_addr,
       }
     }
   }
+  if (pm_action & BTA_DM_PM_SNIFF) {
+    if (pm_req != BTA_DM_PM_EXECUTE && timeout_ms > 0) {
+      timeout_ms = bta_dm_pm_adapt_sniff_timeout(peer_addr, timeout_ms);
+    } else if (pm_req == BTA_DM_PM_EXECUTE && pm_request >= pm_action &&
+               bta_dm_pm_defer_sniff(p_peer_device)) {
+      /* try again once the ongoing burst of traffic is over */
+      pm_req = BTA_DM_PM_RESTART;
+      timeout_ms = kAdaptiveBurstQuietMs;
+    }
+  }
+
   /* if need to start a timer */
   if ((pm_req != BTA_DM_PM_EXECUTE) && (timeout_ms > 0)) {
     for (i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
@@ -805,6 +963,8 @@ void bta_dm_pm_sniff(tBTA_DM_PEER_DEVICE* p_peer_dev, uint8_t index) {
    * If sniff, but SSR is not used in this link, still issue the command */
   tBTM_PM_PWR_MD sniff_entry = get_sniff_entry(index);
   memcpy(&pwr_md, &sniff_entry, sizeof(tBTM_PM_PWR_MD));
+  pwr_md.max = bta_dm_pm_adapt_interval(
+      p_peer_dev->peer_bdaddr, "sniff max interval", pwr_md.max, pwr_md.min);
   if (p_peer_dev->Info() & BTA_DM_DI_INT_SNIFF) {
     LOG_DEBUG("Trying to force power mode");
     pwr_md.mode |= BTM_PM_MD_FORCE;
@@ -894,14 +1054,16 @@ static void bta_dm_pm_ssr(const RawAddress& peer_addr, const int ssr) {
       }
     }
 
+    uint16_t max_lat = bta_dm_pm_adapt_interval(
+        peer_addr, "subrating max latency", p_spec->max_lat, 2);
     LOG_DEBUG(
         "Setting sniff subrating for device:%s spec_name:%s max_latency(s):%.2f"
         " min_local_timeout(s):%.2f min_remote_timeout(s):%.2f",
         ADDRESS_TO_LOGGABLE_CSTR(peer_addr), p_spec->name,
-        ticks_to_seconds(p_spec->max_lat), ticks_to_seconds(p_spec->min_loc_to),
+        ticks_to_seconds(max_lat), ticks_to_seconds(p_spec->min_loc_to),
         ticks_to_seconds(p_spec->min_rmt_to));
     /* set the SSR parameters. */
-    BTM_SetSsrParams(peer_addr, p_spec->max_lat, p_spec->min_rmt_to,
+    BTM_SetSsrParams(peer_addr, max_lat, p_spec->min_rmt_to,
                      p_spec->min_loc_to);
   }
 }
@@ -1008,6 +1170,14 @@ void bta_dm_pm_btm_status(const RawAddress& bd_addr, tBTM_PM_STATUS status,
     return;
   }
 
+  tACL_TRAFFIC_STATS stats{};
+  acl_get_traffic_stats(bd_addr, &stats);
+  bta_dm_pm_record(
+      bd_addr, stats,
+      base::StringPrintf("%s interval:%hu hci_status:%s",
+                         power_mode_status_text(status).c_str(), interval,
+                         hci_error_code_text(hci_status).c_str()));
+
   tBTA_DM_DEV_INFO info = p_dev->Info();
   /* check new mode */
   switch (status) {
@@ -1069,6 +1239,7 @@ void bta_dm_pm_btm_status(const RawAddress& bd_addr, tBTM_PM_STATUS status,
          * in sniff mode from host side.
          */
         bta_dm_pm_stop_timer(bd_addr);
+        p_dev->pm_sniff_deferrals = 0;
       } else {
         p_dev->info &=
             ~(BTA_DM_DI_SET_SNIFF | BTA_DM_DI_INT_SNIFF | BTA_DM_DI_ACP_SNIFF);
@@ -1157,3 +1328,25 @@ tBTM_CONTRL_STATE bta_dm_pm_obtain_controller_state(void) {
   APPL_TRACE_DEBUG("bta_dm_pm_obtain_controller_state: %d", cur_state);
   return cur_state;
 }
+
+namespace bluetooth {
+namespace legacy {
+namespace testing {
+uint64_t bta_dm_pm_adapt_sniff_timeout(const RawAddress& peer_addr,
+                                       uint64_t timeout_ms) {
+  return ::bta_dm_pm_adapt_sniff_timeout(peer_addr, timeout_ms);
+}
+
+bool bta_dm_pm_defer_sniff(tBTA_DM_PEER_DEVICE* p_peer_dev) {
+  return ::bta_dm_pm_defer_sniff(p_peer_dev);
+}
+
+uint16_t bta_dm_pm_adapt_interval(const RawAddress& peer_addr,
+                                  const char* name, uint16_t slots,
+                                  uint16_t min_slots) {
+  return ::bta_dm_pm_adapt_interval(peer_addr, name, slots, min_slots);
+}
+
+}  // namespace testing
+}  // namespace legacy
+}  // namespace bluetooth
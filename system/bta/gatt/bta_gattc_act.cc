@@ -826,6 +826,7 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
 
   if (((p_clcb->p_q_cmd == NULL ||
         p_clcb->auto_update == BTA_GATTC_REQ_WAITING) &&
+       p_clcb->p_q_cmd_in_flight.empty() &&
        p_clcb->p_srcb->state == BTA_GATTC_SERV_IDLE) ||
       p_clcb->p_srcb->state == BTA_GATTC_SERV_DISC)
   /* no pending operation, start discovery right away */
@@ -966,6 +967,7 @@ void bta_gattc_read(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
   if (status != GATT_SUCCESS) {
     /* Dequeue the data, if it was enqueued */
     if (p_clcb->p_q_cmd == p_data) p_clcb->p_q_cmd = NULL;
+    bta_gattc_remove_in_flight_cmd(p_clcb, p_data);
 
     bta_gattc_cmpl_sendmsg(p_clcb->bta_conn_id, GATTC_OPTYPE_READ, status,
                            NULL);
@@ -986,8 +988,11 @@ void bta_gattc_read_multi(tBTA_GATTC_CLCB* p_clcb,
   memcpy(&read_param.read_multiple.handles, p_data->api_read_multi.handles,
          sizeof(uint16_t) * p_data->api_read_multi.num_attr);
 
-  tGATT_STATUS status =
-      GATTC_Read(p_clcb->bta_conn_id, GATT_READ_MULTIPLE, &read_param);
+  tGATT_STATUS status = GATTC_Read(p_clcb->bta_conn_id,
+                                   p_data->api_read_multi.variable_len
+                                       ? GATT_READ_MULTIPLE_VAR_LEN
+                                       : GATT_READ_MULTIPLE,
+                                   &read_param);
   /* read fail */
   if (status != GATT_SUCCESS) {
     /* Dequeue the data, if it was enqueued */
@@ -1027,6 +1032,7 @@ void bta_gattc_write(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
   if (status != GATT_SUCCESS) {
     /* Dequeue the data, if it was enqueued */
     if (p_clcb->p_q_cmd == p_data) p_clcb->p_q_cmd = NULL;
+    bta_gattc_remove_in_flight_cmd(p_clcb, p_data);
 
     bta_gattc_cmpl_sendmsg(p_clcb->bta_conn_id, GATTC_OPTYPE_WRITE, status,
                            NULL);
@@ -1069,6 +1075,27 @@ void bta_gattc_confirm(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
 /** read complete */
 static void bta_gattc_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                 const tBTA_GATTC_OP_CMPL* p_data) {
+  if (p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT) {
+    const tBTA_GATTC_API_READ_MULTI& api_read_multi =
+        p_clcb->p_q_cmd->api_read_multi;
+    GATT_READ_MULTI_OP_CB cb = api_read_multi.read_cb;
+    void* my_cb_data = api_read_multi.read_cb_data;
+
+    tBTA_GATTC_MULTI handles = {.num_attr = api_read_multi.num_attr};
+    memcpy(handles.handles, api_read_multi.handles,
+           sizeof(uint16_t) * handles.num_attr);
+
+    osi_free_and_reset((void**)&p_clcb->p_q_cmd);
+
+    if (cb) {
+      uint16_t len = p_data->p_cmpl ? p_data->p_cmpl->att_value.len : 0;
+      uint8_t* value =
+          p_data->p_cmpl ? p_data->p_cmpl->att_value.value : nullptr;
+      cb(p_clcb->bta_conn_id, p_data->status, handles, len, value, my_cb_data);
+    }
+    return;
+  }
+
   GATT_READ_OP_CB cb = p_clcb->p_q_cmd->api_read.read_cb;
   void* my_cb_data = p_clcb->p_q_cmd->api_read.read_cb_data;
 
@@ -1093,6 +1120,13 @@ static void bta_gattc_write_cmpl(tBTA_GATTC_CLCB* p_clcb,
   GATT_WRITE_OP_CB cb = p_clcb->p_q_cmd->api_write.write_cb;
   void* my_cb_data = p_clcb->p_q_cmd->api_write.write_cb_data;
 
+  if (p_clcb->p_q_cmd->api_write.write_type == GATT_WRITE) {
+    bta_gattc_ccc_write_cmpl(
+        p_clcb->p_srcb, p_clcb->p_q_cmd->api_write.handle,
+        p_clcb->p_q_cmd->api_write.len, p_clcb->p_q_cmd->api_write.p_value,
+        p_data->status);
+  }
+
   if (cb) {
     if (p_data->status == 0 &&
         p_clcb->p_q_cmd->api_write.write_type == BTA_GATTC_WRITE_PREPARE) {
@@ -1159,7 +1193,9 @@ static void bta_gattc_cfg_mtu_cmpl(tBTA_GATTC_CLCB* p_clcb,
 
 /** operation completed */
 void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
-  if (p_clcb->p_q_cmd == NULL) {
+  /* Pipelined commands are completed by the handle they refer to */
+  if (p_clcb->p_q_cmd == NULL &&
+      !bta_gattc_take_in_flight_cmd(p_clcb, &p_data->op_cmpl)) {
     LOG_ERROR("No pending command gatt client command");
     return;
   }
@@ -1181,8 +1217,13 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
       return;
   }
 
-  if (p_clcb->p_q_cmd->hdr.event !=
-      bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
+  /* Read multiple commands complete as reads */
+  uint16_t expected_event = bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ];
+  if (op == GATTC_OPTYPE_READ &&
+      p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT) {
+    expected_event = BTA_GATTC_API_READ_MULTI_EVT;
+  }
+  if (p_clcb->p_q_cmd->hdr.event != expected_event) {
     uint8_t mapped_op =
         p_clcb->p_q_cmd->hdr.event - BTA_GATTC_API_READ_EVT + GATTC_OPTYPE_READ;
     if (mapped_op > GATTC_OPTYPE_INDICATION) mapped_op = 0;
@@ -1434,11 +1475,14 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
   if (++p_srcb->update_count == bta_gattc_num_reg_app()) {
     /* not an opened connection; or connection busy */
     /* search for first available clcb and start discovery */
-    if (p_clcb == NULL || (p_clcb && p_clcb->p_q_cmd != NULL)) {
+    if (p_clcb == NULL ||
+        (p_clcb && (p_clcb->p_q_cmd != NULL ||
+                    !p_clcb->p_q_cmd_in_flight.empty()))) {
       for (size_t i = 0; i < BTA_GATTC_CLCB_MAX; i++) {
         if (bta_gattc_cb.clcb[i].in_use &&
             bta_gattc_cb.clcb[i].p_srcb == p_srcb &&
-            bta_gattc_cb.clcb[i].p_q_cmd == NULL) {
+            bta_gattc_cb.clcb[i].p_q_cmd == NULL &&
+            bta_gattc_cb.clcb[i].p_q_cmd_in_flight.empty()) {
           p_clcb = &bta_gattc_cb.clcb[i];
           break;
         }
@@ -328,6 +328,29 @@ const gatt::Characteristic* BTA_GATTC_GetCharacteristic(uint16_t conn_id,
   return bta_gattc_get_characteristic(conn_id, handle);
 }
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_IsCccdWritten
+ *
+ * Description      This function tells whether a client characteristic
+ *                  configuration descriptor of a bonded server already holds
+ *                  |value|. A bonded server keeps the configuration across
+ *                  connections, so writing the same value again can be
+ *                  skipped on reconnection.
+ *
+ * Parameters       conn_id - connection ID which identify the server.
+ *                  handle - descriptor handle
+ *                  value - configuration the client is about to write
+ *
+ * Returns          true if |value| was last written to the descriptor while
+ *                  bonded and the server database did not change since.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_IsCccdWritten(uint16_t conn_id, uint16_t handle,
+                             uint16_t value) {
+  return bta_gattc_is_ccc_written(conn_id, handle, value);
+}
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_GetDescriptor
@@ -467,19 +490,26 @@ void BTA_GATTC_ReadCharDescr(uint16_t conn_id, uint16_t handle,
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - pointer to the read multiple parameter.
+ *                    variable_len - use the Read Multiple Variable Length
+ *                                   procedure.
+ *                    callback - called with the values read, as received.
  *
  * Returns          None
  *
  ******************************************************************************/
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req) {
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ_MULTI* p_buf =
       (tBTA_GATTC_API_READ_MULTI*)osi_calloc(sizeof(tBTA_GATTC_API_READ_MULTI));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_MULTI_EVT;
   p_buf->hdr.layer_specific = conn_id;
   p_buf->auth_req = auth_req;
+  p_buf->variable_len = variable_len;
   p_buf->num_attr = p_read_multi->num_attr;
+  p_buf->read_cb = callback;
+  p_buf->read_cb_data = cb_data;
 
   if (p_buf->num_attr > 0)
     memcpy(p_buf->handles, p_read_multi->handles,
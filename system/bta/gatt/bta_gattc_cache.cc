@@ -29,6 +29,7 @@
 #include <base/strings/string_number_conversions.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <sstream>
@@ -111,16 +112,10 @@ static void bta_gattc_display_explore_record(const DatabaseBuilder& database) {
 void bta_gattc_init_cache(tBTA_GATTC_SERV* p_srvc_cb) {
   p_srvc_cb->gatt_database = gatt::Database();
   p_srvc_cb->pending_discovery.Clear();
-}
-
-const Service* bta_gattc_find_matching_service(
-    const std::list<Service>& services, uint16_t handle) {
-  for (const Service& service : services) {
-    if (handle >= service.handle && handle <= service.end_handle)
-      return &service;
-  }
-
-  return nullptr;
+  p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_NONE;
+  p_srvc_cb->disc_in_flight = 0;
+  p_srvc_cb->disc_status = GATT_SUCCESS;
+  p_srvc_cb->disc_ranges.clear();
 }
 
 /// Whether the peer device uses robust caching
@@ -286,6 +281,8 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
   LOG(INFO) << __func__ << ": service discovery finished";
 
   p_srvc_cb->gatt_database = p_srvc_cb->pending_discovery.Build();
+  /* the CCC values stored for an older database no longer apply */
+  p_srvc_cb->ccc_values_loaded = false;
 
 #if (BTA_GATT_DEBUG == TRUE)
   bta_gattc_display_cache_server(p_srvc_cb->gatt_database);
@@ -346,6 +343,100 @@ descriptor_discovery_done:
   return;
 }
 
+/* Take the next range to explore in the current parallel discovery phase */
+static bool bta_gattc_next_parallel_range(
+    tBTA_GATTC_SERV* p_srvc_cb, std::pair<uint16_t, uint16_t>* range) {
+  if (p_srvc_cb->disc_phase == BTA_GATTC_DISC_PHASE_INC_SRVC) {
+    /* secondary services found meanwhile are added to the exploration */
+    if (!p_srvc_cb->pending_discovery.StartNextServiceExploration()) {
+      return false;
+    }
+    *range = p_srvc_cb->pending_discovery.CurrentlyExploredService();
+    return true;
+  }
+
+  if (p_srvc_cb->disc_ranges.empty()) return false;
+  *range = p_srvc_cb->disc_ranges.front();
+  p_srvc_cb->disc_ranges.pop_front();
+  return true;
+}
+
+/** Explore the services found by primary service discovery, with up to one
+ * discovery procedure per bearer in progress. The included services of all the
+ * services are discovered first, then their characteristics, then their
+ * descriptors, so that each procedure only depends on the previous phases.
+ * Results are added to the builder by handle, and procedures of the same phase
+ * can complete in any order. */
+static void bta_gattc_explore_services_in_parallel(uint16_t conn_id,
+                                                   tBTA_GATTC_SERV* p_srvc_cb) {
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+  if (!p_clcb) {
+    LOG(ERROR) << "unknown conn_id=" << loghex(conn_id);
+    return;
+  }
+
+  size_t max_in_flight =
+      std::max<size_t>(1, GATTC_GetNumberOfBearers(conn_id));
+
+  while (true) {
+    tGATT_DISC_TYPE disc_type = GATT_DISC_CHAR_DSCPT;
+    if (p_srvc_cb->disc_phase == BTA_GATTC_DISC_PHASE_INC_SRVC) {
+      disc_type = GATT_DISC_INC_SRVC;
+    } else if (p_srvc_cb->disc_phase == BTA_GATTC_DISC_PHASE_CHAR) {
+      disc_type = GATT_DISC_CHAR;
+    }
+
+    std::pair<uint16_t, uint16_t> range;
+    while (p_srvc_cb->disc_status == GATT_SUCCESS &&
+           p_srvc_cb->disc_in_flight < max_in_flight &&
+           bta_gattc_next_parallel_range(p_srvc_cb, &range)) {
+      tGATT_STATUS status =
+          GATTC_Discover(conn_id, disc_type, range.first, range.second);
+      if (status != GATT_SUCCESS) {
+        LOG_ERROR("discovery failed, conn_id=0x%04x, status=%d", conn_id,
+                  status);
+        p_srvc_cb->disc_status = status;
+        break;
+      }
+      p_srvc_cb->disc_in_flight++;
+    }
+
+    /* asynchronous continuation in bta_gattc_disc_cmpl_cback */
+    if (p_srvc_cb->disc_in_flight > 0) return;
+
+    if (p_srvc_cb->disc_status != GATT_SUCCESS) {
+      p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_NONE;
+      p_srvc_cb->disc_ranges.clear();
+      bta_gattc_sm_execute(p_clcb, BTA_GATTC_DISCOVER_CMPL_EVT, NULL);
+      return;
+    }
+
+    switch (p_srvc_cb->disc_phase) {
+      case BTA_GATTC_DISC_PHASE_INC_SRVC: {
+        auto ranges = p_srvc_cb->pending_discovery.ServiceRangesToExplore();
+        p_srvc_cb->disc_ranges.assign(ranges.begin(), ranges.end());
+        p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_CHAR;
+        break;
+      }
+      case BTA_GATTC_DISC_PHASE_CHAR: {
+#if (BTA_GATT_DEBUG == TRUE)
+        bta_gattc_display_explore_record(p_srvc_cb->pending_discovery);
+#endif
+        auto ranges = p_srvc_cb->pending_discovery.DescriptorRangesToExplore();
+        p_srvc_cb->disc_ranges.assign(ranges.begin(), ranges.end());
+        p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_CHAR_DSCPT;
+        break;
+      }
+      default:
+        /* all services explored, read the extended properties and finish */
+        DVLOG(3) << "all services explored";
+        p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_NONE;
+        bta_gattc_explore_next_service(conn_id, p_srvc_cb);
+        return;
+    }
+  }
+}
+
 /* Process the discovery result from sdp */
 void bta_gattc_sdp_callback(tSDP_STATUS sdp_status, const void* user_data) {
   tBTA_GATTC_CB_DATA* cb_data = (tBTA_GATTC_CB_DATA*)user_data;
@@ -518,6 +609,29 @@ void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
   tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
   tBTA_GATTC_SERV* p_srvc_cb = bta_gattc_find_scb_by_cid(conn_id);
 
+  if (p_clcb && p_srvc_cb &&
+      p_srvc_cb->disc_phase != BTA_GATTC_DISC_PHASE_NONE) {
+    if (p_srvc_cb->disc_in_flight > 0) p_srvc_cb->disc_in_flight--;
+    if (status != GATT_SUCCESS && p_srvc_cb->disc_status == GATT_SUCCESS) {
+      p_srvc_cb->disc_status = status;
+    }
+
+    if (p_srvc_cb->disc_status == GATT_SUCCESS &&
+        p_clcb->status == GATT_SUCCESS) {
+      bta_gattc_explore_services_in_parallel(conn_id, p_srvc_cb);
+      return;
+    }
+
+    /* wait for the other procedures before reporting the failure */
+    if (p_srvc_cb->disc_in_flight > 0) return;
+
+    if (p_srvc_cb->disc_status != GATT_SUCCESS) {
+      status = p_srvc_cb->disc_status;
+    }
+    p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_NONE;
+    p_srvc_cb->disc_ranges.clear();
+  }
+
   if (p_clcb && (status != GATT_SUCCESS || p_clcb->status != GATT_SUCCESS)) {
     if (status == GATT_SUCCESS) p_clcb->status = status;
 
@@ -549,6 +663,13 @@ void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
 #if (BTA_GATT_DEBUG == TRUE)
       bta_gattc_display_explore_record(p_srvc_cb->pending_discovery);
 #endif
+      if (bta_gattc_is_parallel_discovery_enabled()) {
+        p_srvc_cb->disc_phase = BTA_GATTC_DISC_PHASE_INC_SRVC;
+        p_srvc_cb->disc_in_flight = 0;
+        p_srvc_cb->disc_status = GATT_SUCCESS;
+        bta_gattc_explore_services_in_parallel(conn_id, p_srvc_cb);
+        break;
+      }
       bta_gattc_explore_next_service(conn_id, p_srvc_cb);
       break;
 
@@ -618,31 +739,23 @@ const std::list<Service>* bta_gattc_get_services(uint16_t conn_id) {
 
 const Service* bta_gattc_get_service_for_handle_srcb(tBTA_GATTC_SERV* p_srcb,
                                                      uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services_srcb(p_srcb);
-  if (services == NULL) return NULL;
-  return bta_gattc_find_matching_service(*services, handle);
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindService(handle);
 }
 
 const Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                 uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services(conn_id);
-  if (services == NULL) return NULL;
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
 
-  return bta_gattc_find_matching_service(*services, handle);
+  if (p_clcb == NULL) return NULL;
+
+  return bta_gattc_get_service_for_handle_srcb(p_clcb->p_srcb, handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) return &charac;
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
@@ -657,20 +770,8 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb,
                                                 uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
-    return NULL;
-  }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &desc;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -682,20 +783,60 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
   return bta_gattc_get_descriptor_srcb(p_srcb, handle);
 }
 
-const Characteristic* bta_gattc_get_owning_characteristic_srcb(
-    tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
+/* Loads the CCC values stored for the current database of a bonded server,
+ * once per connection */
+static void bta_gattc_load_ccc_values(tBTA_GATTC_SERV* p_srcb) {
+  if (p_srcb->ccc_values_loaded) return;
+  p_srcb->ccc_values_loaded = true;
+  p_srcb->ccc_db_hash = p_srcb->gatt_database.Hash();
+  p_srcb->ccc_values =
+      bta_gattc_ccc_load(p_srcb->server_bda, p_srcb->ccc_db_hash);
+}
 
-  if (!service) return NULL;
+bool bta_gattc_is_ccc_written(uint16_t conn_id, uint16_t handle,
+                              uint16_t value) {
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
+  if (p_clcb == NULL || p_clcb->p_srcb == NULL) return false;
 
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &charac;
-    }
+  tBTA_GATTC_SERV* p_srcb = p_clcb->p_srcb;
+  /* only a bonded server keeps the configuration across connections */
+  if (p_srcb->gatt_database.IsEmpty() ||
+      !btm_sec_is_a_bonded_dev(p_srcb->server_bda))
+    return false;
+
+  bta_gattc_load_ccc_values(p_srcb);
+  auto it = p_srcb->ccc_values.find(handle);
+  return it != p_srcb->ccc_values.end() && it->second == value;
+}
+
+void bta_gattc_ccc_write_cmpl(tBTA_GATTC_SERV* p_srcb, uint16_t handle,
+                              uint16_t len, const uint8_t* p_value,
+                              tGATT_STATUS status) {
+  if (p_srcb == NULL || len != 2 || p_value == NULL) return;
+
+  const Descriptor* p_desc = bta_gattc_get_descriptor_srcb(p_srcb, handle);
+  if (p_desc == NULL ||
+      p_desc->uuid != Uuid::From16Bit(GATT_UUID_CHAR_CLIENT_CONFIG) ||
+      !btm_sec_is_a_bonded_dev(p_srcb->server_bda))
+    return;
+
+  bta_gattc_load_ccc_values(p_srcb);
+  uint16_t value = p_value[0] | (p_value[1] << 8);
+  if (status == GATT_SUCCESS) {
+    auto it = p_srcb->ccc_values.find(handle);
+    if (it != p_srcb->ccc_values.end() && it->second == value) return;
+    p_srcb->ccc_values[handle] = value;
+  } else if (p_srcb->ccc_values.erase(handle) == 0) {
+    return;
   }
+  bta_gattc_ccc_write(p_srcb->server_bda, p_srcb->ccc_db_hash,
+                      p_srcb->ccc_values);
+}
 
-  return NULL;
+const Characteristic* bta_gattc_get_owning_characteristic_srcb(
+    tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
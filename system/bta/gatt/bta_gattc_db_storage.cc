@@ -21,8 +21,13 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <array>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -35,7 +40,8 @@ using std::vector;
 
 #ifdef TARGET_FLOSS
 #define GATT_CACHE_PREFIX "/var/lib/bluetooth/gatt/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CCC_PREFIX "/var/lib/bluetooth/gatt/gatt_ccc_"
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/var/lib/bluetooth/gatt/gatt_hash_"
@@ -43,7 +49,8 @@ using std::vector;
 #define GATT_HASH_FILE_PREFIX "gatt_hash_"
 #else
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CCC_PREFIX "/data/misc/bluetooth/gatt_ccc_"
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/data/misc/bluetooth/gatt_hash_"
@@ -63,6 +70,13 @@ static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
            bda.address[4], bda.address[5]);
 }
 
+static void bta_gattc_generate_ccc_file_name(char* buffer, size_t buffer_len,
+                                             const RawAddress& bda) {
+  snprintf(buffer, buffer_len, "%s%02x%02x%02x%02x%02x%02x", GATT_CCC_PREFIX,
+           bda.address[0], bda.address[1], bda.address[2], bda.address[3],
+           bda.address[4], bda.address[5]);
+}
+
 static void bta_gattc_generate_hash_file_name(char* buffer, size_t buffer_len,
                                               const Octet16& hash) {
   snprintf(buffer, buffer_len, "%s%s", GATT_HASH_PATH_PREFIX,
@@ -71,11 +85,69 @@ static void bta_gattc_generate_hash_file_name(char* buffer, size_t buffer_len,
 
 static gatt::Database EMPTY_DB;
 
+/* "GATC", marks files in the flat cache format */
+constexpr uint32_t GATT_CACHE_MAGIC = 0x43544147;
+
+/* Header of a GATT cache file. It is followed by |num_attr| StoredAttribute
+ * records, which are used in place once the file is memory mapped. */
+struct tGATT_CACHE_HEADER {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t num_attr;
+  /* CRC-32 of the attribute records */
+  uint32_t checksum;
+};
+
+static_assert(sizeof(tGATT_CACHE_HEADER) % alignof(StoredAttribute) == 0,
+              "attribute records must be aligned in the mapped file");
+
+/* "GCCC", marks files of client characteristic configuration values */
+constexpr uint32_t GATT_CCC_MAGIC = 0x43434347;
+constexpr uint16_t GATT_CCC_VERSION = 1;
+
+/* Header of a CCC values file. It is followed by |num_values|
+ * tGATT_CCC_RECORD records. */
+struct tGATT_CCC_HEADER {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t num_values;
+  /* hash of the server database the descriptor handles belong to */
+  Octet16 db_hash;
+};
+
+struct tGATT_CCC_RECORD {
+  uint16_t handle;
+  uint16_t value;
+};
+
+static constexpr std::array<uint32_t, 256> bta_gattc_crc32_table() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < table.size(); i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+static uint32_t bta_gattc_cache_checksum(const void* data, size_t len) {
+  static constexpr std::array<uint32_t, 256> table = bta_gattc_crc32_table();
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < len; i++) {
+    crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_load_db
  *
- * Description      Load GATT database from storage.
+ * Description      Load GATT database from storage. The file is memory mapped
+ *                  and the attribute records are deserialized in place.
  *
  * Parameter        fname: input file name
  *
@@ -84,49 +156,50 @@ static gatt::Database EMPTY_DB;
  *
  ******************************************************************************/
 static gatt::Database bta_gattc_load_db(const char* fname) {
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG(ERROR) << __func__ << ": can't open GATT cache file " << fname
                << " for reading, error: " << strerror(errno);
     return EMPTY_DB;
   }
 
-  uint16_t cache_ver = 0;
-  uint16_t num_attr = 0;
-
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't read GATT cache version from: " << fname;
-    goto done;
-  }
-
-  if (cache_ver != GATT_CACHE_VERSION) {
-    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
-    goto done;
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(tGATT_CACHE_HEADER)) {
+    LOG(ERROR) << __func__ << ": can't read GATT cache header from: " << fname;
+    close(fd);
+    return EMPTY_DB;
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't read number of GATT attributes: " << fname;
-    goto done;
+  size_t size = st.st_size;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": can't map GATT cache file " << fname
+               << ", error: " << strerror(errno);
+    return EMPTY_DB;
   }
 
-  {
-    std::vector<StoredAttribute> attr(num_attr);
+  gatt::Database result;
+  bool success = false;
+  const tGATT_CACHE_HEADER* header =
+      static_cast<const tGATT_CACHE_HEADER*>(map);
+  const StoredAttribute* attr = reinterpret_cast<const StoredAttribute*>(
+      static_cast<const uint8_t*>(map) + sizeof(tGATT_CACHE_HEADER));
+  size_t attr_size = size - sizeof(tGATT_CACHE_HEADER);
 
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      LOG(ERROR) << __func__ << ": can't read GATT attributes: " << fname;
-      goto done;
-    }
-    fclose(fd);
-
-    bool success = false;
-    gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
+  if (header->magic != GATT_CACHE_MAGIC ||
+      header->version != GATT_CACHE_VERSION) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
+  } else if (attr_size != header->num_attr * sizeof(StoredAttribute)) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache size: " << fname;
+  } else if (bta_gattc_cache_checksum(attr, attr_size) != header->checksum) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache checksum: " << fname;
+  } else {
+    result = gatt::Database::Deserialize(attr, header->num_attr, &success);
   }
 
-done:
-  fclose(fd);
-  return EMPTY_DB;
+  munmap(map, size);
+  return success ? result : EMPTY_DB;
 }
 
 /*******************************************************************************
@@ -186,17 +259,16 @@ static bool bta_gattc_store_db(const char* fname,
     return false;
   }
 
-  uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't write GATT cache version: " << fname;
-    fclose(fd);
-    return false;
-  }
-
   uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't write GATT cache attribute count: " << fname;
+  tGATT_CACHE_HEADER header = {
+      .magic = GATT_CACHE_MAGIC,
+      .version = GATT_CACHE_VERSION,
+      .num_attr = num_attr,
+      .checksum = bta_gattc_cache_checksum(
+          attr.data(), num_attr * sizeof(StoredAttribute)),
+  };
+  if (fwrite(&header, sizeof(header), 1, fd) != 1) {
+    LOG(ERROR) << __func__ << ": can't write GATT cache header: " << fname;
     fclose(fd);
     return false;
   }
@@ -301,6 +373,120 @@ void bta_gattc_cache_reset(const RawAddress& server_bda) {
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), server_bda);
   unlink(fname);
+  bta_gattc_ccc_reset(server_bda);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_ccc_load
+ *
+ * Description      Load the values written to the client characteristic
+ *                  configuration descriptors of a bonded server.
+ *
+ * Parameter        server_bda: server bd address
+ *                  db_hash: hash of the current database of the server
+ *
+ * Returns          the values by descriptor handle, empty if none were stored
+ *                  or if they were written for another database
+ *
+ ******************************************************************************/
+std::map<uint16_t, uint16_t> bta_gattc_ccc_load(const RawAddress& server_bda,
+                                                const Octet16& db_hash) {
+  char fname[255] = {0};
+  bta_gattc_generate_ccc_file_name(fname, sizeof(fname), server_bda);
+
+  std::map<uint16_t, uint16_t> values;
+  FILE* fd = fopen(fname, "rb");
+  if (!fd) return values;
+
+  tGATT_CCC_HEADER header;
+  if (fread(&header, sizeof(header), 1, fd) != 1 ||
+      header.magic != GATT_CCC_MAGIC || header.version != GATT_CCC_VERSION ||
+      header.db_hash != db_hash) {
+    VLOG(1) << __func__ << ": no CCC values for the current database";
+    fclose(fd);
+    return values;
+  }
+
+  std::vector<tGATT_CCC_RECORD> records(header.num_values);
+  if (fread(records.data(), sizeof(tGATT_CCC_RECORD), records.size(), fd) !=
+      records.size()) {
+    LOG(ERROR) << __func__ << ": can't read CCC values: " << fname;
+    fclose(fd);
+    return values;
+  }
+  fclose(fd);
+
+  for (const tGATT_CCC_RECORD& record : records) {
+    values[record.handle] = record.value;
+  }
+  return values;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_ccc_write
+ *
+ * Description      Store the values written to the client characteristic
+ *                  configuration descriptors of a bonded server.
+ *
+ * Parameter        server_bda: server bd address
+ *                  db_hash: hash of the database the handles belong to
+ *                  values: values by descriptor handle
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_ccc_write(const RawAddress& server_bda, const Octet16& db_hash,
+                         const std::map<uint16_t, uint16_t>& values) {
+  char fname[255] = {0};
+  bta_gattc_generate_ccc_file_name(fname, sizeof(fname), server_bda);
+
+  std::vector<tGATT_CCC_RECORD> records;
+  records.reserve(values.size());
+  for (const auto& [handle, value] : values) {
+    records.push_back({.handle = handle, .value = value});
+  }
+
+  FILE* fd = fopen(fname, "wb");
+  if (!fd) {
+    LOG(ERROR) << __func__ << ": can't open CCC file for writing: " << fname;
+    return;
+  }
+
+  tGATT_CCC_HEADER header = {
+      .magic = GATT_CCC_MAGIC,
+      .version = GATT_CCC_VERSION,
+      .num_values = static_cast<uint16_t>(records.size()),
+      .db_hash = db_hash,
+  };
+  if (fwrite(&header, sizeof(header), 1, fd) != 1 ||
+      fwrite(records.data(), sizeof(tGATT_CCC_RECORD), records.size(), fd) !=
+          records.size()) {
+    LOG(ERROR) << __func__ << ": can't write CCC values: " << fname;
+    fclose(fd);
+    unlink(fname);
+    return;
+  }
+  fclose(fd);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_ccc_reset
+ *
+ * Description      Forget the client characteristic configuration values
+ *                  stored for a server.
+ *
+ * Parameter        server_bda: server bd address
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_ccc_reset(const RawAddress& server_bda) {
+  char fname[255] = {0};
+  bta_gattc_generate_ccc_file_name(fname, sizeof(fname), server_bda);
+  unlink(fname);
 }
 
 /*******************************************************************************
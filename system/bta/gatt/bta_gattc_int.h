@@ -26,6 +26,10 @@
 
 #include <cstdint>
 #include <deque>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/database.h"
@@ -160,8 +164,11 @@ typedef struct {
 typedef struct {
   BT_HDR_RIGID hdr;
   tGATT_AUTH_REQ auth_req;
+  bool variable_len;
   uint8_t num_attr;
   uint16_t handles[GATT_MAX_READ_MULTI_HANDLES];
+  GATT_READ_MULTI_OP_CB read_cb;
+  void* read_cb_data;
 } tBTA_GATTC_API_READ_MULTI;
 
 typedef struct {
@@ -232,6 +239,25 @@ typedef struct {
   uint16_t attr_index;  /* cahce NV saving/loading attribute index */
 
   uint16_t mtu;
+
+#define BTA_GATTC_DISC_PHASE_NONE 0
+#define BTA_GATTC_DISC_PHASE_INC_SRVC 1
+#define BTA_GATTC_DISC_PHASE_CHAR 2
+#define BTA_GATTC_DISC_PHASE_CHAR_DSCPT 3
+
+  /* used only during parallel service discovery */
+  uint8_t disc_phase;      /* discovery phase in progress */
+  uint8_t disc_in_flight;  /* number of discovery procedures in progress */
+  tGATT_STATUS disc_status; /* first error of the discovery procedures */
+  std::deque<std::pair<uint16_t, uint16_t>> disc_ranges; /* left to explore */
+
+  /* Values last written to the client characteristic configuration
+   * descriptors of a bonded server, by descriptor handle. Loaded from storage
+   * the first time they are needed while connected, for the database of
+   * |ccc_db_hash|. */
+  bool ccc_values_loaded;
+  Octet16 ccc_db_hash;
+  std::map<uint16_t, uint16_t> ccc_values;
 } tBTA_GATTC_SERV;
 
 #ifndef BTA_GATTC_NOTIF_REG_MAX
@@ -255,6 +281,22 @@ typedef struct {
   tBTA_GATTC_NOTIF_REG notif_reg[BTA_GATTC_NOTIF_REG_MAX];
 } tBTA_GATTC_RCB;
 
+/* Maximum number of write commands issued without waiting for the previous
+ * ones to complete */
+#ifndef BTA_GATTC_MAX_PIPELINED_WRITES
+#define BTA_GATTC_MAX_PIPELINED_WRITES 8
+#endif
+
+/* per connection statistics of the client command queue */
+typedef struct {
+  uint32_t num_cmds;           /* commands sent */
+  uint32_t num_pipelined_cmds; /* commands sent with others in flight */
+  uint32_t num_queued_cmds;    /* commands that had to wait in the queue */
+  uint8_t max_in_flight;       /* maximum number of commands in flight */
+  uint64_t total_queue_ms;     /* total time spent in the queue */
+  uint64_t max_queue_ms;       /* maximum time spent in the queue */
+} tBTA_GATTC_CMD_STATS;
+
 /* client channel is a mapping between a BTA client(cl_id) and a remote BD
  * address */
 typedef struct {
@@ -265,6 +307,11 @@ typedef struct {
   tBTA_GATTC_SERV* p_srcb;  /* server cache CB */
   const tBTA_GATTC_DATA* p_q_cmd; /* command in queue waiting for execution */
   std::deque<const tBTA_GATTC_DATA*> p_q_cmd_queue;
+  /* independent commands sent together, when pipelining is enabled */
+  std::list<const tBTA_GATTC_DATA*> p_q_cmd_in_flight;
+  /* time each command of p_q_cmd_queue was queued at, in ms */
+  std::unordered_map<const tBTA_GATTC_DATA*, uint64_t> q_cmd_time_ms;
+  tBTA_GATTC_CMD_STATS cmd_stats;
 
 // request during discover state
 #define BTA_GATTC_DISCOVER_REQ_NONE 0
@@ -322,6 +369,13 @@ typedef struct {
 
   tBTA_GATTC_CLCB clcb[BTA_GATTC_CLCB_MAX];
   tBTA_GATTC_SERV known_server[BTA_GATTC_KNOWN_SR_MAX];
+
+  /* Where the previous lookups found their entry, so that routing each
+   * notification doesn't scan the tables above. The entries may be stale and
+   * are checked before use; the tables remain the reference. */
+  std::unordered_map<uint16_t, uint8_t> clcb_idx_by_conn_id;
+  std::unordered_map<RawAddress, uint8_t> srcb_idx_by_bda;
+  std::unordered_map<uint64_t, uint8_t> notif_reg_idx[BTA_GATTC_CL_MAX];
 } tBTA_GATTC_CB;
 
 /*****************************************************************************
@@ -426,6 +480,10 @@ enum BtaEnqueuedResult_t {
 
 BtaEnqueuedResult_t bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb,
                                       const tBTA_GATTC_DATA* p_data);
+bool bta_gattc_take_in_flight_cmd(tBTA_GATTC_CLCB* p_clcb,
+                                  const tBTA_GATTC_OP_CMPL* p_data);
+void bta_gattc_remove_in_flight_cmd(tBTA_GATTC_CLCB* p_clcb,
+                                    const tBTA_GATTC_DATA* p_data);
 bool bta_gattc_is_data_queued(tBTA_GATTC_CLCB* p_clcb,
                               const tBTA_GATTC_DATA* p_data);
 void bta_gattc_continue(tBTA_GATTC_CLCB* p_clcb);
@@ -448,6 +506,8 @@ void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb,
                                         uint16_t end_handle);
 tBTA_GATTC_SERV* bta_gattc_find_srvr_cache(const RawAddress& bda);
 bool bta_gattc_is_robust_caching_enabled();
+bool bta_gattc_is_pipelining_enabled();
+bool bta_gattc_is_parallel_discovery_enabled();
 
 /* discovery functions */
 void bta_gattc_disc_res_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
@@ -475,6 +535,11 @@ void bta_gattc_get_gatt_db(uint16_t conn_id, uint16_t start_handle,
                            uint16_t end_handle, btgatt_db_element_t** db,
                            int* count);
 void bta_gattc_init_cache(tBTA_GATTC_SERV* p_srvc_cb);
+bool bta_gattc_is_ccc_written(uint16_t conn_id, uint16_t handle,
+                              uint16_t value);
+void bta_gattc_ccc_write_cmpl(tBTA_GATTC_SERV* p_srcb, uint16_t handle,
+                              uint16_t len, const uint8_t* p_value,
+                              tGATT_STATUS status);
 
 enum class RobustCachingSupport {
   UNSUPPORTED,
@@ -502,5 +567,10 @@ void bta_gattc_cache_write(const RawAddress& server_bda,
                            const gatt::Database& database);
 void bta_gattc_cache_link(const RawAddress& server_bda, const Octet16& hash);
 void bta_gattc_cache_reset(const RawAddress& server_bda);
+std::map<uint16_t, uint16_t> bta_gattc_ccc_load(const RawAddress& server_bda,
+                                                const Octet16& db_hash);
+void bta_gattc_ccc_write(const RawAddress& server_bda, const Octet16& db_hash,
+                         const std::map<uint16_t, uint16_t>& values);
+void bta_gattc_ccc_reset(const RawAddress& server_bda);
 
 #endif /* BTA_GATTC_INT_H */
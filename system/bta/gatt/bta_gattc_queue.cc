@@ -16,7 +16,9 @@
 
 #include "bta_gatt_queue.h"
 
+#include <algorithm>
 #include <list>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -37,9 +39,15 @@ struct gatt_read_op_data {
   void* cb_data;
 };
 
+struct gatt_read_multi_op_data {
+  std::vector<gatt_operation> reads;
+};
+
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
 std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_map<uint16_t, uint8_t> BtaGattQueue::gatt_op_reads_in_flight;
+std::unordered_set<uint16_t> BtaGattQueue::gatt_op_read_multi_rejected;
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
   gatt_op_queue_executing.erase(conn_id);
@@ -54,8 +62,10 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
 
   osi_free(data);
 
-  mark_as_not_executing(conn_id);
-  gatt_execute_next_op(conn_id);
+  if (gatt_read_completed(conn_id)) {
+    mark_as_not_executing(conn_id);
+    gatt_execute_next_op(conn_id);
+  }
 
   if (tmp_cb) {
     tmp_cb(conn_id, status, handle, len, value, tmp_cb_data);
@@ -63,6 +73,70 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
   }
 }
 
+void BtaGattQueue::gatt_read_multi_op_finished(uint16_t conn_id,
+                                               tGATT_STATUS status,
+                                               const tBTA_GATTC_MULTI& handles,
+                                               uint16_t len, uint8_t* value,
+                                               void* data) {
+  std::unique_ptr<gatt_read_multi_op_data> tmp(
+      (gatt_read_multi_op_data*)data);
+  std::vector<gatt_operation>& reads = tmp->reads;
+
+  /* Each value is preceded by its length. The response is limited to the MTU,
+   * so the last values may be missing or truncated. */
+  std::vector<std::pair<uint16_t, uint8_t*>> values;
+  if (status == GATT_SUCCESS) {
+    uint8_t* p = value;
+    uint16_t remaining = len;
+    while (values.size() < reads.size() && remaining >= 2) {
+      uint16_t value_len = p[0] | (p[1] << 8);
+      p += 2;
+      remaining -= 2;
+      if (value_len > remaining) break;
+
+      values.emplace_back(value_len, p);
+      p += value_len;
+      remaining -= value_len;
+    }
+  } else if (status == GATT_REQ_NOT_SUPPORTED) {
+    gatt_op_read_multi_rejected.insert(conn_id);
+  }
+
+  /* The reads left without their value are sent again on their own, ahead of
+   * the queue, unless it was cleaned meanwhile */
+  if (values.size() < reads.size() && gatt_op_reads_in_flight.count(conn_id)) {
+    APPL_TRACE_DEBUG("%s: conn_id=0x%x, %zu of %zu values read, status=%d",
+                     __func__, conn_id, values.size(), reads.size(), status);
+    std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+    while (reads.size() > values.size()) {
+      reads.back().read_alone = true;
+      gatt_ops.push_front(std::move(reads.back()));
+      reads.pop_back();
+    }
+  }
+
+  if (gatt_read_completed(conn_id)) {
+    mark_as_not_executing(conn_id);
+    gatt_execute_next_op(conn_id);
+  }
+
+  for (size_t i = 0; i < values.size(); i++) {
+    if (reads[i].read_cb) {
+      reads[i].read_cb(conn_id, status, reads[i].handle, values[i].first,
+                       values[i].second, reads[i].read_cb_data);
+    }
+  }
+}
+
+/* Returns true once the last of the reads sent together has completed */
+bool BtaGattQueue::gatt_read_completed(uint16_t conn_id) {
+  auto it = gatt_op_reads_in_flight.find(conn_id);
+  if (it != gatt_op_reads_in_flight.end() && --it->second > 0) return false;
+
+  gatt_op_reads_in_flight.erase(conn_id);
+  return true;
+}
+
 struct gatt_write_op_data {
   GATT_WRITE_OP_CB cb;
   void* cb_data;
@@ -134,23 +208,12 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 
   gatt_operation& op = gatt_ops.front();
 
-  if (op.type == GATT_READ_CHAR) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
-    BTA_GATTC_ReadCharacteristic(conn_id, op.handle, GATT_AUTH_REQ_NONE,
-                                 gatt_read_op_finished, data);
-
-  } else if (op.type == GATT_READ_DESC) {
-    gatt_read_op_data* data =
-        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
-    data->cb = op.read_cb;
-    data->cb_data = op.read_cb_data;
-    BTA_GATTC_ReadCharDescr(conn_id, op.handle, GATT_AUTH_REQ_NONE,
-                            gatt_read_op_finished, data);
+  if (op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) {
+    gatt_execute_reads(conn_id, gatt_ops);
+    return;
+  }
 
-  } else if (op.type == GATT_WRITE_CHAR) {
+  if (op.type == GATT_WRITE_CHAR) {
     gatt_write_op_data* data =
         (gatt_write_op_data*)osi_malloc(sizeof(gatt_write_op_data));
     data->cb = op.write_cb;
@@ -179,9 +242,69 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   gatt_ops.pop_front();
 }
 
+/* Sends the reads at the front of the queue together: in a single Read
+ * Multiple Variable Length request if the server supports it, or pipelined by
+ * BTA on the ATT bearers of the connection. */
+void BtaGattQueue::gatt_execute_reads(uint16_t conn_id,
+                                      std::list<gatt_operation>& gatt_ops) {
+  bool read_multi = !gatt_ops.front().read_alone &&
+                    !gatt_op_read_multi_rejected.count(conn_id) &&
+                    GATTC_IsReadMultipleVarLenSupported(conn_id);
+
+  std::vector<gatt_operation> reads;
+  while (!gatt_ops.empty() && reads.size() < GATT_MAX_READ_MULTI_HANDLES) {
+    gatt_operation& op = gatt_ops.front();
+    if (op.type != GATT_READ_CHAR && op.type != GATT_READ_DESC) break;
+    if (read_multi && op.read_alone) break;
+
+    /* Results are matched to the reads by their handle */
+    if (std::any_of(reads.begin(), reads.end(),
+                    [&op](const gatt_operation& read) {
+                      return read.handle == op.handle;
+                    })) {
+      break;
+    }
+
+    reads.push_back(std::move(op));
+    gatt_ops.pop_front();
+  }
+
+  if (read_multi && reads.size() > 1) {
+    tBTA_GATTC_MULTI handles = {};
+    handles.num_attr = reads.size();
+    for (size_t i = 0; i < reads.size(); i++) {
+      handles.handles[i] = reads[i].handle;
+    }
+
+    gatt_op_reads_in_flight[conn_id] = 1;
+    gatt_read_multi_op_data* data =
+        new gatt_read_multi_op_data{.reads = std::move(reads)};
+    BTA_GATTC_ReadMultiple(conn_id, &handles, true, GATT_AUTH_REQ_NONE,
+                           gatt_read_multi_op_finished, data);
+    return;
+  }
+
+  gatt_op_reads_in_flight[conn_id] = reads.size();
+  for (const gatt_operation& op : reads) {
+    gatt_read_op_data* data =
+        (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
+    data->cb = op.read_cb;
+    data->cb_data = op.read_cb_data;
+    if (op.type == GATT_READ_CHAR) {
+      BTA_GATTC_ReadCharacteristic(conn_id, op.handle, GATT_AUTH_REQ_NONE,
+                                   gatt_read_op_finished, data);
+    } else {
+      BTA_GATTC_ReadCharDescr(conn_id, op.handle, GATT_AUTH_REQ_NONE,
+                              gatt_read_op_finished, data);
+    }
+  }
+}
+
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
+  gatt_op_reads_in_flight.erase(conn_id);
+  gatt_op_read_multi_rejected.erase(conn_id);
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
@@ -30,8 +30,10 @@
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/bta_gattc_int.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "gd/common/init_flags.h"
+#include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "types/bt_transport.h"
@@ -103,6 +105,16 @@ tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_cif(uint8_t client_if,
   }
   return NULL;
 }
+
+/* Remember where a lookup found its entry. There are never more valid entries
+ * than the table has, beyond that the stale ones are dropped. */
+template <typename Key>
+static void bta_gattc_cache_idx(std::unordered_map<Key, uint8_t>& idx,
+                                const Key& key, uint8_t i, size_t max) {
+  if (idx.size() >= max && idx.find(key) == idx.end()) idx.clear();
+  idx[key] = i;
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_find_clcb_by_conn_id
@@ -113,12 +125,23 @@ tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_cif(uint8_t client_if,
  *
  ******************************************************************************/
 tBTA_GATTC_CLCB* bta_gattc_find_clcb_by_conn_id(uint16_t conn_id) {
-  tBTA_GATTC_CLCB* p_clcb = &bta_gattc_cb.clcb[0];
+  tBTA_GATTC_CLCB* p_clcb;
   uint8_t i;
 
-  for (i = 0; i < BTA_GATTC_CLCB_MAX; i++, p_clcb++) {
+  auto it = bta_gattc_cb.clcb_idx_by_conn_id.find(conn_id);
+  if (it != bta_gattc_cb.clcb_idx_by_conn_id.end()) {
+    p_clcb = &bta_gattc_cb.clcb[it->second];
     if (p_clcb->in_use && p_clcb->bta_conn_id == conn_id) return p_clcb;
   }
+
+  p_clcb = &bta_gattc_cb.clcb[0];
+  for (i = 0; i < BTA_GATTC_CLCB_MAX; i++, p_clcb++) {
+    if (p_clcb->in_use && p_clcb->bta_conn_id == conn_id) {
+      bta_gattc_cache_idx(bta_gattc_cb.clcb_idx_by_conn_id, conn_id, i,
+                          BTA_GATTC_CLCB_MAX);
+      return p_clcb;
+    }
+  }
   return NULL;
 }
 
@@ -148,6 +171,9 @@ tBTA_GATTC_CLCB* bta_gattc_clcb_alloc(tGATT_IF client_if,
       p_clcb->transport = transport;
       p_clcb->bda = remote_bda;
       p_clcb->p_q_cmd = NULL;
+      p_clcb->p_q_cmd_in_flight.clear();
+      p_clcb->q_cmd_time_ms.clear();
+      p_clcb->cmd_stats = {};
 
       p_clcb->p_rcb = bta_gattc_cl_get_regcb(client_if);
 
@@ -206,6 +232,7 @@ void bta_gattc_server_disconnected(tBTA_GATTC_SERV* p_srcb) {
 
     // clear reallocating
     p_srcb->gatt_database.Clear();
+    p_srcb->ccc_values_loaded = false;
   }
 }
 
@@ -237,6 +264,7 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
 
     // clear reallocating
     p_srcb->gatt_database.Clear();
+    p_srcb->ccc_values_loaded = false;
   }
 
   while (!p_clcb->p_q_cmd_queue.empty()) {
@@ -245,12 +273,19 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
     osi_free_and_reset((void**)&p_q_cmd);
   }
 
+  while (!p_clcb->p_q_cmd_in_flight.empty()) {
+    auto p_q_cmd = p_clcb->p_q_cmd_in_flight.front();
+    p_clcb->p_q_cmd_in_flight.pop_front();
+    osi_free_and_reset((void**)&p_q_cmd);
+  }
+  p_clcb->q_cmd_time_ms.clear();
+
   if (p_clcb->p_q_cmd != NULL) {
     osi_free_and_reset((void**)&p_clcb->p_q_cmd);
   }
 
-  /* Clear p_clcb. Some of the fields are already reset e.g. p_q_cmd_queue and
-   * p_q_cmd. */
+  /* Clear p_clcb. Some of the fields are already reset e.g. p_q_cmd_queue,
+   * p_q_cmd_in_flight and p_q_cmd. */
   p_clcb->bta_conn_id = 0;
   p_clcb->bda = {};
   p_clcb->transport = 0;
@@ -274,12 +309,24 @@ void bta_gattc_clcb_dealloc(tBTA_GATTC_CLCB* p_clcb) {
  *
  ******************************************************************************/
 tBTA_GATTC_SERV* bta_gattc_find_srcb(const RawAddress& bda) {
-  tBTA_GATTC_SERV* p_srcb = &bta_gattc_cb.known_server[0];
+  tBTA_GATTC_SERV* p_srcb;
   uint8_t i;
 
-  for (i = 0; i < ble_acceptlist_size(); i++, p_srcb++) {
+  auto it = bta_gattc_cb.srcb_idx_by_bda.find(bda);
+  if (it != bta_gattc_cb.srcb_idx_by_bda.end() &&
+      it->second < ble_acceptlist_size()) {
+    p_srcb = &bta_gattc_cb.known_server[it->second];
     if (p_srcb->in_use && p_srcb->server_bda == bda) return p_srcb;
   }
+
+  p_srcb = &bta_gattc_cb.known_server[0];
+  for (i = 0; i < ble_acceptlist_size(); i++, p_srcb++) {
+    if (p_srcb->in_use && p_srcb->server_bda == bda) {
+      bta_gattc_cache_idx(bta_gattc_cb.srcb_idx_by_bda, bda, i,
+                          BTA_GATTC_KNOWN_SR_MAX);
+      return p_srcb;
+    }
+  }
   return NULL;
 }
 
@@ -380,6 +427,85 @@ void bta_gattc_send_mtu_response(tBTA_GATTC_CLCB* p_clcb,
   }
 }
 
+/* Commands which can be sent while others of the same kind are in flight:
+ * reads by handle, and writes without response. */
+static bool bta_gattc_is_pipelinable(const tBTA_GATTC_CLCB* p_clcb,
+                                     const tBTA_GATTC_DATA* p_data) {
+  if (p_clcb->state != BTA_GATTC_CONN_ST ||
+      !bta_gattc_is_pipelining_enabled()) {
+    return false;
+  }
+
+  switch (p_data->hdr.event) {
+    case BTA_GATTC_API_READ_EVT:
+      return p_data->api_read.handle != 0;
+    case BTA_GATTC_API_WRITE_EVT:
+      return p_data->api_write.write_type == GATT_WRITE_NO_RSP;
+    default:
+      return false;
+  }
+}
+
+/* Check if the command can be sent with the commands in flight. Reads are
+ * limited to one per bearer and to distinct handles, so that responses can be
+ * matched to requests. Writes without response are sent in order on the
+ * first available bearer. */
+static bool bta_gattc_can_join_in_flight(const tBTA_GATTC_CLCB* p_clcb,
+                                         const tBTA_GATTC_DATA* p_data) {
+  if (p_clcb->p_q_cmd_in_flight.empty() ||
+      !bta_gattc_is_pipelinable(p_clcb, p_data) ||
+      p_clcb->p_q_cmd_in_flight.front()->hdr.event != p_data->hdr.event) {
+    return false;
+  }
+
+  size_t in_flight = p_clcb->p_q_cmd_in_flight.size();
+  if (p_data->hdr.event == BTA_GATTC_API_WRITE_EVT) {
+    return in_flight < BTA_GATTC_MAX_PIPELINED_WRITES;
+  }
+
+  if (in_flight >= GATTC_GetNumberOfBearers(p_clcb->bta_conn_id)) {
+    return false;
+  }
+
+  for (const tBTA_GATTC_DATA* p_cmd : p_clcb->p_q_cmd_in_flight) {
+    if (p_cmd->api_read.handle == p_data->api_read.handle) return false;
+  }
+  return true;
+}
+
+/* Update the command queue statistics when a command is sent */
+static void bta_gattc_cmd_sent(tBTA_GATTC_CLCB* p_clcb,
+                               const tBTA_GATTC_DATA* p_data) {
+  tBTA_GATTC_CMD_STATS& stats = p_clcb->cmd_stats;
+  size_t in_flight = p_clcb->p_q_cmd_in_flight.size();
+
+  stats.num_cmds++;
+  if (in_flight > 1) stats.num_pipelined_cmds++;
+  if (in_flight > stats.max_in_flight) stats.max_in_flight = in_flight;
+
+  auto it = p_clcb->q_cmd_time_ms.find(p_data);
+  if (it != p_clcb->q_cmd_time_ms.end()) {
+    uint64_t queue_ms =
+        bluetooth::common::time_get_os_boottime_ms() - it->second;
+    stats.num_queued_cmds++;
+    stats.total_queue_ms += queue_ms;
+    if (queue_ms > stats.max_queue_ms) stats.max_queue_ms = queue_ms;
+    p_clcb->q_cmd_time_ms.erase(it);
+  }
+}
+
+/* Send the queued commands which can join the commands in flight */
+static void bta_gattc_continue_in_flight(tBTA_GATTC_CLCB* p_clcb) {
+  while (!p_clcb->p_q_cmd_queue.empty() &&
+         bta_gattc_can_join_in_flight(p_clcb, p_clcb->p_q_cmd_queue.front())) {
+    const tBTA_GATTC_DATA* p_q_cmd = p_clcb->p_q_cmd_queue.front();
+    p_clcb->p_q_cmd_queue.pop_front();
+    p_clcb->p_q_cmd_in_flight.push_back(p_q_cmd);
+    bta_gattc_cmd_sent(p_clcb, p_q_cmd);
+    bta_gattc_sm_execute(p_clcb, p_q_cmd->hdr.event, p_q_cmd);
+  }
+}
+
 void bta_gattc_continue(tBTA_GATTC_CLCB* p_clcb) {
   if (p_clcb->p_q_cmd != NULL) {
     LOG_INFO("Already scheduled another request for conn_id = 0x%04x",
@@ -387,11 +513,20 @@ void bta_gattc_continue(tBTA_GATTC_CLCB* p_clcb) {
     return;
   }
 
+  if (!p_clcb->p_q_cmd_in_flight.empty()) {
+    /* Only commands of the same kind can be sent until these complete */
+    bta_gattc_continue_in_flight(p_clcb);
+    return;
+  }
+
   while (!p_clcb->p_q_cmd_queue.empty()) {
     const tBTA_GATTC_DATA* p_q_cmd = p_clcb->p_q_cmd_queue.front();
     if (p_q_cmd->hdr.event != BTA_GATTC_API_CFG_MTU_EVT) {
       p_clcb->p_q_cmd_queue.pop_front();
       bta_gattc_sm_execute(p_clcb, p_q_cmd->hdr.event, p_q_cmd);
+      if (!p_clcb->p_q_cmd_in_flight.empty()) {
+        bta_gattc_continue_in_flight(p_clcb);
+      }
       return;
     }
 
@@ -438,10 +573,66 @@ bool bta_gattc_is_data_queued(tBTA_GATTC_CLCB* p_clcb,
     return true;
   }
 
+  if (std::find(p_clcb->p_q_cmd_in_flight.begin(),
+                p_clcb->p_q_cmd_in_flight.end(),
+                p_data) != p_clcb->p_q_cmd_in_flight.end()) {
+    return true;
+  }
+
   auto it = std::find(p_clcb->p_q_cmd_queue.begin(),
                       p_clcb->p_q_cmd_queue.end(), p_data);
   return it != p_clcb->p_q_cmd_queue.end();
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_take_in_flight_cmd
+ *
+ * Description      Find the command in flight completed by an operation
+ *                  complete event, and make it the current command
+ *                  (p_q_cmd) so that the completion is handled as for a
+ *                  command sent alone.
+ *
+ * Returns          true if a matching command was found
+ *
+ ******************************************************************************/
+bool bta_gattc_take_in_flight_cmd(tBTA_GATTC_CLCB* p_clcb,
+                                  const tBTA_GATTC_OP_CMPL* p_data) {
+  if (p_clcb->p_q_cmd != NULL || p_data->p_cmpl == NULL) return false;
+
+  uint16_t handle = p_data->p_cmpl->att_value.handle;
+  for (auto it = p_clcb->p_q_cmd_in_flight.begin();
+       it != p_clcb->p_q_cmd_in_flight.end(); it++) {
+    const tBTA_GATTC_DATA* p_cmd = *it;
+    if ((p_data->op_code == GATTC_OPTYPE_READ &&
+         p_cmd->hdr.event == BTA_GATTC_API_READ_EVT &&
+         p_cmd->api_read.handle == handle) ||
+        (p_data->op_code == GATTC_OPTYPE_WRITE &&
+         p_cmd->hdr.event == BTA_GATTC_API_WRITE_EVT &&
+         p_cmd->api_write.handle == handle)) {
+      p_clcb->p_q_cmd = p_cmd;
+      p_clcb->p_q_cmd_in_flight.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_remove_in_flight_cmd
+ *
+ * Description      Remove a command which could not be sent from the
+ *                  commands in flight.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_remove_in_flight_cmd(tBTA_GATTC_CLCB* p_clcb,
+                                    const tBTA_GATTC_DATA* p_data) {
+  p_clcb->p_q_cmd_in_flight.remove(p_data);
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_enqueue
@@ -453,8 +644,27 @@ bool bta_gattc_is_data_queued(tBTA_GATTC_CLCB* p_clcb,
  ******************************************************************************/
 BtaEnqueuedResult_t bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb,
                                       const tBTA_GATTC_DATA* p_data) {
-  if (p_clcb->p_q_cmd == NULL) {
-    p_clcb->p_q_cmd = p_data;
+  /* Already added to the commands in flight by bta_gattc_continue */
+  if (std::find(p_clcb->p_q_cmd_in_flight.begin(),
+                p_clcb->p_q_cmd_in_flight.end(),
+                p_data) != p_clcb->p_q_cmd_in_flight.end()) {
+    return ENQUEUED_READY_TO_SEND;
+  }
+
+  if (p_clcb->p_q_cmd == NULL && p_clcb->p_q_cmd_in_flight.empty()) {
+    if (bta_gattc_is_pipelinable(p_clcb, p_data)) {
+      p_clcb->p_q_cmd_in_flight.push_back(p_data);
+    } else {
+      p_clcb->p_q_cmd = p_data;
+    }
+    bta_gattc_cmd_sent(p_clcb, p_data);
+    return ENQUEUED_READY_TO_SEND;
+  }
+
+  if (p_clcb->p_q_cmd == NULL && p_clcb->p_q_cmd_queue.empty() &&
+      bta_gattc_can_join_in_flight(p_clcb, p_data)) {
+    p_clcb->p_q_cmd_in_flight.push_back(p_data);
+    bta_gattc_cmd_sent(p_clcb, p_data);
     return ENQUEUED_READY_TO_SEND;
   }
 
@@ -463,6 +673,7 @@ BtaEnqueuedResult_t bta_gattc_enqueue(tBTA_GATTC_CLCB* p_clcb,
       "id=0x%04x",
       ADDRESS_TO_LOGGABLE_CSTR(p_clcb->bda), p_clcb->bta_conn_id);
   p_clcb->p_q_cmd_queue.push_back(p_data);
+  p_clcb->q_cmd_time_ms[p_data] = bluetooth::common::time_get_os_boottime_ms();
 
   return ENQUEUED_FOR_LATER;
 }
@@ -480,6 +691,24 @@ bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
                                     tBTA_GATTC_SERV* p_srcb,
                                     tBTA_GATTC_NOTIFY* p_notify) {
   uint8_t i;
+  std::unordered_map<uint64_t, uint8_t>* p_idx = NULL;
+  uint64_t key = 0;
+
+  if (p_clreg >= &bta_gattc_cb.cl_rcb[0] &&
+      p_clreg < &bta_gattc_cb.cl_rcb[BTA_GATTC_CL_MAX]) {
+    p_idx = &bta_gattc_cb.notif_reg_idx[p_clreg - &bta_gattc_cb.cl_rcb[0]];
+    for (uint8_t octet : p_srcb->server_bda.address) key = (key << 8) | octet;
+    key = (key << 16) | p_notify->handle;
+
+    auto it = p_idx->find(key);
+    if (it != p_idx->end()) {
+      tBTA_GATTC_NOTIF_REG* p_reg = &p_clreg->notif_reg[it->second];
+      if (p_reg->in_use && p_reg->remote_bda == p_srcb->server_bda &&
+          p_reg->handle == p_notify->handle && !p_reg->app_disconnected) {
+        return true;
+      }
+    }
+  }
 
   for (i = 0; i < BTA_GATTC_NOTIF_REG_MAX; i++) {
     if (p_clreg->notif_reg[i].in_use &&
@@ -487,6 +716,8 @@ bool bta_gattc_check_notif_registry(tBTA_GATTC_RCB* p_clreg,
         p_clreg->notif_reg[i].handle == p_notify->handle &&
         !p_clreg->notif_reg[i].app_disconnected) {
       VLOG(1) << "Notification registered!";
+      if (p_idx != NULL)
+        bta_gattc_cache_idx(*p_idx, key, i, BTA_GATTC_NOTIF_REG_MAX);
       return true;
     }
   }
@@ -811,3 +1042,59 @@ tBTA_GATTC_CLCB* bta_gattc_find_int_disconn_clcb(tBTA_GATTC_DATA* p_msg) {
 bool bta_gattc_is_robust_caching_enabled() {
   return bluetooth::common::init_flags::gatt_robust_caching_client_is_enabled();
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_is_pipelining_enabled
+ *
+ * Description      check if independent client commands of a connection can
+ *                  be sent without waiting for the previous ones to complete
+ *
+ * Returns          true if enabled; otherwise false
+ *
+ ******************************************************************************/
+bool bta_gattc_is_pipelining_enabled() {
+  return bluetooth::common::init_flags::gatt_client_pipelining_is_enabled();
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_is_parallel_discovery_enabled
+ *
+ * Description      check if the services of a server can be explored at the
+ *                  same time during service discovery
+ *
+ * Returns          true if enabled; otherwise false
+ *
+ ******************************************************************************/
+bool bta_gattc_is_parallel_discovery_enabled() {
+  return bluetooth::common::init_flags::
+      gatt_client_parallel_discovery_is_enabled();
+}
+
+#define DUMPSYS_TAG "shim::legacy::bta::gattc"
+void DumpsysBtaGattc(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  LOG_DUMPSYS(fd, " pipelining enabled:%s",
+              bta_gattc_is_pipelining_enabled() ? "true" : "false");
+  for (const tBTA_GATTC_CLCB& clcb : bta_gattc_cb.clcb) {
+    if (!clcb.in_use) continue;
+
+    const tBTA_GATTC_CMD_STATS& stats = clcb.cmd_stats;
+    uint64_t avg_queue_ms =
+        stats.num_queued_cmds ? stats.total_queue_ms / stats.num_queued_cmds
+                              : 0;
+    LOG_DUMPSYS(fd,
+                " conn_id:0x%04x in_flight:%zu queued:%zu cmds:%u "
+                "pipelined:%u max_in_flight:%u",
+                clcb.bta_conn_id,
+                clcb.p_q_cmd_in_flight.size() + (clcb.p_q_cmd ? 1 : 0),
+                clcb.p_q_cmd_queue.size(), stats.num_cmds,
+                stats.num_pipelined_cmds, stats.max_in_flight);
+    LOG_DUMPSYS(fd,
+                "   queued cmds:%u avg queue time:%llums max queue time:%llums",
+                stats.num_queued_cmds, (unsigned long long)avg_queue_ms,
+                (unsigned long long)stats.max_queue_ms);
+  }
+}
+#undef DUMPSYS_TAG
@@ -61,6 +61,87 @@ Service* FindService(std::list<Service>& services, uint16_t handle) {
   return nullptr;
 }
 
+Database::Database(const Database& other) : services(other.services) {
+  BuildIndex();
+}
+
+Database& Database::operator=(const Database& other) {
+  if (this != &other) {
+    services = other.services;
+    BuildIndex();
+  }
+  return *this;
+}
+
+void Database::BuildIndex() {
+  service_index.clear();
+  attribute_index.clear();
+  service_index.reserve(services.size());
+
+  for (const Service& service : services) {
+    service_index.push_back({service.handle, service.end_handle, &service});
+    for (const Characteristic& charac : service.characteristics) {
+      attribute_index.push_back({charac.value_handle, &charac, nullptr});
+      for (const Descriptor& desc : charac.descriptors) {
+        attribute_index.push_back({desc.handle, &charac, &desc});
+      }
+    }
+  }
+
+  // Services and attributes are usually discovered in handle order already
+  std::stable_sort(service_index.begin(), service_index.end(),
+                   [](const ServiceRange& a, const ServiceRange& b) {
+                     return a.handle < b.handle;
+                   });
+  std::stable_sort(attribute_index.begin(), attribute_index.end(),
+                   [](const AttributeEntry& a, const AttributeEntry& b) {
+                     return a.handle < b.handle;
+                   });
+}
+
+const Service* Database::FindService(uint16_t handle) const {
+  auto it = std::upper_bound(
+      service_index.begin(), service_index.end(), handle,
+      [](uint16_t handle, const ServiceRange& range) {
+        return handle < range.handle;
+      });
+  if (it == service_index.begin()) return nullptr;
+
+  --it;
+  return handle <= it->end_handle ? it->service : nullptr;
+}
+
+const Database::AttributeEntry* Database::FindAttribute(uint16_t handle) const {
+  auto it = std::lower_bound(
+      attribute_index.begin(), attribute_index.end(), handle,
+      [](const AttributeEntry& entry, uint16_t handle) {
+        return entry.handle < handle;
+      });
+  if (it == attribute_index.end() || it->handle != handle) return nullptr;
+
+  return &*it;
+}
+
+const Characteristic* Database::FindCharacteristic(uint16_t handle) const {
+  const AttributeEntry* entry = FindAttribute(handle);
+  if (!entry || entry->descriptor) return nullptr;
+
+  return entry->characteristic;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  const AttributeEntry* entry = FindAttribute(handle);
+  return entry ? entry->descriptor : nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(
+    uint16_t handle) const {
+  const AttributeEntry* entry = FindAttribute(handle);
+  if (!entry || !entry->descriptor) return nullptr;
+
+  return entry->characteristic;
+}
+
 std::string Database::ToString() const {
   std::stringstream tmp;
 
@@ -139,11 +220,17 @@ std::vector<StoredAttribute> Database::Serialize() const {
 
 Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
                                bool* success) {
+  return Deserialize(nv_attr.data(), nv_attr.size(), success);
+}
+
+Database Database::Deserialize(const StoredAttribute* nv_attr, size_t count,
+                               bool* success) {
   // clear reallocating
   Database result;
-  auto it = nv_attr.cbegin();
+  const StoredAttribute* it = nv_attr;
+  const StoredAttribute* end = nv_attr + count;
 
-  for (; it != nv_attr.cend(); ++it) {
+  for (; it != end; ++it) {
     const auto& attr = *it;
     if (attr.type != PRIMARY_SERVICE && attr.type != SECONDARY_SERVICE) break;
     result.services.emplace_back(Service{
@@ -155,7 +242,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
   }
 
   auto current_service_it = result.services.begin();
-  for (; it != nv_attr.cend(); it++) {
+  for (; it != end; it++) {
     const auto& attr = *it;
 
     // go to the service this attribute belongs to; attributes are stored in
@@ -174,8 +261,8 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
     }
 
     if (attr.type == INCLUDE) {
-      Service* included_service =
-          FindService(result.services, attr.value.included_service.handle);
+      Service* included_service = gatt::FindService(
+          result.services, attr.value.included_service.handle);
       if (!included_service) {
         LOG(ERROR) << __func__ << ": Non-existing included service!";
         *success = false;
@@ -196,6 +283,13 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       });
 
     } else {
+      if (current_service_it->characteristics.empty()) {
+        LOG(ERROR) << __func__ << ": Descriptor without characteristic: "
+                   << loghex(attr.handle);
+        *success = false;
+        return result;
+      }
+
       if (attr.type == CHARACTERISTIC_EXTENDED_PROPERTIES) {
         current_service_it->characteristics.back().descriptors.emplace_back(
             Descriptor{.handle = attr.handle,
@@ -209,6 +303,7 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       }
     }
   }
+  result.BuildIndex();
   *success = true;
   return result;
 }
@@ -102,16 +102,38 @@ class DatabaseBuilder;
 
 class Database {
  public:
+  Database() = default;
+  Database(const Database& other);
+  Database& operator=(const Database& other);
+  Database(Database&& other) = default;
+  Database& operator=(Database&& other) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::vector<ServiceRange>().swap(service_index);
+    std::vector<AttributeEntry>().swap(attribute_index);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
 
+  /* Return the service containing |handle|, or nullptr if there is none. */
+  const Service* FindService(uint16_t handle) const;
+
+  /* Return the characteristic with value handle |handle|, or nullptr. */
+  const Characteristic* FindCharacteristic(uint16_t handle) const;
+
+  /* Return the descriptor with handle |handle|, or nullptr. */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return the characteristic owning descriptor |handle|, or nullptr. */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
   std::string ToString() const;
 
   std::vector<gatt::StoredAttribute> Serialize() const;
@@ -119,13 +141,42 @@ class Database {
   static Database Deserialize(const std::vector<gatt::StoredAttribute>& nv_attr,
                               bool* success);
 
+  /* Deserialize |count| attributes stored contiguously at |nv_attr|, i.e. a
+   * memory mapped cache file, without copying them first. */
+  static Database Deserialize(const gatt::StoredAttribute* nv_attr,
+                              size_t count, bool* success);
+
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
   friend class DatabaseBuilder;
 
  private:
+  /* Handle range of a service, sorted by start handle in |service_index| */
+  struct ServiceRange {
+    uint16_t handle;
+    uint16_t end_handle;
+    const Service* service;
+  };
+
+  /* Characteristic value or descriptor, sorted by handle in |attribute_index|.
+   * |characteristic| is the characteristic itself for a value, or the owning
+   * characteristic for a descriptor. */
+  struct AttributeEntry {
+    uint16_t handle;
+    const Characteristic* characteristic;
+    const Descriptor* descriptor;
+  };
+
+  /* Rebuild the handle indexes, once |services| is complete. The indexes
+   * point into |services|, whose elements are not modified afterwards. */
+  void BuildIndex();
+
+  const AttributeEntry* FindAttribute(uint16_t handle) const;
+
   std::list<Service> services;
+  std::vector<ServiceRange> service_index;
+  std::vector<AttributeEntry> attribute_index;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
@@ -194,6 +194,43 @@ std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
   return {HANDLE_MAX, HANDLE_MAX};
 }
 
+std::vector<std::pair<uint16_t, uint16_t>>
+DatabaseBuilder::ServiceRangesToExplore() const {
+  std::vector<std::pair<uint16_t, uint16_t>> ranges;
+  for (const Service& service : database.services) {
+    // Empty service declaration, nothing to explore
+    if (service.handle == service.end_handle) continue;
+
+    ranges.emplace_back(service.handle, service.end_handle);
+  }
+  return ranges;
+}
+
+std::vector<std::pair<uint16_t, uint16_t>>
+DatabaseBuilder::DescriptorRangesToExplore() const {
+  std::vector<std::pair<uint16_t, uint16_t>> ranges;
+  for (const Service& service : database.services) {
+    for (auto it = service.characteristics.cbegin();
+         it != service.characteristics.cend(); it++) {
+      auto next = std::next(it);
+
+      /* Same as NextDescriptorRangeToExplore, descriptors are between the
+       * Characteristic Value Declaration and the next Characteristic
+       * Declaration or the end of the service */
+      uint32_t start = it->declaration_handle + 2;
+      uint32_t end = (next != service.characteristics.cend())
+                         ? next->declaration_handle - 1
+                         : service.end_handle;
+
+      // No place for descriptor - skip to next characteristic
+      if (start > end) continue;
+
+      ranges.emplace_back(start, end);
+    }
+  }
+  return ranges;
+}
+
 Descriptor* FindDescriptorByHandle(std::list<Service>& services,
                                    uint16_t handle) {
   Service* service = FindService(services, handle);
@@ -51,6 +51,18 @@ class DatabaseBuilder {
    */
   std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore();
 
+  /* Return start and end handles of all the non empty services, to discover
+   * their characteristics independently of each other. Must be called once
+   * all the services, including the secondary ones, were explored.
+   */
+  std::vector<std::pair<uint16_t, uint16_t>> ServiceRangesToExplore() const;
+
+  /* Return start and end handles of the descriptor ranges of all the
+   * characteristics, to discover them independently of each other. Must be
+   * called once all the characteristics were discovered.
+   */
+  std::vector<std::pair<uint16_t, uint16_t>> DescriptorRangesToExplore() const;
+
   /* Return vector of "Characteristic Extended Properties" descriptors that must
    * be read as part of service discovery process */
   std::vector<uint16_t> DescriptorHandlesToRead() {
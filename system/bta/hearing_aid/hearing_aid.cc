@@ -1364,8 +1364,9 @@ class HearingAidImpl : public HearingAid {
       return;
     }
 
-    std::vector<uint16_t> chan_left;
-    std::vector<uint16_t> chan_right;
+    chan_left.clear();
+    chan_right.clear();
+    chan_stereo.clear();
     if (left == nullptr || right == nullptr) {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
@@ -1380,15 +1381,16 @@ class HearingAidImpl : public HearingAid {
         chan_right.push_back(mono_data);
       }
     } else {
+      // Both channels are kept interleaved, and encoded in a single pass
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
 
-        uint16_t left = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_left.push_back(left);
+        int16_t left = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
+        chan_stereo.push_back(left);
 
         sample += 2;
-        uint16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
-        chan_right.push_back(right);
+        int16_t right = (int16_t)((*(sample + 1) << 8) + *sample) >> 1;
+        chan_stereo.push_back(right);
       }
     }
 
@@ -1396,19 +1398,33 @@ class HearingAidImpl : public HearingAid {
 
     // divide encoded data into packets, add header, send.
 
-    // TODO: make those buffers static and global to prevent constant
-    // reallocations
-    // TODO: this should basically fit the encoded data, tune the size later
-    std::vector<uint8_t> encoded_data_left;
+    // G.722 at 64 kbit/s packs two samples into a byte, so one byte per sample
+    // is an upper bound for the encoded size of each side. It is never less
+    // than one packet, which SendAudio reads in full.
+    size_t max_encoded_size = std::max<size_t>(
+        num_samples,
+        CalcCompressedAudioPacketSize(codec_in_use, default_data_interval_ms));
+    encoded_data_left.clear();
+    encoded_data_right.clear();
     auto time_point = std::chrono::steady_clock::now();
-    if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_left.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_left, encoded_data_left.data(),
-                      (const int16_t*)chan_left.data(), chan_left.size());
+    if (left && right) {
+      encoded_data_left.resize(max_encoded_size);
+      encoded_data_right.resize(max_encoded_size);
+      int encoded_size = g722_encode_stereo(
+          encoder_state_left, encoder_state_right, encoded_data_left.data(),
+          encoded_data_right.data(), chan_stereo.data(), num_samples);
       encoded_data_left.resize(encoded_size);
+      encoded_data_right.resize(encoded_size);
+    }
+
+    if (left) {
+      if (right == nullptr) {
+        encoded_data_left.resize(max_encoded_size);
+        int encoded_size =
+            g722_encode(encoder_state_left, encoded_data_left.data(),
+                        (const int16_t*)chan_left.data(), chan_left.size());
+        encoded_data_left.resize(encoded_size);
+      }
 
       uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
@@ -1434,15 +1450,14 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(left);
     }
 
-    std::vector<uint8_t> encoded_data_right;
     if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_right, encoded_data_right.data(),
-                      (const int16_t*)chan_right.data(), chan_right.size());
-      encoded_data_right.resize(encoded_size);
+      if (left == nullptr) {
+        encoded_data_right.resize(max_encoded_size);
+        int encoded_size =
+            g722_encode(encoder_state_right, encoded_data_right.data(),
+                        (const int16_t*)chan_right.data(), chan_right.size());
+        encoded_data_right.resize(encoded_size);
+      }
 
       uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
@@ -1856,6 +1871,14 @@ class HearingAidImpl : public HearingAid {
 
   HearingDevices hearingDevices;
 
+  /* Per frame scratch buffers of OnAudioDataReady. They keep their capacity
+   * between frames so that streaming does not allocate every interval. */
+  std::vector<uint16_t> chan_left;
+  std::vector<uint16_t> chan_right;
+  std::vector<int16_t> chan_stereo;
+  std::vector<uint8_t> encoded_data_left;
+  std::vector<uint8_t> encoded_data_right;
+
   void find_server_changed_ccc_handle(uint16_t conn_id,
                                       const gatt::Service* service) {
     HearingDevice* hearingDevice = hearingDevices.FindByConnId(conn_id);
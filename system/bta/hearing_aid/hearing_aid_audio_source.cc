@@ -52,6 +52,7 @@ const char* audio_ha_hw_dump_ctrl_event(tHEARING_AID_CTRL_CMD event) {
     CASE_RETURN_STR(HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_CMD_OFFLOAD_START)
+    CASE_RETURN_STR(HEARING_AID_CTRL_GET_AUDIO_RING)
     default:
       break;
   }
@@ -309,6 +310,16 @@ void hearing_aid_recv_ctrl_data() {
       break;
     }
 
+    case HEARING_AID_CTRL_GET_AUDIO_RING:
+      // The audio HAL keeps using the data socket unless a ring is sent
+      if (!UIPC_OpenRing(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO)) {
+        hearing_aid_send_ack(HEARING_AID_CTRL_ACK_UNSUPPORTED);
+        break;
+      }
+      hearing_aid_send_ack(HEARING_AID_CTRL_ACK_SUCCESS);
+      UIPC_SendRing(*uipc_hearing_aid, UIPC_CH_ID_AV_CTRL, UIPC_CH_ID_AV_AUDIO);
+      break;
+
     default:
       LOG_ERROR("UNSUPPORTED CMD: %u", cmd);
       hearing_aid_send_ack(HEARING_AID_CTRL_ACK_FAILURE);
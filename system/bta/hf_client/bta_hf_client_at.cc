@@ -1575,27 +1575,60 @@ static char* bta_hf_client_process_unknown(tBTA_HF_CLIENT_CB* client_cb,
  */
 typedef char* (*tBTA_HF_CLIENT_PARSER_CALLBACK)(tBTA_HF_CLIENT_CB*, char*);
 
-static const tBTA_HF_CLIENT_PARSER_CALLBACK bta_hf_client_parser_cb[] = {
-    bta_hf_client_parse_ok,        bta_hf_client_parse_error,
-    bta_hf_client_parse_ring,      bta_hf_client_parse_brsf,
-    bta_hf_client_parse_cind,      bta_hf_client_parse_ciev,
-    bta_hf_client_parse_chld,      bta_hf_client_parse_bcs,
-    bta_hf_client_parse_bsir,      bta_hf_client_parse_cmeerror,
-    bta_hf_client_parse_vgm,       bta_hf_client_parse_vgme,
-    bta_hf_client_parse_vgs,       bta_hf_client_parse_vgse,
-    bta_hf_client_parse_bvra,      bta_hf_client_parse_clip,
-    bta_hf_client_parse_ccwa,      bta_hf_client_parse_cops,
-    bta_hf_client_parse_binp,      bta_hf_client_parse_clcc,
-    bta_hf_client_parse_cnum,      bta_hf_client_parse_btrh,
-    bta_hf_client_parse_bind,      bta_hf_client_parse_busy,
-    bta_hf_client_parse_delayed,   bta_hf_client_parse_no_carrier,
-    bta_hf_client_parse_no_answer, bta_hf_client_parse_rejectlisted,
-    bta_hf_client_process_unknown};
+/* |event| is the prefix the parser expects after <cr><lf>, used to skip the
+ * parsers that cannot match without calling them. The parser still does the
+ * full prefix check itself. A NULL |event| is tried on every AT event.
+ */
+typedef struct {
+  const char* event;
+  tBTA_HF_CLIENT_PARSER_CALLBACK parser;
+} tBTA_HF_CLIENT_PARSER;
+
+static const tBTA_HF_CLIENT_PARSER bta_hf_client_parser_cb[] = {
+    {"OK", bta_hf_client_parse_ok},
+    {"ERROR", bta_hf_client_parse_error},
+    {"RING", bta_hf_client_parse_ring},
+    {"+BRSF:", bta_hf_client_parse_brsf},
+    {"+CIND:", bta_hf_client_parse_cind},
+    {"+CIEV:", bta_hf_client_parse_ciev},
+    {"+CHLD:", bta_hf_client_parse_chld},
+    {"+BCS:", bta_hf_client_parse_bcs},
+    {"+BSIR:", bta_hf_client_parse_bsir},
+    {"+CME ERROR:", bta_hf_client_parse_cmeerror},
+    {"+VGM:", bta_hf_client_parse_vgm},
+    {"+VGM=", bta_hf_client_parse_vgme},
+    {"+VGS:", bta_hf_client_parse_vgs},
+    {"+VGS=", bta_hf_client_parse_vgse},
+    {"+BVRA:", bta_hf_client_parse_bvra},
+    {"+CLIP:", bta_hf_client_parse_clip},
+    {"+CCWA:", bta_hf_client_parse_ccwa},
+    {"+COPS:", bta_hf_client_parse_cops},
+    {"+BINP:", bta_hf_client_parse_binp},
+    {"+CLCC:", bta_hf_client_parse_clcc},
+    {"+CNUM:", bta_hf_client_parse_cnum},
+    {"+BTRH:", bta_hf_client_parse_btrh},
+    {"+BIND:", bta_hf_client_parse_bind},
+    {"BUSY", bta_hf_client_parse_busy},
+    {"DELAYED", bta_hf_client_parse_delayed},
+    {"NO CARRIER", bta_hf_client_parse_no_carrier},
+    {"NO ANSWER", bta_hf_client_parse_no_answer},
+    {"REJECTLISTED", bta_hf_client_parse_rejectlisted},
+    {NULL, bta_hf_client_process_unknown}};
 
 /* calculate supported event list length */
 static const uint16_t bta_hf_client_parser_cb_count =
     sizeof(bta_hf_client_parser_cb) / sizeof(bta_hf_client_parser_cb[0]);
 
+/* All events are at least two characters long, so comparing the first two
+ * after <cr><lf> rules out most of the table before any parser runs.
+ */
+static bool bta_hf_client_parser_may_match(const tBTA_HF_CLIENT_PARSER* entry,
+                                           const char* buf) {
+  if (entry->event == NULL) return true;
+  return buf[0] == '\r' && buf[1] == '\n' && buf[2] == entry->event[0] &&
+         buf[3] == entry->event[1];
+}
+
 #ifdef BTA_HF_CLIENT_AT_DUMP
 static void bta_hf_client_dump_at(tBTA_HF_CLIENT_CB* client_cb) {
   char dump[(4 * BTA_HF_CLIENT_AT_PARSER_MAX_LEN) + 1];
@@ -1638,7 +1671,11 @@ static void bta_hf_client_at_parse_start(tBTA_HF_CLIENT_CB* client_cb) {
     char* tmp = NULL;
 
     for (i = 0; i < bta_hf_client_parser_cb_count; i++) {
-      tmp = bta_hf_client_parser_cb[i](client_cb, buf);
+      if (!bta_hf_client_parser_may_match(&bta_hf_client_parser_cb[i], buf)) {
+        continue;
+      }
+
+      tmp = bta_hf_client_parser_cb[i].parser(client_cb, buf);
       if (tmp == NULL) {
         APPL_TRACE_ERROR("HFPCient: AT event/reply parsing failed, skipping");
         tmp = bta_hf_client_skip_unknown(client_cb, buf);
@@ -1685,8 +1722,11 @@ static bool bta_hf_client_check_at_complete(tBTA_HF_CLIENT_CB* client_cb) {
   return ret;
 }
 
+/* Parsing stops at the first \0, so only the buffer start needs resetting. Every
+ * append below terminates the buffer at the new offset.
+ */
 static void bta_hf_client_at_clear_buf(tBTA_HF_CLIENT_CB* client_cb) {
-  memset(client_cb->at_cb.buf, 0, sizeof(client_cb->at_cb.buf));
+  client_cb->at_cb.buf[0] = '\0';
   client_cb->at_cb.offset = 0;
 }
 
@@ -1743,6 +1783,7 @@ void bta_hf_client_at_parse(tBTA_HF_CLIENT_CB* client_cb, char* buf,
     /* recover cut data */
     memcpy(client_cb->at_cb.buf, tmp_buff, tmp);
     client_cb->at_cb.offset += tmp;
+    client_cb->at_cb.buf[client_cb->at_cb.offset] = '\0';
   }
 
   /* prevent buffer overflow in cases where LEN exceeds available buffer space
@@ -1753,6 +1794,7 @@ void bta_hf_client_at_parse(tBTA_HF_CLIENT_CB* client_cb, char* buf,
 
   memcpy(client_cb->at_cb.buf + client_cb->at_cb.offset, buf, len);
   client_cb->at_cb.offset += len;
+  client_cb->at_cb.buf[client_cb->at_cb.offset] = '\0';
 
   /* If last event is complete, parsing can be started */
   if (bta_hf_client_check_at_complete(client_cb)) {
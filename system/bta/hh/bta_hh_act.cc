@@ -702,15 +702,20 @@ void bta_hh_open_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
  * Returns          void
  *
  ******************************************************************************/
-void bta_hh_data_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
-  BT_HDR* pdata = p_data->hid_cback.p_data;
+static void bta_hh_deliver_input_report(tBTA_HH_DEV_CB* p_cb,
+                                        uint8_t dev_handle, BT_HDR* pdata) {
   uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
 
-  bta_hh_co_data((uint8_t)p_data->hid_cback.hdr.layer_specific, p_rpt,
-                 pdata->len, p_cb->mode, p_cb->sub_class,
+  bta_hh_co_data(dev_handle, p_rpt, pdata->len, p_cb->mode, p_cb->sub_class,
                  p_cb->dscp_info.ctry_code, p_cb->addr, p_cb->app_id);
 
-  osi_free_and_reset((void**)&pdata);
+  osi_free(pdata);
+}
+
+void bta_hh_data_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
+  bta_hh_deliver_input_report(p_cb,
+                              (uint8_t)p_data->hid_cback.hdr.layer_specific,
+                              p_data->hid_cback.p_data);
 }
 
 /*******************************************************************************
@@ -1225,9 +1230,19 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
     case HID_HDEV_EVT_CLOSE:
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
-    case HID_HDEV_EVT_INTR_DATA:
+    case HID_HDEV_EVT_INTR_DATA: {
+      /* HID host callbacks already run on the main thread, so input reports
+       * of a connected device skip the round trip through the BTA message
+       * queue and go straight to uhid */
+      uint8_t index = bta_hh_dev_handle_to_cb_idx(dev_handle);
+      if (index != BTA_HH_IDX_INVALID &&
+          bta_hh_cb.kdev[index].state == BTA_HH_CONN_ST) {
+        bta_hh_deliver_input_report(&bta_hh_cb.kdev[index], dev_handle, pdata);
+        return;
+      }
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
+    }
     case HID_HDEV_EVT_HANDSHAKE:
       sm_event = BTA_HH_INT_HANDSK_EVT;
       break;
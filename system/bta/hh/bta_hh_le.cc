@@ -1592,9 +1592,11 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
 
   APPL_TRACE_DEBUG("Notification received on report ID: %d", p_rpt->rpt_id);
 
-  /* need to append report ID to the head of data */
+  /* need to append report ID to the head of data, use the stack rather than
+   * the heap as this runs for every input report */
+  uint8_t rpt_buf[GATT_MAX_ATTR_LEN + 1];
   if (p_rpt->rpt_id != 0) {
-    p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
+    p_buf = rpt_buf;
 
     p_buf[0] = p_rpt->rpt_id;
     memcpy(&p_buf[1], p_data->value, p_data->len);
@@ -1606,8 +1608,6 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
   bta_hh_co_data((uint8_t)p_dev_cb->hid_handle, p_buf, p_data->len,
                  p_dev_cb->mode, 0, /* no sub class*/
                  p_dev_cb->dscp_info.ctry_code, p_dev_cb->addr, app_id);
-
-  if (p_buf != p_data->value) osi_free(p_buf);
 }
 
 /*******************************************************************************
@@ -620,6 +620,10 @@ typedef void (*GATT_WRITE_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                  const uint8_t* value, void* data);
 typedef void (*GATT_CONFIGURE_MTU_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                          void* data);
+typedef void (*GATT_READ_MULTI_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
+                                      const tBTA_GATTC_MULTI& handles,
+                                      uint16_t len, uint8_t* value,
+                                      void* data);
 
 /*******************************************************************************
  *
@@ -732,6 +736,25 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if,
                                                 const RawAddress& remote_bda,
                                                 uint16_t handle);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_IsCccdWritten
+ *
+ * Description      This function tells whether a client characteristic
+ *                  configuration descriptor of a bonded server already holds
+ *                  |value|, so that writing it again can be skipped.
+ *
+ * Parameters       conn_id - connection ID.
+ *                  handle - descriptor handle.
+ *                  value - configuration the client is about to write.
+ *
+ * Returns          true if |value| was last written to the descriptor while
+ *                  bonded and the server database did not change since.
+ *
+ ******************************************************************************/
+bool BTA_GATTC_IsCccdWritten(uint16_t conn_id, uint16_t handle,
+                             uint16_t value);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_DeregisterForNotifications
@@ -793,12 +816,17 @@ void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - read multiple parameters.
+ *                    variable_len - use the Read Multiple Variable Length
+ *                                   procedure, the values are then each
+ *                                   preceded by their length.
+ *                    callback - called with the values read, as received.
  *
  * Returns          None
  *
  ******************************************************************************/
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req);
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data);
 
 /*******************************************************************************
  *
@@ -1028,4 +1056,6 @@ void BTA_GATTS_Close(uint16_t conn_id);
 // Adds bonded device for GATT server tracking service changes
 void BTA_GATTS_InitBonded(void);
 
+void DumpsysBtaGattc(int fd);
+
 #endif /* BTA_GATT_API_H */
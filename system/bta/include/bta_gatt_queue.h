@@ -30,6 +30,10 @@
  * Methods below can be used as replacement to BTA_GATTC_* in BTA app. They do
  * queue the commands if another command is currently being executed.
  *
+ * Consecutive reads are sent together: with Read Multiple Variable Length
+ * requests when the server supports them, pipelined otherwise. Each read still
+ * completes with its own callback.
+ *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
  */
@@ -64,14 +68,25 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* read-specific fields */
+    bool read_alone; /* not to be batched, its batched read failed */
   };
 
  private:
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
+  static void gatt_execute_reads(uint16_t conn_id,
+                                 std::list<gatt_operation>& gatt_ops);
+  static bool gatt_read_completed(uint16_t conn_id);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                     uint16_t handle, uint16_t len,
                                     uint8_t* value, void* data);
+  static void gatt_read_multi_op_finished(uint16_t conn_id,
+                                          tGATT_STATUS status,
+                                          const tBTA_GATTC_MULTI& handles,
+                                          uint16_t len, uint8_t* value,
+                                          void* data);
   static void gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                      uint16_t handle, uint16_t len,
                                      const uint8_t* value, void* data);
@@ -82,4 +97,8 @@ class BtaGattQueue {
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // maps connection id to the number of reads sent together not completed yet
+  static std::unordered_map<uint16_t, uint8_t> gatt_op_reads_in_flight;
+  // contain connection ids whose server rejected Read Multiple Variable Length
+  static std::unordered_set<uint16_t> gatt_op_read_multi_rejected;
 };
@@ -29,6 +29,7 @@
 #include "common/message_loop_thread.h"
 #include "hardware/bluetooth.h"
 #include "osi/include/wakelock.h"
+#include "pcm_ring_buffer.h"
 
 using ::testing::_;
 using ::testing::Assign;
@@ -539,3 +540,38 @@ TEST_F(LeAudioClientAudioTest, testAudioHalClientResume) {
   bool start_media_task = false;
   ASSERT_TRUE(sink_audio_hal_stream_cb.on_resume_(start_media_task));
 }
+
+TEST(PcmRingBufferTest, testWrapAround) {
+  le_audio::PcmRingBuffer ring;
+  ring.Reset(8);
+
+  std::vector<uint8_t> in = {1, 2, 3, 4, 5, 6};
+  std::vector<uint8_t> out(6);
+  ASSERT_EQ(ring.Write(in.data(), in.size()), 6u);
+  ASSERT_EQ(ring.Read(out.data(), 4), 4u);
+  ASSERT_EQ(ring.Size(), 2u);
+
+  /* Only 6 bytes of space left and the write has to wrap */
+  std::vector<uint8_t> more = {7, 8, 9, 10, 11, 12, 13};
+  ASSERT_EQ(ring.Write(more.data(), more.size()), 6u);
+  ASSERT_EQ(ring.Size(), 8u);
+
+  out.resize(8);
+  ASSERT_EQ(ring.Read(out.data(), out.size()), 8u);
+  ASSERT_EQ(out, std::vector<uint8_t>({5, 6, 7, 8, 9, 10, 11, 12}));
+  ASSERT_EQ(ring.Read(out.data(), out.size()), 0u);
+}
+
+TEST(PcmRingBufferTest, testProduceStopsOnShortFill) {
+  le_audio::PcmRingBuffer ring;
+  ring.Reset(16);
+
+  int calls = 0;
+  size_t produced = ring.Produce(16, [&calls](uint8_t* dst, size_t len) {
+    calls++;
+    return len / 2;
+  });
+  ASSERT_EQ(produced, 8u);
+  ASSERT_EQ(calls, 1);
+  ASSERT_EQ(ring.Size(), 8u);
+}
@@ -37,6 +37,20 @@ enum {
   HAL_STARTED,
 } le_audio_source_hal_state;
 
+struct AudioHalStats {
+  size_t media_write_total_overflow_bytes;
+  size_t media_write_total_overflow_count;
+  uint64_t media_write_last_overflow_us;
+
+  AudioHalStats() { Reset(); }
+
+  void Reset() {
+    media_write_total_overflow_bytes = 0;
+    media_write_total_overflow_count = 0;
+    media_write_last_overflow_us = 0;
+  }
+} sStats;
+
 class SinkImpl : public LeAudioSinkAudioHalClient {
  public:
   // Interface implementation
@@ -201,6 +215,8 @@ bool SinkImpl::Start(const LeAudioCodecConfiguration& codec_configuration,
            codec_configuration.num_channels, codec_configuration.sample_rate,
            codec_configuration.data_interval_us);
 
+  sStats.Reset();
+
   LeAudioClientInterface::PcmParameters pcmParameters = {
       .data_interval_us = codec_configuration.data_interval_us,
       .sample_rate = codec_configuration.sample_rate,
@@ -251,6 +267,10 @@ size_t SinkImpl::SendData(uint8_t* data, uint16_t size) {
     LOG_ERROR(
         "Not all data is written to source HAL. Bytes written: %zu, total: %d",
         bytes_written, size);
+    sStats.media_write_total_overflow_bytes += size - bytes_written;
+    sStats.media_write_total_overflow_count++;
+    sStats.media_write_last_overflow_us =
+        bluetooth::common::time_get_os_boottime_us();
   }
 
   return bytes_written;
@@ -338,6 +358,20 @@ LeAudioSinkAudioHalClient::AcquireUnicast() {
 }
 
 void LeAudioSinkAudioHalClient::DebugDump(int fd) {
-  /* TODO: Add some statistic for LeAudioSink Audio HAL interface */
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  std::stringstream stream;
+  stream << "  LE AudioHalClient Sink:"
+         << "\n    Counts (overflow)                                       : "
+         << sStats.media_write_total_overflow_count
+         << "\n    Bytes (overflow)                                        : "
+         << sStats.media_write_total_overflow_bytes
+         << "\n    Last update time ago in ms (overflow)                   : "
+         << (sStats.media_write_last_overflow_us > 0
+                 ? (unsigned long long)(now_us -
+                                        sStats.media_write_last_overflow_us) /
+                       1000
+                 : 0)
+         << std::endl;
+  dprintf(fd, "%s", stream.str().c_str());
 }
 }  // namespace le_audio
@@ -24,12 +24,20 @@
 #include "btu.h"
 #include "common/time_util.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
+#include "pcm_ring_buffer.h"
 
 using bluetooth::audio::le_audio::LeAudioClientInterface;
 
 namespace le_audio {
 namespace {
+/* How far ahead of the encoder the audio HAL is read. 0 disables it. Capped at
+ * the remote presentation delay so the added latency stays hidden in it.
+ */
+constexpr char kReadAheadMsProperty[] =
+    "persist.bluetooth.leaudio.source.read_ahead_ms";
+
 // TODO: HAL state should be in the HAL implementation
 enum {
   HAL_UNINITIALIZED,
@@ -86,9 +94,19 @@ class SourceImpl : public LeAudioSourceAudioHalClient {
   void StartAudioTicks();
   void StopAudioTicks();
   void SendAudioData();
+  uint32_t GetBytesPerTick() const;
 
   bool is_broadcaster_;
 
+  /* Filled from the HAL and drained into |frame_| on the worker thread. Both
+   * are sized in StartAudioTicks() so no allocation happens per SDU interval.
+   */
+  PcmRingBuffer read_ahead_buffer_;
+  std::vector<uint8_t> frame_;
+  uint32_t bytes_per_tick_ = 0;
+  uint32_t read_ahead_bytes_ = 0;
+  uint16_t read_ahead_ms_ = 0;
+
   bluetooth::audio::le_audio::LeAudioClientInterface::Sink* halSinkInterface_ =
       nullptr;
   LeAudioSourceAudioHalClient::Callbacks* audioSourceCallbacks_ = nullptr;
@@ -177,19 +195,23 @@ void SourceImpl::SendAudioData() {
     return;
   }
 
-  // 24 bit audio is aligned to 32bit
-  int bytes_per_sample = (source_codec_config_.bits_per_sample == 24)
-                             ? 4
-                             : (source_codec_config_.bits_per_sample / 8);
-  uint32_t bytes_per_tick =
-      (source_codec_config_.num_channels * source_codec_config_.sample_rate *
-       source_codec_config_.data_interval_us / 1000 * bytes_per_sample) /
-      1000;
-  std::vector<uint8_t> data(bytes_per_tick);
-
-  uint32_t bytes_read = halSinkInterface_->Read(data.data(), bytes_per_tick);
-  if (bytes_read < bytes_per_tick) {
-    sStats.media_read_total_underflow_bytes += bytes_per_tick - bytes_read;
+  /* Top the ring up to one frame plus the read ahead. A late tick finds the
+   * previous reads still buffered instead of waiting on the HAL.
+   */
+  size_t target = bytes_per_tick_ + read_ahead_bytes_;
+  size_t buffered = read_ahead_buffer_.Size();
+  if (buffered < target) {
+    read_ahead_buffer_.Produce(target - buffered,
+                               [this](uint8_t* dst, size_t len) -> size_t {
+                                 return halSinkInterface_->Read(dst, len);
+                               });
+  }
+
+  size_t bytes_read =
+      read_ahead_buffer_.Read(frame_.data(), bytes_per_tick_);
+  if (bytes_read < bytes_per_tick_) {
+    std::fill(frame_.begin() + bytes_read, frame_.end(), 0);
+    sStats.media_read_total_underflow_bytes += bytes_per_tick_ - bytes_read;
     sStats.media_read_total_underflow_count++;
     sStats.media_read_last_underflow_us =
         bluetooth::common::time_get_os_boottime_us();
@@ -197,10 +219,20 @@ void SourceImpl::SendAudioData() {
 
   std::lock_guard<std::mutex> guard(audioSourceCallbacksMutex_);
   if (audioSourceCallbacks_ != nullptr) {
-    audioSourceCallbacks_->OnAudioDataReady(data);
+    audioSourceCallbacks_->OnAudioDataReady(frame_);
   }
 }
 
+uint32_t SourceImpl::GetBytesPerTick() const {
+  // 24 bit audio is aligned to 32bit
+  int bytes_per_sample = (source_codec_config_.bits_per_sample == 24)
+                             ? 4
+                             : (source_codec_config_.bits_per_sample / 8);
+  return (source_codec_config_.num_channels * source_codec_config_.sample_rate *
+          source_codec_config_.data_interval_us / 1000 * bytes_per_sample) /
+         1000;
+}
+
 bool SourceImpl::InitAudioSinkThread() {
   const std::string thread_name =
       is_broadcaster_ ? "bt_le_audio_broadcast_sink_worker_thread"
@@ -224,6 +256,21 @@ bool SourceImpl::InitAudioSinkThread() {
 }
 
 void SourceImpl::StartAudioTicks() {
+  /* The worker must be idle while the buffers are resized */
+  audio_timer_.CancelAndWait();
+
+  bytes_per_tick_ = GetBytesPerTick();
+  uint32_t ticks_ahead = 0;
+  if (source_codec_config_.data_interval_us != 0) {
+    /* Round up to whole frames */
+    ticks_ahead = (read_ahead_ms_ * 1000 +
+                   source_codec_config_.data_interval_us - 1) /
+                  source_codec_config_.data_interval_us;
+  }
+  read_ahead_bytes_ = ticks_ahead * bytes_per_tick_;
+  read_ahead_buffer_.Reset(bytes_per_tick_ + read_ahead_bytes_);
+  frame_.assign(bytes_per_tick_, 0);
+
   wakelock_acquire();
   audio_timer_.SchedulePeriodic(
       worker_thread_->GetWeakPtr(), FROM_HERE,
@@ -411,8 +458,16 @@ void SourceImpl::UpdateRemoteDelay(uint16_t remote_delay_ms) {
     return;
   }
 
-  LOG_INFO();
-  halSinkInterface_->SetRemoteDelay(remote_delay_ms);
+  /* Reading ahead of the encoder adds to the delay the audio framework has to
+   * compensate for, so it is reported together with the remote one.
+   */
+  int32_t read_ahead_ms =
+      std::max(0, osi_property_get_int32(kReadAheadMsProperty, 0));
+  read_ahead_ms_ = std::min<int32_t>(read_ahead_ms, remote_delay_ms);
+
+  LOG_INFO("remote delay: %d ms, read ahead: %d ms", remote_delay_ms,
+           read_ahead_ms_);
+  halSinkInterface_->SetRemoteDelay(remote_delay_ms + read_ahead_ms_);
 }
 
 void SourceImpl::UpdateAudioConfigToHal(
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace le_audio {
+
+/* Fixed size byte ring for PCM samples, with a single producer and a single
+ * consumer which may run on different threads without locking. The storage is
+ * allocated once in Reset() so neither side allocates while streaming.
+ */
+class PcmRingBuffer {
+ public:
+  /* Drops the content and resizes the storage. Must not run concurrently with
+   * either side.
+   */
+  void Reset(size_t capacity) {
+    buffer_.assign(capacity, 0);
+    read_pos_.store(0, std::memory_order_relaxed);
+    write_pos_.store(0, std::memory_order_relaxed);
+  }
+
+  size_t Capacity() const { return buffer_.size(); }
+
+  size_t Size() const {
+    return write_pos_.load(std::memory_order_acquire) -
+           read_pos_.load(std::memory_order_acquire);
+  }
+
+  /* Producer side. Lets |fill| write up to |len| bytes straight into the free
+   * space, one contiguous region at a time. |fill| returns the number of bytes
+   * it wrote, stopping early when it returns less than it was offered.
+   */
+  template <typename FillFn>
+  size_t Produce(size_t len, FillFn fill) {
+    size_t capacity = Capacity();
+    if (capacity == 0) return 0;
+
+    size_t write_pos = write_pos_.load(std::memory_order_relaxed);
+    size_t used = write_pos - read_pos_.load(std::memory_order_acquire);
+    len = std::min(len, capacity - used);
+
+    size_t produced = 0;
+    while (produced < len) {
+      size_t offset = (write_pos + produced) % capacity;
+      size_t chunk = std::min(len - produced, capacity - offset);
+      size_t written = fill(&buffer_[offset], chunk);
+      produced += written;
+      if (written < chunk) break;
+    }
+
+    write_pos_.store(write_pos + produced, std::memory_order_release);
+    return produced;
+  }
+
+  size_t Write(const uint8_t* data, size_t len) {
+    return Produce(len, [&data](uint8_t* dst, size_t chunk) {
+      memcpy(dst, data, chunk);
+      data += chunk;
+      return chunk;
+    });
+  }
+
+  /* Consumer side. Copies out up to |len| bytes. */
+  size_t Read(uint8_t* out, size_t len) {
+    size_t capacity = Capacity();
+    if (capacity == 0) return 0;
+
+    size_t read_pos = read_pos_.load(std::memory_order_relaxed);
+    size_t used = write_pos_.load(std::memory_order_acquire) - read_pos;
+    len = std::min(len, used);
+
+    size_t consumed = 0;
+    while (consumed < len) {
+      size_t offset = (read_pos + consumed) % capacity;
+      size_t chunk = std::min(len - consumed, capacity - offset);
+      memcpy(out + consumed, &buffer_[offset], chunk);
+      consumed += chunk;
+    }
+
+    read_pos_.store(read_pos + consumed, std::memory_order_release);
+    return consumed;
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  /* Total bytes consumed and produced since Reset() */
+  std::atomic<size_t> read_pos_{0};
+  std::atomic<size_t> write_pos_{0};
+};
+
+}  // namespace le_audio
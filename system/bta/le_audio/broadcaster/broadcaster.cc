@@ -17,10 +17,14 @@
 
 #include <base/functional/bind.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <mutex>
 
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
+#include "bta/le_audio/broadcaster/encoder_pool.h"
 #include "bta/le_audio/broadcaster/state_machine.h"
 #include "bta/le_audio/content_control_id_keeper.h"
 #include "bta/le_audio/le_audio_types.h"
@@ -53,6 +57,7 @@ using le_audio::broadcaster::BroadcastCodecWrapper;
 using le_audio::broadcaster::BroadcastQosConfig;
 using le_audio::broadcaster::BroadcastStateMachine;
 using le_audio::broadcaster::BroadcastStateMachineConfig;
+using le_audio::broadcaster::EncoderWorkerPool;
 using le_audio::broadcaster::IBroadcastStateMachineCallbacks;
 using le_audio::types::AudioContexts;
 using le_audio::types::CodecLocation;
@@ -867,25 +872,46 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         return;
       }
 
-      if (enc_audio_buffers_.size() != codec_wrapper_.GetNumChannels()) {
-        enc_audio_buffers_.resize(codec_wrapper_.GetNumChannels());
-      }
-
       const int dt_us = codec_wrapper_.GetDataIntervalUs();
       const int sr_hz = codec_wrapper_.GetSampleRate();
-      const auto encoder_bytes = lc3_encoder_size(dt_us, sr_hz);
+      const auto num_channels = codec_wrapper_.GetNumChannels();
       const auto channel_bytes = codec_wrapper_.GetMaxSduSizePerChannel();
 
+      /* Keep the encoders of all the channels in a single memory block, and
+       * their output frames in a single buffer, as they are encoded together
+       * on each audio data interval.
+       */
+      const auto encoder_bytes =
+          (lc3_encoder_size(dt_us, sr_hz) + alignof(std::max_align_t) - 1) &
+          ~(alignof(std::max_align_t) - 1);
+
       /* TODO: We should act smart and reuse current configurations */
       encoders_.clear();
-      encoders_mem_.clear();
-      while (encoders_.size() < codec_wrapper_.GetNumChannels()) {
-        auto& encoder_buf = enc_audio_buffers_.at(encoders_.size());
-        encoder_buf.resize(channel_bytes);
-
-        encoders_mem_.emplace_back(malloc(encoder_bytes), &std::free);
-        encoders_.emplace_back(
-            lc3_setup_encoder(dt_us, sr_hz, 0, encoders_mem_.back().get()));
+      encoders_mem_.reset(malloc(encoder_bytes * num_channels));
+      for (uint8_t chan = 0; chan < num_channels; ++chan) {
+        encoders_.emplace_back(lc3_setup_encoder(
+            dt_us, sr_hz, 0,
+            static_cast<uint8_t*>(encoders_mem_.get()) +
+                chan * encoder_bytes));
+      }
+
+      enc_channel_bytes_ = channel_bytes;
+      enc_audio_buffer_.resize(channel_bytes * num_channels);
+
+      /* Optionally spread the channels over threads, the calling thread
+       * being one of them and encoding its share of the channels as well.
+       */
+      const int num_threads =
+          std::min(osi_property_get_int32(kEncoderThreadsProp, 0),
+                   static_cast<int>(num_channels));
+      const size_t num_workers = num_threads > 1 ? num_threads - 1 : 0;
+      if (num_workers == 0) {
+        encoder_pool_.reset();
+      } else if (!encoder_pool_ ||
+                 encoder_pool_->NumWorkers() != num_workers) {
+        LOG_INFO("Encoding %d channels on %zu worker threads", num_channels,
+                 num_workers);
+        encoder_pool_ = std::make_unique<EncoderWorkerPool>(num_workers);
       }
     }
 
@@ -897,23 +923,38 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       codec_wrapper_ = config;
     }
 
-    void encodeLc3Channel(lc3_encoder_t encoder,
-                          std::vector<uint8_t>& out_buffer,
-                          const std::vector<uint8_t>& data,
-                          int initial_channel_offset, int pitch_samples,
-                          int num_channels) {
-      auto encoder_status =
-          lc3_encode(encoder, LC3_PCM_FORMAT_S16,
-                     (int16_t*)(data.data() + initial_channel_offset),
-                     pitch_samples, out_buffer.size(), out_buffer.data());
-      if (encoder_status != 0) {
-        LOG_ERROR("Encoding error=%d", encoder_status);
+    /* Each channel is encoded in its own slot of the output buffer, the
+     * data sent afterwards does not depend on the order of completion.
+     */
+    void encodeLc3ChannelsParallel(const std::vector<uint8_t>& data) {
+      const auto num_channels = encoders_.size();
+      const auto deadline =
+          std::chrono::microseconds(codec_wrapper_.GetDataIntervalUs());
+
+      auto encode_channel = [&](size_t chan) {
+        auto encoder_status =
+            lc3_encode(encoders_[chan], LC3_PCM_FORMAT_S16,
+                       data.data() + chan * sizeof(int16_t), num_channels,
+                       enc_channel_bytes_,
+                       enc_audio_buffer_.data() + chan * enc_channel_bytes_);
+        if (encoder_status != 0) {
+          LOG_ERROR("Encoding error=%d on channel %zu", encoder_status, chan);
+        }
+      };
+
+      bool in_time =
+          encoder_pool_->Run(num_channels, encode_channel, deadline);
+
+      if (!in_time) {
+        LOG_WARN("Encoding exceeded the SDU interval of %lld us, %zu misses",
+                 static_cast<long long>(deadline.count()),
+                 encoder_pool_->NumDeadlineMisses());
       }
     }
 
     static void sendBroadcastData(
         const std::unique_ptr<BroadcastStateMachine>& broadcast,
-        std::vector<std::vector<uint8_t>>& encoded_channels) {
+        const std::vector<uint8_t>& encoded_data, size_t channel_bytes) {
       auto const& config = broadcast->GetBigConfig();
       if (config == std::nullopt) {
         LOG_ERROR(
@@ -924,15 +965,17 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         return;
       }
 
-      if (config->connection_handles.size() < encoded_channels.size()) {
+      const auto num_channels =
+          channel_bytes ? encoded_data.size() / channel_bytes : 0;
+      if (config->connection_handles.size() < num_channels) {
         LOG_ERROR("Not enough BIS'es to broadcast all channels!");
         return;
       }
 
-      for (uint8_t chan = 0; chan < encoded_channels.size(); ++chan) {
-        IsoManager::GetInstance()->SendIsoData(config->connection_handles[chan],
-                                               encoded_channels[chan].data(),
-                                               encoded_channels[chan].size());
+      for (uint8_t chan = 0; chan < num_channels; ++chan) {
+        IsoManager::GetInstance()->SendIsoData(
+            config->connection_handles[chan],
+            encoded_data.data() + chan * channel_bytes, channel_bytes);
       }
     }
 
@@ -941,15 +984,19 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
       LOG_VERBOSE("Received %zu bytes.", data.size());
 
-      /* Constants for the channel data configuration */
-      const auto num_channels = codec_wrapper_.GetNumChannels();
-      const auto bytes_per_sample = (codec_wrapper_.GetBitsPerSample() / 8);
-
-      /* Prepare encoded data for all channels */
-      for (uint8_t chan = 0; chan < num_channels; ++chan) {
-        /* TODO: Use encoder agnostic wrapper */
-        encodeLc3Channel(encoders_[chan], enc_audio_buffers_[chan], data,
-                         chan * bytes_per_sample, num_channels, num_channels);
+      /* Prepare encoded data for all channels
+       * TODO: Use encoder agnostic wrapper
+       */
+      if (encoder_pool_) {
+        encodeLc3ChannelsParallel(data);
+      } else {
+        /* Single pass over the interleaved PCM samples */
+        auto encoder_status = lc3_encode_multi(
+            encoders_.data(), encoders_.size(), LC3_PCM_FORMAT_S16,
+            data.data(), enc_channel_bytes_, enc_audio_buffer_.data());
+        if (encoder_status != 0) {
+          LOG_ERROR("Encoding error=%d", encoder_status);
+        }
       }
 
       /* Currently there is no way to broadcast multiple distinct streams.
@@ -961,7 +1008,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         if ((broadcast->GetState() ==
              BroadcastStateMachine::State::STREAMING) &&
             !broadcast->IsMuted())
-          sendBroadcastData(broadcast, enc_audio_buffers_);
+          sendBroadcastData(broadcast, enc_audio_buffer_, enc_channel_bytes_);
       }
       LOG_VERBOSE("All data sent.");
     }
@@ -1013,8 +1060,14 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
    private:
     BroadcastCodecWrapper codec_wrapper_;
     std::vector<lc3_encoder_t> encoders_;
-    std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
-    std::vector<std::vector<uint8_t>> enc_audio_buffers_;
+    std::unique_ptr<void, decltype(&std::free)> encoders_mem_{nullptr,
+                                                              &std::free};
+    std::vector<uint8_t> enc_audio_buffer_;
+    size_t enc_channel_bytes_ = 0;
+    std::unique_ptr<EncoderWorkerPool> encoder_pool_;
+
+    static constexpr char kEncoderThreadsProp[] =
+        "persist.bluetooth.leaudio.broadcast.encoder_threads";
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
@@ -225,6 +225,85 @@ void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
   UINT8_TO_STREAM(data_ptr, periodic_data.size() - 1);
 }
 
+static bool operator==(const BasicAudioAnnouncementCodecConfig& lhs,
+                       const BasicAudioAnnouncementCodecConfig& rhs) {
+  return lhs.codec_id == rhs.codec_id &&
+         lhs.vendor_company_id == rhs.vendor_company_id &&
+         lhs.vendor_codec_id == rhs.vendor_codec_id &&
+         lhs.codec_specific_params == rhs.codec_specific_params;
+}
+
+static bool operator==(const BasicAudioAnnouncementBisConfig& lhs,
+                       const BasicAudioAnnouncementBisConfig& rhs) {
+  return lhs.bis_index == rhs.bis_index &&
+         lhs.codec_specific_params == rhs.codec_specific_params;
+}
+
+/* Serializes |config| into the cache unless it holds the same one already */
+template <typename T, typename Emit>
+static void UpdateCachedLevel(T& cache, const decltype(cache.config)& config,
+                              Emit emit) {
+  if (cache.valid && cache.config == config) return;
+
+  cache.config = config;
+  cache.raw.clear();
+  emit(config, cache.raw);
+  cache.valid = true;
+}
+
+bool BasicAudioAnnouncementBuilder::Build(
+    const BasicAudioAnnouncementData& announcement) {
+  std::vector<uint8_t> periodic_data;
+  periodic_data.reserve(periodic_data_.size());
+
+  /* Same layout as PreparePeriodicData() */
+  periodic_data.resize(4);
+  uint8_t* data_ptr = periodic_data.data() + 1;
+  UINT8_TO_STREAM(data_ptr, BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE);
+  UINT16_TO_STREAM(data_ptr, kBasicAudioAnnouncementServiceUuid);
+  EmitHeader(announcement, periodic_data);
+  periodic_data.push_back(announcement.subgroup_configs.size());
+
+  subgroups_.resize(announcement.subgroup_configs.size());
+  for (size_t i = 0; i < announcement.subgroup_configs.size(); ++i) {
+    auto const& subgroup_config = announcement.subgroup_configs[i];
+    auto& cached = subgroups_[i];
+
+    UpdateCachedLevel(
+        cached.codec_config, subgroup_config.codec_config,
+        [](const BasicAudioAnnouncementCodecConfig& config,
+           std::vector<uint8_t>& raw) {
+          EmitCodecConfiguration(config, raw, nullptr);
+        });
+    UpdateCachedLevel(cached.metadata, subgroup_config.metadata, EmitMetadata);
+
+    cached.bis_configs.resize(subgroup_config.bis_configs.size());
+    for (size_t j = 0; j < subgroup_config.bis_configs.size(); ++j) {
+      UpdateCachedLevel(
+          cached.bis_configs[j], subgroup_config.bis_configs[j],
+          [](const BasicAudioAnnouncementBisConfig& config,
+             std::vector<uint8_t>& raw) { EmitBisConfigs({config}, raw); });
+    }
+
+    periodic_data.push_back(subgroup_config.bis_configs.size());
+    periodic_data.insert(periodic_data.end(), cached.codec_config.raw.begin(),
+                         cached.codec_config.raw.end());
+    periodic_data.insert(periodic_data.end(), cached.metadata.raw.begin(),
+                         cached.metadata.raw.end());
+    for (auto const& bis_config : cached.bis_configs) {
+      periodic_data.insert(periodic_data.end(), bis_config.raw.begin(),
+                           bis_config.raw.end());
+    }
+  }
+
+  data_ptr = periodic_data.data();
+  UINT8_TO_STREAM(data_ptr, periodic_data.size() - 1);
+
+  if (periodic_data == periodic_data_) return false;
+  periodic_data_ = std::move(periodic_data);
+  return true;
+}
+
 constexpr types::LeAudioCodecId kLeAudioCodecIdLc3 = {
     .coding_format = types::kLeAudioCodingFormatLC3,
     .vendor_company_id = types::kLeAudioVendorCompanyIdUndefined,
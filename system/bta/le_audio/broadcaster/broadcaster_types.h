@@ -49,6 +49,41 @@ void PreparePeriodicData(
     const bluetooth::le_audio::BasicAudioAnnouncementData& announcement,
     std::vector<uint8_t>& periodic_data);
 
+/* Builds the periodic advertising data carrying the Basic Audio Announcement
+ * (BASE) and keeps the serialized codec configurations, metadata and BIS
+ * configurations of each subgroup. An update only serializes again the parts
+ * which changed, e.g. the metadata of a subgroup on a track change, and tells
+ * whether the resulting data changed at all.
+ */
+class BasicAudioAnnouncementBuilder {
+ public:
+  /* Returns true if the periodic data differs from the previous build */
+  bool Build(
+      const bluetooth::le_audio::BasicAudioAnnouncementData& announcement);
+  const std::vector<uint8_t>& GetPeriodicData() const {
+    return periodic_data_;
+  }
+
+ private:
+  template <typename T>
+  struct CachedLevel {
+    T config;
+    std::vector<uint8_t> raw;
+    bool valid = false;
+  };
+  struct CachedSubgroup {
+    CachedLevel<bluetooth::le_audio::BasicAudioAnnouncementCodecConfig>
+        codec_config;
+    CachedLevel<std::map<uint8_t, std::vector<uint8_t>>> metadata;
+    std::vector<
+        CachedLevel<bluetooth::le_audio::BasicAudioAnnouncementBisConfig>>
+        bis_configs;
+  };
+
+  std::vector<CachedSubgroup> subgroups_;
+  std::vector<uint8_t> periodic_data_;
+};
+
 struct BroadcastCodecWrapper {
   BroadcastCodecWrapper(types::LeAudioCodecId codec_id,
                         LeAudioCodecConfiguration source_codec_config,
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_pool.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+EncoderWorkerPool::EncoderWorkerPool(size_t num_workers) {
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&EncoderWorkerPool::WorkerLoop, this);
+  }
+}
+
+EncoderWorkerPool::~EncoderWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+
+  for (auto& worker : workers_) worker.join();
+}
+
+void EncoderWorkerPool::RunTasks(uint64_t generation) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (generation_ == generation && next_task_ < num_tasks_) {
+    const Task& task = *task_;
+    size_t index = next_task_++;
+
+    lock.unlock();
+    task(index);
+    lock.lock();
+
+    if (++num_done_ == num_tasks_) done_cv_.notify_one();
+  }
+}
+
+void EncoderWorkerPool::WorkerLoop() {
+  uint64_t generation = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock,
+                     [&] { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+    }
+
+    RunTasks(generation);
+  }
+}
+
+bool EncoderWorkerPool::Run(size_t num_tasks, const Task& task,
+                            std::chrono::microseconds deadline) {
+  auto start = std::chrono::steady_clock::now();
+
+  if (num_tasks == 0) return true;
+
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    num_tasks_ = num_tasks;
+    next_task_ = 0;
+    num_done_ = 0;
+    generation = ++generation_;
+  }
+  if (num_tasks > 1) start_cv_.notify_all();
+
+  /* The calling thread takes its share of the tasks */
+  RunTasks(generation);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return num_done_ == num_tasks_; });
+    task_ = nullptr;
+  }
+
+  if (std::chrono::steady_clock::now() - start <= deadline) return true;
+
+  deadline_misses_++;
+  return false;
+}
+
+}  // namespace broadcaster
+}  // namespace le_audio
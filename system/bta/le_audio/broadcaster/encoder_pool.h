@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace le_audio {
+namespace broadcaster {
+
+/* Pool of worker threads running the encoding of independent BIS channels
+ * within an SDU interval.
+ *
+ * Run() dispatches the tasks 0 to num_tasks - 1 to the workers and to the
+ * calling thread, and returns once all of them have completed. Each task is
+ * expected to write only its own output, so that the results gathered after
+ * Run() do not depend on the scheduling of the tasks.
+ */
+class EncoderWorkerPool {
+ public:
+  using Task = std::function<void(size_t)>;
+
+  explicit EncoderWorkerPool(size_t num_workers);
+  ~EncoderWorkerPool();
+
+  EncoderWorkerPool(const EncoderWorkerPool&) = delete;
+  EncoderWorkerPool& operator=(const EncoderWorkerPool&) = delete;
+
+  /* Runs all the tasks and waits for their completion. Returns false when
+   * the completion took longer than the given deadline.
+   */
+  bool Run(size_t num_tasks, const Task& task,
+           std::chrono::microseconds deadline);
+
+  size_t NumWorkers() const { return workers_.size(); }
+
+  /* Number of runs which exceeded their deadline */
+  size_t NumDeadlineMisses() const { return deadline_misses_; }
+
+ private:
+  void WorkerLoop();
+  void RunTasks(uint64_t generation);
+
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  bool stop_ = false;
+  uint64_t generation_ = 0;
+
+  /* State of the current run, guarded by mutex_. A task is claimed by
+   * incrementing next_task_, only while generation_ is the one of the run.
+   */
+  const Task* task_ = nullptr;
+  size_t num_tasks_ = 0;
+  size_t next_task_ = 0;
+  size_t num_done_ = 0;
+
+  size_t deadline_misses_ = 0;
+};
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace le_audio {
+namespace broadcaster {
+
+TEST(EncoderWorkerPoolTest, RunsEachTaskOnce) {
+  EncoderWorkerPool pool(3);
+  ASSERT_EQ(pool.NumWorkers(), 3u);
+
+  for (size_t num_tasks : {0, 1, 2, 4, 7}) {
+    std::vector<std::atomic<int>> runs(num_tasks);
+    ASSERT_TRUE(pool.Run(
+        num_tasks, [&](size_t i) { runs[i]++; }, 1s));
+    for (auto& count : runs) ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(EncoderWorkerPoolTest, ResultsDoNotDependOnScheduling) {
+  EncoderWorkerPool pool(2);
+  std::vector<size_t> out(8);
+
+  for (int iteration = 0; iteration < 1000; iteration++) {
+    ASSERT_TRUE(pool.Run(
+        out.size(), [&](size_t i) { out[i] = i * iteration; }, 1s));
+    for (size_t i = 0; i < out.size(); i++) ASSERT_EQ(out[i], i * iteration);
+  }
+}
+
+TEST(EncoderWorkerPoolTest, RunsTasksConcurrently) {
+  EncoderWorkerPool pool(1);
+  std::atomic<int> waiting = 0;
+
+  /* Both tasks only complete once they have run at the same time */
+  ASSERT_TRUE(pool.Run(
+      2,
+      [&](size_t) {
+        waiting++;
+        while (waiting < 2) std::this_thread::yield();
+      },
+      10s));
+}
+
+TEST(EncoderWorkerPoolTest, ReportsDeadlineMisses) {
+  EncoderWorkerPool pool(1);
+
+  ASSERT_EQ(pool.NumDeadlineMisses(), 0u);
+  ASSERT_FALSE(pool.Run(
+      2, [](size_t) { std::this_thread::sleep_for(5ms); }, 1ms));
+  ASSERT_EQ(pool.NumDeadlineMisses(), 1u);
+
+  ASSERT_TRUE(pool.Run(2, [](size_t) {}, 1s));
+  ASSERT_EQ(pool.NumDeadlineMisses(), 1u);
+}
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -154,18 +154,22 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
 
     sm_config_.broadcast_name = broadcast_name;
     sm_config_.public_announcement = announcement;
+    /* Every update reprograms the controller, skip the ones not changing it */
+    if (adv_data == adv_data_) return;
+    adv_data_ = adv_data;
     advertiser_if_->SetData(advertising_sid_, false, adv_data,
                             base::DoNothing());
   }
 
   void UpdateBroadcastAnnouncement(
       bluetooth::le_audio::BasicAudioAnnouncementData announcement) override {
-    std::vector<uint8_t> periodic_data;
-    PreparePeriodicData(announcement, periodic_data);
+    bool changed = announcement_builder_.Build(announcement);
 
     sm_config_.announcement = std::move(announcement);
-    advertiser_if_->SetPeriodicAdvertisingData(advertising_sid_, periodic_data,
-                                               base::DoNothing());
+    if (!changed) return;
+    advertiser_if_->SetPeriodicAdvertisingData(
+        advertising_sid_, announcement_builder_.GetPeriodicData(),
+        base::DoNothing());
   }
 
   void ProcessMessage(Message msg, const void* data = nullptr) override {
@@ -191,6 +195,9 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   std::optional<BigConfig> active_config_;
   BroadcastStateMachineConfig sm_config_;
   bool suspending_;
+  /* Announcements currently programmed in the controller */
+  std::vector<uint8_t> adv_data_;
+  BasicAudioAnnouncementBuilder announcement_builder_;
 
   /* Message handlers for each possible state */
   typedef std::function<void(const void*)> msg_handler_t;
@@ -318,12 +325,11 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
     if (advertiser_if_ != nullptr) {
       tBTM_BLE_ADV_PARAMS adv_params;
       tBLE_PERIODIC_ADV_PARAMS periodic_params;
-      std::vector<uint8_t> adv_data;
-      std::vector<uint8_t> periodic_data;
 
+      adv_data_.clear();
       PrepareAdvertisingData(is_public, broadcast_name, broadcast_id,
-                             public_announcement, adv_data);
-      PreparePeriodicData(announcement, periodic_data);
+                             public_announcement, adv_data_);
+      announcement_builder_.Build(announcement);
 
       adv_params.adv_int_min = 0x00A0; /* 160 * 0,625 = 100ms */
       adv_params.adv_int_max = 0x0140; /* 320 * 0,625 = 200ms */
@@ -347,8 +353,9 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
       advertiser_if_->StartAdvertisingSet(
           base::Bind(&BroadcastStateMachineImpl::CreateAnnouncementCb,
                      base::Unretained(this)),
-          &adv_params, adv_data, std::vector<uint8_t>(), &periodic_params,
-          periodic_data, 0 /* duration */, 0 /* maxExtAdvEvents */,
+          &adv_params, adv_data_, std::vector<uint8_t>(), &periodic_params,
+          announcement_builder_.GetPeriodicData(), 0 /* duration */,
+          0 /* maxExtAdvEvents */,
           base::Bind(&BroadcastStateMachineImpl::CreateAnnouncementTimeoutCb,
                      base::Unretained(this)));
     }
@@ -457,6 +457,52 @@ TEST_F(StateMachineTest, UpdateAnnouncement) {
             second_len);
 }
 
+TEST_F(StateMachineTest, UpdateAnnouncementOnlyWhenChanged) {
+  EXPECT_CALL(*(sm_callbacks_.get()), OnStateMachineCreateStatus(_, true))
+      .Times(1);
+
+  auto broadcast_id = InstantiateStateMachine();
+  BroadcastCodecWrapper codec_config(
+      {.coding_format = le_audio::types::kLeAudioCodingFormatLC3,
+       .vendor_company_id = le_audio::types::kLeAudioVendorCompanyIdUndefined,
+       .vendor_codec_id = le_audio::types::kLeAudioVendorCodecIdUndefined},
+      {.num_channels = LeAudioCodecConfiguration::kChannelNumberStereo,
+       .sample_rate = LeAudioCodecConfiguration::kSampleRate16000,
+       .bits_per_sample = LeAudioCodecConfiguration::kBitsPerSample16,
+       .data_interval_us = LeAudioCodecConfiguration::kInterval10000Us},
+      32000, 40);
+
+  auto adv_sid = broadcasts_[broadcast_id]->GetAdvertisingSid();
+  std::vector<uint8_t> data;
+  EXPECT_CALL(*mock_ble_advertising_manager_,
+              SetPeriodicAdvertisingData(adv_sid, _, _))
+      .Times(2)
+      .WillRepeatedly(SaveArg<1>(&data));
+
+  std::map<uint8_t, std::vector<uint8_t>> metadata = {{0x01, {0x03}}};
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(
+      prepareAnnouncement(codec_config, metadata));
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(
+      prepareAnnouncement(codec_config, metadata));
+
+  // Only the metadata changes, the cached parts are reused as they are
+  metadata = {{0x01, {0x04}}, {0x02, {0x05, 0x06}}};
+  auto announcement = prepareAnnouncement(codec_config, metadata);
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(announcement);
+  std::vector<uint8_t> expected;
+  PreparePeriodicData(announcement, expected);
+  ASSERT_EQ(expected, data);
+
+  EXPECT_CALL(*mock_ble_advertising_manager_, SetData(adv_sid, false, _, _))
+      .Times(1);
+  bluetooth::le_audio::PublicBroadcastAnnouncementData public_announcement = {
+      .features = 0x01, .metadata = metadata};
+  for (int i = 0; i < 2; i++) {
+    broadcasts_[broadcast_id]->UpdatePublicBroadcastAnnouncement(
+        broadcast_id, test_broadcast_name, public_announcement);
+  }
+}
+
 TEST_F(StateMachineTest, ProcessMessageStartWhenConfigured) {
   EXPECT_CALL(*(sm_callbacks_.get()), OnStateMachineCreateStatus(_, true))
       .Times(1);
@@ -1651,6 +1651,9 @@ class LeAudioClientImpl : public LeAudioClient {
       /* Update supported context types including internal capabilities */
       LeAudioDeviceGroup* group = aseGroups_.FindById(leAudioDevice->group_id_);
 
+      /* The selection cache only keeps a hash of the PACs, don't rely on it */
+      if (group) group->InvalidateConfigurationCache();
+
       /* Available context map should be considered to be updated in response to
        * PACs update.
        * Read of available context during initial attribute discovery.
@@ -1685,6 +1688,9 @@ class LeAudioClientImpl : public LeAudioClient {
       /* Update supported context types including internal capabilities */
       LeAudioDeviceGroup* group = aseGroups_.FindById(leAudioDevice->group_id_);
 
+      /* The selection cache only keeps a hash of the PACs, don't rely on it */
+      if (group) group->InvalidateConfigurationCache();
+
       /* Available context map should be considered to be updated in response to
        * PACs update.
        * Read of available context during initial attribute discovery.
@@ -2959,14 +2965,13 @@ class LeAudioClientImpl : public LeAudioClient {
     return true;
   }
 
-  // mix stero signal into mono
-  std::vector<uint8_t> mono_blend(const std::vector<uint8_t>& buf,
-                                  int bytes_per_sample, size_t frames) {
-    std::vector<uint8_t> mono_out;
-    mono_out.resize(frames * bytes_per_sample);
+  // mix stero signal into mono, reusing the memory of mono_out
+  void mono_blend(const std::vector<uint8_t>& buf, int bytes_per_sample,
+                  size_t frames, std::vector<uint8_t>* mono_out) {
+    mono_out->resize(frames * bytes_per_sample);
 
     if (bytes_per_sample == 2) {
-      int16_t* out = (int16_t*)mono_out.data();
+      int16_t* out = (int16_t*)mono_out->data();
       const int16_t* in = (int16_t*)(buf.data());
       for (size_t i = 0; i < frames; ++i) {
         int accum = 0;
@@ -2976,7 +2981,7 @@ class LeAudioClientImpl : public LeAudioClient {
         *out++ = accum;
       }
     } else if (bytes_per_sample == 4) {
-      int32_t* out = (int32_t*)mono_out.data();
+      int32_t* out = (int32_t*)mono_out->data();
       const int32_t* in = (int32_t*)(buf.data());
       for (size_t i = 0; i < frames; ++i) {
         int accum = 0;
@@ -2988,7 +2993,6 @@ class LeAudioClientImpl : public LeAudioClient {
     } else {
       LOG_ERROR("Don't know how to mono blend that %d!", bytes_per_sample);
     }
-    return mono_out;
   }
 
   void PrepareAndSendToTwoCises(
@@ -3024,8 +3028,10 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    std::vector<uint8_t> chan_left_enc(byte_count, 0);
-    std::vector<uint8_t> chan_right_enc(byte_count, 0);
+    std::vector<uint8_t>& chan_left_enc = encoded_data_left_;
+    std::vector<uint8_t>& chan_right_enc = encoded_data_right_;
+    chan_left_enc.assign(byte_count, 0);
+    chan_right_enc.assign(byte_count, 0);
 
     bool mono = (left_cis_handle == 0) || (right_cis_handle == 0);
 
@@ -3036,8 +3042,9 @@ class LeAudioClientImpl : public LeAudioClient {
                  data.data() + bytes_per_sample, 2, chan_right_enc.size(),
                  chan_right_enc.data());
     } else {
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
+      std::vector<uint8_t>& mono = mono_data_;
+      mono_blend(data, bytes_per_sample, number_of_required_samples_per_channel,
+                 &mono);
       if (left_cis_handle) {
         lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
                    chan_left_enc.size(), chan_left_enc.data());
@@ -3082,13 +3089,15 @@ class LeAudioClientImpl : public LeAudioClient {
       LOG(ERROR) << __func__ << "Missing samples";
       return;
     }
-    std::vector<uint8_t> chan_encoded(num_channels * byte_count, 0);
+    std::vector<uint8_t>& chan_encoded = encoded_data_left_;
+    chan_encoded.assign(num_channels * byte_count, 0);
 
     if (num_channels == 1) {
       /* Since we always get two channels from framework, lets make it mono here
        */
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
+      std::vector<uint8_t>& mono = mono_data_;
+      mono_blend(data, bytes_per_sample, number_of_required_samples_per_channel,
+                 &mono);
 
       auto err = lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
                             byte_count, chan_encoded.data());
@@ -3433,6 +3442,14 @@ class LeAudioClientImpl : public LeAudioClient {
           lc3_setup_encoder(dt_us, sr_hz, af_hz, lc3_encoder_left_mem);
       lc3_encoder_right =
           lc3_setup_encoder(dt_us, sr_hz, af_hz, lc3_encoder_right_mem);
+
+      /* Allocate the encoding buffers now rather than on the first SDU */
+      size_t octets_per_frame = stream_conf->sink_octets_per_codec_frame;
+      uint8_t bytes_per_sample = bits_to_bytes_per_sample(
+          audio_framework_source_config.bits_per_sample);
+      encoded_data_left_.reserve(2 /* channels */ * octets_per_frame);
+      encoded_data_right_.reserve(octets_per_frame);
+      mono_data_.reserve(lc3_frame_samples(dt_us, af_hz) * bytes_per_sample);
     }
 
     le_audio_source_hal_client_->UpdateRemoteDelay(remote_delay_ms);
@@ -3526,6 +3543,10 @@ class LeAudioClientImpl : public LeAudioClient {
       lc3_encoder_right_mem = nullptr;
     }
 
+    std::vector<uint8_t>().swap(encoded_data_left_);
+    std::vector<uint8_t>().swap(encoded_data_right_);
+    std::vector<uint8_t>().swap(mono_data_);
+
     if (lc3_decoder_left_mem) {
       free(lc3_decoder_left_mem);
       lc3_decoder_left_mem = nullptr;
@@ -3601,6 +3622,7 @@ class LeAudioClientImpl : public LeAudioClient {
       dprintf(fd, ", %d ms", static_cast<int>(t));
     }
     dprintf(fd, "\n");
+    le_audio::MetricsCollector::Get()->Dump(fd);
     printCurrentStreamConfiguration(fd);
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  LE Audio Groups:\n");
@@ -5083,6 +5105,9 @@ class LeAudioClientImpl : public LeAudioClient {
     stream_setup_end_timestamp_ = bluetooth::common::time_get_os_boottime_us();
     stream_start_history_queue_.emplace_front(
         (stream_setup_end_timestamp_ - stream_setup_start_timestamp_) / 1000);
+    le_audio::MetricsCollector::Get()->OnStreamSetupCompleted(
+        active_group_id_, configuration_context_type_,
+        (stream_setup_end_timestamp_ - stream_setup_start_timestamp_) * 1000);
 
     stream_setup_end_timestamp_ = 0;
     stream_setup_start_timestamp_ = 0;
@@ -5273,6 +5298,12 @@ class LeAudioClientImpl : public LeAudioClient {
   lc3_encoder_t lc3_encoder_left;
   lc3_encoder_t lc3_encoder_right;
 
+  /* Encoder output and mono downmix buffers, reused every SDU interval so that
+   * no memory is allocated on the audio path while streaming */
+  std::vector<uint8_t> encoded_data_left_;
+  std::vector<uint8_t> encoded_data_right_;
+  std::vector<uint8_t> mono_data_;
+
   void* lc3_decoder_left_mem;
   void* lc3_decoder_right_mem;
 
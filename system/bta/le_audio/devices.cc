@@ -2059,6 +2059,56 @@ bool LeAudioDeviceGroup::IsConfigurationSupported(
   return false;
 }
 
+static void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static void HashPacs(size_t& seed,
+                     const types::PublishedAudioCapabilities& pacs) {
+  for (const auto& [handles, records] : pacs) {
+    for (const auto& record : records) {
+      HashCombine(seed, record.codec_id.coding_format);
+      HashCombine(seed, record.codec_id.vendor_company_id);
+      HashCombine(seed, record.codec_id.vendor_codec_id);
+      for (const auto& [type, value] : record.codec_spec_caps.Values()) {
+        HashCombine(seed, type);
+        for (auto octet : value) HashCombine(seed, octet);
+      }
+    }
+  }
+}
+
+/* Covers everything IsConfigurationSupported() looks at, for all the
+ * candidate configurations of the context type.
+ */
+size_t LeAudioDeviceGroup::GetConfigurationCacheKey(
+    LeAudioContextType context_type,
+    const set_configurations::AudioSetConfigurations* confs,
+    types::LeAudioConfigurationStrategy required_snk_strategy) {
+  size_t key = 0;
+  HashCombine(key, reinterpret_cast<uintptr_t>(confs));
+  HashCombine(key, static_cast<size_t>(required_snk_strategy));
+  HashCombine(key, NumOfConnected());
+  HashCombine(key, NumOfConnected(context_type));
+
+  for (auto* device = GetFirstDeviceWithActiveContext(context_type);
+       device != nullptr;
+       device = GetNextDeviceWithActiveContext(device, context_type)) {
+    for (auto octet : device->address_.address) HashCombine(key, octet);
+    HashCombine(key, device->snk_audio_locations_.to_ulong());
+    HashCombine(key, device->src_audio_locations_.to_ulong());
+    for (const auto& ase : device->ases_) HashCombine(key, ase.direction);
+    HashPacs(key, device->snk_pacs_);
+    HashPacs(key, device->src_pacs_);
+  }
+
+  return key;
+}
+
+void LeAudioDeviceGroup::InvalidateConfigurationCache(void) {
+  configuration_cache_.clear();
+}
+
 const set_configurations::AudioSetConfiguration*
 LeAudioDeviceGroup::FindFirstSupportedConfiguration(
     LeAudioContextType context_type) {
@@ -2076,17 +2126,32 @@ LeAudioDeviceGroup::FindFirstSupportedConfiguration(
     return nullptr;
   }
 
-  /* Filter out device set for each end every scenario */
-
   auto required_snk_strategy = GetGroupStrategy(Size());
+  auto key =
+      GetConfigurationCacheKey(context_type, confs, required_snk_strategy);
+  auto cached = configuration_cache_.find(context_type);
+  if (cached != configuration_cache_.end() && cached->second.key == key) {
+    configuration_cache_hits_++;
+    LOG_DEBUG("cached: %s", cached->second.conf != nullptr
+                                ? cached->second.conf->name.c_str()
+                                : "none");
+    return cached->second.conf;
+  }
+  configuration_cache_misses_++;
+
+  /* Filter out device set for each end every scenario */
+  const set_configurations::AudioSetConfiguration* found = nullptr;
   for (const auto& conf : *confs) {
     if (IsConfigurationSupported(conf, context_type, required_snk_strategy)) {
       LOG_DEBUG("found: %s", conf->name.c_str());
-      return conf;
+      found = conf;
+      break;
     }
   }
 
-  return nullptr;
+  configuration_cache_.insert_or_assign(context_type,
+                                        ConfigurationCacheEntry{key, found});
+  return found;
 }
 
 /* This method should choose aproperiate ASEs to be active and set a cached
@@ -2199,6 +2264,9 @@ void LeAudioDeviceGroup::Dump(int fd, int active_group_id) {
          << "\n"
          << "      active configuration name: "
          << (active_conf ? active_conf->name : " not set") << "\n"
+         << "      configuration cache hits/misses: "
+         << configuration_cache_hits_ << "/" << configuration_cache_misses_
+         << "\n"
          << "      stream configuration: "
          << (stream_conf.conf != nullptr ? stream_conf.conf->name : " unknown ")
          << "\n"
@@ -436,6 +436,15 @@ class LeAudioDeviceGroup {
     return group_available_contexts_;
   }
 
+  /* Drops the memoized configuration selection of every context type */
+  void InvalidateConfigurationCache(void);
+  inline uint32_t GetConfigurationCacheHits(void) const {
+    return configuration_cache_hits_;
+  }
+  inline uint32_t GetConfigurationCacheMisses(void) const {
+    return configuration_cache_misses_;
+  }
+
   bool IsInTransition(void);
   bool IsStreaming(void);
   bool IsReleasingOrIdle(void);
@@ -459,6 +468,10 @@ class LeAudioDeviceGroup {
       const set_configurations::AudioSetConfiguration* audio_set_configuration,
       types::LeAudioContextType context_type,
       types::LeAudioConfigurationStrategy required_snk_strategy);
+  size_t GetConfigurationCacheKey(
+      types::LeAudioContextType context_type,
+      const set_configurations::AudioSetConfigurations* confs,
+      types::LeAudioConfigurationStrategy required_snk_strategy);
   uint32_t GetTransportLatencyUs(uint8_t direction);
 
   /* Current configuration and metadata context types */
@@ -484,6 +497,20 @@ class LeAudioDeviceGroup {
            const set_configurations::AudioSetConfiguration*>
       available_context_to_configuration_map;
 
+  /* Result of the last configuration search per context type, along with the
+   * key of the group state it was made for. The search is only redone when
+   * the key changes, i.e. when PACs, audio locations, ASEs, available contexts
+   * or the candidate configurations change.
+   */
+  struct ConfigurationCacheEntry {
+    size_t key;
+    const set_configurations::AudioSetConfiguration* conf;
+  };
+  std::map<types::LeAudioContextType, ConfigurationCacheEntry>
+      configuration_cache_;
+  uint32_t configuration_cache_hits_ = 0;
+  uint32_t configuration_cache_misses_ = 0;
+
   types::AseState target_state_;
   types::AseState current_state_;
   std::vector<std::weak_ptr<LeAudioDevice>> leAudioDevices_;
@@ -1410,6 +1410,52 @@ TEST_F(LeAudioAseConfigurationTest, test_num_of_connected) {
   ASSERT_EQ(0, group_->NumOfConnected());
 }
 
+TEST_F(LeAudioAseConfigurationTest, test_configuration_cache) {
+  LeAudioDevice* tws_headset = AddTestDevice(2, 1);
+  tws_headset->snk_audio_locations_ = kChannelAllocationStereo;
+  tws_headset->src_audio_locations_ =
+      ::le_audio::codec_spec_conf::kLeAudioLocationFrontLeft;
+  group_->ReloadAudioLocations();
+
+  auto all_configurations =
+      ::le_audio::AudioSetConfigurationProvider::Get()->GetConfigurations(
+          LeAudioContextType::CONVERSATIONAL);
+  ASSERT_NE(nullptr, all_configurations);
+  ASSERT_NE(all_configurations->end(), all_configurations->begin());
+
+  PublishedAudioCapabilitiesBuilder snk_pac_builder, src_pac_builder;
+  for (const auto& entry : (*all_configurations->begin())->confs) {
+    if (entry.direction == kLeAudioDirectionSink) {
+      snk_pac_builder.Add(entry.codec, 1);
+    } else {
+      src_pac_builder.Add(entry.codec, 1);
+    }
+  }
+  tws_headset->snk_pacs_ = snk_pac_builder.Get();
+  tws_headset->src_pacs_ = src_pac_builder.Get();
+
+  auto conversational = AudioContexts(LeAudioContextType::CONVERSATIONAL);
+  group_->UpdateAudioContextTypeAvailability(conversational);
+  ASSERT_EQ(0u, group_->GetConfigurationCacheHits());
+  ASSERT_EQ(1u, group_->GetConfigurationCacheMisses());
+
+  /* Nothing changed, the previous search result is reused */
+  group_->UpdateAudioContextTypeAvailability(conversational);
+  ASSERT_EQ(1u, group_->GetConfigurationCacheHits());
+  ASSERT_EQ(1u, group_->GetConfigurationCacheMisses());
+
+  /* Audio location change makes the group search again */
+  tws_headset->src_audio_locations_ =
+      ::le_audio::codec_spec_conf::kLeAudioLocationFrontRight;
+  group_->UpdateAudioContextTypeAvailability(conversational);
+  ASSERT_EQ(1u, group_->GetConfigurationCacheHits());
+  ASSERT_EQ(2u, group_->GetConfigurationCacheMisses());
+
+  group_->InvalidateConfigurationCache();
+  group_->UpdateAudioContextTypeAvailability(conversational);
+  ASSERT_EQ(3u, group_->GetConfigurationCacheMisses());
+}
+
 /*
  * Failure happens when there is no matching single device scenario for dual
  * device scanario. Stereo location for single earbud seems to be invalid but
@@ -15,6 +15,11 @@
  *
  */
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <mutex>
 #include <string>
 #include <string_view>
@@ -27,6 +32,7 @@
 #include "le_audio_set_configuration_provider.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 
 using le_audio::set_configurations::AudioSetConfiguration;
 using le_audio::set_configurations::AudioSetConfigurations;
@@ -40,6 +46,12 @@ namespace le_audio {
 using ::le_audio::CodecManager;
 
 #ifdef __ANDROID__
+static const std::vector<const char*> kLeAudioSetConfigsBinary = {
+    "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+    "audio_set_configurations.bin"};
+static const std::vector<const char*> kLeAudioSetScenariosBinary = {
+    "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+    "audio_set_scenarios.bin"};
 static const std::vector<
     std::pair<const char* /*schema*/, const char* /*content*/>>
     kLeAudioSetConfigs = {
@@ -54,6 +66,10 @@ static const std::vector<
                              "/apex/com.android.btservices/etc/bluetooth/"
                              "le_audio/audio_set_scenarios.json"}};
 #else
+static const std::vector<const char*> kLeAudioSetConfigsBinary = {
+    "audio_set_configurations.bin"};
+static const std::vector<const char*> kLeAudioSetScenariosBinary = {
+    "audio_set_scenarios.bin"};
 static const std::vector<
     std::pair<const char* /*schema*/, const char* /*content*/>>
     kLeAudioSetConfigs = {
@@ -64,11 +80,60 @@ static const std::vector<
         {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
 #endif
 
+/* Forces parsing the JSON files instead of using the binary flatbuffers
+ * compiled from them at build time, e.g. to try out an edited configuration.
+ */
+static constexpr char kLeAudioSetConfigsUseJsonProperty[] =
+    "persist.bluetooth.leaudio.set_configurations.use_json";
+
+/** Read only mapping of a whole file, unmapped on destruction */
+class MappedFile {
+ public:
+  explicit MappedFile(const char* path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_ = static_cast<const uint8_t*>(addr);
+        size_ = st.st_size;
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
 /** Provides a set configurations for the given context type */
 struct AudioSetConfigurationProviderJson {
   static constexpr auto kDefaultScenario = "Media";
 
   AudioSetConfigurationProviderJson() {
+    if (!osi_property_get_bool(kLeAudioSetConfigsUseJsonProperty, false)) {
+      if (LoadBinaryContent(kLeAudioSetConfigsBinary,
+                            kLeAudioSetScenariosBinary)) {
+        return;
+      }
+      LOG_WARN("Falling back to the JSON le audio set configuration files");
+      configurations_.clear();
+      context_configurations_.clear();
+    }
+
     ASSERT_LOG(LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios),
                ": Unable to load le audio set configuration files.");
   }
@@ -424,8 +489,26 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto configurations_root = bluetooth::le_audio::GetAudioSetConfigurations(
+    return LoadConfigurationsFromBuffer(
         configurations_parser_.builder_.GetBufferPointer());
+  }
+
+  bool LoadConfigurationsFromBinaryFile(const char* binary_file) {
+    MappedFile file(binary_file);
+    if (!file.data()) return false;
+
+    flatbuffers::Verifier verifier(file.data(), file.size());
+    if (!bluetooth::le_audio::VerifyAudioSetConfigurationsBuffer(verifier)) {
+      LOG_ERROR("Invalid audio set configurations in %s", binary_file);
+      return false;
+    }
+
+    return LoadConfigurationsFromBuffer(file.data());
+  }
+
+  bool LoadConfigurationsFromBuffer(const uint8_t* buffer) {
+    auto configurations_root =
+        bluetooth::le_audio::GetAudioSetConfigurations(buffer);
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -501,8 +584,25 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto scenarios_root = bluetooth::le_audio::GetAudioSetScenarios(
+    return LoadScenariosFromBuffer(
         scenarios_parser_.builder_.GetBufferPointer());
+  }
+
+  bool LoadScenariosFromBinaryFile(const char* binary_file) {
+    MappedFile file(binary_file);
+    if (!file.data()) return false;
+
+    flatbuffers::Verifier verifier(file.data(), file.size());
+    if (!bluetooth::le_audio::VerifyAudioSetScenariosBuffer(verifier)) {
+      LOG_ERROR("Invalid audio set scenarios in %s", binary_file);
+      return false;
+    }
+
+    return LoadScenariosFromBuffer(file.data());
+  }
+
+  bool LoadScenariosFromBuffer(const uint8_t* buffer) {
+    auto scenarios_root = bluetooth::le_audio::GetAudioSetScenarios(buffer);
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
@@ -528,6 +628,22 @@ struct AudioSetConfigurationProviderJson {
     return true;
   }
 
+  /* The binary flatbuffers are compiled from the JSON files at build time and
+   * can be used as they are, without going through the flatbuffers parser.
+   * Returns false if any of them is missing or invalid.
+   */
+  bool LoadBinaryContent(const std::vector<const char*>& config_files,
+                         const std::vector<const char*>& scenario_files) {
+    for (auto file : config_files) {
+      if (!LoadConfigurationsFromBinaryFile(file)) return false;
+    }
+
+    for (auto file : scenario_files) {
+      if (!LoadScenariosFromBinaryFile(file)) return false;
+    }
+    return true;
+  }
+
   bool LoadContent(
       std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
           config_files,
@@ -16,6 +16,9 @@
 
 #include "metrics_collector.h"
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -280,6 +283,35 @@ void MetricsCollector::OnStreamEnded(int32_t group_id) {
   }
 }
 
+void MetricsCollector::OnStreamSetupCompleted(
+    int32_t group_id, le_audio::types::LeAudioContextType context_type,
+    int64_t setup_duration_nanos) {
+  if (group_id <= 0 || setup_duration_nanos < 0) return;
+  auto& stats = stream_setup_stats_[context_type];
+  stats.count++;
+  stats.last_nanos = setup_duration_nanos;
+  stats.max_nanos = std::max(stats.max_nanos, setup_duration_nanos);
+  stats.total_nanos += setup_duration_nanos;
+}
+
+const StreamSetupStats* MetricsCollector::GetStreamSetupStats(
+    le_audio::types::LeAudioContextType context_type) const {
+  auto it = stream_setup_stats_.find(context_type);
+  if (it == stream_setup_stats_.end()) return nullptr;
+  return &it->second;
+}
+
+void MetricsCollector::Dump(int fd) {
+  dprintf(fd, "  Time to first audio:\n");
+  for (const auto& [context_type, stats] : stream_setup_stats_) {
+    dprintf(fd, "    %s: count: %u, last: %d ms, avg: %d ms, max: %d ms\n",
+            types::contextTypeToStr(context_type).c_str(), stats.count,
+            static_cast<int>(stats.last_nanos / 1000000),
+            static_cast<int>(stats.total_nanos / stats.count / 1000000),
+            static_cast<int>(stats.max_nanos / 1000000));
+  }
+}
+
 void MetricsCollector::OnBroadcastStateChanged(bool started) {
   if (started) {
     broadcast_beginning_timepoint_ = std::chrono::high_resolution_clock::now();
@@ -20,6 +20,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <unordered_map>
 
@@ -81,6 +82,15 @@ class GroupMetrics {
   virtual void Flush() = 0;
 };
 
+/* Time from a stream request until the group is streaming and audio can
+ * flow, for one context type */
+struct StreamSetupStats {
+  uint32_t count = 0;
+  int64_t last_nanos = 0;
+  int64_t max_nanos = 0;
+  int64_t total_nanos = 0;
+};
+
 class MetricsCollector {
  public:
   static MetricsCollector* Get();
@@ -122,6 +132,27 @@ class MetricsCollector {
    */
   void OnStreamEnded(int32_t group_id);
 
+  /**
+   * When a requested stream is set up and the audio starts
+   *
+   * @param group_id Group ID of the associated stream.
+   * @param context_type Context type the stream was set up for.
+   * @param setup_duration_nanos Time from the stream request until the group
+   * reached the streaming state.
+   */
+  void OnStreamSetupCompleted(int32_t group_id,
+                              le_audio::types::LeAudioContextType context_type,
+                              int64_t setup_duration_nanos);
+
+  /**
+   * Time to first audio recorded for the context type, or nullptr if no stream
+   * was set up for it yet.
+   */
+  const StreamSetupStats* GetStreamSetupStats(
+      le_audio::types::LeAudioContextType context_type) const;
+
+  void Dump(int fd);
+
   /**
    * When there is a change in Bluetooth LE Audio broadcast state
    *
@@ -146,6 +177,9 @@ class MetricsCollector {
   std::unordered_map<int32_t, int32_t> group_size_table_;
 
   metrics::ClockTimePoint broadcast_beginning_timepoint_;
+
+  std::map<le_audio::types::LeAudioContextType, StreamSetupStats>
+      stream_setup_stats_;
 };
 
 }  // namespace le_audio
@@ -40,6 +40,17 @@ void MetricsCollector::OnStreamStarted(
 
 void MetricsCollector::OnStreamEnded(int32_t group_id) {}
 
+void MetricsCollector::OnStreamSetupCompleted(
+    int32_t group_id, le_audio::types::LeAudioContextType context_type,
+    int64_t setup_duration_nanos) {}
+
+const StreamSetupStats* MetricsCollector::GetStreamSetupStats(
+    le_audio::types::LeAudioContextType context_type) const {
+  return nullptr;
+}
+
+void MetricsCollector::Dump(int fd) {}
+
 void MetricsCollector::OnBroadcastStateChanged(bool started) {}
 
 void MetricsCollector::Flush() {}
@@ -373,6 +373,36 @@ TEST_F(MetricsCollectorTest, StreamingSessions) {
             static_cast<int32_t>(LeAudioMetricsContextType::COMMUNICATION));
 }
 
+TEST_F(MetricsCollectorTest, StreamSetupTimes) {
+  ASSERT_EQ(collector->GetStreamSetupStats(
+                le_audio::types::LeAudioContextType::MEDIA),
+            nullptr);
+
+  collector->OnStreamSetupCompleted(
+      group_id1, le_audio::types::LeAudioContextType::MEDIA, 300000000);
+  collector->OnStreamSetupCompleted(
+      group_id2, le_audio::types::LeAudioContextType::MEDIA, 100000000);
+  collector->OnStreamSetupCompleted(
+      group_id1, le_audio::types::LeAudioContextType::CONVERSATIONAL,
+      200000000);
+  /* Ignored, not a valid group */
+  collector->OnStreamSetupCompleted(
+      -1, le_audio::types::LeAudioContextType::MEDIA, 900000000);
+
+  auto media = collector->GetStreamSetupStats(
+      le_audio::types::LeAudioContextType::MEDIA);
+  ASSERT_NE(media, nullptr);
+  ASSERT_EQ(media->count, 2u);
+  ASSERT_EQ(media->last_nanos, 100000000);
+  ASSERT_EQ(media->max_nanos, 300000000);
+  ASSERT_EQ(media->total_nanos, 400000000);
+
+  auto conversational = collector->GetStreamSetupStats(
+      le_audio::types::LeAudioContextType::CONVERSATIONAL);
+  ASSERT_NE(conversational, nullptr);
+  ASSERT_EQ(conversational->count, 1u);
+}
+
 TEST_F(MetricsCollectorTest, BroadastSessions) {
   last_broadcast_duration_nanos = 0;
   collector->OnBroadcastStateChanged(true);
@@ -211,6 +211,7 @@ void bta_sys_deregister(uint8_t id);
 bool bta_sys_is_register(uint8_t id);
 void bta_sys_sendmsg(void* p_msg);
 void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay);
+void bta_sys_discard_pending_msgs();
 void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
                          uint16_t layer_specific);
 void bta_sys_disable();
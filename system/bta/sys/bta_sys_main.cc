@@ -28,6 +28,8 @@
 #include <base/logging.h>
 
 #include <cstring>
+#include <deque>
+#include <mutex>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/sys/bta_sys.h"
@@ -45,6 +47,12 @@ void BTIF_dm_on_hw_error();
 /* system manager control block definition */
 tBTA_SYS_CB bta_sys_cb;
 
+/* Messages sent to BTA, in the order their delivery tasks were posted. Every
+ * task runs the same closure, which delivers the oldest message, so that a
+ * message does not bind a closure of its own. */
+static std::mutex pending_msgs_mutex;
+static std::deque<BT_HDR_RIGID*> pending_msgs;
+
 /* trace level */
 /* TODO Hard-coded trace levels -  Needs to be configurable */
 uint8_t appl_trace_level = APPL_INITIAL_TRACE_LEVEL;
@@ -106,6 +114,19 @@ static void bta_sys_event(BT_HDR_RIGID* p_msg) {
   }
 }
 
+static void bta_sys_deliver_next_msg() {
+  BT_HDR_RIGID* p_msg;
+  {
+    std::lock_guard<std::mutex> lock(pending_msgs_mutex);
+    if (pending_msgs.empty()) {
+      return;
+    }
+    p_msg = pending_msgs.front();
+    pending_msgs.pop_front();
+  }
+  bta_sys_event(p_msg);
+}
+
 /*******************************************************************************
  *
  * Function         bta_sys_register
@@ -164,12 +185,35 @@ bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
  *
  ******************************************************************************/
 void bta_sys_sendmsg(void* p_msg) {
-  if (do_in_main_thread(
-          FROM_HERE,
-          base::Bind(&bta_sys_event, static_cast<BT_HDR_RIGID*>(p_msg))) !=
-      BT_STATUS_SUCCESS) {
+  static const base::RepeatingClosure deliver_next_msg =
+      base::BindRepeating(&bta_sys_deliver_next_msg);
+
+  /* The lock keeps the messages in the order of their tasks */
+  std::lock_guard<std::mutex> lock(pending_msgs_mutex);
+  pending_msgs.push_back(static_cast<BT_HDR_RIGID*>(p_msg));
+  if (do_in_main_thread(FROM_HERE, deliver_next_msg) != BT_STATUS_SUCCESS) {
     LOG(ERROR) << __func__ << ": do_in_main_thread failed";
+    pending_msgs.pop_back();
+    osi_free(p_msg);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_discard_pending_msgs
+ *
+ * Description      Free the messages whose delivery tasks were dropped with
+ *                  the main thread. Called once the main thread is shut down.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_discard_pending_msgs() {
+  std::lock_guard<std::mutex> lock(pending_msgs_mutex);
+  for (BT_HDR_RIGID* p_msg : pending_msgs) {
+    osi_free(p_msg);
   }
+  pending_msgs.clear();
 }
 
 void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay) {
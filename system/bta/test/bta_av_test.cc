@@ -87,3 +87,35 @@ TEST_F(BtaAvTest, bta_av_rc_opened) {
   };
   bta_av_rc_opened(&cb, &data);
 }
+
+TEST_F(BtaAvTest, bta_av_caps_cache) {
+  tAVDT_SEP_INFO sep_info[2] = {
+      {.in_use = false, .seid = 1, .media_type = 0, .tsep = AVDT_TSEP_SNK},
+      {.in_use = true, .seid = 2, .media_type = 0, .tsep = AVDT_TSEP_SNK},
+  };
+  AvdtpSepConfig cap;
+  cap.num_codec = 1;
+  cap.codec_info[0] = 0x42;
+
+  bta_av_caps_cache_update_seps(kRawAddress, sep_info, 2);
+  bta_av_caps_cache_put(kRawAddress, 2, true, cap);
+
+  AvdtpSepConfig cached;
+  ASSERT_TRUE(bta_av_caps_cache_get(kRawAddress, 2, true, &cached));
+  ASSERT_EQ(0x42, cached.codec_info[0]);
+  ASSERT_FALSE(bta_av_caps_cache_get(kRawAddress, 1, true, &cached));
+  ASSERT_FALSE(bta_av_caps_cache_get(kRawAddress, 2, false, &cached));
+
+  // Streams opened by another device don't change the capabilities
+  sep_info[1].in_use = false;
+  bta_av_caps_cache_update_seps(kRawAddress, sep_info, 2);
+  ASSERT_TRUE(bta_av_caps_cache_get(kRawAddress, 2, true, &cached));
+
+  sep_info[1].seid = 3;
+  bta_av_caps_cache_update_seps(kRawAddress, sep_info, 2);
+  ASSERT_FALSE(bta_av_caps_cache_get(kRawAddress, 2, true, &cached));
+
+  bta_av_caps_cache_put(kRawAddress, 3, true, cap);
+  bta_av_caps_cache_remove(kRawAddress);
+  ASSERT_FALSE(bta_av_caps_cache_get(kRawAddress, 3, true, &cached));
+}
@@ -26,6 +26,7 @@
 #include "bta/include/bta_dm_api.h"
 #include "bta/include/bta_hf_client_api.h"
 #include "btif/include/stack_manager.h"
+#include "common/time_util.h"
 #include "common/message_loop_thread.h"
 #include "osi/include/compat.h"
 #include "stack/include/btm_status.h"
@@ -250,6 +251,13 @@ void bta_dm_remname_cback(const tBTM_REMOTE_DEV_NAME* p);
 tBT_TRANSPORT bta_dm_determine_discovery_transport(
     const RawAddress& remote_bd_addr);
 
+uint64_t bta_dm_pm_adapt_sniff_timeout(const RawAddress& peer_addr,
+                                       uint64_t timeout_ms);
+bool bta_dm_pm_defer_sniff(tBTA_DM_PEER_DEVICE* p_peer_dev);
+uint16_t bta_dm_pm_adapt_interval(const RawAddress& peer_addr,
+                                  const char* name, uint16_t slots,
+                                  uint16_t min_slots);
+
 }  // namespace testing
 }  // namespace legacy
 }  // namespace bluetooth
@@ -525,3 +533,89 @@ TEST_F(BtaDmTest, bta_dm_search_evt_text) {
           static_cast<tBTA_DM_SEARCH_EVT>(std::numeric_limits<uint8_t>::max()))
           .c_str());
 }
+
+TEST_F(BtaDmTest, bta_dm_pm_adapt_sniff_timeout) {
+  tACL_TRAFFIC_STATS stats{
+      .last_packet_ms = 0,
+      .idle_gap_ms = 10000,
+      .idle_gap_var_ms = 1000,
+      .num_idle_gaps = 8,
+  };
+  test::mock::stack_acl::acl_get_traffic_stats.body =
+      [&stats](const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats) {
+        *p_stats = stats;
+        return true;
+      };
+
+  /* idle periods of at least 8s enter sniff sooner */
+  ASSERT_EQ(1500u, bluetooth::legacy::testing::bta_dm_pm_adapt_sniff_timeout(
+                       kRawAddress, 3000));
+  ASSERT_EQ(1000u, bluetooth::legacy::testing::bta_dm_pm_adapt_sniff_timeout(
+                       kRawAddress, 1200));
+  ASSERT_EQ(5000u, bluetooth::legacy::testing::bta_dm_pm_adapt_sniff_timeout(
+                       kRawAddress, 5000));
+
+  /* not enough history to predict */
+  stats.num_idle_gaps = 1;
+  ASSERT_EQ(3000u, bluetooth::legacy::testing::bta_dm_pm_adapt_sniff_timeout(
+                       kRawAddress, 3000));
+
+  test::mock::stack_acl::acl_get_traffic_stats = {};
+  ASSERT_EQ(3000u, bluetooth::legacy::testing::bta_dm_pm_adapt_sniff_timeout(
+                       kRawAddress, 3000));
+  ASSERT_FALSE(bta_dm_pm_history().empty());
+}
+
+TEST_F(BtaDmTest, bta_dm_pm_adapt_interval) {
+  tACL_TRAFFIC_STATS stats{
+      .last_packet_ms = 0,
+      .idle_gap_ms = 300,
+      .idle_gap_var_ms = 50,
+      .num_idle_gaps = 8,
+  };
+  test::mock::stack_acl::acl_get_traffic_stats.body =
+      [&stats](const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats) {
+        *p_stats = stats;
+        return true;
+      };
+
+  /* 200ms of predicted idle time are 320 slots */
+  ASSERT_EQ(320u, bluetooth::legacy::testing::bta_dm_pm_adapt_interval(
+                      kRawAddress, "test", 800, 100));
+  ASSERT_EQ(400u, bluetooth::legacy::testing::bta_dm_pm_adapt_interval(
+                      kRawAddress, "test", 800, 400));
+  ASSERT_EQ(200u, bluetooth::legacy::testing::bta_dm_pm_adapt_interval(
+                      kRawAddress, "test", 200, 100));
+
+  /* unpredictable idle time */
+  stats.idle_gap_var_ms = 200;
+  ASSERT_EQ(800u, bluetooth::legacy::testing::bta_dm_pm_adapt_interval(
+                      kRawAddress, "test", 800, 100));
+
+  test::mock::stack_acl::acl_get_traffic_stats = {};
+}
+
+TEST_F(BtaDmTest, bta_dm_pm_defer_sniff) {
+  tACL_TRAFFIC_STATS stats{
+      .last_packet_ms = bluetooth::common::time_get_os_boottime_ms(),
+  };
+  test::mock::stack_acl::acl_get_traffic_stats.body =
+      [&stats](const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats) {
+        *p_stats = stats;
+        return true;
+      };
+  tBTA_DM_PEER_DEVICE device{};
+  device.peer_bdaddr = kRawAddress;
+
+  /* traffic right now, sniff is deferred a limited number of times */
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(bluetooth::legacy::testing::bta_dm_pm_defer_sniff(&device));
+  }
+  ASSERT_FALSE(bluetooth::legacy::testing::bta_dm_pm_defer_sniff(&device));
+
+  device.pm_sniff_deferrals = 0;
+  stats.last_packet_ms = 0;
+  ASSERT_FALSE(bluetooth::legacy::testing::bta_dm_pm_defer_sniff(&device));
+
+  test::mock::stack_acl::acl_get_traffic_stats = {};
+}
@@ -297,3 +297,101 @@ TEST_F(BtaGattTest, bta_gattc_op_cmpl_read_interrupted) {
   bta_gattc_op_cmpl(&client_channel_control_block, &data);
   ASSERT_EQ(GATT_ERROR, param::bta_gatt_read_complete_callback.status);
 }
+
+TEST_F(BtaGattTest, bta_gattc_op_cmpl_read_in_flight) {
+  tBTA_GATTC_DATA other_command = {
+      .api_read =  // tBTA_GATTC_API_READ
+      {
+          .hdr =
+              {
+                  .event = BTA_GATTC_API_READ_EVT,
+              },
+          .handle = 123,
+          .read_cb = bta_gatt_read_complete_callback,
+          .read_cb_data = nullptr,
+      },
+  };
+  command_queue = {
+      .api_read =  // tBTA_GATTC_API_READ
+      {
+          .hdr =
+              {
+                  .event = BTA_GATTC_API_READ_EVT,
+              },
+          .handle = 2,
+          .read_cb = bta_gatt_read_complete_callback,
+          .read_cb_data = static_cast<void*>(this),
+      },
+  };
+
+  client_channel_control_block.p_q_cmd = nullptr;
+  client_channel_control_block.p_q_cmd_in_flight = {&other_command,
+                                                    &command_queue};
+
+  tBTA_GATTC_DATA data = {
+      .op_cmpl =
+          {
+              .op_code = GATTC_OPTYPE_READ,
+              .status = GATT_SUCCESS,
+              .p_cmpl = &gatt_cl_complete,
+          },
+  };
+
+  // The response is matched to the read of the handle it carries
+  bta_gattc_op_cmpl(&client_channel_control_block, &data);
+  ASSERT_EQ(1, get_func_call_count("osi_free_and_reset"));
+  ASSERT_EQ(GATT_SUCCESS, param::bta_gatt_read_complete_callback.status);
+  ASSERT_EQ(2, param::bta_gatt_read_complete_callback.handle);
+  ASSERT_EQ(this, param::bta_gatt_read_complete_callback.data);
+  ASSERT_EQ(1UL, client_channel_control_block.p_q_cmd_in_flight.size());
+  ASSERT_EQ(&other_command,
+            client_channel_control_block.p_q_cmd_in_flight.front());
+
+  // A response which does not match any command in flight is ignored
+  client_channel_control_block.p_q_cmd = nullptr;  // not reset by the mock
+  param::bta_gatt_read_complete_callback = {};
+  gatt_cl_complete.att_value.handle = 7;
+  bta_gattc_op_cmpl(&client_channel_control_block, &data);
+  ASSERT_EQ(1, get_func_call_count("osi_free_and_reset"));
+  ASSERT_EQ(nullptr, param::bta_gatt_read_complete_callback.value);
+  ASSERT_EQ(1UL, client_channel_control_block.p_q_cmd_in_flight.size());
+}
+
+TEST_F(BtaGattTest, bta_gattc_lookups_follow_table_changes) {
+  bta_gattc_cb = tBTA_GATTC_CB();
+
+  bta_gattc_cb.clcb[3].in_use = true;
+  bta_gattc_cb.clcb[3].bta_conn_id = 0x42;
+  ASSERT_EQ(&bta_gattc_cb.clcb[3], bta_gattc_find_clcb_by_conn_id(0x42));
+  ASSERT_EQ(&bta_gattc_cb.clcb[3], bta_gattc_find_clcb_by_conn_id(0x42));
+
+  // The connection moved to another control block
+  bta_gattc_cb.clcb[3].in_use = false;
+  bta_gattc_cb.clcb[5].in_use = true;
+  bta_gattc_cb.clcb[5].bta_conn_id = 0x42;
+  ASSERT_EQ(&bta_gattc_cb.clcb[5], bta_gattc_find_clcb_by_conn_id(0x42));
+  bta_gattc_cb.clcb[5].in_use = false;
+  ASSERT_EQ(nullptr, bta_gattc_find_clcb_by_conn_id(0x42));
+
+  tBTA_GATTC_RCB* p_clreg = &bta_gattc_cb.cl_rcb[1];
+  tBTA_GATTC_SERV* p_srcb = &bta_gattc_cb.known_server[0];
+  p_srcb->server_bda = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+  tBTA_GATTC_NOTIFY notify = {};
+  notify.handle = 0x10;
+
+  p_clreg->notif_reg[7].in_use = true;
+  p_clreg->notif_reg[7].remote_bda = p_srcb->server_bda;
+  p_clreg->notif_reg[7].handle = 0x10;
+  ASSERT_TRUE(bta_gattc_check_notif_registry(p_clreg, p_srcb, &notify));
+  ASSERT_TRUE(bta_gattc_check_notif_registry(p_clreg, p_srcb, &notify));
+
+  p_clreg->notif_reg[7].app_disconnected = true;
+  ASSERT_FALSE(bta_gattc_check_notif_registry(p_clreg, p_srcb, &notify));
+  p_clreg->notif_reg[7] = {};
+  p_clreg->notif_reg[2].in_use = true;
+  p_clreg->notif_reg[2].remote_bda = p_srcb->server_bda;
+  p_clreg->notif_reg[2].handle = 0x10;
+  ASSERT_TRUE(bta_gattc_check_notif_registry(p_clreg, p_srcb, &notify));
+  notify.handle = 0x11;
+  ASSERT_FALSE(bta_gattc_check_notif_registry(p_clreg, p_srcb, &notify));
+}
@@ -99,6 +99,12 @@ tGATT_STATUS BTA_GATTC_RegisterForNotifications(tGATT_IF client_if,
                                                   handle);
 }
 
+bool BTA_GATTC_IsCccdWritten(uint16_t conn_id, uint16_t handle,
+                             uint16_t value) {
+  LOG_ASSERT(gatt_interface) << "Mock GATT interface not set!";
+  return gatt_interface->IsCccdWritten(conn_id, handle, value);
+}
+
 tGATT_STATUS BTA_GATTC_DeregisterForNotifications(tGATT_IF client_if,
                                                   const RawAddress& remote_bda,
                                                   uint16_t handle) {
@@ -52,6 +52,8 @@ class BtaGattInterface {
   virtual tGATT_STATUS DeregisterForNotifications(tGATT_IF client_if,
                                                   const RawAddress& remote_bda,
                                                   uint16_t handle) = 0;
+  virtual bool IsCccdWritten(uint16_t conn_id, uint16_t handle,
+                             uint16_t value) = 0;
   virtual ~BtaGattInterface() = default;
 };
 
@@ -89,6 +91,8 @@ class MockBtaGattInterface : public BtaGattInterface {
   MOCK_METHOD((tGATT_STATUS), DeregisterForNotifications,
               (tGATT_IF client_if, const RawAddress& remote_bda,
                uint16_t handle));
+  MOCK_METHOD((bool), IsCccdWritten,
+              (uint16_t conn_id, uint16_t handle, uint16_t value));
 };
 
 /**
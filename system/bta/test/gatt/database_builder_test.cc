@@ -178,4 +178,48 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   ASSERT_EQ(service, result.Services().end());
 }
 
+/* Verify that the ranges to explore when discovering several services at once
+ * match the ranges explored one service at a time */
+TEST(DatabaseBuilderTest, ParallelExplorationRangesTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x0001, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddService(0x0020, 0x002f, SERVICE_3_UUID, true);
+
+  std::vector<std::pair<uint16_t, uint16_t>> services =
+      builder.ServiceRangesToExplore();
+  ASSERT_EQ(services.size(), (size_t)2);
+  ASSERT_EQ(services[0], make_pair_u16(0x0010, 0x001f));
+  ASSERT_EQ(services[1], make_pair_u16(0x0020, 0x002f));
+
+  // Characteristics of both services are discovered at the same time
+  builder.AddCharacteristic(0x0021, 0x0022, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0024, 0x0025, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0013, 0x0014, SERVICE_1_CHAR_1_UUID, 0x02);
+
+  std::vector<std::pair<uint16_t, uint16_t>> descriptors =
+      builder.DescriptorRangesToExplore();
+  ASSERT_EQ(descriptors.size(), (size_t)3);
+  ASSERT_EQ(descriptors[0], make_pair_u16(0x0015, 0x001f));
+  ASSERT_EQ(descriptors[1], make_pair_u16(0x0023, 0x0023));
+  ASSERT_EQ(descriptors[2], make_pair_u16(0x0026, 0x002f));
+
+  builder.AddDescriptor(0x0026, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0015, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0023, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database result = builder.Build();
+  auto service = std::next(result.Services().begin());
+  ASSERT_EQ(service->characteristics.size(), (size_t)2);
+  ASSERT_TRUE(service->characteristics[0].descriptors.empty());
+  ASSERT_EQ(service->characteristics[1].descriptors[0].handle, 0x0015);
+
+  service++;
+  ASSERT_EQ(service->characteristics.size(), (size_t)2);
+  ASSERT_EQ(service->characteristics[0].descriptors[0].handle, 0x0023);
+  ASSERT_EQ(service->characteristics[1].descriptors[0].handle, 0x0026);
+}
+
 }  // namespace gatt
@@ -290,4 +290,72 @@ TEST(GattCacheTest,
   // LOG(ERROR) << " " << base::HexEncode(&attr, len);
   EXPECT_EQ(memcmp(binary_form, &attr, len), 0);
 }
+
+/* This test makes sure that attributes stored contiguously, as in a memory
+ * mapped cache file, deserialize into the original database. */
+TEST(GattDatabaseTest, deserialize_in_place_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, false);
+  builder.AddIncludedService(0x0002, SERVICE_2_UUID, 0x0010, 0x001f);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database db = builder.Build();
+  std::vector<StoredAttribute> serialized = db.Serialize();
+
+  bool success = false;
+  Database result =
+      Database::Deserialize(serialized.data(), serialized.size(), &success);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(result.ToString(), db.ToString());
+
+  // A descriptor must follow a characteristic of its service.
+  success = true;
+  Database::Deserialize(serialized.data(), 2, &success);
+  EXPECT_TRUE(success);
+  StoredAttribute descriptor = serialized[4];
+  serialized.erase(serialized.begin() + 2, serialized.end());
+  serialized.push_back(descriptor);
+  Database::Deserialize(serialized.data(), serialized.size(), &success);
+  EXPECT_FALSE(success);
+}
+
+/* This test makes sure that attributes are found by handle, also in copies of
+ * the database. */
+TEST(GattDatabaseTest, find_by_handle_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, false);
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x10);
+
+  Database db = builder.Build();
+
+  EXPECT_EQ(db.FindService(0x0000), nullptr);
+  EXPECT_EQ(db.FindService(0x0001)->uuid, SERVICE_1_UUID);
+  EXPECT_EQ(db.FindService(0x000f)->uuid, SERVICE_1_UUID);
+  EXPECT_EQ(db.FindService(0x0012)->uuid, SERVICE_2_UUID);
+  EXPECT_EQ(db.FindService(0x0020), nullptr);
+
+  EXPECT_EQ(db.FindCharacteristic(0x0004)->declaration_handle, 0x0003);
+  EXPECT_EQ(db.FindCharacteristic(0x0012)->declaration_handle, 0x0011);
+  EXPECT_EQ(db.FindCharacteristic(0x0003), nullptr);
+  EXPECT_EQ(db.FindCharacteristic(0x0005), nullptr);
+
+  EXPECT_EQ(db.FindDescriptor(0x0005)->uuid, SERVICE_1_CHAR_1_DESC_1_UUID);
+  EXPECT_EQ(db.FindDescriptor(0x0004), nullptr);
+  EXPECT_EQ(db.FindOwningCharacteristic(0x0005)->value_handle, 0x0004);
+  EXPECT_EQ(db.FindOwningCharacteristic(0x0004), nullptr);
+
+  Database copy;
+  copy = db;
+  db.Clear();
+  EXPECT_EQ(db.FindCharacteristic(0x0004), nullptr);
+  const Characteristic* charac = copy.FindCharacteristic(0x0004);
+  ASSERT_NE(charac, nullptr);
+  EXPECT_EQ(charac, &copy.Services().front().characteristics.front());
+  EXPECT_EQ(copy.FindDescriptor(0x0005), &charac->descriptors.front());
+}
 }  // namespace gatt
@@ -237,6 +237,13 @@ bool VolumeControlDevice::subscribe_for_notifications(tGATT_IF gatt_if,
     return false;
   }
 
+  /* A bonded server kept the configuration since the last connection */
+  if (BTA_GATTC_IsCccdWritten(connection_id, ccc_handle,
+                              GATT_CHAR_CLIENT_CONFIG_NOTIFICATION)) {
+    handles_pending.erase(ccc_handle);
+    return true;
+  }
+
   std::vector<uint8_t> value(2);
   uint8_t* ptr = value.data();
   UINT16_TO_STREAM(ptr, GATT_CHAR_CLIENT_CONFIG_NOTIFICATION);
@@ -491,6 +491,47 @@ TEST_F(VolumeControlDeviceTest, test_enqueue_initial_requests) {
                                                  cccd_write_cb));
 };
 
+TEST_F(VolumeControlDeviceTest, test_enqueue_initial_requests_bonded) {
+  SetSampleDatabase1();
+
+  tGATT_IF gatt_if = 0x0001;
+  std::map<uint16_t, uint16_t> expected_to_read_write{
+      {0x0011, 0x0012} /* volume control state */,
+      {0x0062, 0x0063} /* volume offset state 1 */,
+      {0x0082, 0x0083} /* volume offset state 2 */};
+
+  // The bonded server kept the configuration, only the states are read
+  ON_CALL(gatt_interface,
+          IsCccdWritten(_, _, GATT_CHAR_CLIENT_CONFIG_NOTIFICATION))
+      .WillByDefault(Return(true));
+  std::vector<uint16_t> requested_handles;
+  ON_CALL(gatt_queue, ReadCharacteristic(_, _, _, _))
+      .WillByDefault(Invoke(
+          [&requested_handles](uint16_t conn_id, uint16_t handle,
+                               GATT_READ_OP_CB cb, void* cb_data) -> void {
+            requested_handles.push_back(handle);
+          }));
+  EXPECT_CALL(gatt_queue, WriteDescriptor(_, _, _, _, _, _)).Times(0);
+  for (auto const& handle_pair : expected_to_read_write) {
+    EXPECT_CALL(gatt_interface,
+                RegisterForNotifications(gatt_if, _, handle_pair.first));
+  }
+
+  auto chrc_read_cb = [](uint16_t conn_id, tGATT_STATUS status, uint16_t handle,
+                         uint16_t len, uint8_t* value, void* data) {};
+  auto cccd_write_cb = [](uint16_t conn_id, tGATT_STATUS status,
+                          uint16_t handle, uint16_t len, const uint8_t* value,
+                          void* data) {};
+  ASSERT_EQ(true, device->EnqueueInitialRequests(gatt_if, chrc_read_cb,
+                                                 cccd_write_cb));
+  ASSERT_EQ(expected_to_read_write.size(), requested_handles.size());
+  for (uint16_t handle : requested_handles) {
+    ASSERT_EQ(false, device->device_ready);
+    device->VerifyReady(handle);
+  }
+  ASSERT_EQ(true, device->device_ready);
+}
+
 TEST_F(VolumeControlDeviceTest, test_device_ready) {
   SetSampleDatabase1();
 
@@ -91,6 +91,13 @@ class BtaAvCoPeer {
         num_sup_sources(0),
         p_sink(nullptr),
         p_source(nullptr),
+        sink_for_codec{},
+        source_for_codec{},
+        codec_tables_ready(false),
+        selectable_source_codecs(0),
+        selectable_sink_codecs(0),
+        selectable_source_codecs_updated(false),
+        selectable_sink_codecs_updated(false),
         codec_config{},
         acceptor(false),
         reconfig_needed(false),
@@ -148,6 +155,17 @@ class BtaAvCoPeer {
   uint8_t num_sup_sources;                // Number of supported sources
   const BtaAvCoSep* p_sink;               // Currently selected sink
   const BtaAvCoSep* p_source;             // Currently selected source
+  // Peer SEP to use for each codec index, built once all the capabilities of
+  // the peer are retrieved. Valid while codec_tables_ready is set.
+  BtaAvCoSep* sink_for_codec[BTAV_A2DP_CODEC_INDEX_MAX];
+  BtaAvCoSep* source_for_codec[BTAV_A2DP_CODEC_INDEX_MAX];
+  bool codec_tables_ready;
+  // The selectable capabilities of the local codecs only depend on the peer
+  // capabilities, so they are computed once per capability retrieval
+  size_t selectable_source_codecs;
+  size_t selectable_sink_codecs;
+  bool selectable_source_codecs_updated;
+  bool selectable_sink_codecs_updated;
   uint8_t codec_config[AVDT_CODEC_SIZE];  // Current codec configuration
   bool acceptor;                          // True if acceptor
   bool reconfig_needed;                   // True if reconfiguration is needed
@@ -518,6 +536,23 @@ class BtaAvCo {
                              btav_a2dp_codec_index_t codec_index);
 
  private:
+  /**
+   * Build the tables that map each codec index to the peer SEP to use for it,
+   * once all the capabilities of a peer are retrieved. Codec selection and
+   * reconfiguration then look up the peer SEPs instead of parsing the
+   * capabilities of each of them again.
+   *
+   * @param p_peer the peer to use
+   */
+  void BuildPeerCodecTables(BtaAvCoPeer* p_peer);
+
+  /**
+   * Drop the tables of a peer, when its capabilities are retrieved again.
+   *
+   * @param p_peer the peer to use
+   */
+  void ClearPeerCodecTables(BtaAvCoPeer* p_peer);
+
   /**
    * Reset the state.
    */
@@ -740,6 +775,13 @@ void BtaAvCoPeer::Reset(tBTA_AV_HNDL bta_av_handle) {
   num_sup_sources = 0;
   p_sink = nullptr;
   p_source = nullptr;
+  memset(sink_for_codec, 0, sizeof(sink_for_codec));
+  memset(source_for_codec, 0, sizeof(source_for_codec));
+  codec_tables_ready = false;
+  selectable_source_codecs = 0;
+  selectable_sink_codecs = 0;
+  selectable_source_codecs_updated = false;
+  selectable_sink_codecs_updated = false;
   memset(codec_config, 0, sizeof(codec_config));
   acceptor = false;
   reconfig_needed = false;
@@ -905,6 +947,7 @@ void BtaAvCo::ProcessDiscoveryResult(tBTA_AV_HNDL bta_av_handle,
   p_peer->num_rx_sources = 0;
   p_peer->num_sup_sinks = 0;
   p_peer->num_sup_sources = 0;
+  ClearPeerCodecTables(p_peer);
   if (uuid_local == UUID_SERVCLASS_AUDIO_SINK) {
     p_peer->uuid_to_connect = UUID_SERVCLASS_AUDIO_SOURCE;
   } else if (uuid_local == UUID_SERVCLASS_AUDIO_SOURCE) {
@@ -972,6 +1015,8 @@ tA2DP_STATUS BtaAvCo::ProcessSourceGetConfig(
                    __func__, ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr),
                    p_peer->acceptor ? "acceptor" : "initiator");
 
+  BuildPeerCodecTables(p_peer);
+
   bta_av_co_store_peer_codectype(p_peer);
 
   // Select the Source codec
@@ -1119,6 +1164,8 @@ tA2DP_STATUS BtaAvCo::ProcessSinkGetConfig(tBTA_AV_HNDL bta_av_handle,
   APPL_TRACE_DEBUG("%s: last Source codec reached for peer %s", __func__,
                    ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr));
 
+  BuildPeerCodecTables(p_peer);
+
   // Select the Sink codec
   const BtaAvCoSep* p_source = nullptr;
   if (p_peer->acceptor) {
@@ -1860,6 +1907,25 @@ const BtaAvCoSep* BtaAvCo::SelectSinkCodec(BtaAvCoPeer* p_peer) {
   return p_source;
 }
 
+void BtaAvCo::BuildPeerCodecTables(BtaAvCoPeer* p_peer) {
+  ClearPeerCodecTables(p_peer);
+  for (size_t index = 0; index < BTAV_A2DP_CODEC_INDEX_MAX; index++) {
+    btav_a2dp_codec_index_t codec_index =
+        static_cast<btav_a2dp_codec_index_t>(index);
+    p_peer->sink_for_codec[index] = FindPeerSink(p_peer, codec_index);
+    p_peer->source_for_codec[index] = FindPeerSource(p_peer, codec_index);
+  }
+  p_peer->codec_tables_ready = true;
+}
+
+void BtaAvCo::ClearPeerCodecTables(BtaAvCoPeer* p_peer) {
+  memset(p_peer->sink_for_codec, 0, sizeof(p_peer->sink_for_codec));
+  memset(p_peer->source_for_codec, 0, sizeof(p_peer->source_for_codec));
+  p_peer->codec_tables_ready = false;
+  p_peer->selectable_source_codecs_updated = false;
+  p_peer->selectable_sink_codecs_updated = false;
+}
+
 BtaAvCoSep* BtaAvCo::FindPeerSink(BtaAvCoPeer* p_peer,
                                   btav_a2dp_codec_index_t codec_index) {
   if (codec_index == BTAV_A2DP_CODEC_INDEX_MAX) {
@@ -1867,6 +1933,9 @@ BtaAvCoSep* BtaAvCo::FindPeerSink(BtaAvCoPeer* p_peer,
                        ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr));
     return nullptr;
   }
+  if (p_peer->codec_tables_ready) {
+    return p_peer->sink_for_codec[codec_index];
+  }
 
   // Find the peer Sink for the codec
   for (size_t index = 0; index < p_peer->num_sup_sinks; index++) {
@@ -1895,6 +1964,9 @@ BtaAvCoSep* BtaAvCo::FindPeerSource(BtaAvCoPeer* p_peer,
                        ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr));
     return nullptr;
   }
+  if (p_peer->codec_tables_ready) {
+    return p_peer->source_for_codec[codec_index];
+  }
 
   // Find the peer Source for the codec
   for (size_t index = 0; index < p_peer->num_sup_sources; index++) {
@@ -1976,6 +2048,10 @@ size_t BtaAvCo::UpdateAllSelectableSourceCodecs(BtaAvCoPeer* p_peer) {
   APPL_TRACE_DEBUG("%s: peer %s", __func__,
                    ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr));
 
+  if (p_peer->selectable_source_codecs_updated) {
+    return p_peer->selectable_source_codecs;
+  }
+
   size_t updated_codecs = 0;
   for (const auto& iter : p_peer->GetCodecs()->orderedSourceCodecs()) {
     APPL_TRACE_DEBUG("%s: updating selectable codec %s", __func__,
@@ -1984,6 +2060,8 @@ size_t BtaAvCo::UpdateAllSelectableSourceCodecs(BtaAvCoPeer* p_peer) {
       updated_codecs++;
     }
   }
+  p_peer->selectable_source_codecs = updated_codecs;
+  p_peer->selectable_source_codecs_updated = p_peer->codec_tables_ready;
   return updated_codecs;
 }
 
@@ -2011,6 +2089,10 @@ size_t BtaAvCo::UpdateAllSelectableSinkCodecs(BtaAvCoPeer* p_peer) {
   APPL_TRACE_DEBUG("%s: peer %s", __func__,
                    ADDRESS_TO_LOGGABLE_CSTR(p_peer->addr));
 
+  if (p_peer->selectable_sink_codecs_updated) {
+    return p_peer->selectable_sink_codecs;
+  }
+
   size_t updated_codecs = 0;
   for (const auto& iter : p_peer->GetCodecs()->orderedSinkCodecs()) {
     APPL_TRACE_DEBUG("%s: updating selectable codec %s", __func__,
@@ -2019,6 +2101,8 @@ size_t BtaAvCo::UpdateAllSelectableSinkCodecs(BtaAvCoPeer* p_peer) {
       updated_codecs++;
     }
   }
+  p_peer->selectable_sink_codecs = updated_codecs;
+  p_peer->selectable_sink_codecs_updated = p_peer->codec_tables_ready;
   return updated_codecs;
 }
 
@@ -25,6 +25,7 @@
 #include <linux/uhid.h>
 #include <poll.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -220,18 +221,21 @@ static bool uhid_set_report_req_handler(btif_hh_device_t* p_dev,
 }
 #endif  // ENABLE_UHID_SET_REPORT
 
-/*Internal function to perform UHID write and error checking*/
-static int uhid_write(int fd, const struct uhid_event* ev) {
+/*Internal function to perform UHID write and error checking. Events with a
+ * size field ahead of their payload, like UHID_INPUT2, may be written with
+ * |len| covering only the used part of the event.*/
+static int uhid_write(int fd, const struct uhid_event* ev,
+                      size_t len = sizeof(struct uhid_event)) {
   ssize_t ret;
-  OSI_NO_INTR(ret = write(fd, ev, sizeof(*ev)));
+  OSI_NO_INTR(ret = write(fd, ev, len));
 
   if (ret < 0) {
     int rtn = -errno;
     APPL_TRACE_ERROR("%s: Cannot write to uhid:%s", __func__, strerror(errno));
     return rtn;
-  } else if (ret != (ssize_t)sizeof(*ev)) {
+  } else if (ret != (ssize_t)len) {
     APPL_TRACE_ERROR("%s: Wrong size written to uhid: %zd != %zu", __func__,
-                     ret, sizeof(*ev));
+                     ret, len);
     return -EFAULT;
   }
 
@@ -468,17 +472,18 @@ static void* btif_hh_poll_event_thread(void* arg) {
 int bta_hh_co_write(int fd, uint8_t* rpt, uint16_t len) {
   APPL_TRACE_VERBOSE("%s: UHID write %d", __func__, len);
 
+  /* UHID_INPUT2 keeps the size ahead of the data, so only the header and the
+   * report are cleared, copied and written instead of the whole event */
   struct uhid_event ev;
-  memset(&ev, 0, sizeof(ev));
-  ev.type = UHID_INPUT;
-  ev.u.input.size = len;
-  if (len > sizeof(ev.u.input.data)) {
+  if (len > sizeof(ev.u.input2.data)) {
     APPL_TRACE_WARNING("%s: Report size greater than allowed size", __func__);
     return -1;
   }
-  memcpy(ev.u.input.data, rpt, len);
+  ev.type = UHID_INPUT2;
+  ev.u.input2.size = len;
+  memcpy(ev.u.input2.data, rpt, len);
 
-  return uhid_write(fd, &ev);
+  return uhid_write(fd, &ev, offsetof(struct uhid_event, u.input2.data) + len);
 }
 
 /*******************************************************************************
@@ -123,6 +123,13 @@ static constexpr int8_t kCriWarnRssi = -80;
 static constexpr uint8_t kCriWarnUnusedCh = 55;
 // The queue size of recording the BQR events.
 static constexpr uint8_t kBqrEventQueueSize = 25;
+// The number of connections whose Link Quality events are aggregated. When a
+// new connection reports and the table is full, the connection that reported
+// least recently is forgotten.
+static constexpr uint8_t kBqrLinkQualityStatsSize = 16;
+// The size of the buffer in which the records of a trace log file are batched
+// before they are written to the file.
+static constexpr size_t kLogDumpBufferSize = 4096;
 // The Property of BQR event mask configuration.
 static constexpr const char* kpPropertyEventMask =
     "persist.bluetooth.bqr.event_mask";
@@ -319,6 +326,58 @@ typedef struct {
   const uint8_t* vendor_specific_parameter;
 } BqrLogDumpEvent;
 
+// Rolling statistics of the Link Quality related BQR events of a connection
+typedef struct {
+  // Remote device address, empty if the events did not carry one.
+  RawAddress bdaddr;
+  // Connection handle of the connection.
+  uint16_t connection_handle;
+  // The number of events aggregated.
+  uint32_t report_count;
+  // Boot time of the last event.
+  // Unit: ms
+  uint64_t last_report_ms;
+  // Last, lowest and highest RSSI.
+  int8_t rssi;
+  int8_t rssi_min;
+  int8_t rssi_max;
+  // Moving averages of the RSSI and SNR, weighting each new event by 1/8.
+  // Unit: 1/16 dBm and 1/16 dB
+  int16_t rssi_avg_x16;
+  uint16_t snr_avg_x16;
+  // Sums of the counts reported by the events.
+  uint64_t retransmission_count;
+  uint64_t no_rx_count;
+  uint64_t nak_count;
+  uint64_t flow_off_count;
+  uint64_t buffer_overflow_bytes;
+  uint64_t tx_total_packets;
+  uint64_t tx_flushed_packets;
+  // The time covered by the events, from the piconet clock of the first event
+  // to that of the last one.
+  // Unit: N * 0.3125 ms (1 Bluetooth Clock)
+  uint64_t air_time;
+  // Piconet clock of the last event.
+  uint32_t last_piconet_clock;
+} BqrLinkQualityStats;
+
+// Batches the records of a trace log file, so that the file is written once
+// per kLogDumpBufferSize bytes rather than twice per event. Only used on the
+// main thread.
+class BqrLogDumpWriter {
+ public:
+  // Append a record, first writing the buffered records to |fd| if the record
+  // does not fit.
+  void Append(int fd, const void* data, size_t length);
+
+  // Write the buffered records to |fd|.
+  void Flush(int fd);
+
+ private:
+  uint8_t buffer_[kLogDumpBufferSize];
+  size_t length_ = 0;
+};
+
 // BQR sub-event of Vendor Specific Event
 class BqrVseSubEvt {
  public:
@@ -443,6 +502,21 @@ void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event);
 //   trace log file.
 int OpenBtSchedulingTraceLogFile();
 
+// Fold a Link Quality related BQR event into the statistics of its connection.
+//
+// @param event The parsed Link Quality related BQR event.
+void UpdateLinkQualityStats(const BqrLinkQualityEvent& event);
+
+// Get the rolling link quality statistics of a connection, e.g. for the audio
+// bitrate adaptation or for metrics.
+//
+// @param bd_addr The remote device address of the connection.
+// @param p_stats The statistics are copied here.
+// @return true if a Link Quality related BQR event was received for the
+//   connection.
+bool GetLinkQualityStats(const RawAddress& bd_addr,
+                         BqrLinkQualityStats* p_stats);
+
 // Dump Bluetooth Quality Report information.
 //
 // @param fd The file descriptor to use for dumping information.
@@ -22,7 +22,9 @@
 #include <stddef.h>
 
 #include <list>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "osi/include/config.h"
@@ -69,5 +71,21 @@ size_t btif_config_get_bin_length(const std::string& section,
 
 std::vector<RawAddress> btif_config_get_paired_devices();
 
+// All keys of a section and their values, as returned by
+// btif_config_get_sections()
+typedef std::unordered_map<std::string, std::string> btif_config_section_t;
+
+// Fetch all keys of each of |sections| at once, instead of taking the config
+// lock for each key. A section that does not exist is returned as
+// std::nullopt. The btif_config_section_get_* accessors convert values the
+// same way as the matching btif_config_get_* functions.
+std::vector<std::optional<btif_config_section_t>> btif_config_get_sections(
+    const std::vector<std::string>& sections);
+bool btif_config_section_get_int(const btif_config_section_t& section,
+                                 const std::string& key, int* value);
+bool btif_config_section_get_str(const btif_config_section_t& section,
+                                 const std::string& key, char* value,
+                                 int* size_bytes);
+
 bool btif_config_clear(void);
 void btif_debug_config_dump(int fd);
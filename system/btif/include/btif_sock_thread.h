@@ -32,9 +32,13 @@
 #define SOCK_THREAD_FD_WR (1 << 1)        /* BT socket write signal */
 #define SOCK_THREAD_FD_EXCEPTION (1 << 2) /* BT socket exception singal */
 
-/* Add BT socket fd in current socket poll thread context immediately */
+/* Add BT socket fd in current socket poll thread context immediately. Fds
+ * are now always armed synchronously, the flag is kept for compatibility. */
 #define SOCK_THREAD_ADD_FD_SYNC (1 << 3)
 
+/* Max number of epoll I/O threads serving one socket thread handle */
+#define BTSOCK_MAX_IO_THREADS 4
+
 /*******************************************************************************
  *  Functions
  ******************************************************************************/
@@ -53,6 +57,12 @@ int btsock_thread_post_cmd(int handle, int cmd_type,
                            uint32_t user_id);
 int btsock_thread_create(btsock_signaled_cb callback,
                          btsock_cmd_cb cmd_callback);
+/* Fds added to the handle are sharded over |io_thread_count| I/O threads, so
+ * |callback| may run concurrently for different fds. User commands are always
+ * delivered on the first I/O thread. */
+int btsock_thread_create_with_io_threads(btsock_signaled_cb callback,
+                                         btsock_cmd_cb cmd_callback,
+                                         int io_thread_count);
 int btsock_thread_exit(int handle);
 
 #endif
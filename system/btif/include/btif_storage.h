@@ -117,6 +117,23 @@ bt_status_t btif_storage_set_adapter_property(bt_property_t* property);
 bt_status_t btif_storage_get_remote_device_property(
     const RawAddress* remote_bd_addr, bt_property_t* property);
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_get_remote_device_properties
+ *
+ * Description      BTIF storage API - Fetches several properties of a remote
+ *                  device with a single config lookup. Each of |properties|
+ *                  is filled as btif_storage_get_remote_device_property()
+ *                  would, and its result is stored in |statuses| if not NULL.
+ *
+ * Returns          BT_STATUS_SUCCESS if all properties were fetched,
+ *                  BT_STATUS_FAIL otherwise
+ *
+ ******************************************************************************/
+bt_status_t btif_storage_get_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_props,
+    bt_property_t* properties, bt_status_t* statuses);
+
 /*******************************************************************************
  *
  * Function         btif_storage_set_remote_device_property
@@ -38,6 +38,12 @@ typedef struct {
 
 const stack_manager_t* stack_manager_get_interface();
 
+// Runs |step| of the stack start up, named |name|, and records how long it
+// took for the dumpsys
+void stack_manager_run_start_up_step(const char* name, void (*step)(void));
+
+void stack_manager_debug_dump(int fd);
+
 // TODO(zachoverflow): remove this terrible hack once the startup sequence is
 // more sane
 future_t* stack_manager_get_hack_future();
@@ -54,6 +54,7 @@
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_ar_api.h"
 #include "bta/include/bta_csis_api.h"
+#include "bta/include/bta_gatt_api.h"
 #include "bta/include/bta_has_api.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
@@ -89,17 +90,25 @@
 #include "device/include/device_iot_config.h"
 #include "device/include/interop.h"
 #include "device/include/interop_config.h"
+#include "gd/common/allocation_hook.h"
 #include "gd/common/init_flags.h"
+#include "gd/common/task_stats.h"
+#include "gd/common/tracing.h"
+#include "gd/os/logging/binary_log.h"
 #include "gd/os/parameter_provider.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
 #include "osi/include/alarm.h"
+#include "osi/include/allocation_profiler.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
+#include "osi/include/slab_allocator.h"
 #include "osi/include/wakelock.h"
 #include "profile_log_levels.h"
+#include "stack/btm/btm_sco.h"
 #include "stack/btm/btm_sco_hfp_hal.h"
 #include "stack/gatt/connection_manager.h"
 #include "stack/include/a2dp_api.h"
@@ -133,6 +142,17 @@ const int CONFIG_COMPARE_ALL_PASS = 0b11;
 int common_criteria_config_compare_result = CONFIG_COMPARE_ALL_PASS;
 bool is_local_device_atv = false;
 
+// Records the data path trace points, dumped with dumpsys
+static const char kTracingEnabledProperty[] =
+    "bluetooth.trace.hot_path.enabled";
+
+// Records the queue depth, wait and run times of the tasks of every thread,
+// dumped with dumpsys. Tasks running longer than the threshold are logged.
+static const char kTaskStatsEnabledProperty[] =
+    "bluetooth.task_stats.enabled";
+static const char kTaskStatsLongTaskThresholdProperty[] =
+    "bluetooth.task_stats.long_task_threshold_ms";
+
 /*******************************************************************************
  *  Externs
  ******************************************************************************/
@@ -393,6 +413,23 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
   allocation_tracker_init();
 #endif
 
+  if (bluetooth::common::init_flags::osi_slab_allocator_is_enabled()) {
+    slab_allocator_init();
+  }
+
+  allocation_profiler_init();
+  if (allocation_profiler_get_sample_interval() > 0) {
+    bluetooth::common::SetAllocationHook(
+        allocation_profiler_notify_transient_alloc);
+  }
+
+  bluetooth::common::tracing::Enable(
+      osi_property_get_bool(kTracingEnabledProperty, false));
+  bluetooth::common::EnableTaskStats(
+      osi_property_get_bool(kTaskStatsEnabledProperty, false),
+      std::chrono::milliseconds(
+          osi_property_get_int32(kTaskStatsLongTaskThresholdProperty, 100)));
+
   set_hal_cbacks(callbacks);
 
   restricted_mode = start_restricted;
@@ -417,17 +454,17 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
 
 static void start_profiles() {
 #if (BNEP_INCLUDED == TRUE)
-  BNEP_Init();
+  stack_manager_run_start_up_step("bnep", BNEP_Init);
 #if (PAN_INCLUDED == TRUE)
-  PAN_Init();
+  stack_manager_run_start_up_step("pan", PAN_Init);
 #endif /* PAN */
 #endif /* BNEP Included */
-  A2DP_Init();
-  AVRC_Init();
+  stack_manager_run_start_up_step("a2dp", A2DP_Init);
+  stack_manager_run_start_up_step("avrc", AVRC_Init);
 #if (HID_HOST_INCLUDED == TRUE)
-  HID_HostInit();
+  stack_manager_run_start_up_step("hid_host", HID_HostInit);
 #endif
-  bta_ar_init();
+  stack_manager_run_start_up_step("bta_ar", bta_ar_init);
 
   // initialize profile-specific logging levels
   const auto stack_config = stack_config_get_interface();
@@ -781,6 +818,8 @@ static void dump(int fd, const char** arguments) {
   BTA_HfClientDumpStatistics(fd);
   wakelock_debug_dump(fd);
   osi_allocator_debug_dump(fd);
+  allocation_profiler_debug_dump(fd);
+  bluetooth::common::TaskStats::DumpAll(fd);
   alarm_debug_dump(fd);
   bluetooth::csis::CsisClient::DebugDump(fd);
 #ifndef TARGET_FLOSS
@@ -797,7 +836,12 @@ static void dump(int fd, const char** arguments) {
   PAN_Dumpsys(fd);
   DumpsysHid(fd);
   DumpsysBtaDm(fd);
+  DumpsysBtaGattc(fd);
+  DumpsysBtmSco(fd);
+  stack_manager_debug_dump(fd);
   bluetooth::shim::Dump(fd, arguments);
+  bluetooth::common::tracing::Dump(fd);
+  bluetooth::os::binary_log::Dump(fd);
 }
 
 static void dumpMetrics(std::string* output) {
@@ -246,6 +246,17 @@ static void btif_a2dp_control_on_get_presentation_position() {
   UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, (uint8_t*)&nsec, sizeof(nsec));
 }
 
+static void btif_a2dp_control_on_get_audio_ring() {
+  /* The audio HAL keeps using the data socket unless a ring is sent */
+  if (!UIPC_OpenRing(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO)) {
+    btif_a2dp_command_ack(A2DP_CTRL_ACK_UNSUPPORTED);
+    return;
+  }
+
+  btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
+  UIPC_SendRing(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, UIPC_CH_ID_AV_AUDIO);
+}
+
 static void btif_a2dp_recv_ctrl_data(void) {
   tA2DP_CTRL_CMD cmd = A2DP_CTRL_CMD_NONE;
   int n;
@@ -305,6 +316,10 @@ static void btif_a2dp_recv_ctrl_data(void) {
       btif_a2dp_control_on_get_presentation_position();
       break;
 
+    case A2DP_CTRL_GET_AUDIO_RING:
+      btif_a2dp_control_on_get_audio_ring();
+      break;
+
     default:
       APPL_TRACE_ERROR("%s: UNSUPPORTED CMD (%d)", __func__, cmd);
       btif_a2dp_command_ack(A2DP_CTRL_ACK_FAILURE);
@@ -24,7 +24,9 @@
 #include <base/functional/bind.h>
 #include <base/logging.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdlib>
 #include <mutex>
 #include <string>
 
@@ -34,6 +36,8 @@
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
+#include "gd/os/thread_scheduling.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
@@ -53,9 +57,17 @@ using LockGuard = std::lock_guard<std::mutex>;
 
 #define BTIF_SINK_MEDIA_TIME_TICK_MS 20
 
-/* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
+/* In case of A2DP Sink, we will delay start by 5 AVDTP Packets until the
+ * arrival jitter of the stream is known */
 #define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
 
+/* Bounds of the jitter based start threshold, in AVDTP packets */
+#define MIN_A2DP_DELAYED_START_FRAME_COUNT 2
+#define MAX_A2DP_JITTER_START_FRAME_COUNT (MAX_INPUT_A2DP_FRAME_QUEUE_SZ / 2)
+
+/* Gaps longer than this are pauses in the stream rather than jitter */
+#define BTIF_SINK_MAX_INTER_ARRIVAL_US (500 * 1000)
+
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -90,6 +102,11 @@ class BtifA2dpSinkControlBlock {
       : worker_thread(thread_name),
         rx_audio_queue(nullptr),
         rx_flush(false),
+        rx_prebuffering(true),
+        rx_last_arrival_us(0),
+        rx_interval_us(0),
+        rx_jitter_us(0),
+        rx_underruns(0),
         decode_alarm(nullptr),
         sample_rate(0),
         channel_count(0),
@@ -108,6 +125,11 @@ class BtifA2dpSinkControlBlock {
     alarm_free(decode_alarm);
     decode_alarm = nullptr;
     rx_flush = false;
+    rx_prebuffering = true;
+    rx_last_arrival_us = 0;
+    rx_interval_us = 0;
+    rx_jitter_us = 0;
+    rx_underruns = 0;
     rx_focus_state = BTIF_A2DP_SINK_FOCUS_NOT_GRANTED;
     sample_rate = 0;
     channel_count = 0;
@@ -117,6 +139,13 @@ class BtifA2dpSinkControlBlock {
   MessageLoopThread worker_thread;
   fixed_queue_t* rx_audio_queue;
   bool rx_flush; /* discards any incoming data when true */
+  bool rx_prebuffering; /* waits for the start threshold before decoding */
+  /* Inter-arrival time of the media packets and its mean deviation, smoothed
+   * with the 1/16 gain of the RFC 3550 jitter estimator */
+  uint64_t rx_last_arrival_us;
+  uint32_t rx_interval_us;
+  uint32_t rx_jitter_us;
+  uint32_t rx_underruns;
   alarm_t* decode_alarm;
   tA2DP_SAMPLE_RATE sample_rate;
   tA2DP_BITS_PER_SAMPLE bits_per_sample;
@@ -195,7 +224,9 @@ bool btif_a2dp_sink_init() {
   btif_a2dp_sink_cb.rx_audio_queue = fixed_queue_new(SIZE_MAX);
 
   /* Schedule the rest of the operations */
-  if (!btif_a2dp_sink_cb.worker_thread.EnableRealTimeScheduling()) {
+  if (!bluetooth::os::ApplyThreadScheduling(
+          btif_a2dp_sink_cb.worker_thread.GetThreadId(),
+          btif_a2dp_sink_cb.worker_thread.GetName(), true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__
                << ": Failed to increase A2DP decoder thread priority";
@@ -543,15 +574,65 @@ static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg) {
   }
 }
 
+// Must be called while locked.
+static void btif_a2dp_sink_update_jitter() {
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t last_us = btif_a2dp_sink_cb.rx_last_arrival_us;
+  btif_a2dp_sink_cb.rx_last_arrival_us = now_us;
+  if (last_us == 0 || now_us - last_us > BTIF_SINK_MAX_INTER_ARRIVAL_US) return;
+
+  int64_t interval_us = now_us - last_us;
+  if (btif_a2dp_sink_cb.rx_interval_us == 0) {
+    btif_a2dp_sink_cb.rx_interval_us = interval_us;
+    return;
+  }
+
+  int64_t deviation_us = interval_us - btif_a2dp_sink_cb.rx_interval_us;
+  btif_a2dp_sink_cb.rx_interval_us += deviation_us / 16;
+  int64_t jitter_us = btif_a2dp_sink_cb.rx_jitter_us;
+  btif_a2dp_sink_cb.rx_jitter_us +=
+      (std::abs(deviation_us) - jitter_us) / 16;
+}
+
+// Number of packets to hold before decoding starts, enough to ride out four
+// times the observed arrival jitter. Must be called while locked.
+static size_t btif_a2dp_sink_start_threshold() {
+  uint32_t interval_us = btif_a2dp_sink_cb.rx_interval_us;
+  if (interval_us == 0) return MAX_A2DP_DELAYED_START_FRAME_COUNT;
+
+  size_t count =
+      1 + (4 * static_cast<size_t>(btif_a2dp_sink_cb.rx_jitter_us) +
+           interval_us - 1) /
+              interval_us;
+  return std::clamp<size_t>(count, MIN_A2DP_DELAYED_START_FRAME_COUNT,
+                            MAX_A2DP_JITTER_START_FRAME_COUNT);
+}
+
 static void btif_a2dp_sink_avk_handle_timer() {
   LockGuard lock(g_mutex);
 
   BT_HDR* p_msg;
   if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
     APPL_TRACE_DEBUG("%s: empty queue", __func__);
+    // Build the buffer up again in one go rather than playing every late
+    // packet as soon as it arrives, which gives a pop per packet.
+    if (!btif_a2dp_sink_cb.rx_prebuffering) {
+      btif_a2dp_sink_cb.rx_prebuffering = true;
+      btif_a2dp_sink_cb.rx_underruns++;
+    }
     return;
   }
 
+  if (btif_a2dp_sink_cb.rx_prebuffering) {
+    size_t threshold = btif_a2dp_sink_start_threshold();
+    if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) < threshold) {
+      APPL_TRACE_DEBUG("%s: buffering, waiting for %zu packets", __func__,
+                       threshold);
+      return;
+    }
+    btif_a2dp_sink_cb.rx_prebuffering = false;
+  }
+
   /* Don't do anything in case of focus not granted */
   if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED) {
     APPL_TRACE_DEBUG("%s: skipping frames since focus is not present",
@@ -593,6 +674,8 @@ static void btif_a2dp_sink_audio_rx_flush_event() {
   LockGuard lock(g_mutex);
   // Flush all received encoded audio buffers
   fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+  btif_a2dp_sink_cb.rx_prebuffering = true;
+  btif_a2dp_sink_cb.rx_last_arrival_us = 0;
 }
 
 static void btif_a2dp_sink_decoder_update_event(
@@ -673,6 +756,8 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   }
 
   BTIF_TRACE_VERBOSE("%s +", __func__);
+  btif_a2dp_sink_update_jitter();
+
   /* Allocate and queue this buffer */
   BT_HDR* p_msg =
       reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
@@ -680,8 +765,9 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   p_msg->offset = 0;
   memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
   fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
-  if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
-      MAX_A2DP_DELAYED_START_FRAME_COUNT) {
+  if (btif_a2dp_sink_cb.decode_alarm == nullptr &&
+      fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) >=
+          btif_a2dp_sink_start_threshold()) {
     BTIF_TRACE_DEBUG("%s: Initiate decoding. Current focus state:%d", __func__,
                      btif_a2dp_sink_cb.rx_focus_state);
     if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
@@ -706,8 +792,15 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(UNUSED_ATTR int fd) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd,
+          "  Packet interval (us): %u  Arrival jitter (us): %u  "
+          "Start threshold (packets): %zu\n",
+          btif_a2dp_sink_cb.rx_interval_us, btif_a2dp_sink_cb.rx_jitter_us,
+          btif_a2dp_sink_start_threshold());
+  dprintf(fd, "  Underruns: %u\n", btif_a2dp_sink_cb.rx_underruns);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -27,10 +27,19 @@
 #endif
 #include <inttypes.h>
 #include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <future>
+#include <thread>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "audio_hal_interface/a2dp_encoding.h"
@@ -40,16 +49,20 @@
 #include "btif_a2dp_source.h"
 #include "btif_av.h"
 #include "btif_av_co.h"
+#include "btif_bqr.h"
 #include "btif_metrics_logging.h"
 #include "btif_util.h"
 #include "common/message_loop_thread.h"
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
+#include "gd/common/tracing.h"
+#include "gd/os/thread_scheduling.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -70,6 +83,31 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+// The TX queue enqueue time (in us) of each media packet is kept in the
+// offset area of the packet, after the 32-bit timestamp written by the
+// encoder (see BtaAvCo::GetNextSourceDataPacket()).
+static constexpr size_t kTxQueueEnqueueTimeOffset = sizeof(uint32_t);
+static constexpr size_t kTxQueueEnqueueTimeEnd =
+    kTxQueueEnqueueTimeOffset + sizeof(uint64_t);
+
+/**
+ * When true, the encoder is driven by the timerfd based media clock instead
+ * of the media alarm posted on the A2DP Source worker thread.
+ */
+#define PROPERTY_A2DP_SOURCE_MEDIA_CLOCK \
+  "persist.bluetooth.a2dp_source.media_clock.enabled"
+
+// Bounds (in us) of the buckets of the media clock histograms. The last
+// bucket counts the deviations above the largest bound.
+static constexpr uint64_t kMediaClockHistogramBoundsUs[] = {250,  500,  1000,
+                                                            2000, 5000, 10000};
+static constexpr size_t kMediaClockHistogramSize =
+    sizeof(kMediaClockHistogramBoundsUs) / sizeof(uint64_t) + 1;
+
+// Scheduling priority of the media clock thread, same as the A2DP Source
+// worker thread.
+static constexpr int kMediaClockSchedulingPriority = 1;
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -117,6 +155,166 @@ class SchedulingStats {
   uint64_t total_scheduling_time_us;
 };
 
+class MediaClockStats {
+ public:
+  MediaClockStats() { Reset(); }
+  void Reset() {
+    total_ticks = 0;
+    missed_ticks = 0;
+    last_tick_us = 0;
+    total_late_us = 0;
+    max_late_us = 0;
+    total_drift_us = 0;
+    max_drift_us = 0;
+    std::fill(std::begin(late_histogram), std::end(late_histogram), 0);
+    std::fill(std::begin(drift_histogram), std::end(drift_histogram), 0);
+  }
+
+  // Counter for the ticks handled by the worker thread
+  size_t total_ticks;
+
+  // Counter for the timer expirations merged into a later tick
+  size_t missed_ticks;
+
+  // Last tick timestamp (in us)
+  uint64_t last_tick_us;
+
+  // Accumulated and max. delay between the timer deadline and the tick
+  // (in us)
+  uint64_t total_late_us;
+  uint64_t max_late_us;
+
+  // Accumulated and max. deviation of the interval between two ticks from
+  // the encoder interval (in us)
+  uint64_t total_drift_us;
+  uint64_t max_drift_us;
+
+  // Histograms of the delays and deviations above, in the buckets of
+  // kMediaClockHistogramBoundsUs
+  size_t late_histogram[kMediaClockHistogramSize];
+  size_t drift_histogram[kMediaClockHistogramSize];
+};
+
+// Media clock driven by a timerfd, read on a dedicated real time thread.
+// The timer is armed with absolute CLOCK_BOOTTIME deadlines, so the wake-up
+// latency of one tick does not delay the following ones. The expirations
+// are handed to |tick|, which forwards them to the A2DP Source worker thread
+// where all the encoder state is accessed.
+class MediaClock {
+ public:
+  // Called on the media clock thread with the deadline (in us) of the last
+  // expiration and the number of expirations since the previous call.
+  using TickCallback = std::function<void(uint64_t, uint64_t)>;
+
+  MediaClock() = default;
+  MediaClock(const MediaClock&) = delete;
+  MediaClock& operator=(const MediaClock&) = delete;
+  ~MediaClock() { Stop(); }
+
+  // Starts the clock with a period of |interval_us|.
+  // Returns true on success, otherwise false.
+  bool Start(uint64_t interval_us, TickCallback tick) {
+    Stop();
+
+    timer_fd_ = timerfd_create(CLOCK_BOOTTIME, TFD_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (timer_fd_ < 0 || stop_fd_ < 0) {
+      LOG_ERROR("%s: unable to create the media clock: %s", __func__,
+                strerror(errno));
+      CloseFds();
+      return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    interval_ns_ = interval_us * 1000;
+    start_ns_ = now.tv_sec * 1000000000ULL + now.tv_nsec;
+    expirations_ = 0;
+
+    uint64_t first_deadline_ns = start_ns_ + interval_ns_;
+    struct itimerspec spec = {};
+    spec.it_interval.tv_sec = interval_ns_ / 1000000000;
+    spec.it_interval.tv_nsec = interval_ns_ % 1000000000;
+    spec.it_value.tv_sec = first_deadline_ns / 1000000000;
+    spec.it_value.tv_nsec = first_deadline_ns % 1000000000;
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+      LOG_ERROR("%s: unable to arm the media clock: %s", __func__,
+                strerror(errno));
+      CloseFds();
+      return false;
+    }
+
+    tick_ = std::move(tick);
+    running_ = true;
+    thread_ = std::thread(&MediaClock::Run, this);
+    return true;
+  }
+
+  // Stops the clock and waits for the media clock thread to exit.
+  // No tick callback is called after this returns.
+  void Stop() {
+    if (thread_.joinable()) {
+      uint64_t value = 1;
+      if (write(stop_fd_, &value, sizeof(value)) != sizeof(value)) {
+        LOG_ERROR("%s: unable to stop the media clock: %s", __func__,
+                  strerror(errno));
+      }
+      thread_.join();
+    }
+    running_ = false;
+    tick_ = nullptr;
+    CloseFds();
+  }
+
+  bool IsRunning() const { return running_; }
+
+ private:
+  void Run() {
+    pthread_setname_np(pthread_self(), "bt_a2dp_clock");
+    struct sched_param rt_params = {.sched_priority =
+                                        kMediaClockSchedulingPriority};
+    if (sched_setscheduler(0, SCHED_FIFO, &rt_params) != 0) {
+      LOG_WARN("%s: unable to set SCHED_FIFO priority %d: %s", __func__,
+               kMediaClockSchedulingPriority, strerror(errno));
+    }
+
+    struct pollfd fds[] = {{.fd = timer_fd_, .events = POLLIN, .revents = 0},
+                           {.fd = stop_fd_, .events = POLLIN, .revents = 0}};
+    while (true) {
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR) continue;
+        LOG_ERROR("%s: poll failed: %s", __func__, strerror(errno));
+        break;
+      }
+      if (fds[1].revents != 0) break;
+
+      uint64_t expirations;
+      if (read(timer_fd_, &expirations, sizeof(expirations)) !=
+          sizeof(expirations)) {
+        continue;
+      }
+      expirations_ += expirations;
+      tick_((start_ns_ + expirations_ * interval_ns_) / 1000, expirations);
+    }
+  }
+
+  void CloseFds() {
+    if (timer_fd_ >= 0) close(timer_fd_);
+    if (stop_fd_ >= 0) close(stop_fd_);
+    timer_fd_ = -1;
+    stop_fd_ = -1;
+  }
+
+  int timer_fd_ = -1;
+  int stop_fd_ = -1;
+  uint64_t start_ns_ = 0;
+  uint64_t interval_ns_ = 0;
+  uint64_t expirations_ = 0;
+  TickCallback tick_;
+  std::thread thread_;
+  std::atomic<bool> running_ = false;
+};
+
 class BtifMediaStats {
  public:
   BtifMediaStats() { Reset(); }
@@ -137,9 +335,12 @@ class BtifMediaStats {
     tx_queue_max_dropped_messages = 0;
     tx_queue_dropouts = 0;
     tx_queue_last_dropouts_us = 0;
+    tx_queue_total_late_messages = 0;
+    tx_queue_last_late_us = 0;
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    media_clock_stats.Reset();
     codec_index = -1;
   }
 
@@ -166,10 +367,15 @@ class BtifMediaStats {
   size_t tx_queue_dropouts;
   uint64_t tx_queue_last_dropouts_us;
 
+  size_t tx_queue_total_late_messages;  // Dropped for exceeding the budget
+  uint64_t tx_queue_last_late_us;
+
   size_t media_read_total_underflow_bytes;
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  MediaClockStats media_clock_stats;
+
   int codec_index = -1;
 };
 
@@ -187,6 +393,7 @@ class BtifA2dpSource {
         tx_flush(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
+        tx_latency_budget_ms(0),
         state_(kStateOff) {}
 
   void Reset() {
@@ -194,9 +401,12 @@ class BtifA2dpSource {
     tx_audio_queue = nullptr;
     tx_flush = false;
     media_alarm.CancelAndWait();
+    media_clock.Stop();
     wakelock_release();
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
+    tx_latency_budget_ms = 0;
+    link_quality = {};
     stats.Reset();
     accumulated_stats.Reset();
     state_ = kStateOff;
@@ -221,8 +431,11 @@ class BtifA2dpSource {
   fixed_queue_t* tx_audio_queue;
   bool tx_flush; /* Discards any outgoing data when true */
   RepeatingTimer media_alarm;
+  MediaClock media_clock; /* Used instead of media_alarm when enabled */
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
+  uint64_t tx_latency_budget_ms; /* Local copy of the codec budget */
+  tA2DP_LINK_QUALITY link_quality; /* Reported to the encoder */
   BtifMediaStats stats;
   BtifMediaStats accumulated_stats;
 
@@ -264,18 +477,28 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_handle_clock_tick(uint64_t deadline_us,
+                                                     uint64_t expirations);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
 static void log_tstamps_us(const char* comment, uint64_t timestamp_us);
 static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
                                     uint64_t expected_delta);
+static void update_media_clock_stats(MediaClockStats* stats, uint64_t now_us,
+                                     uint64_t deadline_us, uint64_t expirations,
+                                     uint64_t expected_delta);
 // Update the A2DP Source related metrics.
 // This function should be called before collecting the metrics.
 static void btif_a2dp_source_update_metrics(void);
 static void btm_read_rssi_cb(void* data);
 static void btm_read_failed_contact_counter_cb(void* data);
 static void btm_read_tx_power_cb(void* data);
+static void btif_a2dp_source_report_link_quality(void);
+static void btif_a2dp_source_report_late_messages(size_t late_n);
+static void btif_a2dp_source_update_rssi(int8_t rssi);
+static void btif_a2dp_source_update_failed_contact_counter(
+    uint16_t failed_contact_counter);
 
 void btif_a2dp_source_accumulate_scheduling_stats(SchedulingStats* src,
                                                   SchedulingStats* dst) {
@@ -297,6 +520,21 @@ void btif_a2dp_source_accumulate_scheduling_stats(SchedulingStats* src,
   dst->total_scheduling_time_us += src->total_scheduling_time_us;
 }
 
+void btif_a2dp_source_accumulate_media_clock_stats(MediaClockStats* src,
+                                                   MediaClockStats* dst) {
+  dst->total_ticks += src->total_ticks;
+  dst->missed_ticks += src->missed_ticks;
+  dst->last_tick_us = src->last_tick_us;
+  dst->total_late_us += src->total_late_us;
+  dst->max_late_us = std::max(dst->max_late_us, src->max_late_us);
+  dst->total_drift_us += src->total_drift_us;
+  dst->max_drift_us = std::max(dst->max_drift_us, src->max_drift_us);
+  for (size_t i = 0; i < kMediaClockHistogramSize; i++) {
+    dst->late_histogram[i] += src->late_histogram[i];
+    dst->drift_histogram[i] += src->drift_histogram[i];
+  }
+}
+
 void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
                                        BtifMediaStats* dst) {
   dst->tx_queue_total_frames += src->tx_queue_total_frames;
@@ -314,6 +552,8 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
       dst->tx_queue_max_dropped_messages, src->tx_queue_max_dropped_messages);
   dst->tx_queue_dropouts += src->tx_queue_dropouts;
   dst->tx_queue_last_dropouts_us = src->tx_queue_last_dropouts_us;
+  dst->tx_queue_total_late_messages += src->tx_queue_total_late_messages;
+  dst->tx_queue_last_late_us = src->tx_queue_last_late_us;
   dst->media_read_total_underflow_bytes +=
       src->media_read_total_underflow_bytes;
   dst->media_read_total_underflow_count +=
@@ -324,6 +564,8 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
                                                &dst->tx_queue_enqueue_stats);
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_dequeue_stats,
                                                &dst->tx_queue_dequeue_stats);
+  btif_a2dp_source_accumulate_media_clock_stats(&src->media_clock_stats,
+                                                &dst->media_clock_stats);
   src->Reset();
 }
 
@@ -363,7 +605,9 @@ bool btif_a2dp_source_startup(void) {
 
 static void btif_a2dp_source_startup_delayed() {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
-  if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
+  if (!bluetooth::os::ApplyThreadScheduling(
+          btif_a2dp_source_thread.GetThreadId(),
+          btif_a2dp_source_thread.GetName(), true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
 #endif
@@ -506,6 +750,7 @@ static void btif_a2dp_source_shutdown_delayed(
 
   // Stop the timer
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_cb.media_clock.Stop();
   wakelock_release();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
@@ -550,7 +795,8 @@ bool btif_a2dp_source_media_task_is_shutting_down(void) {
 
 // This runs on worker thread
 bool btif_a2dp_source_is_streaming(void) {
-  return btif_a2dp_source_cb.media_alarm.IsScheduled();
+  return btif_a2dp_source_cb.media_alarm.IsScheduled() ||
+         btif_a2dp_source_cb.media_clock.IsRunning();
 }
 
 static void btif_a2dp_source_setup_codec(const RawAddress& peer_address) {
@@ -597,10 +843,13 @@ static void btif_a2dp_source_setup_codec_delayed(
   btif_a2dp_source_cb.encoder_interface->encoder_init(
       &peer_params, a2dp_codec_config, btif_a2dp_source_read_callback,
       btif_a2dp_source_enqueue_callback);
+  btif_a2dp_source_cb.link_quality = {};
 
   // Save a local copy of the encoder_interval_ms
   btif_a2dp_source_cb.encoder_interval_ms =
       btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms();
+  btif_a2dp_source_cb.tx_latency_budget_ms =
+      a2dp_codec_config->getTxLatencyBudgetMs();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     bluetooth::audio::a2dp::setup_codec();
@@ -813,15 +1062,33 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   btif_a2dp_source_cb.tx_flush = false;
 
   wakelock_acquire();
-  btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
-      btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
-      base::Bind(&btif_a2dp_source_audio_handle_timer),
+  bool use_media_clock =
+      osi_property_get_bool(PROPERTY_A2DP_SOURCE_MEDIA_CLOCK, false);
+  if (use_media_clock &&
+      !btif_a2dp_source_cb.media_clock.Start(
+          btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms() *
+              1000,
+          [](uint64_t deadline_us, uint64_t expirations) {
+            btif_a2dp_source_thread.DoInThread(
+                FROM_HERE,
+                base::BindOnce(&btif_a2dp_source_audio_handle_clock_tick,
+                               deadline_us, expirations));
+          })) {
+    LOG_WARN("%s: unable to start the media clock, using the media alarm",
+             __func__);
+    use_media_clock = false;
+  }
+  if (!use_media_clock) {
+    btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
+        btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
+        base::Bind(&btif_a2dp_source_audio_handle_timer),
 #if BASE_VER < 931007
-      base::TimeDelta::FromMilliseconds(
+        base::TimeDelta::FromMilliseconds(
 #else
-      base::Milliseconds(
+        base::Milliseconds(
 #endif
-          btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+            btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+  }
 
   btif_a2dp_source_cb.stats.Reset();
   // Assign session_start_us to 1 when
@@ -866,6 +1133,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   /* Stop the timer first */
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_cb.media_clock.Stop();
   wakelock_release();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
@@ -899,6 +1167,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
 static void btif_a2dp_source_audio_handle_timer(void) {
   if (btif_av_is_a2dp_offload_running()) return;
+  BT_TRACE_SCOPE("a2dp", "encode", 0, 0);
 
 #ifndef TARGET_FLOSS
   uint64_t timestamp_us = bluetooth::common::time_get_os_boottime_us();
@@ -932,6 +1201,18 @@ static void btif_a2dp_source_audio_handle_timer(void) {
                           btif_a2dp_source_cb.encoder_interval_ms * 1000);
 }
 
+static void btif_a2dp_source_audio_handle_clock_tick(uint64_t deadline_us,
+                                                     uint64_t expirations) {
+  // Ignore the ticks posted before the media clock was stopped
+  if (!btif_a2dp_source_cb.media_clock.IsRunning()) return;
+
+  update_media_clock_stats(&btif_a2dp_source_cb.stats.media_clock_stats,
+                           bluetooth::common::time_get_os_boottime_us(),
+                           deadline_us, expirations,
+                           btif_a2dp_source_cb.encoder_interval_ms * 1000);
+  btif_a2dp_source_audio_handle_timer();
+}
+
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   uint32_t bytes_read = 0;
 
@@ -959,6 +1240,7 @@ static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
 
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read) {
+  BT_TRACE_INSTANT("a2dp", "enqueue", 0, 0);
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
   btif_a2dp_control_log_bytes_read(bytes_read);
 
@@ -992,13 +1274,17 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
     btif_a2dp_source_cb.stats.tx_queue_dropouts++;
     btif_a2dp_source_cb.stats.tx_queue_last_dropouts_us = now_us;
 
-    // Flush all queued buffers
-    size_t drop_n = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+    // Drop the oldest queued buffers to make room for the new one, rather
+    // than flushing the whole queue
+    size_t queue_n = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+    size_t drop_n = std::min(
+        queue_n,
+        queue_n + frames_n - btif_a2dp_source_dynamic_audio_buffer_size);
     btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages = std::max(
         drop_n, btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages);
     int num_dropped_encoded_bytes = 0;
     int num_dropped_encoded_frames = 0;
-    while (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue)) {
+    for (size_t i = 0; i < drop_n; i++) {
       btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages++;
       void* p_data =
           fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
@@ -1013,6 +1299,10 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
         btif_av_source_active_peer(), btif_a2dp_source_cb.encoder_interval_ms,
         drop_n, num_dropped_encoded_frames, num_dropped_encoded_bytes);
 
+    // Let the encoder lower its bit rate rather than keep dropping packets
+    btif_a2dp_source_cb.link_quality.tx_queue_dropped_messages += drop_n;
+    btif_a2dp_source_report_link_quality();
+
     // Intel controllers don't handle ReadRSSI, ReadFailedContactCounter, and
     // ReadTxPower very well, it sends back Hardware Error event which will
     // crash the daemon. So temporarily disable this for Floss.
@@ -1048,6 +1338,10 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
       frames_n, btif_a2dp_source_cb.stats.tx_queue_max_frames_per_packet);
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
 
+  if (p_buf->offset >= kTxQueueEnqueueTimeEnd) {
+    memcpy(reinterpret_cast<uint8_t*>(p_buf + 1) + kTxQueueEnqueueTimeOffset,
+           &now_us, sizeof(now_us));
+  }
   fixed_queue_enqueue(btif_a2dp_source_cb.tx_audio_queue, p_buf);
 
   return true;
@@ -1080,10 +1374,56 @@ static bool btif_a2dp_source_audio_tx_flush_req(void) {
   return true;
 }
 
+// Gets the time (in us) a packet may wait in the TX queue before it is
+// dropped. Without a codec latency budget, this is the time it takes to fill
+// up the TX queue.
+static uint64_t btif_a2dp_source_tx_latency_budget_us(void) {
+  uint64_t budget_ms = btif_a2dp_source_cb.tx_latency_budget_ms;
+  if (budget_ms == 0) {
+    budget_ms = btif_a2dp_source_dynamic_audio_buffer_size *
+                btif_a2dp_source_cb.encoder_interval_ms;
+  }
+  return budget_ms * 1000;
+}
+
 BT_HDR* btif_a2dp_source_audio_readbuf(void) {
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
-  BT_HDR* p_buf =
-      (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
+  uint64_t budget_us = btif_a2dp_source_tx_latency_budget_us();
+  size_t late_n = 0;
+  BT_HDR* p_buf;
+
+  // Drop the packets that waited too long one by one, the following ones
+  // are still sent in time
+  while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(
+              btif_a2dp_source_cb.tx_audio_queue)) != nullptr) {
+    if (p_buf->offset < kTxQueueEnqueueTimeEnd) break;
+
+    uint64_t enqueue_us;
+    memcpy(&enqueue_us,
+           reinterpret_cast<uint8_t*>(p_buf + 1) + kTxQueueEnqueueTimeOffset,
+           sizeof(enqueue_us));
+    uint64_t queueing_time_us = now_us - enqueue_us;
+    if (budget_us == 0 || queueing_time_us <= budget_us) {
+      btif_a2dp_source_cb.stats.tx_queue_total_queueing_time_us +=
+          queueing_time_us;
+      btif_a2dp_source_cb.stats.tx_queue_max_queueing_time_us =
+          std::max(queueing_time_us,
+                   btif_a2dp_source_cb.stats.tx_queue_max_queueing_time_us);
+      break;
+    }
+    late_n++;
+    osi_free(p_buf);
+  }
+
+  if (late_n > 0) {
+    LOG_WARN("%s: dropped %zu packets queued for more than %" PRIu64 " ms",
+             __func__, late_n, budget_us / 1000);
+    btif_a2dp_source_cb.stats.tx_queue_total_late_messages += late_n;
+    btif_a2dp_source_cb.stats.tx_queue_last_late_us = now_us;
+    btif_a2dp_source_thread.DoInThread(
+        FROM_HERE,
+        base::BindOnce(&btif_a2dp_source_report_late_messages, late_n));
+  }
 
   btif_a2dp_source_cb.stats.tx_queue_total_readbuf_calls++;
   btif_a2dp_source_cb.stats.tx_queue_last_readbuf_us = now_us;
@@ -1145,6 +1485,53 @@ static void update_scheduling_stats(SchedulingStats* stats, uint64_t now_us,
   }
 }
 
+static size_t media_clock_histogram_bucket(uint64_t delta_us) {
+  size_t i = 0;
+  while (i < kMediaClockHistogramSize - 1 &&
+         delta_us >= kMediaClockHistogramBoundsUs[i]) {
+    i++;
+  }
+  return i;
+}
+
+static void update_media_clock_stats(MediaClockStats* stats, uint64_t now_us,
+                                     uint64_t deadline_us, uint64_t expirations,
+                                     uint64_t expected_delta) {
+  uint64_t last_us = stats->last_tick_us;
+
+  stats->total_ticks++;
+  stats->missed_ticks += expirations - 1;
+  stats->last_tick_us = now_us;
+
+  uint64_t late_us = (now_us > deadline_us) ? now_us - deadline_us : 0;
+  stats->total_late_us += late_us;
+  stats->max_late_us = std::max(late_us, stats->max_late_us);
+  stats->late_histogram[media_clock_histogram_bucket(late_us)]++;
+
+  if (last_us == 0) return;  // First tick: expected delta doesn't apply
+
+  uint64_t delta_us = now_us - last_us;
+  uint64_t drift_us = (delta_us > expected_delta) ? delta_us - expected_delta
+                                                  : expected_delta - delta_us;
+  stats->total_drift_us += drift_us;
+  stats->max_drift_us = std::max(drift_us, stats->max_drift_us);
+  stats->drift_histogram[media_clock_histogram_bucket(drift_us)]++;
+}
+
+static void dump_media_clock_histogram(int fd, const char* name,
+                                       const size_t* histogram) {
+  dprintf(fd, "  %s histogram in us (<", name);
+  for (size_t i = 0; i < kMediaClockHistogramSize - 1; i++) {
+    dprintf(fd, "%" PRIu64 "/", kMediaClockHistogramBoundsUs[i]);
+  }
+  dprintf(fd, ">=%" PRIu64 ") : ",
+          kMediaClockHistogramBoundsUs[kMediaClockHistogramSize - 2]);
+  for (size_t i = 0; i < kMediaClockHistogramSize; i++) {
+    dprintf(fd, (i == 0) ? "%zu" : " / %zu", histogram[i]);
+  }
+  dprintf(fd, "\n");
+}
+
 void btif_a2dp_source_debug_dump(int fd) {
   btif_a2dp_source_accumulate_stats(&btif_a2dp_source_cb.stats,
                                     &btif_a2dp_source_cb.accumulated_stats);
@@ -1152,6 +1539,7 @@ void btif_a2dp_source_debug_dump(int fd) {
   BtifMediaStats* accumulated_stats = &btif_a2dp_source_cb.accumulated_stats;
   SchedulingStats* enqueue_stats = &accumulated_stats->tx_queue_enqueue_stats;
   SchedulingStats* dequeue_stats = &accumulated_stats->tx_queue_dequeue_stats;
+  MediaClockStats* clock_stats = &accumulated_stats->media_clock_stats;
   size_t ave_size;
   uint64_t ave_time_us;
 
@@ -1201,6 +1589,22 @@ void btif_a2dp_source_debug_dump(int fd) {
           "  Counts (max dropped)                                    : %zu\n",
           accumulated_stats->tx_queue_max_dropped_messages);
 
+  dprintf(fd,
+          "  Counts (late)                                           : %zu\n",
+          accumulated_stats->tx_queue_total_late_messages);
+
+  ave_time_us = 0;
+  if (dequeue_stats->total_updates != 0) {
+    ave_time_us = accumulated_stats->tx_queue_total_queueing_time_us /
+                  dequeue_stats->total_updates;
+  }
+  dprintf(fd,
+          "  Queueing time in ms (max/ave)                           : %llu / "
+          "%llu\n",
+          (unsigned long long)accumulated_stats->tx_queue_max_queueing_time_us /
+              1000,
+          (unsigned long long)ave_time_us / 1000);
+
   dprintf(
       fd,
       "  Last update time ago in ms (flushed/dropped)            : %llu / "
@@ -1233,6 +1637,21 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  bluetooth::bqr::BqrLinkQualityStats link_quality;
+  if (bluetooth::bqr::GetLinkQualityStats(btif_av_source_active_peer(),
+                                          &link_quality)) {
+    dprintf(
+        fd,
+        "  Link quality (reports/RSSI avg in dBm)                  : %u / %d\n",
+        link_quality.report_count, link_quality.rssi_avg_x16 / 16);
+    dprintf(
+        fd,
+        "  Link quality counts (retransmission/TX flushed)         : %llu / "
+        "%llu\n",
+        (unsigned long long)link_quality.retransmission_count,
+        (unsigned long long)link_quality.tx_flushed_packets);
+  }
+
   //
   // TxQueue enqueue stats
   //
@@ -1308,6 +1727,42 @@ void btif_a2dp_source_debug_dump(int fd) {
       (unsigned long long)dequeue_stats->max_premature_scheduling_delta_us /
           1000,
       (unsigned long long)ave_time_us / 1000);
+
+  //
+  // Media clock stats
+  //
+  if (clock_stats->total_ticks == 0) return;
+
+  dprintf(fd,
+          "  Media clock ticks (total/missed)                        : %zu / "
+          "%zu\n",
+          clock_stats->total_ticks, clock_stats->missed_ticks);
+
+  dprintf(fd,
+          "  Media clock late tick time in us (total/max/ave)        : %llu / "
+          "%llu / %llu\n",
+          (unsigned long long)clock_stats->total_late_us,
+          (unsigned long long)clock_stats->max_late_us,
+          (unsigned long long)clock_stats->total_late_us /
+              clock_stats->total_ticks);
+
+  size_t drift_count = 0;
+  for (size_t count : clock_stats->drift_histogram) drift_count += count;
+  ave_time_us = 0;
+  if (drift_count != 0) {
+    ave_time_us = clock_stats->total_drift_us / drift_count;
+  }
+  dprintf(fd,
+          "  Media clock tick drift in us (total/max/ave)            : %llu / "
+          "%llu / %llu\n",
+          (unsigned long long)clock_stats->total_drift_us,
+          (unsigned long long)clock_stats->max_drift_us,
+          (unsigned long long)ave_time_us);
+
+  dump_media_clock_histogram(fd, "Media clock late tick",
+                             clock_stats->late_histogram);
+  dump_media_clock_histogram(fd, "Media clock tick drift",
+                             clock_stats->drift_histogram);
 }
 
 static void btif_a2dp_source_update_metrics(void) {
@@ -1381,6 +1836,9 @@ static void btm_read_rssi_cb(void* data) {
 
   LOG_WARN("%s: device: %s, rssi: %d", __func__,
            ADDRESS_TO_LOGGABLE_CSTR(result->rem_bda), result->rssi);
+
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE, base::BindOnce(&btif_a2dp_source_update_rssi, result->rssi));
 }
 
 static void btm_read_failed_contact_counter_cb(void* data) {
@@ -1403,6 +1861,10 @@ static void btm_read_failed_contact_counter_cb(void* data) {
   LOG_WARN("%s: device: %s, Failed Contact Counter: %u", __func__,
            ADDRESS_TO_LOGGABLE_CSTR(result->rem_bda),
            result->failed_contact_counter);
+
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE, base::BindOnce(&btif_a2dp_source_update_failed_contact_counter,
+                                result->failed_contact_counter));
 }
 
 static void btm_read_tx_power_cb(void* data) {
@@ -1424,3 +1886,33 @@ static void btm_read_tx_power_cb(void* data) {
   LOG_WARN("%s: device: %s, Tx Power: %d", __func__,
            ADDRESS_TO_LOGGABLE_CSTR(result->rem_bda), result->tx_power);
 }
+
+// Reports the link quality to the encoder, which may adapt its bit rate.
+// Must be called on the A2DP Source worker thread.
+static void btif_a2dp_source_report_link_quality(void) {
+  if (btif_a2dp_source_cb.encoder_interface == nullptr ||
+      btif_a2dp_source_cb.encoder_interface->set_link_quality == nullptr) {
+    return;
+  }
+  btif_a2dp_source_cb.encoder_interface->set_link_quality(
+      &btif_a2dp_source_cb.link_quality);
+}
+
+static void btif_a2dp_source_report_late_messages(size_t late_n) {
+  btif_a2dp_source_cb.link_quality.tx_queue_dropped_messages += late_n;
+  btif_a2dp_source_report_link_quality();
+}
+
+static void btif_a2dp_source_update_rssi(int8_t rssi) {
+  btif_a2dp_source_cb.link_quality.rssi_valid = true;
+  btif_a2dp_source_cb.link_quality.rssi = rssi;
+  btif_a2dp_source_report_link_quality();
+}
+
+static void btif_a2dp_source_update_failed_contact_counter(
+    uint16_t failed_contact_counter) {
+  btif_a2dp_source_cb.link_quality.failed_contact_counter_valid = true;
+  btif_a2dp_source_cb.link_quality.failed_contact_counter =
+      failed_contact_counter;
+  btif_a2dp_source_report_link_quality();
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <base/functional/bind.h>
 #include <base/logging.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -21,8 +22,12 @@
 #include <statslog_bt.h>
 #endif
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <mutex>
+
 #include "btif/include/stack_manager.h"
 #include "btif_bqr.h"
 #include "btif_common.h"
@@ -32,9 +37,11 @@
 #include "common/leaky_bonded_queue.h"
 #include "common/time_util.h"
 #include "core_callbacks.h"
+#include "os/logging/log_adapter.h"
 #include "osi/include/properties.h"
 #include "raw_address.h"
 #include "stack/btm/btm_dev.h"
+#include "stack/include/btu.h"
 
 namespace bluetooth {
 namespace bqr {
@@ -48,6 +55,14 @@ static std::unique_ptr<LeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
 
 static uint16_t vendor_cap_supported_version;
 
+// The writers batching the trace log files
+static BqrLogDumpWriter lmp_ll_message_trace_writer;
+static BqrLogDumpWriter bt_scheduling_trace_writer;
+
+// The rolling statistics of the connections reporting their link quality
+static std::mutex link_quality_stats_mutex;
+static BqrLinkQualityStats link_quality_stats[kBqrLinkQualityStatsSize];
+
 class BluetoothQualityReportInterfaceImpl;
 std::unique_ptr<BluetoothQualityReportInterface> bluetoothQualityReportInstance;
 
@@ -130,9 +145,11 @@ void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
          << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
          << " VSP: ";
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
+  const std::string log_header = ss_log.str();
+  lmp_ll_message_trace_writer.Append(fd, log_header.c_str(),
+                                     log_header.size());
+  lmp_ll_message_trace_writer.Append(
+      fd, bqr_log_dump_event_.vendor_specific_parameter, length);
   LmpLlMessageTraceCounter++;
 }
 
@@ -152,12 +169,33 @@ void BqrVseSubEvt::WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
          << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
          << " VSP: ";
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
+  const std::string log_header = ss_log.str();
+  bt_scheduling_trace_writer.Append(fd, log_header.c_str(),
+                                    log_header.size());
+  bt_scheduling_trace_writer.Append(
+      fd, bqr_log_dump_event_.vendor_specific_parameter, length);
   BtSchedulingTraceCounter++;
 }
 
+void BqrLogDumpWriter::Append(int fd, const void* data, size_t length) {
+  if (length_ + length > sizeof(buffer_)) {
+    Flush(fd);
+  }
+  if (length > sizeof(buffer_)) {
+    TEMP_FAILURE_RETRY(write(fd, data, length));
+    return;
+  }
+  memcpy(buffer_ + length_, data, length);
+  length_ += length;
+}
+
+void BqrLogDumpWriter::Flush(int fd) {
+  if (length_ > 0 && fd != INVALID_FD) {
+    TEMP_FAILURE_RETRY(write(fd, buffer_, length_));
+  }
+  length_ = 0;
+}
+
 std::string BqrVseSubEvt::ToString() const {
   std::stringstream ss;
   ss << QualityReportIdToString(bqr_link_quality_event_.quality_report_id)
@@ -539,6 +577,7 @@ void AddLinkQualityEventToQueue(uint8_t length,
   RawAddress bd_addr;
 
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
+  UpdateLinkQualityStats(p_bqr_event->bqr_link_quality_event_);
 
   LOG(WARNING) << *p_bqr_event;
   GetInterfaceToProfiles()->events->invoke_link_quality_report_cb(
@@ -608,6 +647,10 @@ void DumpLmpLlMessage(uint8_t length, const uint8_t* p_lmp_ll_message_event) {
 
   if (LmpLlMessageTraceLogFd == INVALID_FD ||
       LmpLlMessageTraceCounter >= kLogDumpEventPerFile) {
+    if (LmpLlMessageTraceLogFd != INVALID_FD) {
+      lmp_ll_message_trace_writer.Flush(LmpLlMessageTraceLogFd);
+      close(LmpLlMessageTraceLogFd);
+    }
     LmpLlMessageTraceLogFd = OpenLmpLlTraceLogFile();
   }
   if (LmpLlMessageTraceLogFd != INVALID_FD) {
@@ -643,6 +686,10 @@ void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event) {
 
   if (BtSchedulingTraceLogFd == INVALID_FD ||
       BtSchedulingTraceCounter == kLogDumpEventPerFile) {
+    if (BtSchedulingTraceLogFd != INVALID_FD) {
+      bt_scheduling_trace_writer.Flush(BtSchedulingTraceLogFd);
+      close(BtSchedulingTraceLogFd);
+    }
     BtSchedulingTraceLogFd = OpenBtSchedulingTraceLogFile();
   }
   if (BtSchedulingTraceLogFd != INVALID_FD) {
@@ -673,7 +720,111 @@ int OpenBtSchedulingTraceLogFile() {
   return logfile_fd;
 }
 
+static void FlushTraceLogs() {
+  lmp_ll_message_trace_writer.Flush(LmpLlMessageTraceLogFd);
+  bt_scheduling_trace_writer.Flush(BtSchedulingTraceLogFd);
+}
+
+void UpdateLinkQualityStats(const BqrLinkQualityEvent& event) {
+  std::lock_guard<std::mutex> lock(link_quality_stats_mutex);
+
+  BqrLinkQualityStats* p_stats = nullptr;
+  BqrLinkQualityStats* p_oldest = &link_quality_stats[0];
+  for (auto& stats : link_quality_stats) {
+    if (stats.report_count > 0 &&
+        stats.connection_handle == event.connection_handle) {
+      p_stats = &stats;
+      break;
+    }
+    if (stats.last_report_ms < p_oldest->last_report_ms) {
+      p_oldest = &stats;
+    }
+  }
+  // A reused handle, or a connection not seen yet
+  if (p_stats == nullptr || p_stats->bdaddr != event.bdaddr) {
+    if (p_stats == nullptr) p_stats = p_oldest;
+    *p_stats = {};
+    p_stats->bdaddr = event.bdaddr;
+    p_stats->connection_handle = event.connection_handle;
+    p_stats->rssi_min = event.rssi;
+    p_stats->rssi_max = event.rssi;
+    p_stats->rssi_avg_x16 = event.rssi * 16;
+    p_stats->snr_avg_x16 = event.snr * 16;
+    p_stats->last_piconet_clock = event.connection_piconet_clock;
+  }
+
+  p_stats->report_count++;
+  p_stats->last_report_ms = bluetooth::common::time_get_os_boottime_ms();
+  p_stats->rssi = event.rssi;
+  p_stats->rssi_min = std::min(p_stats->rssi_min, event.rssi);
+  p_stats->rssi_max = std::max(p_stats->rssi_max, event.rssi);
+  p_stats->rssi_avg_x16 += (event.rssi * 16 - p_stats->rssi_avg_x16) / 8;
+  p_stats->snr_avg_x16 += (event.snr * 16 - p_stats->snr_avg_x16) / 8;
+  p_stats->retransmission_count += event.retransmission_count;
+  p_stats->no_rx_count += event.no_rx_count;
+  p_stats->nak_count += event.nak_count;
+  p_stats->flow_off_count += event.flow_off_count;
+  p_stats->buffer_overflow_bytes += event.buffer_overflow_bytes;
+  p_stats->tx_total_packets += event.tx_total_packets;
+  p_stats->tx_flushed_packets += event.tx_flushed_packets;
+  // The piconet clock is 28 bits wide and wraps around
+  p_stats->air_time +=
+      (event.connection_piconet_clock - p_stats->last_piconet_clock) &
+      0x0FFFFFFF;
+  p_stats->last_piconet_clock = event.connection_piconet_clock;
+}
+
+bool GetLinkQualityStats(const RawAddress& bd_addr,
+                         BqrLinkQualityStats* p_stats) {
+  std::lock_guard<std::mutex> lock(link_quality_stats_mutex);
+  for (const auto& stats : link_quality_stats) {
+    if (stats.report_count > 0 && stats.bdaddr == bd_addr) {
+      *p_stats = stats;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void DumpLinkQualityStats(int fd) {
+  std::lock_guard<std::mutex> lock(link_quality_stats_mutex);
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  dprintf(fd, "\nBT Quality Report Link Statistics: \n");
+  for (const auto& stats : link_quality_stats) {
+    if (stats.report_count == 0) continue;
+    dprintf(fd,
+            "  %s Handle: 0x%04x Reports: %u Last: %llu ms ago Air Time: "
+            "%llu ms\n",
+            ADDRESS_TO_LOGGABLE_CSTR(stats.bdaddr), stats.connection_handle,
+            stats.report_count,
+            (unsigned long long)(now_ms - stats.last_report_ms),
+            (unsigned long long)(stats.air_time * 3125 / 10000));
+    dprintf(fd,
+            "    RSSI (last/min/max/avg): %d / %d / %d / %.1f dBm SNR (avg): "
+            "%.1f dB\n",
+            stats.rssi, stats.rssi_min, stats.rssi_max,
+            stats.rssi_avg_x16 / 16.0, stats.snr_avg_x16 / 16.0);
+    dprintf(fd,
+            "    Counts (retransmission/no RX/NAK/flow off): %llu / %llu / "
+            "%llu / %llu\n",
+            (unsigned long long)stats.retransmission_count,
+            (unsigned long long)stats.no_rx_count,
+            (unsigned long long)stats.nak_count,
+            (unsigned long long)stats.flow_off_count);
+    dprintf(fd,
+            "    TX packets (total/flushed): %llu / %llu Overflow: %llu "
+            "bytes\n",
+            (unsigned long long)stats.tx_total_packets,
+            (unsigned long long)stats.tx_flushed_packets,
+            (unsigned long long)stats.buffer_overflow_bytes);
+  }
+}
+
 void DebugDump(int fd) {
+  // Let the trace log files in the bug report catch up with the events
+  do_in_main_thread(FROM_HERE, base::BindOnce(&FlushTraceLogs));
+  DumpLinkQualityStats(fd);
+
   dprintf(fd, "\nBT Quality Report Events: \n");
 
   if (kpBqrEventQueue->Empty()) {
@@ -25,10 +25,13 @@
 #include <unistd.h>
 
 #include <cctype>
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -307,6 +310,46 @@ std::vector<RawAddress> btif_config_get_paired_devices() {
   return result;
 }
 
+std::vector<std::optional<btif_config_section_t>> btif_config_get_sections(
+    const std::vector<std::string>& sections) {
+  CHECK(bluetooth::shim::is_gd_stack_started_up());
+  return bluetooth::shim::BtifConfigInterface::GetSections(sections);
+}
+
+bool btif_config_section_get_int(const btif_config_section_t& section,
+                                 const std::string& key, int* value) {
+  CHECK(value != nullptr);
+  auto it = section.find(key);
+  if (it == section.end()) return false;
+
+  const char* str = it->second.c_str();
+  char* end = nullptr;
+  errno = 0;
+  long long parsed = strtoll(str, &end, 10);
+  if (errno != 0 || end == str || *end != '\0' ||
+      parsed < std::numeric_limits<int>::min() ||
+      parsed > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  *value = static_cast<int>(parsed);
+  return true;
+}
+
+bool btif_config_section_get_str(const btif_config_section_t& section,
+                                 const std::string& key, char* value,
+                                 int* size_bytes) {
+  CHECK(value != nullptr);
+  CHECK(size_bytes != nullptr);
+  auto it = section.find(key);
+  if (it == section.end()) return false;
+  if (*size_bytes == 0) return true;
+
+  *size_bytes = it->second.copy(value, *size_bytes - 1);
+  value[*size_bytes] = '\0';
+  *size_bytes += 1;
+  return true;
+}
+
 bool btif_config_remove(const std::string& section, const std::string& key) {
   CHECK(bluetooth::shim::is_gd_stack_started_up());
   return bluetooth::shim::BtifConfigInterface::RemoveProperty(section, key);
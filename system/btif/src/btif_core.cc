@@ -165,6 +165,16 @@ bt_status_t do_in_jni_thread(base::OnceClosure task) {
   return do_in_jni_thread(FROM_HERE, std::move(task));
 }
 
+bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                     base::OnceClosure task,
+                                     const base::TimeDelta& delay) {
+  if (!jni_thread.DoInThreadDelayed(from_here, std::move(task), delay)) {
+    LOG(ERROR) << __func__ << ": Post task to task runner failed!";
+    return BT_STATUS_FAIL;
+  }
+  return BT_STATUS_SUCCESS;
+}
+
 bool is_on_jni_thread() {
   return jni_thread.GetThreadId() == PlatformThread::CurrentId();
 }
@@ -401,36 +411,29 @@ static bt_status_t btif_in_get_remote_device_properties(RawAddress* bd_addr) {
   memset(remote_properties, 0, sizeof(remote_properties));
   BTIF_STORAGE_FILL_PROPERTY(&remote_properties[num_props], BT_PROPERTY_BDNAME,
                              sizeof(name), &name);
-  btif_storage_get_remote_device_property(bd_addr,
-                                          &remote_properties[num_props]);
   num_props++;
 
   BTIF_STORAGE_FILL_PROPERTY(&remote_properties[num_props],
                              BT_PROPERTY_REMOTE_FRIENDLY_NAME, sizeof(alias),
                              &alias);
-  btif_storage_get_remote_device_property(bd_addr,
-                                          &remote_properties[num_props]);
   num_props++;
 
   BTIF_STORAGE_FILL_PROPERTY(&remote_properties[num_props],
                              BT_PROPERTY_CLASS_OF_DEVICE, sizeof(cod), &cod);
-  btif_storage_get_remote_device_property(bd_addr,
-                                          &remote_properties[num_props]);
   num_props++;
 
   BTIF_STORAGE_FILL_PROPERTY(&remote_properties[num_props],
                              BT_PROPERTY_TYPE_OF_DEVICE, sizeof(devtype),
                              &devtype);
-  btif_storage_get_remote_device_property(bd_addr,
-                                          &remote_properties[num_props]);
   num_props++;
 
   BTIF_STORAGE_FILL_PROPERTY(&remote_properties[num_props], BT_PROPERTY_UUIDS,
                              sizeof(remote_uuids), remote_uuids);
-  btif_storage_get_remote_device_property(bd_addr,
-                                          &remote_properties[num_props]);
   num_props++;
 
+  btif_storage_get_remote_device_properties(bd_addr, num_props,
+                                            remote_properties, NULL);
+
   GetInterfaceToProfiles()->events->invoke_remote_device_properties_cb(
       BT_STATUS_SUCCESS, *bd_addr, num_props, remote_properties);
 
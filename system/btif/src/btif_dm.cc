@@ -47,8 +47,10 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <map>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 #include "advertise_data_parser.h"
 #include "bta/include/bta_api.h"
@@ -81,6 +83,7 @@
 #include "internal_include/stack_config.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
+#include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -228,6 +231,28 @@ static skip_sdp_entry_t sdp_rejectlist[] = {{76}};  // Apple Mouse and Keyboard
 /* This flag will be true if HCI_Inquiry is in progress */
 static bool btif_dm_inquiry_in_progress = false;
 
+/* The inquiry results of a device received within this window are merged and
+ * reported at once */
+#define BTIF_DM_DISCOVERY_BATCH_MS 100
+
+typedef std::map<bt_property_type_t, std::vector<uint8_t>> btif_dm_properties_t;
+
+typedef struct {
+  /* Properties last reported to the upper layer during this discovery */
+  btif_dm_properties_t reported;
+  /* Properties received since the last report */
+  btif_dm_properties_t to_report;
+  /* Properties not stored yet, they are stored when the discovery ends */
+  btif_dm_properties_t to_store;
+  tBLE_ADDR_TYPE addr_type;
+} btif_dm_discovered_device_t;
+
+/* Devices found during the current discovery */
+static std::map<RawAddress, btif_dm_discovered_device_t> discovered_devices;
+/* Devices with results to report, in the order of their first result */
+static std::vector<RawAddress> discovered_devices_to_report;
+static alarm_t* discovery_batch_alarm = nullptr;
+
 /*******************************************************************************
  *  Static variables
  ******************************************************************************/
@@ -257,6 +282,8 @@ static btif_dm_oob_cb_t oob_cb;
 static btif_dm_metadata_cb_t metadata_cb{.le_audio_cache{40}};
 static void btif_dm_cb_create_bond(const RawAddress bd_addr,
                                    tBT_TRANSPORT transport);
+static void btif_dm_store_discovered_device(const RawAddress& bd_addr);
+static void btif_dm_end_discovery_batch(void);
 static void btif_dm_cb_create_bond_le(const RawAddress bd_addr,
                                       tBLE_ADDR_TYPE addr_type);
 static void btif_update_remote_properties(const RawAddress& bd_addr,
@@ -304,6 +331,9 @@ void btif_dm_cleanup(void) {
     uid_set_destroy(uid_set);
     uid_set = NULL;
   }
+  btif_dm_end_discovery_batch();
+  alarm_free(discovery_batch_alarm);
+  discovery_batch_alarm = nullptr;
 }
 
 bt_status_t btif_in_execute_service_request(tBTA_SERVICE_ID service_id,
@@ -444,38 +474,6 @@ static bool check_eir_appearance(tBTA_DM_SEARCH* p_search_data,
   return false;
 }
 
-/*******************************************************************************
- *
- * Function         check_cached_remote_name
- *
- * Description      Check if remote name is in the NVRAM cache
- *
- * Returns          true if remote name found
- *                  Populate p_remote_name, if provided and remote name found
- *
- ******************************************************************************/
-static bool check_cached_remote_name(tBTA_DM_SEARCH* p_search_data,
-                                     uint8_t* p_remote_name,
-                                     uint8_t* p_remote_name_len) {
-  bt_bdname_t bdname;
-  bt_property_t prop_name;
-
-  /* check if we already have it in our btif_storage cache */
-
-  BTIF_STORAGE_FILL_PROPERTY(&prop_name, BT_PROPERTY_BDNAME,
-                             sizeof(bt_bdname_t), &bdname);
-  if (btif_storage_get_remote_device_property(
-          &p_search_data->inq_res.bd_addr, &prop_name) == BT_STATUS_SUCCESS) {
-    if (p_remote_name && p_remote_name_len) {
-      strcpy((char*)p_remote_name, (char*)bdname.name);
-      *p_remote_name_len = strlen((char*)p_remote_name);
-    }
-    return true;
-  }
-
-  return false;
-}
-
 static uint32_t get_cod(const RawAddress* remote_bdaddr) {
   uint32_t remote_cod;
   bt_property_t prop_name;
@@ -544,6 +542,10 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
                                bt_bond_state_t state) {
   btif_stats_add_bond_event(bd_addr, BTIF_DM_FUNC_BOND_STATE_CHANGED, state);
 
+  if (state == BT_BOND_STATE_BONDING) {
+    btif_dm_store_discovered_device(bd_addr);
+  }
+
   if ((pairing_cb.state == state) && (state == BT_BOND_STATE_BONDING)) {
     // Cross key pairing so send callback for static address
     if (!pairing_cb.static_bdaddr.IsEmpty()) {
@@ -790,6 +792,8 @@ bool is_le_audio_capable_during_service_discovery(const RawAddress& bd_addr) {
  ******************************************************************************/
 static void btif_dm_cb_create_bond(const RawAddress bd_addr,
                                    tBT_TRANSPORT transport) {
+  /* Bonding reads the class and address type from the storage */
+  btif_dm_store_discovered_device(bd_addr);
   bool is_hid = check_cod(&bd_addr, COD_HID_POINTING);
   bond_state_changed(BT_STATUS_SUCCESS, bd_addr, BT_BOND_STATE_BONDING);
 
@@ -1354,6 +1358,153 @@ static void btif_dm_auth_cmpl_evt(tBTA_DM_AUTH_CMPL* p_auth_cmpl) {
   }
 }
 
+/* Merges |p_props| into |properties|, the last value of a property wins */
+static void btif_dm_merge_properties(btif_dm_properties_t& properties,
+                                     uint32_t num_properties,
+                                     const bt_property_t* p_props) {
+  for (uint32_t i = 0; i < num_properties; i++) {
+    const uint8_t* val = static_cast<const uint8_t*>(p_props[i].val);
+    properties[p_props[i].type].assign(val, val + p_props[i].len);
+  }
+}
+
+/* Overrides the values of |properties| read from the storage with the ones
+ * found during the discovery and not stored yet */
+static void btif_dm_get_discovered_properties(const RawAddress& bd_addr,
+                                              int num_properties,
+                                              bt_property_t* properties,
+                                              bt_status_t* status) {
+  auto device = discovered_devices.find(bd_addr);
+  if (device == discovered_devices.end()) return;
+  for (int i = 0; i < num_properties; i++) {
+    auto value = device->second.to_store.find(properties[i].type);
+    if (value == device->second.to_store.end() ||
+        value->second.size() > (size_t)properties[i].len) {
+      continue;
+    }
+    memset(properties[i].val, 0, properties[i].len);
+    memcpy(properties[i].val, value->second.data(), value->second.size());
+    status[i] = BT_STATUS_SUCCESS;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_dm_report_discovered_devices
+ *
+ * Description      Reports the devices with new results to the upper layer,
+ *                  with the properties changed since their last report only
+ *
+ ******************************************************************************/
+static void btif_dm_report_discovered_devices(void) {
+  for (const RawAddress& bd_addr : discovered_devices_to_report) {
+    btif_dm_discovered_device_t& device = discovered_devices[bd_addr];
+    std::vector<bt_property_t> properties;
+    /* The address comes first, it identifies the device */
+    RawAddress addr = bd_addr;
+    properties.push_back({BT_PROPERTY_BDADDR, sizeof(addr), &addr});
+    for (auto& [type, value] : device.to_report) {
+      if (type == BT_PROPERTY_BDADDR) continue;
+      auto reported = device.reported.find(type);
+      if (reported != device.reported.end() && reported->second == value) {
+        continue;
+      }
+      properties.push_back({type, (int)value.size(), value.data()});
+    }
+
+    if (properties.size() > 1) {
+      GetInterfaceToProfiles()->events->invoke_device_found_cb(
+          properties.size(), properties.data());
+    }
+    for (auto& [type, value] : device.to_report) {
+      device.reported[type] = std::move(value);
+    }
+    device.to_report.clear();
+  }
+  discovered_devices_to_report.clear();
+}
+
+static void btif_dm_discovery_batch_timeout(UNUSED_ATTR void* data) {
+  btif_dm_report_discovered_devices();
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_dm_add_discovery_result
+ *
+ * Description      Adds an inquiry result of a device to the batch. The
+ *                  result is stored when the discovery ends, and reported
+ *                  within BTIF_DM_DISCOVERY_BATCH_MS if |report| is true.
+ *
+ ******************************************************************************/
+static void btif_dm_add_discovery_result(const RawAddress& bd_addr,
+                                         uint32_t num_properties,
+                                         bt_property_t* properties,
+                                         tBLE_ADDR_TYPE addr_type,
+                                         bool report) {
+  btif_dm_discovered_device_t& device = discovered_devices[bd_addr];
+  btif_dm_merge_properties(device.to_store, num_properties, properties);
+  device.addr_type = addr_type;
+  if (!report) return;
+
+  if (device.to_report.empty()) {
+    discovered_devices_to_report.push_back(bd_addr);
+  }
+  btif_dm_merge_properties(device.to_report, num_properties, properties);
+
+  if (discovery_batch_alarm == nullptr) {
+    discovery_batch_alarm = alarm_new("btif_dm.discovery_batch");
+  }
+  if (!alarm_is_scheduled(discovery_batch_alarm)) {
+    alarm_set_on_mloop(discovery_batch_alarm, BTIF_DM_DISCOVERY_BATCH_MS,
+                       btif_dm_discovery_batch_timeout, nullptr);
+  }
+}
+
+static void btif_dm_store_device(const RawAddress& bd_addr,
+                                 btif_dm_discovered_device_t& device) {
+  if (device.to_store.empty()) return;
+
+  std::vector<bt_property_t> properties;
+  for (auto& [type, value] : device.to_store) {
+    properties.push_back({type, (int)value.size(), value.data()});
+  }
+  bt_status_t status = btif_storage_add_remote_device(
+      &bd_addr, properties.size(), properties.data());
+  ASSERTC(status == BT_STATUS_SUCCESS,
+          "failed to save remote device (inquiry)", status);
+  status = btif_storage_set_remote_addr_type(&bd_addr, device.addr_type);
+  ASSERTC(status == BT_STATUS_SUCCESS,
+          "failed to save remote addr type (inquiry)", status);
+  device.to_store.clear();
+}
+
+/* Stores the results of |bd_addr| before the discovery ends, for the
+ * procedures reading them from the storage */
+static void btif_dm_store_discovered_device(const RawAddress& bd_addr) {
+  auto device = discovered_devices.find(bd_addr);
+  if (device != discovered_devices.end()) {
+    btif_dm_store_device(bd_addr, device->second);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btif_dm_end_discovery_batch
+ *
+ * Description      Reports the pending results and stores the results of the
+ *                  discovery at once
+ *
+ ******************************************************************************/
+static void btif_dm_end_discovery_batch(void) {
+  alarm_cancel(discovery_batch_alarm);
+  btif_dm_report_discovered_devices();
+  for (auto& [bd_addr, device] : discovered_devices) {
+    btif_dm_store_device(bd_addr, device);
+  }
+  discovered_devices.clear();
+}
+
 /******************************************************************************
  *
  * Function         btif_dm_search_devices_evt
@@ -1391,8 +1542,11 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         uint32_t cod = 0;
         /* Check if we already have cod in our btif_storage cache */
         BTIF_STORAGE_FILL_PROPERTY(&properties[2], BT_PROPERTY_CLASS_OF_DEVICE, sizeof(uint32_t), &cod);
-        if (btif_storage_get_remote_device_property(
-                        &bdaddr, &properties[2]) == BT_STATUS_SUCCESS) {
+        bt_status_t cod_status =
+            btif_storage_get_remote_device_property(&bdaddr, &properties[2]);
+        btif_dm_get_discovered_properties(bdaddr, 1, &properties[2],
+                                          &cod_status);
+        if (cod_status == BT_STATUS_SUCCESS) {
           BTIF_TRACE_DEBUG("%s, BTA_DM_DISC_RES_EVT, cod in storage = 0x%08x", __func__, cod);
         } else {
           BTIF_TRACE_DEBUG("%s, BTA_DM_DISC_RES_EVT, no cod in storage", __func__);
@@ -1427,8 +1581,29 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
                        p_search_data->inq_res.device_type);
       bdname.name[0] = 0;
 
-      if (!check_eir_remote_name(p_search_data, bdname.name, &remote_name_len))
-        check_cached_remote_name(p_search_data, bdname.name, &remote_name_len);
+      /* Fetch what is stored about the device with a single lookup */
+      bt_bdname_t stored_name;
+      int stored_device_type = 0;
+      bt_property_t stored_properties[2];
+      bt_status_t stored_status[2];
+      BTIF_STORAGE_FILL_PROPERTY(&stored_properties[0], BT_PROPERTY_BDNAME,
+                                 sizeof(stored_name), &stored_name);
+      BTIF_STORAGE_FILL_PROPERTY(&stored_properties[1],
+                                 BT_PROPERTY_TYPE_OF_DEVICE,
+                                 sizeof(stored_device_type),
+                                 &stored_device_type);
+      btif_storage_get_remote_device_properties(&bdaddr, 2, stored_properties,
+                                                stored_status);
+      btif_dm_get_discovered_properties(bdaddr, 2, stored_properties,
+                                        stored_status);
+
+      /* Use the cached name if the EIR has none */
+      if (!check_eir_remote_name(p_search_data, bdname.name,
+                                 &remote_name_len) &&
+          stored_status[0] == BT_STATUS_SUCCESS) {
+        strcpy((char*)bdname.name, (char*)stored_name.name);
+        remote_name_len = strlen((char*)bdname.name);
+      }
 
       /* Check EIR for services */
       if (p_search_data->inq_res.p_eir) {
@@ -1441,7 +1616,6 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         bt_property_t properties[10];  // increase when properties are added
         bt_device_type_t dev_type;
         uint32_t num_properties = 0;
-        bt_status_t status;
         tBLE_ADDR_TYPE addr_type = BLE_ADDR_PUBLIC;
 
         memset(properties, 0, sizeof(properties));
@@ -1472,8 +1646,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         /* FixMe: Assumption is that bluetooth.h and BTE enums match */
 
         /* Verify if the device is dual mode in NVRAM */
-        int stored_device_type = 0;
-        if (btif_get_device_type(bdaddr, &stored_device_type) &&
+        if (stored_status[1] == BT_STATUS_SUCCESS &&
             ((stored_device_type != BT_DEVICE_TYPE_BREDR &&
               p_search_data->inq_res.device_type == BT_DEVICE_TYPE_BREDR) ||
              (stored_device_type != BT_DEVICE_TYPE_BLE &&
@@ -1534,7 +1707,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
 #else
         bool report_eir_uuids = false;
 #endif
-        // Scope needs to persist until `invoke_device_found_cb` below.
+        // Scope needs to persist until `btif_dm_add_discovery_result` below.
         std::vector<uint8_t> property_value;
         /* Cache EIR queried services */
         if (num_uuids > 0) {
@@ -1575,27 +1748,21 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
           num_properties++;
         }
 
-        status =
-            btif_storage_add_remote_device(&bdaddr, num_properties, properties);
-        ASSERTC(status == BT_STATUS_SUCCESS,
-                "failed to save remote device (inquiry)", status);
-        status = btif_storage_set_remote_addr_type(&bdaddr, addr_type);
-        ASSERTC(status == BT_STATUS_SUCCESS,
-                "failed to save remote addr type (inquiry)", status);
-
         bool restrict_report = osi_property_get_bool(
             "bluetooth.restrict_discovered_device.enabled", false);
+        bool report = true;
         if (restrict_report &&
             p_search_data->inq_res.device_type == BT_DEVICE_TYPE_BLE &&
             !(p_search_data->inq_res.ble_evt_type & BTM_BLE_CONNECTABLE_MASK)) {
           LOG_INFO("%s: Ble device is not connectable",
                    ADDRESS_TO_LOGGABLE_CSTR(bdaddr));
-          break;
+          report = false;
         }
 
-        /* Callback to notify upper layer of device */
-        GetInterfaceToProfiles()->events->invoke_device_found_cb(num_properties,
-                                                                 properties);
+        /* Stored when the discovery ends, reported to the upper layer with the
+         * other results of the batch */
+        btif_dm_add_discovery_result(bdaddr, num_properties, properties,
+                                     addr_type, report);
       }
     } break;
 
@@ -1603,6 +1770,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
       /* do nothing */
     } break;
     case BTA_DM_DISC_CMPL_EVT: {
+      btif_dm_end_discovery_batch();
       GetInterfaceToProfiles()->events->invoke_discovery_state_changed_cb(
           BT_DISCOVERY_STOPPED);
     } break;
@@ -1617,6 +1785,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
        *
        */
       if (!btif_dm_inquiry_in_progress) {
+        btif_dm_end_discovery_batch();
         GetInterfaceToProfiles()->events->invoke_discovery_state_changed_cb(
             BT_DISCOVERY_STOPPED);
       }
@@ -2048,6 +2217,7 @@ void BTIF_dm_report_inquiry_status_change(tBTM_STATUS status) {
         BT_DISCOVERY_STARTED);
     btif_dm_inquiry_in_progress = true;
   } else if (status == BTM_INQUIRY_CANCELLED) {
+    btif_dm_end_discovery_batch();
     GetInterfaceToProfiles()->events->invoke_discovery_state_changed_cb(
         BT_DISCOVERY_STOPPED);
     btif_dm_inquiry_in_progress = false;
@@ -2452,6 +2622,8 @@ void btif_dm_start_discovery(void) {
     return;
   }
 
+  /* Report all the devices of the new discovery, even if unchanged */
+  btif_dm_end_discovery_batch();
   /* Will be enabled to true once inquiry busy level has been received */
   btif_dm_inquiry_in_progress = false;
   /* find nearby devices */
@@ -34,11 +34,14 @@
 #include <base/strings/stringprintf.h>
 #include <string.h>
 
+#include <iterator>
 #include <list>
 
 #include "btif/include/stack_manager.h"
 #include "btif_common.h"
+#include "device/include/device_iot_config.h"
 #include "main/shim/dumpsys.h"
+#include "stack/include/acl_api.h"
 #include "types/raw_address.h"
 
 /*******************************************************************************
@@ -60,6 +63,7 @@ class ConnectNode {
 
   const RawAddress& address() const { return address_; }
   uint16_t uuid() const { return uuid_; }
+  bool busy() const { return busy_; }
 
   /**
    * Initiate the connection.
@@ -89,6 +93,16 @@ static std::list<ConnectNode> connect_queue;
 
 static const size_t MAX_REASONABLE_REQUESTS = 20;
 
+/* Order in which queued devices are connected, lowest first. */
+enum {
+  /* The ACL is already up, the profile connects without paging */
+  RECONNECT_RANK_ACL_UP,
+  /* No history, or the device connected more often than it failed */
+  RECONNECT_RANK_DEFAULT,
+  /* The device failed more often than it connected, likely out of range */
+  RECONNECT_RANK_UNRELIABLE,
+};
+
 /*******************************************************************************
  *  Queue helper functions
  ******************************************************************************/
@@ -140,6 +154,62 @@ static void queue_int_cleanup(uint16_t uuid) {
 
 static void queue_int_release() { connect_queue.clear(); }
 
+static int connect_history_count(const RawAddress& bda,
+                                 const char* const keys[], size_t num_keys) {
+  int total = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    int count = 0;
+    if (DEVICE_IOT_CONFIG_ADDR_GET_INT(bda, keys[i], count)) total += count;
+  }
+  return total;
+}
+
+static int queue_int_reconnect_rank(const RawAddress& bda) {
+  if (BTM_IsAclConnectionUp(bda, BT_TRANSPORT_BR_EDR)) {
+    return RECONNECT_RANK_ACL_UP;
+  }
+
+  static const char* const success_keys[] = {
+      IOT_CONF_KEY_HFP_SLC_CONN_COUNT,
+      IOT_CONF_KEY_AVRCP_CONN_COUNT,
+  };
+  static const char* const failure_keys[] = {
+      IOT_CONF_KEY_HFP_SLC_CONN_FAIL_COUNT,
+      IOT_CONF_KEY_AVRCP_CONN_FAIL_COUNT,
+      IOT_CONF_KEY_GAP_DISC_CONNTIMEOUT_COUNT,
+  };
+  int successes = connect_history_count(bda, success_keys,
+                                        std::size(success_keys));
+  int failures = connect_history_count(bda, failure_keys,
+                                       std::size(failure_keys));
+  return failures > successes ? RECONNECT_RANK_UNRELIABLE
+                              : RECONNECT_RANK_DEFAULT;
+}
+
+/* Moves the request to execute next to the head of the queue. Requests of
+ * devices that are already connected go first since they need no paging, and
+ * devices that keep failing go last so that their page timeouts do not hold
+ * back the others. The queue order is kept otherwise. */
+static void queue_int_schedule_head() {
+  if (connect_queue.empty() || connect_queue.front().busy()) return;
+
+  auto best = connect_queue.begin();
+  int best_rank = queue_int_reconnect_rank(best->address());
+  for (auto it = std::next(connect_queue.begin());
+       it != connect_queue.end() && best_rank != RECONNECT_RANK_ACL_UP; ++it) {
+    int rank = queue_int_reconnect_rank(it->address());
+    if (rank < best_rank) {
+      best = it;
+      best_rank = rank;
+    }
+  }
+
+  if (best != connect_queue.begin()) {
+    LOG_INFO("Connecting first: %s", best->ToString().c_str());
+    connect_queue.splice(connect_queue.begin(), connect_queue, best);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         btif_queue_connect
@@ -192,6 +262,7 @@ bt_status_t btif_queue_connect_next(void) {
   if (!stack_manager_get_interface()->get_stack_is_running())
     return BT_STATUS_FAIL;
 
+  queue_int_schedule_head();
   ConnectNode& head = connect_queue.front();
 
   LOG_INFO("Executing profile connection request:%s", head.ToString().c_str());
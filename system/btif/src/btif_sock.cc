@@ -40,6 +40,7 @@
 #include "btif_sock_thread.h"
 #include "btif_uid.h"
 #include "btif_util.h"
+#include "osi/include/properties.h"
 #include "osi/include/thread.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
@@ -70,6 +71,9 @@ static thread_t* thread;
 
 #define SOCK_LOGGER_SIZE_MAX 16
 
+// Number of epoll threads serving RFCOMM and L2CAP app sockets
+#define SOCK_IO_THREADS_PROPERTY "persist.bluetooth.socket_io_threads"
+
 struct SockConnectionEvent {
   bool used;
   RawAddress addr;
@@ -101,7 +105,9 @@ bt_status_t btif_sock_init(uid_set_t* uid_set) {
 
   bt_status_t status;
   btsock_thread_init();
-  thread_handle = btsock_thread_create(btsock_signaled, NULL);
+  thread_handle = btsock_thread_create_with_io_threads(
+      btsock_signaled, NULL,
+      osi_property_get_int32(SOCK_IO_THREADS_PROPERTY, 1));
   if (thread_handle == -1) {
     LOG_ERROR("%s unable to create btsock_thread.", __func__);
     goto error;
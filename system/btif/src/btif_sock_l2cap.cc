@@ -42,8 +42,8 @@
 
 struct packet {
   struct packet *next, *prev;
-  uint32_t len;
-  uint8_t* data;
+  uint32_t len;   // bytes left to deliver to the app
+  uint8_t* data;  // points into the same allocation, right after the packet
 };
 
 typedef struct l2cap_socket {
@@ -76,6 +76,12 @@ typedef struct l2cap_socket {
   int64_t rx_bytes;
 } l2cap_socket;
 
+/* Max number of app packets forwarded to the stack per read wakeup */
+#define L2CAP_SOCK_READ_BATCH 8
+
+/* Max number of packets delivered to the app per sendmmsg() */
+#define L2CAP_SOCK_WRITE_BATCH 16
+
 static void btsock_l2cap_server_listen(l2cap_socket* sock);
 
 static std::mutex state_lock;
@@ -102,75 +108,43 @@ static void btsock_l2cap_cbk(tBTA_JV_EVT event, tBTA_JV* p_data,
  * wait
  *       confirming the l2cap_ind until we have more space in the buffer. */
 
-/* returns false if none - caller must free "data" memory when done with it */
-static char packet_get_head_l(l2cap_socket* sock, uint8_t** data,
-                              uint32_t* len) {
+/* allocates a packet with room for |len| bytes of data, in one allocation */
+static struct packet* packet_alloc(uint32_t len) {
+  struct packet* p = (struct packet*)osi_malloc(sizeof(*p) + len);
+
+  p->next = NULL;
+  p->prev = NULL;
+  p->len = len;
+  p->data = (uint8_t*)(p + 1);
+  return p;
+}
+
+/* returns NULL if none - caller must osi_free() the packet when done with it */
+static struct packet* packet_get_head_l(l2cap_socket* sock) {
   struct packet* p = sock->first_packet;
 
-  if (!p) return false;
+  if (!p) return NULL;
 
-  if (data) *data = sock->first_packet->data;
-  if (len) *len = sock->first_packet->len;
   sock->first_packet = p->next;
   if (sock->first_packet)
     sock->first_packet->prev = NULL;
   else
     sock->last_packet = NULL;
 
-  if (len) sock->bytes_buffered -= *len;
-
-  osi_free(p);
+  sock->bytes_buffered -= p->len;
 
-  return true;
-}
-
-static struct packet* packet_alloc(const uint8_t* data, uint32_t len) {
-  struct packet* p = (struct packet*)osi_calloc(sizeof(*p));
-  uint8_t* buf = (uint8_t*)osi_malloc(len);
-
-  p->data = buf;
-  p->len = len;
-  memcpy(p->data, data, len);
   return p;
 }
 
-/* makes a copy of the data, returns true on success */
-static char packet_put_head_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
-
-  /*
-   * We do not check size limits here since this is used to undo "getting" a
-   * packet that the user read incompletely. That is to say the packet was
-   * already in the queue. We do check thos elimits in packet_put_tail_l() since
-   * that function is used to put new data into the queue.
-   */
-
-  if (!p) return false;
-
-  p->prev = NULL;
-  p->next = sock->first_packet;
-  sock->first_packet = p;
-  if (p->next)
-    p->next->prev = p;
-  else
-    sock->last_packet = p;
-
-  sock->bytes_buffered += len;
-
-  return true;
-}
-
-/* makes a copy of the data, returns true on success */
-static char packet_put_tail_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
+/* takes ownership of |p|, returns false if it was dropped */
+static bool packet_put_tail_l(l2cap_socket* sock, struct packet* p) {
   if (sock->bytes_buffered >= L2CAP_MAX_RX_BUFFER) {
     LOG_ERROR("Unable to add to buffer due to buffer overflow socket_id:%u",
               sock->id);
+    osi_free(p);
     return false;
   }
 
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
   p->next = NULL;
   p->prev = sock->last_packet;
   sock->last_packet = p;
@@ -179,7 +153,7 @@ static char packet_put_tail_l(l2cap_socket* sock, const void* data,
   else
     sock->first_packet = p;
 
-  sock->bytes_buffered += len;
+  sock->bytes_buffered += p->len;
 
   return true;
 }
@@ -199,7 +173,7 @@ static l2cap_socket* btsock_l2cap_find_by_id_l(uint32_t id) {
 }
 
 static void btsock_l2cap_free_l(l2cap_socket* sock) {
-  uint8_t* buf;
+  struct packet* p;
   l2cap_socket* t = socks;
 
   while (t && t != sock) t = t->next;
@@ -235,7 +209,7 @@ static void btsock_l2cap_free_l(l2cap_socket* sock) {
              sock->id);
   }
 
-  while (packet_get_head_l(sock, &buf, NULL)) osi_free(buf);
+  while ((p = packet_get_head_l(sock)) != NULL) osi_free(p);
 
   // lower-level close() should be idempotent... so let's call it and see...
   if (sock->is_le_coc) {
@@ -661,20 +635,21 @@ static void on_l2cap_data_ind(tBTA_JV* evt, uint32_t id) {
   uint32_t count;
 
   if (BTA_JvL2capReady(sock->handle, &count) == BTA_JV_SUCCESS) {
-    std::vector<uint8_t> buffer(count);
-    if (BTA_JvL2capRead(sock->handle, sock->id, buffer.data(), count) ==
+    // The SDU is read straight into the packet that is later sent to the app
+    struct packet* p = packet_alloc(count);
+    if (BTA_JvL2capRead(sock->handle, sock->id, p->data, count) !=
         BTA_JV_SUCCESS) {
-      if (packet_put_tail_l(sock, buffer.data(), count)) {
-        bytes_read = count;
-        btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
-                             sock->id);
-      } else {  // connection must be dropped
-        LOG_WARN("Closing socket as unable to push data to socket socket_id:%u",
-                 sock->id);
-        BTA_JvL2capClose(sock->handle);
-        btsock_l2cap_free_l(sock);
-        return;
-      }
+      osi_free(p);
+    } else if (packet_put_tail_l(sock, p)) {
+      bytes_read = count;
+      btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
+                           sock->id);
+    } else {  // connection must be dropped
+      LOG_WARN("Closing socket as unable to push data to socket socket_id:%u",
+               sock->id);
+      BTA_JvL2capClose(sock->handle);
+      btsock_l2cap_free_l(sock);
+      return;
     }
   }
 
@@ -853,26 +828,41 @@ bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel,
  * (for example: unrecoverable error or no data)
  */
 static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  uint32_t len;
-
-  while (packet_get_head_l(sock, &buf, &len)) {
-    ssize_t sent;
-    OSI_NO_INTR(sent = send(sock->our_fd, buf, len, MSG_DONTWAIT));
-    int saved_errno = errno;
-
-    if (sent == (signed)len)
-      osi_free(buf);
-    else if (sent >= 0) {
-      packet_put_head_l(sock, buf + sent, len - sent);
-      osi_free(buf);
-      if (!sent) /* special case if other end not keeping up */
+  struct iovec iov[L2CAP_SOCK_WRITE_BATCH];
+  struct mmsghdr msgs[L2CAP_SOCK_WRITE_BATCH];
+
+  while (sock->first_packet) {
+    /* Each packet is one SOCK_SEQPACKET message, hand a batch of them to the
+     * socket in a single call */
+    unsigned int count = 0;
+    for (struct packet* p = sock->first_packet;
+         p && count < L2CAP_SOCK_WRITE_BATCH; p = p->next, count++) {
+      iov[count].iov_base = p->data;
+      iov[count].iov_len = p->len;
+      memset(&msgs[count], 0, sizeof(msgs[count]));
+      msgs[count].msg_hdr.msg_iov = &iov[count];
+      msgs[count].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent;
+    OSI_NO_INTR(sent = sendmmsg(sock->our_fd, msgs, count, MSG_DONTWAIT));
+    if (sent < 0) {
+      return errno == EWOULDBLOCK || errno == EAGAIN;
+    }
+
+    for (int i = 0; i < sent; i++) {
+      struct packet* p = sock->first_packet;
+      if (msgs[i].msg_len < p->len) {
+        /* keep the rest of the packet at the head of the queue */
+        p->data += msgs[i].msg_len;
+        p->len -= msgs[i].msg_len;
+        sock->bytes_buffered -= msgs[i].msg_len;
         return true;
-    } else {
-      packet_put_head_l(sock, buf, len);
-      osi_free(buf);
-      return saved_errno == EWOULDBLOCK || saved_errno == EAGAIN;
+      }
+      osi_free(packet_get_head_l(sock));
     }
+    if (sent < (int)count) /* other end not keeping up */
+      return true;
   }
 
   return false;
@@ -911,31 +901,45 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
 
            BluetoothSocket.write(...) guarantees that any packet send to this
            socket is broken into pieces no bigger than MTU bytes (as requested
-           by BT spec). */
-        size = std::min(size, (int)sock->tx_mtu);
-
-        BT_HDR* buffer = malloc_l2cap_buf(size);
-        /* The socket is created with SOCK_SEQPACKET, hence we read one message
-         * at the time. */
-        ssize_t count;
-        OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
-                                 MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
-        if (count > sock->tx_mtu) {
-          /* This can't happen thanks to check in BluetoothSocket.java but leave
-           * this in case this socket is ever used anywhere else*/
-          LOG(ERROR) << "recv more than MTU. Data will be lost: " << count;
-          count = sock->tx_mtu;
+           by BT spec). The socket is created with SOCK_SEQPACKET, hence each
+           recv returns one such packet: drain up to L2CAP_SOCK_READ_BATCH of
+           them into SDU sized buffers per wakeup. */
+        int sent = 0;
+        while (sent < L2CAP_SOCK_READ_BATCH && (sent == 0 || size > 0)) {
+          int len = std::min(size, (int)sock->tx_mtu);
+          if (len == 0) len = sock->tx_mtu;
+
+          BT_HDR* buffer = malloc_l2cap_buf(len);
+          ssize_t count;
+          OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), len,
+                                   MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
+          if (count <= 0) {
+            osi_free(buffer);
+            break;
+          }
+          size -= count;
+          if (count > len) {
+            /* This can't happen thanks to check in BluetoothSocket.java but
+             * leave this in case this socket is ever used anywhere else*/
+            LOG(ERROR) << "recv more than MTU. Data will be lost: " << count;
+            count = len;
+          }
+
+          /* When multiple packets smaller than MTU are flushed to the socket,
+             the size of the single packet read could be smaller than the ioctl
+             reported total size of awaiting packets. Hence, we adjust the
+             buffer length. */
+          buffer->len = count;
+          DVLOG(2) << __func__ << ": bytes received from socket: " << count;
+
+          // will take care of freeing buffer
+          BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
+          sent++;
         }
-
-        /* When multiple packets smaller than MTU are flushed to the socket, the
-           size of the single packet read could be smaller than the ioctl
-           reported total size of awaiting packets. Hence, we adjust the buffer
-           length. */
-        buffer->len = count;
-        DVLOG(2) << __func__ << ": bytes received from socket: " << count;
-
-        // will take care of freeing buffer
-        BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
+        // Reading is re-armed by the write completion, unless nothing was sent
+        if (sent == 0 && !(flags & SOCK_THREAD_FD_EXCEPTION))
+          btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP,
+                               SOCK_THREAD_FD_RD, sock->id);
       }
     } else
       drop_it = true;
@@ -20,7 +20,7 @@
  *
  *  Filename:      btif_sock_thread.cc
  *
- *  Description:   socket select thread
+ *  Description:   socket epoll threads
  *
  ******************************************************************************/
 
@@ -33,13 +33,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -50,6 +49,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 #include "bta_api.h"
 #include "btif_common.h"
@@ -66,41 +66,52 @@
   } while (0)
 
 #define MAX_THREAD 8
-#define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
-#define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e)&POLLIN)
-#define IS_WRITE(e) ((e)&POLLOUT)
+#define MAX_EPOLL_EVENTS 64
+#define EPOLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
+#define IS_EXCEPTION(e) ((e)&EPOLL_EXCEPTION_EVENTS)
+#define IS_READ(e) ((e)&EPOLLIN)
+#define IS_WRITE(e) ((e)&EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
-#define CMD_ADD_FD 3
 #define CMD_REMOVE_FD 4
 #define CMD_USER_PRIVATE 5
 
 struct poll_slot_t {
-  struct pollfd pfd;
+  int fd;
   uint32_t user_id;
   int type;
   int flags;
 };
-struct thread_slot_t {
-  int cmd_fdr, cmd_fdw;
-  int poll_count;
-  poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
+/* One epoll instance and the thread waiting on it. The data fds of a socket
+ * thread handle are sharded over its I/O threads by fd number. */
+struct io_thread_t {
+  int epoll_fd = -1;
+  int cmd_fdr = -1, cmd_fdw = -1;
   std::optional<pthread_t> thread_id;
+  std::mutex slot_lock;  // guards slots
+  std::unordered_map<int, poll_slot_t> slots;
+};
+struct thread_slot_t {
+  int io_thread_count;
+  io_thread_t io[BTSOCK_MAX_IO_THREADS];
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
   int used;
 };
 static thread_slot_t ts[MAX_THREAD];
 
-static void* sock_poll_thread(void* arg);
-static inline void close_cmd_fd(int h);
+typedef struct {
+  int id;
+  int fd;
+  int type;
+  int flags;
+  uint32_t user_id;
+} sock_cmd_t;
 
-static inline void add_poll(int h, int fd, int type, int flags,
-                            uint32_t user_id);
+static void* sock_poll_thread(void* arg);
+static bool send_cmd(io_thread_t* io, const void* cmd, int size);
+static inline void close_io_fds(io_thread_t* io);
 
 static std::recursive_mutex thread_slot_lock;
 
@@ -129,7 +140,7 @@ static inline int create_thread(void* (*start_routine)(void*), void* arg,
   pthread_setschedparam(*thread_id, policy, &param);
   return ret;
 }
-static void init_poll(int cmd_fd);
+static bool init_poll(int h, int io_thread_count);
 static int alloc_thread_slot() {
   std::unique_lock<std::recursive_mutex> lock(thread_slot_lock);
   int i;
@@ -145,7 +156,12 @@ static int alloc_thread_slot() {
 }
 static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
-    close_cmd_fd(h);
+    for (int i = 0; i < BTSOCK_MAX_IO_THREADS; i++) {
+      close_io_fds(&ts[h].io[i]);
+      std::lock_guard<std::mutex> lock(ts[h].io[i].slot_lock);
+      ts[h].io[i].slots.clear();
+    }
+    ts[h].io_thread_count = 0;
     ts[h].used = 0;
   } else
     APPL_TRACE_ERROR("invalid thread handle:%d", h);
@@ -156,90 +172,172 @@ void btsock_thread_init() {
     initialized = 1;
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
-      ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].io_thread_count = 0;
       ts[h].used = 0;
-      ts[h].thread_id = std::nullopt;
-      ts[h].poll_count = 0;
       ts[h].callback = NULL;
       ts[h].cmd_callback = NULL;
     }
   }
 }
-int btsock_thread_create(btsock_signaled_cb callback,
-                         btsock_cmd_cb cmd_callback) {
+static void join_io_threads(int h) {
+  for (int i = 0; i < ts[h].io_thread_count; i++) {
+    io_thread_t* io = &ts[h].io[i];
+    if (io->thread_id != std::nullopt) {
+      pthread_join(io->thread_id.value(), 0);
+      io->thread_id = std::nullopt;
+    }
+  }
+}
+int btsock_thread_create_with_io_threads(btsock_signaled_cb callback,
+                                         btsock_cmd_cb cmd_callback,
+                                         int io_thread_count) {
   asrt(callback || cmd_callback);
+  if (io_thread_count < 1) io_thread_count = 1;
+  if (io_thread_count > BTSOCK_MAX_IO_THREADS) {
+    LOG_WARN("io thread count %d clamped to %d", io_thread_count,
+             BTSOCK_MAX_IO_THREADS);
+    io_thread_count = BTSOCK_MAX_IO_THREADS;
+  }
   int h = alloc_thread_slot();
   if (h >= 0) {
-    init_poll(h);
-    pthread_t thread;
-    int status = create_thread(sock_poll_thread, (void*)(uintptr_t)h, &thread);
-    if (status) {
-      APPL_TRACE_ERROR("create_thread failed: %s", strerror(status));
+    if (!init_poll(h, io_thread_count)) {
       free_thread_slot(h);
       return -1;
     }
-
-    ts[h].thread_id = thread;
     ts[h].callback = callback;
     ts[h].cmd_callback = cmd_callback;
+    for (int i = 0; i < io_thread_count; i++) {
+      pthread_t thread;
+      int status = create_thread(
+          sock_poll_thread, (void*)(uintptr_t)(h * BTSOCK_MAX_IO_THREADS + i),
+          &thread);
+      if (status) {
+        APPL_TRACE_ERROR("create_thread failed: %s", strerror(status));
+        sock_cmd_t cmd = {CMD_EXIT, 0, 0, 0, 0};
+        for (int j = 0; j < i; j++) send_cmd(&ts[h].io[j], &cmd, sizeof(cmd));
+        join_io_threads(h);
+        free_thread_slot(h);
+        return -1;
+      }
+      ts[h].io[i].thread_id = thread;
+    }
   }
   return h;
 }
+int btsock_thread_create(btsock_signaled_cb callback,
+                         btsock_cmd_cb cmd_callback) {
+  return btsock_thread_create_with_io_threads(callback, cmd_callback, 1);
+}
 
-/* create dummy socket pair used to wake up select loop */
-static inline void init_cmd_fd(int h) {
-  asrt(ts[h].cmd_fdr == -1 && ts[h].cmd_fdw == -1);
-  if (socketpair(AF_UNIX, SOCK_STREAM, 0, &ts[h].cmd_fdr) < 0) {
+/* create the epoll instance and the dummy socket pair used to wake it up */
+static inline bool init_io_fds(io_thread_t* io) {
+  asrt(io->epoll_fd == -1 && io->cmd_fdr == -1 && io->cmd_fdw == -1);
+  io->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (io->epoll_fd == -1) {
+    APPL_TRACE_ERROR("epoll_create1 failed: %s", strerror(errno));
+    return false;
+  }
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, &io->cmd_fdr) < 0) {
     APPL_TRACE_ERROR("socketpair failed: %s", strerror(errno));
-    return;
+    return false;
   }
-  // add the cmd fd for read & write
-  add_poll(h, ts[h].cmd_fdr, 0, SOCK_THREAD_FD_RD, 0);
+  // the cmd fd stays armed for read for the lifetime of the thread
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = io->cmd_fdr;
+  if (epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, io->cmd_fdr, &event) == -1) {
+    APPL_TRACE_ERROR("epoll_ctl add cmd fd failed: %s", strerror(errno));
+    return false;
+  }
+  return true;
 }
-static inline void close_cmd_fd(int h) {
-  if (ts[h].cmd_fdr != -1) {
-    close(ts[h].cmd_fdr);
-    ts[h].cmd_fdr = -1;
+static inline void close_io_fds(io_thread_t* io) {
+  if (io->cmd_fdr != -1) {
+    close(io->cmd_fdr);
+    io->cmd_fdr = -1;
+  }
+  if (io->cmd_fdw != -1) {
+    close(io->cmd_fdw);
+    io->cmd_fdw = -1;
   }
-  if (ts[h].cmd_fdw != -1) {
-    close(ts[h].cmd_fdw);
-    ts[h].cmd_fdw = -1;
+  if (io->epoll_fd != -1) {
+    close(io->epoll_fd);
+    io->epoll_fd = -1;
   }
 }
-typedef struct {
-  int id;
-  int fd;
-  int type;
-  int flags;
-  uint32_t user_id;
-} sock_cmd_t;
+static inline io_thread_t* io_thread_for_fd(int h, int fd) {
+  return &ts[h].io[fd % ts[h].io_thread_count];
+}
+static bool send_cmd(io_thread_t* io, const void* cmd, int size) {
+  ssize_t ret;
+  OSI_NO_INTR(ret = send(io->cmd_fdw, cmd, size, 0));
+  return ret == size;
+}
+static inline uint32_t flags2epevents(int flags) {
+  // Every registration is one-shot: once an event fires the fd stays in the
+  // epoll set but is disabled until the socket code re-arms it.
+  uint32_t events = EPOLLONESHOT;
+  if (flags & SOCK_THREAD_FD_WR) events |= EPOLLOUT;
+  if (flags & SOCK_THREAD_FD_RD) events |= EPOLLIN;
+  events |= EPOLL_EXCEPTION_EVENTS;
+  return events;
+}
+// slot_lock must be held
+static void arm_slot_locked(io_thread_t* io, const poll_slot_t& slot,
+                            bool is_new) {
+  struct epoll_event event = {};
+  event.events = flags2epevents(slot.flags);
+  event.data.fd = slot.fd;
+  int op = is_new ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  if (epoll_ctl(io->epoll_fd, op, slot.fd, &event) == 0) return;
+  // The slot map and the epoll set can disagree when a fd was closed without
+  // being removed (the kernel drops it) or when a disarmed entry was dropped
+  // from the map while the fd stayed registered.
+  if (errno == ENOENT && op == EPOLL_CTL_MOD)
+    op = EPOLL_CTL_ADD;
+  else if (errno == EEXIST && op == EPOLL_CTL_ADD)
+    op = EPOLL_CTL_MOD;
+  else {
+    APPL_TRACE_ERROR("epoll_ctl op:%d fd:%d failed: %s", op, slot.fd,
+                     strerror(errno));
+    return;
+  }
+  if (epoll_ctl(io->epoll_fd, op, slot.fd, &event) == -1)
+    APPL_TRACE_ERROR("epoll_ctl op:%d fd:%d failed: %s", op, slot.fd,
+                     strerror(errno));
+}
+static void add_poll(int h, int fd, int type, int flags, uint32_t user_id) {
+  asrt(fd != -1);
+  io_thread_t* io = io_thread_for_fd(h, fd);
+  std::lock_guard<std::mutex> lock(io->slot_lock);
+  auto it = io->slots.find(fd);
+  bool is_new = it == io->slots.end();
+  if (!is_new) {
+    if (it->second.type != 0 && it->second.type != type)
+      APPL_TRACE_ERROR(
+          "poll socket type should not changed! type was:%d, type now:%d",
+          it->second.type, type);
+    flags |= it->second.flags;
+  }
+  poll_slot_t& slot = io->slots[fd];
+  slot = {fd, user_id, type, flags};
+  arm_slot_locked(io, slot, is_new);
+}
 int btsock_thread_add_fd(int h, int fd, int type, int flags, uint32_t user_id) {
   if (h < 0 || h >= MAX_THREAD) {
     APPL_TRACE_ERROR("invalid bt thread handle:%d", h);
     return false;
   }
-  if (ts[h].cmd_fdw == -1) {
+  if (ts[h].io_thread_count == 0 || ts[h].io[0].cmd_fdw == -1) {
     APPL_TRACE_ERROR(
         "cmd socket is not created. socket thread may not initialized");
     return false;
   }
-  if (flags & SOCK_THREAD_ADD_FD_SYNC) {
-    // must executed in socket poll thread
-    if (ts[h].thread_id.value() == pthread_self()) {
-      // cleanup one-time flags
-      flags &= ~SOCK_THREAD_ADD_FD_SYNC;
-      add_poll(h, fd, type, flags, user_id);
-      return true;
-    }
-    LOG_WARN(
-        "THREAD_ADD_FD_SYNC is not called in poll thread, fallback to async");
-  }
-  sock_cmd_t cmd = {CMD_ADD_FD, fd, type, flags, user_id};
-
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[h].cmd_fdw, &cmd, sizeof(cmd), 0));
-
-  return ret == sizeof(cmd);
+  // epoll registration is thread safe, so the fd is armed right away from any
+  // thread and the sync flag has nothing left to do
+  flags &= ~SOCK_THREAD_ADD_FD_SYNC;
+  add_poll(h, fd, type, flags, user_id);
+  return true;
 }
 
 bool btsock_thread_remove_fd_and_close(int thread_handle, int fd) {
@@ -251,13 +349,16 @@ bool btsock_thread_remove_fd_and_close(int thread_handle, int fd) {
     APPL_TRACE_ERROR("%s invalid file descriptor.", __func__);
     return false;
   }
+  if (ts[thread_handle].io_thread_count == 0) {
+    APPL_TRACE_ERROR("%s thread handle %d is not running", __func__,
+                     thread_handle);
+    return false;
+  }
 
+  // Closed by the I/O thread owning the fd, so it can not be closed while
+  // its callback is running.
   sock_cmd_t cmd = {CMD_REMOVE_FD, fd, 0, 0, 0};
-
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[thread_handle].cmd_fdw, &cmd, sizeof(cmd), 0));
-
-  return ret == sizeof(cmd);
+  return send_cmd(io_thread_for_fd(thread_handle, fd), &cmd, sizeof(cmd));
 }
 
 int btsock_thread_post_cmd(int h, int type, const unsigned char* data, int size,
@@ -266,7 +367,7 @@ int btsock_thread_post_cmd(int h, int type, const unsigned char* data, int size,
     APPL_TRACE_ERROR("invalid bt thread handle:%d", h);
     return false;
   }
-  if (ts[h].cmd_fdw == -1) {
+  if (ts[h].io_thread_count == 0 || ts[h].io[0].cmd_fdw == -1) {
     APPL_TRACE_ERROR(
         "cmd socket is not created. socket thread may not initialized");
     return false;
@@ -287,124 +388,58 @@ int btsock_thread_post_cmd(int h, int type, const unsigned char* data, int size,
     }
   }
 
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[h].cmd_fdw, cmd_send, size_send, 0));
-
-  return ret == size_send;
+  // user commands are always handled by the first I/O thread
+  return send_cmd(&ts[h].io[0], cmd_send, size_send);
 }
 int btsock_thread_wakeup(int h) {
   if (h < 0 || h >= MAX_THREAD) {
     APPL_TRACE_ERROR("invalid bt thread handle:%d", h);
     return false;
   }
-  if (ts[h].cmd_fdw == -1) {
+  if (ts[h].io_thread_count == 0 || ts[h].io[0].cmd_fdw == -1) {
     APPL_TRACE_ERROR("thread handle:%d, cmd socket is not created", h);
     return false;
   }
   sock_cmd_t cmd = {CMD_WAKEUP, 0, 0, 0, 0};
-
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[h].cmd_fdw, &cmd, sizeof(cmd), 0));
-
-  return ret == sizeof(cmd);
+  return send_cmd(&ts[h].io[0], &cmd, sizeof(cmd));
 }
 int btsock_thread_exit(int h) {
   if (h < 0 || h >= MAX_THREAD) {
     APPL_TRACE_ERROR("invalid bt thread slot:%d", h);
     return false;
   }
-  if (ts[h].cmd_fdw == -1) {
+  if (ts[h].io_thread_count == 0 || ts[h].io[0].cmd_fdw == -1) {
     APPL_TRACE_ERROR("cmd socket is not created");
     return false;
   }
   sock_cmd_t cmd = {CMD_EXIT, 0, 0, 0, 0};
-
-  ssize_t ret;
-  OSI_NO_INTR(ret = send(ts[h].cmd_fdw, &cmd, sizeof(cmd), 0));
-
-  if (ret == sizeof(cmd)) {
-    if (ts[h].thread_id != std::nullopt) {
-      pthread_join(ts[h].thread_id.value(), 0);
-      ts[h].thread_id = std::nullopt;
+  for (int i = 0; i < ts[h].io_thread_count; i++) {
+    if (!send_cmd(&ts[h].io[i], &cmd, sizeof(cmd))) {
+      APPL_TRACE_ERROR("failed to stop io thread %d of handle:%d", i, h);
+      return false;
     }
-    free_thread_slot(h);
-    return true;
   }
-  return false;
+  join_io_threads(h);
+  free_thread_slot(h);
+  return true;
 }
-static void init_poll(int h) {
-  int i;
-  ts[h].poll_count = 0;
-  ts[h].thread_id = std::nullopt;
+static bool init_poll(int h, int io_thread_count) {
+  ts[h].io_thread_count = io_thread_count;
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
-  for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
-  }
-  init_cmd_fd(h);
-}
-static inline unsigned int flags2pevents(int flags) {
-  unsigned int pevents = 0;
-  if (flags & SOCK_THREAD_FD_WR) pevents |= POLLOUT;
-  if (flags & SOCK_THREAD_FD_RD) pevents |= POLLIN;
-  pevents |= POLL_EXCEPTION_EVENTS;
-  return pevents;
-}
-
-static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
-                            uint32_t user_id) {
-  ps->pfd.fd = fd;
-  ps->user_id = user_id;
-  if (ps->type != 0 && ps->type != type)
-    APPL_TRACE_ERROR(
-        "poll socket type should not changed! type was:%d, type now:%d",
-        ps->type, type);
-  ps->type = type;
-  ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
-}
-static inline void add_poll(int h, int fd, int type, int flags,
-                            uint32_t user_id) {
-  asrt(fd != -1);
-  int i;
-  int empty = -1;
-  poll_slot_t* ps = ts[h].ps;
-
-  for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
-      asrt(ts[h].poll_count < MAX_POLL);
-
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
-      return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1)
-      empty = i;
+  for (int i = 0; i < io_thread_count; i++) {
+    ts[h].io[i].thread_id = std::nullopt;
+    if (!init_io_fds(&ts[h].io[i])) return false;
   }
-  if (empty >= 0) {
-    asrt(ts[h].poll_count < MAX_POLL);
-    set_poll(&ps[empty], fd, type, flags, user_id);
-    ++ts[h].poll_count;
-    return;
-  }
-  APPL_TRACE_ERROR("exceeded max poll slot:%d!", MAX_POLL);
+  return true;
 }
-static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
-  if (flags == ps->flags) {
-    // all monitored events signaled. To remove it, just clear the slot
-    --ts[h].poll_count;
-    memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
-  } else {
-    // one read or one write monitor event signaled, removed the accordding bit
-    ps->flags &= ~flags;
-    // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
-  }
+static void remove_poll(io_thread_t* io, int fd) {
+  std::lock_guard<std::mutex> lock(io->slot_lock);
+  if (io->slots.erase(fd)) epoll_ctl(io->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
 }
-static int process_cmd_sock(int h) {
+static int process_cmd_sock(int h, io_thread_t* io) {
   sock_cmd_t cmd = {-1, 0, 0, 0, 0};
-  int fd = ts[h].cmd_fdr;
+  int fd = io->cmd_fdr;
 
   ssize_t ret;
   OSI_NO_INTR(ret = recv(fd, &cmd, sizeof(cmd), MSG_WAITALL));
@@ -414,17 +449,8 @@ static int process_cmd_sock(int h) {
     return false;
   }
   switch (cmd.id) {
-    case CMD_ADD_FD:
-      add_poll(h, cmd.fd, cmd.type, cmd.flags, cmd.user_id);
-      break;
     case CMD_REMOVE_FD:
-      for (int i = 1; i < MAX_POLL; ++i) {
-        poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
-          remove_poll(h, poll_slot, poll_slot->flags);
-          break;
-        }
-      }
+      remove_poll(io, cmd.fd);
       close(cmd.fd);
       break;
     case CMD_WAKEUP:
@@ -443,95 +469,70 @@ static int process_cmd_sock(int h) {
   return true;
 }
 
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count,
-                              int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        LOG_INFO("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags)
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
-    }
-  }
-}
-
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      APPL_TRACE_ERROR(
-          "exceed max poll range, ps_i:%d, MAX_POLL:%d, count:%d, "
-          "ts[h].poll_count:%d",
-          ps_i, MAX_POLL, count, ts[h].poll_count);
+static void process_data_sock(int h, io_thread_t* io,
+                              const struct epoll_event* event) {
+  int fd = event->data.fd;
+  uint32_t user_id;
+  int type;
+  int flags = 0;
+  {
+    std::lock_guard<std::mutex> lock(io->slot_lock);
+    auto it = io->slots.find(fd);
+    if (it == io->slots.end()) {
+      LOG_INFO("Socket has been removed from poll set");
       return;
     }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
+    poll_slot_t& slot = it->second;
+    user_id = slot.user_id;
+    type = slot.type;
+    if (IS_READ(event->events) && (slot.flags & SOCK_THREAD_FD_RD)) {
+      flags |= SOCK_THREAD_FD_RD;
+    }
+    if (IS_WRITE(event->events) && (slot.flags & SOCK_THREAD_FD_WR)) {
+      flags |= SOCK_THREAD_FD_WR;
+    }
+    if (IS_EXCEPTION(event->events)) {
+      flags |= SOCK_THREAD_FD_EXCEPTION;
+      // remove the whole slot not flags
+      epoll_ctl(io->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+      io->slots.erase(it);
+    } else {
+      // remove the monitor flags that already processed, keep watching the
+      // rest
+      slot.flags &= ~flags;
+      if (slot.flags)
+        arm_slot_locked(io, slot, false);
+      else
+        io->slots.erase(it);
     }
-    ps_i++;
   }
+  if (flags) ts[h].callback(fd, type, flags, user_id);
 }
+
 static void* sock_poll_thread(void* arg) {
-  std::array<struct pollfd, MAX_POLL> pfds;
+  std::array<struct epoll_event, MAX_EPOLL_EVENTS> events;
 
-  int h = (intptr_t)arg;
+  int h = (intptr_t)arg / BTSOCK_MAX_IO_THREADS;
+  io_thread_t* io = &ts[h].io[(intptr_t)arg % BTSOCK_MAX_IO_THREADS];
   for (;;) {
-    pfds = {};
-    prepare_poll_fds(h, pfds.data());
     int ret;
-    OSI_NO_INTR(ret = poll(pfds.data(), ts[h].poll_count, -1));
+    OSI_NO_INTR(ret = epoll_wait(io->epoll_fd, events.data(),
+                                 MAX_EPOLL_EVENTS, -1));
     if (ret == -1) {
-      APPL_TRACE_ERROR("poll ret -1, exit the thread, errno:%d, err:%s", errno,
-                       strerror(errno));
+      APPL_TRACE_ERROR("epoll_wait ret -1, exit the thread, errno:%d, err:%s",
+                       errno, strerror(errno));
       break;
     }
-    if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
-        if (!process_cmd_sock(h)) {
-          LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
-          break;
-        }
-        if (ret == 1)
-          need_process_data_fd = false;
-        else
-          ret--;  // exclude the cmd fd
+    int i;
+    for (i = 0; i < ret; i++) {
+      if (events[i].data.fd != io->cmd_fdr) {
+        process_data_sock(h, io, &events[i]);
+      } else if (!process_cmd_sock(h, io)) {
+        LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
+        break;
       }
-      if (need_process_data_fd)
-        process_data_sock(h, pfds.data(), pfds_count, ret);
-    } else {
-      LOG_INFO("no data, select ret: %d", ret);
-    };
+    }
+    if (i < ret) break;
   }
   LOG_INFO("socket poll thread exiting, h:%d", h);
   return 0;
@@ -39,6 +39,9 @@
 #include <string.h>
 #include <time.h>
 
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -130,6 +133,33 @@ void btif_gatts_add_bonded_dev_from_nv(const RawAddress& bda);
 
 static bool btif_has_ble_keys(const std::string& bdstr);
 
+/*******************************************************************************
+ *  Bonded devices
+ ******************************************************************************/
+
+/* Whether each device has a link key or LE keys, as btif_in_fetch_bonded_device
+ * finds it. Filled by the walk over the bonded devices at enable, so that the
+ * profiles loading their devices afterwards don't read and decode every key
+ * again. The entry of a device is dropped when its keys or type are written.
+ */
+static std::mutex bonded_device_cache_mutex;
+static std::unordered_map<std::string, bool> bonded_device_cache;
+
+/* The bonded devices added to BTA by btif_storage_load_le_devices, for
+ * btif_storage_load_bonded_devices which follows it at enable */
+static std::optional<btif_bonded_devices_t> loaded_bonded_devices;
+
+static void btif_bonded_device_cache_set(const std::string& bdstr,
+                                         bool bonded) {
+  std::lock_guard<std::mutex> lock(bonded_device_cache_mutex);
+  bonded_device_cache[bdstr] = bonded;
+}
+
+static void btif_bonded_device_cache_invalidate(const std::string& bdstr) {
+  std::lock_guard<std::mutex> lock(bonded_device_cache_mutex);
+  bonded_device_cache.erase(bdstr);
+}
+
 /*******************************************************************************
  *  Static functions
  ******************************************************************************/
@@ -190,6 +220,7 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
     case BT_PROPERTY_TYPE_OF_DEVICE:
       btif_config_set_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
                           *(int*)prop->val);
+      btif_bonded_device_cache_invalidate(bdstr);
       break;
     case BT_PROPERTY_UUIDS: {
       std::string val;
@@ -247,7 +278,28 @@ static int prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   return true;
 }
 
-static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
+/* Read a key of the remote device section |bdstr|, from |section| when the
+ * section was already fetched with btif_config_get_sections() */
+static bool cfg_get_int(const std::string& bdstr,
+                        const btif_config_section_t* section,
+                        const std::string& key, int* value) {
+  if (section != nullptr) {
+    return btif_config_section_get_int(*section, key, value);
+  }
+  return btif_config_get_int(bdstr, key, value);
+}
+
+static bool cfg_get_str(const std::string& bdstr,
+                        const btif_config_section_t* section,
+                        const std::string& key, char* value, int* size_bytes) {
+  if (section != nullptr) {
+    return btif_config_section_get_str(*section, key, value, size_bytes);
+  }
+  return btif_config_get_str(bdstr, key, value, size_bytes);
+}
+
+static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop,
+                    const btif_config_section_t* section = nullptr) {
   std::string bdstr;
   if (remote_bd_addr) {
     bdstr = remote_bd_addr->ToString();
@@ -261,14 +313,14 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTIME,
-                                  (int*)prop->val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_REMOTE_DEVTIME,
+                          (int*)prop->val);
       break;
     case BT_PROPERTY_BDNAME: {
       int len = prop->len;
       if (remote_bd_addr)
-        ret = btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_NAME,
-                                  (char*)prop->val, &len);
+        ret = cfg_get_str(bdstr, section, BTIF_STORAGE_PATH_REMOTE_NAME,
+                          (char*)prop->val, &len);
       else
         ret = btif_config_get_str("Adapter", BTIF_STORAGE_KEY_ADAPTER_NAME,
                                   (char*)prop->val, &len);
@@ -282,8 +334,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
     }
     case BT_PROPERTY_REMOTE_FRIENDLY_NAME: {
       int len = prop->len;
-      ret = btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_ALIASE,
-                                (char*)prop->val, &len);
+      ret = cfg_get_str(bdstr, section, BTIF_STORAGE_PATH_REMOTE_ALIASE,
+                        (char*)prop->val, &len);
       if (ret && len && len <= prop->len)
         prop->len = len - 1;
       else {
@@ -310,19 +362,19 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       break;
     case BT_PROPERTY_CLASS_OF_DEVICE:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
-                                  (int*)prop->val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_REMOTE_DEVCLASS,
+                          (int*)prop->val);
       break;
     case BT_PROPERTY_TYPE_OF_DEVICE:
       if (prop->len >= (int)sizeof(int))
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
-                                  (int*)prop->val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_REMOTE_DEVTYPE,
+                          (int*)prop->val);
       break;
     case BT_PROPERTY_UUIDS: {
       char value[1280];
       int size = sizeof(value);
-      if (btif_config_get_str(bdstr, BTIF_STORAGE_PATH_REMOTE_SERVICE, value,
-                              &size)) {
+      if (cfg_get_str(bdstr, section, BTIF_STORAGE_PATH_REMOTE_SERVICE, value,
+                      &size)) {
         Uuid* p_uuid = reinterpret_cast<Uuid*>(prop->val);
         size_t num_uuids =
             btif_split_uuids_string(value, p_uuid, BT_MAX_NUM_UUIDS);
@@ -338,16 +390,16 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       bt_remote_version_t* info = (bt_remote_version_t*)prop->val;
 
       if (prop->len >= (int)sizeof(bt_remote_version_t)) {
-        ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_MFCT,
-                                  &info->manufacturer);
+        ret = cfg_get_int(bdstr, section, BT_CONFIG_KEY_REMOTE_VER_MFCT,
+                          &info->manufacturer);
 
         if (ret)
-          ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_VER,
-                                    &info->version);
+          ret = cfg_get_int(bdstr, section, BT_CONFIG_KEY_REMOTE_VER_VER,
+                            &info->version);
 
         if (ret)
-          ret = btif_config_get_int(bdstr, BT_CONFIG_KEY_REMOTE_VER_SUBVER,
-                                    &info->sub_ver);
+          ret = cfg_get_int(bdstr, section, BT_CONFIG_KEY_REMOTE_VER_SUBVER,
+                            &info->sub_ver);
       }
     } break;
 
@@ -355,8 +407,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       int val;
 
       if (prop->len >= (int)sizeof(uint16_t)) {
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_REMOTE_APPEARANCE,
-                                  &val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_REMOTE_APPEARANCE,
+                          &val);
         *(uint16_t*)prop->val = (uint16_t)val;
       }
     } break;
@@ -366,20 +418,20 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       int val;
 
       if (prop->len >= (int)sizeof(bt_vendor_product_info_t)) {
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_VENDOR_ID_SOURCE,
-                                  &val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_VENDOR_ID_SOURCE,
+                          &val);
         info->vendor_id_src = (uint8_t)val;
 
         if (ret) {
-          ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_VENDOR_ID, &val);
+          ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_VENDOR_ID, &val);
           info->vendor_id = (uint16_t)val;
         }
         if (ret) {
-          ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_PRODUCT_ID, &val);
+          ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_PRODUCT_ID, &val);
           info->product_id = (uint16_t)val;
         }
         if (ret) {
-          ret = btif_config_get_int(bdstr, BTIF_STORAGE_PATH_VERSION, &val);
+          ret = cfg_get_int(bdstr, section, BTIF_STORAGE_PATH_VERSION, &val);
           info->version = (uint16_t)val;
         }
       }
@@ -387,8 +439,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
 
     case BT_PROPERTY_REMOTE_MODEL_NUM: {
       int len = prop->len;
-      ret = btif_config_get_str(bdstr, BT_CONFIG_KEY_DIS_MODEL_NUM,
-                                (char*)prop->val, &len);
+      ret = cfg_get_str(bdstr, section, BT_CONFIG_KEY_DIS_MODEL_NUM,
+                        (char*)prop->val, &len);
       if (ret && len && len <= prop->len)
         prop->len = len - 1;
       else {
@@ -400,8 +452,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       int val;
 
       if (prop->len >= (int)sizeof(uint8_t)) {
-        ret = btif_config_get_int(
-            bdstr, BTIF_STORAGE_KEY_SECURE_CONNECTIONS_SUPPORTED, &val);
+        ret = cfg_get_int(bdstr, section,
+                          BTIF_STORAGE_KEY_SECURE_CONNECTIONS_SUPPORTED, &val);
         *(uint8_t*)prop->val = (uint8_t)val;
       }
     } break;
@@ -410,8 +462,8 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       int val;
 
       if (prop->len >= (int)sizeof(uint8_t)) {
-        ret = btif_config_get_int(bdstr, BTIF_STORAGE_KEY_MAX_SESSION_KEY_SIZE,
-                                  &val);
+        ret = cfg_get_int(bdstr, section, BTIF_STORAGE_KEY_MAX_SESSION_KEY_SIZE,
+                          &val);
         *(uint8_t*)prop->val = (uint8_t)val;
       }
     } break;
@@ -434,6 +486,13 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
  *
  ******************************************************************************/
 bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
+  {
+    std::lock_guard<std::mutex> lock(bonded_device_cache_mutex);
+    auto it = bonded_device_cache.find(bdstr);
+    if (it != bonded_device_cache.end())
+      return it->second ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
+  }
+
   bool bt_linkkey_file_found = false;
 
   LinkKey link_key;
@@ -449,8 +508,10 @@ bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
   if ((btif_in_fetch_bonded_ble_device(bdstr, false, NULL) !=
        BT_STATUS_SUCCESS) &&
       (!bt_linkkey_file_found)) {
+    btif_bonded_device_cache_set(bdstr, false);
     return BT_STATUS_FAIL;
   }
+  btif_bonded_device_cache_set(bdstr, true);
   return BT_STATUS_SUCCESS;
 }
 
@@ -468,11 +529,11 @@ static bt_status_t btif_in_fetch_bonded_devices(
     btif_bonded_devices_t* p_bonded_devices, int add) {
   memset(p_bonded_devices, 0, sizeof(btif_bonded_devices_t));
 
-  bool bt_linkkey_file_found = false;
   int device_type;
 
   for (const auto& bd_addr : btif_config_get_paired_devices()) {
     auto name = bd_addr.ToString();
+    bool bt_linkkey_file_found = false;
 
     BTIF_TRACE_DEBUG("Remote device:%s", ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
     LinkKey link_key;
@@ -506,10 +567,12 @@ static bt_status_t btif_in_fetch_bonded_devices(
         bt_linkkey_file_found = false;
       }
     }
-    if (!btif_in_fetch_bonded_ble_device(name, add, p_bonded_devices) &&
-        !bt_linkkey_file_found) {
+    bool ble_key_found = btif_in_fetch_bonded_ble_device(
+                             name, add, p_bonded_devices) == BT_STATUS_SUCCESS;
+    if (!ble_key_found && !bt_linkkey_file_found) {
       LOG_VERBOSE("No link key or ble key found for device:%s", name.c_str());
     }
+    btif_bonded_device_cache_set(name, ble_key_found || bt_linkkey_file_found);
   }
   return BT_STATUS_SUCCESS;
 }
@@ -760,14 +823,16 @@ bt_status_t btif_storage_set_adapter_property(bt_property_t* property) {
   return prop2cfg(NULL, property) ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
 }
 
-/** Helper function for fetching a bt_property of a remote device. */
-bt_status_t btif_storage_get_remote_prop(RawAddress* remote_addr,
-                                         bt_property_type_t type, void* buf,
-                                         int size, bt_property_t* property) {
+/** Helper function for fetching a bt_property of a remote device from its
+ * config section. */
+static bt_status_t btif_storage_get_remote_prop(
+    RawAddress* remote_addr, const btif_config_section_t* section,
+    bt_property_type_t type, void* buf, int size, bt_property_t* property) {
   property->type = type;
   property->val = buf;
   property->len = size;
-  return btif_storage_get_remote_device_property(remote_addr, property);
+  return cfg2prop(remote_addr, property, section) ? BT_STATUS_SUCCESS
+                                                  : BT_STATUS_FAIL;
 }
 
 /*******************************************************************************
@@ -788,6 +853,38 @@ bt_status_t btif_storage_get_remote_device_property(
   return cfg2prop(remote_bd_addr, property) ? BT_STATUS_SUCCESS
                                             : BT_STATUS_FAIL;
 }
+
+/*******************************************************************************
+ *
+ * Function         btif_storage_get_remote_device_properties
+ *
+ * Description      BTIF storage API - Fetches several properties of a remote
+ *                  device with a single config lookup. Each of |properties|
+ *                  is filled as btif_storage_get_remote_device_property()
+ *                  would, and its result is stored in |statuses| if not NULL.
+ *
+ * Returns          BT_STATUS_SUCCESS if all properties were fetched,
+ *                  BT_STATUS_FAIL otherwise
+ *
+ ******************************************************************************/
+bt_status_t btif_storage_get_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_props,
+    bt_property_t* properties, bt_status_t* statuses) {
+  auto sections = btif_config_get_sections({remote_bd_addr->ToString()});
+  const btif_config_section_t empty_section;
+  const btif_config_section_t* section =
+      sections[0] ? &*sections[0] : &empty_section;
+
+  bt_status_t status = BT_STATUS_SUCCESS;
+  for (uint32_t i = 0; i < num_props; i++) {
+    bt_status_t prop_status = cfg2prop(remote_bd_addr, &properties[i], section)
+                                  ? BT_STATUS_SUCCESS
+                                  : BT_STATUS_FAIL;
+    if (statuses != NULL) statuses[i] = prop_status;
+    if (prop_status != BT_STATUS_SUCCESS) status = BT_STATUS_FAIL;
+  }
+  return status;
+}
 /*******************************************************************************
  *
  * Function         btif_storage_set_remote_device_property
@@ -862,6 +959,7 @@ bt_status_t btif_storage_add_bonded_device(RawAddress* remote_bd_addr,
                                            LinkKey link_key, uint8_t key_type,
                                            uint8_t pin_length) {
   std::string bdstr = remote_bd_addr->ToString();
+  btif_bonded_device_cache_invalidate(bdstr);
   int ret = btif_config_set_int(bdstr, "LinkKeyType", (int)key_type);
   ret &= btif_config_set_int(bdstr, "PinLength", (int)pin_length);
   ret &=
@@ -891,6 +989,7 @@ bt_status_t btif_storage_remove_bonded_device(
   std::string bdstr = remote_bd_addr->ToString();
   LOG_INFO("Removing bonded device addr:%s",
            ADDRESS_TO_LOGGABLE_CSTR(*remote_bd_addr));
+  btif_bonded_device_cache_invalidate(bdstr);
 
   btif_storage_remove_ble_bonding_keys(remote_bd_addr);
 
@@ -970,7 +1069,9 @@ static void remove_devices_with_sample_ltk() {
  ******************************************************************************/
 void btif_storage_load_le_devices(void) {
   btif_bonded_devices_t bonded_devices;
+  remove_devices_with_sample_ltk();
   btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  loaded_bonded_devices = bonded_devices;
   std::unordered_set<RawAddress> bonded_addresses;
   for (uint16_t i = 0; i < bonded_devices.num_devices; i++) {
     bonded_addresses.insert(bonded_devices.devices[i]);
@@ -1055,9 +1156,14 @@ bt_status_t btif_storage_load_bonded_devices(void) {
   Uuid remote_uuids[BT_MAX_NUM_UUIDS];
   bt_status_t status;
 
-  remove_devices_with_sample_ltk();
-
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  /* The devices were already added to BTA when loading the LE devices */
+  if (loaded_bonded_devices) {
+    bonded_devices = *loaded_bonded_devices;
+    loaded_bonded_devices.reset();
+  } else {
+    remove_devices_with_sample_ltk();
+    btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  }
 
   /* Now send the adapter_properties_cb with all adapter_properties */
   {
@@ -1121,8 +1227,19 @@ bt_status_t btif_storage_load_bonded_devices(void) {
                    bonded_devices.num_devices);
 
   {
+    /* Fetch the config sections of all bonded devices at once */
+    std::vector<std::string> sections;
+    sections.reserve(bonded_devices.num_devices);
+    for (i = 0; i < bonded_devices.num_devices; i++) {
+      sections.push_back(bonded_devices.devices[i].ToString());
+    }
+    auto device_sections = btif_config_get_sections(sections);
+    const btif_config_section_t empty_section;
+
     for (i = 0; i < bonded_devices.num_devices; i++) {
       RawAddress* p_remote_addr;
+      const btif_config_section_t* section =
+          device_sections[i] ? &*device_sections[i] : &empty_section;
 
       /*
        * TODO: improve handling of missing fields in NVRAM.
@@ -1133,36 +1250,37 @@ bt_status_t btif_storage_load_bonded_devices(void) {
       num_props = 0;
       p_remote_addr = &bonded_devices.devices[i];
       memset(remote_properties, 0, sizeof(remote_properties));
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_BDNAME, &name,
-                                   sizeof(name), &remote_properties[num_props]);
+      btif_storage_get_remote_prop(p_remote_addr, section, BT_PROPERTY_BDNAME,
+                                   &name, sizeof(name),
+                                   &remote_properties[num_props]);
       num_props++;
 
       btif_storage_get_remote_prop(
-          p_remote_addr, BT_PROPERTY_REMOTE_FRIENDLY_NAME, &alias,
+          p_remote_addr, section, BT_PROPERTY_REMOTE_FRIENDLY_NAME, &alias,
           sizeof(alias), &remote_properties[num_props]);
       num_props++;
 
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_CLASS_OF_DEVICE,
-                                   &cod, sizeof(cod),
-                                   &remote_properties[num_props]);
+      btif_storage_get_remote_prop(
+          p_remote_addr, section, BT_PROPERTY_CLASS_OF_DEVICE, &cod,
+          sizeof(cod), &remote_properties[num_props]);
       num_props++;
 
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_TYPE_OF_DEVICE,
-                                   &devtype, sizeof(devtype),
-                                   &remote_properties[num_props]);
+      btif_storage_get_remote_prop(
+          p_remote_addr, section, BT_PROPERTY_TYPE_OF_DEVICE, &devtype,
+          sizeof(devtype), &remote_properties[num_props]);
       num_props++;
 
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_UUIDS,
+      btif_storage_get_remote_prop(p_remote_addr, section, BT_PROPERTY_UUIDS,
                                    remote_uuids, sizeof(remote_uuids),
                                    &remote_properties[num_props]);
       num_props++;
 
       // Floss needs appearance for metrics purposes
       uint16_t appearance = 0;
-      if (btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_APPEARANCE,
-                                       &appearance, sizeof(appearance),
-                                       &remote_properties[num_props]) ==
-          BT_STATUS_SUCCESS) {
+      if (btif_storage_get_remote_prop(
+              p_remote_addr, section, BT_PROPERTY_APPEARANCE, &appearance,
+              sizeof(appearance),
+              &remote_properties[num_props]) == BT_STATUS_SUCCESS) {
         num_props++;
       }
 
@@ -1170,16 +1288,16 @@ bt_status_t btif_storage_load_bonded_devices(void) {
       // Floss needs VID:PID for metrics purposes
       bt_vendor_product_info_t vp_info;
       if (btif_storage_get_remote_prop(
-              p_remote_addr, BT_PROPERTY_VENDOR_PRODUCT_INFO, &vp_info,
+              p_remote_addr, section, BT_PROPERTY_VENDOR_PRODUCT_INFO, &vp_info,
               sizeof(vp_info),
               &remote_properties[num_props]) == BT_STATUS_SUCCESS) {
         num_props++;
       }
 #endif
 
-      btif_storage_get_remote_prop(p_remote_addr, BT_PROPERTY_REMOTE_MODEL_NUM,
-                                   &model_name, sizeof(model_name),
-                                   &remote_properties[num_props]);
+      btif_storage_get_remote_prop(
+          p_remote_addr, section, BT_PROPERTY_REMOTE_MODEL_NUM, &model_name,
+          sizeof(model_name), &remote_properties[num_props]);
       num_props++;
 
       btif_remote_properties_evt(BT_STATUS_SUCCESS, p_remote_addr, num_props,
@@ -1228,6 +1346,7 @@ bt_status_t btif_storage_add_ble_bonding_key(RawAddress* remote_bd_addr,
     default:
       return BT_STATUS_FAIL;
   }
+  btif_bonded_device_cache_invalidate(remote_bd_addr->ToString());
   int ret =
       btif_config_set_bin(remote_bd_addr->ToString(), name, key, key_length);
   return ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
@@ -1291,6 +1410,7 @@ bt_status_t btif_storage_remove_ble_bonding_keys(
   std::string bdstr = remote_bd_addr->ToString();
   LOG_INFO("Removing bonding keys for bd addr:%s",
            ADDRESS_TO_LOGGABLE_CSTR(*remote_bd_addr));
+  btif_bonded_device_cache_invalidate(bdstr);
   int ret = 1;
   if (btif_config_exist(bdstr, "LE_KEY_PENC"))
     ret &= btif_config_remove(bdstr, "LE_KEY_PENC");
@@ -1464,6 +1584,7 @@ void btif_storage_set_remote_addr_type(const RawAddress& remote_bd_addr,
 
 void btif_storage_set_remote_device_type(const RawAddress& remote_bd_addr,
                                          const tBT_DEVICE_TYPE& device_type) {
+  btif_bonded_device_cache_invalidate(remote_bd_addr.ToString());
   if (!btif_config_set_int(remote_bd_addr.ToString(), "DevType",
                            static_cast<int>(device_type)))
     LOG_ERROR("Unable to set storage property");
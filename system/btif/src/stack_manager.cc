@@ -22,8 +22,11 @@
 
 #include <hardware/bluetooth.h>
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "btcore/include/osi_module.h"
@@ -69,6 +72,7 @@
 #include "device/include/interop.h"
 #include "internal_include/stack_config.h"
 #include "main/shim/controller.h"
+#include "main/shim/dumpsys.h"
 #include "rust/src/core/ffi/module.h"
 #include "stack/include/smp_api.h"
 
@@ -135,6 +139,15 @@ static bool stack_is_initialized;
 // If running, the stack is fully up and able to bluetooth.
 static bool stack_is_running;
 
+struct StartUpStep {
+  const char* name;
+  std::chrono::microseconds duration;
+};
+
+// Steps of the last stack start up, to find the modules slowing it down
+static std::mutex start_up_steps_mutex;
+static std::vector<StartUpStep> start_up_steps;
+
 static void event_init_stack(std::promise<void> promise,
                              bluetooth::core::CoreInterface* interface);
 static void event_start_up_stack(bluetooth::core::CoreInterface* interface,
@@ -310,23 +323,32 @@ static void event_start_up_stack(bluetooth::core::CoreInterface* interface,
   LOG_INFO("%s is bringing up the stack", __func__);
   future_t* local_hack_future = future_new();
   hack_future = local_hack_future;
+  auto start_up_begin = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(start_up_steps_mutex);
+    start_up_steps.clear();
+  }
 
   LOG_INFO("%s Gd shim module enabled", __func__);
-  get_btm_client_interface().lifecycle.btm_init();
-  module_start_up(get_local_module(BTIF_CONFIG_MODULE));
-
-  l2c_init();
-  sdp_init();
-  gatt_init();
-  SMP_Init();
-  get_btm_client_interface().lifecycle.btm_ble_init();
-
-  RFCOMM_Init();
-  GAP_Init();
+  stack_manager_run_start_up_step(
+      "btm", get_btm_client_interface().lifecycle.btm_init);
+  stack_manager_run_start_up_step("btif_config", [] {
+    module_start_up(get_local_module(BTIF_CONFIG_MODULE));
+  });
+
+  stack_manager_run_start_up_step("l2cap", l2c_init);
+  stack_manager_run_start_up_step("sdp", sdp_init);
+  stack_manager_run_start_up_step("gatt", gatt_init);
+  stack_manager_run_start_up_step("smp", SMP_Init);
+  stack_manager_run_start_up_step(
+      "btm_ble", get_btm_client_interface().lifecycle.btm_ble_init);
+
+  stack_manager_run_start_up_step("rfcomm", RFCOMM_Init);
+  stack_manager_run_start_up_step("gap", GAP_Init);
 
   startProfiles();
 
-  bta_sys_init();
+  stack_manager_run_start_up_step("bta_sys", bta_sys_init);
 
   module_init(get_local_module(BTE_LOGMSG_MODULE));
 
@@ -336,7 +358,9 @@ static void event_start_up_stack(bluetooth::core::CoreInterface* interface,
 
   bta_set_forward_hw_failures(true);
   btm_acl_device_down();
-  CHECK(module_start_up(get_local_module(GD_CONTROLLER_MODULE)));
+  stack_manager_run_start_up_step("controller", [] {
+    CHECK(module_start_up(get_local_module(GD_CONTROLLER_MODULE)));
+  });
   BTM_reset_complete();
 
   BTA_dm_on_hw_on();
@@ -348,10 +372,16 @@ static void event_start_up_stack(bluetooth::core::CoreInterface* interface,
     return;
   }
 
-  module_start_up(get_local_module(RUST_MODULE));
+  stack_manager_run_start_up_step("rust", [] {
+    module_start_up(get_local_module(RUST_MODULE));
+  });
 
   stack_is_running = true;
-  LOG_INFO("%s finished", __func__);
+  LOG_INFO("%s finished in %lld ms", __func__,
+           static_cast<long long>(
+               std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - start_up_begin)
+                   .count()));
   do_in_jni_thread(FROM_HERE, base::Bind(event_signal_stack_up, nullptr));
 }
 
@@ -440,6 +470,7 @@ static void event_clean_up_stack(std::promise<void> promise,
   module_shut_down(get_local_module(GD_SHIM_MODULE));
 
   main_thread_shut_down();
+  bta_sys_discard_pending_msgs();
 
   module_management_stop();
   LOG_INFO("%s finished", __func__);
@@ -482,3 +513,26 @@ const stack_manager_t* stack_manager_get_interface() {
 }
 
 future_t* stack_manager_get_hack_future() { return hack_future; }
+
+void stack_manager_run_start_up_step(const char* name, void (*step)(void)) {
+  auto begin = std::chrono::steady_clock::now();
+  step();
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+
+  std::lock_guard<std::mutex> lock(start_up_steps_mutex);
+  start_up_steps.push_back({name, duration});
+}
+
+#define DUMPSYS_TAG "shim::legacy::stack_manager"
+void stack_manager_debug_dump(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  std::lock_guard<std::mutex> lock(start_up_steps_mutex);
+  LOG_DUMPSYS(fd, "Last start up steps:%zu", start_up_steps.size());
+  for (const auto& step : start_up_steps) {
+    LOG_DUMPSYS(fd, "  %-20s %8lld us", step.name,
+                static_cast<long long>(step.duration.count()));
+  }
+}
+#undef DUMPSYS_TAG
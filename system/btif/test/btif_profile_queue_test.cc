@@ -23,6 +23,8 @@
 #include <gtest/gtest.h>
 
 #include "btif/include/stack_manager.h"
+#include "device/include/device_iot_config.h"
+#include "stack/include/acl_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
@@ -42,6 +44,16 @@ bt_status_t do_in_jni_thread(const base::Location& from_here,
 }
 bool is_on_jni_thread() { return true; }
 
+static RawAddress sAclUpAddress = RawAddress::kEmpty;
+bool BTM_IsAclConnectionUp(const RawAddress& remote_bda,
+                           tBT_TRANSPORT transport) {
+  return remote_bda == sAclUpAddress;
+}
+bool device_iot_config_get_int(const std::string& section,
+                               const std::string& key, int& value) {
+  return false;
+}
+
 enum ResultType {
   NOT_SET = 0,
   UNKNOWN,
@@ -64,6 +76,7 @@ class BtifProfileQueueTest : public ::testing::Test {
   void SetUp() override {
     sStackRunning = true;
     sResult = NOT_SET;
+    sAclUpAddress = RawAddress::kEmpty;
   };
   void TearDown() override { btif_queue_release(); };
 };
@@ -263,3 +276,21 @@ TEST_F(BtifProfileQueueTest, test_cleanup_both_reverse_order) {
   btif_queue_connect_next();
   EXPECT_EQ(sResult, NOT_SET);
 }
+
+TEST_F(BtifProfileQueueTest, test_connected_device_goes_first) {
+  // First item is executed
+  sResult = NOT_SET;
+  btif_queue_connect(kTestUuid1, &kTestAddr1, test_connect_cb);
+  EXPECT_EQ(sResult, UUID1_ADDR1);
+  btif_queue_connect(kTestUuid2, &kTestAddr1, test_connect_cb);
+  btif_queue_connect(kTestUuid1, &kTestAddr2, test_connect_cb);
+  // ADDR2 gets connected while waiting, its request needs no paging
+  sAclUpAddress = kTestAddr2;
+  sResult = NOT_SET;
+  btif_queue_advance();
+  EXPECT_EQ(sResult, UUID1_ADDR2);
+  // Then the queue order is resumed
+  sResult = NOT_SET;
+  btif_queue_advance();
+  EXPECT_EQ(sResult, UUID2_ADDR1);
+}
@@ -22,6 +22,7 @@
 #include <mutex>
 #include <string>
 
+#include "lru.h"
 #include "raw_address.h"
 
 namespace bluetooth {
@@ -47,7 +48,8 @@ class AddressObfuscator {
   static bool IsSaltValid(const Octet32& salt_256bit);
 
   /**
-   * Initialize this obfuscator with necessary parameters
+   * Initialize this obfuscator with necessary parameters. Tokens obfuscated
+   * with a previous salt are forgotten.
    *
    * @param salt_256bit a 256 bit salt used to hash the fixed length address
    */
@@ -59,7 +61,9 @@ class AddressObfuscator {
   bool IsInitialized();
 
   /**
-   * Obfuscate Bluetooth MAC address into an anonymous ID string
+   * Obfuscate Bluetooth MAC address into an anonymous ID string. The tokens
+   * of the most recently obfuscated addresses are cached, so that the many
+   * metrics logged for a device don't hash its address each time.
    *
    * @param address Bluetooth MAC address to be obfuscated
    * @return the obfuscated MAC address in 256 bit
@@ -67,8 +71,13 @@ class AddressObfuscator {
   std::string Obfuscate(const RawAddress& address);
 
  private:
-  AddressObfuscator() : salt_256bit_({0}) {}
+  static constexpr size_t kTokenCacheSize = 64;
+
+  AddressObfuscator()
+      : salt_256bit_({0}),
+        token_cache_(kTokenCacheSize, "bt_address_obfuscator") {}
   Octet32 salt_256bit_;
+  LegacyLruCache<RawAddress, std::string> token_cache_;
   std::recursive_mutex instance_mutex_;
 };
 
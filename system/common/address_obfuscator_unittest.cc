@@ -120,3 +120,22 @@ TEST(AddressObfuscatorTest, test_obfuscate_address_key2_max_address) {
   EXPECT_EQ(result.size(), AddressObfuscator::kOctet32Length);
   EXPECT_EQ(result, kTestResult2_3);
 }
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_repeated) {
+  AddressObfuscator::GetInstance()->Initialize(kTestKey2);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1),
+              kTestResult2_1);
+    EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_3),
+              kTestResult2_3);
+  }
+}
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_salt_changed) {
+  AddressObfuscator::GetInstance()->Initialize(kTestKey2);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            AddressObfuscator::GetInstance()->Obfuscate(kTestData1));
+  AddressObfuscator::GetInstance()->Initialize(kTestKey1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+}
@@ -19,16 +19,24 @@
 #include <base/run_loop.h>
 #include <base/threading/thread.h>
 #include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <thread>
 
 #include "abstract_message_loop.h"
 #include "common/message_loop_thread.h"
+#include "gd/common/inline_closure.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/thread.h"
 
 using ::benchmark::State;
+using bluetooth::common::InlineClosure;
 using bluetooth::common::MessageLoopThread;
 
 #define NUM_MESSAGES_TO_SEND 100000
@@ -36,6 +44,28 @@ using bluetooth::common::MessageLoopThread;
 volatile static int g_counter = 0;
 static std::unique_ptr<std::promise<void>> g_counter_promise = nullptr;
 
+// Heap allocations made by any thread, to report allocations per post
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+
+void operator delete(void* ptr, size_t size) noexcept { free(ptr); }
+
+static void ReportAllocationsPerPost(State& state, uint64_t allocations,
+                                     uint64_t posts) {
+  state.counters["allocations_per_post"] =
+      benchmark::Counter(posts == 0 ? 0 : (double)allocations / posts);
+}
+
 void pthread_callback_batch(void* context) {
   auto queue = static_cast<fixed_queue_t*>(context);
   CHECK_NE(queue, nullptr);
@@ -371,6 +401,99 @@ BENCHMARK_F(BM_MessageLooopThread, sequential_execution)(State& state) {
   }
 };
 
+// Packet sized payload captured by the posted tasks
+struct Payload {
+  uint8_t bytes[32];
+};
+
+void callback_payload(const Payload& payload) { g_counter += payload.bytes[0]; }
+
+BENCHMARK_F(BM_MessageLooopThread, allocations_per_post)(State& state) {
+  uint64_t allocations = 0;
+  uint64_t posts = 0;
+  for (auto _ : state) {
+    g_counter_promise = std::make_unique<std::promise<void>>();
+    std::future<void> counter_future = g_counter_promise->get_future();
+    uint64_t before = g_allocations.load();
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      message_loop_thread_->DoInThread(
+          FROM_HERE, base::BindOnce(&callback_payload, Payload{}));
+    }
+    message_loop_thread_->DoInThread(
+        FROM_HERE, base::BindOnce(&callback_sequential, nullptr));
+    counter_future.wait();
+    allocations += g_allocations.load() - before;
+    posts += NUM_MESSAGES_TO_SEND;
+  }
+  ReportAllocationsPerPost(state, allocations, posts);
+};
+
+// Mirrors how HCI messages reach the main thread: items are queued and a drain
+// task is only posted when the queue was empty
+static std::mutex g_pending_mutex;
+static std::deque<Payload> g_pending;
+
+void drain_pending() {
+  std::deque<Payload> pending;
+  {
+    std::lock_guard<std::mutex> lock(g_pending_mutex);
+    pending.swap(g_pending);
+  }
+  for (const auto& payload : pending) {
+    callback_payload(payload);
+  }
+}
+
+BENCHMARK_F(BM_MessageLooopThread, allocations_per_batched_post)
+(State& state) {
+  uint64_t allocations = 0;
+  uint64_t posts = 0;
+  for (auto _ : state) {
+    g_counter_promise = std::make_unique<std::promise<void>>();
+    std::future<void> counter_future = g_counter_promise->get_future();
+    uint64_t before = g_allocations.load();
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      {
+        std::lock_guard<std::mutex> lock(g_pending_mutex);
+        g_pending.push_back(Payload{});
+        if (g_pending.size() > 1) continue;
+      }
+      message_loop_thread_->DoInThread(FROM_HERE,
+                                       base::BindOnce(&drain_pending));
+    }
+    message_loop_thread_->DoInThread(
+        FROM_HERE, base::BindOnce(&callback_sequential, nullptr));
+    counter_future.wait();
+    allocations += g_allocations.load() - before;
+    posts += NUM_MESSAGES_TO_SEND;
+  }
+  ReportAllocationsPerPost(state, allocations, posts);
+};
+
+// Cost of the task object alone, without any thread hop
+static void BM_OnceClosureTask(State& state) {
+  uint64_t before = g_allocations.load();
+  for (auto _ : state) {
+    base::OnceClosure closure = base::BindOnce(&callback_payload, Payload{});
+    std::move(closure).Run();
+  }
+  ReportAllocationsPerPost(state, g_allocations.load() - before,
+                           state.iterations());
+}
+BENCHMARK(BM_OnceClosureTask);
+
+static void BM_InlineClosureTask(State& state) {
+  uint64_t before = g_allocations.load();
+  for (auto _ : state) {
+    InlineClosure closure(
+        [payload = Payload{}]() { callback_payload(payload); });
+    std::move(closure).Run();
+  }
+  ReportAllocationsPerPost(state, g_allocations.load() - before,
+                           state.iterations());
+}
+BENCHMARK(BM_InlineClosureTask);
+
 class BM_LibChromeThread : public BM_ThreadPerformance {
  protected:
   void SetUp(State& st) override {
@@ -45,7 +45,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name,
       linux_tid_(-1),
       weak_ptr_factory_(this),
       shutting_down_(false),
-      is_main_(is_main) {}
+      is_main_(is_main),
+      task_stats_(thread_name) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -80,11 +81,21 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                << ", from " << from_here.ToString();
     return false;
   }
+  bool instrumented = IsTaskStatsEnabled();
+  if (instrumented) {
+    task_stats_.OnPosted();
+    // Unretained is safe as the message loop and its tasks are deleted before
+    // this thread is
+    task = base::BindOnce(&MessageLoopThread::RunInstrumentedTask,
+                          base::Unretained(this), from_here,
+                          base::TimeTicks::Now() + delay, std::move(task));
+  }
   if (!message_loop_->task_runner()->PostDelayedTask(from_here, std::move(task),
                                                      delay)) {
     LOG(ERROR) << __func__
                << ": failed to post task to message loop for thread " << *this
                << ", from " << from_here.ToString();
+    if (instrumented) task_stats_.OnDropped(1);
     return false;
   }
   return true;
@@ -127,6 +138,10 @@ base::PlatformThreadId MessageLoopThread::GetThreadId() const {
 
 std::string MessageLoopThread::GetName() const { return thread_name_; }
 
+const TaskStats& MessageLoopThread::GetTaskStats() const {
+  return task_stats_;
+}
+
 std::string MessageLoopThread::ToString() const {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return base::StringPrintf("%s(%d)", thread_name_.c_str(), thread_id_);
@@ -202,11 +217,33 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
     message_loop_ = nullptr;
     delete run_loop_;
     run_loop_ = nullptr;
+    // Tasks still queued were deleted with the message loop
+    task_stats_.OnDropped(task_stats_.GetQueueDepth());
     LOG(INFO) << __func__ << ": message loop finished for thread "
               << thread_name_;
   }
 }
 
+void MessageLoopThread::RunInstrumentedTask(const base::Location& from_here,
+                                            base::TimeTicks ready_time,
+                                            base::OnceClosure task) {
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  std::move(task).Run();
+  base::TimeTicks end_time = base::TimeTicks::Now();
+
+  std::chrono::microseconds run_time(
+      (end_time - start_time).InMicroseconds());
+  if (task_stats_.OnRun(
+          from_here.file_name(), from_here.line_number(),
+          from_here.function_name(),
+          std::chrono::microseconds((start_time - ready_time).InMicroseconds()),
+          run_time)) {
+    LOG(WARNING) << __func__ << ": task from " << from_here.ToString()
+                 << " ran for " << run_time.count() << "us on thread "
+                 << thread_name_;
+  }
+}
+
 }  // namespace common
 
 }  // namespace bluetooth
@@ -20,6 +20,7 @@
 #include <base/location.h>
 #include <base/run_loop.h>
 #include <base/threading/platform_thread.h>
+#include <base/time/time.h>
 #include <unistd.h>
 
 #include <future>
@@ -28,6 +29,7 @@
 #include <thread>
 
 #include "abstract_message_loop.h"
+#include "gd/common/task_stats.h"
 
 namespace bluetooth {
 
@@ -104,6 +106,14 @@ class MessageLoopThread final {
    */
   std::string GetName() const;
 
+  /**
+   * Get the queue depth, wait and run time statistics of the tasks posted to
+   * this thread while task statistics are enabled
+   *
+   * @return this thread's task statistics
+   */
+  const TaskStats& GetTaskStats() const;
+
   /**
    * Get a string representation of this thread
    *
@@ -189,6 +199,15 @@ class MessageLoopThread final {
    */
   void Run(std::promise<void> start_up_promise);
 
+  /**
+   * Run a task posted while task statistics are enabled, and record its wait
+   * and run time
+   *
+   * @param ready_time when the task was due to run
+   */
+  void RunInstrumentedTask(const base::Location& from_here,
+                           base::TimeTicks ready_time, base::OnceClosure task);
+
   mutable std::recursive_mutex api_mutex_;
   const std::string thread_name_;
   btbase::AbstractMessageLoop* message_loop_;
@@ -200,6 +219,7 @@ class MessageLoopThread final {
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
   bool is_main_;
+  TaskStats task_stats_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -328,3 +328,23 @@ TEST_F(MessageLoopThreadTest, shut_down_start_up_multi_thread) {
   auto thread = std::thread(&MessageLoopThread::StartUp, &message_loop_thread);
   thread.join();
 }
+
+// Verify tasks posted while task statistics are enabled are recorded
+TEST_F(MessageLoopThreadTest, test_task_stats) {
+  bluetooth::common::EnableTaskStats(true, std::chrono::milliseconds(100));
+  MessageLoopThread message_loop_thread("test_thread");
+  message_loop_thread.StartUp();
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce([]() {}));
+  // Tasks run in order, so the first one is recorded by the time the second
+  // one runs
+  std::promise<void> second_ran;
+  std::future<void> second_ran_future = second_ran.get_future();
+  message_loop_thread.DoInThread(
+      FROM_HERE, base::BindOnce(&std::promise<void>::set_value,
+                                base::Unretained(&second_ran)));
+  second_ran_future.wait();
+  message_loop_thread.ShutDown();
+  EXPECT_EQ(message_loop_thread.GetTaskStats().GetTaskCount(), 2u);
+  EXPECT_EQ(message_loop_thread.GetTaskStats().GetQueueDepth(), 0);
+  bluetooth::common::EnableTaskStats(false, std::chrono::milliseconds(100));
+}
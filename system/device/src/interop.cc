@@ -32,10 +32,16 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "bt_types.h"
 #include "btcore/include/module.h"
@@ -84,6 +90,27 @@ bool interop_is_initialized = false;
 // protects operations on |interop_list|
 pthread_mutex_t interop_list_lock;
 
+// Lookup tables compiled from |interop_list| for the interop_match_* checks,
+// see interop_index_get_()
+namespace {
+struct InteropFeatureIndex {
+  // Address prefixes, by prefix length in bytes
+  std::array<std::unordered_set<uint64_t>, sizeof(RawAddress) + 1> addrs;
+  std::vector<std::pair<RawAddress, RawAddress>> addr_ranges;
+  // Lower case names, matched as a prefix of the remote name
+  std::unordered_set<std::string> names;
+  size_t max_name_length = 0;
+  std::unordered_set<uint16_t> manufacturers;
+  // (vendor_id << 16) | product_id
+  std::unordered_set<uint32_t> vndr_prdts;
+};
+using InteropIndex = std::unordered_map<int, InteropFeatureIndex>;
+}  // namespace
+
+// Rebuilt on the first lookup after |interop_list| changed. Readers keep the
+// snapshot they got alive, so a rebuild never blocks or invalidates them.
+static std::shared_ptr<const InteropIndex> interop_index;
+
 // protects operations on |config|
 static pthread_mutex_t file_lock;
 static std::unique_ptr<const config_t> config_static;
@@ -296,6 +323,7 @@ static future_t* interop_clean_up(void) {
   pthread_mutex_lock(&interop_list_lock);
   list_free(interop_list);
   interop_list = NULL;
+  interop_index_invalidate_();
   list_free(media_player_list);
   media_player_list = NULL;
   interop_is_initialized = false;
@@ -618,6 +646,7 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
 
   if (interop_list) {
     list_append(interop_list, db_entry);
+    interop_index_invalidate_();
   }
 
   pthread_mutex_unlock(&interop_list_lock);
@@ -763,6 +792,96 @@ static bool interop_database_match(interop_db_entry_t* entry,
   return found;
 }
 
+static uint64_t interop_addr_prefix_(const RawAddress& addr, size_t length) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < length; i++) prefix = (prefix << 8) | addr.address[i];
+  return prefix;
+}
+
+static std::string interop_lower_case_(const char* str) {
+  std::string lower(str);
+  for (char& c : lower) c = tolower((unsigned char)c);
+  return lower;
+}
+
+// Must be called with |interop_list_lock| held
+static std::shared_ptr<const InteropIndex> interop_index_build_() {
+  auto index = std::make_shared<InteropIndex>();
+  if (interop_list == NULL) return index;
+
+  for (const list_node_t* node = list_begin(interop_list);
+       node != list_end(interop_list); node = list_next(node)) {
+    const interop_db_entry_t* db_entry =
+        (const interop_db_entry_t*)list_node(node);
+    switch (db_entry->bl_type) {
+      case INTEROP_BL_TYPE_ADDR: {
+        const interop_addr_entry_t* e = &db_entry->entry_type.addr_entry;
+        size_t length = std::min(e->length, sizeof(RawAddress));
+        (*index)[e->feature].addrs[length].insert(
+            interop_addr_prefix_(e->addr, length));
+        break;
+      }
+      case INTEROP_BL_TYPE_ADDR_RANGE: {
+        // Ranges are only ever matched against static entries
+        if (db_entry->bl_entry_type != INTEROP_ENTRY_TYPE_STATIC) break;
+        const interop_addr_range_entry_t* e =
+            &db_entry->entry_type.addr_range_entry;
+        (*index)[e->feature].addr_ranges.emplace_back(e->addr_start,
+                                                      e->addr_end);
+        break;
+      }
+      case INTEROP_BL_TYPE_NAME: {
+        const interop_name_entry_t* e = &db_entry->entry_type.name_entry;
+        InteropFeatureIndex& feature_index = (*index)[e->feature];
+        std::string name = interop_lower_case_(e->name);
+        feature_index.max_name_length =
+            std::max(feature_index.max_name_length, name.size());
+        feature_index.names.insert(std::move(name));
+        break;
+      }
+      case INTEROP_BL_TYPE_MANUFACTURE: {
+        const interop_manufacturer_t* e = &db_entry->entry_type.mnfr_entry;
+        (*index)[e->feature].manufacturers.insert(e->manufacturer);
+        break;
+      }
+      case INTEROP_BL_TYPE_VNDR_PRDT: {
+        const interop_hid_multitouch_t* e = &db_entry->entry_type.vnr_pdt_entry;
+        (*index)[e->feature].vndr_prdts.insert((uint32_t)e->vendor_id << 16 |
+                                               e->product_id);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return index;
+}
+
+// Must be called with |interop_list_lock| held whenever |interop_list| changes
+static void interop_index_invalidate_() {
+  std::atomic_store(&interop_index, std::shared_ptr<const InteropIndex>());
+}
+
+static std::shared_ptr<const InteropIndex> interop_index_get_() {
+  std::shared_ptr<const InteropIndex> index = std::atomic_load(&interop_index);
+  if (index) return index;
+
+  pthread_mutex_lock(&interop_list_lock);
+  index = std::atomic_load(&interop_index);
+  if (!index) {
+    index = interop_index_build_();
+    std::atomic_store(&interop_index, index);
+  }
+  pthread_mutex_unlock(&interop_list_lock);
+  return index;
+}
+
+static const InteropFeatureIndex* interop_index_find_(
+    const InteropIndex& index, const interop_feature_t feature) {
+  auto it = index.find(feature);
+  return it == index.end() ? nullptr : &it->second;
+}
+
 static bool interop_database_remove_(interop_db_entry_t* entry) {
   interop_db_entry_t* ret_entry = NULL;
 
@@ -776,6 +895,7 @@ static bool interop_database_remove_(interop_db_entry_t* entry) {
   // first remove it from linked list
   pthread_mutex_lock(&interop_list_lock);
   list_remove(interop_list, (void*)ret_entry);
+  interop_index_invalidate_();
   pthread_mutex_unlock(&interop_list_lock);
 
   return interop_config_add_or_remove(entry, false);
@@ -1277,16 +1397,11 @@ void interop_database_add_addr_lmp_version(const interop_feature_t feature,
 
 bool interop_database_match_manufacturer(const interop_feature_t feature,
                                          uint16_t manufacturer) {
-  interop_db_entry_t entry;
-
-  entry.bl_type = INTEROP_BL_TYPE_MANUFACTURE;
-  entry.entry_type.mnfr_entry.feature = feature;
-  entry.entry_type.mnfr_entry.manufacturer = manufacturer;
-
-  if (interop_database_match(
-          &entry, NULL,
-          (interop_entry_type)(INTEROP_ENTRY_TYPE_STATIC |
-                               INTEROP_ENTRY_TYPE_DYNAMIC))) {
+  auto index = interop_index_get_();
+  const InteropFeatureIndex* feature_index =
+      interop_index_find_(*index, feature);
+  if (feature_index &&
+      feature_index->manufacturers.count(manufacturer) != 0) {
     LOG_WARN(
         "Device with manufacturer id: %d is a match for interop workaround %s",
         manufacturer, interop_feature_string_(feature));
@@ -1302,20 +1417,22 @@ bool interop_database_match_name(const interop_feature_t feature,
   CHECK(name);
 
   strlcpy(trim_name, name, KEY_MAX_LENGTH);
-  interop_db_entry_t entry;
-
-  entry.bl_type = INTEROP_BL_TYPE_NAME;
-  strlcpy(entry.entry_type.name_entry.name, trim(trim_name), KEY_MAX_LENGTH);
-  entry.entry_type.name_entry.feature = (interop_feature_t)feature;
-  entry.entry_type.name_entry.length = strlen(entry.entry_type.name_entry.name);
 
-  if (interop_database_match(
-          &entry, NULL,
-          (interop_entry_type)(INTEROP_ENTRY_TYPE_STATIC |
-                               INTEROP_ENTRY_TYPE_DYNAMIC))) {
-    LOG_WARN("Device with name: %s is a match for interop workaround %s", name,
-             interop_feature_string_(feature));
-    return true;
+  auto index = interop_index_get_();
+  const InteropFeatureIndex* feature_index =
+      interop_index_find_(*index, feature);
+  if (feature_index == nullptr || feature_index->names.empty()) return false;
+
+  // Entries match when they are a case insensitive prefix of |name|
+  std::string lower_name = interop_lower_case_(trim(trim_name));
+  size_t max_length =
+      std::min(lower_name.size(), feature_index->max_name_length);
+  for (size_t length = 0; length <= max_length; length++) {
+    if (feature_index->names.count(lower_name.substr(0, length)) != 0) {
+      LOG_WARN("Device with name: %s is a match for interop workaround %s",
+               name, interop_feature_string_(feature));
+      return true;
+    }
   }
 
   return false;
@@ -1325,32 +1442,29 @@ bool interop_database_match_addr(const interop_feature_t feature,
                                  const RawAddress* addr) {
   CHECK(addr);
 
-  interop_db_entry_t entry;
-
-  entry.bl_type = INTEROP_BL_TYPE_ADDR;
-  entry.entry_type.addr_entry.addr = *addr;
-  entry.entry_type.addr_entry.feature = (interop_feature_t)feature;
-  entry.entry_type.addr_entry.length = sizeof(RawAddress);
-
-  if (interop_database_match(
-          &entry, NULL,
-          (interop_entry_type)(INTEROP_ENTRY_TYPE_STATIC |
-                               INTEROP_ENTRY_TYPE_DYNAMIC))) {
-    LOG_WARN("Device %s is a match for interop workaround %s.",
-             ADDRESS_TO_LOGGABLE_CSTR(*addr), interop_feature_string_(feature));
-    return true;
+  auto index = interop_index_get_();
+  const InteropFeatureIndex* feature_index =
+      interop_index_find_(*index, feature);
+  if (feature_index == nullptr) return false;
+
+  for (size_t length = 0; length < feature_index->addrs.size(); length++) {
+    const auto& prefixes = feature_index->addrs[length];
+    if (!prefixes.empty() &&
+        prefixes.count(interop_addr_prefix_(*addr, length)) != 0) {
+      LOG_WARN("Device %s is a match for interop workaround %s.",
+               ADDRESS_TO_LOGGABLE_CSTR(*addr),
+               interop_feature_string_(feature));
+      return true;
+    }
   }
 
-  entry.bl_type = INTEROP_BL_TYPE_ADDR_RANGE;
-  entry.bl_entry_type = INTEROP_ENTRY_TYPE_STATIC;
-  entry.entry_type.addr_range_entry.addr_start = *addr;
-  entry.entry_type.addr_range_entry.feature = (interop_feature_t)feature;
-
-  if (interop_database_match(&entry, NULL,
-                             (interop_entry_type)(INTEROP_ENTRY_TYPE_STATIC))) {
-    LOG_WARN("Device %s is a match for interop workaround %s.",
-             ADDRESS_TO_LOGGABLE_CSTR(*addr), interop_feature_string_(feature));
-    return true;
+  for (const auto& [addr_start, addr_end] : feature_index->addr_ranges) {
+    if (*addr >= addr_start && *addr <= addr_end) {
+      LOG_WARN("Device %s is a match for interop workaround %s.",
+               ADDRESS_TO_LOGGABLE_CSTR(*addr),
+               interop_feature_string_(feature));
+      return true;
+    }
   }
 
   return false;
@@ -1358,17 +1472,12 @@ bool interop_database_match_addr(const interop_feature_t feature,
 
 bool interop_database_match_vndr_prdt(const interop_feature_t feature,
                                       uint16_t vendor_id, uint16_t product_id) {
-  interop_db_entry_t entry;
-
-  entry.bl_type = INTEROP_BL_TYPE_VNDR_PRDT;
-
-  entry.entry_type.vnr_pdt_entry.feature = (interop_feature_t)feature;
-  entry.entry_type.vnr_pdt_entry.vendor_id = vendor_id;
-  entry.entry_type.vnr_pdt_entry.product_id = product_id;
-  if (interop_database_match(
-          &entry, NULL,
-          (interop_entry_type)(INTEROP_ENTRY_TYPE_STATIC |
-                               INTEROP_ENTRY_TYPE_DYNAMIC))) {
+  auto index = interop_index_get_();
+  const InteropFeatureIndex* feature_index =
+      interop_index_find_(*index, feature);
+  if (feature_index &&
+      feature_index->vndr_prdts.count((uint32_t)vendor_id << 16 |
+                                      product_id) != 0) {
     LOG_WARN(
         "Device with vendor_id: %d product_id: %d is a match for interop "
         "workaround %s",
@@ -1564,6 +1673,7 @@ bool interop_database_remove_feature(const interop_feature_t feature) {
     if (entry_match) {
       pthread_mutex_lock(&interop_list_lock);
       list_remove(interop_list, (void*)entry);
+      interop_index_invalidate_();
       pthread_mutex_unlock(&interop_list_lock);
     }
   }
@@ -136,6 +136,12 @@ extern "C" {
 g722_encode_state_t *g722_encode_init(g722_encode_state_t *s, unsigned int rate, int options);
 int g722_encode_release(g722_encode_state_t *s);
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[], const int16_t amp[], int len);
+/*! Encode the interleaved left and right samples amp[2*i], amp[2*i + 1] of len samples by
+    channel, with the same results as g722_encode() on each channel. Both encoders are
+    expected to use the same rate and options. Returns the number of bytes by channel. */
+int g722_encode_stereo(g722_encode_state_t *s_left, g722_encode_state_t *s_right,
+                       uint8_t g722_data_left[], uint8_t g722_data_right[],
+                       const int16_t amp[], int len);
 
 g722_decode_state_t *g722_decode_init(g722_decode_state_t *s, unsigned int rate, int options);
 int g722_decode_release(g722_decode_state_t *s);
@@ -32,6 +32,12 @@
 #include "g722_typedefs.h"
 #include "g722_enc_dec.h"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -268,8 +274,98 @@ static int16_t ihp[3] = {0, 3, 2};
 static int16_t wh[3] = {0, -214, 798};
 static int16_t rh2[4] = {2, 1, 2, 1};
 
-int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
-                       const int16_t amp[], int len)
+/* Transmit QMF coefficients applied to the 24 samples of the signal history,
+   in the order of the history. The even samples are weighted by the odd QMF
+   taps, and the odd samples by the even QMF taps in reverse order. The sum
+   gives the low band, and the difference of the even and odd taps the high
+   band. */
+static const int16_t qmf_coeffs_low[24] =
+{
+       3,  -11,  -11,   53,   12, -156,   32,  362, -210, -805,  951, 3876,
+    3876,  951, -805, -210,  362,   32, -156,   12,   53,  -11,  -11,    3,
+};
+static const int16_t qmf_coeffs_high[24] =
+{
+      -3,  -11,   11,   53,  -12, -156,  -32,  362,  210, -805, -951, 3876,
+   -3876,  951,  805, -210, -362,   32,  156,   12,  -53,  -11,   11,    3,
+};
+
+/* Apply the transmit QMF to the signal history x[0..23], and discard every
+   other output. We shift by 12 to allow for the QMF filters (DC gain = 4096),
+   plus 1 to allow for us summing two filters, plus 1 to allow for the 15 bit
+   input to the G.722 algorithm. The products and their sums fit in 32 bits,
+   the result does not depend on the order of the accumulation. */
+#if defined(__ARM_NEON)
+static __inline void tx_qmf(const int16_t x[24], int *xlow, int *xhigh)
+{
+    int32x4_t low = vdupq_n_s32(0);
+    int32x4_t high = vdupq_n_s32(0);
+    int i;
+
+    for (i = 0;  i < 24;  i += 8)
+    {
+        int16x8_t xi = vld1q_s16(x + i);
+        int16x8_t cl = vld1q_s16(qmf_coeffs_low + i);
+        int16x8_t ch = vld1q_s16(qmf_coeffs_high + i);
+
+        low = vmlal_s16(low, vget_low_s16(xi), vget_low_s16(cl));
+        low = vmlal_s16(low, vget_high_s16(xi), vget_high_s16(cl));
+        high = vmlal_s16(high, vget_low_s16(xi), vget_low_s16(ch));
+        high = vmlal_s16(high, vget_high_s16(xi), vget_high_s16(ch));
+    }
+
+    int32x2_t sum = vpadd_s32(
+        vpadd_s32(vget_low_s32(low), vget_high_s32(low)),
+        vpadd_s32(vget_low_s32(high), vget_high_s32(high)));
+
+    *xlow = vget_lane_s32(sum, 0) >> 14;
+    *xhigh = vget_lane_s32(sum, 1) >> 14;
+}
+#elif defined(__SSE2__)
+static __inline void tx_qmf(const int16_t x[24], int *xlow, int *xhigh)
+{
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    int i;
+
+    for (i = 0;  i < 24;  i += 8)
+    {
+        __m128i xi = _mm_loadu_si128((const __m128i *) (x + i));
+
+        low = _mm_add_epi32(low, _mm_madd_epi16(xi,
+            _mm_loadu_si128((const __m128i *) (qmf_coeffs_low + i))));
+        high = _mm_add_epi32(high, _mm_madd_epi16(xi,
+            _mm_loadu_si128((const __m128i *) (qmf_coeffs_high + i))));
+    }
+
+    /* Horizontal sums, the low band in lane 0 and the high band in lane 1 */
+    __m128i sum = _mm_add_epi32(_mm_unpacklo_epi32(low, high),
+                                _mm_unpackhi_epi32(low, high));
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+
+    *xlow = _mm_cvtsi128_si32(sum) >> 14;
+    *xhigh = _mm_cvtsi128_si32(_mm_srli_si128(sum, 4)) >> 14;
+}
+#else
+static __inline void tx_qmf(const int16_t x[24], int *xlow, int *xhigh)
+{
+    int low = 0;
+    int high = 0;
+    int i;
+
+    for (i = 0;  i < 24;  i++)
+    {
+        low += x[i]*qmf_coeffs_low[i];
+        high += x[i]*qmf_coeffs_high[i];
+    }
+    *xlow = low >> 14;
+    *xhigh = high >> 14;
+}
+#endif
+/*- End of function --------------------------------------------------------*/
+
+/* Encode the low and high band samples from the QMF, return the code */
+static __inline int encode_bands(g722_encode_state_t *s, int xlow, int xhigh)
 {
     int dlow;
     int dhigh;
@@ -283,6 +379,117 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     int wd3;
     int eh;
     int mih;
+    int i;
+    int ihigh;
+    int ilow;
+    int code;
+
+    /* Block 1L, SUBTRA */
+    el = saturate(xlow - s->band[0].s);
+
+    /* Block 1L, QUANTL */
+    wd = (el >= 0)  ?  el  :  -(el + 1);
+
+    for (i = 1;  i < 30;  i++)
+    {
+        wd1 = (q6[i]*s->band[0].det) >> 12;
+        if (wd < wd1)
+            break;
+    }
+    ilow = (el < 0)  ?  iln[i]  :  ilp[i];
+
+    /* Block 2L, INVQAL */
+    ril = ilow >> 2;
+    wd2 = qm4[ril];
+    dlow = (s->band[0].det*wd2) >> 15;
+
+    /* Block 3L, LOGSCL */
+    il4 = rl42[ril];
+    wd = (s->band[0].nb*127) >> 7;
+    s->band[0].nb = wd + wl[il4];
+    if (s->band[0].nb < 0)
+        s->band[0].nb = 0;
+    else if (s->band[0].nb > 18432)
+        s->band[0].nb = 18432;
+
+    /* Block 3L, SCALEL */
+    wd1 = (s->band[0].nb >> 6) & 31;
+    wd2 = 8 - (s->band[0].nb >> 11);
+    wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+    s->band[0].det = wd3 << 2;
+
+    block4(&s->band[0], dlow);
+    {
+        int nb;
+
+        /* Block 1H, SUBTRA */
+        eh = saturate(xhigh - s->band[1].s);
+
+        /* Block 1H, QUANTH */
+        wd = (eh >= 0)  ?  eh  :  -(eh + 1);
+        wd1 = (564*s->band[1].det) >> 12;
+        mih = (wd >= wd1)  ?  2  :  1;
+        ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
+
+        /* Block 2H, INVQAH */
+        wd2 = qm2[ihigh];
+        dhigh = (s->band[1].det*wd2) >> 15;
+
+        /* Block 3H, LOGSCH */
+        ih2 = rh2[ihigh];
+        wd = (s->band[1].nb*127) >> 7;
+
+        nb = wd + wh[ih2];
+        if (nb < 0)
+            nb = 0;
+        else if (nb > 22528)
+            nb = 22528;
+        s->band[1].nb = nb;
+
+        /* Block 3H, SCALEH */
+        wd1 = (s->band[1].nb >> 6) & 31;
+        wd2 = 10 - (s->band[1].nb >> 11);
+        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+        s->band[1].det = wd3 << 2;
+
+        block4(&s->band[1], dhigh);
+#if   BITS_PER_SAMPLE == 8
+        code = ((ihigh << 6) | ilow);
+#elif BITS_PER_SAMPLE == 7
+        code = ((ihigh << 6) | ilow) >> 1;
+#elif BITS_PER_SAMPLE == 6
+        code = ((ihigh << 6) | ilow) >> 2;
+#endif
+    }
+    return code;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Output a code, return the updated count of bytes */
+static __inline int put_code(g722_encode_state_t *s, uint8_t g722_data[],
+                             int g722_bytes, int code)
+{
+#if PACKED_OUTPUT == 1
+    /* Pack the code bits */
+    s->out_buffer |= (code << s->out_bits);
+    s->out_bits += s->bits_per_sample;
+    if (s->out_bits >= 8)
+    {
+        g722_data[g722_bytes++] = (uint8_t) (s->out_buffer & 0xFF);
+        s->out_bits -= 8;
+        s->out_buffer >>= 8;
+    }
+#else
+    (void) s;
+    g722_data[g722_bytes++] = (uint8_t) code;
+#endif
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
+                       const int16_t amp[], int len)
+{
     int i;
     int j;
     /* Low and high band PCM from the QMF */
@@ -292,9 +499,6 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     /* Even and odd tap accumulators */
     int sumeven;
     int sumodd;
-    int ihigh;
-    int ilow;
-    int code;
 
     g722_bytes = 0;
     xhigh = 0;
@@ -340,99 +544,97 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
 #endif
             }
         }
-        /* Block 1L, SUBTRA */
-        el = saturate(xlow - s->band[0].s);
+        g722_bytes = put_code(s, g722_data, g722_bytes,
+                              encode_bands(s, xlow, xhigh));
+    }
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
 
-        /* Block 1L, QUANTL */
-        wd = (el >= 0)  ?  el  :  -(el + 1);
+int g722_encode_stereo(g722_encode_state_t *s_left,
+                       g722_encode_state_t *s_right,
+                       uint8_t g722_data_left[], uint8_t g722_data_right[],
+                       const int16_t amp[], int len)
+{
+    enum { CHUNK_SAMPLES = 160 };
+
+    /* Signal history of the QMF followed by the samples of the chunk */
+    int16_t x_left[24 + CHUNK_SAMPLES];
+    int16_t x_right[24 + CHUNK_SAMPLES];
+    int xlow;
+    int xhigh;
+    int left_bytes = 0;
+    int right_bytes = 0;
+    int i;
+    int j;
+    int n;
 
-        for (i = 1;  i < 30;  i++)
+    if (s_left->itu_test_mode || s_right->itu_test_mode || (len & 1))
+    {
+        /* Encode each channel separately */
+        int16_t chunk[CHUNK_SAMPLES];
+
+        for (j = 0;  j < len;  j += n)
         {
-            wd1 = (q6[i]*s->band[0].det) >> 12;
-            if (wd < wd1)
-                break;
+            n = (len - j < CHUNK_SAMPLES)  ?  len - j  :  CHUNK_SAMPLES;
+            for (i = 0;  i < n;  i++)
+                chunk[i] = amp[2*(j + i)];
+            left_bytes += g722_encode(s_left, g722_data_left + left_bytes,
+                                      chunk, n);
+            for (i = 0;  i < n;  i++)
+                chunk[i] = amp[2*(j + i) + 1];
+            right_bytes += g722_encode(s_right, g722_data_right + right_bytes,
+                                       chunk, n);
         }
-        ilow = (el < 0)  ?  iln[i]  :  ilp[i];
-
-        /* Block 2L, INVQAL */
-        ril = ilow >> 2;
-        wd2 = qm4[ril];
-        dlow = (s->band[0].det*wd2) >> 15;
-
-        /* Block 3L, LOGSCL */
-        il4 = rl42[ril];
-        wd = (s->band[0].nb*127) >> 7;
-        s->band[0].nb = wd + wl[il4];
-        if (s->band[0].nb < 0)
-            s->band[0].nb = 0;
-        else if (s->band[0].nb > 18432)
-            s->band[0].nb = 18432;
-
-        /* Block 3L, SCALEL */
-        wd1 = (s->band[0].nb >> 6) & 31;
-        wd2 = 8 - (s->band[0].nb >> 11);
-        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-        s->band[0].det = wd3 << 2;
+        return left_bytes;
+    }
+
+    for (i = 0;  i < 24;  i++)
+    {
+        x_left[i] = (int16_t) s_left->x[i];
+        x_right[i] = (int16_t) s_right->x[i];
+    }
 
-        block4(&s->band[0], dlow);
+    for (j = 0;  j < len;  j += n)
+    {
+        n = (len - j < CHUNK_SAMPLES)  ?  len - j  :  CHUNK_SAMPLES;
+        for (i = 0;  i < n;  i++)
         {
-	    int nb;
-
-            /* Block 1H, SUBTRA */
-            eh = saturate(xhigh - s->band[1].s);
-
-            /* Block 1H, QUANTH */
-            wd = (eh >= 0)  ?  eh  :  -(eh + 1);
-            wd1 = (564*s->band[1].det) >> 12;
-            mih = (wd >= wd1)  ?  2  :  1;
-            ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
-
-            /* Block 2H, INVQAH */
-            wd2 = qm2[ihigh];
-            dhigh = (s->band[1].det*wd2) >> 15;
-
-            /* Block 3H, LOGSCH */
-            ih2 = rh2[ihigh];
-            wd = (s->band[1].nb*127) >> 7;
-
-            nb = wd + wh[ih2];
-            if (nb < 0)
-                nb = 0;
-            else if (nb > 22528)
-                nb = 22528;
-	    s->band[1].nb = nb;
-
-            /* Block 3H, SCALEH */
-            wd1 = (s->band[1].nb >> 6) & 31;
-            wd2 = 10 - (s->band[1].nb >> 11);
-            wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-            s->band[1].det = wd3 << 2;
-
-            block4(&s->band[1], dhigh);
-#if   BITS_PER_SAMPLE == 8
-            code = ((ihigh << 6) | ilow);
-#elif BITS_PER_SAMPLE == 7
-            code = ((ihigh << 6) | ilow) >> 1;
-#elif BITS_PER_SAMPLE == 6
-            code = ((ihigh << 6) | ilow) >> 2;
-#endif
+            x_left[24 + i] = amp[2*(j + i)];
+            x_right[24 + i] = amp[2*(j + i) + 1];
         }
 
-#if PACKED_OUTPUT == 1
-            /* Pack the code bits */
-            s->out_buffer |= (code << s->out_bits);
-            s->out_bits += s->bits_per_sample;
-            if (s->out_bits >= 8)
-            {
-                g722_data[g722_bytes++] = (uint8_t) (s->out_buffer & 0xFF);
-                s->out_bits -= 8;
-                s->out_buffer >>= 8;
-            }
-#else
-            g722_data[g722_bytes++] = (uint8_t) code;
+        /* Each pair of input samples is shifted in the history, and gives
+           one code per channel */
+        for (i = 0;  i < n;  i += 2)
+        {
+            tx_qmf(x_left + i + 2, &xlow, &xhigh);
+#ifdef RUN_LIKE_REFERENCE_G722
+            xlow = limitValues(xlow);
+            xhigh = limitValues(xhigh);
+#endif
+            left_bytes = put_code(s_left, g722_data_left, left_bytes,
+                                  encode_bands(s_left, xlow, xhigh));
+
+            tx_qmf(x_right + i + 2, &xlow, &xhigh);
+#ifdef RUN_LIKE_REFERENCE_G722
+            xlow = limitValues(xlow);
+            xhigh = limitValues(xhigh);
 #endif
+            right_bytes = put_code(s_right, g722_data_right, right_bytes,
+                                   encode_bands(s_right, xlow, xhigh));
+        }
+
+        memmove(x_left, x_left + n, 24*sizeof(x_left[0]));
+        memmove(x_right, x_right + n, 24*sizeof(x_right[0]));
     }
-    return g722_bytes;
+
+    for (i = 0;  i < 24;  i++)
+    {
+        s_left->x[i] = x_left[i];
+        s_right->x[i] = x_right[i];
+    }
+    return left_bytes;
 }
 /*- End of function --------------------------------------------------------*/
 /*- End of file ------------------------------------------------------------*/
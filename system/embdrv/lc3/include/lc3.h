@@ -258,6 +258,23 @@ lc3_encoder_t lc3_setup_encoder(
 int lc3_encode(lc3_encoder_t encoder, enum lc3_pcm_format fmt,
     const void *pcm, int stride, int nbytes, void *out);
 
+/**
+ * Encode a frame of interleaved channels
+ * encoders        Handles of the encoders, one by channel
+ * nch             Number of channels
+ * fmt             PCM input format
+ * pcm             Input PCM samples, interleaved by channel
+ * nbytes          Target size, in bytes, of the frame of a channel (20 to 400)
+ * out             Output buffer of `nch` consecutives frames of `nbytes` size
+ * return          0: On success  -1: Wrong parameters
+ *
+ * The encoders are expected to be setup with the same frame duration and
+ * input samplerate. The frame of the channel `n` is stored at the offset
+ * `n * nbytes` of the output buffer.
+ */
+int lc3_encode_multi(lc3_encoder_t const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void *out);
+
 /**
  * Return size needed for an decoder
  * dt_us           Frame duration in us, 7500 or 10000
@@ -192,6 +192,19 @@ static void load_s24(
     }
 }
 
+/**
+ * Input PCM Samples loaders, and size of a sample, by format
+ */
+static void (* const load[])(struct lc3_encoder *, const void *, int) = {
+    [LC3_PCM_FORMAT_S16] = load_s16,
+    [LC3_PCM_FORMAT_S24] = load_s24,
+};
+
+static const int pcm_sample_bytes[] = {
+    [LC3_PCM_FORMAT_S16] = sizeof(int16_t),
+    [LC3_PCM_FORMAT_S24] = sizeof(int32_t),
+};
+
 /**
  * Frame Analysis
  * encoder         Encoder state
@@ -334,11 +347,6 @@ struct lc3_encoder *lc3_setup_encoder(
 int lc3_encode(struct lc3_encoder *encoder, enum lc3_pcm_format fmt,
     const void *pcm, int stride, int nbytes, void *out)
 {
-    static void (* const load[])(struct lc3_encoder *, const void *, int) = {
-        [LC3_PCM_FORMAT_S16] = load_s16,
-        [LC3_PCM_FORMAT_S24] = load_s24,
-    };
-
     /* --- Check parameters --- */
 
     if (!encoder || nbytes < LC3_MIN_FRAME_BYTES
@@ -359,6 +367,48 @@ int lc3_encode(struct lc3_encoder *encoder, enum lc3_pcm_format fmt,
     return 0;
 }
 
+/**
+ * Encode a frame of interleaved channels
+ */
+int lc3_encode_multi(struct lc3_encoder * const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void *out)
+{
+    /* --- Check parameters --- */
+
+    if (!encoders || nch <= 0 || nbytes < LC3_MIN_FRAME_BYTES
+                              || nbytes > LC3_MAX_FRAME_BYTES)
+        return -1;
+
+    for (int ich = 0; ich < nch; ich++)
+        if (!encoders[ich] || encoders[ich]->dt != encoders[0]->dt ||
+                              encoders[ich]->sr != encoders[0]->sr ||
+                              encoders[ich]->sr_pcm != encoders[0]->sr_pcm)
+            return -1;
+
+    /* --- Processing --- */
+
+    struct side_data side;
+    uint16_t xq[LC3_NE(encoders[0]->dt, encoders[0]->sr)];
+
+    const uint8_t *pcm_ch = pcm;
+    uint8_t *out_ch = out;
+
+    for (int ich = 0; ich < nch; ich++) {
+        struct lc3_encoder *encoder = encoders[ich];
+
+        load[fmt](encoder, pcm_ch, nch);
+
+        analyze(encoder, nbytes, &side, xq);
+
+        encode(encoder, &side, xq, nbytes, out_ch);
+
+        pcm_ch += pcm_sample_bytes[fmt];
+        out_ch += nbytes;
+    }
+
+    return 0;
+}
+
 
 /* ----------------------------------------------------------------------------
  *  Decoder
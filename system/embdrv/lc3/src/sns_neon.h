@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __ARM_NEON && __ARM_ARCH_ISA_A64
+
+#ifndef TEST_NEON
+#include <arm_neon.h>
+#endif /* TEST_NEON */
+
+
+/**
+ * Forward DCT-16 transformation
+ */
+#ifndef dct16_forward
+#define dct16_forward neon_dct16_forward
+LC3_HOT static void neon_dct16_forward(const float *x, float *y)
+{
+    float32x4_t y0 = vmovq_n_f32(0), y1 = vmovq_n_f32(0);
+    float32x4_t y2 = vmovq_n_f32(0), y3 = vmovq_n_f32(0);
+
+    for (int j = 0; j < 16; j++) {
+        float32x4_t xj = vld1q_dup_f32(x + j);
+        const float *m = dct16_m[j];
+
+        y0 = vfmaq_f32(y0, xj, vld1q_f32(m +  0));
+        y1 = vfmaq_f32(y1, xj, vld1q_f32(m +  4));
+        y2 = vfmaq_f32(y2, xj, vld1q_f32(m +  8));
+        y3 = vfmaq_f32(y3, xj, vld1q_f32(m + 12));
+    }
+
+    vst1q_f32(y +  0, y0);
+    vst1q_f32(y +  4, y1);
+    vst1q_f32(y +  8, y2);
+    vst1q_f32(y + 12, y3);
+}
+#endif /* dct16_forward */
+
+/**
+ * Inverse DCT-16 transformation
+ */
+#ifndef dct16_inverse
+#define dct16_inverse neon_dct16_inverse
+LC3_HOT static void neon_dct16_inverse(const float *x, float *y)
+{
+    float32x4_t x0 = vld1q_f32(x +  0), x1 = vld1q_f32(x +  4);
+    float32x4_t x2 = vld1q_f32(x +  8), x3 = vld1q_f32(x + 12);
+
+    for (int i = 0; i < 16; i++) {
+        const float *m = dct16_m[i];
+        float32x4_t yi;
+
+        yi = vmulq_f32(x0, vld1q_f32(m +  0));
+        yi = vfmaq_f32(yi, x1, vld1q_f32(m +  4));
+        yi = vfmaq_f32(yi, x2, vld1q_f32(m +  8));
+        yi = vfmaq_f32(yi, x3, vld1q_f32(m + 12));
+
+        y[i] = vaddvq_f32(yi);
+    }
+}
+#endif /* dct16_inverse */
+
+
+#endif /* __ARM_NEON && __ARM_ARCH_ISA_A64 */
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __ARM_NEON && __ARM_ARCH_ISA_A64
+
+#ifndef TEST_NEON
+#include <arm_neon.h>
+#endif /* TEST_NEON */
+
+
+/**
+ * Import
+ */
+
+static float unquantize_gain(int);
+
+
+/**
+ * Spectrum quantization
+ */
+#ifndef quantize
+#define quantize neon_quantize
+LC3_HOT static void neon_quantize(enum lc3_dt dt, enum lc3_srate sr,
+    int g_int, float *x, uint16_t *xq, int *nq)
+{
+    float32x4_t g_inv = vmovq_n_f32(1 / unquantize_gain(g_int));
+    float32x4_t k_6u16 = vmovq_n_f32(6.f/16);
+    float32x4_t k_max = vmovq_n_f32(INT16_MAX);
+    int ne = LC3_NE(dt, sr);
+
+    for (int i = 0; i < ne; i += 4) {
+        float32x4_t v = vmulq_f32(vld1q_f32(x + i), g_inv);
+        vst1q_f32(x + i, v);
+
+        uint32x4_t q = vcvtq_u32_f32(
+            vminq_f32(vaddq_f32(vabsq_f32(v), k_6u16), k_max));
+
+        uint32x4_t s = vandq_u32(
+            vcltq_f32(v, vmovq_n_f32(0)), vcgtq_u32(q, vmovq_n_u32(0)));
+
+        q = vorrq_u32(vshlq_n_u32(q, 1), vshrq_n_u32(s, 31));
+        vst1_u16(xq + i, vmovn_u32(q));
+    }
+
+    /* --- Count of significants, by pairs of coefficients --- */
+
+    int n = ne;
+
+    while (n > 0 && !(xq[n-1] | xq[n-2]))
+        n -= 2;
+
+    *nq = n;
+}
+#endif /* quantize */
+
+
+#endif /* __ARM_NEON && __ARM_ARCH_ISA_A64 */
@@ -19,6 +19,8 @@
 #include "tns.h"
 #include "tables.h"
 
+#include "tns_neon.h"
+
 
 /* ----------------------------------------------------------------------------
  *  Filter Coefficients
@@ -39,6 +41,7 @@ static bool resolve_lpc_weighting(enum lc3_dt dt, int nbytes)
  * a, b, n         The 2 vectors of size `n`
  * return          sum( a[i] * b[i] ), i = [0..n-1]
  */
+#ifndef dot
 LC3_HOT static inline float dot(const float *a, const float *b, int n)
 {
     float v = 0;
@@ -48,6 +51,7 @@ LC3_HOT static inline float dot(const float *a, const float *b, int n)
 
     return v;
 }
+#endif /* dot */
 
 /**
  * LPC Coefficients
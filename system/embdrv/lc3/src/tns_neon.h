@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __ARM_NEON && __ARM_ARCH_ISA_A64
+
+#ifndef TEST_NEON
+#include <arm_neon.h>
+#endif /* TEST_NEON */
+
+
+/**
+ * Return dot product of 2 vectors
+ */
+#ifndef dot
+#define dot neon_dot
+LC3_HOT static inline float neon_dot(const float *a, const float *b, int n)
+{
+    float32x4_t v0 = vmovq_n_f32(0), v1 = vmovq_n_f32(0);
+
+    for (; n >= 8; n -= 8, a += 8, b += 8) {
+        v0 = vfmaq_f32(v0, vld1q_f32(a + 0), vld1q_f32(b + 0));
+        v1 = vfmaq_f32(v1, vld1q_f32(a + 4), vld1q_f32(b + 4));
+    }
+
+    if (n >= 4) {
+        v0 = vfmaq_f32(v0, vld1q_f32(a), vld1q_f32(b));
+        n -= 4, a += 4, b += 4;
+    }
+
+    float v = vaddvq_f32(vaddq_f32(v0, v1));
+
+    while (n--)
+        v += *(a++) * *(b++);
+
+    return v;
+}
+#endif /* dot */
+
+
+#endif /* __ARM_NEON && __ARM_ARCH_ISA_A64 */
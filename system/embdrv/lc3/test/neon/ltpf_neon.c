@@ -27,12 +27,6 @@
 #define TEST_NEON
 #include <ltpf.c>
 
-void lc3_put_bits_generic(lc3_bits_t *a, unsigned b, int c)
-{ (void)a, (void)b, (void)c; }
-
-unsigned lc3_get_bits_generic(struct lc3_bits *a, int b)
-{ return (void)a, (void)b, 0; }
-
 /* -------------------------------------------------------------------------- */
 
 static int check_resampler()
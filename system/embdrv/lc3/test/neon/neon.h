@@ -24,6 +24,7 @@
 #define __ARM_NEON 1
 
 #include <stdint.h>
+#include <math.h>
 
 
 /* ----------------------------------------------------------------------------
@@ -31,10 +32,12 @@
  * -------------------------------------------------------------------------- */
 
 typedef struct { int16_t e[4]; } int16x4_t;
+typedef struct { uint16_t e[4]; } uint16x4_t;
 
 typedef struct { int16_t e[8]; } int16x8_t;
 typedef struct { int32_t e[4]; } int32x4_t;
 typedef struct { int64_t e[2]; } int64x2_t;
+typedef struct { uint32_t e[4]; } uint32x4_t;
 
 
 /**
@@ -48,6 +51,13 @@ static int16x4_t vld1_s16(const int16_t *p)
 }
 
 
+__attribute__((unused))
+static void vst1_u16(uint16_t *p, uint16x4_t v)
+{
+    p[0] = v.e[0], p[1] = v.e[1], p[2] = v.e[2], p[3] = v.e[3];
+}
+
+
 /**
  * Arithmetic
  */
@@ -79,6 +89,52 @@ static int64x2_t vpadalq_s32(int64x2_t a, int32x4_t b)
 }
 
 
+/**
+ * Logical and shift
+ */
+
+__attribute__((unused))
+static uint32x4_t vandq_u32(uint32x4_t a, uint32x4_t b)
+{
+    return (uint32x4_t){ { a.e[0] & b.e[0], a.e[1] & b.e[1],
+                           a.e[2] & b.e[2], a.e[3] & b.e[3] } };
+}
+
+__attribute__((unused))
+static uint32x4_t vorrq_u32(uint32x4_t a, uint32x4_t b)
+{
+    return (uint32x4_t){ { a.e[0] | b.e[0], a.e[1] | b.e[1],
+                           a.e[2] | b.e[2], a.e[3] | b.e[3] } };
+}
+
+__attribute__((unused))
+static uint32x4_t vshlq_n_u32(uint32x4_t a, const int n)
+{
+    return (uint32x4_t){ { a.e[0] << n, a.e[1] << n,
+                           a.e[2] << n, a.e[3] << n } };
+}
+
+__attribute__((unused))
+static uint32x4_t vshrq_n_u32(uint32x4_t a, const int n)
+{
+    return (uint32x4_t){ { a.e[0] >> n, a.e[1] >> n,
+                           a.e[2] >> n, a.e[3] >> n } };
+}
+
+
+/**
+ * Compare
+ */
+
+__attribute__((unused))
+static uint32x4_t vcgtq_u32(uint32x4_t a, uint32x4_t b)
+{
+    return (uint32x4_t){ {
+        a.e[0] > b.e[0] ? ~0u : 0, a.e[1] > b.e[1] ? ~0u : 0,
+        a.e[2] > b.e[2] ? ~0u : 0, a.e[3] > b.e[3] ? ~0u : 0 } };
+}
+
+
 /**
  * Reduce
  */
@@ -121,6 +177,18 @@ static int64x2_t vmovq_n_s64(int64_t v)
     return (int64x2_t){ { v, v, } };
 }
 
+__attribute__((unused))
+static uint32x4_t vmovq_n_u32(uint32_t v)
+{
+    return (uint32x4_t){ { v, v, v, v } };
+}
+
+__attribute__((unused))
+static uint16x4_t vmovn_u32(uint32x4_t a)
+{
+    return (uint16x4_t){ { a.e[0], a.e[1], a.e[2], a.e[3] } };
+}
+
 
 
 /* ----------------------------------------------------------------------------
@@ -198,6 +266,13 @@ static float32x4_t vnegq_f32(float32x4_t a)
     return (float32x4_t){ { -a.e[0], -a.e[1], -a.e[2], -a.e[3] } };
 }
 
+__attribute__((unused))
+static float32x4_t vabsq_f32(float32x4_t a)
+{
+    return (float32x4_t){ {
+        fabsf(a.e[0]), fabsf(a.e[1]), fabsf(a.e[2]), fabsf(a.e[3]) } };
+}
+
 __attribute__((unused))
 static float32x4_t vaddq_f32(float32x4_t a, float32x4_t b)
 {
@@ -212,6 +287,21 @@ static float32x4_t vsubq_f32(float32x4_t a, float32x4_t b)
                             a.e[2] - b.e[2], a.e[3] - b.e[3] } };
 }
 
+__attribute__((unused))
+static float32x4_t vmulq_f32(float32x4_t a, float32x4_t b)
+{
+    return (float32x4_t){ { a.e[0] * b.e[0], a.e[1] * b.e[1],
+                            a.e[2] * b.e[2], a.e[3] * b.e[3] } };
+}
+
+__attribute__((unused))
+static float32x4_t vminq_f32(float32x4_t a, float32x4_t b)
+{
+    return (float32x4_t){ {
+        fminf(a.e[0], b.e[0]), fminf(a.e[1], b.e[1]),
+        fminf(a.e[2], b.e[2]), fminf(a.e[3], b.e[3]) } };
+}
+
 __attribute__((unused))
 static float32x2_t vfma_f32(float32x2_t a, float32x2_t b, float32x2_t c)
 {
@@ -243,6 +333,36 @@ static float32x4_t vfmsq_f32(float32x4_t a, float32x4_t b, float32x4_t c)
 }
 
 
+/**
+ * Compare and convert
+ */
+
+__attribute__((unused))
+static uint32x4_t vcltq_f32(float32x4_t a, float32x4_t b)
+{
+    return (uint32x4_t){ {
+        a.e[0] < b.e[0] ? ~0u : 0, a.e[1] < b.e[1] ? ~0u : 0,
+        a.e[2] < b.e[2] ? ~0u : 0, a.e[3] < b.e[3] ? ~0u : 0 } };
+}
+
+__attribute__((unused))
+static uint32x4_t vcvtq_u32_f32(float32x4_t a)
+{
+    return (uint32x4_t){ { a.e[0], a.e[1], a.e[2], a.e[3] } };
+}
+
+
+/**
+ * Reduce
+ */
+
+__attribute__((unused))
+static float vaddvq_f32(float32x4_t v)
+{
+    return (v.e[0] + v.e[1]) + (v.e[2] + v.e[3]);
+}
+
+
 /**
  * Manipulation
  */
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "neon.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_NEON
+#include <sns.c>
+
+/* -------------------------------------------------------------------------- */
+
+static int check_dct16(void)
+{
+    float x[16], y[16], y_neon[16];
+
+    for (int i = 0; i < 16; i++)
+        x[i] = (float)rand() / RAND_MAX;
+
+    dct16_forward(x, y);
+    neon_dct16_forward(x, y_neon);
+    for (int i = 0; i < 16; i++)
+        if (fabsf(y[i] - y_neon[i]) > 1e-6f)
+            return -1;
+
+    dct16_inverse(x, y);
+    neon_dct16_inverse(x, y_neon);
+    for (int i = 0; i < 16; i++)
+        if (fabsf(y[i] - y_neon[i]) > 1e-6f)
+            return -1;
+
+    return 0;
+}
+
+int check_sns(void)
+{
+    int ret;
+
+    if ((ret = check_dct16()) < 0)
+        return ret;
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "neon.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_NEON
+#include <spec.c>
+
+/* -------------------------------------------------------------------------- */
+
+static int check_quantize(void)
+{
+    float x[LC3_MAX_NE], x_ref[LC3_MAX_NE], x_neon[LC3_MAX_NE];
+    uint16_t xq[LC3_MAX_NE], xq_neon[LC3_MAX_NE];
+    int ne = LC3_NE(LC3_DT_10M, LC3_SRATE_48K);
+    int nq, nq_neon;
+
+    for (int g_int = 0; g_int < 128; g_int += 3) {
+        for (int i = 0; i < ne; i++)
+            x[i] = ((float)rand() / RAND_MAX - 0.5f) * 1e4f;
+
+        for (int i = ne - (rand() % ne); i < ne; i++)
+            x[i] = 0;
+
+        memcpy(x_ref, x, sizeof(x));
+        memcpy(x_neon, x, sizeof(x));
+
+        quantize(LC3_DT_10M, LC3_SRATE_48K, g_int - 32, x_ref, xq, &nq);
+        neon_quantize(LC3_DT_10M, LC3_SRATE_48K,
+                      g_int - 32, x_neon, xq_neon, &nq_neon);
+
+        if (memcmp(x_ref, x_neon, ne * sizeof(*x)) != 0 ||
+            memcmp(xq, xq_neon, ne * sizeof(*xq)) != 0  ||
+            nq != nq_neon)
+            return -1;
+    }
+
+    return 0;
+}
+
+int check_spec(void)
+{
+    int ret;
+
+    if ((ret = check_quantize()) < 0)
+        return ret;
+
+    return 0;
+}
@@ -18,8 +18,36 @@
 
 #include <stdio.h>
 
+#include "bits.h"
+#include "bwdet.h"
+
+/* -------------------------------------------------------------------------- */
+
+void lc3_put_bits_generic(lc3_bits_t *a, unsigned b, int c)
+{ (void)a, (void)b, (void)c; }
+
+unsigned lc3_get_bits_generic(struct lc3_bits *a, int b)
+{ return (void)a, (void)b, 0; }
+
+int lc3_get_bits_left(const lc3_bits_t *a)
+{ return (void)a, 0; }
+
+void lc3_ac_read_renorm(lc3_bits_t *a)
+{ (void)a; }
+
+void lc3_ac_write_renorm(lc3_bits_t *a)
+{ (void)a; }
+
+int lc3_bwdet_get_nbits(enum lc3_srate a)
+{ return (void)a, 0; }
+
+/* -------------------------------------------------------------------------- */
+
 int check_ltpf(void);
 int check_mdct(void);
+int check_sns(void);
+int check_spec(void);
+int check_tns(void);
 
 int main()
 {
@@ -33,5 +61,17 @@ int main()
     printf("%s\n", (r = check_mdct()) == 0 ? "OK" : "Failed");
     ret = ret || r;
 
+    printf("Checking SNS Neon... "); fflush(stdout);
+    printf("%s\n", (r = check_sns()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    printf("Checking Spectrum Neon... "); fflush(stdout);
+    printf("%s\n", (r = check_spec()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    printf("Checking TNS Neon... "); fflush(stdout);
+    printf("%s\n", (r = check_tns()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
     return ret;
 }
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ *  Copyright 2022 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "neon.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_NEON
+#include <tns.c>
+
+/* -------------------------------------------------------------------------- */
+
+static int check_dot(void)
+{
+    float a[200], b[200];
+
+    for (int i = 0; i < 200; i++) {
+        a[i] = (float)rand() / RAND_MAX - 0.5f;
+        b[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+
+    for (int n = 0; n < 192; n += 7) {
+        float y = dot(a, b + 4, n);
+        float y_neon = neon_dot(a, b + 4, n);
+        if (fabsf(y - y_neon) > 1e-5f)
+            return -1;
+    }
+
+    return 0;
+}
+
+int check_tns(void)
+{
+    int ret;
+
+    if ((ret = check_dot()) < 0)
+        return ret;
+
+    return 0;
+}
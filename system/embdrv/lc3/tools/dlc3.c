@@ -205,8 +205,8 @@ int main(int argc, char *argv[])
 
     static const char *dash_line = "========================================";
 
-    int nsec = 0;
-    unsigned t0 = clock_us();
+    int nsec = 0, nframes = 0;
+    unsigned t0 = clock_us(), tc = 0;
 
     for (int i = 0; i * frame_samples < encode_samples; i++) {
 
@@ -223,6 +223,8 @@ int main(int argc, char *argv[])
             nsec = rint(i * frame_us * 1e-6);
         }
 
+        unsigned tc0 = clock_us();
+
         if (frame_bytes <= 0)
             memset(pcm, 0, nch * frame_samples * pcm_sbytes);
         else
@@ -231,6 +233,8 @@ int main(int argc, char *argv[])
                     in + ich * frame_bytes, frame_bytes,
                     pcm_fmt, pcm + ich * pcm_sbytes, nch);
 
+        tc += clock_us() - tc0, nframes++;
+
         int pcm_offset = i > 0 ? 0 : encode_samples - pcm_samples;
         int pcm_nwrite = MIN(frame_samples - pcm_offset,
             encode_samples - i*frame_samples);
@@ -244,6 +248,10 @@ int main(int argc, char *argv[])
     fprintf(stderr, "%02d:%02d Decoded in %d.%03d seconds %20s\n",
         nsec / 60, nsec % 60, t / 1000, t % 1000, "");
 
+    fprintf(stderr, "%d frames decoded at %.0f frames/s"
+                    " (%.1fx realtime, codec only)\n", nframes,
+        tc ? nframes * 1e6 / tc : 0, tc ? nframes * frame_us / (double)tc : 0);
+
     /* --- Cleanup --- */
 
     for (int ich = 0; ich < nch; ich++)
@@ -210,8 +210,8 @@ int main(int argc, char *argv[])
 
     static const char *dash_line = "========================================";
 
-    int nsec = 0;
-    unsigned t0 = clock_us();
+    int nsec = 0, nframes = 0;
+    unsigned t0 = clock_us(), tc = 0;
 
     for (int i = 0; i * frame_samples < encode_samples; i++) {
 
@@ -231,20 +231,28 @@ int main(int argc, char *argv[])
             nsec = (int)(i * frame_us * 1e-6);
         }
 
+        unsigned tc0 = clock_us();
+
         for (int ich = 0; ich < nch; ich++)
             lc3_encode(enc[ich],
                 pcm_fmt, pcm + ich * pcm_sbytes, nch,
                 frame_bytes, out[ich]);
 
+        tc += clock_us() - tc0, nframes++;
+
         lc3bin_write_data(fp_out, out, nch, frame_bytes);
     }
 
     unsigned t = (clock_us() - t0) / 1000;
     nsec = encode_samples / srate_hz;
 
-    fprintf(stderr, "%02d:%02d Encoded in %d.%d seconds %20s\n",
+    fprintf(stderr, "%02d:%02d Encoded in %d.%03d seconds %20s\n",
         nsec / 60, nsec % 60, t / 1000, t % 1000, "");
 
+    fprintf(stderr, "%d frames encoded at %.0f frames/s"
+                    " (%.1fx realtime, codec only)\n", nframes,
+        tc ? nframes * 1e6 / tc : 0, tc ? nframes * frame_us / (double)tc : 0);
+
     /* --- Cleanup --- */
 
     for (int ich = 0; ich < nch; ich++)
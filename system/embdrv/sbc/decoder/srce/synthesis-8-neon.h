@@ -0,0 +1,132 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ @file
+
+ NEON version of SynthWindow80_generated(), the 8-subband synthesis window.
+
+ The generated code computes each output sample as a sum of 16x16 bit
+ products, each shifted by its own amount before the accumulation. Within
+ each group of 16 values of the filter buffer, the outputs 1 to 7 read the
+ values 5 to 11 and the same values in reverse order; the output 0 reads
+ the value 12 and the value 4 of the group. The outputs are therefore
+ computed in 8 lanes, ordered 1 to 7 then 0, from the groups buffer[16 * m
+ + 5 .. 12] and buffer[16 * m + 4 .. 11] reversed, with the coefficients
+ and shifts of the generated code laid out in the same order. Lanes without
+ a term have a zero coefficient. The result is identical to the generated
+ code.
+
+ @ingroup codec_internal
+ */
+
+/**
+@addtogroup codec_internal
+@{
+*/
+
+#if defined(__ARM_NEON) && !defined(SBC_SYNTHESIS_NO_NEON)
+
+#ifndef TEST_NEON
+#include <arm_neon.h>
+#endif
+
+#ifndef SYNTH80
+#define SYNTH80 SynthWindow80_neon
+
+static const int16_t synth80_neon_coeff[5][2][8] = {
+    {{-3263, -10385, -16457, 10445, -8443, -10337, -6087, 8235},
+     {29293, 24995, 19083, 0, 16913, 11167, 9293, 0}},
+    {{-5229, -309, -23641, -5297, -301, -30605, -2893, 26479},
+     {30835, 9161, -29015, 0, 3687, 1917, 1247, -23167}},
+    {{-27021, -23063, -12889, 22299, 10255, 9553, 18055, 9399},
+     {31633, 27561, 6145, 0, 15447, 8317, 23671, -17397}},
+    {{17319, 2309, 24211, 10603, 9405, 16383, 1747, 26479},
+     {26663, 12705, 23469, 0, -18233, 22117, 11537, 17397}},
+    {{4555, 6239, 21223, 9539, 26189, 8603, 8721, 8235},
+     {12419, 9251, 26913, 0, 1499, 7543, 685, 23167}}};
+
+/* Left shifts of the products, right shifts are negative. */
+static const int32_t synth80_neon_shift[5][2][8] = {
+    {{-5, -6, -6, -4, -7, -4, -2, -3}, {-5, -5, -5, 0, -5, -4, -3, 0}},
+    {{0, 4, -2, 1, 5, -1, 3, -2}, {-3, -3, -4, 0, 1, 2, 3, -3}},
+    {{1, 1, 2, 2, 2, 2, 1, 3}, {1, 1, 3, 0, 2, 3, 2, 1}},
+    {{1, 3, -1, 0, -1, -2, 1, -2}, {-2, -1, -2, 0, -3, -4, -1, 1}},
+    {{-1, -3, -8, -4, -7, -6, -7, -3}, {-4, -4, -6, 0, -1, -3, 1, -3}}};
+
+INLINE int32x4_t synth80_neon_mac(int32x4_t acc, int16x4_t x, int16x4_t k,
+                                  const int32_t* shift) {
+  return vaddq_s32(acc, vshlq_s32(vmull_s16(x, k), vld1q_s32(shift)));
+}
+
+/** Division by 32768 rounding toward zero, as done by the generated code. */
+INLINE int32x4_t synth80_neon_div32768(int32x4_t x) {
+  uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(x, 31)), 17);
+  return vshrq_n_s32(vaddq_s32(x, vreinterpretq_s32_u32(bias)), 15);
+}
+
+PRIVATE void SynthWindow80_neon(int16_t* pcm,
+                                SBC_BUFFER_T const* RESTRICT buffer,
+                                OI_UINT strideShift) {
+  int32x4_t lo = vdupq_n_s32(0);
+  int32x4_t hi = vdupq_n_s32(0);
+  int16x8_t out;
+  int m;
+
+  for (m = 0; m < 5; m++) {
+    int16x8_t x = vld1q_s16(buffer + 16 * m + 5);
+    int16x8_t r = vrev64q_s16(vld1q_s16(buffer + 16 * m + 4));
+    int16x8_t kx = vld1q_s16(synth80_neon_coeff[m][0]);
+    int16x8_t kr = vld1q_s16(synth80_neon_coeff[m][1]);
+
+    r = vcombine_s16(vget_high_s16(r), vget_low_s16(r));
+    lo = synth80_neon_mac(lo, vget_low_s16(x), vget_low_s16(kx),
+                          synth80_neon_shift[m][0]);
+    hi = synth80_neon_mac(hi, vget_high_s16(x), vget_high_s16(kx),
+                          synth80_neon_shift[m][0] + 4);
+    lo = synth80_neon_mac(lo, vget_low_s16(r), vget_low_s16(kr),
+                          synth80_neon_shift[m][1]);
+    hi = synth80_neon_mac(hi, vget_high_s16(r), vget_high_s16(kr),
+                          synth80_neon_shift[m][1] + 4);
+  }
+
+  /* Saturate to 16 bits like CLIP_INT16, and move the output 0 first. */
+  out = vcombine_s16(vqmovn_s32(synth80_neon_div32768(lo)),
+                     vqmovn_s32(synth80_neon_div32768(hi)));
+  out = vextq_s16(out, out, 7);
+
+  if (strideShift == 0) {
+    vst1q_s16(pcm, out);
+  } else {
+    int16_t samples[8];
+    int i;
+
+    vst1q_s16(samples, out);
+    for (i = 0; i < 8; i++) {
+      pcm[i << strideShift] = samples[i];
+    }
+  }
+}
+
+#endif /* SYNTH80 */
+
+#endif /* __ARM_NEON && !SBC_SYNTHESIS_NO_NEON */
+
+/**
+@}
+*/
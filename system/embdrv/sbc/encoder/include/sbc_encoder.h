@@ -90,6 +90,14 @@
 #define SBC_ARM_ASM_OPT FALSE
 #endif
 
+/* Set SBC_SIMD_OPT to FALSE to disable the NEON and SSE2 versions of the
+ * analysis windowing, used when SBC_IPAQ_OPT is TRUE and
+ * SBC_IS_64_MULT_IN_WINDOW_ACCU is FALSE. They give bit exact results.
+ */
+#ifndef SBC_SIMD_OPT
+#define SBC_SIMD_OPT TRUE
+#endif
+
 /* green hill compiler option -> Used to distinguish the syntax for inline
  * assembly code
  */
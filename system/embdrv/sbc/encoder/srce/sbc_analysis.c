@@ -1185,6 +1185,11 @@ static int16_t* s16X =
 #endif
 #endif
 
+#if (SBC_ARM_ASM_OPT == FALSE && SBC_IPAQ_OPT == TRUE && \
+     SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE)
+#include "sbc_analysis_simd.h"
+#endif
+
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
 /****************************************************************************
@@ -1205,7 +1210,7 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #if (SBC_IPAQ_OPT == TRUE)
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
   register int64_t s64Temp, s64Temp2;
-#else
+#elif !defined(SBC_SIMD_WINDOW_ACCU)
   register int32_t s32Temp, s32Temp2;
 #endif
 #else
@@ -1296,7 +1301,7 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 #if (SBC_IPAQ_OPT == TRUE)
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
   register int64_t s64Temp, s64Temp2;
-#else
+#elif !defined(SBC_SIMD_WINDOW_ACCU)
   register int32_t s32Temp, s32Temp2;
 #endif
 #else
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  NEON and SSE2 versions of the analysis windowing, included by
+ *  sbc_analysis.c after the definition of the 16 bits window coefficients.
+ *
+ *  The windowing of the output i accumulates the 5 input samples
+ *  s16X[ChOffset + i + k * 2 * NumOfSubBands], k = 0..4. The coefficients
+ *  are laid out as [k][i] so that consecutive outputs are computed in
+ *  parallel. The symmetric samples of the scalar code, added or subtracted
+ *  before the multiplication, are multiplied separately here: the results
+ *  are identical as the accumulation wraps around on 32 bits in both cases.
+ *
+ ******************************************************************************/
+
+#if (SBC_SIMD_OPT == TRUE) && (defined(__ARM_NEON) || defined(__SSE2__))
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#define SBC_SIMD_WINDOW_ACCU
+
+#define SBC_NEG(w) (int16_t)(-(int32_t)(w))
+
+static const int16_t gas16WindowCoeffFor4SBs[5][8] = {
+    {0, WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_1_4},
+    {WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_1, WIND_4_SUBBANDS_2_1,
+     WIND_4_SUBBANDS_3_1, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_3,
+     WIND_4_SUBBANDS_2_3, WIND_4_SUBBANDS_1_3},
+    {WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_2_2,
+     WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_3_2,
+     WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_1_2},
+    {SBC_NEG(WIND_4_SUBBANDS_0_2), WIND_4_SUBBANDS_1_3, WIND_4_SUBBANDS_2_3,
+     WIND_4_SUBBANDS_3_3, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_1,
+     WIND_4_SUBBANDS_2_1, WIND_4_SUBBANDS_1_1},
+    {SBC_NEG(WIND_4_SUBBANDS_0_1), WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_1_0}};
+
+static const int16_t gas16WindowCoeffFor8SBs[5][16] = {
+    {0, WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_3_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_6_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_7_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_4_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_1_4},
+    {WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_1_3},
+    {WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_8_2,
+     WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_1_2},
+    {SBC_NEG(WIND_8_SUBBANDS_0_2), WIND_8_SUBBANDS_1_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_1_1},
+    {SBC_NEG(WIND_8_SUBBANDS_0_1), WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_2_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_5_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_8_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_5_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_2_0,
+     WIND_8_SUBBANDS_1_0}};
+
+#undef SBC_NEG
+
+/* Windowing of 8 consecutive outputs, the input samples and the coefficients
+ * of the successive taps are `stride` apart. */
+#if defined(__ARM_NEON)
+static inline void SbcWindowAccu8(const int16_t* ps16X,
+                                  const int16_t* ps16Coeff, int32_t stride,
+                                  int32_t* ps32Out) {
+  int16x8_t x = vld1q_s16(ps16X);
+  int16x8_t c = vld1q_s16(ps16Coeff);
+  int32x4_t lo = vmull_s16(vget_low_s16(x), vget_low_s16(c));
+  int32x4_t hi = vmull_s16(vget_high_s16(x), vget_high_s16(c));
+
+  for (int k = 1; k < 5; k++) {
+    x = vld1q_s16(ps16X + k * stride);
+    c = vld1q_s16(ps16Coeff + k * stride);
+    lo = vmlal_s16(lo, vget_low_s16(x), vget_low_s16(c));
+    hi = vmlal_s16(hi, vget_high_s16(x), vget_high_s16(c));
+  }
+
+  vst1q_s32(ps32Out, lo);
+  vst1q_s32(ps32Out + 4, hi);
+}
+#else
+static inline void SbcWindowAccu8(const int16_t* ps16X,
+                                  const int16_t* ps16Coeff, int32_t stride,
+                                  int32_t* ps32Out) {
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+
+  for (int k = 0; k < 5; k++) {
+    __m128i x = _mm_loadu_si128((const __m128i*)(ps16X + k * stride));
+    __m128i c = _mm_loadu_si128((const __m128i*)(ps16Coeff + k * stride));
+    __m128i p_lo = _mm_mullo_epi16(x, c);
+    __m128i p_hi = _mm_mulhi_epi16(x, c);
+    lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(p_lo, p_hi));
+    hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(p_lo, p_hi));
+  }
+
+  _mm_storeu_si128((__m128i*)ps32Out, lo);
+  _mm_storeu_si128((__m128i*)(ps32Out + 4), hi);
+}
+#endif
+
+#undef WINDOW_PARTIAL_4
+#define WINDOW_PARTIAL_4                                                 \
+  {                                                                      \
+    SbcWindowAccu8(s16X + ChOffset, gas16WindowCoeffFor4SBs[0], 8,       \
+                   s32DCTY);                                             \
+  }
+
+#undef WINDOW_PARTIAL_8
+#define WINDOW_PARTIAL_8                                                \
+  {                                                                     \
+    SbcWindowAccu8(s16X + ChOffset, gas16WindowCoeffFor8SBs[0], 16,     \
+                   s32DCTY);                                            \
+    SbcWindowAccu8(s16X + ChOffset + 8, gas16WindowCoeffFor8SBs[0] + 8, \
+                   16, s32DCTY + 8);                                    \
+  }
+
+#endif /* SBC_SIMD_OPT && (__ARM_NEON || __SSE2__) */
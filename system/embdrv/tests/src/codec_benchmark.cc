@@ -0,0 +1,403 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput and per frame latency of the in-tree codecs.
+//
+// Each iteration processes one frame, so the reported time is the latency of
+// a frame. The frames_per_second counter gives the throughput, and the
+// realtime counter the seconds of audio processed per second, i.e. how many
+// times faster than real time the codec runs on one core. The architecture
+// of the binary is reported in the context, run both the 32 and 64 bit
+// binaries on device to compare them.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "aptXHDbtenc.h"
+#include "aptXbtenc.h"
+#include "embdrv/sbc/decoder/include/oi_codec_sbc.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+#include "g722_enc_dec.h"
+#include "lc3.h"
+
+using ::benchmark::Counter;
+using ::benchmark::State;
+
+namespace {
+
+#if defined(__aarch64__)
+constexpr char kArch[] = "arm64";
+#elif defined(__arm__)
+constexpr char kArch[] = "arm";
+#elif defined(__x86_64__)
+constexpr char kArch[] = "x86_64";
+#elif defined(__i386__)
+constexpr char kArch[] = "x86";
+#elif defined(__riscv)
+constexpr char kArch[] = "riscv64";
+#else
+constexpr char kArch[] = "unknown";
+#endif
+
+// Number of distinct frames of signal, so that the codecs don't see the same
+// input on each iteration.
+constexpr size_t kNumFrames = 64;
+
+// Fills |pcm| with a two tone signal, |channels| interleaved, continuing at
+// sample |t| of each channel.
+void FillTwoTone(int16_t* pcm, size_t samples, int channels, size_t t) {
+  for (size_t i = 0; i < samples; i++) {
+    size_t n = t + i / channels;
+    pcm[i] = static_cast<int16_t>(8000 * std::sin(n * 0.031) +
+                                  6000 * std::sin(n * 0.47 + i % channels));
+  }
+}
+
+std::vector<int16_t> MakeSignal(size_t samples_per_frame, int channels) {
+  std::vector<int16_t> pcm(kNumFrames * samples_per_frame);
+  FillTwoTone(pcm.data(), pcm.size(), channels, 0);
+  return pcm;
+}
+
+void SetFrameCounters(State& state, double frame_duration_s) {
+  state.counters["frames_per_second"] =
+      Counter(static_cast<double>(state.iterations()), Counter::kIsRate);
+  state.counters["realtime"] = Counter(
+      static_cast<double>(state.iterations()) * frame_duration_s,
+      Counter::kIsRate);
+}
+
+/*
+ * SBC and mSBC
+ */
+
+constexpr size_t kMaxSbcFrameBytes = 512;
+
+// Encodes one SBC frame per iteration, the arguments are the SBC channel
+// mode, number of subbands and bit rate in kbps, at 44.1 kHz.
+void BM_SbcEncode(State& state) {
+  SBC_ENC_PARAMS params = {};
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = state.range(0);
+  params.s16NumOfSubBands = state.range(1);
+  params.s16NumOfChannels = params.s16ChannelMode == SBC_MONO ? 1 : 2;
+  params.s16NumOfBlocks = 16;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = state.range(2);
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  size_t samples_per_frame = params.s16NumOfBlocks * params.s16NumOfSubBands *
+                             params.s16NumOfChannels;
+  auto pcm = MakeSignal(samples_per_frame, params.s16NumOfChannels);
+  uint8_t frame[kMaxSbcFrameBytes];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        SBC_Encode(&params, &pcm[i * samples_per_frame], frame));
+    i = (i + 1) % kNumFrames;
+  }
+  SetFrameCounters(state, params.s16NumOfBlocks * params.s16NumOfSubBands /
+                              44100.0);
+}
+
+BENCHMARK(BM_SbcEncode)
+    ->ArgNames({"mode", "subbands", "kbps"})
+    ->Args({SBC_JOINT_STEREO, 8, 328})
+    ->Args({SBC_STEREO, 8, 328})
+    ->Args({SBC_MONO, 8, 198})
+    ->Args({SBC_JOINT_STEREO, 4, 328});
+
+// mSBC as configured by the HFP encoder: 16 kHz mono, 8 subbands, 15 blocks
+// and bitpool 26. Like hfp_msbc_encoder_init(), SBC_Encoder_Init() is not
+// called as it would derive the bitpool from the bit rate.
+constexpr size_t kMsbcSamplesPerFrame = 120;
+
+SBC_ENC_PARAMS MsbcEncoderParams() {
+  SBC_ENC_PARAMS params = {};
+  params.s16SamplingFreq = SBC_sf16000;
+  params.s16ChannelMode = SBC_MONO;
+  params.s16NumOfSubBands = 8;
+  params.s16NumOfChannels = 1;
+  params.s16NumOfBlocks = 15;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.s16BitPool = 26;
+  params.Format = SBC_FORMAT_MSBC;
+  return params;
+}
+
+void BM_MsbcEncode(State& state) {
+  SBC_ENC_PARAMS params = MsbcEncoderParams();
+  auto pcm = MakeSignal(kMsbcSamplesPerFrame, 1);
+  uint8_t frame[kMaxSbcFrameBytes];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        SBC_Encode(&params, &pcm[i * kMsbcSamplesPerFrame], frame));
+    i = (i + 1) % kNumFrames;
+  }
+  SetFrameCounters(state, kMsbcSamplesPerFrame / 16000.0);
+}
+
+BENCHMARK(BM_MsbcEncode);
+
+void BM_MsbcDecode(State& state) {
+  SBC_ENC_PARAMS params = MsbcEncoderParams();
+  auto pcm = MakeSignal(kMsbcSamplesPerFrame, 1);
+  std::vector<uint8_t> frames(kNumFrames * kMaxSbcFrameBytes);
+  uint32_t frame_bytes = 0;
+  for (size_t i = 0; i < kNumFrames; i++) {
+    frame_bytes = SBC_Encode(&params, &pcm[i * kMsbcSamplesPerFrame],
+                             &frames[i * kMaxSbcFrameBytes]);
+  }
+
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  uint32_t context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)];
+  if (!OI_SUCCESS(OI_CODEC_SBC_DecoderReset(
+          &context, context_data, sizeof(context_data), 1, 1, false)) ||
+      !OI_SUCCESS(OI_CODEC_SBC_DecoderConfigureMSbc(&context))) {
+    state.SkipWithError("mSBC decoder setup failed");
+    return;
+  }
+
+  int16_t out[kMsbcSamplesPerFrame];
+  size_t i = 0;
+  for (auto _ : state) {
+    const OI_BYTE* data = &frames[i * kMaxSbcFrameBytes];
+    uint32_t bytes = frame_bytes;
+    uint32_t out_bytes = sizeof(out);
+    if (!OI_SUCCESS(OI_CODEC_SBC_DecodeFrame(&context, &data, &bytes, out,
+                                             &out_bytes))) {
+      state.SkipWithError("OI_CODEC_SBC_DecodeFrame failed");
+      return;
+    }
+    ::benchmark::DoNotOptimize(out);
+    i = (i + 1) % kNumFrames;
+  }
+  SetFrameCounters(state, kMsbcSamplesPerFrame / 16000.0);
+}
+
+BENCHMARK(BM_MsbcDecode);
+
+/*
+ * LC3
+ */
+
+// Two bits per sample, 16 kbps at 8 kHz up to 96 kbps at 48 kHz.
+int Lc3FrameBytes(int dt_us, int sr_hz) {
+  return lc3_frame_bytes(dt_us, sr_hz * 2);
+}
+
+// Encodes one mono LC3 frame per iteration, the arguments are the frame
+// duration in us and the sample rate in Hz.
+void BM_Lc3Encode(State& state) {
+  int dt_us = state.range(0);
+  int sr_hz = state.range(1);
+  int samples_per_frame = lc3_frame_samples(dt_us, sr_hz);
+  int nbytes = Lc3FrameBytes(dt_us, sr_hz);
+
+  std::vector<uint8_t> mem(lc3_encoder_size(dt_us, sr_hz));
+  lc3_encoder_t encoder = lc3_setup_encoder(dt_us, sr_hz, 0, mem.data());
+  auto pcm = MakeSignal(samples_per_frame, 1);
+  uint8_t frame[LC3_MAX_FRAME_BYTES];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(lc3_encode(encoder, LC3_PCM_FORMAT_S16,
+                                          &pcm[i * samples_per_frame], 1,
+                                          nbytes, frame));
+    i = (i + 1) % kNumFrames;
+  }
+  state.SetBytesProcessed(state.iterations() * nbytes);
+  SetFrameCounters(state, dt_us / 1e6);
+}
+
+// Decodes one mono LC3 frame per iteration, same arguments as BM_Lc3Encode.
+void BM_Lc3Decode(State& state) {
+  int dt_us = state.range(0);
+  int sr_hz = state.range(1);
+  int samples_per_frame = lc3_frame_samples(dt_us, sr_hz);
+  int nbytes = Lc3FrameBytes(dt_us, sr_hz);
+
+  std::vector<uint8_t> encoder_mem(lc3_encoder_size(dt_us, sr_hz));
+  lc3_encoder_t encoder =
+      lc3_setup_encoder(dt_us, sr_hz, 0, encoder_mem.data());
+  auto pcm = MakeSignal(samples_per_frame, 1);
+  std::vector<uint8_t> frames(kNumFrames * nbytes);
+  for (size_t i = 0; i < kNumFrames; i++) {
+    lc3_encode(encoder, LC3_PCM_FORMAT_S16, &pcm[i * samples_per_frame], 1,
+               nbytes, &frames[i * nbytes]);
+  }
+
+  std::vector<uint8_t> mem(lc3_decoder_size(dt_us, sr_hz));
+  lc3_decoder_t decoder = lc3_setup_decoder(dt_us, sr_hz, 0, mem.data());
+  std::vector<int16_t> out(samples_per_frame);
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(lc3_decode(decoder, &frames[i * nbytes],
+                                          nbytes, LC3_PCM_FORMAT_S16,
+                                          out.data(), 1));
+    i = (i + 1) % kNumFrames;
+  }
+  state.SetBytesProcessed(state.iterations() * nbytes);
+  SetFrameCounters(state, dt_us / 1e6);
+}
+
+BENCHMARK(BM_Lc3Encode)
+    ->ArgNames({"dt_us", "sr_hz"})
+    ->ArgsProduct({{7500, 10000}, {8000, 16000, 24000, 32000, 48000}});
+BENCHMARK(BM_Lc3Decode)
+    ->ArgNames({"dt_us", "sr_hz"})
+    ->ArgsProduct({{7500, 10000}, {8000, 16000, 24000, 32000, 48000}});
+
+/*
+ * G.722
+ */
+
+// 10 ms at 16 kHz, as sent by the hearing aid profile
+constexpr int kG722SamplesPerFrame = 160;
+
+void BM_G722Encode(State& state) {
+  g722_encode_state_t* encoder = g722_encode_init(nullptr, 64000, G722_PACKED);
+  auto pcm = MakeSignal(kG722SamplesPerFrame, 1);
+  uint8_t frame[kG722SamplesPerFrame / 2];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(g722_encode(
+        encoder, frame, &pcm[i * kG722SamplesPerFrame], kG722SamplesPerFrame));
+    i = (i + 1) % kNumFrames;
+  }
+  g722_encode_release(encoder);
+  SetFrameCounters(state, kG722SamplesPerFrame / 16000.0);
+}
+
+BENCHMARK(BM_G722Encode);
+
+// Encodes the two channels of an interleaved stereo frame
+void BM_G722EncodeStereo(State& state) {
+  g722_encode_state_t* left = g722_encode_init(nullptr, 64000, G722_PACKED);
+  g722_encode_state_t* right = g722_encode_init(nullptr, 64000, G722_PACKED);
+  auto pcm = MakeSignal(2 * kG722SamplesPerFrame, 2);
+  uint8_t frame_left[kG722SamplesPerFrame / 2];
+  uint8_t frame_right[kG722SamplesPerFrame / 2];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(g722_encode_stereo(
+        left, right, frame_left, frame_right,
+        &pcm[i * 2 * kG722SamplesPerFrame], kG722SamplesPerFrame));
+    i = (i + 1) % kNumFrames;
+  }
+  g722_encode_release(left);
+  g722_encode_release(right);
+  SetFrameCounters(state, kG722SamplesPerFrame / 16000.0);
+}
+
+BENCHMARK(BM_G722EncodeStereo);
+
+void BM_G722Decode(State& state) {
+  g722_encode_state_t* encoder = g722_encode_init(nullptr, 64000, G722_PACKED);
+  auto pcm = MakeSignal(kG722SamplesPerFrame, 1);
+  std::vector<uint8_t> frames(kNumFrames * kG722SamplesPerFrame / 2);
+  g722_encode(encoder, frames.data(), pcm.data(), pcm.size());
+  g722_encode_release(encoder);
+
+  g722_decode_state_t* decoder = g722_decode_init(nullptr, 64000, G722_PACKED);
+  int16_t out[kG722SamplesPerFrame];
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        g722_decode(decoder, out, &frames[i * kG722SamplesPerFrame / 2],
+                    kG722SamplesPerFrame / 2, 0xffff));
+    i = (i + 1) % kNumFrames;
+  }
+  g722_decode_release(decoder);
+  SetFrameCounters(state, kG722SamplesPerFrame / 16000.0);
+}
+
+BENCHMARK(BM_G722Decode);
+
+/*
+ * aptX and aptX HD
+ */
+
+// The encoders take 4 samples of each channel per call, a frame is 512
+// samples of each channel, about 11.6 ms at 44.1 kHz.
+constexpr size_t kAptxSamplesPerFrame = 512;
+
+void BM_AptxEncode(State& state) {
+  void* encoder = malloc(SizeofAptxbtenc());
+  aptxbtenc_init(encoder, 0);
+  auto pcm = MakeSignal(2 * kAptxSamplesPerFrame, 2);
+  size_t i = 0;
+  for (auto _ : state) {
+    const int16_t* frame = &pcm[i * 2 * kAptxSamplesPerFrame];
+    for (size_t j = 0; j < kAptxSamplesPerFrame; j += 4, frame += 8) {
+      int32_t pcm_left[4], pcm_right[4];
+      for (size_t k = 0; k < 4; k++) {
+        pcm_left[k] = frame[2 * k];
+        pcm_right[k] = frame[2 * k + 1];
+      }
+      uint16_t codeword[2];
+      aptxbtenc_encodestereo(encoder, pcm_left, pcm_right, codeword);
+      ::benchmark::DoNotOptimize(codeword);
+    }
+    i = (i + 1) % kNumFrames;
+  }
+  free(encoder);
+  SetFrameCounters(state, kAptxSamplesPerFrame / 44100.0);
+}
+
+BENCHMARK(BM_AptxEncode);
+
+void BM_AptxHdEncode(State& state) {
+  void* encoder = malloc(SizeofAptxhdbtenc());
+  aptxhdbtenc_init(encoder, 0);
+  auto pcm = MakeSignal(2 * kAptxSamplesPerFrame, 2);
+  size_t i = 0;
+  for (auto _ : state) {
+    const int16_t* frame = &pcm[i * 2 * kAptxSamplesPerFrame];
+    for (size_t j = 0; j < kAptxSamplesPerFrame; j += 4, frame += 8) {
+      // 24 bit samples
+      int32_t pcm_left[4], pcm_right[4];
+      for (size_t k = 0; k < 4; k++) {
+        pcm_left[k] = frame[2 * k] * 256;
+        pcm_right[k] = frame[2 * k + 1] * 256;
+      }
+      uint32_t codeword[2];
+      aptxhdbtenc_encodestereo(encoder, pcm_left, pcm_right, codeword);
+      ::benchmark::DoNotOptimize(codeword);
+    }
+    i = (i + 1) % kNumFrames;
+  }
+  free(encoder);
+  SetFrameCounters(state, kAptxSamplesPerFrame / 44100.0);
+}
+
+BENCHMARK(BM_AptxHdEncode);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::AddCustomContext("arch", kArch);
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <cmath>
+#include <vector>
+
+#include "g722_typedefs.h"
+#include "g722_enc_dec.h"
+
+class LibG722EncTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    for (auto** s : {&mono_left, &mono_right, &stereo_left, &stereo_right}) {
+      *s = g722_encode_init(nullptr, 64000, G722_PACKED);
+      ASSERT_NE(*s, nullptr);
+    }
+  }
+
+  void TearDown() override {
+    for (auto* s : {mono_left, mono_right, stereo_left, stereo_right})
+      g722_encode_release(s);
+  }
+
+  // Encodes the interleaved samples with g722_encode_stereo(), and each
+  // channel separately with g722_encode(), and compares the outputs.
+  void encode_cmp(const std::vector<int16_t>& pcm) {
+    const int len = pcm.size() / 2;
+    std::vector<int16_t> left(len), right(len);
+    for (int i = 0; i < len; i++) {
+      left[i] = pcm[2 * i];
+      right[i] = pcm[2 * i + 1];
+    }
+
+    std::vector<uint8_t> out_left(len), out_right(len);
+    ASSERT_EQ(g722_encode(mono_left, out_left.data(), left.data(), len),
+              len / 2);
+    ASSERT_EQ(g722_encode(mono_right, out_right.data(), right.data(), len),
+              len / 2);
+
+    std::vector<uint8_t> stereo_out_left(len), stereo_out_right(len);
+    ASSERT_EQ(g722_encode_stereo(stereo_left, stereo_right,
+                                 stereo_out_left.data(),
+                                 stereo_out_right.data(), pcm.data(), len),
+              len / 2);
+
+    ASSERT_EQ(out_left, stereo_out_left);
+    ASSERT_EQ(out_right, stereo_out_right);
+  }
+
+  g722_encode_state_t* mono_left = nullptr;
+  g722_encode_state_t* mono_right = nullptr;
+  g722_encode_state_t* stereo_left = nullptr;
+  g722_encode_state_t* stereo_right = nullptr;
+};
+
+TEST_F(LibG722EncTest, stereo_encode_tones) {
+  std::vector<int16_t> pcm(2 * 320);
+  for (int frame = 0; frame < 100; frame++) {
+    for (size_t i = 0; i < pcm.size() / 2; i++) {
+      size_t t = frame * pcm.size() / 2 + i;
+      pcm[2 * i] = 12000 * std::sin(t * 0.11) + 4000 * std::sin(t * 1.9);
+      pcm[2 * i + 1] = 16000 * std::sin(t * 0.37);
+    }
+    encode_cmp(pcm);
+  }
+}
+
+TEST_F(LibG722EncTest, stereo_encode_full_scale_noise) {
+  srand(0x722);
+  for (int len : {2, 160, 320, 1000, 64, 482}) {
+    std::vector<int16_t> pcm(2 * len);
+    for (auto& sample : pcm) sample = rand() & 0xffff;
+    encode_cmp(pcm);
+  }
+}
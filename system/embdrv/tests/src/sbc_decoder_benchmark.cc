@@ -0,0 +1,118 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "embdrv/sbc/decoder/include/oi_codec_sbc.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kNumFrames = 256;
+constexpr size_t kMaxFrameBytes = 512;
+constexpr size_t kMaxSamplesPerFrame = 16 * 8 * 2;
+
+// A stream of SBC frames encoded from a two tone signal, with the encoder
+// configuration of the benchmark arguments.
+struct EncodedStream {
+  std::vector<uint8_t> data;
+  uint32_t samples_per_frame;
+};
+
+EncodedStream EncodeStream(int16_t channel_mode, int16_t subbands,
+                           uint16_t bitrate_kbps) {
+  SBC_ENC_PARAMS params = {};
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = channel_mode;
+  params.s16NumOfSubBands = subbands;
+  params.s16NumOfChannels = channel_mode == SBC_MONO ? 1 : 2;
+  params.s16NumOfBlocks = 16;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = bitrate_kbps;
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  EncodedStream stream;
+  stream.samples_per_frame = params.s16NumOfBlocks * params.s16NumOfSubBands *
+                             params.s16NumOfChannels;
+
+  std::vector<int16_t> pcm(kMaxSamplesPerFrame);
+  uint8_t frame[kMaxFrameBytes];
+  size_t t = 0;
+  for (size_t i = 0; i < kNumFrames; i++) {
+    for (size_t j = 0; j < stream.samples_per_frame; j++, t++) {
+      pcm[j] = static_cast<int16_t>(8000 * std::sin(t * 0.031) +
+                                    6000 * std::sin(t * 0.47));
+    }
+    uint32_t length = SBC_Encode(&params, pcm.data(), frame);
+    stream.data.insert(stream.data.end(), frame, frame + length);
+  }
+  return stream;
+}
+
+// Decodes |kNumFrames| SBC frames per iteration, the arguments are the
+// SBC channel mode, number of subbands and bit rate in kbps.
+void BM_SbcDecode(State& state) {
+  EncodedStream stream =
+      EncodeStream(state.range(0), state.range(1), state.range(2));
+
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  uint32_t context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)];
+  if (!OI_SUCCESS(OI_CODEC_SBC_DecoderReset(
+          &context, context_data, sizeof(context_data), 2, 2, false))) {
+    state.SkipWithError("OI_CODEC_SBC_DecoderReset failed");
+    return;
+  }
+
+  std::vector<int16_t> pcm(kMaxSamplesPerFrame);
+  for (auto _ : state) {
+    const OI_BYTE* data = stream.data.data();
+    uint32_t bytes = stream.data.size();
+    while (bytes > 0) {
+      uint32_t pcm_bytes = pcm.size() * sizeof(int16_t);
+      if (!OI_SUCCESS(OI_CODEC_SBC_DecodeFrame(&context, &data, &bytes,
+                                               pcm.data(), &pcm_bytes))) {
+        state.SkipWithError("OI_CODEC_SBC_DecodeFrame failed");
+        return;
+      }
+    }
+    ::benchmark::DoNotOptimize(pcm.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumFrames);
+  state.SetBytesProcessed(state.iterations() * stream.data.size());
+  state.counters["samples_per_second"] = ::benchmark::Counter(
+      static_cast<double>(state.iterations()) * kNumFrames *
+          stream.samples_per_frame,
+      ::benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_SbcDecode)
+    ->ArgNames({"mode", "subbands", "kbps"})
+    ->Args({SBC_JOINT_STEREO, 8, 328})
+    ->Args({SBC_STEREO, 8, 328})
+    ->Args({SBC_MONO, 8, 198})
+    ->Args({SBC_JOINT_STEREO, 4, 328});
+
+}  // namespace
+
+BENCHMARK_MAIN();
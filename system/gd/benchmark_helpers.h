@@ -0,0 +1,73 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace bluetooth {
+namespace benchmark {
+
+// Number of calls to operator new made by the whole process so far, counted by benchmark.cc
+uint64_t GetAllocationCount();
+
+// Reports throughput, average time per packet and heap allocations per packet for a data path benchmark.
+// Create it right before the timed loop and call Report() right after it, so that only the loop is counted.
+class PacketCounters {
+ public:
+  explicit PacketCounters(::benchmark::State& state) : state_(state), start_allocations_(GetAllocationCount()) {}
+
+  void Report(int64_t packets_per_iteration, int64_t bytes_per_packet) {
+    int64_t packets = state_.iterations() * packets_per_iteration;
+    uint64_t allocations = GetAllocationCount() - start_allocations_;
+    state_.SetItemsProcessed(packets);
+    state_.SetBytesProcessed(packets * bytes_per_packet);
+    state_.counters["time_per_packet"] =
+        ::benchmark::Counter(packets, ::benchmark::Counter::kIsRate | ::benchmark::Counter::kInvert);
+    state_.counters["allocs_per_packet"] = packets > 0 ? static_cast<double>(allocations) / packets : 0;
+  }
+
+ private:
+  ::benchmark::State& state_;
+  const uint64_t start_allocations_;
+};
+
+// Lets the benchmark thread wait for packets handled on another thread
+class CompletionCounter {
+ public:
+  void Add(uint64_t count = 1) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_ += count;
+    cv_.notify_all();
+  }
+
+  // Block until at least |total| packets were completed since construction
+  void WaitFor(uint64_t total) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, total] { return completed_ >= total; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t completed_ = 0;
+};
+
+}  // namespace benchmark
+}  // namespace bluetooth
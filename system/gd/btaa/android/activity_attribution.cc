@@ -137,8 +137,11 @@ struct ActivityAttribution::impl {
     g_module = nullptr;
   }
 
-  void on_hci_packet(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length) {
-    attribution_processor_.OnBtaaPackets(std::move(hci_processor_.OnHciPacket(std::move(packet), type, length)));
+  void on_hci_packet(std::shared_ptr<const hal::HciPacket> packet, hal::SnoopLogger::PacketType type, uint16_t length) {
+    auto packet_view = packet::PacketView<packet::kLittleEndian>(std::move(packet));
+    btaa_hci_packets_.clear();
+    hci_processor_.OnHciPacket(packet_view, type, length, btaa_hci_packets_);
+    attribution_processor_.OnBtaaPackets(btaa_hci_packets_);
   }
 
   void on_wakelock_acquired() {
@@ -175,6 +178,8 @@ struct ActivityAttribution::impl {
   AttributionProcessor attribution_processor_;
   HciProcessor hci_processor_;
   WakelockProcessor wakelock_processor_;
+  // Reused for every captured packet so the classification does not allocate
+  std::vector<BtaaHciPacket> btaa_hci_packets_;
 };
 
 void ActivityAttribution::Capture(const hal::HciPacket& packet, hal::SnoopLogger::PacketType type) {
@@ -197,8 +202,9 @@ void ActivityAttribution::Capture(const hal::HciPacket& packet, hal::SnoopLogger
     return;
   }
 
-  hal::HciPacket truncate_packet(packet.begin(), packet.begin() + truncate_length);
-  CallOn(pimpl_.get(), &impl::on_hci_packet, truncate_packet, type, original_length);
+  // Copy the truncated packet once; the module thread parses it in place
+  auto truncate_packet = std::make_shared<const hal::HciPacket>(packet.begin(), packet.begin() + truncate_length);
+  CallOn(pimpl_.get(), &impl::on_hci_packet, std::move(truncate_packet), type, original_length);
 }
 
 void ActivityAttribution::OnWakelockAcquired() {
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <unordered_map>
 
@@ -25,6 +26,10 @@ namespace bluetooth {
 namespace activity_attribution {
 
 static constexpr size_t kWakeupAggregatorSize = 200;
+// Device-activity pairs accounted between two wakelock releases. Further pairs are accounted per activity, without an
+// address, until the next release flushes the table.
+static constexpr size_t kWakelockDurationAggregatorSize = 64;
+static constexpr size_t kActivityCount = static_cast<size_t>(Activity::VENDOR) + 1;
 
 struct AddressActivityKey {
   hci::Address address;
@@ -38,7 +43,7 @@ struct AddressActivityKey {
 struct AddressActivityKeyHasher {
   std::size_t operator()(const AddressActivityKey& key) const {
     return (
-        (std::hash<std::string>()(key.address.ToString()) ^
+        (std::hash<hci::Address>()(key.address) ^
          (std::hash<unsigned char>()(static_cast<unsigned char>(key.activity)))));
   }
 };
@@ -75,7 +80,7 @@ struct AppWakeupDescriptor {
 
 class AttributionProcessor {
  public:
-  void OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets);
+  void OnBtaaPackets(const std::vector<BtaaHciPacket>& btaa_packets);
   void OnWakelockReleased(uint32_t duration_ms);
   void OnWakeup();
   void NotifyActivityAttributionInfo(int uid, const std::string& package_name, const std::string& device_address);
@@ -98,7 +103,10 @@ class AttributionProcessor {
   NowFunc now_func_ = std::chrono::system_clock::now;
   bool wakeup_ = false;
   std::unordered_map<AddressActivityKey, BtaaAggregationEntry, AddressActivityKeyHasher> btaa_aggregator_;
-  std::unordered_map<AddressActivityKey, BtaaAggregationEntry, AddressActivityKeyHasher> wakelock_duration_aggregator_;
+  // Every HCI packet is accounted here, so this is a fixed table rather than a map
+  std::array<BtaaAggregationEntry, kWakelockDurationAggregatorSize> wakelock_duration_aggregator_ = {};
+  size_t wakelock_duration_aggregator_size_ = 0;
+  std::array<BtaaAggregationEntry, kActivityCount> wakelock_duration_overflow_ = {};
   std::unordered_map<std::string, std::string> address_app_map_;
   std::unordered_map<AppActivityKey, BtaaAggregationEntry, AppActivityKeyHasher> app_activity_aggregator_;
   common::TimestampedCircularBuffer<DeviceWakeupDescriptor> device_wakeup_aggregator_ =
@@ -106,6 +114,9 @@ class AttributionProcessor {
   common::TimestampedCircularBuffer<AppWakeupDescriptor> app_wakeup_aggregator_ =
       common::TimestampedCircularBuffer<AppWakeupDescriptor>(kWakeupAggregatorSize);
   const char* ActivityToString(Activity activity);
+  BtaaAggregationEntry& GetWakelockDurationEntry(const hci::Address& address, Activity activity);
+  void FlushWakelockDurationEntry(
+      const BtaaAggregationEntry& entry, uint32_t duration_ms, uint32_t total_byte_count, ClockType cur_time);
 };
 
 }  // namespace activity_attribution
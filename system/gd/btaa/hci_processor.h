@@ -49,7 +49,13 @@ struct PendingCommand {
 
 class HciProcessor {
  public:
-  std::vector<BtaaHciPacket> OnHciPacket(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length);
+  // Classifies |packet| and appends the resulting entries to |btaa_hci_packets|. The view shares the caller's buffer
+  // and the output vector is owned by the caller, so a hot packet path can reuse both without any allocation.
+  void OnHciPacket(
+      packet::PacketView<packet::kLittleEndian>& packet,
+      hal::SnoopLogger::PacketType type,
+      uint16_t length,
+      std::vector<BtaaHciPacket>& btaa_hci_packets);
 
  private:
   void process_le_event(std::vector<BtaaHciPacket>& btaa_hci_packets, int16_t byte_count, hci::EventView& event);
@@ -32,20 +32,32 @@ static const int kByteCountTransientDeviceActivityEntry = 200;
 static const int kDurationTransientDeviceActivityEntrySecs = 900;
 static const int kMapSizeTrimDownAggregationEntry = 200;
 
-void AttributionProcessor::OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets) {
-  AddressActivityKey key;
+BtaaAggregationEntry& AttributionProcessor::GetWakelockDurationEntry(const hci::Address& address, Activity activity) {
+  for (size_t i = 0; i < wakelock_duration_aggregator_size_; i++) {
+    auto& entry = wakelock_duration_aggregator_[i];
+    if (entry.activity == activity && entry.address == address) {
+      return entry;
+    }
+  }
+  if (wakelock_duration_aggregator_size_ < kWakelockDurationAggregatorSize) {
+    auto& entry = wakelock_duration_aggregator_[wakelock_duration_aggregator_size_++];
+    entry = {};
+    entry.address = address;
+    entry.activity = activity;
+    return entry;
+  }
+  auto& entry = wakelock_duration_overflow_[static_cast<size_t>(activity)];
+  entry.activity = activity;
+  return entry;
+}
 
+void AttributionProcessor::OnBtaaPackets(const std::vector<BtaaHciPacket>& btaa_packets) {
   for (auto& btaa_packet : btaa_packets) {
-    key.address = btaa_packet.address;
-    key.activity = btaa_packet.activity;
-
-    if (wakelock_duration_aggregator_.find(key) == wakelock_duration_aggregator_.end()) {
-      wakelock_duration_aggregator_[key] = {};
-    }
-    wakelock_duration_aggregator_[key].byte_count += btaa_packet.byte_count;
+    auto& entry = GetWakelockDurationEntry(btaa_packet.address, btaa_packet.activity);
+    entry.byte_count += btaa_packet.byte_count;
 
     if (wakeup_) {
-      wakelock_duration_aggregator_[key].wakeup_count += 1;
+      entry.wakeup_count += 1;
       device_wakeup_aggregator_.Push(std::move(DeviceWakeupDescriptor(btaa_packet.activity, btaa_packet.address)));
       std::string package_info = kUnknownPackageInfo;
       std::string address = btaa_packet.address.ToString();
@@ -58,67 +70,83 @@ void AttributionProcessor::OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets
   wakeup_ = false;
 }
 
-void AttributionProcessor::OnWakelockReleased(uint32_t duration_ms) {
-  uint32_t total_byte_count = 0;
+void AttributionProcessor::FlushWakelockDurationEntry(
+    const BtaaAggregationEntry& entry, uint32_t duration_ms, uint32_t total_byte_count, ClockType cur_time) {
+  AddressActivityKey device_key;
+  device_key.address = entry.address;
+  device_key.activity = entry.activity;
+  uint32_t wakelock_duration_ms = (uint64_t)duration_ms * entry.byte_count / total_byte_count;
+  if (btaa_aggregator_.find(device_key) == btaa_aggregator_.end()) {
+    btaa_aggregator_[device_key] = {};
+    btaa_aggregator_[device_key].creation_time = cur_time;
+  }
 
-  for (auto& it : wakelock_duration_aggregator_) {
-    total_byte_count += it.second.byte_count;
+  auto elapsed_time_sec =
+      std::chrono::duration_cast<std::chrono::seconds>(cur_time - btaa_aggregator_[device_key].creation_time).count();
+  if (elapsed_time_sec > kDurationToKeepDeviceActivityEntrySecs) {
+    btaa_aggregator_[device_key].wakeup_count = 0;
+    btaa_aggregator_[device_key].byte_count = 0;
+    btaa_aggregator_[device_key].wakelock_duration_ms = 0;
+    btaa_aggregator_[device_key].creation_time = cur_time;
   }
 
-  if (total_byte_count == 0) {
-    return;
+  btaa_aggregator_[device_key].wakeup_count += entry.wakeup_count;
+  btaa_aggregator_[device_key].byte_count += entry.byte_count;
+  btaa_aggregator_[device_key].wakelock_duration_ms += wakelock_duration_ms;
+
+  std::string address = entry.address.ToString();
+  std::string package_info = kUnknownPackageInfo;
+  if (address_app_map_.find(address) != address_app_map_.end()) {
+    package_info = address_app_map_[address];
   }
+  AppActivityKey key;
+  key.app = package_info;
+  key.activity = entry.activity;
 
-  auto cur_time = now_func_();
-  for (auto& it : wakelock_duration_aggregator_) {
-    it.second.wakelock_duration_ms = (uint64_t)duration_ms * it.second.byte_count / total_byte_count;
-    if (btaa_aggregator_.find(it.first) == btaa_aggregator_.end()) {
-      btaa_aggregator_[it.first] = {};
-      btaa_aggregator_[it.first].creation_time = cur_time;
-    }
+  if (app_activity_aggregator_.find(key) == app_activity_aggregator_.end()) {
+    app_activity_aggregator_[key] = {};
+    app_activity_aggregator_[key].creation_time = cur_time;
+  }
 
-    auto elapsed_time_sec =
-        std::chrono::duration_cast<std::chrono::seconds>(cur_time - btaa_aggregator_[it.first].creation_time).count();
-    if (elapsed_time_sec > kDurationToKeepDeviceActivityEntrySecs) {
-      btaa_aggregator_[it.first].wakeup_count = 0;
-      btaa_aggregator_[it.first].byte_count = 0;
-      btaa_aggregator_[it.first].wakelock_duration_ms = 0;
-      btaa_aggregator_[it.first].creation_time = cur_time;
-    }
+  elapsed_time_sec =
+      std::chrono::duration_cast<std::chrono::seconds>(cur_time - app_activity_aggregator_[key].creation_time).count();
+  if (elapsed_time_sec > kDurationToKeepDeviceActivityEntrySecs) {
+    app_activity_aggregator_[key].wakeup_count = 0;
+    app_activity_aggregator_[key].byte_count = 0;
+    app_activity_aggregator_[key].wakelock_duration_ms = 0;
+    app_activity_aggregator_[key].creation_time = cur_time;
+  }
 
-    btaa_aggregator_[it.first].wakeup_count += it.second.wakeup_count;
-    btaa_aggregator_[it.first].byte_count += it.second.byte_count;
-    btaa_aggregator_[it.first].wakelock_duration_ms += it.second.wakelock_duration_ms;
+  app_activity_aggregator_[key].wakeup_count += entry.wakeup_count;
+  app_activity_aggregator_[key].byte_count += entry.byte_count;
+  app_activity_aggregator_[key].wakelock_duration_ms += wakelock_duration_ms;
+}
 
-    std::string address = it.first.address.ToString();
-    std::string package_info = kUnknownPackageInfo;
-    if (address_app_map_.find(address) != address_app_map_.end()) {
-      package_info = address_app_map_[address];
-    }
-    AppActivityKey key;
-    key.app = package_info;
-    key.activity = it.first.activity;
+void AttributionProcessor::OnWakelockReleased(uint32_t duration_ms) {
+  uint32_t total_byte_count = 0;
 
-    if (app_activity_aggregator_.find(key) == app_activity_aggregator_.end()) {
-      app_activity_aggregator_[key] = {};
-      app_activity_aggregator_[key].creation_time = cur_time;
-    }
+  for (size_t i = 0; i < wakelock_duration_aggregator_size_; i++) {
+    total_byte_count += wakelock_duration_aggregator_[i].byte_count;
+  }
+  for (auto& entry : wakelock_duration_overflow_) {
+    total_byte_count += entry.byte_count;
+  }
 
-    elapsed_time_sec =
-        std::chrono::duration_cast<std::chrono::seconds>(cur_time - app_activity_aggregator_[key].creation_time)
-            .count();
-    if (elapsed_time_sec > kDurationToKeepDeviceActivityEntrySecs) {
-      app_activity_aggregator_[key].wakeup_count = 0;
-      app_activity_aggregator_[key].byte_count = 0;
-      app_activity_aggregator_[key].wakelock_duration_ms = 0;
-      app_activity_aggregator_[key].creation_time = cur_time;
-    }
+  if (total_byte_count == 0) {
+    return;
+  }
 
-    app_activity_aggregator_[key].wakeup_count += it.second.wakeup_count;
-    app_activity_aggregator_[key].byte_count += it.second.byte_count;
-    app_activity_aggregator_[key].wakelock_duration_ms += it.second.wakelock_duration_ms;
+  auto cur_time = now_func_();
+  for (size_t i = 0; i < wakelock_duration_aggregator_size_; i++) {
+    FlushWakelockDurationEntry(wakelock_duration_aggregator_[i], duration_ms, total_byte_count, cur_time);
+  }
+  for (auto& entry : wakelock_duration_overflow_) {
+    if (entry.byte_count != 0 || entry.wakeup_count != 0) {
+      FlushWakelockDurationEntry(entry, duration_ms, total_byte_count, cur_time);
+    }
   }
-  wakelock_duration_aggregator_.clear();
+  wakelock_duration_aggregator_size_ = 0;
+  wakelock_duration_overflow_ = {};
 
   if (btaa_aggregator_.size() <= kMapSizeTrimDownAggregationEntry &&
       app_activity_aggregator_.size() <= kMapSizeTrimDownAggregationEntry) {
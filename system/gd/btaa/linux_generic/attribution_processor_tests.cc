@@ -20,9 +20,11 @@
 
 #include <chrono>
 #include <functional>
+#include <future>
 #include <memory>
 #include <vector>
 
+#include "activity_attribution_generated.h"
 #include "btaa/activity_attribution.h"
 #include "btaa/attribution_processor.h"
 
@@ -45,7 +47,17 @@ class AttributionProcessorTest : public ::testing::Test {
     pAttProc.reset();
   }
 
+  const ActivityAttributionData* Dump() {
+    std::promise<flatbuffers::Offset<ActivityAttributionData>> promise;
+    fb_builder.Clear();
+    auto future = promise.get_future();
+    pAttProc->Dump(std::move(promise), &fb_builder);
+    fb_builder.Finish(future.get());
+    return flatbuffers::GetRoot<ActivityAttributionData>(fb_builder.GetBufferPointer());
+  }
+
   std::unique_ptr<AttributionProcessor> pAttProc;
+  flatbuffers::FlatBufferBuilder fb_builder;
 };
 
 static void fake_now_set_current() {
@@ -83,3 +95,74 @@ TEST_F(AttributionProcessorTest, UAFInOnWakelockReleasedRegressionTest) {
   pAttProc->OnBtaaPackets(btaaPackets);
   pAttProc->OnWakelockReleased(100);
 }
+
+TEST_F(AttributionProcessorTest, AccountsPacketsPerDeviceActivity) {
+  std::vector<BtaaHciPacket> btaaPackets;
+  Address addr1, addr2;
+  ASSERT_TRUE(Address::FromString("21:43:65:87:a9:01", addr1));
+  ASSERT_TRUE(Address::FromString("21:43:65:87:a9:02", addr2));
+
+  fake_now_set_current();
+  btaaPackets.push_back(BtaaHciPacket(Activity::ACL, addr1, 100));
+  btaaPackets.push_back(BtaaHciPacket(Activity::ACL, addr1, 200));
+  btaaPackets.push_back(BtaaHciPacket(Activity::SCAN, addr1, 100));
+  pAttProc->OnBtaaPackets(btaaPackets);
+  btaaPackets.clear();
+  btaaPackets.push_back(BtaaHciPacket(Activity::ACL, addr2, 400));
+  pAttProc->OnBtaaPackets(btaaPackets);
+  pAttProc->OnWakelockReleased(800);
+
+  auto data = Dump();
+  ASSERT_EQ(data->num_device_activity(), 3);
+  for (auto entry : *data->device_activity_aggregation()) {
+    if (entry->address()->str() == addr1.ToString() && entry->activity()->str() == "Activity::ACL") {
+      EXPECT_EQ(entry->byte_count(), 300);
+      EXPECT_EQ(entry->wakelock_duration_ms(), 300);
+    } else if (entry->address()->str() == addr1.ToString()) {
+      EXPECT_EQ(entry->activity()->str(), "Activity::SCAN");
+      EXPECT_EQ(entry->byte_count(), 100);
+      EXPECT_EQ(entry->wakelock_duration_ms(), 100);
+    } else {
+      EXPECT_EQ(entry->address()->str(), addr2.ToString());
+      EXPECT_EQ(entry->byte_count(), 400);
+      EXPECT_EQ(entry->wakelock_duration_ms(), 400);
+    }
+  }
+}
+
+TEST_F(AttributionProcessorTest, DevicesBeyondTableCapacityAreStillAccounted) {
+  std::vector<BtaaHciPacket> btaaPackets;
+  Address addr;
+  const size_t device_count = kWakelockDurationAggregatorSize + 10;
+
+  fake_now_set_current();
+  for (size_t i = 0; i < device_count; i++) {
+    ASSERT_TRUE(Address::FromString(base::StringPrintf("21:43:65:87:a9:%02zx", i + 1), addr));
+    btaaPackets.push_back(BtaaHciPacket(Activity::ACL, addr, 10));
+  }
+  pAttProc->OnBtaaPackets(btaaPackets);
+  pAttProc->OnWakelockReleased(device_count * 10);
+
+  // The devices that did not fit share one entry without an address
+  auto data = Dump();
+  ASSERT_EQ(data->num_device_activity(), static_cast<int>(kWakelockDurationAggregatorSize + 1));
+  int byte_count = 0;
+  int wakelock_duration_ms = 0;
+  for (auto entry : *data->device_activity_aggregation()) {
+    if (entry->address()->str() == Address::kEmpty.ToString()) {
+      EXPECT_EQ(entry->byte_count(), 100);
+    }
+    byte_count += entry->byte_count();
+    wakelock_duration_ms += entry->wakelock_duration_ms();
+  }
+  EXPECT_EQ(byte_count, static_cast<int>(device_count * 10));
+  EXPECT_EQ(wakelock_duration_ms, static_cast<int>(device_count * 10));
+
+  // The table is flushed on release, so the next period starts from an empty table
+  btaaPackets.resize(1);
+  pAttProc->OnBtaaPackets(btaaPackets);
+  pAttProc->OnWakelockReleased(10);
+  data = Dump();
+  ASSERT_EQ(data->num_device_activity(), 1);
+  EXPECT_EQ(data->device_activity_aggregation()->Get(0)->byte_count(), 10);
+}
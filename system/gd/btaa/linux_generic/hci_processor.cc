@@ -240,10 +240,11 @@ void HciProcessor::process_iso(
   btaa_hci_packets.push_back(BtaaHciPacket(Activity::ISO, address_value, byte_count));
 }
 
-std::vector<BtaaHciPacket> HciProcessor::OnHciPacket(
-    hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length) {
-  std::vector<BtaaHciPacket> btaa_hci_packets;
-  auto packet_view = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(packet));
+void HciProcessor::OnHciPacket(
+    packet::PacketView<packet::kLittleEndian>& packet_view,
+    hal::SnoopLogger::PacketType type,
+    uint16_t length,
+    std::vector<BtaaHciPacket>& btaa_hci_packets) {
   switch (type) {
     case hal::SnoopLogger::PacketType::CMD:
       process_command(btaa_hci_packets, packet_view, length);
@@ -261,7 +262,6 @@ std::vector<BtaaHciPacket> HciProcessor::OnHciPacket(
       process_iso(btaa_hci_packets, packet_view, length);
       break;
   }
-  return btaa_hci_packets;
 }
 
 }  // namespace activity_attribution
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace bluetooth {
+namespace common {
+
+// Buffers on the GD data paths come from std::vector rather than the osi allocator, so an allocation profiler cannot
+// see them. Hot paths report their buffer allocations here instead, under a |site| name with static storage. Without
+// a hook installed this is a single relaxed load.
+using AllocationHook = void (*)(const char* site, size_t bytes);
+
+inline std::atomic<AllocationHook> allocation_hook{nullptr};
+
+inline void SetAllocationHook(AllocationHook hook) {
+  allocation_hook.store(hook, std::memory_order_relaxed);
+}
+
+inline void NotifyAllocation(const char* site, size_t bytes) {
+  AllocationHook hook = allocation_hook.load(std::memory_order_relaxed);
+  if (hook != nullptr) {
+    hook(site, bytes);
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -16,11 +16,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <type_traits>
+#include <vector>
 
 namespace bluetooth {
 namespace common {
@@ -78,6 +84,47 @@ class TimestampedCircularBuffer : public CircularBuffer<TimestampedEntry<T>> {
   std::unique_ptr<Timestamper> timestamper_{std::make_unique<TimestamperInMilliseconds>()};
 };
 
+// Fixed capacity alternative to TimestampedCircularBuffer for histories written from hot paths. All slots are
+// allocated up front, Push() is wait-free and readers never block writers. Entries are copied in and out bytewise,
+// so T has to be trivially copyable (use a fixed size char array instead of a std::string).
+//
+// Each slot carries a sequence number: odd while a writer fills it, 2 * (ticket + 1) once it holds the entry of
+// that ticket. A reader keeps an entry only if the sequence was the expected one before and after copying it, so
+// an entry overwritten during a snapshot is skipped rather than returned torn. A writer that laps a slot still being
+// written by a slower one drops its entry; Dropped() counts those.
+template <typename T>
+class LockFreeTimestampedCircularBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "entries are copied bytewise");
+
+ public:
+  explicit LockFreeTimestampedCircularBuffer(
+      size_t size, std::unique_ptr<Timestamper> timestamper = std::make_unique<TimestamperInMilliseconds>());
+
+  void Push(const T& item);
+  // Calls |fn| with each entry of a snapshot of the buffer, oldest first, without allocating or locking
+  template <typename Fn>
+  void ForEach(Fn fn) const;
+  // Take a snapshot of the circular buffer and return it as a vector
+  std::vector<TimestampedEntry<T>> Pull() const;
+
+  size_t Size() const;
+  uint64_t Dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    TimestampedEntry<T> value;
+  };
+
+  const size_t size_;
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<Timestamper> timestamper_;
+  std::atomic<uint64_t> next_ticket_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
 }  // namespace common
 }  // namespace bluetooth
 
@@ -128,3 +175,66 @@ template <typename T>
 std::vector<struct bluetooth::common::TimestampedEntry<T>> bluetooth::common::TimestampedCircularBuffer<T>::Drain() {
   return bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Drain();
 }
+
+template <typename T>
+bluetooth::common::LockFreeTimestampedCircularBuffer<T>::LockFreeTimestampedCircularBuffer(
+    size_t size, std::unique_ptr<Timestamper> timestamper)
+    : size_(size), slots_(std::make_unique<Slot[]>(size)), timestamper_(std::move(timestamper)) {}
+
+template <typename T>
+void bluetooth::common::LockFreeTimestampedCircularBuffer<T>::Push(const T& item) {
+  if (size_ == 0) {
+    return;
+  }
+  TimestampedEntry<T> timestamped_entry{timestamper_->GetTimestamp(), item};
+  uint64_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[ticket % size_];
+
+  uint64_t writing = 2 * ticket + 1;
+  uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  // Give up instead of waiting if another writer owns the slot or a newer entry already landed in it
+  if ((sequence & 1) != 0 || sequence > writing ||
+      !slot.sequence.compare_exchange_strong(sequence, writing, std::memory_order_relaxed)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&slot.value, &timestamped_entry, sizeof(timestamped_entry));
+  slot.sequence.store(writing + 1, std::memory_order_release);
+}
+
+template <typename T>
+template <typename Fn>
+void bluetooth::common::LockFreeTimestampedCircularBuffer<T>::ForEach(Fn fn) const {
+  uint64_t end = next_ticket_.load(std::memory_order_acquire);
+  uint64_t begin = end > size_ ? end - size_ : 0;
+  for (uint64_t ticket = begin; ticket < end; ticket++) {
+    const Slot& slot = slots_[ticket % size_];
+    uint64_t expected = 2 * ticket + 2;
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+      continue;
+    }
+    TimestampedEntry<T> copy;
+    std::memcpy(&copy, &slot.value, sizeof(copy));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+      continue;
+    }
+    fn(copy);
+  }
+}
+
+template <typename T>
+std::vector<struct bluetooth::common::TimestampedEntry<T>>
+bluetooth::common::LockFreeTimestampedCircularBuffer<T>::Pull() const {
+  std::vector<TimestampedEntry<T>> items;
+  items.reserve(size_);
+  ForEach([&items](const TimestampedEntry<T>& entry) { items.push_back(entry); });
+  return items;
+}
+
+template <typename T>
+size_t bluetooth::common::LockFreeTimestampedCircularBuffer<T>::Size() const {
+  uint64_t pushed = next_ticket_.load(std::memory_order_relaxed);
+  return pushed < size_ ? pushed : size_;
+}
@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 #include <limits>
 #include <string>
+#include <thread>
 
 #include "common/circular_buffer.h"
 #include "os/log.h"
@@ -104,4 +105,75 @@ TEST(CircularBufferTest, max_timestamps) {
   }
 }
 
+TEST(CircularBufferTest, lock_free_simple) {
+  timestamp_ = 0;
+  bluetooth::common::LockFreeTimestampedCircularBuffer<int> buffer(10, std::make_unique<TestTimestamper>());
+
+  buffer.Push(1);
+  buffer.Push(2);
+  buffer.Push(3);
+
+  auto vec = buffer.Pull();
+  ASSERT_EQ(3ul, vec.size());
+  ASSERT_EQ(3ul, buffer.Size());
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(i + 1, vec[i].entry);
+    ASSERT_EQ(i, vec[i].timestamp);
+  }
+}
+
+TEST(CircularBufferTest, lock_free_wraps_around) {
+  bluetooth::common::LockFreeTimestampedCircularBuffer<int> buffer(10);
+
+  for (int i = 0; i < 25; i++) {
+    buffer.Push(i);
+  }
+
+  int expected = 15;
+  buffer.ForEach([&expected](const bluetooth::common::TimestampedEntry<int>& entry) {
+    ASSERT_EQ(expected, entry.entry);
+    expected++;
+  });
+  ASSERT_EQ(25, expected);
+  ASSERT_EQ(10ul, buffer.Size());
+  ASSERT_EQ(0ul, buffer.Dropped());
+}
+
+TEST(CircularBufferTest, lock_free_concurrent_push) {
+  struct Entry {
+    int writer;
+    int sequence;
+    int check;
+  };
+  bluetooth::common::LockFreeTimestampedCircularBuffer<Entry> buffer(64);
+  constexpr int kWriters = 4;
+  constexpr int kPushesPerWriter = 10000;
+
+  std::vector<std::thread> writers;
+  for (int writer = 0; writer < kWriters; writer++) {
+    writers.emplace_back([&buffer, writer] {
+      for (int i = 0; i < kPushesPerWriter; i++) {
+        buffer.Push(Entry{writer, i, writer ^ i});
+      }
+    });
+  }
+  // Snapshots taken while writing only ever contain complete entries
+  for (int i = 0; i < 100; i++) {
+    buffer.ForEach([](const bluetooth::common::TimestampedEntry<Entry>& entry) {
+      ASSERT_EQ(entry.entry.writer ^ entry.entry.sequence, entry.entry.check);
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  // Only the writes dropped on the last lap leave holes
+  auto vec = buffer.Pull();
+  ASSERT_LE(vec.size(), 64ul);
+  ASSERT_GE(vec.size() + buffer.Dropped(), 64ul);
+  for (const auto& entry : vec) {
+    ASSERT_EQ(entry.entry.writer ^ entry.entry.sequence, entry.entry.check);
+  }
+}
+
 }  // namespace testing
@@ -61,12 +61,15 @@ class ContextualOnceCallback<R(Args...)> {
 
  private:
   common::OnceCallback<R(Args...)> callback_;
-  IPostableContext* context_;
+  IPostableContext* context_ = nullptr;
 };
 
 template <typename R, typename... Args>
 class ContextualCallback;
 
+template <typename Sig>
+class ContextualCallbackList;
+
 // A callback bound to an execution context that can be invoked multiple times.
 template <typename R, typename... Args>
 class ContextualCallback<R(Args...)> {
@@ -96,8 +99,11 @@ class ContextualCallback<R(Args...)> {
   }
 
  private:
+  template <typename Sig>
+  friend class ContextualCallbackList;
+
   common::Callback<R(Args...)> callback_;
-  IPostableContext* context_;
+  IPostableContext* context_ = nullptr;
 };
 
 }  // namespace common
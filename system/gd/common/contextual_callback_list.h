@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/callback.h"
+#include "common/contextual_callback.h"
+
+namespace bluetooth {
+namespace common {
+
+// Callbacks of several listeners notified of the same events. The callbacks are grouped by their context, and a
+// notification posts a single closure to each context, which runs the callbacks of the context in the order they were
+// added.
+//
+// Adding or clearing callbacks replaces the list with a modified copy. A notification holds on to the current list
+// without taking the lock, so that it never waits for a registration.
+template <typename Sig>
+class ContextualCallbackList;
+
+template <typename... Args>
+class ContextualCallbackList<void(Args...)> {
+ public:
+  ContextualCallbackList() = default;
+  ContextualCallbackList(const ContextualCallbackList&) = delete;
+  ContextualCallbackList& operator=(const ContextualCallbackList&) = delete;
+
+  void Add(ContextualCallback<void(Args...)> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto groups = std::make_shared<Groups>(*std::atomic_load(&groups_));
+    auto group = groups->begin();
+    while (group != groups->end() && group->context != callback.context_) {
+      group++;
+    }
+    if (group == groups->end()) {
+      group = groups->insert(group, Group{callback.context_, {}});
+    }
+    group->callbacks.push_back(std::move(callback.callback_));
+    std::atomic_store(&groups_, std::shared_ptr<const Groups>(std::move(groups)));
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::atomic_store(&groups_, std::make_shared<const Groups>());
+  }
+
+  // The arguments are copied once for each context
+  void Notify(Args... args) const {
+    std::shared_ptr<const Groups> groups = std::atomic_load(&groups_);
+    for (size_t i = 0; i < groups->size(); i++) {
+      (*groups)[i].context->Post(common::BindOnce(&ContextualCallbackList::RunGroup, groups, i, args...));
+    }
+  }
+
+  // Number of closures posted by a notification
+  size_t NumContexts() const {
+    return std::atomic_load(&groups_)->size();
+  }
+
+ private:
+  struct Group {
+    IPostableContext* context;
+    std::vector<Callback<void(Args...)>> callbacks;
+  };
+  using Groups = std::vector<Group>;
+
+  static void RunGroup(std::shared_ptr<const Groups> groups, size_t index, Args... args) {
+    for (const auto& callback : (*groups)[index].callbacks) {
+      callback.Run(args...);
+    }
+  }
+
+  // Serializes the modifications only
+  std::mutex mutex_;
+  std::shared_ptr<const Groups> groups_ = std::make_shared<const Groups>();
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/contextual_callback_list.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+class QueuedContext : public IPostableContext {
+ public:
+  void Post(OnceClosure closure) override {
+    closures_.push_back(std::move(closure));
+  }
+
+  void RunAll() {
+    std::vector<OnceClosure> closures = std::move(closures_);
+    closures_.clear();
+    for (auto& closure : closures) {
+      std::move(closure).Run();
+    }
+  }
+
+  size_t NumPosted() const {
+    return closures_.size();
+  }
+
+ private:
+  std::vector<OnceClosure> closures_;
+};
+
+void Append(std::string* log, const std::string& name, int value) {
+  *log += name + ":" + std::to_string(value) + " ";
+}
+
+class ContextualCallbackListTest : public ::testing::Test {
+ protected:
+  void Add(const std::string& name, QueuedContext* context) {
+    list_.Add(ContextualCallback<void(int)>(Bind(&Append, Unretained(&log_), name), context));
+  }
+
+  ContextualCallbackList<void(int)> list_;
+  QueuedContext context_a_;
+  QueuedContext context_b_;
+  std::string log_;
+};
+
+TEST_F(ContextualCallbackListTest, one_closure_per_context) {
+  Add("a1", &context_a_);
+  Add("b1", &context_b_);
+  Add("a2", &context_a_);
+  ASSERT_EQ(list_.NumContexts(), 2u);
+
+  list_.Notify(7);
+  ASSERT_EQ(context_a_.NumPosted(), 1u);
+  ASSERT_EQ(context_b_.NumPosted(), 1u);
+
+  context_a_.RunAll();
+  ASSERT_EQ(log_, "a1:7 a2:7 ");
+  context_b_.RunAll();
+  ASSERT_EQ(log_, "a1:7 a2:7 b1:7 ");
+}
+
+TEST_F(ContextualCallbackListTest, posted_notification_survives_clear) {
+  Add("a1", &context_a_);
+  list_.Notify(1);
+  list_.Clear();
+  list_.Notify(2);
+  ASSERT_EQ(list_.NumContexts(), 0u);
+
+  context_a_.RunAll();
+  ASSERT_EQ(log_, "a1:1 ");
+}
+
+TEST_F(ContextualCallbackListTest, added_callback_misses_earlier_notifications) {
+  Add("a1", &context_a_);
+  list_.Notify(1);
+  Add("a2", &context_a_);
+  list_.Notify(2);
+
+  context_a_.RunAll();
+  ASSERT_EQ(log_, "a1:1 a1:2 a2:2 ");
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/crc16.h"
+
+// The carry-less multiply instructions are only enabled on the functions using them, so the rest of the library keeps
+// running on CPUs without them.
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC16_CLMUL_X86
+#include <cpuid.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#define CRC16_CLMUL_ARM64
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+// x^16 + x^15 + x^2 + 1, most significant bit first, without the x^16 term
+constexpr uint16_t kPolynomial = 0x8005;
+// The same polynomial least significant bit first
+constexpr uint16_t kReflectedPolynomial = 0xa001;
+
+// Buffers shorter than this are not worth the setup of the carry-less multiply path
+constexpr size_t kClmulMinLength = 64;
+
+struct Tables {
+  // tables[k][b] is the CRC of the byte b followed by k zero bytes
+  uint16_t tables[8][256];
+};
+
+constexpr Tables make_tables() {
+  Tables result{};
+  for (int byte = 0; byte < 256; byte++) {
+    uint16_t crc = byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ kReflectedPolynomial : crc >> 1;
+    }
+    result.tables[0][byte] = crc;
+  }
+  for (int k = 1; k < 8; k++) {
+    for (int byte = 0; byte < 256; byte++) {
+      uint16_t previous = result.tables[k - 1][byte];
+      result.tables[k][byte] = (previous >> 8) ^ result.tables[0][previous & 0xff];
+    }
+  }
+  return result;
+}
+
+constexpr Tables kTables = make_tables();
+static_assert(kTables.tables[0][1] == 0xc0c1, "CRC table does not match the L2CAP FCS");
+static_assert(kTables.tables[0][255] == 0x4040, "CRC table does not match the L2CAP FCS");
+
+uint16_t update_byte(uint16_t crc, uint8_t byte) {
+  return (crc >> 8) ^ kTables.tables[0][(crc ^ byte) & 0xff];
+}
+
+uint16_t update_tables(uint16_t crc, const uint8_t* data, size_t len) {
+  const auto& t = kTables.tables;
+  while (len >= 8) {
+    crc = t[7][(data[0] ^ crc) & 0xff] ^ t[6][data[1] ^ (crc >> 8)] ^ t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^
+          t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    data += 8;
+    len -= 8;
+  }
+  while (len-- > 0) {
+    crc = update_byte(crc, *data++);
+  }
+  return crc;
+}
+
+// x^n mod P, bit reversed into the top 16 bits of a 64 bit word so that carry-less multiplying a 64 bit block loaded
+// least significant bit first by it leaves the product aligned with the next 128 bit block. The product of two
+// reflected operands comes out one degree short, hence n - 1.
+constexpr uint64_t fold_constant(int n) {
+  uint32_t remainder = 1;
+  for (int i = 0; i < n - 1; i++) {
+    remainder <<= 1;
+    if (remainder & 0x10000) {
+      remainder ^= 0x10000 | kPolynomial;
+    }
+  }
+  uint64_t reflected = 0;
+  for (int degree = 0; degree < 16; degree++) {
+    if (remainder & (1u << degree)) {
+      reflected |= uint64_t{1} << (63 - degree);
+    }
+  }
+  return reflected;
+}
+
+// The first 8 bytes of a 16 bytes block are folded 192 bits ahead, the last 8 bytes 128 bits ahead
+constexpr uint64_t kFoldLow = fold_constant(192);
+constexpr uint64_t kFoldHigh = fold_constant(128);
+
+#if defined(CRC16_CLMUL_X86)
+
+bool probe_clmul() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+  return (ecx & bit_PCLMUL) != 0;
+}
+
+// Folds all 16 bytes blocks into a congruent last block, which the tables finish along with the tail
+__attribute__((target("pclmul,sse2"))) uint16_t update_clmul(uint16_t crc, const uint8_t* data, size_t len) {
+  const __m128i fold = _mm_set_epi64x(kFoldHigh, kFoldLow);
+  __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_cvtsi32_si128(crc));
+  data += 16;
+  len -= 16;
+  while (len >= 16) {
+    __m128i low = _mm_clmulepi64_si128(block, fold, 0x00);
+    __m128i high = _mm_clmulepi64_si128(block, fold, 0x11);
+    block = _mm_xor_si128(_mm_xor_si128(low, high), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    data += 16;
+    len -= 16;
+  }
+  uint8_t last[16];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(last), block);
+  return update_tables(update_tables(0, last, sizeof(last)), data, len);
+}
+
+#elif defined(CRC16_CLMUL_ARM64)
+
+bool probe_clmul() {
+  return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+}
+
+#if defined(__clang__)
+#define CRC16_CLMUL_TARGET "aes"
+#else
+#define CRC16_CLMUL_TARGET "+crypto"
+#endif
+
+// Folds all 16 bytes blocks into a congruent last block, which the tables finish along with the tail
+__attribute__((target(CRC16_CLMUL_TARGET))) uint16_t update_clmul(uint16_t crc, const uint8_t* data, size_t len) {
+  uint64x2_t block = veorq_u64(vreinterpretq_u64_u8(vld1q_u8(data)), vcombine_u64(vcreate_u64(crc), vcreate_u64(0)));
+  data += 16;
+  len -= 16;
+  while (len >= 16) {
+    poly128_t low = vmull_p64((poly64_t)vgetq_lane_u64(block, 0), (poly64_t)kFoldLow);
+    poly128_t high = vmull_p64((poly64_t)vgetq_lane_u64(block, 1), (poly64_t)kFoldHigh);
+    block = veorq_u64(
+        veorq_u64(vreinterpretq_u64_p128(low), vreinterpretq_u64_p128(high)), vreinterpretq_u64_u8(vld1q_u8(data)));
+    data += 16;
+    len -= 16;
+  }
+  uint8_t last[16];
+  vst1q_u8(last, vreinterpretq_u8_u64(block));
+  return update_tables(update_tables(0, last, sizeof(last)), data, len);
+}
+
+#else
+
+bool probe_clmul() {
+  return false;
+}
+
+uint16_t update_clmul(uint16_t crc, const uint8_t* data, size_t len) {
+  return update_tables(crc, data, len);
+}
+
+#endif
+
+bool clmul_supported() {
+  static const bool supported = probe_clmul();
+  return supported;
+}
+
+}  // namespace
+
+uint16_t Crc16Update(uint16_t crc, const uint8_t* data, size_t len) {
+  if (len >= kClmulMinLength && clmul_supported()) {
+    return update_clmul(crc, data, len);
+  }
+  return update_tables(crc, data, len);
+}
+
+uint16_t Crc16UpdateByte(uint16_t crc, uint8_t byte) {
+  return update_byte(crc, byte);
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+namespace common {
+
+// CRC-16 with the generator polynomial x^16 + x^15 + x^2 + 1, processed least significant bit first and without a
+// final XOR. This is the Frame Check Sequence of L2CAP Enhanced Retransmission and Streaming modes, Vol 3, Part A,
+// 3.3.5.
+
+// Feed |len| bytes of |data| into |crc| and return the updated value. Uses slicing-by-8 tables, and carry-less
+// multiplication (PCLMULQDQ on x86, PMULL on ARMv8) for long buffers when the CPU has it.
+uint16_t Crc16Update(uint16_t crc, const uint8_t* data, size_t len);
+
+// Feed a single byte into |crc|
+uint16_t Crc16UpdateByte(uint16_t crc, uint8_t byte);
+
+}  // namespace common
+}  // namespace bluetooth
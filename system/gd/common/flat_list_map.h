@@ -0,0 +1,465 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Hash of the keys of FlatListMap. The std::string keys are hashed as std::string_view, so that they can be looked up
+// without building a std::string.
+template <typename Key>
+struct FlatMapHash : std::hash<Key> {};
+
+template <>
+struct FlatMapHash<std::string> {
+  using is_transparent = void;
+  size_t operator()(std::string_view key) const {
+    return std::hash<std::string_view>()(key);
+  }
+};
+
+// A ListMap storing its elements in a contiguous slot array instead of a node per element. The order of the elements
+// is kept by links between slots, and the keys are indexed by an open addressing hash table of slot indexes.
+//
+// Differences with ListMap:
+//   - find(), contains() and extract() accept any key type that the hash and KeyEqual accept, e.g. std::string_view
+//     or const char* for std::string keys
+//   - Iterators stay valid until their element is erased, but references and pointers to elements are invalidated
+//     when an insertion grows the slot array. reserve() prevents that up to a number of elements.
+//   - Erased slots are reused by the next insertions
+//
+// Performance:
+//   - Key look-up and modification is O(1), without pointer chasing between nodes
+//   - Memory consumption is:
+//     O(capacity*(sizeof(K)+sizeof(V)+2*sizeof(uint32_t)+sizeof(size_t)) + 2*capacity*sizeof(uint32_t))
+//   - NOT THREAD SAFE
+//
+// Template:
+//   - Key key
+//   - T value
+template <typename Key, typename T, typename Hash = FlatMapHash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatListMap {
+ private:
+  // Slot index of the end of the list, or of an empty free list
+  static constexpr uint32_t kEnd = UINT32_MAX;
+  // Entry of the hash table that holds no slot index
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+  static constexpr size_t kMinIndexSize = 16;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  // different from c++17 node_type on purpose as we want node to be copyable
+  using node_type = std::pair<Key, T>;
+
+  template <bool Const>
+  class Iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = FlatListMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    // iterator to const_iterator
+    template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+    Iterator(const Iterator<OtherConst>& other) : map_(other.map_), slot_(other.slot_) {}
+
+    reference operator*() const {
+      return *map_->slots_[slot_].value;
+    }
+    pointer operator->() const {
+      return &*map_->slots_[slot_].value;
+    }
+
+    Iterator& operator++() {
+      slot_ = map_->slots_[slot_].next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator iter = *this;
+      ++*this;
+      return iter;
+    }
+    Iterator& operator--() {
+      slot_ = slot_ == kEnd ? map_->tail_ : map_->slots_[slot_].prev;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator iter = *this;
+      --*this;
+      return iter;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.map_ == rhs.map_ && lhs.slot_ == rhs.slot_;
+    }
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class FlatListMap;
+    template <bool>
+    friend class Iterator;
+
+    using map_pointer = std::conditional_t<Const, const FlatListMap*, FlatListMap*>;
+
+    Iterator(map_pointer map, uint32_t slot) : map_(map), slot_(slot) {}
+
+    map_pointer map_ = nullptr;
+    uint32_t slot_ = kEnd;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructor of the list map
+  FlatListMap() = default;
+
+  // for move
+  FlatListMap(FlatListMap&& other) noexcept {
+    *this = std::move(other);
+  }
+  FlatListMap& operator=(FlatListMap&& other) noexcept {
+    if (&other == this) {
+      return *this;
+    }
+    slots_ = std::move(other.slots_);
+    index_ = std::move(other.index_);
+    head_ = std::exchange(other.head_, kEnd);
+    tail_ = std::exchange(other.tail_, kEnd);
+    free_ = std::exchange(other.free_, kEnd);
+    size_ = std::exchange(other.size_, 0);
+    index_shift_ = other.index_shift_;
+    other.slots_.clear();
+    other.index_.clear();
+    return *this;
+  }
+
+  // slots are linked by index, they can be copied directly
+  FlatListMap(const FlatListMap& other) = default;
+  FlatListMap& operator=(const FlatListMap& other) = default;
+
+  // comparison operators
+  bool operator==(const FlatListMap& rhs) const {
+    return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+  }
+  bool operator!=(const FlatListMap& rhs) const {
+    return !(*this == rhs);
+  }
+
+  // Clear the list map, keeping the memory allocated for the elements
+  void clear() {
+    slots_.clear();
+    std::fill(index_.begin(), index_.end(), kEmpty);
+    head_ = tail_ = free_ = kEnd;
+    size_ = 0;
+  }
+
+  // Allocate the memory for |count| elements at once, so that references to elements stay valid until the map holds
+  // more than |count| elements
+  void reserve(size_t count) {
+    slots_.reserve(count);
+    grow_index(count);
+  }
+
+  // const version of find()
+  template <typename K>
+  const_iterator find(const K& key) const {
+    return const_iterator(this, find_slot(key));
+  }
+
+  // Get the value of a key. Return iterator to the item if found, end() if not found
+  template <typename K>
+  iterator find(const K& key) {
+    return iterator(this, find_slot(key));
+  }
+
+  // Check if key exist in the map. Return true if key exist in map, false if not.
+  template <typename K>
+  bool contains(const K& key) const {
+    return find_slot(key) != kEnd;
+  }
+
+  // Try emplace an element before a specific position |pos| of the list map. If the |key| already exists, does nothing.
+  // Moved arguments won't be moved when key already exists. Return <iterator, true> when key does not exist, <end(),
+  // false> when key exist.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const_iterator pos, const Key& key, Args&&... args) {
+    size_t hash = Hash()(key);
+    if (find_slot(key, hash) != kEnd) {
+      return std::make_pair(end(), false);
+    }
+    grow_index(size_ + 1);
+    uint32_t slot = allocate_slot(hash);
+    slots_[slot].value.emplace(
+        std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    link(slot, pos.slot_);
+    insert_index(slot);
+    size_++;
+    return std::make_pair(iterator(this, slot), true);
+  }
+
+  // Try emplace an element before the end of the list map. If the key already exists, does nothing. Moved arguments
+  // won't be moved when key already exists return <iterator, true> when key does not exist, <end(), false> when key
+  // exist
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace_back(const Key& key, Args&&... args) {
+    return try_emplace(end(), key, std::forward<Args>(args)...);
+  }
+
+  // Put a key-value pair to the map before position. If key already exist, |pos| will be ignored and existing value
+  // will be replaced
+  void insert_or_assign(const_iterator pos, const Key& key, T value) {
+    uint32_t slot = find_slot(key);
+    if (slot != kEnd) {
+      slots_[slot].value->second = std::move(value);
+      return;
+    }
+    try_emplace(pos, key, std::move(value));
+  }
+
+  // Put a key-value pair to the tail of the map or replace the current value without moving the key if key exists
+  void insert_or_assign(const Key& key, T value) {
+    insert_or_assign(end(), key, std::move(value));
+  }
+
+  // STL splice, same as std::list::splice
+  // - pos: element before which the content will be inserted
+  // - other: another container to transfer the content from
+  // - it: the element to transfer from other to *this
+  // The element keeps its slot when moved within the same map, iterators to it stay valid
+  void splice(const_iterator pos, FlatListMap& other, const_iterator it) {
+    if (&other != this) {
+      auto node = other.extract(it->first);
+      try_emplace(pos, node->first, std::move(node->second));
+      return;
+    }
+    if (it.slot_ == pos.slot_) {
+      return;
+    }
+    unlink(it.slot_);
+    link(it.slot_, pos.slot_);
+  }
+
+  // Remove a key from the list map and return removed value if key exits, std::nullopt if not. The return value will be
+  // evaluated to true in a boolean context if a value is contained by std::optional, false otherwise.
+  template <typename K>
+  std::optional<node_type> extract(const K& key) {
+    uint32_t slot = find_slot(key);
+    if (slot == kEnd) {
+      return std::nullopt;
+    }
+    std::optional<node_type> removed_node(std::move(*slots_[slot].value));
+    remove_slot(slot);
+    return removed_node;
+  }
+
+  // Remove an iterator pointed item from the list map and return the iterator immediately after the erased item
+  iterator erase(const_iterator iter) {
+    uint32_t next = slots_[iter.slot_].next;
+    remove_slot(iter.slot_);
+    return iterator(this, next);
+  }
+
+  // Return size of the list map
+  inline size_t size() const {
+    return size_;
+  }
+
+  // Return iterator interface for begin
+  inline iterator begin() {
+    return iterator(this, head_);
+  }
+
+  // Iterator interface for begin, const
+  inline const_iterator begin() const {
+    return const_iterator(this, head_);
+  }
+
+  // Iterator interface for end
+  inline iterator end() {
+    return iterator(this, kEnd);
+  }
+
+  // Iterator interface for end, const
+  inline const_iterator end() const {
+    return const_iterator(this, kEnd);
+  }
+
+ private:
+  struct Slot {
+    // Links of the list, or |next| links the free slots
+    uint32_t prev = kEnd;
+    uint32_t next = kEnd;
+    size_t hash = 0;
+    std::optional<value_type> value;
+  };
+
+  // Spread the hash over the high bits with a multiplicative hash, std::hash of integers is the identity
+  size_t index_position(size_t hash) const {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> index_shift_);
+  }
+
+  template <typename K>
+  uint32_t find_slot(const K& key) const {
+    return find_slot(key, Hash()(key));
+  }
+
+  template <typename K>
+  uint32_t find_slot(const K& key, size_t hash) const {
+    if (index_.empty()) {
+      return kEnd;
+    }
+    size_t mask = index_.size() - 1;
+    for (size_t position = index_position(hash);; position = (position + 1) & mask) {
+      uint32_t slot = index_[position];
+      if (slot == kEmpty) {
+        return kEnd;
+      }
+      if (slots_[slot].hash == hash && KeyEqual()(slots_[slot].value->first, key)) {
+        return slot;
+      }
+    }
+  }
+
+  // Keep the hash table at most half full so that probe sequences stay short
+  void grow_index(size_t count) {
+    if (count * 2 <= index_.size()) {
+      return;
+    }
+    size_t index_size = kMinIndexSize;
+    while (index_size < count * 2) {
+      index_size *= 2;
+    }
+    index_shift_ = 64;
+    for (size_t size = index_size; size > 1; size /= 2) {
+      index_shift_--;
+    }
+    index_.assign(index_size, kEmpty);
+    for (uint32_t slot = head_; slot != kEnd; slot = slots_[slot].next) {
+      insert_index(slot);
+    }
+  }
+
+  void insert_index(uint32_t slot) {
+    size_t mask = index_.size() - 1;
+    size_t position = index_position(slots_[slot].hash);
+    while (index_[position] != kEmpty) {
+      position = (position + 1) & mask;
+    }
+    index_[position] = slot;
+  }
+
+  void erase_index(uint32_t slot) {
+    size_t mask = index_.size() - 1;
+    size_t position = index_position(slots_[slot].hash);
+    while (index_[position] != slot) {
+      position = (position + 1) & mask;
+    }
+    // Shift back the following entries of the probe sequence into the hole instead of leaving a tombstone, so that
+    // erasing and inserting keys forever never degrades the look-ups
+    for (size_t next = (position + 1) & mask; index_[next] != kEmpty; next = (next + 1) & mask) {
+      size_t home = index_position(slots_[index_[next]].hash);
+      // The entry can move to the hole unless its home is cyclically in (position, next]
+      if (((next - home) & mask) >= ((next - position) & mask)) {
+        index_[position] = index_[next];
+        position = next;
+      }
+    }
+    index_[position] = kEmpty;
+  }
+
+  uint32_t allocate_slot(size_t hash) {
+    uint32_t slot = free_;
+    if (slot != kEnd) {
+      free_ = slots_[slot].next;
+    } else {
+      slot = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    }
+    slots_[slot].hash = hash;
+    return slot;
+  }
+
+  void remove_slot(uint32_t slot) {
+    erase_index(slot);
+    unlink(slot);
+    slots_[slot].value.reset();
+    slots_[slot].next = free_;
+    free_ = slot;
+    size_--;
+  }
+
+  // Link |slot| before |pos|
+  void link(uint32_t slot, uint32_t pos) {
+    uint32_t prev = pos == kEnd ? tail_ : slots_[pos].prev;
+    slots_[slot].prev = prev;
+    slots_[slot].next = pos;
+    if (prev == kEnd) {
+      head_ = slot;
+    } else {
+      slots_[prev].next = slot;
+    }
+    if (pos == kEnd) {
+      tail_ = slot;
+    } else {
+      slots_[pos].prev = slot;
+    }
+  }
+
+  void unlink(uint32_t slot) {
+    uint32_t prev = slots_[slot].prev;
+    uint32_t next = slots_[slot].next;
+    if (prev == kEnd) {
+      head_ = next;
+    } else {
+      slots_[prev].next = next;
+    }
+    if (next == kEnd) {
+      tail_ = prev;
+    } else {
+      slots_[next].prev = prev;
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> index_;
+  size_t index_shift_ = 64;
+  uint32_t head_ = kEnd;
+  uint32_t tail_ = kEnd;
+  uint32_t free_ = kEnd;
+  size_t size_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
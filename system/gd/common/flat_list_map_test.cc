@@ -0,0 +1,423 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "common/flat_list_map.h"
+
+namespace testing {
+
+using bluetooth::common::FlatListMap;
+
+TEST(FlatListMapTest, empty_test) {
+  FlatListMap<int, int> flat_list_map;
+  EXPECT_EQ(flat_list_map.size(), 0ul);
+  EXPECT_EQ(flat_list_map.find(42), flat_list_map.end());
+  flat_list_map.clear();  // should not crash
+  EXPECT_EQ(flat_list_map.find(42), flat_list_map.end());
+  EXPECT_FALSE(flat_list_map.contains(42));
+  EXPECT_FALSE(flat_list_map.extract(42));
+}
+
+TEST(FlatListMapTest, comparison_test) {
+  FlatListMap<int, int> flat_list_map_1;
+  flat_list_map_1.insert_or_assign(1, 10);
+  flat_list_map_1.insert_or_assign(2, 20);
+  FlatListMap<int, int> flat_list_map_2;
+  flat_list_map_2.insert_or_assign(1, 10);
+  flat_list_map_2.insert_or_assign(2, 20);
+  EXPECT_EQ(flat_list_map_1, flat_list_map_2);
+  // List map with different value should be different
+  flat_list_map_2.insert_or_assign(1, 11);
+  EXPECT_NE(flat_list_map_1, flat_list_map_2);
+  // List maps with different order should not be equal
+  FlatListMap<int, int> flat_list_map_3;
+  flat_list_map_3.insert_or_assign(2, 20);
+  flat_list_map_3.insert_or_assign(1, 10);
+  EXPECT_NE(flat_list_map_1, flat_list_map_3);
+  // Empty list map should not be equal to non-empty ones
+  FlatListMap<int, int> flat_list_map_4;
+  EXPECT_NE(flat_list_map_1, flat_list_map_4);
+  // Empty list maps should be equal
+  FlatListMap<int, int> flat_list_map_5;
+  EXPECT_EQ(flat_list_map_4, flat_list_map_5);
+}
+
+TEST(FlatListMapTest, copy_test) {
+  FlatListMap<int, std::shared_ptr<int>> flat_list_map;
+  flat_list_map.insert_or_assign(1, std::make_shared<int>(100));
+  auto iter = flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  FlatListMap<int, std::shared_ptr<int>> new_flat_list_map = flat_list_map;
+  iter = new_flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  *iter->second = 300;
+  iter = new_flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 300);
+  // Since copy is used, shared_ptr should increase count
+  EXPECT_EQ(iter->second.use_count(), 2);
+}
+
+TEST(FlatListMapTest, move_test) {
+  FlatListMap<int, std::shared_ptr<int>> flat_list_map;
+  flat_list_map.insert_or_assign(1, std::make_shared<int>(100));
+  auto iter = flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  FlatListMap<int, std::shared_ptr<int>> new_flat_list_map = std::move(flat_list_map);
+  iter = new_flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  *iter->second = 300;
+  iter = new_flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 300);
+  // Since move is used, shared_ptr should not increase count
+  EXPECT_EQ(iter->second.use_count(), 1);
+}
+
+TEST(FlatListMapTest, move_insert_unique_ptr_test) {
+  FlatListMap<int, std::unique_ptr<int>> flat_list_map;
+  flat_list_map.insert_or_assign(1, std::make_unique<int>(100));
+  auto iter = flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  flat_list_map.insert_or_assign(1, std::make_unique<int>(400));
+  iter = flat_list_map.find(1);
+  EXPECT_EQ(*iter->second, 400);
+}
+
+TEST(FlatListMapTest, move_insert_flat_list_map_test) {
+  FlatListMap<int, FlatListMap<int, int>> flat_list_map;
+  FlatListMap<int, int> m1;
+  m1.insert_or_assign(1, 100);
+  flat_list_map.insert_or_assign(1, std::move(m1));
+  auto iter = flat_list_map.find(1);
+  EXPECT_THAT(iter->second, ElementsAre(Pair(1, 100)));
+  FlatListMap<int, int> m2;
+  m2.insert_or_assign(2, 200);
+  flat_list_map.insert_or_assign(1, std::move(m2));
+  iter = flat_list_map.find(1);
+  EXPECT_THAT(iter->second, ElementsAre(Pair(2, 200)));
+}
+
+TEST(FlatListMapTest, erase_one_item_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  flat_list_map.insert_or_assign(3, 30);
+  auto iter = flat_list_map.find(2);
+  iter = flat_list_map.erase(iter);
+  EXPECT_EQ(iter->first, 3);
+  EXPECT_EQ(iter->second, 30);
+}
+
+TEST(FlatListMapTest, erase_in_for_loop_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  flat_list_map.insert_or_assign(3, 30);
+  for (auto iter = flat_list_map.begin(); iter != flat_list_map.end();) {
+    if (iter->first == 2) {
+      iter = flat_list_map.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  EXPECT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(3, 30)));
+}
+
+TEST(FlatListMapTest, splice_different_list_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  flat_list_map.insert_or_assign(3, 30);
+  FlatListMap<int, int> flat_list_map_2;
+  flat_list_map_2.insert_or_assign(4, 40);
+  flat_list_map_2.insert_or_assign(5, 50);
+  flat_list_map.splice(flat_list_map.find(2), flat_list_map_2, flat_list_map_2.find(4));
+  EXPECT_EQ(flat_list_map_2.find(4), flat_list_map_2.end());
+  auto iter = flat_list_map.find(4);
+  EXPECT_NE(iter, flat_list_map.end());
+  EXPECT_EQ(iter->second, 40);
+  EXPECT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(4, 40), Pair(2, 20), Pair(3, 30)));
+}
+
+TEST(FlatListMapTest, splice_same_list_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  flat_list_map.insert_or_assign(3, 30);
+  flat_list_map.splice(flat_list_map.find(2), flat_list_map, flat_list_map.find(3));
+  EXPECT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(3, 30), Pair(2, 20)));
+  flat_list_map.extract(2);
+  flat_list_map.insert_or_assign(flat_list_map.begin(), 4, 40);
+  EXPECT_THAT(flat_list_map, ElementsAre(Pair(4, 40), Pair(1, 10), Pair(3, 30)));
+  auto iter = flat_list_map.find(4);
+  EXPECT_EQ(iter->second, 40);
+  flat_list_map.splice(flat_list_map.begin(), flat_list_map, flat_list_map.find(4));
+  flat_list_map.splice(flat_list_map.begin(), flat_list_map, flat_list_map.find(3));
+  flat_list_map.splice(flat_list_map.begin(), flat_list_map, flat_list_map.find(1));
+  EXPECT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(3, 30), Pair(4, 40)));
+  iter = flat_list_map.find(4);
+  EXPECT_EQ(iter->second, 40);
+  iter = flat_list_map.find(3);
+  EXPECT_EQ(iter->second, 30);
+}
+
+TEST(FlatListMapTest, put_get_and_contains_key_test) {
+  FlatListMap<int, int> flat_list_map;
+  EXPECT_EQ(flat_list_map.size(), 0ul);
+  EXPECT_EQ(flat_list_map.find(42), flat_list_map.end());
+  EXPECT_FALSE(flat_list_map.contains(42));
+  flat_list_map.insert_or_assign(56, 200);
+  EXPECT_EQ(flat_list_map.find(42), flat_list_map.end());
+  EXPECT_FALSE(flat_list_map.contains(42));
+  auto iter = flat_list_map.find(56);
+  EXPECT_NE(iter, flat_list_map.end());
+  EXPECT_TRUE(flat_list_map.contains(56));
+  EXPECT_EQ(iter->second, 200);
+  EXPECT_TRUE(flat_list_map.extract(56));
+  EXPECT_FALSE(flat_list_map.contains(56));
+}
+
+TEST(FlatListMapTest, try_emplace_at_position_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  auto iter = flat_list_map.find(2);
+  EXPECT_EQ(iter->second, 20);
+  auto result = flat_list_map.try_emplace(iter, 42, 420);
+  EXPECT_TRUE(result.second);
+  iter = flat_list_map.find(42);
+  EXPECT_EQ(iter->second, 420);
+  EXPECT_EQ(iter, result.first);
+  ASSERT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(42, 420), Pair(2, 20)));
+  EXPECT_FALSE(flat_list_map.try_emplace(result.first, 42, 420).second);
+}
+
+TEST(FlatListMapTest, try_emplace_back_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  auto result = flat_list_map.try_emplace_back(42, 420);
+  EXPECT_TRUE(result.second);
+  auto iter = flat_list_map.find(42);
+  EXPECT_EQ(iter->second, 420);
+  EXPECT_EQ(iter, result.first);
+  ASSERT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(2, 20), Pair(42, 420)));
+  EXPECT_FALSE(flat_list_map.try_emplace_back(42, 420).second);
+}
+
+TEST(FlatListMapTest, insert_at_position_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  auto iter = flat_list_map.find(2);
+  EXPECT_EQ(iter->second, 20);
+  flat_list_map.insert_or_assign(iter, 42, 420);
+  iter = flat_list_map.find(42);
+  EXPECT_EQ(iter->second, 420);
+  ASSERT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(42, 420), Pair(2, 20)));
+}
+
+TEST(FlatListMapTest, in_place_modification_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  auto iter = flat_list_map.find(2);
+  iter->second = 200;
+  ASSERT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(2, 200)));
+}
+
+TEST(FlatListMapTest, get_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  auto iter = flat_list_map.find(1);
+  EXPECT_NE(iter, flat_list_map.end());
+  EXPECT_EQ(iter->second, 10);
+}
+
+TEST(FlatListMapTest, remove_test) {
+  FlatListMap<int, int> flat_list_map;
+  for (int key = 0; key <= 30; key++) {
+    flat_list_map.insert_or_assign(key, key * 100);
+  }
+  for (int key = 0; key <= 30; key++) {
+    EXPECT_TRUE(flat_list_map.contains(key));
+  }
+  for (int key = 0; key <= 30; key++) {
+    auto removed = flat_list_map.extract(key);
+    EXPECT_TRUE(removed);
+    EXPECT_EQ(*removed, std::make_pair(key, key * 100));
+  }
+  for (int key = 0; key <= 30; key++) {
+    EXPECT_FALSE(flat_list_map.contains(key));
+  }
+}
+
+TEST(FlatListMapTest, clear_test) {
+  FlatListMap<int, int> flat_list_map;
+  for (int key = 0; key < 10; key++) {
+    flat_list_map.insert_or_assign(key, key * 100);
+  }
+  for (int key = 0; key < 10; key++) {
+    EXPECT_TRUE(flat_list_map.contains(key));
+  }
+  flat_list_map.clear();
+  for (int key = 0; key < 10; key++) {
+    EXPECT_FALSE(flat_list_map.contains(key));
+  }
+
+  for (int key = 0; key < 10; key++) {
+    flat_list_map.insert_or_assign(key, key * 1000);
+  }
+  for (int key = 0; key < 10; key++) {
+    EXPECT_TRUE(flat_list_map.contains(key));
+  }
+}
+
+TEST(FlatListMapTest, container_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  ASSERT_THAT(flat_list_map, ElementsAre(Pair(1, 10), Pair(2, 20)));
+}
+
+TEST(FlatListMapTest, iterator_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  std::list<std::pair<int, int>> list(flat_list_map.begin(), flat_list_map.end());
+  ASSERT_THAT(list, ElementsAre(Pair(1, 10), Pair(2, 20)));
+}
+
+TEST(FlatListMapTest, for_loop_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  flat_list_map.insert_or_assign(2, 20);
+  std::list<std::pair<int, int>> list;
+  for (const auto& node : flat_list_map) {
+    list.emplace_back(node);
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(1, 10), Pair(2, 20)));
+  list.clear();
+  for (auto& node : flat_list_map) {
+    list.emplace_back(node);
+    node.second = node.second * 2;
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(1, 10), Pair(2, 20)));
+  list.clear();
+  for (const auto& node : flat_list_map) {
+    list.emplace_back(node);
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(1, 20), Pair(2, 40)));
+}
+
+TEST(FlatListMapTest, pressure_test) {
+  int num_entries = 0xFFFF;  // 2^16 = 65535
+  FlatListMap<int, int> flat_list_map;
+
+  // fill the flat_list_map
+  for (int key = 0; key < num_entries; key++) {
+    flat_list_map.insert_or_assign(key, key);
+  }
+
+  // make sure the flat_list_map is full
+  for (int key = 0; key < num_entries; key++) {
+    EXPECT_TRUE(flat_list_map.contains(key));
+  }
+
+  // clear the entire flat_list_map
+  for (int key = 0; key < num_entries; key++) {
+    auto iter = flat_list_map.find(key);
+    EXPECT_NE(iter, flat_list_map.end());
+    EXPECT_EQ(iter->second, key);
+    EXPECT_TRUE(flat_list_map.extract(key));
+  }
+  EXPECT_EQ(flat_list_map.size(), 0ul);
+}
+
+
+TEST(FlatListMapTest, heterogeneous_lookup_test) {
+  FlatListMap<std::string, int> flat_list_map;
+  flat_list_map.insert_or_assign("AA:BB:CC:DD:EE:FF", 1);
+  flat_list_map.insert_or_assign("Adapter", 2);
+  std::string_view key = "Adapter";
+  EXPECT_TRUE(flat_list_map.contains(key));
+  EXPECT_EQ(flat_list_map.find(key)->second, 2);
+  EXPECT_EQ(flat_list_map.find("AA:BB:CC:DD:EE:FF")->second, 1);
+  EXPECT_EQ(flat_list_map.find(std::string_view("Info")), flat_list_map.end());
+  auto node = flat_list_map.extract(key);
+  ASSERT_TRUE(node);
+  EXPECT_EQ(node->first, "Adapter");
+  EXPECT_EQ(flat_list_map.size(), 1ul);
+}
+
+TEST(FlatListMapTest, iterators_valid_after_growth_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.insert_or_assign(1, 10);
+  auto iter = flat_list_map.find(1);
+  for (int key = 2; key <= 1000; key++) {
+    flat_list_map.insert_or_assign(key, key * 10);
+  }
+  EXPECT_EQ(iter->first, 1);
+  EXPECT_EQ(iter->second, 10);
+  EXPECT_EQ(std::next(iter)->first, 2);
+  EXPECT_EQ(std::prev(flat_list_map.end())->first, 1000);
+}
+
+TEST(FlatListMapTest, erased_slots_reused_test) {
+  FlatListMap<int, int> flat_list_map;
+  flat_list_map.reserve(4);
+  for (int key = 0; key < 4; key++) {
+    flat_list_map.insert_or_assign(key, key);
+  }
+  auto* first = &*flat_list_map.begin();
+  // Erase and insert keys many times, without growing the slots nor exhausting the hash table
+  for (int key = 4; key < 10000; key++) {
+    flat_list_map.erase(flat_list_map.begin());
+    flat_list_map.insert_or_assign(key, key);
+    EXPECT_EQ(flat_list_map.size(), 4ul);
+  }
+  EXPECT_TRUE(flat_list_map.contains(9999));
+  EXPECT_FALSE(flat_list_map.contains(9995));
+  EXPECT_EQ(flat_list_map.begin()->first, 9996);
+  int pointer_in_slots = 0;
+  for (auto& item : flat_list_map) {
+    pointer_in_slots += &item == first ? 1 : 0;
+  }
+  EXPECT_EQ(pointer_in_slots, 1);
+}
+
+TEST(FlatListMapTest, reverse_iteration_test) {
+  FlatListMap<int, int> flat_list_map;
+  for (int key = 0; key < 5; key++) {
+    flat_list_map.insert_or_assign(key, key);
+  }
+  flat_list_map.splice(flat_list_map.end(), flat_list_map, flat_list_map.find(2));
+  std::vector<int> keys;
+  for (auto iter = flat_list_map.end(); iter != flat_list_map.begin();) {
+    keys.push_back((--iter)->first);
+  }
+  EXPECT_THAT(keys, ElementsAre(2, 4, 3, 1, 0));
+}
+
+}  // namespace testing
@@ -0,0 +1,487 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <limits>
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "common/flat_lru_cache.h"
+
+namespace testing {
+
+using bluetooth::common::FlatLruCache;
+
+TEST(FlatLruCacheTest, empty_test) {
+  FlatLruCache<int, int> cache(3);  // capacity = 3;
+  EXPECT_EQ(cache.size(), 0ul);
+  EXPECT_EQ(cache.find(42), cache.end());
+  cache.clear();  // should not crash
+  EXPECT_EQ(cache.find(42), cache.end());
+  EXPECT_FALSE(cache.contains(42));
+  EXPECT_FALSE(cache.extract(42));
+}
+
+TEST(FlatLruCacheTest, comparison_test) {
+  FlatLruCache<int, int> cache_1(2);
+  cache_1.insert_or_assign(1, 10);
+  cache_1.insert_or_assign(2, 20);
+  FlatLruCache<int, int> cache_2(2);
+  cache_2.insert_or_assign(1, 10);
+  cache_2.insert_or_assign(2, 20);
+  EXPECT_EQ(cache_1, cache_2);
+  // Cache with different order should not be equal
+  cache_2.find(1);
+  EXPECT_NE(cache_1, cache_2);
+  cache_1.find(1);
+  EXPECT_EQ(cache_1, cache_2);
+  // Cache with different value should be different
+  cache_2.insert_or_assign(1, 11);
+  EXPECT_NE(cache_1, cache_2);
+  // Cache with different capacity should not be equal
+  FlatLruCache<int, int> cache_3(3);
+  cache_3.insert_or_assign(1, 10);
+  cache_3.insert_or_assign(2, 20);
+  EXPECT_NE(cache_1, cache_3);
+  // Empty cache should not be equal to non-empty ones
+  FlatLruCache<int, int> cache_4(2);
+  EXPECT_NE(cache_1, cache_4);
+  // Empty caches should be equal
+  FlatLruCache<int, int> cache_5(2);
+  EXPECT_EQ(cache_4, cache_5);
+  // Empty caches with different capacity should not be equal
+  FlatLruCache<int, int> cache_6(3);
+  EXPECT_NE(cache_4, cache_6);
+}
+
+TEST(FlatLruCacheTest, try_emplace_test) {
+  FlatLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto result = cache.try_emplace(42, 420);
+  // 1, 10 evicted
+  EXPECT_EQ(std::get<2>(result), std::make_pair(1, 10));
+  auto iter = cache.find(42);
+  EXPECT_EQ(iter->second, 420);
+  EXPECT_EQ(iter, std::get<0>(result));
+  ASSERT_THAT(cache, ElementsAre(Pair(42, 420), Pair(2, 20)));
+}
+
+TEST(FlatLruCacheTest, copy_test) {
+  FlatLruCache<int, std::shared_ptr<int>> cache(2);
+  cache.insert_or_assign(1, std::make_shared<int>(100));
+  auto iter = cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  FlatLruCache<int, std::shared_ptr<int>> new_cache = cache;
+  iter = new_cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  *iter->second = 300;
+  iter = new_cache.find(1);
+  EXPECT_EQ(*iter->second, 300);
+  // Since copy is used, shared_ptr should increase count
+  EXPECT_EQ(iter->second.use_count(), 2);
+}
+
+TEST(FlatLruCacheTest, move_test) {
+  FlatLruCache<int, std::shared_ptr<int>> cache(2);
+  cache.insert_or_assign(1, std::make_shared<int>(100));
+  auto iter = cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  FlatLruCache<int, std::shared_ptr<int>> new_cache = std::move(cache);
+  iter = new_cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  *iter->second = 300;
+  iter = new_cache.find(1);
+  EXPECT_EQ(*iter->second, 300);
+  // Since move is used, shared_ptr should not increase count
+  EXPECT_EQ(iter->second.use_count(), 1);
+}
+
+TEST(FlatLruCacheTest, move_insert_unique_ptr_test) {
+  FlatLruCache<int, std::unique_ptr<int>> cache(2);
+  cache.insert_or_assign(1, std::make_unique<int>(100));
+  auto iter = cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  cache.insert_or_assign(1, std::make_unique<int>(400));
+  iter = cache.find(1);
+  EXPECT_EQ(*iter->second, 400);
+}
+
+TEST(FlatLruCacheTest, move_insert_cache_test) {
+  FlatLruCache<int, FlatLruCache<int, int>> cache(2);
+  FlatLruCache<int, int> m1(2);
+  m1.insert_or_assign(1, 100);
+  cache.insert_or_assign(1, std::move(m1));
+  auto iter = cache.find(1);
+  EXPECT_THAT(iter->second, ElementsAre(Pair(1, 100)));
+  FlatLruCache<int, int> m2(2);
+  m2.insert_or_assign(2, 200);
+  cache.insert_or_assign(1, std::move(m2));
+  iter = cache.find(1);
+  EXPECT_THAT(iter->second, ElementsAre(Pair(2, 200)));
+}
+
+TEST(FlatLruCacheTest, erase_one_item_test) {
+  FlatLruCache<int, int> cache(3);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  cache.insert_or_assign(3, 30);
+  auto iter = cache.find(2);
+  // 2, 3, 1
+  cache.find(3);
+  // 3, 2, 1
+  iter = cache.erase(iter);
+  EXPECT_EQ(iter->first, 1);
+  EXPECT_EQ(iter->second, 10);
+  EXPECT_THAT(cache, ElementsAre(Pair(3, 30), Pair(1, 10)));
+}
+
+TEST(FlatLruCacheTest, erase_in_for_loop_test) {
+  FlatLruCache<int, int> cache(3);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  cache.insert_or_assign(3, 30);
+  for (auto iter = cache.begin(); iter != cache.end();) {
+    if (iter->first == 2) {
+      iter = cache.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  EXPECT_THAT(cache, ElementsAre(Pair(3, 30), Pair(1, 10)));
+}
+
+TEST(FlatLruCacheTest, get_and_contains_key_test) {
+  FlatLruCache<int, int> cache(3);  // capacity = 3;
+  EXPECT_EQ(cache.size(), 0ul);
+  EXPECT_EQ(cache.find(42), cache.end());
+  EXPECT_FALSE(cache.contains(42));
+  EXPECT_FALSE(cache.insert_or_assign(56, 200));
+  EXPECT_EQ(cache.find(42), cache.end());
+  EXPECT_FALSE(cache.contains(42));
+  EXPECT_NE(cache.find(56), cache.end());
+  EXPECT_TRUE(cache.contains(56));
+  auto iter = cache.find(56);
+  EXPECT_NE(iter, cache.end());
+  EXPECT_EQ(iter->second, 200);
+  EXPECT_TRUE(cache.extract(56));
+  EXPECT_FALSE(cache.contains(56));
+}
+
+TEST(FlatLruCacheTest, put_and_get_sequence_1) {
+  // Section 1: Ordered put and ordered get
+  FlatLruCache<int, int> cache(3);  // capacity = 3;
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_EQ(cache.size(), 1ul);
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  EXPECT_EQ(cache.size(), 2ul);
+  EXPECT_FALSE(cache.insert_or_assign(3, 30));
+  EXPECT_EQ(cache.size(), 3ul);
+  // 3, 2, 1 after above operations
+
+  auto evicted = cache.insert_or_assign(4, 40);
+  // 4, 3, 2 after above operations, 1 is evicted
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(1, 10));
+  EXPECT_EQ(cache.find(1), cache.end());
+  FlatLruCache<int, int>::const_iterator iter;
+  EXPECT_NE(iter = cache.find(4), cache.end());
+  EXPECT_EQ(iter->second, 40);
+  EXPECT_NE(iter = cache.find(2), cache.end());
+  EXPECT_EQ(iter->second, 20);
+  EXPECT_NE(iter = cache.find(3), cache.end());
+  EXPECT_EQ(iter->second, 30);
+  // 3, 2, 4 after above operations
+
+  // Section 2: Over capacity put and ordered get
+  evicted = cache.insert_or_assign(5, 50);
+  // 5, 3, 2 after above operations, 4 is evicted
+  EXPECT_EQ(cache.size(), 3ul);
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(4, 40));
+
+  EXPECT_TRUE(cache.extract(3));
+  // 5, 2 should be in cache, 3 is removed
+  EXPECT_FALSE(cache.insert_or_assign(6, 60));
+  // 6, 5, 2 should be in cache
+
+  // Section 3: Out of order get
+  EXPECT_EQ(cache.find(3), cache.end());
+  EXPECT_EQ(cache.find(4), cache.end());
+  EXPECT_NE(iter = cache.find(2), cache.end());
+  // 2, 6, 5 should be in cache
+  EXPECT_EQ(iter->second, 20);
+  EXPECT_NE(iter = cache.find(6), cache.end());
+  // 6, 2, 5 should be in cache
+  EXPECT_EQ(iter->second, 60);
+  EXPECT_NE(iter = cache.find(5), cache.end());
+  // 5, 6, 2 should be in cache
+  EXPECT_EQ(iter->second, 50);
+  evicted = cache.insert_or_assign(7, 70);
+  // 7, 5, 6 should be in cache, 2 is evicted
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(2, 20));
+}
+
+TEST(FlatLruCacheTest, put_and_get_sequence_2) {
+  // Section 1: Replace item in cache
+  FlatLruCache<int, int> cache(2);  // size = 2;
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  // 2, 1 in cache
+  auto evicted = cache.insert_or_assign(3, 30);
+  // 3, 2 in cache, 1 is evicted
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 200));
+  // 2, 3 in cache, nothing is evicted
+  EXPECT_EQ(cache.size(), 2ul);
+
+  EXPECT_FALSE(cache.contains(1));
+  FlatLruCache<int, int>::const_iterator iter;
+  EXPECT_NE(iter = cache.find(2), cache.end());
+  EXPECT_EQ(iter->second, 200);
+  EXPECT_NE(iter = cache.find(3), cache.end());
+  // 3, 2 in cache
+  EXPECT_EQ(iter->second, 30);
+
+  evicted = cache.insert_or_assign(4, 40);
+  // 4, 3 in cache, 2 is evicted
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(2, 200));
+
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_NE(iter = cache.find(3), cache.end());
+  EXPECT_EQ(iter->second, 30);
+  EXPECT_NE(iter = cache.find(4), cache.end());
+  EXPECT_EQ(iter->second, 40);
+  // 4, 3 in cache
+
+  EXPECT_TRUE(cache.extract(4));
+  EXPECT_FALSE(cache.contains(4));
+  // 3 in cache
+  EXPECT_EQ(cache.size(), 1ul);
+  EXPECT_FALSE(cache.insert_or_assign(2, 2000));
+  // 2, 3 in cache
+
+  EXPECT_FALSE(cache.contains(4));
+  EXPECT_NE(iter = cache.find(3), cache.end());
+  EXPECT_EQ(iter->second, 30);
+  EXPECT_NE(iter = cache.find(2), cache.end());
+  EXPECT_EQ(iter->second, 2000);
+
+  EXPECT_TRUE(cache.extract(2));
+  EXPECT_TRUE(cache.extract(3));
+  EXPECT_FALSE(cache.insert_or_assign(5, 50));
+  EXPECT_FALSE(cache.insert_or_assign(1, 100));
+  EXPECT_FALSE(cache.insert_or_assign(5, 1000));
+  EXPECT_EQ(cache.size(), 2ul);
+  // 5, 1 in cache
+
+  evicted = cache.insert_or_assign(6, 2000);
+  // 6, 5 in cache
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(1, 100));
+
+  EXPECT_FALSE(cache.contains(2));
+  EXPECT_FALSE(cache.contains(3));
+  EXPECT_NE(iter = cache.find(6), cache.end());
+  EXPECT_EQ(iter->second, 2000);
+  EXPECT_NE(iter = cache.find(5), cache.end());
+  EXPECT_EQ(iter->second, 1000);
+}
+
+TEST(FlatLruCacheTest, in_place_modification_test) {
+  FlatLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto iter = cache.find(2);
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 20), Pair(1, 10)));
+  iter->second = 200;
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 200), Pair(1, 10)));
+  cache.insert_or_assign(1, 100);
+  // 1, 2 in cache
+  ASSERT_THAT(cache, ElementsAre(Pair(1, 100), Pair(2, 200)));
+  // modifying iterator does not warm up key
+  iter->second = 400;
+  ASSERT_THAT(cache, ElementsAre(Pair(1, 100), Pair(2, 400)));
+}
+
+TEST(FlatLruCacheTest, get_test) {
+  FlatLruCache<int, int> cache(2);
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  EXPECT_TRUE(cache.contains(1));
+  // 1, 2 in cache
+  auto evicted = cache.insert_or_assign(3, 30);
+  // 3, 1 in cache
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(2, 20));
+}
+
+TEST(FlatLruCacheTest, remove_test) {
+  FlatLruCache<int, int> cache(10);
+  for (int key = 0; key <= 30; key++) {
+    cache.insert_or_assign(key, key * 100);
+  }
+  for (int key = 0; key <= 20; key++) {
+    EXPECT_FALSE(cache.contains(key));
+  }
+  for (int key = 21; key <= 30; key++) {
+    EXPECT_TRUE(cache.contains(key));
+  }
+  for (int key = 0; key <= 20; key++) {
+    EXPECT_FALSE(cache.extract(key));
+  }
+  for (int key = 21; key <= 30; key++) {
+    auto removed = cache.extract(key);
+    EXPECT_TRUE(removed);
+    EXPECT_EQ(*removed, std::make_pair(key, key * 100));
+  }
+  for (int key = 21; key <= 30; key++) {
+    EXPECT_FALSE(cache.contains(key));
+  }
+}
+
+TEST(FlatLruCacheTest, clear_test) {
+  FlatLruCache<int, int> cache(10);
+  for (int key = 0; key < 10; key++) {
+    cache.insert_or_assign(key, key * 100);
+  }
+  for (int key = 0; key < 10; key++) {
+    EXPECT_TRUE(cache.contains(key));
+  }
+  cache.clear();
+  for (int key = 0; key < 10; key++) {
+    EXPECT_FALSE(cache.contains(key));
+  }
+
+  for (int key = 0; key < 10; key++) {
+    cache.insert_or_assign(key, key * 1000);
+  }
+  for (int key = 0; key < 10; key++) {
+    EXPECT_TRUE(cache.contains(key));
+  }
+}
+
+TEST(FlatLruCacheTest, container_test) {
+  FlatLruCache<int, int> lru_cache(2);
+  lru_cache.insert_or_assign(1, 10);
+  lru_cache.insert_or_assign(2, 20);
+  // Warm elements first
+  ASSERT_THAT(lru_cache, ElementsAre(Pair(2, 20), Pair(1, 10)));
+}
+
+TEST(FlatLruCacheTest, iterator_test) {
+  FlatLruCache<int, int> lru_cache(2);
+  lru_cache.insert_or_assign(1, 10);
+  lru_cache.insert_or_assign(2, 20);
+  // Warm elements first
+  std::list<std::pair<int, int>> list(lru_cache.begin(), lru_cache.end());
+  ASSERT_THAT(list, ElementsAre(Pair(2, 20), Pair(1, 10)));
+}
+
+TEST(FlatLruCacheTest, for_loop_test) {
+  FlatLruCache<int, int> lru_cache(2);
+  lru_cache.insert_or_assign(1, 10);
+  lru_cache.insert_or_assign(2, 20);
+  // Warm elements first
+  std::list<std::pair<int, int>> list;
+  for (const auto& node : lru_cache) {
+    list.emplace_back(node);
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(2, 20), Pair(1, 10)));
+  list.clear();
+  for (auto& node : lru_cache) {
+    list.emplace_back(node);
+    node.second = node.second * 2;
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(2, 20), Pair(1, 10)));
+  list.clear();
+  for (const auto& node : lru_cache) {
+    list.emplace_back(node);
+  }
+  ASSERT_THAT(list, ElementsAre(Pair(2, 40), Pair(1, 20)));
+}
+
+TEST(FlatLruCacheTest, pressure_test) {
+  int capacity = 0xFFFF;  // 2^16 = 65535
+  FlatLruCache<int, int> cache(static_cast<size_t>(capacity));
+
+  // fill the cache
+  for (int key = 0; key < capacity; key++) {
+    cache.insert_or_assign(key, key);
+  }
+
+  // make sure the cache is full
+  for (int key = 0; key < capacity; key++) {
+    EXPECT_TRUE(cache.contains(key));
+  }
+
+  // refresh the entire cache
+  for (int key = 0; key < capacity; key++) {
+    int new_key = key + capacity;
+    cache.insert_or_assign(new_key, new_key);
+    EXPECT_FALSE(cache.contains(key));
+    EXPECT_TRUE(cache.contains(new_key));
+  }
+
+  // clear the entire cache
+  FlatLruCache<int, int>::const_iterator iter;
+  for (int key = capacity; key < 2 * capacity; key++) {
+    EXPECT_NE(iter = cache.find(key), cache.end());
+    EXPECT_EQ(iter->second, key);
+    EXPECT_TRUE(cache.extract(key));
+  }
+  EXPECT_EQ(cache.size(), 0ul);
+}
+
+
+TEST(FlatLruCacheTest, heterogeneous_lookup_warms_key_test) {
+  FlatLruCache<std::string, int> cache(2);
+  cache.insert_or_assign("Adapter", 1);
+  cache.insert_or_assign("Info", 2);
+  EXPECT_EQ(cache.find(std::string_view("Adapter"))->second, 1);
+  auto evicted = cache.insert_or_assign("Metrics", 3);
+  ASSERT_TRUE(evicted);
+  EXPECT_EQ(evicted->first, "Info");
+  EXPECT_TRUE(cache.contains(std::string_view("Adapter")));
+  EXPECT_TRUE(cache.extract(std::string_view("Metrics")));
+  EXPECT_EQ(cache.size(), 1ul);
+}
+
+TEST(FlatLruCacheTest, eviction_reuses_slot_test) {
+  FlatLruCache<int, int> cache(3);
+  for (int key = 0; key < 3; key++) {
+    cache.insert_or_assign(key, key);
+  }
+  std::vector<const void*> slots;
+  for (auto& item : cache) {
+    slots.push_back(&item);
+  }
+  for (int key = 3; key < 1000; key++) {
+    EXPECT_TRUE(cache.insert_or_assign(key, key));
+  }
+  for (auto& item : cache) {
+    EXPECT_THAT(slots, Contains(&item));
+  }
+}
+
+}  // namespace testing
@@ -60,6 +60,58 @@ class InitFlags final {
     return init_flags::gd_hal_snoop_logger_filtering_is_enabled();
   }
 
+  inline static bool IsSnoopLoggerAsyncEnabled() {
+    return init_flags::gd_hal_snoop_logger_async_is_enabled();
+  }
+
+  inline static bool IsSnoopLoggerMmapRingEnabled() {
+    return init_flags::gd_hal_snoop_logger_mmap_ring_is_enabled();
+  }
+
+  inline static bool IsControllerSnapshotEnabled() {
+    return init_flags::gd_controller_snapshot_is_enabled();
+  }
+
+  inline static bool IsDataPathThreadEnabled() {
+    return init_flags::gd_data_path_thread_is_enabled();
+  }
+
+  inline static bool IsConfigCacheSnapshotReadsEnabled() {
+    return init_flags::gd_config_cache_snapshot_reads_is_enabled();
+  }
+
+  inline static bool IsStorageConfigJournalEnabled() {
+    return init_flags::gd_storage_config_journal_is_enabled();
+  }
+
+  inline static bool IsHalBatchedReceiveEnabled() {
+    return init_flags::gd_hal_batched_receive_is_enabled();
+  }
+
+  inline static bool IsHalZeroCopyReceiveEnabled() {
+    return init_flags::gd_hal_zero_copy_receive_is_enabled();
+  }
+
+  inline static bool IsHalFastReceiveEnabled() {
+    return init_flags::gd_hal_fast_receive_is_enabled();
+  }
+
+  inline static bool IsHciCommandPipeliningEnabled() {
+    return init_flags::gd_hci_command_pipelining_is_enabled();
+  }
+
+  inline static bool IsModuleParallelStartEnabled() {
+    return init_flags::gd_module_parallel_start_is_enabled();
+  }
+
+  inline static bool IsL2capWeightedFairSchedulerEnabled() {
+    return init_flags::gd_l2cap_weighted_fair_scheduler_is_enabled();
+  }
+
+  inline static bool IsLeScanningSoftwareFilterEnabled() {
+    return init_flags::gd_le_scanning_software_filter_is_enabled();
+  }
+
   inline static bool IsBluetoothQualityReportCallbackEnabled() {
     return init_flags::bluetooth_quality_report_callback_is_enabled();
   }
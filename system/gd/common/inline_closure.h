@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bluetooth {
+namespace common {
+
+// A move-only task that keeps its callable in place when it fits in kInlineSize bytes, so posting it costs no heap
+// allocation, unlike a OnceClosure whose BindState is always allocated. Larger callables are moved to the heap.
+// Like a OnceClosure it is run at most once, through std::move(closure).Run().
+class InlineClosure {
+ public:
+  static constexpr size_t kInlineSize = 48;
+
+  InlineClosure() = default;
+
+  template <
+      typename Functor,
+      typename Callable = std::decay_t<Functor>,
+      typename = std::enable_if_t<!std::is_same_v<Callable, InlineClosure> && std::is_invocable_r_v<void, Callable&>>>
+  InlineClosure(Functor&& functor) {  // NOLINT(google-explicit-constructor)
+    if constexpr (FitsInline<Callable>()) {
+      new (storage_) Callable(std::forward<Functor>(functor));
+      ops_ = &kInlineOps<Callable>;
+    } else {
+      *reinterpret_cast<Callable**>(storage_) = new Callable(std::forward<Functor>(functor));
+      ops_ = &kHeapOps<Callable>;
+    }
+  }
+
+  InlineClosure(InlineClosure&& other) noexcept {
+    take(std::move(other));
+  }
+
+  InlineClosure& operator=(InlineClosure&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(std::move(other));
+    }
+    return *this;
+  }
+
+  InlineClosure(const InlineClosure&) = delete;
+  InlineClosure& operator=(const InlineClosure&) = delete;
+
+  ~InlineClosure() {
+    reset();
+  }
+
+  explicit operator bool() const {
+    return ops_ != nullptr;
+  }
+
+  // True when the callable lives in this object rather than on the heap
+  bool IsInline() const {
+    return ops_ != nullptr && ops_->is_inline;
+  }
+
+  // Run the callable and release it, leaving this closure empty
+  void Run() && {
+    const Ops* ops = ops_;
+    ops_ = nullptr;
+    ops->run(storage_);
+  }
+
+  template <typename Callable>
+  static constexpr bool FitsInline() {
+    return sizeof(Callable) <= kInlineSize && alignof(Callable) <= alignof(std::max_align_t);
+  }
+
+ private:
+  struct Ops {
+    // Invokes the callable and destroys it
+    void (*run)(void* storage);
+    void (*move)(void* from, void* to);
+    void (*destroy)(void* storage);
+    bool is_inline;
+  };
+
+  template <typename Callable>
+  static Callable* inline_callable(void* storage) {
+    return std::launder(reinterpret_cast<Callable*>(storage));
+  }
+
+  template <typename Callable>
+  static Callable*& heap_callable(void* storage) {
+    return *std::launder(reinterpret_cast<Callable**>(storage));
+  }
+
+  template <typename Callable>
+  static constexpr Ops kInlineOps = {
+      [](void* storage) {
+        Callable* callable = inline_callable<Callable>(storage);
+        (*callable)();
+        callable->~Callable();
+      },
+      [](void* from, void* to) {
+        Callable* callable = inline_callable<Callable>(from);
+        new (to) Callable(std::move(*callable));
+        callable->~Callable();
+      },
+      [](void* storage) { inline_callable<Callable>(storage)->~Callable(); },
+      true,
+  };
+
+  template <typename Callable>
+  static constexpr Ops kHeapOps = {
+      [](void* storage) {
+        Callable* callable = heap_callable<Callable>(storage);
+        (*callable)();
+        delete callable;
+      },
+      [](void* from, void* to) { new (to) Callable*(heap_callable<Callable>(from)); },
+      [](void* storage) { delete heap_callable<Callable>(storage); },
+      false,
+  };
+
+  void take(InlineClosure&& other) {
+    ops_ = other.ops_;
+    if (ops_ != nullptr) {
+      ops_->move(other.storage_, storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  void reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  const Ops* ops_ = nullptr;
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/inline_closure.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+namespace testing {
+
+using bluetooth::common::InlineClosure;
+
+TEST(InlineClosureTest, small_capture_is_inline) {
+  int counter = 0;
+  InlineClosure closure([&counter]() { counter++; });
+  ASSERT_TRUE(closure);
+  ASSERT_TRUE(closure.IsInline());
+  std::move(closure).Run();
+  ASSERT_EQ(counter, 1);
+  ASSERT_FALSE(closure);
+}
+
+TEST(InlineClosureTest, large_capture_is_on_heap) {
+  std::array<uint8_t, InlineClosure::kInlineSize + 1> payload{};
+  payload.back() = 42;
+  int result = 0;
+  InlineClosure closure([payload, &result]() { result = payload.back(); });
+  ASSERT_FALSE(closure.IsInline());
+  std::move(closure).Run();
+  ASSERT_EQ(result, 42);
+}
+
+TEST(InlineClosureTest, move_keeps_callable) {
+  int counter = 0;
+  InlineClosure first([&counter]() { counter++; });
+  InlineClosure second(std::move(first));
+  ASSERT_FALSE(first);
+  ASSERT_TRUE(second);
+
+  InlineClosure third;
+  third = std::move(second);
+  ASSERT_FALSE(second);
+  std::move(third).Run();
+  ASSERT_EQ(counter, 1);
+}
+
+TEST(InlineClosureTest, captures_are_released) {
+  auto shared = std::make_shared<int>(0);
+  {
+    InlineClosure not_run([shared]() {});
+    ASSERT_EQ(shared.use_count(), 2);
+  }
+  ASSERT_EQ(shared.use_count(), 1);
+
+  InlineClosure run([shared]() { (*shared)++; });
+  std::move(run).Run();
+  ASSERT_EQ(*shared, 1);
+  ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(InlineClosureTest, move_only_capture) {
+  auto value = std::make_unique<int>(7);
+  int result = 0;
+  InlineClosure closure([value = std::move(value), &result]() { result = *value; });
+  ASSERT_TRUE(closure.IsInline());
+  InlineClosure moved(std::move(closure));
+  std::move(moved).Run();
+  ASSERT_EQ(result, 7);
+}
+
+}  // namespace testing
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+namespace common {
+
+// Latencies in microseconds, counted in buckets in the manner of HdrHistogram: each power of two is split into
+// kSubBuckets buckets, so a percentile is reported within 1 / kSubBuckets of its value whatever its magnitude, in a
+// fixed amount of memory and with a constant time Record(). Values past kMaxMicroseconds count as kMaxMicroseconds.
+// Not thread safe.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kMaxMagnitude = 31;
+  static constexpr uint64_t kMaxMicroseconds = (uint64_t{1} << (kMaxMagnitude + 1)) - 1;
+
+  void Record(std::chrono::microseconds latency) {
+    uint64_t value = std::min<uint64_t>(std::max<int64_t>(latency.count(), 0), kMaxMicroseconds);
+    counts_[bucket_of(value)]++;
+    count_++;
+    max_ = std::max(max_, value);
+  }
+
+  uint64_t Count() const {
+    return count_;
+  }
+
+  std::chrono::microseconds Max() const {
+    return std::chrono::microseconds(max_);
+  }
+
+  // The latency that |percentile| percent of the recorded ones did not exceed, rounded up to its bucket
+  std::chrono::microseconds Percentile(double percentile) const {
+    if (count_ == 0) {
+      return std::chrono::microseconds(0);
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; bucket++) {
+      seen += counts_[bucket];
+      if (seen >= rank) {
+        return std::chrono::microseconds(std::min(upper_bound_of(bucket), max_));
+      }
+    }
+    return Max();
+  }
+
+  void Reset() {
+    counts_.fill(0);
+    count_ = 0;
+    max_ = 0;
+  }
+
+ private:
+  // Values below kSubBuckets have a bucket each, then each magnitude has kSubBuckets
+  static constexpr size_t kBuckets = kSubBuckets + (kMaxMagnitude + 1 - kSubBucketBits) * kSubBuckets;
+
+  static size_t magnitude_of(uint64_t value) {
+    size_t magnitude = 0;
+    while (value >>= 1) {
+      magnitude++;
+    }
+    return magnitude;
+  }
+
+  static size_t bucket_of(uint64_t value) {
+    if (value < kSubBuckets) {
+      return value;
+    }
+    size_t shift = magnitude_of(value) - kSubBucketBits;
+    return kSubBuckets + shift * kSubBuckets + ((value >> shift) - kSubBuckets);
+  }
+
+  static uint64_t upper_bound_of(size_t bucket) {
+    if (bucket < kSubBuckets) {
+      return bucket;
+    }
+    size_t shift = (bucket - kSubBuckets) / kSubBuckets;
+    uint64_t sub_bucket = kSubBuckets + (bucket - kSubBuckets) % kSubBuckets;
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  std::array<uint32_t, kBuckets> counts_{};
+  uint64_t count_ = 0;
+  uint64_t max_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+using std::chrono::microseconds;
+
+TEST(LatencyHistogramTest, empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.Max(), microseconds(0));
+  EXPECT_EQ(histogram.Percentile(50), microseconds(0));
+}
+
+TEST(LatencyHistogramTest, small_values_are_exact) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 8; i++) {
+    histogram.Record(microseconds(i));
+  }
+  EXPECT_EQ(histogram.Count(), 8u);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(3));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(7));
+  EXPECT_EQ(histogram.Max(), microseconds(7));
+}
+
+TEST(LatencyHistogramTest, percentiles_within_bucket_precision) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 10000; i++) {
+    histogram.Record(microseconds(i));
+  }
+  for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+    double expected = percentile * 100;
+    auto reported = histogram.Percentile(percentile).count();
+    EXPECT_GE(reported, expected);
+    EXPECT_LE(reported, expected * (1 + 1.0 / LatencyHistogram::kSubBuckets));
+  }
+  EXPECT_EQ(histogram.Percentile(100), microseconds(10000));
+}
+
+TEST(LatencyHistogramTest, outliers_are_clamped) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(-5));
+  histogram.Record(std::chrono::hours(24 * 365));
+  EXPECT_EQ(histogram.Count(), 2u);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(0));
+  EXPECT_EQ(histogram.Max(), microseconds(LatencyHistogram::kMaxMicroseconds));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(LatencyHistogram::kMaxMicroseconds));
+}
+
+TEST(LatencyHistogramTest, reset) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(100));
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0u);
+  EXPECT_EQ(histogram.Max(), microseconds(0));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/flat_lru_cache.h"
+#include "common/lru_cache.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+// Keys like the device sections of the config cache
+std::vector<std::string> MakeKeys(size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    char address[18];
+    std::snprintf(address, sizeof(address), "AA:BB:CC:DD:%02zX:%02zX", (i >> 8) & 0xff, i & 0xff);
+    keys.emplace_back(address);
+  }
+  return keys;
+}
+
+// Look-ups of cached keys, each of them warms the key up
+template <typename Cache>
+void BM_Find(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys(capacity);
+  Cache cache(capacity);
+  for (const auto& key : keys) {
+    cache.insert_or_assign(key, 0);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(cache.find(keys[i]));
+    i = (i + 7) % capacity;
+  }
+}
+
+// Insertions of new keys into a full cache, each of them evicts the coldest key
+template <typename Cache>
+void BM_InsertEvict(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys(capacity * 2);
+  Cache cache(capacity);
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(cache.insert_or_assign(keys[i], static_cast<int>(i)));
+    i = (i + 1) % keys.size();
+  }
+}
+
+// Half the look-ups miss, like a cache of remote devices in front of the storage
+template <typename Cache>
+void BM_MixedHitMiss(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys(capacity * 2);
+  Cache cache(capacity);
+  size_t i = 0;
+  for (auto _ : state) {
+    if (!cache.contains(keys[i])) {
+      cache.insert_or_assign(keys[i], static_cast<int>(i));
+    }
+    i = (i * 31 + 17) % keys.size();
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Find, LruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Find, FlatLruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_InsertEvict, LruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_InsertEvict, FlatLruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_MixedHitMiss, LruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_MixedHitMiss, FlatLruCache<std::string, int>)->Arg(16)->Arg(256)->Arg(4096);
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
@@ -87,6 +87,20 @@ void StopWatch::DumpStopWatchLog() {
   LOG_INFO("=-----------------------------------=");
 }
 
+void StopWatch::RecordElapsed(
+    std::string text,
+    std::chrono::high_resolution_clock::time_point start_timestamp,
+    std::chrono::high_resolution_clock::time_point end_timestamp) {
+  StopWatchLog sw_log;
+  sw_log.timestamp = std::chrono::system_clock::now() -
+                     std::chrono::duration_cast<std::chrono::system_clock::duration>(end_timestamp - start_timestamp);
+  sw_log.start_timestamp = start_timestamp;
+  sw_log.end_timestamp = end_timestamp;
+  sw_log.message = std::move(text);
+
+  RecordLog(std::move(sw_log));
+}
+
 StopWatch::StopWatch(std::string text)
     : text_(std::move(text)),
       timestamp_(std::chrono::system_clock::now()),
@@ -32,6 +32,12 @@ typedef struct {
 class StopWatch {
  public:
   static void DumpStopWatchLog(void);
+  // Records a scope the caller timed itself, for hot paths that only want to build |text| when
+  // the scope turned out to be slow.
+  static void RecordElapsed(
+      std::string text,
+      std::chrono::high_resolution_clock::time_point start_timestamp,
+      std::chrono::high_resolution_clock::time_point end_timestamp);
   StopWatch(std::string text);
   ~StopWatch();
 
@@ -39,7 +45,7 @@ class StopWatch {
   std::string text_;
   std::chrono::system_clock::time_point timestamp_;
   std::chrono::high_resolution_clock::time_point start_timestamp_;
-  void RecordLog(StopWatchLog log);
+  static void RecordLog(StopWatchLog log);
 };
 
 }  // namespace common
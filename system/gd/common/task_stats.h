@@ -0,0 +1,238 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "latency_histogram.h"
+
+namespace bluetooth {
+namespace common {
+
+// Task instrumentation for the legacy message loop threads and the GD handler threads. Off by default, when it only
+// costs a relaxed load per post.
+inline std::atomic<bool> task_stats_enabled{false};
+inline std::atomic<int64_t> task_stats_long_task_threshold_us{100000};
+
+inline void EnableTaskStats(bool enabled, std::chrono::milliseconds long_task_threshold) {
+  task_stats_long_task_threshold_us.store(
+      std::chrono::duration_cast<std::chrono::microseconds>(long_task_threshold).count(), std::memory_order_relaxed);
+  task_stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool IsTaskStatsEnabled() {
+  return task_stats_enabled.load(std::memory_order_relaxed);
+}
+
+// The queue depth, the time from post to run and the run time of the tasks of one thread. Run times are also kept per
+// posting site where the poster provides one, with |file| and |function| being string literals. Thread safe.
+class TaskStats {
+ public:
+  explicit TaskStats(std::string name) : name_(std::move(name)) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().insert(this);
+  }
+
+  ~TaskStats() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    registry().erase(this);
+  }
+
+  TaskStats(const TaskStats&) = delete;
+  TaskStats& operator=(const TaskStats&) = delete;
+
+  void OnPosted() {
+    int64_t depth = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+    int64_t max_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    while (depth > max_depth &&
+           !max_queue_depth_.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Tasks that were posted but will never run
+  void OnDropped(int64_t count) {
+    queue_depth_.fetch_sub(count, std::memory_order_relaxed);
+  }
+
+  // Returns true when the task ran for longer than the long task threshold
+  bool OnRun(
+      const char* file,
+      int line,
+      const char* function,
+      std::chrono::microseconds wait,
+      std::chrono::microseconds run) {
+    queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+    bool is_long = run.count() >= task_stats_long_task_threshold_us.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    wait_.Record(wait);
+    run_.Record(run);
+    if (is_long) {
+      long_task_count_++;
+    }
+    if (file != nullptr) {
+      Site& site = sites_[{file, line}];
+      site.function = function;
+      site.count++;
+      site.long_count += is_long ? 1 : 0;
+      site.total_run += run;
+      site.max_run = std::max(site.max_run, run);
+      site.max_wait = std::max(site.max_wait, wait);
+    }
+    return is_long;
+  }
+
+  int64_t GetQueueDepth() const {
+    return queue_depth_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetTaskCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_.Count();
+  }
+
+  LatencyHistogram GetWaitHistogram() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wait_;
+  }
+
+  LatencyHistogram GetRunHistogram() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_;
+  }
+
+  uint64_t GetLongTaskCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return long_task_count_;
+  }
+
+  const std::string& GetName() const {
+    return name_;
+  }
+
+  void Dump(int fd, size_t max_sites = kDumpMaxSites) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dprintf(
+        fd,
+        "  %s: queue depth %" PRId64 " (max %" PRId64 "), %" PRIu64 " tasks, %" PRIu64 " long\n",
+        name_.c_str(),
+        queue_depth_.load(std::memory_order_relaxed),
+        max_queue_depth_.load(std::memory_order_relaxed),
+        run_.Count(),
+        long_task_count_);
+    if (run_.Count() == 0) {
+      return;
+    }
+    dump_histogram(fd, "wait", wait_);
+    dump_histogram(fd, "run", run_);
+
+    // Sites that kept the thread busiest first
+    std::vector<std::pair<Key, const Site*>> sites;
+    for (const auto& [key, site] : sites_) {
+      sites.emplace_back(key, &site);
+    }
+    size_t count = std::min(sites.size(), max_sites);
+    std::partial_sort(sites.begin(), sites.begin() + count, sites.end(), [](const auto& a, const auto& b) {
+      return a.second->total_run > b.second->total_run;
+    });
+    for (size_t i = 0; i < count; i++) {
+      const auto& [key, site] = sites[i];
+      dprintf(
+          fd,
+          "    %s (%s:%d): %" PRIu64 " tasks, %" PRIu64 " long, run total %" PRId64 "us max %" PRId64
+          "us, max wait %" PRId64 "us\n",
+          site->function ? site->function : "?",
+          std::get<0>(key),
+          std::get<1>(key),
+          site->count,
+          site->long_count,
+          static_cast<int64_t>(site->total_run.count()),
+          static_cast<int64_t>(site->max_run.count()),
+          static_cast<int64_t>(site->max_wait.count()));
+    }
+  }
+
+  // Dumps every live TaskStats
+  static void DumpAll(int fd) {
+    dprintf(fd, "\nTask Statistics:\n");
+    if (!IsTaskStatsEnabled()) {
+      dprintf(fd, "  Disabled\n");
+    }
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (const TaskStats* stats : registry()) {
+      stats->Dump(fd);
+    }
+  }
+
+ private:
+  static constexpr size_t kDumpMaxSites = 10;
+
+  using Key = std::tuple<const char*, int>;
+
+  struct Site {
+    const char* function = nullptr;
+    uint64_t count = 0;
+    uint64_t long_count = 0;
+    std::chrono::microseconds total_run{0};
+    std::chrono::microseconds max_run{0};
+    std::chrono::microseconds max_wait{0};
+  };
+
+  static std::set<TaskStats*>& registry() {
+    static std::set<TaskStats*> registry;
+    return registry;
+  }
+
+  static std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static void dump_histogram(int fd, const char* name, const LatencyHistogram& histogram) {
+    dprintf(
+        fd,
+        "    %s: p50 %" PRId64 "us p90 %" PRId64 "us p99 %" PRId64 "us max %" PRId64 "us\n",
+        name,
+        static_cast<int64_t>(histogram.Percentile(50).count()),
+        static_cast<int64_t>(histogram.Percentile(90).count()),
+        static_cast<int64_t>(histogram.Percentile(99).count()),
+        static_cast<int64_t>(histogram.Max().count()));
+  }
+
+  const std::string name_;
+  std::atomic<int64_t> queue_depth_{0};
+  std::atomic<int64_t> max_queue_depth_{0};
+  mutable std::mutex mutex_;
+  LatencyHistogram wait_;
+  LatencyHistogram run_;
+  uint64_t long_task_count_ = 0;
+  std::map<Key, Site> sites_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
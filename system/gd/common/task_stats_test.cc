@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/task_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+class TaskStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    EnableTaskStats(true, milliseconds(10));
+  }
+
+  void TearDown() override {
+    EnableTaskStats(false, milliseconds(100));
+  }
+
+  TaskStats stats_{"test_thread"};
+};
+
+TEST_F(TaskStatsTest, queue_depth) {
+  stats_.OnPosted();
+  stats_.OnPosted();
+  stats_.OnPosted();
+  EXPECT_EQ(stats_.GetQueueDepth(), 3);
+  stats_.OnRun(nullptr, 0, nullptr, microseconds(5), microseconds(5));
+  EXPECT_EQ(stats_.GetQueueDepth(), 2);
+  stats_.OnDropped(2);
+  EXPECT_EQ(stats_.GetQueueDepth(), 0);
+  EXPECT_EQ(stats_.GetTaskCount(), 1u);
+}
+
+TEST_F(TaskStatsTest, long_tasks_flagged) {
+  stats_.OnPosted();
+  EXPECT_FALSE(stats_.OnRun(nullptr, 0, nullptr, microseconds(0), microseconds(9999)));
+  stats_.OnPosted();
+  EXPECT_TRUE(stats_.OnRun(nullptr, 0, nullptr, microseconds(0), milliseconds(10)));
+  EXPECT_EQ(stats_.GetLongTaskCount(), 1u);
+}
+
+TEST_F(TaskStatsTest, dump_lists_busiest_sites) {
+  stats_.OnPosted();
+  stats_.OnRun("quiet.cc", 1, "Quiet", microseconds(1), microseconds(1));
+  stats_.OnPosted();
+  stats_.OnRun("busy.cc", 2, "Busy", microseconds(1), microseconds(500));
+
+  FILE* file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  TaskStats::DumpAll(fileno(file));
+  rewind(file);
+  char contents[4096] = {};
+  fread(contents, 1, sizeof(contents) - 1, file);
+  fclose(file);
+
+  const char* thread = strstr(contents, "test_thread");
+  ASSERT_NE(thread, nullptr);
+  const char* busy = strstr(thread, "Busy (busy.cc:2)");
+  const char* quiet = strstr(thread, "Quiet (quiet.cc:1)");
+  ASSERT_NE(busy, nullptr);
+  ASSERT_NE(quiet, nullptr);
+  EXPECT_LT(busy, quiet);
+}
+
+TEST(TaskStatsRegistryTest, destroyed_stats_are_not_dumped) {
+  {
+    TaskStats stats("gone_thread");
+  }
+  FILE* file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  TaskStats::DumpAll(fileno(file));
+  rewind(file);
+  char contents[4096] = {};
+  fread(contents, 1, sizeof(contents) - 1, file);
+  fclose(file);
+  EXPECT_EQ(strstr(contents, "gone_thread"), nullptr);
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
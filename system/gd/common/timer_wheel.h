@@ -0,0 +1,315 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace bluetooth {
+namespace common {
+
+// Hierarchical timer wheel with millisecond resolution. Level L has kSlots slots of kSlots^L ms each; an entry sits in
+// the lowest level whose current slot range covers its deadline and is cascaded to lower levels as time advances, so
+// scheduling and cancelling are O(1). Entries are intrusive and owned by the caller. Not thread safe.
+class TimerWheel {
+ private:
+  struct List;
+
+ public:
+  static constexpr int kSlotBits = 6;
+  static constexpr size_t kSlots = 1 << kSlotBits;
+  static constexpr int kLevels = 6;
+
+  class Entry {
+   public:
+    Entry() = default;
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    bool IsScheduled() const {
+      return list_ != nullptr;
+    }
+
+    // The deadline the entry was scheduled with
+    uint64_t DeadlineMs() const {
+      return deadline_ms_;
+    }
+
+    // Free for the owner, e.g. to find its way back from an expired entry
+    void* context = nullptr;
+
+   private:
+    friend class TimerWheel;
+    uint64_t deadline_ms_ = 0;
+    Entry* prev_ = nullptr;
+    Entry* next_ = nullptr;
+    List* list_ = nullptr;
+  };
+
+  explicit TimerWheel(uint64_t now_ms) : current_ms_(now_ms) {}
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Round |deadline_ms| up so that timers with |slack_ms| of tolerance expire together. The result is at most
+  // |slack_ms| later.
+  static uint64_t CoalesceDeadline(uint64_t deadline_ms, uint64_t slack_ms) {
+    if (slack_ms < 2) {
+      return deadline_ms;
+    }
+    uint64_t granularity = uint64_t{1} << (63 - __builtin_clzll(slack_ms));
+    return (deadline_ms + granularity - 1) & ~(granularity - 1);
+  }
+
+  // Schedule |entry| to expire at |deadline_ms|, replacing its previous deadline. Deadlines in the past expire on the
+  // next call to Advance().
+  void Schedule(Entry* entry, uint64_t deadline_ms) {
+    if (entry->IsScheduled()) {
+      Cancel(entry);
+    }
+    entry->deadline_ms_ = deadline_ms;
+    insert(entry);
+    size_++;
+  }
+
+  // No-op if |entry| is not scheduled
+  void Cancel(Entry* entry) {
+    if (!entry->IsScheduled()) {
+      return;
+    }
+    unlink(entry);
+    size_--;
+  }
+
+  size_t Size() const {
+    return size_;
+  }
+
+  // Earliest deadline of the scheduled entries, no earlier than the time already processed
+  std::optional<uint64_t> NextDeadlineMs() const {
+    // Every entry of a level expires before the entries of the levels above
+    for (int level = 0; level < kLevels; level++) {
+      size_t index = slot_index(current_ms_, level);
+      uint64_t pending = occupied_[level] >> index;
+      if (pending == 0) {
+        continue;
+      }
+      size_t slot = index + __builtin_ctzll(pending);
+      if (level == 0) {
+        // A level 0 slot holds a single millisecond
+        return (current_ms_ & ~kSlotMask) + slot;
+      }
+      return earliest(slots_[level][slot]);
+    }
+    return earliest(overflow_);
+  }
+
+  // Expire every entry with a deadline up to |now_ms|, in deadline order. |on_expired| is called once the entry is
+  // no longer scheduled and may schedule it again.
+  template <typename Callback>
+  void Advance(uint64_t now_ms, Callback on_expired) {
+    while (current_ms_ <= now_ms) {
+      uint64_t pending = occupied_[0] >> slot_index(current_ms_, 0);
+      if (pending == 0) {
+        // Nothing left in this range, skip to the next cascade without going past |now_ms|
+        set_current(std::min(next_cascade_ms(), now_ms + 1));
+        continue;
+      }
+      uint64_t time = current_ms_ + __builtin_ctzll(pending);
+      if (time > now_ms) {
+        set_current(now_ms + 1);
+        break;
+      }
+      // Entries scheduled from |on_expired| land after the slot being expired, and cancelling an entry that is
+      // still waiting for its turn in |expiring_| takes it out
+      splice(&slots_[0][slot_index(time, 0)], &expiring_);
+      set_current(time + 1);
+      while (expiring_.head != nullptr) {
+        Entry* entry = expiring_.head;
+        unlink(entry);
+        size_--;
+        on_expired(entry);
+      }
+    }
+  }
+
+  // Visit every scheduled entry, in no particular order
+  template <typename Callback>
+  void ForEach(Callback callback) const {
+    for (int level = 0; level < kLevels; level++) {
+      for (size_t slot = 0; slot < kSlots; slot++) {
+        for (Entry* entry = slots_[level][slot].head; entry != nullptr; entry = entry->next_) {
+          callback(entry);
+        }
+      }
+    }
+    for (Entry* entry = overflow_.head; entry != nullptr; entry = entry->next_) {
+      callback(entry);
+    }
+  }
+
+ private:
+  static constexpr uint64_t kSlotMask = kSlots - 1;
+
+  struct List {
+    Entry* head = nullptr;
+    Entry* tail = nullptr;
+  };
+
+  static size_t slot_index(uint64_t time_ms, int level) {
+    return (time_ms >> (kSlotBits * level)) & kSlotMask;
+  }
+
+  static std::optional<uint64_t> earliest(const List& list) {
+    std::optional<uint64_t> next;
+    for (Entry* entry = list.head; entry != nullptr; entry = entry->next_) {
+      if (!next || entry->deadline_ms_ < *next) {
+        next = entry->deadline_ms_;
+      }
+    }
+    return next;
+  }
+
+  void insert(Entry* entry) {
+    uint64_t expiry = std::max(entry->deadline_ms_, current_ms_);
+    // The lowest level at which the expiry and the current time fall in the same range of the level above
+    uint64_t differing_bits = expiry ^ current_ms_;
+    int level = differing_bits == 0 ? 0 : (63 - __builtin_clzll(differing_bits)) / kSlotBits;
+    if (level >= kLevels) {
+      append(&overflow_, entry);
+      return;
+    }
+    size_t slot = slot_index(expiry, level);
+    append(&slots_[level][slot], entry);
+    occupied_[level] |= uint64_t{1} << slot;
+  }
+
+  // Start of the first occupied slot above level 0, where the next cascade brings entries down
+  uint64_t next_cascade_ms() const {
+    for (int level = 1; level < kLevels; level++) {
+      size_t index = slot_index(current_ms_, level);
+      uint64_t pending = occupied_[level] >> index;
+      if (pending != 0) {
+        int shift = kSlotBits * level;
+        uint64_t range_start = current_ms_ >> (shift + kSlotBits) << (shift + kSlotBits);
+        return range_start + (uint64_t{index + __builtin_ctzll(pending)} << shift);
+      }
+    }
+    if (overflow_.head != nullptr) {
+      int shift = kSlotBits * kLevels;
+      return ((current_ms_ >> shift) + 1) << shift;
+    }
+    return UINT64_MAX;
+  }
+
+  // Slots covering the current time are cascaded as soon as it is reached, so an entry never waits in a slot of a
+  // level above 0 that has started
+  void set_current(uint64_t time_ms) {
+    current_ms_ = time_ms;
+    if ((time_ms & kSlotMask) == 0) {
+      cascade(time_ms);
+    }
+  }
+
+  // Move the entries of the slots starting at |time_ms| one level down, beginning with the highest level so that
+  // entries landing in a lower slot that starts now are cascaded again
+  void cascade(uint64_t time_ms) {
+    int top = 1;
+    while (top < kLevels && slot_index(time_ms, top) == 0) {
+      top++;
+    }
+    if (top == kLevels) {
+      redistribute(&overflow_);
+      top--;
+    }
+    for (int level = top; level >= 1; level--) {
+      size_t slot = slot_index(time_ms, level);
+      redistribute(&slots_[level][slot]);
+    }
+  }
+
+  void redistribute(List* list) {
+    Entry* entry = list->head;
+    while (entry != nullptr) {
+      Entry* next = entry->next_;
+      unlink(entry);
+      insert(entry);
+      entry = next;
+    }
+  }
+
+  void splice(List* from, List* to) {
+    while (from->head != nullptr) {
+      Entry* entry = from->head;
+      unlink(entry);
+      append(to, entry);
+    }
+  }
+
+  bool is_slot(const List* list) const {
+    return list >= &slots_[0][0] && list < &slots_[0][0] + kLevels * kSlots;
+  }
+
+  void append(List* list, Entry* entry) {
+    entry->list_ = list;
+    entry->prev_ = list->tail;
+    entry->next_ = nullptr;
+    if (list->tail != nullptr) {
+      list->tail->next_ = entry;
+    } else {
+      list->head = entry;
+    }
+    list->tail = entry;
+  }
+
+  void unlink(Entry* entry) {
+    List* list = entry->list_;
+    if (entry->prev_ != nullptr) {
+      entry->prev_->next_ = entry->next_;
+    } else {
+      list->head = entry->next_;
+    }
+    if (entry->next_ != nullptr) {
+      entry->next_->prev_ = entry->prev_;
+    } else {
+      list->tail = entry->prev_;
+    }
+    entry->prev_ = nullptr;
+    entry->next_ = nullptr;
+    entry->list_ = nullptr;
+
+    if (list->head == nullptr && is_slot(list)) {
+      size_t index = list - &slots_[0][0];
+      occupied_[index / kSlots] &= ~(uint64_t{1} << (index % kSlots));
+    }
+  }
+
+  // Every deadline before this has expired
+  uint64_t current_ms_;
+  size_t size_ = 0;
+  uint64_t occupied_[kLevels] = {};
+  List slots_[kLevels][kSlots];
+  // Deadlines beyond the range of the top level, redistributed when the top level wraps
+  List overflow_;
+  // Entries of the slot being expired
+  List expiring_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::common::TimerWheel;
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  std::vector<uint64_t> AdvanceTo(uint64_t now_ms) {
+    std::vector<uint64_t> expired;
+    wheel_.Advance(now_ms, [&](TimerWheel::Entry* entry) {
+      EXPECT_FALSE(entry->IsScheduled());
+      EXPECT_LE(entry->DeadlineMs(), now_ms);
+      expired.push_back(entry->DeadlineMs());
+    });
+    return expired;
+  }
+
+  TimerWheel wheel_{1000};
+};
+
+TEST_F(TimerWheelTest, empty) {
+  ASSERT_FALSE(wheel_.NextDeadlineMs());
+  ASSERT_TRUE(AdvanceTo(100000).empty());
+}
+
+TEST_F(TimerWheelTest, expire_in_order) {
+  TimerWheel::Entry entries[4];
+  wheel_.Schedule(&entries[0], 1010);
+  wheel_.Schedule(&entries[1], 1500);
+  wheel_.Schedule(&entries[2], 1001);
+  wheel_.Schedule(&entries[3], 70000);
+  ASSERT_EQ(wheel_.Size(), 4u);
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), 1001u);
+
+  ASSERT_EQ(AdvanceTo(1000), std::vector<uint64_t>());
+  ASSERT_EQ(AdvanceTo(1600), std::vector<uint64_t>({1001, 1010, 1500}));
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), 70000u);
+  ASSERT_EQ(AdvanceTo(69999), std::vector<uint64_t>());
+  ASSERT_EQ(AdvanceTo(70000), std::vector<uint64_t>({70000}));
+  ASSERT_EQ(wheel_.Size(), 0u);
+}
+
+TEST_F(TimerWheelTest, past_deadline_expires_next) {
+  AdvanceTo(2000);
+  TimerWheel::Entry entry;
+  wheel_.Schedule(&entry, 1500);
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), 2001u);
+  ASSERT_EQ(AdvanceTo(2001), std::vector<uint64_t>({1500}));
+}
+
+TEST_F(TimerWheelTest, cancel_and_reschedule) {
+  TimerWheel::Entry first;
+  TimerWheel::Entry second;
+  wheel_.Schedule(&first, 1100);
+  wheel_.Schedule(&second, 1200);
+  wheel_.Cancel(&first);
+  ASSERT_FALSE(first.IsScheduled());
+  wheel_.Cancel(&first);
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), 1200u);
+
+  wheel_.Schedule(&second, 5000);
+  ASSERT_EQ(wheel_.Size(), 1u);
+  ASSERT_EQ(AdvanceTo(4999), std::vector<uint64_t>());
+  ASSERT_EQ(AdvanceTo(5000), std::vector<uint64_t>({5000}));
+}
+
+TEST_F(TimerWheelTest, reschedule_from_callback) {
+  TimerWheel::Entry periodic;
+  wheel_.Schedule(&periodic, 1010);
+  std::vector<uint64_t> expired;
+  wheel_.Advance(1100, [&](TimerWheel::Entry* entry) {
+    expired.push_back(entry->DeadlineMs());
+    wheel_.Schedule(entry, entry->DeadlineMs() + 10);
+  });
+  ASSERT_EQ(expired, std::vector<uint64_t>({1010, 1020, 1030, 1040, 1050, 1060, 1070, 1080, 1090, 1100}));
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), 1110u);
+}
+
+TEST_F(TimerWheelTest, cancel_expiring_from_callback) {
+  TimerWheel::Entry first;
+  TimerWheel::Entry second;
+  wheel_.Schedule(&first, 1050);
+  wheel_.Schedule(&second, 1050);
+  int expired = 0;
+  wheel_.Advance(1050, [&](TimerWheel::Entry* entry) {
+    expired++;
+    wheel_.Cancel(entry == &first ? &second : &first);
+  });
+  ASSERT_EQ(expired, 1);
+  ASSERT_EQ(wheel_.Size(), 0u);
+}
+
+TEST_F(TimerWheelTest, far_deadline_overflows) {
+  TimerWheel::Entry entry;
+  uint64_t deadline = 1000 + (uint64_t{1} << 40);
+  wheel_.Schedule(&entry, deadline);
+  ASSERT_EQ(*wheel_.NextDeadlineMs(), deadline);
+  ASSERT_TRUE(AdvanceTo(deadline - 1).empty());
+  ASSERT_EQ(AdvanceTo(deadline), std::vector<uint64_t>({deadline}));
+}
+
+TEST_F(TimerWheelTest, coalesce_deadline) {
+  ASSERT_EQ(TimerWheel::CoalesceDeadline(1001, 0), 1001u);
+  ASSERT_EQ(TimerWheel::CoalesceDeadline(1001, 1), 1001u);
+  ASSERT_EQ(TimerWheel::CoalesceDeadline(1001, 100), 1024u);
+  ASSERT_EQ(TimerWheel::CoalesceDeadline(1024, 100), 1024u);
+  ASSERT_EQ(TimerWheel::CoalesceDeadline(1030, 100), 1088u);
+}
+
+TEST_F(TimerWheelTest, random_deadlines_match_sorted_order) {
+  std::mt19937_64 random(42);
+  constexpr size_t kEntries = 2000;
+  std::vector<TimerWheel::Entry> entries(kEntries);
+  std::multimap<uint64_t, size_t> expected;
+  for (size_t i = 0; i < kEntries; i++) {
+    uint64_t deadline = 1000 + random() % 10000000;
+    wheel_.Schedule(&entries[i], deadline);
+    expected.emplace(deadline, i);
+  }
+  for (size_t i = 0; i < kEntries; i += 7) {
+    wheel_.Cancel(&entries[i]);
+    for (auto it = expected.begin(); it != expected.end(); it++) {
+      if (it->second == i) {
+        expected.erase(it);
+        break;
+      }
+    }
+  }
+
+  std::vector<uint64_t> expired;
+  uint64_t now = 1000;
+  while (wheel_.Size() > 0) {
+    auto next = wheel_.NextDeadlineMs();
+    ASSERT_TRUE(next);
+    ASSERT_EQ(*next, expected.begin()->first);
+    now += 1 + random() % 50000;
+    for (uint64_t deadline : AdvanceTo(now)) {
+      expired.push_back(deadline);
+    }
+    while (!expected.empty() && expected.begin()->first <= now) {
+      expected.erase(expected.begin());
+    }
+  }
+  ASSERT_TRUE(expected.empty());
+  ASSERT_TRUE(std::is_sorted(expired.begin(), expired.end()));
+  ASSERT_EQ(expired.size(), kEntries - (kEntries + 6) / 7);
+}
+
+}  // namespace testing
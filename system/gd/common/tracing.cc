@@ -0,0 +1,244 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/tracing.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+namespace tracing {
+
+namespace internal {
+std::atomic_bool enabled = false;
+}  // namespace internal
+
+namespace {
+
+// Rings of threads that have exited are kept for the next dump, up to this many
+constexpr size_t kMaxRetiredRings = 16;
+
+struct Event {
+  uint64_t timestamp_ns;
+  const char* category;
+  const char* name;
+  uint16_t handle;
+  uint16_t cid;
+  Phase phase;
+};
+
+// Written by its thread only. Every field is a relaxed atomic so that a dump can read slots while they are being
+// overwritten, the dump then discards the slots that may have changed under it.
+class Ring {
+ public:
+  explicit Ring(uint32_t tid) : tid_(tid) {}
+
+  void Write(const Event& event) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[head % kEventsPerThread];
+    slot.timestamp_ns.store(event.timestamp_ns, std::memory_order_relaxed);
+    slot.category.store(event.category, std::memory_order_relaxed);
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.args.store(static_cast<uint32_t>(event.handle) << 16 | event.cid, std::memory_order_relaxed);
+    slot.phase.store(static_cast<uint8_t>(event.phase), std::memory_order_relaxed);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  void Read(std::vector<Event>* events) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > kEventsPerThread ? head - kEventsPerThread : 0;
+    std::vector<Event> copied;
+    copied.reserve(head - first);
+    for (uint64_t i = first; i < head; i++) {
+      const Slot& slot = slots_[i % kEventsPerThread];
+      uint32_t args = slot.args.load(std::memory_order_relaxed);
+      copied.push_back({
+          slot.timestamp_ns.load(std::memory_order_relaxed),
+          slot.category.load(std::memory_order_relaxed),
+          slot.name.load(std::memory_order_relaxed),
+          static_cast<uint16_t>(args >> 16),
+          static_cast<uint16_t>(args),
+          static_cast<Phase>(slot.phase.load(std::memory_order_relaxed)),
+      });
+    }
+    // Slots the writer got to while they were copied hold a mix of two events
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t new_head = head_.load(std::memory_order_relaxed);
+    uint64_t overwritten = new_head > kEventsPerThread ? new_head - kEventsPerThread : 0;
+    size_t skip = overwritten > first ? std::min<uint64_t>(overwritten - first, copied.size()) : 0;
+    events->insert(events->end(), copied.begin() + skip, copied.end());
+  }
+
+  void Clear() {
+    clear_requested_.store(true, std::memory_order_relaxed);
+  }
+
+  // Called by the writer before it records, so that only the writer moves the head
+  void ClearIfRequested() {
+    if (clear_requested_.exchange(false, std::memory_order_relaxed)) {
+      head_.store(0, std::memory_order_release);
+    }
+  }
+
+  uint32_t tid() const {
+    return tid_;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> timestamp_ns{0};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint32_t> args{0};
+    std::atomic<uint8_t> phase{0};
+  };
+
+  const uint32_t tid_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic_bool clear_requested_{false};
+  std::array<Slot, kEventsPerThread> slots_;
+};
+
+std::mutex rings_mutex;
+std::vector<std::shared_ptr<Ring>> live_rings;
+std::vector<std::shared_ptr<Ring>> retired_rings;
+
+// Registers the ring of its thread on first use, and retires it when the thread exits
+class ThreadRing {
+ public:
+  ThreadRing() : ring_(std::make_shared<Ring>(static_cast<uint32_t>(syscall(SYS_gettid)))) {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    live_rings.push_back(ring_);
+  }
+
+  ~ThreadRing() {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    live_rings.erase(std::find(live_rings.begin(), live_rings.end(), ring_));
+    retired_rings.push_back(ring_);
+    if (retired_rings.size() > kMaxRetiredRings) {
+      retired_rings.erase(retired_rings.begin());
+    }
+  }
+
+  Ring& ring() {
+    return *ring_;
+  }
+
+ private:
+  std::shared_ptr<Ring> ring_;
+};
+
+uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void append_escaped(std::string* out, const char* text) {
+  for (const char* c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      out->push_back('\\');
+    }
+    out->push_back(*c);
+  }
+}
+
+}  // namespace
+
+void Enable(bool enabled) {
+  internal::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Record(const char* category, const char* name, Phase phase, uint16_t handle, uint16_t cid) {
+  thread_local ThreadRing thread_ring;
+  Ring& ring = thread_ring.ring();
+  ring.ClearIfRequested();
+  ring.Write({now_ns(), category, name, handle, cid, phase});
+}
+
+std::string ToChromeTraceJson() {
+  std::vector<std::pair<uint32_t, std::vector<Event>>> threads;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    for (const auto* rings : {&live_rings, &retired_rings}) {
+      for (const auto& ring : *rings) {
+        threads.emplace_back(ring->tid(), std::vector<Event>());
+        ring->Read(&threads.back().second);
+      }
+    }
+  }
+
+  std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  char buffer[128];
+  int pid = getpid();
+  for (const auto& [tid, events] : threads) {
+    for (const Event& event : events) {
+      json += first ? "" : ",";
+      first = false;
+      json += "{\"cat\":\"";
+      append_escaped(&json, event.category);
+      json += "\",\"name\":\"";
+      append_escaped(&json, event.name);
+      snprintf(
+          buffer,
+          sizeof(buffer),
+          "\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"pid\":%d,\"tid\":%" PRIu32,
+          static_cast<char>(event.phase),
+          event.timestamp_ns / 1000,
+          event.timestamp_ns % 1000,
+          pid,
+          tid);
+      json += buffer;
+      if (event.phase == Phase::INSTANT) {
+        json += ",\"s\":\"t\"";
+      }
+      snprintf(buffer, sizeof(buffer), ",\"args\":{\"handle\":%u,\"cid\":%u}}", event.handle, event.cid);
+      json += buffer;
+    }
+  }
+  json += "]}";
+  return json;
+}
+
+void Dump(int fd) {
+  dprintf(fd, "\nBluetooth trace events, load in ui.perfetto.dev or chrome://tracing:\n");
+  if (!IsEnabled()) {
+    dprintf(fd, "  Tracing is disabled\n");
+  }
+  std::string json = ToChromeTraceJson();
+  dprintf(fd, "%s\n", json.c_str());
+}
+
+void Clear() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  for (auto& ring : live_rings) {
+    ring->Clear();
+  }
+  retired_rings.clear();
+}
+
+}  // namespace tracing
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Trace points for the data paths, cheap enough to stay compiled in. While tracing is disabled a trace point is a
+// relaxed atomic load. Once enabled, each thread records into its own ring buffer without taking a lock, and the
+// last events of every thread can be dumped in the Chrome trace event format, which Perfetto also reads.
+//
+// |category| and |name| must be string literals, only their address is recorded.
+//
+//   void send_acl(uint16_t handle) {
+//     BT_TRACE_SCOPE("acl", "send_acl", handle, 0);
+//     ...
+//   }
+
+namespace bluetooth {
+namespace common {
+namespace tracing {
+
+enum class Phase : uint8_t {
+  BEGIN = 'B',
+  END = 'E',
+  INSTANT = 'i',
+};
+
+// Events kept per thread, the oldest are overwritten
+constexpr size_t kEventsPerThread = 2048;
+
+namespace internal {
+extern std::atomic_bool enabled;
+}  // namespace internal
+
+void Enable(bool enabled);
+
+inline bool IsEnabled() {
+  return internal::enabled.load(std::memory_order_relaxed);
+}
+
+// |handle| and |cid| identify the link and channel the event is about, 0 when they don't apply
+void Record(const char* category, const char* name, Phase phase, uint16_t handle, uint16_t cid);
+
+// The recorded events of all threads, as a Chrome trace event JSON object
+std::string ToChromeTraceJson();
+
+// Write ToChromeTraceJson() to |fd|, for dumpsys
+void Dump(int fd);
+
+// Drop the recorded events
+void Clear();
+
+class ScopedTrace {
+ public:
+  ScopedTrace(const char* category, const char* name, uint16_t handle, uint16_t cid)
+      : category_(category), name_(name), handle_(handle), cid_(cid), active_(IsEnabled()) {
+    if (active_) {
+      Record(category_, name_, Phase::BEGIN, handle_, cid_);
+    }
+  }
+
+  ~ScopedTrace() {
+    if (active_) {
+      Record(category_, name_, Phase::END, handle_, cid_);
+    }
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+  uint16_t handle_;
+  uint16_t cid_;
+  bool active_;
+};
+
+}  // namespace tracing
+}  // namespace common
+}  // namespace bluetooth
+
+#define BT_TRACE_CONCAT_INNER(a, b) a##b
+#define BT_TRACE_CONCAT(a, b) BT_TRACE_CONCAT_INNER(a, b)
+
+// Trace the rest of the enclosing scope
+#define BT_TRACE_SCOPE(category, name, handle, cid) \
+  ::bluetooth::common::tracing::ScopedTrace BT_TRACE_CONCAT(bt_trace_scope_, __LINE__)(category, name, handle, cid)
+
+// Trace a point in time
+#define BT_TRACE_INSTANT(category, name, handle, cid)                                                           \
+  do {                                                                                                           \
+    if (::bluetooth::common::tracing::IsEnabled()) {                                                             \
+      ::bluetooth::common::tracing::Record(category, name, ::bluetooth::common::tracing::Phase::INSTANT, handle, \
+                                           cid);                                                                 \
+    }                                                                                                            \
+  } while (0)
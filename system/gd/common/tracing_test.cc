@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/tracing.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace bluetooth {
+namespace common {
+namespace tracing {
+namespace {
+
+size_t CountOf(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    count++;
+  }
+  return count;
+}
+
+class TracingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Clear();
+    Enable(true);
+  }
+
+  void TearDown() override {
+    Enable(false);
+    Clear();
+  }
+};
+
+TEST_F(TracingTest, nothing_recorded_while_disabled) {
+  Enable(false);
+  {
+    BT_TRACE_SCOPE("test", "disabled_scope", 1, 2);
+    BT_TRACE_INSTANT("test", "disabled_instant", 1, 2);
+  }
+  EXPECT_EQ(CountOf(ToChromeTraceJson(), "disabled_"), 0u);
+}
+
+TEST_F(TracingTest, scope_records_begin_and_end) {
+  {
+    BT_TRACE_SCOPE("test", "scope", 0x40, 0x41);
+    BT_TRACE_INSTANT("test", "instant", 0x40, 0);
+  }
+  std::string json = ToChromeTraceJson();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+  EXPECT_EQ(CountOf(json, "\"name\":\"scope\",\"ph\":\"B\""), 1u);
+  EXPECT_EQ(CountOf(json, "\"name\":\"scope\",\"ph\":\"E\""), 1u);
+  EXPECT_EQ(CountOf(json, "\"name\":\"instant\",\"ph\":\"i\""), 1u);
+  EXPECT_EQ(CountOf(json, "\"args\":{\"handle\":64,\"cid\":65}"), 2u);
+  EXPECT_LT(json.find("\"ph\":\"B\""), json.find("\"ph\":\"i\""));
+  EXPECT_LT(json.find("\"ph\":\"i\""), json.find("\"ph\":\"E\""));
+}
+
+TEST_F(TracingTest, keeps_last_events_of_each_thread) {
+  for (size_t i = 0; i < kEventsPerThread + 10; i++) {
+    BT_TRACE_INSTANT("test", "main_thread", 0, 0);
+  }
+  std::thread([] { BT_TRACE_INSTANT("test", "other_thread", 0, 0); }).join();
+
+  std::string json = ToChromeTraceJson();
+  EXPECT_EQ(CountOf(json, "main_thread"), kEventsPerThread);
+  EXPECT_EQ(CountOf(json, "other_thread"), 1u);
+}
+
+TEST_F(TracingTest, clear_drops_events) {
+  BT_TRACE_INSTANT("test", "before_clear", 0, 0);
+  Clear();
+  BT_TRACE_INSTANT("test", "after_clear", 0, 0);
+  std::string json = ToChromeTraceJson();
+  EXPECT_EQ(CountOf(json, "before_clear"), 0u);
+  EXPECT_EQ(CountOf(json, "after_clear"), 1u);
+}
+
+TEST_F(TracingTest, dump_while_recording) {
+  std::atomic_bool done = false;
+  std::thread writer([&done] {
+    while (!done) {
+      BT_TRACE_SCOPE("test", "busy", 1, 1);
+    }
+  });
+  for (int i = 0; i < 20; i++) {
+    std::string json = ToChromeTraceJson();
+    EXPECT_EQ(json.back(), '}');
+  }
+  done = true;
+  writer.join();
+}
+
+}  // namespace
+}  // namespace tracing
+}  // namespace common
+}  // namespace bluetooth
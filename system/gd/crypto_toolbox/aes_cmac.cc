@@ -25,6 +25,7 @@
 #include <algorithm>
 
 #include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/aes_hw.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 
 namespace bluetooth {
@@ -57,23 +58,43 @@ static void xor_128(Octet16* a, const Octet16& b) {
 }
 }  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
+static_assert(
+    sizeof(Aes128Key) == AES128_KEY_SCHEDULE_LEN && sizeof(aes_context::ksch) >= AES128_KEY_SCHEDULE_LEN,
+    "Unexpected AES-128 key schedule size");
+
+Aes128Key::Aes128Key(const Octet16& key) {
   Octet16 key_reversed;
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+
+  aes_context ctx;
+  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
+  std::copy(ctx.ksch, ctx.ksch + round_keys_.size(), round_keys_.begin());
+}
+
+Octet16 Aes128Key::Encrypt(const Octet16& message) const {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
 
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
-  aes_encrypt(message_reversed.data(), output.data(), &ctx);
+  if (aes_hw_supported()) {
+    aes_hw_encrypt_128(round_keys_.data(), message_reversed.data(), output.data());
+  } else {
+    aes_context ctx;
+    std::copy(round_keys_.begin(), round_keys_.end(), ctx.ksch);
+    ctx.rnd = 10;
+    aes_encrypt(message_reversed.data(), output.data(), &ctx);
+  }
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  return Aes128Key(key).Encrypt(message);
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * OCTET16_LEN memory space; where include length bytes valid data. */
@@ -96,7 +117,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const Aes128Key& key) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -105,7 +126,9 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], x);
 
-    output = aes_128(key, &cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], OCTET16_LEN);
+    Octet16 block;
+    std::copy_n(&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], OCTET16_LEN, block.begin());
+    output = key.Encrypt(block);
     x = output;
     i++;
   }
@@ -136,9 +159,9 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 /** This is the function to generate the two subkeys.
  * |key| is CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const Aes128Key& key) {
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero.data(), OCTET16_LEN);
+  Octet16 p = key.Encrypt(zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -168,7 +191,7 @@ static void cmac_generate_subkey(const Octet16& key) {
  *  input - text to be signed in little endian byte order.
  *  length - length of the input in byte.
  */
-Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
+Octet16 aes_cmac(const Aes128Key& key, const uint8_t* input, uint16_t length) {
   uint32_t len;
   uint16_t diff;
   /* n is number of rounds */
@@ -201,5 +224,9 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
   return signature;
 }
 
+Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
+  return aes_cmac(Aes128Key(key), input, length);
+}
+
 }  // namespace crypto_toolbox
 }  // namespace bluetooth
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "crypto_toolbox/aes_hw.h"
+
+// The AES instructions are only enabled on the functions using them, so the
+// rest of the library keeps running on CPUs without them.
+#if defined(__x86_64__) || defined(__i386__)
+#define AES_HW_X86
+#include <cpuid.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#define AES_HW_ARM64
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace bluetooth {
+namespace crypto_toolbox {
+
+namespace {
+
+#if defined(AES_HW_X86)
+
+bool probe_aes_hw() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+  return (ecx & bit_AES) != 0;
+}
+
+__attribute__((target("aes,sse2"))) void encrypt_128(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) {
+  const __m128i* rk = reinterpret_cast<const __m128i*>(round_keys);
+  __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_loadu_si128(rk));
+  for (int r = 1; r < 10; r++) {
+    block = _mm_aesenc_si128(block, _mm_loadu_si128(rk + r));
+  }
+  block = _mm_aesenclast_si128(block, _mm_loadu_si128(rk + 10));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+}
+
+#elif defined(AES_HW_ARM64)
+
+bool probe_aes_hw() {
+  return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+}
+
+#if defined(__clang__)
+#define AES_HW_TARGET "aes"
+#else
+#define AES_HW_TARGET "+crypto"
+#endif
+
+// AESE performs AddRoundKey before SubBytes and ShiftRows, hence the last
+// round key is added separately.
+__attribute__((target(AES_HW_TARGET))) void encrypt_128(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) {
+  uint8x16_t block = vld1q_u8(in);
+  for (int r = 0; r < 9; r++) {
+    block = vaesmcq_u8(vaeseq_u8(block, vld1q_u8(round_keys + 16 * r)));
+  }
+  block = vaeseq_u8(block, vld1q_u8(round_keys + 16 * 9));
+  block = veorq_u8(block, vld1q_u8(round_keys + 16 * 10));
+  vst1q_u8(out, block);
+}
+
+#else
+
+bool probe_aes_hw() {
+  return false;
+}
+
+void encrypt_128(const uint8_t* /* round_keys */, const uint8_t* /* in */, uint8_t* /* out */) {}
+
+#endif
+
+}  // namespace
+
+bool aes_hw_supported() {
+  static const bool supported = probe_aes_hw();
+  return supported;
+}
+
+void aes_hw_encrypt_128(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) {
+  encrypt_128(round_keys, in, out);
+}
+
+}  // namespace crypto_toolbox
+}  // namespace bluetooth
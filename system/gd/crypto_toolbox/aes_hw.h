@@ -0,0 +1,38 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace bluetooth {
+namespace crypto_toolbox {
+
+// Number of bytes of an expanded AES-128 key schedule: 11 round keys.
+constexpr int AES128_KEY_SCHEDULE_LEN = 11 * 16;
+
+// Returns true if the CPU implements the AES instructions used by
+// aes_hw_encrypt_128(): AES-NI on x86 and the Crypto Extensions on ARMv8.
+// The CPU is only probed on the first call.
+bool aes_hw_supported();
+
+// Encrypts the 16 bytes block |in| into |out| with the AES-128 key schedule
+// |round_keys|, as expanded by aes_set_key(). Must only be called when
+// aes_hw_supported() returns true.
+void aes_hw_encrypt_128(const uint8_t* round_keys, const uint8_t* in, uint8_t* out);
+
+}  // namespace crypto_toolbox
+}  // namespace bluetooth
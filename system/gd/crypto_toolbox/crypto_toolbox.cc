@@ -51,7 +51,7 @@ Octet16 f4(uint8_t* u, uint8_t* v, const Octet16& x, uint8_t z) {
 
 /** helper for f5 */
 static Octet16 calculate_mac_key_or_ltk(
-    const Octet16& t,
+    const Aes128Key& t,
     uint8_t counter,
     uint8_t* key_id,
     const Octet16& n1,
@@ -81,7 +81,7 @@ void f5(uint8_t* w, const Octet16& n1, const Octet16& n2, uint8_t* a1, uint8_t*
   //          7);
 
   const Octet16 salt{0xBE, 0x83, 0x60, 0x5A, 0xDB, 0x0B, 0x37, 0x60, 0x38, 0xA5, 0xF5, 0xAA, 0x91, 0x83, 0x88, 0x6C};
-  Octet16 t = aes_cmac(salt, w, OCTET32_LEN);
+  Aes128Key t(aes_cmac(salt, w, OCTET32_LEN));
 
   // DVLOG(2) << "T=" << HexEncode(t.data(), t.size());
 
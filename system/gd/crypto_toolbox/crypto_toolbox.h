@@ -38,7 +38,22 @@ Octet16 c1(
     const uint8_t* ra);
 Octet16 s1(const Octet16& k, const Octet16& r1, const Octet16& r2);
 
+/* AES-128 key with its key schedule expanded once, for the callers using the
+ * same key for several blocks. |key| is in the same little endian order as
+ * for aes_128(). */
+class Aes128Key {
+ public:
+  explicit Aes128Key(const Octet16& key);
+
+  /* Returns AES_128(key, message) */
+  Octet16 Encrypt(const Octet16& message) const;
+
+ private:
+  std::array<uint8_t, 11 * OCTET16_LEN> round_keys_;
+};
+
 Octet16 aes_128(const Octet16& key, const Octet16& message);
+Octet16 aes_cmac(const Aes128Key& key, const uint8_t* message, uint16_t length);
 Octet16 aes_cmac(const Octet16& key, const uint8_t* message, uint16_t length);
 Octet16 f4(uint8_t* u, uint8_t* v, const Octet16& x, uint8_t z);
 void f5(
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/aes_hw.h"
 
 namespace bluetooth {
 namespace crypto_toolbox {
@@ -352,5 +353,94 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// Deterministic pseudo random blocks for the bit-exactness tests
+static Octet16 pseudo_random_block(uint32_t* seed) {
+  Octet16 block;
+  for (auto& b : block) {
+    *seed = *seed * 1103515245 + 12345;
+    b = *seed >> 24;
+  }
+  return block;
+}
+
+// FIPS-197 Appendix C.1
+TEST(CryptoToolboxTest, aes_128_key_fips_197_test) {
+  Octet16 k{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+  Octet16 m{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+  Octet16 expected{0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+
+  // algorithm expect all input to be in little endian format, so reverse
+  std::reverse(std::begin(k), std::end(k));
+  std::reverse(std::begin(m), std::end(m));
+  std::reverse(std::begin(expected), std::end(expected));
+
+  Aes128Key key(k);
+  EXPECT_EQ(key.Encrypt(m), expected);
+  EXPECT_EQ(key.Encrypt(m), expected);
+  EXPECT_EQ(aes_128(k, m), expected);
+}
+
+TEST(CryptoToolboxTest, aes_128_key_matches_software_test) {
+  uint32_t seed = 1;
+  for (int i = 0; i < 256; i++) {
+    Octet16 k = pseudo_random_block(&seed);
+    Aes128Key key(k);
+
+    Octet16 k_reversed;
+    std::reverse_copy(k.begin(), k.end(), k_reversed.begin());
+    aes_context ctx;
+    aes_set_key(k_reversed.data(), k_reversed.size(), &ctx);
+
+    for (int j = 0; j < 4; j++) {
+      Octet16 m = pseudo_random_block(&seed);
+      Octet16 expected;
+      Octet16 m_reversed;
+      std::reverse_copy(m.begin(), m.end(), m_reversed.begin());
+      aes_encrypt(m_reversed.data(), expected.data(), &ctx);
+      std::reverse(std::begin(expected), std::end(expected));
+
+      EXPECT_EQ(key.Encrypt(m), expected);
+      EXPECT_EQ(aes_128(k, m), expected);
+    }
+  }
+}
+
+TEST(CryptoToolboxTest, aes_hw_matches_software_test) {
+  if (!aes_hw_supported()) {
+    GTEST_SKIP() << "No AES instructions on this CPU";
+  }
+
+  uint32_t seed = 2;
+  for (int i = 0; i < 1024; i++) {
+    Octet16 k = pseudo_random_block(&seed);
+    Octet16 m = pseudo_random_block(&seed);
+    aes_context ctx;
+    aes_set_key(k.data(), k.size(), &ctx);
+
+    uint8_t expected[OCTET16_LEN];
+    uint8_t output[OCTET16_LEN];
+    aes_encrypt(m.data(), expected, &ctx);
+    aes_hw_encrypt_128(ctx.ksch, m.data(), output);
+    EXPECT_TRUE(memcmp(output, expected, OCTET16_LEN) == 0);
+  }
+}
+
+TEST(CryptoToolboxTest, aes_cmac_prekeyed_test) {
+  uint32_t seed = 3;
+  uint8_t m[64];
+  for (int i = 0; i < 16; i++) {
+    Octet16 k = pseudo_random_block(&seed);
+    for (size_t j = 0; j < sizeof(m); j += OCTET16_LEN) {
+      Octet16 block = pseudo_random_block(&seed);
+      std::copy(block.begin(), block.end(), m + j);
+    }
+
+    Aes128Key key(k);
+    for (uint16_t length = 0; length <= sizeof(m); length += 7) {
+      EXPECT_EQ(aes_cmac(key, m, length), aes_cmac(k, m, length));
+    }
+  }
+}
+
 }  // namespace crypto_toolbox
 }  // namespace bluetooth
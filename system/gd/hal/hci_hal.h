@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "module.h"
@@ -25,8 +26,35 @@ namespace hal {
 
 using HciPacket = std::vector<uint8_t>;
 
+// An HCI packet that lives inside a larger, refcounted receive buffer (e.g. a pooled buffer that also holds the H4
+// packet type byte). The buffer may be shared and must be treated as immutable.
+struct HciPacketSlice {
+  std::shared_ptr<const std::vector<uint8_t>> buffer;
+  size_t begin;
+  size_t end;
+
+  const uint8_t* data() const {
+    return buffer->data() + begin;
+  }
+
+  size_t size() const {
+    return end - begin;
+  }
+
+  HciPacket ToHciPacket() const {
+    return HciPacket(buffer->begin() + begin, buffer->begin() + end);
+  }
+};
+
 enum class Status : int32_t { SUCCESS, TRANSPORT_ERROR, INITIALIZATION_ERROR, UNKNOWN };
 
+// A received HCI packet tagged with its H4 packet type, used for batched delivery
+struct ReceivedHciPacket {
+  enum class Type { EVENT, ACL, SCO, ISO };
+  Type type;
+  HciPacketSlice slice;
+};
+
 // Mirrors hardware/interfaces/bluetooth/1.0/IBluetoothHciCallbacks.hal in Android, but moved initializationComplete
 // callback to BluetoothInitializationCompleteCallback
 
@@ -51,6 +79,45 @@ class HciHalCallbacks {
   // Send an ISO data packet from the controller to the host
   // @param data the ISO HCI packet to be passed to the host stack
   virtual void isoDataReceived(HciPacket data) = 0;
+
+  // Zero-copy variants of the callbacks above, used by HALs that receive into shared buffers. The default
+  // implementations copy the slice into an HciPacket.
+  virtual void hciEventSliceReceived(HciPacketSlice event) {
+    hciEventReceived(event.ToHciPacket());
+  }
+
+  virtual void aclDataSliceReceived(HciPacketSlice data) {
+    aclDataReceived(data.ToHciPacket());
+  }
+
+  virtual void scoDataSliceReceived(HciPacketSlice data) {
+    scoDataReceived(data.ToHciPacket());
+  }
+
+  virtual void isoDataSliceReceived(HciPacketSlice data) {
+    isoDataReceived(data.ToHciPacket());
+  }
+
+  // Several packets drained from the transport in one wakeup, in arrival order. The default implementation
+  // dispatches them one by one to the slice callbacks.
+  virtual void hciPacketBatchReceived(std::vector<ReceivedHciPacket> packets) {
+    for (auto& packet : packets) {
+      switch (packet.type) {
+        case ReceivedHciPacket::Type::EVENT:
+          hciEventSliceReceived(std::move(packet.slice));
+          break;
+        case ReceivedHciPacket::Type::ACL:
+          aclDataSliceReceived(std::move(packet.slice));
+          break;
+        case ReceivedHciPacket::Type::SCO:
+          scoDataSliceReceived(std::move(packet.slice));
+          break;
+        case ReceivedHciPacket::Type::ISO:
+          isoDataSliceReceived(std::move(packet.slice));
+          break;
+      }
+    }
+  }
 };
 
 // Mirrors hardware/interfaces/bluetooth/1.0/IBluetoothHci.hal in Android
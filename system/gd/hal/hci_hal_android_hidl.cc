@@ -30,8 +30,11 @@
 #undef LOG_INFO
 #undef LOG_WARNING
 
+#include <atomic>
+#include <chrono>
 #include <future>
-#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
 #include "btaa/activity_attribution.h"
@@ -71,7 +74,7 @@ class HciDeathRecipient : public ::android::hardware::hidl_death_recipient {
 android::sp<HciDeathRecipient> hci_death_recipient_ = new HciDeathRecipient();
 
 template <class VecType>
-std::string GetTimerText(const char* func_name, VecType vec) {
+std::string GetTimerText(const char* func_name, const VecType& vec) {
   return common::StringFormat(
       "%s: len %zu, 1st 5 bytes '%s'",
       func_name,
@@ -79,6 +82,75 @@ std::string GetTimerText(const char* func_name, VecType vec) {
       common::ToHexString(vec.begin(), std::min(vec.end(), vec.begin() + 5)).c_str());
 }
 
+// Receive callbacks that run for longer than this are recorded in the stop watch log in fast receive mode
+constexpr std::chrono::milliseconds kSlowReceiveCallbackThreshold(5);
+
+// Times one receive callback. Every callback is recorded in the stop watch log with its length and first bytes,
+// unless gd_hal_fast_receive is set: then only the clock is read, and the text is built and recorded only when
+// the callback ran for longer than kSlowReceiveCallbackThreshold.
+template <class VecType>
+class ReceiveStopWatch {
+ public:
+  ReceiveStopWatch(bool fast_receive, const char* func_name, const VecType& vec)
+      : func_name_(func_name), vec_(vec), start_timestamp_(std::chrono::high_resolution_clock::now()) {
+    if (!fast_receive) {
+      stop_watch_.emplace(GetTimerText(func_name, vec));
+    }
+  }
+
+  ~ReceiveStopWatch() {
+    if (stop_watch_.has_value()) {
+      return;
+    }
+    auto end_timestamp = std::chrono::high_resolution_clock::now();
+    if (end_timestamp - start_timestamp_ >= kSlowReceiveCallbackThreshold) {
+      common::StopWatch::RecordElapsed(GetTimerText(func_name_, vec_), start_timestamp_, end_timestamp);
+    }
+  }
+
+ private:
+  const char* func_name_;
+  const VecType& vec_;
+  std::chrono::high_resolution_clock::time_point start_timestamp_;
+  std::optional<common::StopWatch> stop_watch_;
+};
+
+// The registered HciHalCallbacks, read by every receive callback without taking a lock. Readers announce
+// themselves in |readers_| before loading the pointer, and Reset() waits for the readers in flight after clearing
+// it, so the callbacks are not used once unregisterIncomingPacketCallback() has returned.
+class IncomingPacketCallback {
+ public:
+  void Set(HciHalCallbacks* callback) {
+    ASSERT(callback != nullptr);
+    HciHalCallbacks* expected = nullptr;
+    bool registered = callback_.compare_exchange_strong(expected, callback);
+    ASSERT(registered);
+  }
+
+  void Reset() {
+    callback_.store(nullptr);
+    while (readers_.load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Runs |dispatch| with the registered callbacks, returns false when none are registered
+  template <class DispatchFn>
+  bool Dispatch(DispatchFn dispatch) {
+    readers_.fetch_add(1);
+    HciHalCallbacks* callback = callback_.load();
+    if (callback != nullptr) {
+      dispatch(callback);
+    }
+    readers_.fetch_sub(1);
+    return callback != nullptr;
+  }
+
+ private:
+  std::atomic<HciHalCallbacks*> callback_ = nullptr;
+  std::atomic<int> readers_ = 0;
+};
+
 class InternalHciCallbacks : public IBluetoothHciCallbacks_1_1 {
  public:
   InternalHciCallbacks(activity_attribution::ActivityAttribution* btaa_logger_, SnoopLogger* btsnoop_logger)
@@ -87,15 +159,12 @@ class InternalHciCallbacks : public IBluetoothHciCallbacks_1_1 {
   }
 
   void SetCallback(HciHalCallbacks* callback) {
-    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-    ASSERT(callback_ == nullptr && callback != nullptr);
-    callback_ = callback;
+    callback_.Set(callback);
   }
 
   void ResetCallback() {
-    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
+    callback_.Reset();
     LOG_INFO("callbacks have been reset!");
-    callback_ = nullptr;
   }
 
   std::promise<void>* GetInitPromise() {
@@ -111,72 +180,56 @@ class InternalHciCallbacks : public IBluetoothHciCallbacks_1_1 {
   }
 
   Return<void> hciEventReceived(const hidl_vec<uint8_t>& event) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, event));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, event);
     std::vector<uint8_t> received_hci_packet(event.begin(), event.end());
     btsnoop_logger_->Capture(received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::EVT);
     }
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->hciEventReceived(std::move(received_hci_packet));
-      }
-    }
+    callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->hciEventReceived(std::move(received_hci_packet)); });
     return Void();
   }
 
   Return<void> aclDataReceived(const hidl_vec<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::ACL);
     }
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->aclDataReceived(std::move(received_hci_packet));
-      }
-    }
+    callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->aclDataReceived(std::move(received_hci_packet)); });
     return Void();
   }
 
   Return<void> scoDataReceived(const hidl_vec<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::SCO);
     }
 
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->scoDataReceived(std::move(received_hci_packet));
-      }
-    }
+    callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->scoDataReceived(std::move(received_hci_packet)); });
     return Void();
   }
 
   Return<void> isoDataReceived(const hidl_vec<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
 
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->isoDataReceived(std::move(received_hci_packet));
-      }
-    }
+    callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->isoDataReceived(std::move(received_hci_packet)); });
     return Void();
   }
 
  private:
-  std::mutex incoming_packet_callback_mutex_;
   std::promise<void>* init_promise_ = nullptr;
-  HciHalCallbacks* callback_ = nullptr;
+  IncomingPacketCallback callback_;
+  bool fast_receive_ = common::InitFlags::IsHalFastReceiveEnabled();
   activity_attribution::ActivityAttribution* btaa_logger_ = nullptr;
   SnoopLogger* btsnoop_logger_ = nullptr;
 };
@@ -193,14 +246,11 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   void SetCallback(HciHalCallbacks* callback) {
-    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-    ASSERT(callback_ == nullptr && callback != nullptr);
-    callback_ = callback;
+    callback_.Set(callback);
   }
 
   void ResetCallback() {
-    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-    callback_ = nullptr;
+    callback_.Reset();
   }
 
   std::promise<void>* GetInitPromise() {
@@ -215,21 +265,15 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   ::ndk::ScopedAStatus hciEventReceived(const std::vector<uint8_t>& event) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, event));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, event);
     std::vector<uint8_t> received_hci_packet(event.begin(), event.end());
     btsnoop_logger_->Capture(
         received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::EVT);
     }
-    bool sent = false;
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->hciEventReceived(std::move(received_hci_packet));
-        sent = true;
-      }
-    }
+    bool sent = callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->hciEventReceived(std::move(received_hci_packet)); });
     if (!sent) {
       LOG_INFO("Dropping HCI Event, since callback_ is null");
     }
@@ -237,21 +281,15 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   ::ndk::ScopedAStatus aclDataReceived(const std::vector<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(
         received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::ACL);
     }
-    bool sent = false;
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->aclDataReceived(std::move(received_hci_packet));
-        sent = true;
-      }
-    }
+    bool sent = callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->aclDataReceived(std::move(received_hci_packet)); });
     if (!sent) {
       LOG_INFO("Dropping ACL Data, since callback_ is null");
     }
@@ -259,21 +297,15 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   ::ndk::ScopedAStatus scoDataReceived(const std::vector<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(
         received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
     if (common::init_flags::btaa_hci_is_enabled()) {
       btaa_logger_->Capture(received_hci_packet, SnoopLogger::PacketType::SCO);
     }
-    bool sent = false;
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->scoDataReceived(std::move(received_hci_packet));
-        sent = true;
-      }
-    }
+    bool sent = callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->scoDataReceived(std::move(received_hci_packet)); });
     if (!sent) {
       LOG_INFO("Dropping SCO Data, since callback_ is null");
     }
@@ -281,18 +313,12 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   ::ndk::ScopedAStatus isoDataReceived(const std::vector<uint8_t>& data) override {
-    common::StopWatch stop_watch(GetTimerText(__func__, data));
+    ReceiveStopWatch stop_watch(fast_receive_, __func__, data);
     std::vector<uint8_t> received_hci_packet(data.begin(), data.end());
     btsnoop_logger_->Capture(
         received_hci_packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
-    bool sent = false;
-    {
-      std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
-      if (callback_ != nullptr) {
-        callback_->isoDataReceived(std::move(received_hci_packet));
-        sent = true;
-      }
-    }
+    bool sent = callback_.Dispatch(
+        [&](HciHalCallbacks* callback) { callback->isoDataReceived(std::move(received_hci_packet)); });
     if (!sent) {
       LOG_INFO("Dropping ISO Data, since callback_ is null");
     }
@@ -300,9 +326,9 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
  private:
-  std::mutex incoming_packet_callback_mutex_;
   std::promise<void>* init_promise_ = nullptr;
-  HciHalCallbacks* callback_ = nullptr;
+  IncomingPacketCallback callback_;
+  bool fast_receive_ = common::InitFlags::IsHalFastReceiveEnabled();
   activity_attribution::ActivityAttribution* btaa_logger_ = nullptr;
   SnoopLogger* btsnoop_logger_ = nullptr;
 };
@@ -21,8 +21,10 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <array>
 #include <chrono>
 #include <csignal>
 #include <mutex>
@@ -31,6 +33,7 @@
 #include "gd/common/init_flags.h"
 #include "hal/hci_hal.h"
 #include "hal/mgmt.h"
+#include "hal/receive_buffer_pool.h"
 #include "hal/snoop_logger.h"
 #include "metrics/counter_metrics.h"
 #include "os/log.h"
@@ -53,6 +56,12 @@ constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
 
+// Pooled buffers fit the largest EDR baseband payload (3-DH5, 1021 bytes) and everything shorter. Anything larger
+// spills into the overflow buffer, which fits the largest H4 packet the 16-bit ACL length field can describe.
+constexpr size_t kReceiveBufferPoolSize = 64;
+constexpr size_t kReceiveBatchSize = 16;
+constexpr size_t kMaxH4PacketSize = kH4HeaderSize + kHciAclHeaderSize + 0xffff;
+
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
 constexpr uint16_t HCI_CHANNEL_CONTROL = 3;
@@ -236,8 +245,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(command);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
-    packet.insert(packet.cbegin(), kH4Command);
-    write_to_fd(packet);
+    write_to_fd(kH4Command, std::move(packet));
   }
 
   void sendAclData(HciPacket data) override {
@@ -245,8 +253,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
-    packet.insert(packet.cbegin(), kH4Acl);
-    write_to_fd(packet);
+    write_to_fd(kH4Acl, std::move(packet));
   }
 
   void sendScoData(HciPacket data) override {
@@ -254,8 +261,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
-    packet.insert(packet.cbegin(), kH4Sco);
-    write_to_fd(packet);
+    write_to_fd(kH4Sco, std::move(packet));
   }
 
   void sendIsoData(HciPacket data) override {
@@ -263,8 +269,7 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ != INVALID_FD);
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ISO);
-    packet.insert(packet.cbegin(), kH4Iso);
-    write_to_fd(packet);
+    write_to_fd(kH4Iso, std::move(packet));
   }
 
   uint16_t getMsftOpcode() override {
@@ -282,6 +287,14 @@ class HciHalHost : public HciHal {
     ASSERT(sock_fd_ == INVALID_FD);
     sock_fd_ = ConnectToSocket();
     ASSERT(sock_fd_ != INVALID_FD);
+    batched_receive_ = bluetooth::common::InitFlags::IsHalBatchedReceiveEnabled();
+    if (batched_receive_ || bluetooth::common::InitFlags::IsHalZeroCopyReceiveEnabled()) {
+      receive_buffer_pool_ = std::make_unique<ReceiveBufferPool>(kBufSize, kReceiveBufferPoolSize);
+      // Left uninitialized so the kernel only commits the pages a long packet actually touches
+      for (auto& overflow_buffer : receive_overflow_buffers_) {
+        overflow_buffer.reset(new uint8_t[kMaxH4PacketSize - kBufSize]);
+      }
+    }
     reactable_ = hci_incoming_thread_.GetReactor()->Register(
         sock_fd_,
         common::Bind(&HciHalHost::incoming_packet_received, common::Unretained(this)),
@@ -309,6 +322,10 @@ class HciHalHost : public HciHal {
     }
     ::close(sock_fd_);
     sock_fd_ = INVALID_FD;
+    receive_buffer_pool_.reset();
+    for (auto& overflow_buffer : receive_overflow_buffers_) {
+      overflow_buffer.reset();
+    }
     LOG_INFO("HAL is closed");
   }
 
@@ -325,12 +342,22 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  // Packets are queued without their H4 packet type byte, which is written along with them, so that adding it never
+  // shifts the whole packet
+  struct OutgoingPacket {
+    uint8_t h4_type;
+    HciPacket packet;
+  };
+  std::queue<OutgoingPacket> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
+  // Only used on hci_incoming_thread_ when zero-copy or batched receive is enabled
+  bool batched_receive_ = false;
+  std::unique_ptr<ReceiveBufferPool> receive_buffer_pool_;
+  std::array<std::unique_ptr<uint8_t[]>, kReceiveBatchSize> receive_overflow_buffers_;
 
-  void write_to_fd(HciPacket packet) {
+  void write_to_fd(uint8_t h4_type, HciPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.push(OutgoingPacket{h4_type, std::move(packet)});
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
@@ -339,8 +366,12 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
+    auto& packet_to_send = hci_outgoing_queue_.front();
+    struct iovec iov[] = {
+        {&packet_to_send.h4_type, kH4HeaderSize},
+        {packet_to_send.packet.data(), packet_to_send.packet.size()},
+    };
+    auto bytes_written = writev(sock_fd_, iov, 2);
     hci_outgoing_queue_.pop();
     if (bytes_written == -1) {
       abort();
@@ -358,6 +389,14 @@ class HciHalHost : public HciHal {
         return;
       }
     }
+    if (batched_receive_) {
+      incoming_packets_received_in_batch();
+      return;
+    }
+    if (receive_buffer_pool_ != nullptr) {
+      incoming_packet_received_into_pool();
+      return;
+    }
     uint8_t buf[kBufSize] = {};
 
     ssize_t received_size;
@@ -469,6 +508,181 @@ class HciHalHost : public HciHal {
     }
     memset(buf, 0, kBufSize);
   }
+
+  // Receives straight into a pooled buffer that becomes the backing store of the HciLayer packet views.
+  void incoming_packet_received_into_pool() {
+    std::shared_ptr<std::vector<uint8_t>> buffer = receive_buffer_pool_->Acquire();
+    struct iovec iov[] = {
+        {.iov_base = buffer->data(), .iov_len = buffer->size()},
+        {.iov_base = receive_overflow_buffers_[0].get(), .iov_len = kMaxH4PacketSize - buffer->size()},
+    };
+
+    ssize_t received_size;
+    RUN_NO_INTR(received_size = readv(sock_fd_, iov, 2));
+    ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
+    if (received_size == 0) {
+      handle_eof();
+      return;
+    }
+
+    ReceivedHciPacket packet;
+    if (!parse_received_packet(std::move(buffer), received_size, 0, &packet)) {
+      return;
+    }
+    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
+    if (incoming_packet_callback_ == nullptr) {
+      LOG_INFO("Dropping a packet after processing");
+      return;
+    }
+    switch (packet.type) {
+      case ReceivedHciPacket::Type::EVENT:
+        incoming_packet_callback_->hciEventSliceReceived(std::move(packet.slice));
+        break;
+      case ReceivedHciPacket::Type::ACL:
+        incoming_packet_callback_->aclDataSliceReceived(std::move(packet.slice));
+        break;
+      case ReceivedHciPacket::Type::SCO:
+        incoming_packet_callback_->scoDataSliceReceived(std::move(packet.slice));
+        break;
+      case ReceivedHciPacket::Type::ISO:
+        incoming_packet_callback_->isoDataSliceReceived(std::move(packet.slice));
+        break;
+    }
+  }
+
+  // Drains up to kReceiveBatchSize queued packets with a single recvmmsg() and hands them to the stack as one batch.
+  void incoming_packets_received_in_batch() {
+    std::array<std::shared_ptr<std::vector<uint8_t>>, kReceiveBatchSize> buffers;
+    std::array<std::array<struct iovec, 2>, kReceiveBatchSize> iovs;
+    std::array<struct mmsghdr, kReceiveBatchSize> msgs = {};
+    for (size_t i = 0; i < kReceiveBatchSize; i++) {
+      buffers[i] = receive_buffer_pool_->Acquire();
+      iovs[i][0] = {.iov_base = buffers[i]->data(), .iov_len = buffers[i]->size()};
+      iovs[i][1] = {.iov_base = receive_overflow_buffers_[i].get(), .iov_len = kMaxH4PacketSize - buffers[i]->size()};
+      msgs[i].msg_hdr.msg_iov = iovs[i].data();
+      msgs[i].msg_hdr.msg_iovlen = iovs[i].size();
+    }
+
+    int received_count;
+    RUN_NO_INTR(received_count = recvmmsg(sock_fd_, msgs.data(), msgs.size(), MSG_DONTWAIT, nullptr));
+    if (received_count == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    ASSERT_LOG(received_count != -1, "Can't receive from socket: %s", strerror(errno));
+
+    std::vector<ReceivedHciPacket> batch;
+    batch.reserve(received_count);
+    for (int i = 0; i < received_count; i++) {
+      if (msgs[i].msg_len == 0) {
+        handle_eof();
+        return;
+      }
+      ReceivedHciPacket packet;
+      if (parse_received_packet(std::move(buffers[i]), msgs[i].msg_len, i, &packet)) {
+        batch.push_back(std::move(packet));
+      }
+    }
+    if (batch.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
+    if (incoming_packet_callback_ == nullptr) {
+      LOG_INFO("Dropping %zu packets after processing", batch.size());
+      return;
+    }
+    incoming_packet_callback_->hciPacketBatchReceived(std::move(batch));
+  }
+
+  void handle_eof() {
+    LOG_WARN("Can't read H4 header. EOF received");
+    // First close sock fd before raising sigint
+    close(sock_fd_);
+    raise(SIGINT);
+  }
+
+  // Validates the H4 framing of a packet received into |buffer|, plus receive_overflow_buffers_[overflow_index] when
+  // it did not fit, and logs it to btsnoop. Returns false for packets that must be dropped.
+  bool parse_received_packet(
+      std::shared_ptr<std::vector<uint8_t>> buffer,
+      size_t packet_size,
+      size_t overflow_index,
+      ReceivedHciPacket* packet) {
+    if (packet_size > buffer->size()) {
+      // Only packets longer than a 3-DH5 payload get here; stitch them into a dedicated buffer.
+      auto large_buffer = std::make_shared<std::vector<uint8_t>>(*buffer);
+      const uint8_t* overflow = receive_overflow_buffers_[overflow_index].get();
+      large_buffer->insert(large_buffer->end(), overflow, overflow + (packet_size - buffer->size()));
+      buffer = std::move(large_buffer);
+    }
+    const uint8_t* buf = buffer->data();
+
+    SnoopLogger::PacketType snoop_type;
+    switch (buf[0]) {
+      case kH4Event: {
+        ASSERT_LOG(
+            packet_size >= kH4HeaderSize + kHciEvtHeaderSize, "Received bad HCI_EVT packet size: %zu", packet_size);
+        size_t payload_size = packet_size - (kH4HeaderSize + kHciEvtHeaderSize);
+        uint8_t hci_evt_parameter_total_length = buf[2];
+        ASSERT_LOG(
+            payload_size == hci_evt_parameter_total_length,
+            "malformed HCI event total parameter size received: %zu != %d",
+            payload_size,
+            hci_evt_parameter_total_length);
+        packet->type = ReceivedHciPacket::Type::EVENT;
+        snoop_type = SnoopLogger::PacketType::EVT;
+        break;
+      }
+      case kH4Acl: {
+        ASSERT_LOG(
+            packet_size >= kH4HeaderSize + kHciAclHeaderSize, "Received bad HCI_ACL packet size: %zu", packet_size);
+        size_t payload_size = packet_size - (kH4HeaderSize + kHciAclHeaderSize);
+        uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
+        ASSERT_LOG(
+            payload_size == hci_acl_data_total_length,
+            "malformed ACL length received: %zu != %d",
+            payload_size,
+            hci_acl_data_total_length);
+        packet->type = ReceivedHciPacket::Type::ACL;
+        snoop_type = SnoopLogger::PacketType::ACL;
+        break;
+      }
+      case kH4Sco: {
+        ASSERT_LOG(
+            packet_size >= kH4HeaderSize + kHciScoHeaderSize, "Received bad HCI_SCO packet size: %zu", packet_size);
+        size_t payload_size = packet_size - (kH4HeaderSize + kHciScoHeaderSize);
+        uint8_t hci_sco_data_total_length = buf[3];
+        ASSERT_LOG(
+            payload_size == hci_sco_data_total_length,
+            "malformed SCO length received: %zu != %d",
+            payload_size,
+            hci_sco_data_total_length);
+        packet->type = ReceivedHciPacket::Type::SCO;
+        snoop_type = SnoopLogger::PacketType::SCO;
+        break;
+      }
+      case kH4Iso: {
+        ASSERT_LOG(
+            packet_size >= kH4HeaderSize + kHciIsoHeaderSize, "Received bad HCI_ISO packet size: %zu", packet_size);
+        size_t payload_size = packet_size - (kH4HeaderSize + kHciIsoHeaderSize);
+        uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
+        ASSERT_LOG(
+            payload_size == hci_iso_data_total_length,
+            "malformed ISO length received: %zu != %d",
+            payload_size,
+            hci_iso_data_total_length);
+        packet->type = ReceivedHciPacket::Type::ISO;
+        snoop_type = SnoopLogger::PacketType::ISO;
+        break;
+      }
+      default:
+        LOG_WARN("Dropping a packet with unknown H4 type 0x%02hhx", buf[0]);
+        return false;
+    }
+
+    packet->slice = HciPacketSlice{.buffer = std::move(buffer), .begin = kH4HeaderSize, .end = packet_size};
+    btsnoop_logger_->Capture(packet->slice.data(), packet->slice.size(), SnoopLogger::Direction::INCOMING, snoop_type);
+    return true;
+  }
 };
 
 const ModuleFactory HciHal::Factory = ModuleFactory([]() { return new HciHalHost(); });
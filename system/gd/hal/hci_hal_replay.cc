@@ -0,0 +1,291 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_hal_replay.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "hal/snoop_logger_common.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+constexpr size_t kPacketHeaderSize = 24;
+constexpr uint32_t kFlagReceived = 1 << 0;
+
+constexpr uint8_t kCommandCompleteEventCode = 0x0e;
+constexpr uint8_t kCommandStatusEventCode = 0x0f;
+// Host Number Of Completed Packets is the one command the controller does not answer
+constexpr uint16_t kHostNumCompletedPacketsOpCode = 0x0c35;
+
+uint32_t read_be32(const uint8_t* data) {
+  return (uint32_t{data[0]} << 24) | (uint32_t{data[1]} << 16) | (uint32_t{data[2]} << 8) | data[3];
+}
+
+uint64_t read_be64(const uint8_t* data) {
+  return (uint64_t{read_be32(data)} << 32) | read_be32(data + 4);
+}
+
+// The opcode a Command Complete or Command Status event answers, or nothing for other events
+std::optional<uint16_t> response_opcode(const HciPacket& event) {
+  if (event.size() >= 5 && event[0] == kCommandCompleteEventCode) {
+    return event[3] | (event[4] << 8);
+  }
+  if (event.size() >= 6 && event[0] == kCommandStatusEventCode) {
+    return event[4] | (event[5] << 8);
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+std::optional<std::vector<SnoopRecord>> ParseBtsnoop(const uint8_t* data, size_t size) {
+  const auto& file_header = SnoopLoggerCommon::kBtSnoopFileHeader;
+  if (size < sizeof(file_header) || memcmp(data, &file_header, sizeof(file_header)) != 0) {
+    return std::nullopt;
+  }
+
+  std::vector<SnoopRecord> records;
+  std::optional<uint64_t> first_timestamp;
+  for (size_t offset = sizeof(file_header); offset + kPacketHeaderSize <= size;) {
+    const uint8_t* header = data + offset;
+    uint32_t length_original = read_be32(header);
+    uint32_t length_captured = read_be32(header + 4);
+    uint32_t flags = read_be32(header + 8);
+    uint64_t timestamp = read_be64(header + 16);
+    offset += kPacketHeaderSize;
+    if (length_captured > size - offset) {
+      LOG_WARN("Dropping truncated packet at the end of the capture");
+      break;
+    }
+    const uint8_t* packet = data + offset;
+    offset += length_captured;
+
+    if (length_captured == 0 || packet[0] < SnoopLogger::PacketType::CMD ||
+        packet[0] > SnoopLogger::PacketType::ISO) {
+      continue;
+    }
+    if (!first_timestamp.has_value()) {
+      first_timestamp = timestamp;
+    }
+    SnoopRecord record{
+        .timestamp = std::chrono::microseconds(timestamp - *first_timestamp),
+        .type = static_cast<SnoopLogger::PacketType>(packet[0]),
+        .direction = (flags & kFlagReceived) ? SnoopLogger::Direction::INCOMING : SnoopLogger::Direction::OUTGOING,
+        .packet = HciPacket(packet + 1, packet + length_captured),
+    };
+    // Filtered captures cut payloads short, pad them back so that the length fields still hold
+    if (length_original > length_captured) {
+      record.packet.resize(length_original - 1);
+    }
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+std::optional<std::vector<SnoopRecord>> ReadBtsnoopFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    LOG_ERROR("Unable to open %s", path.c_str());
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return ParseBtsnoop(bytes.data(), bytes.size());
+}
+
+ReplayHciHal::ReplayHciHal(std::vector<SnoopRecord> records) {
+  for (auto& record : records) {
+    if (record.direction != SnoopLogger::Direction::INCOMING || record.type == SnoopLogger::PacketType::CMD) {
+      continue;
+    }
+    if (record.type == SnoopLogger::PacketType::EVT) {
+      auto opcode = response_opcode(record.packet);
+      // Responses without an opcode only return command credits and can come at any time
+      if (opcode.has_value() && *opcode != 0) {
+        recorded_responses_[*opcode].push_back(std::move(record.packet));
+        continue;
+      }
+    }
+    incoming_.push_back(std::move(record));
+  }
+  reset_responses();
+  thread_ = std::thread(&ReplayHciHal::run, this);
+}
+
+ReplayHciHal::~ReplayHciHal() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void ReplayHciHal::registerIncomingPacketCallback(HciHalCallbacks* callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_ = callback;
+}
+
+void ReplayHciHal::unregisterIncomingPacketCallback() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_ = nullptr;
+}
+
+void ReplayHciHal::sendHciCommand(HciPacket command) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_command_count_++;
+    if (command.size() < 2 || (command[0] | (command[1] << 8)) == kHostNumCompletedPacketsOpCode) {
+      return;
+    }
+    pending_commands_.push_back(std::move(command));
+  }
+  cv_.notify_all();
+}
+
+void ReplayHciHal::sendAclData(HciPacket /* data */) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sent_acl_count_++;
+}
+
+void ReplayHciHal::sendScoData(HciPacket /* data */) {}
+
+void ReplayHciHal::sendIsoData(HciPacket /* data */) {}
+
+void ReplayHciHal::Replay(double speed) {
+  std::future<void> done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_LOG(!replaying_, "A replay is already running");
+    replay_done_ = std::promise<void>();
+    done = replay_done_.get_future();
+    speed_ = speed;
+    replay_start_ = std::chrono::steady_clock::now();
+    next_record_ = 0;
+    replaying_ = true;
+    reset_responses();
+  }
+  cv_.notify_all();
+  done.wait();
+}
+
+size_t ReplayHciHal::GetReplayedPacketCount() const {
+  return incoming_.size();
+}
+
+uint64_t ReplayHciHal::GetSentCommandCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sent_command_count_;
+}
+
+uint64_t ReplayHciHal::GetSentAclCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sent_acl_count_;
+}
+
+uint64_t ReplayHciHal::GetSynthesizedResponseCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return synthesized_response_count_;
+}
+
+void ReplayHciHal::reset_responses() {
+  responses_.clear();
+  for (const auto& [opcode, responses] : recorded_responses_) {
+    responses_[opcode] = std::deque<HciPacket>(responses.begin(), responses.end());
+  }
+}
+
+HciPacket ReplayHciHal::take_response(HciPacket command) {
+  uint16_t opcode = command[0] | (command[1] << 8);
+  auto recorded = responses_.find(opcode);
+  if (recorded != responses_.end()) {
+    // The last response of an opcode answers any further command with it
+    HciPacket response = recorded->second.front();
+    if (recorded->second.size() > 1) {
+      recorded->second.pop_front();
+    }
+    return response;
+  }
+  synthesized_response_count_++;
+  return {kCommandCompleteEventCode, 0x04, 0x01, command[0], command[1], 0x00 /* SUCCESS */};
+}
+
+void ReplayHciHal::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    HciHalCallbacks* callbacks = callbacks_;
+    if (!pending_commands_.empty()) {
+      HciPacket command = std::move(pending_commands_.front());
+      pending_commands_.pop_front();
+      HciPacket response = take_response(std::move(command));
+      if (callbacks != nullptr) {
+        lock.unlock();
+        callbacks->hciEventReceived(std::move(response));
+        lock.lock();
+      }
+      continue;
+    }
+    if (!replaying_) {
+      cv_.wait(lock);
+      continue;
+    }
+    if (next_record_ == incoming_.size()) {
+      replaying_ = false;
+      replay_done_.set_value();
+      continue;
+    }
+    const SnoopRecord& record = incoming_[next_record_];
+    if (speed_ > 0) {
+      auto due = replay_start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double, std::micro>(record.timestamp.count() / speed_));
+      if (std::chrono::steady_clock::now() < due) {
+        cv_.wait_until(lock, due);
+        continue;
+      }
+    }
+    next_record_++;
+    if (callbacks != nullptr) {
+      lock.unlock();
+      deliver(record, callbacks);
+      lock.lock();
+    }
+  }
+}
+
+void ReplayHciHal::deliver(const SnoopRecord& record, HciHalCallbacks* callbacks) {
+  switch (record.type) {
+    case SnoopLogger::PacketType::EVT:
+      callbacks->hciEventReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::ACL:
+      callbacks->aclDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::SCO:
+      callbacks->scoDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::ISO:
+      callbacks->isoDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::CMD:
+      break;
+  }
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hal/hci_hal.h"
+#include "hal/snoop_logger.h"
+
+namespace bluetooth {
+namespace hal {
+
+// A packet of a btsnoop capture
+struct SnoopRecord {
+  // Since the first packet of the capture
+  std::chrono::microseconds timestamp;
+  SnoopLogger::PacketType type;
+  SnoopLogger::Direction direction;
+  // Without the H4 packet type
+  HciPacket packet;
+};
+
+// Parse a btsnoop capture with the H4 datalink type, as written by SnoopLogger. Captures from bug reports can be
+// converted from btsnooz with tools/scripts/btsnooz.py. Returns nothing if the header is not a btsnoop one; a
+// truncated last packet is dropped.
+std::optional<std::vector<SnoopRecord>> ParseBtsnoop(const uint8_t* data, size_t size);
+std::optional<std::vector<SnoopRecord>> ReadBtsnoopFile(const std::string& path);
+
+// A HAL that plays the controller side of a capture back into the stack, to reproduce field performance problems
+// deterministically.
+//
+// Replay() delivers the recorded controller to host packets from its own thread, like a HAL thread would, at the
+// recorded pace or faster. Command Complete and Command Status events are not part of that timeline. They are instead
+// sent in answer to the commands the stack actually sends: the next recorded response for the opcode if there is one,
+// otherwise a successful response of the kind the capture used for that opcode, so that HciLayer always sees its own
+// commands answered whatever the stack state is.
+class ReplayHciHal : public HciHal {
+ public:
+  explicit ReplayHciHal(std::vector<SnoopRecord> records);
+  ReplayHciHal(const ReplayHciHal&) = delete;
+  ReplayHciHal& operator=(const ReplayHciHal&) = delete;
+  ~ReplayHciHal();
+
+  void registerIncomingPacketCallback(HciHalCallbacks* callback) override;
+  void unregisterIncomingPacketCallback() override;
+
+  void sendHciCommand(HciPacket command) override;
+  void sendAclData(HciPacket data) override;
+  void sendScoData(HciPacket data) override;
+  void sendIsoData(HciPacket data) override;
+
+  // Deliver the recorded packets |speed| times faster than recorded, or as fast as possible when |speed| is 0. Blocks
+  // until every packet was handed to the stack. Can be called again to replay the capture once more.
+  void Replay(double speed);
+
+  // Number of recorded controller to host packets delivered by Replay(), responses excluded
+  size_t GetReplayedPacketCount() const;
+
+  // Number of packets the stack sent, per type
+  uint64_t GetSentCommandCount() const;
+  uint64_t GetSentAclCount() const;
+
+  // Number of commands answered with a synthesized response because the capture had none left for them
+  uint64_t GetSynthesizedResponseCount() const;
+
+  void ListDependencies(ModuleList*) const override {}
+  void Start() override {}
+  void Stop() override {}
+  std::string ToString() const override {
+    return std::string("ReplayHciHal");
+  }
+
+ private:
+  void run();
+  void reset_responses();
+  HciPacket take_response(HciPacket command);
+  static void deliver(const SnoopRecord& record, HciHalCallbacks* callbacks);
+
+  // Controller to host packets, without the command responses
+  std::vector<SnoopRecord> incoming_;
+  // The recorded command responses of each opcode, in capture order
+  std::map<uint16_t, std::vector<HciPacket>> recorded_responses_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  HciHalCallbacks* callbacks_ = nullptr;
+  std::map<uint16_t, std::deque<HciPacket>> responses_;
+  std::deque<HciPacket> pending_commands_;
+  bool stopping_ = false;
+  bool replaying_ = false;
+  double speed_ = 0;
+  std::chrono::steady_clock::time_point replay_start_;
+  size_t next_record_ = 0;
+  std::promise<void> replay_done_;
+  uint64_t sent_command_count_ = 0;
+  uint64_t sent_acl_count_ = 0;
+  uint64_t synthesized_response_count_ = 0;
+  std::thread thread_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
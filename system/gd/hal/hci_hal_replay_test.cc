@@ -0,0 +1,172 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_hal_replay.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "common/blocking_queue.h"
+#include "hal/snoop_logger_common.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::seconds;
+
+constexpr uint32_t kFlagReceived = 1 << 0;
+constexpr uint32_t kFlagCommandOrEvent = 1 << 1;
+
+// The reset command, its Command Complete, and a Read BD_ADDR command with none recorded
+const HciPacket kReset = {0x03, 0x0c, 0x00};
+const HciPacket kResetComplete = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+const HciPacket kReadBdAddr = {0x09, 0x10, 0x00};
+const HciPacket kDisconnectionComplete = {0x05, 0x04, 0x00, 0x23, 0x01, 0x13};
+const HciPacket kAcl = {0x23, 0x21, 0x02, 0x00, 0xaa, 0xbb};
+
+void AppendBe32(std::vector<uint8_t>& bytes, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    bytes.push_back(value >> shift);
+  }
+}
+
+class BtsnoopWriter {
+ public:
+  BtsnoopWriter() {
+    const auto& header = SnoopLoggerCommon::kBtSnoopFileHeader;
+    auto begin = reinterpret_cast<const uint8_t*>(&header);
+    bytes_.insert(bytes_.end(), begin, begin + sizeof(header));
+  }
+
+  void Add(uint64_t timestamp_us, SnoopLogger::PacketType type, uint32_t flags, const HciPacket& packet,
+           size_t captured = SIZE_MAX) {
+    uint32_t length = packet.size() + 1;
+    uint32_t length_captured = std::min<size_t>(length, captured);
+    AppendBe32(bytes_, length);
+    AppendBe32(bytes_, length_captured);
+    AppendBe32(bytes_, flags);
+    AppendBe32(bytes_, 0);
+    AppendBe32(bytes_, timestamp_us >> 32);
+    AppendBe32(bytes_, timestamp_us & 0xffffffff);
+    bytes_.push_back(type);
+    bytes_.insert(bytes_.end(), packet.begin(), packet.begin() + length_captured - 1);
+  }
+
+  const std::vector<uint8_t>& Bytes() const {
+    return bytes_;
+  }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+class TestCallbacks : public HciHalCallbacks {
+ public:
+  void hciEventReceived(HciPacket event) override {
+    events.push(std::move(event));
+  }
+  void aclDataReceived(HciPacket data) override {
+    acl.push(std::move(data));
+  }
+  void scoDataReceived(HciPacket) override {}
+  void isoDataReceived(HciPacket) override {}
+
+  common::BlockingQueue<HciPacket> events;
+  common::BlockingQueue<HciPacket> acl;
+};
+
+TEST(HciHalReplayTest, parse_rejects_other_files) {
+  std::vector<uint8_t> bytes(64, 0);
+  EXPECT_FALSE(ParseBtsnoop(bytes.data(), bytes.size()).has_value());
+}
+
+TEST(HciHalReplayTest, parse_records) {
+  BtsnoopWriter writer;
+  writer.Add(1000, SnoopLogger::PacketType::CMD, kFlagCommandOrEvent, kReset);
+  writer.Add(1500, SnoopLogger::PacketType::EVT, kFlagReceived | kFlagCommandOrEvent, kResetComplete);
+  // Filtered captures keep only the start of the payload
+  writer.Add(3000, SnoopLogger::PacketType::ACL, kFlagReceived, kAcl, 5);
+
+  auto records = ParseBtsnoop(writer.Bytes().data(), writer.Bytes().size());
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(records->size(), 3u);
+  EXPECT_EQ((*records)[0].timestamp, microseconds(0));
+  EXPECT_EQ((*records)[0].type, SnoopLogger::PacketType::CMD);
+  EXPECT_EQ((*records)[0].direction, SnoopLogger::Direction::OUTGOING);
+  EXPECT_EQ((*records)[0].packet, kReset);
+  EXPECT_EQ((*records)[1].timestamp, microseconds(500));
+  EXPECT_EQ((*records)[1].direction, SnoopLogger::Direction::INCOMING);
+  EXPECT_EQ((*records)[2].timestamp, microseconds(2000));
+  ASSERT_EQ((*records)[2].packet.size(), kAcl.size());
+  EXPECT_EQ((*records)[2].packet[3], kAcl[3]);
+  EXPECT_EQ((*records)[2].packet[5], 0);
+}
+
+TEST(HciHalReplayTest, parse_drops_truncated_last_packet) {
+  BtsnoopWriter writer;
+  writer.Add(1000, SnoopLogger::PacketType::ACL, kFlagReceived, kAcl);
+  auto bytes = writer.Bytes();
+  bytes.resize(bytes.size() - 1);
+  auto records = ParseBtsnoop(bytes.data(), bytes.size());
+  ASSERT_TRUE(records.has_value());
+  EXPECT_TRUE(records->empty());
+}
+
+TEST(HciHalReplayTest, replay_answers_commands_and_delivers_packets) {
+  BtsnoopWriter writer;
+  writer.Add(0, SnoopLogger::PacketType::CMD, kFlagCommandOrEvent, kReset);
+  writer.Add(10, SnoopLogger::PacketType::EVT, kFlagReceived | kFlagCommandOrEvent, kResetComplete);
+  writer.Add(20, SnoopLogger::PacketType::ACL, kFlagReceived, kAcl);
+  writer.Add(30, SnoopLogger::PacketType::EVT, kFlagReceived | kFlagCommandOrEvent, kDisconnectionComplete);
+  auto records = ParseBtsnoop(writer.Bytes().data(), writer.Bytes().size());
+  ASSERT_TRUE(records.has_value());
+
+  TestCallbacks callbacks;
+  ReplayHciHal hal(std::move(*records));
+  hal.registerIncomingPacketCallback(&callbacks);
+
+  // The recorded response answers the command, whenever the stack sends it
+  hal.sendHciCommand(kReset);
+  ASSERT_TRUE(callbacks.events.wait_to_take(seconds(1)));
+  EXPECT_EQ(callbacks.events.take(), kResetComplete);
+
+  // Commands the capture never answered get a successful Command Complete
+  hal.sendHciCommand(kReadBdAddr);
+  ASSERT_TRUE(callbacks.events.wait_to_take(seconds(1)));
+  HciPacket synthesized = callbacks.events.take();
+  EXPECT_EQ(synthesized[0], 0x0e);
+  EXPECT_EQ(synthesized[3], kReadBdAddr[0]);
+  EXPECT_EQ(synthesized[4], kReadBdAddr[1]);
+  EXPECT_EQ(hal.GetSynthesizedResponseCount(), 1u);
+
+  hal.Replay(0);
+  EXPECT_EQ(hal.GetReplayedPacketCount(), 2u);
+  ASSERT_TRUE(callbacks.acl.wait_to_take(seconds(1)));
+  EXPECT_EQ(callbacks.acl.take(), kAcl);
+  ASSERT_TRUE(callbacks.events.wait_to_take(seconds(1)));
+  EXPECT_EQ(callbacks.events.take(), kDisconnectionComplete);
+  EXPECT_FALSE(callbacks.events.wait_to_take(std::chrono::milliseconds(10)));
+
+  EXPECT_EQ(hal.GetSentCommandCount(), 2u);
+  hal.unregisterIncomingPacketCallback();
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
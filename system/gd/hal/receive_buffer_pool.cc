@@ -0,0 +1,60 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/receive_buffer_pool.h"
+
+#include <atomic>
+
+#include "common/allocation_hook.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+
+ReceiveBufferPool::ReceiveBufferPool(size_t buffer_size, size_t pool_size) : buffer_size_(buffer_size) {
+  ASSERT(buffer_size > 0 && pool_size > 0);
+  buffers_.reserve(pool_size);
+  for (size_t i = 0; i < pool_size; i++) {
+    buffers_.push_back(std::make_shared<std::vector<uint8_t>>(buffer_size));
+  }
+}
+
+std::shared_ptr<std::vector<uint8_t>> ReceiveBufferPool::Acquire() {
+  for (size_t i = 0; i < buffers_.size(); i++) {
+    auto& buffer = buffers_[next_];
+    next_ = (next_ + 1) % buffers_.size();
+    // Only the pool hands out references, so a use count of one cannot go back up behind our back.
+    if (buffer.use_count() == 1) {
+      // Pairs with the release of the last reader so that its reads happen before we overwrite the buffer
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return buffer;
+    }
+  }
+  miss_count_++;
+  common::NotifyAllocation("hal receive buffer pool miss", buffer_size_);
+  return std::make_shared<std::vector<uint8_t>>(buffer_size_);
+}
+
+size_t ReceiveBufferPool::GetBufferSize() const {
+  return buffer_size_;
+}
+
+size_t ReceiveBufferPool::GetMissCount() const {
+  return miss_count_;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
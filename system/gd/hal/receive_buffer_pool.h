@@ -0,0 +1,54 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+
+// A fixed set of equally sized, refcounted byte buffers. A buffer goes back to the pool as soon as every reader has
+// dropped its reference, so a HAL can receive straight into memory that later backs a packet::PacketView.
+//
+// Acquire() must always be called from the same thread. References to acquired buffers may be dropped on any thread.
+class ReceiveBufferPool {
+ public:
+  ReceiveBufferPool(size_t buffer_size, size_t pool_size);
+  ReceiveBufferPool(const ReceiveBufferPool&) = delete;
+  ReceiveBufferPool& operator=(const ReceiveBufferPool&) = delete;
+
+  // Returns a buffer of GetBufferSize() bytes that nobody else references. When every pooled buffer is still in use
+  // a new, unpooled buffer is allocated instead.
+  std::shared_ptr<std::vector<uint8_t>> Acquire();
+
+  size_t GetBufferSize() const;
+
+  // Number of Acquire() calls that had to fall back to the system allocator
+  size_t GetMissCount() const;
+
+ private:
+  const size_t buffer_size_;
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> buffers_;
+  size_t next_ = 0;
+  size_t miss_count_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
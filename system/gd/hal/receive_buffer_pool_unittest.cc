@@ -0,0 +1,82 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/receive_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+TEST(ReceiveBufferPoolTest, buffers_have_requested_size) {
+  ReceiveBufferPool pool(1029, 4);
+  ASSERT_EQ(pool.GetBufferSize(), 1029u);
+  auto buffer = pool.Acquire();
+  ASSERT_EQ(buffer->size(), 1029u);
+}
+
+TEST(ReceiveBufferPoolTest, released_buffer_is_reused) {
+  ReceiveBufferPool pool(16, 1);
+  const std::vector<uint8_t>* first = nullptr;
+  {
+    auto buffer = pool.Acquire();
+    first = buffer.get();
+  }
+  auto buffer = pool.Acquire();
+  ASSERT_EQ(buffer.get(), first);
+  ASSERT_EQ(pool.GetMissCount(), 0u);
+}
+
+TEST(ReceiveBufferPoolTest, buffer_in_use_is_not_handed_out_twice) {
+  ReceiveBufferPool pool(16, 2);
+  auto first = pool.Acquire();
+  auto second = pool.Acquire();
+  ASSERT_NE(first.get(), second.get());
+  ASSERT_EQ(pool.GetMissCount(), 0u);
+
+  // Every pooled buffer is referenced, so the next one comes from the allocator
+  auto third = pool.Acquire();
+  ASSERT_NE(third.get(), first.get());
+  ASSERT_NE(third.get(), second.get());
+  ASSERT_EQ(third->size(), 16u);
+  ASSERT_EQ(pool.GetMissCount(), 1u);
+}
+
+TEST(ReceiveBufferPoolTest, const_reference_keeps_buffer_alive) {
+  ReceiveBufferPool pool(16, 1);
+  std::shared_ptr<const std::vector<uint8_t>> reader = pool.Acquire();
+  auto buffer = pool.Acquire();
+  ASSERT_NE(buffer.get(), reader.get());
+  reader.reset();
+  buffer.reset();
+  ASSERT_EQ(pool.Acquire().use_count(), 2);
+}
+
+TEST(ReceiveBufferPoolTest, buffer_released_on_other_thread) {
+  ReceiveBufferPool pool(16, 1);
+  auto buffer = pool.Acquire();
+  const std::vector<uint8_t>* pooled = buffer.get();
+  std::thread reader([buffer = std::move(buffer)]() mutable { buffer.reset(); });
+  reader.join();
+  ASSERT_EQ(pool.Acquire().get(), pooled);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_ring_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "hal/snoop_logger_common.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr size_t kRecordSizeLength = sizeof(uint32_t);
+
+// Same permissions as the btsnoop files
+constexpr mode_t kRingFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
+uint32_t ToLittleEndian(uint32_t value) {
+  if constexpr (isLittleEndian) {
+    return value;
+  } else {
+    return __builtin_bswap32(value);
+  }
+}
+
+bool read_all(int fd, void* data, size_t size, off_t offset) {
+  uint8_t* bytes = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    ssize_t bytes_read;
+    RUN_NO_INTR(bytes_read = pread(fd, bytes, size, offset));
+    if (bytes_read <= 0) {
+      return false;
+    }
+    bytes += bytes_read;
+    size -= bytes_read;
+    offset += bytes_read;
+  }
+  return true;
+}
+
+// Copy size bytes at offset out of a circular area of data_size bytes
+void CopyOut(const uint8_t* area, size_t data_size, uint64_t offset, void* bytes, size_t size) {
+  size_t position = offset % data_size;
+  size_t first = std::min(size, data_size - position);
+  std::memcpy(bytes, area + position, first);
+  std::memcpy(static_cast<uint8_t*>(bytes) + first, area, size - first);
+}
+
+}  // namespace
+
+std::unique_ptr<SnoopLogRingFile> SnoopLogRingFile::Create(const std::string& path, size_t data_size) {
+  ASSERT(data_size > kRecordSizeLength);
+  int fd;
+  mode_t prevmask = umask(0);
+  RUN_NO_INTR(fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, kRingFileMode));
+  umask(prevmask);
+  if (fd == -1) {
+    LOG_ERROR("Unable to open snoop log ring at \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    return nullptr;
+  }
+  size_t file_size = kHeaderSize + data_size;
+  if (ftruncate(fd, file_size) != 0) {
+    LOG_ERROR("Unable to resize snoop log ring at \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+  void* mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    LOG_ERROR("Unable to map snoop log ring at \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+  return std::unique_ptr<SnoopLogRingFile>(new SnoopLogRingFile(fd, static_cast<uint8_t*>(mapping), data_size));
+}
+
+SnoopLogRingFile::SnoopLogRingFile(int fd, uint8_t* mapping, size_t data_size)
+    : fd_(fd),
+      mapping_(mapping),
+      header_(reinterpret_cast<Header*>(mapping)),
+      data_(mapping + kHeaderSize),
+      data_size_(data_size) {
+  // The file was just truncated, so the offsets already read as zero
+  header_->version = kVersion;
+  header_->header_size = kHeaderSize;
+  header_->data_size = data_size_;
+  // Written last, so that a file with the magic has a valid header
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+}
+
+SnoopLogRingFile::~SnoopLogRingFile() {
+  munmap(mapping_, kHeaderSize + data_size_);
+  close(fd_);
+}
+
+bool SnoopLogRingFile::Write(const void* header, size_t header_size, const uint8_t* data, size_t size) {
+  size_t record_size = kRecordSizeLength + header_size + size;
+  if (record_size > data_size_) {
+    return false;
+  }
+  uint64_t write_offset = header_->write_offset.load(std::memory_order_relaxed);
+  uint64_t end = write_offset + record_size;
+
+  uint64_t first_record_offset = header_->first_record_offset.load(std::memory_order_relaxed);
+  if (end - first_record_offset > data_size_) {
+    // Give up the oldest records before overwriting them
+    while (end - first_record_offset > data_size_) {
+      first_record_offset += kRecordSizeLength + ReadRecordSize(first_record_offset);
+    }
+    header_->first_record_offset.store(first_record_offset, std::memory_order_release);
+  }
+
+  uint32_t record_size_le = ToLittleEndian(header_size + size);
+  CopyIn(write_offset, &record_size_le, kRecordSizeLength);
+  CopyIn(write_offset + kRecordSizeLength, header, header_size);
+  CopyIn(write_offset + kRecordSizeLength + header_size, data, size);
+  header_->write_offset.store(end, std::memory_order_release);
+  return true;
+}
+
+size_t SnoopLogRingFile::GetDataSize() const {
+  return data_size_;
+}
+
+void SnoopLogRingFile::CopyIn(uint64_t offset, const void* bytes, size_t size) {
+  size_t position = offset % data_size_;
+  size_t first = std::min(size, data_size_ - position);
+  std::memcpy(data_ + position, bytes, first);
+  std::memcpy(data_, static_cast<const uint8_t*>(bytes) + first, size - first);
+}
+
+uint32_t SnoopLogRingFile::ReadRecordSize(uint64_t offset) const {
+  uint32_t record_size_le;
+  CopyOut(data_, data_size_, offset, &record_size_le, kRecordSizeLength);
+  return ToLittleEndian(record_size_le);
+}
+
+std::optional<std::vector<uint8_t>> SnoopLogRingFile::ReadRecords(const std::string& path) {
+  int fd;
+  RUN_NO_INTR(fd = open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd == -1) {
+    LOG_ERROR("Unable to open snoop log ring at \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    return std::nullopt;
+  }
+
+  // Offsets from before and after copying the data area. The records in [first_record_offset after, write_offset
+  // before) were not touched by the writer in between.
+  Header before;
+  Header after;
+  std::vector<uint8_t> area;
+  bool valid = read_all(fd, &before, sizeof(Header), 0) && std::memcmp(before.magic, kMagic, sizeof(kMagic)) == 0 &&
+               before.version == kVersion && before.data_size > kRecordSizeLength;
+  if (valid) {
+    area.resize(before.data_size);
+    valid = read_all(fd, area.data(), area.size(), before.header_size) && read_all(fd, &after, sizeof(Header), 0);
+  }
+  close(fd);
+  if (!valid) {
+    LOG_ERROR("Unable to read snoop log ring at \"%s\"", path.c_str());
+    return std::nullopt;
+  }
+
+  std::vector<uint8_t> records;
+  uint64_t end = before.write_offset.load();
+  uint64_t offset = after.first_record_offset.load();
+  while (offset + kRecordSizeLength <= end) {
+    uint32_t record_size_le;
+    CopyOut(area.data(), area.size(), offset, &record_size_le, kRecordSizeLength);
+    uint32_t record_size = ToLittleEndian(record_size_le);
+    if (offset + kRecordSizeLength + record_size > end) {
+      break;
+    }
+    size_t old_size = records.size();
+    records.resize(old_size + record_size);
+    CopyOut(area.data(), area.size(), offset + kRecordSizeLength, records.data() + old_size, record_size);
+    offset += kRecordSizeLength + record_size;
+  }
+  return records;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+
+// A fixed size file, mapped into memory, that keeps the most recent snoop log records.
+//
+// Writing a record is a copy into the mapping, so the log costs no syscall per packet, and what was written survives
+// a crash of the process without a flush. Once the file is full the oldest records are overwritten.
+//
+// The file starts with a Header page, followed by the circular data area. Offsets in the header count every byte ever
+// written to the data area, so offset % data_size is the position in it. Each record in the data area is preceded by
+// its size as a little endian uint32_t. The records between first_record_offset and write_offset are complete, as the
+// writer moves first_record_offset before it overwrites a record and write_offset after it copied a new one. This
+// lets ReadRecords() copy them out while the stack keeps logging.
+//
+// Write() must not be called concurrently.
+class SnoopLogRingFile {
+ public:
+  static constexpr char kMagic[8] = {'b', 't', 's', 'n', 'r', 'i', 'n', 'g'};
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kHeaderSize = 4096;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t data_size;
+    std::atomic<uint64_t> write_offset;
+    std::atomic<uint64_t> first_record_offset;
+  };
+  static_assert(sizeof(Header) <= kHeaderSize);
+
+  // Create the file at path, replacing any existing one, and map it. Returns nullptr on failure.
+  static std::unique_ptr<SnoopLogRingFile> Create(const std::string& path, size_t data_size);
+
+  // Copy the complete records of the ring file at path, without their sizes, oldest first. The result is the body
+  // of a btsnoop file when the records written are btsnoop packet records. Returns std::nullopt if the file cannot
+  // be read or is not a ring file.
+  static std::optional<std::vector<uint8_t>> ReadRecords(const std::string& path);
+
+  SnoopLogRingFile(const SnoopLogRingFile&) = delete;
+  SnoopLogRingFile& operator=(const SnoopLogRingFile&) = delete;
+  ~SnoopLogRingFile();
+
+  // Append the record made of header followed by data, overwriting the oldest records as needed. Returns false if
+  // the record is larger than the data area.
+  bool Write(const void* header, size_t header_size, const uint8_t* data, size_t size);
+
+  size_t GetDataSize() const;
+
+ private:
+  SnoopLogRingFile(int fd, uint8_t* mapping, size_t data_size);
+
+  void CopyIn(uint64_t offset, const void* bytes, size_t size);
+  uint32_t ReadRecordSize(uint64_t offset) const;
+
+  const int fd_;
+  uint8_t* const mapping_;
+  Header* const header_;
+  uint8_t* const data_;
+  const size_t data_size_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_log_ring_file.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr uint8_t kHeader[] = {0xa0, 0xa1};
+// Size prefix, header and three bytes of data
+constexpr size_t kRecordSize = sizeof(uint32_t) + sizeof(kHeader) + 3;
+
+class SnoopLogRingFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const testing::TestInfo* const test_info = testing::UnitTest::GetInstance()->current_test_info();
+    path_ = std::filesystem::temp_directory_path() / (std::string(test_info->name()) + "_btsnoop_hci.log.ring");
+    std::filesystem::remove(path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  static std::vector<uint8_t> Record(uint8_t value) {
+    return {kHeader[0], kHeader[1], value, static_cast<uint8_t>(value + 1), static_cast<uint8_t>(value + 2)};
+  }
+
+  static bool Write(SnoopLogRingFile& ring, uint8_t value) {
+    std::vector<uint8_t> data = {value, static_cast<uint8_t>(value + 1), static_cast<uint8_t>(value + 2)};
+    return ring.Write(kHeader, sizeof(kHeader), data.data(), data.size());
+  }
+
+  static std::vector<uint8_t> Concat(std::vector<uint8_t> values) {
+    std::vector<uint8_t> records;
+    for (auto value : values) {
+      auto record = Record(value);
+      records.insert(records.end(), record.begin(), record.end());
+    }
+    return records;
+  }
+
+  std::filesystem::path path_;
+};
+
+TEST_F(SnoopLogRingFileTest, empty_ring_test) {
+  auto ring = SnoopLogRingFile::Create(path_, 10 * kRecordSize);
+  ASSERT_NE(ring, nullptr);
+  ASSERT_EQ(std::filesystem::file_size(path_), SnoopLogRingFile::kHeaderSize + 10 * kRecordSize);
+  auto records = SnoopLogRingFile::ReadRecords(path_);
+  ASSERT_TRUE(records.has_value());
+  ASSERT_TRUE(records->empty());
+}
+
+TEST_F(SnoopLogRingFileTest, records_are_read_in_order_test) {
+  auto ring = SnoopLogRingFile::Create(path_, 10 * kRecordSize);
+  ASSERT_NE(ring, nullptr);
+  for (uint8_t i = 0; i < 5; i++) {
+    ASSERT_TRUE(Write(*ring, i));
+  }
+  ASSERT_EQ(SnoopLogRingFile::ReadRecords(path_), Concat({0, 1, 2, 3, 4}));
+}
+
+TEST_F(SnoopLogRingFileTest, oldest_records_are_overwritten_test) {
+  // Not a multiple of the record size, so that records wrap around the end of the data area
+  auto ring = SnoopLogRingFile::Create(path_, 3 * kRecordSize + 4);
+  ASSERT_NE(ring, nullptr);
+  for (uint8_t i = 0; i < 10; i++) {
+    ASSERT_TRUE(Write(*ring, 10 * i));
+    ASSERT_EQ(SnoopLogRingFile::ReadRecords(path_)->size(), std::min(i + 1, 3) * Record(0).size());
+  }
+  ASSERT_EQ(SnoopLogRingFile::ReadRecords(path_), Concat({70, 80, 90}));
+}
+
+TEST_F(SnoopLogRingFileTest, records_survive_the_writer_test) {
+  {
+    auto ring = SnoopLogRingFile::Create(path_, 10 * kRecordSize);
+    ASSERT_NE(ring, nullptr);
+    ASSERT_TRUE(Write(*ring, 1));
+    ASSERT_TRUE(Write(*ring, 2));
+  }
+  ASSERT_EQ(SnoopLogRingFile::ReadRecords(path_), Concat({1, 2}));
+}
+
+TEST_F(SnoopLogRingFileTest, too_large_record_is_rejected_test) {
+  auto ring = SnoopLogRingFile::Create(path_, kRecordSize);
+  ASSERT_NE(ring, nullptr);
+  std::vector<uint8_t> data(4);
+  ASSERT_FALSE(ring->Write(kHeader, sizeof(kHeader), data.data(), data.size()));
+  ASSERT_TRUE(Write(*ring, 1));
+  ASSERT_EQ(SnoopLogRingFile::ReadRecords(path_), Concat({1}));
+}
+
+TEST_F(SnoopLogRingFileTest, not_a_ring_file_test) {
+  ASSERT_FALSE(SnoopLogRingFile::ReadRecords(path_).has_value());
+  std::ofstream file(path_);
+  file << std::string(SnoopLogRingFile::kHeaderSize + 16, 'x');
+  file.close();
+  ASSERT_FALSE(SnoopLogRingFile::ReadRecords(path_).has_value());
+}
+
+TEST_F(SnoopLogRingFileTest, read_while_writing_test) {
+  auto ring = SnoopLogRingFile::Create(path_, 16 * kRecordSize);
+  ASSERT_NE(ring, nullptr);
+  std::thread writer([&ring] {
+    for (int i = 0; i < 20000; i++) {
+      Write(*ring, i % 250);
+    }
+  });
+  for (int i = 0; i < 200; i++) {
+    auto records = SnoopLogRingFile::ReadRecords(path_);
+    ASSERT_TRUE(records.has_value());
+    // Only whole records, each as written
+    ASSERT_EQ(records->size() % Record(0).size(), 0u);
+    for (size_t offset = 0; offset < records->size(); offset += Record(0).size()) {
+      std::vector<uint8_t> record(records->begin() + offset, records->begin() + offset + Record(0).size());
+      ASSERT_EQ(record, Record(record[2]));
+    }
+  }
+  writer.join();
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -17,11 +17,16 @@
 #include "hal/snoop_logger.h"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <bitset>
 #include <chrono>
+#include <cinttypes>
+#include <memory>
 #include <sstream>
 
 #include "common/circular_buffer.h"
@@ -34,6 +39,7 @@
 #include "os/log.h"
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
+#include "os/utils.h"
 
 namespace bluetooth {
 #ifdef USE_FAKE_TIMERS
@@ -292,11 +298,17 @@ uint64_t htonll(uint64_t ll) {
 // the relevant system property
 constexpr size_t kDefaultBtSnoopMaxPacketsPerFile = 0xffff;
 
+// The size of the data area of the ring file, which keeps the most recent packets instead of rotating btsnoop files
+constexpr size_t kDefaultBtSnoopRingFileSize = 8 * 1024 * 1024;
+
 // We restrict the maximum packet size to 150 bytes
 constexpr size_t kDefaultBtSnoozMaxBytesPerPacket = 150;
 constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
     kDefaultBtSnoozMaxBytesPerPacket - sizeof(SnoopLogger::PacketHeaderType);
 
+// Same permissions as the files std::ofstream creates
+constexpr mode_t kBtSnoopFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH;
+
 using namespace std::chrono_literals;
 constexpr std::chrono::hours kBtSnoozLogLifeTime = 12h;
 constexpr std::chrono::hours kBtSnoozLogDeleteRepeatingAlarmInterval = 1h;
@@ -308,6 +320,81 @@ std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 std::mutex a2dpMediaChannels_mutex;
 std::vector<SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
 
+// What the filters do with the packets of a channel, a channel being a connection handle and the CID the packets
+// carry in their direction
+constexpr uint8_t kChannelAcceptlisted = 1 << 0;
+constexpr uint8_t kChannelRfcomm = 1 << 1;
+constexpr uint8_t kChannelA2dpMedia = 1 << 2;
+
+constexpr uint16_t kL2capSignalingCid = 0x0001;
+
+// Snapshot of filter_tracker_list and a2dpMediaChannels that the capture path reads without a lock. It is never
+// modified once published, channel open and close events publish a new one.
+struct FilterActionTable {
+  static uint32_t ChannelKey(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
+    return (static_cast<uint32_t>(conn_handle) << 17) | (static_cast<uint32_t>(cid) << 1) | is_local_cid;
+  }
+  static uint32_t DlciKey(uint16_t conn_handle, uint8_t dlci) {
+    return (static_cast<uint32_t>(conn_handle) << 8) | dlci;
+  }
+
+  uint8_t GetChannelActions(uint16_t conn_handle, uint16_t cid, bool is_local_cid) const {
+    auto it = channel_actions.find(ChannelKey(conn_handle, cid, is_local_cid));
+    if (it != channel_actions.end()) {
+      return it->second;
+    }
+    // Connections without a FilterTracker yet only acceptlist L2CAP signaling
+    return cid == kL2capSignalingCid ? kChannelAcceptlisted : 0;
+  }
+
+  bool IsAcceptlistedDlci(uint16_t conn_handle, uint8_t dlci) const {
+    return dlci == 0 || acceptlisted_dlcis.count(DlciKey(conn_handle, dlci)) != 0;
+  }
+
+  std::unordered_map<uint32_t, uint8_t> channel_actions;
+  std::unordered_set<uint32_t> acceptlisted_dlcis;
+};
+
+std::mutex filter_action_table_mutex;
+// Only accessed with std::atomic_load and std::atomic_store
+std::shared_ptr<const FilterActionTable> filter_action_table = std::make_shared<const FilterActionTable>();
+
+// Publishes a new filter action table from filter_tracker_list and a2dpMediaChannels. Callers must not hold their
+// mutexes.
+void RebuildFilterActionTable() {
+  // Serializes the rebuilds, so that the last table published reflects the last update
+  std::lock_guard<std::mutex> rebuild_lock(filter_action_table_mutex);
+  auto table = std::make_shared<FilterActionTable>();
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+    for (const auto& [conn_handle, filters] : filter_tracker_list) {
+      for (auto cid : filters.l2c_local_cid) {
+        table->channel_actions[FilterActionTable::ChannelKey(conn_handle, cid, true)] |= kChannelAcceptlisted;
+      }
+      for (auto cid : filters.l2c_remote_cid) {
+        table->channel_actions[FilterActionTable::ChannelKey(conn_handle, cid, false)] |= kChannelAcceptlisted;
+      }
+      table->channel_actions[FilterActionTable::ChannelKey(conn_handle, filters.rfcomm_local_cid, true)] |=
+          kChannelRfcomm;
+      table->channel_actions[FilterActionTable::ChannelKey(conn_handle, filters.rfcomm_remote_cid, false)] |=
+          kChannelRfcomm;
+      for (auto dlci : filters.rfcomm_channels) {
+        table->acceptlisted_dlcis.insert(FilterActionTable::DlciKey(conn_handle, dlci));
+      }
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
+    for (const auto& channel : a2dpMediaChannels) {
+      table->channel_actions[FilterActionTable::ChannelKey(channel.conn_handle, channel.local_cid, true)] |=
+          kChannelA2dpMedia;
+      table->channel_actions[FilterActionTable::ChannelKey(channel.conn_handle, channel.remote_cid, false)] |=
+          kChannelA2dpMedia;
+    }
+  }
+  std::atomic_store(&filter_action_table, std::shared_ptr<const FilterActionTable>(std::move(table)));
+}
+
 std::mutex snoop_log_filters_mutex;
 
 std::mutex profiles_filter_mutex;
@@ -319,6 +406,20 @@ const uint32_t magic_pat_len = strlen(payload_fill_magic);
 const uint32_t cpbr_pat_len = strlen(cpbr_pattern);
 const uint32_t clcc_pat_len = strlen(clcc_pattern);
 
+bool write_all(int fd, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    ssize_t written;
+    RUN_NO_INTR(written = write(fd, bytes, size));
+    if (written <= 0) {
+      return false;
+    }
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+
 std::string get_btsnoop_log_path(std::string log_dir, bool filtered) {
   if (filtered) {
     log_dir.append(".filtered");
@@ -330,6 +431,10 @@ std::string get_last_log_path(std::string log_file_path) {
   return log_file_path.append(".last");
 }
 
+std::string get_ring_file_path(std::string log_file_path) {
+  return log_file_path.append(".ring");
+}
+
 void delete_btsnoop_files(const std::string& log_path) {
   LOG_INFO("Deleting logs if they exist");
   if (os::FileExists(log_path)) {
@@ -369,7 +474,7 @@ void delete_old_btsnooz_files(const std::string& log_path, const std::chrono::mi
 }
 
 size_t get_btsnooz_packet_length_to_write(
-    const HciPacket& packet, SnoopLogger::PacketType type, bool qualcomm_debug_log_enabled) {
+    const uint8_t* packet, size_t packet_size, SnoopLogger::PacketType type, bool qualcomm_debug_log_enabled) {
   static const size_t kAclHeaderSize = 4;
   static const size_t kL2capHeaderSize = 4;
   static const size_t kL2capCidOffset = (kAclHeaderSize + 2);
@@ -387,14 +492,14 @@ size_t get_btsnooz_packet_length_to_write(
   switch (type) {
     case SnoopLogger::PacketType::CMD:
     case SnoopLogger::PacketType::EVT:
-      included_length = packet.size();
+      included_length = packet_size;
       break;
 
     case SnoopLogger::PacketType::ACL: {
       // Log ACL and L2CAP header by default
       size_t len_hci_acl = kAclHeaderSize + kL2capHeaderSize;
       // Check if we have enough data for an L2CAP header
-      if (packet.size() > len_hci_acl) {
+      if (packet_size > len_hci_acl) {
         uint16_t l2cap_cid =
             static_cast<uint16_t>(packet[kL2capCidOffset]) |
             static_cast<uint16_t>((static_cast<uint16_t>(packet[kL2capCidOffset + 1]) << static_cast<uint16_t>(8)));
@@ -407,15 +512,15 @@ size_t get_btsnooz_packet_length_to_write(
           // For the signaling CID, take the full packet.
           // That way, the PSM setup is captured, allowing decoding of PSMs down
           // the road.
-          return packet.size();
+          return packet_size;
         } else if (qualcomm_debug_log_enabled && hci_acl_packet_handle == kQualcommDebugLogHandle) {
-          return packet.size();
+          return packet_size;
         } else {
           // Otherwise, return as much as we reasonably can
           len_hci_acl = kMaxBtsnoozAclSize;
         }
       }
-      included_length = std::min(len_hci_acl, packet.size());
+      included_length = std::min(len_hci_acl, packet_size);
       break;
     }
 
@@ -432,6 +537,8 @@ size_t get_btsnooz_packet_length_to_write(
 
 // system properties
 const std::string SnoopLogger::kBtSnoopMaxPacketsPerFileProperty = "persist.bluetooth.btsnoopsize";
+const std::string SnoopLogger::kBtSnoopRingFileSizeProperty = "persist.bluetooth.btsnoopringsize";
+const std::string SnoopLogger::kBtSnoopSocketModeProperty = "persist.bluetooth.btsnoopsocketmode";
 const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
@@ -457,6 +564,10 @@ const std::string SnoopLogger::kSoCManufacturerProperty = "ro.soc.manufacturer";
 const std::string SnoopLogger::kBtSnoopLogModeDisabled = "disabled";
 const std::string SnoopLogger::kBtSnoopLogModeFiltered = "filtered";
 const std::string SnoopLogger::kBtSnoopLogModeFull = "full";
+// persist.bluetooth.btsnoopsocketmode
+const std::string SnoopLogger::kBtSnoopSocketModeRaw = "raw";
+const std::string SnoopLogger::kBtSnoopSocketModeCompressed = "compressed";
+const std::string SnoopLogger::kBtSnoopSocketModeCompressedHeaders = "compressed_headers";
 // ro.soc.manufacturer
 const std::string SnoopLogger::kSoCManufacturerQualcomm = "Qualcomm";
 
@@ -475,6 +586,8 @@ std::string SnoopLogger::btsnoop_mode_;
 const size_t SnoopLogger::PACKET_TYPE_LENGTH = 1;
 const size_t SnoopLogger::MAX_HCI_ACL_LEN = 14;
 const uint32_t SnoopLogger::L2CAP_HEADER_SIZE = 8;
+const size_t SnoopLogger::ASYNC_MAX_PACKETS = 256;
+const size_t SnoopLogger::ASYNC_MAX_PACKET_SIZE = 2048;
 
 SnoopLogger::SnoopLogger(
     std::string snoop_log_path,
@@ -521,12 +634,27 @@ SnoopLogger::SnoopLogger(
     // delete both filtered and unfiltered logs
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
+    delete_btsnoop_files(get_ring_file_path(get_btsnoop_log_path(snoop_log_path_, true)));
+    delete_btsnoop_files(get_ring_file_path(get_btsnoop_log_path(snoop_log_path_, false)));
   }
 
   snoop_logger_socket_thread_ = nullptr;
   socket_ = nullptr;
   // Add ".filtered" extension if necessary
   snoop_log_path_ = get_btsnoop_log_path(snoop_log_path_, btsnoop_mode_ == kBtSnoopLogModeFiltered);
+
+  if (btsnoop_mode_ != kBtSnoopLogModeDisabled && bluetooth::common::InitFlags::IsSnoopLoggerMmapRingEnabled()) {
+    // Writing to the ring is a copy into memory, so there is nothing left to hand off to the async writer
+    ring_file_path_ = get_ring_file_path(snoop_log_path_);
+    ring_file_size_ = GetRingFileSize();
+    LOG_INFO("Snoop Logs written to ring file \"%s\" of %zu bytes", ring_file_path_.c_str(), ring_file_size_);
+  } else if (btsnoop_mode_ != kBtSnoopLogModeDisabled && bluetooth::common::InitFlags::IsSnoopLoggerAsyncEnabled()) {
+    LOG_INFO("Snoop Logs written asynchronously");
+    async_writer_ = std::make_unique<SnoopLoggerAsyncWriter>(
+        ASYNC_MAX_PACKETS,
+        sizeof(PacketHeaderType) + ASYNC_MAX_PACKET_SIZE,
+        [this](SnoopLoggerAsyncWriter::Record* records, size_t count) { WriteBtsnoopRecords(records, count); });
+  }
 }
 
 void SnoopLogger::CloseCurrentSnoopLogFile() {
@@ -535,13 +663,35 @@ void SnoopLogger::CloseCurrentSnoopLogFile() {
     btsnoop_ostream_.flush();
     btsnoop_ostream_.close();
   }
+  if (btsnoop_fd_ != -1) {
+    close(btsnoop_fd_);
+    btsnoop_fd_ = -1;
+  }
+  ring_file_.reset();
   packet_counter_ = 0;
+  dropped_packets_in_file_ = 0;
 }
 
 void SnoopLogger::OpenNextSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   CloseCurrentSnoopLogFile();
 
+  if (ring_file_size_ != 0) {
+    // Keep the packets of the previous session, e.g. the ones that led to a crash
+    auto last_ring_file_path = get_last_log_path(ring_file_path_);
+    if (os::FileExists(ring_file_path_) && !os::RenameFile(ring_file_path_, last_ring_file_path)) {
+      LOG_ERROR(
+          "Unabled to rename existing ring file from \"%s\" to \"%s\"",
+          ring_file_path_.c_str(),
+          last_ring_file_path.c_str());
+    }
+    ring_file_ = SnoopLogRingFile::Create(ring_file_path_, ring_file_size_);
+    if (ring_file_ == nullptr) {
+      LOG_ALWAYS_FATAL("Unable to create snoop log ring file at \"%s\"", ring_file_path_.c_str());
+    }
+    return;
+  }
+
   auto last_file_path = get_last_log_path(snoop_log_path_);
 
   if (os::FileExists(snoop_log_path_)) {
@@ -556,15 +706,28 @@ void SnoopLogger::OpenNextSnoopLogFile() {
   }
 
   mode_t prevmask = umask(0);
-  // do not use std::ios::app as we want override the existing file
-  btsnoop_ostream_.open(snoop_log_path_, std::ios::binary | std::ios::out);
+  if (async_writer_ != nullptr) {
+    // do not use O_APPEND as we want override the existing file
+    RUN_NO_INTR(
+        btsnoop_fd_ = open(snoop_log_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, kBtSnoopFileMode));
+  } else {
+    // do not use std::ios::app as we want override the existing file
+    btsnoop_ostream_.open(snoop_log_path_, std::ios::binary | std::ios::out);
+  }
 #ifdef USE_FAKE_TIMERS
   file_creation_time = fake_timerfd_get_clock();
 #endif
-  if (!btsnoop_ostream_.good()) {
+  if (async_writer_ != nullptr ? btsnoop_fd_ == -1 : !btsnoop_ostream_.good()) {
     LOG_ALWAYS_FATAL("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   umask(prevmask);
+  if (async_writer_ != nullptr) {
+    if (!write_all(btsnoop_fd_, &SnoopLoggerCommon::kBtSnoopFileHeader, sizeof(SnoopLoggerCommon::FileHeaderType))) {
+      LOG_ALWAYS_FATAL(
+          "Unable to write file header to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
+    }
+    return;
+  }
   if (!btsnoop_ostream_.write(
           reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
           sizeof(SnoopLoggerCommon::FileHeaderType))) {
@@ -596,6 +759,23 @@ void SnoopLogger::EnableFilters() {
     }
     LOG_INFO("%s: %s", itr->first.c_str(), itr->second.c_str());
   }
+
+  uint8_t enabled_filters = 0;
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterHeadersProperty]) {
+    enabled_filters |= kFilterHeaders;
+  }
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterProfileA2dpProperty]) {
+    enabled_filters |= kFilterA2dp;
+  }
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterProfileRfcommProperty]) {
+    enabled_filters |= kFilterRfcomm;
+  }
+  for (const auto& [filter_name, filter_mode] : kBtSnoopLogFilterMode) {
+    if (filter_mode != SnoopLogger::kBtSnoopLogFilterProfileModeDisabled) {
+      enabled_filters |= kFilterProfiles;
+    }
+  }
+  enabled_filters_ = enabled_filters;
 }
 
 void SnoopLogger::DisableFilters() {
@@ -608,6 +788,7 @@ void SnoopLogger::DisableFilters() {
     itr->second = SnoopLogger::kBtSnoopLogFilterProfileModeDisabled;
     LOG_INFO("%s, %s", itr->first.c_str(), itr->second.c_str());
   }
+  enabled_filters_ = 0;
 }
 
 bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
@@ -625,34 +806,52 @@ bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
   return false;
 }
 
-bool SnoopLogger::ShouldFilterLog(bool is_received, uint8_t* packet) {
+uint32_t SnoopLogger::ClassifyAclPacket(
+    const uint8_t* packet, Direction direction, uint32_t length, uint8_t filters) const {
+  /* Received packets carry the local CID, sent packets the remote CID */
+  bool is_received = direction == Direction::INCOMING;
   uint16_t conn_handle =
-      ((((uint16_t)packet[ACL_CHANNEL_OFFSET + 1]) << 8) + packet[ACL_CHANNEL_OFFSET]) & 0x0fff;
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
-  auto& filters = filter_tracker_list[conn_handle];
+      ((((uint16_t)packet[ACL_CHANNEL_OFFSET + 1]) << 8) + packet[ACL_CHANNEL_OFFSET]) & HANDLE_MASK;
   uint16_t cid = (packet[L2CAP_CHANNEL_OFFSET + 1] << 8) + packet[L2CAP_CHANNEL_OFFSET];
-  if (filters.IsRfcommChannel(is_received, cid)) {
-    uint8_t rfcomm_event = packet[RFCOMM_EVENT_OFFSET] & 0b11101111;
-    if (rfcomm_event == RFCOMM_SABME || rfcomm_event == RFCOMM_UA) {
-      return false;
-    }
 
-    uint8_t rfcomm_dlci = packet[RFCOMM_CHANNEL_OFFSET] >> 2;
-    if (!filters.IsAcceptlistedDlci(rfcomm_dlci)) {
-      return true;
+  std::shared_ptr<const FilterActionTable> table;
+  uint8_t channel_actions = 0;
+  if (filters & (kFilterA2dp | kFilterRfcomm)) {
+    table = std::atomic_load(&filter_action_table);
+    channel_actions = table->GetChannelActions(conn_handle, cid, is_received);
+  }
+
+  if ((filters & kFilterA2dp) && (channel_actions & kChannelA2dpMedia)) {
+    return 0;
+  }
+
+  if (filters & kFilterHeaders) {
+    CalculateAclPacketLength(length, packet, is_received);
+  }
+
+  if (filters & kFilterRfcomm) {
+    bool should_filter = false;
+    if (channel_actions & kChannelRfcomm) {
+      uint8_t rfcomm_event = packet[RFCOMM_EVENT_OFFSET] & 0b11101111;
+      if (rfcomm_event != RFCOMM_SABME && rfcomm_event != RFCOMM_UA) {
+        uint8_t rfcomm_dlci = packet[RFCOMM_CHANNEL_OFFSET] >> 2;
+        should_filter = !table->IsAcceptlistedDlci(conn_handle, rfcomm_dlci);
+      }
+    } else {
+      should_filter = !(channel_actions & kChannelAcceptlisted);
+    }
+    if (should_filter) {
+      length = L2CAP_HEADER_SIZE + PACKET_TYPE_LENGTH;
     }
-  } else if (!filters.IsAcceptlistedL2cap(is_received, cid)) {
-    return true;
   }
 
-  return false;
+  return length;
 }
 
-void SnoopLogger::CalculateAclPacketLength(uint32_t& length, uint8_t* packet, bool is_received) {
+void SnoopLogger::CalculateAclPacketLength(uint32_t& length, const uint8_t* packet, bool is_received) const {
   uint32_t def_len =
       ((((uint16_t)packet[ACL_LENGTH_OFFSET + 1]) << 8) + packet[ACL_LENGTH_OFFSET]) +
       ACL_HEADER_LENGTH + PACKET_TYPE_LENGTH;
-  constexpr uint16_t L2CAP_SIGNALING_CID = 0x0001;
 
   if (length == 0) {
     return;
@@ -665,7 +864,7 @@ void SnoopLogger::CalculateAclPacketLength(uint32_t& length, uint8_t* packet, bo
 
   if (boundary_flag == START_PACKET_BOUNDARY) {
     uint16_t l2cap_cid = packet[L2CAP_CHANNEL_OFFSET] | (packet[L2CAP_CHANNEL_OFFSET + 1] << 8);
-    if (l2cap_cid == L2CAP_SIGNALING_CID || handle == kQualcommDebugLogHandle) {
+    if (l2cap_cid == kL2capSignalingCid || handle == kQualcommDebugLogHandle) {
       length = def_len;
     } else {
       if (def_len < MAX_HCI_ACL_LEN) {
@@ -887,11 +1086,14 @@ void SnoopLogger::AcceptlistL2capChannel(
       conn_handle,
       local_cid,
       remote_cid);
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
 
-  // This will create the entry if there is no associated filter with the
-  // connection.
-  filter_tracker_list[conn_handle].AddL2capCid(local_cid, remote_cid);
+    // This will create the entry if there is no associated filter with the
+    // connection.
+    filter_tracker_list[conn_handle].AddL2capCid(local_cid, remote_cid);
+  }
+  RebuildFilterActionTable();
 }
 
 void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid, uint8_t dlci) {
@@ -901,9 +1103,11 @@ void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid,
   }
 
   LOG_DEBUG("Acceptlisting rfcomm channel: local cid=%d, dlci=%d", local_cid, dlci);
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
-
-  filter_tracker_list[conn_handle].AddRfcommDlci(dlci);
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+    filter_tracker_list[conn_handle].AddRfcommDlci(dlci);
+  }
+  RebuildFilterActionTable();
 }
 
 void SnoopLogger::AddRfcommL2capChannel(
@@ -918,10 +1122,12 @@ void SnoopLogger::AddRfcommL2capChannel(
       conn_handle,
       local_cid,
       remote_cid);
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
-
-  filter_tracker_list[conn_handle].SetRfcommCid(local_cid, remote_cid);
-  local_cid_to_acl.insert({local_cid, conn_handle});
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+    filter_tracker_list[conn_handle].SetRfcommCid(local_cid, remote_cid);
+    local_cid_to_acl.insert({local_cid, conn_handle});
+  }
+  RebuildFilterActionTable();
 }
 
 void SnoopLogger::ClearL2capAcceptlist(
@@ -936,9 +1142,11 @@ void SnoopLogger::ClearL2capAcceptlist(
       conn_handle,
       local_cid,
       remote_cid);
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
-
-  filter_tracker_list[conn_handle].RemoveL2capCid(local_cid, remote_cid);
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+    filter_tracker_list[conn_handle].RemoveL2capCid(local_cid, remote_cid);
+  }
+  RebuildFilterActionTable();
 }
 
 bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
@@ -962,18 +1170,6 @@ bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is
   return iter != a2dpMediaChannels.end();
 }
 
-bool SnoopLogger::IsA2dpMediaPacket(bool is_received, uint8_t* packet) {
-  uint16_t cid, conn_handle;
-  bool is_local_cid = is_received;
-  /*is_received signifies Rx packet so packet will have local_cid at offset 6
-   * Tx packet with is_received as false and have remote_cid at the offset*/
-
-  conn_handle = (uint16_t)((packet[0] + (packet[1] << 8)) & 0x0FFF);
-  cid = (uint16_t)(packet[6] + (packet[7] << 8));
-
-  return IsA2dpMediaChannel(conn_handle, cid, is_local_cid);
-}
-
 void SnoopLogger::AddA2dpMediaChannel(
     uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid) {
   if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
@@ -987,8 +1183,11 @@ void SnoopLogger::AddA2dpMediaChannel(
         conn_handle,
         local_cid,
         remote_cid);
-    std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-    a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    {
+      std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
+      a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    }
+    RebuildFilterActionTable();
   }
 }
 
@@ -998,15 +1197,18 @@ void SnoopLogger::RemoveA2dpMediaChannel(uint16_t conn_handle, uint16_t local_ci
     return;
   }
 
-  std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  a2dpMediaChannels.erase(
-      std::remove_if(
-          a2dpMediaChannels.begin(),
-          a2dpMediaChannels.end(),
-          [conn_handle, local_cid](auto& el) {
-            return (el.conn_handle == conn_handle && el.local_cid == local_cid);
-          }),
-      a2dpMediaChannels.end());
+  {
+    std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
+    a2dpMediaChannels.erase(
+        std::remove_if(
+            a2dpMediaChannels.begin(),
+            a2dpMediaChannels.end(),
+            [conn_handle, local_cid](auto& el) {
+              return (el.conn_handle == conn_handle && el.local_cid == local_cid);
+            }),
+        a2dpMediaChannels.end());
+  }
+  RebuildFilterActionTable();
 }
 
 void SnoopLogger::SetRfcommPortOpen(
@@ -1158,42 +1360,34 @@ void SnoopLogger::FilterCapturedPacket(
     return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
-    if (IsA2dpMediaPacket(direction == Direction::INCOMING, (uint8_t*)packet.data())) {
-      length = 0;
-      return;
-    }
+  uint8_t filters = enabled_filters_.load(std::memory_order_relaxed);
+  if (!(filters & kFilterProfiles)) {
+    length = ClassifyAclPacket(packet.data(), direction, length, filters);
+    return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
-    CalculateAclPacketLength(length, (uint8_t*)packet.data(), direction == Direction::INCOMING);
+  length = ClassifyAclPacket(packet.data(), direction, length, filters & (kFilterA2dp | kFilterHeaders));
+  if (length == 0) {
+    return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
-      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
-    // If HeadersFiltered applied, do not use ProfilesFiltered
-    if (length == ntohl(header.length_original)) {
-      if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
-        // Add additional bytes for magic string in case
-        // payload length is less than the length of magic string.
-        packet.resize((size_t)(packet.size() + EXTRA_BUF_SIZE));
-      }
-
-      length = FilterProfiles(direction == Direction::INCOMING, (uint8_t*)packet.data());
-      if (length == 0) return;
+  // If HeadersFiltered applied, do not use ProfilesFiltered
+  if (length == ntohl(header.length_original)) {
+    if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
+      // Add additional bytes for magic string in case
+      // payload length is less than the length of magic string.
+      packet.resize((size_t)(packet.size() + EXTRA_BUF_SIZE));
     }
-  }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
-    bool shouldFilter =
-        SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, (uint8_t*)packet.data());
-    if (shouldFilter) {
-      length = L2CAP_HEADER_SIZE + PACKET_TYPE_LENGTH;
-    }
+    length = FilterProfiles(direction == Direction::INCOMING, (uint8_t*)packet.data());
+    if (length == 0) return;
   }
+
+  length = ClassifyAclPacket(packet.data(), direction, length, filters & kFilterRfcomm);
 }
 
-void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType type) {
+SnoopLogger::PacketHeaderType SnoopLogger::MakePacketHeader(
+    size_t packet_size, Direction direction, PacketType type) {
   uint64_t timestamp_us =
       std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
           .count();
@@ -1214,62 +1408,231 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
       flags.set(1, true);
       break;
   }
-  uint32_t length = packet.size() + /* type byte */ PACKET_TYPE_LENGTH;
-  PacketHeaderType header = {.length_original = htonl(length),
-                             .length_captured = htonl(length),
-                             .flags = htonl(static_cast<uint32_t>(flags.to_ulong())),
-                             .dropped_packets = 0,
-                             .timestamp = htonll(timestamp_us + kBtSnoopEpochDelta),
-                             .type = static_cast<uint8_t>(type)};
-  {
-    std::lock_guard<std::recursive_mutex> lock(file_mutex_);
-    if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
-      // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
-      size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
-      header.length_captured = htonl(included_length + /* type byte */ PACKET_TYPE_LENGTH);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      btsnooz_buffer_.Push(ss.str());
+  uint32_t length = packet_size + /* type byte */ PACKET_TYPE_LENGTH;
+  return {.length_original = htonl(length),
+          .length_captured = htonl(length),
+          .flags = htonl(static_cast<uint32_t>(flags.to_ulong())),
+          .dropped_packets = 0,
+          .timestamp = htonll(timestamp_us + kBtSnoopEpochDelta),
+          .type = static_cast<uint8_t>(type)};
+}
+
+void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType type) {
+  if (CaptureAsync(packet.data(), packet.size(), direction, type)) {
+    return;
+  }
+  PacketHeaderType header = MakePacketHeader(packet.size(), direction, type);
+  uint32_t length = ntohl(header.length_original);
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
+    // btsnoop disabled, log in-memory btsnooz log only
+    WriteBtsnoozPacket(header, packet.data(), packet.size(), type);
+    return;
+  }
+
+  FilterCapturedPacket(packet, direction, type, length, header);
+
+  if (length == 0) {
+    return;
+  } else if (length != ntohl(header.length_original)) {
+    header.length_captured = htonl(length);
+  }
+  WriteBtsnoopPacket(header, packet.data(), packet.size(), length);
+}
+
+void SnoopLogger::Capture(const uint8_t* data, size_t size, Direction direction, PacketType type) {
+  if (CaptureAsync(data, size, direction, type)) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  uint8_t filters = enabled_filters_.load(std::memory_order_relaxed);
+  if (btsnoop_mode_ == kBtSnoopLogModeFiltered && type == PacketType::ACL && (filters & kFilterProfiles)) {
+    // Profile filters rewrite the payload in place, which must not leak into the caller's buffer
+    HciPacket packet(data, data + size);
+    Capture(packet, direction, type);
+    return;
+  }
+
+  PacketHeaderType header = MakePacketHeader(size, direction, type);
+  if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
+    // btsnoop disabled, log in-memory btsnooz log only
+    WriteBtsnoozPacket(header, data, size, type);
+    return;
+  }
+  uint32_t length = ntohl(header.length_original);
+  if (btsnoop_mode_ == kBtSnoopLogModeFiltered && type == PacketType::ACL) {
+    length = ClassifyAclPacket(data, direction, length, filters);
+    if (length == 0) {
       return;
     }
+    header.length_captured = htonl(length);
+  }
+  WriteBtsnoopPacket(header, data, size, length);
+}
 
-    FilterCapturedPacket(packet, direction, type, length, header);
+void SnoopLogger::WriteBtsnoozPacket(PacketHeaderType header, const uint8_t* data, size_t size, PacketType type) {
+  std::stringstream ss;
+  size_t included_length = get_btsnooz_packet_length_to_write(data, size, type, qualcomm_debug_log_enabled_);
+  header.length_captured = htonl(included_length + /* type byte */ PACKET_TYPE_LENGTH);
+  if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
+    LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
+  }
+  if (!ss.write(reinterpret_cast<const char*>(data), included_length)) {
+    LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
+  }
+  btsnooz_buffer_.Push(ss.str());
+}
 
+bool SnoopLogger::CaptureAsync(const uint8_t* data, size_t size, Direction direction, PacketType type) {
+  if (async_writer_ == nullptr) {
+    return false;
+  }
+  PacketHeaderType header = MakePacketHeader(size, direction, type);
+  if (btsnoop_mode_ == kBtSnoopLogModeFiltered && type == PacketType::ACL) {
+    // Profile filters keep state that is updated along with the packets, so their packets are still captured in
+    // order under file_mutex_, and only their write is deferred. The other filters only read the filter action table.
+    uint8_t filters = enabled_filters_.load(std::memory_order_relaxed);
+    if (filters & kFilterProfiles) {
+      return false;
+    }
+    uint32_t length = ClassifyAclPacket(data, direction, ntohl(header.length_original), filters);
     if (length == 0) {
-      return;
-    } else if (length != ntohl(header.length_original)) {
-      header.length_captured = htonl(length);
+      return true;
     }
+    header.length_captured = htonl(length);
+  }
+  async_writer_->Push(&header, sizeof(PacketHeaderType), data, size);
+  return true;
+}
 
+void SnoopLogger::WriteBtsnoopPacket(
+    const PacketHeaderType& header, const uint8_t* data, size_t size, uint32_t length) {
+  if (ring_file_ != nullptr) {
+    if (!ring_file_->Write(&header, sizeof(PacketHeaderType), data, length - 1)) {
+      LOG_ERROR("Packet of %u bytes does not fit the btsnoop ring file", length);
+    }
+    auto* socket = socket_.load();
+    if (socket != nullptr) {
+      socket->WriteRecord(&header, sizeof(PacketHeaderType), data, size);
+    }
+    return;
+  }
+  if (async_writer_ != nullptr) {
+    // The captured length in the header tells the writer how much of the packet goes into the file
+    async_writer_->Push(&header, sizeof(PacketHeaderType), data, size);
+    return;
+  }
+  packet_counter_++;
+  if (packet_counter_ > max_packets_per_file_) {
+    OpenNextSnoopLogFile();
+  }
+  if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
+    LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
+  }
+  if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(data), length - 1)) {
+    LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
+  }
+
+  auto* socket = socket_.load();
+  if (socket != nullptr) {
+    socket->WriteRecord(&header, sizeof(PacketHeaderType), data, size);
+  }
+
+  // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
+  // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
+  // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
+  //       as write() syscall dumps data into kernel memory directly
+  if (!btsnoop_ostream_.flush()) {
+    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+  }
+}
+
+void SnoopLogger::WriteBtsnoopRecords(SnoopLoggerAsyncWriter::Record* records, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    auto& record = records[i];
+    auto* header = reinterpret_cast<PacketHeaderType*>(record.data);
     packet_counter_++;
     if (packet_counter_ > max_packets_per_file_) {
+      FlushBtsnoopIovecs();
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-      LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
+    if (record.dropped_before != 0) {
+      LOG_WARN(
+          "Dropped %u btsnoop packets, %" PRIu64 " since start",
+          record.dropped_before,
+          async_writer_->GetDroppedRecords());
+      dropped_packets_in_file_ += record.dropped_before;
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), length - 1)) {
-      LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
+    // btsnoop counts the packets lost since the first packet of the file
+    header->dropped_packets = htonl(dropped_packets_in_file_);
+    if (record.truncated) {
+      uint32_t length_stored = record.size - sizeof(PacketHeaderType) + PACKET_TYPE_LENGTH;
+      header->length_captured = htonl(std::min(ntohl(header->length_captured), length_stored));
     }
-
-    if (socket_ != nullptr) {
-      socket_->Write(&header, sizeof(PacketHeaderType));
-      socket_->Write(packet.data(), packet.size());
+    btsnoop_iovecs_.push_back(
+        {.iov_base = record.data,
+         .iov_len = sizeof(PacketHeaderType) + ntohl(header->length_captured) - PACKET_TYPE_LENGTH});
+
+    auto* socket = socket_.load();
+    if (socket != nullptr) {
+      socket->WriteRecord(
+          record.data,
+          sizeof(PacketHeaderType),
+          record.data + sizeof(PacketHeaderType),
+          record.size - sizeof(PacketHeaderType));
     }
+  }
+  FlushBtsnoopIovecs();
+}
 
-    // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
-    // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
-    // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
-    //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
-      LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+void SnoopLogger::FlushBtsnoopIovecs() {
+  size_t offset = 0;
+  while (offset < btsnoop_iovecs_.size()) {
+    int iovcnt = std::min<size_t>(btsnoop_iovecs_.size() - offset, IOV_MAX);
+    ssize_t written;
+    RUN_NO_INTR(written = writev(btsnoop_fd_, &btsnoop_iovecs_[offset], iovcnt));
+    if (written <= 0) {
+      LOG_ERROR("Failed to write packets for btsnoop, error: \"%s\"", strerror(errno));
+      break;
+    }
+    size_t remaining = written;
+    while (offset < btsnoop_iovecs_.size() && remaining >= btsnoop_iovecs_[offset].iov_len) {
+      remaining -= btsnoop_iovecs_[offset].iov_len;
+      offset++;
+    }
+    if (remaining > 0) {
+      // Short write, carry on from the middle of the record
+      auto& iov = btsnoop_iovecs_[offset];
+      iov.iov_base = static_cast<uint8_t*>(iov.iov_base) + remaining;
+      iov.iov_len -= remaining;
     }
   }
+  btsnoop_iovecs_.clear();
+}
+
+void SnoopLogger::ExportRingFile() const {
+  if (ring_file_size_ == 0) {
+    return;
+  }
+  // Records are read straight from the file, so this does not hold up packets being captured meanwhile
+  auto records = SnoopLogRingFile::ReadRecords(ring_file_path_);
+  if (!records) {
+    return;
+  }
+  mode_t prevmask = umask(0);
+  std::ofstream btsnoop_ostream(snoop_log_path_, std::ios::binary | std::ios::out);
+  umask(prevmask);
+  if (!btsnoop_ostream.good()) {
+    LOG_ERROR("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
+    return;
+  }
+  if (!btsnoop_ostream.write(
+          reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
+          sizeof(SnoopLoggerCommon::FileHeaderType)) ||
+      !btsnoop_ostream.write(reinterpret_cast<const char*>(records->data()), records->size()) ||
+      !btsnoop_ostream.flush()) {
+    LOG_ERROR("Failed to export ring file to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
+  }
 }
 
 void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
@@ -1322,23 +1685,16 @@ void SnoopLogger::Start() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
     OpenNextSnoopLogFile();
+    if (async_writer_ != nullptr) {
+      async_writer_->Start();
+    }
 
     if (btsnoop_mode_ == kBtSnoopLogModeFiltered) {
       EnableFilters();
     }
 
     if (bluetooth::common::InitFlags::IsSnoopLoggerSocketEnabled()) {
-      auto snoop_logger_socket = std::make_unique<SnoopLoggerSocket>(&syscall_if);
-      snoop_logger_socket_thread_ = std::make_unique<SnoopLoggerSocketThread>(std::move(snoop_logger_socket));
-      auto thread_started_future = snoop_logger_socket_thread_->Start();
-      thread_started_future.wait();
-      if (thread_started_future.get()) {
-        RegisterSocket(snoop_logger_socket_thread_.get());
-      } else {
-        snoop_logger_socket_thread_->Stop();
-        snoop_logger_socket_thread_.reset();
-        snoop_logger_socket_thread_ = nullptr;
-      }
+      StartSocket();
     }
   }
   alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
@@ -1347,16 +1703,19 @@ void SnoopLogger::Start() {
 }
 
 void SnoopLogger::Stop() {
+  // Write what is still buffered. The writer takes file_mutex_ when it rotates files, so it must be joined first.
+  if (async_writer_ != nullptr) {
+    async_writer_->Stop();
+    if (async_writer_->GetDroppedRecords() != 0) {
+      LOG_WARN("Dropped %" PRIu64 " btsnoop packets since start", async_writer_->GetDroppedRecords());
+    }
+  }
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   LOG_DEBUG("Closing btsnoop log data at %s", snoop_log_path_.c_str());
+  ExportRingFile();
   CloseCurrentSnoopLogFile();
 
-  if (snoop_logger_socket_thread_ != nullptr) {
-    snoop_logger_socket_thread_->Stop();
-    snoop_logger_socket_thread_.reset();
-    snoop_logger_socket_thread_ = nullptr;
-    socket_ = nullptr;
-  }
+  StopSocket();
 
   btsnoop_mode_.clear();
   // Disable all filters
@@ -1374,6 +1733,7 @@ void SnoopLogger::Stop() {
 DumpsysDataFinisher SnoopLogger::GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const {
   LOG_DEBUG("Dumping btsnooz log data to %s", snooz_log_path_.c_str());
   DumpSnoozLogToFile(btsnooz_buffer_.Pull());
+  ExportRingFile();
   return Module::GetDumpsysData(builder);
 }
 
@@ -1392,6 +1752,22 @@ size_t SnoopLogger::GetMaxPacketsPerFile() {
   return max_packets_per_file;
 }
 
+size_t SnoopLogger::GetRingFileSize() {
+  // Allow override ring file size via system property
+  auto ring_file_size = kDefaultBtSnoopRingFileSize;
+  {
+    auto ring_file_size_prop = os::GetSystemProperty(kBtSnoopRingFileSizeProperty);
+    if (ring_file_size_prop) {
+      auto ring_file_size_number = common::Uint64FromString(ring_file_size_prop.value());
+      // Leave room for at least one packet
+      if (ring_file_size_number && ring_file_size_number.value() >= sizeof(PacketHeaderType) + sizeof(uint32_t)) {
+        ring_file_size = ring_file_size_number.value();
+      }
+    }
+  }
+  return ring_file_size;
+}
+
 size_t SnoopLogger::GetMaxPacketsPerBuffer() {
   // We want to use at most 256 KB memory for btsnooz log for release builds
   // and 512 KB memory for userdebug/eng builds
@@ -1437,11 +1813,64 @@ std::string SnoopLogger::GetBtSnoopMode() {
   return btsnoop_mode;
 }
 
+void SnoopLogger::StartSocket() {
+  auto snoop_logger_socket = std::make_unique<SnoopLoggerSocket>(&syscall_if);
+  snoop_logger_socket_thread_ = std::make_unique<SnoopLoggerSocketThread>(std::move(snoop_logger_socket));
+  auto thread_started_future = snoop_logger_socket_thread_->Start();
+  thread_started_future.wait();
+  if (!thread_started_future.get()) {
+    snoop_logger_socket_thread_->Stop();
+    snoop_logger_socket_thread_.reset();
+    snoop_logger_socket_thread_ = nullptr;
+    return;
+  }
+
+  auto socket_mode = os::GetSystemProperty(kBtSnoopSocketModeProperty).value_or(kBtSnoopSocketModeRaw);
+  if (socket_mode == kBtSnoopSocketModeCompressed || socket_mode == kBtSnoopSocketModeCompressedHeaders) {
+    auto mode = socket_mode == kBtSnoopSocketModeCompressed ? SnoopLoggerStreamWriter::Mode::COMPRESSED
+                                                            : SnoopLoggerStreamWriter::Mode::COMPRESSED_HEADERS;
+    stream_writer_ = std::make_unique<SnoopLoggerStreamWriter>(snoop_logger_socket_thread_.get(), mode);
+    stream_writer_->Start();
+    RegisterSocket(stream_writer_.get());
+    return;
+  }
+  if (socket_mode != kBtSnoopSocketModeRaw) {
+    LOG_WARN("Unknown btsnoop socket mode %s, streaming raw records", socket_mode.c_str());
+  }
+  RegisterSocket(snoop_logger_socket_thread_.get());
+}
+
+void SnoopLogger::StopSocket() {
+  socket_ = nullptr;
+  if (stream_writer_ != nullptr) {
+    stream_writer_->Stop();
+    auto stats = stream_writer_->GetStats();
+    LOG_INFO(
+        "Streamed %" PRIu64 " btsnoop records in %" PRIu64 " frames, %" PRIu64 " bytes compressed to %" PRIu64
+        ", dropped %" PRIu64 " records",
+        stats.records,
+        stats.frames,
+        stats.raw_bytes,
+        stats.compressed_bytes,
+        stats.dropped_records);
+    stream_writer_.reset();
+  }
+  if (snoop_logger_socket_thread_ != nullptr) {
+    snoop_logger_socket_thread_->Stop();
+    snoop_logger_socket_thread_.reset();
+    snoop_logger_socket_thread_ = nullptr;
+  }
+}
+
 void SnoopLogger::RegisterSocket(SnoopLoggerSocketInterface* socket) {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   socket_ = socket;
 }
 
+uint64_t SnoopLogger::GetDroppedPackets() const {
+  return async_writer_ == nullptr ? 0 : async_writer_->GetDroppedRecords();
+}
+
 bool SnoopLogger::IsBtSnoopLogPersisted() {
   auto is_debuggable = os::GetSystemPropertyBool(kIsDebuggableProperty, false);
   return is_debuggable && os::GetSystemPropertyBool(kBtSnoopLogPersists, false);
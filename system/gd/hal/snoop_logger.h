@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <sys/uio.h>
+
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <mutex>
@@ -25,7 +28,10 @@
 
 #include "common/circular_buffer.h"
 #include "hal/hci_hal.h"
+#include "hal/snoop_log_ring_file.h"
+#include "hal/snoop_logger_async_writer.h"
 #include "hal/snoop_logger_socket_thread.h"
+#include "hal/snoop_logger_stream_writer.h"
 #include "hal/syscall_wrapper_impl.h"
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -142,6 +148,8 @@ class SnoopLogger : public ::bluetooth::Module {
   static const ModuleFactory Factory;
 
   static const std::string kBtSnoopMaxPacketsPerFileProperty;
+  static const std::string kBtSnoopRingFileSizeProperty;
+  static const std::string kBtSnoopSocketModeProperty;
   static const std::string kIsDebuggableProperty;
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopLogPersists;
@@ -157,6 +165,10 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kBtSnoopLogModeFiltered;
   static const std::string kBtSnoopLogModeFull;
 
+  static const std::string kBtSnoopSocketModeRaw;
+  static const std::string kBtSnoopSocketModeCompressed;
+  static const std::string kBtSnoopSocketModeCompressedHeaders;
+
   static const std::string kSoCManufacturerQualcomm;
 
   static const std::string kBtSnoopLogFilterProfileModeFullfillter;
@@ -164,6 +176,12 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kBtSnoopLogFilterProfileModeMagic;
   static const std::string kBtSnoopLogFilterProfileModeDisabled;
 
+  // Bits of enabled_filters_
+  static constexpr uint8_t kFilterHeaders = 1 << 0;
+  static constexpr uint8_t kFilterA2dp = 1 << 1;
+  static constexpr uint8_t kFilterRfcomm = 1 << 2;
+  static constexpr uint8_t kFilterProfiles = 1 << 3;
+
   std::unordered_map<std::string, bool> kBtSnoopLogFilterState = {
       {kBtSnoopLogFilterHeadersProperty, false},
       {kBtSnoopLogFilterProfileA2dpProperty, false},
@@ -194,6 +212,10 @@ class SnoopLogger : public ::bluetooth::Module {
   // Changes to this value is only effective after restarting Bluetooth
   static size_t GetMaxPacketsPerFile();
 
+  // Returns the size in bytes of the data area of the ring file
+  // Changes to this value is only effective after restarting Bluetooth
+  static size_t GetRingFileSize();
+
   static size_t GetMaxPacketsPerBuffer();
 
   // Get snoop logger mode based on current system setup
@@ -223,6 +245,10 @@ class SnoopLogger : public ::bluetooth::Module {
 
   void Capture(HciPacket& packet, Direction direction, PacketType type);
 
+  // Capture a packet that is owned by the caller and must not be modified, e.g. a slice of a shared receive buffer.
+  // The bytes are only copied when the active filtering mode has to rewrite the payload.
+  void Capture(const uint8_t* data, size_t size, Direction direction, PacketType type);
+
   // Set a L2CAP channel as acceptlisted, allowing packets with that L2CAP CID
   // to show up in the snoop logs.
   void AcceptlistL2capChannel(uint16_t conn_handle, uint16_t local_cid, uint16_t remote_cid);
@@ -262,6 +288,9 @@ class SnoopLogger : public ::bluetooth::Module {
 
   void RegisterSocket(SnoopLoggerSocketInterface* socket);
 
+  // Number of packets that were not logged because the async writer fell behind
+  uint64_t GetDroppedPackets() const;
+
  protected:
   // Packet type length
   static const size_t PACKET_TYPE_LENGTH;
@@ -270,6 +299,9 @@ class SnoopLogger : public ::bluetooth::Module {
   static const uint32_t L2CAP_HEADER_SIZE;
   // Max packet data size when headersfiltered option enabled
   static const size_t MAX_HCI_ACL_LEN;
+  // Number of packets the async writer buffers, and the largest packet it logs without truncating it
+  static const size_t ASYNC_MAX_PACKETS;
+  static const size_t ASYNC_MAX_PACKET_SIZE;
 
   void ListDependencies(ModuleList* list) const override;
   void Start() override;
@@ -298,17 +330,17 @@ class SnoopLogger : public ::bluetooth::Module {
   void DisableFilters();
   // Check if the filter is enabled. Pass filter name as a string.
   bool IsFilterEnabled(std::string filter_name);
-  // Check if packet should be filtered (rfcommchannelfiltered mode)
-  bool ShouldFilterLog(bool is_received, uint8_t* packet);
+  // Returns the length of an ACL packet to log once the filters in |filters| are applied, 0 if it is dropped
+  // (a2dppktsfiltered, snoopheadersfiltered and rfcommchannelfiltered modes). The channel is looked up once in the
+  // filter action table, without taking a lock.
+  uint32_t ClassifyAclPacket(const uint8_t* packet, Direction direction, uint32_t length, uint8_t filters) const;
   // Calculate packet length (snoopheadersfiltered mode)
-  void CalculateAclPacketLength(uint32_t& length, uint8_t* packet, bool is_received);
+  void CalculateAclPacketLength(uint32_t& length, const uint8_t* packet, bool is_received) const;
   // Strip packet's payload (profilesfiltered mode)
   uint32_t PayloadStrip(
       profile_type_t current_profile, uint8_t* packet, uint32_t hdr_len, uint32_t pl_len);
   // Filter profile packet according to its filtering mode
   uint32_t FilterProfiles(bool is_received, uint8_t* packet);
-  // Check if packet is A2DP media packet (a2dppktsfiltered mode)
-  bool IsA2dpMediaPacket(bool is_received, uint8_t* packet);
   // Chec if channel is cached in snoop logger for filtering (a2dppktsfiltered mode)
   bool IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid);
   // Handle HFP filtering while profilesfiltered enabled
@@ -330,8 +362,23 @@ class SnoopLogger : public ::bluetooth::Module {
       PacketType type,
       uint32_t& length,
       PacketHeaderType header);
+  static PacketHeaderType MakePacketHeader(size_t packet_size, Direction direction, PacketType type);
+  void WriteBtsnoozPacket(PacketHeaderType header, const uint8_t* data, size_t size, PacketType type);
+  void WriteBtsnoopPacket(const PacketHeaderType& header, const uint8_t* data, size_t size, uint32_t length);
+  // Hand a packet to the async writer once the stateless filters are applied, returns false if it has to be captured
+  // synchronously
+  bool CaptureAsync(const uint8_t* data, size_t size, Direction direction, PacketType type);
+  // Write a batch of records on the async writer's thread
+  void WriteBtsnoopRecords(SnoopLoggerAsyncWriter::Record* records, size_t count);
+  void FlushBtsnoopIovecs();
+  // Write the records of the ring file to the btsnoop file, so that it can be pulled like other snoop logs
+  void ExportRingFile() const;
+  // Start the snoop socket, and the stream writer in front of it if the socket mode asks for one
+  void StartSocket();
+  void StopSocket();
 
   std::unique_ptr<SnoopLoggerSocketThread> snoop_logger_socket_thread_;
+  std::unique_ptr<SnoopLoggerStreamWriter> stream_writer_;
 
  private:
   static std::string btsnoop_mode_;
@@ -346,7 +393,19 @@ class SnoopLogger : public ::bluetooth::Module {
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   std::chrono::milliseconds snooz_log_life_time_;
   std::chrono::milliseconds snooz_log_delete_alarm_interval_;
-  SnoopLoggerSocketInterface* socket_;
+  std::atomic<SnoopLoggerSocketInterface*> socket_;
+  // kFilter* bits of the filters enabled by EnableFilters(), read on each captured packet
+  std::atomic<uint8_t> enabled_filters_{0};
+  // Set when packets are logged asynchronously. The btsnoop file is then written with btsnoop_fd_ instead of
+  // btsnoop_ostream_, and only from the async writer's thread once it started.
+  std::unique_ptr<SnoopLoggerAsyncWriter> async_writer_;
+  int btsnoop_fd_ = -1;
+  uint32_t dropped_packets_in_file_ = 0;
+  std::vector<struct iovec> btsnoop_iovecs_;
+  // Set when packets are logged to the ring file, which then replaces the rotating btsnoop files
+  std::string ring_file_path_;
+  size_t ring_file_size_ = 0;
+  std::unique_ptr<SnoopLogRingFile> ring_file_;
   SyscallWrapperImpl syscall_if;
   bool snoop_log_persists = false;
 };
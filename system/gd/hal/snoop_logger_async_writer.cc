@@ -0,0 +1,165 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_async_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t power = 2;
+  while (power < value) {
+    power <<= 1;
+  }
+  return power;
+}
+
+}  // namespace
+
+SnoopLoggerAsyncWriter::SnoopLoggerAsyncWriter(size_t num_records, size_t record_size, WriteCallback write_records)
+    : mask_(RoundUpToPowerOfTwo(num_records) - 1),
+      record_size_(record_size),
+      wake_up_threshold_(std::max<size_t>((mask_ + 1) / 4, 1)),
+      write_records_(std::move(write_records)),
+      slots_(new Slot[mask_ + 1]),
+      records_(new uint8_t[(mask_ + 1) * record_size_]),
+      batch_(new Record[mask_ + 1]) {
+  ASSERT(record_size_ > 0);
+  ASSERT(write_records_ != nullptr);
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+SnoopLoggerAsyncWriter::~SnoopLoggerAsyncWriter() {
+  Stop();
+}
+
+void SnoopLoggerAsyncWriter::Start() {
+  if (thread_ != nullptr) {
+    return;
+  }
+  running_ = true;
+  thread_ = std::make_unique<std::thread>(&SnoopLoggerAsyncWriter::Run, this);
+}
+
+void SnoopLoggerAsyncWriter::Stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_one();
+  thread_->join();
+  thread_.reset();
+}
+
+bool SnoopLoggerAsyncWriter::Push(const void* header, size_t header_size, const uint8_t* data, size_t size) {
+  size_t position = push_position_.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots_[position & mask_];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (diff == 0) {
+      if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The writer has not released this slot yet, so the ring is full
+      dropped_records_.fetch_add(1, std::memory_order_relaxed);
+      pending_drops_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = push_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  uint8_t* record = &records_[(position & mask_) * record_size_];
+  size_t header_copied = std::min(header_size, record_size_);
+  std::memcpy(record, header, header_copied);
+  size_t data_copied = std::min(size, record_size_ - header_copied);
+  std::memcpy(record + header_copied, data, data_copied);
+  slot->size = header_copied + data_copied;
+  slot->truncated = header_copied + data_copied < header_size + size;
+  slot->dropped_before = pending_drops_.exchange(0, std::memory_order_relaxed);
+  slot->sequence.store(position + 1, std::memory_order_release);
+
+  if ((position + 1) % wake_up_threshold_ == 0 && !wake_up_.exchange(true)) {
+    // Without taking the mutex this may race with the writer going to sleep, which then only delays the batch until
+    // the next flush interval
+    cv_.notify_one();
+  }
+  return true;
+}
+
+uint64_t SnoopLoggerAsyncWriter::GetDroppedRecords() const {
+  return dropped_records_.load(std::memory_order_relaxed);
+}
+
+void SnoopLoggerAsyncWriter::Run() {
+  while (running_) {
+    while (Drain()) {
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, kFlushInterval, [this] { return wake_up_ || !running_; });
+    wake_up_ = false;
+  }
+  while (Drain()) {
+  }
+}
+
+bool SnoopLoggerAsyncWriter::Drain() {
+  const size_t capacity = mask_ + 1;
+  size_t count = 0;
+  while (count < capacity) {
+    size_t position = pop_position_ + count;
+    Slot& slot = slots_[position & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      break;
+    }
+    batch_[count] = {
+        .data = &records_[(position & mask_) * record_size_],
+        .size = slot.size,
+        .truncated = slot.truncated,
+        .dropped_before = slot.dropped_before,
+    };
+    count++;
+  }
+  if (count == 0) {
+    return false;
+  }
+
+  write_records_(batch_.get(), count);
+
+  for (size_t i = 0; i < count; i++) {
+    size_t position = pop_position_ + i;
+    slots_[position & mask_].sequence.store(position + capacity, std::memory_order_release);
+  }
+  pop_position_ += count;
+  return true;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
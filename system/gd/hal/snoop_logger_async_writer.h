@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace bluetooth {
+namespace hal {
+
+// Hands snoop log records from the threads capturing packets to a dedicated writer thread.
+//
+// Records are copied into a bounded ring of preallocated, fixed size slots. Push() never blocks and never allocates:
+// any number of threads may push concurrently, and a record that finds the ring full is dropped and counted instead.
+// The writer thread passes every run of consecutive records to the write callback in one call, so that it can write
+// them with a single writev(). It wakes up when the ring is a quarter full, and at least every kFlushInterval.
+class SnoopLoggerAsyncWriter {
+ public:
+  static constexpr std::chrono::milliseconds kFlushInterval = std::chrono::milliseconds(20);
+
+  struct Record {
+    // The record as pushed, truncated to the slot size. The callback may rewrite it in place.
+    uint8_t* data;
+    size_t size;
+    // Whether the record did not fit a slot
+    bool truncated;
+    // Records dropped since the one before this
+    uint32_t dropped_before;
+  };
+  using WriteCallback = std::function<void(Record* records, size_t count)>;
+
+  // num_records is rounded up to a power of two
+  SnoopLoggerAsyncWriter(size_t num_records, size_t record_size, WriteCallback write_records);
+  SnoopLoggerAsyncWriter(const SnoopLoggerAsyncWriter&) = delete;
+  SnoopLoggerAsyncWriter& operator=(const SnoopLoggerAsyncWriter&) = delete;
+  ~SnoopLoggerAsyncWriter();
+
+  void Start();
+  // Writes the records that are still in the ring and joins the writer thread
+  void Stop();
+
+  // Copy header followed by data into the ring. Returns false if the ring was full and the record was dropped.
+  bool Push(const void* header, size_t header_size, const uint8_t* data, size_t size);
+
+  // Number of records dropped since construction
+  uint64_t GetDroppedRecords() const;
+
+ private:
+  struct Slot {
+    // Vyukov's bounded queue: a slot is free for the push at position p when sequence == p, and holds the record of
+    // that push once sequence == p + 1
+    std::atomic<size_t> sequence;
+    size_t size;
+    bool truncated;
+    uint32_t dropped_before;
+  };
+
+  void Run();
+  // Write every record in the ring, returns false if it was empty
+  bool Drain();
+
+  const size_t mask_;
+  const size_t record_size_;
+  const size_t wake_up_threshold_;
+  WriteCallback write_records_;
+  std::unique_ptr<Slot[]> slots_;
+  std::unique_ptr<uint8_t[]> records_;
+  std::unique_ptr<Record[]> batch_;
+
+  alignas(64) std::atomic<size_t> push_position_ = 0;
+  alignas(64) std::atomic<uint32_t> pending_drops_ = 0;
+  std::atomic<uint64_t> dropped_records_ = 0;
+  // Only accessed by the writer thread, or once it is joined
+  alignas(64) size_t pop_position_ = 0;
+
+  std::atomic<bool> wake_up_ = false;
+  std::atomic<bool> running_ = false;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<std::thread> thread_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
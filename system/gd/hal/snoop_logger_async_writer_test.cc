@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_async_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr uint8_t kHeader[] = {0xa0, 0xa1};
+
+class SnoopLoggerAsyncWriterTest : public ::testing::Test {
+ protected:
+  SnoopLoggerAsyncWriter::WriteCallback Collect() {
+    return [this](SnoopLoggerAsyncWriter::Record* records, size_t count) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batch_sizes_.push_back(count);
+      for (size_t i = 0; i < count; i++) {
+        records_.emplace_back(records[i].data, records[i].data + records[i].size);
+        truncated_.push_back(records[i].truncated);
+        dropped_before_.push_back(records[i].dropped_before);
+      }
+    };
+  }
+
+  static std::vector<uint8_t> Expected(std::vector<uint8_t> data) {
+    data.insert(data.begin(), std::begin(kHeader), std::end(kHeader));
+    return data;
+  }
+
+  std::mutex mutex_;
+  std::vector<size_t> batch_sizes_;
+  std::vector<std::vector<uint8_t>> records_;
+  std::vector<bool> truncated_;
+  std::vector<uint32_t> dropped_before_;
+};
+
+TEST_F(SnoopLoggerAsyncWriterTest, records_are_written_in_order) {
+  SnoopLoggerAsyncWriter writer(16, 32, Collect());
+  writer.Start();
+  for (uint8_t i = 0; i < 100; i++) {
+    std::vector<uint8_t> data = {i, static_cast<uint8_t>(i + 1)};
+    ASSERT_TRUE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+    if (i % 8 == 7) {
+      // Let the writer keep up with the ring
+      std::this_thread::sleep_for(2 * SnoopLoggerAsyncWriter::kFlushInterval);
+    }
+  }
+  writer.Stop();
+
+  ASSERT_EQ(records_.size(), 100u);
+  for (uint8_t i = 0; i < 100; i++) {
+    ASSERT_EQ(records_[i], Expected({i, static_cast<uint8_t>(i + 1)}));
+    ASSERT_FALSE(truncated_[i]);
+    ASSERT_EQ(dropped_before_[i], 0u);
+  }
+  ASSERT_EQ(writer.GetDroppedRecords(), 0u);
+}
+
+TEST_F(SnoopLoggerAsyncWriterTest, buffered_records_are_written_in_one_batch) {
+  SnoopLoggerAsyncWriter writer(16, 32, Collect());
+  std::vector<uint8_t> data = {1, 2, 3};
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  }
+  writer.Start();
+  writer.Stop();
+  ASSERT_EQ(batch_sizes_, std::vector<size_t>({10}));
+}
+
+TEST_F(SnoopLoggerAsyncWriterTest, full_ring_drops_records) {
+  SnoopLoggerAsyncWriter writer(4, 32, Collect());
+  std::vector<uint8_t> data = {1, 2, 3};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  }
+  // The writer is not running, so nothing frees a slot
+  ASSERT_FALSE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  ASSERT_FALSE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  ASSERT_EQ(writer.GetDroppedRecords(), 2u);
+  writer.Start();
+  writer.Stop();
+  ASSERT_EQ(records_.size(), 4u);
+
+  // The next record carries the number of records dropped before it
+  ASSERT_TRUE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  writer.Start();
+  writer.Stop();
+  ASSERT_EQ(records_.size(), 5u);
+  ASSERT_EQ(dropped_before_, std::vector<uint32_t>({0, 0, 0, 0, 2}));
+}
+
+TEST_F(SnoopLoggerAsyncWriterTest, large_record_is_truncated) {
+  SnoopLoggerAsyncWriter writer(4, 8, Collect());
+  std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  ASSERT_TRUE(writer.Push(kHeader, sizeof(kHeader), data.data(), data.size()));
+  writer.Start();
+  writer.Stop();
+  ASSERT_EQ(records_.size(), 1u);
+  ASSERT_EQ(records_[0], Expected({1, 2, 3, 4, 5, 6}));
+  ASSERT_TRUE(truncated_[0]);
+}
+
+TEST_F(SnoopLoggerAsyncWriterTest, concurrent_producers) {
+  constexpr int kProducers = 4;
+  constexpr int kRecordsPerProducer = 1000;
+  SnoopLoggerAsyncWriter writer(kProducers * kRecordsPerProducer, 32, Collect());
+  writer.Start();
+  std::vector<std::thread> producers;
+  for (uint8_t producer = 0; producer < kProducers; producer++) {
+    producers.emplace_back([&writer, producer] {
+      for (int i = 0; i < kRecordsPerProducer; i++) {
+        std::vector<uint8_t> data = {producer, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)};
+        writer.Push(kHeader, sizeof(kHeader), data.data(), data.size());
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  writer.Stop();
+
+  ASSERT_EQ(writer.GetDroppedRecords(), 0u);
+  ASSERT_EQ(records_.size(), static_cast<size_t>(kProducers * kRecordsPerProducer));
+  // Records of each producer keep their order
+  std::vector<int> next(kProducers, 0);
+  for (const auto& record : records_) {
+    ASSERT_EQ(record.size(), sizeof(kHeader) + 3);
+    uint8_t producer = record[2];
+    ASSERT_LT(producer, kProducers);
+    ASSERT_EQ((record[3] << 8) | record[4], next[producer]);
+    next[producer]++;
+  }
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -28,6 +28,17 @@ class SnoopLoggerSocketInterface {
   virtual ~SnoopLoggerSocketInterface() = default;
 
   virtual void Write(const void* data, size_t length) = 0;
+
+  // Writes one btsnoop record, given as its header and the packet
+  virtual void WriteRecord(const void* header, size_t header_length, const void* data, size_t length) {
+    Write(header, header_length);
+    Write(data, length);
+  }
+
+  // Whether anything written reaches a client
+  virtual bool IsClientConnected() const {
+    return true;
+  }
 };
 
 }  // namespace hal
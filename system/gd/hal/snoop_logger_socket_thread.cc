@@ -80,6 +80,10 @@ void SnoopLoggerSocketThread::Write(const void* data, size_t length) {
   socket_->Write(data, length);
 }
 
+bool SnoopLoggerSocketThread::IsClientConnected() const {
+  return socket_->IsClientSocketConnected();
+}
+
 bool SnoopLoggerSocketThread::ThreadIsRunning() const {
   return listen_thread_running_;
 }
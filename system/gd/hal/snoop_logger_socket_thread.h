@@ -40,6 +40,7 @@ class SnoopLoggerSocketThread : public SnoopLoggerSocketInterface {
   std::future<bool> Start();
   void Stop();
   void Write(const void* data, size_t length) override;
+  bool IsClientConnected() const override;
   bool ThreadIsRunning() const;
 
   SnoopLoggerSocket* GetSocket();
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_stream_writer.h"
+
+#include <arpa/inet.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+// A btsnoop record header is followed by the captured bytes: the H4 packet type, which the snoop logger keeps at the
+// end of its record header, and the packet
+constexpr size_t kRecordHeaderLength = 24;
+constexpr size_t kIncludedLengthOffset = 4;
+
+void Append(std::vector<uint8_t>& batch, const void* data, size_t length) {
+  auto* bytes = static_cast<const uint8_t*>(data);
+  batch.insert(batch.end(), bytes, bytes + length);
+}
+
+}  // namespace
+
+SnoopLoggerStreamWriter::SnoopLoggerStreamWriter(
+    SnoopLoggerSocketInterface* socket, Mode mode, size_t payload_length, size_t max_queued_batches)
+    : socket_(socket), mode_(mode), payload_length_(payload_length), max_queued_batches_(max_queued_batches) {
+  ASSERT(socket_ != nullptr);
+  ASSERT(max_queued_batches_ > 0);
+  batch_.reserve(kBatchSize);
+}
+
+SnoopLoggerStreamWriter::~SnoopLoggerStreamWriter() {
+  Stop();
+}
+
+void SnoopLoggerStreamWriter::Start() {
+  if (thread_ != nullptr) {
+    return;
+  }
+  running_ = true;
+  thread_ = std::make_unique<std::thread>(&SnoopLoggerStreamWriter::Run, this);
+}
+
+void SnoopLoggerStreamWriter::Stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_one();
+  thread_->join();
+  thread_.reset();
+}
+
+void SnoopLoggerStreamWriter::Write(const void* data, size_t length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Append(batch_, data, length);
+  if (batch_.size() >= kBatchSize) {
+    QueueBatch();
+  }
+}
+
+void SnoopLoggerStreamWriter::WriteRecord(
+    const void* header, size_t header_length, const void* data, size_t length) {
+  ASSERT(header_length >= kRecordHeaderLength);
+  uint32_t included_length;
+  memcpy(&included_length, static_cast<const uint8_t*>(header) + kIncludedLengthOffset, sizeof(included_length));
+  // The captured length of filtered packets may be shorter than the packet
+  size_t captured_in_header = header_length - kRecordHeaderLength;
+  length = std::min<size_t>(length, std::max<size_t>(ntohl(included_length), captured_in_header) - captured_in_header);
+  if (mode_ == Mode::COMPRESSED_HEADERS) {
+    length = std::min(length, payload_length_);
+  }
+  included_length = htonl(captured_in_header + length);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t offset = batch_.size();
+  Append(batch_, header, header_length);
+  memcpy(&batch_[offset + kIncludedLengthOffset], &included_length, sizeof(included_length));
+  Append(batch_, data, length);
+  batch_records_++;
+  records_++;
+  if (batch_.size() >= kBatchSize) {
+    QueueBatch();
+  }
+}
+
+bool SnoopLoggerStreamWriter::IsClientConnected() const {
+  return socket_->IsClientConnected();
+}
+
+SnoopLoggerStreamWriter::Stats SnoopLoggerStreamWriter::GetStats() const {
+  return {
+      .records = records_,
+      .dropped_records = dropped_records_,
+      .frames = frames_,
+      .raw_bytes = raw_bytes_,
+      .compressed_bytes = compressed_bytes_,
+  };
+}
+
+void SnoopLoggerStreamWriter::QueueBatch() {
+  if (batch_.empty()) {
+    return;
+  }
+  if (queue_.size() >= max_queued_batches_) {
+    pending_dropped_records_ += batch_records_;
+    dropped_records_ += batch_records_;
+    batch_.clear();
+  } else {
+    queue_.push_back({.data = std::move(batch_), .dropped_records = pending_dropped_records_});
+    pending_dropped_records_ = 0;
+    if (free_batches_.empty()) {
+      batch_ = {};
+      batch_.reserve(kBatchSize);
+    } else {
+      batch_ = std::move(free_batches_.back());
+      free_batches_.pop_back();
+    }
+    cv_.notify_one();
+  }
+  batch_records_ = 0;
+}
+
+void SnoopLoggerStreamWriter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (queue_.empty()) {
+      cv_.wait_for(lock, kFlushInterval, [this] { return !queue_.empty() || !running_; });
+      // Send the partial batch when nothing filled one in time, and when stopping
+      if (queue_.empty()) {
+        QueueBatch();
+      }
+      if (queue_.empty()) {
+        if (!running_) {
+          break;
+        }
+        continue;
+      }
+    }
+    QueuedBatch batch = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    SendBatch(batch.data, batch.dropped_records);
+    batch.data.clear();
+    lock.lock();
+    free_batches_.push_back(std::move(batch.data));
+  }
+}
+
+void SnoopLoggerStreamWriter::SendBatch(const std::vector<uint8_t>& batch, uint32_t dropped_records) {
+  // Nothing would be sent, don't spend the CPU time compressing
+  if (!socket_->IsClientConnected()) {
+    return;
+  }
+  uLongf compressed_length = compressBound(batch.size());
+  frame_.resize(sizeof(FrameHeader) + compressed_length);
+  int ret = compress2(
+      frame_.data() + sizeof(FrameHeader), &compressed_length, batch.data(), batch.size(), Z_BEST_SPEED);
+  if (ret != Z_OK) {
+    LOG_ERROR("Unable to compress %zu bytes of snoop records: %d", batch.size(), ret);
+    return;
+  }
+  FrameHeader header = {
+      .magic = {},
+      .raw_length = htonl(batch.size()),
+      .compressed_length = htonl(compressed_length),
+      .dropped_records = htonl(dropped_records),
+  };
+  memcpy(header.magic, kFrameMagic, sizeof(header.magic));
+  memcpy(frame_.data(), &header, sizeof(header));
+  // A single write, so that a client connecting meanwhile starts at a frame boundary
+  socket_->Write(frame_.data(), sizeof(FrameHeader) + compressed_length);
+
+  frames_++;
+  raw_bytes_ += batch.size();
+  compressed_bytes_ += compressed_length;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "hal/snoop_logger_socket_interface.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Streams btsnoop records to a snoop socket in compressed frames, instead of one socket write per record.
+//
+// Records are appended to a batch under a short lock. Full batches are queued for a dedicated thread that compresses
+// each of them with zlib and writes it to the socket as a single frame. At most max_queued_batches wait in the queue:
+// when the client can't keep up, the batches beyond that are dropped and counted, and the frame that follows carries
+// the number of records lost. A partial batch is sent at least every kFlushInterval.
+//
+// After the btsnoop file header that the socket sends on connection, the stream is a sequence of frames, each a
+// FrameHeader followed by compressed_length bytes of zlib data. They inflate to raw_length bytes of btsnoop records.
+class SnoopLoggerStreamWriter : public SnoopLoggerSocketInterface {
+ public:
+  enum class Mode {
+    // Whole records
+    COMPRESSED,
+    // Records with their payload truncated to the first payload_length bytes
+    COMPRESSED_HEADERS,
+  };
+
+  struct FrameHeader {
+    uint8_t magic[4];
+    // All big endian, like the btsnoop records
+    uint32_t raw_length;
+    uint32_t compressed_length;
+    uint32_t dropped_records;
+  } __attribute__((__packed__));
+  static constexpr uint8_t kFrameMagic[4] = {'b', 't', 's', 'z'};
+
+  struct Stats {
+    uint64_t records;
+    uint64_t dropped_records;
+    uint64_t frames;
+    uint64_t raw_bytes;
+    uint64_t compressed_bytes;
+  };
+
+  static constexpr size_t kBatchSize = 32 * 1024;
+  static constexpr size_t kDefaultMaxQueuedBatches = 8;
+  static constexpr size_t kDefaultPayloadLength = 32;
+  static constexpr std::chrono::milliseconds kFlushInterval = std::chrono::milliseconds(100);
+
+  // |socket| must outlive the writer. |payload_length| only applies to Mode::COMPRESSED_HEADERS.
+  SnoopLoggerStreamWriter(
+      SnoopLoggerSocketInterface* socket,
+      Mode mode,
+      size_t payload_length = kDefaultPayloadLength,
+      size_t max_queued_batches = kDefaultMaxQueuedBatches);
+  SnoopLoggerStreamWriter(const SnoopLoggerStreamWriter&) = delete;
+  SnoopLoggerStreamWriter& operator=(const SnoopLoggerStreamWriter&) = delete;
+  ~SnoopLoggerStreamWriter();
+
+  void Start();
+  // Sends what is still batched and joins the sender thread
+  void Stop();
+
+  void Write(const void* data, size_t length) override;
+  void WriteRecord(const void* header, size_t header_length, const void* data, size_t length) override;
+  bool IsClientConnected() const override;
+
+  Stats GetStats() const;
+
+ private:
+  void Run();
+  // Moves the current batch to the queue, or drops it if the queue is full. Called with mutex_ held.
+  void QueueBatch();
+  void SendBatch(const std::vector<uint8_t>& batch, uint32_t dropped_records);
+
+  SnoopLoggerSocketInterface* socket_;
+  const Mode mode_;
+  const size_t payload_length_;
+  const size_t max_queued_batches_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<uint8_t> batch_;
+  uint32_t batch_records_ = 0;
+  struct QueuedBatch {
+    std::vector<uint8_t> data;
+    uint32_t dropped_records;
+  };
+  std::deque<QueuedBatch> queue_;
+  // Emptied batches handed back by the sender, so that batching does not allocate once streaming
+  std::vector<std::vector<uint8_t>> free_batches_;
+  uint32_t pending_dropped_records_ = 0;
+  bool running_ = false;
+  std::unique_ptr<std::thread> thread_;
+  // Only used by the sender thread
+  std::vector<uint8_t> frame_;
+
+  std::atomic<uint64_t> records_ = 0;
+  std::atomic<uint64_t> dropped_records_ = 0;
+  std::atomic<uint64_t> frames_ = 0;
+  std::atomic<uint64_t> raw_bytes_ = 0;
+  std::atomic<uint64_t> compressed_bytes_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_stream_writer.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr size_t kHeaderLength = 25;
+
+class FakeSocket : public SnoopLoggerSocketInterface {
+ public:
+  void Write(const void* data, size_t length) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !blocked_; });
+    auto* bytes = static_cast<const uint8_t*>(data);
+    writes_.emplace_back(bytes, bytes + length);
+  }
+
+  bool IsClientConnected() const override {
+    return connected_;
+  }
+
+  void SetBlocked(bool blocked) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      blocked_ = blocked;
+    }
+    cv_.notify_all();
+  }
+
+  std::vector<std::vector<uint8_t>> writes_;
+  bool connected_ = true;
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool blocked_ = false;
+};
+
+// A btsnoop record header, followed by the H4 packet type
+std::vector<uint8_t> MakeHeader(size_t payload_length) {
+  std::vector<uint8_t> header(kHeaderLength, 0);
+  uint32_t length = htonl(payload_length + 1);
+  memcpy(&header[0], &length, sizeof(length));
+  memcpy(&header[4], &length, sizeof(length));
+  header[24] = 0x02;
+  return header;
+}
+
+struct Frame {
+  std::vector<uint8_t> records;
+  uint32_t dropped_records;
+};
+
+std::vector<Frame> Inflate(const std::vector<std::vector<uint8_t>>& writes) {
+  std::vector<Frame> frames;
+  for (auto& write : writes) {
+    SnoopLoggerStreamWriter::FrameHeader header;
+    EXPECT_GE(write.size(), sizeof(header));
+    memcpy(&header, write.data(), sizeof(header));
+    EXPECT_EQ(0, memcmp(header.magic, SnoopLoggerStreamWriter::kFrameMagic, sizeof(header.magic)));
+    EXPECT_EQ(write.size(), sizeof(header) + ntohl(header.compressed_length));
+
+    uLongf raw_length = ntohl(header.raw_length);
+    std::vector<uint8_t> records(raw_length);
+    EXPECT_EQ(
+        Z_OK,
+        uncompress(records.data(), &raw_length, write.data() + sizeof(header), ntohl(header.compressed_length)));
+    EXPECT_EQ(records.size(), raw_length);
+    frames.push_back({.records = std::move(records), .dropped_records = ntohl(header.dropped_records)});
+  }
+  return frames;
+}
+
+TEST(SnoopLoggerStreamWriterTest, records_are_compressed_into_frames) {
+  FakeSocket socket;
+  SnoopLoggerStreamWriter writer(&socket, SnoopLoggerStreamWriter::Mode::COMPRESSED);
+  writer.Start();
+
+  std::vector<uint8_t> expected;
+  for (uint8_t i = 0; i < 10; i++) {
+    std::vector<uint8_t> payload(i, i);
+    auto header = MakeHeader(payload.size());
+    writer.WriteRecord(header.data(), header.size(), payload.data(), payload.size());
+    expected.insert(expected.end(), header.begin(), header.end());
+    expected.insert(expected.end(), payload.begin(), payload.end());
+  }
+  writer.Stop();
+
+  auto frames = Inflate(socket.writes_);
+  ASSERT_EQ(1ul, frames.size());
+  ASSERT_EQ(expected, frames[0].records);
+  ASSERT_EQ(0u, frames[0].dropped_records);
+
+  auto stats = writer.GetStats();
+  ASSERT_EQ(10ul, stats.records);
+  ASSERT_EQ(1ul, stats.frames);
+  ASSERT_EQ(expected.size(), stats.raw_bytes);
+}
+
+TEST(SnoopLoggerStreamWriterTest, headers_mode_truncates_payload) {
+  FakeSocket socket;
+  SnoopLoggerStreamWriter writer(&socket, SnoopLoggerStreamWriter::Mode::COMPRESSED_HEADERS, 4);
+  writer.Start();
+
+  std::vector<uint8_t> payload = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  auto header = MakeHeader(payload.size());
+  writer.WriteRecord(header.data(), header.size(), payload.data(), payload.size());
+  writer.Stop();
+
+  auto frames = Inflate(socket.writes_);
+  ASSERT_EQ(1ul, frames.size());
+  auto& records = frames[0].records;
+  ASSERT_EQ(kHeaderLength + 4, records.size());
+
+  uint32_t original_length, included_length;
+  memcpy(&original_length, &records[0], sizeof(original_length));
+  memcpy(&included_length, &records[4], sizeof(included_length));
+  ASSERT_EQ(11u, ntohl(original_length));
+  ASSERT_EQ(5u, ntohl(included_length));
+  ASSERT_EQ(std::vector<uint8_t>({0, 1, 2, 3}), std::vector<uint8_t>(records.begin() + kHeaderLength, records.end()));
+}
+
+TEST(SnoopLoggerStreamWriterTest, slow_client_drops_batches) {
+  FakeSocket socket;
+  SnoopLoggerStreamWriter writer(&socket, SnoopLoggerStreamWriter::Mode::COMPRESSED, 0, 1);
+  writer.Start();
+  socket.SetBlocked(true);
+
+  std::vector<uint8_t> payload(1000, 0xab);
+  auto header = MakeHeader(payload.size());
+  size_t num_records = 4 * SnoopLoggerStreamWriter::kBatchSize / payload.size();
+  for (size_t i = 0; i < num_records; i++) {
+    writer.WriteRecord(header.data(), header.size(), payload.data(), payload.size());
+  }
+  socket.SetBlocked(false);
+  writer.Stop();
+
+  auto stats = writer.GetStats();
+  ASSERT_EQ(num_records, stats.records);
+  ASSERT_GT(stats.dropped_records, 0ul);
+
+  size_t received_records = 0;
+  size_t reported_drops = 0;
+  for (auto& frame : Inflate(socket.writes_)) {
+    received_records += frame.records.size() / (kHeaderLength + payload.size());
+    reported_drops += frame.dropped_records;
+  }
+  ASSERT_EQ(num_records, received_records + stats.dropped_records);
+  ASSERT_EQ(stats.dropped_records, reported_drops);
+}
+
+TEST(SnoopLoggerStreamWriterTest, nothing_is_sent_without_client) {
+  FakeSocket socket;
+  socket.connected_ = false;
+  SnoopLoggerStreamWriter writer(&socket, SnoopLoggerStreamWriter::Mode::COMPRESSED);
+  writer.Start();
+
+  std::vector<uint8_t> payload(10, 0);
+  auto header = MakeHeader(payload.size());
+  writer.WriteRecord(header.data(), header.size(), payload.data(), payload.size());
+  writer.Stop();
+
+  ASSERT_TRUE(socket.writes_.empty());
+  ASSERT_EQ(0ul, writer.GetStats().frames);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -330,6 +330,34 @@ TEST_F(SnoopLoggerModuleTest, capture_hci_cmd_btsnooz_test) {
   ASSERT_FALSE(std::filesystem::exists(temp_snooz_log_));
 }
 
+TEST_F(SnoopLoggerModuleTest, capture_one_packet_from_shared_buffer_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // Packet preceded by an H4 type byte, as it sits in a HAL receive buffer
+  std::vector<uint8_t> buffer = {0x01};
+  buffer.insert(buffer.end(), kInformationRequest.begin(), kInformationRequest.end());
+  const std::vector<uint8_t> original = buffer;
+  snoop_logger->Capture(
+      buffer.data() + 1, buffer.size() - 1, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  ASSERT_EQ(buffer, original);
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size());
+}
+
 TEST_F(SnoopLoggerModuleTest, capture_l2cap_signal_packet_btsnooz_test) {
   // Actual test
   auto* snoop_logger = new TestSnoopLoggerModule(
@@ -1072,6 +1100,54 @@ TEST_F(SnoopLoggerModuleTest, rfcomm_channel_filtered_acceptlisted_l2cap_channel
   ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
 }
 
+TEST_F(SnoopLoggerModuleTest, rfcomm_channel_filtered_cleared_l2cap_channel_test) {
+  // Actual test
+  uint16_t conn_handle = 0x000c;
+  uint16_t local_cid = 0x0042;
+  uint16_t remote_cid = 0x3041;
+
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(
+      SnoopLogger::kBtSnoopLogFilterProfileRfcommProperty, "true"));
+
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFiltered,
+      false,
+      false);
+
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  snoop_logger->AcceptlistL2capChannel(conn_handle, local_cid, remote_cid);
+
+  std::vector<uint8_t> kL2capChannel = {
+      0x0c, 0x20, 0x12, 0x00, 0x0e, 0x00, 0x42, 0x00, 0x00, 0xef, 0x15,
+      0x83, 0x11, 0x06, 0xf0, 0x07, 0x00, 0x9d, 0x02, 0x00, 0x07, 0x70,
+  };
+
+  snoop_logger->Capture(kL2capChannel, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
+  snoop_logger->ClearL2capAcceptlist(conn_handle, local_cid, remote_cid);
+  snoop_logger->Capture(kL2capChannel, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
+
+  test_registry.StopAll();
+
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(
+      SnoopLogger::kBtSnoopLogFilterProfileRfcommProperty, "false"));
+
+  // Verify states after test
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_filtered));
+
+  // The first packet is logged whole, the second one only up to its L2CAP header once the channel is cleared
+  constexpr size_t kL2capHeaderSize = 8;
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_filtered),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + 2 * sizeof(SnoopLogger::PacketHeaderType) +
+          kL2capChannel.size() + kL2capHeaderSize);
+  ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
+}
+
 TEST_F(SnoopLoggerModuleTest, profiles_filtered_hfp_hf_test) {
   // Actual test
   uint16_t conn_handle = 0x000b;
@@ -1589,4 +1665,82 @@ TEST_F(SnoopLoggerModuleTest, custom_socket_interface_register_logging_enabled_t
 
   test_registry->StopAll();
 }
+
+TEST_F(SnoopLoggerModuleTest, async_capture_and_rotate_test) {
+  const char* async_test_flags[] = {
+      "INIT_logging_debug_enabled_for_all=true",
+      "INIT_gd_hal_snoop_logger_async=true",
+      nullptr,
+  };
+  bluetooth::common::InitFlags::Load(async_test_flags);
+
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 11; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+  ASSERT_EQ(snoop_logger->GetDroppedPackets(), 0u);
+
+  // Stopping writes every buffered packet
+  test_registry->StopAll();
+
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 1);
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_last_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
+}
+
+TEST_F(SnoopLoggerModuleTest, ring_file_capture_and_export_test) {
+  const char* ring_test_flags[] = {
+      "INIT_logging_debug_enabled_for_all=true",
+      "INIT_gd_hal_snoop_logger_mmap_ring=true",
+      nullptr,
+  };
+  bluetooth::common::InitFlags::Load(ring_test_flags);
+  const size_t record_size = sizeof(uint32_t) + sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size();
+  ASSERT_TRUE(
+      bluetooth::os::SetSystemProperty(SnoopLogger::kBtSnoopRingFileSizeProperty, std::to_string(4 * record_size)));
+  auto ring_file = temp_snoop_log_.string() + ".ring";
+
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // The ring keeps the most recent packets instead of rotating files
+  for (int i = 0; i < 11; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+  ASSERT_TRUE(std::filesystem::exists(ring_file));
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_last_));
+
+  // Packets can be extracted while logging goes on
+  snoop_logger->CallGetDumpsysData(builder_);
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 4);
+
+  test_registry->StopAll();
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(SnoopLogger::kBtSnoopRingFileSizeProperty, ""));
+  ASSERT_TRUE(std::filesystem::remove(ring_file));
+}
 }  // namespace testing
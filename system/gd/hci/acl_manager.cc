@@ -28,6 +28,7 @@
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_acl_connection.h"
 #include "hci/acl_manager/le_impl.h"
+#include "hci/acl_manager/packet_latency.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
@@ -65,7 +66,10 @@ struct AclManager::impl {
     hci_layer_ = acl_manager_.GetDependency<HciLayer>();
     handler_ = acl_manager_.GetHandler();
     controller_ = acl_manager_.GetDependency<Controller>();
-    round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
+    {
+      const std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
+    }
     acl_scheduler_ = acl_manager_.GetDependency<AclScheduler>();
 
     if (bluetooth::common::init_flags::gd_remote_name_request_is_enabled()) {
@@ -108,7 +112,11 @@ struct AclManager::impl {
     unknown_acl_alarm_.reset();
     waiting_packets_.clear();
 
-    delete round_robin_scheduler_;
+    {
+      const std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      delete round_robin_scheduler_;
+      round_robin_scheduler_ = nullptr;
+    }
     hci_queue_end_ = nullptr;
     handler_ = nullptr;
     hci_layer_ = nullptr;
@@ -161,6 +169,7 @@ struct AclManager::impl {
     }
     uint16_t handle = packet->GetHandle();
     if (handle == kQualcommDebugHandle) return;
+    acl_manager::RecordPacketLatency(handle, acl_manager::PacketLatencyStage::RX_ACL_MANAGER, packet->GetTimestamp());
     if (classic_impl_->send_packet_upward(
             handle, [&packet](struct acl_manager::assembler* assembler) { assembler->on_incoming_packet(*packet); }))
       return;
@@ -417,6 +426,10 @@ void AclManager::HACK_SetNonAclDisconnectCallback(std::function<void(uint16_t, u
   pimpl_->classic_impl_->HACK_SetNonAclDisconnectCallback(callback);
 }
 
+void AclManager::SetAclTxQos(uint16_t handle, uint16_t weight, std::chrono::milliseconds latency_target) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkQos, handle, weight, latency_target);
+}
+
 void AclManager::HACK_SetAclTxPriority(uint8_t handle, bool high_priority) {
   CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkPriority, handle, high_priority);
 }
@@ -467,12 +480,35 @@ void AclManager::impl::Dump(
   }
   auto vecofstrings = fb_builder->CreateVector(strings, connect_list.size());
 
+  std::vector<flatbuffers::Offset<AclSchedulerLinkData>> link_offsets;
+  if (round_robin_scheduler_ != nullptr) {
+    for (const auto& stats : round_robin_scheduler_->GetLinkStats()) {
+      bool is_le = stats.connection_type_ == RoundRobinScheduler::ConnectionType::LE;
+      auto connection_type = fb_builder->CreateString(is_le ? "LE" : "CLASSIC");
+      AclSchedulerLinkDataBuilder link_builder(*fb_builder);
+      link_builder.add_handle(stats.handle_);
+      link_builder.add_connection_type(connection_type);
+      link_builder.add_weight(stats.weight_);
+      link_builder.add_latency_target_ms(stats.latency_target_.count());
+      link_builder.add_high_priority(stats.high_priority_);
+      link_builder.add_sent_packets(stats.sent_packets_);
+      link_builder.add_sent_fragments(stats.sent_fragments_);
+      link_builder.add_credit_starved_count(stats.credit_starved_count_);
+      link_builder.add_credit_starved_time_ms(stats.credit_starved_time_.count());
+      link_builder.add_max_queueing_delay_ms(stats.max_queueing_delay_.count());
+      link_builder.add_latency_target_misses(stats.latency_target_misses_);
+      link_offsets.push_back(link_builder.Finish());
+    }
+  }
+  auto acl_scheduler_links = fb_builder->CreateVector(link_offsets);
+
   AclManagerDataBuilder builder(*fb_builder);
   builder.add_title(title);
   builder.add_le_filter_accept_list_count(connect_list.size());
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  builder.add_acl_scheduler_links(acl_scheduler_links);
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
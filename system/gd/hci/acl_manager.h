@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
@@ -149,6 +150,10 @@ public:
  virtual void OnLeSuspendInitiatedDisconnect(uint16_t handle, ErrorCode reason);
  virtual void SetSystemSuspendState(bool suspended);
 
+ // Share of the controller's ACL buffers |handle| gets while other links are busy, and how long its PDUs may wait
+ // before they are sent out of turn.  A zero |latency_target| clears it.
+ virtual void SetAclTxQos(uint16_t handle, uint16_t weight, std::chrono::milliseconds latency_target);
+
  static const ModuleFactory Factory;
 
 protected:
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "common/bind.h"
+#include "hci/acl_manager/acl_fragmenter.h"
+#include "hci/acl_manager/assembler.h"
+#include "hci/hci_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::CompletionCounter;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+constexpr uint16_t kHandle = 0x0123;
+constexpr uint16_t kCid = 0x0040;
+constexpr size_t kAclMtu = 1021;
+
+// An L2CAP basic frame with |payload_size| bytes of payload
+std::vector<uint8_t> MakeL2capPdu(size_t payload_size) {
+  std::vector<uint8_t> pdu = {
+      static_cast<uint8_t>(payload_size & 0xff),
+      static_cast<uint8_t>(payload_size >> 8),
+      static_cast<uint8_t>(kCid & 0xff),
+      static_cast<uint8_t>(kCid >> 8)};
+  pdu.resize(kL2capBasicFrameHeaderSize + payload_size, 0xa5);
+  return pdu;
+}
+
+// Fragment |pdu| into HCI ACL packets the way RoundRobinScheduler does
+std::vector<std::vector<uint8_t>> FragmentPdu(const std::vector<uint8_t>& pdu, size_t mtu) {
+  std::vector<std::vector<uint8_t>> acl_packets;
+  auto fragments = AclFragmenter(mtu, std::make_unique<packet::RawBuilder>(pdu)).GetFragments();
+  PacketBoundaryFlag packet_boundary_flag = PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE;
+  for (auto& fragment : fragments) {
+    auto acl = AclBuilder::Create(kHandle, packet_boundary_flag, BroadcastFlag::POINT_TO_POINT, std::move(fragment));
+    packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
+    std::vector<uint8_t> bytes;
+    bytes.reserve(acl->size());
+    packet::BitInserter i(bytes);
+    acl->Serialize(i);
+    acl_packets.push_back(std::move(bytes));
+  }
+  return acl_packets;
+}
+
+void BM_AclFragmenter_vary_by_pdu_size(State& state) {
+  auto pdu = MakeL2capPdu(state.range(0));
+  int64_t fragments_per_pdu = FragmentPdu(pdu, kAclMtu).size();
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    auto acl_packets = FragmentPdu(pdu, kAclMtu);
+    ::benchmark::DoNotOptimize(acl_packets);
+  }
+  counters.Report(fragments_per_pdu, pdu.size() / fragments_per_pdu);
+}
+
+// Feeds prebuilt ACL fragments of one L2CAP PDU per iteration to an assembler on its handler thread and waits for
+// the reassembled PDU to come out of the connection queue
+class BM_AclAssembler : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("assembler_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    queue_ = std::make_unique<AclConnection::Queue>(kMaxQueuedPacketsPerConnection);
+    assembler_ = std::make_unique<assembler>(
+        AddressWithType(Address::kEmpty, AddressType::PUBLIC_DEVICE_ADDRESS), queue_->GetDownEnd(), handler_);
+    completed_ = std::make_unique<CompletionCounter>();
+    queue_->GetUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&BM_AclAssembler::on_pdu_ready, common::Unretained(this)));
+  }
+
+  void TearDown(State& st) override {
+    queue_->GetUpEnd()->UnregisterDequeue();
+    handler_->Clear();
+    assembler_.reset();
+    queue_.reset();
+    delete handler_;
+    delete thread_;
+    completed_.reset();
+    fragments_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void on_pdu_ready() {
+    auto pdu = queue_->GetUpEnd()->TryDequeue();
+    ::benchmark::DoNotOptimize(pdu->size());
+    completed_->Add();
+  }
+
+  void feed_fragments() {
+    for (const auto& fragment : fragments_) {
+      assembler_->on_incoming_packet(fragment);
+    }
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+  std::unique_ptr<AclConnection::Queue> queue_;
+  std::unique_ptr<assembler> assembler_;
+  std::unique_ptr<CompletionCounter> completed_;
+  std::vector<AclView> fragments_;
+};
+
+}  // namespace
+
+BENCHMARK(BM_AclFragmenter_vary_by_pdu_size)->Arg(27)->Arg(672)->Arg(1691)->Arg(8192);
+
+BENCHMARK_DEFINE_F(BM_AclAssembler, reassemble_vary_by_pdu_size)(State& state) {
+  auto pdu = MakeL2capPdu(state.range(0));
+  for (auto& bytes : FragmentPdu(pdu, kAclMtu)) {
+    auto view = AclView::Create(
+        packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::move(bytes))));
+    ASSERT(view.IsValid());
+    fragments_.push_back(view);
+  }
+
+  uint64_t received = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    handler_->Post(common::BindOnce(&BM_AclAssembler::feed_fragments, common::Unretained(this)));
+    completed_->WaitFor(++received);
+  }
+  counters.Report(fragments_.size(), pdu.size() / fragments_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_AclAssembler, reassemble_vary_by_pdu_size)
+    ->Arg(27)
+    ->Arg(672)
+    ->Arg(1691)
+    ->Arg(8192)
+    ->UseRealTime();
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
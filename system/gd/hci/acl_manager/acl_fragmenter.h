@@ -23,7 +23,7 @@
 #include <vector>
 
 #include "packet/base_packet_builder.h"
-#include "packet/raw_builder.h"
+#include "packet/fragment_builder.h"
 
 namespace bluetooth {
 namespace hci {
@@ -34,7 +34,8 @@ class AclFragmenter {
   AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> input);
   virtual ~AclFragmenter() = default;
 
-  std::vector<std::unique_ptr<packet::RawBuilder>> GetFragments();
+  // The fragments share a single serialized copy of the input packet
+  std::vector<std::unique_ptr<packet::FragmentBuilder>> GetFragments();
 
  private:
   size_t mtu_;
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Entries of the links indexed by their 12-bit connection handle, so that the per packet lookups on the ACL data path
+// cost the same however many links there are. The table does not own the entries, which have to stay at the same
+// address while they are in it, like the values of the std::map the owner keeps them in.
+template <typename T>
+class AclHandleTable {
+ public:
+  static constexpr size_t kSize = 0x1000;
+
+  T* Find(uint16_t handle) const {
+    return handle < kSize ? entries_[handle] : nullptr;
+  }
+
+  void Set(uint16_t handle, T* entry) {
+    if (handle < kSize) {
+      entries_[handle] = entry;
+    }
+  }
+
+  void Remove(uint16_t handle) {
+    Set(handle, nullptr);
+  }
+
+  void Clear() {
+    entries_.fill(nullptr);
+  }
+
+ private:
+  std::array<T*, kSize> entries_{};
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_handle_table.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+TEST(AclHandleTableTest, set_find_and_remove) {
+  AclHandleTable<int> table;
+  int first = 1;
+  int second = 2;
+  ASSERT_EQ(nullptr, table.Find(0x0001));
+
+  table.Set(0x0001, &first);
+  table.Set(0x0eff, &second);
+  ASSERT_EQ(&first, table.Find(0x0001));
+  ASSERT_EQ(&second, table.Find(0x0eff));
+
+  table.Remove(0x0001);
+  ASSERT_EQ(nullptr, table.Find(0x0001));
+  ASSERT_EQ(&second, table.Find(0x0eff));
+}
+
+TEST(AclHandleTableTest, clear) {
+  AclHandleTable<int> table;
+  int entry = 1;
+  table.Set(0x0000, &entry);
+  table.Set(0x0fff, &entry);
+  table.Clear();
+  ASSERT_EQ(nullptr, table.Find(0x0000));
+  ASSERT_EQ(nullptr, table.Find(0x0fff));
+}
+
+TEST(AclHandleTableTest, handle_out_of_range) {
+  AclHandleTable<int> table;
+  int entry = 1;
+  table.Set(0x1000, &entry);
+  ASSERT_EQ(nullptr, table.Find(0x1000));
+  ASSERT_EQ(nullptr, table.Find(0xffff));
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
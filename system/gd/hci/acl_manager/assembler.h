@@ -19,8 +19,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "hci/acl_manager/acl_connection.h"
+#include "hci/acl_manager/packet_latency.h"
 #include "hci/address_with_type.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -34,6 +36,7 @@ constexpr size_t kMaxQueuedPacketsPerConnection = 10;
 constexpr size_t kL2capBasicFrameHeaderSize = 4;
 
 namespace {
+// Chains the fragments of an L2CAP PDU as they are, the payloads stay in the buffers they were received in
 class PacketViewForRecombination : public packet::PacketView<packet::kLittleEndian> {
  public:
   PacketViewForRecombination(const PacketView& packetView) : PacketView(packetView) {}
@@ -61,8 +64,8 @@ struct assembler {
   AddressWithType address_with_type_;
   AclConnection::QueueDownEnd* down_end_;
   os::Handler* handler_;
-  PacketViewForRecombination recombination_stage_{
-      PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
+  // Starts at the first fragment of the PDU being recombined, unset between PDUs
+  std::optional<PacketViewForRecombination> recombination_stage_;
   size_t remaining_sdu_continuation_packet_size_ = 0;
   std::shared_ptr<std::atomic_bool> enqueue_registered_ = std::make_shared<std::atomic_bool>(false);
   std::queue<packet::PacketView<packet::kLittleEndian>> incoming_queue_;
@@ -75,12 +78,12 @@ struct assembler {
 
   // Invoked from some external Queue Reactable context
   std::unique_ptr<packet::PacketView<packet::kLittleEndian>> on_le_incoming_data_ready() {
-    auto packet = incoming_queue_.front();
+    auto packet = std::make_unique<PacketView<packet::kLittleEndian>>(incoming_queue_.front());
     incoming_queue_.pop();
     if (incoming_queue_.empty() && enqueue_registered_->exchange(false)) {
       down_end_->UnregisterEnqueue();
     }
-    return std::make_unique<PacketView<packet::kLittleEndian>>(packet);
+    return packet;
   }
 
   void on_incoming_packet(AclView packet) {
@@ -97,25 +100,24 @@ struct assembler {
       return;
     }
     if (packet_boundary_flag == PacketBoundaryFlag::CONTINUING_FRAGMENT) {
-      if (remaining_sdu_continuation_packet_size_ < payload_size) {
+      if (!recombination_stage_.has_value() || remaining_sdu_continuation_packet_size_ < payload_size) {
         LOG_WARN("Remote sent unexpected L2CAP PDU. Drop the entire L2CAP PDU");
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        recombination_stage_.reset();
         remaining_sdu_continuation_packet_size_ = 0;
         return;
       }
       remaining_sdu_continuation_packet_size_ -= payload_size;
-      recombination_stage_.AppendPacketView(payload);
+      recombination_stage_->AppendPacketView(payload);
       if (remaining_sdu_continuation_packet_size_ != 0) {
         return;
       } else {
-        payload = recombination_stage_;
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        payload = *recombination_stage_;
+        recombination_stage_.reset();
       }
     } else if (packet_boundary_flag == PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE) {
-      if (recombination_stage_.size() > 0) {
+      if (recombination_stage_.has_value()) {
         LOG_ERROR("Controller sent a starting packet without finishing previous packet. Drop previous one.");
+        recombination_stage_.reset();
       }
       size_t l2cap_pdu_size = GetL2capPduSize(packet);
       if (l2cap_pdu_size == 0) {
@@ -135,9 +137,10 @@ struct assembler {
             l2cap_pdu_size - (payload_size - kL2capBasicFrameHeaderSize);
       }
       if (remaining_sdu_continuation_packet_size_ > 0) {
-        recombination_stage_ = payload;
+        recombination_stage_.emplace(payload);
         return;
       }
+      // Fast path: the first fragment carries the whole PDU, which is delivered without being staged
     }
     if (incoming_queue_.size() > kMaxQueuedPacketsPerConnection) {
       LOG_ERROR("Dropping packet from %s due to congestion",
@@ -145,6 +148,7 @@ struct assembler {
       return;
     }
 
+    RecordPacketLatency(packet.GetHandle(), PacketLatencyStage::RX_REASSEMBLED, payload.GetTimestamp());
     incoming_queue_.push(payload);
     if (!enqueue_registered_->exchange(true)) {
       down_end_->RegisterEnqueue(handler_,
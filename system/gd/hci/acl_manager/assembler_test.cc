@@ -0,0 +1,160 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/assembler.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "common/bind.h"
+#include "hci/acl_manager/acl_fragmenter.h"
+#include "hci/hci_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+constexpr uint16_t kHandle = 0x0123;
+constexpr uint16_t kCid = 0x0040;
+constexpr size_t kAclMtu = 27;
+
+std::vector<uint8_t> MakeL2capPdu(size_t payload_size, uint8_t fill) {
+  std::vector<uint8_t> pdu = {
+      static_cast<uint8_t>(payload_size & 0xff),
+      static_cast<uint8_t>(payload_size >> 8),
+      static_cast<uint8_t>(kCid & 0xff),
+      static_cast<uint8_t>(kCid >> 8)};
+  pdu.resize(kL2capBasicFrameHeaderSize + payload_size, fill);
+  return pdu;
+}
+
+std::vector<AclView> FragmentPdu(const std::vector<uint8_t>& pdu) {
+  std::vector<AclView> acl_packets;
+  auto fragments = AclFragmenter(kAclMtu, std::make_unique<packet::RawBuilder>(pdu)).GetFragments();
+  PacketBoundaryFlag packet_boundary_flag = PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE;
+  for (auto& fragment : fragments) {
+    auto acl = AclBuilder::Create(kHandle, packet_boundary_flag, BroadcastFlag::POINT_TO_POINT, std::move(fragment));
+    packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    packet::BitInserter i(*bytes);
+    acl->Serialize(i);
+    auto view = AclView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+    EXPECT_TRUE(view.IsValid());
+    acl_packets.push_back(view);
+  }
+  return acl_packets;
+}
+
+class AssemblerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("assembler_test", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    queue_ = std::make_unique<AclConnection::Queue>(kMaxQueuedPacketsPerConnection);
+    assembler_ = std::make_unique<assembler>(
+        AddressWithType(Address::kEmpty, AddressType::PUBLIC_DEVICE_ADDRESS), queue_->GetDownEnd(), handler_);
+    queue_->GetUpEnd()->RegisterDequeue(handler_, common::Bind(&AssemblerTest::on_pdu, common::Unretained(this)));
+  }
+
+  void TearDown() override {
+    queue_->GetUpEnd()->UnregisterDequeue();
+    handler_->Clear();
+    assembler_.reset();
+    queue_.reset();
+    delete handler_;
+    delete thread_;
+  }
+
+  void on_pdu() {
+    auto pdu = queue_->GetUpEnd()->TryDequeue();
+    received_.emplace_back(pdu->begin(), pdu->end());
+  }
+
+  // Feeds |fragments| on the handler thread and returns the PDUs that came out of the connection queue
+  std::vector<std::vector<uint8_t>> Feed(const std::vector<AclView>& fragments) {
+    handler_->Post(common::BindOnce(
+        [](assembler* assembler, std::vector<AclView> fragments) {
+          for (auto& fragment : fragments) {
+            assembler->on_incoming_packet(fragment);
+          }
+        },
+        assembler_.get(),
+        fragments));
+    EXPECT_TRUE(thread_->GetReactor()->WaitForIdle(2s));
+    return std::move(received_);
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+  std::unique_ptr<AclConnection::Queue> queue_;
+  std::unique_ptr<assembler> assembler_;
+  std::vector<std::vector<uint8_t>> received_;
+};
+
+TEST_F(AssemblerTest, pdu_in_a_single_fragment) {
+  auto pdu = MakeL2capPdu(10, 0x11);
+  auto fragments = FragmentPdu(pdu);
+  ASSERT_EQ(1ul, fragments.size());
+  auto received = Feed(fragments);
+  ASSERT_EQ(1ul, received.size());
+  ASSERT_EQ(pdu, received[0]);
+}
+
+TEST_F(AssemblerTest, fragmented_pdu_is_recombined) {
+  auto pdu = MakeL2capPdu(100, 0x22);
+  auto fragments = FragmentPdu(pdu);
+  ASSERT_EQ(4ul, fragments.size());
+  auto received = Feed(fragments);
+  ASSERT_EQ(1ul, received.size());
+  ASSERT_EQ(pdu, received[0]);
+}
+
+TEST_F(AssemblerTest, continuation_without_start_is_dropped) {
+  auto fragments = FragmentPdu(MakeL2capPdu(40, 0x33));
+  ASSERT_TRUE(Feed({fragments[1]}).empty());
+
+  auto pdu = MakeL2capPdu(40, 0x44);
+  auto received = Feed(FragmentPdu(pdu));
+  ASSERT_EQ(1ul, received.size());
+  ASSERT_EQ(pdu, received[0]);
+}
+
+TEST_F(AssemblerTest, unfinished_pdu_is_dropped_by_next_start) {
+  auto unfinished = FragmentPdu(MakeL2capPdu(40, 0x55));
+  ASSERT_TRUE(Feed({unfinished[0]}).empty());
+
+  // A complete PDU in one fragment, then the rest of the dropped one
+  auto pdu = MakeL2capPdu(10, 0x66);
+  auto received = Feed(FragmentPdu(pdu));
+  ASSERT_EQ(1ul, received.size());
+  ASSERT_EQ(pdu, received[0]);
+  ASSERT_TRUE(Feed({unfinished[1]}).empty());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
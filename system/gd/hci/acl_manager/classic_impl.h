@@ -22,6 +22,7 @@
 
 #include "common/bind.h"
 #include "common/init_flags.h"
+#include "hci/acl_manager/acl_handle_table.h"
 #include "hci/acl_manager/acl_scheduler.h"
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/event_checkers.h"
@@ -137,11 +138,13 @@ struct classic_impl : public security::ISecurityManagerListener {
   struct {
    private:
     std::map<uint16_t, acl_connection> acl_connections_;
+    // The entries of acl_connections_ by handle, for the lookups of every received packet
+    AclHandleTable<acl_connection> acl_connection_table_;
     mutable std::mutex acl_connections_guard_;
     ConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
-      auto connection = acl_connections_.find(handle);
-      if (connection == acl_connections_.end()) return nullptr;
-      return connection->second.connection_management_callbacks_;
+      auto connection = acl_connection_table_.Find(handle);
+      if (connection == nullptr) return nullptr;
+      return connection->connection_management_callbacks_;
     }
     ConnectionManagementCallbacks* find_callbacks(const Address& address) {
       for (auto& connection_pair : acl_connections_) {
@@ -155,6 +158,7 @@ struct classic_impl : public security::ISecurityManagerListener {
       auto connection = acl_connections_.find(handle);
       if (connection != acl_connections_.end()) {
         connection->second.connection_management_callbacks_ = nullptr;
+        acl_connection_table_.Remove(handle);
         acl_connections_.erase(handle);
       }
     }
@@ -167,6 +171,7 @@ struct classic_impl : public security::ISecurityManagerListener {
     }
     void reset() {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
+      acl_connection_table_.Clear();
       acl_connections_.clear();
     }
     void invalidate(uint16_t handle) {
@@ -192,9 +197,9 @@ struct classic_impl : public security::ISecurityManagerListener {
     }
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
-      auto connection = acl_connections_.find(handle);
-      if (connection != acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != acl_connections_.end();
+      auto connection = acl_connection_table_.Find(handle);
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -209,6 +214,7 @@ struct classic_impl : public security::ISecurityManagerListener {
           std::forward_as_tuple(remote_address, queue_end, handler));
       ASSERT(emplace_pair.second);  // Make sure the connection is unique
       emplace_pair.first->second.connection_management_callbacks_ = connection_management_callbacks;
+      acl_connection_table_.Set(handle, &emplace_pair.first->second);
     }
     uint16_t HACK_get_handle(const Address& address) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
@@ -207,6 +207,47 @@ void LeAclConnection::LeSubrateRequest(
       pimpl_->tracker.client_handler_->BindOnceOn(this, &LeAclConnection::OnLeSubrateRequestStatus));
 }
 
+void LeAclConnection::OnLeSetDataLengthComplete(CommandCompleteView complete) {
+  auto complete_view = LeSetDataLengthCompleteView::Create(complete);
+  ASSERT(complete_view.IsValid());
+  auto hci_status = complete_view.GetStatus();
+  if (hci_status != ErrorCode::SUCCESS) {
+    LOG_INFO("LeSetDataLength status %s", ErrorCodeText(hci_status).c_str());
+  }
+}
+
+bool LeAclConnection::LeSetDataLength(uint16_t tx_octets, uint16_t tx_time) {
+  if (tx_octets < 0x001B || tx_octets > 0x00FB || tx_time < 0x0148 || tx_time > 0x4290) {
+    LOG_ERROR("Invalid parameter");
+    return false;
+  }
+  pimpl_->tracker.le_acl_connection_interface_->EnqueueCommand(
+      LeSetDataLengthBuilder::Create(handle_, tx_octets, tx_time),
+      pimpl_->tracker.client_handler_->BindOnceOn(this, &LeAclConnection::OnLeSetDataLengthComplete));
+  return true;
+}
+
+void LeAclConnection::OnLeSetPhyStatus(CommandStatusView status) {
+  auto set_phy_status = LeSetPhyStatusView::Create(status);
+  ASSERT(set_phy_status.IsValid());
+  auto hci_status = set_phy_status.GetStatus();
+  if (hci_status != ErrorCode::SUCCESS) {
+    LOG_INFO("LeSetPhy status %s", ErrorCodeText(hci_status).c_str());
+    pimpl_->tracker.OnPhyUpdate(hci_status, 0, 0);
+  }
+}
+
+bool LeAclConnection::LeSetPhy(uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, PhyOptions phy_options) {
+  if (all_phys > 0x03 || tx_phys > 0x07 || rx_phys > 0x07) {
+    LOG_ERROR("Invalid parameter");
+    return false;
+  }
+  pimpl_->tracker.le_acl_connection_interface_->EnqueueCommand(
+      LeSetPhyBuilder::Create(handle_, all_phys & 0x01, (all_phys >> 1) & 0x01, tx_phys, rx_phys, phy_options),
+      pimpl_->tracker.client_handler_->BindOnceOn(this, &LeAclConnection::OnLeSetPhyStatus));
+  return true;
+}
+
 LeConnectionManagementCallbacks* LeAclConnection::GetEventCallbacks(
     std::function<void(uint16_t)> invalidate_callbacks) {
   return pimpl_->GetEventCallbacks(std::move(invalidate_callbacks));
@@ -125,6 +125,12 @@ class LeAclConnection : public AclConnection {
   virtual void LeSubrateRequest(
       uint16_t subrate_min, uint16_t subrate_max, uint16_t max_latency, uint16_t cont_num, uint16_t sup_tout);
 
+  // Parameters are defined in Core spec HCI 7.8.33
+  virtual bool LeSetDataLength(uint16_t tx_octets, uint16_t tx_time);
+
+  // Parameters are defined in Core spec HCI 7.8.49. A failure is reported through OnPhyUpdate().
+  virtual bool LeSetPhy(uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, PhyOptions phy_options);
+
   // TODO implement LeRemoteConnectionParameterRequestReply, LeRemoteConnectionParameterRequestNegativeReply
 
   // Called once before passing the connection to the client
@@ -136,6 +142,8 @@ class LeAclConnection : public AclConnection {
 
  private:
   void OnLeSubrateRequestStatus(CommandStatusView status);
+  void OnLeSetDataLengthComplete(CommandCompleteView complete);
+  void OnLeSetPhyStatus(CommandStatusView status);
   virtual bool check_connection_parameters(
       uint16_t conn_interval_min,
       uint16_t conn_interval_max,
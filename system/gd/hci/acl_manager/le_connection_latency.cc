@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_latency.h"
+
+#include <array>
+#include <mutex>
+
+#include "common/latency_histogram.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+constexpr size_t kTypeCount = static_cast<size_t>(LeConnectionAttemptType::COUNT);
+
+struct AttemptStats {
+  common::LatencyHistogram successes;
+  uint64_t failures = 0;
+};
+
+std::mutex attempt_mutex;
+std::array<AttemptStats, kTypeCount> attempt_stats;
+}  // namespace
+
+std::string LeConnectionAttemptTypeText(LeConnectionAttemptType type) {
+  switch (type) {
+    case LeConnectionAttemptType::DIRECT:
+      return "DIRECT";
+    case LeConnectionAttemptType::BACKGROUND:
+      return "BACKGROUND";
+    case LeConnectionAttemptType::COUNT:
+      break;
+  }
+  return "UNKNOWN";
+}
+
+void RecordLeConnectionAttempt(LeConnectionAttemptType type, bool success, std::chrono::microseconds latency) {
+  if (type >= LeConnectionAttemptType::COUNT) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(attempt_mutex);
+  auto& stats = attempt_stats[static_cast<size_t>(type)];
+  if (success) {
+    stats.successes.Record(latency);
+  } else {
+    stats.failures++;
+  }
+}
+
+std::vector<LeConnectionAttemptSummary> GetLeConnectionAttemptSummaries() {
+  std::vector<LeConnectionAttemptSummary> summaries;
+  std::lock_guard<std::mutex> lock(attempt_mutex);
+  for (size_t type = 0; type < kTypeCount; type++) {
+    const auto& stats = attempt_stats[type];
+    if (stats.successes.Count() == 0 && stats.failures == 0) {
+      continue;
+    }
+    summaries.push_back({
+        static_cast<LeConnectionAttemptType>(type),
+        stats.successes.Count(),
+        stats.failures,
+        stats.successes.Percentile(50),
+        stats.successes.Percentile(90),
+        stats.successes.Max(),
+    });
+  }
+  return summaries;
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// How an LE connection attempt initiated by the host was started. An attempt lasts from the peer being added to the
+// filter accept list until the connection completes, fails or times out.
+enum class LeConnectionAttemptType : uint8_t {
+  DIRECT,      // Requested by a direct connect, using the fast scan parameters
+  BACKGROUND,  // Waiting in the background connection list
+  COUNT,
+};
+
+std::string LeConnectionAttemptTypeText(LeConnectionAttemptType type);
+
+// Record the end of an attempt that lasted |latency|. Safe to call from any thread.
+void RecordLeConnectionAttempt(LeConnectionAttemptType type, bool success, std::chrono::microseconds latency);
+
+struct LeConnectionAttemptSummary {
+  LeConnectionAttemptType type;
+  uint64_t successes;
+  uint64_t failures;
+  // Latencies of the successful attempts
+  std::chrono::microseconds p50;
+  std::chrono::microseconds p90;
+  std::chrono::microseconds max;
+};
+
+// The attempt types that ended at least once, ordered by type
+std::vector<LeConnectionAttemptSummary> GetLeConnectionAttemptSummaries();
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_latency.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using std::chrono::milliseconds;
+
+LeConnectionAttemptSummary SummaryOf(LeConnectionAttemptType type) {
+  for (const auto& summary : GetLeConnectionAttemptSummaries()) {
+    if (summary.type == type) {
+      return summary;
+    }
+  }
+  return {type, 0, 0, {}, {}, {}};
+}
+
+TEST(LeConnectionLatencyTest, records_successes_and_failures) {
+  auto before = SummaryOf(LeConnectionAttemptType::DIRECT);
+
+  RecordLeConnectionAttempt(LeConnectionAttemptType::DIRECT, true, milliseconds(150));
+  RecordLeConnectionAttempt(LeConnectionAttemptType::DIRECT, true, milliseconds(300));
+  RecordLeConnectionAttempt(LeConnectionAttemptType::DIRECT, false, milliseconds(30000));
+
+  auto after = SummaryOf(LeConnectionAttemptType::DIRECT);
+  EXPECT_EQ(after.successes, before.successes + 2);
+  EXPECT_EQ(after.failures, before.failures + 1);
+  EXPECT_GE(after.max, milliseconds(300));
+  EXPECT_LT(after.max, milliseconds(30000));
+}
+
+TEST(LeConnectionLatencyTest, ignores_invalid_type) {
+  auto summaries = GetLeConnectionAttemptSummaries().size();
+  RecordLeConnectionAttempt(LeConnectionAttemptType::COUNT, true, milliseconds(1));
+  EXPECT_EQ(GetLeConnectionAttemptSummaries().size(), summaries);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -19,18 +19,24 @@
 #include <base/strings/stringprintf.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "crypto_toolbox/crypto_toolbox.h"
+#include "hci/acl_manager/acl_handle_table.h"
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
+#include "hci/acl_manager/le_connection_latency.h"
 #include "hci/acl_manager/le_connection_management_callbacks.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/controller.h"
@@ -70,6 +76,7 @@ constexpr uint8_t PHY_LE_2M = 0x02;
 constexpr uint8_t PHY_LE_CODED = 0x04;
 constexpr bool kEnableBlePrivacy = true;
 constexpr bool kEnableBleOnlyInit1mPhy = false;
+constexpr bool kEnableAclConnectionEventBursts = false;
 
 static const std::string kPropertyMinConnInterval = "bluetooth.core.le.min_connection_interval";
 static const std::string kPropertyMaxConnInterval = "bluetooth.core.le.max_connection_interval";
@@ -84,6 +91,7 @@ static const std::string kPropertyConnScanIntervalSlow = "bluetooth.core.le.conn
 static const std::string kPropertyConnScanWindowSlow = "bluetooth.core.le.connection_scan_window_slow";
 static const std::string kPropertyEnableBlePrivacy = "bluetooth.core.gap.le.privacy.enabled";
 static const std::string kPropertyEnableBleOnlyInit1mPhy = "bluetooth.core.gap.le.conn.only_init_1m_phy.enabled";
+static const std::string kPropertyAclConnectionEventBursts = "bluetooth.core.le.acl_connection_event_bursts.enabled";
 
 enum class ConnectabilityState {
   DISARMED = 0,
@@ -193,16 +201,19 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   struct {
    private:
     std::map<uint16_t, le_acl_connection> le_acl_connections_;
+    // The entries of le_acl_connections_ by handle, for the lookups of every received packet
+    AclHandleTable<le_acl_connection> le_acl_connection_table_;
     mutable std::mutex le_acl_connections_guard_;
     LeConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
-      auto connection = le_acl_connections_.find(handle);
-      if (connection == le_acl_connections_.end()) return nullptr;
-      return connection->second.le_connection_management_callbacks_;
+      auto connection = le_acl_connection_table_.Find(handle);
+      if (connection == nullptr) return nullptr;
+      return connection->le_connection_management_callbacks_;
     }
     void remove(uint16_t handle) {
       auto connection = le_acl_connections_.find(handle);
       if (connection != le_acl_connections_.end()) {
         connection->second.le_connection_management_callbacks_ = nullptr;
+        le_acl_connection_table_.Remove(handle);
         le_acl_connections_.erase(handle);
       }
     }
@@ -217,6 +228,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       std::map<uint16_t, le_acl_connection> le_acl_connections{};
       {
         std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
+        le_acl_connection_table_.Clear();
         le_acl_connections = std::move(le_acl_connections_);
       }
       le_acl_connections.clear();
@@ -239,9 +251,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != le_acl_connections_.end();
+      auto connection = le_acl_connection_table_.Find(handle);
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -257,6 +269,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
           std::forward_as_tuple(remote_address, std::move(pending_connection), queue_end, handler));
       ASSERT(emplace_pair.second);  // Make sure the connection is unique
       emplace_pair.first->second.le_connection_management_callbacks_ = le_connection_management_callbacks;
+      le_acl_connection_table_.Set(handle, &emplace_pair.first->second);
     }
 
     std::unique_ptr<LeAclConnection> record_peripheral_data_and_extract_pending_connection(
@@ -383,6 +396,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         return;
       }
 
+      record_connection_attempt(remote_address, status == ErrorCode::SUCCESS);
       arm_on_resume_ = false;
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
@@ -440,6 +454,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     auto queue = std::make_shared<AclConnection::Queue>(10);
     auto queue_down_end = queue->GetDownEnd();
     round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, handle, queue);
+    set_connection_events(handle, conn_interval, conn_latency);
     std::unique_ptr<LeAclConnection> connection(new LeAclConnection(
         std::move(queue),
         le_acl_connection_interface_,
@@ -531,6 +546,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         return;
       }
 
+      record_connection_attempt(remote_address, status == ErrorCode::SUCCESS);
       arm_on_resume_ = false;
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
@@ -588,6 +604,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     auto queue = std::make_shared<AclConnection::Queue>(10);
     auto queue_down_end = queue->GetDownEnd();
     round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, handle, queue);
+    set_connection_events(handle, conn_interval, conn_latency);
     std::unique_ptr<LeAclConnection> connection(new LeAclConnection(
         std::move(queue),
         le_acl_connection_interface_,
@@ -682,6 +699,9 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     auto handle = complete_view.GetConnectionHandle();
+    if (complete_view.GetStatus() == ErrorCode::SUCCESS) {
+      set_connection_events(handle, complete_view.GetConnInterval(), complete_view.GetConnLatency());
+    }
     connections.execute(handle, [=](LeConnectionManagementCallbacks* callbacks) {
       callbacks->OnConnectionUpdate(
           complete_view.GetStatus(),
@@ -691,6 +711,18 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     });
   }
 
+  // Low power devices can opt in to sending ACL data in bursts ahead of each connection event
+  void set_connection_events(uint16_t handle, uint16_t conn_interval, uint16_t conn_latency) {
+    static const bool enabled =
+        os::GetSystemPropertyBool(kPropertyAclConnectionEventBursts, kEnableAclConnectionEventBursts);
+    if (!enabled) {
+      return;
+    }
+    // The connection interval is in units of 1.25 ms
+    round_robin_scheduler_->SetLeConnectionEvents(
+        handle, std::chrono::microseconds(conn_interval * 1250), conn_latency);
+  }
+
   void on_le_phy_update_complete(LeMetaEventView view) {
     auto complete_view = LePhyUpdateCompleteView::Create(view);
     if (!complete_view.IsValid()) {
@@ -806,8 +838,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
     connect_list.insert(address_with_type);
     register_with_address_manager();
-    le_address_manager_->AddDeviceToFilterAcceptList(
-        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    queue_filter_accept_list_update(address_with_type, true);
   }
 
   bool is_device_in_connect_list(AddressWithType address_with_type) {
@@ -823,17 +854,62 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     connect_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
     direct_connections_.erase(address_with_type);
+    connection_attempt_start_.erase(address_with_type);
     register_with_address_manager();
-    le_address_manager_->RemoveDeviceFromFilterAcceptList(
-        address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    queue_filter_accept_list_update(address_with_type, false);
   }
 
   void clear_filter_accept_list() {
     connect_list.clear();
+    connection_attempt_start_.clear();
+    pending_filter_accept_list_updates_.clear();
     register_with_address_manager();
     le_address_manager_->ClearFilterAcceptList();
   }
 
+  // Every filter accept list update pauses scanning, advertising and connecting until the controller took it. The
+  // updates are held until the next turn of the handler so that a burst of connection requests, such as the
+  // reconnection of the bonded peripherals, is sent within a single pause.
+  void queue_filter_accept_list_update(AddressWithType address_with_type, bool add) {
+    pending_filter_accept_list_updates_.emplace_back(address_with_type, add);
+    if (pending_filter_accept_list_updates_.size() == 1) {
+      handler_->Post(common::BindOnce(&le_impl::flush_filter_accept_list_updates, common::Unretained(this)));
+    }
+  }
+
+  void flush_filter_accept_list_updates() {
+    auto updates = std::move(pending_filter_accept_list_updates_);
+    pending_filter_accept_list_updates_.clear();
+    for (const auto& [address_with_type, add] : updates) {
+      if (add) {
+        le_address_manager_->AddDeviceToFilterAcceptList(
+            address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+      } else {
+        le_address_manager_->RemoveDeviceFromFilterAcceptList(
+            address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+      }
+    }
+  }
+
+  void record_connection_attempt(AddressWithType address_with_type, bool success) {
+    auto attempt = connection_attempt_start_.find(address_with_type);
+    if (attempt == connection_attempt_start_.end()) {
+      return;
+    }
+    auto type = direct_connections_.count(address_with_type) ? LeConnectionAttemptType::DIRECT
+                                                              : LeConnectionAttemptType::BACKGROUND;
+    auto latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - attempt->second);
+    LOG_INFO(
+        "%s connection attempt to %s %s after %lld ms",
+        LeConnectionAttemptTypeText(type).c_str(),
+        ADDRESS_TO_LOGGABLE_CSTR(address_with_type),
+        success ? "succeeded" : "failed",
+        static_cast<long long>(latency.count() / 1000));
+    RecordLeConnectionAttempt(type, success, latency);
+    connection_attempt_start_.erase(attempt);
+  }
+
   void add_device_to_resolving_list(
       AddressWithType address_with_type,
       const std::array<uint8_t, 16>& peer_irk,
@@ -1058,7 +1134,11 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     // TODO: Configure default LE connection parameters?
     if (add_to_connect_list) {
       add_device_to_connect_list(address_with_type);
-      if (is_direct) {
+      if (!is_direct) {
+        connection_attempt_start_.emplace(address_with_type, std::chrono::steady_clock::now());
+      } else {
+        // A direct connect starts a new attempt, even if the peer already waited in the background
+        connection_attempt_start_[address_with_type] = std::chrono::steady_clock::now();
         direct_connections_.insert(address_with_type);
         if (create_connection_timeout_alarms_.find(address_with_type) == create_connection_timeout_alarms_.end()) {
           create_connection_timeout_alarms_.emplace(
@@ -1129,8 +1209,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
           android::bluetooth::le::LeConnectionState::STATE_LE_ACL_TIMEOUT,
           argument_list);
 
+      record_connection_attempt(address_with_type, false);
       if (background_connections_.find(address_with_type) != background_connections_.end()) {
         direct_connections_.erase(address_with_type);
+        connection_attempt_start_.emplace(address_with_type, std::chrono::steady_clock::now());
         disarm_connectability();
       } else {
         cancel_connect(address_with_type);
@@ -1344,6 +1426,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   std::unordered_set<AddressWithType> connecting_le_{};
   bool arm_on_resume_{};
   std::unordered_set<AddressWithType> direct_connections_{};
+  std::unordered_map<AddressWithType, std::chrono::steady_clock::time_point> connection_attempt_start_{};
+  std::vector<std::pair<AddressWithType, bool /* add */>> pending_filter_accept_list_updates_{};
   // Set of devices that will not be removed from connect list after direct connect timeout
   std::unordered_set<AddressWithType> background_connections_;
   std::unordered_set<AddressWithType> connect_list;
@@ -374,8 +374,8 @@ class TestHciLayer : public HciLayer {
       common::ContextualCallback<
           void(hci::ErrorCode hci_status, uint16_t, uint8_t version, uint16_t manufacturer_name, uint16_t sub_version)>
           on_read_remote_version) override {
-    disconnect_handlers_.push_back(on_disconnect);
-    read_remote_version_handlers_.push_back(on_read_remote_version);
+    disconnect_handlers_.Add(on_disconnect);
+    read_remote_version_handlers_.Add(on_read_remote_version);
     le_event_handler_ = event_handler;
     return &le_acl_connection_manager_interface_;
   }
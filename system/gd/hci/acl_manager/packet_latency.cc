@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/packet_latency.h"
+
+#include <array>
+#include <map>
+#include <mutex>
+
+#include "common/latency_histogram.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+constexpr size_t kStageCount = static_cast<size_t>(PacketLatencyStage::COUNT);
+
+std::mutex latency_mutex;
+std::map<uint16_t, std::array<common::LatencyHistogram, kStageCount>> latency_per_link;
+}  // namespace
+
+std::string PacketLatencyStageText(PacketLatencyStage stage) {
+  switch (stage) {
+    case PacketLatencyStage::RX_ACL_MANAGER:
+      return "RX_ACL_MANAGER";
+    case PacketLatencyStage::RX_REASSEMBLED:
+      return "RX_REASSEMBLED";
+    case PacketLatencyStage::RX_SHIM:
+      return "RX_SHIM";
+    case PacketLatencyStage::RX_MAIN_THREAD:
+      return "RX_MAIN_THREAD";
+    case PacketLatencyStage::RX_DELIVERED:
+      return "RX_DELIVERED";
+    case PacketLatencyStage::TX_LINK_QUEUE:
+      return "TX_LINK_QUEUE";
+    case PacketLatencyStage::TX_SCHEDULED:
+      return "TX_SCHEDULED";
+    case PacketLatencyStage::TX_HCI:
+      return "TX_HCI";
+    case PacketLatencyStage::COUNT:
+      break;
+  }
+  return "UNKNOWN";
+}
+
+void AddPacketLatencyLink(uint16_t handle) {
+  std::lock_guard<std::mutex> lock(latency_mutex);
+  latency_per_link[handle] = {};
+}
+
+void RemovePacketLatencyLink(uint16_t handle) {
+  std::lock_guard<std::mutex> lock(latency_mutex);
+  latency_per_link.erase(handle);
+}
+
+void RecordPacketLatency(uint16_t handle, PacketLatencyStage stage, std::chrono::steady_clock::time_point since) {
+  if (since == std::chrono::steady_clock::time_point()) {
+    return;
+  }
+  auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since);
+  std::lock_guard<std::mutex> lock(latency_mutex);
+  auto link = latency_per_link.find(handle);
+  if (link == latency_per_link.end()) {
+    return;
+  }
+  link->second[static_cast<size_t>(stage)].Record(latency);
+}
+
+std::vector<PacketLatencySummary> GetPacketLatencySummaries() {
+  std::vector<PacketLatencySummary> summaries;
+  std::lock_guard<std::mutex> lock(latency_mutex);
+  for (const auto& [handle, histograms] : latency_per_link) {
+    for (size_t stage = 0; stage < kStageCount; stage++) {
+      const auto& histogram = histograms[stage];
+      if (histogram.Count() == 0) {
+        continue;
+      }
+      summaries.push_back({
+          handle,
+          static_cast<PacketLatencyStage>(stage),
+          histogram.Count(),
+          histogram.Percentile(50),
+          histogram.Percentile(90),
+          histogram.Percentile(99),
+          histogram.Max(),
+      });
+    }
+  }
+  return summaries;
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// The points an ACL PDU passes on its way between the HAL and the profiles. Each stage measures the time from the
+// start of the path to that point, so the difference between two stages is the time spent in between.
+enum class PacketLatencyStage : uint8_t {
+  // Received PDUs, from the HAL handing over their first fragment
+  RX_ACL_MANAGER,  // Routed to its link by the ACL manager
+  RX_REASSEMBLED,  // Last fragment recombined
+  RX_SHIM,         // Taken off the link queue by the legacy shim
+  RX_MAIN_THREAD,  // Picked up by the main thread
+  RX_DELIVERED,    // Returned from L2CAP and the profile callback
+  // Sent PDUs, from the legacy stack handing them to the shim
+  TX_LINK_QUEUE,  // Taken by the link's ACL queue
+  TX_SCHEDULED,   // Fragmented by the scheduler for the controller buffers
+  TX_HCI,         // Last fragment handed to the HCI layer
+  COUNT,
+};
+
+std::string PacketLatencyStageText(PacketLatencyStage stage);
+
+// Start and stop collecting the latencies of a link. Latencies of other handles are dropped.
+void AddPacketLatencyLink(uint16_t handle);
+void RemovePacketLatencyLink(uint16_t handle);
+
+// Record that a PDU of |handle| that started its path at |since| reached |stage|. Does nothing when |since| is unset.
+// Safe to call from any thread.
+void RecordPacketLatency(uint16_t handle, PacketLatencyStage stage, std::chrono::steady_clock::time_point since);
+
+struct PacketLatencySummary {
+  uint16_t handle;
+  PacketLatencyStage stage;
+  uint64_t count;
+  std::chrono::microseconds p50;
+  std::chrono::microseconds p90;
+  std::chrono::microseconds p99;
+  std::chrono::microseconds max;
+};
+
+// The stages each link recorded PDUs for, ordered by handle then stage
+std::vector<PacketLatencySummary> GetPacketLatencySummaries();
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
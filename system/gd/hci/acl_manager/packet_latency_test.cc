@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/packet_latency.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+class PacketLatencyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    AddPacketLatencyLink(kHandle);
+  }
+
+  void TearDown() override {
+    RemovePacketLatencyLink(kHandle);
+  }
+
+  static constexpr uint16_t kHandle = 0x0123;
+};
+
+TEST_F(PacketLatencyTest, records_per_stage) {
+  auto now = steady_clock::now();
+  RecordPacketLatency(kHandle, PacketLatencyStage::RX_SHIM, now - milliseconds(10));
+  RecordPacketLatency(kHandle, PacketLatencyStage::RX_SHIM, now - milliseconds(20));
+  RecordPacketLatency(kHandle, PacketLatencyStage::TX_HCI, now - milliseconds(5));
+
+  auto summaries = GetPacketLatencySummaries();
+  ASSERT_EQ(summaries.size(), 2u);
+  EXPECT_EQ(summaries[0].handle, kHandle);
+  EXPECT_EQ(summaries[0].stage, PacketLatencyStage::RX_SHIM);
+  EXPECT_EQ(summaries[0].count, 2u);
+  EXPECT_GE(summaries[0].p50, milliseconds(10));
+  EXPECT_GE(summaries[0].max, milliseconds(20));
+  EXPECT_EQ(summaries[1].stage, PacketLatencyStage::TX_HCI);
+  EXPECT_EQ(summaries[1].count, 1u);
+}
+
+TEST_F(PacketLatencyTest, ignores_unknown_links_and_unset_timestamps) {
+  RecordPacketLatency(kHandle + 1, PacketLatencyStage::RX_SHIM, steady_clock::now());
+  RecordPacketLatency(kHandle, PacketLatencyStage::RX_SHIM, steady_clock::time_point());
+  EXPECT_TRUE(GetPacketLatencySummaries().empty());
+}
+
+TEST_F(PacketLatencyTest, removed_link_is_dropped) {
+  RecordPacketLatency(kHandle, PacketLatencyStage::RX_SHIM, steady_clock::now());
+  RemovePacketLatencyLink(kHandle);
+  EXPECT_TRUE(GetPacketLatencySummaries().empty());
+  RecordPacketLatency(kHandle, PacketLatencyStage::RX_SHIM, steady_clock::now());
+  EXPECT_TRUE(GetPacketLatencySummaries().empty());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
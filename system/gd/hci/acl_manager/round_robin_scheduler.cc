@@ -15,15 +15,36 @@
  */
 
 #include "hci/acl_manager/round_robin_scheduler.h"
+
+#include <algorithm>
+
+#include "common/tracing.h"
 #include "hci/acl_manager/acl_fragmenter.h"
+#include "hci/acl_manager/packet_latency.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+namespace {
+size_t get_fragment_count(size_t size, size_t mtu) {
+  if (mtu == 0) {
+    return 1;
+  }
+  return std::max<size_t>(1, (size + mtu - 1) / mtu);
+}
+
+std::chrono::milliseconds to_milliseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+}
+
+// A held link sends during the last quarter of the time between its connection events
+constexpr int kBurstWindowDivisor = 4;
+}  // namespace
+
 RoundRobinScheduler::RoundRobinScheduler(
     os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end)
-    : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end) {
+    : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end), release_alarm_(handler) {
   max_acl_packet_credits_ = controller_->GetNumAclPacketBuffers();
   acl_packet_credits_ = max_acl_packet_credits_;
   hci_mtu_ = controller_->GetAclPacketLength();
@@ -31,41 +52,47 @@ RoundRobinScheduler::RoundRobinScheduler(
   le_max_acl_packet_credits_ = le_buffer_size.total_num_le_packets_;
   le_acl_packet_credits_ = le_max_acl_packet_credits_;
   le_hci_mtu_ = le_buffer_size.le_data_packet_length_;
-  controller_->RegisterCompletedAclPacketsCallback(handler->BindOn(this, &RoundRobinScheduler::incoming_acl_credits));
+  // Credits unblock the queued ACL packets, they must not wait behind control work on the ACL manager handler
+  controller_->RegisterCompletedAclPacketsCallback(
+      handler->BindOn(os::Handler::Priority::REAL_TIME, this, &RoundRobinScheduler::incoming_acl_credits));
 }
 
 RoundRobinScheduler::~RoundRobinScheduler() {
   unregister_all_connections();
+  if (enqueue_registered_.exchange(false)) {
+    hci_queue_end_->UnregisterEnqueue();
+  }
   controller_->UnregisterCompletedAclPacketsCallback();
 }
 
 void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t handle,
                                    std::shared_ptr<acl_manager::AclConnection::Queue> queue) {
   ASSERT(acl_queue_handlers_.count(handle) == 0);
-  acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
-  acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
-  if (fragments_to_send_.size() == 0) {
-    start_round_robin();
+  LinkIterator acl_queue_handler;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    acl_queue_handler = acl_queue_handlers_.try_emplace(handle).first;
+    acl_queue_handler->second.connection_type_ = connection_type;
+    acl_queue_handler->second.queue_ = std::move(queue);
   }
+  acl_queue_handler_table_.Set(handle, &acl_queue_handler->second);
+  register_link(acl_queue_handler);
 }
 
 void RoundRobinScheduler::Unregister(uint16_t handle) {
   ASSERT(acl_queue_handlers_.count(handle) == 1);
-  auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
+  auto& acl_queue_handler = acl_queue_handlers_.find(handle)->second;
   // Reclaim outstanding packets
-  if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
-    acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
-  } else {
-    le_acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
-  }
+  get_credits(acl_queue_handler.connection_type_) += acl_queue_handler.number_of_sent_packets_;
   acl_queue_handler.number_of_sent_packets_ = 0;
 
   if (acl_queue_handler.dequeue_is_registered_) {
     acl_queue_handler.dequeue_is_registered_ = false;
     acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
   }
+  acl_queue_handler_table_.Remove(handle);
+  std::lock_guard<std::mutex> lock(stats_mutex_);
   acl_queue_handlers_.erase(handle);
-  starting_point_ = acl_queue_handlers_.begin();
 }
 
 void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
@@ -74,9 +101,47 @@ void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
     LOG_WARN("handle %d is invalid", handle);
     return;
   }
+  std::lock_guard<std::mutex> lock(stats_mutex_);
   acl_queue_handler->second.high_priority_ = high_priority;
 }
 
+void RoundRobinScheduler::SetLinkQos(uint16_t handle, uint16_t weight, std::chrono::milliseconds latency_target) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  if (weight == 0) {
+    LOG_WARN("Ignoring zero weight for handle %d", handle);
+    weight = kDefaultWeight;
+  }
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  acl_queue_handler->second.weight_ = weight;
+  acl_queue_handler->second.latency_target_ = latency_target;
+}
+
+void RoundRobinScheduler::SetLeConnectionEvents(
+    uint16_t handle, std::chrono::microseconds interval, uint16_t latency) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  auto& link = acl_queue_handler->second;
+  if (link.connection_type_ != ConnectionType::LE) {
+    LOG_WARN("handle %d is not an LE link", handle);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    link.connection_event_period_ = interval * (latency + 1);
+    link.connection_event_anchor_ = std::chrono::steady_clock::now();
+    link.stats_.connection_event_period_ = link.connection_event_period_;
+  }
+  // A PDU held for the previous period may be releasable now
+  start_round_robin();
+}
+
 uint16_t RoundRobinScheduler::GetCredits() {
   return acl_packet_credits_;
 }
@@ -85,93 +150,262 @@ uint16_t RoundRobinScheduler::GetLeCredits() {
   return le_acl_packet_credits_;
 }
 
-void RoundRobinScheduler::start_round_robin() {
-  if (acl_packet_credits_ == 0 && le_acl_packet_credits_ == 0) {
-    return;
+std::vector<RoundRobinScheduler::LinkStats> RoundRobinScheduler::GetLinkStats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  std::vector<LinkStats> link_stats;
+  for (const auto& [handle, acl_queue_handler] : acl_queue_handlers_) {
+    LinkStats stats = acl_queue_handler.stats_;
+    stats.handle_ = handle;
+    stats.connection_type_ = acl_queue_handler.connection_type_;
+    stats.weight_ = acl_queue_handler.weight_;
+    stats.latency_target_ = acl_queue_handler.latency_target_;
+    stats.high_priority_ = acl_queue_handler.high_priority_;
+    link_stats.push_back(stats);
   }
-  if (!fragments_to_send_.empty()) {
-    auto connection_type = fragments_to_send_.front().first;
-    bool classic_buffer_full = acl_packet_credits_ == 0 && connection_type == ConnectionType::CLASSIC;
-    bool le_buffer_full = le_acl_packet_credits_ == 0 && connection_type == ConnectionType::LE;
-    if (classic_buffer_full || le_buffer_full) {
-      LOG_WARN("Buffer of connection_type %d is full", connection_type);
-      return;
-    }
-    send_next_fragment();
+  return link_stats;
+}
+
+size_t RoundRobinScheduler::get_mtu(ConnectionType connection_type) const {
+  return connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
+}
+
+uint16_t& RoundRobinScheduler::get_credits(ConnectionType connection_type) {
+  return connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ : le_acl_packet_credits_;
+}
+
+bool RoundRobinScheduler::can_send(ConnectionType connection_type) {
+  return !fragments_to_send_[connection_type].empty() && get_credits(connection_type) > 0;
+}
+
+void RoundRobinScheduler::register_link(LinkIterator acl_queue_handler) {
+  if (acl_queue_handler->second.dequeue_is_registered_ || acl_queue_handler->second.pending_packet_ != nullptr) {
     return;
   }
-  if (acl_queue_handlers_.empty()) {
-    LOG_INFO("No any acl connection");
+  acl_queue_handler->second.dequeue_is_registered_ = true;
+  uint16_t acl_handle = acl_queue_handler->first;
+  acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
+      handler_, common::Bind(&RoundRobinScheduler::on_link_ready, common::Unretained(this), acl_handle));
+}
+
+void RoundRobinScheduler::on_link_ready(uint16_t acl_handle) {
+  auto acl_queue_handler = acl_queue_handler_table_.Find(acl_handle);
+  if (acl_queue_handler == nullptr) {
+    LOG_ERROR("Ignore since ACL connection vanished with handle: 0x%X", acl_handle);
     return;
   }
 
-  if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
-    starting_point_ = acl_queue_handlers_.begin();
+  // Hold on to one PDU per link, the link is registered again once it has been fragmented
+  acl_queue_handler->dequeue_is_registered_ = false;
+  acl_queue_handler->queue_->GetDownEnd()->UnregisterDequeue();
+  acl_queue_handler->pending_packet_ = acl_queue_handler->queue_->GetDownEnd()->TryDequeue();
+  ASSERT(acl_queue_handler->pending_packet_ != nullptr);
+  acl_queue_handler->pending_since_ = std::chrono::steady_clock::now();
+  acl_queue_handler->pending_sequence_ = next_sequence_++;
+  start_round_robin();
+}
+
+void RoundRobinScheduler::start_round_robin() {
+  auto now = std::chrono::steady_clock::now();
+  for (auto connection_type : {ConnectionType::CLASSIC, ConnectionType::LE}) {
+    update_credit_starvation(connection_type, now);
+    fill_pool(connection_type, now);
+  }
+  if (can_send(ConnectionType::CLASSIC) || can_send(ConnectionType::LE)) {
+    send_next_fragment();
   }
-  size_t count = acl_queue_handlers_.size();
+}
 
-  for (auto acl_queue_handler = starting_point_; count > 0; count--) {
-    // Prevent registration when credits is zero
-    bool classic_buffer_full =
-        acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC;
-    bool le_buffer_full =
-        le_acl_packet_credits_ == 0 && acl_queue_handler->second.connection_type_ == ConnectionType::LE;
-    if (!acl_queue_handler->second.dequeue_is_registered_ && !classic_buffer_full && !le_buffer_full) {
-      acl_queue_handler->second.dequeue_is_registered_ = true;
-      uint16_t acl_handle = acl_queue_handler->first;
-      acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
-          handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_handle));
-    }
-    acl_queue_handler = std::next(acl_queue_handler);
+void RoundRobinScheduler::fill_pool(ConnectionType connection_type, std::chrono::steady_clock::time_point now) {
+  if (!fragments_to_send_[connection_type].empty() || get_credits(connection_type) == 0) {
+    return;
+  }
+  auto acl_queue_handler = select_next_link(connection_type, now);
+  if (acl_queue_handler != acl_queue_handlers_.end()) {
+    buffer_packet(acl_queue_handler, now);
+  }
+}
+
+// Deficit round robin over the links of |connection_type| that have a PDU waiting
+RoundRobinScheduler::LinkIterator RoundRobinScheduler::select_next_link(
+    ConnectionType connection_type, std::chrono::steady_clock::time_point now) {
+  size_t mtu = get_mtu(connection_type);
+  std::vector<LinkIterator> waiting;
+  bool high_priority_waiting = false;
+  // Visit the links in turn order, starting after the one whose turn it was and ending with it
+  auto acl_queue_handler = acl_queue_handlers_.upper_bound(current_link_[connection_type]);
+  for (size_t count = acl_queue_handlers_.size(); count > 0; count--) {
     if (acl_queue_handler == acl_queue_handlers_.end()) {
       acl_queue_handler = acl_queue_handlers_.begin();
     }
+    auto& link = acl_queue_handler->second;
+    std::chrono::steady_clock::time_point release;
+    if (link.connection_type_ == connection_type) {
+      if (link.pending_packet_ == nullptr) {
+        // An idle link does not keep the credit it did not use
+        link.deficit_ = 0;
+      } else if (is_held(link, now, &release)) {
+        schedule_release(release, now);
+      } else {
+        waiting.push_back(acl_queue_handler);
+        high_priority_waiting |= link.high_priority_;
+      }
+    }
+    acl_queue_handler++;
+  }
+  if (high_priority_waiting) {
+    waiting.erase(
+        std::remove_if(waiting.begin(), waiting.end(), [](LinkIterator link) { return !link->second.high_priority_; }),
+        waiting.end());
+  }
+  if (waiting.empty()) {
+    return acl_queue_handlers_.end();
   }
 
-  starting_point_ = std::next(starting_point_);
-}
+  auto cost = [mtu](LinkIterator link) { return get_fragment_count(link->second.pending_packet_->size(), mtu); };
 
-void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
-  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
-  auto acl_queue_handler = acl_queue_handlers_.find(acl_handle);
-  if( acl_queue_handler == acl_queue_handlers_.end()) {
-    LOG_ERROR("Ignore since ACL connection vanished with handle: 0x%X", acl_handle);
-    return;
+  // A link whose PDU is past its latency target goes first, the earliest deadline among them
+  auto overdue = acl_queue_handlers_.end();
+  std::chrono::steady_clock::time_point overdue_deadline;
+  for (auto link : waiting) {
+    if (link->second.latency_target_.count() == 0) {
+      continue;
+    }
+    auto deadline = link->second.pending_since_ + link->second.latency_target_;
+    if (deadline <= now && (overdue == acl_queue_handlers_.end() || deadline < overdue_deadline)) {
+      overdue = link;
+      overdue_deadline = deadline;
+    }
+  }
+  if (overdue != acl_queue_handlers_.end()) {
+    overdue->second.deficit_ -= std::min<uint32_t>(overdue->second.deficit_, cost(overdue));
+    return overdue;
+  }
+
+  // The link whose turn it is keeps going while its credit covers its next PDU
+  auto current = waiting.back();
+  if (current->first == current_link_[connection_type] && cost(current) <= current->second.deficit_) {
+    current->second.deficit_ -= cost(current);
+    return current;
   }
 
-  // Wrap packet and enqueue it
+  // Skip the rounds in which no link would have earned enough to send, then hand out one more
+  size_t rounds = SIZE_MAX;
+  for (auto link : waiting) {
+    size_t missing = cost(link) - std::min<size_t>(cost(link), link->second.deficit_);
+    rounds = std::min(rounds, (missing + link->second.weight_ - 1) / link->second.weight_);
+  }
+  rounds = std::max<size_t>(rounds, 1);
+  for (auto link : waiting) {
+    link->second.deficit_ += (rounds - 1) * link->second.weight_;
+  }
+  for (auto link : waiting) {
+    link->second.deficit_ += link->second.weight_;
+    if (cost(link) <= link->second.deficit_) {
+      link->second.deficit_ -= cost(link);
+      current_link_[connection_type] = link->first;
+      return link;
+    }
+  }
+  ASSERT_LOG(false, "No link earned enough credit after %zu rounds", rounds);
+  return acl_queue_handlers_.end();
+}
+
+void RoundRobinScheduler::buffer_packet(LinkIterator acl_queue_handler, std::chrono::steady_clock::time_point now) {
+  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
   uint16_t handle = acl_queue_handler->first;
-  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  BT_TRACE_SCOPE("acl", "fragment", handle, 0);
+  auto& link = acl_queue_handler->second;
+  auto packet = std::move(link.pending_packet_);
   ASSERT(packet != nullptr);
+  RecordPacketLatency(handle, PacketLatencyStage::TX_SCHEDULED, packet->GetTimestamp());
+  pdu_handle_[link.connection_type_] = handle;
+  pdu_timestamp_[link.connection_type_] = packet->GetTimestamp();
 
-  ConnectionType connection_type = acl_queue_handler->second.connection_type_;
-  size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
+  ConnectionType connection_type = link.connection_type_;
+  size_t mtu = get_mtu(connection_type);
   PacketBoundaryFlag packet_boundary_flag = (packet->IsFlushable())
                                                 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
-  int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
+  auto& fragments_to_send = fragments_to_send_[connection_type];
+  ASSERT(fragments_to_send.empty());
   if (packet->size() <= mtu) {
-    fragments_to_send_.push(
-        std::make_pair(
-            connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))),
-        acl_priority);
+    fragments_to_send.push(AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet)));
   } else {
     auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragments();
     for (size_t i = 0; i < fragments.size(); i++) {
-      fragments_to_send_.push(
-          std::make_pair(
-              connection_type,
-              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))),
-          acl_priority);
+      fragments_to_send.push(
+          AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i])));
       packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
     }
   }
-  ASSERT(fragments_to_send_.size() > 0);
-  unregister_all_connections();
+  fragments_sequence_[connection_type] = link.pending_sequence_;
+  link.number_of_sent_packets_ += fragments_to_send.size();
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
-  send_next_fragment();
+  auto queueing_delay = to_milliseconds(now - link.pending_since_);
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    link.stats_.sent_packets_++;
+    link.stats_.sent_fragments_ += fragments_to_send.size();
+    link.stats_.max_queueing_delay_ = std::max(link.stats_.max_queueing_delay_, queueing_delay);
+    if (link.latency_target_.count() != 0 && queueing_delay > link.latency_target_) {
+      link.stats_.latency_target_misses_++;
+    }
+  }
+  register_link(acl_queue_handler);
+}
+
+bool RoundRobinScheduler::is_held(
+    const acl_queue_handler& link,
+    std::chrono::steady_clock::time_point now,
+    std::chrono::steady_clock::time_point* release) {
+  auto period = link.connection_event_period_;
+  if (period.count() == 0) {
+    return false;
+  }
+  auto phase = std::chrono::duration_cast<std::chrono::microseconds>(now - link.connection_event_anchor_) % period;
+  auto burst_start = period - period / kBurstWindowDivisor;
+  if (phase >= burst_start) {
+    return false;
+  }
+  *release = now + (burst_start - phase);
+  return true;
+}
+
+void RoundRobinScheduler::schedule_release(
+    std::chrono::steady_clock::time_point release, std::chrono::steady_clock::time_point now) {
+  if (release_scheduled_ && scheduled_release_ <= release) {
+    return;
+  }
+  release_scheduled_ = true;
+  scheduled_release_ = release;
+  // Round up, waking up before the burst starts would only hold the link again
+  auto delay = std::chrono::ceil<std::chrono::milliseconds>(release - now);
+  release_alarm_.Schedule(common::BindOnce(&RoundRobinScheduler::on_release, common::Unretained(this)), delay);
+}
+
+void RoundRobinScheduler::on_release() {
+  release_scheduled_ = false;
+  start_round_robin();
+}
+
+void RoundRobinScheduler::update_credit_starvation(
+    ConnectionType connection_type, std::chrono::steady_clock::time_point now) {
+  bool pool_is_empty = get_credits(connection_type) == 0;
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  for (auto& [handle, link] : acl_queue_handlers_) {
+    if (link.connection_type_ != connection_type) {
+      continue;
+    }
+    if (pool_is_empty && link.pending_packet_ != nullptr && !link.credit_starved_) {
+      link.credit_starved_ = true;
+      link.credit_starved_since_ = now;
+      link.stats_.credit_starved_count_++;
+    } else if (!pool_is_empty && link.credit_starved_) {
+      link.credit_starved_ = false;
+      link.stats_.credit_starved_time_ += to_milliseconds(now - link.credit_starved_since_);
+    }
+  }
 }
 
 void RoundRobinScheduler::unregister_all_connections() {
@@ -193,48 +427,47 @@ void RoundRobinScheduler::send_next_fragment() {
 
 // Invoked from some external Queue Reactable context 1
 std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment() {
-  ConnectionType connection_type = fragments_to_send_.front().first;
-  if (connection_type == ConnectionType::CLASSIC) {
-    ASSERT(acl_packet_credits_ > 0);
-    acl_packet_credits_ -= 1;
-  } else {
-    ASSERT(le_acl_packet_credits_ > 0);
-    le_acl_packet_credits_ -= 1;
+  // Send the PDUs in the order they were fragmented, only overtaking one whose pool ran out of buffers
+  ConnectionType connection_type = ConnectionType::CLASSIC;
+  if (!can_send(ConnectionType::CLASSIC) ||
+      (can_send(ConnectionType::LE) &&
+       fragments_sequence_[ConnectionType::LE] < fragments_sequence_[ConnectionType::CLASSIC])) {
+    connection_type = ConnectionType::LE;
   }
+  ASSERT(can_send(connection_type));
+  get_credits(connection_type) -= 1;
 
-  auto raw_pointer = fragments_to_send_.front().second.release();
-  fragments_to_send_.pop();
-  if (fragments_to_send_.empty()) {
-    if (enqueue_registered_.exchange(false)) {
-      hci_queue_end_->UnregisterEnqueue();
-    }
-    handler_->Post(common::BindOnce(&RoundRobinScheduler::start_round_robin, common::Unretained(this)));
-  } else {
-    ConnectionType next_connection_type = fragments_to_send_.front().first;
-    bool classic_buffer_full = next_connection_type == ConnectionType::CLASSIC && acl_packet_credits_ == 0;
-    bool le_buffer_full = next_connection_type == ConnectionType::LE && le_acl_packet_credits_ == 0;
-    if ((classic_buffer_full || le_buffer_full) && enqueue_registered_.exchange(false)) {
-      hci_queue_end_->UnregisterEnqueue();
-    }
+  auto& fragments_to_send = fragments_to_send_[connection_type];
+  auto fragment = std::move(fragments_to_send.front());
+  fragments_to_send.pop();
+  BT_TRACE_INSTANT("acl", "send_fragment", 0, 0);
+  if (fragments_to_send.empty()) {
+    RecordPacketLatency(pdu_handle_[connection_type], PacketLatencyStage::TX_HCI, pdu_timestamp_[connection_type]);
+    // Refill the pool right away so that a PDU that arrived earlier is not overtaken by the other pool's next one
+    fill_pool(connection_type, std::chrono::steady_clock::now());
+  }
+  if (!can_send(ConnectionType::CLASSIC) && !can_send(ConnectionType::LE) && enqueue_registered_.exchange(false)) {
+    hci_queue_end_->UnregisterEnqueue();
   }
-  return std::unique_ptr<AclBuilder>(raw_pointer);
+  return fragment;
 }
 
 void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits) {
-  auto acl_queue_handler = acl_queue_handlers_.find(handle);
-  if (acl_queue_handler == acl_queue_handlers_.end()) {
+  auto acl_queue_handler = acl_queue_handler_table_.Find(handle);
+  if (acl_queue_handler == nullptr) {
     return;
   }
 
-  if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
-    acl_queue_handler->second.number_of_sent_packets_ -= credits;
+  BT_TRACE_INSTANT("acl", "credits", handle, 0);
+  if (acl_queue_handler->number_of_sent_packets_ >= credits) {
+    acl_queue_handler->number_of_sent_packets_ -= credits;
   } else {
     LOG_WARN("receive more credits than we sent");
-    acl_queue_handler->second.number_of_sent_packets_ = 0;
+    acl_queue_handler->number_of_sent_packets_ = 0;
   }
 
   bool credit_was_zero = false;
-  if (acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC) {
+  if (acl_queue_handler->connection_type_ == ConnectionType::CLASSIC) {
     if (acl_packet_credits_ == 0) {
       credit_was_zero = true;
     }
@@ -253,11 +486,19 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("le acl packet credits overflow due to receive %hx credits", credits);
     }
   }
-  if (credit_was_zero) {
-    start_round_robin();
+  // The controller hands out the entries of a Number Of Completed Packets event as consecutive tasks on our handler.
+  // Apply all of them before scheduling, so that a single pass fills every buffer the event freed.
+  if (credit_was_zero && !credits_pass_scheduled_) {
+    credits_pass_scheduled_ = true;
+    handler_->Post(common::BindOnce(&RoundRobinScheduler::on_credits_applied, common::Unretained(this)));
   }
 }
 
+void RoundRobinScheduler::on_credits_applied() {
+  credits_pass_scheduled_ = false;
+  start_round_robin();
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
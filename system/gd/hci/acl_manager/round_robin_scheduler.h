@@ -18,17 +18,34 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <vector>
+
 #include "common/bidi_queue.h"
-#include "common/multi_priority_queue.h"
 #include "hci/acl_manager.h"
+#include "hci/acl_manager/acl_handle_table.h"
 #include "hci/controller.h"
 #include "hci/hci_packets.h"
+#include "os/alarm.h"
 #include "os/handler.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+// Shares the controller's ACL buffers between links with a deficit round robin per buffer pool.  BR/EDR and LE
+// links draw on separate pools, each with its own fragment queue, so one pool running dry never holds up the other.
+//
+// Each turn a link earns |weight| fragments of credit and may send PDUs while that covers them.  A link with a
+// latency target is served out of turn once its next PDU has waited longer than the target, and high priority
+// links are always served before the others in their pool.
+//
+// An LE link may have its PDUs held back and sent in a burst just ahead of each of its connection events, so that the
+// host wakes up and talks to the controller once per event instead of once per PDU.
 class RoundRobinScheduler {
  public:
   RoundRobinScheduler(
@@ -37,33 +54,95 @@ class RoundRobinScheduler {
 
   enum ConnectionType { CLASSIC, LE };
 
+  static constexpr uint16_t kDefaultWeight = 1;
+
+  struct LinkStats {
+    uint16_t handle_ = 0;
+    ConnectionType connection_type_ = CLASSIC;
+    uint16_t weight_ = kDefaultWeight;
+    std::chrono::milliseconds latency_target_{0};
+    bool high_priority_ = false;
+
+    uint64_t sent_packets_ = 0;
+    uint64_t sent_fragments_ = 0;
+    // Times the link had a PDU ready while its pool had no controller buffers left, and for how long in total
+    uint32_t credit_starved_count_ = 0;
+    std::chrono::milliseconds credit_starved_time_{0};
+    // Longest a PDU waited between leaving the link's queue and being fragmented for the controller
+    std::chrono::milliseconds max_queueing_delay_{0};
+    uint32_t latency_target_misses_ = 0;
+    // Zero unless the link sends in bursts ahead of its connection events
+    std::chrono::microseconds connection_event_period_{0};
+  };
+
   struct acl_queue_handler {
     ConnectionType connection_type_;
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
     bool high_priority_ = false;           // For A2dp use
+    uint16_t weight_ = kDefaultWeight;
+    std::chrono::milliseconds latency_target_{0};  // Zero when the link has none
+    // The next PDU of the link, taken off its queue so the scheduler can see which links are waiting
+    std::unique_ptr<packet::BasePacketBuilder> pending_packet_;
+    std::chrono::steady_clock::time_point pending_since_;
+    uint64_t pending_sequence_ = 0;
+    uint32_t deficit_ = 0;  // In fragments
+    bool credit_starved_ = false;
+    std::chrono::steady_clock::time_point credit_starved_since_;
+    // Time between the connection events the link sends ahead of, zero to send as soon as possible
+    std::chrono::microseconds connection_event_period_{0};
+    // When the period was last set, taken as the time of a connection event
+    std::chrono::steady_clock::time_point connection_event_anchor_;
+    LinkStats stats_;
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  // |weight| is the share of its pool the link gets while other links are busy, a zero |latency_target| clears it
+  void SetLinkQos(uint16_t handle, uint16_t weight, std::chrono::milliseconds latency_target);
+  // Hold the PDUs of an LE link and send them in a burst ahead of each connection event. Called when the connection
+  // parameters are set or updated, which happens at a connection event. The controller only has to serve one event in
+  // |latency| + 1 when idle, so PDUs are released ahead of those. A zero |interval| sends as soon as possible again.
+  void SetLeConnectionEvents(uint16_t handle, std::chrono::microseconds interval, uint16_t latency);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
+  // Safe to call from any thread
+  std::vector<LinkStats> GetLinkStats() const;
 
  private:
+  using LinkIterator = std::map<uint16_t, acl_queue_handler>::iterator;
+
   void start_round_robin();
-  void buffer_packet(uint16_t acl_handle);
+  void fill_pool(ConnectionType connection_type, std::chrono::steady_clock::time_point now);
+  void on_link_ready(uint16_t acl_handle);
+  void register_link(LinkIterator acl_queue_handler);
+  LinkIterator select_next_link(ConnectionType connection_type, std::chrono::steady_clock::time_point now);
+  void buffer_packet(LinkIterator acl_queue_handler, std::chrono::steady_clock::time_point now);
+  // Whether |link| has to wait for its next burst, and if so when that starts
+  bool is_held(const acl_queue_handler& link, std::chrono::steady_clock::time_point now,
+               std::chrono::steady_clock::time_point* release);
+  void schedule_release(std::chrono::steady_clock::time_point release, std::chrono::steady_clock::time_point now);
+  void on_release();
+  void update_credit_starvation(ConnectionType connection_type, std::chrono::steady_clock::time_point now);
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
+  void on_credits_applied();
+  size_t get_mtu(ConnectionType connection_type) const;
+  uint16_t& get_credits(ConnectionType connection_type);
+  bool can_send(ConnectionType connection_type);
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
-  common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
+  // The entries of acl_queue_handlers_ by handle, for the lookups of every dequeued PDU and completed packets event
+  AclHandleTable<acl_queue_handler> acl_queue_handler_table_;
+  // Fragments of the PDU each pool is sending, indexed by ConnectionType
+  std::array<std::queue<std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
   uint16_t le_max_acl_packet_credits_ = 0;
@@ -72,10 +151,24 @@ class RoundRobinScheduler {
   size_t le_hci_mtu_{0};
   std::atomic_bool enqueue_registered_ = false;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
-  // first register queue end for the Round-robin schedule
-  std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
+  // Arrival order of the PDU each pool is sending, the older one goes out first unless its pool has no credits
+  std::array<uint64_t, 2> fragments_sequence_{};
+  // Link and send timestamp of the PDU each pool is sending
+  std::array<uint16_t, 2> pdu_handle_{};
+  std::array<std::chrono::steady_clock::time_point, 2> pdu_timestamp_{};
+  uint64_t next_sequence_ = 0;
+  // Handle of the link whose turn it is in each pool
+  std::array<uint16_t, 2> current_link_{};
+  // Guards acl_queue_handlers_ membership and the link statistics against GetLinkStats
+  mutable std::mutex stats_mutex_;
+  // Wakes the scheduler up for the next burst of a held link
+  os::Alarm release_alarm_;
+  bool release_scheduled_ = false;
+  std::chrono::steady_clock::time_point scheduled_release_;
+  // A scheduling pass is queued behind the credits of the Number Of Completed Packets event being applied
+  bool credits_pass_scheduled_ = false;
 };
 
 }  // namespace acl_manager
 }  // namespace hci
-}  // namespace bluetooth
\ No newline at end of file
+}  // namespace bluetooth
@@ -159,6 +159,44 @@ class RoundRobinSchedulerTest : public ::testing::Test {
     packet_future_ = std::make_unique<std::future<void>>(packet_promise_->get_future());
   }
 
+  // Use up the BR/EDR controller buffers with packets from |handle|, so that the next ones wait for credits
+  void ExhaustCredits(uint16_t handle, AclConnection::QueueUpEnd* queue_up_end) {
+    ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+    std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+    for (uint16_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+      EnqueueAclUpEnd(queue_up_end, packet);
+    }
+    packet_future_->wait();
+    for (uint16_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+      VerifyPacket(handle, packet);
+    }
+    ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+  }
+
+  // Return one credit at a time for |handle| and collect which link the scheduler sent a packet for
+  std::vector<uint16_t> SendOneByOne(uint16_t credit_handle, size_t count) {
+    std::vector<uint16_t> handles;
+    for (size_t i = 0; i < count; i++) {
+      sync_handler();
+      SetPacketFuture(1);
+      controller_->SendCompletedAclPacketsCallback(credit_handle, 1);
+      packet_future_->wait();
+      handles.push_back(sent_acl_packets_.front().GetHandle());
+      sent_acl_packets_.pop();
+    }
+    return handles;
+  }
+
+  RoundRobinScheduler::LinkStats GetLinkStats(uint16_t handle) {
+    for (const auto& stats : round_robin_scheduler_->GetLinkStats()) {
+      if (stats.handle_ == handle) {
+        return stats;
+      }
+    }
+    ADD_FAILURE() << "No stats for handle " << handle;
+    return {};
+  }
+
   BidiQueue<AclView, AclBuilder> hci_queue_{3};
   Thread* thread_;
   Handler* handler_;
@@ -267,6 +305,45 @@ TEST_F(RoundRobinSchedulerTest, reveived_completed_callback_with_unknown_handle)
   EXPECT_EQ(round_robin_scheduler_->GetLeCredits(), controller_->le_max_acl_packet_credits_);
 }
 
+TEST_F(RoundRobinSchedulerTest, credits_of_several_links_fill_all_freed_buffers) {
+  uint16_t handle = 0x01;
+  uint16_t handle2 = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+
+  // Use up all the buffers, with 3 more PDUs waiting on each link
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(10));
+  for (uint8_t i = 0; i < 8; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x01, i});
+    EnqueueAclUpEnd(connection_queue2->GetUpEnd(), {0x02, i});
+  }
+  packet_future_->wait();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+  while (!sent_acl_packets_.empty()) {
+    sent_acl_packets_.pop();
+  }
+
+  // Both entries of the event are applied before the waiting PDUs are scheduled
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(6));
+  controller_->SendCompletedAclPacketsCallback(handle, 5);
+  controller_->SendCompletedAclPacketsCallback(handle2, 5);
+  packet_future_->wait();
+  sync_handler();
+  std::map<uint16_t, size_t> sent_per_handle;
+  while (!sent_acl_packets_.empty()) {
+    sent_per_handle[sent_acl_packets_.front().GetHandle()]++;
+    sent_acl_packets_.pop();
+  }
+  ASSERT_EQ(3ul, sent_per_handle[handle]);
+  ASSERT_EQ(3ul, sent_per_handle[handle2]);
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 4);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(handle2);
+}
+
 TEST_F(RoundRobinSchedulerTest, buffer_packet_intervally) {
   uint16_t handle1 = 0x01;
   uint16_t handle2 = 0x02;
@@ -412,6 +489,156 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, weighted_links_share_credits) {
+  uint16_t handle = 0x01;
+  uint16_t bulk_handle = 0x02;
+  uint16_t filler_handle = 0x03;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto bulk_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto filler_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, bulk_handle, bulk_connection_queue);
+  round_robin_scheduler_->Register(
+      RoundRobinScheduler::ConnectionType::CLASSIC, filler_handle, filler_connection_queue);
+  round_robin_scheduler_->SetLinkQos(handle, 3, std::chrono::milliseconds(0));
+  ASSERT_NO_FATAL_FAILURE(ExhaustCredits(filler_handle, filler_connection_queue->GetUpEnd()));
+
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  for (int i = 0; i < 8; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+    EnqueueAclUpEnd(bulk_connection_queue->GetUpEnd(), packet);
+  }
+
+  std::vector<uint16_t> expected = {handle, handle, handle, bulk_handle, handle, handle, handle, bulk_handle};
+  ASSERT_EQ(SendOneByOne(filler_handle, expected.size()), expected);
+  ASSERT_EQ(GetLinkStats(handle).sent_packets_, 6u);
+  ASSERT_EQ(GetLinkStats(bulk_handle).sent_packets_, 2u);
+  ASSERT_GE(GetLinkStats(bulk_handle).credit_starved_count_, 1u);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(bulk_handle);
+  round_robin_scheduler_->Unregister(filler_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, link_past_latency_target_goes_first) {
+  uint16_t handle = 0x01;
+  uint16_t audio_handle = 0x02;
+  uint16_t filler_handle = 0x03;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto audio_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto filler_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, audio_handle, audio_connection_queue);
+  round_robin_scheduler_->Register(
+      RoundRobinScheduler::ConnectionType::CLASSIC, filler_handle, filler_connection_queue);
+  round_robin_scheduler_->SetLinkQos(handle, 10, std::chrono::milliseconds(0));
+  round_robin_scheduler_->SetLinkQos(audio_handle, 1, std::chrono::milliseconds(200));
+  ASSERT_NO_FATAL_FAILURE(ExhaustCredits(filler_handle, filler_connection_queue->GetUpEnd()));
+
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  for (int i = 0; i < 2; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+    EnqueueAclUpEnd(audio_connection_queue->GetUpEnd(), packet);
+  }
+  sync_handler();
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+  // The heavier link would have the next turn, but the audio PDU is overdue
+  std::vector<uint16_t> expected = {audio_handle, handle, handle};
+  ASSERT_EQ(SendOneByOne(filler_handle, expected.size()), expected);
+  auto audio_stats = GetLinkStats(audio_handle);
+  ASSERT_EQ(audio_stats.latency_target_misses_, 1u);
+  ASSERT_GE(audio_stats.max_queueing_delay_, std::chrono::milliseconds(200));
+  ASSERT_EQ(audio_stats.weight_, 1);
+  ASSERT_EQ(audio_stats.latency_target_, std::chrono::milliseconds(200));
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(audio_handle);
+  round_robin_scheduler_->Unregister(filler_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, high_priority_link_goes_first) {
+  uint16_t handle = 0x01;
+  uint16_t a2dp_handle = 0x02;
+  uint16_t filler_handle = 0x03;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto a2dp_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto filler_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, a2dp_handle, a2dp_connection_queue);
+  round_robin_scheduler_->Register(
+      RoundRobinScheduler::ConnectionType::CLASSIC, filler_handle, filler_connection_queue);
+  round_robin_scheduler_->SetLinkPriority(a2dp_handle, true);
+  ASSERT_NO_FATAL_FAILURE(ExhaustCredits(filler_handle, filler_connection_queue->GetUpEnd()));
+
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  for (int i = 0; i < 2; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+    EnqueueAclUpEnd(a2dp_connection_queue->GetUpEnd(), packet);
+  }
+
+  std::vector<uint16_t> expected = {a2dp_handle, a2dp_handle, handle, handle};
+  ASSERT_EQ(SendOneByOne(filler_handle, expected.size()), expected);
+  ASSERT_TRUE(GetLinkStats(a2dp_handle).high_priority_);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(a2dp_handle);
+  round_robin_scheduler_->Unregister(filler_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, le_link_not_blocked_by_classic_fragment_waiting_for_credits) {
+  uint16_t handle = 0x01;
+  uint16_t le_handle = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(20);
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(20);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+
+  // Leave the second fragment of the last classic PDU waiting for a credit
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  for (uint16_t i = 0; i < controller_->max_acl_packet_credits_ - 1; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+  }
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), std::vector<uint8_t>(2000));
+  packet_future_->wait();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+  sent_acl_packets_ = {};
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(1));
+  std::vector<uint8_t> le_packet = {0x04, 0x05, 0x06};
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), le_packet);
+  packet_future_->wait();
+  VerifyPacket(le_handle, le_packet);
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), controller_->le_max_acl_packet_credits_ - 1);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, le_link_sends_ahead_of_connection_events) {
+  uint16_t le_handle = 0x02;
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(20);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+
+  // A 20 ms interval with a latency of 4 gives a burst every 100 ms, in the last 25 ms before the event
+  auto start = std::chrono::steady_clock::now();
+  round_robin_scheduler_->SetLeConnectionEvents(le_handle, 20ms, 4);
+  ASSERT_EQ(GetLinkStats(le_handle).connection_event_period_, 100ms);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(2));
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  std::vector<uint8_t> packet2 = {0x04, 0x05, 0x06};
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), packet);
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), packet2);
+  packet_future_->wait();
+  ASSERT_GE(std::chrono::steady_clock::now() - start, 75ms);
+  VerifyPacket(le_handle, packet);
+  VerifyPacket(le_handle, packet2);
+
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
@@ -60,6 +60,9 @@ class MockLeAclConnection : public LeAclConnection {
   MOCK_METHOD(void, Disconnect, (DisconnectReason reason), (override));
   MOCK_METHOD(void, RegisterCallbacks, (LeConnectionManagementCallbacks * callbacks, os::Handler* handler), (override));
   MOCK_METHOD(bool, ReadRemoteVersionInformation, (), (override));
+  MOCK_METHOD(bool, LeSetDataLength, (uint16_t tx_octets, uint16_t tx_time), (override));
+  MOCK_METHOD(
+      bool, LeSetPhy, (uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, PhyOptions phy_options), (override));
 
   QueueUpEnd* GetAclQueueEnd() const override {
     return acl_queue_.GetUpEnd();
@@ -17,14 +17,19 @@
 #include "hci/controller.h"
 
 #include <future>
+#include <limits>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "common/init_flags.h"
+#include "common/strings.h"
 #include "hci/hci_layer.h"
 #include "hci_controller_generated.h"
+#include "os/files.h"
 #include "os/metrics.h"
+#include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "sysprops/sysprops_module.h"
 
@@ -37,6 +42,10 @@ constexpr bool kDefaultVendorCapabilitiesEnabled = true;
 static const std::string kPropertyVendorCapabilitiesEnabled =
     "bluetooth.core.le.vendor_capabilities.enabled";
 
+// Capabilities read at start up are persisted next to the config file, keyed by the controller identity
+constexpr char kControllerSnapshotFileName[] = "bt_controller_snapshot";
+constexpr uint64_t kControllerSnapshotVersion = 1;
+
 using os::Handler;
 
 struct Controller::impl {
@@ -46,38 +55,53 @@ struct Controller::impl {
     hci_ = hci;
     Handler* handler = module_.GetHandler();
     hci_->RegisterEventHandler(
-        EventCode::NUMBER_OF_COMPLETED_PACKETS, handler->BindOn(this, &Controller::impl::NumberOfCompletedPackets));
+        EventCode::NUMBER_OF_COMPLETED_PACKETS,
+        handler->BindOn(Handler::Priority::REAL_TIME, this, &Controller::impl::NumberOfCompletedPackets));
 
     set_event_mask(kDefaultEventMask);
     write_le_host_support(Enable::ENABLED, Enable::DISABLED);
-    hci_->EnqueueCommand(ReadLocalNameBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
-    hci_->EnqueueCommand(ReadLocalVersionInformationBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
-    hci_->EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
 
-    hci_->EnqueueCommand(
-        LeReadLocalSupportedFeaturesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
+    // On a warm start the capabilities come from the snapshot, only the commands changing the controller state
+    // are still sent
+    bool warm_start = common::InitFlags::IsControllerSnapshotEnabled() && start_from_snapshot();
 
-    hci_->EnqueueCommand(
-        LeReadSupportedStatesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
+    if (!warm_start) {
+      hci_->EnqueueCommand(
+          ReadLocalNameBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
+      hci_->EnqueueCommand(
+          ReadLocalVersionInformationBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
+      hci_->EnqueueCommand(
+          ReadLocalSupportedCommandsBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
+
+      hci_->EnqueueCommand(
+          LeReadLocalSupportedFeaturesBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
+
+      hci_->EnqueueCommand(
+          LeReadSupportedStatesBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
 
-    // Wait for all extended features read
-    std::promise<void> features_promise;
-    auto features_future = features_promise.get_future();
+      // Wait for all extended features read
+      std::promise<void> features_promise;
+      auto features_future = features_promise.get_future();
 
-    hci_->EnqueueCommand(ReadLocalExtendedFeaturesBuilder::Create(0x00),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                             std::move(features_promise)));
-    features_future.wait();
+      hci_->EnqueueCommand(
+          ReadLocalExtendedFeaturesBuilder::Create(0x00),
+          handler->BindOnceOn(
+              this, &Controller::impl::read_local_extended_features_complete_handler, std::move(features_promise)));
+      features_future.wait();
+    }
 
     le_set_event_mask(MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
 
-    hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
+    if (!warm_start) {
+      hci_->EnqueueCommand(
+          ReadBufferSizeBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
+    }
 
     if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
       hci_->EnqueueCommand(
@@ -85,6 +109,74 @@ struct Controller::impl {
           handler->BindOnceOn(this, &Controller::impl::set_min_encryption_key_size_handler));
     }
 
+    if (!warm_start) {
+      read_le_capabilities();
+    }
+
+    // SSP is managed by security layer once enabled
+    write_simple_pairing_mode(Enable::ENABLED);
+    if (module_.SupportsSecureConnections()) {
+      hci_->EnqueueCommand(
+          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
+          handler->BindOnceOn(
+              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
+    }
+    if (!warm_start) {
+      read_le_advertising_capabilities();
+    }
+
+    if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
+      hci_->EnqueueCommand(
+          LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
+          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+    }
+
+    if (common::init_flags::subrating_is_enabled() && is_supported(OpCode::LE_SET_HOST_FEATURE) &&
+        module_.SupportsBleConnectionSubrating()) {
+      hci_->EnqueueCommand(
+          LeSetHostFeatureBuilder::Create(
+              LeHostFeatureBits::CONNECTION_SUBRATING_HOST_SUPPORT, Enable::ENABLED),
+          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+    }
+
+    if (is_supported(OpCode::READ_DEFAULT_ERRONEOUS_DATA_REPORTING)) {
+      hci_->EnqueueCommand(
+          ReadDefaultErroneousDataReportingBuilder::Create(),
+          handler->BindOnceOn(
+              this, &Controller::impl::read_default_erroneous_data_reporting_handler));
+    }
+
+    if (warm_start) {
+      verify_snapshot();
+      return;
+    }
+
+    // Skip vendor capabilities check if configured.
+    if (os::GetSystemPropertyBool(
+            kPropertyVendorCapabilitiesEnabled, kDefaultVendorCapabilitiesEnabled)) {
+      hci_->EnqueueCommand(
+          LeGetVendorCapabilitiesBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::le_get_vendor_capabilities_handler));
+    } else {
+      vendor_capabilities_.is_supported_ = 0x00;
+    }
+
+    // We only need to synchronize the last read. Make BD_ADDR to be the last one.
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    hci_->EnqueueCommand(
+        ReadBdAddrBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
+    future.wait();
+
+    if (common::InitFlags::IsControllerSnapshotEnabled() &&
+        !os::WriteToFile(snapshot_file_path(), serialize_snapshot())) {
+      LOG_WARN("Unable to persist the controller snapshot");
+    }
+  }
+
+  void read_le_capabilities() {
+    Handler* handler = module_.GetHandler();
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
       hci_->EnqueueCommand(
           LeReadBufferSizeV2Builder::Create(),
@@ -118,15 +210,10 @@ struct Controller::impl {
       le_maximum_data_length_.supported_max_tx_octets_ = 0;
       le_maximum_data_length_.supported_max_tx_time_ = 0;
     }
+  }
 
-    // SSP is managed by security layer once enabled
-    write_simple_pairing_mode(Enable::ENABLED);
-    if (module_.SupportsSecureConnections()) {
-      hci_->EnqueueCommand(
-          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
-          handler->BindOnceOn(
-              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
-    }
+  void read_le_advertising_capabilities() {
+    Handler* handler = module_.GetHandler();
     if (is_supported(OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
       hci_->EnqueueCommand(
           LeReadSuggestedDefaultDataLengthBuilder::Create(),
@@ -164,44 +251,237 @@ struct Controller::impl {
       LOG_INFO("LE_READ_PERIODIC_ADVERTISER_LIST_SIZE not supported, defaulting to 0");
       le_periodic_advertiser_list_size_ = 0;
     }
-    if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
-      hci_->EnqueueCommand(
-          LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
-          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
-    }
-
-    if (common::init_flags::subrating_is_enabled() && is_supported(OpCode::LE_SET_HOST_FEATURE) &&
-        module_.SupportsBleConnectionSubrating()) {
-      hci_->EnqueueCommand(
-          LeSetHostFeatureBuilder::Create(
-              LeHostFeatureBits::CONNECTION_SUBRATING_HOST_SUPPORT, Enable::ENABLED),
-          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
-    }
+  }
 
-    if (is_supported(OpCode::READ_DEFAULT_ERRONEOUS_DATA_REPORTING)) {
-      hci_->EnqueueCommand(
-          ReadDefaultErroneousDataReportingBuilder::Create(),
-          handler->BindOnceOn(
-              this, &Controller::impl::read_default_erroneous_data_reporting_handler));
-    }
+  std::string snapshot_file_path() const {
+    std::string config_file_path = os::ParameterProvider::ConfigFilePath();
+    return config_file_path.substr(0, config_file_path.find_last_of('/') + 1) + kControllerSnapshotFileName;
+  }
 
-    // Skip vendor capabilities check if configured.
-    if (os::GetSystemPropertyBool(
-            kPropertyVendorCapabilitiesEnabled, kDefaultVendorCapabilitiesEnabled)) {
-      hci_->EnqueueCommand(
-          LeGetVendorCapabilitiesBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_get_vendor_capabilities_handler));
-    } else {
-      vendor_capabilities_.is_supported_ = 0x00;
+  // Reads the identity of the controller and, if it matches the persisted snapshot, restores the capabilities
+  // from it. Returns false when the full read sequence is needed.
+  bool start_from_snapshot() {
+    auto snapshot = os::ReadSmallFile(snapshot_file_path());
+    if (!snapshot.has_value()) {
+      return false;
     }
 
-    // We only need to synchronize the last read. Make BD_ADDR to be the last one.
+    Handler* handler = module_.GetHandler();
+    hci_->EnqueueCommand(
+        ReadLocalVersionInformationBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
     std::promise<void> promise;
     auto future = promise.get_future();
     hci_->EnqueueCommand(
         ReadBdAddrBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
     future.wait();
+
+    if (!restore_snapshot(*snapshot)) {
+      LOG_INFO("Controller snapshot is stale or invalid, reading all capabilities");
+      extended_lmp_features_array_.clear();
+      return false;
+    }
+    LOG_INFO("Restored controller capabilities from snapshot");
+    return true;
+  }
+
+  std::string serialize_snapshot() const {
+    std::vector<std::string> lines;
+    auto put = [&lines](const std::string& key, uint64_t value) {
+      lines.push_back(key + "=" + common::ToString(value));
+    };
+
+    put("version", kControllerSnapshotVersion);
+    lines.push_back("address=" + mac_address_.ToString());
+    put("hci_version", static_cast<uint64_t>(local_version_information_.hci_version_));
+    put("hci_revision", local_version_information_.hci_revision_);
+    put("lmp_version", static_cast<uint64_t>(local_version_information_.lmp_version_));
+    put("manufacturer_name", local_version_information_.manufacturer_name_);
+    put("lmp_subversion", local_version_information_.lmp_subversion_);
+
+    lines.push_back("local_name=" + common::ToHexString(std::vector<uint8_t>(local_name_.begin(), local_name_.end())));
+    lines.push_back(
+        "supported_commands=" +
+        common::ToHexString(local_supported_commands_.begin(), local_supported_commands_.end()));
+    std::vector<std::string> pages;
+    for (auto page : extended_lmp_features_array_) {
+      pages.push_back(common::ToString(page));
+    }
+    lines.push_back("extended_features=" + common::StringJoin(pages, ","));
+
+    put("acl_buffer_length", acl_buffer_length_);
+    put("acl_buffers", acl_buffers_);
+    put("sco_buffer_length", sco_buffer_length_);
+    put("sco_buffers", sco_buffers_);
+    put("le_data_packet_length", le_buffer_size_.le_data_packet_length_);
+    put("total_num_le_packets", le_buffer_size_.total_num_le_packets_);
+    put("iso_data_packet_length", iso_buffer_size_.le_data_packet_length_);
+    put("total_num_iso_packets", iso_buffer_size_.total_num_le_packets_);
+    put("le_features", le_local_supported_features_);
+    put("le_states", le_supported_states_);
+    put("le_connect_list_size", le_connect_list_size_);
+    put("le_resolving_list_size", le_resolving_list_size_);
+    put("le_max_tx_octets", le_maximum_data_length_.supported_max_tx_octets_);
+    put("le_max_tx_time", le_maximum_data_length_.supported_max_tx_time_);
+    put("le_max_rx_octets", le_maximum_data_length_.supported_max_rx_octets_);
+    put("le_max_rx_time", le_maximum_data_length_.supported_max_rx_time_);
+    put("le_max_advertising_data_length", le_maximum_advertising_data_length_);
+    put("le_suggested_default_data_length", le_suggested_default_data_length_);
+    put("le_advertising_sets", le_number_supported_advertising_sets_);
+    put("le_periodic_advertiser_list_size", le_periodic_advertiser_list_size_);
+
+    put("vendor_is_supported", vendor_capabilities_.is_supported_);
+    put("vendor_max_advt_instances", vendor_capabilities_.max_advt_instances_);
+    put("vendor_offloaded_rpa_resolution", vendor_capabilities_.offloaded_resolution_of_private_address_);
+    put("vendor_total_scan_results_storage", vendor_capabilities_.total_scan_results_storage_);
+    put("vendor_max_irk_list_sz", vendor_capabilities_.max_irk_list_sz_);
+    put("vendor_filtering_support", vendor_capabilities_.filtering_support_);
+    put("vendor_max_filter", vendor_capabilities_.max_filter_);
+    put("vendor_activity_energy_info_support", vendor_capabilities_.activity_energy_info_support_);
+    put("vendor_version_supported", vendor_capabilities_.version_supported_);
+    put("vendor_total_num_of_advt_tracked", vendor_capabilities_.total_num_of_advt_tracked_);
+    put("vendor_extended_scan_support", vendor_capabilities_.extended_scan_support_);
+    put("vendor_debug_logging_supported", vendor_capabilities_.debug_logging_supported_);
+    put("vendor_le_address_generation_offloading_support",
+        vendor_capabilities_.le_address_generation_offloading_support_);
+    put("vendor_a2dp_source_offload_capability_mask", vendor_capabilities_.a2dp_source_offload_capability_mask_);
+    put("vendor_bluetooth_quality_report_support", vendor_capabilities_.bluetooth_quality_report_support_);
+
+    return common::StringJoin(lines, "\n") + "\n";
+  }
+
+  bool restore_snapshot(const std::string& snapshot) {
+    std::map<std::string, std::string> values;
+    for (const auto& line : common::StringSplit(snapshot, "\n")) {
+      auto separator = line.find('=');
+      if (separator != std::string::npos) {
+        values[line.substr(0, separator)] = line.substr(separator + 1);
+      }
+    }
+    auto get = [&values](const std::string& key, auto* value) {
+      using T = std::remove_pointer_t<decltype(value)>;
+      auto it = values.find(key);
+      if (it == values.end()) {
+        return false;
+      }
+      auto parsed = common::Uint64FromString(it->second);
+      if (!parsed.has_value() || *parsed > std::numeric_limits<T>::max()) {
+        return false;
+      }
+      *value = static_cast<T>(*parsed);
+      return true;
+    };
+
+    // The identity is checked first, so a different controller or firmware never restores anything
+    uint64_t version = 0;
+    uint8_t hci_version = 0, lmp_version = 0;
+    uint16_t hci_revision = 0, manufacturer_name = 0, lmp_subversion = 0;
+    if (!get("version", &version) || version != kControllerSnapshotVersion ||
+        values["address"] != mac_address_.ToString() || !get("hci_version", &hci_version) ||
+        !get("hci_revision", &hci_revision) ||
+        !get("lmp_version", &lmp_version) || !get("manufacturer_name", &manufacturer_name) ||
+        !get("lmp_subversion", &lmp_subversion) ||
+        hci_version != static_cast<uint8_t>(local_version_information_.hci_version_) ||
+        hci_revision != local_version_information_.hci_revision_ ||
+        lmp_version != static_cast<uint8_t>(local_version_information_.lmp_version_) ||
+        manufacturer_name != local_version_information_.manufacturer_name_ ||
+        lmp_subversion != local_version_information_.lmp_subversion_) {
+      return false;
+    }
+
+    auto local_name = common::FromHexString(values["local_name"]);
+    auto supported_commands = common::FromHexString(values["supported_commands"]);
+    if (!local_name.has_value() || !supported_commands.has_value() ||
+        supported_commands->size() != local_supported_commands_.size()) {
+      return false;
+    }
+    local_name_ = std::string(local_name->begin(), local_name->end());
+    std::copy(supported_commands->begin(), supported_commands->end(), local_supported_commands_.begin());
+
+    extended_lmp_features_array_.clear();
+    for (const auto& page : common::StringSplit(values["extended_features"], ",")) {
+      auto features = common::Uint64FromString(page);
+      if (!features.has_value()) {
+        return false;
+      }
+      extended_lmp_features_array_.push_back(*features);
+    }
+    if (extended_lmp_features_array_.empty()) {
+      return false;
+    }
+
+    return get("acl_buffer_length", &acl_buffer_length_) && get("acl_buffers", &acl_buffers_) &&
+           get("sco_buffer_length", &sco_buffer_length_) && get("sco_buffers", &sco_buffers_) &&
+           get("le_data_packet_length", &le_buffer_size_.le_data_packet_length_) &&
+           get("total_num_le_packets", &le_buffer_size_.total_num_le_packets_) &&
+           get("iso_data_packet_length", &iso_buffer_size_.le_data_packet_length_) &&
+           get("total_num_iso_packets", &iso_buffer_size_.total_num_le_packets_) &&
+           get("le_features", &le_local_supported_features_) && get("le_states", &le_supported_states_) &&
+           get("le_connect_list_size", &le_connect_list_size_) &&
+           get("le_resolving_list_size", &le_resolving_list_size_) &&
+           get("le_max_tx_octets", &le_maximum_data_length_.supported_max_tx_octets_) &&
+           get("le_max_tx_time", &le_maximum_data_length_.supported_max_tx_time_) &&
+           get("le_max_rx_octets", &le_maximum_data_length_.supported_max_rx_octets_) &&
+           get("le_max_rx_time", &le_maximum_data_length_.supported_max_rx_time_) &&
+           get("le_max_advertising_data_length", &le_maximum_advertising_data_length_) &&
+           get("le_suggested_default_data_length", &le_suggested_default_data_length_) &&
+           get("le_advertising_sets", &le_number_supported_advertising_sets_) &&
+           get("le_periodic_advertiser_list_size", &le_periodic_advertiser_list_size_) &&
+           get("vendor_is_supported", &vendor_capabilities_.is_supported_) &&
+           get("vendor_max_advt_instances", &vendor_capabilities_.max_advt_instances_) &&
+           get("vendor_offloaded_rpa_resolution", &vendor_capabilities_.offloaded_resolution_of_private_address_) &&
+           get("vendor_total_scan_results_storage", &vendor_capabilities_.total_scan_results_storage_) &&
+           get("vendor_max_irk_list_sz", &vendor_capabilities_.max_irk_list_sz_) &&
+           get("vendor_filtering_support", &vendor_capabilities_.filtering_support_) &&
+           get("vendor_max_filter", &vendor_capabilities_.max_filter_) &&
+           get("vendor_activity_energy_info_support", &vendor_capabilities_.activity_energy_info_support_) &&
+           get("vendor_version_supported", &vendor_capabilities_.version_supported_) &&
+           get("vendor_total_num_of_advt_tracked", &vendor_capabilities_.total_num_of_advt_tracked_) &&
+           get("vendor_extended_scan_support", &vendor_capabilities_.extended_scan_support_) &&
+           get("vendor_debug_logging_supported", &vendor_capabilities_.debug_logging_supported_) &&
+           get("vendor_le_address_generation_offloading_support",
+               &vendor_capabilities_.le_address_generation_offloading_support_) &&
+           get("vendor_a2dp_source_offload_capability_mask",
+               &vendor_capabilities_.a2dp_source_offload_capability_mask_) &&
+           get("vendor_bluetooth_quality_report_support", &vendor_capabilities_.bluetooth_quality_report_support_);
+  }
+
+  // After a warm start, the capabilities the rest of the stack relies on most are read again in the background.
+  // A mismatch drops the snapshot, so the next start reads everything from the controller.
+  void verify_snapshot() {
+    Handler* handler = module_.GetHandler();
+    hci_->EnqueueCommand(
+        ReadLocalSupportedCommandsBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::verify_supported_commands_handler));
+    hci_->EnqueueCommand(
+        LeReadLocalSupportedFeaturesBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::verify_le_features_handler));
+  }
+
+  void verify_supported_commands_handler(CommandCompleteView view) {
+    auto complete_view = ReadLocalSupportedCommandsCompleteView::Create(view);
+    if (!complete_view.IsValid() || complete_view.GetStatus() != ErrorCode::SUCCESS) {
+      return;
+    }
+    if (complete_view.GetSupportedCommands() != local_supported_commands_) {
+      drop_snapshot("supported commands");
+    }
+  }
+
+  void verify_le_features_handler(CommandCompleteView view) {
+    auto complete_view = LeReadLocalSupportedFeaturesCompleteView::Create(view);
+    if (!complete_view.IsValid() || complete_view.GetStatus() != ErrorCode::SUCCESS) {
+      return;
+    }
+    if (complete_view.GetLeFeatures() != le_local_supported_features_) {
+      drop_snapshot("LE features");
+    }
+  }
+
+  void drop_snapshot(const char* reason) {
+    LOG_WARN("Controller snapshot does not match the controller (%s), dropping it", reason);
+    os::RemoveFile(snapshot_file_path());
   }
 
   void Stop() {
@@ -29,6 +29,8 @@
 #include "common/init_flags.h"
 #include "hci/address.h"
 #include "hci/hci_layer.h"
+#include "os/files.h"
+#include "os/parameter_provider.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -87,6 +89,10 @@ class TestHciLayer : public HciLayer {
     auto packet_view = GetPacketView(std::move(command_builder));
     CommandView command = CommandView::Create(packet_view);
     ASSERT_TRUE(command.IsValid());
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      handled_commands_[command.GetOpCode()]++;
+    }
 
     uint8_t num_packets = 1;
     std::unique_ptr<packet::BasePacketBuilder> event_builder;
@@ -268,6 +274,11 @@ class TestHciLayer : public HciLayer {
     return command;
   }
 
+  size_t GetHandledCommandCount(OpCode op_code) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return handled_commands_[op_code];
+  }
+
   void ListDependencies(ModuleList* list) const {}
   void Start() override {}
   void Stop() override {}
@@ -282,6 +293,7 @@ class TestHciLayer : public HciLayer {
  private:
   common::ContextualCallback<void(EventView)> number_of_completed_packets_callback_;
   std::queue<CommandView> command_queue_;
+  std::map<OpCode, size_t> handled_commands_;
   mutable std::mutex mutex_;
   std::condition_variable not_empty_;
 };
@@ -291,6 +303,9 @@ class ControllerTest : public ::testing::Test {
   void SetUp() override {
     feature_spec_version = feature_spec_version_;
     bluetooth::common::InitFlags::SetAllForTesting();
+    // Every test starts cold, without a controller snapshot from a previous one
+    os::ParameterProvider::OverrideConfigFilePath(::testing::TempDir() + "/bt_config.conf");
+    os::RemoveFile(::testing::TempDir() + "/bt_controller_snapshot");
     test_hci_layer_ = new TestHciLayer;
     fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
     client_handler_ = fake_registry_.GetTestModuleHandler(&HciLayer::Factory);
@@ -360,6 +375,27 @@ TEST_F(ControllerTest, read_controller_info) {
   ASSERT_EQ(controller_->GetLeNumberOfSupportedAdverisingSets(), 0xF0);
 }
 
+TEST_F(ControllerTest, warm_start_from_snapshot) {
+  ASSERT_EQ(test_hci_layer_->GetHandledCommandCount(OpCode::READ_BUFFER_SIZE), 1u);
+  fake_registry_.StopAll();
+
+  // The cold start persisted the capabilities, the next start only checks the controller identity
+  test_hci_layer_ = new TestHciLayer;
+  fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
+  fake_registry_.Start<Controller>(&thread_);
+  controller_ = static_cast<Controller*>(fake_registry_.GetModuleUnderTest(&Controller::Factory));
+
+  ASSERT_EQ(test_hci_layer_->GetHandledCommandCount(OpCode::READ_BUFFER_SIZE), 0u);
+  ASSERT_EQ(test_hci_layer_->GetHandledCommandCount(OpCode::READ_LOCAL_VERSION_INFORMATION), 1u);
+  ASSERT_EQ(controller_->GetAclPacketLength(), test_hci_layer_->acl_data_packet_length);
+  ASSERT_EQ(controller_->GetNumAclPacketBuffers(), test_hci_layer_->total_num_acl_data_packets);
+  ASSERT_EQ(controller_->GetLeBufferSize().le_data_packet_length_, 0x16);
+  ASSERT_EQ(controller_->GetLeSupportedStates(), 0x001f123456789abeUL);
+  ASSERT_EQ(controller_->GetLeMaximumAdvertisingDataLength(), 0x0672);
+  ASSERT_EQ(controller_->GetLocalName(), std::string("DUT"));
+  ASSERT_TRUE(controller_->IsSupported(OpCode::LE_SET_EVENT_MASK));
+}
+
 TEST_F(ControllerTest, read_write_local_name) {
   ASSERT_EQ(controller_->GetLocalName(), "DUT");
   controller_->WriteLocalName("New name");
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/distance_measurement_estimator.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth::hci {
+
+static constexpr int8_t kRSSIDropOffAt1M = 41;
+static constexpr double kSpeedOfLight = 299792458.0;
+
+namespace ranging {
+
+double DistanceFromRssi(int8_t remote_tx_power, int8_t rssi) {
+  double pow_value = (remote_tx_power - rssi - kRSSIDropOffAt1M) / 20.0;
+  return pow(10.0, pow_value);
+}
+
+std::optional<double> DistanceFromPhases(
+    const std::vector<double>& frequencies_hz, const std::vector<double>& phases_rad) {
+  size_t count = frequencies_hz.size();
+  if (count < 2 || phases_rad.size() != count) {
+    return std::nullopt;
+  }
+
+  // The loops below run over plain arrays without dependencies between iterations, so that the compiler can
+  // vectorize them; only the prefix sum unwrapping the phases is sequential.
+  std::vector<double> unwrapped(count);
+  unwrapped[0] = phases_rad[0];
+  for (size_t k = 1; k < count; k++) {
+    double step = phases_rad[k] - phases_rad[k - 1];
+    unwrapped[k] = step - 2 * M_PI * nearbyint(step / (2 * M_PI));
+  }
+  for (size_t k = 1; k < count; k++) {
+    unwrapped[k] += unwrapped[k - 1];
+  }
+
+  double frequency_sum = 0;
+  double phase_sum = 0;
+  for (size_t k = 0; k < count; k++) {
+    frequency_sum += frequencies_hz[k];
+    phase_sum += unwrapped[k];
+  }
+  double frequency_mean = frequency_sum / count;
+  double phase_mean = phase_sum / count;
+
+  double covariance = 0;
+  double frequency_variance = 0;
+  for (size_t k = 0; k < count; k++) {
+    double frequency_offset = frequencies_hz[k] - frequency_mean;
+    covariance += frequency_offset * (unwrapped[k] - phase_mean);
+    frequency_variance += frequency_offset * frequency_offset;
+  }
+  if (frequency_variance == 0) {
+    return std::nullopt;
+  }
+
+  double slope = covariance / frequency_variance;
+  return std::max(0.0, -slope * kSpeedOfLight / (4 * M_PI));
+}
+
+std::optional<double> DistanceFromIq(
+    const std::vector<double>& frequencies_hz,
+    const std::vector<double>& i_samples,
+    const std::vector<double>& q_samples) {
+  if (i_samples.size() != q_samples.size()) {
+    return std::nullopt;
+  }
+  std::vector<double> phases_rad(i_samples.size());
+  for (size_t k = 0; k < i_samples.size(); k++) {
+    phases_rad[k] = atan2(q_samples[k], i_samples[k]);
+  }
+  return DistanceFromPhases(frequencies_hz, phases_rad);
+}
+
+}  // namespace ranging
+
+DistanceEstimator::DistanceEstimator(Parameters parameters) : parameters_(parameters) {
+  ASSERT(parameters_.window_size > 0);
+  sorted_window_.reserve(parameters_.window_size);
+}
+
+void DistanceEstimator::AddRssiSample(
+    int8_t remote_tx_power, int8_t rssi, std::chrono::steady_clock::time_point timestamp) {
+  pending_.push_back({
+      .type = SampleType::RSSI,
+      .timestamp = timestamp,
+      .remote_tx_power = remote_tx_power,
+      .rssi = rssi,
+      .frequencies_hz = {},
+      .phases_rad = {},
+  });
+}
+
+void DistanceEstimator::AddPhaseSample(
+    std::vector<double> frequencies_hz,
+    std::vector<double> phases_rad,
+    std::chrono::steady_clock::time_point timestamp) {
+  pending_.push_back({
+      .type = SampleType::PHASE,
+      .timestamp = timestamp,
+      .remote_tx_power = 0,
+      .rssi = 0,
+      .frequencies_hz = std::move(frequencies_hz),
+      .phases_rad = std::move(phases_rad),
+  });
+}
+
+std::optional<DistanceEstimator::Estimate> DistanceEstimator::Process() {
+  for (const auto& sample : pending_) {
+    switch (sample.type) {
+      case SampleType::RSSI:
+        Update(sample.type, ranging::DistanceFromRssi(sample.remote_tx_power, sample.rssi), sample.timestamp);
+        break;
+      case SampleType::PHASE: {
+        auto meters = ranging::DistanceFromPhases(sample.frequencies_hz, sample.phases_rad);
+        if (!meters) {
+          LOG_WARN("Dropping phase sample of %zu tones", sample.phases_rad.size());
+          break;
+        }
+        Update(sample.type, *meters, sample.timestamp);
+      } break;
+    }
+  }
+  pending_.clear();
+
+  if (!initialized_) {
+    return std::nullopt;
+  }
+  return Estimate{.meters = distance_, .error_meters = sqrt(variance_)};
+}
+
+void DistanceEstimator::Update(SampleType type, double meters, std::chrono::steady_clock::time_point timestamp) {
+  auto& window = windows_[static_cast<size_t>(type)];
+  window.push_back(meters);
+  if (window.size() > parameters_.window_size) {
+    window.pop_front();
+  }
+  sorted_window_.assign(window.begin(), window.end());
+  std::sort(sorted_window_.begin(), sorted_window_.end());
+  size_t middle = sorted_window_.size() / 2;
+  double median = sorted_window_.size() % 2 ? sorted_window_[middle]
+                                            : (sorted_window_[middle - 1] + sorted_window_[middle]) / 2;
+
+  double measurement_noise =
+      type == SampleType::RSSI ? parameters_.rssi_measurement_noise : parameters_.phase_measurement_noise;
+  if (!initialized_) {
+    initialized_ = true;
+    distance_ = median;
+    variance_ = measurement_noise;
+    last_update_ = timestamp;
+    return;
+  }
+
+  // Predict: the distance may have drifted since the last update
+  if (timestamp > last_update_) {
+    variance_ += parameters_.process_noise * std::chrono::duration<double>(timestamp - last_update_).count();
+    last_update_ = timestamp;
+  }
+  // Correct with the filtered measurement
+  double gain = variance_ / (variance_ + measurement_noise);
+  distance_ += gain * (median - distance_);
+  variance_ *= 1 - gain;
+}
+
+}  // namespace bluetooth::hci
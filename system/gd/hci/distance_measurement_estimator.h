@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace bluetooth::hci {
+
+/// Ranging math turning raw measurements into distances, in meters.
+namespace ranging {
+
+/// Log-distance path loss with a free space exponent, from the transmit
+/// power of the remote device and the RSSI measured locally.
+double DistanceFromRssi(int8_t remote_tx_power, int8_t rssi);
+
+/// Phase based ranging. |phases_rad| are the round trip phases measured on
+/// tones of increasing |frequencies_hz|, as in channel sounding. The phase
+/// decreases by 4 * pi * f * d / c with the frequency, so the distance is
+/// given by the slope of the unwrapped phases, fitted with least squares.
+/// Phases are unwrapped between adjacent tones, so the result is ambiguous
+/// beyond c / (4 * tone spacing), i.e. 75m for tones 1MHz apart. Returns
+/// std::nullopt for fewer than two tones.
+std::optional<double> DistanceFromPhases(
+    const std::vector<double>& frequencies_hz, const std::vector<double>& phases_rad);
+
+/// Same as DistanceFromPhases, from the IQ samples of each tone.
+std::optional<double> DistanceFromIq(
+    const std::vector<double>& frequencies_hz,
+    const std::vector<double>& i_samples,
+    const std::vector<double>& q_samples);
+
+}  // namespace ranging
+
+/// Filters the distance of one remote device out of noisy raw samples.
+///
+/// Samples are queued as they arrive and processed in a batch when an
+/// estimate is requested. Each one is converted to a distance, then goes
+/// through a median over the last samples, which rejects the outliers of
+/// multipath fading, and a one dimensional Kalman filter tracking a
+/// distance that moves as a random walk. The error of the estimate is the
+/// standard deviation of the filter.
+class DistanceEstimator {
+ public:
+  struct Parameters {
+    /// Number of samples the median is taken over
+    size_t window_size = 5;
+    /// Variance the distance gains per second, in m^2/s
+    double process_noise = 0.5;
+    /// Variances of the distance of a single sample, in m^2
+    double rssi_measurement_noise = 4.0;
+    double phase_measurement_noise = 0.01;
+  };
+
+  struct Estimate {
+    double meters;
+    double error_meters;
+  };
+
+  DistanceEstimator() : DistanceEstimator(Parameters{}) {}
+  explicit DistanceEstimator(Parameters parameters);
+
+  void AddRssiSample(int8_t remote_tx_power, int8_t rssi, std::chrono::steady_clock::time_point timestamp);
+  void AddPhaseSample(
+      std::vector<double> frequencies_hz,
+      std::vector<double> phases_rad,
+      std::chrono::steady_clock::time_point timestamp);
+
+  size_t PendingSamples() const {
+    return pending_.size();
+  }
+
+  /// Processes the samples queued since the last call. Returns the current
+  /// estimate, std::nullopt until a valid sample was processed.
+  std::optional<Estimate> Process();
+
+ private:
+  enum class SampleType { RSSI, PHASE };
+
+  struct Sample {
+    SampleType type;
+    std::chrono::steady_clock::time_point timestamp;
+    int8_t remote_tx_power;
+    int8_t rssi;
+    std::vector<double> frequencies_hz;
+    std::vector<double> phases_rad;
+  };
+
+  void Update(SampleType type, double meters, std::chrono::steady_clock::time_point timestamp);
+
+  const Parameters parameters_;
+  std::vector<Sample> pending_;
+  // Last raw distances of each sample type, their precisions differ too much to share a median
+  std::deque<double> windows_[2];
+  std::vector<double> sorted_window_;
+  bool initialized_ = false;
+  double distance_ = 0;
+  double variance_ = 0;
+  std::chrono::steady_clock::time_point last_update_;
+};
+
+}  // namespace bluetooth::hci
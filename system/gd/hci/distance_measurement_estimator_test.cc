@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/distance_measurement_estimator.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+static constexpr double kSpeedOfLight = 299792458.0;
+
+// Round trip phases of a reflector at |meters|, on the 2402-2480MHz tones
+static std::vector<double> TonePhases(double meters, std::vector<double>* frequencies_hz) {
+  std::vector<double> phases;
+  for (int channel = 2; channel <= 80; channel++) {
+    double frequency = (2400 + channel) * 1e6;
+    frequencies_hz->push_back(frequency);
+    phases.push_back(remainder(-4 * M_PI * frequency * meters / kSpeedOfLight, 2 * M_PI));
+  }
+  return phases;
+}
+
+TEST(DistanceMeasurementEstimatorTest, distance_from_rssi) {
+  // 41dB of path loss at 1m, 20dB per decade
+  ASSERT_NEAR(1.0, ranging::DistanceFromRssi(0, -41), 1e-9);
+  ASSERT_NEAR(10.0, ranging::DistanceFromRssi(0, -61), 1e-9);
+  ASSERT_NEAR(10.0, ranging::DistanceFromRssi(10, -51), 1e-9);
+}
+
+TEST(DistanceMeasurementEstimatorTest, distance_from_phases) {
+  for (double meters : {0.0, 0.5, 3.2, 27.0, 70.0}) {
+    std::vector<double> frequencies_hz;
+    auto phases = TonePhases(meters, &frequencies_hz);
+    auto distance = ranging::DistanceFromPhases(frequencies_hz, phases);
+    ASSERT_TRUE(distance.has_value());
+    ASSERT_NEAR(meters, *distance, 1e-6);
+  }
+}
+
+TEST(DistanceMeasurementEstimatorTest, distance_from_iq) {
+  std::vector<double> frequencies_hz;
+  auto phases = TonePhases(12.5, &frequencies_hz);
+  std::vector<double> i_samples, q_samples;
+  for (double phase : phases) {
+    i_samples.push_back(0.3 * cos(phase));
+    q_samples.push_back(0.3 * sin(phase));
+  }
+  auto distance = ranging::DistanceFromIq(frequencies_hz, i_samples, q_samples);
+  ASSERT_TRUE(distance.has_value());
+  ASSERT_NEAR(12.5, *distance, 1e-6);
+}
+
+TEST(DistanceMeasurementEstimatorTest, invalid_phases) {
+  ASSERT_FALSE(ranging::DistanceFromPhases({2402e6}, {0.1}).has_value());
+  ASSERT_FALSE(ranging::DistanceFromPhases({2402e6, 2403e6}, {0.1}).has_value());
+  ASSERT_FALSE(ranging::DistanceFromPhases({2402e6, 2402e6}, {0.1, 0.2}).has_value());
+  ASSERT_FALSE(ranging::DistanceFromIq({2402e6, 2403e6}, {1, 1}, {0}).has_value());
+}
+
+TEST(DistanceMeasurementEstimatorTest, no_estimate_without_samples) {
+  DistanceEstimator estimator;
+  ASSERT_FALSE(estimator.Process().has_value());
+
+  // A phase sample that can't be ranged
+  estimator.AddPhaseSample({2402e6}, {0.1}, std::chrono::steady_clock::now());
+  ASSERT_EQ(1u, estimator.PendingSamples());
+  ASSERT_FALSE(estimator.Process().has_value());
+  ASSERT_EQ(0u, estimator.PendingSamples());
+}
+
+TEST(DistanceMeasurementEstimatorTest, samples_are_processed_in_batches) {
+  DistanceEstimator estimator;
+  auto now = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4; i++) {
+    estimator.AddRssiSample(0, -61, now + i * 100ms);
+  }
+  ASSERT_EQ(4u, estimator.PendingSamples());
+  auto estimate = estimator.Process();
+  ASSERT_EQ(0u, estimator.PendingSamples());
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_NEAR(10.0, estimate->meters, 1e-9);
+  // More samples of the same distance make the estimate more certain
+  ASSERT_LT(estimate->error_meters, 2.0);
+}
+
+TEST(DistanceMeasurementEstimatorTest, median_rejects_outliers) {
+  DistanceEstimator estimator;
+  auto now = std::chrono::steady_clock::now();
+  estimator.AddRssiSample(0, -61, now);
+  estimator.AddRssiSample(0, -61, now + 100ms);
+  // A deep fade reads as a much farther device
+  estimator.AddRssiSample(0, -81, now + 200ms);
+  estimator.AddRssiSample(0, -61, now + 300ms);
+  auto estimate = estimator.Process();
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_NEAR(10.0, estimate->meters, 1e-9);
+}
+
+TEST(DistanceMeasurementEstimatorTest, estimate_follows_a_moving_device) {
+  DistanceEstimator::Parameters parameters;
+  parameters.window_size = 1;
+  DistanceEstimator estimator(parameters);
+  auto now = std::chrono::steady_clock::now();
+
+  std::vector<double> frequencies_hz;
+  auto phases = TonePhases(2.0, &frequencies_hz);
+  estimator.AddPhaseSample(frequencies_hz, phases, now);
+  auto estimate = estimator.Process();
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_NEAR(2.0, estimate->meters, 1e-6);
+
+  for (int i = 1; i <= 20; i++) {
+    frequencies_hz.clear();
+    phases = TonePhases(4.0, &frequencies_hz);
+    estimator.AddPhaseSample(frequencies_hz, phases, now + i * 1s);
+  }
+  estimate = estimator.Process();
+  ASSERT_TRUE(estimate.has_value());
+  ASSERT_NEAR(4.0, estimate->meters, 0.01);
+  ASSERT_LT(estimate->error_meters, 0.1);
+}
+
+}  // namespace bluetooth::hci
@@ -15,15 +15,16 @@
  */
 #include "hci/distance_measurement_manager.h"
 
-#include <math.h>
-
+#include <algorithm>
 #include <unordered_map>
 
 #include "hci/acl_manager.h"
+#include "hci/distance_measurement_estimator.h"
 #include "hci/hci_layer.h"
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace hci {
@@ -32,7 +33,10 @@ const ModuleFactory DistanceMeasurementManager::Factory =
     ModuleFactory([]() { return new DistanceMeasurementManager(); });
 static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
 static constexpr uint8_t kTxPowerNotAvailable = 0xfe;
-static constexpr int8_t kRSSIDropOffAt1M = 41;
+// RSSI samples filtered into each reported distance, read evenly over the report interval
+static constexpr char kSamplesPerReportProperty[] = "bluetooth.core.le.distance_measurement_samples_per_report";
+static constexpr uint32_t kDefaultSamplesPerReport = 4;
+static constexpr uint16_t kMinRssiSampleIntervalMs = 100;
 
 struct DistanceMeasurementManager::impl {
   ~impl() {}
@@ -40,6 +44,8 @@ struct DistanceMeasurementManager::impl {
     handler_ = handler;
     hci_layer_ = hci_layer;
     acl_manager_ = acl_manager;
+    samples_per_report_ = std::max<uint32_t>(
+        1, os::GetSystemPropertyUint32(kSamplesPerReportProperty, kDefaultSamplesPerReport));
     hci_layer_->RegisterLeEventHandler(
         hci::SubeventCode::TRANSMIT_POWER_REPORTING,
         handler_->BindOn(this, &impl::on_transmit_power_reporting));
@@ -71,7 +77,7 @@ struct DistanceMeasurementManager::impl {
       case METHOD_RSSI: {
         if (rssi_trackers.find(address) == rssi_trackers.end()) {
           rssi_trackers[address].handle = connection_handle;
-          rssi_trackers[address].frequency = frequency;
+          set_rssi_tracker_frequency(address, frequency);
           rssi_trackers[address].remote_tx_power = kTxPowerNotAvailable;
           rssi_trackers[address].started = false;
           rssi_trackers[address].alarm = std::make_unique<os::Alarm>(handler_);
@@ -81,7 +87,7 @@ struct DistanceMeasurementManager::impl {
               handler_->BindOnceOn(
                   this, &impl::on_read_remote_transmit_power_level_status, address));
         } else {
-          rssi_trackers[address].frequency = frequency;
+          set_rssi_tracker_frequency(address, frequency);
         }
       } break;
     }
@@ -108,6 +114,13 @@ struct DistanceMeasurementManager::impl {
     }
   }
 
+  void set_rssi_tracker_frequency(const Address& address, uint16_t frequency) {
+    auto& tracker = rssi_trackers[address];
+    tracker.frequency = frequency;
+    tracker.samples_per_report =
+        std::clamp<uint32_t>(frequency / kMinRssiSampleIntervalMs, 1, samples_per_report_);
+  }
+
   void read_rssi_regularly(const Address& address, uint16_t frequency) {
     if (rssi_trackers.find(address) == rssi_trackers.end()) {
       LOG_WARN("Can't find rssi tracker for %s ", ADDRESS_TO_LOGGABLE_CSTR(address));
@@ -132,7 +145,8 @@ struct DistanceMeasurementManager::impl {
 
     rssi_trackers[address].alarm->Schedule(
         common::BindOnce(&impl::read_rssi_regularly, common::Unretained(this), address, frequency),
-        std::chrono::milliseconds(rssi_trackers[address].frequency));
+        std::chrono::milliseconds(
+            rssi_trackers[address].frequency / rssi_trackers[address].samples_per_report));
   }
 
   void on_read_remote_transmit_power_level_status(Address address, CommandStatusView view) {
@@ -243,14 +257,21 @@ struct DistanceMeasurementManager::impl {
       LOG_WARN("Can't find rssi tracker for %s", ADDRESS_TO_LOGGABLE_CSTR(address));
       return;
     }
-    double remote_tx_power = (int8_t)rssi_trackers[address].remote_tx_power;
-    int8_t rssi = complete_view.GetRssi();
-    double pow_value = (remote_tx_power - rssi - kRSSIDropOffAt1M) / 20.0;
-    double distance = pow(10.0, pow_value);
+    auto& tracker = rssi_trackers[address];
+    tracker.estimator.AddRssiSample(
+        (int8_t)tracker.remote_tx_power, complete_view.GetRssi(), std::chrono::steady_clock::now());
+    // Report the filtered distance once per report interval, rather than every raw sample
+    if (tracker.estimator.PendingSamples() < tracker.samples_per_report) {
+      return;
+    }
+    auto estimate = tracker.estimator.Process();
+    if (!estimate) {
+      return;
+    }
     distance_measurement_callbacks_->OnDistanceMeasurementResult(
         address,
-        distance * 100,
-        distance * 100,
+        estimate->meters * 100,
+        estimate->error_meters * 100,
         -1,
         -1,
         -1,
@@ -274,9 +295,11 @@ struct DistanceMeasurementManager::impl {
   struct RSSITracker {
     uint16_t handle;
     uint16_t frequency;
+    uint32_t samples_per_report;
     uint8_t remote_tx_power;
     bool started;
     std::unique_ptr<os::Alarm> alarm;
+    DistanceEstimator estimator;
   };
 
   os::Handler* handler_;
@@ -284,6 +307,7 @@ struct DistanceMeasurementManager::impl {
   hci::AclManager* acl_manager_;
   std::unordered_map<Address, RSSITracker> rssi_trackers;
   DistanceMeasurementCallbacks* distance_measurement_callbacks_;
+  uint32_t samples_per_report_ = kDefaultSamplesPerReport;
 };
 
 DistanceMeasurementManager::DistanceMeasurementManager() {
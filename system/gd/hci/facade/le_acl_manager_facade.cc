@@ -145,9 +145,8 @@ class LeAclManagerFacadeService : public LeAclManagerFacade::Service, public LeC
       const LeConnectionCommandMsg* request,
       ::google::protobuf::Empty* response) override {
     LOG_INFO("size=%zu", request->packet().size());
-    auto command_view =
-        ConnectionManagementCommandView::Create(AclCommandView::Create(CommandView::Create(PacketView<kLittleEndian>(
-            std::make_shared<std::vector<uint8_t>>(request->packet().begin(), request->packet().end())))));
+    auto command_view = AclCommandView::Create(CommandView::Create(PacketView<kLittleEndian>(
+        std::make_shared<std::vector<uint8_t>>(request->packet().begin(), request->packet().end()))));
     if (!command_view.IsValid()) {
       return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Invalid command packet");
     }
@@ -159,6 +158,16 @@ class LeAclManagerFacadeService : public LeAclManagerFacade::Service, public LeC
         connection->second.connection_->Disconnect(view.GetReason());
         return ::grpc::Status::OK;
       }
+      case OpCode::LE_SET_PHY: {
+        auto view = LeSetPhyView::Create(LeConnectionManagementCommandView::Create(command_view));
+        GET_CONNECTION(view);
+        uint8_t all_phys = view.GetAllPhysNoTransmitPreference() | (view.GetAllPhysNoReceivePreference() << 1);
+        if (!connection->second.connection_->LeSetPhy(
+                all_phys, view.GetTxPhysBitmask(), view.GetRxPhysBitmask(), view.GetPhyOptions())) {
+          return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Invalid PHY parameters");
+        }
+        return ::grpc::Status::OK;
+      }
       default:
         return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT, "Invalid command packet");
     }
@@ -357,7 +366,15 @@ class LeAclManagerFacadeService : public LeAclManagerFacade::Service, public LeC
           "tx_octets: 0x%hx, tx_time: 0x%hx, rx_octets 0x%hx, rx_time 0x%hx", tx_octets, tx_time, rx_octets, rx_time);
     }
 
-    void OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy) override {}
+    void OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy) override {
+      LOG_INFO("hci_status: %s, tx_phy: %hhu, rx_phy: %hhu", ErrorCodeText(hci_status).c_str(), tx_phy, rx_phy);
+      std::unique_ptr<BasePacketBuilder> builder =
+          LePhyUpdateCompleteBuilder::Create(hci_status, handle_, tx_phy, rx_phy);
+      LeConnectionEvent phy_update;
+      phy_update.set_payload(builder_to_string(std::move(builder)));
+      event_stream_->OnIncomingEvent(phy_update);
+    }
+
     void OnDisconnection(ErrorCode reason) override {
       LOG_INFO("reason: %s", ErrorCodeText(reason).c_str());
       std::unique_ptr<BasePacketBuilder> builder =
@@ -16,9 +16,14 @@
 
 #include "hci/hci_layer.h"
 
+#include <algorithm>
+#include <array>
+
+#include "common/allocation_hook.h"
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "common/stop_watch.h"
+#include "common/tracing.h"
 #include "hci/hci_metrics_logging.h"
 #include "os/alarm.h"
 #include "os/metrics.h"
@@ -58,6 +63,51 @@ static void abort_after_time_out(OpCode op_code) {
   ASSERT_LOG(false, "Done waiting for debug information after HCI timeout (%s)", OpCodeText(op_code).c_str());
 }
 
+// Commands that are only sent once every outstanding command completed, and that hold off the commands after them
+static bool is_barrier_command(OpCode op_code) {
+  switch (op_code) {
+    case OpCode::RESET:
+    case OpCode::CONTROLLER_DEBUG_INFO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The LE filter accept list and resolving list can not change while scanning or connecting uses them, so these are
+// kept one at a time in the order they were queued
+static bool is_le_list_scan_or_connect_command(OpCode op_code) {
+  switch (op_code) {
+    case OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST:
+    case OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST:
+    case OpCode::LE_CLEAR_FILTER_ACCEPT_LIST:
+    case OpCode::LE_ADD_DEVICE_TO_RESOLVING_LIST:
+    case OpCode::LE_REMOVE_DEVICE_FROM_RESOLVING_LIST:
+    case OpCode::LE_CLEAR_RESOLVING_LIST:
+    case OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE:
+    case OpCode::LE_SET_RESOLVABLE_PRIVATE_ADDRESS_TIMEOUT:
+    case OpCode::LE_SET_PRIVACY_MODE:
+    case OpCode::LE_SET_RANDOM_ADDRESS:
+    case OpCode::LE_SET_SCAN_PARAMETERS:
+    case OpCode::LE_SET_SCAN_ENABLE:
+    case OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS:
+    case OpCode::LE_SET_EXTENDED_SCAN_ENABLE:
+    case OpCode::LE_CREATE_CONNECTION:
+    case OpCode::LE_EXTENDED_CREATE_CONNECTION:
+    case OpCode::LE_CREATE_CONNECTION_CANCEL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether the command queued later has to wait for the outstanding one to complete. Responses are matched to
+// outstanding commands by op code, so two commands with the same op code are never outstanding together.
+static bool depends_on(OpCode later, OpCode outstanding) {
+  return later == outstanding || is_barrier_command(later) || is_barrier_command(outstanding) ||
+         (is_le_list_scan_or_connect_command(later) && is_le_list_scan_or_connect_command(outstanding));
+}
+
 class CommandQueueEntry {
  public:
   CommandQueueEntry(
@@ -75,6 +125,8 @@ class CommandQueueEntry {
         on_status(std::move(on_status_function)) {}
 
   unique_ptr<CommandBuilder> command;
+  // Set when the command is queued, so that its op code is known while it waits for its dependencies
+  std::shared_ptr<std::vector<uint8_t>> bytes;
   unique_ptr<CommandView> command_view;
 
   bool waiting_for_status_;
@@ -113,6 +165,7 @@ struct HciLayer::impl {
       delete hci_abort_alarm_;
     }
     command_queue_.clear();
+    outstanding_commands_.clear();
   }
 
   void drop(EventView event) {
@@ -120,35 +173,43 @@ struct HciLayer::impl {
   }
 
   void on_outbound_acl_ready() {
+    BT_TRACE_SCOPE("hci", "send_acl", 0, 0);
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    common::NotifyAllocation("hci acl tx", packet->size());
+    hal_->sendAclData(packet->SerializeToBytes());
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendScoData(bytes);
+    hal_->sendScoData(packet->SerializeToBytes());
   }
 
   void on_outbound_iso_ready() {
+    BT_TRACE_SCOPE("hci", "send_iso", 0, 0);
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendIsoData(bytes);
+    hal_->sendIsoData(packet->SerializeToBytes());
   }
 
   template <typename TResponse>
   void enqueue_command(unique_ptr<CommandBuilder> command, ContextualOnceCallback<void(TResponse)> on_response) {
-    command_queue_.emplace_back(std::move(command), std::move(on_response));
+    auto& entry = command_queue_.emplace_back(std::move(command), std::move(on_response));
+    entry.bytes = std::make_shared<std::vector<uint8_t>>();
+    BitInserter bi(*entry.bytes);
+    entry.command->Serialize(bi);
+    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(entry.bytes));
+    ASSERT(cmd_view.IsValid());
+    entry.command_view = std::make_unique<CommandView>(std::move(cmd_view));
     send_next_command();
   }
 
+  // The outstanding command a response with this op code is for, or the end of outstanding_commands_
+  std::list<CommandQueueEntry>::iterator find_outstanding_command(OpCode op_code) {
+    return std::find_if(
+        outstanding_commands_.begin(), outstanding_commands_.end(), [op_code](const CommandQueueEntry& entry) {
+          return entry.command_view->GetOpCode() == op_code;
+        });
+  }
+
   void on_command_status(EventView event) {
     CommandStatusView response_view = CommandStatusView::Create(event);
     ASSERT(response_view.IsValid());
@@ -181,26 +242,28 @@ struct HciLayer::impl {
     bool is_status = logging_id == "status";
 
     ASSERT_LOG(
-        !command_queue_.empty(),
+        !outstanding_commands_.empty(),
         "Unexpected %s event with OpCode 0x%02hx (%s)",
         logging_id.c_str(),
         op_code,
         OpCodeText(op_code).c_str());
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    auto command = find_outstanding_command(op_code);
+    if (command == outstanding_commands_.end() &&
+        outstanding_commands_.front().command_view->GetOpCode() == OpCode::CONTROLLER_DEBUG_INFO) {
       LOG_ERROR("Discarding event that came after timeout 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
       return;
     }
     ASSERT_LOG(
-        waiting_command_ == op_code,
+        command != outstanding_commands_.end(),
         "Waiting for 0x%02hx (%s), got 0x%02hx (%s)",
-        waiting_command_,
-        OpCodeText(waiting_command_).c_str(),
+        outstanding_commands_.front().command_view->GetOpCode(),
+        OpCodeText(outstanding_commands_.front().command_view->GetOpCode()).c_str(),
         op_code,
         OpCodeText(op_code).c_str());
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected,
       // we can't treat this as hard failure since we have no way of probing this lack of support at
@@ -208,37 +271,46 @@ struct HciLayer::impl {
       // packet, which will be interpreted as invalid response.
       CommandCompleteView command_complete_view = CommandCompleteView::Create(
           EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-      command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(
-          std::move(command_complete_view));
+      command->GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
     } else {
       ASSERT_LOG(
-          command_queue_.front().waiting_for_status_ == is_status,
+          command->waiting_for_status_ == is_status,
           "0x%02hx (%s) was not expecting %s event",
           op_code,
           OpCodeText(op_code).c_str(),
           logging_id.c_str());
 
-      command_queue_.front().GetCallback<TResponse>()->Invoke(std::move(response_view));
+      command->GetCallback<TResponse>()->Invoke(std::move(response_view));
     }
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    bool was_oldest = command == outstanding_commands_.begin();
+    outstanding_commands_.erase(command);
     if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Cancel();
+      if (was_oldest) {
+        hci_timeout_alarm_->Cancel();
+        // The next oldest command gets a full timeout from now
+        if (!outstanding_commands_.empty()) {
+          schedule_hci_timeout(outstanding_commands_.front().command_view->GetOpCode());
+        }
+      }
       send_next_command();
     }
   }
 
+  void schedule_hci_timeout(OpCode op_code) {
+    hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
+  }
+
   void on_hci_timeout(OpCode op_code) {
     common::StopWatch::DumpStopWatchLog();
     LOG_ERROR("Timed out waiting for 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
     // TODO: LogMetricHciTimeoutEvent(static_cast<uint32_t>(op_code));
 
-    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size());
+    LOG_ERROR("Flushing %zd waiting commands", outstanding_commands_.size() + command_queue_.size());
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
+    outstanding_commands_.clear();
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
     // Ignore the response, since we don't know what might come back.
     enqueue_command(ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce([](CommandCompleteView) {}));
     // Don't time out for this one;
@@ -255,33 +327,44 @@ struct HciLayer::impl {
     }
   }
 
-  void send_next_command() {
-    if (command_credits_ == 0) {
-      return;
+  // Whether the oldest queued command can be sent now. Commands are sent in the order they were queued.
+  bool can_send_next_command() const {
+    if (command_credits_ == 0 || command_queue_.empty()) {
+      return false;
     }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
+    if (!command_pipelining_ && !outstanding_commands_.empty()) {
+      return false;
     }
-    if (command_queue_.size() == 0) {
-      return;
+    OpCode op_code = command_queue_.front().command_view->GetOpCode();
+    for (const auto& outstanding : outstanding_commands_) {
+      if (depends_on(op_code, outstanding.command_view->GetOpCode())) {
+        return false;
+      }
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
+    return true;
+  }
 
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    ASSERT(cmd_view.IsValid());
-    OpCode op_code = cmd_view.GetOpCode();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
-    if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
-    } else {
-      LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+  void send_next_command() {
+    while (can_send_next_command()) {
+      outstanding_commands_.splice(outstanding_commands_.end(), command_queue_, command_queue_.begin());
+      auto& command = outstanding_commands_.back();
+      BT_TRACE_INSTANT("hci", "send_command", 0, 0);
+      hal_->sendHciCommand(*command.bytes);
+
+      OpCode op_code = command.command_view->GetOpCode();
+      log_link_layer_connection_command(command.command_view);
+      log_classic_pairing_command_status(command.command_view, ErrorCode::STATUS_UNKNOWN);
+      // Num_HCI_Command_Packets of the next response tells how many more the controller takes
+      command_credits_--;
+      if (outstanding_commands_.size() > 1) {
+        // The timeout runs for the oldest outstanding command
+        continue;
+      }
+      if (hci_timeout_alarm_ != nullptr) {
+        schedule_hci_timeout(op_code);
+      } else {
+        LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+      }
     }
   }
 
@@ -291,29 +374,31 @@ struct HciLayer::impl {
         "Can not register handler for %02hhx (%s)",
         EventCode::LE_META_EVENT,
         EventCodeText(EventCode::LE_META_EVENT).c_str());
+    auto& event_handler = event_handlers_[static_cast<uint8_t>(event)];
     ASSERT_LOG(
-        event_handlers_.count(event) == 0,
+        event_handler.IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         EventCodeText(event).c_str());
-    event_handlers_[event] = handler;
+    event_handler = handler;
   }
 
   void unregister_event(EventCode event) {
-    event_handlers_.erase(event);
+    event_handlers_[static_cast<uint8_t>(event)] = {};
   }
 
   void register_le_event(SubeventCode event, ContextualCallback<void(LeMetaEventView)> handler) {
+    auto& subevent_handler = subevent_handlers_[static_cast<uint8_t>(event)];
     ASSERT_LOG(
-        subevent_handlers_.count(event) == 0,
+        subevent_handler.IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         SubeventCodeText(event).c_str());
-    subevent_handlers_[event] = handler;
+    subevent_handler = handler;
   }
 
   void unregister_le_event(SubeventCode event) {
-    subevent_handlers_.erase(subevent_handlers_.find(event));
+    subevent_handlers_[static_cast<uint8_t>(event)] = {};
   }
 
   static void abort_after_root_inflammation(uint8_t vse_error) {
@@ -338,9 +423,16 @@ struct HciLayer::impl {
     }
   }
 
+  void on_hci_events(std::vector<EventView> events) {
+    for (auto& event : events) {
+      on_hci_event(std::move(event));
+    }
+  }
+
   void on_hci_event(EventView event) {
+    BT_TRACE_SCOPE("hci", "event", 0, 0);
     ASSERT(event.IsValid());
-    if (command_queue_.empty()) {
+    if (outstanding_commands_.empty()) {
       auto event_code = event.GetEventCode();
       // BT Core spec 5.2 (Volume 4, Part E section 4.4) allows anytime
       // COMMAND_COMPLETE and COMMAND_STATUS with opcode 0x0 for flow control
@@ -371,7 +463,7 @@ struct HciLayer::impl {
       std::unique_ptr<CommandView> no_waiting_command{nullptr};
       log_hci_event(no_waiting_command, event, module_.GetDependency<storage::StorageModule>());
     } else {
-      log_hci_event(command_queue_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
+      log_hci_event(outstanding_command_view(event), event, module_.GetDependency<storage::StorageModule>());
     }
     EventCode event_code = event.GetEventCode();
     // Root Inflamation is a special case, since it aborts here
@@ -397,38 +489,62 @@ struct HciLayer::impl {
       case EventCode::LE_META_EVENT:
         on_le_meta_event(event);
         break;
-      default:
-        if (event_handlers_.find(event_code) == event_handlers_.end()) {
+      default: {
+        auto& event_handler = event_handlers_[static_cast<uint8_t>(event_code)];
+        if (event_handler.IsEmpty()) {
           LOG_WARN(
               "Unhandled event of type 0x%02hhx (%s)",
               event_code,
               EventCodeText(event_code).c_str());
         } else {
-          event_handlers_[event_code].Invoke(event);
+          event_handler.Invoke(event);
         }
+      }
+    }
+  }
+
+  // The outstanding command a Command Complete or Status event is for, falling back to the oldest one
+  std::unique_ptr<CommandView>& outstanding_command_view(EventView event) {
+    OpCode op_code = OpCode::NONE;
+    if (event.GetEventCode() == EventCode::COMMAND_COMPLETE) {
+      auto view = CommandCompleteView::Create(event);
+      op_code = view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
+    } else if (event.GetEventCode() == EventCode::COMMAND_STATUS) {
+      auto view = CommandStatusView::Create(event);
+      op_code = view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
     }
+    auto command = find_outstanding_command(op_code);
+    if (command == outstanding_commands_.end()) {
+      return outstanding_commands_.front().command_view;
+    }
+    return command->command_view;
   }
 
   void on_le_meta_event(EventView event) {
     LeMetaEventView meta_event_view = LeMetaEventView::Create(event);
     ASSERT(meta_event_view.IsValid());
     SubeventCode subevent_code = meta_event_view.GetSubeventCode();
-    if (subevent_handlers_.find(subevent_code) == subevent_handlers_.end()) {
+    auto& subevent_handler = subevent_handlers_[static_cast<uint8_t>(subevent_code)];
+    if (subevent_handler.IsEmpty()) {
       LOG_WARN("Unhandled le subevent of type 0x%02hhx (%s)", subevent_code, SubeventCodeText(subevent_code).c_str());
       return;
     }
-    subevent_handlers_[subevent_code].Invoke(meta_event_view);
+    subevent_handler.Invoke(meta_event_view);
   }
 
   hal::HciHal* hal_;
   HciLayer& module_;
 
   // Command Handling
+  // Commands not sent yet, and commands sent and waiting for their Command Complete or Status, oldest first
   std::list<CommandQueueEntry> command_queue_;
+  std::list<CommandQueueEntry> outstanding_commands_;
+  // Whether to send more commands than one at a time, up to the number the controller allows
+  const bool command_pipelining_{common::InitFlags::IsHciCommandPipeliningEnabled()};
 
-  std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
-  std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> subevent_handlers_;
-  OpCode waiting_command_{OpCode::NONE};
+  // Indexed by event and subevent code, an empty callback when there is no handler
+  std::array<ContextualCallback<void(EventView)>, 0x100> event_handlers_;
+  std::array<ContextualCallback<void(LeMetaEventView)>, 0x100> subevent_handlers_;
   uint8_t command_credits_{1};  // Send reset first
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
@@ -451,15 +567,18 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
+    common::NotifyAllocation("hci event rx", event_bytes.size());
     auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
-    EventView event = EventView::Create(packet);
-    module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event));
+    post_event(EventView::Create(packet));
   }
 
   void aclDataReceived(hal::HciPacket data_bytes) override {
+    common::NotifyAllocation("hci acl rx", data_bytes.size());
     auto packet = packet::PacketView<packet::kLittleEndian>(
         std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
+    packet.SetTimestamp(std::chrono::steady_clock::now());
     auto acl = std::make_unique<AclView>(AclView::Create(packet));
+    BT_TRACE_INSTANT("hci", "receive_acl", 0, 0);
     module_.impl_->incoming_acl_buffer_.Enqueue(std::move(acl), module_.GetHandler());
   }
 
@@ -474,9 +593,71 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
     auto packet = packet::PacketView<packet::kLittleEndian>(
         std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
     auto iso = std::make_unique<IsoView>(IsoView::Create(packet));
+    BT_TRACE_INSTANT("hci", "receive_iso", 0, 0);
+    module_.impl_->incoming_iso_buffer_.Enqueue(std::move(iso), module_.GetHandler());
+  }
+
+  void hciEventSliceReceived(hal::HciPacketSlice event_slice) override {
+    post_event(EventView::Create(ToPacketView(std::move(event_slice))));
+  }
+
+  void aclDataSliceReceived(hal::HciPacketSlice data_slice) override {
+    auto packet = ToPacketView(std::move(data_slice));
+    packet.SetTimestamp(std::chrono::steady_clock::now());
+    auto acl = std::make_unique<AclView>(AclView::Create(packet));
+    BT_TRACE_INSTANT("hci", "receive_acl", 0, 0);
+    module_.impl_->incoming_acl_buffer_.Enqueue(std::move(acl), module_.GetHandler());
+  }
+
+  void scoDataSliceReceived(hal::HciPacketSlice data_slice) override {
+    auto sco = std::make_unique<ScoView>(ScoView::Create(ToPacketView(std::move(data_slice))));
+    module_.impl_->incoming_sco_buffer_.Enqueue(std::move(sco), module_.GetHandler());
+  }
+
+  void isoDataSliceReceived(hal::HciPacketSlice data_slice) override {
+    auto iso = std::make_unique<IsoView>(IsoView::Create(ToPacketView(std::move(data_slice))));
+    BT_TRACE_INSTANT("hci", "receive_iso", 0, 0);
     module_.impl_->incoming_iso_buffer_.Enqueue(std::move(iso), module_.GetHandler());
   }
 
+  void hciPacketBatchReceived(std::vector<hal::ReceivedHciPacket> packets) override {
+    // Events are handed over in a single hop; data packets already go through the enqueue buffers.
+    std::vector<EventView> events;
+    for (auto& packet : packets) {
+      switch (packet.type) {
+        case hal::ReceivedHciPacket::Type::EVENT:
+          events.push_back(EventView::Create(ToPacketView(std::move(packet.slice))));
+          break;
+        case hal::ReceivedHciPacket::Type::ACL:
+          aclDataSliceReceived(std::move(packet.slice));
+          break;
+        case hal::ReceivedHciPacket::Type::SCO:
+          scoDataSliceReceived(std::move(packet.slice));
+          break;
+        case hal::ReceivedHciPacket::Type::ISO:
+          isoDataSliceReceived(std::move(packet.slice));
+          break;
+      }
+    }
+    if (events.size() == 1) {
+      post_event(std::move(events.front()));
+    } else if (!events.empty()) {
+      module_.CallOn(module_.impl_, &impl::on_hci_events, std::move(events));
+    }
+  }
+
+  // Events arrive once per packet, the inline task avoids allocating a BindState for each of them
+  void post_event(EventView event) {
+    module_.GetHandler()->Post(
+        [impl = module_.impl_, event = std::move(event)]() mutable { impl->on_hci_event(std::move(event)); });
+  }
+
+  // The view shares ownership of the HAL buffer, so no bytes are copied
+  static packet::PacketView<packet::kLittleEndian> ToPacketView(hal::HciPacketSlice slice) {
+    return packet::PacketView<packet::kLittleEndian>(
+        std::forward_list<packet::View>({packet::View(std::move(slice.buffer), slice.begin, slice.end)}));
+  }
+
   HciLayer& module_;
 };
 
@@ -540,10 +721,7 @@ void HciLayer::on_disconnection_complete(EventView event_view) {
 }
 
 void HciLayer::Disconnect(uint16_t handle, ErrorCode reason) {
-  std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-  for (auto callback : disconnect_handlers_) {
-    callback.Invoke(handle, reason);
-  }
+  disconnect_handlers_.Notify(handle, reason);
 }
 
 void HciLayer::on_read_remote_version_complete(EventView event_view) {
@@ -559,10 +737,7 @@ void HciLayer::on_read_remote_version_complete(EventView event_view) {
 
 void HciLayer::ReadRemoteVersion(
     hci::ErrorCode hci_status, uint16_t handle, uint8_t version, uint16_t manufacturer_name, uint16_t sub_version) {
-  std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-  for (auto callback : read_remote_version_handlers_) {
-    callback.Invoke(hci_status, handle, version, manufacturer_name, sub_version);
-  }
+  read_remote_version_handlers_.Notify(hci_status, handle, version, manufacturer_name, sub_version);
 }
 
 AclConnectionInterface* HciLayer::GetAclConnectionInterface(
@@ -571,11 +746,8 @@ AclConnectionInterface* HciLayer::GetAclConnectionInterface(
     ContextualCallback<
         void(hci::ErrorCode hci_status, uint16_t, uint8_t version, uint16_t manufacturer_name, uint16_t sub_version)>
         on_read_remote_version) {
-  {
-    std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-    disconnect_handlers_.push_back(on_disconnect);
-    read_remote_version_handlers_.push_back(on_read_remote_version);
-  }
+  disconnect_handlers_.Add(on_disconnect);
+  read_remote_version_handlers_.Add(on_read_remote_version);
   for (const auto event : AclConnectionEvents) {
     RegisterEventHandler(event, event_handler);
   }
@@ -586,11 +758,8 @@ void HciLayer::PutAclConnectionInterface() {
   for (const auto event : AclConnectionEvents) {
     UnregisterEventHandler(event);
   }
-  {
-    std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-    disconnect_handlers_.clear();
-    read_remote_version_handlers_.clear();
-  }
+  disconnect_handlers_.Clear();
+  read_remote_version_handlers_.Clear();
 }
 
 LeAclConnectionInterface* HciLayer::GetLeAclConnectionInterface(
@@ -599,11 +768,8 @@ LeAclConnectionInterface* HciLayer::GetLeAclConnectionInterface(
     ContextualCallback<
         void(hci::ErrorCode hci_status, uint16_t, uint8_t version, uint16_t manufacturer_name, uint16_t sub_version)>
         on_read_remote_version) {
-  {
-    std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-    disconnect_handlers_.push_back(on_disconnect);
-    read_remote_version_handlers_.push_back(on_read_remote_version);
-  }
+  disconnect_handlers_.Add(on_disconnect);
+  read_remote_version_handlers_.Add(on_read_remote_version);
   for (const auto event : LeConnectionManagementEvents) {
     RegisterLeEventHandler(event, event_handler);
   }
@@ -614,11 +780,8 @@ void HciLayer::PutLeAclConnectionInterface() {
   for (const auto event : LeConnectionManagementEvents) {
     UnregisterLeEventHandler(event);
   }
-  {
-    std::unique_lock<std::mutex> lock(callback_handlers_guard_);
-    disconnect_handlers_.clear();
-    read_remote_version_handlers_.clear();
-  }
+  disconnect_handlers_.Clear();
+  read_remote_version_handlers_.Clear();
 }
 
 SecurityInterface* HciLayer::GetSecurityInterface(ContextualCallback<void(EventView)> event_handler) {
@@ -28,6 +28,7 @@
 #include "common/bidi_queue.h"
 #include "common/callback.h"
 #include "common/contextual_callback.h"
+#include "common/contextual_callback_list.h"
 #include "hal/hci_hal.h"
 #include "hci/acl_connection_interface.h"
 #include "hci/hci_packets.h"
@@ -125,8 +126,8 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
       uint16_t manufacturer_name,
       uint16_t sub_version);
 
-  std::list<common::ContextualCallback<void(uint16_t, ErrorCode)>> disconnect_handlers_;
-  std::list<common::ContextualCallback<void(hci::ErrorCode, uint16_t, uint8_t, uint16_t, uint16_t)>>
+  common::ContextualCallbackList<void(uint16_t, ErrorCode)> disconnect_handlers_;
+  common::ContextualCallbackList<void(hci::ErrorCode, uint16_t, uint8_t, uint16_t, uint16_t)>
       read_remote_version_handlers_;
 
  private:
@@ -153,7 +154,6 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
     HciLayer& hci_;
   };
 
-  std::mutex callback_handlers_guard_;
   void on_disconnection_complete(EventView event_view);
   void on_read_remote_version_complete(EventView event_view);
 
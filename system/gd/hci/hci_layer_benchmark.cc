@@ -0,0 +1,168 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "common/bind.h"
+#include "hal/hci_hal_fake.h"
+#include "hci/hci_layer.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::CompletionCounter;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+constexpr uint16_t kHandle = 0x0123;
+
+std::vector<uint8_t> GetPacketBytes(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  std::vector<uint8_t> bytes;
+  bytes.reserve(packet->size());
+  packet::BitInserter i(bytes);
+  packet->Serialize(i);
+  return bytes;
+}
+
+// Feeds preserialized packets to HciLayer through the fake HAL callbacks, the same way the HAL thread does, and
+// counts them as they reach a client handler on another thread
+class BM_HciLayer : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    registry_ = std::make_unique<TestModuleRegistry>();
+    hal_ = new hal::TestHciHal();
+    registry_->InjectTestModule(&hal::HciHal::Factory, hal_);
+    registry_->Start<HciLayer>(&registry_->GetTestThread());
+    hci_ = registry_->GetModuleUnderTest<HciLayer>();
+
+    // Complete the reset sent by HciLayer::Start so that its command timeout never fires
+    auto reset = hal_->GetSentCommand();
+    ASSERT(reset.has_value());
+    hal_->InjectEvent(ResetCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+
+    client_thread_ = new os::Thread("client_thread", os::Thread::Priority::NORMAL);
+    client_handler_ = new os::Handler(client_thread_);
+    completed_ = std::make_unique<CompletionCounter>();
+    received_ = 0;
+  }
+
+  void TearDown(State& st) override {
+    registry_->StopAll();
+    client_handler_->Clear();
+    delete client_handler_;
+    delete client_thread_;
+    completed_.reset();
+    registry_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void on_event(EventView view) {
+    ::benchmark::DoNotOptimize(LinkSupervisionTimeoutChangedView::Create(view).IsValid());
+    completed_->Add();
+  }
+
+  void on_le_event(LeMetaEventView view) {
+    ::benchmark::DoNotOptimize(LeDataLengthChangeView::Create(view).IsValid());
+    completed_->Add();
+  }
+
+  void on_acl_ready() {
+    auto packet = hci_->GetAclQueueEnd()->TryDequeue();
+    ::benchmark::DoNotOptimize(packet->GetHandle());
+    completed_->Add();
+  }
+
+  // Inject |batch| copies of |bytes| per iteration and wait until all of them were handled
+  void RunEvents(State& state, const std::vector<uint8_t>& bytes) {
+    int64_t batch = state.range(0);
+    PacketCounters counters(state);
+    for (auto _ : state) {
+      for (int64_t i = 0; i < batch; i++) {
+        hal_->callbacks->hciEventReceived(bytes);
+      }
+      received_ += batch;
+      completed_->WaitFor(received_);
+    }
+    counters.Report(batch, bytes.size());
+  }
+
+  std::unique_ptr<TestModuleRegistry> registry_;
+  hal::TestHciHal* hal_ = nullptr;
+  HciLayer* hci_ = nullptr;
+  os::Thread* client_thread_ = nullptr;
+  os::Handler* client_handler_ = nullptr;
+  std::unique_ptr<CompletionCounter> completed_;
+  uint64_t received_ = 0;
+};
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(BM_HciLayer, event_dispatch)(State& state) {
+  hci_->RegisterEventHandler(
+      EventCode::LINK_SUPERVISION_TIMEOUT_CHANGED, client_handler_->BindOn(this, &BM_HciLayer::on_event));
+  RunEvents(state, GetPacketBytes(LinkSupervisionTimeoutChangedBuilder::Create(kHandle, 0x7d00)));
+  hci_->UnregisterEventHandler(EventCode::LINK_SUPERVISION_TIMEOUT_CHANGED);
+}
+
+BENCHMARK_REGISTER_F(BM_HciLayer, event_dispatch)->Arg(1)->Arg(100)->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_HciLayer, le_event_dispatch)(State& state) {
+  hci_->RegisterLeEventHandler(
+      SubeventCode::DATA_LENGTH_CHANGE, client_handler_->BindOn(this, &BM_HciLayer::on_le_event));
+  RunEvents(state, GetPacketBytes(LeDataLengthChangeBuilder::Create(kHandle, 251, 2120, 251, 2120)));
+  hci_->UnregisterLeEventHandler(SubeventCode::DATA_LENGTH_CHANGE);
+}
+
+BENCHMARK_REGISTER_F(BM_HciLayer, le_event_dispatch)->Arg(1)->Arg(100)->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_HciLayer, acl_receive_vary_by_packet_size)(State& state) {
+  constexpr int64_t kPacketsPerIteration = 100;
+  auto bytes = GetPacketBytes(AclBuilder::Create(
+      kHandle,
+      PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+      BroadcastFlag::POINT_TO_POINT,
+      std::make_unique<packet::RawBuilder>(std::vector<uint8_t>(state.range(0), 0xa5))));
+  hci_->GetAclQueueEnd()->RegisterDequeue(
+      client_handler_, common::Bind(&BM_HciLayer::on_acl_ready, common::Unretained(this)));
+
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < kPacketsPerIteration; i++) {
+      hal_->callbacks->aclDataReceived(bytes);
+    }
+    received_ += kPacketsPerIteration;
+    completed_->WaitFor(received_);
+  }
+  counters.Report(kPacketsPerIteration, bytes.size());
+
+  registry_->SynchronizeHandler(client_handler_, std::chrono::seconds(1));
+  hci_->GetAclQueueEnd()->UnregisterDequeue();
+}
+
+BENCHMARK_REGISTER_F(BM_HciLayer, acl_receive_vary_by_packet_size)->Arg(27)->Arg(251)->Arg(1021)->UseRealTime();
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -647,6 +647,61 @@ TEST_F(HciTest, receiveMultipleIsoPackets) {
   }
 }
 
+TEST_F(HciTest, receivePacketBatch) {
+  // Each packet sits behind its H4 type byte, as in a HAL receive buffer
+  auto make_slice = [](uint8_t h4_type, std::vector<uint8_t> bytes) {
+    bytes.insert(bytes.begin(), h4_type);
+    size_t size = bytes.size();
+    return hal::HciPacketSlice{
+        .buffer = std::make_shared<const std::vector<uint8_t>>(std::move(bytes)), .begin = 1, .end = size};
+  };
+  uint16_t handle = 0x0001;
+  const uint16_t num_packets = 4;
+  std::vector<hal::ReceivedHciPacket> batch;
+  for (uint16_t i = 0; i < num_packets; i++) {
+    auto acl_payload = std::make_unique<RawBuilder>();
+    acl_payload->AddOctets2(i);
+    batch.push_back(
+        {.type = hal::ReceivedHciPacket::Type::ACL,
+         .slice = make_slice(
+             0x02,
+             GetPacketBytes(AclBuilder::Create(
+                 handle,
+                 PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+                 BroadcastFlag::POINT_TO_POINT,
+                 std::move(acl_payload))))});
+    batch.push_back(
+        {.type = hal::ReceivedHciPacket::Type::EVENT,
+         .slice = make_slice(
+             0x04,
+             GetPacketBytes(LeConnectionCompleteBuilder::Create(
+                 ErrorCode::SUCCESS,
+                 i,
+                 Role::CENTRAL,
+                 AddressType::PUBLIC_DEVICE_ADDRESS,
+                 Address::kAny,
+                 0x0ABC,
+                 0x0123,
+                 0x0B05,
+                 ClockAccuracy::PPM_50)))});
+  }
+  hal->callbacks->hciPacketBatchReceived(std::move(batch));
+
+  for (uint16_t i = 0; i < num_packets; i++) {
+    auto event = upper->GetReceivedEvent();
+    ASSERT_TRUE(event.has_value());
+    auto connection_complete = LeConnectionCompleteView::Create(LeMetaEventView::Create(EventView::Create(*event)));
+    ASSERT_TRUE(connection_complete.IsValid());
+    ASSERT_EQ(i, connection_complete.GetConnectionHandle());
+
+    auto acl_opt = upper->GetReceivedAcl();
+    ASSERT_TRUE(acl_opt.has_value());
+    ASSERT_TRUE(acl_opt->IsValid());
+    auto itr = acl_opt->GetPayload().begin();
+    ASSERT_EQ(i, itr.extract<uint16_t>());
+  }
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
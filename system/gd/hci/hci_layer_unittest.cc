@@ -59,6 +59,7 @@ namespace hci {
 
 using common::BidiQueue;
 using common::BidiQueueEnd;
+using common::ContextualOnceCallback;
 using common::InitFlags;
 using os::fake_timer::fake_timerfd_advance;
 using packet::kLittleEndian;
@@ -435,5 +436,94 @@ TEST_F(HciLayerTest, command_status_callback_is_invoked_with_failure_status) {
   sync_handler();
 }
 
+class HciLayerPipeliningTest : public HciLayerTest {
+ protected:
+  void SetUp() override {
+    // The flag is read when the layer starts
+    InitFlags::Load(pipelining_flags_);
+    HciLayerTest::SetUp();
+    FailIfResetNotSent();
+  }
+
+  // Returns the op code of the next command sent to the HAL, or OpCode::NONE if there is none
+  OpCode GetSentOpCode() {
+    sync_handler();
+    auto sent_command = hal_->GetSentCommand(std::chrono::milliseconds(20));
+    return sent_command.has_value() ? sent_command->GetOpCode() : OpCode::NONE;
+  }
+
+  ContextualOnceCallback<void(CommandCompleteView)> OnComplete(std::promise<void> promise) {
+    return hci_handler_->BindOnce(
+        [](std::promise<void> promise, CommandCompleteView view) { promise.set_value(); }, std::move(promise));
+  }
+
+  const char* pipelining_flags_[2] = {"INIT_gd_hci_command_pipelining=true", nullptr};
+};
+
+TEST_F(HciLayerPipeliningTest, commands_are_sent_up_to_command_credits) {
+  // Nothing is sent along with the reset
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  hci_->EnqueueCommand(ReadLocalNameBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BD_ADDR);
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BUFFER_SIZE);
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(1, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_LOCAL_NAME);
+}
+
+TEST_F(HciLayerPipeliningTest, responses_are_matched_by_op_code) {
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  std::promise<void> bd_addr_promise;
+  auto bd_addr_future = bd_addr_promise.get_future();
+  std::promise<void> buffer_size_promise;
+  auto buffer_size_future = buffer_size_promise.get_future();
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), OnComplete(std::move(bd_addr_promise)));
+  hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(), OnComplete(std::move(buffer_size_promise)));
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BD_ADDR);
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BUFFER_SIZE);
+
+  // The controller completes them out of order
+  hal_->InjectEvent(ReadBufferSizeCompleteBuilder::Create(1, ErrorCode::SUCCESS, 0x400, 0x40, 8, 8));
+  ASSERT_EQ(buffer_size_future.wait_for(1s), std::future_status::ready);
+  ASSERT_EQ(bd_addr_future.wait_for(0s), std::future_status::timeout);
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(1, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(bd_addr_future.wait_for(1s), std::future_status::ready);
+}
+
+TEST_F(HciLayerPipeliningTest, dependent_commands_wait_for_outstanding_ones) {
+  hal_->InjectEvent(ResetCompleteBuilder::Create(5, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  hci_->EnqueueCommand(
+      LeClearFilterAcceptListBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  // Same op code as an outstanding command
+  hci_->EnqueueCommand(ReadBdAddrBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BD_ADDR);
+  ASSERT_EQ(GetSentOpCode(), OpCode::LE_CLEAR_FILTER_ACCEPT_LIST);
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(4, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(GetSentOpCode(), OpCode::READ_BD_ADDR);
+
+  // Filter accept list changes stay one at a time
+  hci_->EnqueueCommand(
+      LeClearFilterAcceptListBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+  hal_->InjectEvent(LeClearFilterAcceptListCompleteBuilder::Create(4, ErrorCode::SUCCESS));
+  ASSERT_EQ(GetSentOpCode(), OpCode::LE_CLEAR_FILTER_ACCEPT_LIST);
+
+  // A reset waits for every outstanding command
+  hci_->EnqueueCommand(ResetBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+  hal_->InjectEvent(ReadBdAddrCompleteBuilder::Create(4, ErrorCode::SUCCESS, Address::kAny));
+  ASSERT_EQ(GetSentOpCode(), OpCode::NONE);
+  hal_->InjectEvent(LeClearFilterAcceptListCompleteBuilder::Create(4, ErrorCode::SUCCESS));
+  ASSERT_EQ(GetSentOpCode(), OpCode::RESET);
+}
+
 }  // namespace hci
 }  // namespace bluetooth
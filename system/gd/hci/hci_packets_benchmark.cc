@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "hci/hci_packets.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+constexpr uint16_t kHandle = 0x0123;
+
+std::shared_ptr<std::vector<uint8_t>> Serialize(const packet::BasePacketBuilder& packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet.size());
+  packet::BitInserter i(*bytes);
+  packet.Serialize(i);
+  return bytes;
+}
+
+std::unique_ptr<AclBuilder> MakeAcl(size_t payload_size) {
+  return AclBuilder::Create(
+      kHandle,
+      PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+      BroadcastFlag::POINT_TO_POINT,
+      std::make_unique<packet::RawBuilder>(std::vector<uint8_t>(payload_size, 0xa5)));
+}
+
+void BM_HciPackets_acl_serialize_vary_by_payload_size(State& state) {
+  auto acl = MakeAcl(state.range(0));
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    auto bytes = Serialize(*acl);
+    ::benchmark::DoNotOptimize(bytes);
+  }
+  counters.Report(1, acl->size());
+}
+
+void BM_HciPackets_acl_parse_vary_by_payload_size(State& state) {
+  auto bytes = Serialize(*MakeAcl(state.range(0)));
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    auto view = AclView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+    ::benchmark::DoNotOptimize(view.IsValid());
+    ::benchmark::DoNotOptimize(view.GetPayload().size());
+  }
+  counters.Report(1, bytes->size());
+}
+
+void BM_HciPackets_le_meta_event_parse(State& state) {
+  auto bytes = Serialize(*LeDataLengthChangeBuilder::Create(kHandle, 251, 2120, 251, 2120));
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    // The same chain of views HciLayer and its clients build for every LE meta event
+    auto event = EventView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+    auto le_meta_event = LeMetaEventView::Create(event);
+    auto data_length_change = LeDataLengthChangeView::Create(le_meta_event);
+    ::benchmark::DoNotOptimize(data_length_change.IsValid());
+    ::benchmark::DoNotOptimize(data_length_change.GetMaxTxOctets());
+  }
+  counters.Report(1, bytes->size());
+}
+
+void BM_HciPackets_command_serialize(State& state) {
+  auto command = LeSetDataLengthBuilder::Create(kHandle, 251, 2120);
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    auto bytes = Serialize(*command);
+    ::benchmark::DoNotOptimize(bytes);
+  }
+  counters.Report(1, command->size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_HciPackets_acl_serialize_vary_by_payload_size)->Arg(27)->Arg(251)->Arg(1021);
+BENCHMARK(BM_HciPackets_acl_parse_vary_by_payload_size)->Arg(27)->Arg(251)->Arg(1021);
+BENCHMARK(BM_HciPackets_le_meta_event_parse);
+BENCHMARK(BM_HciPackets_command_serialize);
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+
+#include <cstdlib>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "common/bind.h"
+#include "common/latency_histogram.h"
+#include "common/task_stats.h"
+#include "hal/hci_hal_replay.h"
+#include "hci/hci_layer.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+constexpr char kCaptureVariable[] = "BT_HCI_REPLAY_CAPTURE";
+constexpr std::chrono::seconds kSynchronizeTimeout{10};
+
+std::chrono::nanoseconds GetProcessCpuTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// Replays the btsnoop capture named by BT_HCI_REPLAY_CAPTURE into HciLayer, with a client thread draining the data
+// queues. Besides the throughput it reports the process CPU time per replay, and the latency of each stage: the wait of
+// HAL packets for the HCI thread, the HCI tasks, and the ACL packets from the HAL to the client.
+class BM_HciReplay : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    const char* path = std::getenv(kCaptureVariable);
+    if (path == nullptr) {
+      return;
+    }
+    auto records = hal::ReadBtsnoopFile(path);
+    if (!records.has_value()) {
+      return;
+    }
+    for (const auto& record : *records) {
+      if (record.direction == hal::SnoopLogger::Direction::INCOMING) {
+        incoming_bytes_ += record.packet.size();
+      }
+    }
+
+    common::EnableTaskStats(true, std::chrono::milliseconds(100));
+    registry_ = std::make_unique<TestModuleRegistry>();
+    hal_ = new hal::ReplayHciHal(std::move(*records));
+    registry_->InjectTestModule(&hal::HciHal::Factory, hal_);
+    registry_->Start<HciLayer>(&registry_->GetTestThread());
+    hci_ = registry_->GetModuleUnderTest<HciLayer>();
+
+    client_thread_ = new os::Thread("client_thread", os::Thread::Priority::NORMAL);
+    client_handler_ = new os::Handler(client_thread_);
+    hci_->GetAclQueueEnd()->RegisterDequeue(
+        client_handler_, common::Bind(&BM_HciReplay::on_acl_ready, common::Unretained(this)));
+    hci_->GetScoQueueEnd()->RegisterDequeue(
+        client_handler_, common::Bind(&BM_HciReplay::on_sco_ready, common::Unretained(this)));
+    hci_->GetIsoQueueEnd()->RegisterDequeue(
+        client_handler_, common::Bind(&BM_HciReplay::on_iso_ready, common::Unretained(this)));
+  }
+
+  void TearDown(State& st) override {
+    if (registry_ != nullptr) {
+      registry_->SynchronizeHandler(client_handler_, kSynchronizeTimeout);
+      hci_->GetAclQueueEnd()->UnregisterDequeue();
+      hci_->GetScoQueueEnd()->UnregisterDequeue();
+      hci_->GetIsoQueueEnd()->UnregisterDequeue();
+      registry_->StopAll();
+      client_handler_->Clear();
+      delete client_handler_;
+      delete client_thread_;
+      registry_.reset();
+      hal_ = nullptr;
+      common::EnableTaskStats(false, std::chrono::milliseconds(100));
+    }
+    acl_latency_.Reset();
+    incoming_bytes_ = 0;
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void on_acl_ready() {
+    auto packet = hci_->GetAclQueueEnd()->TryDequeue();
+    auto received = packet->GetTimestamp();
+    if (received != std::chrono::steady_clock::time_point()) {
+      acl_latency_.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - received));
+    }
+  }
+
+  void on_sco_ready() {
+    ::benchmark::DoNotOptimize(hci_->GetScoQueueEnd()->TryDequeue());
+  }
+
+  void on_iso_ready() {
+    ::benchmark::DoNotOptimize(hci_->GetIsoQueueEnd()->TryDequeue());
+  }
+
+  static void ReportLatency(State& state, const std::string& stage, const common::LatencyHistogram& histogram) {
+    state.counters[stage + "_p50_us"] = histogram.Percentile(50).count();
+    state.counters[stage + "_p99_us"] = histogram.Percentile(99).count();
+    state.counters[stage + "_max_us"] = histogram.Max().count();
+  }
+
+  std::unique_ptr<TestModuleRegistry> registry_;
+  hal::ReplayHciHal* hal_ = nullptr;
+  HciLayer* hci_ = nullptr;
+  os::Thread* client_thread_ = nullptr;
+  os::Handler* client_handler_ = nullptr;
+  // Only touched on the client thread until the replays are over
+  common::LatencyHistogram acl_latency_;
+  size_t incoming_bytes_ = 0;
+};
+
+}  // namespace
+
+// The argument is the replay speed in percent of the recorded one, 0 replaying as fast as possible
+BENCHMARK_DEFINE_F(BM_HciReplay, replay)(State& state) {
+  if (hal_ == nullptr) {
+    state.SkipWithError("Set BT_HCI_REPLAY_CAPTURE to a readable btsnoop capture");
+    return;
+  }
+  double speed = state.range(0) / 100.0;
+  size_t packets = hal_->GetReplayedPacketCount();
+  auto cpu_start = GetProcessCpuTime();
+
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    hal_->Replay(speed);
+    registry_->SynchronizeModuleHandler(&HciLayer::Factory, kSynchronizeTimeout);
+    registry_->SynchronizeHandler(client_handler_, kSynchronizeTimeout);
+  }
+  counters.Report(packets, packets > 0 ? incoming_bytes_ / packets : 0);
+
+  auto cpu_time = GetProcessCpuTime() - cpu_start;
+  state.counters["process_cpu_ms_per_replay"] =
+      std::chrono::duration<double, std::milli>(cpu_time).count() / state.iterations();
+  state.counters["synthesized_responses"] = hal_->GetSynthesizedResponseCount();
+  const common::TaskStats& hci_thread = registry_->GetTestThread().GetTaskStats();
+  ReportLatency(state, "hci_wait", hci_thread.GetWaitHistogram());
+  ReportLatency(state, "hci_task", hci_thread.GetRunHistogram());
+  ReportLatency(state, "acl_to_client", acl_latency_);
+}
+
+BENCHMARK_REGISTER_F(BM_HciReplay, replay)->Arg(0)->Arg(100)->Arg(1000)->UseRealTime();
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -235,6 +235,9 @@ AddressWithType LeAddressManager::NewNonResolvableAddress() {
 
 void LeAddressManager::pause_registered_clients() {
   for (auto& client : registered_clients_) {
+    if (!needs_pause(client.first)) {
+      continue;
+    }
     switch (client.second) {
       case ClientState::PAUSED:
       case ClientState::WAITING_FOR_PAUSE:
@@ -248,9 +251,30 @@ void LeAddressManager::pause_registered_clients() {
   }
 }
 
-void LeAddressManager::push_command(Command command) {
+// Sends the command right away when it is the only one cached and none of the clients has to be paused for it
+void LeAddressManager::pause_or_handle_next_command() {
   pause_registered_clients();
+  if (cached_commands_.size() != 1) {
+    return;
+  }
+  for (auto client : registered_clients_) {
+    if (client.second != ClientState::RESUMED && client.second != ClientState::WAITING_FOR_RESUME) {
+      return;
+    }
+  }
+  handle_next_command();
+}
+
+bool LeAddressManager::needs_pause(LeAddressManagerCallback* client) const {
+  if (cached_commands_.empty() || host_address_commands_ != cached_commands_.size()) {
+    return true;
+  }
+  return client->UsesHostRandomAddress();
+}
+
+void LeAddressManager::push_command(Command command) {
   cached_commands_.push(std::move(command));
+  pause_registered_clients();
 }
 
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
@@ -260,6 +284,9 @@ void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
   }
   registered_clients_.find(callback)->second = ClientState::PAUSED;
   for (auto client : registered_clients_) {
+    if (!needs_pause(client.first)) {
+      continue;
+    }
     switch (client.second) {
       case ClientState::PAUSED:
         LOG_INFO("Client already in paused state");
@@ -293,6 +320,10 @@ void LeAddressManager::resume_registered_clients() {
 
   LOG_INFO("Resuming registered clients");
   for (auto& client : registered_clients_) {
+    if (client.second == ClientState::RESUMED) {
+      // Kept running while the random address of the host was rotated
+      continue;
+    }
     client.second = ClientState::WAITING_FOR_RESUME;
     client.first->OnResume();
   }
@@ -307,7 +338,8 @@ void LeAddressManager::ack_resume(LeAddressManagerCallback* callback) {
 void LeAddressManager::prepare_to_rotate() {
   Command command = {CommandType::ROTATE_RANDOM_ADDRESS, RotateRandomAddressCommand{}};
   cached_commands_.push(std::move(command));
-  pause_registered_clients();
+  host_address_commands_++;
+  pause_or_handle_next_command();
 }
 
 void LeAddressManager::schedule_rotate_random_address() {
@@ -348,11 +380,8 @@ void LeAddressManager::rotate_random_address() {
 void LeAddressManager::prepare_to_update_irk(UpdateIRKCommand update_irk_command) {
   Command command = {CommandType::UPDATE_IRK, update_irk_command};
   cached_commands_.push(std::move(command));
-  if (registered_clients_.empty()) {
-    handle_next_command();
-  } else {
-    pause_registered_clients();
-  }
+  host_address_commands_++;
+  pause_or_handle_next_command();
 }
 
 void LeAddressManager::update_irk(UpdateIRKCommand command) {
@@ -434,7 +463,7 @@ uint8_t LeAddressManager::GetResolvingListSize() {
 
 void LeAddressManager::handle_next_command() {
   for (auto client : registered_clients_) {
-    if (client.second != ClientState::PAUSED) {
+    if (client.second != ClientState::PAUSED && needs_pause(client.first)) {
       // make sure all client paused, if not, this function will be trigger again by ack_pause
       LOG_INFO("waiting for ack_pause, return");
       return;
@@ -444,6 +473,9 @@ void LeAddressManager::handle_next_command() {
   ASSERT(!cached_commands_.empty());
   auto command = std::move(cached_commands_.front());
   cached_commands_.pop();
+  if (!std::holds_alternative<HCICommand>(command.contents)) {
+    host_address_commands_--;
+  }
 
   std::visit(
       [this](auto&& command) {
@@ -656,12 +688,13 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
       break;
   }
 
-  handler_->BindOnceOn(this, &LeAddressManager::check_cached_commands).Invoke();
+  // Completions are delivered on handler_, so the next command of the sequence is sent without another hop
+  check_cached_commands();
 }
 
 void LeAddressManager::check_cached_commands() {
   for (auto client : registered_clients_) {
-    if (client.second != ClientState::PAUSED && !cached_commands_.empty()) {
+    if (client.second != ClientState::PAUSED && !cached_commands_.empty() && needs_pause(client.first)) {
       pause_registered_clients();
       return;
     }
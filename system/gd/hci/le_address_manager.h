@@ -36,6 +36,10 @@ class LeAddressManagerCallback {
   virtual void OnPause() = 0;
   virtual void OnResume() = 0;
   virtual void NotifyOnIRKChange(){};
+  // A client that doesn't use the random address of the host keeps running while only that address is rotated
+  virtual bool UsesHostRandomAddress() {
+    return true;
+  }
 };
 
 class LeAddressManager {
@@ -148,6 +152,8 @@ class LeAddressManager {
   };
 
   void pause_registered_clients();
+  void pause_or_handle_next_command();
+  bool needs_pause(LeAddressManagerCallback* client) const;
   void push_command(Command command);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
@@ -179,6 +185,8 @@ class LeAddressManager {
   uint8_t connect_list_size_;
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
+  // Cached commands that only change the random address of the host
+  size_t host_address_commands_{0};
   bool supports_ble_privacy_{false};
 };
 
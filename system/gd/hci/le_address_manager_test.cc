@@ -158,6 +158,22 @@ class RotatorClient : public LeAddressManagerCallback {
   std::unique_ptr<std::promise<void>> resume_promise_;
 };
 
+// Like an extended advertiser, which sets the random addresses of its sets itself
+class OwnAddressClient : public RotatorClient {
+ public:
+  using RotatorClient::RotatorClient;
+
+  bool UsesHostRandomAddress() override {
+    return false;
+  }
+
+  void NotifyOnIRKChange() override {
+    irk_changes++;
+  }
+
+  size_t irk_changes{0};
+};
+
 class LeAddressManagerTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -262,6 +278,51 @@ TEST_F(LeAddressManagerTest, rotator_non_resolvable_address_for_single_client) {
   sync_handler(handler_);
 }
 
+TEST_F(LeAddressManagerTest, irk_update_pauses_only_clients_using_host_address) {
+  Octet16 irk = {0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05, 0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  auto minimum_rotation_time = std::chrono::milliseconds(1000);
+  auto maximum_rotation_time = std::chrono::milliseconds(3000);
+  AddressWithType remote_address(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->SetPrivacyPolicyForInitiatorAddress(
+      LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS,
+      remote_address,
+      irk,
+      true,
+      minimum_rotation_time,
+      maximum_rotation_time);
+  test_hci_layer_->GetCommand(OpCode::LE_SET_RANDOM_ADDRESS);
+  test_hci_layer_->IncomingEvent(LeSetRandomAddressCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+
+  OwnAddressClient own_address_client(le_address_manager_, 1);
+  le_address_manager_->Register(clients[0].get());
+  le_address_manager_->Register(&own_address_client);
+  sync_handler(handler_);
+
+  irk[0] ^= 0xff;
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->SetPrivacyPolicyForInitiatorAddress(
+      LeAddressManager::AddressPolicy::USE_RESOLVABLE_ADDRESS,
+      remote_address,
+      irk,
+      true,
+      minimum_rotation_time,
+      maximum_rotation_time);
+  test_hci_layer_->GetCommand(OpCode::LE_SET_RANDOM_ADDRESS);
+  sync_handler(handler_);
+  ASSERT_TRUE(clients[0].get()->paused);
+  ASSERT_FALSE(own_address_client.paused);
+  ASSERT_EQ(own_address_client.irk_changes, 1u);
+
+  test_hci_layer_->IncomingEvent(LeSetRandomAddressCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+  ASSERT_FALSE(own_address_client.paused);
+
+  le_address_manager_->Unregister(clients[0].get());
+  le_address_manager_->Unregister(&own_address_client);
+  sync_handler(handler_);
+}
+
 // TODO handle the case "register during rotate_random_address" and enable this
 TEST_F(LeAddressManagerTest, DISABLED_rotator_address_for_multiple_clients) {
   AllocateClients(2);
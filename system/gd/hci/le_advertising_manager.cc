@@ -15,6 +15,7 @@
  */
 #include "hci/le_advertising_manager.h"
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 
@@ -842,7 +843,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
-  bool data_has_flags(std::vector<GapData> data) {
+  bool data_has_flags(const std::vector<GapData>& data) {
     for (auto& gap_data : data) {
       if (gap_data.data_type_ == GapDataType::FLAGS) {
         return true;
@@ -851,7 +852,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     return false;
   }
 
-  bool check_advertising_data(std::vector<GapData> data, bool include_flag) {
+  bool check_advertising_data(const std::vector<GapData>& data, bool include_flag) {
     uint16_t data_len = 0;
     // check data size
     for (size_t i = 0; i < data.size(); i++) {
@@ -875,7 +876,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     return true;
   };
 
-  bool check_extended_advertising_data(std::vector<GapData> data, bool include_flag) {
+  bool check_extended_advertising_data(const std::vector<GapData>& data, bool include_flag) {
     uint16_t data_len = 0;
     // check data size
     for (size_t i = 0; i < data.size(); i++) {
@@ -1022,7 +1023,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   }
 
   void send_data_fragment(
-      AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data, Operation operation) {
+      AdvertiserId advertiser_id, bool set_scan_rsp, const std::vector<GapData>& data, Operation operation) {
     if (operation == Operation::COMPLETE_ADVERTISEMENT || operation == Operation::LAST_FRAGMENT) {
       if (set_scan_rsp) {
         le_advertising_interface_->EnqueueCommand(
@@ -1097,6 +1098,11 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       } break;
     }
 
+    update_enabled_set(advertiser_id, enable, duration, max_extended_advertising_events);
+  }
+
+  void update_enabled_set(
+      AdvertiserId advertiser_id, bool enable, uint16_t duration, uint8_t max_extended_advertising_events) {
     if (enable) {
       enabled_sets_[advertiser_id].advertising_handle_ = advertiser_id;
       advertising_sets_[advertiser_id].duration = duration;
@@ -1110,6 +1116,96 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  // Enables or disables several sets at once. The extended API takes all of them in a single
+  // command, the other APIs fall back to one command per set.
+  void enable_advertisers(std::vector<EnabledSet> enabled_sets, bool enable) {
+    if (enabled_sets.empty()) {
+      return;
+    }
+
+    if (advertising_api_type_ != AdvertisingApiType::EXTENDED) {
+      for (const auto& enabled_set : enabled_sets) {
+        enable_advertiser(
+            enabled_set.advertising_handle_,
+            enable,
+            enabled_set.duration_,
+            enabled_set.max_extended_advertising_events_);
+      }
+      return;
+    }
+
+    Enable enable_value = enable ? Enable::ENABLED : Enable::DISABLED;
+    le_advertising_interface_->EnqueueCommand(
+        hci::LeSetExtendedAdvertisingEnableBuilder::Create(enable_value, enabled_sets),
+        module_handler_->BindOnceOn(
+            this,
+            &impl::on_set_extended_advertising_enable_complete<LeSetExtendedAdvertisingEnableCompleteView>,
+            enable,
+            enabled_sets,
+            true /* trigger callbacks */));
+
+    for (const auto& enabled_set : enabled_sets) {
+      update_enabled_set(
+          enabled_set.advertising_handle_,
+          enable,
+          enabled_set.duration_,
+          enabled_set.max_extended_advertising_events_);
+    }
+  }
+
+  // Applies the updates of several sets with as few commands as possible. Sets being disabled are
+  // disabled first with a single command, so that their parameters can be changed, and sets being
+  // enabled are enabled last with a single command, once their parameters and data are queued.
+  // All the commands are queued back to back without waiting for each other's completion.
+  void update_advertisers(std::vector<AdvertisingSetUpdate> updates) {
+    std::vector<EnabledSet> sets_to_disable;
+    std::vector<EnabledSet> sets_to_enable;
+
+    updates.erase(
+        std::remove_if(
+            updates.begin(),
+            updates.end(),
+            [this](const AdvertisingSetUpdate& update) {
+              if (advertising_sets_.count(update.advertiser_id) == 0) {
+                LOG_WARN("No advertising set with key: %d", update.advertiser_id);
+                return true;
+              }
+              return false;
+            }),
+        updates.end());
+
+    for (const auto& update : updates) {
+      if (!update.enable.has_value()) {
+        continue;
+      }
+      EnabledSet curr_set;
+      curr_set.advertising_handle_ = update.advertiser_id;
+      curr_set.duration_ = update.duration;
+      curr_set.max_extended_advertising_events_ = update.max_extended_advertising_events;
+      if (*update.enable) {
+        sets_to_enable.push_back(curr_set);
+      } else {
+        sets_to_disable.push_back(curr_set);
+      }
+    }
+
+    enable_advertisers(std::move(sets_to_disable), false);
+
+    for (auto& update : updates) {
+      if (update.parameters.has_value()) {
+        set_parameters(update.advertiser_id, std::move(*update.parameters));
+      }
+      if (update.advertising_data.has_value()) {
+        set_data(update.advertiser_id, false, std::move(*update.advertising_data));
+      }
+      if (update.scan_response.has_value()) {
+        set_data(update.advertiser_id, true, std::move(*update.scan_response));
+      }
+    }
+
+    enable_advertisers(std::move(sets_to_enable), true);
+  }
+
   void set_periodic_parameter(
       AdvertiserId advertiser_id, PeriodicAdvertisingParameters periodic_advertising_parameters) {
     uint8_t include_tx_power = periodic_advertising_parameters.properties >>
@@ -1173,7 +1269,8 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
-  void send_periodic_data_fragment(AdvertiserId advertiser_id, std::vector<GapData> data, Operation operation) {
+  void send_periodic_data_fragment(
+      AdvertiserId advertiser_id, const std::vector<GapData>& data, Operation operation) {
     if (operation == Operation::COMPLETE_ADVERTISEMENT || operation == Operation::LAST_FRAGMENT) {
       le_advertising_interface_->EnqueueCommand(
           hci::LeSetPeriodicAdvertisingDataBuilder::Create(advertiser_id, operation, data),
@@ -1318,6 +1415,12 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     le_address_manager_->AckResume(this);
   }
 
+  // Extended advertising sets are given random addresses of their own, which the rotation of the host address doesn't
+  // touch
+  bool UsesHostRandomAddress() override {
+    return advertising_api_type_ != AdvertisingApiType::EXTENDED;
+  }
+
   // Note: this needs to be synchronous (i.e. NOT on a handler) for two reasons:
   // 1. For parity with OnPause() and OnResume()
   // 2. If we don't enqueue our HCI commands SYNCHRONOUSLY, then it is possible that we OnResume() in addressManager
@@ -1753,7 +1856,7 @@ void LeAdvertisingManager::SetParameters(AdvertiserId advertiser_id, Advertising
 }
 
 void LeAdvertisingManager::SetData(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
-  CallOn(pimpl_.get(), &impl::set_data, advertiser_id, set_scan_rsp, data);
+  CallOn(pimpl_.get(), &impl::set_data, advertiser_id, set_scan_rsp, std::move(data));
 }
 
 void LeAdvertisingManager::EnableAdvertiser(
@@ -1761,13 +1864,17 @@ void LeAdvertisingManager::EnableAdvertiser(
   CallOn(pimpl_.get(), &impl::enable_advertiser, advertiser_id, enable, duration, max_extended_advertising_events);
 }
 
+void LeAdvertisingManager::UpdateAdvertisers(std::vector<AdvertisingSetUpdate> updates) {
+  CallOn(pimpl_.get(), &impl::update_advertisers, std::move(updates));
+}
+
 void LeAdvertisingManager::SetPeriodicParameters(
     AdvertiserId advertiser_id, PeriodicAdvertisingParameters periodic_advertising_parameters) {
   CallOn(pimpl_.get(), &impl::set_periodic_parameter, advertiser_id, periodic_advertising_parameters);
 }
 
 void LeAdvertisingManager::SetPeriodicData(AdvertiserId advertiser_id, std::vector<GapData> data) {
-  CallOn(pimpl_.get(), &impl::set_periodic_data, advertiser_id, data);
+  CallOn(pimpl_.get(), &impl::set_periodic_data, advertiser_id, std::move(data));
 }
 
 void LeAdvertisingManager::EnablePeriodicAdvertising(AdvertiserId advertiser_id, bool enable, bool include_adi) {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -74,6 +75,18 @@ class AdvertisingConfig {
 
 using AdvertiserId = uint8_t;
 
+// Changes to apply to one advertising set as part of LeAdvertisingManager::UpdateAdvertisers().
+// Fields left empty are not changed.
+struct AdvertisingSetUpdate {
+  AdvertiserId advertiser_id;
+  std::optional<AdvertisingConfig> parameters;
+  std::optional<std::vector<GapData>> advertising_data;
+  std::optional<std::vector<GapData>> scan_response;
+  std::optional<bool> enable;
+  uint16_t duration = 0;
+  uint8_t max_extended_advertising_events = 0;
+};
+
 class AdvertisingCallback {
  public:
   enum AdvertisingStatus {
@@ -142,6 +155,10 @@ class LeAdvertisingManager : public bluetooth::Module {
   void EnableAdvertiser(
       AdvertiserId advertiser_id, bool enable, uint16_t duration, uint8_t max_extended_advertising_events);
 
+  // Applies parameter, data, scan response and enable changes to several sets at once. With the
+  // extended advertising API all the sets are disabled and enabled with a single command each.
+  void UpdateAdvertisers(std::vector<AdvertisingSetUpdate> updates);
+
   void SetPeriodicParameters(AdvertiserId advertiser_id, PeriodicAdvertisingParameters periodic_advertising_parameters);
 
   void SetPeriodicData(AdvertiserId advertiser_id, std::vector<GapData> data);
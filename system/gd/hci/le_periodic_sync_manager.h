@@ -15,8 +15,12 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
 #include "common/callback.h"
@@ -35,6 +39,8 @@ namespace hci {
 
 constexpr std::chrono::duration kPeriodicSyncTimeout = std::chrono::seconds(30);
 constexpr int kMaxSyncTransactions = 16;
+// Periodic advertising data is at most 1650 bytes, however many reports it is fragmented in
+constexpr size_t kMaxPeriodicAdvertisingDataLength = 1650;
 
 enum PeriodicSyncState : int {
   PERIODIC_SYNC_STATE_IDLE = 0,
@@ -69,6 +75,9 @@ struct PendingPeriodicSyncRequest {
         sync_timeout(sync_timeout),
         sync_timeout_alarm(handler) {}
   bool busy = false;
+  // Periodic advertiser list mode: waiting to be removed from the list, and whether it was because of a timeout
+  bool abandoned = false;
+  bool timed_out = false;
   uint8_t advertiser_sid;
   AddressWithType address_with_type;
   uint16_t skip;
@@ -81,9 +90,22 @@ class PeriodicSyncManager {
   explicit PeriodicSyncManager(ScanningCallback* callbacks)
       : le_scanning_interface_(nullptr), handler_(nullptr), callbacks_(callbacks), sync_received_callback_id(0) {}
 
-  void Init(hci::LeScanningInterface* le_scanning_interface, os::Handler* handler) {
+  // With a periodic advertiser list of more than one entry, up to that many sync requests are pending at once: they
+  // go in the list, and a single create sync synchronizes to whichever advertiser is found first.
+  void Init(
+      hci::LeScanningInterface* le_scanning_interface,
+      os::Handler* handler,
+      uint8_t periodic_advertiser_list_size = 0) {
     le_scanning_interface_ = le_scanning_interface;
     handler_ = handler;
+    periodic_advertiser_list_size_ = std::min<uint8_t>(periodic_advertiser_list_size, kMaxSyncTransactions);
+  }
+
+  // Drops the complete periodic advertising reports which carry the same data as the previous one of their sync, and
+  // the BIGInfo reports which don't change the encryption of their BIG. Advertisers repeat unchanged data (BASE,
+  // BIGInfo) every periodic advertising interval.
+  void SetDuplicateReportFiltering(bool enable) {
+    filter_duplicate_reports_ = enable;
   }
 
   void SetScanningCallback(ScanningCallback* callbacks) {
@@ -123,6 +145,7 @@ class PeriodicSyncManager {
       return;
     };
     periodic_syncs_.erase(periodic_sync);
+    report_states_.erase(handle);
     le_scanning_interface_->EnqueueCommand(
         hci::LePeriodicAdvertisingTerminateSyncBuilder::Create(handle),
         handler_->BindOnceOn(this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
@@ -136,7 +159,14 @@ class PeriodicSyncManager {
       return;
     }
 
-    if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
+    if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING && UsesPeriodicAdvertiserList()) {
+      LOG_WARN("[PSync]: Sync state is pending");
+      auto request = GetPendingSyncFromAddressAndSid(address, adv_sid);
+      if (request != pending_sync_requests_.end()) {
+        request->abandoned = true;
+        CancelListCreateSync();
+      }
+    } else if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
       LOG_WARN("[PSync]: Sync state is pending");
       le_scanning_interface_->EnqueueCommand(
           hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
@@ -272,6 +302,16 @@ class PeriodicSyncManager {
     if (pending_sync_request != pending_sync_requests_.end()) {
       pending_sync_request->sync_timeout_alarm.Cancel();
     }
+    if (UsesPeriodicAdvertiserList()) {
+      // Whatever the status, the create sync is over
+      list_create_sync_pending_ = false;
+      list_create_sync_cancelling_ = false;
+      if (pending_sync_request != pending_sync_requests_.end() &&
+          event_view.GetStatus() != ErrorCode::OPERATION_CANCELLED_BY_HOST) {
+        RemoveFromPeriodicAdvertiserList(*pending_sync_request);
+        pending_sync_requests_.erase(pending_sync_request);
+      }
+    }
 
     auto address_with_type = AddressWithType(event_view.GetAdvertiserAddress(), event_view.GetAdvertiserAddressType());
     auto peer_address_type = address_with_type.GetAddressType();
@@ -298,7 +338,7 @@ class PeriodicSyncManager {
             handler_->BindOnceOn(
                 this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
       }
-      AdvanceRequest();
+      OnSyncEstablishmentDone();
       return;
     }
     periodic_sync->sync_handle = event_view.GetSyncHandle();
@@ -311,7 +351,7 @@ class PeriodicSyncManager {
         address_with_type,
         (uint16_t)event_view.GetAdvertiserPhy(),
         event_view.GetPeriodicAdvertisingInterval());
-    AdvanceRequest();
+    OnSyncEstablishmentDone();
   }
 
   void HandleLePeriodicAdvertisingReport(LePeriodicAdvertisingReportView event_view) {
@@ -332,13 +372,36 @@ class PeriodicSyncManager {
       LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
       return;
     }
+
+    // Fragments are reassembled into the buffer of their sync, which keeps its capacity from one report to the next,
+    // and delivered in a single report
+    auto& report_state = report_states_[sync_handle];
+    auto data_status = event_view.GetDataStatus();
+    auto data = event_view.GetData();
+    if (data_status == DataStatus::CONTINUING || !report_state.data.empty()) {
+      if (report_state.data.capacity() == 0) {
+        report_state.data.reserve(kMaxPeriodicAdvertisingDataLength);
+      }
+      report_state.data.insert(report_state.data.end(), data.begin(), data.end());
+      if (data_status == DataStatus::CONTINUING) {
+        return;
+      }
+      data.assign(report_state.data.begin(), report_state.data.end());
+      report_state.data.clear();
+    }
+
+    if (filter_duplicate_reports_ && data_status == DataStatus::COMPLETE) {
+      size_t hash = std::hash<std::string_view>{}(
+          std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+      if (report_state.last_data_hash == hash) {
+        return;
+      }
+      report_state.last_data_hash = hash;
+    }
+
     LOG_DEBUG("%s", "[PSync]: invoking callback");
     callbacks_->OnPeriodicSyncReport(
-        sync_handle,
-        event_view.GetTxPower(),
-        event_view.GetRssi(),
-        (uint16_t)event_view.GetDataStatus(),
-        event_view.GetData());
+        sync_handle, event_view.GetTxPower(), event_view.GetRssi(), (uint16_t)data_status, std::move(data));
   }
 
   void HandleLePeriodicAdvertisingSyncLost(LePeriodicAdvertisingSyncLostView event_view) {
@@ -348,6 +411,7 @@ class PeriodicSyncManager {
     callbacks_->OnPeriodicSyncLost(sync_handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(sync_handle);
     periodic_syncs_.erase(periodic_sync);
+    report_states_.erase(sync_handle);
   }
 
   void HandleLePeriodicAdvertisingSyncTransferReceived(LePeriodicAdvertisingSyncTransferReceivedView event_view) {
@@ -418,8 +482,16 @@ class PeriodicSyncManager {
       LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
       return;
     }
+    bool encrypted = event_view.GetEncryption() == Enable::ENABLED;
+    if (filter_duplicate_reports_) {
+      auto& report_state = report_states_[sync_handle];
+      if (report_state.last_big_info_encrypted == encrypted) {
+        return;
+      }
+      report_state.last_big_info_encrypted = encrypted;
+    }
     LOG_DEBUG("%s", "[PSync]: invoking callback");
-    callbacks_->OnBigInfoReport(sync_handle, event_view.GetEncryption() == Enable::ENABLED ? true : false);
+    callbacks_->OnBigInfoReport(sync_handle, encrypted);
   }
 
  private:
@@ -494,6 +566,10 @@ class PeriodicSyncManager {
   }
 
   void HandleNextRequest() {
+    if (UsesPeriodicAdvertiserList()) {
+      HandleNextListRequests();
+      return;
+    }
     if (pending_sync_requests_.empty()) {
       LOG_DEBUG("pending_sync_requests_ empty");
       return;
@@ -525,6 +601,146 @@ class PeriodicSyncManager {
     HandleNextRequest();
   }
 
+  bool UsesPeriodicAdvertiserList() const {
+    return periodic_advertiser_list_size_ > 1;
+  }
+
+  void OnSyncEstablishmentDone() {
+    if (UsesPeriodicAdvertiserList()) {
+      RemoveAbandonedListRequests();
+      HandleNextListRequests();
+    } else {
+      AdvanceRequest();
+    }
+  }
+
+  // Moves waiting requests into the periodic advertiser list, then synchronizes to any advertiser of the list. The
+  // list can only change while no create sync is pending.
+  void HandleNextListRequests() {
+    size_t listed = 0;
+    if (list_create_sync_pending_) {
+      // Make room for new requests as soon as the list has some, instead of after the current create sync
+      for (auto& request : pending_sync_requests_) {
+        listed += request.busy ? 1 : 0;
+      }
+      if (listed < periodic_advertiser_list_size_ && listed < pending_sync_requests_.size()) {
+        CancelListCreateSync();
+      }
+      return;
+    }
+    for (auto& request : pending_sync_requests_) {
+      if (!request.busy && listed < periodic_advertiser_list_size_) {
+        AddToPeriodicAdvertiserList(request);
+      }
+      listed += request.busy ? 1 : 0;
+    }
+    if (listed == 0) {
+      LOG_DEBUG("pending_sync_requests_ empty");
+      return;
+    }
+
+    // The list shares the skip and timeout of the oldest request
+    auto& oldest = pending_sync_requests_.front();
+    PeriodicAdvertisingOptions options;
+    options.use_periodic_advertiser_list_ = 1;
+    auto sync_cte_type =
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOA_CONSTANT_TONE_EXTENSION) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_ONE_US_SLOTS) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_TWO_US_SLOTS);
+    list_create_sync_pending_ = true;
+    le_scanning_interface_->EnqueueCommand(
+        hci::LePeriodicAdvertisingCreateSyncBuilder::Create(
+            options,
+            0,
+            AdvertisingAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+            Address::kEmpty,
+            oldest.skip,
+            oldest.sync_timeout,
+            sync_cte_type),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncStatus));
+  }
+
+  void AddToPeriodicAdvertiserList(PendingPeriodicSyncRequest& request) {
+    LOG_INFO(
+        "executing sync request SID=%04X, bd_addr=%s",
+        request.advertiser_sid,
+        ADDRESS_TO_LOGGABLE_CSTR(request.address_with_type));
+    request.busy = true;
+    auto sync = GetSyncFromAddressWithTypeAndSid(request.address_with_type, request.advertiser_sid);
+    if (sync != periodic_syncs_.end()) {
+      sync->sync_state = PERIODIC_SYNC_STATE_PENDING;
+    }
+    le_scanning_interface_->EnqueueCommand(
+        hci::LeAddDeviceToPeriodicAdvertiserListBuilder::Create(
+            static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+            request.address_with_type.GetAddress(),
+            request.advertiser_sid),
+        handler_->BindOnceOn(
+            this, &PeriodicSyncManager::check_status<LeAddDeviceToPeriodicAdvertiserListCompleteView>));
+    request.sync_timeout_alarm.Schedule(
+        base::BindOnce(
+            &PeriodicSyncManager::OnListRequestTimeout,
+            base::Unretained(this),
+            request.advertiser_sid,
+            request.address_with_type.GetAddress()),
+        kPeriodicSyncTimeout);
+  }
+
+  void RemoveFromPeriodicAdvertiserList(const PendingPeriodicSyncRequest& request) {
+    le_scanning_interface_->EnqueueCommand(
+        hci::LeRemoveDeviceFromPeriodicAdvertiserListBuilder::Create(
+            static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+            request.address_with_type.GetAddress(),
+            request.advertiser_sid),
+        handler_->BindOnceOn(
+            this, &PeriodicSyncManager::check_status<LeRemoveDeviceFromPeriodicAdvertiserListCompleteView>));
+  }
+
+  void OnListRequestTimeout(uint8_t advertiser_sid, Address address) {
+    auto request = GetPendingSyncFromAddressAndSid(address, advertiser_sid);
+    if (request == pending_sync_requests_.end()) {
+      return;
+    }
+    LOG_WARN(
+        "%s: sync timeout SID=%04X, bd_addr=%s",
+        __func__,
+        request->advertiser_sid,
+        ADDRESS_TO_LOGGABLE_CSTR(request->address_with_type));
+    request->abandoned = true;
+    request->timed_out = true;
+    CancelListCreateSync();
+  }
+
+  // The controller answers the cancel with a sync established event, after which the abandoned requests leave the list
+  void CancelListCreateSync() {
+    if (!list_create_sync_pending_ || list_create_sync_cancelling_) {
+      return;
+    }
+    list_create_sync_cancelling_ = true;
+    le_scanning_interface_->EnqueueCommand(
+        hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncCancelStatus));
+  }
+
+  void RemoveAbandonedListRequests() {
+    auto it = pending_sync_requests_.begin();
+    while (it != pending_sync_requests_.end()) {
+      if (!it->busy || !it->abandoned) {
+        ++it;
+        continue;
+      }
+      RemoveFromPeriodicAdvertiserList(*it);
+      auto sync = GetSyncFromAddressWithTypeAndSid(it->address_with_type, it->advertiser_sid);
+      if (it->timed_out && sync != periodic_syncs_.end()) {
+        int status = static_cast<int>(ErrorCode::ADVERTISING_TIMEOUT);
+        callbacks_->OnPeriodicSyncStarted(
+            sync->request_id, status, 0, sync->advertiser_sid, it->address_with_type, 0, 0);
+        RemoveSyncRequest(sync);
+      }
+      it = pending_sync_requests_.erase(it);
+    }
+  }
+
   void CleanUpRequest(uint8_t advertiser_sid, Address address) {
     auto it = pending_sync_requests_.begin();
     while (it != pending_sync_requests_.end()) {
@@ -547,6 +763,18 @@ class PeriodicSyncManager {
   std::list<PendingPeriodicSyncRequest> pending_sync_requests_;
   std::list<PeriodicSyncStates> periodic_syncs_;
   std::list<PeriodicSyncTransferStates> periodic_sync_transfers_;
+  uint8_t periodic_advertiser_list_size_ = 0;
+  bool list_create_sync_pending_ = false;
+  bool list_create_sync_cancelling_ = false;
+
+  struct ReportState {
+    std::vector<uint8_t> data;
+    std::optional<size_t> last_data_hash;
+    std::optional<bool> last_big_info_encrypted;
+  };
+  std::unordered_map<uint16_t, ReportState> report_states_;
+  bool filter_duplicate_reports_ = false;
+
   bool sync_received_callback_registered_ = false;
   int sync_received_callback_id{};
 };
@@ -25,6 +25,7 @@
 #include "os/handler.h"
 
 using namespace std::chrono_literals;
+using ::testing::_;
 
 namespace bluetooth {
 namespace hci {
@@ -646,6 +647,190 @@ TEST_F(PeriodicSyncManagerTest, handle_biginfo_advertising_report_test) {
   sync_handler();
 }
 
+LePeriodicAdvertisingSyncEstablishedView SyncEstablished(
+    ErrorCode status, uint16_t sync_handle, uint8_t advertiser_sid, AddressWithType address_with_type) {
+  auto builder = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      status,
+      sync_handle,
+      advertiser_sid,
+      address_with_type.GetAddressType(),
+      address_with_type.GetAddress(),
+      SecondaryPhyType::LE_1M,
+      0xFF,
+      ClockAccuracy::PPM_250);
+  return LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+}
+
+LePeriodicAdvertisingReportView PeriodicReport(uint16_t sync_handle, DataStatus status, std::vector<uint8_t> data) {
+  auto builder = LePeriodicAdvertisingReportBuilder::Create(
+      sync_handle, 0x1a, 0x1a, CteType::AOA_CONSTANT_TONE_EXTENSION, status, data);
+  return LePeriodicAdvertisingReportView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder)))));
+}
+
+TEST_F(PeriodicSyncManagerTest, fragmented_periodic_advertising_report_test) {
+  uint16_t sync_handle = 0x12;
+  uint8_t advertiser_sid = 0x02;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  AddressWithType address_with_type = AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  PeriodicSyncStates request{
+      .request_id = 0x01,
+      .advertiser_sid = advertiser_sid,
+      .address_with_type = address_with_type,
+      .sync_handle = sync_handle,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+  periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(
+      SyncEstablished(ErrorCode::SUCCESS, sync_handle, advertiser_sid, address_with_type));
+
+  // The fragments are delivered as a single report
+  std::vector<uint8_t> data = {0x01, 0x02, 0x03, 0x04, 0x05};
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnPeriodicSyncReport(sync_handle, 0x1a, 0x1a, static_cast<uint8_t>(DataStatus::COMPLETE), data))
+      .Times(1);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::CONTINUING, {0x01, 0x02}));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::CONTINUING, {0x03, 0x04}));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::COMPLETE, {0x05}));
+  testing::Mock::VerifyAndClearExpectations(&mock_callbacks_);
+
+  // Without duplicate filtering, the same data is reported again
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnPeriodicSyncReport(sync_handle, 0x1a, 0x1a, static_cast<uint8_t>(DataStatus::COMPLETE), data))
+      .Times(1);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(PeriodicReport(sync_handle, DataStatus::COMPLETE, data));
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, duplicate_report_filtering_test) {
+  uint16_t sync_handle = 0x12;
+  uint8_t advertiser_sid = 0x02;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  AddressWithType address_with_type = AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  PeriodicSyncStates request{
+      .request_id = 0x01,
+      .advertiser_sid = advertiser_sid,
+      .address_with_type = address_with_type,
+      .sync_handle = sync_handle,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  periodic_sync_manager_->SetDuplicateReportFiltering(true);
+  ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+  periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(
+      SyncEstablished(ErrorCode::SUCCESS, sync_handle, advertiser_sid, address_with_type));
+
+  std::vector<uint8_t> base = {0x01, 0x02, 0x03};
+  std::vector<uint8_t> updated_base = {0x01, 0x02, 0x04};
+  {
+    testing::InSequence s;
+    EXPECT_CALL(mock_callbacks_, OnPeriodicSyncReport(sync_handle, _, _, _, base)).Times(1);
+    EXPECT_CALL(mock_callbacks_, OnPeriodicSyncReport(sync_handle, _, _, _, updated_base)).Times(1);
+  }
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(PeriodicReport(sync_handle, DataStatus::COMPLETE, base));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(PeriodicReport(sync_handle, DataStatus::COMPLETE, base));
+  // Same data, fragmented differently
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::CONTINUING, {0x01}));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::COMPLETE, {0x02, 0x03}));
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(
+      PeriodicReport(sync_handle, DataStatus::COMPLETE, updated_base));
+
+  // Only changes of the BIGInfo encryption are reported
+  EXPECT_CALL(mock_callbacks_, OnBigInfoReport(sync_handle, true)).Times(1);
+  for (int i = 0; i < 3; i++) {
+    auto builder = LeBigInfoAdvertisingReportBuilder::Create(
+        sync_handle,
+        2,
+        9,
+        24,
+        3,
+        1,
+        2,
+        100,
+        10000,
+        100,
+        static_cast<SecondaryPhyType>(2),
+        static_cast<Enable>(0),
+        Enable::ENABLED);
+    periodic_sync_manager_->HandleLeBigInfoAdvertisingReport(LeBigInfoAdvertisingReportView::Create(
+        LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder))))));
+  }
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, periodic_advertiser_list_test) {
+  periodic_sync_manager_->Init(test_le_scanning_interface_, handler_, 2);
+  uint16_t sync_handle = 0x12;
+  Address address_1, address_2;
+  Address::FromString("00:11:22:33:44:55", address_1);
+  Address::FromString("00:11:22:33:44:66", address_2);
+  AddressWithType address_with_type_1 = AddressWithType(address_1, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType address_with_type_2 = AddressWithType(address_2, AddressType::PUBLIC_DEVICE_ADDRESS);
+  PeriodicSyncStates request_1{
+      .request_id = 0x01,
+      .advertiser_sid = 0x02,
+      .address_with_type = address_with_type_1,
+      .sync_handle = 0,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  PeriodicSyncStates request_2{
+      .request_id = 0x02,
+      .advertiser_sid = 0x03,
+      .address_with_type = address_with_type_2,
+      .sync_handle = 0,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+
+  ASSERT_NO_FATAL_FAILURE(test_le_scanning_interface_->SetCommandFuture());
+  periodic_sync_manager_->StartSync(request_1, 0x04, 0x0A);
+  auto add = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(
+      test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST)));
+  ASSERT_TRUE(add.IsValid());
+  ASSERT_EQ(address_1, add.GetAdvertiserAddress());
+  auto create_sync = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(
+      test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC)));
+  ASSERT_TRUE(create_sync.IsValid());
+  ASSERT_EQ(1, create_sync.GetOptions().use_periodic_advertiser_list_);
+
+  // The list has room for the second request: the pending create sync is restarted with both advertisers
+  periodic_sync_manager_->StartSync(request_2, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC_CANCEL);
+  auto no_address = AddressWithType(Address::kEmpty, AddressType::PUBLIC_DEVICE_ADDRESS);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(
+      SyncEstablished(ErrorCode::OPERATION_CANCELLED_BY_HOST, 0, 0, no_address));
+  add = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(
+      test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST)));
+  ASSERT_TRUE(add.IsValid());
+  ASSERT_EQ(address_2, add.GetAdvertiserAddress());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+
+  // The second advertiser is found first, the first one stays in the list
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted(0x02, 0, sync_handle, 0x03, _, _, _)).Times(1);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(
+      SyncEstablished(ErrorCode::SUCCESS, sync_handle, 0x03, address_with_type_2));
+  auto remove = LeRemoveDeviceFromPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(
+      test_le_scanning_interface_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_PERIODIC_ADVERTISER_LIST)));
+  ASSERT_TRUE(remove.IsValid());
+  ASSERT_EQ(address_2, remove.GetAdvertiserAddress());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  sync_handler();
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
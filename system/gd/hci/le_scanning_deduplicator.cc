@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/le_scanning_deduplicator.h"
+
+#include <cstdlib>
+
+#include "os/log.h"
+
+namespace bluetooth::hci {
+
+LeScanningDeduplicator::LeScanningDeduplicator(size_t maximum_entries) : maximum_entries_(maximum_entries) {
+  ASSERT(maximum_entries > 0);
+}
+
+void LeScanningDeduplicator::SetParameters(std::chrono::milliseconds report_window, uint8_t rssi_threshold) {
+  report_window_ = report_window;
+  rssi_threshold_ = rssi_threshold;
+  if (!IsEnabled()) {
+    entries_.clear();
+  }
+}
+
+bool LeScanningDeduplicator::ShouldReport(
+    uint16_t event_type,
+    uint8_t address_type,
+    Address address,
+    uint8_t advertising_sid,
+    int8_t rssi,
+    const std::vector<uint8_t>& advertising_data,
+    std::chrono::steady_clock::time_point now) {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  ReportKey key{event_type, address_type, address, advertising_sid, HashAdvertisingData(advertising_data)};
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    bool in_window = now - it->second.delivered_at < report_window_;
+    bool rssi_changed = rssi_threshold_ != 0 && std::abs(rssi - it->second.rssi) >= rssi_threshold_;
+    if (in_window && !rssi_changed) {
+      return false;
+    }
+    it->second = {now, rssi};
+    return true;
+  }
+
+  // Make room for the new advertiser. When all the entries are recent
+  // the table is reset, which at worst lets a few duplicates through.
+  if (entries_.size() >= maximum_entries_) {
+    RemoveExpiredEntries(now);
+    if (entries_.size() >= maximum_entries_) {
+      LOG_DEBUG("Too many advertisers tracked, resetting");
+      entries_.clear();
+    }
+  }
+  entries_.emplace(key, ReportEntry{now, rssi});
+  return true;
+}
+
+void LeScanningDeduplicator::RemoveExpiredEntries(std::chrono::steady_clock::time_point now) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (now - it->second.delivered_at >= report_window_) {
+      it = entries_.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+/// FNV-1a hash of the advertising data. Different payloads of the same
+/// advertiser colliding only cost a missed report within the window.
+uint64_t LeScanningDeduplicator::HashAdvertisingData(const std::vector<uint8_t>& advertising_data) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (uint8_t byte : advertising_data) {
+    hash ^= byte;
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+bool LeScanningDeduplicator::ReportKey::operator==(const ReportKey& other) const {
+  return event_type == other.event_type && address_type == other.address_type && address == other.address &&
+         advertising_sid == other.advertising_sid && advertising_data_hash == other.advertising_data_hash;
+}
+
+size_t LeScanningDeduplicator::ReportKeyHash::operator()(const ReportKey& key) const {
+  size_t hash = std::hash<Address>{}(key.address);
+  hash = hash * 31 + key.event_type;
+  hash = hash * 31 + key.address_type;
+  hash = hash * 31 + key.advertising_sid;
+  return hash ^ key.advertising_data_hash;
+}
+
+}  // namespace bluetooth::hci
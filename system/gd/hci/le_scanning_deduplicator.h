@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// The LE Scanning deduplicator drops complete advertising reports that
+/// repeat a report delivered recently, as advertisers commonly send
+/// identical payloads every few tens of milliseconds.
+/// It complements the controller filters (APCF) which select the
+/// advertisers reported, but not how often.
+///
+/// A report is a duplicate of the last delivered report with the same
+/// event type, address, SID and advertising data when it is received
+/// within the report window, and its RSSI did not change by the RSSI
+/// threshold or more.
+
+class LeScanningDeduplicator {
+ public:
+  /// Default number of advertisers tracked at the same time.
+  static constexpr size_t kDefaultMaximumEntries = 1024;
+
+  explicit LeScanningDeduplicator(size_t maximum_entries = kDefaultMaximumEntries);
+  LeScanningDeduplicator(const LeScanningDeduplicator&) = delete;
+  LeScanningDeduplicator& operator=(const LeScanningDeduplicator&) = delete;
+
+  /// Configure the deduplication. A zero report window disables it,
+  /// a zero RSSI threshold ignores RSSI changes.
+  void SetParameters(std::chrono::milliseconds report_window, uint8_t rssi_threshold);
+
+  bool IsEnabled() const {
+    return report_window_.count() > 0;
+  }
+
+  /// Returns true if the complete advertising report should be delivered,
+  /// false if it is a duplicate. Delivered reports are recorded as the
+  /// reference for the following ones.
+  bool ShouldReport(
+      uint16_t event_type,
+      uint8_t address_type,
+      Address address,
+      uint8_t advertising_sid,
+      int8_t rssi,
+      const std::vector<uint8_t>& advertising_data,
+      std::chrono::steady_clock::time_point now);
+
+  /// Forget all delivered reports, e.g. when scanning restarts.
+  void Clear() {
+    entries_.clear();
+  }
+
+ private:
+  struct ReportKey {
+    uint16_t event_type;
+    uint8_t address_type;
+    Address address;
+    uint8_t advertising_sid;
+    uint64_t advertising_data_hash;
+
+    bool operator==(const ReportKey& other) const;
+  };
+
+  struct ReportKeyHash {
+    size_t operator()(const ReportKey& key) const;
+  };
+
+  struct ReportEntry {
+    std::chrono::steady_clock::time_point delivered_at;
+    int8_t rssi;
+  };
+
+  const size_t maximum_entries_;
+  std::chrono::milliseconds report_window_{0};
+  uint8_t rssi_threshold_{0};
+  std::unordered_map<ReportKey, ReportEntry, ReportKeyHash> entries_;
+
+  /// Remove the entries older than the report window.
+  void RemoveExpiredEntries(std::chrono::steady_clock::time_point now);
+
+  static uint64_t HashAdvertisingData(const std::vector<uint8_t>& advertising_data);
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_deduplicator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+// Event type fields.
+static constexpr uint16_t kConnectable = 0x1;
+static constexpr uint16_t kLegacy = 0x10;
+
+static constexpr uint8_t kPublicAddress = 0x0;
+static constexpr uint8_t kSidNotPresent = 0xff;
+static constexpr int8_t kRssi = -60;
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const std::vector<uint8_t> kTestAdvertisingData = {0x2, 0x1, 0x6};
+
+class LeScanningDeduplicatorTest : public ::testing::Test {
+ public:
+  bool ShouldReport(
+      int8_t rssi = kRssi,
+      const std::vector<uint8_t>& advertising_data = kTestAdvertisingData,
+      Address address = kTestAddress,
+      uint8_t advertising_sid = kSidNotPresent,
+      uint16_t event_type = kLegacy | kConnectable) {
+    return deduplicator_.ShouldReport(
+        event_type, kPublicAddress, address, advertising_sid, rssi, advertising_data, now_);
+  }
+
+  LeScanningDeduplicator deduplicator_;
+  std::chrono::steady_clock::time_point now_;
+};
+
+TEST_F(LeScanningDeduplicatorTest, disabled_by_default) {
+  ASSERT_FALSE(deduplicator_.IsEnabled());
+  ASSERT_TRUE(ShouldReport());
+  ASSERT_TRUE(ShouldReport());
+}
+
+TEST_F(LeScanningDeduplicatorTest, duplicates_are_dropped_within_report_window) {
+  deduplicator_.SetParameters(1000ms, 0);
+  ASSERT_TRUE(ShouldReport());
+  now_ += 20ms;
+  ASSERT_FALSE(ShouldReport());
+  now_ += 950ms;
+  ASSERT_FALSE(ShouldReport(kRssi - 30));
+  // The window starts at the last delivered report.
+  now_ += 30ms;
+  ASSERT_TRUE(ShouldReport());
+  now_ += 20ms;
+  ASSERT_FALSE(ShouldReport());
+}
+
+TEST_F(LeScanningDeduplicatorTest, rssi_change_is_reported) {
+  deduplicator_.SetParameters(1000ms, 5);
+  ASSERT_TRUE(ShouldReport());
+  now_ += 20ms;
+  ASSERT_FALSE(ShouldReport(kRssi + 4));
+  ASSERT_TRUE(ShouldReport(kRssi + 5));
+  // The delivered report is the new RSSI reference.
+  ASSERT_FALSE(ShouldReport(kRssi + 1));
+  ASSERT_TRUE(ShouldReport(kRssi - 1));
+}
+
+TEST_F(LeScanningDeduplicatorTest, reports_are_keyed_by_advertiser_and_payload) {
+  deduplicator_.SetParameters(1000ms, 0);
+  ASSERT_TRUE(ShouldReport());
+  ASSERT_TRUE(ShouldReport(kRssi, {0x2, 0x1, 0x4}));
+  ASSERT_TRUE(ShouldReport(kRssi, kTestAdvertisingData, Address({5, 4, 3, 2, 1, 0})));
+  ASSERT_TRUE(ShouldReport(kRssi, kTestAdvertisingData, kTestAddress, 0x1));
+  ASSERT_TRUE(ShouldReport(kRssi, kTestAdvertisingData, kTestAddress, kSidNotPresent, kLegacy));
+
+  ASSERT_FALSE(ShouldReport());
+  ASSERT_FALSE(ShouldReport(kRssi, {0x2, 0x1, 0x4}));
+  ASSERT_FALSE(ShouldReport(kRssi, kTestAdvertisingData, Address({5, 4, 3, 2, 1, 0})));
+  ASSERT_FALSE(ShouldReport(kRssi, kTestAdvertisingData, kTestAddress, 0x1));
+  ASSERT_FALSE(ShouldReport(kRssi, kTestAdvertisingData, kTestAddress, kSidNotPresent, kLegacy));
+}
+
+TEST_F(LeScanningDeduplicatorTest, clear_and_disable_forget_reports) {
+  deduplicator_.SetParameters(1000ms, 0);
+  ASSERT_TRUE(ShouldReport());
+  deduplicator_.Clear();
+  ASSERT_TRUE(ShouldReport());
+
+  deduplicator_.SetParameters(0ms, 0);
+  ASSERT_TRUE(ShouldReport());
+  deduplicator_.SetParameters(1000ms, 0);
+  ASSERT_TRUE(ShouldReport());
+  ASSERT_FALSE(ShouldReport());
+}
+
+TEST_F(LeScanningDeduplicatorTest, table_is_bounded) {
+  LeScanningDeduplicator deduplicator(2);
+  deduplicator.SetParameters(1000ms, 0);
+  auto should_report = [&](uint8_t i) {
+    return deduplicator.ShouldReport(
+        kLegacy, kPublicAddress, Address({i, 0, 0, 0, 0, 0}), kSidNotPresent, kRssi, kTestAdvertisingData, now_);
+  };
+
+  ASSERT_TRUE(should_report(0));
+  now_ += 500ms;
+  ASSERT_TRUE(should_report(1));
+  now_ += 600ms;
+  // The first entry expired and makes room for the third advertiser.
+  ASSERT_TRUE(should_report(2));
+  ASSERT_FALSE(should_report(1));
+  ASSERT_FALSE(should_report(2));
+
+  // All entries are recent, the table is reset.
+  ASSERT_TRUE(should_report(3));
+  ASSERT_TRUE(should_report(1));
+}
+
+}  // namespace bluetooth::hci
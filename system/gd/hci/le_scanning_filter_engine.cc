@@ -0,0 +1,443 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/le_scanning_filter_engine.h"
+
+#include <algorithm>
+
+#include "hci/address_with_type.h"
+#include "os/log.h"
+
+namespace bluetooth::hci {
+
+namespace {
+
+bool is_empty_128bit(const std::array<uint8_t, 16>& data) {
+  return std::all_of(data.begin(), data.end(), [](uint8_t byte) { return byte == 0; });
+}
+
+// The AD types holding the data matched by each filter type.
+std::vector<GapDataType> ad_types_of(ApcfFilterType filter_type) {
+  switch (filter_type) {
+    case ApcfFilterType::SERVICE_UUID:
+      return {
+          GapDataType::INCOMPLETE_LIST_16_BIT_UUIDS,
+          GapDataType::COMPLETE_LIST_16_BIT_UUIDS,
+          GapDataType::INCOMPLETE_LIST_32_BIT_UUIDS,
+          GapDataType::COMPLETE_LIST_32_BIT_UUIDS,
+          GapDataType::INCOMPLETE_LIST_128_BIT_UUIDS,
+          GapDataType::COMPLETE_LIST_128_BIT_UUIDS};
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      return {
+          GapDataType::LIST_16BIT_SERVICE_SOLICITATION_UUIDS,
+          GapDataType::LIST_32BIT_SERVICE_SOLICITATION_UUIDS,
+          GapDataType::LIST_128BIT_SERVICE_SOLICITATION_UUIDS};
+    case ApcfFilterType::LOCAL_NAME:
+      return {GapDataType::SHORTENED_LOCAL_NAME, GapDataType::COMPLETE_LOCAL_NAME};
+    case ApcfFilterType::MANUFACTURER_DATA:
+      return {GapDataType::MANUFACTURER_SPECIFIC_DATA};
+    case ApcfFilterType::SERVICE_DATA:
+      return {
+          GapDataType::SERVICE_DATA_16_BIT_UUIDS,
+          GapDataType::SERVICE_DATA_32_BIT_UUIDS,
+          GapDataType::SERVICE_DATA_128_BIT_UUIDS};
+    case ApcfFilterType::TRANSPORT_DISCOVERY_DATA:
+      return {GapDataType::TRANSPORT_DISCOVERY_DATA};
+    default:
+      return {};
+  }
+}
+
+Uuid mask_uuid(const Uuid& uuid, const Uuid& mask) {
+  Uuid::UUID128Bit bytes = uuid.To128BitBE();
+  const Uuid::UUID128Bit& mask_bytes = mask.To128BitBE();
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] &= mask_bytes[i];
+  }
+  return Uuid::From128BitBE(bytes);
+}
+
+}  // namespace
+
+void LeScanningFilterEngine::SetFilterParameters(
+    ApcfAction action, uint8_t filter_index, const AdvertisingFilterParameter& parameters) {
+  switch (action) {
+    case ApcfAction::ADD: {
+      Filter& filter = filters_[filter_index];
+      filter.has_parameters = true;
+      filter.parameters = parameters;
+    } break;
+    case ApcfAction::DELETE:
+      filters_.erase(filter_index);
+      break;
+    case ApcfAction::CLEAR:
+      filters_.clear();
+      break;
+    default:
+      LOG_ERROR("Unknown action type: %d", (uint16_t)action);
+      return;
+  }
+  Compile();
+}
+
+void LeScanningFilterEngine::AddConditions(
+    uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions) {
+  Filter& filter = filters_[filter_index];
+  filter.conditions.insert(filter.conditions.end(), conditions.begin(), conditions.end());
+  Compile();
+}
+
+size_t LeScanningFilterEngine::GetFilterCount() const {
+  return compiled_filters_.size();
+}
+
+void LeScanningFilterEngine::Compile() {
+  compiled_filters_.clear();
+  condition_count_ = 0;
+  ad_types_.reset();
+  address_index_.clear();
+  irk_conditions_.clear();
+  service_uuid_index_.clear();
+  solicitation_uuid_index_.clear();
+  masked_service_uuids_.clear();
+  masked_solicitation_uuids_.clear();
+  name_trie_.assign(1, TrieNode{});
+  manufacturer_index_.clear();
+  masked_manufacturers_.clear();
+  service_data_.clear();
+  ad_type_data_.clear();
+  transport_discovery_data_.clear();
+
+  for (const auto& [filter_index, filter] : filters_) {
+    // Conditions without parameters are kept until the parameters are
+    // added, but do not filter anything.
+    if (!filter.has_parameters) {
+      continue;
+    }
+    CompiledFilter compiled_filter{filter.parameters, {}};
+    for (const auto& condition : filter.conditions) {
+      size_t feature = static_cast<size_t>(condition.filter_type);
+      if (feature >= kNumFeatures) {
+        LOG_ERROR("Unknown filter type: %d", (uint16_t)condition.filter_type);
+        continue;
+      }
+      if (condition.data.size() != condition.data_mask.size() && !condition.data.empty() &&
+          !condition.data_mask.empty()) {
+        LOG_ERROR("data and data_mask are of different size");
+        continue;
+      }
+      size_t index = condition_count_++;
+      compiled_filter.conditions[feature].push_back(index);
+      CompileCondition(condition, index);
+    }
+    compiled_filters_.push_back(std::move(compiled_filter));
+  }
+  matched_.assign(condition_count_, false);
+}
+
+void LeScanningFilterEngine::CompileCondition(const AdvertisingPacketContentFilterCommand& condition, size_t index) {
+  for (GapDataType ad_type : ad_types_of(condition.filter_type)) {
+    ad_types_.set(static_cast<uint8_t>(ad_type));
+  }
+
+  // An empty mask compares all the data.
+  std::vector<uint8_t> data_mask = condition.data_mask;
+  if (data_mask.empty()) {
+    data_mask.assign(condition.data.size(), 0xff);
+  }
+
+  switch (condition.filter_type) {
+    case ApcfFilterType::BROADCASTER_ADDRESS:
+      address_index_.emplace(condition.address, index);
+      if (!is_empty_128bit(condition.irk)) {
+        irk_conditions_.emplace_back(condition.irk, index);
+      }
+      break;
+    case ApcfFilterType::SERVICE_UUID:
+      if (condition.uuid_mask.IsEmpty()) {
+        service_uuid_index_.emplace(condition.uuid, index);
+      } else {
+        masked_service_uuids_.push_back({mask_uuid(condition.uuid, condition.uuid_mask), condition.uuid_mask, index});
+      }
+      break;
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      if (condition.uuid_mask.IsEmpty()) {
+        solicitation_uuid_index_.emplace(condition.uuid, index);
+      } else {
+        masked_solicitation_uuids_.push_back(
+            {mask_uuid(condition.uuid, condition.uuid_mask), condition.uuid_mask, index});
+      }
+      break;
+    case ApcfFilterType::LOCAL_NAME: {
+      size_t node = 0;
+      for (uint8_t octet : condition.name) {
+        auto child = name_trie_[node].children.find(octet);
+        if (child == name_trie_[node].children.end()) {
+          name_trie_.push_back(TrieNode{});
+          child = name_trie_[node].children.emplace(octet, name_trie_.size() - 1).first;
+        }
+        node = child->second;
+      }
+      name_trie_[node].conditions.push_back(index);
+    } break;
+    case ApcfFilterType::MANUFACTURER_DATA: {
+      // A zero company mask compares the whole company identifier.
+      DataCondition data_condition{condition.data, data_mask, index};
+      if (condition.company_mask == 0 || condition.company_mask == 0xffff) {
+        manufacturer_index_.emplace(condition.company, std::move(data_condition));
+      } else {
+        masked_manufacturers_.emplace_back(condition.company_mask, std::move(data_condition));
+        // The masked company identifier is kept in front of the data.
+        auto& masked = masked_manufacturers_.back().second;
+        uint16_t company = condition.company & condition.company_mask;
+        masked.data.insert(masked.data.begin(), {(uint8_t)company, (uint8_t)(company >> 8)});
+        masked.mask.insert(
+            masked.mask.begin(), {(uint8_t)condition.company_mask, (uint8_t)(condition.company_mask >> 8)});
+      }
+    } break;
+    case ApcfFilterType::SERVICE_DATA:
+      service_data_.push_back({condition.data, data_mask, index});
+      break;
+    case ApcfFilterType::TRANSPORT_DISCOVERY_DATA:
+      transport_discovery_data_.emplace_back(condition, index);
+      break;
+    case ApcfFilterType::AD_TYPE:
+      ad_types_.set(condition.ad_type);
+      ad_type_data_.emplace_back(condition.ad_type, DataCondition{condition.data, data_mask, index});
+      break;
+    default:
+      // Not evaluated on the host, the condition is left unmatched and
+      // SERVICE_DATA_CHANGE filters match, see MatchesFilter.
+      break;
+  }
+}
+
+bool LeScanningFilterEngine::Matches(Address address, int8_t rssi, const std::vector<uint8_t>& advertising_data) {
+  if (!enabled_) {
+    return true;
+  }
+  if (compiled_filters_.empty()) {
+    return false;
+  }
+
+  std::fill(matched_.begin(), matched_.end(), false);
+
+  auto [first, last] = address_index_.equal_range(address);
+  for (auto it = first; it != last; it++) {
+    matched_[it->second] = true;
+  }
+  if (!irk_conditions_.empty()) {
+    AddressWithType address_with_type(address, AddressType::RANDOM_DEVICE_ADDRESS);
+    for (const auto& [irk, condition] : irk_conditions_) {
+      if (!matched_[condition] && address_with_type.IsRpaThatMatchesIrk(irk)) {
+        matched_[condition] = true;
+      }
+    }
+  }
+
+  for (size_t offset = 0; offset < advertising_data.size();) {
+    size_t length = advertising_data[offset];
+    if (length == 0 || offset + 1 + length > advertising_data.size()) {
+      break;
+    }
+    uint8_t ad_type = advertising_data[offset + 1];
+    if (ad_types_.test(ad_type)) {
+      MatchAdStructure(ad_type, &advertising_data[offset + 2], length - 1);
+    }
+    offset += 1 + length;
+  }
+
+  for (const auto& filter : compiled_filters_) {
+    if (MatchesFilter(filter, rssi)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void LeScanningFilterEngine::MatchAdStructure(uint8_t ad_type, const uint8_t* data, size_t size) {
+  switch (static_cast<GapDataType>(ad_type)) {
+    case GapDataType::INCOMPLETE_LIST_16_BIT_UUIDS:
+    case GapDataType::COMPLETE_LIST_16_BIT_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes16, service_uuid_index_, masked_service_uuids_);
+      break;
+    case GapDataType::INCOMPLETE_LIST_32_BIT_UUIDS:
+    case GapDataType::COMPLETE_LIST_32_BIT_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes32, service_uuid_index_, masked_service_uuids_);
+      break;
+    case GapDataType::INCOMPLETE_LIST_128_BIT_UUIDS:
+    case GapDataType::COMPLETE_LIST_128_BIT_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes128, service_uuid_index_, masked_service_uuids_);
+      break;
+    case GapDataType::LIST_16BIT_SERVICE_SOLICITATION_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes16, solicitation_uuid_index_, masked_solicitation_uuids_);
+      break;
+    case GapDataType::LIST_32BIT_SERVICE_SOLICITATION_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes32, solicitation_uuid_index_, masked_solicitation_uuids_);
+      break;
+    case GapDataType::LIST_128BIT_SERVICE_SOLICITATION_UUIDS:
+      MatchUuids(data, size, Uuid::kNumBytes128, solicitation_uuid_index_, masked_solicitation_uuids_);
+      break;
+    case GapDataType::SHORTENED_LOCAL_NAME:
+    case GapDataType::COMPLETE_LOCAL_NAME:
+      MatchName(data, size);
+      break;
+    case GapDataType::MANUFACTURER_SPECIFIC_DATA:
+      if (size >= 2) {
+        uint16_t company = data[0] | (data[1] << 8);
+        auto [first, last] = manufacturer_index_.equal_range(company);
+        for (auto it = first; it != last; it++) {
+          if (MatchesData(it->second, data + 2, size - 2)) {
+            matched_[it->second.condition] = true;
+          }
+        }
+        for (const auto& [company_mask, condition] : masked_manufacturers_) {
+          if (MatchesData(condition, data, size)) {
+            matched_[condition.condition] = true;
+          }
+        }
+      }
+      break;
+    case GapDataType::SERVICE_DATA_16_BIT_UUIDS:
+    case GapDataType::SERVICE_DATA_32_BIT_UUIDS:
+    case GapDataType::SERVICE_DATA_128_BIT_UUIDS:
+      for (const auto& condition : service_data_) {
+        if (MatchesData(condition, data, size)) {
+          matched_[condition.condition] = true;
+        }
+      }
+      break;
+    case GapDataType::TRANSPORT_DISCOVERY_DATA:
+      // Only the organization and flags of the first transport block are
+      // compared, the transport data is left to the upper layers.
+      if (size >= 2) {
+        for (const auto& [condition, index] : transport_discovery_data_) {
+          if (data[0] == condition.org_id &&
+              (data[1] & condition.tds_flags_mask) == (condition.tds_flags & condition.tds_flags_mask)) {
+            matched_[index] = true;
+          }
+        }
+      }
+      break;
+    default:
+      break;
+  }
+
+  for (const auto& [condition_ad_type, condition] : ad_type_data_) {
+    if (condition_ad_type == ad_type && MatchesData(condition, data, size)) {
+      matched_[condition.condition] = true;
+    }
+  }
+}
+
+void LeScanningFilterEngine::MatchUuids(
+    const uint8_t* data,
+    size_t size,
+    size_t uuid_size,
+    const std::unordered_multimap<Uuid, size_t>& index,
+    const std::vector<UuidCondition>& masked) {
+  for (size_t offset = 0; offset + uuid_size <= size; offset += uuid_size) {
+    Uuid uuid;
+    if (uuid_size == Uuid::kNumBytes16) {
+      uuid = Uuid::From16Bit(data[offset] | (data[offset + 1] << 8));
+    } else if (uuid_size == Uuid::kNumBytes32) {
+      uuid = Uuid::From32Bit(
+          data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | ((uint32_t)data[offset + 3] << 24));
+    } else {
+      uuid = Uuid::From128BitLE(data + offset);
+    }
+    auto [first, last] = index.equal_range(uuid);
+    for (auto it = first; it != last; it++) {
+      matched_[it->second] = true;
+    }
+    for (const auto& condition : masked) {
+      if (mask_uuid(uuid, condition.mask) == condition.uuid) {
+        matched_[condition.condition] = true;
+      }
+    }
+  }
+}
+
+/// Mark the name conditions that are a prefix of the advertised name.
+void LeScanningFilterEngine::MatchName(const uint8_t* data, size_t size) {
+  size_t node = 0;
+  for (size_t i = 0;; i++) {
+    for (size_t condition : name_trie_[node].conditions) {
+      matched_[condition] = true;
+    }
+    if (i == size) {
+      break;
+    }
+    auto child = name_trie_[node].children.find(data[i]);
+    if (child == name_trie_[node].children.end()) {
+      break;
+    }
+    node = child->second;
+  }
+}
+
+bool LeScanningFilterEngine::MatchesFilter(const CompiledFilter& filter, int8_t rssi) const {
+  const AdvertisingFilterParameter& parameters = filter.parameters;
+  if (rssi < static_cast<int8_t>(parameters.rssi_high_thresh)) {
+    return false;
+  }
+  // Reports matching filters with other delivery modes are reported by
+  // the controller as tracking events or batched reports, which are not
+  // emulated here.
+  if (parameters.delivery_mode != DeliveryMode::IMMEDIATE) {
+    return true;
+  }
+
+  bool filter_logic_and = parameters.filter_logic_type != 0;
+  bool any_feature = false;
+  for (size_t feature = 0; feature < kNumFeatures; feature++) {
+    if (!(parameters.feature_selection & (1 << feature))) {
+      continue;
+    }
+    const std::vector<size_t>& conditions = filter.conditions[feature];
+    auto is_matched = [this](size_t condition) { return matched_[condition]; };
+    bool feature_matched;
+    if (feature == static_cast<size_t>(ApcfFilterType::SERVICE_DATA_CHANGE) || conditions.empty()) {
+      feature_matched = true;
+    } else if (parameters.list_logic_type & (1 << feature)) {
+      feature_matched = std::all_of(conditions.begin(), conditions.end(), is_matched);
+    } else {
+      feature_matched = std::any_of(conditions.begin(), conditions.end(), is_matched);
+    }
+    if (filter_logic_and && !feature_matched) {
+      return false;
+    }
+    if (!filter_logic_and && feature_matched) {
+      return true;
+    }
+    any_feature = true;
+  }
+  // No feature selected: the filter lets all reports through.
+  return filter_logic_and || !any_feature;
+}
+
+bool LeScanningFilterEngine::MatchesData(const DataCondition& condition, const uint8_t* data, size_t size) {
+  if (condition.data.size() > size) {
+    return false;
+  }
+  for (size_t i = 0; i < condition.data.size(); i++) {
+    if ((data[i] & condition.mask[i]) != (condition.data[i] & condition.mask[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/hci_packets.h"
+#include "hci/le_scanning_callback.h"
+#include "hci/uuid.h"
+
+namespace bluetooth::hci {
+
+/// The LE Scanning filter engine applies the advertising packet content
+/// filters (APCF) on the host, for controllers that do not support the
+/// vendor APCF commands.
+///
+/// Filters are configured with the same parameters and conditions as the
+/// controller filters, and compiled into indexes on each change:
+/// the AD types referenced by any condition, a hash map of service UUIDs,
+/// addresses and company identifiers, and a prefix trie of local names.
+/// Matching a report then parses its advertising data once and only looks
+/// at the AD structures some condition refers to.
+///
+/// A report matches a filter when it matches the conditions of the
+/// features selected by the filter parameters. The conditions of the same
+/// feature are combined according to the list logic type, the features
+/// according to the filter logic type. A report is delivered if it matches
+/// any filter. Features that cannot be evaluated on the host (service data
+/// change, delivery modes other than immediate) are treated as matching,
+/// as the upper layers filter the delivered reports again.
+
+class LeScanningFilterEngine {
+ public:
+  LeScanningFilterEngine() = default;
+  LeScanningFilterEngine(const LeScanningFilterEngine&) = delete;
+  LeScanningFilterEngine& operator=(const LeScanningFilterEngine&) = delete;
+
+  /// Enable or disable filtering. All reports match when disabled.
+  void SetEnabled(bool enable) {
+    enabled_ = enable;
+  }
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  /// Add or delete the filter parameters of a filter index, or clear all
+  /// the filters. Deleting a filter also removes its conditions.
+  void SetFilterParameters(ApcfAction action, uint8_t filter_index, const AdvertisingFilterParameter& parameters);
+
+  /// Add conditions to a filter index.
+  void AddConditions(uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions);
+
+  /// Returns true if the complete advertising report matches any filter.
+  bool Matches(Address address, int8_t rssi, const std::vector<uint8_t>& advertising_data);
+
+  /// Number of filter indexes with parameters.
+  size_t GetFilterCount() const;
+
+ private:
+  static constexpr size_t kNumFeatures = 9;
+
+  struct Filter {
+    bool has_parameters{false};
+    AdvertisingFilterParameter parameters{};
+    std::vector<AdvertisingPacketContentFilterCommand> conditions;
+  };
+
+  /// Masked comparison of the start of an AD structure payload.
+  struct DataCondition {
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> mask;
+    size_t condition;
+  };
+
+  struct UuidCondition {
+    Uuid uuid;
+    Uuid mask;
+    size_t condition;
+  };
+
+  struct TrieNode {
+    std::map<uint8_t, size_t> children;
+    std::vector<size_t> conditions;
+  };
+
+  struct CompiledFilter {
+    AdvertisingFilterParameter parameters;
+    /// Compiled condition indexes of each feature.
+    std::array<std::vector<size_t>, kNumFeatures> conditions;
+  };
+
+  bool enabled_{false};
+  std::map<uint8_t, Filter> filters_;
+
+  /// Compiled filters, rebuilt by Compile() when the filters change.
+  std::vector<CompiledFilter> compiled_filters_;
+  size_t condition_count_{0};
+  std::bitset<256> ad_types_;
+  std::unordered_multimap<Address, size_t> address_index_;
+  std::vector<std::pair<std::array<uint8_t, 16>, size_t>> irk_conditions_;
+  std::unordered_multimap<Uuid, size_t> service_uuid_index_;
+  std::unordered_multimap<Uuid, size_t> solicitation_uuid_index_;
+  std::vector<UuidCondition> masked_service_uuids_;
+  std::vector<UuidCondition> masked_solicitation_uuids_;
+  std::vector<TrieNode> name_trie_;
+  std::unordered_multimap<uint16_t, DataCondition> manufacturer_index_;
+  std::vector<std::pair<uint16_t, DataCondition>> masked_manufacturers_;
+  std::vector<DataCondition> service_data_;
+  std::vector<std::pair<uint8_t, DataCondition>> ad_type_data_;
+  std::vector<std::pair<AdvertisingPacketContentFilterCommand, size_t>> transport_discovery_data_;
+
+  /// Conditions matched by the report being processed.
+  std::vector<bool> matched_;
+
+  void Compile();
+  void CompileCondition(const AdvertisingPacketContentFilterCommand& condition, size_t index);
+  void MatchAdStructure(uint8_t ad_type, const uint8_t* data, size_t size);
+  void MatchUuids(
+      const uint8_t* data,
+      size_t size,
+      size_t uuid_size,
+      const std::unordered_multimap<Uuid, size_t>& index,
+      const std::vector<UuidCondition>& masked);
+  void MatchName(const uint8_t* data, size_t size);
+  bool MatchesFilter(const CompiledFilter& filter, int8_t rssi) const;
+
+  static bool MatchesData(const DataCondition& condition, const uint8_t* data, size_t size);
+};
+
+}  // namespace bluetooth::hci
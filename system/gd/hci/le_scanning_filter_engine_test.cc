@@ -0,0 +1,246 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_filter_engine.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+static constexpr uint8_t kFilterIndex = 0x1;
+static constexpr int8_t kRssi = -60;
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+
+// Feature selection bits.
+static constexpr uint16_t kAddressFeature = 1 << 0;
+static constexpr uint16_t kServiceUuidFeature = 1 << 2;
+static constexpr uint16_t kLocalNameFeature = 1 << 4;
+static constexpr uint16_t kManufacturerDataFeature = 1 << 5;
+static constexpr uint16_t kServiceDataFeature = 1 << 6;
+
+class LeScanningFilterEngineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filter_engine_.SetEnabled(true);
+  }
+
+  void AddFilter(
+      uint16_t feature_selection,
+      std::vector<AdvertisingPacketContentFilterCommand> conditions,
+      uint16_t list_logic_type = 0,
+      uint8_t filter_logic_type = 0,
+      uint8_t filter_index = kFilterIndex) {
+    AdvertisingFilterParameter parameters{};
+    parameters.feature_selection = feature_selection;
+    parameters.list_logic_type = list_logic_type;
+    parameters.filter_logic_type = filter_logic_type;
+    parameters.rssi_high_thresh = static_cast<uint8_t>(-128);
+    parameters.delivery_mode = DeliveryMode::IMMEDIATE;
+    filter_engine_.SetFilterParameters(ApcfAction::ADD, filter_index, parameters);
+    filter_engine_.AddConditions(filter_index, conditions);
+  }
+
+  bool Matches(const std::vector<uint8_t>& advertising_data, Address address = kOtherAddress, int8_t rssi = kRssi) {
+    return filter_engine_.Matches(address, rssi, advertising_data);
+  }
+
+  static AdvertisingPacketContentFilterCommand Condition(ApcfFilterType filter_type) {
+    AdvertisingPacketContentFilterCommand condition{};
+    condition.filter_type = filter_type;
+    return condition;
+  }
+
+  static AdvertisingPacketContentFilterCommand AddressCondition(Address address) {
+    auto condition = Condition(ApcfFilterType::BROADCASTER_ADDRESS);
+    condition.address = address;
+    return condition;
+  }
+
+  static AdvertisingPacketContentFilterCommand ServiceUuidCondition(Uuid uuid, Uuid uuid_mask = Uuid::kEmpty) {
+    auto condition = Condition(ApcfFilterType::SERVICE_UUID);
+    condition.uuid = uuid;
+    condition.uuid_mask = uuid_mask;
+    return condition;
+  }
+
+  static AdvertisingPacketContentFilterCommand NameCondition(const std::string& name) {
+    auto condition = Condition(ApcfFilterType::LOCAL_NAME);
+    condition.name.assign(name.begin(), name.end());
+    return condition;
+  }
+
+  static AdvertisingPacketContentFilterCommand ManufacturerCondition(
+      uint16_t company, std::vector<uint8_t> data, std::vector<uint8_t> data_mask = {}) {
+    auto condition = Condition(ApcfFilterType::MANUFACTURER_DATA);
+    condition.company = company;
+    condition.data = data;
+    condition.data_mask = data_mask;
+    return condition;
+  }
+
+  LeScanningFilterEngine filter_engine_;
+};
+
+TEST_F(LeScanningFilterEngineTest, disabled_engine_matches_everything) {
+  filter_engine_.SetEnabled(false);
+  AddFilter(kLocalNameFeature, {NameCondition("abc")});
+  ASSERT_TRUE(Matches({}));
+  ASSERT_TRUE(Matches({0x4, 0x9, 'x', 'y', 'z'}));
+}
+
+TEST_F(LeScanningFilterEngineTest, enabled_engine_without_filters_matches_nothing) {
+  ASSERT_EQ(0ul, filter_engine_.GetFilterCount());
+  ASSERT_FALSE(Matches({0x2, 0x1, 0x6}));
+}
+
+TEST_F(LeScanningFilterEngineTest, filter_without_features_matches_everything) {
+  AddFilter(0, {});
+  ASSERT_EQ(1ul, filter_engine_.GetFilterCount());
+  ASSERT_TRUE(Matches({0x2, 0x1, 0x6}));
+}
+
+TEST_F(LeScanningFilterEngineTest, broadcaster_address) {
+  AddFilter(kAddressFeature, {AddressCondition(kTestAddress)});
+  ASSERT_TRUE(Matches({}, kTestAddress));
+  ASSERT_FALSE(Matches({}, kOtherAddress));
+}
+
+TEST_F(LeScanningFilterEngineTest, service_uuid) {
+  AddFilter(kServiceUuidFeature, {ServiceUuidCondition(Uuid::From16Bit(0xfe2c))});
+  ASSERT_TRUE(Matches({0x5, 0x3, 0x0f, 0x18, 0x2c, 0xfe}));
+  ASSERT_TRUE(Matches({0x3, 0x2, 0x2c, 0xfe}));
+  ASSERT_FALSE(Matches({0x3, 0x3, 0x0f, 0x18}));
+  // The UUID is in service data, not in a UUID list.
+  ASSERT_FALSE(Matches({0x3, 0x16, 0x2c, 0xfe}));
+
+  Uuid::UUID128Bit uuid_le = Uuid::From16Bit(0xfe2c).To128BitLE();
+  std::vector<uint8_t> advertising_data = {17, 0x7};
+  advertising_data.insert(advertising_data.end(), uuid_le.begin(), uuid_le.end());
+  ASSERT_TRUE(Matches(advertising_data));
+}
+
+TEST_F(LeScanningFilterEngineTest, masked_service_uuid) {
+  // Ignore the low byte of the 16-bit UUID.
+  Uuid uuid_mask = Uuid::From128BitBE(
+      {0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff});
+  AddFilter(kServiceUuidFeature, {ServiceUuidCondition(Uuid::From16Bit(0xfe00), uuid_mask)});
+  ASSERT_TRUE(Matches({0x3, 0x3, 0x2c, 0xfe}));
+  ASSERT_TRUE(Matches({0x3, 0x3, 0x01, 0xfe}));
+  ASSERT_FALSE(Matches({0x3, 0x3, 0x2c, 0xfd}));
+}
+
+TEST_F(LeScanningFilterEngineTest, local_name_prefix) {
+  AddFilter(kLocalNameFeature, {NameCondition("Pixel"), NameCondition("Pix Buds")});
+  ASSERT_TRUE(Matches({0x6, 0x9, 'P', 'i', 'x', 'e', 'l'}));
+  ASSERT_TRUE(Matches({0x8, 0x8, 'P', 'i', 'x', 'e', 'l', ' ', '7'}));
+  ASSERT_TRUE(Matches({0x9, 0x9, 'P', 'i', 'x', ' ', 'B', 'u', 'd', 's'}));
+  ASSERT_FALSE(Matches({0x4, 0x9, 'P', 'i', 'x'}));
+  ASSERT_FALSE(Matches({0x6, 0x9, 'p', 'i', 'x', 'e', 'l'}));
+}
+
+TEST_F(LeScanningFilterEngineTest, manufacturer_data) {
+  AddFilter(kManufacturerDataFeature, {ManufacturerCondition(0x00e0, {0x01, 0x80}, {0xff, 0xf0})});
+  ASSERT_TRUE(Matches({0x5, 0xff, 0xe0, 0x00, 0x01, 0x8f}));
+  ASSERT_TRUE(Matches({0x6, 0xff, 0xe0, 0x00, 0x01, 0x80, 0x42}));
+  ASSERT_FALSE(Matches({0x5, 0xff, 0xe0, 0x00, 0x02, 0x80}));
+  ASSERT_FALSE(Matches({0x5, 0xff, 0x4c, 0x00, 0x01, 0x80}));
+  // Manufacturer data shorter than the condition.
+  ASSERT_FALSE(Matches({0x4, 0xff, 0xe0, 0x00, 0x01}));
+}
+
+TEST_F(LeScanningFilterEngineTest, service_data) {
+  auto condition = Condition(ApcfFilterType::SERVICE_DATA);
+  condition.data = {0x2c, 0xfe, 0x42};
+  AddFilter(kServiceDataFeature, {condition});
+  ASSERT_TRUE(Matches({0x5, 0x16, 0x2c, 0xfe, 0x42, 0x00}));
+  ASSERT_FALSE(Matches({0x5, 0x16, 0x2c, 0xfe, 0x43, 0x00}));
+}
+
+TEST_F(LeScanningFilterEngineTest, ad_type) {
+  auto condition = Condition(ApcfFilterType::AD_TYPE);
+  condition.ad_type = 0x2a;
+  AddFilter(1 << 8, {condition});
+  ASSERT_TRUE(Matches({0x3, 0x2a, 0x01, 0x02}));
+  ASSERT_FALSE(Matches({0x3, 0x2b, 0x01, 0x02}));
+}
+
+TEST_F(LeScanningFilterEngineTest, list_logic_type) {
+  std::vector<uint8_t> both = {0x3, 0x3, 0x0f, 0x18, 0x3, 0x3, 0x2c, 0xfe};
+  std::vector<uint8_t> one = {0x3, 0x3, 0x2c, 0xfe};
+  std::vector<AdvertisingPacketContentFilterCommand> conditions = {
+      ServiceUuidCondition(Uuid::From16Bit(0x180f)), ServiceUuidCondition(Uuid::From16Bit(0xfe2c))};
+
+  AddFilter(kServiceUuidFeature, conditions, 0);
+  ASSERT_TRUE(Matches(both));
+  ASSERT_TRUE(Matches(one));
+
+  filter_engine_.SetFilterParameters(ApcfAction::CLEAR, 0, {});
+  AddFilter(kServiceUuidFeature, conditions, kServiceUuidFeature);
+  ASSERT_TRUE(Matches(both));
+  ASSERT_FALSE(Matches(one));
+}
+
+TEST_F(LeScanningFilterEngineTest, filter_logic_type) {
+  std::vector<AdvertisingPacketContentFilterCommand> conditions = {
+      AddressCondition(kTestAddress), NameCondition("abc")};
+  std::vector<uint8_t> name = {0x4, 0x9, 'a', 'b', 'c'};
+
+  AddFilter(kAddressFeature | kLocalNameFeature, conditions, 0, 0);
+  ASSERT_TRUE(Matches(name, kOtherAddress));
+  ASSERT_TRUE(Matches({}, kTestAddress));
+  ASSERT_FALSE(Matches({}, kOtherAddress));
+
+  filter_engine_.SetFilterParameters(ApcfAction::CLEAR, 0, {});
+  AddFilter(kAddressFeature | kLocalNameFeature, conditions, 0, 1);
+  ASSERT_TRUE(Matches(name, kTestAddress));
+  ASSERT_FALSE(Matches(name, kOtherAddress));
+  ASSERT_FALSE(Matches({}, kTestAddress));
+}
+
+TEST_F(LeScanningFilterEngineTest, rssi_threshold) {
+  AdvertisingFilterParameter parameters{};
+  parameters.rssi_high_thresh = static_cast<uint8_t>(-70);
+  parameters.delivery_mode = DeliveryMode::IMMEDIATE;
+  filter_engine_.SetFilterParameters(ApcfAction::ADD, kFilterIndex, parameters);
+  ASSERT_TRUE(Matches({}, kTestAddress, -70));
+  ASSERT_FALSE(Matches({}, kTestAddress, -71));
+}
+
+TEST_F(LeScanningFilterEngineTest, any_filter_matches) {
+  AddFilter(kLocalNameFeature, {NameCondition("abc")}, 0, 0, 1);
+  AddFilter(kAddressFeature, {AddressCondition(kTestAddress)}, 0, 0, 2);
+  ASSERT_EQ(2ul, filter_engine_.GetFilterCount());
+  ASSERT_TRUE(Matches({0x4, 0x9, 'a', 'b', 'c'}));
+  ASSERT_TRUE(Matches({}, kTestAddress));
+
+  // Deleting a filter deletes its conditions.
+  filter_engine_.SetFilterParameters(ApcfAction::DELETE, 2, {});
+  ASSERT_EQ(1ul, filter_engine_.GetFilterCount());
+  ASSERT_FALSE(Matches({}, kTestAddress));
+  AddFilter(0, {}, 0, 0, 2);
+  ASSERT_TRUE(Matches({}, kTestAddress));
+}
+
+TEST_F(LeScanningFilterEngineTest, malformed_advertising_data) {
+  AddFilter(kLocalNameFeature, {NameCondition("abc")});
+  ASSERT_FALSE(Matches({0x8, 0x9, 'a', 'b', 'c'}));
+  ASSERT_FALSE(Matches({0x0, 0x4, 0x9, 'a', 'b', 'c'}));
+  ASSERT_TRUE(Matches({0x2, 0x1, 0x6, 0x4, 0x9, 'a', 'b', 'c'}));
+}
+
+}  // namespace bluetooth::hci
@@ -15,14 +15,19 @@
  */
 #include "hci/le_scanning_manager.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
+#include "common/init_flags.h"
 #include "hci/acl_manager.h"
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "hci/le_periodic_sync_manager.h"
+#include "hci/le_scanning_deduplicator.h"
+#include "hci/le_scanning_filter_engine.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/le_scanning_reassembler.h"
 #include "hci/vendor_specific_event_manager.h"
@@ -48,6 +53,7 @@ constexpr uint16_t kLeScanIntervalMin = 0x0004;
 constexpr uint16_t kLeScanIntervalMax = 0x4000;
 constexpr uint16_t kDefaultLeExtendedScanInterval = 4800;
 constexpr uint16_t kLeExtendedScanIntervalMax = 0xFFFF;
+constexpr uint32_t kLeScanResultDedupWindowMax = 60000;
 
 constexpr uint8_t kScannableBit = 1;
 constexpr uint8_t kDirectedBit = 2;
@@ -57,6 +63,9 @@ constexpr uint8_t kDataStatusBits = 5;
 
 // system properties
 const std::string kLeRxPathLossCompProperty = "bluetooth.hardware.radio.le_rx_path_loss_comp_db";
+const std::string kLeScanResultDedupWindowProperty = "bluetooth.core.le.scan_result_dedup_window_ms";
+const std::string kLeScanResultDedupRssiThresholdProperty = "bluetooth.core.le.scan_result_dedup_rssi_threshold_db";
+const std::string kLePeriodicSyncReportDedupProperty = "bluetooth.core.le.periodic_sync_report_dedup";
 
 const ModuleFactory LeScanningManager::Factory = ModuleFactory([]() { return new LeScanningManager(); });
 
@@ -69,6 +78,8 @@ enum class ScanApiType {
 struct Scanner {
   Uuid app_uuid;
   bool in_use;
+  std::chrono::milliseconds dedup_report_window{0};
+  uint8_t dedup_rssi_threshold{0};
 };
 
 class NullScanningCallback : public ScanningCallback {
@@ -186,7 +197,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     le_address_manager_ = acl_manager->GetLeAddressManager();
     le_scanning_interface_ = hci_layer_->GetLeScanningInterface(
         module_handler_->BindOn(this, &LeScanningManager::impl::handle_scan_results));
-    periodic_sync_manager_.Init(le_scanning_interface_, module_handler_);
+    uint8_t periodic_advertiser_list_size = 0;
+    if (controller_->IsSupported(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST)) {
+      periodic_advertiser_list_size = controller_->GetLePeriodicAdvertiserListSize();
+    }
+    periodic_sync_manager_.Init(le_scanning_interface_, module_handler_, periodic_advertiser_list_size);
+    periodic_sync_manager_.SetDuplicateReportFiltering(
+        os::GetSystemPropertyBool(kLePeriodicSyncReportDedupProperty, false));
     /* Check to see if the opcode is supported and C19 (support for extended advertising). */
     if (controller_->IsSupported(OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS) &&
         controller->SupportsBleExtendedAdvertising()) {
@@ -203,6 +220,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       le_scanning_interface_->EnqueueCommand(
           LeAdvFilterReadExtendedFeaturesBuilder::Create(),
           module_handler_->BindOnceOn(this, &impl::on_apcf_read_extended_features_complete));
+    } else if (common::init_flags::IsLeScanningSoftwareFilterEnabled()) {
+      LOG_INFO("Advertising filter is not supported, filtering scan results on the host");
+      is_software_filter_enabled_ = true;
     }
     is_batch_scan_supported_ = controller->IsSupported(OpCode::LE_BATCH_SCAN);
     is_periodic_advertising_sync_transfer_sender_supported_ =
@@ -222,6 +242,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
     le_rx_path_loss_comp_ = get_rx_path_loss_compensation();
+    default_dedup_report_window_ =
+        std::chrono::milliseconds(get_uint_property(kLeScanResultDedupWindowProperty, kLeScanResultDedupWindowMax));
+    default_dedup_rssi_threshold_ = get_uint_property(kLeScanResultDedupRssiThresholdProperty, UINT8_MAX);
   }
 
   void stop() {
@@ -305,6 +328,18 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     return compensation;
   }
 
+  uint32_t get_uint_property(const std::string& property, uint32_t max) {
+    auto value_prop = os::GetSystemProperty(property);
+    if (value_prop) {
+      auto value = common::Uint64FromString(value_prop.value());
+      if (value && value.value() <= max) {
+        return value.value();
+      }
+      LOG_ERROR("Invalid value for %s: %s", property.c_str(), value_prop.value().c_str());
+    }
+    return 0;
+  }
+
   int8_t get_rssi_after_calibration(int8_t rssi) {
     if (le_rx_path_loss_comp_ == 0 || rssi == kLeScanRssiUnknown) {
       return rssi;
@@ -437,6 +472,20 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
         event_type, address_type, address, advertising_sid, advertising_data);
 
     if (complete_advertising_data.has_value()) {
+      if (!scanning_filter_engine_.Matches(address, rssi, complete_advertising_data.value())) {
+        return;
+      }
+      if (!scanning_deduplicator_.ShouldReport(
+              event_type,
+              address_type,
+              address,
+              advertising_sid,
+              rssi,
+              complete_advertising_data.value(),
+              std::chrono::steady_clock::now())) {
+        return;
+      }
+
       switch (address_type) {
         case (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS:
         case (uint8_t)AddressType::PUBLIC_IDENTITY_ADDRESS:
@@ -518,6 +567,9 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       if (!scanners_[i].in_use) {
         scanners_[i].app_uuid = app_uuid;
         scanners_[i].in_use = true;
+        scanners_[i].dedup_report_window = default_dedup_report_window_;
+        scanners_[i].dedup_rssi_threshold = default_dedup_rssi_threshold_;
+        update_scan_result_deduplication();
         scanning_callbacks_->OnScannerRegistered(app_uuid, i, ScanningCallback::ScanningStatus::SUCCESS);
         return;
       }
@@ -536,6 +588,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     if (scanners_[scanner_id].in_use) {
       scanners_[scanner_id].in_use = false;
       scanners_[scanner_id].app_uuid = Uuid::kEmpty;
+      update_scan_result_deduplication();
     } else {
       LOG_WARN("Unregister scanner with unused scanner id");
     }
@@ -562,6 +615,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       return;
     }
     is_scanning_ = true;
+    scanning_deduplicator_.Clear();
     if (!address_manager_registered_) {
       le_address_manager_->Register(this);
       address_manager_registered_ = true;
@@ -642,7 +696,49 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     filter_policy_ = filter_policy;
   }
 
+  void set_scan_result_deduplication(
+      ScannerId scanner_id, std::chrono::milliseconds report_window, uint8_t rssi_threshold) {
+    if (scanner_id <= 0 || scanner_id > kMaxAppNum || !scanners_[scanner_id].in_use) {
+      LOG_WARN("Invalid scanner id");
+      return;
+    }
+    scanners_[scanner_id].dedup_report_window = report_window;
+    scanners_[scanner_id].dedup_rssi_threshold = rssi_threshold;
+    update_scan_result_deduplication();
+  }
+
+  // Scan results are delivered to all the scanners, so only deduplicate
+  // what none of them wants to see.
+  void update_scan_result_deduplication() {
+    std::chrono::milliseconds report_window = std::chrono::milliseconds::max();
+    uint8_t rssi_threshold = 0;
+    bool any_scanner = false;
+    for (uint8_t i = 1; i <= kMaxAppNum; i++) {
+      if (scanners_[i].in_use) {
+        any_scanner = true;
+        report_window = std::min(report_window, scanners_[i].dedup_report_window);
+        // A zero threshold ignores RSSI changes, any other one is stricter.
+        uint8_t threshold = scanners_[i].dedup_rssi_threshold;
+        if (threshold != 0 && (rssi_threshold == 0 || threshold < rssi_threshold)) {
+          rssi_threshold = threshold;
+        }
+      }
+    }
+    if (!any_scanner) {
+      report_window = std::chrono::milliseconds(0);
+    }
+    LOG_INFO(
+        "Scan result deduplication window: %lld ms, rssi threshold: %d dB",
+        static_cast<long long>(report_window.count()),
+        rssi_threshold);
+    scanning_deduplicator_.SetParameters(report_window, rssi_threshold);
+  }
+
   void scan_filter_enable(bool enable) {
+    if (is_software_filter_enabled_) {
+      scanning_filter_engine_.SetEnabled(enable);
+      return;
+    }
     if (!is_filter_supported_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -667,6 +763,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
+    if (is_software_filter_enabled_) {
+      scanning_filter_engine_.SetFilterParameters(action, filter_index, advertising_filter_parameter);
+      return;
+    }
     if (!is_filter_supported_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -730,6 +830,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   }
 
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
+    if (is_software_filter_enabled_) {
+      scanning_filter_engine_.AddConditions(filter_index, filters);
+      return;
+    }
     if (!is_filter_supported_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -1208,10 +1312,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       return;
     }
 
-    if (batch_scan_result_cache_.find(scanner_id) == batch_scan_result_cache_.end()) {
-      std::vector<uint8_t> empty_data = {};
-      batch_scan_result_cache_.emplace(scanner_id, empty_data);
-    }
+    batch_scan_result_cache_.emplace(scanner_id, std::vector<uint8_t>());
 
     le_scanning_interface_->EnqueueCommand(
         LeBatchScanReadResultParametersBuilder::Create(static_cast<BatchScanDataRead>(scan_mode)),
@@ -1534,17 +1635,35 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     }
     uint8_t num_of_records = complete_view.GetNumOfRecords();
     auto report_format = complete_view.GetBatchScanDataRead();
+    auto cache = batch_scan_result_cache_.find(scanner_id);
     if (num_of_records == 0) {
+      std::vector<uint8_t> data;
+      if (cache != batch_scan_result_cache_.end()) {
+        data = std::move(cache->second);
+        batch_scan_result_cache_.erase(cache);
+      }
       scanning_callbacks_->OnBatchScanReports(
-          scanner_id, 0x00, (int)report_format, total_num_of_records, batch_scan_result_cache_[scanner_id]);
-      batch_scan_result_cache_.erase(scanner_id);
-    } else {
+          scanner_id, 0x00, (int)report_format, total_num_of_records, std::move(data));
+      return;
+    }
+    // Records are decoded as their fragment arrives, so that a malformed fragment cannot shift the records of the
+    // following ones once they are all parsed by the upper layers.
+    if (!is_batch_scan_result_valid(status_view, report_format)) {
+      LOG_WARN("Dropping %hhu malformed batch scan records", num_of_records);
+    } else if (cache != batch_scan_result_cache_.end()) {
       auto raw_data = complete_view.GetRawData();
-      batch_scan_result_cache_[scanner_id].insert(
-          batch_scan_result_cache_[scanner_id].end(), raw_data.begin(), raw_data.end());
+      cache->second.insert(cache->second.end(), raw_data.begin(), raw_data.end());
       total_num_of_records += num_of_records;
-      batch_scan_read_results(scanner_id, total_num_of_records, static_cast<BatchScanMode>(report_format));
     }
+    batch_scan_read_results(scanner_id, total_num_of_records, static_cast<BatchScanMode>(report_format));
+  }
+
+  static bool is_batch_scan_result_valid(LeBatchScanCompleteView status_view, BatchScanDataRead report_format) {
+    auto result_view = LeBatchScanReadResultParametersCompleteView::Create(status_view);
+    if (report_format == BatchScanDataRead::TRUNCATED_MODE_DATA) {
+      return LeBatchScanReadTruncatedResultParametersCompleteView::Create(result_view).IsValid();
+    }
+    return LeBatchScanReadFullResultParametersCompleteView::Create(result_view).IsValid();
   }
 
   void on_storage_threshold_breach(VendorSpecificEventView event) {
@@ -1635,7 +1754,12 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   bool scan_on_resume_ = false;
   bool paused_ = false;
   LeScanningReassembler scanning_reassembler_;
+  LeScanningDeduplicator scanning_deduplicator_;
+  LeScanningFilterEngine scanning_filter_engine_;
+  std::chrono::milliseconds default_dedup_report_window_{0};
+  uint8_t default_dedup_rssi_threshold_{0};
   bool is_filter_supported_ = false;
+  bool is_software_filter_enabled_ = false;
   bool is_ad_type_filter_supported_ = false;
   bool is_batch_scan_supported_ = false;
   bool is_periodic_advertising_sync_transfer_sender_supported_ = false;
@@ -1728,6 +1852,11 @@ void LeScanningManager::SetScanFilterPolicy(LeScanningFilterPolicy filter_policy
   CallOn(pimpl_.get(), &impl::set_scan_filter_policy, filter_policy);
 }
 
+void LeScanningManager::SetScanResultDeduplication(
+    ScannerId scanner_id, std::chrono::milliseconds report_window, uint8_t rssi_threshold) {
+  CallOn(pimpl_.get(), &impl::set_scan_result_deduplication, scanner_id, report_window, rssi_threshold);
+}
+
 void LeScanningManager::ScanFilterEnable(bool enable) {
   CallOn(pimpl_.get(), &impl::scan_filter_enable, enable);
 }
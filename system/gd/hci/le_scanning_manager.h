@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "common/callback.h"
@@ -56,6 +57,11 @@ class LeScanningManager : public bluetooth::Module {
 
   virtual void SetScanFilterPolicy(LeScanningFilterPolicy filter_policy);
 
+  // Drop scan results repeating one delivered less than report_window ago, unless the RSSI changed by rssi_threshold
+  // or more. Results are shared, so the shortest window and lowest threshold of the registered scanners apply.
+  virtual void SetScanResultDeduplication(
+      ScannerId scanner_id, std::chrono::milliseconds report_window, uint8_t rssi_threshold);
+
   /* Scan filter */
   virtual void ScanFilterEnable(bool enable);
 
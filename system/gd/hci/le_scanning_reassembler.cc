@@ -15,6 +15,7 @@
  */
 #include "hci/le_scanning_reassembler.h"
 
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 
@@ -32,6 +33,15 @@
 
 namespace bluetooth::hci {
 
+LeScanningReassembler::LeScanningReassembler(size_t cache_size) : fragments_(cache_size) {
+  ASSERT(cache_size > 0);
+  index_.reserve(cache_size);
+  for (size_t fragment = 0; fragment < cache_size; fragment++) {
+    fragments_[fragment].next = fragment + 1 < cache_size ? fragment + 1 : kNoFragment;
+  }
+  free_head_ = 0;
+}
+
 std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingReport(
     uint16_t event_type,
     uint8_t address_type,
@@ -65,15 +75,6 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
     RemoveFragment(key);
   }
 
-  // Concatenate the data with existing fragments.
-  std::list<AdvertisingFragment>::iterator advertising_fragment =
-      AppendFragment(key, advertising_data);
-
-  // Trim the advertising data when the complete payload is received.
-  if (data_status != DataStatus::CONTINUING) {
-    advertising_fragment->data = TrimAdvertisingData(advertising_fragment->data);
-  }
-
   // TODO(b/272120114) waiting for a scan response here is prone to failure as the
   // SCAN_REQ PDUs can be rejected by the advertiser according to the
   // advertising filter parameter.
@@ -83,14 +84,33 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
   // - For legacy advertising, when a scan response is expected.
   // - For extended advertising, when the current data is marked
   //   incomplete OR when a scan response is expected.
-  if (data_status == DataStatus::CONTINUING || expect_scan_response) {
+  bool is_complete = data_status != DataStatus::CONTINUING && !expect_scan_response;
+
+  // Most reports are complete on their own, return them without
+  // going through the cache.
+  if (is_complete && !ContainsFragment(key)) {
+    std::vector<uint8_t> complete_advertising_data(advertising_data);
+    TrimAdvertisingDataInPlace(complete_advertising_data);
+    return complete_advertising_data;
+  }
+
+  // Concatenate the data with existing fragments.
+  AdvertisingFragment& advertising_fragment = AppendFragment(key, advertising_data);
+
+  // Trim the advertising data when the complete payload is received.
+  if (data_status != DataStatus::CONTINUING) {
+    TrimAdvertisingDataInPlace(advertising_fragment.data);
+  }
+
+  if (!is_complete) {
     return {};
   }
 
   // Otherwise the full advertising report has been reassembled,
   // removed the cache entry and return the complete advertising data.
-  std::vector<uint8_t> complete_advertising_data = std::move(advertising_fragment->data);
-  cache_.erase(advertising_fragment);
+  // The data is copied out so that the fragment keeps its buffer.
+  std::vector<uint8_t> complete_advertising_data(advertising_fragment.data);
+  RemoveFragment(key);
   return complete_advertising_data;
 }
 
@@ -98,24 +118,30 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
 /// GAP Data entries.
 std::vector<uint8_t> LeScanningReassembler::TrimAdvertisingData(
     const std::vector<uint8_t>& advertising_data) {
-  // Remove empty and overflowing entries from the advertising data.
-  std::vector<uint8_t> significant_advertising_data;
+  std::vector<uint8_t> significant_advertising_data(advertising_data);
+  TrimAdvertisingDataInPlace(significant_advertising_data);
+  return significant_advertising_data;
+}
+
+/// Remove empty and overflowing entries from the advertising data,
+/// moving the significant entries towards the start of the buffer.
+void LeScanningReassembler::TrimAdvertisingDataInPlace(std::vector<uint8_t>& advertising_data) {
+  size_t significant_size = 0;
   for (size_t offset = 0; offset < advertising_data.size();) {
     size_t remaining_size = advertising_data.size() - offset;
     uint8_t entry_size = advertising_data[offset];
 
     if (entry_size != 0 && entry_size < remaining_size) {
-      significant_advertising_data.push_back(entry_size);
-      significant_advertising_data.insert(
-          significant_advertising_data.end(),
-          advertising_data.begin() + offset + 1,
-          advertising_data.begin() + offset + 1 + entry_size);
+      if (significant_size != offset) {
+        std::memmove(&advertising_data[significant_size], &advertising_data[offset], entry_size + 1);
+      }
+      significant_size += entry_size + 1;
     }
 
     offset += entry_size + 1;
   }
 
-  return significant_advertising_data;
+  advertising_data.resize(significant_size);
 }
 
 LeScanningReassembler::AdvertisingKey::AdvertisingKey(
@@ -132,48 +158,92 @@ LeScanningReassembler::AdvertisingKey::AdvertisingKey(
   }
 }
 
-bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) {
+bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) const {
   return address == other.address && sid == other.sid;
 }
 
+size_t LeScanningReassembler::AdvertisingKeyHash::operator()(const AdvertisingKey& key) const {
+  size_t address_hash = key.address ? std::hash<AddressWithType>{}(*key.address) + 1 : 0;
+  size_t sid_hash = key.sid ? *key.sid + 1 : 0;
+  return address_hash * 257 + sid_hash;
+}
+
 /// Append to the current advertising data of the selected advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
-/// dropping the oldest advertiser.
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator
-LeScanningReassembler::AppendFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    it->data.insert(it->data.end(), data.cbegin(), data.cend());
-    return it;
+/// dropping the least recently updated advertiser.
+LeScanningReassembler::AdvertisingFragment& LeScanningReassembler::AppendFragment(
+    const AdvertisingKey& key, const std::vector<uint8_t>& data) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    AdvertisingFragment& fragment = fragments_[it->second];
+    fragment.data.insert(fragment.data.end(), data.cbegin(), data.cend());
+    Unlink(it->second);
+    LinkFront(it->second);
+    return fragment;
   }
 
-  if (cache_.size() > kMaximumCacheSize) {
-    cache_.pop_back();
+  if (free_head_ == kNoFragment) {
+    LOG_DEBUG("Dropping advertising data of the least recently updated advertiser");
+    RemoveFragment(fragments_[lru_tail_].key);
   }
 
-  cache_.emplace_front(key, data);
-  return cache_.begin();
+  size_t index = free_head_;
+  AdvertisingFragment& fragment = fragments_[index];
+  free_head_ = fragment.next;
+  fragment.key = key;
+  fragment.data.assign(data.cbegin(), data.cend());
+  LinkFront(index);
+  index_.emplace(key, index);
+  return fragment;
 }
 
 void LeScanningReassembler::RemoveFragment(const AdvertisingKey& key) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    cache_.erase(it);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    ReleaseFragment(it->second);
+    index_.erase(it);
   }
 }
 
-bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) {
-  return FindFragment(key) != cache_.end();
+bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) const {
+  return index_.count(key) != 0;
 }
 
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator LeScanningReassembler::FindFragment(
-    const AdvertisingKey& key) {
-  for (auto it = cache_.begin(); it != cache_.end(); it++) {
-    if (it->key == key) {
-      return it;
-    }
+/// Return the fragment to the free list. The data is cleared but keeps
+/// its capacity for the next advertiser.
+void LeScanningReassembler::ReleaseFragment(size_t fragment) {
+  Unlink(fragment);
+  fragments_[fragment].data.clear();
+  fragments_[fragment].next = free_head_;
+  free_head_ = fragment;
+}
+
+void LeScanningReassembler::LinkFront(size_t fragment) {
+  fragments_[fragment].prev = kNoFragment;
+  fragments_[fragment].next = lru_head_;
+  if (lru_head_ != kNoFragment) {
+    fragments_[lru_head_].prev = fragment;
+  } else {
+    lru_tail_ = fragment;
+  }
+  lru_head_ = fragment;
+}
+
+void LeScanningReassembler::Unlink(size_t fragment) {
+  size_t prev = fragments_[fragment].prev;
+  size_t next = fragments_[fragment].next;
+  if (prev != kNoFragment) {
+    fragments_[prev].next = next;
+  } else {
+    lru_head_ = next;
+  }
+  if (next != kNoFragment) {
+    fragments_[next].prev = prev;
+  } else {
+    lru_tail_ = prev;
   }
-  return cache_.end();
+  fragments_[fragment].prev = kNoFragment;
+  fragments_[fragment].next = kNoFragment;
 }
 
 }  // namespace bluetooth::hci
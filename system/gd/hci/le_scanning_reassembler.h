@@ -17,9 +17,10 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <list>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "hci/address_with_type.h"
@@ -35,7 +36,11 @@ namespace bluetooth::hci {
 
 class LeScanningReassembler {
  public:
-  LeScanningReassembler(){};
+  /// Default number of advertisers for which incomplete advertising data
+  /// can be cached at the same time.
+  static constexpr size_t kDefaultCacheSize = 16;
+
+  explicit LeScanningReassembler(size_t cache_size = kDefaultCacheSize);
   LeScanningReassembler(const LeScanningReassembler&) = delete;
   LeScanningReassembler& operator=(const LeScanningReassembler&) = delete;
 
@@ -83,36 +88,53 @@ class LeScanningReassembler {
     std::optional<uint8_t> sid;
 
     AdvertisingKey(Address address, DirectAdvertisingAddressType address_type, uint8_t sid);
-    bool operator==(const AdvertisingKey& other);
+    bool operator==(const AdvertisingKey& other) const;
+  };
+
+  struct AdvertisingKeyHash {
+    size_t operator()(const AdvertisingKey& key) const;
   };
 
+  static constexpr size_t kNoFragment = SIZE_MAX;
+
   /// Packs incomplete advertising data.
+  /// Fragments are allocated once in a pool of cache_size entries and
+  /// linked by index into either the free list or the LRU list.
+  /// The data buffer is kept when the fragment is released, so that
+  /// the next advertiser using it appends without reallocating.
   struct AdvertisingFragment {
-    AdvertisingKey key;
+    AdvertisingKey key{Address::kEmpty, DirectAdvertisingAddressType::NO_ADDRESS_PROVIDED, 0xff};
     std::vector<uint8_t> data;
-
-    AdvertisingFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data)
-        : key(key), data(data.begin(), data.end()) {}
+    size_t prev{kNoFragment};
+    size_t next{kNoFragment};
   };
 
   /// Advertising cache for de-fragmenting extended advertising reports,
   /// and joining advertising reports with the matching scan response when
   /// applicable.
   /// The cached advertising data is removed as soon as the complete
-  /// advertisement is got (including the scan response).
-  static constexpr size_t kMaximumCacheSize = 16;
-  std::list<AdvertisingFragment> cache_;
+  /// advertisement is got (including the scan response). When the cache
+  /// is full the least recently updated advertiser is dropped.
+  std::vector<AdvertisingFragment> fragments_;
+  std::unordered_map<AdvertisingKey, size_t, AdvertisingKeyHash> index_;
+  /// Most and least recently updated fragments.
+  size_t lru_head_{kNoFragment};
+  size_t lru_tail_{kNoFragment};
+  /// Unused fragments, linked by next.
+  size_t free_head_{kNoFragment};
 
   /// Advertising cache management methods.
-  std::list<AdvertisingFragment>::iterator AppendFragment(
-      const AdvertisingKey& key, const std::vector<uint8_t>& data);
+  AdvertisingFragment& AppendFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data);
   void RemoveFragment(const AdvertisingKey& key);
-  bool ContainsFragment(const AdvertisingKey& key);
-  std::list<AdvertisingFragment>::iterator FindFragment(const AdvertisingKey& key);
+  bool ContainsFragment(const AdvertisingKey& key) const;
+  void ReleaseFragment(size_t fragment);
+  void LinkFront(size_t fragment);
+  void Unlink(size_t fragment);
 
   /// Trim the advertising data by removing empty or overflowing
   /// GAP Data entries.
   static std::vector<uint8_t> TrimAdvertisingData(const std::vector<uint8_t>& advertising_data);
+  static void TrimAdvertisingDataInPlace(std::vector<uint8_t>& advertising_data);
 
   FRIEND_TEST(LeScanningReassemblerTest, trim_advertising_data);
 };
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "hci/le_scanning_reassembler.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+// Event type fields.
+constexpr uint16_t kScannable = 0x2;
+constexpr uint16_t kScanResponse = 0x8;
+constexpr uint16_t kLegacy = 0x10;
+constexpr uint16_t kComplete = 0x0;
+constexpr uint16_t kContinuation = 0x20;
+
+constexpr uint8_t kSidNotPresent = 0xff;
+constexpr size_t kExtendedFragments = 3;
+
+struct AdvertisingReport {
+  uint16_t event_type;
+  uint8_t address_type;
+  Address address;
+  uint8_t advertising_sid;
+  std::vector<uint8_t> advertising_data;
+};
+
+// Advertising data made of a single GAP Data entry of |size| bytes
+std::vector<uint8_t> MakeAdvertisingData(size_t size, uint8_t value) {
+  std::vector<uint8_t> data(size, value);
+  data[0] = size - 1;
+  return data;
+}
+
+// The reports a scanner gets in one scan interval from |advertisers| devices, in the order controllers usually
+// deliver them: each device sends the first PDU of its advertising event before any of them sends the
+// following ones. A quarter of the devices use scannable legacy advertising, a quarter non scannable legacy
+// advertising, a quarter extended advertising split over kExtendedFragments reports, and the rest extended
+// advertising that fits in one report.
+std::vector<AdvertisingReport> MakeReportStream(size_t advertisers) {
+  std::vector<AdvertisingReport> first_reports;
+  std::vector<AdvertisingReport> following_reports[kExtendedFragments - 1];
+  for (size_t i = 0; i < advertisers; i++) {
+    Address address({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x33, 0x44, 0x55, 0x66});
+    uint8_t address_type =
+        static_cast<uint8_t>(i % 2 ? AddressType::RANDOM_DEVICE_ADDRESS : AddressType::PUBLIC_DEVICE_ADDRESS);
+    uint8_t sid = i % 16;
+    switch (i % 4) {
+      case 0:
+        first_reports.push_back(
+            {kLegacy | kScannable | kComplete, address_type, address, kSidNotPresent, MakeAdvertisingData(31, i)});
+        following_reports[0].push_back({kLegacy | kScannable | kScanResponse | kComplete,
+                                         address_type,
+                                         address,
+                                         kSidNotPresent,
+                                         MakeAdvertisingData(31, i)});
+        break;
+      case 1:
+        first_reports.push_back(
+            {kLegacy | kComplete, address_type, address, kSidNotPresent, MakeAdvertisingData(31, i)});
+        break;
+      case 2:
+        first_reports.push_back({kContinuation, address_type, address, sid, MakeAdvertisingData(229, i)});
+        following_reports[0].push_back({kContinuation, address_type, address, sid, MakeAdvertisingData(229, i)});
+        following_reports[1].push_back({kComplete, address_type, address, sid, MakeAdvertisingData(100, i)});
+        break;
+      default:
+        first_reports.push_back({kComplete, address_type, address, sid, MakeAdvertisingData(100, i)});
+        break;
+    }
+  }
+  std::vector<AdvertisingReport> stream = std::move(first_reports);
+  for (auto& reports : following_reports) {
+    stream.insert(stream.end(), reports.begin(), reports.end());
+  }
+  return stream;
+}
+
+// Args: number of advertisers in range, reassembler cache size
+void BM_LeScanningReassembler_process_report_stream(State& state) {
+  auto stream = MakeReportStream(state.range(0));
+  LeScanningReassembler reassembler(state.range(1));
+  size_t bytes = 0;
+  for (const auto& report : stream) {
+    bytes += report.advertising_data.size();
+  }
+  size_t completed = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& report : stream) {
+      auto advertising_data = reassembler.ProcessAdvertisingReport(
+          report.event_type, report.address_type, report.address, report.advertising_sid, report.advertising_data);
+      completed += advertising_data.has_value();
+      ::benchmark::DoNotOptimize(advertising_data);
+    }
+  }
+  counters.Report(stream.size(), bytes / stream.size());
+  // Advertisements reassembled per device and scan interval, below 1 when the cache drops incomplete data
+  state.counters["completed_per_advertiser"] =
+      static_cast<double>(completed) / (state.iterations() * static_cast<double>(state.range(0)));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LeScanningReassembler_process_report_stream)
+    ->Args({16, LeScanningReassembler::kDefaultCacheSize})
+    ->Args({256, LeScanningReassembler::kDefaultCacheSize})
+    ->Args({256, 256})
+    ->Args({2048, 2048});
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -41,6 +41,10 @@ static constexpr uint8_t kSidNotPresent = 0xff;
 // Test addresses.
 static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
 
+static Address MakeTestAddress(uint8_t index) {
+  return Address({index, 1, 2, 3, 4, 5});
+}
+
 class LeScanningReassemblerTest : public ::testing::Test {
  public:
   LeScanningReassembler reassembler_;
@@ -324,4 +328,82 @@ TEST_F(LeScanningReassemblerTest, interleaved_advertising) {
       std::vector<uint8_t>({0x2, 0x3, 0x3}));
 }
 
+TEST_F(LeScanningReassemblerTest, least_recently_updated_advertiser_is_dropped) {
+  LeScanningReassembler reassembler(4);
+
+  // Fill the cache with incomplete advertising data.
+  for (uint8_t i = 0; i < 4; i++) {
+    ASSERT_FALSE(reassembler
+                     .ProcessAdvertisingReport(
+                         kContinuation,
+                         (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                         MakeTestAddress(i),
+                         kSidNotPresent,
+                         {0x2, i})
+                     .has_value());
+  }
+
+  // Update the first advertiser, the second one is now the least
+  // recently updated.
+  ASSERT_FALSE(reassembler
+                   .ProcessAdvertisingReport(
+                       kContinuation,
+                       (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                       MakeTestAddress(0),
+                       kSidNotPresent,
+                       {0x0})
+                   .has_value());
+
+  // A new advertiser drops the second one.
+  ASSERT_FALSE(reassembler
+                   .ProcessAdvertisingReport(
+                       kContinuation,
+                       (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                       MakeTestAddress(4),
+                       kSidNotPresent,
+                       {0x2, 0x4})
+                   .has_value());
+
+  ASSERT_EQ(
+      reassembler.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, MakeTestAddress(0), kSidNotPresent, {0x1, 0x9}),
+      std::vector<uint8_t>({0x2, 0x0, 0x0, 0x1, 0x9}));
+  ASSERT_EQ(
+      reassembler.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, MakeTestAddress(1), kSidNotPresent, {0x1, 0x9}),
+      std::vector<uint8_t>({0x1, 0x9}));
+  for (uint8_t i = 2; i < 5; i++) {
+    ASSERT_EQ(
+        reassembler.ProcessAdvertisingReport(
+            kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, MakeTestAddress(i), kSidNotPresent, {0x9}),
+        std::vector<uint8_t>({0x2, i, 0x9}));
+  }
+}
+
+TEST_F(LeScanningReassemblerTest, complete_advertising_does_not_drop_cached_fragments) {
+  LeScanningReassembler reassembler(1);
+
+  ASSERT_FALSE(reassembler
+                   .ProcessAdvertisingReport(
+                       kContinuation,
+                       (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                       MakeTestAddress(0),
+                       kSidNotPresent,
+                       {0x2, 0x0})
+                   .has_value());
+
+  // Complete advertising data from other advertisers does not use the cache.
+  for (uint8_t i = 1; i < 4; i++) {
+    ASSERT_EQ(
+        reassembler.ProcessAdvertisingReport(
+            kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, MakeTestAddress(i), kSidNotPresent, {0x1, i, 0x0}),
+        std::vector<uint8_t>({0x1, i}));
+  }
+
+  ASSERT_EQ(
+      reassembler.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, MakeTestAddress(0), kSidNotPresent, {0x9}),
+      std::vector<uint8_t>({0x2, 0x0, 0x9}));
+}
+
 }  // namespace bluetooth::hci
@@ -17,10 +17,16 @@
 
 #include <hardware/bt_common_types.h>
 
+#include <atomic>
+#include <set>
+
+#include "common/bind.h"
 #include "hal/hci_hal.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
+#include "hci/msft_host_monitor_matcher.h"
 #include "hci/vendor_specific_event_manager.h"
+#include "os/alarm.h"
 
 namespace bluetooth {
 namespace hci {
@@ -53,6 +59,7 @@ struct MsftExtensionManager::impl {
     hal_ = hal;
     hci_layer_ = hci_layer;
     vendor_specific_event_manager_ = vendor_specific_event_manager;
+    lost_alarm_ = std::make_unique<os::Alarm>(module_handler_);
 
     /*
      * The MSFT opcode is assigned by Bluetooth controller vendors.
@@ -76,6 +83,8 @@ struct MsftExtensionManager::impl {
 
   void stop() {
     LOG_INFO("MsftExtensionManager stop()");
+    lost_alarm_->Cancel();
+    lost_alarm_.reset();
   }
 
   void handle_rssi_event(MsftRssiEventPayloadView view) {
@@ -139,7 +148,7 @@ struct MsftExtensionManager::impl {
 
   void msft_adv_monitor_add(const MsftAdvMonitor& monitor, MsftAdvMonitorAddCallback cb) {
     if (!supports_msft_extensions()) {
-      LOG_WARN("Disallowed as MSFT extension is not supported.");
+      add_host_monitor(monitor, cb);
       return;
     }
 
@@ -150,7 +159,8 @@ struct MsftExtensionManager::impl {
     // (255 - 1 (packet type) - 2 (OGF/OCF) - 1 (length) - 7 (MSFT command parameters)) /
     // 4 (min size of a pattern) = 61
     if (monitor.patterns.size() > 61) {
-      LOG_ERROR("Number of MSFT patterns %zu is too large", monitor.patterns.size());
+      LOG_INFO("Number of MSFT patterns %zu is too large, monitoring on the host", monitor.patterns.size());
+      add_host_monitor(monitor, cb);
       return;
     }
     for (auto& p : monitor.patterns) {
@@ -161,6 +171,7 @@ struct MsftExtensionManager::impl {
     }
 
     msft_adv_monitor_add_cb_ = cb;
+    pending_monitor_ = monitor;
     hci_layer_->EnqueueCommand(
         MsftLeMonitorAdvConditionPatternsBuilder::Create(
             static_cast<OpCode>(msft_.opcode.value()),
@@ -173,11 +184,20 @@ struct MsftExtensionManager::impl {
   }
 
   void msft_adv_monitor_remove(uint8_t monitor_handle, MsftAdvMonitorRemoveCallback cb) {
+    if (host_matcher_.HasMonitor(monitor_handle)) {
+      host_matcher_.RemoveMonitor(monitor_handle);
+      has_host_monitors_ = !host_matcher_.IsEmpty();
+      schedule_lost_check();
+      cb.Run(ErrorCode::SUCCESS);
+      return;
+    }
+
     if (!supports_msft_extensions()) {
       LOG_WARN("Disallowed as MSFT extension is not supported.");
       return;
     }
 
+    controller_monitor_handles_.erase(monitor_handle);
     msft_adv_monitor_remove_cb_ = cb;
     hci_layer_->EnqueueCommand(
         MsftLeCancelMonitorAdvBuilder::Create(
@@ -187,16 +207,78 @@ struct MsftExtensionManager::impl {
 
   void msft_adv_monitor_enable(bool enable, MsftAdvMonitorEnableCallback cb) {
     if (!supports_msft_extensions()) {
-      LOG_WARN("Disallowed as MSFT extension is not supported.");
+      adv_filter_enabled_ = false;
+      cb.Run(ErrorCode::SUCCESS);
       return;
     }
 
+    if (enable && !host_matcher_.IsEmpty()) {
+      LOG_INFO("Keeping the controller filter disabled for the monitors on the host");
+      enable = false;
+    }
+    adv_filter_enabled_ = enable;
     msft_adv_monitor_enable_cb_ = cb;
     hci_layer_->EnqueueCommand(
         MsftLeSetAdvFilterEnableBuilder::Create(static_cast<OpCode>(msft_.opcode.value()), enable),
         module_handler_->BindOnceOn(this, &impl::on_msft_adv_monitor_enable_complete));
   }
 
+  void add_host_monitor(const MsftAdvMonitor& monitor, MsftAdvMonitorAddCallback cb) {
+    // The controller allocates its handles from the bottom, take the host ones from the top
+    for (int handle = 0xff; handle >= 0; handle--) {
+      if (controller_monitor_handles_.count(handle) != 0 || host_matcher_.HasMonitor(handle)) {
+        continue;
+      }
+      host_matcher_.AddMonitor(handle, monitor);
+      has_host_monitors_ = true;
+      LOG_INFO("Monitoring advertisements on the host with handle %d", handle);
+      cb.Run(handle, ErrorCode::SUCCESS);
+      return;
+    }
+    LOG_WARN("No monitor handle left");
+    cb.Run(0, ErrorCode::MEMORY_CAPACITY_EXCEEDED);
+  }
+
+  void on_advertising_report(
+      uint8_t address_type, Address address, int8_t tx_power, int8_t rssi, std::vector<uint8_t> advertising_data) {
+    auto found = host_matcher_.OnAdvertisingReport(
+        address_type, address, tx_power, rssi, advertising_data, std::chrono::steady_clock::now());
+    if (found.empty()) {
+      return;
+    }
+    for (auto& info : found) {
+      scanning_callbacks_->OnTrackAdvFoundLost(std::move(info));
+    }
+    schedule_lost_check();
+  }
+
+  // Keeps the alarm set for the first device that can be lost. The deadlines only move later as devices are seen,
+  // the alarm is rescheduled when it fires early.
+  void schedule_lost_check() {
+    auto deadline = host_matcher_.GetNextLostDeadline();
+    if (!deadline.has_value()) {
+      lost_alarm_->Cancel();
+      lost_alarm_deadline_.reset();
+      return;
+    }
+    if (lost_alarm_deadline_.has_value() && lost_alarm_deadline_.value() <= deadline.value()) {
+      return;
+    }
+    lost_alarm_deadline_ = deadline;
+    auto delay = std::chrono::ceil<std::chrono::milliseconds>(deadline.value() - std::chrono::steady_clock::now());
+    lost_alarm_->Schedule(
+        common::BindOnce(&impl::on_lost_check, common::Unretained(this)),
+        std::max(delay, std::chrono::milliseconds(0)));
+  }
+
+  void on_lost_check() {
+    lost_alarm_deadline_.reset();
+    for (auto& info : host_matcher_.CheckLost(std::chrono::steady_clock::now())) {
+      scanning_callbacks_->OnTrackAdvFoundLost(std::move(info));
+    }
+    schedule_lost_check();
+  }
+
   void set_scanning_callback(ScanningCallback* callbacks) {
     scanning_callbacks_ = callbacks;
   }
@@ -256,6 +338,16 @@ struct MsftExtensionManager::impl {
       return;
     }
 
+    if (status_view.GetStatus() != ErrorCode::SUCCESS) {
+      // Most likely out of monitor slots
+      LOG_INFO(
+          "Controller did not add the monitor (%s), monitoring on the host",
+          ErrorCodeText(status_view.GetStatus()).c_str());
+      add_host_monitor(pending_monitor_, msft_adv_monitor_add_cb_);
+      return;
+    }
+
+    controller_monitor_handles_.insert(status_view.GetMonitorHandle());
     msft_adv_monitor_add_cb_.Run(status_view.GetMonitorHandle(), status_view.GetStatus());
   }
 
@@ -299,6 +391,14 @@ struct MsftExtensionManager::impl {
   MsftAdvMonitorRemoveCallback msft_adv_monitor_remove_cb_;
   MsftAdvMonitorEnableCallback msft_adv_monitor_enable_cb_;
   ScanningCallback* scanning_callbacks_;
+  MsftAdvMonitor pending_monitor_;
+  std::set<uint8_t> controller_monitor_handles_;
+  MsftHostMonitorMatcher host_matcher_;
+  std::unique_ptr<os::Alarm> lost_alarm_;
+  std::optional<std::chrono::steady_clock::time_point> lost_alarm_deadline_;
+  // Read from the scanning callbacks
+  std::atomic<bool> has_host_monitors_{false};
+  std::atomic<bool> adv_filter_enabled_{false};
 };
 
 MsftExtensionManager::MsftExtensionManager() {
@@ -350,5 +450,19 @@ void MsftExtensionManager::SetScanningCallback(ScanningCallback* callbacks) {
   CallOn(pimpl_.get(), &impl::set_scanning_callback, callbacks);
 }
 
+bool MsftExtensionManager::IsAdvFilterEnabled() {
+  return pimpl_->adv_filter_enabled_;
+}
+
+bool MsftExtensionManager::HasHostAdvMonitors() {
+  return pimpl_->has_host_monitors_;
+}
+
+void MsftExtensionManager::OnAdvertisingReport(
+    uint8_t address_type, Address address, int8_t tx_power, int8_t rssi, std::vector<uint8_t> advertising_data) {
+  CallOn(
+      pimpl_.get(), &impl::on_advertising_report, address_type, address, tx_power, rssi, std::move(advertising_data));
+}
+
 }  // namespace hci
 }  // namespace bluetooth
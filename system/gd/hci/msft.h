@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <vector>
+
+#include "hci/address.h"
 #include "hci/hci_packets.h"
 #include "hci/le_scanning_callback.h"
 #include "module.h"
@@ -37,11 +40,25 @@ class MsftExtensionManager : public bluetooth::Module {
   using MsftAdvMonitorEnableCallback = base::Callback<void(ErrorCode /* status */)>;
 
   virtual bool SupportsMsftExtensions();
+
+  // Monitors are offloaded to the controller when it supports the MSFT extension and has a free monitor slot, and
+  // matched on the host otherwise. The monitor handles of both are reported the same way.
   void MsftAdvMonitorAdd(const MsftAdvMonitor& monitor, MsftAdvMonitorAddCallback cb);
   void MsftAdvMonitorRemove(uint8_t monitor_handle, MsftAdvMonitorRemoveCallback cb);
+
+  // The controller filter stays disabled while monitors are matched on the host, as the host then needs all the
+  // advertisements. It is applied when enabled again after the monitors change.
   void MsftAdvMonitorEnable(bool enable, MsftAdvMonitorEnableCallback cb);
   void SetScanningCallback(ScanningCallback* callbacks);
 
+  // Whether the controller filters the advertisements with its monitors
+  bool IsAdvFilterEnabled();
+
+  // Whether monitors are matched on the host, which then needs the advertising reports
+  bool HasHostAdvMonitors();
+  void OnAdvertisingReport(
+      uint8_t address_type, Address address, int8_t tx_power, int8_t rssi, std::vector<uint8_t> advertising_data);
+
   static const ModuleFactory Factory;
 
  protected:
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/msft_host_monitor_matcher.h"
+
+#include <algorithm>
+
+namespace bluetooth::hci {
+
+namespace {
+
+// Monitor Device event states
+constexpr uint8_t kDeviceLost = 0x00;
+constexpr uint8_t kDeviceFound = 0x01;
+
+// The MSFT extension accepts low threshold time intervals of 1 to 60 seconds.
+constexpr uint8_t kMinLostTimeoutSeconds = 1;
+
+AdvertisingFilterOnFoundOnLostInfo make_event(
+    uint8_t monitor_handle, uint8_t advertiser_state, const AddressWithType& address_with_type) {
+  AdvertisingFilterOnFoundOnLostInfo info{};
+  info.monitor_handle = monitor_handle;
+  info.advertiser_state = advertiser_state;
+  info.advertiser_info_present = AdvtInfoPresent::NO_ADVT_INFO_PRESENT;
+  info.advertiser_address = address_with_type.GetAddress();
+  info.advertiser_address_type = static_cast<uint8_t>(address_with_type.GetAddressType());
+  return info;
+}
+
+}  // namespace
+
+void MsftHostMonitorMatcher::AddMonitor(uint8_t monitor_handle, const MsftAdvMonitor& monitor) {
+  auto lost_timeout =
+      std::chrono::seconds(std::max(monitor.rssi_threshold_low_time_interval, kMinLostTimeoutSeconds));
+  monitors_[monitor_handle] = Monitor{monitor, lost_timeout, {}};
+}
+
+void MsftHostMonitorMatcher::RemoveMonitor(uint8_t monitor_handle) {
+  monitors_.erase(monitor_handle);
+}
+
+std::vector<AdvertisingFilterOnFoundOnLostInfo> MsftHostMonitorMatcher::OnAdvertisingReport(
+    uint8_t address_type,
+    Address address,
+    int8_t tx_power,
+    int8_t rssi,
+    const std::vector<uint8_t>& advertising_data,
+    Clock::time_point now) {
+  std::vector<AdvertisingFilterOnFoundOnLostInfo> found;
+  AddressWithType address_with_type(address, static_cast<AddressType>(address_type));
+
+  for (auto& [monitor_handle, monitor] : monitors_) {
+    if (!MatchesPatterns(monitor.monitor, advertising_data)) {
+      continue;
+    }
+    auto device = monitor.devices.find(address_with_type);
+    if (device != monitor.devices.end()) {
+      if (rssi > static_cast<int8_t>(monitor.monitor.rssi_threshold_low)) {
+        device->second = now;
+      }
+      continue;
+    }
+    if (rssi < static_cast<int8_t>(monitor.monitor.rssi_threshold_high)) {
+      continue;
+    }
+    monitor.devices.emplace(address_with_type, now);
+    auto info = make_event(monitor_handle, kDeviceFound, address_with_type);
+    info.advertiser_info_present = AdvtInfoPresent::ADVT_INFO_PRESENT;
+    info.tx_power = static_cast<uint8_t>(tx_power);
+    info.rssi = rssi;
+    info.adv_packet = advertising_data;
+    found.push_back(std::move(info));
+  }
+  return found;
+}
+
+std::vector<AdvertisingFilterOnFoundOnLostInfo> MsftHostMonitorMatcher::CheckLost(Clock::time_point now) {
+  std::vector<AdvertisingFilterOnFoundOnLostInfo> lost;
+  for (auto& [monitor_handle, monitor] : monitors_) {
+    for (auto device = monitor.devices.begin(); device != monitor.devices.end();) {
+      if (now - device->second < monitor.lost_timeout) {
+        device++;
+        continue;
+      }
+      lost.push_back(make_event(monitor_handle, kDeviceLost, device->first));
+      device = monitor.devices.erase(device);
+    }
+  }
+  return lost;
+}
+
+std::optional<MsftHostMonitorMatcher::Clock::time_point> MsftHostMonitorMatcher::GetNextLostDeadline() const {
+  std::optional<Clock::time_point> deadline;
+  for (const auto& [monitor_handle, monitor] : monitors_) {
+    for (const auto& [address_with_type, last_in_range] : monitor.devices) {
+      auto device_deadline = last_in_range + monitor.lost_timeout;
+      if (!deadline.has_value() || device_deadline < deadline.value()) {
+        deadline = device_deadline;
+      }
+    }
+  }
+  return deadline;
+}
+
+bool MsftHostMonitorMatcher::MatchesPatterns(
+    const MsftAdvMonitor& monitor, const std::vector<uint8_t>& advertising_data) {
+  if (monitor.patterns.empty()) {
+    return true;
+  }
+  // Walk the AD structures once, each of them is compared to the patterns of its AD type
+  size_t offset = 0;
+  while (offset < advertising_data.size()) {
+    size_t length = advertising_data[offset];
+    if (length == 0 || offset + length >= advertising_data.size()) {
+      break;
+    }
+    uint8_t ad_type = advertising_data[offset + 1];
+    auto payload = advertising_data.begin() + offset + 2;
+    size_t payload_size = length - 1;
+    for (const auto& pattern : monitor.patterns) {
+      if (pattern.ad_type != ad_type || pattern.start_byte + pattern.pattern.size() > payload_size) {
+        continue;
+      }
+      if (std::equal(pattern.pattern.begin(), pattern.pattern.end(), payload + pattern.start_byte)) {
+        return true;
+      }
+    }
+    offset += length + 1;
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
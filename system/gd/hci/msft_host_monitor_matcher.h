@@ -0,0 +1,98 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <hardware/bt_common_types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/address_with_type.h"
+#include "hci/le_scanning_callback.h"
+
+namespace bluetooth::hci {
+
+/// The MSFT host monitor matcher applies MSFT advertisement monitors on the
+/// host, for controllers without the MSFT extension or without a free
+/// monitor slot.
+///
+/// It follows the controller semantics: a device is found when one of its
+/// reports matches a pattern of the monitor with an RSSI at or above the
+/// high threshold, and lost once no matching report was received above the
+/// low threshold for the low threshold time interval. A monitor without
+/// patterns matches all the reports.
+///
+/// The matcher only keeps the state, the caller passes the reports and the
+/// time, and checks for lost devices at the time returned by
+/// GetNextLostDeadline().
+class MsftHostMonitorMatcher {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  MsftHostMonitorMatcher() = default;
+  MsftHostMonitorMatcher(const MsftHostMonitorMatcher&) = delete;
+  MsftHostMonitorMatcher& operator=(const MsftHostMonitorMatcher&) = delete;
+
+  void AddMonitor(uint8_t monitor_handle, const MsftAdvMonitor& monitor);
+
+  /// Removes the monitor and forgets its devices, without reporting them lost,
+  /// like the controller does on LE Cancel Monitor Advertisement.
+  void RemoveMonitor(uint8_t monitor_handle);
+
+  bool HasMonitor(uint8_t monitor_handle) const {
+    return monitors_.count(monitor_handle) != 0;
+  }
+
+  bool IsEmpty() const {
+    return monitors_.empty();
+  }
+
+  /// Matches a complete advertising report. Returns the found events of the
+  /// monitors starting to track the device.
+  std::vector<AdvertisingFilterOnFoundOnLostInfo> OnAdvertisingReport(
+      uint8_t address_type,
+      Address address,
+      int8_t tx_power,
+      int8_t rssi,
+      const std::vector<uint8_t>& advertising_data,
+      Clock::time_point now);
+
+  /// Returns the lost events of the devices not seen in range for the low
+  /// threshold time interval of their monitor.
+  std::vector<AdvertisingFilterOnFoundOnLostInfo> CheckLost(Clock::time_point now);
+
+  /// Time at which the first tracked device is lost if it is not seen again.
+  std::optional<Clock::time_point> GetNextLostDeadline() const;
+
+ private:
+  struct Monitor {
+    MsftAdvMonitor monitor;
+    std::chrono::seconds lost_timeout;
+    /// Last time each tracked device was seen above the low threshold.
+    std::map<AddressWithType, Clock::time_point> devices;
+  };
+
+  std::map<uint8_t, Monitor> monitors_;
+
+  static bool MatchesPatterns(const MsftAdvMonitor& monitor, const std::vector<uint8_t>& advertising_data);
+};
+
+}  // namespace bluetooth::hci
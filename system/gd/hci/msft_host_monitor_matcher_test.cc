@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/msft_host_monitor_matcher.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+static constexpr uint8_t kMonitorHandle = 0xfe;
+static constexpr uint8_t kPublicAddressType = 0x00;
+static constexpr int8_t kTxPower = 0;
+static constexpr int8_t kHighThreshold = -60;
+static constexpr int8_t kLowThreshold = -80;
+static constexpr uint8_t kLostTimeoutSeconds = 5;
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+
+// Service data of the 16-bit UUID 0xfe2c, followed by the payload 0x01 0x02.
+static const std::vector<uint8_t> kMatchingData = {0x02, 0x01, 0x06, 0x05, 0x16, 0x2c, 0xfe, 0x01, 0x02};
+static const std::vector<uint8_t> kOtherData = {0x02, 0x01, 0x06, 0x05, 0x16, 0x2c, 0xfe, 0x03, 0x04};
+
+class MsftHostMonitorMatcherTest : public ::testing::Test {
+ protected:
+  void AddMonitor(std::vector<MsftAdvMonitorPattern> patterns) {
+    MsftAdvMonitor monitor{};
+    monitor.rssi_threshold_high = static_cast<uint8_t>(kHighThreshold);
+    monitor.rssi_threshold_low = static_cast<uint8_t>(kLowThreshold);
+    monitor.rssi_threshold_low_time_interval = kLostTimeoutSeconds;
+    monitor.patterns = std::move(patterns);
+    matcher_.AddMonitor(kMonitorHandle, monitor);
+  }
+
+  size_t Report(const std::vector<uint8_t>& data, int8_t rssi, Address address = kTestAddress) {
+    return matcher_.OnAdvertisingReport(kPublicAddressType, address, kTxPower, rssi, data, now_).size();
+  }
+
+  MsftHostMonitorMatcher matcher_;
+  MsftHostMonitorMatcher::Clock::time_point now_{};
+};
+
+TEST_F(MsftHostMonitorMatcherTest, found_above_high_threshold_only) {
+  AddMonitor({{0x16, 0x02, {0x01, 0x02}}});
+
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold - 1), 0u);
+  ASSERT_EQ(Report(kOtherData, kHighThreshold), 0u);
+
+  auto found =
+      matcher_.OnAdvertisingReport(kPublicAddressType, kTestAddress, kTxPower, kHighThreshold, kMatchingData, now_);
+  ASSERT_EQ(found.size(), 1u);
+  ASSERT_EQ(found[0].monitor_handle, kMonitorHandle);
+  ASSERT_EQ(found[0].advertiser_state, 0x01);
+  ASSERT_EQ(found[0].advertiser_address, kTestAddress);
+  ASSERT_EQ(found[0].adv_packet, kMatchingData);
+
+  // A device is found once
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold), 0u);
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold, kOtherAddress), 1u);
+}
+
+TEST_F(MsftHostMonitorMatcherTest, pattern_must_fit_in_ad_structure) {
+  AddMonitor({{0x16, 0x03, {0x02, 0x03}}});
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold), 0u);
+}
+
+TEST_F(MsftHostMonitorMatcherTest, monitor_without_patterns_matches_all) {
+  AddMonitor({});
+  ASSERT_EQ(Report(kOtherData, kHighThreshold), 1u);
+}
+
+TEST_F(MsftHostMonitorMatcherTest, lost_after_timeout_out_of_range) {
+  AddMonitor({});
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold), 1u);
+  ASSERT_EQ(matcher_.GetNextLostDeadline(), now_ + std::chrono::seconds(kLostTimeoutSeconds));
+
+  // Reports at or below the low threshold do not keep the device in range
+  now_ += std::chrono::seconds(3);
+  ASSERT_EQ(Report(kMatchingData, kLowThreshold), 0u);
+  ASSERT_TRUE(matcher_.CheckLost(now_).empty());
+
+  now_ += std::chrono::seconds(2);
+  auto lost = matcher_.CheckLost(now_);
+  ASSERT_EQ(lost.size(), 1u);
+  ASSERT_EQ(lost[0].advertiser_state, 0x00);
+  ASSERT_EQ(lost[0].advertiser_address, kTestAddress);
+  ASSERT_FALSE(matcher_.GetNextLostDeadline().has_value());
+}
+
+TEST_F(MsftHostMonitorMatcherTest, report_in_range_postpones_lost) {
+  AddMonitor({});
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold), 1u);
+
+  now_ += std::chrono::seconds(3);
+  ASSERT_EQ(Report(kMatchingData, kLowThreshold + 1), 0u);
+  now_ += std::chrono::seconds(3);
+  ASSERT_TRUE(matcher_.CheckLost(now_).empty());
+  ASSERT_EQ(matcher_.GetNextLostDeadline(), now_ + std::chrono::seconds(2));
+}
+
+TEST_F(MsftHostMonitorMatcherTest, removed_monitor_forgets_devices) {
+  AddMonitor({});
+  ASSERT_EQ(Report(kMatchingData, kHighThreshold), 1u);
+  matcher_.RemoveMonitor(kMonitorHandle);
+  ASSERT_TRUE(matcher_.IsEmpty());
+  ASSERT_FALSE(matcher_.GetNextLostDeadline().has_value());
+  ASSERT_TRUE(matcher_.CheckLost(now_ + std::chrono::seconds(kLostTimeoutSeconds)).empty());
+}
+
+}  // namespace bluetooth::hci
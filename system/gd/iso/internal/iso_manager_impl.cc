@@ -30,11 +30,15 @@ namespace internal {
 
 using bluetooth::hci::IsoBuilder;
 
+// Enough SDUs in flight for a few CISes at a 7.5ms SDU interval
+constexpr size_t kSduBufferPoolSize = 16;
+
 IsoManagerImpl::IsoManagerImpl(os::Handler* iso_handler, hci::HciLayer* hci_layer, hci::Controller* controller)
     : iso_handler_(iso_handler),
       hci_layer_(hci_layer),
       hci_le_iso_interface_(hci_layer->GetLeIsoInterface(iso_handler_->BindOn(this, &IsoManagerImpl::OnHciLeEvent))),
-      controller_(controller) {
+      controller_(controller),
+      sdu_buffer_pool_(kIsoSduHeadroom + kIsoMaxSduLength, kSduBufferPoolSize) {
   hci_layer_->GetIsoQueueEnd()->RegisterDequeue(
       iso_handler_, common::Bind(&IsoManagerImpl::OnIncomingPacket, common::Unretained(this)));
   iso_enqueue_buffer_ = std::make_unique<os::EnqueueBuffer<IsoBuilder>>(hci_layer_->GetIsoQueueEnd());
@@ -261,9 +265,30 @@ void IsoManagerImpl::SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> pac
   iso_enqueue_buffer_->Enqueue(std::move(builder), iso_handler_);
 }
 
+IsoSduBuffer IsoManagerImpl::AcquireSduBuffer() {
+  std::lock_guard<std::mutex> lock(sdu_buffer_pool_mutex_);
+  return IsoSduBuffer(sdu_buffer_pool_.Acquire());
+}
+
+void IsoManagerImpl::SendIsoSdu(
+    uint16_t cis_handle, IsoSduBuffer sdu, std::optional<uint32_t> time_stamp, uint16_t sequence_number) {
+  size_t max_data_load_length = controller_->GetControllerIsoBufferSize().le_data_packet_length_;
+  for (auto& fragment :
+       FragmentIsoSdu(cis_handle, std::move(sdu), time_stamp, sequence_number, max_data_load_length)) {
+    iso_enqueue_buffer_->Enqueue(std::move(fragment), iso_handler_);
+  }
+}
+
 void IsoManagerImpl::OnIncomingPacket() {
   std::unique_ptr<hci::IsoView> packet = hci_layer_->GetIsoQueueEnd()->TryDequeue();
-  iso_data_callback.Invoke(std::move(packet));
+  if (iso_sdu_callback.IsEmpty()) {
+    iso_data_callback.Invoke(std::move(packet));
+    return;
+  }
+  auto sdu = sdu_assembler_.OnIsoPacket(*packet);
+  if (sdu) {
+    iso_sdu_callback.Invoke(std::move(*sdu));
+  }
 }
 
 }  // namespace internal
@@ -16,18 +16,22 @@
 
 #pragma once
 
+#include "hal/receive_buffer_pool.h"
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
+#include "iso/internal/iso_sdu.h"
 #include "os/handler.h"
 
 #include <list>
+#include <mutex>
 
 namespace bluetooth {
 namespace iso {
 using SetCigParametersCallback = common::ContextualOnceCallback<void(std::vector<uint16_t>)>;
 using CisEstablishedCallback = common::ContextualCallback<void(uint16_t)>;
 using IsoDataCallback = common::ContextualCallback<void(std::unique_ptr<hci::IsoView>)>;
+using IsoSduCallback = common::ContextualCallback<void(IsoSdu)>;
 
 namespace internal {
 
@@ -50,6 +54,10 @@ class IsoManagerImpl {
     this->iso_data_callback = cb;
   }
 
+  void RegisterIsoSduCallback(IsoSduCallback cb) {
+    this->iso_sdu_callback = cb;
+  }
+
   void OnHciLeEvent(hci::LeMetaEventView event);
 
   void SetCigParameters(
@@ -95,6 +103,10 @@ class IsoManagerImpl {
   void RemoveCigComplete(hci::CommandCompleteView command_complete);
 
   void SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> packet);
+  // May be called from any thread
+  IsoSduBuffer AcquireSduBuffer();
+  void SendIsoSdu(
+      uint16_t cis_handle, IsoSduBuffer sdu, std::optional<uint32_t> time_stamp, uint16_t sequence_number);
   void OnIncomingPacket();
 
   bool IsKnownCig(uint8_t cig_id) {
@@ -108,10 +120,14 @@ class IsoManagerImpl {
   hci::HciLayer* hci_layer_;
   hci::LeIsoInterface* hci_le_iso_interface_;
   std::unique_ptr<os::EnqueueBuffer<bluetooth::hci::IsoBuilder>> iso_enqueue_buffer_;
-  hci::Controller* controller_ __attribute__((unused));
+  hci::Controller* controller_;
   std::list<IsochronousConnection> iso_connections_;
   CisEstablishedCallback cis_established_callback;
   IsoDataCallback iso_data_callback;
+  IsoSduCallback iso_sdu_callback;
+  std::mutex sdu_buffer_pool_mutex_;
+  hal::ReceiveBufferPool sdu_buffer_pool_;
+  IsoSduAssembler sdu_assembler_;
 };
 }  // namespace internal
 }  // namespace iso
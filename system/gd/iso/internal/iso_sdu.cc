@@ -0,0 +1,183 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "iso/internal/iso_sdu.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+#include "packet/fragment_builder.h"
+
+namespace bluetooth {
+namespace iso {
+
+namespace {
+
+constexpr size_t kTimeStampSize = 4;
+// Packet sequence number, then the SDU length and the packet status flag
+constexpr size_t kSequenceAndLengthSize = 4;
+
+size_t DataLoadHeaderSize(hci::TimeStampFlag ts_flag) {
+  return (ts_flag == hci::TimeStampFlag::PRESENT ? kTimeStampSize : 0) + kSequenceAndLengthSize;
+}
+
+}  // namespace
+
+IsoSduBuffer::IsoSduBuffer(std::shared_ptr<std::vector<uint8_t>> buffer) : buffer_(std::move(buffer)) {
+  ASSERT(buffer_ != nullptr && buffer_->size() > kIsoSduHeadroom);
+}
+
+void IsoSduBuffer::SetLength(size_t length) {
+  ASSERT_LOG(length <= std::min(capacity(), kIsoMaxSduLength), "SDU of %zu bytes is too long", length);
+  length_ = length;
+}
+
+std::vector<std::unique_ptr<hci::IsoBuilder>> FragmentIsoSdu(
+    uint16_t connection_handle,
+    IsoSduBuffer sdu,
+    std::optional<uint32_t> time_stamp,
+    uint16_t sequence_number,
+    size_t max_data_load_length) {
+  auto ts_flag = time_stamp ? hci::TimeStampFlag::PRESENT : hci::TimeStampFlag::NOT_PRESENT;
+  size_t begin = kIsoSduHeadroom - DataLoadHeaderSize(ts_flag);
+  size_t end = kIsoSduHeadroom + sdu.length_;
+  if (max_data_load_length == 0) {
+    max_data_load_length = end - begin;
+  }
+  ASSERT(max_data_load_length > DataLoadHeaderSize(ts_flag));
+
+  uint8_t* header = sdu.buffer_->data() + begin;
+  if (time_stamp) {
+    for (size_t i = 0; i < kTimeStampSize; i++) {
+      *header++ = *time_stamp >> (8 * i);
+    }
+  }
+  uint16_t length_and_status = sdu.length_ | static_cast<uint16_t>(hci::IsoPacketStatusFlag::VALID) << 14;
+  *header++ = sequence_number;
+  *header++ = sequence_number >> 8;
+  *header++ = length_and_status;
+  *header++ = length_and_status >> 8;
+
+  std::vector<std::unique_ptr<hci::IsoBuilder>> fragments;
+  std::shared_ptr<const std::vector<uint8_t>> buffer = std::move(sdu.buffer_);
+  for (size_t fragment_begin = begin; fragment_begin < end;) {
+    size_t fragment_end = std::min(end, fragment_begin + max_data_load_length);
+    bool first = fragments.empty();
+    bool last = fragment_end == end;
+    hci::IsoPacketBoundaryFlag pb_flag;
+    if (first) {
+      pb_flag = last ? hci::IsoPacketBoundaryFlag::COMPLETE_SDU : hci::IsoPacketBoundaryFlag::FIRST_FRAGMENT;
+    } else {
+      pb_flag = last ? hci::IsoPacketBoundaryFlag::LAST_FRAGMENT : hci::IsoPacketBoundaryFlag::CONTINUATION_FRAGMENT;
+    }
+    // The time stamp flag describes the data load header, which only the first fragment carries
+    fragments.push_back(hci::IsoBuilder::Create(
+        connection_handle,
+        pb_flag,
+        first ? ts_flag : hci::TimeStampFlag::NOT_PRESENT,
+        std::make_unique<packet::FragmentBuilder>(buffer, fragment_begin, fragment_end)));
+    fragment_begin = fragment_end;
+  }
+  return fragments;
+}
+
+std::optional<IsoSdu> IsoSduAssembler::OnIsoPacket(hci::IsoView packet) {
+  if (!packet.IsValid()) {
+    LOG_WARN("Dropping invalid ISO packet");
+    dropped_packets_++;
+    return std::nullopt;
+  }
+  uint16_t connection_handle = packet.GetConnectionHandle();
+  auto pb_flag = packet.GetPbFlag();
+  auto data_load = packet.GetPayload();
+
+  if (pb_flag == hci::IsoPacketBoundaryFlag::CONTINUATION_FRAGMENT ||
+      pb_flag == hci::IsoPacketBoundaryFlag::LAST_FRAGMENT) {
+    auto pending = pending_.find(connection_handle);
+    if (pending == pending_.end()) {
+      LOG_WARN("Dropping ISO fragment without a first fragment on handle 0x%04hx", connection_handle);
+      dropped_packets_++;
+      return std::nullopt;
+    }
+    pending->second.payload.AppendFragment(data_load);
+    if (pending->second.payload.size() > pending->second.sdu_length) {
+      Drop(connection_handle, "longer than announced");
+      return std::nullopt;
+    }
+    if (pb_flag == hci::IsoPacketBoundaryFlag::CONTINUATION_FRAGMENT) {
+      return std::nullopt;
+    }
+    if (pending->second.payload.size() != pending->second.sdu_length) {
+      Drop(connection_handle, "shorter than announced");
+      return std::nullopt;
+    }
+    IsoSdu sdu = std::move(pending->second.sdu);
+    sdu.payload = pending->second.payload;
+    pending_.erase(pending);
+    return sdu;
+  }
+
+  if (pending_.count(connection_handle) != 0) {
+    Drop(connection_handle, "interrupted by a new SDU");
+  }
+  auto ts_flag = packet.GetTsFlag();
+  size_t header_size = DataLoadHeaderSize(ts_flag);
+  if (data_load.size() < header_size) {
+    LOG_WARN("Dropping ISO packet too short for its header on handle 0x%04hx", connection_handle);
+    dropped_packets_++;
+    return std::nullopt;
+  }
+  auto it = data_load.begin();
+  std::optional<uint32_t> time_stamp;
+  if (ts_flag == hci::TimeStampFlag::PRESENT) {
+    time_stamp = it.extract<uint32_t>();
+  }
+  uint16_t sequence_number = it.extract<uint16_t>();
+  uint16_t length_and_status = it.extract<uint16_t>();
+  size_t sdu_length = length_and_status & kIsoMaxSduLength;
+  IsoSdu sdu = {
+      .connection_handle = connection_handle,
+      .time_stamp = time_stamp,
+      .sequence_number = sequence_number,
+      .packet_status_flag = static_cast<hci::IsoPacketStatusFlag>(length_and_status >> 14),
+      .payload = data_load.GetLittleEndianSubview(header_size, data_load.size()),
+  };
+
+  if (pb_flag == hci::IsoPacketBoundaryFlag::FIRST_FRAGMENT) {
+    RecombinationView payload(sdu.payload);
+    pending_.emplace(
+        connection_handle, PendingSdu{.sdu = std::move(sdu), .payload = payload, .sdu_length = sdu_length});
+    return std::nullopt;
+  }
+  if (sdu.payload.size() != sdu_length) {
+    LOG_WARN(
+        "Dropping ISO SDU of %zu bytes announcing %zu on handle 0x%04hx",
+        sdu.payload.size(),
+        sdu_length,
+        connection_handle);
+    dropped_packets_++;
+    return std::nullopt;
+  }
+  return sdu;
+}
+
+void IsoSduAssembler::Drop(uint16_t connection_handle, const char* reason) {
+  LOG_WARN("Dropping partial ISO SDU on handle 0x%04hx, %s", connection_handle, reason);
+  pending_.erase(connection_handle);
+  dropped_packets_++;
+}
+
+}  // namespace iso
+}  // namespace bluetooth
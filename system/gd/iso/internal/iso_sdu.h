@@ -0,0 +1,114 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/hci_packets.h"
+#include "packet/packet_view.h"
+
+namespace bluetooth {
+namespace iso {
+
+// Room an SDU buffer keeps in front of the SDU for the ISO_Data_Load header of its first fragment: time stamp, packet
+// sequence number and SDU length
+constexpr size_t kIsoSduHeadroom = 8;
+constexpr size_t kIsoMaxSduLength = 0x0fff;
+
+// An outgoing SDU, written in place into a pooled buffer. The buffer goes back to its pool once the last fragment of
+// the SDU was handed to the HAL.
+class IsoSduBuffer {
+ public:
+  explicit IsoSduBuffer(std::shared_ptr<std::vector<uint8_t>> buffer);
+
+  uint8_t* data() {
+    return buffer_->data() + kIsoSduHeadroom;
+  }
+  size_t capacity() const {
+    return buffer_->size() - kIsoSduHeadroom;
+  }
+
+  // Number of bytes of the SDU written to data()
+  void SetLength(size_t length);
+  size_t length() const {
+    return length_;
+  }
+
+ private:
+  friend std::vector<std::unique_ptr<hci::IsoBuilder>> FragmentIsoSdu(
+      uint16_t, IsoSduBuffer, std::optional<uint32_t>, uint16_t, size_t);
+
+  std::shared_ptr<std::vector<uint8_t>> buffer_;
+  size_t length_ = 0;
+};
+
+// Splits |sdu| into ISO data packets carrying at most |max_data_load_length| bytes each, 0 for no limit. The header of
+// the first fragment is written into the headroom of the buffer and every fragment refers to its range of the buffer,
+// so the SDU is only copied once, when the HCI layer serializes the packets for the HAL.
+std::vector<std::unique_ptr<hci::IsoBuilder>> FragmentIsoSdu(
+    uint16_t connection_handle,
+    IsoSduBuffer sdu,
+    std::optional<uint32_t> time_stamp,
+    uint16_t sequence_number,
+    size_t max_data_load_length);
+
+// An incoming SDU. The payload refers to the received ISO data packets, without copying their fragments together.
+struct IsoSdu {
+  uint16_t connection_handle;
+  std::optional<uint32_t> time_stamp;
+  uint16_t sequence_number;
+  hci::IsoPacketStatusFlag packet_status_flag;
+  packet::PacketView<packet::kLittleEndian> payload;
+};
+
+// Reassembles the SDUs of each connection out of the ISO data packets received from the controller.
+class IsoSduAssembler {
+ public:
+  // Returns the SDU that |packet| completes, if any
+  std::optional<IsoSdu> OnIsoPacket(hci::IsoView packet);
+
+  size_t GetDroppedPacketCount() const {
+    return dropped_packets_;
+  }
+
+ private:
+  class RecombinationView : public packet::PacketView<packet::kLittleEndian> {
+   public:
+    explicit RecombinationView(const PacketView& view) : PacketView(view) {}
+    void AppendFragment(PacketView fragment) {
+      Append(fragment);
+    }
+  };
+
+  struct PendingSdu {
+    IsoSdu sdu;
+    RecombinationView payload;
+    size_t sdu_length;
+  };
+
+  void Drop(uint16_t connection_handle, const char* reason);
+
+  std::unordered_map<uint16_t, PendingSdu> pending_;
+  size_t dropped_packets_ = 0;
+};
+
+}  // namespace iso
+}  // namespace bluetooth
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "iso/internal/iso_sdu.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace bluetooth {
+namespace iso {
+namespace {
+
+constexpr uint16_t kHandle = 0x60;
+
+IsoSduBuffer MakeSdu(size_t length) {
+  IsoSduBuffer sdu(std::make_shared<std::vector<uint8_t>>(kIsoSduHeadroom + kIsoMaxSduLength));
+  for (size_t i = 0; i < length; i++) {
+    sdu.data()[i] = static_cast<uint8_t>(i);
+  }
+  sdu.SetLength(length);
+  return sdu;
+}
+
+// Serializes the packets as the HCI layer would, then parses them as received ones
+std::vector<hci::IsoView> Loopback(const std::vector<std::unique_ptr<hci::IsoBuilder>>& packets) {
+  std::vector<hci::IsoView> views;
+  for (auto& packet : packets) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>(packet->SerializeToBytes());
+    views.push_back(hci::IsoView::Create(packet::PacketView<packet::kLittleEndian>(bytes)));
+  }
+  return views;
+}
+
+std::vector<uint8_t> Bytes(const packet::PacketView<packet::kLittleEndian>& view) {
+  return std::vector<uint8_t>(view.begin(), view.end());
+}
+
+TEST(IsoSduTest, complete_sdu_with_time_stamp) {
+  auto sdu = MakeSdu(40);
+  auto packets = FragmentIsoSdu(kHandle, sdu, 0x12345678, 7, 0);
+  ASSERT_EQ(1ul, packets.size());
+
+  auto views = Loopback(packets);
+  ASSERT_TRUE(views[0].IsValid());
+  ASSERT_EQ(hci::IsoPacketBoundaryFlag::COMPLETE_SDU, views[0].GetPbFlag());
+  auto with_time_stamp = hci::IsoWithTimestampView::Create(views[0]);
+  ASSERT_TRUE(with_time_stamp.IsValid());
+  ASSERT_EQ(0x12345678u, with_time_stamp.GetTimeStamp());
+  ASSERT_EQ(7, with_time_stamp.GetPacketSequenceNumber());
+  ASSERT_EQ(40ul, with_time_stamp.GetPayload().size());
+
+  IsoSduAssembler assembler;
+  auto received = assembler.OnIsoPacket(views[0]);
+  ASSERT_TRUE(received.has_value());
+  ASSERT_EQ(kHandle, received->connection_handle);
+  ASSERT_EQ(0x12345678u, received->time_stamp);
+  ASSERT_EQ(7, received->sequence_number);
+  ASSERT_EQ(hci::IsoPacketStatusFlag::VALID, received->packet_status_flag);
+  ASSERT_EQ(std::vector<uint8_t>(sdu.data(), sdu.data() + 40), Bytes(received->payload));
+}
+
+TEST(IsoSduTest, fragmented_sdu_is_reassembled) {
+  auto sdu = MakeSdu(100);
+  auto packets = FragmentIsoSdu(kHandle, sdu, std::nullopt, 3, 30);
+  // 4 header bytes and 100 SDU bytes in data loads of 30
+  ASSERT_EQ(4ul, packets.size());
+
+  auto views = Loopback(packets);
+  ASSERT_EQ(hci::IsoPacketBoundaryFlag::FIRST_FRAGMENT, views[0].GetPbFlag());
+  ASSERT_EQ(hci::IsoPacketBoundaryFlag::CONTINUATION_FRAGMENT, views[1].GetPbFlag());
+  ASSERT_EQ(hci::IsoPacketBoundaryFlag::CONTINUATION_FRAGMENT, views[2].GetPbFlag());
+  ASSERT_EQ(hci::IsoPacketBoundaryFlag::LAST_FRAGMENT, views[3].GetPbFlag());
+  for (auto& view : views) {
+    ASSERT_EQ(hci::TimeStampFlag::NOT_PRESENT, view.GetTsFlag());
+  }
+
+  IsoSduAssembler assembler;
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_FALSE(assembler.OnIsoPacket(views[i]).has_value());
+  }
+  auto received = assembler.OnIsoPacket(views[3]);
+  ASSERT_TRUE(received.has_value());
+  ASSERT_FALSE(received->time_stamp.has_value());
+  ASSERT_EQ(3, received->sequence_number);
+  ASSERT_EQ(std::vector<uint8_t>(sdu.data(), sdu.data() + 100), Bytes(received->payload));
+  ASSERT_EQ(0ul, assembler.GetDroppedPacketCount());
+}
+
+TEST(IsoSduTest, buffer_is_released_with_the_last_fragment) {
+  auto buffer = std::make_shared<std::vector<uint8_t>>(kIsoSduHeadroom + 64);
+  IsoSduBuffer sdu(buffer);
+  sdu.SetLength(64);
+  auto packets = FragmentIsoSdu(kHandle, std::move(sdu), std::nullopt, 0, 20);
+  ASSERT_GT(buffer.use_count(), 1);
+  packets.clear();
+  ASSERT_EQ(1, buffer.use_count());
+}
+
+TEST(IsoSduTest, orphan_fragments_are_dropped) {
+  auto packets = FragmentIsoSdu(kHandle, MakeSdu(50), std::nullopt, 0, 30);
+  auto views = Loopback(packets);
+  ASSERT_EQ(2ul, views.size());
+
+  IsoSduAssembler assembler;
+  ASSERT_FALSE(assembler.OnIsoPacket(views[1]).has_value());
+  ASSERT_EQ(1ul, assembler.GetDroppedPacketCount());
+}
+
+TEST(IsoSduTest, interrupted_sdu_is_dropped) {
+  auto first = Loopback(FragmentIsoSdu(kHandle, MakeSdu(50), std::nullopt, 0, 30));
+  auto second = Loopback(FragmentIsoSdu(kHandle, MakeSdu(10), std::nullopt, 1, 30));
+
+  IsoSduAssembler assembler;
+  ASSERT_FALSE(assembler.OnIsoPacket(first[0]).has_value());
+  auto received = assembler.OnIsoPacket(second[0]);
+  ASSERT_TRUE(received.has_value());
+  ASSERT_EQ(1, received->sequence_number);
+  ASSERT_EQ(1ul, assembler.GetDroppedPacketCount());
+  // The rest of the interrupted SDU has nothing to complete anymore
+  ASSERT_FALSE(assembler.OnIsoPacket(first[1]).has_value());
+  ASSERT_EQ(2ul, assembler.GetDroppedPacketCount());
+}
+
+}  // namespace
+}  // namespace iso
+}  // namespace bluetooth
@@ -30,6 +30,10 @@ void IsoManager::RegisterIsoDataCallback(IsoDataCallback cb) {
   iso_handler_->CallOn(iso_manager_impl_, &internal::IsoManagerImpl::RegisterIsoDataCallback, cb);
 }
 
+void IsoManager::RegisterIsoSduCallback(IsoSduCallback cb) {
+  iso_handler_->CallOn(iso_manager_impl_, &internal::IsoManagerImpl::RegisterIsoSduCallback, cb);
+}
+
 void IsoManager::SetCigParameters(
     uint8_t cig_id,
     uint32_t sdu_interval_m_to_s,
@@ -100,5 +104,20 @@ void IsoManager::SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> packet)
   iso_handler_->CallOn(iso_manager_impl_, &internal::IsoManagerImpl::SendIsoPacket, cis_handle, packet);
 }
 
+IsoSduBuffer IsoManager::AcquireSduBuffer() {
+  return iso_manager_impl_->AcquireSduBuffer();
+}
+
+void IsoManager::SendIsoSdu(
+    uint16_t cis_handle, IsoSduBuffer sdu, std::optional<uint32_t> time_stamp, uint16_t sequence_number) {
+  iso_handler_->CallOn(
+      iso_manager_impl_,
+      &internal::IsoManagerImpl::SendIsoSdu,
+      cis_handle,
+      std::move(sdu),
+      time_stamp,
+      sequence_number);
+}
+
 }  // namespace iso
 }  // namespace bluetooth
@@ -30,6 +30,7 @@ namespace iso {
 using SetCigParametersCallback = common::ContextualOnceCallback<void(std::vector<uint16_t> /* connectino handles*/)>;
 using CisEstablishedCallback = common::ContextualCallback<void(uint16_t)>;
 using IsoDataCallback = common::ContextualCallback<void(std::unique_ptr<hci::IsoView>)>;
+using IsoSduCallback = common::ContextualCallback<void(IsoSdu)>;
 
 /**
  * Manages the iso attributes, pairing, bonding of devices, and the
@@ -44,6 +45,8 @@ class IsoManager {
 
   void RegisterIsoEstablishedCallback(CisEstablishedCallback cb);
   void RegisterIsoDataCallback(IsoDataCallback cb);
+  // Once registered, received ISO packets are reassembled into SDUs instead of going to the IsoDataCallback
+  void RegisterIsoSduCallback(IsoSduCallback cb);
 
   void SetCigParameters(
       uint8_t cig_id,
@@ -76,6 +79,13 @@ class IsoManager {
 
   void SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> packet);
 
+  // Returns a pooled buffer to write an SDU into, then pass to SendIsoSdu. May be called from any thread.
+  IsoSduBuffer AcquireSduBuffer();
+  // Sends |sdu|, fragmented to the ISO buffer size of the controller. The buffer goes back to the pool once the
+  // last fragment was handed to the HAL.
+  void SendIsoSdu(
+      uint16_t cis_handle, IsoSduBuffer sdu, std::optional<uint32_t> time_stamp, uint16_t sequence_number);
+
  protected:
   IsoManager(os::Handler* iso_handler, internal::IsoManagerImpl* iso_manager_impl)
       : iso_handler_(iso_handler), iso_manager_impl_(iso_manager_impl) {}
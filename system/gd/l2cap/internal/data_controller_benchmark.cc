@@ -0,0 +1,248 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_helpers.h"
+#include "common/bidi_queue.h"
+#include "common/bind.h"
+#include "l2cap/internal/enhanced_retransmission_mode_channel_data_controller.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/le_credit_based_channel_data_controller.h"
+#include "l2cap/internal/scheduler.h"
+#include "l2cap/l2cap_packets.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+using ::bluetooth::benchmark::CompletionCounter;
+using ::bluetooth::benchmark::PacketCounters;
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+constexpr Cid kCid = 0x41;
+constexpr uint16_t kLeMps = 251;
+constexpr uint16_t kLeCredits = 100;
+constexpr uint8_t kErtmMaxTxSeq = 64;
+
+packet::PacketView<packet::kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet->size());
+  packet::BitInserter i(*bytes);
+  packet->Serialize(i);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+// Counts the packets a data controller made ready, in place of the link scheduler
+class CountingScheduler : public Scheduler {
+ public:
+  void OnPacketsReady(Cid cid, int number_packets) override {
+    ready_ += number_packets;
+  }
+
+  int TakeReady() {
+    int ready = ready_;
+    ready_ = 0;
+    return ready;
+  }
+
+ private:
+  int ready_ = 0;
+};
+
+class FakeLink : public ILink {
+ public:
+  void SendDisconnectionRequest(Cid local_cid, Cid remote_cid) override {}
+  hci::AddressWithType GetDevice() const override {
+    return {};
+  }
+};
+
+// Drives a data controller directly, the way a link's sender and receiver do, with the channel's up end drained on
+// a separate handler
+class BM_DataController : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = new os::Thread("channel_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    channel_queue_ = std::make_unique<common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue>>(10);
+    completed_ = std::make_unique<CompletionCounter>();
+    channel_queue_->GetUpEnd()->RegisterDequeue(
+        handler_, common::Bind(&BM_DataController::on_sdu_ready, common::Unretained(this)));
+  }
+
+  void TearDown(State& st) override {
+    channel_queue_->GetUpEnd()->UnregisterDequeue();
+    handler_->Clear();
+    channel_queue_.reset();
+    delete handler_;
+    delete thread_;
+    completed_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void on_sdu_ready() {
+    auto sdu = channel_queue_->GetUpEnd()->TryDequeue();
+    ::benchmark::DoNotOptimize(sdu->size());
+    completed_->Add();
+  }
+
+  // Serialize every packet |controller| made ready, as the sender does, and return how many there were
+  int SendReadyPackets(DataController* controller) {
+    int ready = scheduler_.TakeReady();
+    for (int i = 0; i < ready; i++) {
+      bytes_.clear();
+      packet::BitInserter inserter(bytes_);
+      controller->GetNextPacket()->Serialize(inserter);
+    }
+    return ready;
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+  std::unique_ptr<common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue>> channel_queue_;
+  std::unique_ptr<CompletionCounter> completed_;
+  CountingScheduler scheduler_;
+  FakeLink link_;
+  std::vector<uint8_t> bytes_;
+};
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(BM_DataController, le_credit_transmit_vary_by_sdu_size)(State& state) {
+  LeCreditBasedDataController controller{&link_, kCid, kCid, channel_queue_->GetDownEnd(), handler_, &scheduler_};
+  controller.SetMtu(0xffff);
+  controller.SetMps(kLeMps);
+  controller.OnCredit(kLeCredits);
+  std::vector<uint8_t> sdu(state.range(0), 0xa5);
+
+  int64_t pdus = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    controller.OnSdu(std::make_unique<packet::RawBuilder>(sdu));
+    // The peer returns a credit for every K-frame it received
+    int sent = SendReadyPackets(&controller);
+    controller.OnCredit(sent);
+    pdus += sent;
+  }
+  counters.Report(pdus / std::max<int64_t>(state.iterations(), 1), sdu.size());
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, le_credit_transmit_vary_by_sdu_size)->Arg(23)->Arg(247)->Arg(2000);
+
+BENCHMARK_DEFINE_F(BM_DataController, le_credit_receive_vary_by_sdu_size)(State& state) {
+  LeCreditBasedDataController controller{&link_, kCid, kCid, channel_queue_->GetDownEnd(), handler_, &scheduler_};
+  controller.SetMtu(0xffff);
+  // OnPdu checks the MPS against the whole K-frame, basic L2CAP header and SDU length included
+  controller.SetMps(kLeMps + 4);
+
+  // Segment one SDU the way the peer would, using a second controller
+  LeCreditBasedDataController peer{&link_, kCid, kCid, channel_queue_->GetDownEnd(), handler_, &scheduler_};
+  peer.SetMtu(0xffff);
+  peer.SetMps(kLeMps);
+  peer.OnCredit(kLeCredits);
+  std::vector<uint8_t> sdu(state.range(0), 0xa5);
+  peer.OnSdu(std::make_unique<packet::RawBuilder>(sdu));
+  std::vector<packet::PacketView<packet::kLittleEndian>> pdus;
+  for (int ready = scheduler_.TakeReady(); ready > 0; ready--) {
+    pdus.push_back(GetPacketView(peer.GetNextPacket()));
+  }
+
+  uint64_t received = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    for (const auto& pdu : pdus) {
+      controller.OnPdu(pdu);
+    }
+    completed_->WaitFor(++received);
+  }
+  counters.Report(pdus.size(), sdu.size() / pdus.size());
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, le_credit_receive_vary_by_sdu_size)
+    ->Arg(23)
+    ->Arg(247)
+    ->Arg(2000)
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_DataController, ertm_transmit_vary_by_sdu_size)(State& state) {
+  ErtmController controller{&link_, kCid, kCid, channel_queue_->GetDownEnd(), handler_, &scheduler_};
+  std::vector<uint8_t> sdu(state.range(0), 0xa5);
+
+  // Acknowledge every I-frame right away so that the transmit window never fills up
+  std::vector<packet::PacketView<packet::kLittleEndian>> acks;
+  for (uint8_t req_seq = 0; req_seq < kErtmMaxTxSeq; req_seq++) {
+    acks.push_back(GetPacketView(EnhancedSupervisoryFrameBuilder::Create(
+        kCid, SupervisoryFunction::RECEIVER_READY, Poll::NOT_SET, Final::NOT_SET, (req_seq + 1) % kErtmMaxTxSeq)));
+  }
+
+  uint8_t tx_seq = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    controller.OnSdu(std::make_unique<packet::RawBuilder>(sdu));
+    SendReadyPackets(&controller);
+    controller.OnPdu(acks[tx_seq]);
+    tx_seq = (tx_seq + 1) % kErtmMaxTxSeq;
+  }
+  counters.Report(1, sdu.size());
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, ertm_transmit_vary_by_sdu_size)->Arg(23)->Arg(247)->Arg(1000);
+
+BENCHMARK_DEFINE_F(BM_DataController, ertm_receive_vary_by_sdu_size)(State& state) {
+  ErtmController controller{&link_, kCid, kCid, channel_queue_->GetDownEnd(), handler_, &scheduler_};
+  std::vector<uint8_t> sdu(state.range(0), 0xa5);
+
+  std::vector<packet::PacketView<packet::kLittleEndian>> i_frames;
+  for (uint8_t tx_seq = 0; tx_seq < kErtmMaxTxSeq; tx_seq++) {
+    i_frames.push_back(GetPacketView(EnhancedInformationFrameBuilder::Create(
+        kCid,
+        tx_seq,
+        Final::NOT_SET,
+        0,
+        SegmentationAndReassembly::UNSEGMENTED,
+        std::make_unique<packet::RawBuilder>(sdu))));
+  }
+
+  uint64_t received = 0;
+  PacketCounters counters(state);
+  for (auto _ : state) {
+    controller.OnPdu(i_frames[received % kErtmMaxTxSeq]);
+    // Send the acknowledgements the controller scheduled
+    SendReadyPackets(&controller);
+    completed_->WaitFor(++received);
+  }
+  counters.Report(1, sdu.size());
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, ertm_receive_vary_by_sdu_size)
+    ->Arg(23)
+    ->Arg(247)
+    ->Arg(1000)
+    ->UseRealTime();
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
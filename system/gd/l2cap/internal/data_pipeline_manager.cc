@@ -16,6 +16,7 @@
 
 #include <unordered_map>
 
+#include "common/init_flags.h"
 #include "l2cap/cid.h"
 #include "l2cap/internal/channel_impl.h"
 #include "l2cap/internal/data_controller.h"
@@ -27,6 +28,17 @@ namespace bluetooth {
 namespace l2cap {
 namespace internal {
 
+std::unique_ptr<Scheduler> DataPipelineManager::create_scheduler(
+    SchedulerType scheduler_type, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler) {
+  switch (scheduler_type) {
+    case SchedulerType::FIFO:
+      return std::make_unique<Fifo>(this, link_queue_up_end, handler);
+    case SchedulerType::WEIGHTED_FAIR_QUEUE:
+      return std::make_unique<WeightedFairQueue>(this, link_queue_up_end, handler);
+  }
+  return std::make_unique<Fifo>(this, link_queue_up_end, handler);
+}
+
 void DataPipelineManager::AttachChannel(Cid cid, std::shared_ptr<ChannelImpl> channel, ChannelMode mode) {
   ASSERT(sender_map_.find(cid) == sender_map_.end());
   sender_map_.emplace(std::piecewise_construct, std::forward_as_tuple(cid),
@@ -62,6 +74,18 @@ void DataPipelineManager::SetChannelTxPriority(Cid cid, bool high_priority) {
   scheduler_->SetChannelTxPriority(cid, high_priority);
 }
 
+void DataPipelineManager::SetChannelTxWeight(Cid cid, uint16_t weight) {
+  ASSERT(sender_map_.find(cid) != sender_map_.end());
+  scheduler_->SetChannelTxWeight(cid, weight);
+}
+
+DataPipelineManager::SchedulerType GetLinkSchedulerType() {
+  if (common::InitFlags::IsL2capWeightedFairSchedulerEnabled()) {
+    return DataPipelineManager::SchedulerType::WEIGHTED_FAIR_QUEUE;
+  }
+  return DataPipelineManager::SchedulerType::FIFO;
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
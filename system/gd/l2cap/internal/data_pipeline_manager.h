@@ -28,6 +28,7 @@
 #include "l2cap/internal/receiver.h"
 #include "l2cap/internal/scheduler.h"
 #include "l2cap/internal/scheduler_fifo.h"
+#include "l2cap/internal/scheduler_weighted_fair_queue.h"
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/mtu.h"
 #include "os/handler.h"
@@ -55,8 +56,20 @@ class DataPipelineManager {
   using LowerDequeue = UpperEnqueue;
   using LowerQueueUpEnd = common::BidiQueueEnd<LowerEnqueue, LowerDequeue>;
 
-  DataPipelineManager(os::Handler* handler, ILink* link, LowerQueueUpEnd* link_queue_up_end)
-      : handler_(handler), link_(link), scheduler_(std::make_unique<Fifo>(this, link_queue_up_end, handler)),
+  // How the link is shared between the outgoing packets of its channels
+  enum class SchedulerType {
+    FIFO,
+    WEIGHTED_FAIR_QUEUE,
+  };
+
+  DataPipelineManager(
+      os::Handler* handler,
+      ILink* link,
+      LowerQueueUpEnd* link_queue_up_end,
+      SchedulerType scheduler_type = SchedulerType::FIFO)
+      : handler_(handler),
+        link_(link),
+        scheduler_(create_scheduler(scheduler_type, link_queue_up_end, handler)),
         receiver_(link_queue_up_end, handler, this) {}
 
   using ChannelMode = Sender::ChannelMode;
@@ -67,6 +80,7 @@ class DataPipelineManager {
   virtual void OnPacketSent(Cid cid);
   virtual void UpdateClassicConfiguration(Cid cid, classic::internal::ChannelConfigurationState config);
   virtual void SetChannelTxPriority(Cid cid, bool high_priority);
+  virtual void SetChannelTxWeight(Cid cid, uint16_t weight);
   virtual ~DataPipelineManager() = default;
 
  private:
@@ -75,7 +89,14 @@ class DataPipelineManager {
   std::unordered_map<Cid, Sender> sender_map_;
   std::unique_ptr<Scheduler> scheduler_;
   Receiver receiver_;
+
+  std::unique_ptr<Scheduler> create_scheduler(
+      SchedulerType scheduler_type, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler);
 };
+
+// The scheduler links use for their channels, as selected by init flags
+DataPipelineManager::SchedulerType GetLinkSchedulerType();
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
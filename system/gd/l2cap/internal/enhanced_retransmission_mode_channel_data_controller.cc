@@ -17,18 +17,29 @@
 #include "l2cap/internal/enhanced_retransmission_mode_channel_data_controller.h"
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <vector>
 
 #include "common/bind.h"
 #include "l2cap/internal/ilink.h"
+#include "l2cap/internal/retransmission_window.h"
 #include "os/alarm.h"
+#include "packet/bit_inserter.h"
 #include "packet/fragmenting_inserter.h"
 #include "packet/raw_builder.h"
 
 namespace bluetooth {
 namespace l2cap {
 namespace internal {
+namespace {
+// Stage of every channel not reassembling an SDU
+std::shared_ptr<const std::vector<uint8_t>> empty_payload() {
+  static const auto* payload = new std::shared_ptr<const std::vector<uint8_t>>(new std::vector<uint8_t>());
+  return *payload;
+}
+}  // namespace
+
 ErtmController::ErtmController(ILink* link, Cid cid, Cid remote_cid, UpperQueueDownEnd* channel_queue_end,
                                os::Handler* handler, Scheduler* scheduler)
     : link_(link), cid_(cid), remote_cid_(remote_cid), enqueue_buffer_(channel_queue_end), handler_(handler),
@@ -40,7 +51,8 @@ ErtmController::~ErtmController() {
 
 struct ErtmController::impl {
   impl(ErtmController* controller, os::Handler* handler)
-      : controller_(controller), handler_(handler), retrans_timer_(handler), monitor_timer_(handler) {}
+      : controller_(controller), handler_(handler), unacked_list_(controller->remote_tx_window_),
+        retrans_timer_(handler), monitor_timer_(handler) {}
 
   ErtmController* controller_;
   os::Handler* handler_;
@@ -78,9 +90,8 @@ struct ErtmController::impl {
   bool remote_busy_ = false;
   bool local_busy_ = false;
   int unacked_frames_ = 0;
-  // TODO: Instead of having a map, we may consider about a better data structure
-  // Map from TxSeq to (SAR, SDU size for START packet, information payload)
-  std::map<uint8_t, std::tuple<SegmentationAndReassembly, uint16_t, std::shared_ptr<packet::RawBuilder>>> unacked_list_;
+  // Serialized I-frames waiting for an acknowledgement
+  RetransmissionWindow unacked_list_;
   // Stores (SAR, SDU size for START packet, information payload)
   std::queue<std::tuple<SegmentationAndReassembly, uint16_t, std::unique_ptr<packet::RawBuilder>>> pending_frames_;
   int retry_count_ = 0;
@@ -574,7 +585,7 @@ struct ErtmController::impl {
 
   // Actions (@see 8.6.5.6)
 
-  void _send_i_frame(SegmentationAndReassembly sar, std::unique_ptr<CopyablePacketBuilder> segment, uint8_t req_seq,
+  void _send_i_frame(SegmentationAndReassembly sar, std::unique_ptr<packet::RawBuilder> segment, uint8_t req_seq,
                      uint8_t tx_seq, uint16_t sdu_size = 0, Final f = Final::NOT_SET) {
     std::unique_ptr<packet::BasePacketBuilder> builder;
     if (sar == SegmentationAndReassembly::START) {
@@ -594,18 +605,17 @@ struct ErtmController::impl {
                                                           std::move(segment));
       }
     }
-    controller_->send_pdu(std::move(builder));
+    // Serialized once, retransmissions reuse the bytes
+    std::vector<uint8_t> frame;
+    frame.reserve(builder->size());
+    packet::BitInserter inserter(frame);
+    builder->Serialize(inserter);
+    controller_->send_pdu(unacked_list_.Push(tx_seq, std::move(frame), controller_->fcs_enabled_));
   }
 
   void send_data(SegmentationAndReassembly sar, uint16_t sdu_size, std::unique_ptr<packet::RawBuilder> segment,
                  Final f = Final::NOT_SET) {
-    std::shared_ptr<packet::RawBuilder> shared_segment(segment.release());
-    unacked_list_.emplace(std::piecewise_construct, std::forward_as_tuple(next_tx_seq_),
-                          std::forward_as_tuple(sar, sdu_size, shared_segment));
-
-    std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-        std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(next_tx_seq_)->second));
-    _send_i_frame(sar, std::move(copyable_packet_builder), buffer_seq_, next_tx_seq_, sdu_size, f);
+    _send_i_frame(sar, std::move(segment), buffer_seq_, next_tx_seq_, sdu_size, f);
     unacked_frames_++;
     frames_sent_++;
     retry_i_frames_[next_tx_seq_] = 1;
@@ -618,10 +628,10 @@ struct ErtmController::impl {
   }
 
   void process_req_seq(uint8_t req_seq) {
-    for (int i = expected_ack_seq_; i < req_seq; i++) {
-      unacked_list_.erase(i);
+    for (uint8_t i = expected_ack_seq_; i != req_seq; i = (i + 1) % kMaxTxWin) {
       retry_i_frames_[i] = 0;
     }
+    unacked_list_.Acknowledge(req_seq);
     unacked_frames_ -= ((req_seq - expected_ack_seq_) + kMaxTxWin) % kMaxTxWin;
     expected_ack_seq_ = req_seq;
     if (unacked_frames_ == 0) {
@@ -751,19 +761,16 @@ struct ErtmController::impl {
   void retransmit_i_frames(uint8_t req_seq, Poll p = Poll::NOT_SET) {
     uint8_t i = req_seq;
     Final f = (p == Poll::NOT_SET ? Final::NOT_SET : Final::POLL_RESPONSE);
-    while (unacked_list_.find(i) != unacked_list_.end()) {
+    while (unacked_list_.Contains(i)) {
       if (retry_i_frames_[i] == controller_->local_max_transmit_) {
         CloseChannel();
         return;
       }
-      std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-          std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(i)->second));
-      _send_i_frame(std::get<0>(unacked_list_.find(i)->second), std::move(copyable_packet_builder), buffer_seq_, i,
-                    std::get<1>(unacked_list_.find(i)->second), f);
+      controller_->send_pdu(unacked_list_.Retransmit(i, buffer_seq_, f));
       retry_i_frames_[i]++;
       frames_sent_++;
       f = Final::NOT_SET;
-      i++;
+      i = (i + 1) % kMaxTxWin;
     }
     if (i != req_seq) {
       start_retrans_timer();
@@ -772,14 +779,11 @@ struct ErtmController::impl {
 
   void retransmit_requested_i_frame(uint8_t req_seq, Poll p) {
     Final f = p == Poll::POLL ? Final::POLL_RESPONSE : Final::NOT_SET;
-    if (unacked_list_.find(req_seq) == unacked_list_.end()) {
+    if (!unacked_list_.Contains(req_seq)) {
       LOG_ERROR("Received invalid SREJ");
       return;
     }
-    std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-        std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(req_seq)->second));
-    _send_i_frame(std::get<0>(unacked_list_.find(req_seq)->second), std::move(copyable_packet_builder), buffer_seq_,
-                  req_seq, std::get<1>(unacked_list_.find(req_seq)->second), f);
+    controller_->send_pdu(unacked_list_.Retransmit(req_seq, buffer_seq_, f));
     retry_i_frames_[req_seq]++;
     start_retrans_timer();
   }
@@ -1011,14 +1015,15 @@ void ErtmController::stage_for_reassembly(SegmentationAndReassembly sar, uint16_
       remaining_sdu_continuation_packet_size_ -= payload.size();
       if (remaining_sdu_continuation_packet_size_ != 0) {
         LOG_WARN("Received invalid END I-Frame");
-        reassembly_stage_ =
-            PacketViewForReassembly(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+        reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(empty_payload()));
         remaining_sdu_continuation_packet_size_ = 0;
         close_channel();
         return;
       }
       reassembly_stage_.AppendPacketView(payload);
       enqueue_buffer_.Enqueue(std::make_unique<packet::PacketView<kLittleEndian>>(reassembly_stage_), handler_);
+      // Don't hold on to the fragments of the SDU once delivered
+      reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(empty_payload()));
       if (enqueue_buffer_.Size() == kEnqueueBufferBusyThreshold) {
         pimpl_->local_busy_detected();
         enqueue_buffer_.NotifyOnEmpty(common::BindOnce(&impl::local_busy_clear, common::Unretained(pimpl_.get())));
@@ -1039,6 +1044,7 @@ void ErtmController::send_pdu(std::unique_ptr<packet::BasePacketBuilder> pdu) {
 void ErtmController::SetRetransmissionAndFlowControlOptions(
     const RetransmissionAndFlowControlConfigurationOption& option) {
   remote_tx_window_ = option.tx_window_size_;
+  pimpl_->unacked_list_.SetCapacity(remote_tx_window_);
   local_max_transmit_ = option.max_transmit_;
   local_retransmit_timeout_ms_ = option.retransmission_time_out_;
   local_monitor_timeout_ms_ = option.monitor_time_out_;
@@ -1049,14 +1055,6 @@ void ErtmController::close_channel() {
   link_->SendDisconnectionRequest(cid_, remote_cid_);
 }
 
-size_t ErtmController::CopyablePacketBuilder::size() const {
-  return builder_->size();
-}
-
-void ErtmController::CopyablePacketBuilder::Serialize(BitInserter& it) const {
-  builder_->Serialize(it);
-}
-
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -204,6 +204,39 @@ TEST_F(ErtmDataControllerTest, receive_packet_with_fcs) {
   EXPECT_EQ(data, "abcd");
 }
 
+TEST_F(ErtmDataControllerTest, retransmit_on_reject_with_fcs) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.EnableFcs(true);
+  EXPECT_CALL(scheduler, OnPacketsReady(1, 1)).Times(4);
+  controller.OnSdu(CreateSdu({'a', 'b', 'c', 'd'}));
+  controller.OnSdu(CreateSdu({'e', 'f', 'g', 'h'}));
+  controller.GetNextPacket();
+  controller.GetNextPacket();
+
+  auto reject = EnhancedSupervisoryFrameWithFcsBuilder::Create(
+      1, SupervisoryFunction::REJECT, Poll::POLL, Final::NOT_SET, 0);
+  controller.OnPdu(GetPacketView(std::move(reject)));
+
+  std::vector<std::string> payloads = {"abcd", "efgh"};
+  for (uint8_t tx_seq = 0; tx_seq < 2; tx_seq++) {
+    auto view = GetPacketView(controller.GetNextPacket());
+    auto pdu_view = BasicFrameWithFcsView::Create(view);
+    ASSERT_TRUE(pdu_view.IsValid());
+    auto standard_view = StandardFrameWithFcsView::Create(pdu_view);
+    ASSERT_TRUE(standard_view.IsValid());
+    auto i_frame_view = EnhancedInformationFrameWithFcsView::Create(standard_view);
+    ASSERT_TRUE(i_frame_view.IsValid());
+    auto payload = i_frame_view.GetPayload();
+    EXPECT_EQ(std::string(payload.begin(), payload.end()), payloads[tx_seq]);
+    EXPECT_EQ(i_frame_view.GetTxSeq(), tx_seq);
+    // Only the first retransmission answers the poll
+    EXPECT_EQ(i_frame_view.GetF(), tx_seq == 0 ? Final::POLL_RESPONSE : Final::NOT_SET);
+  }
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
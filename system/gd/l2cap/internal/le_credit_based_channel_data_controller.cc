@@ -16,6 +16,10 @@
 
 #include "l2cap/internal/le_credit_based_channel_data_controller.h"
 
+#include <algorithm>
+
+#include "common/bind.h"
+#include "common/tracing.h"
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/le/internal/link.h"
 #include "packet/fragmenting_inserter.h"
@@ -32,6 +36,7 @@ LeCreditBasedDataController::LeCreditBasedDataController(ILink* link, Cid cid, C
       link_(link) {}
 
 void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilder> sdu) {
+  BT_TRACE_SCOPE("l2cap", "segment_sdu", 0, cid_);
   auto sdu_size = sdu->size();
   if (sdu_size == 0) {
     LOG_WARN("Received empty SDU");
@@ -52,19 +57,25 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
     builder = BasicFrameBuilder::Create(remote_cid_, std::move(segments[i]));
     pdu_queue_.emplace(std::move(builder));
   }
-  if (credits_ >= segments.size()) {
+  if (pending_frames_count_ == 0 && credits_ >= segments.size()) {
     scheduler_->OnPacketsReady(cid_, segments.size());
     credits_ -= segments.size();
-  } else if (credits_ > 0) {
-    scheduler_->OnPacketsReady(cid_, credits_);
-    pending_frames_count_ += (segments.size() - credits_);
-    credits_ = 0;
-  } else {
-    pending_frames_count_ += segments.size();
+    return;
   }
+  // Send ahead as many frames as we have credits for, the rest wait for OnCredit()
+  if (pending_frames_count_ == 0) {
+    credit_statistics_.tx_stalls++;
+  }
+  uint16_t ready = credits_;
+  if (ready > 0) {
+    scheduler_->OnPacketsReady(cid_, ready);
+  }
+  pending_frames_count_ += segments.size() - ready;
+  credits_ = 0;
 }
 
 void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
+  BT_TRACE_SCOPE("l2cap", "reassemble_pdu", 0, cid_);
   auto basic_frame_view = BasicFrameView::Create(pdu);
   if (!basic_frame_view.IsValid()) {
     LOG_WARN("Received invalid frame");
@@ -91,14 +102,15 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
   }
   if (remaining_sdu_continuation_packet_size_ == 0) {
     enqueue_buffer_.Enqueue(std::make_unique<PacketView<kLittleEndian>>(reassembly_stage_), handler_);
+    reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
   } else if (remaining_sdu_continuation_packet_size_ < 0 || reassembly_stage_.size() > mtu_) {
     LOG_WARN("Received larger SDU size than expected");
     reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
     remaining_sdu_continuation_packet_size_ = 0;
     link_->SendDisconnectionRequest(cid_, remote_cid_);
   }
-  // TODO: Improve the logic by sending credit only after user dequeued the SDU
-  link_->SendLeCredit(cid_, 1);
+  credits_to_grant_++;
+  grant_credits(false);
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
@@ -116,21 +128,65 @@ void LeCreditBasedDataController::SetMps(uint16_t mps) {
   mps_ = mps;
 }
 
+void LeCreditBasedDataController::SetInitialCredit(uint16_t credits) {
+  initial_credit_ = credits;
+}
+
 void LeCreditBasedDataController::OnCredit(uint16_t credits) {
+  BT_TRACE_INSTANT("l2cap", "credits", 0, cid_);
   int total_credits = credits_ + credits;
   if (total_credits > 0xffff) {
+    LOG_WARN("Credit overflow on cid %d", cid_);
     link_->SendDisconnectionRequest(cid_, remote_cid_);
+    return;
   }
+  credit_statistics_.credits_received += credits;
   credits_ = total_credits;
-  if (pending_frames_count_ > 0 && credits_ >= pending_frames_count_) {
-    scheduler_->OnPacketsReady(cid_, pending_frames_count_);
-    pending_frames_count_ = 0;
-    credits_ -= pending_frames_count_;
-  } else if (pending_frames_count_ > 0) {
-    scheduler_->OnPacketsReady(cid_, credits_);
-    pending_frames_count_ -= credits_;
-    credits_ = 0;
+  if (pending_frames_count_ == 0 || credits_ == 0) {
+    return;
+  }
+  uint16_t ready = std::min(credits_, pending_frames_count_);
+  scheduler_->OnPacketsReady(cid_, ready);
+  pending_frames_count_ -= ready;
+  credits_ -= ready;
+  if (pending_frames_count_ > 0) {
+    credit_statistics_.tx_stalls++;
+  }
+}
+
+const LeCreditBasedDataController::CreditStatistics& LeCreditBasedDataController::GetCreditStatistics() const {
+  return credit_statistics_;
+}
+
+void LeCreditBasedDataController::grant_credits(bool force) {
+  if (credits_to_grant_ == 0) {
+    return;
+  }
+  if (enqueue_buffer_.Size() > kMaxBufferedSdus) {
+    // The upper layer is behind, let the remote run out of credits until it catches up
+    if (!waiting_for_drain_) {
+      waiting_for_drain_ = true;
+      credit_statistics_.grants_deferred++;
+      enqueue_buffer_.NotifyOnEmpty(
+          common::BindOnce(&LeCreditBasedDataController::on_enqueue_buffer_empty, common::Unretained(this)));
+    }
+    return;
+  }
+  // Give credits back once the remote has used half of its initial credits, so it never waits for a round trip
+  uint16_t batch = std::max(1, initial_credit_ / 2);
+  if (!force && credits_to_grant_ < batch) {
+    return;
   }
+  link_->SendLeCredit(cid_, credits_to_grant_);
+  credit_statistics_.credits_granted += credits_to_grant_;
+  credit_statistics_.credit_packets_sent++;
+  credits_to_grant_ = 0;
+}
+
+void LeCreditBasedDataController::on_enqueue_buffer_empty() {
+  waiting_for_drain_ = false;
+  // The remote may be out of credits, don't wait for a full batch
+  grant_credits(true);
 }
 
 }  // namespace internal
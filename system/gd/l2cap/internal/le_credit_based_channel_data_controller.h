@@ -55,10 +55,32 @@ class LeCreditBasedDataController : public DataController {
   // TODO: Set MTU and MPS from signalling channel
   void SetMtu(Mtu mtu);
   void SetMps(uint16_t mps);
-  // TODO: Handle credits
+  // Credits we gave the remote in the connection request or response. Received frames are credited back in batches
+  // of half of it.
+  void SetInitialCredit(uint16_t credits);
+  // Credits the remote gave us, to send that many frames
   void OnCredit(uint16_t credits);
 
+  struct CreditStatistics {
+    // Credits received from the remote
+    uint32_t credits_received = 0;
+    // Times a frame was ready to be sent but had to wait for credits
+    uint32_t tx_stalls = 0;
+    // Credits we gave back to the remote, and in how many LE Flow Control Credit packets
+    uint32_t credits_granted = 0;
+    uint32_t credit_packets_sent = 0;
+    // Times we held credits back because the upper layer was not dequeuing SDUs
+    uint32_t grants_deferred = 0;
+  };
+  const CreditStatistics& GetCreditStatistics() const;
+
  private:
+  // More SDUs than this waiting for the upper queue means the upper layer is not keeping up
+  static constexpr size_t kMaxBufferedSdus = 1;
+
+  void grant_credits(bool force);
+  void on_enqueue_buffer_empty();
+
   Cid cid_;
   Cid remote_cid_;
   os::EnqueueBuffer<UpperEnqueue> enqueue_buffer_;
@@ -70,6 +92,10 @@ class LeCreditBasedDataController : public DataController {
   uint16_t mps_ = 251;
   uint16_t credits_ = 0;
   uint16_t pending_frames_count_ = 0;
+  uint16_t initial_credit_ = 0;
+  uint16_t credits_to_grant_ = 0;
+  bool waiting_for_drain_ = false;
+  CreditStatistics credit_statistics_;
 
   class PacketViewForReassembly : public packet::PacketView<kLittleEndian> {
    public:
@@ -179,6 +179,42 @@ TEST_F(LeCreditBasedDataControllerTest, receive_segmented_with_wrong_sdu_length)
   EXPECT_EQ(payload, nullptr);
 }
 
+TEST_F(LeCreditBasedDataControllerTest, transmit_ahead_of_credits) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.OnCredit(1);
+  controller.SetMps(4);
+  // Should be divided into 'ab', 'cd' and 'e', only the first can be sent
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 1));
+  controller.OnSdu(CreateSdu({'a', 'b', 'c', 'd', 'e'}));
+  EXPECT_EQ(controller.GetCreditStatistics().tx_stalls, 1u);
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 2));
+  controller.OnCredit(5);
+  EXPECT_EQ(controller.GetCreditStatistics().credits_received, 6u);
+  EXPECT_EQ(controller.GetCreditStatistics().tx_stalls, 1u);
+  // The remaining 3 credits are used right away
+  EXPECT_CALL(scheduler, OnPacketsReady(0x41, 1));
+  controller.OnSdu(CreateSdu({'f'}));
+}
+
+TEST_F(LeCreditBasedDataControllerTest, grant_credits_in_batches) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetInitialCredit(6);
+  EXPECT_CALL(link, SendLeCredit(0x41, 3)).Times(1);
+  for (uint8_t i = 0; i < 4; i++) {
+    auto builder = FirstLeInformationFrameBuilder::Create(0x41, 1, CreateSdu({i}));
+    controller.OnPdu(GetPacketView(std::move(builder)));
+    sync_handler(queue_handler_);
+  }
+  EXPECT_EQ(controller.GetCreditStatistics().credits_granted, 3u);
+  EXPECT_EQ(controller.GetCreditStatistics().credit_packets_sent, 1u);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
@@ -36,6 +36,14 @@ class ParameterProvider {
   virtual std::chrono::milliseconds GetLeLinkIdleDisconnectTimeout() {
     return std::chrono::seconds(1);
   }
+  // An LE link that keeps packets queued for this long is tuned for throughput
+  virtual std::chrono::milliseconds GetLeLinkBulkTransferDetectionTime() {
+    return std::chrono::milliseconds(300);
+  }
+  // An LE link tuned for throughput goes back to a low power connection interval after being idle for this long
+  virtual std::chrono::milliseconds GetLeLinkBulkTransferIdleTimeout() {
+    return std::chrono::seconds(3);
+  }
   virtual uint16_t GetLeMps() {
     return 251;
   }
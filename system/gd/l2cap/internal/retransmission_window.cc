@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/retransmission_window.h"
+
+#include <algorithm>
+
+#include "common/allocation_hook.h"
+#include "common/crc16.h"
+#include "os/log.h"
+#include "packet/fragment_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+namespace {
+// Basic L2CAP header, then the Enhanced Control Field: TxSeq and F in its first byte, ReqSeq and SAR in the second
+constexpr size_t kControlOffset = 4;
+constexpr uint8_t kFinalMask = 0x80;
+constexpr uint8_t kReqSeqMask = 0x3f;
+constexpr size_t kFcsSize = 2;
+}  // namespace
+
+RetransmissionWindow::RetransmissionWindow(size_t capacity) : ring_(capacity) {}
+
+void RetransmissionWindow::SetCapacity(size_t capacity) {
+  capacity = std::max(capacity, size_);
+  std::vector<Frame> ring(capacity);
+  for (size_t i = 0; i < size_; i++) {
+    ring[i] = std::move(frame_at(i));
+  }
+  ring_ = std::move(ring);
+  head_ = 0;
+}
+
+size_t RetransmissionWindow::Size() const {
+  return size_;
+}
+
+bool RetransmissionWindow::Contains(uint8_t tx_seq) const {
+  return offset_of(tx_seq) < size_;
+}
+
+std::unique_ptr<packet::BasePacketBuilder> RetransmissionWindow::Push(
+    uint8_t tx_seq, std::vector<uint8_t> frame, bool fcs) {
+  ASSERT(frame.size() >= kControlOffset + 2 + (fcs ? kFcsSize : 0));
+  if (size_ == 0) {
+    first_tx_seq_ = tx_seq;
+  }
+  ASSERT_LOG(offset_of(tx_seq) == size_, "TxSeq %hhu does not follow the unacknowledged frames", tx_seq);
+  if (size_ == ring_.size()) {
+    // The remote TxWindow bounds the unacknowledged frames, this only happens if it was not set
+    SetCapacity(std::max<size_t>(1, ring_.size() * 2));
+  }
+  size_++;
+  Frame& stored = frame_at(size_ - 1);
+  stored.bytes = std::make_shared<std::vector<uint8_t>>(std::move(frame));
+  stored.fcs = fcs;
+  return std::make_unique<packet::FragmentBuilder>(stored.bytes, 0, stored.bytes->size());
+}
+
+void RetransmissionWindow::Acknowledge(uint8_t req_seq) {
+  size_t acknowledged = std::min<size_t>(offset_of(req_seq), size_);
+  for (size_t i = 0; i < acknowledged; i++) {
+    frame_at(0).bytes.reset();
+    head_ = (head_ + 1) % ring_.size();
+    size_--;
+  }
+  first_tx_seq_ = (first_tx_seq_ + acknowledged) % kMaxTxSeq;
+}
+
+std::unique_ptr<packet::BasePacketBuilder> RetransmissionWindow::Retransmit(uint8_t tx_seq, uint8_t req_seq, Final f) {
+  ASSERT(Contains(tx_seq));
+  Frame& stored = frame_at(offset_of(tx_seq));
+  if (stored.bytes.use_count() > 1) {
+    // The scheduler has yet to send a builder of the frame, leave its bytes alone
+    common::NotifyAllocation("l2cap retransmission copy", stored.bytes->size());
+    stored.bytes = std::make_shared<std::vector<uint8_t>>(*stored.bytes);
+  }
+  auto& bytes = *stored.bytes;
+  bytes[kControlOffset] = (bytes[kControlOffset] & ~kFinalMask) | (f == Final::POLL_RESPONSE ? kFinalMask : 0);
+  bytes[kControlOffset + 1] = (bytes[kControlOffset + 1] & ~kReqSeqMask) | (req_seq & kReqSeqMask);
+  if (stored.fcs) {
+    size_t covered = bytes.size() - kFcsSize;
+    uint16_t fcs = common::Crc16Update(0, bytes.data(), covered);
+    bytes[covered] = fcs & 0xff;
+    bytes[covered + 1] = fcs >> 8;
+  }
+  return std::make_unique<packet::FragmentBuilder>(stored.bytes, 0, bytes.size());
+}
+
+uint8_t RetransmissionWindow::offset_of(uint8_t tx_seq) const {
+  return (tx_seq + kMaxTxSeq - first_tx_seq_) % kMaxTxSeq;
+}
+
+RetransmissionWindow::Frame& RetransmissionWindow::frame_at(uint8_t offset) {
+  return ring_[(head_ + offset) % ring_.size()];
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
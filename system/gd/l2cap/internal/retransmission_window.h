@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "l2cap/l2cap_packets.h"
+#include "packet/base_packet_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+/**
+ * Unacknowledged I-frames of an ERTM channel, in a ring sized to the remote TxWindow. Each frame is serialized once,
+ * when first sent. A retransmission rewrites the ReqSeq and F bits of the stored frame, and its FCS, instead of
+ * building the frame again.
+ */
+class RetransmissionWindow {
+ public:
+  // We don't support extended window
+  static constexpr uint8_t kMaxTxSeq = 64;
+
+  explicit RetransmissionWindow(size_t capacity);
+
+  // Resize the ring, keeping the frames stored
+  void SetCapacity(size_t capacity);
+
+  size_t Size() const;
+
+  bool Contains(uint8_t tx_seq) const;
+
+  // Store |frame|, the serialized I-frame |tx_seq|, and return a builder for its first transmission. |tx_seq| must
+  // follow the last frame stored.
+  std::unique_ptr<packet::BasePacketBuilder> Push(uint8_t tx_seq, std::vector<uint8_t> frame, bool fcs);
+
+  // Release the frames before |req_seq|, acknowledged by the remote
+  void Acknowledge(uint8_t req_seq);
+
+  // Return a builder sending the stored |tx_seq| again with |req_seq| and |f|. The frame is patched in place, unless a
+  // previous transmission of it is still waiting to be sent.
+  std::unique_ptr<packet::BasePacketBuilder> Retransmit(uint8_t tx_seq, uint8_t req_seq, Final f);
+
+ private:
+  struct Frame {
+    std::shared_ptr<std::vector<uint8_t>> bytes;
+    bool fcs = false;
+  };
+
+  uint8_t offset_of(uint8_t tx_seq) const;
+  Frame& frame_at(uint8_t offset);
+
+  std::vector<Frame> ring_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  uint8_t first_tx_seq_ = 0;
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
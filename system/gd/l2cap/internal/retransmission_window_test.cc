@@ -0,0 +1,130 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/retransmission_window.h"
+
+#include <gtest/gtest.h>
+
+#include "common/crc16.h"
+#include "packet/bit_inserter.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+// An I-frame with FCS: basic header, control field with TxSeq |tx_seq|, ReqSeq 0 and F unset, payload, FCS
+std::vector<uint8_t> MakeFrame(uint8_t tx_seq, bool fcs) {
+  std::vector<uint8_t> frame = {0, 0, 0x41, 0x00, static_cast<uint8_t>(tx_seq << 1), 0x00, 'a', 'b', 'c'};
+  frame[0] = frame.size() - 4 + (fcs ? 2 : 0);
+  if (fcs) {
+    uint16_t crc = common::Crc16Update(0, frame.data(), frame.size());
+    frame.push_back(crc & 0xff);
+    frame.push_back(crc >> 8);
+  }
+  return frame;
+}
+
+std::vector<uint8_t> Serialize(std::unique_ptr<packet::BasePacketBuilder> builder) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter inserter(bytes);
+  builder->Serialize(inserter);
+  return bytes;
+}
+
+TEST(RetransmissionWindowTest, push_and_acknowledge) {
+  RetransmissionWindow window(3);
+  EXPECT_EQ(Serialize(window.Push(0, MakeFrame(0, false), false)), MakeFrame(0, false));
+  window.Push(1, MakeFrame(1, false), false);
+  window.Push(2, MakeFrame(2, false), false);
+  EXPECT_EQ(window.Size(), 3u);
+  EXPECT_TRUE(window.Contains(0));
+  EXPECT_TRUE(window.Contains(2));
+  EXPECT_FALSE(window.Contains(3));
+
+  window.Acknowledge(2);
+  EXPECT_EQ(window.Size(), 1u);
+  EXPECT_FALSE(window.Contains(1));
+  EXPECT_TRUE(window.Contains(2));
+
+  window.Push(3, MakeFrame(3, false), false);
+  window.Push(4, MakeFrame(4, false), false);
+  window.Acknowledge(5);
+  EXPECT_EQ(window.Size(), 0u);
+}
+
+TEST(RetransmissionWindowTest, wraps_around_tx_seq) {
+  RetransmissionWindow window(10);
+  for (uint8_t tx_seq = 60; tx_seq != 6; tx_seq = (tx_seq + 1) % RetransmissionWindow::kMaxTxSeq) {
+    window.Push(tx_seq, MakeFrame(tx_seq, false), false);
+  }
+  EXPECT_EQ(window.Size(), 10u);
+  EXPECT_TRUE(window.Contains(63));
+  EXPECT_TRUE(window.Contains(5));
+  EXPECT_FALSE(window.Contains(6));
+  EXPECT_FALSE(window.Contains(59));
+  EXPECT_EQ(Serialize(window.Retransmit(1, 0, Final::NOT_SET)), MakeFrame(1, false));
+
+  window.Acknowledge(2);
+  EXPECT_EQ(window.Size(), 4u);
+  EXPECT_FALSE(window.Contains(63));
+  EXPECT_TRUE(window.Contains(2));
+}
+
+TEST(RetransmissionWindowTest, retransmit_patches_control_and_fcs) {
+  RetransmissionWindow window(2);
+  window.Push(5, MakeFrame(5, true), true);
+
+  auto frame = Serialize(window.Retransmit(5, 0x2a, Final::POLL_RESPONSE));
+  auto expected = MakeFrame(5, false);
+  expected[0] += 2;
+  expected[4] |= 0x80;
+  expected[5] = 0x2a;
+  uint16_t crc = common::Crc16Update(0, expected.data(), expected.size());
+  expected.push_back(crc & 0xff);
+  expected.push_back(crc >> 8);
+  EXPECT_EQ(frame, expected);
+
+  // F is only set on the frame answering the poll
+  frame = Serialize(window.Retransmit(5, 0x2a, Final::NOT_SET));
+  EXPECT_EQ(frame[4] & 0x80, 0);
+  EXPECT_EQ(common::Crc16Update(0, frame.data(), frame.size() - 2), frame[frame.size() - 2] | frame.back() << 8);
+}
+
+TEST(RetransmissionWindowTest, pending_transmission_is_not_modified) {
+  RetransmissionWindow window(2);
+  auto first = window.Push(0, MakeFrame(0, false), false);
+  auto retransmission = window.Retransmit(0, 7, Final::POLL_RESPONSE);
+  EXPECT_EQ(Serialize(std::move(first)), MakeFrame(0, false));
+  auto patched = Serialize(std::move(retransmission));
+  EXPECT_EQ(patched[4], 0x80);
+  EXPECT_EQ(patched[5], 7);
+}
+
+TEST(RetransmissionWindowTest, grows_past_capacity) {
+  RetransmissionWindow window(1);
+  window.Push(0, MakeFrame(0, false), false);
+  window.Push(1, MakeFrame(1, false), false);
+  window.SetCapacity(1);
+  EXPECT_EQ(window.Size(), 2u);
+  EXPECT_EQ(Serialize(window.Retransmit(0, 0, Final::NOT_SET)), MakeFrame(0, false));
+  EXPECT_EQ(Serialize(window.Retransmit(1, 0, Final::NOT_SET)), MakeFrame(1, false));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
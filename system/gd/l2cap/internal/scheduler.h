@@ -60,6 +60,12 @@ class Scheduler {
    */
   virtual void SetChannelTxPriority(Cid cid, bool high_priority) {}
 
+  /**
+   * Give the specified cid a share of the link proportional to weight, among the channels that are not high priority.
+   * Only used by schedulers that share the link by weight.
+   */
+  virtual void SetChannelTxWeight(Cid cid, uint16_t weight) {}
+
   /**
    * Called by data controller to indicate that a channel is closed and packets should be dropped
    */
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_weighted_fair_queue.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+#include "common/bind.h"
+#include "l2cap/internal/data_pipeline_manager.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+WeightedFairQueue::WeightedFairQueue(
+    DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler)
+    : data_pipeline_manager_(data_pipeline_manager), link_queue_up_end_(link_queue_up_end), handler_(handler) {
+  ASSERT(link_queue_up_end_ != nullptr && handler_ != nullptr);
+}
+
+// Invoked from some external Handler context
+WeightedFairQueue::~WeightedFairQueue() {
+  if (link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+// Invoked within L2CAP Handler context
+void WeightedFairQueue::OnPacketsReady(Cid cid, int number_packets) {
+  if (number_packets <= 0) {
+    return;
+  }
+  auto& channel = channels_[cid];
+  channel.ready_times.insert(channel.ready_times.end(), number_packets, std::chrono::steady_clock::now());
+  if (!channel.active) {
+    channel.active = true;
+    channel.deficit = 0;
+    active_list_for(cid).push_back(cid);
+  }
+  try_register_link_queue_enqueue();
+}
+
+// Invoked within L2CAP Handler context
+void WeightedFairQueue::SetChannelTxPriority(Cid cid, bool high_priority) {
+  if ((high_priority_cids_.count(cid) != 0) == high_priority) {
+    return;
+  }
+  auto channel = channels_.find(cid);
+  bool active = channel != channels_.end() && channel->second.active;
+  if (active) {
+    active_list_for(cid).remove(cid);
+    channel->second.deficit = 0;
+  }
+  if (high_priority) {
+    high_priority_cids_.emplace(cid);
+  } else {
+    high_priority_cids_.erase(cid);
+  }
+  if (active) {
+    active_list_for(cid).push_back(cid);
+  }
+}
+
+// Invoked within L2CAP Handler context
+void WeightedFairQueue::SetChannelTxWeight(Cid cid, uint16_t weight) {
+  tx_weights_[cid] = std::max<uint16_t>(weight, 1);
+}
+
+void WeightedFairQueue::RemoveChannel(Cid cid) {
+  auto channel = channels_.find(cid);
+  if (channel != channels_.end()) {
+    log_latency(cid);
+    if (channel->second.active) {
+      active_list_for(cid).remove(cid);
+    }
+    channels_.erase(channel);
+  }
+  tx_weights_.erase(cid);
+  try_unregister_link_queue_enqueue();
+}
+
+WeightedFairQueue::LatencyPercentiles WeightedFairQueue::GetLatencyPercentiles(Cid cid) const {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end() || channel->second.latency_samples.empty()) {
+    return {};
+  }
+  auto samples = channel->second.latency_samples;
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&samples](size_t p) { return samples[(samples.size() - 1) * p / 100]; };
+  return {percentile(50), percentile(90), percentile(99)};
+}
+
+uint16_t WeightedFairQueue::get_weight(Cid cid) const {
+  auto weight = tx_weights_.find(cid);
+  return weight == tx_weights_.end() ? kDefaultWeight : weight->second;
+}
+
+std::list<Cid>& WeightedFairQueue::active_list_for(Cid cid) {
+  return high_priority_cids_.count(cid) != 0 ? active_high_priority_channels_ : active_channels_;
+}
+
+// Returns the channel at the front of its active list that sends next
+Cid WeightedFairQueue::select_next_channel() {
+  if (!active_high_priority_channels_.empty()) {
+    return active_high_priority_channels_.front();
+  }
+  // A channel that reaches the front of the list starts its round with a new quantum. One that is still in debt from
+  // its last PDU waits for another round, which ends since every channel gains at least kQuantumBytes per round.
+  while (true) {
+    Cid cid = active_channels_.front();
+    auto& channel = channels_[cid];
+    if (channel.deficit > 0) {
+      return cid;
+    }
+    channel.deficit += kQuantumBytes * get_weight(cid);
+    if (channel.deficit > 0) {
+      return cid;
+    }
+    active_channels_.splice(active_channels_.end(), active_channels_, active_channels_.begin());
+  }
+}
+
+void WeightedFairQueue::record_latency(Cid cid, ChannelState& channel, std::chrono::microseconds latency) {
+  if (channel.latency_samples.size() < kLatencySamples) {
+    channel.latency_samples.push_back(latency);
+  } else {
+    channel.latency_samples[channel.next_latency_sample] = latency;
+  }
+  channel.next_latency_sample = (channel.next_latency_sample + 1) % kLatencySamples;
+  if (channel.packets_sent % kLatencyReportPackets == 0) {
+    log_latency(cid);
+  }
+}
+
+void WeightedFairQueue::log_latency(Cid cid) const {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end() || channel->second.packets_sent == 0) {
+    return;
+  }
+  auto percentiles = GetLatencyPercentiles(cid);
+  LOG_INFO(
+      "cid:0x%04hx weight:%hu packets:%" PRIu64 " bytes:%" PRIu64 " queueing delay p50:%lldus p90:%lldus p99:%lldus",
+      cid,
+      get_weight(cid),
+      channel->second.packets_sent,
+      channel->second.bytes_sent,
+      static_cast<long long>(percentiles.p50.count()),
+      static_cast<long long>(percentiles.p90.count()),
+      static_cast<long long>(percentiles.p99.count()));
+}
+
+void WeightedFairQueue::try_register_link_queue_enqueue() {
+  if (link_queue_enqueue_registered_.exchange(true)) {
+    return;
+  }
+  link_queue_up_end_->RegisterEnqueue(
+      handler_, common::Bind(&WeightedFairQueue::link_queue_enqueue_callback, common::Unretained(this)));
+}
+
+void WeightedFairQueue::try_unregister_link_queue_enqueue() {
+  if (active_channels_.empty() && active_high_priority_channels_.empty() &&
+      link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+// Invoked from some external Queue Reactable context
+std::unique_ptr<WeightedFairQueue::LowerEnqueue> WeightedFairQueue::link_queue_enqueue_callback() {
+  ASSERT(!active_channels_.empty() || !active_high_priority_channels_.empty());
+  Cid cid = select_next_channel();
+  auto& channel = channels_[cid];
+  auto ready_time = channel.ready_times.front();
+  channel.ready_times.pop_front();
+  auto packet = data_pipeline_manager_->GetDataController(cid)->GetNextPacket();
+  size_t packet_size = packet->size();
+
+  auto& active_list = active_list_for(cid);
+  if (channel.ready_times.empty()) {
+    active_list.pop_front();
+    channel.active = false;
+    channel.deficit = 0;
+  } else if (&active_list == &active_high_priority_channels_) {
+    // High priority channels take turns one PDU at a time
+    active_list.splice(active_list.end(), active_list, active_list.begin());
+  } else {
+    channel.deficit -= static_cast<int32_t>(packet_size);
+    if (channel.deficit <= 0) {
+      active_list.splice(active_list.end(), active_list, active_list.begin());
+    }
+  }
+
+  channel.packets_sent++;
+  channel.bytes_sent += packet_size;
+  record_latency(
+      cid, channel, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - ready_time));
+
+  data_pipeline_manager_->OnPacketSent(cid);
+  try_unregister_link_queue_enqueue();
+  return packet;
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
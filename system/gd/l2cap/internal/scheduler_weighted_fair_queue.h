@@ -0,0 +1,106 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "l2cap/cid.h"
+#include "l2cap/internal/scheduler.h"
+#include "os/handler.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+class DataPipelineManager;
+
+/**
+ * Shares the link between channels with deficit round robin over the bytes each one sends, so that a bulk transfer
+ * cannot hold back the small PDUs of other channels on the same link.
+ *
+ * High priority channels are still served first, one PDU each in turn. Every other channel gets a quantum of
+ * kQuantumBytes times its weight per round. The size of a PDU is only known once the data controller built it, so a
+ * channel may overdraw its deficit by up to one PDU, which is paid back in the next round.
+ *
+ * The time between OnPacketsReady and the PDU going to the link queue is sampled per channel, and its percentiles are
+ * logged every kLatencyReportPackets PDUs and when the channel is removed.
+ */
+class WeightedFairQueue : public Scheduler {
+ public:
+  static constexpr int32_t kQuantumBytes = 1024;
+  static constexpr uint16_t kDefaultWeight = 1;
+  static constexpr size_t kLatencySamples = 256;
+  static constexpr uint64_t kLatencyReportPackets = 1000;
+
+  struct LatencyPercentiles {
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+  };
+
+  WeightedFairQueue(
+      DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler);
+  ~WeightedFairQueue();
+  void OnPacketsReady(Cid cid, int number_packets) override;
+  void SetChannelTxPriority(Cid cid, bool high_priority) override;
+  void SetChannelTxWeight(Cid cid, uint16_t weight) override;
+  void RemoveChannel(Cid cid) override;
+
+  // Percentiles of the queueing delay of the last kLatencySamples PDUs sent on cid, or zero if none were sent
+  LatencyPercentiles GetLatencyPercentiles(Cid cid) const;
+
+ private:
+  struct ChannelState {
+    std::deque<std::chrono::steady_clock::time_point> ready_times;
+    int32_t deficit = 0;
+    bool active = false;
+    uint64_t packets_sent = 0;
+    uint64_t bytes_sent = 0;
+    std::vector<std::chrono::microseconds> latency_samples;
+    size_t next_latency_sample = 0;
+  };
+
+  DataPipelineManager* data_pipeline_manager_;
+  LowerQueueUpEnd* link_queue_up_end_;
+  os::Handler* handler_;
+  std::unordered_map<Cid, ChannelState> channels_;
+  std::unordered_map<Cid, uint16_t> tx_weights_;
+  std::unordered_set<Cid> high_priority_cids_;
+  // Channels with packets ready, high priority ones apart
+  std::list<Cid> active_channels_;
+  std::list<Cid> active_high_priority_channels_;
+  std::atomic_bool link_queue_enqueue_registered_ = false;
+
+  uint16_t get_weight(Cid cid) const;
+  std::list<Cid>& active_list_for(Cid cid);
+  Cid select_next_channel();
+  void record_latency(Cid cid, ChannelState& channel, std::chrono::microseconds latency);
+  void log_latency(Cid cid) const;
+  void try_register_link_queue_enqueue();
+  void try_unregister_link_queue_enqueue();
+  std::unique_ptr<LowerEnqueue> link_queue_enqueue_callback();
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
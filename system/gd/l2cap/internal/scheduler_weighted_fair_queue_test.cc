@@ -0,0 +1,201 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_weighted_fair_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "l2cap/internal/data_controller_mock.h"
+#include "l2cap/internal/data_pipeline_manager_mock.h"
+#include "os/handler.h"
+#include "os/mock_queue.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+// A basic frame of exactly one quantum
+constexpr size_t kQuantumPayloadSize = WeightedFairQueue::kQuantumBytes - 4;
+
+std::unique_ptr<packet::BasePacketBuilder> CreateSdu(std::vector<uint8_t> payload) {
+  auto raw_builder = std::make_unique<packet::RawBuilder>();
+  raw_builder->AddOctets(payload);
+  return raw_builder;
+}
+
+PacketView<kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter i(*bytes);
+  bytes->reserve(packet->size());
+  packet->Serialize(i);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+class MyDataController : public testing::MockDataController {
+ public:
+  std::unique_ptr<BasePacketBuilder> GetNextPacket() override {
+    auto next = std::move(next_packets.front());
+    next_packets.pop();
+    return next;
+  }
+
+  std::queue<std::unique_ptr<BasePacketBuilder>> next_packets;
+};
+
+class L2capSchedulerWeightedFairQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    queue_handler_ = new os::Handler(thread_);
+    mock_data_pipeline_manager_ = new testing::MockDataPipelineManager(queue_handler_, &queue_end_);
+    scheduler_ = new WeightedFairQueue(mock_data_pipeline_manager_, &queue_end_, queue_handler_);
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(1)).WillRepeatedly(Return(&data_controller_1_));
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(2)).WillRepeatedly(Return(&data_controller_2_));
+  }
+
+  void TearDown() override {
+    delete scheduler_;
+    delete mock_data_pipeline_manager_;
+    queue_handler_->Clear();
+    delete queue_handler_;
+    delete thread_;
+  }
+
+  // Make count basic frames with a payload of payload_size ready on cid
+  void QueueFrames(Cid cid, MyDataController* data_controller, int count, size_t payload_size) {
+    for (int i = 0; i < count; i++) {
+      data_controller->next_packets.push(
+          BasicFrameBuilder::Create(cid, CreateSdu(std::vector<uint8_t>(payload_size, 'a' + i))));
+    }
+    scheduler_->OnPacketsReady(cid, count);
+  }
+
+  // The channel ids of the frames the scheduler sent, in order
+  std::vector<Cid> TakeSentCids() {
+    std::vector<Cid> cids;
+    while (!enqueue_.enqueued.empty()) {
+      auto basic_frame_view = BasicFrameView::Create(GetPacketView(std::move(enqueue_.enqueued.front())));
+      enqueue_.enqueued.pop();
+      EXPECT_TRUE(basic_frame_view.IsValid());
+      cids.push_back(basic_frame_view.GetChannelId());
+    }
+    return cids;
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* queue_handler_ = nullptr;
+  os::MockIQueueDequeue<Scheduler::LowerDequeue> dequeue_;
+  os::MockIQueueEnqueue<Scheduler::LowerEnqueue> enqueue_;
+  common::BidiQueueEnd<Scheduler::LowerEnqueue, Scheduler::LowerDequeue> queue_end_{&enqueue_, &dequeue_};
+  testing::MockDataPipelineManager* mock_data_pipeline_manager_ = nullptr;
+  MyDataController data_controller_1_;
+  MyDataController data_controller_2_;
+  WeightedFairQueue* scheduler_ = nullptr;
+};
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, send_packet) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(1));
+  data_controller_1_.next_packets.push(BasicFrameBuilder::Create(1, CreateSdu({'a', 'b', 'c'})));
+  scheduler_->OnPacketsReady(1, 1);
+  enqueue_.run_enqueue();
+  auto basic_frame_view = BasicFrameView::Create(GetPacketView(std::move(enqueue_.enqueued.front())));
+  enqueue_.enqueued.pop();
+  ASSERT_TRUE(basic_frame_view.IsValid());
+  ASSERT_EQ(basic_frame_view.GetChannelId(), 1);
+  auto payload = basic_frame_view.GetPayload();
+  ASSERT_EQ(std::string(payload.begin(), payload.end()), "abc");
+  // Nothing left to send
+  ASSERT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, prioritize_channel) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(4);
+  scheduler_->SetChannelTxPriority(1, true);
+  QueueFrames(2, &data_controller_2_, 2, 3);
+  QueueFrames(1, &data_controller_1_, 2, 3);
+  enqueue_.run_enqueue(4);
+  ASSERT_THAT(TakeSentCids(), ElementsAre(1, 1, 2, 2));
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, bulk_channel_does_not_delay_small_frames) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(8);
+  QueueFrames(1, &data_controller_1_, 4, kQuantumPayloadSize);
+  QueueFrames(2, &data_controller_2_, 4, 3);
+  enqueue_.run_enqueue(8);
+  // A whole quantum goes to one large frame, while the small ones all fit in theirs
+  ASSERT_THAT(TakeSentCids(), ElementsAre(1, 2, 2, 2, 2, 1, 1, 1));
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, share_link_by_weight) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(10);
+  scheduler_->SetChannelTxWeight(1, 3);
+  QueueFrames(1, &data_controller_1_, 6, kQuantumPayloadSize);
+  QueueFrames(2, &data_controller_2_, 4, kQuantumPayloadSize);
+  enqueue_.run_enqueue(10);
+  ASSERT_THAT(TakeSentCids(), ElementsAre(1, 1, 1, 2, 1, 1, 1, 2, 2, 2));
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, overdrawn_channel_waits_for_next_round) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(4);
+  // A frame of two quanta leaves channel 1 one quantum in debt
+  QueueFrames(1, &data_controller_1_, 2, 2 * WeightedFairQueue::kQuantumBytes - 4);
+  QueueFrames(2, &data_controller_2_, 2, kQuantumPayloadSize);
+  enqueue_.run_enqueue(4);
+  ASSERT_THAT(TakeSentCids(), ElementsAre(1, 2, 2, 1));
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, remove_channel) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(2));
+  QueueFrames(1, &data_controller_1_, 1, 3);
+  QueueFrames(2, &data_controller_2_, 1, 3);
+  scheduler_->RemoveChannel(1);
+  enqueue_.run_enqueue(2);
+  ASSERT_THAT(TakeSentCids(), ElementsAre(2));
+  ASSERT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerWeightedFairQueueTest, latency_percentiles) {
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(1)).Times(10);
+  auto percentiles = scheduler_->GetLatencyPercentiles(1);
+  ASSERT_EQ(percentiles.p99.count(), 0);
+
+  QueueFrames(1, &data_controller_1_, 10, 3);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  enqueue_.run_enqueue(10);
+  TakeSentCids();
+  percentiles = scheduler_->GetLatencyPercentiles(1);
+  ASSERT_GE(percentiles.p50, std::chrono::milliseconds(5));
+  ASSERT_LE(percentiles.p50, percentiles.p90);
+  ASSERT_LE(percentiles.p90, percentiles.p99);
+
+  scheduler_->RemoveChannel(1);
+  ASSERT_EQ(scheduler_->GetLatencyPercentiles(1).p99.count(), 0);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -40,7 +40,8 @@ Link::Link(os::Handler* l2cap_handler, std::unique_ptr<hci::acl_manager::LeAclCo
            DynamicChannelServiceManagerImpl* dynamic_service_manager,
            FixedChannelServiceManagerImpl* fixed_service_manager, LinkManager* link_manager)
     : l2cap_handler_(l2cap_handler), acl_connection_(std::move(acl_connection)),
-      data_pipeline_manager_(l2cap_handler, this, acl_connection_->GetAclQueueEnd()),
+      data_pipeline_manager_(
+          l2cap_handler, this, acl_connection_->GetAclQueueEnd(), l2cap::internal::GetLinkSchedulerType()),
       parameter_provider_(parameter_provider), dynamic_service_manager_(dynamic_service_manager),
       signalling_manager_(l2cap_handler_, this, &data_pipeline_manager_, dynamic_service_manager_,
                           &dynamic_channel_allocator_),
@@ -89,6 +90,7 @@ void Link::OnConnectionUpdate(
 
 void Link::OnDataLengthChange(uint16_t tx_octets, uint16_t tx_time, uint16_t rx_octets, uint16_t rx_time) {
   LOG_INFO("tx_octets %hx tx_time %hx rx_octets %hx rx_time %hx", tx_octets, tx_time, rx_octets, rx_time);
+  link_tuner_.OnDataLengthChange(tx_octets);
 }
 
 void Link::OnReadRemoteVersionInformationComplete(
@@ -100,7 +102,9 @@ void Link::OnReadRemoteVersionInformationComplete(
 
 void Link::OnLeReadRemoteFeaturesComplete(hci::ErrorCode hci_status, uint64_t features) {}
 
-void Link::OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy) {}
+void Link::OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy) {
+  link_tuner_.OnPhyUpdate(hci_status, tx_phy, rx_phy);
+}
 
 void Link::OnLeSubrateChange(
     hci::ErrorCode hci_status,
@@ -125,6 +129,7 @@ void Link::Disconnect() {
 void Link::UpdateConnectionParameterFromRemote(SignalId signal_id, uint16_t conn_interval_min,
                                                uint16_t conn_interval_max, uint16_t conn_latency,
                                                uint16_t supervision_timeout) {
+  link_tuner_.OnConnectionParametersChosen();
   acl_connection_->LeConnectionUpdate(conn_interval_min, conn_interval_max, conn_latency, supervision_timeout,
                                       kDefaultMinimumCeLength, kDefaultMaximumCeLength);
   update_request_signal_id_ = signal_id;
@@ -158,6 +163,19 @@ bool Link::CheckConnectionParameters(
 
 void Link::SendConnectionParameterUpdate(uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency,
                                          uint16_t supervision_timeout, uint16_t min_ce_length, uint16_t max_ce_length) {
+  link_tuner_.OnConnectionParametersChosen();
+  send_connection_parameter_update(conn_interval_min, conn_interval_max, conn_latency, supervision_timeout,
+                                   min_ce_length, max_ce_length);
+}
+
+void Link::SetPhy(uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, hci::PhyOptions phy_options) {
+  link_tuner_.OnPhyChosen();
+  acl_connection_->LeSetPhy(all_phys, tx_phys, rx_phys, phy_options);
+}
+
+void Link::send_connection_parameter_update(uint16_t conn_interval_min, uint16_t conn_interval_max,
+                                            uint16_t conn_latency, uint16_t supervision_timeout,
+                                            uint16_t min_ce_length, uint16_t max_ce_length) {
   if (acl_connection_->GetRole() == hci::Role::PERIPHERAL) {
     // TODO: If both LL central and peripheral support 4.1, use HCI command directly
     signalling_manager_.SendConnectionParameterUpdateRequest(conn_interval_min, conn_interval_max, conn_latency,
@@ -308,6 +326,12 @@ void Link::on_connection_update_complete(SignalId signal_id, hci::ErrorCode erro
   signalling_manager_.SendConnectionParameterUpdateResponse(SignalId(), result);
 }
 
+void Link::on_tuned_connection_parameters(uint16_t conn_interval_min, uint16_t conn_interval_max,
+                                          uint16_t conn_latency, uint16_t supervision_timeout) {
+  send_connection_parameter_update(conn_interval_min, conn_interval_max, conn_latency, supervision_timeout,
+                                   kDefaultMinimumCeLength, kDefaultMaximumCeLength);
+}
+
 void Link::OnPendingPacketChange(Cid local_cid, bool has_packet) {
   if (has_packet) {
     remaining_packets_to_be_sent_++;
@@ -315,6 +339,7 @@ void Link::OnPendingPacketChange(Cid local_cid, bool has_packet) {
     remaining_packets_to_be_sent_--;
   }
   link_manager_->OnPendingPacketChange(GetDevice(), remaining_packets_to_be_sent_);
+  link_tuner_.OnPendingPacketChange(remaining_packets_to_be_sent_ > 0);
 }
 
 }  // namespace internal
@@ -31,6 +31,7 @@
 #include "l2cap/le/internal/dynamic_channel_service_manager_impl.h"
 #include "l2cap/le/internal/fixed_channel_impl.h"
 #include "l2cap/le/internal/fixed_channel_service_manager_impl.h"
+#include "l2cap/le/internal/link_tuner.h"
 #include "l2cap/le/internal/signalling_manager.h"
 #include "l2cap/le/link_options.h"
 #include "l2cap/le/security_enforcement_interface.h"
@@ -117,6 +118,8 @@ class Link : public l2cap::internal::ILink,
                                              uint16_t conn_latency, uint16_t supervision_timeout,
                                              uint16_t min_ce_length, uint16_t max_ce_length);
 
+  virtual void SetPhy(uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, hci::PhyOptions phy_options);
+
   // FixedChannel methods
 
   virtual std::shared_ptr<FixedChannelImpl> AllocateFixedChannel(Cid cid, SecurityPolicy security_policy);
@@ -185,6 +188,8 @@ class Link : public l2cap::internal::ILink,
   std::unordered_map<Cid, PendingDynamicChannelConnection> local_cid_to_pending_dynamic_channel_connection_map_;
   os::Alarm link_idle_disconnect_alarm_{l2cap_handler_};
   LinkOptions link_options_{acl_connection_.get(), this, l2cap_handler_};
+  LinkTuner link_tuner_{l2cap_handler_, acl_connection_.get(), parameter_provider_,
+                        common::Bind(&Link::on_tuned_connection_parameters, common::Unretained(this))};
   LinkManager* link_manager_;
   SignalId update_request_signal_id_ = kInvalidSignalId;
   uint16_t update_request_interval_min_;
@@ -197,6 +202,12 @@ class Link : public l2cap::internal::ILink,
   // response to remote. If SignalId is bound to an invalid number, we don't send a response to remote, because the
   // connection update request is not from remote LL peripheral.
   void on_connection_update_complete(SignalId signal_id, hci::ErrorCode error_code);
+
+  void send_connection_parameter_update(uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency,
+                                        uint16_t supervision_timeout, uint16_t min_ce_length, uint16_t max_ce_length);
+
+  void on_tuned_connection_parameters(uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency,
+                                      uint16_t supervision_timeout);
 };
 
 }  // namespace internal
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/le/internal/link_tuner.h"
+
+#include "common/bind.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace le {
+namespace internal {
+
+// Largest PDU payload, and the time to send it on the 1M PHY (Core spec HCI 7.8.33)
+static constexpr uint16_t kMaxTxOctets = 0x00FB;
+static constexpr uint16_t kMaxTxTime = 0x0848;
+
+static constexpr uint8_t kPhy2m = 0x02;
+static constexpr uint8_t kPhy2mMask = 0x02;
+
+// 7.5 ms to 15 ms while a transfer runs, otherwise 30 ms to 50 ms like the connections are created with
+static constexpr uint16_t kThroughputConnIntervalMin = 0x0006;
+static constexpr uint16_t kThroughputConnIntervalMax = 0x000C;
+static constexpr uint16_t kPowerConnIntervalMin = 0x0018;
+static constexpr uint16_t kPowerConnIntervalMax = 0x0028;
+static constexpr uint16_t kConnLatency = 0x0000;
+static constexpr uint16_t kSupervisionTimeout = 0x01F4;
+
+LinkTuner::LinkTuner(os::Handler* l2cap_handler, hci::acl_manager::LeAclConnection* acl_connection,
+                     l2cap::internal::ParameterProvider* parameter_provider,
+                     UpdateConnectionParametersCallback update_connection_parameters)
+    : l2cap_handler_(l2cap_handler), acl_connection_(acl_connection), parameter_provider_(parameter_provider),
+      update_connection_parameters_(std::move(update_connection_parameters)) {}
+
+void LinkTuner::OnPendingPacketChange(bool has_pending_packets) {
+  if (has_pending_packets == has_pending_packets_) {
+    return;
+  }
+  has_pending_packets_ = has_pending_packets;
+  if (!has_pending_packets) {
+    last_drained_ = std::chrono::steady_clock::now();
+    if (tuned_for_throughput_) {
+      idle_alarm_.Schedule(common::BindOnce(&LinkTuner::tune_for_power, common::Unretained(this)),
+                           parameter_provider_->GetLeLinkBulkTransferIdleTimeout());
+    }
+    return;
+  }
+  idle_alarm_.Cancel();
+  if (!tuned_for_throughput_ && !detecting_bulk_transfer_) {
+    detecting_bulk_transfer_ = true;
+    bulk_transfer_detection_alarm_.Schedule(
+        common::BindOnce(&LinkTuner::on_bulk_transfer_detection_timeout, common::Unretained(this)),
+        parameter_provider_->GetLeLinkBulkTransferDetectionTime());
+  }
+}
+
+void LinkTuner::OnDataLengthChange(uint16_t tx_octets) {
+  if (tx_octets >= kMaxTxOctets) {
+    data_length_requested_ = true;
+  }
+}
+
+void LinkTuner::OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy) {
+  if (hci_status == hci::ErrorCode::SUCCESS && tx_phy == kPhy2m && rx_phy == kPhy2m) {
+    phy_requested_ = true;
+  }
+}
+
+void LinkTuner::OnConnectionParametersChosen() {
+  connection_parameters_chosen_ = true;
+}
+
+void LinkTuner::OnPhyChosen() {
+  phy_chosen_ = true;
+}
+
+void LinkTuner::on_bulk_transfer_detection_timeout() {
+  detecting_bulk_transfer_ = false;
+  // A request and its response drain the queue well before the detection time, a transfer keeps refilling it. A
+  // queue drained in the last quarter of the detection time still counts as busy.
+  auto busy_after_drained = parameter_provider_->GetLeLinkBulkTransferDetectionTime() / 4;
+  if (has_pending_packets_ || std::chrono::steady_clock::now() - last_drained_ < busy_after_drained) {
+    tune_for_throughput();
+  }
+}
+
+void LinkTuner::tune_for_throughput() {
+  LOG_INFO("Tuning link for throughput");
+  tuned_for_throughput_ = true;
+  if (!data_length_requested_) {
+    data_length_requested_ = true;
+    acl_connection_->LeSetDataLength(kMaxTxOctets, kMaxTxTime);
+  }
+  if (!phy_chosen_ && !phy_requested_) {
+    phy_requested_ = true;
+    acl_connection_->LeSetPhy(0x00, kPhy2mMask, kPhy2mMask, hci::PhyOptions::NO_PREFERENCE);
+  }
+  if (!connection_parameters_chosen_) {
+    update_connection_parameters_.Run(
+        kThroughputConnIntervalMin, kThroughputConnIntervalMax, kConnLatency, kSupervisionTimeout);
+  }
+  if (!has_pending_packets_) {
+    idle_alarm_.Schedule(common::BindOnce(&LinkTuner::tune_for_power, common::Unretained(this)),
+                         parameter_provider_->GetLeLinkBulkTransferIdleTimeout());
+  }
+}
+
+void LinkTuner::tune_for_power() {
+  LOG_INFO("Tuning idle link for power");
+  tuned_for_throughput_ = false;
+  if (!connection_parameters_chosen_) {
+    update_connection_parameters_.Run(kPowerConnIntervalMin, kPowerConnIntervalMax, kConnLatency, kSupervisionTimeout);
+  }
+}
+
+}  // namespace internal
+}  // namespace le
+}  // namespace l2cap
+}  // namespace bluetooth
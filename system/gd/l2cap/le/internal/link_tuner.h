@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "common/callback.h"
+#include "hci/acl_manager/le_acl_connection.h"
+#include "l2cap/internal/parameter_provider.h"
+#include "os/alarm.h"
+#include "os/handler.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace le {
+namespace internal {
+
+/**
+ * Adapts the link layer parameters of an LE link to its traffic, so that transfers such as firmware updates run fast
+ * without their application asking for it.
+ *
+ * A link that keeps packets queued for a while is switched to the largest data length, the 2M PHY and a short
+ * connection interval. Once nothing has been queued for a while, the connection interval is relaxed again. The data
+ * length and the PHY are kept, they shorten the radio time of sparse traffic as well.
+ *
+ * The connection parameters and the PHY are left alone once a profile or the remote chose them.
+ */
+class LinkTuner {
+ public:
+  using UpdateConnectionParametersCallback = common::Callback<void(
+      uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency, uint16_t supervision_timeout)>;
+
+  LinkTuner(os::Handler* l2cap_handler, hci::acl_manager::LeAclConnection* acl_connection,
+            l2cap::internal::ParameterProvider* parameter_provider,
+            UpdateConnectionParametersCallback update_connection_parameters);
+
+  LinkTuner(const LinkTuner&) = delete;
+  LinkTuner& operator=(const LinkTuner&) = delete;
+
+  // Whether any channel of the link has packets waiting to be sent
+  void OnPendingPacketChange(bool has_pending_packets);
+
+  void OnDataLengthChange(uint16_t tx_octets);
+
+  void OnPhyUpdate(hci::ErrorCode hci_status, uint8_t tx_phy, uint8_t rx_phy);
+
+  // A profile or the remote asked for connection parameters of its own
+  void OnConnectionParametersChosen();
+
+  // A profile asked for a PHY of its own
+  void OnPhyChosen();
+
+  bool IsTunedForThroughput() const {
+    return tuned_for_throughput_;
+  }
+
+ private:
+  void on_bulk_transfer_detection_timeout();
+  void tune_for_throughput();
+  void tune_for_power();
+
+  os::Handler* l2cap_handler_;
+  hci::acl_manager::LeAclConnection* acl_connection_;
+  l2cap::internal::ParameterProvider* parameter_provider_;
+  UpdateConnectionParametersCallback update_connection_parameters_;
+  os::Alarm bulk_transfer_detection_alarm_{l2cap_handler_};
+  os::Alarm idle_alarm_{l2cap_handler_};
+  bool has_pending_packets_ = false;
+  bool detecting_bulk_transfer_ = false;
+  std::chrono::steady_clock::time_point last_drained_;
+  bool tuned_for_throughput_ = false;
+  bool connection_parameters_chosen_ = false;
+  bool phy_chosen_ = false;
+  // Set once requested, or once the link is found to use them already. They are never requested twice.
+  bool data_length_requested_ = false;
+  bool phy_requested_ = false;
+};
+
+}  // namespace internal
+}  // namespace le
+}  // namespace l2cap
+}  // namespace bluetooth
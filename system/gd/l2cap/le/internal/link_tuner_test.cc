@@ -0,0 +1,165 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/le/internal/link_tuner.h"
+
+#include <future>
+#include <thread>
+
+#include "common/bind.h"
+#include "hci/acl_manager_mock.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace l2cap {
+namespace le {
+namespace internal {
+namespace {
+
+using hci::testing::MockLeAclConnection;
+using ::testing::Return;
+
+constexpr auto kDetectionTime = std::chrono::milliseconds(20);
+constexpr auto kIdleTimeout = std::chrono::milliseconds(50);
+constexpr auto kWaitTime = std::chrono::seconds(1);
+
+class ShortTimesParameterProvider : public l2cap::internal::ParameterProvider {
+ public:
+  std::chrono::milliseconds GetLeLinkBulkTransferDetectionTime() override {
+    return kDetectionTime;
+  }
+  std::chrono::milliseconds GetLeLinkBulkTransferIdleTimeout() override {
+    return kIdleTimeout;
+  }
+};
+
+class L2capLeLinkTunerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+    link_tuner_ = new LinkTuner(
+        handler_, &acl_connection_, &parameter_provider_,
+        common::Bind(&L2capLeLinkTunerTest::on_update_connection_parameters, common::Unretained(this)));
+    ON_CALL(acl_connection_, LeSetDataLength).WillByDefault(Return(true));
+    ON_CALL(acl_connection_, LeSetPhy).WillByDefault(Return(true));
+  }
+
+  void TearDown() override {
+    Run([this] { delete link_tuner_; });
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+  }
+
+  // Runs |task| on the l2cap handler and waits for it
+  template <typename F>
+  void Run(F task) {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    handler_->Post(common::BindOnce(
+        [](F task, std::promise<void>* promise) {
+          task();
+          promise->set_value();
+        },
+        task,
+        common::Unretained(&promise)));
+    ASSERT_EQ(future.wait_for(kWaitTime), std::future_status::ready);
+  }
+
+  // Waits for the next connection parameters requested by the tuner
+  uint16_t WaitForConnectionIntervalMax() {
+    auto future = parameters_promise_.get_future();
+    EXPECT_EQ(future.wait_for(kWaitTime), std::future_status::ready);
+    parameters_promise_ = std::promise<uint16_t>();
+    return future.get();
+  }
+
+  void on_update_connection_parameters(
+      uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency, uint16_t supervision_timeout) {
+    parameters_requested_++;
+    parameters_promise_.set_value(conn_interval_max);
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* handler_ = nullptr;
+  ::testing::NiceMock<MockLeAclConnection> acl_connection_;
+  ShortTimesParameterProvider parameter_provider_;
+  LinkTuner* link_tuner_ = nullptr;
+  std::promise<uint16_t> parameters_promise_;
+  int parameters_requested_ = 0;
+};
+
+TEST_F(L2capLeLinkTunerTest, bulk_transfer_tunes_link_until_idle) {
+  EXPECT_CALL(acl_connection_, LeSetDataLength(0x00FB, 0x0848)).Times(1);
+  EXPECT_CALL(acl_connection_, LeSetPhy(0x00, 0x02, 0x02, hci::PhyOptions::NO_PREFERENCE)).Times(1);
+  Run([this] { link_tuner_->OnPendingPacketChange(true); });
+
+  ASSERT_EQ(WaitForConnectionIntervalMax(), 0x000C);
+  Run([this] {
+    ASSERT_TRUE(link_tuner_->IsTunedForThroughput());
+    link_tuner_->OnPendingPacketChange(false);
+  });
+
+  ASSERT_EQ(WaitForConnectionIntervalMax(), 0x0028);
+  Run([this] { ASSERT_FALSE(link_tuner_->IsTunedForThroughput()); });
+
+  // The data length and the PHY are kept for the next transfer
+  Run([this] { link_tuner_->OnPendingPacketChange(true); });
+  ASSERT_EQ(WaitForConnectionIntervalMax(), 0x000C);
+}
+
+TEST_F(L2capLeLinkTunerTest, short_exchange_leaves_link_alone) {
+  EXPECT_CALL(acl_connection_, LeSetDataLength).Times(0);
+  EXPECT_CALL(acl_connection_, LeSetPhy).Times(0);
+  Run([this] {
+    link_tuner_->OnPendingPacketChange(true);
+    link_tuner_->OnPendingPacketChange(false);
+  });
+
+  std::this_thread::sleep_for(kDetectionTime * 3);
+  Run([this] {
+    ASSERT_FALSE(link_tuner_->IsTunedForThroughput());
+    ASSERT_EQ(parameters_requested_, 0);
+  });
+}
+
+TEST_F(L2capLeLinkTunerTest, choices_of_profiles_are_kept) {
+  EXPECT_CALL(acl_connection_, LeSetDataLength).Times(0);
+  EXPECT_CALL(acl_connection_, LeSetPhy).Times(0);
+  Run([this] {
+    link_tuner_->OnDataLengthChange(0x00FB);
+    link_tuner_->OnConnectionParametersChosen();
+    link_tuner_->OnPhyChosen();
+    link_tuner_->OnPendingPacketChange(true);
+  });
+
+  std::this_thread::sleep_for(kDetectionTime * 3);
+  Run([this] {
+    ASSERT_TRUE(link_tuner_->IsTunedForThroughput());
+    ASSERT_EQ(parameters_requested_, 0);
+  });
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace le
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -59,8 +59,15 @@ bool LinkOptions::UpdateConnectionParameter(uint16_t conn_interval_min, uint16_t
 }
 
 bool LinkOptions::SetPhy(uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, uint16_t phy_options) {
-  LOG_ERROR("Not implemented");
-  return false;
+  if (all_phys > 0x03 || tx_phys > 0x07 || rx_phys > 0x07 || phy_options > 0x0002) {
+    LOG_ERROR("Invalid parameter");
+    return false;
+  }
+
+  l2cap_handler_->Post(common::BindOnce(&internal::Link::SetPhy, common::Unretained(link_), all_phys, tx_phys,
+                                        rx_phys, static_cast<hci::PhyOptions>(phy_options)));
+
+  return true;
 }
 
 }  // namespace le
@@ -17,6 +17,8 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <climits>
+
 #include "common/bind.h"
 #include "os/log.h"
 #include "os/metrics.h"
@@ -28,6 +30,18 @@ const int COUNTER_METRICS_PERDIOD_MINUTES = 360; // Drain counters every 6 hours
 
 const ModuleFactory CounterMetrics::Factory = ModuleFactory([]() { return new CounterMetrics(); });
 
+namespace {
+std::atomic<uint64_t> next_instance_id = 1;
+
+int64_t saturating_add(int64_t total, int64_t count) {
+  return LLONG_MAX - total < count ? LLONG_MAX : total + count;
+}
+}  // namespace
+
+CounterMetrics::CounterMetrics() : instance_id_(next_instance_id++) {}
+
+CounterMetrics::~CounterMetrics() = default;
+
 void CounterMetrics::ListDependencies(ModuleList* list) const {
 }
 
@@ -58,6 +72,19 @@ bool CounterMetrics::CacheCount(int32_t key, int64_t count) {
     LOG_WARN("count is not larger than 0. count: %s, key: %d", std::to_string(count).c_str(), key);
     return false;
   }
+  if (key >= 0 && key < kShardedKeyCount) {
+    auto& counter = get_shard().counters[key];
+    int64_t total = counter.load(std::memory_order_relaxed);
+    if (LLONG_MAX - total < count) {
+      LOG_WARN("Counter metric overflows. count %s current total: %s key: %d",
+               std::to_string(count).c_str(), std::to_string(total).c_str(), key);
+      counter.store(LLONG_MAX, std::memory_order_relaxed);
+      return false;
+    }
+    // Only this thread adds to its shard, this only races with a drain resetting the counter
+    counter.fetch_add(count, std::memory_order_relaxed);
+    return true;
+  }
   int64_t total = 0;
   std::lock_guard<std::mutex> lock(mutex_);
   if (counters_.find(key) != counters_.end()) {
@@ -91,12 +118,43 @@ void CounterMetrics::DrainBufferedCounters() {
     LOG_WARN("Counter metrics isn't initialized");
     return ;
   }
-  std::lock_guard<std::mutex> lock(mutex_);
   LOG_INFO("Draining buffered counters");
-  for (auto const& pair : counters_) {
+  std::unordered_map<int32_t, int64_t> totals;
+  {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    for (auto& shard : shards_) {
+      for (int32_t key = 0; key < kShardedKeyCount; key++) {
+        auto& counter = shard->counters[key];
+        if (counter.load(std::memory_order_relaxed) == 0) {
+          continue;
+        }
+        totals[key] = saturating_add(totals[key], counter.exchange(0, std::memory_order_relaxed));
+      }
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& pair : counters_) {
+      totals[pair.first] = saturating_add(totals[pair.first], pair.second);
+    }
+    counters_.clear();
+  }
+  for (auto const& pair : totals) {
     Count(pair.first, pair.second);
   }
-  counters_.clear();
+}
+
+CounterMetrics::Shard& CounterMetrics::get_shard() {
+  thread_local uint64_t cached_instance_id = 0;
+  thread_local Shard* cached_shard = nullptr;
+  if (cached_instance_id != instance_id_) {
+    auto shard = std::make_unique<Shard>();
+    cached_shard = shard.get();
+    cached_instance_id = instance_id_;
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    shards_.push_back(std::move(shard));
+  }
+  return *cached_shard;
 }
 
 }  // namespace metrics
@@ -15,7 +15,11 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -23,8 +27,19 @@
 namespace bluetooth {
 namespace metrics {
 
+// Counts are cached and logged when drained, every few hours and when the module stops.
+//
+// Keys below kShardedKeyCount, which covers the CodePathCounterKeyEnum values, are counted in a shard per calling
+// thread without taking a lock, so CacheCount() can be called on a per packet path. Shards are only summed when
+// drained. Other keys are counted in a map under a lock.
 class CounterMetrics : public bluetooth::Module {
  public:
+  static constexpr int32_t kShardedKeyCount = 4096;
+
+  CounterMetrics();
+  ~CounterMetrics();
+
+  // Safe to call from any thread
   bool CacheCount(int32_t key, int64_t value);
   virtual bool Count(int32_t key, int64_t count);
   void Stop() override;
@@ -42,6 +57,18 @@ class CounterMetrics : public bluetooth::Module {
   }
 
  private:
+  // Written by its thread only, read and reset when drained. Aligned so that shards do not share cache lines.
+  struct alignas(64) Shard {
+    std::array<std::atomic<int64_t>, kShardedKeyCount> counters{};
+  };
+
+  Shard& get_shard();
+
+  // Tells a thread's cached shard of a destroyed CounterMetrics from one of a new instance at the same address
+  const uint64_t instance_id_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::mutex shards_mutex_;
+
   std::unordered_map<int32_t, int64_t> counters_;
   mutable std::mutex mutex_;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
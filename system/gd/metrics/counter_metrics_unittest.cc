@@ -16,7 +16,10 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <climits>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -87,6 +90,43 @@ TEST_F(CounterMetricsTest, non_positive) {
   ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
 }
 
+TEST_F(CounterMetricsTest, key_outside_shards) {
+  int32_t key = CounterMetrics::kShardedKeyCount + 1;
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(key, 2));
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(-1, 3));
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(key, 4));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[key], 6);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[-1], 3);
+}
+
+TEST_F(CounterMetricsTest, multiple_threads) {
+  constexpr int kThreads = 4;
+  constexpr int kCounts = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([this] {
+      for (int j = 0; j < kCounts; j++) {
+        testable_counter_metrics_.CacheCount(1, 1);
+        testable_counter_metrics_.CacheCount(2, 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[1], kThreads * kCounts);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[2], 2 * kThreads * kCounts);
+}
+
+TEST_F(CounterMetricsTest, overflow_across_threads) {
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(1, LLONG_MAX));
+  std::thread([this] { ASSERT_TRUE(testable_counter_metrics_.CacheCount(1, 1)); }).join();
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[1], LLONG_MAX);
+}
+
 }  // namespace
 }  // namespace metrics
 }  // namespace bluetooth
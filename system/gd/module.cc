@@ -17,6 +17,11 @@
 
 #include "module.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+
 #include "common/init_flags.h"
 #include "os/wakelock_manager.h"
 
@@ -27,6 +32,9 @@ using ::bluetooth::os::WakelockManager;
 namespace bluetooth {
 
 constexpr std::chrono::milliseconds kModuleStopTimeout = std::chrono::milliseconds(2000);
+constexpr std::chrono::milliseconds kModuleStopBudget = std::chrono::milliseconds(500);
+constexpr size_t kModuleStartThreads = 4;
+constexpr size_t kModuleStopThreads = 4;
 
 ModuleFactory::ModuleFactory(std::function<Module*()> ctor) : ctor_(ctor) {
 }
@@ -41,6 +49,12 @@ DumpsysDataFinisher Module::GetDumpsysData(flatbuffers::FlatBufferBuilder* build
   return EmptyDumpsysDataFinisher;
 }
 
+common::OnceClosure Module::DeferStartCompletion() {
+  ASSERT_LOG(!start_completion_.is_null(), "Start completion can only be deferred once, from Start()");
+  start_deferred_ = true;
+  return std::move(start_completion_);
+}
+
 const ModuleRegistry* Module::GetModuleRegistry() const {
   return registry_;
 }
@@ -56,19 +70,250 @@ Module* Module::GetDependency(const ModuleFactory* module) const {
 }
 
 Module* ModuleRegistry::Get(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto instance = started_modules_.find(module);
   ASSERT_LOG(instance != started_modules_.end(), "Request for module not started up, maybe not in Start(ModuleList)?");
   return instance->second;
 }
 
 bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   return started_modules_.find(module) != started_modules_.end();
 }
 
+// Starts a set of modules and their dependencies as a graph: every module whose dependencies have all
+// completed starting is handed to a pool of start threads, so independent subtrees start concurrently.
+// Completion order is a valid dependency order, so StopAll() can still tear down in reverse.
+class ModuleStartScheduler {
+ public:
+  ModuleStartScheduler(ModuleRegistry* registry, Thread* thread) : registry_(registry), thread_(thread) {}
+
+  void Run(ModuleList* modules) {
+    for (auto factory : modules->list_) {
+      Add(factory);
+    }
+    if (nodes_.empty()) {
+      return;
+    }
+
+    for (size_t i = 0; i < nodes_.size(); i++) {
+      if (nodes_[i].pending_dependencies == 0) {
+        ready_.push(i);
+      }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(nodes_.size(), kModuleStartThreads); i++) {
+      workers.emplace_back(&ModuleStartScheduler::Work, this);
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+ private:
+  static constexpr size_t kAlreadyStarted = SIZE_MAX;
+
+  struct Node {
+    const ModuleFactory* factory;
+    Module* instance;
+    std::vector<size_t> dependents;
+    size_t pending_dependencies = 0;
+    std::chrono::steady_clock::time_point start_time;
+  };
+
+  size_t Add(const ModuleFactory* factory) {
+    if (registry_->IsStarted(factory)) {
+      return kAlreadyStarted;
+    }
+    auto it = index_.find(factory);
+    if (it != index_.end()) {
+      return it->second;
+    }
+
+    LOG_INFO("Constructing next module");
+    Module* instance = factory->ctor_();
+    registry_->set_registry_and_handler(instance, registry_->thread_for(factory, thread_));
+    instance->ListDependencies(&instance->dependencies_);
+
+    size_t index = nodes_.size();
+    Node node;
+    node.factory = factory;
+    node.instance = instance;
+    nodes_.push_back(std::move(node));
+    index_[factory] = index;
+
+    for (auto dependency : instance->dependencies_.list_) {
+      size_t dependency_index = Add(dependency);
+      if (dependency_index == kAlreadyStarted) {
+        continue;
+      }
+      nodes_[dependency_index].dependents.push_back(index);
+      nodes_[index].pending_dependencies++;
+    }
+    return index;
+  }
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return !ready_.empty() || started_ == nodes_.size(); });
+      if (ready_.empty()) {
+        return;
+      }
+      size_t index = ready_.front();
+      ready_.pop();
+
+      Module* instance = nodes_[index].instance;
+      nodes_[index].start_time = std::chrono::steady_clock::now();
+      registry_->last_instance_ = "starting " + instance->ToString();
+      lock.unlock();
+
+      LOG_INFO("Calling Start() of %s", instance->ToString().c_str());
+      instance->start_completion_ = common::BindOnce(&ModuleStartScheduler::OnStarted, common::Unretained(this), index);
+      instance->start_deferred_ = false;
+      instance->Start();
+      if (!instance->start_deferred_) {
+        std::move(instance->start_completion_).Run();
+      }
+
+      lock.lock();
+    }
+  }
+
+  void OnStarted(size_t index) {
+    Node& node = nodes_[index];
+    registry_->record_started(
+        node.factory,
+        node.instance,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - node.start_time));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_++;
+    for (auto dependent : node.dependents) {
+      if (--nodes_[dependent].pending_dependencies == 0) {
+        ready_.push(dependent);
+      }
+    }
+    cv_.notify_all();
+  }
+
+  ModuleRegistry* registry_;
+  Thread* thread_;
+  std::vector<Node> nodes_;
+  std::map<const ModuleFactory*, size_t> index_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::queue<size_t> ready_;
+  size_t started_ = 0;
+};
+
+// Stops the started modules as a graph, in the reverse of ModuleStartScheduler: every module whose dependents have
+// all stopped is handed to a pool of stop threads, so independent subtrees stop concurrently.
+class ModuleStopScheduler {
+ public:
+  explicit ModuleStopScheduler(ModuleRegistry* registry) : registry_(registry) {}
+
+  void Run() {
+    for (auto factory : registry_->start_order_) {
+      index_[factory] = nodes_.size();
+      nodes_.push_back(Node{registry_->started_modules_[factory]});
+    }
+    if (nodes_.empty()) {
+      return;
+    }
+
+    for (size_t i = 0; i < nodes_.size(); i++) {
+      for (auto dependency : nodes_[i].instance->dependencies_.list_) {
+        auto it = index_.find(dependency);
+        if (it == index_.end()) {
+          continue;
+        }
+        nodes_[i].dependencies.push_back(it->second);
+        nodes_[it->second].pending_dependents++;
+      }
+    }
+    for (size_t i = 0; i < nodes_.size(); i++) {
+      if (nodes_[i].pending_dependents == 0) {
+        ready_.push(i);
+      }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(nodes_.size(), kModuleStopThreads); i++) {
+      workers.emplace_back(&ModuleStopScheduler::Work, this);
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+ private:
+  struct Node {
+    Module* instance;
+    std::vector<size_t> dependencies;
+    size_t pending_dependents = 0;
+  };
+
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return !ready_.empty() || stopped_ == nodes_.size(); });
+      if (ready_.empty()) {
+        return;
+      }
+      size_t index = ready_.front();
+      ready_.pop();
+
+      Module* instance = nodes_[index].instance;
+      registry_->last_instance_ = "stopping " + instance->ToString();
+      lock.unlock();
+
+      registry_->stop_instance(instance);
+
+      lock.lock();
+      stopped_++;
+      for (auto dependency : nodes_[index].dependencies) {
+        if (--nodes_[dependency].pending_dependents == 0) {
+          ready_.push(dependency);
+        }
+      }
+      cv_.notify_all();
+    }
+  }
+
+  ModuleRegistry* registry_;
+  std::vector<Node> nodes_;
+  std::map<const ModuleFactory*, size_t> index_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::queue<size_t> ready_;
+  size_t stopped_ = 0;
+};
+
 void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
-  for (auto it = modules->list_.begin(); it != modules->list_.end(); it++) {
-    Start(*it, thread);
+  auto start_time = std::chrono::steady_clock::now();
+  if (common::InitFlags::IsModuleParallelStartEnabled()) {
+    parallel_start_ = true;
+    ModuleStartScheduler scheduler(this, thread);
+    scheduler.Run(modules);
+  } else {
+    for (auto it = modules->list_.begin(); it != modules->list_.end(); it++) {
+      Start(*it, thread);
+    }
   }
+  total_start_duration_ +=
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+}
+
+void ModuleRegistry::SetModuleThread(const ModuleFactory* module, Thread* thread) {
+  ASSERT_LOG(!IsStarted(module), "The thread of a module must be set before it starts");
+  module_threads_[module] = thread;
+}
+
+Thread* ModuleRegistry::thread_for(const ModuleFactory* module, Thread* thread) const {
+  auto it = module_threads_.find(module);
+  return it != module_threads_.end() ? it->second : thread;
 }
 
 void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread) const {
@@ -76,44 +321,94 @@ void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread)
   instance->handler_ = new Handler(thread);
 }
 
+void ModuleRegistry::start_instance(Module* instance) {
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  instance->start_completion_ =
+      common::BindOnce(&std::promise<void>::set_value, common::Unretained(&promise));
+  instance->start_deferred_ = false;
+  instance->Start();
+  if (!instance->start_deferred_) {
+    std::move(instance->start_completion_).Run();
+  }
+  future.wait();
+}
+
+void ModuleRegistry::record_started(
+    const ModuleFactory* module, Module* instance, std::chrono::microseconds duration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  start_order_.push_back(module);
+  started_modules_[module] = instance;
+  start_records_.push_back({instance->ToString(), duration, instance->start_deferred_});
+  LOG_INFO("Started %s in %lld us", instance->ToString().c_str(), static_cast<long long>(duration.count()));
+}
+
 Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
-  auto started_instance = started_modules_.find(module);
-  if (started_instance != started_modules_.end()) {
-    return started_instance->second;
+  if (IsStarted(module)) {
+    return Get(module);
   }
 
   LOG_INFO("Constructing next module");
   Module* instance = module->ctor_();
-  set_registry_and_handler(instance, thread);
+  set_registry_and_handler(instance, thread_for(module, thread));
 
   LOG_INFO("Starting dependencies of %s", instance->ToString().c_str());
   instance->ListDependencies(&instance->dependencies_);
-  Start(&instance->dependencies_, thread);
+  for (auto dependency : instance->dependencies_.list_) {
+    Start(dependency, thread);
+  }
 
   LOG_INFO("Finished starting dependencies and calling Start() of %s", instance->ToString().c_str());
 
   last_instance_ = "starting " + instance->ToString();
-  instance->Start();
-  start_order_.push_back(module);
-  started_modules_[module] = instance;
-  LOG_INFO("Started %s", instance->ToString().c_str());
+  auto start_time = std::chrono::steady_clock::now();
+  start_instance(instance);
+  record_started(
+      module,
+      instance,
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time));
   return instance;
 }
 
-void ModuleRegistry::StopAll() {
-  // Since modules were brought up in dependency order, it is safe to tear down by going in reverse order.
-  for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
-    auto instance = started_modules_.find(*it);
-    ASSERT(instance != started_modules_.end());
-    last_instance_ = "stopping " + instance->second->ToString();
+void ModuleRegistry::stop_instance(Module* instance) {
+  auto stop_time = std::chrono::steady_clock::now();
+
+  // Clear the handler before stopping the module to allow it to shut down gracefully.
+  LOG_INFO("Stopping Handler of Module %s", instance->ToString().c_str());
+  instance->handler_->Clear();
+  instance->handler_->WaitUntilStopped(kModuleStopTimeout);
+  LOG_INFO("Stopping Module %s", instance->ToString().c_str());
+  instance->Stop();
+
+  auto duration = std::chrono::steady_clock::now() - stop_time;
+  if (duration > kModuleStopBudget) {
+    LOG_WARN(
+        "%s took %lld ms to stop, over its budget of %lld ms",
+        instance->ToString().c_str(),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()),
+        static_cast<long long>(kModuleStopBudget.count()));
+  }
+}
 
-    // Clear the handler before stopping the module to allow it to shut down gracefully.
-    LOG_INFO("Stopping Handler of Module %s", instance->second->ToString().c_str());
-    instance->second->handler_->Clear();
-    instance->second->handler_->WaitUntilStopped(kModuleStopTimeout);
-    LOG_INFO("Stopping Module %s", instance->second->ToString().c_str());
-    instance->second->Stop();
+void ModuleRegistry::StopAll() {
+  auto stop_time = std::chrono::steady_clock::now();
+  if (parallel_start_) {
+    ModuleStopScheduler scheduler(this);
+    scheduler.Run();
+  } else {
+    // Since modules were brought up in dependency order, it is safe to tear down by going in reverse order.
+    for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
+      auto instance = started_modules_.find(*it);
+      ASSERT(instance != started_modules_.end());
+      last_instance_ = "stopping " + instance->second->ToString();
+      stop_instance(instance->second);
+    }
   }
+  LOG_INFO(
+      "Stopped %zu modules in %lld ms",
+      start_order_.size(),
+      static_cast<long long>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - stop_time).count()));
   for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
     auto instance = started_modules_.find(*it);
     ASSERT(instance != started_modules_.end());
@@ -124,6 +419,10 @@ void ModuleRegistry::StopAll() {
 
   ASSERT(started_modules_.empty());
   start_order_.clear();
+  start_records_.clear();
+  module_threads_.clear();
+  total_start_duration_ = std::chrono::microseconds(0);
+  parallel_start_ = false;
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
@@ -134,27 +433,59 @@ os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const
   return nullptr;
 }
 
-void ModuleDumper::DumpState(std::string* output) const {
-  ASSERT(output != nullptr);
-
-  flatbuffers::FlatBufferBuilder builder(1024);
-  auto title = builder.CreateString(title_);
+DumpsysDataFinisher ModuleDumper::GetDumperData(flatbuffers::FlatBufferBuilder* builder) const {
+  auto title = builder->CreateString(title_);
 
-  common::InitFlagsDataBuilder init_flags_builder(builder);
-  init_flags_builder.add_title(builder.CreateString("----- Init Flags -----"));
+  common::InitFlagsDataBuilder init_flags_builder(*builder);
+  init_flags_builder.add_title(builder->CreateString("----- Init Flags -----"));
   std::vector<flatbuffers::Offset<common::InitFlagValue>> flags;
   for (const auto& flag : common::init_flags::dump()) {
     flags.push_back(common::CreateInitFlagValue(
-        builder,
-        builder.CreateString(std::string(flag.flag)),
-        builder.CreateString(std::string(flag.value))));
+        *builder,
+        builder->CreateString(std::string(flag.flag)),
+        builder->CreateString(std::string(flag.value))));
   }
-  init_flags_builder.add_values(builder.CreateVector(flags));
+  init_flags_builder.add_values(builder->CreateVector(flags));
   auto init_flags_offset = init_flags_builder.Finish();
 
-  auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
+  auto wakelock_offset = WakelockManager::Get().GetDumpsysData(builder);
+
+  std::vector<flatbuffers::Offset<ModuleStartTime>> start_times;
+  bool parallel_start;
+  int64_t total_start_micros;
+  {
+    std::lock_guard<std::mutex> lock(module_registry_.mutex_);
+    for (const auto& record : module_registry_.start_records_) {
+      start_times.push_back(CreateModuleStartTime(
+          *builder, builder->CreateString(record.name), record.duration.count(), record.deferred));
+    }
+    parallel_start = module_registry_.parallel_start_;
+    total_start_micros = module_registry_.total_start_duration_.count();
+  }
+  auto start_times_offset = builder->CreateVector(start_times);
+  auto module_start_title = builder->CreateString("----- Module Start -----");
+  ModuleStartDataBuilder module_start_builder(*builder);
+  module_start_builder.add_title(module_start_title);
+  module_start_builder.add_parallel(parallel_start);
+  module_start_builder.add_total_start_micros(total_start_micros);
+  module_start_builder.add_modules(start_times_offset);
+  auto module_start_offset = module_start_builder.Finish();
+
+  return [title, init_flags_offset, wakelock_offset, module_start_offset](DumpsysDataBuilder* data_builder) {
+    data_builder->add_title(title);
+    data_builder->add_init_flags(init_flags_offset);
+    data_builder->add_wakelock_manager_data(wakelock_offset);
+    data_builder->add_module_start_data(module_start_offset);
+  };
+}
+
+void ModuleDumper::DumpState(std::string* output) const {
+  ASSERT(output != nullptr);
+
+  flatbuffers::FlatBufferBuilder builder(1024);
 
   std::queue<DumpsysDataFinisher> queue;
+  queue.push(GetDumperData(&builder));
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
     auto instance = module_registry_.started_modules_.find(*it);
     ASSERT(instance != module_registry_.started_modules_.end());
@@ -162,9 +493,6 @@ void ModuleDumper::DumpState(std::string* output) const {
   }
 
   DumpsysDataBuilder data_builder(builder);
-  data_builder.add_title(title);
-  data_builder.add_init_flags(init_flags_offset);
-  data_builder.add_wakelock_manager_data(wakelock_offset);
 
   while (!queue.empty()) {
     queue.front()(&data_builder);
@@ -175,4 +503,60 @@ void ModuleDumper::DumpState(std::string* output) const {
   *output = std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
 }
 
+std::string ModuleDumper::SnapshotModule(const Module* module) {
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto finisher = module->GetDumpsysData(&builder);
+  DumpsysDataBuilder data_builder(builder);
+  finisher(&data_builder);
+  builder.Finish(data_builder.Finish());
+  return std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+}
+
+void ModuleDumper::DumpStateIncrementally(
+    std::chrono::milliseconds budget, std::function<void(const ModuleDumpsysSnapshot&)> on_snapshot) const {
+  auto start = std::chrono::steady_clock::now();
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto finisher = GetDumperData(&builder);
+  DumpsysDataBuilder data_builder(builder);
+  finisher(&data_builder);
+  builder.Finish(data_builder.Finish());
+  on_snapshot({
+      title_,
+      std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize()),
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start),
+      false,
+  });
+
+  std::vector<const Module*> modules;
+  {
+    std::lock_guard<std::mutex> lock(module_registry_.mutex_);
+    for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
+      auto instance = module_registry_.started_modules_.find(*it);
+      ASSERT(instance != module_registry_.started_modules_.end());
+      modules.push_back(instance->second);
+    }
+  }
+
+  for (const auto* module : modules) {
+    // Shared with the posted task, which may still run after a timed out wait has moved on
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto future = promise->get_future();
+    start = std::chrono::steady_clock::now();
+    module->GetHandler()->Post(common::BindOnce(
+        [](const Module* module, std::shared_ptr<std::promise<std::string>> promise) {
+          promise->set_value(SnapshotModule(module));
+        },
+        module,
+        promise));
+
+    bool timed_out = future.wait_for(budget) != std::future_status::ready;
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    if (timed_out) {
+      LOG_WARN(
+          "Module %s did not provide its dumpsys data within %d ms", module->ToString().c_str(), (int)budget.count());
+    }
+    on_snapshot({module->ToString(), timed_out ? std::string() : future.get(), duration, timed_out});
+  }
+}
+
 }  // namespace bluetooth
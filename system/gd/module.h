@@ -21,11 +21,13 @@
 #include <functional>
 #include <future>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "common/bind.h"
+#include "common/callback.h"
 #include "dumpsys_data_generated.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -36,11 +38,14 @@ namespace bluetooth {
 class Module;
 class ModuleDumper;
 class ModuleRegistry;
+class ModuleStartScheduler;
+class ModuleStopScheduler;
 class TestModuleRegistry;
 class FuzzTestModuleRegistry;
 
 class ModuleFactory {
  friend ModuleRegistry;
+ friend ModuleStartScheduler;
  friend FuzzTestModuleRegistry;
 
 public:
@@ -53,6 +58,8 @@ private:
 class ModuleList {
  friend Module;
  friend ModuleRegistry;
+ friend ModuleStartScheduler;
+ friend ModuleStopScheduler;
 
 public:
  template <class T>
@@ -76,6 +83,8 @@ using DumpsysDataFinisher = std::function<void(DumpsysDataBuilder* dumpsys_data_
 class Module {
   friend ModuleDumper;
   friend ModuleRegistry;
+  friend ModuleStartScheduler;
+  friend ModuleStopScheduler;
   friend TestModuleRegistry;
 
  public:
@@ -91,6 +100,11 @@ class Module {
   // Release all resources, you're about to be deleted
   virtual void Stop() = 0;
 
+  // Call during Start() if starting completes asynchronously, e.g. after a round trip to the controller.
+  // The module is not considered started, and modules depending on it are not started, until the
+  // returned closure has been run. It may be run from any thread.
+  common::OnceClosure DeferStartCompletion();
+
   // Get relevant state data from the module
   virtual DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const;
 
@@ -121,11 +135,15 @@ class Module {
   ::bluetooth::os::Handler* handler_ = nullptr;
   ModuleList dependencies_;
   const ModuleRegistry* registry_;
+  common::OnceClosure start_completion_;
+  bool start_deferred_ = false;
 };
 
 class ModuleRegistry {
  friend Module;
  friend ModuleDumper;
+ friend ModuleStartScheduler;
+ friend ModuleStopScheduler;
  friend class StackManager;
  public:
   template <class T>
@@ -136,7 +154,8 @@ class ModuleRegistry {
   bool IsStarted(const ModuleFactory* factory) const;
 
   // Start all the modules on this list and their dependencies
-  // in dependency order
+  // in dependency order. With the gd_module_parallel_start init flag,
+  // modules whose dependencies have all started are started concurrently.
   void Start(ModuleList* modules, ::bluetooth::os::Thread* thread);
 
   template <class T>
@@ -146,7 +165,12 @@ class ModuleRegistry {
 
   Module* Start(const ModuleFactory* id, ::bluetooth::os::Thread* thread);
 
-  // Stop all running modules in reverse order of start
+  // Give |module| a handler on |thread| instead of the thread passed to Start(). Must be called before the module
+  // is started.
+  void SetModuleThread(const ModuleFactory* module, ::bluetooth::os::Thread* thread);
+
+  // Stop all running modules in reverse order of start. When the modules were started in parallel, modules whose
+  // dependents have all stopped are stopped concurrently.
   void StopAll();
 
  protected:
@@ -154,20 +178,62 @@ class ModuleRegistry {
 
   void set_registry_and_handler(Module* instance, ::bluetooth::os::Thread* thread) const;
 
+  // The thread set with SetModuleThread() for |module|, or |thread| if there is none
+  ::bluetooth::os::Thread* thread_for(const ModuleFactory* module, ::bluetooth::os::Thread* thread) const;
+
   os::Handler* GetModuleHandler(const ModuleFactory* module) const;
 
+  // Runs Start() of the instance, returns once it has completed, asynchronously or not
+  void start_instance(Module* instance);
+
+  void record_started(const ModuleFactory* module, Module* instance, std::chrono::microseconds duration);
+
+  // Drains the handler of the instance and runs its Stop(), reporting it when it takes longer than its budget
+  void stop_instance(Module* instance);
+
+  struct StartRecord {
+    std::string name;
+    std::chrono::microseconds duration;
+    bool deferred;
+  };
+
+  // Guards started_modules_, start_order_ and start_records_ while modules start in parallel
+  mutable std::mutex mutex_;
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
+  std::vector<StartRecord> start_records_;
+  std::map<const ModuleFactory*, ::bluetooth::os::Thread*> module_threads_;
+  std::chrono::microseconds total_start_duration_{0};
+  bool parallel_start_ = false;
   std::string last_instance_;
 };
 
+// The state of one module, taken on the module's own handler
+struct ModuleDumpsysSnapshot {
+  std::string name;
+  // A DumpsysData flatbuffer holding only this module's data, empty if the module did not answer in time
+  std::string data;
+  // From posting the snapshot to the module's handler until it was taken, or until the budget ran out
+  std::chrono::microseconds duration;
+  bool timed_out;
+};
+
 class ModuleDumper {
  public:
   ModuleDumper(const ModuleRegistry& module_registry, const char* title)
       : module_registry_(module_registry), title_(title) {}
   void DumpState(std::string* output) const;
 
+  // Takes the snapshots one module at a time, each on the module's own handler, and passes each one to |on_snapshot|
+  // as soon as it is ready. The first snapshot holds the dumper's own data. A module is waited for at most |budget|.
+  // Must not be called from a module handler, as the wait would block the modules sharing its thread.
+  void DumpStateIncrementally(
+      std::chrono::milliseconds budget, std::function<void(const ModuleDumpsysSnapshot&)> on_snapshot) const;
+
  private:
+  DumpsysDataFinisher GetDumperData(flatbuffers::FlatBufferBuilder* builder) const;
+  static std::string SnapshotModule(const Module* module);
+
   const ModuleRegistry& module_registry_;
   const std::string title_;
 };
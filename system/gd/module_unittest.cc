@@ -15,15 +15,20 @@
  */
 
 #include "module.h"
+#include "common/init_flags.h"
 #include "module_unittest_generated.h"
 #include "os/handler.h"
 #include "os/thread.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <future>
+#include <mutex>
 #include <string>
+#include <vector>
 
 using ::bluetooth::os::Thread;
 
@@ -46,6 +51,20 @@ class ModuleTest : public ::testing::Test {
   Thread* thread_;
 };
 
+// Names of the modules in the order their Stop() ran
+std::mutex stopped_modules_mutex;
+std::vector<std::string> stopped_modules;
+
+void record_stopped(const std::string& name) {
+  std::lock_guard<std::mutex> lock(stopped_modules_mutex);
+  stopped_modules.push_back(name);
+}
+
+size_t stop_position(const std::string& name) {
+  std::lock_guard<std::mutex> lock(stopped_modules_mutex);
+  return std::find(stopped_modules.begin(), stopped_modules.end(), name) - stopped_modules.begin();
+}
+
 os::Handler* test_module_no_dependency_handler = nullptr;
 
 class TestModuleNoDependency : public Module {
@@ -64,6 +83,7 @@ class TestModuleNoDependency : public Module {
   void Stop() override {
     // A module is not considered stopped until after Stop() finishes
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleNoDependency>());
+    record_stopped("TestModuleNoDependency");
   }
 
   std::string ToString() const override {
@@ -99,6 +119,7 @@ class TestModuleOneDependency : public Module {
 
     // A module is not considered stopped until after Stop() finishes
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleOneDependency>());
+    record_stopped("TestModuleOneDependency");
   }
 
   std::string ToString() const override {
@@ -126,6 +147,7 @@ class TestModuleNoDependencyTwo : public Module {
   void Stop() override {
     // A module is not considered stopped until after Stop() finishes
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleNoDependencyTwo>());
+    record_stopped("TestModuleNoDependencyTwo");
   }
 
   std::string ToString() const override {
@@ -161,6 +183,7 @@ class TestModuleTwoDependencies : public Module {
 
     // A module is not considered stopped until after Stop() finishes
     EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleTwoDependencies>());
+    record_stopped("TestModuleTwoDependencies");
   }
 
   std::string ToString() const override {
@@ -217,6 +240,57 @@ class TestModuleDumpState : public Module {
 
 const ModuleFactory TestModuleDumpState::Factory = ModuleFactory([]() { return new TestModuleDumpState(); });
 
+class TestModuleDeferredStart : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {}
+
+  void Start() override {
+    // Complete starting from the handler, as a module waiting for the controller would
+    GetHandler()->Post(DeferStartCompletion());
+    EXPECT_FALSE(GetModuleRegistry()->IsStarted<TestModuleDeferredStart>());
+  }
+
+  void Stop() override {
+    record_stopped("TestModuleDeferredStart");
+  }
+
+  std::string ToString() const override {
+    return std::string("TestModuleDeferredStart");
+  }
+};
+
+const ModuleFactory TestModuleDeferredStart::Factory = ModuleFactory([]() { return new TestModuleDeferredStart(); });
+
+class TestModuleDependsOnDeferredStart : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {
+    list->add<TestModuleDeferredStart>();
+    list->add<TestModuleTwoDependencies>();
+  }
+
+  void Start() override {
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleDeferredStart>());
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleTwoDependencies>());
+  }
+
+  void Stop() override {
+    record_stopped("TestModuleDependsOnDeferredStart");
+  }
+
+  std::string ToString() const override {
+    return std::string("TestModuleDependsOnDeferredStart");
+  }
+};
+
+const ModuleFactory TestModuleDependsOnDeferredStart::Factory =
+    ModuleFactory([]() { return new TestModuleDependsOnDeferredStart(); });
+
 TEST_F(ModuleTest, no_dependency) {
   ModuleList list;
   list.add<TestModuleNoDependency>();
@@ -314,5 +388,157 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleTest, dump_state_incrementally) {
+  static const char* title = "Test Dump Title";
+  ModuleList list;
+  list.add<TestModuleDumpState>();
+  registry_->Start(&list, thread_);
+
+  ModuleDumper dumper(*registry_, title);
+
+  std::vector<ModuleDumpsysSnapshot> snapshots;
+  dumper.DumpStateIncrementally(
+      std::chrono::seconds(1), [&snapshots](const ModuleDumpsysSnapshot& snapshot) { snapshots.push_back(snapshot); });
+
+  // The dumper's own data, then the modules in reverse start order
+  ASSERT_EQ(3u, snapshots.size());
+  EXPECT_EQ(title, snapshots[0].name);
+  EXPECT_STREQ(title, flatbuffers::GetRoot<DumpsysData>(snapshots[0].data.data())->title()->c_str());
+  EXPECT_EQ("TestModuleDumpState", snapshots[1].name);
+  EXPECT_FALSE(snapshots[1].timed_out);
+  auto data = flatbuffers::GetRoot<DumpsysData>(snapshots[1].data.data());
+  EXPECT_EQ(nullptr, data->title());
+  EXPECT_STREQ("Initial Test String", data->module_unittest_data()->title()->c_str());
+  EXPECT_EQ("TestModuleNoDependency", snapshots[2].name);
+  EXPECT_FALSE(snapshots[2].timed_out);
+
+  registry_->StopAll();
+}
+
+TEST_F(ModuleTest, dump_state_incrementally_with_busy_module) {
+  ModuleList list;
+  list.add<TestModuleDumpState>();
+  registry_->Start(&list, thread_);
+
+  std::promise<void> unblock;
+  auto unblocked = unblock.get_future().share();
+  test_module_no_dependency_handler->Post(
+      common::BindOnce([](std::shared_future<void> future) { future.wait(); }, unblocked));
+
+  ModuleDumper dumper(*registry_, "Test Dump Title");
+  std::vector<ModuleDumpsysSnapshot> snapshots;
+  dumper.DumpStateIncrementally(std::chrono::milliseconds(10), [&snapshots](const ModuleDumpsysSnapshot& snapshot) {
+    snapshots.push_back(snapshot);
+  });
+  unblock.set_value();
+
+  // Both modules share the blocked thread; each is given up on after its budget
+  ASSERT_EQ(3u, snapshots.size());
+  for (size_t i = 1; i < snapshots.size(); i++) {
+    EXPECT_TRUE(snapshots[i].timed_out);
+    EXPECT_TRUE(snapshots[i].data.empty());
+    EXPECT_GE(snapshots[i].duration, std::chrono::milliseconds(10));
+  }
+
+  registry_->StopAll();
+}
+
+TEST_F(ModuleTest, deferred_start) {
+  ModuleList list;
+  list.add<TestModuleDependsOnDeferredStart>();
+  registry_->Start(&list, thread_);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleDeferredStart>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleDependsOnDeferredStart>());
+
+  registry_->StopAll();
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleDeferredStart>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleDependsOnDeferredStart>());
+}
+
+TEST_F(ModuleTest, module_on_own_thread) {
+  Thread data_thread("data_thread", Thread::Priority::NORMAL);
+  registry_->SetModuleThread(&TestModuleNoDependency::Factory, &data_thread);
+
+  ModuleList list;
+  list.add<TestModuleOneDependency>();
+  registry_->Start(&list, thread_);
+
+  std::promise<bool> on_data_thread;
+  auto on_data_thread_future = on_data_thread.get_future();
+  test_module_no_dependency_handler->Post(common::BindOnce(
+      [](Thread* thread, std::promise<bool> promise) { promise.set_value(thread->IsSameThread()); },
+      &data_thread,
+      std::move(on_data_thread)));
+  EXPECT_TRUE(on_data_thread_future.get());
+
+  std::promise<bool> on_stack_thread;
+  auto on_stack_thread_future = on_stack_thread.get_future();
+  test_module_one_dependency_handler->Post(common::BindOnce(
+      [](Thread* thread, std::promise<bool> promise) { promise.set_value(thread->IsSameThread()); },
+      thread_,
+      std::move(on_stack_thread)));
+  EXPECT_TRUE(on_stack_thread_future.get());
+
+  registry_->StopAll();
+}
+
+TEST_F(ModuleTest, parallel_start) {
+  const char* flags[] = {"INIT_gd_module_parallel_start=true", nullptr};
+  common::InitFlags::Load(flags);
+
+  ModuleList list;
+  list.add<TestModuleDependsOnDeferredStart>();
+  registry_->Start(&list, thread_);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleDeferredStart>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleDependsOnDeferredStart>());
+
+  ModuleDumper dumper(*registry_, "Test Dump Title");
+  std::string output;
+  dumper.DumpState(&output);
+
+  auto start_data = flatbuffers::GetRoot<DumpsysData>(output.data())->module_start_data();
+  EXPECT_TRUE(start_data->parallel());
+  ASSERT_EQ(6u, start_data->modules()->size());
+  EXPECT_STREQ("TestModuleDependsOnDeferredStart", start_data->modules()->Get(5)->name()->c_str());
+
+  registry_->StopAll();
+  common::InitFlags::Load(nullptr);
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleDependsOnDeferredStart>());
+}
+
+TEST_F(ModuleTest, parallel_stop) {
+  const char* flags[] = {"INIT_gd_module_parallel_start=true", nullptr};
+  common::InitFlags::Load(flags);
+
+  ModuleList list;
+  list.add<TestModuleDependsOnDeferredStart>();
+  registry_->Start(&list, thread_);
+  {
+    std::lock_guard<std::mutex> lock(stopped_modules_mutex);
+    stopped_modules.clear();
+  }
+
+  registry_->StopAll();
+  common::InitFlags::Load(nullptr);
+
+  // Every module stops before its dependencies
+  ASSERT_EQ(6u, stopped_modules.size());
+  EXPECT_LT(stop_position("TestModuleDependsOnDeferredStart"), stop_position("TestModuleDeferredStart"));
+  EXPECT_LT(stop_position("TestModuleDependsOnDeferredStart"), stop_position("TestModuleTwoDependencies"));
+  EXPECT_LT(stop_position("TestModuleTwoDependencies"), stop_position("TestModuleOneDependency"));
+  EXPECT_LT(stop_position("TestModuleTwoDependencies"), stop_position("TestModuleNoDependencyTwo"));
+  EXPECT_LT(stop_position("TestModuleOneDependency"), stop_position("TestModuleNoDependency"));
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+}
+
 }  // namespace
 }  // namespace bluetooth
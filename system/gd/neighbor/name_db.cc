@@ -17,7 +17,12 @@
 
 #include "neighbor/name_db.h"
 
+#include <algorithm>
+#include <deque>
+#include <list>
 #include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -27,6 +32,7 @@
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "storage/storage_module.h"
 
 namespace bluetooth {
 namespace neighbor {
@@ -36,11 +42,16 @@ struct PendingRemoteNameRead {
   ReadRemoteNameDbCallback callback_;
   os::Handler* handler_;
 };
+
+std::string RemoteNameToString(const RemoteName& name) {
+  return std::string(name.begin(), std::find(name.begin(), name.end(), 0));
+}
 }  // namespace
 
 struct NameDbModule::impl {
   void ReadRemoteNameRequest(
-      hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler);
+      hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler, RemoteNamePriority priority);
+  void CacheNameFromExtendedInquiryResponse(hci::Address address, std::vector<hci::GapData> eir);
 
   bool IsNameCached(hci::Address address) const;
   RemoteName ReadCachedRemoteName(hci::Address address) const;
@@ -52,11 +63,19 @@ struct NameDbModule::impl {
 
  private:
   std::unordered_map<hci::Address, std::list<PendingRemoteNameRead>> address_to_pending_read_map_;
-  std::unordered_map<hci::Address, RemoteName> address_to_name_map_;
-
+  // Addresses with a pending read that were not handed to the controller yet
+  std::deque<hci::Address> high_priority_queue_;
+  std::deque<hci::Address> low_priority_queue_;
+  size_t outstanding_requests_ = 0;
+
+  std::optional<std::string> GetFreshName(hci::Address address) const;
+  void StoreName(hci::Address address, const std::string& name);
+  void SendNextRemoteNameRequests();
+  void OnRemoteNameRequestStatus(hci::Address address, hci::ErrorCode status);
   void OnRemoteNameResponse(hci::Address address, hci::ErrorCode status, RemoteName name);
 
   hci::RemoteNameRequestModule* name_module_;
+  storage::StorageModule* storage_module_;
 
   const NameDbModule& module_;
   os::Handler* handler_;
@@ -68,10 +87,20 @@ const ModuleFactory neighbor::NameDbModule::Factory =
 neighbor::NameDbModule::impl::impl(const neighbor::NameDbModule& module) : module_(module) {}
 
 void neighbor::NameDbModule::impl::ReadRemoteNameRequest(
-    hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler) {
+    hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler, RemoteNamePriority priority) {
+  if (GetFreshName(address)) {
+    handler->Call(std::move(callback), address, true);
+    return;
+  }
+
   if (address_to_pending_read_map_.find(address) != address_to_pending_read_map_.end()) {
     LOG_WARN("Already have remote read db in progress; adding callback to callback list");
     address_to_pending_read_map_[address].push_back({std::move(callback), handler});
+    auto queued = std::find(low_priority_queue_.begin(), low_priority_queue_.end(), address);
+    if (priority == RemoteNamePriority::HIGH && queued != low_priority_queue_.end()) {
+      low_priority_queue_.erase(queued);
+      high_priority_queue_.push_back(address);
+    }
     return;
   }
 
@@ -79,45 +108,105 @@ void neighbor::NameDbModule::impl::ReadRemoteNameRequest(
   address_to_pending_read_map_[address] = std::move(tmp);
   address_to_pending_read_map_[address].push_back({std::move(callback), handler});
 
-  // TODO(cmanton) Use remote name request defaults for now
-  hci::PageScanRepetitionMode page_scan_repetition_mode = hci::PageScanRepetitionMode::R1;
-  uint16_t clock_offset = 0;
-  hci::ClockOffsetValid clock_offset_valid = hci::ClockOffsetValid::INVALID;
-  name_module_->StartRemoteNameRequest(
-      address,
-      hci::RemoteNameRequestBuilder::Create(
-          address, page_scan_repetition_mode, clock_offset, clock_offset_valid),
-      handler_->BindOnce(
-          [](neighbor::NameDbModule::impl* self, hci::Address address, hci::ErrorCode status) {
-            self->OnRemoteNameResponse(address, status, {});
-          },
-          common::Unretained(this),
-          address),
-      handler_->BindOnce(
-          [&](uint64_t features) { LOG_WARN("UNIMPLEMENTED: ignoring host supported features"); }),
-      handler_->BindOnceOn(this, &NameDbModule::impl::OnRemoteNameResponse, address));
+  if (priority == RemoteNamePriority::HIGH) {
+    high_priority_queue_.push_back(address);
+  } else {
+    low_priority_queue_.push_back(address);
+  }
+  SendNextRemoteNameRequests();
+}
+
+void neighbor::NameDbModule::impl::SendNextRemoteNameRequests() {
+  while (outstanding_requests_ < kMaxOutstandingRemoteNameRequests &&
+         !(high_priority_queue_.empty() && low_priority_queue_.empty())) {
+    auto& queue = high_priority_queue_.empty() ? low_priority_queue_ : high_priority_queue_;
+    hci::Address address = queue.front();
+    queue.pop_front();
+    outstanding_requests_++;
+
+    // TODO(cmanton) Use remote name request defaults for now
+    hci::PageScanRepetitionMode page_scan_repetition_mode = hci::PageScanRepetitionMode::R1;
+    uint16_t clock_offset = 0;
+    hci::ClockOffsetValid clock_offset_valid = hci::ClockOffsetValid::INVALID;
+    name_module_->StartRemoteNameRequest(
+        address,
+        hci::RemoteNameRequestBuilder::Create(address, page_scan_repetition_mode, clock_offset, clock_offset_valid),
+        handler_->BindOnceOn(this, &NameDbModule::impl::OnRemoteNameRequestStatus, address),
+        handler_->BindOnce(
+            [&](uint64_t features) { LOG_WARN("UNIMPLEMENTED: ignoring host supported features"); }),
+        handler_->BindOnceOn(this, &NameDbModule::impl::OnRemoteNameResponse, address));
+  }
+}
+
+void neighbor::NameDbModule::impl::OnRemoteNameRequestStatus(hci::Address address, hci::ErrorCode status) {
+  // On success the name follows in the Remote Name Request Complete event
+  if (status != hci::ErrorCode::SUCCESS) {
+    OnRemoteNameResponse(address, status, {});
+  }
 }
 
 void neighbor::NameDbModule::impl::OnRemoteNameResponse(
     hci::Address address, hci::ErrorCode status, RemoteName name) {
   ASSERT(address_to_pending_read_map_.find(address) != address_to_pending_read_map_.end());
+  ASSERT(outstanding_requests_ > 0);
+  outstanding_requests_--;
   if (status == hci::ErrorCode::SUCCESS) {
-    address_to_name_map_[address] = name;
+    StoreName(address, RemoteNameToString(name));
   }
   auto& callback_list = address_to_pending_read_map_.at(address);
   for (auto& it : callback_list) {
     it.handler_->Call(std::move(it.callback_), address, status == hci::ErrorCode::SUCCESS);
   }
   address_to_pending_read_map_.erase(address);
+  SendNextRemoteNameRequests();
+}
+
+void neighbor::NameDbModule::impl::CacheNameFromExtendedInquiryResponse(
+    hci::Address address, std::vector<hci::GapData> eir) {
+  for (const auto& gap_data : eir) {
+    if (gap_data.data_type_ != hci::GapDataType::COMPLETE_LOCAL_NAME) {
+      continue;
+    }
+    std::string name(gap_data.data_.begin(), std::find(gap_data.data_.begin(), gap_data.data_.end(), 0));
+    if (GetFreshName(address) != name) {
+      StoreName(address, name);
+    }
+    return;
+  }
+}
+
+std::optional<std::string> neighbor::NameDbModule::impl::GetFreshName(hci::Address address) const {
+  auto device = storage_module_->GetDeviceByClassicMacAddress(address);
+  auto name = device.GetName();
+  auto timestamp = device.GetNameUnixTimestamp();
+  if (!name || !timestamp) {
+    return std::nullopt;
+  }
+  auto age = std::chrono::system_clock::now() - std::chrono::system_clock::from_time_t(*timestamp);
+  if (age > kRemoteNameCacheTtl) {
+    return std::nullopt;
+  }
+  return name;
+}
+
+void neighbor::NameDbModule::impl::StoreName(hci::Address address, const std::string& name) {
+  auto device = storage_module_->GetDeviceByClassicMacAddress(address);
+  auto mutation = storage_module_->Modify();
+  mutation.Add(device.SetName(name));
+  mutation.Add(device.SetNameUnixTimestamp(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())));
+  mutation.Commit();
 }
 
 bool neighbor::NameDbModule::impl::IsNameCached(hci::Address address) const {
-  return address_to_name_map_.count(address) == 1;
+  return GetFreshName(address).has_value();
 }
 
 RemoteName neighbor::NameDbModule::impl::ReadCachedRemoteName(hci::Address address) const {
-  ASSERT(IsNameCached(address));
-  return address_to_name_map_.at(address);
+  auto name = GetFreshName(address);
+  ASSERT(name.has_value());
+  RemoteName remote_name = {};
+  std::copy_n(name->begin(), std::min(name->size(), remote_name.size() - 1), remote_name.begin());
+  return remote_name;
 }
 
 /**
@@ -130,13 +219,20 @@ neighbor::NameDbModule::~NameDbModule() {
 }
 
 void neighbor::NameDbModule::ReadRemoteNameRequest(
-    hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler) {
+    hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler, RemoteNamePriority priority) {
   GetHandler()->Post(common::BindOnce(
       &NameDbModule::impl::ReadRemoteNameRequest,
       common::Unretained(pimpl_.get()),
       address,
       std::move(callback),
-      handler));
+      handler,
+      priority));
+}
+
+void neighbor::NameDbModule::CacheNameFromExtendedInquiryResponse(
+    hci::Address address, const std::vector<hci::GapData>& eir) {
+  GetHandler()->Post(common::BindOnce(
+      &NameDbModule::impl::CacheNameFromExtendedInquiryResponse, common::Unretained(pimpl_.get()), address, eir));
 }
 
 bool neighbor::NameDbModule::IsNameCached(hci::Address address) const {
@@ -149,6 +245,7 @@ RemoteName neighbor::NameDbModule::ReadCachedRemoteName(hci::Address address) co
 
 void neighbor::NameDbModule::impl::Start() {
   name_module_ = module_.GetDependency<hci::RemoteNameRequestModule>();
+  storage_module_ = module_.GetDependency<storage::StorageModule>();
   handler_ = module_.GetHandler();
 }
 
@@ -159,6 +256,7 @@ void neighbor::NameDbModule::impl::Stop() {}
  */
 void neighbor::NameDbModule::ListDependencies(ModuleList* list) const {
   list->add<hci::RemoteNameRequestModule>();
+  list->add<storage::StorageModule>();
 }
 
 void neighbor::NameDbModule::Start() {
@@ -16,8 +16,10 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "common/bind.h"
 #include "hci/address.h"
@@ -30,13 +32,27 @@ namespace neighbor {
 using RemoteName = std::array<uint8_t, 248>;
 using ReadRemoteNameDbCallback = common::OnceCallback<void(hci::Address address, bool success)>;
 
+// Requests that block a connection or pairing go ahead of the ones issued while discovering
+enum class RemoteNamePriority { HIGH, LOW };
+
+// Names are kept in the StorageModule and are only requested again over the air once they are older than this
+constexpr std::chrono::hours kRemoteNameCacheTtl = std::chrono::hours(24 * 7);
+
 class NameDbModule : public bluetooth::Module {
  public:
-  virtual void ReadRemoteNameRequest(hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler);
+  // Completes right away if a fresh name is cached, otherwise queues a Remote Name Request. Requests to the same
+  // address are merged and at most kMaxOutstandingRemoteNameRequests are handed to the controller at a time.
+  virtual void ReadRemoteNameRequest(
+      hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler, RemoteNamePriority priority);
+
+  // Fills the cache with the complete local name of an Extended Inquiry Response, if it carries one
+  void CacheNameFromExtendedInquiryResponse(hci::Address address, const std::vector<hci::GapData>& eir);
 
   bool IsNameCached(hci::Address address) const;
   RemoteName ReadCachedRemoteName(hci::Address address) const;
 
+  static constexpr size_t kMaxOutstandingRemoteNameRequests = 1;
+
   static const ModuleFactory Factory;
 
   NameDbModule();
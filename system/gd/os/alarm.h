@@ -16,11 +16,11 @@
 
 #pragma once
 
-#include <functional>
+#include <chrono>
 #include <memory>
-#include <mutex>
 
 #include "common/callback.h"
+#include "os/alarm_scheduler.h"
 #include "os/handler.h"
 #include "os/thread.h"
 #include "os/utils.h"
@@ -28,9 +28,8 @@
 namespace bluetooth {
 namespace os {
 
-// A single-shot alarm for reactor-based thread, implemented by Linux timerfd.
-// When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+// A single-shot alarm for reactor-based thread. The alarms of a thread share a timer wheel behind a single Linux
+// timerfd, see AlarmScheduler.
 class Alarm {
  public:
   // Create and register a single-shot alarm on a given handler
@@ -42,19 +41,19 @@ class Alarm {
   // Unregister this alarm from the thread and release resource
   ~Alarm();
 
-  // Schedule the alarm with given delay
-  void Schedule(common::OnceClosure task, std::chrono::milliseconds delay);
+  // Schedule the alarm with given delay. With a |slack|, the alarm may fire up to that much later so that it shares a
+  // wakeup with other alarms of the thread.
+  void Schedule(
+      common::OnceClosure task,
+      std::chrono::milliseconds delay,
+      std::chrono::milliseconds slack = std::chrono::milliseconds::zero());
 
   // Cancel the alarm. No-op if it's not armed.
   void Cancel();
 
  private:
-  common::OnceClosure task_;
-  Handler* handler_;
-  int fd_ = 0;
-  Reactor::Reactable* token_;
-  mutable std::mutex mutex_;
-  void on_fire();
+  std::shared_ptr<AlarmScheduler> scheduler_;
+  AlarmScheduler::Timer timer_;
 };
 
 }  // namespace os
@@ -16,17 +16,21 @@
 
 #include <chrono>
 #include <future>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
 #include "os/alarm.h"
+#include "os/alarm_scheduler.h"
 #include "os/repeating_alarm.h"
 #include "os/thread.h"
 
 using ::benchmark::State;
 using ::bluetooth::common::Bind;
 using ::bluetooth::os::Alarm;
+using ::bluetooth::os::AlarmScheduler;
 using ::bluetooth::os::Handler;
 using ::bluetooth::os::RepeatingAlarm;
 using ::bluetooth::os::Thread;
@@ -71,6 +75,21 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
     promise_.set_value();
   }
 
+  void CountFire() {
+    task_counter_++;
+    if (task_counter_ >= scheduled_tasks_) {
+      promise_.set_value();
+    }
+  }
+
+  std::vector<std::unique_ptr<Alarm>> NewAlarms(int count) {
+    std::vector<std::unique_ptr<Alarm>> alarms;
+    for (int i = 0; i < count; i++) {
+      alarms.push_back(std::make_unique<Alarm>(handler_.get()));
+    }
+    return alarms;
+  }
+
   int64_t scheduled_tasks_;
   int64_t task_length_;
   int64_t task_interval_;
@@ -140,3 +159,48 @@ BENCHMARK_REGISTER_F(BM_ReactableAlarm, periodic_accuracy)
     ->Args({2000, 15, 20})
     ->Iterations(1)
     ->UseRealTime();
+
+// Per connection timers: many armed alarms on one thread, rescheduled and cancelled far ahead of their deadline
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, schedule_cancel_many)(State& state) {
+  auto alarms = NewAlarms(state.range(0));
+  for (auto _ : state) {
+    for (size_t i = 0; i < alarms.size(); i++) {
+      alarms[i]->Schedule(bluetooth::common::BindOnce([] {}), std::chrono::milliseconds(1000 + i * 37 % 60000));
+    }
+    for (auto& alarm : alarms) {
+      alarm->Cancel();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * alarms.size());
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, schedule_cancel_many)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+// Timerfd wakeups needed to run alarms spread over 200 ms, with and without slack to coalesce them
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, wakeups_with_slack)(State& state) {
+  auto alarms = NewAlarms(state.range(0));
+  auto slack = std::chrono::milliseconds(state.range(1));
+  auto scheduler = AlarmScheduler::Get(thread_.get());
+  for (auto _ : state) {
+    scheduled_tasks_ = alarms.size();
+    task_counter_ = 0;
+    promise_ = std::promise<void>();
+    uint64_t wakeups = scheduler->GetWakeupCount();
+    for (size_t i = 0; i < alarms.size(); i++) {
+      alarms[i]->Schedule(
+          bluetooth::common::BindOnce(
+              &BM_ReactableAlarm_wakeups_with_slack_Benchmark::CountFire, bluetooth::common::Unretained(this)),
+          std::chrono::milliseconds(5 + i * 7 % 200),
+          slack);
+    }
+    promise_.get_future().get();
+    state.counters["wakeups"] = scheduler->GetWakeupCount() - wakeups;
+  }
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, wakeups_with_slack)
+    ->Args({100, 0})
+    ->Args({100, 16})
+    ->Args({100, 64})
+    ->Iterations(1)
+    ->UseRealTime();
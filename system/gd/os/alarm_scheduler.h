@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "common/callback.h"
+#include "common/timer_wheel.h"
+#include "os/reactor.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace os {
+
+// Keeps the alarms of a thread in a timer wheel behind a single timerfd, instead of a timerfd per alarm. Shared by the
+// Alarm and RepeatingAlarm instances of a thread and released with the last of them.
+class AlarmScheduler : public std::enable_shared_from_this<AlarmScheduler> {
+ public:
+  class Timer : public common::TimerWheel::Entry {
+   private:
+    friend class AlarmScheduler;
+    common::OnceClosure task_;
+    common::Closure repeating_task_;
+    uint64_t period_ms_ = 0;
+  };
+
+  // The scheduler of |thread|, created on first use
+  static std::shared_ptr<AlarmScheduler> Get(Thread* thread);
+
+  explicit AlarmScheduler(Thread* thread);
+  AlarmScheduler(const AlarmScheduler&) = delete;
+  AlarmScheduler& operator=(const AlarmScheduler&) = delete;
+  ~AlarmScheduler();
+
+  // Run |task| once after |delay|. With a |slack|, the deadline may be pushed back by up to that much so that it
+  // expires together with other timers.
+  void Schedule(Timer* timer, common::OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack);
+
+  // Run |task| every |period| until cancelled. Periods missed while the thread was busy are run back to back.
+  void ScheduleRepeating(Timer* timer, common::Closure task, std::chrono::milliseconds period);
+
+  // No-op if |timer| is not armed. Once this returns, a task of |timer| that has not started yet won't run.
+  void Cancel(Timer* timer);
+
+  // Number of wakeups of the timerfd, for benchmarks
+  uint64_t GetWakeupCount() const;
+
+ private:
+  void on_fire();
+  void cancel_locked(Timer* timer);
+  void rearm_locked();
+
+  Thread* thread_;
+  int fd_;
+  Reactor::Reactable* token_;
+  mutable std::mutex mutex_;
+  common::TimerWheel wheel_;
+  // Expired timers whose task has not run yet
+  std::deque<Timer*> fired_;
+  uint64_t armed_deadline_ms_ = UINT64_MAX;
+  uint64_t wakeup_count_ = 0;
+};
+
+}  // namespace os
+}  // namespace bluetooth
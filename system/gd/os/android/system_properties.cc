@@ -17,6 +17,7 @@
 #include "os/system_properties.h"
 
 #include <cutils/properties.h>
+#include <sys/system_properties.h>
 
 #include <array>
 #include <cctype>
@@ -49,6 +50,10 @@ bool SetSystemProperty(const std::string& property, const std::string& value) {
   return true;
 }
 
+uint32_t GetSystemPropertiesSerial() {
+  return __system_property_area_serial();
+}
+
 bool IsRootCanalEnabled() {
   auto value = GetSystemProperty("ro.vendor.build.fingerprint");
   if (value.has_value()) {
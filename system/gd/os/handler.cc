@@ -16,6 +16,8 @@
 
 #include "os/handler.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstring>
 
 #include "common/bind.h"
@@ -26,12 +28,21 @@
 
 namespace bluetooth {
 namespace os {
+using common::InlineClosure;
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
+// REAL_TIME closures that may run in a row while NORMAL closures are waiting
+static constexpr int kMaxRealTimeTasksInARow = 8;
+
+Handler::Handler(Thread* thread) : Handler(thread, WakeupMode::PER_TASK) {}
+
+Handler::Handler(Thread* thread, WakeupMode wakeup_mode)
+    : tasks_(new TaskLanes()), thread_(thread), wakeup_mode_(wakeup_mode) {
   event_ = thread_->GetReactor()->NewEvent();
-  reactable_ = thread_->GetReactor()->Register(
-      event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
+  auto on_read_ready = wakeup_mode_ == WakeupMode::COALESCED
+                           ? common::Bind(&Handler::handle_coalesced_events, common::Unretained(this))
+                           : common::Bind(&Handler::handle_next_event, common::Unretained(this));
+  reactable_ = thread_->GetReactor()->Register(event_->Id(), std::move(on_read_ready), common::Closure());
 }
 
 Handler::~Handler() {
@@ -43,24 +54,60 @@ Handler::~Handler() {
 }
 
 void Handler::Post(OnceClosure closure) {
+  Post(Priority::NORMAL, std::move(closure));
+}
+
+void Handler::Post(InlineClosure closure) {
+  Post(Priority::NORMAL, std::move(closure));
+}
+
+void Handler::Post(Priority priority, OnceClosure closure) {
+  Post(priority, InlineClosure([closure = std::move(closure)]() mutable { std::move(closure).Run(); }));
+}
+
+void Handler::Post(Priority priority, InlineClosure closure) {
+  std::chrono::steady_clock::time_point posted;
+  if (common::IsTaskStatsEnabled()) {
+    posted = std::chrono::steady_clock::now();
+  }
   {
     std::lock_guard<std::mutex> lock(mutex_);
     if (was_cleared()) {
       LOG_WARN("Posting to a handler which has been cleared");
       return;
     }
-    tasks_->emplace(std::move(closure));
+    if (priority == Priority::REAL_TIME) {
+      tasks_->real_time.push({std::move(closure), posted});
+      max_real_time_depth_ = std::max(max_real_time_depth_, tasks_->real_time.size());
+    } else {
+      tasks_->normal.push({std::move(closure), posted});
+      max_normal_depth_ = std::max(max_normal_depth_, tasks_->normal.size());
+    }
+  }
+  if (posted != std::chrono::steady_clock::time_point()) {
+    thread_->GetTaskStats().OnPosted();
+  }
+  if (wakeup_mode_ == WakeupMode::COALESCED && is_signalled_.exchange(true, std::memory_order_acq_rel)) {
+    // A wakeup is already pending and will pick this closure up
+    return;
   }
   event_->Notify();
 }
 
 void Handler::Clear() {
-  std::queue<OnceClosure>* tmp = nullptr;
+  TaskLanes* tmp = nullptr;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     ASSERT_LOG(!was_cleared(), "Handlers must only be cleared once");
     std::swap(tasks_, tmp);
   }
+  int64_t dropped = 0;
+  for (auto* lane : {&tmp->normal, &tmp->real_time}) {
+    for (; !lane->empty(); lane->pop()) {
+      dropped += lane->front().posted != std::chrono::steady_clock::time_point() ? 1 : 0;
+    }
+  }
+  thread_->GetTaskStats().OnDropped(dropped);
   delete tmp;
 
   event_->Clear();
@@ -74,8 +121,47 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   ASSERT(thread_->GetReactor()->WaitForUnregisteredReactable(timeout));
 }
 
+size_t Handler::GetQueueDepth(Priority priority) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (was_cleared()) {
+    return 0;
+  }
+  return priority == Priority::REAL_TIME ? tasks_->real_time.size() : tasks_->normal.size();
+}
+
+size_t Handler::GetMaxQueueDepth(Priority priority) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return priority == Priority::REAL_TIME ? max_real_time_depth_ : max_normal_depth_;
+}
+
+Handler::Task Handler::pop_next_task() {
+  bool run_real_time = !tasks_->real_time.empty() &&
+                       (tasks_->normal.empty() || tasks_->real_time_in_a_row < kMaxRealTimeTasksInARow);
+  auto& lane = run_real_time ? tasks_->real_time : tasks_->normal;
+  tasks_->real_time_in_a_row = run_real_time ? tasks_->real_time_in_a_row + 1 : 0;
+  Task task = std::move(lane.front());
+  lane.pop();
+  return task;
+}
+
+void Handler::run_task(Task task) {
+  if (task.posted == std::chrono::steady_clock::time_point()) {
+    std::move(task.closure).Run();
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::move(task.closure).Run();
+  auto end = std::chrono::steady_clock::now();
+  // Handlers do not know where their closures were posted from, so only the thread totals are kept
+  auto run = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+  if (thread_->GetTaskStats().OnRun(
+          nullptr, 0, nullptr, std::chrono::duration_cast<std::chrono::microseconds>(start - task.posted), run)) {
+    LOG_WARN("A task ran for %" PRId64 "us on %s", static_cast<int64_t>(run.count()), thread_->GetThreadName().c_str());
+  }
+}
+
 void Handler::handle_next_event() {
-  common::OnceClosure closure;
+  Task task;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     bool has_data = event_->Read();
@@ -85,10 +171,42 @@ void Handler::handle_next_event() {
     }
     ASSERT_LOG(has_data, "Notified for work but no work available");
 
-    closure = std::move(tasks_->front());
-    tasks_->pop();
+    task = pop_next_task();
+  }
+  wakeup_count_.fetch_add(1, std::memory_order_relaxed);
+  task_count_.fetch_add(1, std::memory_order_relaxed);
+  run_task(std::move(task));
+}
+
+void Handler::handle_coalesced_events() {
+  size_t pending = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_->Read();
+    // Lower the flag before looking at the queue, so a closure posted after this point signals a new wakeup
+    is_signalled_.store(false, std::memory_order_release);
+
+    if (was_cleared()) {
+      return;
+    }
+    // A post racing with the previous drain may leave a wakeup with nothing left to run
+    pending = tasks_->size();
+  }
+  wakeup_count_.fetch_add(1, std::memory_order_relaxed);
+
+  // Only run what was queued when this wakeup started, later posts get their own wakeup
+  for (; pending > 0; pending--) {
+    Task task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (was_cleared() || tasks_->size() == 0) {
+        return;
+      }
+      task = pop_next_task();
+    }
+    task_count_.fetch_add(1, std::memory_order_relaxed);
+    run_task(std::move(task));
   }
-  std::move(closure).Run();
 }
 
 }  // namespace os
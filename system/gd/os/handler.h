@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -24,6 +27,7 @@
 #include "common/bind.h"
 #include "common/callback.h"
 #include "common/contextual_callback.h"
+#include "common/inline_closure.h"
 #include "os/thread.h"
 #include "os/utils.h"
 
@@ -35,8 +39,25 @@ namespace os {
 // from the thread.
 class Handler : public common::IPostableContext {
  public:
+  enum class WakeupMode {
+    // Every posted closure signals the event and each wakeup runs a single closure.
+    PER_TASK,
+    // Posts only signal the event when no wakeup is pending, and each wakeup runs every closure that was queued
+    // when it started. Closures posted while draining trigger a new wakeup so other reactables are not starved.
+    COALESCED,
+  };
+
+  // Closures posted with REAL_TIME priority run before the NORMAL ones already queued, for data path work such as ACL
+  // credits that must not wait behind a backlog of control work. A NORMAL closure still runs after a bounded number of
+  // REAL_TIME ones, so that a busy data path does not starve the control path.
+  enum class Priority {
+    NORMAL,
+    REAL_TIME,
+  };
+
   // Create and register a handler on given thread
   explicit Handler(Thread* thread);
+  Handler(Thread* thread, WakeupMode wakeup_mode);
 
   Handler(const Handler&) = delete;
   Handler& operator=(const Handler&) = delete;
@@ -47,12 +68,32 @@ class Handler : public common::IPostableContext {
   // Enqueue a closure to the queue of this handler
   virtual void Post(common::OnceClosure closure) override;
 
+  // Enqueue a task without allocating a BindState, for paths that post once per packet
+  void Post(common::InlineClosure closure);
+
+  void Post(Priority priority, common::OnceClosure closure);
+  void Post(Priority priority, common::InlineClosure closure);
+
   // Remove all pending events from the queue of this handler
   void Clear();
 
   // Die if the current reactable doesn't stop before the timeout.  Must be called after Clear()
   void WaitUntilStopped(std::chrono::milliseconds timeout);
 
+  // Number of times the reactor woke this handler up
+  uint64_t GetWakeupCount() const {
+    return wakeup_count_.load(std::memory_order_relaxed);
+  }
+
+  // Number of closures run by this handler
+  uint64_t GetTaskCount() const {
+    return task_count_.load(std::memory_order_relaxed);
+  }
+
+  // Number of closures of the given priority waiting to run, and the most there ever were
+  size_t GetQueueDepth(Priority priority) const;
+  size_t GetMaxQueueDepth(Priority priority) const;
+
   template <typename Functor, typename... Args>
   void Call(Functor&& functor, Args&&... args) {
     Post(common::BindOnce(std::forward<Functor>(functor), std::forward<Args>(args)...));
@@ -63,6 +104,13 @@ class Handler : public common::IPostableContext {
     Post(common::BindOnce(std::forward<Functor>(functor), common::Unretained(obj), std::forward<Args>(args)...));
   }
 
+  template <typename T, typename Functor, typename... Args>
+  void CallOn(Priority priority, T* obj, Functor&& functor, Args&&... args) {
+    Post(
+        priority,
+        common::BindOnce(std::forward<Functor>(functor), common::Unretained(obj), std::forward<Args>(args)...));
+  }
+
   template <typename Functor, typename... Args>
   common::ContextualOnceCallback<common::MakeUnboundRunType<Functor, Args...>> BindOnce(
       Functor&& functor, Args&&... args) {
@@ -90,23 +138,75 @@ class Handler : public common::IPostableContext {
         common::Bind(std::forward<Functor>(functor), common::Unretained(obj), std::forward<Args>(args)...), this);
   }
 
+  // Callback posted with the given priority when invoked
+  template <typename Functor, typename T, typename... Args>
+  common::ContextualCallback<common::MakeUnboundRunType<Functor, T, Args...>> BindOn(
+      Priority priority, T* obj, Functor&& functor, Args&&... args) {
+    return common::ContextualCallback<common::MakeUnboundRunType<Functor, T, Args...>>(
+        common::Bind(std::forward<Functor>(functor), common::Unretained(obj), std::forward<Args>(args)...),
+        priority == Priority::REAL_TIME ? static_cast<common::IPostableContext*>(&real_time_context_) : this);
+  }
+
   template <typename T>
   friend class Queue;
 
+  template <typename T>
+  friend class SpscQueue;
+
   friend class Alarm;
 
   friend class RepeatingAlarm;
 
  private:
+  // A closure and, while task statistics are enabled, when it was posted
+  struct Task {
+    common::InlineClosure closure;
+    std::chrono::steady_clock::time_point posted;
+  };
+
+  struct TaskLanes {
+    std::queue<Task> normal;
+    std::queue<Task> real_time;
+    // REAL_TIME closures run since the last NORMAL one
+    int real_time_in_a_row = 0;
+
+    size_t size() const {
+      return normal.size() + real_time.size();
+    }
+  };
+
+  // Posts the closures of the callbacks bound with REAL_TIME priority
+  class RealTimeContext : public common::IPostableContext {
+   public:
+    explicit RealTimeContext(Handler* handler) : handler_(handler) {}
+    void Post(common::OnceClosure closure) override {
+      handler_->Post(Priority::REAL_TIME, std::move(closure));
+    }
+
+   private:
+    Handler* handler_;
+  };
+
   inline bool was_cleared() const {
     return tasks_ == nullptr;
   };
-  std::queue<common::OnceClosure>* tasks_;
+  void run_task(Task task);
+  // Takes the next closure to run, mutex_ must be held and a closure must be queued
+  Task pop_next_task();
+  TaskLanes* tasks_;
+  size_t max_normal_depth_ = 0;
+  size_t max_real_time_depth_ = 0;
+  RealTimeContext real_time_context_{this};
   Thread* thread_;
   std::unique_ptr<Reactor::Event> event_;
   Reactor::Reactable* reactable_;
   mutable std::mutex mutex_;
+  const WakeupMode wakeup_mode_;
+  std::atomic<bool> is_signalled_{false};
+  std::atomic<uint64_t> wakeup_count_{0};
+  std::atomic<uint64_t> task_count_{0};
   void handle_next_event();
+  void handle_coalesced_events();
 };
 
 }  // namespace os
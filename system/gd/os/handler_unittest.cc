@@ -18,6 +18,7 @@
 
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -64,6 +65,19 @@ TEST_F(HandlerTest, post_task_invoked) {
   handler_->Clear();
 }
 
+TEST_F(HandlerTest, post_inline_task_invoked) {
+  int val = 0;
+  std::promise<void> closure_ran;
+  auto future = closure_ran.get_future();
+  handler_->Post([&val, closure_ran = std::move(closure_ran)]() mutable {
+    val++;
+    closure_ran.set_value();
+  });
+  future.wait();
+  ASSERT_EQ(val, 1);
+  handler_->Clear();
+}
+
 TEST_F(HandlerTest, post_task_cleared) {
   int val = 0;
   std::promise<void> closure_started;
@@ -116,6 +130,149 @@ TEST_F(HandlerTest, callback_with_promise) {
   handler_->Clear();
 }
 
+TEST_F(HandlerTest, task_stats_recorded) {
+  common::EnableTaskStats(true, std::chrono::milliseconds(0));
+  uint64_t task_count = thread_->GetTaskStats().GetTaskCount();
+  handler_->Post(common::BindOnce([]() {}));
+  // Tasks run in order, so the first one is recorded by the time the second one runs
+  std::promise<void> second_ran;
+  auto future = second_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&second_ran)));
+  future.wait();
+  EXPECT_GE(thread_->GetTaskStats().GetTaskCount(), task_count + 1);
+  EXPECT_GE(thread_->GetTaskStats().GetLongTaskCount(), 1u);
+  handler_->Clear();
+  common::EnableTaskStats(false, std::chrono::milliseconds(100));
+}
+
+TEST_F(HandlerTest, real_time_tasks_run_first) {
+  constexpr int kNumNormal = 3;
+  // More than a NORMAL closure lets run in a row
+  constexpr int kNumRealTime = 10;
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  auto can_continue_future = closure_can_continue.get_future();
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> closure_started, std::future<void> can_continue_future) {
+        closure_started.set_value();
+        can_continue_future.wait();
+      },
+      std::move(closure_started),
+      std::move(can_continue_future)));
+  closure_started_future.wait();
+
+  // NORMAL closures are numbered from 0, REAL_TIME ones from 100
+  std::vector<int> order;
+  for (int i = 0; i < kNumNormal; i++) {
+    handler_->Post(common::BindOnce([](std::vector<int>* order, int i) { order->push_back(i); }, &order, i));
+  }
+  for (int i = 0; i < kNumRealTime; i++) {
+    handler_->Post(
+        Handler::Priority::REAL_TIME,
+        common::BindOnce([](std::vector<int>* order, int i) { order->push_back(100 + i); }, &order, i));
+  }
+  ASSERT_EQ(handler_->GetQueueDepth(Handler::Priority::NORMAL), static_cast<size_t>(kNumNormal));
+  ASSERT_EQ(handler_->GetQueueDepth(Handler::Priority::REAL_TIME), static_cast<size_t>(kNumRealTime));
+  std::promise<void> all_ran;
+  auto all_ran_future = all_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&all_ran)));
+  closure_can_continue.set_value();
+  all_ran_future.wait();
+
+  // Eight REAL_TIME closures, then a NORMAL one so that it is not starved, then the rest of the REAL_TIME ones
+  std::vector<int> expected = {100, 101, 102, 103, 104, 105, 106, 107, 0, 108, 109, 1, 2};
+  ASSERT_EQ(order, expected);
+  ASSERT_EQ(handler_->GetQueueDepth(Handler::Priority::REAL_TIME), 0u);
+  ASSERT_EQ(handler_->GetMaxQueueDepth(Handler::Priority::REAL_TIME), static_cast<size_t>(kNumRealTime));
+  ASSERT_EQ(handler_->GetMaxQueueDepth(Handler::Priority::NORMAL), static_cast<size_t>(kNumNormal + 1));
+  handler_->Clear();
+}
+
+class CoalescedHandlerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_, Handler::WakeupMode::COALESCED);
+  }
+  void TearDown() override {
+    delete handler_;
+    delete thread_;
+  }
+
+  Handler* handler_;
+  Thread* thread_;
+};
+
+TEST_F(CoalescedHandlerTest, post_task_invoked) {
+  std::promise<void> closure_ran;
+  auto future = closure_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&closure_ran)));
+  future.wait();
+  ASSERT_EQ(handler_->GetWakeupCount(), 1u);
+  ASSERT_EQ(handler_->GetTaskCount(), 1u);
+  handler_->Clear();
+}
+
+TEST_F(CoalescedHandlerTest, posts_while_busy_share_one_wakeup) {
+  constexpr int kNumClosures = 100;
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  auto can_continue_future = closure_can_continue.get_future();
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> closure_started, std::future<void> can_continue_future) {
+        closure_started.set_value();
+        can_continue_future.wait();
+      },
+      std::move(closure_started),
+      std::move(can_continue_future)));
+  closure_started_future.wait();
+
+  std::vector<int> order;
+  for (int i = 0; i < kNumClosures; i++) {
+    handler_->Post(common::BindOnce([](std::vector<int>* order, int i) { order->push_back(i); }, &order, i));
+  }
+  std::promise<void> all_ran;
+  auto all_ran_future = all_ran.get_future();
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&all_ran)));
+  closure_can_continue.set_value();
+  all_ran_future.wait();
+
+  ASSERT_EQ(order.size(), static_cast<size_t>(kNumClosures));
+  for (int i = 0; i < kNumClosures; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+  ASSERT_EQ(handler_->GetWakeupCount(), 2u);
+  ASSERT_EQ(handler_->GetTaskCount(), static_cast<uint64_t>(kNumClosures + 2));
+  handler_->Clear();
+}
+
+TEST_F(CoalescedHandlerTest, post_task_cleared) {
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  auto can_continue_future = closure_can_continue.get_future();
+  std::promise<void> closure_finished;
+  auto closure_finished_future = closure_finished.get_future();
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> closure_started,
+         std::future<void> can_continue_future,
+         std::promise<void> closure_finished) {
+        closure_started.set_value();
+        can_continue_future.wait();
+        closure_finished.set_value();
+      },
+      std::move(closure_started),
+      std::move(can_continue_future),
+      std::move(closure_finished)));
+  closure_started_future.wait();
+  handler_->Post(common::BindOnce([]() { ASSERT_TRUE(false); }));
+  handler_->Clear();
+  closure_can_continue.set_value();
+  closure_finished_future.wait();
+}
+
 // For Death tests, all the threading needs to be done in the ASSERT_DEATH call
 class HandlerDeathTest : public ::testing::Test {
  protected:
@@ -16,6 +16,7 @@
 
 #include "os/system_properties.h"
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -25,6 +26,7 @@ namespace os {
 
 namespace {
 std::mutex properties_mutex;
+std::atomic<uint32_t> properties_serial = 0;
 std::unordered_map<std::string, std::string> properties;
 }  // namespace
 
@@ -40,15 +42,21 @@ std::optional<std::string> GetSystemProperty(const std::string& property) {
 bool SetSystemProperty(const std::string& property, const std::string& value) {
   std::lock_guard<std::mutex> lock(properties_mutex);
   properties.insert_or_assign(property, value);
+  properties_serial++;
   return true;
 }
 
 bool ClearSystemPropertiesForHost() {
   std::lock_guard<std::mutex> lock(properties_mutex);
   properties.clear();
+  properties_serial++;
   return true;
 }
 
+uint32_t GetSystemPropertiesSerial() {
+  return properties_serial;
+}
+
 bool IsRootCanalEnabled() {
   return false;
 }
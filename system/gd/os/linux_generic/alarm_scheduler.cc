@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/alarm_scheduler.h"
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#include "common/bind.h"
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+#ifdef __ANDROID__
+#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
+#else
+#define ALARM_CLOCK CLOCK_BOOTTIME
+#endif
+
+namespace bluetooth {
+namespace os {
+using common::Closure;
+using common::OnceClosure;
+using common::TimerWheel;
+
+namespace {
+
+std::mutex schedulers_mutex;
+
+// Never destroyed, alarms may outlive static destructors
+std::unordered_map<Thread*, std::weak_ptr<AlarmScheduler>>& schedulers() {
+  static auto* schedulers = new std::unordered_map<Thread*, std::weak_ptr<AlarmScheduler>>();
+  return *schedulers;
+}
+
+uint64_t now_ms() {
+#ifdef USE_FAKE_TIMERS
+  return fake_timer::fake_timerfd_get_clock();
+#else
+  timespec ts;
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000ULL;
+#endif
+}
+
+}  // namespace
+
+std::shared_ptr<AlarmScheduler> AlarmScheduler::Get(Thread* thread) {
+  std::lock_guard<std::mutex> lock(schedulers_mutex);
+  auto& entry = schedulers()[thread];
+  auto scheduler = entry.lock();
+  if (scheduler == nullptr) {
+    scheduler = std::make_shared<AlarmScheduler>(thread);
+    entry = scheduler;
+  }
+  return scheduler;
+}
+
+AlarmScheduler::AlarmScheduler(Thread* thread)
+    : thread_(thread), fd_(TIMERFD_CREATE(ALARM_CLOCK, TFD_NONBLOCK)), wheel_(now_ms()) {
+  ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
+
+  token_ = thread_->GetReactor()->Register(
+      fd_, common::Bind(&AlarmScheduler::on_fire, common::Unretained(this)), Closure());
+}
+
+AlarmScheduler::~AlarmScheduler() {
+  thread_->GetReactor()->Unregister(token_);
+
+  int close_status;
+  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
+  ASSERT(close_status != -1);
+
+  std::lock_guard<std::mutex> lock(schedulers_mutex);
+  auto entry = schedulers().find(thread_);
+  if (entry != schedulers().end() && entry->second.expired()) {
+    schedulers().erase(entry);
+  }
+}
+
+void AlarmScheduler::Schedule(
+    Timer* timer, OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(timer);
+  timer->task_ = std::move(task);
+  timer->period_ms_ = 0;
+  wheel_.Schedule(timer, TimerWheel::CoalesceDeadline(now_ms() + delay.count(), slack.count()));
+  rearm_locked();
+}
+
+void AlarmScheduler::ScheduleRepeating(Timer* timer, Closure task, std::chrono::milliseconds period) {
+  ASSERT(period.count() > 0);
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(timer);
+  timer->repeating_task_ = std::move(task);
+  timer->period_ms_ = period.count();
+  wheel_.Schedule(timer, now_ms() + timer->period_ms_);
+  rearm_locked();
+}
+
+void AlarmScheduler::Cancel(Timer* timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancel_locked(timer);
+  rearm_locked();
+}
+
+uint64_t AlarmScheduler::GetWakeupCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return wakeup_count_;
+}
+
+void AlarmScheduler::cancel_locked(Timer* timer) {
+  wheel_.Cancel(timer);
+  fired_.erase(std::remove(fired_.begin(), fired_.end(), timer), fired_.end());
+}
+
+void AlarmScheduler::rearm_locked() {
+  auto next = wheel_.NextDeadlineMs();
+  if (!next) {
+    if (armed_deadline_ms_ != UINT64_MAX) {
+      itimerspec disarm_itimerspec{/* disarm timer */};
+      int result = TIMERFD_SETTIME(fd_, 0, &disarm_itimerspec, nullptr);
+      ASSERT(result == 0);
+      armed_deadline_ms_ = UINT64_MAX;
+    }
+    return;
+  }
+  if (*next == armed_deadline_ms_) {
+    return;
+  }
+
+  // A zero delay would disarm the timer, an overdue deadline fires in a millisecond instead
+  uint64_t now = now_ms();
+  uint64_t delay_ms = *next > now ? *next - now : 1;
+  itimerspec timer_itimerspec{
+      {/* interval for periodic timer */},
+      {static_cast<time_t>(delay_ms / 1000), static_cast<long>(delay_ms % 1000 * 1000000)}};
+  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
+  ASSERT(result == 0);
+  armed_deadline_ms_ = *next;
+}
+
+void AlarmScheduler::on_fire() {
+  // A task may release the last alarm of the thread, and with it this scheduler
+  auto self = weak_from_this().lock();
+  if (self == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Re-arming resets the expiration count, so the timerfd may have nothing left to read
+    uint64_t times_invoked;
+    auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
+    if (bytes_read == -1 && errno != EAGAIN) {
+      LOG_WARN("cannot read timerfd: %s", strerror(errno));
+    }
+    wakeup_count_++;
+    armed_deadline_ms_ = UINT64_MAX;
+
+    wheel_.Advance(now_ms(), [this](TimerWheel::Entry* entry) {
+      Timer* timer = static_cast<Timer*>(entry);
+      fired_.push_back(timer);
+      if (timer->period_ms_ != 0) {
+        wheel_.Schedule(timer, timer->DeadlineMs() + timer->period_ms_);
+      }
+    });
+    rearm_locked();
+  }
+
+  // Tasks run one at a time so that a task cancelling another expired alarm keeps it from running
+  while (true) {
+    OnceClosure task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (fired_.empty()) {
+        break;
+      }
+      Timer* timer = fired_.front();
+      fired_.pop_front();
+      if (timer->period_ms_ != 0) {
+        task = timer->repeating_task_;
+      } else {
+        task = std::move(timer->task_);
+      }
+    }
+    std::move(task).Run();
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
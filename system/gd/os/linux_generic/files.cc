@@ -28,6 +28,7 @@
 #include <string>
 
 #include "os/log.h"
+#include "os/utils.h"
 
 namespace {
 
@@ -206,6 +207,56 @@ bool WriteToFile(const std::string& path, const std::string& data) {
   return true;
 }
 
+bool AppendToFile(const std::string& path, const std::string& data) {
+  ASSERT(!path.empty());
+  bool created = !FileExists(path);
+  int fd;
+  RUN_NO_INTR(
+      fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP));
+  if (fd < 0) {
+    LOG_ERROR("unable to open file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result;
+    RUN_NO_INTR(result = write(fd, data.data() + written, data.size() - written));
+    if (result < 0) {
+      LOG_ERROR("unable to append to file '%s', error: %s", path.c_str(), strerror(errno));
+      close(fd);
+      return false;
+    }
+    written += result;
+  }
+
+  // Sync appended data out to disk. fsync() is blocking until data makes it to disk.
+  if (fsync(fd) != 0) {
+    LOG_WARN("unable to fsync file '%s', error: %s", path.c_str(), strerror(errno));
+    // Allow fsync to fail and continue
+  }
+  if (close(fd) != 0) {
+    LOG_ERROR("unable to close file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+
+  if (created) {
+    // Make sure the new directory entry is on disk as well
+    std::string temp_path_for_dir(path);
+    std::string directory_path(dirname(temp_path_for_dir.data()));
+    int dir_fd = open(directory_path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0) {
+      LOG_WARN("unable to open dir '%s', error: %s", directory_path.c_str(), strerror(errno));
+    } else {
+      if (fsync(dir_fd) != 0) {
+        LOG_WARN("unable to fsync dir '%s', error: %s", directory_path.c_str(), strerror(errno));
+      }
+      close(dir_fd);
+    }
+  }
+  return true;
+}
+
 bool RemoveFile(const std::string& path) {
   if (remove(path.c_str()) != 0) {
     LOG_ERROR("unable to remove file '%s', error: %s", path.c_str(), strerror(errno));
@@ -72,7 +72,7 @@ class QueueTest : public ::testing::Test {
 
 class TestEnqueueEnd {
  public:
-  explicit TestEnqueueEnd(Queue<std::string>* queue, Handler* handler)
+  explicit TestEnqueueEnd(IQueueEnqueue<std::string>* queue, Handler* handler)
       : count(0), handler_(handler), queue_(queue), delay_(0) {}
 
   ~TestEnqueueEnd() {}
@@ -122,7 +122,7 @@ class TestEnqueueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  IQueueEnqueue<std::string>* queue_;
   std::unordered_map<int, std::promise<int>>* promise_map_;
   int delay_;
 
@@ -138,7 +138,7 @@ class TestEnqueueEnd {
 
 class TestDequeueEnd {
  public:
-  explicit TestDequeueEnd(Queue<std::string>* queue, Handler* handler, int capacity)
+  explicit TestDequeueEnd(IQueueDequeue<std::string>* queue, Handler* handler, int capacity)
       : count(0), handler_(handler), queue_(queue), capacity_(capacity), delay_(0) {}
 
   ~TestDequeueEnd() {}
@@ -186,7 +186,7 @@ class TestDequeueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  IQueueDequeue<std::string>* queue_;
   std::unordered_map<int, std::promise<int>>* promise_map_;
   int capacity_;
   int delay_;
@@ -811,6 +811,142 @@ TEST_F(QueueTest, unregister_dequeue_and_wait) {
 }
 
 // Create all threads for death tests in the function that dies
+// SpscQueue must honor the same level-triggered contract as Queue
+
+TEST_F(QueueTest, spsc_register_enqueue_with_full_queue) {
+  SpscQueue<std::string> queue(kQueueSize);
+  TestEnqueueEnd test_enqueue_end(&queue, enqueue_handler_);
+
+  // make Queue full
+  for (int i = 0; i < kQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+  std::unordered_map<int, std::promise<int>> enqueue_promise_map;
+  enqueue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(0), std::forward_as_tuple());
+  auto enqueue_future = enqueue_promise_map[0].get_future();
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+  enqueue_future.wait();
+  EXPECT_EQ(enqueue_future.get(), 0);
+
+  // push some data to enqueue_end buffer and register enqueue;
+  for (int i = 0; i < kHalfOfQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+
+  // EnqueueCallback shouldn't be invoked
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(test_enqueue_end.buffer_.size(), (size_t)kHalfOfQueueSize);
+  EXPECT_EQ(test_enqueue_end.count, kQueueSize);
+
+  test_enqueue_end.UnregisterEnqueue();
+}
+
+TEST_F(QueueTest, spsc_register_dequeue_with_empty_queue) {
+  SpscQueue<std::string> queue(kQueueSize);
+  TestDequeueEnd test_dequeue_end(&queue, dequeue_handler_, kQueueSize);
+
+  // Register dequeue, DequeueCallback shouldn't be invoked
+  std::unordered_map<int, std::promise<int>> dequeue_promise_map;
+  test_dequeue_end.RegisterDequeue(&dequeue_promise_map);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(test_dequeue_end.count, 0);
+
+  test_dequeue_end.UnregisterDequeue();
+}
+
+TEST_F(QueueTest, spsc_queue_becomes_full_and_non_empty_at_same_time) {
+  SpscQueue<std::string> queue(kQueueSizeOne);
+  TestEnqueueEnd test_enqueue_end(&queue, enqueue_handler_);
+  TestDequeueEnd test_dequeue_end(&queue, dequeue_handler_, kDoubleOfQueueSize);
+
+  for (int i = 0; i < kQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+
+  // Register dequeue
+  std::unordered_map<int, std::promise<int>> dequeue_promise_map;
+  dequeue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(kQueueSize), std::forward_as_tuple());
+  auto dequeue_future = dequeue_promise_map[kQueueSize].get_future();
+  test_dequeue_end.RegisterDequeue(&dequeue_promise_map);
+
+  // Register enqueue
+  std::unordered_map<int, std::promise<int>> enqueue_promise_map;
+  auto enqueue_future = enqueue_promise_map[0].get_future();
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+
+  // Wait for all data move from enqueue end buffer to dequeue end buffer
+  dequeue_future.wait();
+  EXPECT_EQ(dequeue_future.get(), kQueueSize);
+
+  test_dequeue_end.UnregisterDequeue();
+}
+
+TEST_F(QueueTest, spsc_queue_becomes_non_full_during_test) {
+  SpscQueue<std::string> queue(kQueueSize);
+  TestEnqueueEnd test_enqueue_end(&queue, enqueue_handler_);
+  TestDequeueEnd test_dequeue_end(&queue, dequeue_handler_, kQueueSize * 3);
+
+  // make Queue full
+  for (int i = 0; i < kDoubleOfQueueSize; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+  std::unordered_map<int, std::promise<int>> enqueue_promise_map;
+  enqueue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(kQueueSize), std::forward_as_tuple());
+  enqueue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(0), std::forward_as_tuple());
+  auto enqueue_future = enqueue_promise_map[kQueueSize].get_future();
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+  enqueue_future.wait();
+  EXPECT_EQ(enqueue_future.get(), kQueueSize);
+
+  // Expect kQueueSize data block in enqueue end buffer
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(test_enqueue_end.buffer_.size(), (size_t)kQueueSize);
+
+  // Register dequeue
+  std::unordered_map<int, std::promise<int>> dequeue_promise_map;
+  test_dequeue_end.RegisterDequeue(&dequeue_promise_map);
+
+  // Expect enqueue end will empty
+  enqueue_future = enqueue_promise_map[0].get_future();
+  enqueue_future.wait();
+  EXPECT_EQ(enqueue_future.get(), 0);
+
+  test_dequeue_end.UnregisterDequeue();
+}
+
+TEST_F(QueueTest, spsc_keeps_order_across_threads) {
+  constexpr int kNumData = 1000;
+  SpscQueue<std::string> queue(kQueueSize);
+  TestEnqueueEnd test_enqueue_end(&queue, enqueue_handler_);
+  TestDequeueEnd test_dequeue_end(&queue, dequeue_handler_, kNumData);
+
+  for (int i = 0; i < kNumData; i++) {
+    std::unique_ptr<std::string> data = std::make_unique<std::string>(std::to_string(i));
+    test_enqueue_end.buffer_.push(std::move(data));
+  }
+
+  std::unordered_map<int, std::promise<int>> dequeue_promise_map;
+  dequeue_promise_map.emplace(std::piecewise_construct, std::forward_as_tuple(kNumData), std::forward_as_tuple());
+  auto dequeue_future = dequeue_promise_map[kNumData].get_future();
+  test_dequeue_end.RegisterDequeue(&dequeue_promise_map);
+
+  std::unordered_map<int, std::promise<int>> enqueue_promise_map;
+  test_enqueue_end.RegisterEnqueue(&enqueue_promise_map);
+
+  dequeue_future.wait();
+  for (int i = 0; i < kNumData; i++) {
+    ASSERT_NE(test_dequeue_end.buffer_.front(), nullptr);
+    EXPECT_EQ(*test_dequeue_end.buffer_.front(), std::to_string(i));
+    test_dequeue_end.buffer_.pop();
+  }
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
 class QueueDeathTest : public ::testing::Test {
  public:
   void RegisterEnqueueAndDelete() {
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "reactive_event.h"
+
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace os {
+
+ReactiveEvent::ReactiveEvent(bool is_set) : fd_(eventfd(is_set ? 1 : 0, EFD_NONBLOCK)) {
+  ASSERT(fd_ != -1);
+}
+
+ReactiveEvent::~ReactiveEvent() {
+  int close_status;
+  RUN_NO_INTR(close_status = close(fd_));
+  ASSERT_LOG(close_status != -1, "close failed: %s", strerror(errno));
+}
+
+void ReactiveEvent::Set() {
+  auto write_result = eventfd_write(fd_, 1);
+  ASSERT_LOG(write_result != -1, "set failed: %s", strerror(errno));
+}
+
+void ReactiveEvent::Clear() {
+  uint64_t val = 0;
+  auto read_result = eventfd_read(fd_, &val);
+  ASSERT_LOG(read_result != -1 || errno == EAGAIN, "clear failed: %s", strerror(errno));
+}
+
+int ReactiveEvent::GetFd() {
+  return fd_;
+}
+
+}  // namespace os
+}  // namespace bluetooth
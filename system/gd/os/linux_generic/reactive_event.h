@@ -0,0 +1,43 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+// A event_fd in non-blocking mode used as a level-triggered flag: it stays readable from Set() until Clear()
+class ReactiveEvent {
+ public:
+  explicit ReactiveEvent(bool is_set);
+
+  ReactiveEvent(const ReactiveEvent&) = delete;
+  ReactiveEvent& operator=(const ReactiveEvent&) = delete;
+
+  ~ReactiveEvent();
+  // Makes |fd_| readable. Setting an event that is already set has no further effect.
+  void Set();
+  // Makes |fd_| unreadable. Clearing an event that is not set has no effect.
+  void Clear();
+  int GetFd();
+
+ private:
+  int fd_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
@@ -237,6 +237,7 @@ void Reactor::Unregister(Reactor::Reactable* reactable) {
     invalidation_list_.push_back(reactable);
   }
   bool delaying_delete_until_callback_finished = false;
+  std::shared_ptr<std::future<void>> finished;
   {
     int result;
     std::lock_guard<std::mutex> reactable_lock(reactable->mutex_);
@@ -252,10 +253,15 @@ void Reactor::Unregister(Reactor::Reactable* reactable) {
     if (reactable->is_executing_) {
       reactable->removed_ = true;
       reactable->finished_promise_ = std::make_unique<std::promise<void>>();
-      executing_reactable_finished_ = std::make_shared<std::future<void>>(reactable->finished_promise_->get_future());
+      finished = std::make_shared<std::future<void>>(reactable->finished_promise_->get_future());
       delaying_delete_until_callback_finished = true;
     }
   }
+  // Handlers of one thread may be unregistered from several threads when modules stop in parallel
+  if (finished != nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    executing_reactable_finished_ = std::move(finished);
+  }
   // If we are unregistering outside of the callback event from this reactable, we delete it now
   if (!delaying_delete_until_callback_finished) {
     delete reactable;
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity) : ring_(capacity), enqueue_(capacity > 0), dequeue_(false) {
+  ASSERT(capacity > 0);
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue() {
+  ASSERT_LOG(enqueue_.handler_ == nullptr, "Enqueue is not unregistered");
+  ASSERT_LOG(dequeue_.handler_ == nullptr, "Dequeue is not unregistered");
+}
+
+template <typename T>
+void SpscQueue<T>::RegisterEnqueue(Handler* handler, EnqueueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(enqueue_.handler_ == nullptr);
+  ASSERT(enqueue_.reactable_ == nullptr);
+  enqueue_.handler_ = handler;
+  enqueue_.reactable_ = enqueue_.handler_->thread_->GetReactor()->Register(
+      enqueue_.reactive_event_.GetFd(),
+      base::Bind(&SpscQueue<T>::EnqueueCallbackInternal, base::Unretained(this), std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterEnqueue() {
+  Reactor* reactor = nullptr;
+  Reactor::Reactable* to_unregister = nullptr;
+  bool wait_for_unregister = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT(enqueue_.reactable_ != nullptr);
+    reactor = enqueue_.handler_->thread_->GetReactor();
+    wait_for_unregister = (!enqueue_.handler_->thread_->IsSameThread());
+    to_unregister = enqueue_.reactable_;
+    enqueue_.reactable_ = nullptr;
+    enqueue_.handler_ = nullptr;
+  }
+  reactor->Unregister(to_unregister);
+  if (wait_for_unregister) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+}
+
+template <typename T>
+void SpscQueue<T>::RegisterDequeue(Handler* handler, DequeueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(dequeue_.handler_ == nullptr);
+  ASSERT(dequeue_.reactable_ == nullptr);
+  dequeue_.handler_ = handler;
+  dequeue_.reactable_ = dequeue_.handler_->thread_->GetReactor()->Register(
+      dequeue_.reactive_event_.GetFd(), callback, base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterDequeue() {
+  Reactor* reactor = nullptr;
+  Reactor::Reactable* to_unregister = nullptr;
+  bool wait_for_unregister = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT(dequeue_.reactable_ != nullptr);
+    reactor = dequeue_.handler_->thread_->GetReactor();
+    wait_for_unregister = (!dequeue_.handler_->thread_->IsSameThread());
+    to_unregister = dequeue_.reactable_;
+    dequeue_.reactable_ = nullptr;
+    dequeue_.handler_ = nullptr;
+  }
+  reactor->Unregister(to_unregister);
+  if (wait_for_unregister) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+}
+
+template <typename T>
+std::unique_ptr<T> SpscQueue<T>::TryDequeue() {
+  if (size_.load(std::memory_order_acquire) == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<T> data = std::move(ring_[head_]);
+  head_ = (head_ + 1) % ring_.size();
+
+  // Clear our wakeup before publishing the free slot, otherwise a concurrent enqueue could be lost
+  bool may_become_empty = size_.load(std::memory_order_acquire) == 1;
+  if (may_become_empty) {
+    dequeue_.reactive_event_.Clear();
+  }
+  size_t previous_size = size_.fetch_sub(1, std::memory_order_acq_rel);
+  if (previous_size == ring_.size()) {
+    // The enqueue end stopped reacting when the queue filled up
+    enqueue_.reactive_event_.Set();
+  }
+  if (may_become_empty && previous_size != 1) {
+    // Something was enqueued while we were clearing the wakeup
+    dequeue_.reactive_event_.Set();
+  }
+  return data;
+}
+
+template <typename T>
+void SpscQueue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
+  if (size_.load(std::memory_order_acquire) == ring_.size()) {
+    // Stale wakeup, the dequeue end sets the event again once it frees a slot
+    enqueue_.reactive_event_.Clear();
+    if (size_.load(std::memory_order_acquire) != ring_.size()) {
+      enqueue_.reactive_event_.Set();
+    }
+    return;
+  }
+
+  std::unique_ptr<T> data = callback.Run();
+  ASSERT(data != nullptr);
+  ring_[tail_] = std::move(data);
+  tail_ = (tail_ + 1) % ring_.size();
+
+  // Clear our wakeup before publishing the new item, otherwise a concurrent dequeue could be lost
+  bool may_become_full = size_.load(std::memory_order_acquire) == ring_.size() - 1;
+  if (may_become_full) {
+    enqueue_.reactive_event_.Clear();
+  }
+  size_t previous_size = size_.fetch_add(1, std::memory_order_acq_rel);
+  if (previous_size == 0) {
+    // The dequeue end is idle until told otherwise
+    dequeue_.reactive_event_.Set();
+  }
+  if (may_become_full && previous_size != ring_.size() - 1) {
+    // Something was dequeued while we were clearing the wakeup
+    enqueue_.reactive_event_.Set();
+  }
+}
@@ -20,31 +20,18 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
-#include <cerrno>
-#include <cstring>
-
 #include "os/log.h"
+#include "os/thread_scheduling.h"
 
 namespace bluetooth {
 namespace os {
 
-namespace {
-constexpr int kRealTimeFifoSchedulingPriority = 1;
-}
-
 Thread::Thread(const std::string& name, const Priority priority)
-    : name_(name), reactor_(), running_thread_(&Thread::run, this, priority) {}
+    : name_(name), reactor_(), task_stats_(name), running_thread_(&Thread::run, this, priority) {}
 
 void Thread::run(Priority priority) {
-  if (priority == Priority::REAL_TIME) {
-    struct sched_param rt_params = {.sched_priority = kRealTimeFifoSchedulingPriority};
-    auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
-    int rc;
-    RUN_NO_INTR(rc = sched_setscheduler(linux_tid, SCHED_FIFO, &rt_params));
-    if (rc != 0) {
-      LOG_ERROR("unable to set SCHED_FIFO priority: %s", strerror(errno));
-    }
-  }
+  auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
+  ApplyThreadScheduling(linux_tid, name_, priority == Priority::REAL_TIME);
   reactor_.Run();
 }
 
@@ -72,6 +59,10 @@ Reactor* Thread::GetReactor() const {
   return &reactor_;
 }
 
+common::TaskStats& Thread::GetTaskStats() const {
+  return task_stats_;
+}
+
 std::string Thread::GetThreadName() const {
   return name_;
 }
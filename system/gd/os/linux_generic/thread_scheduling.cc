@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/thread_scheduling.h"
+
+#include <sched.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/strings.h"
+#include "os/log.h"
+#include "os/system_properties.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+constexpr char kThreadPropertyPrefix[] = "bluetooth.thread.";
+
+std::optional<int> ParseCpu(const std::string& text) {
+  auto cpu = common::Int64FromString(text);
+  if (!cpu || *cpu < 0 || *cpu >= CPU_SETSIZE) {
+    return std::nullopt;
+  }
+  return static_cast<int>(*cpu);
+}
+}  // namespace
+
+std::vector<int> ParseCpuList(const std::string& cpus) {
+  std::vector<int> result;
+  for (const auto& part : common::StringSplit(cpus, ",")) {
+    auto range = common::StringSplit(common::StringTrim(part), "-");
+    if (range.size() > 2) {
+      return {};
+    }
+    auto first = ParseCpu(range.front());
+    auto last = range.size() == 2 ? ParseCpu(range.back()) : first;
+    if (!first || !last || *first > *last) {
+      return {};
+    }
+    for (int cpu = *first; cpu <= *last; cpu++) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+ThreadSchedulingConfig GetThreadSchedulingConfig(const std::string& thread_name) {
+  ThreadSchedulingConfig config;
+  std::string prefix = kThreadPropertyPrefix + thread_name;
+
+  auto priority = GetSystemProperty(prefix + ".rt_priority");
+  if (priority) {
+    auto value = common::Int64FromString(*priority);
+    if (value && *value >= sched_get_priority_min(SCHED_FIFO) && *value <= sched_get_priority_max(SCHED_FIFO)) {
+      config.real_time_priority = static_cast<int>(*value);
+    } else {
+      LOG_WARN("Ignoring invalid real-time priority '%s' of %s", priority->c_str(), thread_name.c_str());
+    }
+  }
+
+  auto cpus = GetSystemProperty(prefix + ".cpus");
+  if (cpus) {
+    config.cpus = ParseCpuList(*cpus);
+    if (config.cpus.empty()) {
+      LOG_WARN("Ignoring invalid cpu list '%s' of %s", cpus->c_str(), thread_name.c_str());
+    }
+  }
+  return config;
+}
+
+bool ApplyThreadScheduling(pid_t linux_tid, const std::string& thread_name, bool real_time) {
+  auto config = GetThreadSchedulingConfig(thread_name);
+  bool success = true;
+
+  if (real_time || config.real_time_priority) {
+    struct sched_param rt_params = {
+        .sched_priority = config.real_time_priority.value_or(kDefaultRealTimeFifoSchedulingPriority)};
+    int rc;
+    RUN_NO_INTR(rc = sched_setscheduler(linux_tid, SCHED_FIFO, &rt_params));
+    if (rc != 0) {
+      LOG_ERROR(
+          "unable to set SCHED_FIFO priority %d for %s: %s",
+          rt_params.sched_priority,
+          thread_name.c_str(),
+          strerror(errno));
+      success = false;
+    }
+  }
+
+  if (!config.cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : config.cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    if (sched_setaffinity(linux_tid, sizeof(cpu_set), &cpu_set) != 0) {
+      LOG_ERROR("unable to set the cpu affinity of %s: %s", thread_name.c_str(), strerror(errno));
+    } else {
+      LOG_INFO("%s pinned to %zu cpus", thread_name.c_str(), config.cpus.size());
+    }
+  }
+  return success;
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/thread_scheduling.h"
+
+#include <gtest/gtest.h>
+
+#include "os/system_properties.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+TEST(ThreadSchedulingTest, parse_cpu_list) {
+  EXPECT_EQ(ParseCpuList("2"), std::vector<int>({2}));
+  EXPECT_EQ(ParseCpuList("0-3,6"), std::vector<int>({0, 1, 2, 3, 6}));
+  EXPECT_EQ(ParseCpuList("4-5, 7"), std::vector<int>({4, 5, 7}));
+}
+
+TEST(ThreadSchedulingTest, parse_malformed_cpu_list) {
+  EXPECT_TRUE(ParseCpuList("").empty());
+  EXPECT_TRUE(ParseCpuList("3-1").empty());
+  EXPECT_TRUE(ParseCpuList("1-2-3").empty());
+  EXPECT_TRUE(ParseCpuList("0,a").empty());
+  EXPECT_TRUE(ParseCpuList("4-").empty());
+}
+
+TEST(ThreadSchedulingTest, config_from_system_properties) {
+  ASSERT_TRUE(SetSystemProperty("bluetooth.thread.scheduling_test.rt_priority", "3"));
+  ASSERT_TRUE(SetSystemProperty("bluetooth.thread.scheduling_test.cpus", "1-2"));
+
+  auto config = GetThreadSchedulingConfig("scheduling_test");
+  EXPECT_EQ(config.real_time_priority, 3);
+  EXPECT_EQ(config.cpus, std::vector<int>({1, 2}));
+
+  auto unconfigured = GetThreadSchedulingConfig("scheduling_test_unconfigured");
+  EXPECT_FALSE(unconfigured.real_time_priority);
+  EXPECT_TRUE(unconfigured.cpus.empty());
+  ClearSystemPropertiesForHost();
+}
+
+TEST(ThreadSchedulingTest, invalid_priority_is_ignored) {
+  ASSERT_TRUE(SetSystemProperty("bluetooth.thread.scheduling_test.rt_priority", "1000"));
+  EXPECT_FALSE(GetThreadSchedulingConfig("scheduling_test").real_time_priority);
+  ClearSystemPropertiesForHost();
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
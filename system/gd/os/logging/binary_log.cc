@@ -0,0 +1,285 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/logging/binary_log.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace bluetooth {
+namespace os {
+namespace binary_log {
+
+namespace internal {
+std::atomic<uint32_t> levels_generation = 0;
+}  // namespace internal
+
+namespace {
+
+// Rings of threads that have exited are kept for the next dump, up to this many
+constexpr size_t kMaxRetiredRings = 16;
+
+constexpr size_t kArgsWords = (kMaxArgsSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+std::mutex levels_mutex;
+std::unordered_map<std::string, int> tag_levels;
+int default_level = kDefaultLevel;
+
+struct Line {
+  uint64_t timestamp_us;
+  uint32_t tid;
+  const CallSite* site;
+  internal::FormatFunction format;
+  int level;
+  std::array<uint64_t, kArgsWords> args;
+};
+
+// Written by its thread only. Every field is a relaxed atomic so that a dump can read slots while they are being
+// overwritten, the dump then discards the slots that may have changed under it.
+class Ring {
+ public:
+  explicit Ring(uint32_t tid) : tid_(tid) {}
+
+  void Write(
+      uint64_t timestamp_us,
+      const CallSite* site,
+      internal::FormatFunction format,
+      int level,
+      const uint8_t* args,
+      size_t args_size) {
+    std::array<uint64_t, kArgsWords> words;
+    memcpy(words.data(), args, args_size);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[head % kRecordsPerThread];
+    slot.timestamp_us.store(timestamp_us, std::memory_order_relaxed);
+    slot.site.store(site, std::memory_order_relaxed);
+    slot.format.store(format, std::memory_order_relaxed);
+    slot.level.store(level, std::memory_order_relaxed);
+    for (size_t i = 0; i < (args_size + sizeof(uint64_t) - 1) / sizeof(uint64_t); i++) {
+      slot.args[i].store(words[i], std::memory_order_relaxed);
+    }
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  void Read(std::vector<Line>* lines) const {
+    if (clear_requested_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > kRecordsPerThread ? head - kRecordsPerThread : 0;
+    std::vector<Line> copied;
+    copied.reserve(head - first);
+    for (uint64_t i = first; i < head; i++) {
+      const Slot& slot = slots_[i % kRecordsPerThread];
+      Line line = {
+          slot.timestamp_us.load(std::memory_order_relaxed),
+          tid_,
+          slot.site.load(std::memory_order_relaxed),
+          slot.format.load(std::memory_order_relaxed),
+          slot.level.load(std::memory_order_relaxed),
+          {},
+      };
+      for (size_t word = 0; word < kArgsWords; word++) {
+        line.args[word] = slot.args[word].load(std::memory_order_relaxed);
+      }
+      copied.push_back(line);
+    }
+    // Slots the writer got to while they were copied hold a mix of two lines
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t new_head = head_.load(std::memory_order_relaxed);
+    uint64_t overwritten = new_head > kRecordsPerThread ? new_head - kRecordsPerThread : 0;
+    size_t skip = overwritten > first ? std::min<uint64_t>(overwritten - first, copied.size()) : 0;
+    lines->insert(lines->end(), copied.begin() + skip, copied.end());
+  }
+
+  void Clear() {
+    clear_requested_.store(true, std::memory_order_relaxed);
+  }
+
+  // Called by the writer before it records, so that only the writer moves the head
+  void ClearIfRequested() {
+    if (clear_requested_.exchange(false, std::memory_order_relaxed)) {
+      head_.store(0, std::memory_order_release);
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> timestamp_us{0};
+    std::atomic<const CallSite*> site{nullptr};
+    std::atomic<internal::FormatFunction> format{nullptr};
+    std::atomic<int> level{0};
+    std::array<std::atomic<uint64_t>, kArgsWords> args{};
+  };
+
+  const uint32_t tid_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic_bool clear_requested_{false};
+  std::array<Slot, kRecordsPerThread> slots_;
+};
+
+std::mutex rings_mutex;
+std::vector<std::shared_ptr<Ring>> live_rings;
+std::vector<std::shared_ptr<Ring>> retired_rings;
+
+// Registers the ring of its thread on first use, and retires it when the thread exits
+class ThreadRing {
+ public:
+  ThreadRing() : ring_(std::make_shared<Ring>(static_cast<uint32_t>(syscall(SYS_gettid)))) {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    live_rings.push_back(ring_);
+  }
+
+  ~ThreadRing() {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    live_rings.erase(std::find(live_rings.begin(), live_rings.end(), ring_));
+    retired_rings.push_back(ring_);
+    if (retired_rings.size() > kMaxRetiredRings) {
+      retired_rings.erase(retired_rings.begin());
+    }
+  }
+
+  Ring& ring() {
+    return *ring_;
+  }
+
+ private:
+  std::shared_ptr<Ring> ring_;
+};
+
+uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+char level_letter(int level) {
+  switch (level) {
+    case LOG_TAG_FATAL:
+      return 'F';
+    case LOG_TAG_ERROR:
+      return 'E';
+    case LOG_TAG_WARN:
+      return 'W';
+    case LOG_TAG_NOTICE:
+    case LOG_TAG_INFO:
+      return 'I';
+    case LOG_TAG_DEBUG:
+      return 'D';
+    default:
+      return 'V';
+  }
+}
+
+}  // namespace
+
+namespace internal {
+
+int GetLevel(const char* tag) {
+  std::lock_guard<std::mutex> lock(levels_mutex);
+  auto it = tag_levels.find(tag);
+  return it != tag_levels.end() ? it->second : default_level;
+}
+
+void Record(const CallSite* site, int level, FormatFunction format, const uint8_t* args, size_t args_size) {
+  thread_local ThreadRing thread_ring;
+  Ring& ring = thread_ring.ring();
+  ring.ClearIfRequested();
+  ring.Write(now_us(), site, format, level, args, args_size);
+}
+
+}  // namespace internal
+
+void SetLevel(const std::string& tag, int level) {
+  std::lock_guard<std::mutex> lock(levels_mutex);
+  tag_levels[tag] = level;
+  internal::levels_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SetDefaultLevel(int level) {
+  std::lock_guard<std::mutex> lock(levels_mutex);
+  default_level = level;
+  internal::levels_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string ToText() {
+  std::vector<Line> lines;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex);
+    for (const auto* rings : {&live_rings, &retired_rings}) {
+      for (const auto& ring : *rings) {
+        ring->Read(&lines);
+      }
+    }
+  }
+  std::stable_sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+    return a.timestamp_us < b.timestamp_us;
+  });
+
+  std::string text;
+  char prefix[64];
+  char message[256];
+  for (const Line& line : lines) {
+    time_t seconds = line.timestamp_us / 1000000;
+    struct tm local_time;
+    localtime_r(&seconds, &local_time);
+    size_t length = strftime(prefix, sizeof(prefix), "%m-%d %H:%M:%S", &local_time);
+    snprintf(
+        prefix + length,
+        sizeof(prefix) - length,
+        ".%03u %7u %c ",
+        static_cast<unsigned>(line.timestamp_us / 1000 % 1000),
+        line.tid,
+        level_letter(line.level));
+    line.format(message, sizeof(message), line.site->format, reinterpret_cast<const uint8_t*>(line.args.data()));
+    text += prefix;
+    text += line.site->tag;
+    text += ": ";
+    text += line.site->file;
+    text += ":" + std::to_string(line.site->line) + " ";
+    text += line.site->function;
+    text += ": ";
+    text += message;
+    text += "\n";
+  }
+  return text;
+}
+
+void Dump(int fd) {
+  dprintf(fd, "\nBluetooth deferred log lines:\n");
+  std::string text = ToText();
+  dprintf(fd, "%s", text.c_str());
+}
+
+void Clear() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  for (auto& ring : live_rings) {
+    ring->Clear();
+  }
+  retired_rings.clear();
+}
+
+}  // namespace binary_log
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "os/log_tags.h"
+
+// Log lines recorded in binary form, for the paths where formatting a line on the calling thread costs too much to
+// keep the logging enabled. A line records the address of its call site and its raw arguments into a ring buffer of
+// the calling thread, without taking a lock. Formatting happens when the log is dumped.
+//
+// The level of each tag can be changed at runtime. It is checked before the arguments are evaluated, and a disabled
+// line costs two relaxed atomic loads.
+//
+// The format must be a string literal. Arithmetic, enum and pointer arguments are recorded by value. C strings are
+// copied, and truncated when the arguments don't fit in kMaxArgsSize bytes.
+//
+//   LOG_DEFERRED(LOG_TAG_DEBUG, "handle 0x%04hx, %zu bytes", handle, length);
+
+namespace bluetooth {
+namespace os {
+namespace binary_log {
+
+// Lines kept per thread, the oldest are overwritten
+constexpr size_t kRecordsPerThread = 1024;
+
+// Room for the arguments of a line
+constexpr size_t kMaxArgsSize = 64;
+
+// Level of the tags without a level of their own
+constexpr int kDefaultLevel = LOG_TAG_DEBUG;
+
+void SetLevel(const std::string& tag, int level);
+void SetDefaultLevel(int level);
+
+// The recorded lines of all threads, formatted and ordered by time
+std::string ToText();
+
+// Write ToText() to |fd|, for dumpsys
+void Dump(int fd);
+
+// Drop the recorded lines
+void Clear();
+
+struct CallSite {
+  const char* tag;
+  const char* file;
+  int line;
+  const char* function;
+  const char* format;
+};
+
+namespace internal {
+
+// Bumped whenever a level changes, so that the call sites look their level up again
+extern std::atomic<uint32_t> levels_generation;
+
+int GetLevel(const char* tag);
+
+// The level of a tag, cached by each call site
+class LevelCache {
+ public:
+  bool Allows(const char* tag, int level) {
+    uint32_t generation = levels_generation.load(std::memory_order_relaxed);
+    uint32_t cached = cached_.load(std::memory_order_relaxed);
+    if ((cached >> 8) != generation + 1) {
+      cached = (generation + 1) << 8 | static_cast<uint8_t>(GetLevel(tag));
+      cached_.store(cached, std::memory_order_relaxed);
+    }
+    return level <= static_cast<int>(cached & 0xff);
+  }
+
+ private:
+  // The generation plus one, then the level in the low byte. 0 until the first lookup.
+  std::atomic<uint32_t> cached_{0};
+};
+
+using FormatFunction = int (*)(char* buffer, size_t size, const char* format, const uint8_t* args);
+
+void Record(const CallSite* site, int level, FormatFunction format, const uint8_t* args, size_t args_size);
+
+template <typename T, typename Enable = void>
+struct Arg {
+  static_assert(
+      std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>,
+      "Only arithmetic, enum, pointer and C string arguments can be recorded");
+  static constexpr size_t kFixedSize = sizeof(T);
+  using Decoded = T;
+
+  static void Encode(uint8_t*& out, size_t& /* string_budget */, T value) {
+    memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+  }
+
+  static T Decode(const uint8_t*& in) {
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+};
+
+template <typename T>
+struct Arg<T, std::enable_if_t<std::is_same_v<T, const char*> || std::is_same_v<T, char*>>> {
+  // The terminating null character, the characters come out of the string budget
+  static constexpr size_t kFixedSize = 1;
+  using Decoded = const char*;
+
+  static void Encode(uint8_t*& out, size_t& string_budget, const char* value) {
+    if (value == nullptr) {
+      value = "(null)";
+    }
+    size_t length = strnlen(value, string_budget);
+    memcpy(out, value, length);
+    out[length] = '\0';
+    out += length + 1;
+    string_budget -= length;
+  }
+
+  static const char* Decode(const uint8_t*& in) {
+    const char* value = reinterpret_cast<const char*>(in);
+    in += strlen(value) + 1;
+    return value;
+  }
+};
+
+template <typename... Args>
+int Format(char* buffer, size_t size, const char* format, [[maybe_unused]] const uint8_t* args) {
+  // Braced initialization decodes the arguments in order
+  std::tuple<typename Arg<Args>::Decoded...> decoded{Arg<Args>::Decode(args)...};
+  return std::apply(
+      [&](auto... values) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+        return snprintf(buffer, size, format, values...);
+#pragma GCC diagnostic pop
+      },
+      decoded);
+}
+
+template <typename... Args>
+void Log(const CallSite& site, int level, Args... args) {
+  constexpr size_t kFixedSize = (Arg<Args>::kFixedSize + ... + 0);
+  static_assert(kFixedSize <= kMaxArgsSize, "Too many arguments to record");
+  uint8_t buffer[kMaxArgsSize] = {};
+  uint8_t* out = buffer;
+  [[maybe_unused]] size_t string_budget = kMaxArgsSize - kFixedSize;
+  (Arg<Args>::Encode(out, string_budget, args), ...);
+  Record(&site, level, &Format<Args...>, buffer, out - buffer);
+}
+
+inline void CheckFormat(const char* /* format */, ...) __attribute__((format(printf, 1, 2)));
+inline void CheckFormat(const char* /* format */, ...) {}
+
+}  // namespace internal
+
+}  // namespace binary_log
+}  // namespace os
+}  // namespace bluetooth
+
+#define LOG_DEFERRED(level, fmt, args...)                                                                      \
+  do {                                                                                                         \
+    static ::bluetooth::os::binary_log::internal::LevelCache _bt_log_level;                                    \
+    if (_bt_log_level.Allows(LOG_TAG, level)) {                                                                \
+      static const ::bluetooth::os::binary_log::CallSite _bt_log_site = {LOG_TAG, __FILE__, __LINE__, __func__, \
+                                                                         fmt};                                 \
+      if (false) {                                                                                             \
+        ::bluetooth::os::binary_log::internal::CheckFormat(fmt, ##args);                                       \
+      }                                                                                                        \
+      ::bluetooth::os::binary_log::internal::Log(_bt_log_site, level, ##args);                                 \
+    }                                                                                                          \
+  } while (false)
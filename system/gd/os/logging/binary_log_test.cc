@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_binary_log_test"
+
+#include "os/logging/binary_log.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace bluetooth {
+namespace os {
+namespace binary_log {
+namespace {
+
+size_t CountOf(const std::string& text, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    count++;
+  }
+  return count;
+}
+
+class BinaryLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Clear();
+    SetDefaultLevel(kDefaultLevel);
+    SetLevel(LOG_TAG, LOG_TAG_VERBOSE);
+  }
+
+  void TearDown() override {
+    SetLevel(LOG_TAG, kDefaultLevel);
+    Clear();
+  }
+};
+
+TEST_F(BinaryLogTest, formats_recorded_arguments) {
+  uint16_t handle = 0x40;
+  std::string name = "speaker";
+  LOG_DEFERRED(LOG_TAG_DEBUG, "handle 0x%04hx, %zu bytes, %s, %.1f", handle, size_t{27}, name.c_str(), 1.5);
+  name = "overwritten";
+
+  std::string text = ToText();
+  EXPECT_EQ(CountOf(text, " D bt_binary_log_test: "), 1u);
+  EXPECT_EQ(CountOf(text, "os/logging/binary_log_test.cc:"), 1u) << text;
+  EXPECT_EQ(CountOf(text, ": handle 0x0040, 27 bytes, speaker, 1.5\n"), 1u) << text;
+}
+
+TEST_F(BinaryLogTest, arguments_not_evaluated_below_tag_level) {
+  SetLevel(LOG_TAG, LOG_TAG_INFO);
+  int evaluations = 0;
+  LOG_DEFERRED(LOG_TAG_DEBUG, "%d", ++evaluations);
+  EXPECT_EQ(evaluations, 0);
+  EXPECT_TRUE(ToText().empty());
+
+  SetLevel(LOG_TAG, LOG_TAG_DEBUG);
+  for (int i = 0; i < 2; i++) {
+    LOG_DEFERRED(LOG_TAG_DEBUG, "%d", ++evaluations);
+  }
+  EXPECT_EQ(evaluations, 2);
+}
+
+TEST_F(BinaryLogTest, long_strings_are_truncated) {
+  std::string long_string(2 * kMaxArgsSize, 'x');
+  LOG_DEFERRED(LOG_TAG_DEBUG, "%d %s %d", 1, long_string.c_str(), 2);
+  std::string text = ToText();
+  EXPECT_EQ(CountOf(text, " 1 " + std::string(kMaxArgsSize - 2 * sizeof(int) - 1, 'x') + " 2\n"), 1u) << text;
+}
+
+TEST_F(BinaryLogTest, keeps_last_lines_of_each_thread) {
+  for (size_t i = 0; i < kRecordsPerThread + 10; i++) {
+    LOG_DEFERRED(LOG_TAG_DEBUG, "main_thread %zu", i);
+  }
+  std::thread([] { LOG_DEFERRED(LOG_TAG_INFO, "other_thread"); }).join();
+
+  std::string text = ToText();
+  EXPECT_EQ(CountOf(text, "main_thread"), kRecordsPerThread);
+  EXPECT_EQ(CountOf(text, "main_thread 9\n"), 0u);
+  EXPECT_EQ(CountOf(text, "main_thread 10\n"), 1u);
+  EXPECT_EQ(CountOf(text, "other_thread"), 1u);
+}
+
+}  // namespace
+}  // namespace binary_log
+}  // namespace os
+}  // namespace bluetooth
@@ -18,13 +18,16 @@
 
 #include <unistd.h>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
 #include "os/handler.h"
+#include "os/linux_generic/reactive_event.h"
 #include "os/linux_generic/reactive_semaphore.h"
 #include "os/log.h"
 
@@ -98,6 +101,55 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   QueueEndpoint dequeue_;
 };
 
+// A bounded, lock-free alternative to |Queue| for the common case of a single producer and a single consumer. It has
+// the same callback contract as |Queue|, but data moves through a ring without taking a lock, and the eventfds are
+// only written when the other end may be asleep: the dequeue end is woken when the queue goes from empty to non-empty
+// and the enqueue end when it goes from full to non-full.
+//
+// All EnqueueCallbacks must run on one thread, and all TryDequeue() calls must be made on one thread.
+template <typename T>
+class SpscQueue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
+ public:
+  using EnqueueCallback = common::Callback<std::unique_ptr<T>()>;
+  using DequeueCallback = common::Callback<void()>;
+  // Create a queue with |capacity| is the maximum number of messages a queue can contain
+  explicit SpscQueue(size_t capacity);
+  ~SpscQueue();
+  // See |Queue::RegisterEnqueue|
+  void RegisterEnqueue(Handler* handler, EnqueueCallback callback) override;
+  // See |Queue::UnregisterEnqueue|
+  void UnregisterEnqueue() override;
+  // See |Queue::RegisterDequeue|
+  void RegisterDequeue(Handler* handler, DequeueCallback callback) override;
+  // See |Queue::UnregisterDequeue|
+  void UnregisterDequeue() override;
+
+  // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
+  std::unique_ptr<T> TryDequeue() override;
+
+ private:
+  void EnqueueCallbackInternal(EnqueueCallback callback);
+  // Ring of |capacity| slots. |head_| is only touched by the consumer and |tail_| only by the producer; |size_|
+  // publishes slots between them.
+  std::vector<std::unique_ptr<T>> ring_;
+  size_t head_ = 0;
+  size_t tail_ = 0;
+  std::atomic<size_t> size_ = 0;
+  // A mutex that guards registration of the two ends; never taken when moving data
+  std::mutex mutex_;
+
+  class QueueEndpoint {
+   public:
+    explicit QueueEndpoint(bool is_set) : reactive_event_(is_set), handler_(nullptr), reactable_(nullptr) {}
+    ReactiveEvent reactive_event_;
+    Handler* handler_;
+    Reactor::Reactable* reactable_;
+  };
+
+  QueueEndpoint enqueue_;
+  QueueEndpoint dequeue_;
+};
+
 template <typename T>
 class EnqueueBuffer {
  public:
@@ -158,6 +210,7 @@ class EnqueueBuffer {
 };
 
 #include "os/linux_generic/queue.tpp"
+#include "os/linux_generic/spsc_queue.tpp"
 
 }  // namespace os
 }  // namespace bluetooth
@@ -56,7 +56,8 @@ class BM_QueuePerformance : public ::benchmark::Fixture {
 
 class TestEnqueueEnd {
  public:
-  explicit TestEnqueueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+  explicit TestEnqueueEnd(
+      int64_t count, IQueueEnqueue<std::string>* queue, Handler* handler, std::promise<void>* promise)
       : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
 
   void RegisterEnqueue() {
@@ -95,7 +96,7 @@ class TestEnqueueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  IQueueEnqueue<std::string>* queue_;
   std::promise<void>* promise_;
   std::mutex mutex_;
 
@@ -106,7 +107,8 @@ class TestEnqueueEnd {
 
 class TestDequeueEnd {
  public:
-  explicit TestDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+  explicit TestDequeueEnd(
+      int64_t count, IQueueDequeue<std::string>* queue, Handler* handler, std::promise<void>* promise)
       : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
 
   void RegisterDequeue() {
@@ -129,7 +131,7 @@ class TestDequeueEnd {
 
  private:
   Handler* handler_;
-  Queue<std::string>* queue_;
+  IQueueDequeue<std::string>* queue_;
   std::promise<void>* promise_;
 
   void handle_register_dequeue() {
@@ -137,25 +139,30 @@ class TestDequeueEnd {
   }
 };
 
+// Moves |num_data_to_send| packets of |packet_size| bytes through a |QueueType| holding all of them
+template <typename QueueType>
+void SendPackets(Handler* handler, int64_t num_data_to_send, int64_t packet_size) {
+  QueueType queue(num_data_to_send);
+
+  // register dequeue
+  std::promise<void> dequeue_promise;
+  auto dequeue_future = dequeue_promise.get_future();
+  TestDequeueEnd test_dequeue_end(num_data_to_send, &queue, handler, &dequeue_promise);
+  test_dequeue_end.RegisterDequeue();
+
+  // Push data to enqueue end buffer and register enqueue
+  std::promise<void> enqueue_promise;
+  TestEnqueueEnd test_enqueue_end(num_data_to_send, &queue, handler, &enqueue_promise);
+  for (int i = 0; i < num_data_to_send; i++) {
+    std::string data = std::string(packet_size, 'x');
+    test_enqueue_end.push(std::move(data));
+  }
+  dequeue_future.wait();
+}
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num)(State& state) {
   for (auto _ : state) {
-    int64_t num_data_to_send_ = state.range(0);
-    Queue<std::string> queue(num_data_to_send_);
-
-    // register dequeue
-    std::promise<void> dequeue_promise;
-    auto dequeue_future = dequeue_promise.get_future();
-    TestDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
-    test_dequeue_end.RegisterDequeue();
-
-    // Push data to enqueue end buffer and register enqueue
-    std::promise<void> enqueue_promise;
-    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
-    for (int i = 0; i < num_data_to_send_; i++) {
-      std::string data = std::to_string(1);
-      test_enqueue_end.push(std::move(data));
-    }
-    dequeue_future.wait();
+    SendPackets<Queue<std::string>>(enqueue_handler_, state.range(0), 1);
   }
 
   state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
@@ -170,26 +177,26 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_packet_vary_by_packet_num)
     ->Iterations(100)
     ->UseRealTime();
 
+BENCHMARK_DEFINE_F(BM_QueuePerformance, spsc_send_packet_vary_by_packet_num)(State& state) {
+  for (auto _ : state) {
+    SendPackets<SpscQueue<std::string>>(enqueue_handler_, state.range(0), 1);
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, spsc_send_packet_vary_by_packet_num)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(100)
+    ->UseRealTime();
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)(State& state) {
   for (auto _ : state) {
-    int64_t num_data_to_send_ = 10000;
-    int64_t packet_size = state.range(0);
-    Queue<std::string> queue(num_data_to_send_);
-
-    // register dequeue
-    std::promise<void> dequeue_promise;
-    auto dequeue_future = dequeue_promise.get_future();
-    TestDequeueEnd test_dequeue_end(num_data_to_send_, &queue, enqueue_handler_, &dequeue_promise);
-    test_dequeue_end.RegisterDequeue();
-
-    // Push data to enqueue end buffer and register enqueue
-    std::promise<void> enqueue_promise;
-    TestEnqueueEnd test_enqueue_end(num_data_to_send_, &queue, enqueue_handler_, &enqueue_promise);
-    for (int i = 0; i < num_data_to_send_; i++) {
-      std::string data = std::string(packet_size, 'x');
-      test_enqueue_end.push(std::move(data));
-    }
-    dequeue_future.wait();
+    SendPackets<Queue<std::string>>(enqueue_handler_, 10000, state.range(0));
   }
 
   state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0) * 10000);
@@ -202,5 +209,20 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)
     ->Iterations(100)
     ->UseRealTime();
 
+BENCHMARK_DEFINE_F(BM_QueuePerformance, spsc_send_10000_packet_vary_by_packet_size)(State& state) {
+  for (auto _ : state) {
+    SendPackets<SpscQueue<std::string>>(enqueue_handler_, 10000, state.range(0));
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0) * 10000);
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, spsc_send_10000_packet_vary_by_packet_size)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Iterations(100)
+    ->UseRealTime();
+
 }  // namespace os
 }  // namespace bluetooth
@@ -16,11 +16,11 @@
 
 #pragma once
 
-#include <functional>
+#include <chrono>
 #include <memory>
-#include <mutex>
 
 #include "common/callback.h"
+#include "os/alarm_scheduler.h"
 #include "os/handler.h"
 #include "os/thread.h"
 #include "os/utils.h"
@@ -28,9 +28,8 @@
 namespace bluetooth {
 namespace os {
 
-// A repeating alarm for reactor-based thread, implemented by Linux timerfd.
-// When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+// A repeating alarm for reactor-based thread. The alarms of a thread share a timer wheel behind a single Linux
+// timerfd, see AlarmScheduler.
 class RepeatingAlarm {
  public:
   // Create and register a repeating alarm on a given handler
@@ -49,12 +48,8 @@ class RepeatingAlarm {
   void Cancel();
 
  private:
-  common::Closure task_;
-  Handler* handler_;
-  int fd_ = 0;
-  Reactor::Reactable* token_;
-  mutable std::mutex mutex_;
-  void on_fire();
+  std::shared_ptr<AlarmScheduler> scheduler_;
+  AlarmScheduler::Timer timer_;
 };
 
 }  // namespace os
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -57,6 +58,9 @@ bool ClearSystemPropertiesForHost();
 // Check if the vendor image is using root canal simulated Bluetooth stack
 bool IsRootCanalEnabled();
 
+// Serial number of the system properties, which changes whenever one of them is set
+uint32_t GetSystemPropertiesSerial();
+
 // Get Android Vendor Image release version in numeric value (e.g. Android R is 11), return 0 if not on Android or
 // version not available
 int GetAndroidVendorReleaseVersion();
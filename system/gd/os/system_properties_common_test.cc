@@ -60,4 +60,10 @@ TEST(SystemPropertiesTest, getUint32BaseHex) {
   ASSERT_EQ(bluetooth::os::GetSystemPropertyUint32Base(property, 1, 10), 0u);  // if parsed as a dec
 }
 
+TEST(SystemPropertiesTest, serial_changes_when_a_property_is_set) {
+  uint32_t serial = bluetooth::os::GetSystemPropertiesSerial();
+  ASSERT_TRUE(SetSystemProperty("SystemPropertiesTest_serial", "1"));
+  ASSERT_NE(bluetooth::os::GetSystemPropertiesSerial(), serial);
+}
+
 }  // namespace testing
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include <string>
 #include <thread>
 
+#include "common/task_stats.h"
 #include "os/reactor.h"
 #include "os/utils.h"
 
@@ -41,6 +42,7 @@ class Thread {
 
   // name: thread name for POSIX systems
   // priority: priority for kernel scheduler
+  // The real-time priority and CPU affinity can be overridden per thread name, see os/thread_scheduling.h
   Thread(const std::string& name, Priority priority);
 
   Thread(const Thread&) = delete;
@@ -64,11 +66,16 @@ class Thread {
   // Return the pointer of underlying reactor. The ownership is NOT transferred.
   Reactor* GetReactor() const;
 
+  // Queue depth, wait and run times of the tasks posted to the handlers of this thread while task statistics are
+  // enabled
+  common::TaskStats& GetTaskStats() const;
+
  private:
   void run(Priority priority);
   mutable std::mutex mutex_;
   const std::string name_;
   mutable Reactor reactor_;
+  mutable common::TaskStats task_stats_;
   std::thread running_thread_;
 };
 
@@ -64,15 +64,29 @@ class BM_ReactorThread : public BM_ThreadPerformance {
     handler_ = std::make_unique<Handler>(thread_.get());
   }
   void TearDown(State& st) override {
+    handler_->Clear();
     handler_ = nullptr;
     thread_->Stop();
     thread_ = nullptr;
     BM_ThreadPerformance::TearDown(st);
   }
+  void ReportWakeups(State& state) {
+    state.counters["wakeups"] = handler_->GetWakeupCount();
+    state.counters["tasks"] = handler_->GetTaskCount();
+  }
   std::unique_ptr<Thread> thread_;
   std::unique_ptr<Handler> handler_;
 };
 
+class BM_CoalescedReactorThread : public BM_ReactorThread {
+ protected:
+  void SetUp(State& st) override {
+    BM_ReactorThread::SetUp(st);
+    handler_->Clear();
+    handler_ = std::make_unique<Handler>(thread_.get(), Handler::WakeupMode::COALESCED);
+  }
+};
+
 BENCHMARK_DEFINE_F(BM_ReactorThread, batch_enque_dequeue)(State& state) {
   for (auto _ : state) {
     num_messages_to_send_ = state.range(0);
@@ -85,6 +99,7 @@ BENCHMARK_DEFINE_F(BM_ReactorThread, batch_enque_dequeue)(State& state) {
     }
     counter_future.wait();
   }
+  ReportWakeups(state);
 };
 
 BENCHMARK_REGISTER_F(BM_ReactorThread, batch_enque_dequeue)
@@ -106,6 +121,7 @@ BENCHMARK_DEFINE_F(BM_ReactorThread, sequential_execution)(State& state) {
       counter_future.wait();
     }
   }
+  ReportWakeups(state);
 };
 
 BENCHMARK_REGISTER_F(BM_ReactorThread, sequential_execution)
@@ -115,3 +131,49 @@ BENCHMARK_REGISTER_F(BM_ReactorThread, sequential_execution)
     ->Arg(100000)
     ->Iterations(1)
     ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_CoalescedReactorThread, batch_enque_dequeue)(State& state) {
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0);
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    for (int i = 0; i < num_messages_to_send_; i++) {
+      handler_->Post(BindOnce(
+          &BM_CoalescedReactorThread_batch_enque_dequeue_Benchmark::callback_batch,
+          bluetooth::common::Unretained(this)));
+    }
+    counter_future.wait();
+  }
+  ReportWakeups(state);
+};
+
+BENCHMARK_REGISTER_F(BM_CoalescedReactorThread, batch_enque_dequeue)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(1)
+    ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_CoalescedReactorThread, sequential_execution)(State& state) {
+  for (auto _ : state) {
+    num_messages_to_send_ = state.range(0);
+    for (int i = 0; i < num_messages_to_send_; i++) {
+      counter_promise_ = std::promise<void>();
+      std::future<void> counter_future = counter_promise_.get_future();
+      handler_->Post(BindOnce(
+          &BM_CoalescedReactorThread_sequential_execution_Benchmark::callback, bluetooth::common::Unretained(this)));
+      counter_future.wait();
+    }
+  }
+  ReportWakeups(state);
+};
+
+BENCHMARK_REGISTER_F(BM_CoalescedReactorThread, sequential_execution)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Iterations(1)
+    ->UseRealTime();
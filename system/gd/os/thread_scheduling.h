@@ -0,0 +1,51 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace os {
+
+// SCHED_FIFO priority of the threads that ask for real-time scheduling without configuring one
+constexpr int kDefaultRealTimeFifoSchedulingPriority = 1;
+
+// Scheduling overrides of a single named thread, read from the system properties
+//   bluetooth.thread.<thread name>.rt_priority  SCHED_FIFO priority, e.g. "2"
+//   bluetooth.thread.<thread name>.cpus         CPUs the thread may run on, e.g. "0-3,6"
+// Both are optional; a thread without them keeps the scheduling it asked for in code.
+struct ThreadSchedulingConfig {
+  std::optional<int> real_time_priority;
+  std::vector<int> cpus;
+};
+
+ThreadSchedulingConfig GetThreadSchedulingConfig(const std::string& thread_name);
+
+// Parses a CPU list in the kernel's cpuset format ("0-3,6"). Returns an empty list if any part is malformed.
+std::vector<int> ParseCpuList(const std::string& cpus);
+
+// Applies the configuration of |thread_name| to the thread |linux_tid|. The thread gets SCHED_FIFO with the
+// configured priority, or with kDefaultRealTimeFifoSchedulingPriority if it has none and |real_time| is set.
+// Returns false if the real-time scheduling could not be set. A CPU affinity that can't be set is only logged.
+bool ApplyThreadScheduling(pid_t linux_tid, const std::string& thread_name, bool real_time);
+
+}  // namespace os
+}  // namespace bluetooth
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <forward_list>
 #include <iterator>
@@ -38,6 +39,13 @@ class BasePacketBuilder {
   // Write to the vector with the given iterator.
   virtual void Serialize(BitInserter& it) const = 0;
 
+  // Append the packet to |buffer|, after any headroom or earlier packets it already holds, growing it at most once.
+  void SerializeTo(std::vector<uint8_t>& buffer) const {
+    buffer.reserve(buffer.size() + size());
+    BitInserter it(buffer);
+    Serialize(it);
+  }
+
   void SetFlushable(bool is_flushable) {
     is_flushable_ = is_flushable;
   }
@@ -45,11 +53,20 @@ class BasePacketBuilder {
     return is_flushable_;
   }
 
+  // When the stack handed the packet over for sending, unset unless the sender set it
+  void SetTimestamp(std::chrono::steady_clock::time_point timestamp) {
+    timestamp_ = timestamp;
+  }
+  std::chrono::steady_clock::time_point GetTimestamp() const {
+    return timestamp_;
+  }
+
  protected:
   BasePacketBuilder() = default;
 
  private:
   bool is_flushable_{false};
+  std::chrono::steady_clock::time_point timestamp_{};
 };
 
 }  // namespace packet
@@ -48,5 +48,15 @@ void ByteInserter::insert_byte(uint8_t byte) {
   std::back_insert_iterator<std::vector<uint8_t>>::operator=(byte);
 }
 
+void ByteInserter::insert_bytes(const uint8_t* data, size_t length) {
+  if (registered_observers_.empty()) {
+    container->insert(container->end(), data, data + length);
+    return;
+  }
+  for (size_t i = 0; i < length; i++) {
+    ByteInserter::insert_byte(data[i]);
+  }
+}
+
 }  // namespace packet
 }  // namespace bluetooth
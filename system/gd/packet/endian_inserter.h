@@ -84,6 +84,23 @@ class EndianInserter {
     }
   }
 
+  // Write the num_bits low bits of value at bit_offset of a zeroed buffer, so that a fixed size builder can lay out all
+  // its fields before inserting them at once
+  template <typename T>
+  void insert_at(T value, uint8_t* buffer, size_t bit_offset, size_t num_bits) const {
+    static_assert(little_endian == true, "Fixed layouts are only generated for little endian packets");
+    uint64_t bits = static_cast<uint64_t>(value);
+    if (num_bits < 64) {
+      bits &= (static_cast<uint64_t>(1) << num_bits) - 1;
+    }
+    uint8_t* byte = buffer + bit_offset / 8;
+    size_t shift = bit_offset % 8;
+    *byte++ |= static_cast<uint8_t>(bits << shift);
+    for (size_t written = 8 - shift; written < num_bits; written += 8) {
+      *byte++ |= static_cast<uint8_t>(bits >> written);
+    }
+  }
+
   // Specialized insert that allows inserting enums without casting
   template <typename Enum, typename std::enable_if<std::is_enum_v<Enum>, int>::type = 0>
   inline void insert(Enum value, BitInserter& it) const {
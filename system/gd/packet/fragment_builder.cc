@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/fragment_builder.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace packet {
+
+FragmentBuilder::FragmentBuilder(
+    std::shared_ptr<const std::vector<uint8_t>> buffer, size_t begin, size_t end)
+    : buffer_(std::move(buffer)), begin_(begin), end_(end) {
+  ASSERT(buffer_ != nullptr);
+  ASSERT_LOG(
+      begin_ <= end_ && end_ <= buffer_->size(),
+      "Invalid range [%zu, %zu) of %zu bytes",
+      begin_,
+      end_,
+      buffer_->size());
+}
+
+std::vector<std::unique_ptr<FragmentBuilder>> FragmentBuilder::Fragment(
+    const BasePacketBuilder& packet, size_t mtu) {
+  ASSERT(mtu > 0);
+  auto buffer = std::make_shared<std::vector<uint8_t>>();
+  packet.SerializeTo(*buffer);
+
+  std::vector<std::unique_ptr<FragmentBuilder>> fragments;
+  fragments.reserve((buffer->size() + mtu - 1) / mtu);
+  for (size_t begin = 0; begin < buffer->size(); begin += mtu) {
+    size_t end = std::min(begin + mtu, buffer->size());
+    fragments.push_back(std::make_unique<FragmentBuilder>(buffer, begin, end));
+  }
+  return fragments;
+}
+
+size_t FragmentBuilder::size() const {
+  return end_ - begin_;
+}
+
+void FragmentBuilder::Serialize(BitInserter& it) const {
+  it.insert_bytes(buffer_->data() + begin_, end_ - begin_);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/packet_builder.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Builds the bytes [begin, end) of a buffer shared with the other fragments of the same packet.
+// The packet is serialized once and each fragment copies its range straight into the outgoing one.
+class FragmentBuilder : public PacketBuilder<true> {
+ public:
+  FragmentBuilder(std::shared_ptr<const std::vector<uint8_t>> buffer, size_t begin, size_t end);
+  virtual ~FragmentBuilder() = default;
+
+  // Split |packet| into fragments of at most |mtu| bytes that share one serialized copy of it.
+  static std::vector<std::unique_ptr<FragmentBuilder>> Fragment(
+      const BasePacketBuilder& packet, size_t mtu);
+
+  virtual size_t size() const override;
+
+  virtual void Serialize(BitInserter& it) const override;
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> buffer_;
+  size_t begin_;
+  size_t end_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
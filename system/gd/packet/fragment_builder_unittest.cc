@@ -0,0 +1,108 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/fragment_builder.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace packet {
+
+namespace {
+std::vector<uint8_t> count_bytes(size_t size) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i < size; i++) {
+    bytes.push_back(static_cast<uint8_t>(i));
+  }
+  return bytes;
+}
+}  // namespace
+
+TEST(FragmentBuilderTest, fragmentTest) {
+  auto payload = count_bytes(25);
+  RawBuilder packet(payload);
+
+  auto fragments = FragmentBuilder::Fragment(packet, 10);
+  ASSERT_EQ(3ul, fragments.size());
+  ASSERT_EQ(10ul, fragments[0]->size());
+  ASSERT_EQ(10ul, fragments[1]->size());
+  ASSERT_EQ(5ul, fragments[2]->size());
+
+  std::vector<uint8_t> bytes;
+  for (const auto& fragment : fragments) {
+    fragment->SerializeTo(bytes);
+  }
+  ASSERT_EQ(payload, bytes);
+}
+
+TEST(FragmentBuilderTest, fragmentExactMultipleTest) {
+  RawBuilder packet(count_bytes(20));
+  auto fragments = FragmentBuilder::Fragment(packet, 10);
+  ASSERT_EQ(2ul, fragments.size());
+  ASSERT_EQ(10ul, fragments[1]->size());
+  ASSERT_EQ(0ul, FragmentBuilder::Fragment(RawBuilder(), 10).size());
+}
+
+TEST(FragmentBuilderTest, fragmentsOutliveTheirPacketTest) {
+  auto payload = count_bytes(15);
+  auto packet = std::make_unique<RawBuilder>(payload);
+  auto fragments = FragmentBuilder::Fragment(*packet, 10);
+  packet.reset();
+
+  ASSERT_EQ(std::vector<uint8_t>(payload.begin() + 10, payload.end()), fragments[1]->SerializeToBytes());
+}
+
+TEST(FragmentBuilderTest, serializeAfterSavedBitsTest) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{0x12, 0x34});
+  FragmentBuilder fragment(buffer, 0, 2);
+
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  it.insert_bits(0x5, 4);
+  fragment.Serialize(it);
+  it.insert_bits(0xa, 4);
+
+  ASSERT_EQ((std::vector<uint8_t>{0x25, 0x41, 0xa3}), bytes);
+}
+
+TEST(FragmentBuilderTest, observerTest) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(count_bytes(8));
+  FragmentBuilder fragment(buffer, 2, 6);
+
+  std::vector<uint8_t> bytes;
+  std::vector<uint8_t> observed;
+  BitInserter it(bytes);
+  it.RegisterObserver(ByteObserver([&observed](uint8_t byte) { observed.push_back(byte); }, []() { return 0; }));
+  fragment.Serialize(it);
+  it.UnregisterObserver();
+
+  ASSERT_EQ((std::vector<uint8_t>{2, 3, 4, 5}), bytes);
+  ASSERT_EQ(bytes, observed);
+}
+
+TEST(FragmentBuilderTest, invalidRangeDeathTest) {
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(count_bytes(8));
+  ASSERT_DEATH(FragmentBuilder(buffer, 4, 9), "");
+  ASSERT_DEATH(FragmentBuilder(buffer, 5, 4), "");
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -30,6 +30,9 @@ Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t of
   for (auto& view : data) {
     end_ += view.size();
   }
+  if (!data_.empty() && std::next(data_.begin()) == data_.end()) {
+    contiguous_ = data_.front().data();
+  }
 }
 
 template <bool little_endian>
@@ -84,6 +87,7 @@ Iterator<little_endian>& Iterator<little_endian>::operator=(const Iterator<littl
     return *this;
   }
   this->data_ = itr.data_;
+  this->contiguous_ = itr.contiguous_;
   this->begin_ = itr.begin_;
   this->end_ = itr.end_;
   this->index_ = itr.index_;
@@ -128,9 +132,12 @@ uint8_t Iterator<little_endian>::operator*() const {
       index_,
       begin_,
       end_);
+  if (contiguous_ != nullptr) {
+    return contiguous_[index_];
+  }
   size_t index = index_;
 
-  for (auto view : data_) {
+  for (const auto& view : data_) {
     if (index < view.size()) {
       return view[index];
     }
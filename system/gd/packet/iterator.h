@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <forward_list>
 #include <memory>
 #include <type_traits>
@@ -83,6 +84,10 @@ class Iterator : public IteratorTraits {
     FixedWidthPODType extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
 
+    if (contiguous_ != nullptr && NumBytesRemaining() >= sizeof(FixedWidthPODType)) {
+      copy_contiguous(value_ptr, sizeof(FixedWidthPODType));
+      return extracted_value;
+    }
     for (size_t i = 0; i < sizeof(FixedWidthPODType); i++) {
       size_t index = (little_endian ? i : sizeof(FixedWidthPODType) - i - 1);
       value_ptr[index] = this->operator*();
@@ -94,6 +99,10 @@ class Iterator : public IteratorTraits {
   template <typename T, typename std::enable_if<std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>, int>::type = 0>
   T extract() {
     T extracted_value{};
+    if (contiguous_ != nullptr && NumBytesRemaining() >= CustomFieldFixedSizeInterface<T>::length()) {
+      copy_contiguous(extracted_value.data(), CustomFieldFixedSizeInterface<T>::length());
+      return extracted_value;
+    }
     for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
       size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
       extracted_value.data()[index] = this->operator*();
@@ -103,7 +112,23 @@ class Iterator : public IteratorTraits {
   }
 
  private:
+  // Copy the next |length| bytes to |value_ptr| in host order and advance past them. Only valid for contiguous data
+  // with at least |length| bytes remaining.
+  void copy_contiguous(uint8_t* value_ptr, size_t length) {
+    const uint8_t* src = contiguous_ + index_;
+    if (little_endian) {
+      std::memcpy(value_ptr, src, length);
+    } else {
+      for (size_t i = 0; i < length; i++) {
+        value_ptr[length - i - 1] = src[i];
+      }
+    }
+    index_ += length;
+  }
+
   std::forward_list<View> data_;
+  // Start of the data when it is a single fragment, so that reads do not have to walk the fragments
+  const uint8_t* contiguous_ = nullptr;
   size_t index_;
   size_t begin_;
   size_t end_;
@@ -243,5 +243,17 @@ TEST(BuilderBuilderTest, nestingTest) {
   std::vector<uint8_t> count_down{5, 4, 3, 2, 1, 0};
   ASSERT_EQ(*number_5->FinalPacket(), count_down);
 }
+
+TEST(BuilderBuilderTest, serializeAfterHeadroomTest) {
+  std::unique_ptr<BasePacketBuilder> innermost = NestedBuilder::Create(0);
+  std::unique_ptr<BasePacketBuilder> number_1 = NestedBuilder::CreateNested(std::move(innermost), 1);
+  std::unique_ptr<BasePacketBuilder> number_2 = NestedBuilder::CreateNested(std::move(number_1), 2);
+
+  std::vector<uint8_t> bytes{0xff};
+  number_2->SerializeTo(bytes);
+  std::vector<uint8_t> headroom_then_count_down{0xff, 2, 1, 0};
+  ASSERT_EQ(bytes, headroom_then_count_down);
+  ASSERT_GE(bytes.capacity(), 1 + number_2->size());
+}
 }  // namespace packet
 }  // namespace bluetooth
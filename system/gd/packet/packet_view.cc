@@ -26,7 +26,7 @@ namespace packet {
 template <bool little_endian>
 PacketView<little_endian>::PacketView(const std::forward_list<class View> fragments)
     : fragments_(fragments), length_(0) {
-  for (auto fragment : fragments_) {
+  for (const auto& fragment : fragments_) {
     length_ += fragment.size();
   }
 }
@@ -53,6 +53,9 @@ uint8_t PacketView<little_endian>::operator[](size_t index) const {
 template <bool little_endian>
 uint8_t PacketView<little_endian>::at(size_t index) const {
   ASSERT_LOG(index < length_, "Index %zu out of bounds", index);
+  if (std::next(fragments_.begin()) == fragments_.end()) {
+    return fragments_.front().data()[index];
+  }
   for (const auto& fragment : fragments_) {
     if (index < fragment.size()) {
       return fragment[index];
@@ -91,16 +94,20 @@ std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin,
 
 template <bool little_endian>
 PacketView<true> PacketView<little_endian>::GetLittleEndianSubview(size_t begin, size_t end) const {
-  return PacketView<true>(GetSubviewList(begin, end));
+  PacketView<true> subview(GetSubviewList(begin, end));
+  subview.SetTimestamp(timestamp_);
+  return subview;
 }
 
 template <bool little_endian>
 PacketView<false> PacketView<little_endian>::GetBigEndianSubview(size_t begin, size_t end) const {
-  return PacketView<false>(GetSubviewList(begin, end));
+  PacketView<false> subview(GetSubviewList(begin, end));
+  subview.SetTimestamp(timestamp_);
+  return subview;
 }
 
 template <bool little_endian>
-void PacketView<little_endian>::Append(PacketView to_add) {
+void PacketView<little_endian>::Append(const PacketView& to_add) {
   auto insertion_point = fragments_.begin();
   size_t remaining_length = length_;
   while (remaining_length > 0) {
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <forward_list>
 
@@ -50,12 +51,21 @@ class PacketView {
   PacketView<true> GetLittleEndianSubview(size_t begin, size_t end) const;
   PacketView<false> GetBigEndianSubview(size_t begin, size_t end) const;
 
+  // When the packet was received from the HAL, carried over to subviews. Unset unless the HCI layer set it.
+  std::chrono::steady_clock::time_point GetTimestamp() const {
+    return timestamp_;
+  }
+  void SetTimestamp(std::chrono::steady_clock::time_point timestamp) {
+    timestamp_ = timestamp;
+  }
+
  protected:
-  void Append(PacketView to_add);
+  void Append(const PacketView& to_add);
 
  private:
   std::forward_list<View> fragments_;
   size_t length_;
+  std::chrono::steady_clock::time_point timestamp_{};
 
   std::forward_list<View> GetSubviewList(size_t begin, size_t end) const;
 };
@@ -519,6 +519,15 @@ TEST(SubviewTest, subSubviewTest) {
   }
 }
 
+TEST(SubviewTest, timestampTest) {
+  PacketView<true> view({View(std::make_shared<const vector<uint8_t>>(count_all), 0, count_all.size())});
+  ASSERT_EQ(view.GetTimestamp(), std::chrono::steady_clock::time_point());
+  auto timestamp = std::chrono::steady_clock::now();
+  view.SetTimestamp(timestamp);
+  ASSERT_EQ(view.GetLittleEndianSubview(1, 5).GetTimestamp(), timestamp);
+  ASSERT_EQ(view.GetBigEndianSubview(1, 5).GetLittleEndianSubview(0, 2).GetTimestamp(), timestamp);
+}
+
 TEST_F(PacketViewMultiViewTest, sizeTest) {
   ASSERT_EQ(single_view.size(), multi_view.size());
 }
@@ -552,6 +561,25 @@ TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST_F(PacketViewMultiViewTest, extractTest) {
+  auto single_itr = single_view.begin();
+  auto multi_itr = multi_view.begin();
+  // Reads that straddle fragment boundaries in multi_view
+  ASSERT_EQ(single_itr.extract<uint16_t>(), multi_itr.extract<uint16_t>());
+  ASSERT_EQ(single_itr.extract<uint32_t>(), multi_itr.extract<uint32_t>());
+  ASSERT_EQ(single_itr.extract<uint64_t>(), multi_itr.extract<uint64_t>());
+  ASSERT_EQ(single_itr.extract<Address>(), multi_itr.extract<Address>());
+  ASSERT_EQ(single_itr.NumBytesRemaining(), multi_itr.NumBytesRemaining());
+}
+
+TEST_F(PacketViewMultiViewTest, extractSubrangeBoundsDeathTest) {
+  auto single_itr = single_view.begin().Subrange(2, 3);
+  ASSERT_EQ(0x02, single_itr.extract<uint8_t>());
+  ASSERT_DEATH(single_itr.extract<uint32_t>(), "");
+  ASSERT_EQ(0x0403, single_itr.extract<uint16_t>());
+  ASSERT_DEATH(single_itr.extract<uint8_t>(), "");
+}
+
 TEST_F(PacketViewMultiViewAppendTest, sizeTestAppend) {
   ASSERT_EQ(single_view.size(), multi_view.size());
 }
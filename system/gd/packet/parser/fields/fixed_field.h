@@ -45,8 +45,9 @@ class FixedField : public ScalarField {
 
   virtual void GenValidator(std::ostream& s) const override;
 
- private:
   virtual void GenValue(std::ostream& s) const = 0;
 
+ private:
+
   static int unique_id_;
 };
@@ -80,7 +80,9 @@ bool generate_cpp_headers_one_file(
       R"(
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <sstream>
 #include <string>
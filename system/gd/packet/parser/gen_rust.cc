@@ -66,6 +66,10 @@ pub struct TryFromError(&'static str);
 pub trait Packet {
   fn to_bytes(self) -> Bytes;
   fn to_vec(self) -> Vec<u8>;
+  // Size of the serialized packet, to reserve room for write_into
+  fn get_total_size(&self) -> usize;
+  // Appends the serialized packet to |buffer|, without allocating if it has get_total_size() bytes to spare
+  fn write_into(&self, buffer: &mut BytesMut);
 }
 
 )";
@@ -76,7 +80,8 @@ bool generate_rust_source_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    __attribute__((unused)) const std::string& root_namespace) {
+    __attribute__((unused)) const std::string& root_namespace,
+    bool generate_views) {
   auto gen_relative_path = input_file.lexically_relative(include_dir).parent_path();
 
   auto input_filename = input_file.filename().string().substr(0, input_file.filename().string().find(".pdl"));
@@ -227,6 +232,13 @@ bool generate_rust_source_one_file(
     out_file << "\n\n";
   }
 
+  if (generate_views) {
+    for (const auto& packet_def : decls.packet_defs_queue_) {
+      packet_def.second->GenRustView(out_file);
+      out_file << "\n\n";
+    }
+  }
+
   out_file.close();
   return true;
 }
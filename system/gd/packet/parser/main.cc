@@ -59,7 +59,8 @@ bool generate_rust_source_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    const std::string& root_namespace);
+    const std::string& root_namespace,
+    bool generate_views);
 
 bool parse_declarations_one_file(const std::filesystem::path& input_file, Declarations* declarations) {
   void* scanner;
@@ -125,6 +126,12 @@ void usage(const char* prog) {
 
   ofs << std::setw(24) << "--num_shards= ";
   ofs << "Number of shards per output pybind11 cc file." << std::endl;
+
+  ofs << std::setw(24) << "--rust ";
+  ofs << "Generate Rust packets instead of C++." << std::endl;
+
+  ofs << std::setw(24) << "--rust_views ";
+  ofs << "Generate Rust packets along with borrowed views over the packet bytes." << std::endl;
 }
 
 int main(int argc, const char** argv) {
@@ -136,6 +143,7 @@ int main(int argc, const char** argv) {
   // Number of shards per output pybind11 cc file
   size_t num_shards = 1;
   bool generate_rust = false;
+  bool generate_rust_views = false;
   bool generate_fuzzing = false;
   bool generate_tests = false;
   std::queue<std::filesystem::path> input_files;
@@ -145,6 +153,7 @@ int main(int argc, const char** argv) {
   const std::string arg_namespace = "--root_namespace=";
   const std::string arg_num_shards = "--num_shards=";
   const std::string arg_rust = "--rust";
+  const std::string arg_rust_views = "--rust_views";
   const std::string arg_fuzzing = "--fuzzing";
   const std::string arg_testing = "--testing";
   const std::string arg_source_root = "--source_root=";
@@ -168,6 +177,9 @@ int main(int argc, const char** argv) {
       root_namespace = arg.substr(arg_namespace.size());
     } else if (arg.find(arg_num_shards) == 0) {
       num_shards = std::stoul(arg.substr(arg_num_shards.size()));
+    } else if (arg == arg_rust_views) {
+      generate_rust = true;
+      generate_rust_views = true;
     } else if (arg.find(arg_rust) == 0) {
       generate_rust = true;
     } else if (arg.find(arg_fuzzing) == 0) {
@@ -196,7 +208,8 @@ int main(int argc, const char** argv) {
     }
     if (generate_rust) {
       std::cout << "generating rust" << std::endl;
-      if (!generate_rust_source_one_file(declarations, input_files.front(), include_dir, out_dir, root_namespace)) {
+      if (!generate_rust_source_one_file(
+              declarations, input_files.front(), include_dir, out_dir, root_namespace, generate_rust_views)) {
         std::cerr << "Didn't generate rust source for " << input_files.front() << std::endl;
         return 5;
       }
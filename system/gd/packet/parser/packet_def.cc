@@ -76,7 +76,10 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    // A parent view sliced from a deeper view may carry a validated depth that does not apply to this branch.
+    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false;";
+    s << " if (validated_depth_ > " << GetAncestors().size() << ") { validated_depth_ = " << GetAncestors().size()
+      << "; } }";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian> packet) ";
     s << " : PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian>(packet) { was_validated_ = false;}";
@@ -193,12 +196,20 @@ void PacketDef::GenValidator(std::ostream& s) const {
   }
 
   // Generate the private validator Validate().
-  // The method is overridden by all child classes.
+  // The method is overridden by all child classes. Each level records that it was validated in validated_depth_,
+  // which is carried over to child views, so that validating a child skips the levels its parent already checked.
+  const size_t depth = GetAncestors().size() + 1;
   s << "protected:" << std::endl;
   if (parent_ == nullptr) {
     s << "virtual bool Validate() const {" << std::endl;
+    s << "  if (validated_depth_ >= " << depth << ") {" << std::endl;
+    s << "    return true;" << std::endl;
+    s << "  }" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
+    s << "  if (validated_depth_ >= " << depth << ") {" << std::endl;
+    s << "    return true;" << std::endl;
+    s << "  }" << std::endl;
     s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
@@ -326,10 +337,12 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "\n";
   }
 
+  s << "validated_depth_ = " << depth << ";";
   s << "return true;";
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    s << "mutable size_t validated_depth_{0};\n";
   }
 }
 
@@ -387,11 +400,18 @@ void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, boo
     }
   }
 
-  GenSerialize(s);
-  s << "\n";
+  std::vector<FixedLayoutField> fixed_layout;
+  int fixed_size_bits = 0;
+  if (GetFixedLayout(&fixed_layout, &fixed_size_bits)) {
+    GenFixedLayoutSerialize(s, fixed_layout, fixed_size_bits);
+    s << "\n";
+  } else {
+    GenSerialize(s);
+    s << "\n";
 
-  GenSize(s);
-  s << "\n";
+    GenSize(s);
+    s << "\n";
+  }
 
   s << " protected:\n";
   GenBuilderConstructor(s);
@@ -419,6 +439,110 @@ void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, boo
   }
 }
 
+bool PacketDef::GetFixedLayout(std::vector<FixedLayoutField>* layout, int* size_bits) const {
+  if (!is_little_endian_ || fields_.HasPayloadOrBody()) {
+    return false;
+  }
+  auto defs = GetAncestors();
+  defs.push_back(this);
+
+  int offset = 0;
+  for (const auto* def : defs) {
+    if (def != this && !def->fields_.HasPayload()) {
+      return false;
+    }
+    if (def->fields_.GetFieldsAfterPayloadOrBody().size() != 0) {
+      return false;
+    }
+    std::vector<size_t> payload_size_fields;
+    for (const auto* field : def->fields_.GetFieldsBeforePayloadOrBody()) {
+      const auto& field_type = field->GetFieldType();
+      if (field_type == SizeField::kFieldType) {
+        const auto* sized_field = def->fields_.GetField(((SizeField*)field)->GetSizedFieldName());
+        if (sized_field == nullptr || sized_field->GetFieldType() != PayloadField::kFieldType) {
+          return false;
+        }
+        payload_size_fields.push_back(layout->size());
+        layout->push_back({field, offset, (const PayloadField*)sized_field, 0});
+        offset += field->GetSize().bits();
+        continue;
+      } else if (field_type == CustomFieldFixedSize::kFieldType) {
+        // Custom fields of a fixed size are copied as bytes
+        if (dynamic_cast<const CustomFieldFixedSize*>(field) == nullptr || offset % 8 != 0) {
+          return false;
+        }
+      } else if (
+          field_type != ScalarField::kFieldType && field_type != EnumField::kFieldType &&
+          field_type != FixedScalarField::kFieldType && field_type != FixedEnumField::kFieldType &&
+          field_type != ReservedField::kFieldType) {
+        return false;
+      }
+      auto field_size = field->GetSize();
+      if (field_size.empty() || field_size.has_dynamic()) {
+        return false;
+      }
+      if (field_type != CustomFieldFixedSize::kFieldType && field_size.bits() > 64) {
+        return false;
+      }
+      layout->push_back({field, offset, nullptr, 0});
+      offset += field_size.bits();
+    }
+    for (auto index : payload_size_fields) {
+      (*layout)[index].payload_bit_offset = offset;
+    }
+  }
+
+  if (offset % 8 != 0) {
+    return false;
+  }
+  *size_bits = offset;
+  return true;
+}
+
+void PacketDef::GenFixedLayoutSerialize(
+    std::ostream& s, const std::vector<FixedLayoutField>& layout, int size_bits) const {
+  s << "public:";
+  s << "static constexpr size_t kSize = " << size_bits / 8 << ";";
+  s << "virtual size_t size() const override { return kSize; }\n";
+
+  s << "virtual void Serialize(BitInserter& i) const override {";
+  s << "std::array<uint8_t, kSize> bytes{};";
+  for (const auto& entry : layout) {
+    const auto* field = entry.field;
+    const auto& field_type = field->GetFieldType();
+    int bits = field->GetSize().bits();
+    if (field_type == ReservedField::kFieldType) {
+      // Reserved bits are left zeroed
+      continue;
+    }
+    if (field_type == CustomFieldFixedSize::kFieldType) {
+      s << "std::memcpy(bytes.data() + " << entry.bit_offset / 8 << ", " << field->GetName() << "_.data(), "
+        << bits / 8 << ");";
+      continue;
+    }
+    if (field_type == SizeField::kFieldType) {
+      std::string payload_bytes = "kSize - " + std::to_string(entry.payload_bit_offset / 8);
+      std::string modifier = entry.payload->size_modifier_;
+      if (modifier != "") {
+        payload_bytes += " + " + modifier.substr(1);
+      }
+      s << "static_assert(" << payload_bytes << " < (static_cast<size_t>(1) << " << bits << "));";
+      s << "insert_at(static_cast<size_t>(" << payload_bytes << "), bytes.data(), " << entry.bit_offset << ", "
+        << bits << ");";
+      continue;
+    }
+    s << "insert_at(";
+    if (field_type == FixedScalarField::kFieldType || field_type == FixedEnumField::kFieldType) {
+      ((FixedField*)field)->GenValue(s);
+    } else {
+      s << field->GetName() << "_";
+    }
+    s << ", bytes.data(), " << entry.bit_offset << ", " << bits << ");";
+  }
+  s << "i.insert_bytes(bytes.data(), kSize);";
+  s << "}\n";
+}
+
 void PacketDef::GenTestingFromView(std::ostream& s) const {
   s << "#if defined(PACKET_FUZZ_TESTING) || defined(PACKET_TESTING) || defined(FUZZ_TARGET)\n";
 
@@ -1185,6 +1309,15 @@ void PacketDef::GenRustAccessStructImpls(std::ostream& s) const {
   s << "}\n";
 
   s << "fn to_vec(self) -> Vec<u8> { self.to_bytes().to_vec() }\n";
+
+  s << "fn get_total_size(&self) -> usize { self." << root_accessor << ".get_total_size() }\n";
+
+  s << "fn write_into(&self, buffer: &mut BytesMut) {";
+  s << " let mut packet = buffer.split_off(buffer.len());";
+  s << " packet.resize(self." << root_accessor << ".get_total_size(), 0);";
+  s << " self." << root_accessor << ".write_to(&mut packet);";
+  s << " buffer.unsplit(packet);";
+  s << "}\n";
   s << "}";
 
   s << "impl From<" << name_ << "Packet"
@@ -1460,6 +1593,140 @@ void PacketDef::GenRustBuilderTest(std::ostream& s) const {
   }
 }
 
+namespace {
+// Fields a view reads on demand: scalars and enums at a known offset from the start of the packet.
+bool IsRustViewField(const ParentDef* def, const PacketField* field) {
+  auto field_type = field->GetFieldType();
+  if (field_type != ScalarField::kFieldType && field_type != EnumField::kFieldType) {
+    return false;
+  }
+  return !def->GetOffsetForField(field->GetName(), false).empty();
+}
+}  // namespace
+
+void PacketDef::GenRustView(std::ostream& s) const {
+  auto lineage = GetAncestors();
+  lineage.push_back(this);
+
+  s << "#[derive(Debug, Clone, Copy)] ";
+  s << "pub struct " << name_ << "View<'a> { bytes: &'a [u8], }\n";
+
+  s << "impl<'a> " << name_ << "View<'a> {";
+  if (parent_ == nullptr) {
+    s << "pub fn parse(bytes: &'a [u8]) -> Result<Self> {";
+    s << "if !" << name_ << "Data::conforms(bytes) { return Err(Error::InvalidPacketError); }";
+    s << "Ok(Self { bytes })";
+    s << "}\n";
+  }
+  s << "pub fn bytes(&self) -> &'a [u8] { self.bytes }\n";
+
+  for (auto def : lineage) {
+    for (const auto field : def->fields_) {
+      if (!IsRustViewField(def, field)) {
+        continue;
+      }
+      auto start_field_offset = def->GetOffsetForField(field->GetName(), false);
+      auto end_field_offset = def->GetOffsetForField(field->GetName(), true);
+      // Unlike the eager parser, also check the bounds of fields smaller than a byte
+      auto wanted = (start_field_offset.bits() + field->GetSize().bits() + 7) / 8;
+      s << "pub fn get_" << field->GetName() << "(&self) -> Result<" << field->GetRustDataType() << "> {";
+      s << "let bytes = self.bytes;";
+      s << "if bytes.len() < " << wanted << " {";
+      s << " return Err(Error::InvalidLengthError{";
+      s << "    obj: \"" << def->name_ << "\".to_string(),";
+      s << "    field: \"" << field->GetName() << "\".to_string(),";
+      s << "    wanted: " << wanted << ",";
+      s << "    got: bytes.len()});";
+      s << "}";
+      field->GenRustGetter(s, start_field_offset, end_field_offset, def->name_);
+      s << "Ok(" << field->GetName() << ")";
+      s << "}\n";
+    }
+  }
+
+  auto payload_fields = fields_.GetFieldsWithTypes({
+      PayloadField::kFieldType,
+  });
+  if (payload_fields.HasPayload()) {
+    const auto* payload = static_cast<const PayloadField*>(payload_fields[0]);
+    const auto* size_field = payload->size_field_;
+    auto start_offset = GetOffsetForField(payload->GetName(), false);
+    auto end_offset = GetOffsetForField(payload->GetName(), true);
+    bool sized = size_field != nullptr && !GetOffsetForField(size_field->GetName(), false).empty();
+    bool until_end = size_field == nullptr && !end_offset.empty();
+
+    if (!start_offset.empty() && (sized || until_end)) {
+      s << "pub fn get_payload(&self) -> Result<&'a [u8]> {";
+      s << "let bytes = self.bytes;";
+      if (sized) {
+        auto size_start_offset = GetOffsetForField(size_field->GetName(), false);
+        auto size_end_offset = GetOffsetForField(size_field->GetName(), true);
+        size_field->GenBoundsCheck(s, size_start_offset, size_end_offset, name_);
+        size_field->GenRustGetter(s, size_start_offset, size_end_offset, name_);
+        payload->GenBoundsCheck(s, start_offset, end_offset, name_);
+        s << "Ok(&bytes[" << start_offset.bytes() << "..want_])";
+      } else {
+        s << "if bytes.len() < " << start_offset.bytes() + end_offset.bytes() << " {";
+        s << " return Err(Error::InvalidLengthError{";
+        s << "    obj: \"" << name_ << "\".to_string(),";
+        s << "    field: \"" << payload->GetName() << "\".to_string(),";
+        s << "    wanted: " << start_offset.bytes() + end_offset.bytes() << ",";
+        s << "    got: bytes.len()});";
+        s << "}";
+        if (end_offset.bytes() == 0) {
+          s << "Ok(&bytes[" << start_offset.bytes() << "..])";
+        } else {
+          s << "Ok(&bytes[" << start_offset.bytes() << "..bytes.len() - " << end_offset.bytes() << "])";
+        }
+      }
+      s << "}\n";
+    }
+  }
+  s << "}\n";
+
+  if (parent_ == nullptr) {
+    return;
+  }
+
+  // A child view is only handed out once the constraints of the whole lineage hold, which the views of the
+  // ancestors can check lazily as long as every constrained field is readable from a view.
+  std::vector<std::string> checks;
+  for (const auto& constraint : parent_constraints_) {
+    const ParentDef* owner = nullptr;
+    const PacketField* field = nullptr;
+    for (auto ancestor : GetAncestors()) {
+      field = ancestor->fields_.GetField(constraint.first);
+      if (field != nullptr) {
+        owner = ancestor;
+        break;
+      }
+    }
+    if (field == nullptr || !IsRustViewField(owner, field)) {
+      return;
+    }
+    std::string value;
+    if (field->GetFieldType() == ScalarField::kFieldType) {
+      value = std::to_string(std::get<int64_t>(constraint.second));
+    } else {
+      auto constant = std::get<std::string>(constraint.second);
+      constant = constant.substr(constant.find("::") + 2, std::string::npos);
+      value = field->GetDataType() + "::" + util::ConstantCaseToCamelCase(constant);
+    }
+    checks.push_back("matches!(parent.get_" + field->GetName() + "()?, " + value + ")");
+  }
+
+  s << "impl<'a> TryFrom<" << parent_->name_ << "View<'a>> for " << name_ << "View<'a> {";
+  s << "type Error = Error;";
+  s << "fn try_from(parent: " << parent_->name_ << "View<'a>) -> Result<Self> {";
+  for (const auto& check : checks) {
+    s << "if !" << check << " { return Err(Error::InvalidPacketError); }";
+  }
+  s << "if !" << name_ << "Data::conforms(parent.bytes) { return Err(Error::InvalidPacketError); }";
+  s << "Ok(Self { bytes: parent.bytes })";
+  s << "}";
+  s << "}\n";
+}
+
 void PacketDef::GenRustDef(std::ostream& s) const {
   GenRustChildEnums(s);
   GenRustStructDeclarations(s);
@@ -22,6 +22,7 @@
 #include "enum_def.h"
 #include "field_list.h"
 #include "fields/packet_field.h"
+#include "fields/payload_field.h"
 #include "parent_def.h"
 
 class PacketDef : public ParentDef {
@@ -66,6 +67,21 @@ class PacketDef : public ParentDef {
 
   void GenTestingFromView(std::ostream& s) const;
 
+  struct FixedLayoutField {
+    const PacketField* field;
+    int bit_offset;
+    // Payload sized by a size field, and its offset
+    const PayloadField* payload;
+    int payload_bit_offset;
+  };
+
+  // Lays out the fields of the packet and of its ancestors when its builder always serializes the same number of
+  // bytes. Returns false if a field has no fixed size or is not held by the builder.
+  bool GetFixedLayout(std::vector<FixedLayoutField>* layout, int* size_bits) const;
+
+  // Serializes all the fields into a buffer of the packet size, which is inserted at once
+  void GenFixedLayoutSerialize(std::ostream& s, const std::vector<FixedLayoutField>& layout, int size_bits) const;
+
   void GenRustChildEnums(std::ostream& s) const;
 
   void GenRustStructDeclarations(std::ostream& s) const;
@@ -83,4 +99,7 @@ class PacketDef : public ParentDef {
   void GenRustBuilderTest(std::ostream& s) const;
 
   void GenRustDef(std::ostream& s) const;
+
+  // Borrowed view over the serialized packet with lazy field getters (--rust_views)
+  void GenRustView(std::ostream& s) const;
 };
@@ -94,6 +94,18 @@ TEST(GeneratedPacketTest, testChildTwoTwoThree) {
   ASSERT_TRUE(grandchild_view.IsValid());
 }
 
+TEST(GeneratedPacketTest, testValidatedParentSlicedFromSibling) {
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(child_two_two_three);
+  ChildTwoTwoView child_view = ChildTwoTwoView::Create(ParentTwoView::Create(PacketView<kLittleEndian>(packet_bytes)));
+  ASSERT_TRUE(child_view.IsValid());
+
+  // The validation of ChildTwoTwo must not be taken for its sibling
+  ParentTwoView sliced_parent = child_view;
+  ASSERT_TRUE(sliced_parent.IsValid());
+  ChildTwoThreeView sibling_view = ChildTwoThreeView::Create(sliced_parent);
+  ASSERT_FALSE(sibling_view.IsValid());
+}
+
 TEST(GeneratedPacketTest, testChild) {
   uint16_t field_name = 0xa2a1;
   uint8_t footer = 0xb1;
@@ -1965,6 +1977,28 @@ TEST(GeneratedPacketTest, testToStringOneFixedTypesStruct) {
       view.ToString());
 }
 
+vector<uint8_t> child_with_fixed_layout = {0x12, 0x03, 0x05, 0x34, 0x12};
+
+TEST(GeneratedPacketTest, testChildWithFixedLayout) {
+  static_assert(ChildWithFixedLayoutBuilder::kSize == 5);
+  auto packet = ChildWithFixedLayoutBuilder::Create(0x5, 0x1234);
+  ASSERT_EQ(child_with_fixed_layout.size(), packet->size());
+
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  packet->Serialize(it);
+
+  ASSERT_EQ(child_with_fixed_layout, *packet_bytes);
+
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  auto parent_view = ParentWithPayloadSizeView::Create(packet_bytes_view);
+  ASSERT_TRUE(parent_view.IsValid());
+  auto view = ChildWithFixedLayoutView::Create(parent_view);
+  ASSERT_TRUE(view.IsValid());
+  ASSERT_EQ(0x5, view.GetLowFour());
+  ASSERT_EQ(0x1234, view.GetTwoBytes());
+}
+
 }  // namespace parser
 }  // namespace packet
 }  // namespace bluetooth
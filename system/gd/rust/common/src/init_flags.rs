@@ -372,19 +372,35 @@ init_flags!(
         device_iot_config_logging,
         dynamic_avrcp_version_enhancement = true,
         finite_att_timeout = true,
+        gatt_client_parallel_discovery,
+        gatt_client_pipelining,
         gatt_robust_caching_client = true,
         gatt_robust_caching_server,
+        gd_config_cache_snapshot_reads,
         gd_core,
+        gd_controller_snapshot,
+        gd_data_path_thread,
+        gd_hal_batched_receive,
+        gd_hal_fast_receive,
+        gd_hal_snoop_logger_async,
+        gd_hal_snoop_logger_mmap_ring,
         gd_hal_snoop_logger_socket = true,
         gd_hal_snoop_logger_filtering = true,
+        gd_hal_zero_copy_receive,
+        gd_hci_command_pipelining,
         gd_l2cap,
+        gd_l2cap_weighted_fair_scheduler,
+        gd_le_scanning_software_filter,
         gd_link_policy,
+        gd_module_parallel_start,
         gd_remote_name_request,
         gd_rust,
+        gd_storage_config_journal,
         hci_adapter: i32,
         hfp_dynamic_version = true,
         irk_rotation,
         leaudio_targeted_announcement_reconnection_mode = true,
+        osi_slab_allocator,
         pass_phy_update_callback = true,
         pbap_pse_dynamic_version_upgrade = false,
         periodic_advertising_adi = true,
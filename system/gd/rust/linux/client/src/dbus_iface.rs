@@ -589,6 +589,11 @@ impl IScannerCallback for IScannerCallbackDBus {
         dbus_generated!()
     }
 
+    #[dbus_method("OnScanResults")]
+    fn on_scan_results(&mut self, scan_results: Vec<ScanResult>) {
+        dbus_generated!()
+    }
+
     #[dbus_method("OnAdvertisementFound")]
     fn on_advertisement_found(&mut self, scanner_id: u8, scan_result: ScanResult) {
         dbus_generated!()
@@ -1300,6 +1305,11 @@ impl IBluetoothGatt for BluetoothGattDBus {
         dbus_generated!()
     }
 
+    #[dbus_method("SetScanResultBatching")]
+    fn set_scan_result_batching(&mut self, _callback_id: u32, _enabled: bool) -> bool {
+        dbus_generated!()
+    }
+
     #[dbus_method("RegisterScanner")]
     fn register_scanner(&mut self, callback_id: u32) -> Uuid128Bit {
         dbus_generated!()
@@ -877,6 +877,10 @@ pub fn dbus_proxy_obj(attr: TokenStream, item: TokenStream) -> TokenStream {
             fn unregister(&mut self, id: u32) -> bool {
                 self.disconnect_watcher.lock().unwrap().remove(self.remote.clone(), id)
             }
+
+            fn pending_calls(&self) -> usize {
+                self.cb_futures.lock().unwrap().len()
+            }
         }
 
         impl DBusArg for Box<dyn #trait_ + Send> {
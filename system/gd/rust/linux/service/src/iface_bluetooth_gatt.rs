@@ -305,6 +305,11 @@ impl IScannerCallback for ScannerCallbackDBus {
         dbus_generated!()
     }
 
+    #[dbus_method("OnScanResults")]
+    fn on_scan_results(&mut self, scan_results: Vec<ScanResult>) {
+        dbus_generated!()
+    }
+
     #[dbus_method("OnAdvertisementFound")]
     fn on_advertisement_found(&mut self, scanner_id: u8, scan_result: ScanResult) {
         dbus_generated!()
@@ -614,6 +619,11 @@ impl IBluetoothGatt for IBluetoothGattDBus {
         dbus_generated!()
     }
 
+    #[dbus_method("SetScanResultBatching")]
+    fn set_scan_result_batching(&mut self, callback_id: u32, enabled: bool) -> bool {
+        dbus_generated!()
+    }
+
     #[dbus_method("RegisterScanner")]
     fn register_scanner(&mut self, callback_id: u32) -> Uuid128Bit {
         dbus_generated!()
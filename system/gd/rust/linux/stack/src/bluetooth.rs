@@ -8,7 +8,7 @@ use bt_topshim::btif::{
     Uuid, Uuid128Bit,
 };
 use bt_topshim::{
-    metrics,
+    boundary, metrics,
     profiles::gatt::GattStatus,
     profiles::hid_host::{
         BthhConnectionState, BthhHidInfo, BthhProtocolMode, BthhReportType, BthhStatus,
@@ -1167,6 +1167,9 @@ impl BtifBluetoothCallbacks for Bluetooth {
         match self.state {
             BtState::Off => {
                 self.properties.clear();
+                for stats in boundary::snapshot() {
+                    debug!("Topshim callback {}", stats);
+                }
                 match self.remove_pid_file() {
                     Err(err) => warn!("remove_pid_file() error: {}", err),
                     _ => (),
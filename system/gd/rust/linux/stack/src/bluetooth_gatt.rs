@@ -32,10 +32,11 @@ use num_traits::cast::{FromPrimitive, ToPrimitive};
 use num_traits::clamp;
 use rand::rngs::SmallRng;
 use rand::{RngCore, SeedableRng};
-use std::collections::{HashMap, HashSet};
+use std::collections::{HashMap, HashSet, VecDeque};
 use std::convert::TryInto;
 use std::sync::{Arc, Mutex, MutexGuard};
 use tokio::sync::mpsc::Sender;
+use tokio::time::Duration;
 
 struct Client {
     id: Option<i32>,
@@ -374,6 +375,12 @@ pub trait IBluetoothGatt {
     /// Unregisters an LE scanner callback identified by the given id.
     fn unregister_scanner_callback(&mut self, callback_id: u32) -> bool;
 
+    /// Makes the scanner callback identified by the given id receive scan results in batches
+    /// through `IScannerCallback::on_scan_results` rather than one `on_scan_result` each.
+    ///
+    /// Returns false if there is no such callback.
+    fn set_scan_result_batching(&mut self, callback_id: u32, enabled: bool) -> bool;
+
     /// Registers LE scanner.
     ///
     /// `callback_id`: The callback to receive updates about the scanner state.
@@ -1097,6 +1104,15 @@ pub trait IScannerCallback: RPCProxy {
     /// detected while in RSSI range, use on_advertisement_found and on_advertisement_lost below.
     fn on_scan_result(&mut self, scan_result: ScanResult);
 
+    /// Batched form of `on_scan_result`, for callbacks that enabled it with
+    /// `IBluetoothGatt::set_scan_result_batching`. Carries the results seen since the previous
+    /// batch, oldest first.
+    fn on_scan_results(&mut self, scan_results: Vec<ScanResult>) {
+        for scan_result in scan_results {
+            self.on_scan_result(scan_result);
+        }
+    }
+
     /// When an LE advertisement matching aggregate filters is found. The criteria of
     /// how a device is considered found is specified by ScanFilter.
     fn on_advertisement_found(&mut self, scanner_id: u8, scan_result: ScanResult);
@@ -1170,7 +1186,7 @@ pub struct ScanSettings {
 }
 
 /// Represents scan result
-#[derive(Debug)]
+#[derive(Debug, Clone)]
 pub struct ScanResult {
     pub name: String,
     pub address: String,
@@ -1327,6 +1343,76 @@ impl GattAsyncIntf {
 }
 
 /// Implementation of the GATT API (IBluetoothGatt).
+/// How long scan results are held for the callbacks that take them in batches.
+const SCAN_RESULT_BATCH_WINDOW: Duration = Duration::from_millis(100);
+/// Scan results held per batched callback at most. Beyond that the oldest ones are dropped.
+const SCAN_RESULT_BATCH_MAX_SIZE: usize = 256;
+/// Batches a callback may leave unanswered before the next ones are held back.
+const SCAN_RESULT_BATCH_MAX_PENDING_CALLS: usize = 2;
+
+#[derive(Default)]
+struct ScanResultBatch {
+    scan_results: VecDeque<ScanResult>,
+    dropped: usize,
+}
+
+/// Scan results held for the scanner callbacks that enabled batching, keyed by callback id.
+#[derive(Default)]
+struct ScanResultBatches {
+    batches: HashMap<u32, ScanResultBatch>,
+    flush_scheduled: bool,
+}
+
+impl ScanResultBatches {
+    fn set_enabled(&mut self, callback_id: u32, enabled: bool) {
+        if enabled {
+            self.batches.entry(callback_id).or_default();
+        } else {
+            self.batches.remove(&callback_id);
+        }
+    }
+
+    fn is_enabled(&self, callback_id: u32) -> bool {
+        self.batches.contains_key(&callback_id)
+    }
+
+    fn push(&mut self, callback_id: u32, scan_result: ScanResult) {
+        if let Some(batch) = self.batches.get_mut(&callback_id) {
+            if batch.scan_results.len() == SCAN_RESULT_BATCH_MAX_SIZE {
+                batch.scan_results.pop_front();
+                batch.dropped += 1;
+            }
+            batch.scan_results.push_back(scan_result);
+        }
+    }
+
+    /// Returns true once when results are waiting and no flush is scheduled yet.
+    fn needs_flush(&mut self) -> bool {
+        if self.flush_scheduled || self.batches.values().all(|b| b.scan_results.is_empty()) {
+            return false;
+        }
+        self.flush_scheduled = true;
+        true
+    }
+
+    /// Takes the batch of a callback, unless it has `pending_calls` unanswered batches already.
+    /// A slow callback keeps its most recent results until it catches up.
+    fn take(&mut self, callback_id: u32, pending_calls: usize) -> Option<Vec<ScanResult>> {
+        if pending_calls >= SCAN_RESULT_BATCH_MAX_PENDING_CALLS {
+            return None;
+        }
+        let batch = self.batches.get_mut(&callback_id)?;
+        if batch.scan_results.is_empty() {
+            return None;
+        }
+        if batch.dropped > 0 {
+            debug!("Dropped {} scan results for slow callback {}", batch.dropped, callback_id);
+            batch.dropped = 0;
+        }
+        Some(batch.scan_results.drain(..).collect())
+    }
+}
+
 pub struct BluetoothGatt {
     intf: Arc<Mutex<BluetoothInterface>>,
     // TODO(b/254870880): Wrapping in an `Option` makes the code unnecessarily verbose. Find a way
@@ -1339,6 +1425,7 @@ pub struct BluetoothGatt {
     server_context_map: ServerContextMap,
     reliable_queue: HashSet<String>,
     scanner_callbacks: Callbacks<dyn IScannerCallback + Send>,
+    scan_result_batches: ScanResultBatches,
     scanners: Arc<Mutex<ScannersMap>>,
     scan_suspend_mode: SuspendMode,
     paused_scanner_ids: Vec<u8>,
@@ -1353,6 +1440,8 @@ pub struct BluetoothGatt {
     small_rng: SmallRng,
 
     gatt_async: Arc<tokio::sync::Mutex<GattAsyncIntf>>,
+
+    tx: Sender<Message>,
 }
 
 impl BluetoothGatt {
@@ -1371,6 +1460,7 @@ impl BluetoothGatt {
             server_context_map: ServerContextMap::new(tx.clone()),
             reliable_queue: HashSet::new(),
             scanner_callbacks: Callbacks::new(tx.clone(), Message::ScannerCallbackDisconnected),
+            scan_result_batches: ScanResultBatches::default(),
             scanners: scanners.clone(),
             scan_suspend_mode: SuspendMode::Normal,
             paused_scanner_ids: Vec::new(),
@@ -1386,6 +1476,7 @@ impl BluetoothGatt {
                 async_helper_msft_adv_monitor_remove,
                 async_helper_msft_adv_monitor_enable,
             })),
+            tx,
         }
     }
 
@@ -1491,9 +1582,40 @@ impl BluetoothGatt {
             self.unregister_scanner(scanner_id);
         }
 
+        self.scan_result_batches.set_enabled(callback_id, false);
         self.scanner_callbacks.remove_callback(callback_id)
     }
 
+    fn schedule_scan_result_flush(&mut self) {
+        if !self.scan_result_batches.needs_flush() {
+            return;
+        }
+        let tx = self.tx.clone();
+        tokio::spawn(async move {
+            tokio::time::sleep(SCAN_RESULT_BATCH_WINDOW).await;
+            let _ = tx.send(Message::ScanResultBatchFlush).await;
+        });
+    }
+
+    /// Sends the scan results held for the batched callbacks, one D-Bus call per callback.
+    pub fn flush_scan_result_batches(&mut self) {
+        self.scan_result_batches.flush_scheduled = false;
+        let callback_ids: Vec<u32> = self.scan_result_batches.batches.keys().cloned().collect();
+        for callback_id in callback_ids {
+            let callback = match self.scanner_callbacks.get_by_id_mut(callback_id) {
+                Some(callback) => callback,
+                None => continue,
+            };
+            if let Some(scan_results) =
+                self.scan_result_batches.take(callback_id, callback.pending_calls())
+            {
+                callback.on_scan_results(scan_results);
+            }
+        }
+        // Come back for the callbacks that were held back
+        self.schedule_scan_result_flush();
+    }
+
     /// Set the suspend mode.
     pub fn set_scan_suspend_mode(&mut self, suspend_mode: SuspendMode) {
         if suspend_mode != self.scan_suspend_mode {
@@ -1624,7 +1746,6 @@ impl BluetoothGatt {
 
         let gatt_async = self.gatt_async.clone();
         let scanners = self.scanners.clone();
-        let is_msft_supported = self.is_msft_supported();
 
         tokio::spawn(async move {
             // The three operations below (monitor add, monitor enable, update scan) happen one
@@ -1635,39 +1756,37 @@ impl BluetoothGatt {
             // handling callbacks.
             let mut gatt_async = gatt_async.lock().await;
 
-            // Add and enable the monitor filter only when the MSFT extension is supported.
-            if is_msft_supported {
-                if let Some(filter) = filter {
-                    let monitor_handle =
-                        match gatt_async.msft_adv_monitor_add((&filter).into()).await {
-                            Ok((handle, 0)) => handle,
-                            _ => {
-                                log::error!("Error adding advertisement monitor");
-                                return;
-                            }
-                        };
-
-                    if let Some(scanner) =
-                        Self::find_scanner_by_id(&mut scanners.lock().unwrap(), scanner_id)
-                    {
-                        // The monitor handle is needed in stop_scan().
-                        scanner.monitor_handle = Some(monitor_handle);
+            // The monitor is offloaded to the controller when it supports the MSFT extension and
+            // has a free monitor slot, libbluetooth matches it on the host otherwise.
+            if let Some(filter) = filter {
+                let monitor_handle = match gatt_async.msft_adv_monitor_add((&filter).into()).await {
+                    Ok((handle, 0)) => handle,
+                    _ => {
+                        log::error!("Error adding advertisement monitor");
+                        return;
                     }
+                };
 
-                    log::debug!("Added adv monitor handle = {}", monitor_handle);
-                }
-
-                if !gatt_async
-                    .msft_adv_monitor_enable(!has_active_unfiltered_scanner)
-                    .await
-                    .map_or(false, |status| status == 0)
+                if let Some(scanner) =
+                    Self::find_scanner_by_id(&mut scanners.lock().unwrap(), scanner_id)
                 {
-                    // TODO(b/266752123):
-                    // Intel controller throws "Command Disallowed" error if we tried to enable/disable
-                    // filter but it's already at the same state. This is harmless but we can improve
-                    // the state machine to avoid calling enable/disable if it's already at that state
-                    log::error!("Error updating Advertisement Monitor enable");
+                    // The monitor handle is needed in stop_scan().
+                    scanner.monitor_handle = Some(monitor_handle);
                 }
+
+                log::debug!("Added adv monitor handle = {}", monitor_handle);
+            }
+
+            if !gatt_async
+                .msft_adv_monitor_enable(!has_active_unfiltered_scanner)
+                .await
+                .map_or(false, |status| status == 0)
+            {
+                // TODO(b/266752123):
+                // Intel controller throws "Command Disallowed" error if we tried to enable/disable
+                // filter but it's already at the same state. This is harmless but we can improve
+                // the state machine to avoid calling enable/disable if it's already at that state
+                log::error!("Error updating Advertisement Monitor enable");
             }
 
             gatt_async.update_scan().await;
@@ -1863,6 +1982,18 @@ impl IBluetoothGatt for BluetoothGatt {
         self.remove_scanner_callback(callback_id)
     }
 
+    fn set_scan_result_batching(&mut self, callback_id: u32, enabled: bool) -> bool {
+        if self.scanner_callbacks.get_by_id(callback_id).is_none() {
+            return false;
+        }
+        if !enabled {
+            // Hand over what was held before switching back to one call per result
+            self.flush_scan_result_batches();
+        }
+        self.scan_result_batches.set_enabled(callback_id, enabled);
+        true
+    }
+
     fn register_scanner(&mut self, callback_id: u32) -> Uuid128Bit {
         let mut bytes: [u8; 16] = [0; 16];
         self.small_rng.fill_bytes(&mut bytes);
@@ -1949,7 +2080,6 @@ impl IBluetoothGatt for BluetoothGatt {
             .any(|(_uuid, scanner)| scanner.is_active && scanner.filter.is_none());
 
         let gatt_async = self.gatt_async.clone();
-        let is_msft_supported = self.is_msft_supported();
         tokio::spawn(async move {
             // The two operations below (monitor remove, update scan) happen one after another, and
             // cannot be interleaved with other GATT async operations.
@@ -1957,19 +2087,16 @@ impl IBluetoothGatt for BluetoothGatt {
             // at the end of this block.
             let mut gatt_async = gatt_async.lock().await;
 
-            // Remove and disable the monitor only when the MSFT extension is supported.
-            if is_msft_supported {
-                if let Some(handle) = monitor_handle {
-                    let _res = gatt_async.msft_adv_monitor_remove(handle).await;
-                }
+            if let Some(handle) = monitor_handle {
+                let _res = gatt_async.msft_adv_monitor_remove(handle).await;
+            }
 
-                if !gatt_async
-                    .msft_adv_monitor_enable(!has_active_unfiltered_scanner)
-                    .await
-                    .map_or(false, |status| status == 0)
-                {
-                    log::error!("Error updating Advertisement Monitor enable");
-                }
+            if !gatt_async
+                .msft_adv_monitor_enable(!has_active_unfiltered_scanner)
+                .await
+                .map_or(false, |status| status == 0)
+            {
+                log::error!("Error updating Advertisement Monitor enable");
             }
 
             gatt_async.update_scan().await;
@@ -4094,25 +4221,33 @@ impl BtifGattScannerCallbacks for BluetoothGatt {
         periodic_adv_int: u16,
         adv_data: Vec<u8>,
     ) {
-        self.scanner_callbacks.for_all_callbacks(|callback| {
-            callback.on_scan_result(ScanResult {
-                name: adv_parser::extract_name(adv_data.as_slice()),
-                address: address.to_string(),
-                addr_type,
-                event_type,
-                primary_phy,
-                secondary_phy,
-                advertising_sid,
-                tx_power,
-                rssi,
-                periodic_adv_int,
-                flags: adv_parser::extract_flags(adv_data.as_slice()),
-                service_uuids: adv_parser::extract_service_uuids(adv_data.as_slice()),
-                service_data: adv_parser::extract_service_data(adv_data.as_slice()),
-                manufacturer_data: adv_parser::extract_manufacturer_data(adv_data.as_slice()),
-                adv_data: adv_data.clone(),
-            });
+        let scan_result = ScanResult {
+            name: adv_parser::extract_name(adv_data.as_slice()),
+            address: address.to_string(),
+            addr_type,
+            event_type,
+            primary_phy,
+            secondary_phy,
+            advertising_sid,
+            tx_power,
+            rssi,
+            periodic_adv_int,
+            flags: adv_parser::extract_flags(adv_data.as_slice()),
+            service_uuids: adv_parser::extract_service_uuids(adv_data.as_slice()),
+            service_data: adv_parser::extract_service_data(adv_data.as_slice()),
+            manufacturer_data: adv_parser::extract_manufacturer_data(adv_data.as_slice()),
+            adv_data,
+        };
+
+        let batches = &mut self.scan_result_batches;
+        self.scanner_callbacks.for_all_callbacks_with_id(|callback_id, callback| {
+            if batches.is_enabled(callback_id) {
+                batches.push(callback_id, scan_result.clone());
+            } else {
+                callback.on_scan_result(scan_result.clone());
+            }
         });
+        self.schedule_scan_result_flush();
     }
 
     fn on_track_adv_found_lost(&mut self, track_adv_info: RustAdvertisingTrackInfo) {
@@ -4579,4 +4714,66 @@ mod tests {
         assert!(found.is_some());
         assert_eq!(4, found.unwrap());
     }
+
+    fn scan_result_with_rssi(rssi: i8) -> ScanResult {
+        ScanResult {
+            name: String::new(),
+            address: String::from("11:22:33:44:55:66"),
+            addr_type: 0,
+            event_type: 0,
+            primary_phy: 0,
+            secondary_phy: 0,
+            advertising_sid: 0,
+            tx_power: 0,
+            rssi,
+            periodic_adv_int: 0,
+            flags: 0,
+            service_uuids: vec![],
+            service_data: HashMap::new(),
+            manufacturer_data: HashMap::new(),
+            adv_data: vec![],
+        }
+    }
+
+    #[test]
+    fn test_scan_result_batches() {
+        let mut batches = ScanResultBatches::default();
+        assert!(!batches.needs_flush());
+
+        // Results of callbacks without batching are not held
+        batches.push(1, scan_result_with_rssi(0));
+        assert!(!batches.needs_flush());
+
+        batches.set_enabled(2, true);
+        for rssi in 0..3 {
+            batches.push(2, scan_result_with_rssi(rssi));
+        }
+        assert!(batches.needs_flush());
+        // Only one flush is scheduled at a time
+        assert!(!batches.needs_flush());
+
+        // Held back while the callback is behind
+        assert!(batches.take(2, SCAN_RESULT_BATCH_MAX_PENDING_CALLS).is_none());
+
+        let taken = batches.take(2, 0).unwrap();
+        assert_eq!(vec![0, 1, 2], taken.iter().map(|r| r.rssi).collect::<Vec<i8>>());
+        assert!(batches.take(2, 0).is_none());
+    }
+
+    #[test]
+    fn test_scan_result_batches_drop_oldest() {
+        let mut batches = ScanResultBatches::default();
+        batches.set_enabled(1, true);
+        for i in 0..SCAN_RESULT_BATCH_MAX_SIZE + 2 {
+            batches.push(1, scan_result_with_rssi((i % 100) as i8));
+        }
+
+        let taken = batches.take(1, 0).unwrap();
+        assert_eq!(SCAN_RESULT_BATCH_MAX_SIZE, taken.len());
+        assert_eq!(2, taken[0].rssi);
+
+        batches.set_enabled(1, false);
+        batches.push(1, scan_result_with_rssi(0));
+        assert!(batches.take(1, 0).is_none());
+    }
 }
@@ -77,4 +77,11 @@ impl<T: RPCProxy + Send + ?Sized> Callbacks<T> {
             f(callback);
         }
     }
+
+    /// Applies the given function on all active callbacks along with their ids.
+    pub fn for_all_callbacks_with_id<F: FnMut(u32, &mut Box<T>)>(&mut self, mut f: F) {
+        for (id, ref mut callback) in self.callbacks.iter_mut() {
+            f(*id, callback);
+        }
+    }
 }
@@ -101,6 +101,7 @@ pub enum Message {
 
     // Scanner related
     ScannerCallbackDisconnected(u32),
+    ScanResultBatchFlush,
 
     // Advertising related
     AdvertiserCallbackDisconnected(u32),
@@ -305,6 +306,10 @@ impl Stack {
                     bluetooth_gatt.lock().unwrap().remove_scanner_callback(id);
                 }
 
+                Message::ScanResultBatchFlush => {
+                    bluetooth_gatt.lock().unwrap().flush_scan_result_batches();
+                }
+
                 Message::AdvertiserCallbackDisconnected(id) => {
                     bluetooth_gatt.lock().unwrap().remove_adv_callback(id);
                 }
@@ -390,6 +395,11 @@ pub trait RPCProxy {
         false
     }
 
+    /// Returns the number of calls to the remote object still waiting for their reply.
+    fn pending_calls(&self) -> usize {
+        0
+    }
+
     /// Makes this object available for remote call.
     fn export_for_rpc(self: Box<Self>) {}
 }
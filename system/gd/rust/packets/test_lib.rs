@@ -48,6 +48,8 @@ pub mod test_packets {
 #[cfg(test)]
 pub mod test {
     use crate::test_packets::*;
+    use bytes::{BufMut, BytesMut};
+    use std::convert::TryFrom;
 
     #[test]
     fn test_invalid_enum_field_value() {
@@ -105,4 +107,34 @@ pub mod test {
         let res = GrandParentPacket::parse(&input);
         assert!(res.is_err());
     }
+
+    #[test]
+    fn test_view_fields_and_specialization() {
+        let input = [0x1, 0x2, 0x3, 0x1, 0x1, 0x2, 0x3];
+        let grand_parent = GrandParentView::parse(&input).unwrap();
+        assert_eq!(grand_parent.get_field_three().unwrap(), Number::Three);
+        assert_eq!(grand_parent.get_payload().unwrap(), &input[4..]);
+
+        let parent = ParentView::try_from(grand_parent).unwrap();
+        assert!(ChildThreeFourView::try_from(parent).is_err());
+        let child = ChildOneTwoView::try_from(parent).unwrap();
+        assert_eq!(child.get_field_y().unwrap(), Number::Three);
+    }
+
+    #[test]
+    fn test_view_invalid_payload_size() {
+        // Size 2, have 1.
+        let input = [0x2, 0x0];
+        let view = TestPayloadSizeView::parse(&input).unwrap();
+        assert!(view.get_payload().is_err());
+    }
+
+    #[test]
+    fn test_write_into_appends() {
+        let packet = AddCommandBuilder {}.build();
+        let mut buffer = BytesMut::with_capacity(1 + packet.get_total_size());
+        buffer.put_u8(0xff);
+        packet.write_into(&mut buffer);
+        assert_eq!(&buffer[..], &[0xff, 0x04, 0x00]);
+    }
 }
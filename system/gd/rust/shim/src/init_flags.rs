@@ -24,13 +24,28 @@ mod ffi {
         fn device_iot_config_logging_is_enabled() -> bool;
         fn dynamic_avrcp_version_enhancement_is_enabled() -> bool;
         fn finite_att_timeout_is_enabled() -> bool;
+        fn gatt_client_parallel_discovery_is_enabled() -> bool;
+        fn gatt_client_pipelining_is_enabled() -> bool;
         fn gatt_robust_caching_client_is_enabled() -> bool;
         fn gatt_robust_caching_server_is_enabled() -> bool;
+        fn gd_config_cache_snapshot_reads_is_enabled() -> bool;
         fn gd_core_is_enabled() -> bool;
+        fn gd_controller_snapshot_is_enabled() -> bool;
+        fn gd_data_path_thread_is_enabled() -> bool;
+        fn gd_hal_batched_receive_is_enabled() -> bool;
+        fn gd_hal_fast_receive_is_enabled() -> bool;
+        fn gd_hal_snoop_logger_async_is_enabled() -> bool;
+        fn gd_hal_snoop_logger_mmap_ring_is_enabled() -> bool;
         fn gd_hal_snoop_logger_socket_is_enabled() -> bool;
+        fn gd_hal_zero_copy_receive_is_enabled() -> bool;
+        fn gd_hci_command_pipelining_is_enabled() -> bool;
         fn gd_l2cap_is_enabled() -> bool;
+        fn gd_l2cap_weighted_fair_scheduler_is_enabled() -> bool;
+        fn gd_le_scanning_software_filter_is_enabled() -> bool;
         fn gd_link_policy_is_enabled() -> bool;
+        fn gd_module_parallel_start_is_enabled() -> bool;
         fn gd_remote_name_request_is_enabled() -> bool;
+        fn gd_storage_config_journal_is_enabled() -> bool;
         fn get_default_log_level() -> i32;
         fn get_hci_adapter() -> i32;
         fn get_log_level_for_tag(tag: &str) -> i32;
@@ -39,6 +54,7 @@ mod ffi {
         fn hfp_dynamic_version_is_enabled() -> bool;
         fn irk_rotation_is_enabled() -> bool;
         fn leaudio_targeted_announcement_reconnection_mode_is_enabled() -> bool;
+        fn osi_slab_allocator_is_enabled() -> bool;
         fn pass_phy_update_callback_is_enabled() -> bool;
         fn pbap_pse_dynamic_version_upgrade_is_enabled() -> bool;
         fn periodic_advertising_adi_is_enabled() -> bool;
@@ -17,6 +17,7 @@ use gddi::{module, provides, Stoppable};
 use num_traits::ToPrimitive;
 use std::convert::TryFrom;
 use std::sync::Arc;
+use tokio::join;
 
 module! {
     controller_module,
@@ -46,43 +47,145 @@ async fn provide_controller(mut hci: CommandSender) -> Arc<ControllerExports> {
         simultaneous_le_host: Enable::Enabled
     }));
 
-    let name = null_terminated_to_string(
-        assert_success!(hci.send(ReadLocalNameBuilder {})).get_local_name(),
+    // Reads that don't depend on each other are queued together, so the HCI layer can pipeline
+    // them up to the credits the controller gives
+    let (name, version_info, commands, features, buffer_size, le_features, le_supported_states) = join!(
+        async {
+            let mut hci = hci.clone();
+            null_terminated_to_string(
+                assert_success!(hci.send(ReadLocalNameBuilder {})).get_local_name(),
+            )
+        },
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(ReadLocalVersionInformationBuilder {}))
+                .get_local_version_information()
+                .clone()
+        },
+        async {
+            let mut hci = hci.clone();
+            SupportedCommands {
+                supported: *assert_success!(hci.send(ReadLocalSupportedCommandsBuilder {}))
+                    .get_supported_commands(),
+            }
+        },
+        async { read_features(&mut hci.clone()).await },
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(ReadBufferSizeBuilder {}))
+        },
+        async {
+            let mut hci = hci.clone();
+            SupportedLeFeatures::new(
+                assert_success!(hci.send(LeReadLocalSupportedFeaturesBuilder {})).get_le_features(),
+            )
+        },
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(LeReadSupportedStatesBuilder {})).get_le_states()
+        },
+    );
+    let (le_connect_list_size, le_resolving_list_size, address) = join!(
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(LeReadFilterAcceptListSizeBuilder {}))
+                .get_filter_accept_list_size()
+        },
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(LeReadResolvingListSizeBuilder {})).get_resolving_list_size()
+        },
+        async {
+            let mut hci = hci.clone();
+            assert_success!(hci.send(ReadBdAddrBuilder {})).get_bd_addr()
+        },
     );
 
-    let version_info = assert_success!(hci.send(ReadLocalVersionInformationBuilder {}))
-        .get_local_version_information()
-        .clone();
-
-    let commands = SupportedCommands {
-        supported: *assert_success!(hci.send(ReadLocalSupportedCommandsBuilder {}))
-            .get_supported_commands(),
-    };
-
-    let features = read_features(&mut hci).await;
-
-    let buffer_size = assert_success!(hci.send(ReadBufferSizeBuilder {}));
     let acl_buffer_length = buffer_size.get_acl_data_packet_length();
     let mut acl_buffers = buffer_size.get_total_num_acl_data_packets();
 
-    let (mut le_buffer_length, mut le_buffers, iso_buffer_length, iso_buffers) =
-        if commands.is_supported(OpCode::LeReadBufferSizeV2) {
-            let response = assert_success!(hci.send(LeReadBufferSizeV2Builder {}));
-            (
-                response.get_le_buffer_size().le_data_packet_length,
-                response.get_le_buffer_size().total_num_le_packets,
-                response.get_iso_buffer_size().le_data_packet_length,
-                response.get_iso_buffer_size().total_num_le_packets,
-            )
-        } else {
-            let response = assert_success!(hci.send(LeReadBufferSizeV1Builder {}));
-            (
-                response.get_le_buffer_size().le_data_packet_length,
-                response.get_le_buffer_size().total_num_le_packets,
-                0,
-                0,
-            )
-        };
+    // The rest depends on the supported commands
+    let (
+        le_buffer_size,
+        le_max_data_length,
+        le_suggested_default_data_length,
+        le_max_advertising_data_length,
+        le_supported_advertising_sets,
+        le_periodic_advertiser_list_size,
+    ) = join!(
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadBufferSizeV2) {
+                let response = assert_success!(hci.send(LeReadBufferSizeV2Builder {}));
+                (
+                    response.get_le_buffer_size().le_data_packet_length,
+                    response.get_le_buffer_size().total_num_le_packets,
+                    response.get_iso_buffer_size().le_data_packet_length,
+                    response.get_iso_buffer_size().total_num_le_packets,
+                )
+            } else {
+                let response = assert_success!(hci.send(LeReadBufferSizeV1Builder {}));
+                (
+                    response.get_le_buffer_size().le_data_packet_length,
+                    response.get_le_buffer_size().total_num_le_packets,
+                    0,
+                    0,
+                )
+            }
+        },
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadMaximumDataLength) {
+                assert_success!(hci.send(LeReadMaximumDataLengthBuilder {}))
+                    .get_le_maximum_data_length()
+                    .clone()
+            } else {
+                LeMaximumDataLength {
+                    supported_max_rx_octets: 0,
+                    supported_max_rx_time: 0,
+                    supported_max_tx_octets: 0,
+                    supported_max_tx_time: 0,
+                }
+            }
+        },
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadSuggestedDefaultDataLength) {
+                assert_success!(hci.send(LeReadSuggestedDefaultDataLengthBuilder {}))
+                    .get_tx_octets()
+            } else {
+                0
+            }
+        },
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadMaximumAdvertisingDataLength) {
+                assert_success!(hci.send(LeReadMaximumAdvertisingDataLengthBuilder {}))
+                    .get_maximum_advertising_data_length()
+            } else {
+                31
+            }
+        },
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadNumberOfSupportedAdvertisingSets) {
+                assert_success!(hci.send(LeReadNumberOfSupportedAdvertisingSetsBuilder {}))
+                    .get_number_supported_advertising_sets()
+            } else {
+                1
+            }
+        },
+        async {
+            let mut hci = hci.clone();
+            if commands.is_supported(OpCode::LeReadPeriodicAdvertiserListSize) {
+                assert_success!(hci.send(LeReadPeriodicAdvertiserListSizeBuilder {}))
+                    .get_periodic_advertiser_list_size()
+            } else {
+                0
+            }
+        },
+    );
+    let (mut le_buffer_length, mut le_buffers, iso_buffer_length, iso_buffers) = le_buffer_size;
 
     // If the controller reports zero LE buffers, the ACL buffers are shared between classic & LE
     if le_buffers == 0 {
@@ -91,58 +194,6 @@ async fn provide_controller(mut hci: CommandSender) -> Arc<ControllerExports> {
         le_buffer_length = acl_buffer_length;
     }
 
-    let le_features = SupportedLeFeatures::new(
-        assert_success!(hci.send(LeReadLocalSupportedFeaturesBuilder {})).get_le_features(),
-    );
-    let le_supported_states =
-        assert_success!(hci.send(LeReadSupportedStatesBuilder {})).get_le_states();
-    let le_connect_list_size = assert_success!(hci.send(LeReadFilterAcceptListSizeBuilder {}))
-        .get_filter_accept_list_size();
-    let le_resolving_list_size =
-        assert_success!(hci.send(LeReadResolvingListSizeBuilder {})).get_resolving_list_size();
-
-    let le_max_data_length = if commands.is_supported(OpCode::LeReadMaximumDataLength) {
-        assert_success!(hci.send(LeReadMaximumDataLengthBuilder {}))
-            .get_le_maximum_data_length()
-            .clone()
-    } else {
-        LeMaximumDataLength {
-            supported_max_rx_octets: 0,
-            supported_max_rx_time: 0,
-            supported_max_tx_octets: 0,
-            supported_max_tx_time: 0,
-        }
-    };
-
-    let le_suggested_default_data_length =
-        if commands.is_supported(OpCode::LeReadSuggestedDefaultDataLength) {
-            assert_success!(hci.send(LeReadSuggestedDefaultDataLengthBuilder {})).get_tx_octets()
-        } else {
-            0
-        };
-
-    let le_max_advertising_data_length =
-        if commands.is_supported(OpCode::LeReadMaximumAdvertisingDataLength) {
-            assert_success!(hci.send(LeReadMaximumAdvertisingDataLengthBuilder {}))
-                .get_maximum_advertising_data_length()
-        } else {
-            31
-        };
-    let le_supported_advertising_sets =
-        if commands.is_supported(OpCode::LeReadNumberOfSupportedAdvertisingSets) {
-            assert_success!(hci.send(LeReadNumberOfSupportedAdvertisingSetsBuilder {}))
-                .get_number_supported_advertising_sets()
-        } else {
-            1
-        };
-    let le_periodic_advertiser_list_size =
-        if commands.is_supported(OpCode::LeReadPeriodicAdvertiserListSize) {
-            assert_success!(hci.send(LeReadPeriodicAdvertiserListSizeBuilder {}))
-                .get_periodic_advertiser_list_size()
-        } else {
-            0
-        };
-
     if commands.is_supported(OpCode::LeSetHostFeature) {
         assert_success!(hci.send(LeSetHostFeatureBuilder {
             bit_number: LeHostFeatureBits::ConnectedIsoStreamHostSupport,
@@ -150,8 +201,6 @@ async fn provide_controller(mut hci: CommandSender) -> Arc<ControllerExports> {
         }));
     }
 
-    let address = assert_success!(hci.send(ReadBdAddrBuilder {})).get_bd_addr();
-
     Arc::new(ControllerExports {
         name,
         address,
@@ -13,6 +13,7 @@ pub use bt_packets::custom_types::Address;
 pub use controller::ControllerExports;
 
 use crate::hal::ControlHal;
+use bt_common::init_flags;
 use bt_common::time::Alarm;
 use bt_packets::hci::EventChild::{
     CommandComplete, CommandStatus, LeMetaEvent, MaxSlotsChange, PageScanRepetitionModeChange,
@@ -20,12 +21,12 @@ use bt_packets::hci::EventChild::{
 };
 use bt_packets::hci::{
     CommandExpectations, CommandPacket, ErrorCode, EventCode, EventPacket, LeMetaEventPacket,
-    ResetBuilder, SubeventCode,
+    OpCode, ResetBuilder, SubeventCode,
 };
 use error::Result;
 use gddi::{module, part_out, provides, Stoppable};
 use log::error;
-use std::collections::HashMap;
+use std::collections::{HashMap, VecDeque};
 use std::sync::Arc;
 use std::time::Duration;
 use tokio::runtime::Runtime;
@@ -165,6 +166,101 @@ impl EventRegistry {
     }
 }
 
+/// Commands that are only sent once every outstanding command completed, and that hold off the
+/// commands after them
+fn is_barrier_command(op_code: OpCode) -> bool {
+    matches!(op_code, OpCode::Reset | OpCode::ControllerDebugInfo)
+}
+
+/// The LE filter accept list and resolving list can not change while scanning or connecting uses
+/// them, so these are kept one at a time in the order they were queued
+fn is_le_list_scan_or_connect_command(op_code: OpCode) -> bool {
+    matches!(
+        op_code,
+        OpCode::LeAddDeviceToFilterAcceptList
+            | OpCode::LeRemoveDeviceFromFilterAcceptList
+            | OpCode::LeClearFilterAcceptList
+            | OpCode::LeAddDeviceToResolvingList
+            | OpCode::LeRemoveDeviceFromResolvingList
+            | OpCode::LeClearResolvingList
+            | OpCode::LeSetAddressResolutionEnable
+            | OpCode::LeSetResolvablePrivateAddressTimeout
+            | OpCode::LeSetPrivacyMode
+            | OpCode::LeSetRandomAddress
+            | OpCode::LeSetScanParameters
+            | OpCode::LeSetScanEnable
+            | OpCode::LeSetExtendedScanParameters
+            | OpCode::LeSetExtendedScanEnable
+            | OpCode::LeCreateConnection
+            | OpCode::LeExtendedCreateConnection
+            | OpCode::LeCreateConnectionCancel
+    )
+}
+
+/// Whether a command queued later has to wait for an outstanding one to complete. Responses are
+/// matched to outstanding commands by op code, so two commands with the same op code are never
+/// outstanding together.
+fn depends_on(later: OpCode, outstanding: OpCode) -> bool {
+    later == outstanding
+        || is_barrier_command(later)
+        || is_barrier_command(outstanding)
+        || (is_le_list_scan_or_connect_command(later)
+            && is_le_list_scan_or_connect_command(outstanding))
+}
+
+/// Commands sent to the controller and waiting for their Command Complete or Status, oldest first
+struct OutstandingCommands {
+    commands: VecDeque<QueuedCommand>,
+    // Num_HCI_Command_Packets of the last response, the controller takes one command before reset
+    credits: u8,
+    pipelining: bool,
+}
+
+impl OutstandingCommands {
+    fn can_send(&self, next: &QueuedCommand) -> bool {
+        if self.credits == 0 || (!self.pipelining && !self.commands.is_empty()) {
+            return false;
+        }
+        let op_code = next.cmd.get_op_code();
+        !self.commands.iter().any(|outstanding| depends_on(op_code, outstanding.cmd.get_op_code()))
+    }
+
+    /// Takes the command a response is for, updating the credits and the timeout of the oldest
+    /// command. Returns None for the credit only responses with op code NONE.
+    fn complete(
+        &mut self,
+        op_code: OpCode,
+        credits: u8,
+        hci_timeout: &Alarm,
+    ) -> Option<QueuedCommand> {
+        self.credits = credits;
+        if op_code == OpCode::None {
+            return None;
+        }
+        let index =
+            match self.commands.iter().position(|queued| queued.cmd.get_op_code() == op_code) {
+                Some(index) => index,
+                None => match self.commands.front() {
+                    Some(oldest) => {
+                        panic!("Waiting for {}, got {}", oldest.cmd.get_op_code(), op_code)
+                    }
+                    None => panic!("Unexpected response with opcode {}", op_code),
+                },
+            };
+        let queued = self.commands.remove(index).unwrap();
+        if index == 0 {
+            // The next oldest command gets a full timeout from now
+            match self.commands.front() {
+                Some(_) => hci_timeout.reset(HCI_TIMEOUT),
+                None => hci_timeout.cancel(),
+            }
+        }
+        Some(queued)
+    }
+}
+
+const HCI_TIMEOUT: Duration = Duration::from_secs(2);
+
 async fn dispatch(
     evt_handlers: Arc<Mutex<HashMap<EventCode, Sender<EventPacket>>>>,
     le_evt_handlers: Arc<Mutex<HashMap<SubeventCode, Sender<LeMetaEventPacket>>>>,
@@ -172,36 +268,34 @@ async fn dispatch(
     cmd_tx: Sender<CommandPacket>,
     mut cmd_rx: Receiver<QueuedCommand>,
 ) {
-    let mut pending: Option<QueuedCommand> = None;
+    // With gd_hci_command_pipelining, commands are sent in the order they were queued as long as
+    // the controller has credits left and they don't depend on an outstanding command
+    let mut outstanding = OutstandingCommands {
+        commands: VecDeque::new(),
+        credits: 1,
+        pipelining: init_flags::gd_hci_command_pipelining_is_enabled(),
+    };
+    // The oldest queued command, held here until it can be sent
+    let mut next: Option<QueuedCommand> = None;
     let hci_timeout = Alarm::new();
     loop {
         select! {
             Some(evt) = consume(&evt_rx) => {
                 match evt.specialize() {
                     CommandStatus(evt) => {
-                        hci_timeout.cancel();
-                        let this_opcode = evt.get_command_op_code();
-                        match pending.take() {
-                            Some(QueuedCommand{cmd, fut}) if cmd.get_op_code() == this_opcode => {
-                                if let Err(e) = fut.send(evt.into()) {
-                                    error!("failure dispatching command status {:?}", e);
-                                }
-                            },
-                            Some(QueuedCommand{cmd, ..}) => panic!("Waiting for {}, got {}", cmd.get_op_code(), this_opcode),
-                            None => panic!("Unexpected status event with opcode {}", this_opcode),
+                        let credits = evt.get_num_hci_command_packets();
+                        if let Some(QueuedCommand{fut, ..}) = outstanding.complete(evt.get_command_op_code(), credits, &hci_timeout) {
+                            if let Err(e) = fut.send(evt.into()) {
+                                error!("failure dispatching command status {:?}", e);
+                            }
                         }
                     },
                     CommandComplete(evt) => {
-                        hci_timeout.cancel();
-                        let this_opcode = evt.get_command_op_code();
-                        match pending.take() {
-                            Some(QueuedCommand{cmd, fut}) if cmd.get_op_code() == this_opcode => {
-                                if let Err(e) = fut.send(evt.into()) {
-                                    error!("failure dispatching command complete {:?}", e);
-                                }
-                            },
-                            Some(QueuedCommand{cmd, ..}) => panic!("Waiting for {}, got {}", cmd.get_op_code(), this_opcode),
-                            None => panic!("Unexpected complete event with opcode {}", this_opcode),
+                        let credits = evt.get_num_hci_command_packets();
+                        if let Some(QueuedCommand{fut, ..}) = outstanding.complete(evt.get_command_op_code(), credits, &hci_timeout) {
+                            if let Err(e) = fut.send(evt.into()) {
+                                error!("failure dispatching command complete {:?}", e);
+                            }
                         }
                     },
                     LeMetaEvent(evt) => {
@@ -232,16 +326,26 @@ async fn dispatch(
                     },
                 }
             },
-            Some(queued) = cmd_rx.recv(), if pending.is_none() => {
-                if let Err(e) = cmd_tx.send(queued.cmd.clone()).await {
-                    error!("command queue closed: {:?}", e);
-                }
-                hci_timeout.reset(Duration::from_secs(2));
-                pending = Some(queued);
+            Some(queued) = cmd_rx.recv(), if next.is_none() => {
+                next = Some(queued);
             },
-            _ = hci_timeout.expired() => panic!("Timed out waiting for {}", pending.unwrap().cmd.get_op_code()),
+            _ = hci_timeout.expired() => panic!("Timed out waiting for {}", outstanding.commands.front().unwrap().cmd.get_op_code()),
             else => break,
         }
+
+        while next.as_ref().map_or(false, |queued| outstanding.can_send(queued)) {
+            let queued = next.take().unwrap();
+            if let Err(e) = cmd_tx.send(queued.cmd.clone()).await {
+                error!("command queue closed: {:?}", e);
+            }
+            // Num_HCI_Command_Packets of the next response tells how many more the controller takes
+            outstanding.credits -= 1;
+            if outstanding.commands.is_empty() {
+                // The timeout runs for the oldest outstanding command
+                hci_timeout.reset(HCI_TIMEOUT);
+            }
+            outstanding.commands.push_back(queued);
+        }
     }
 }
 
@@ -0,0 +1,122 @@
+//! Counters for the callbacks that carry payloads from libbluetooth into Rust.
+//!
+//! Every callback below is turned into an owned enum variant and sent over a channel to the
+//! stack's main loop, so the payload has to be copied out of the C++ buffer before the callback
+//! returns. These counters keep track of how often each of them crosses the boundary and how many
+//! bytes get copied on the way.
+
+use std::fmt;
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// The high volume callbacks that copy payloads across the boundary.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum BoundaryCallback {
+    GattNotify = 0,
+    GattRead,
+    ScanResult,
+    BatchScanReports,
+    A2dpAudioConfig,
+}
+
+const CALLBACK_COUNT: usize = BoundaryCallback::A2dpAudioConfig as usize + 1;
+
+const ALL_CALLBACKS: [BoundaryCallback; CALLBACK_COUNT] = [
+    BoundaryCallback::GattNotify,
+    BoundaryCallback::GattRead,
+    BoundaryCallback::ScanResult,
+    BoundaryCallback::BatchScanReports,
+    BoundaryCallback::A2dpAudioConfig,
+];
+
+struct Counters {
+    crossings: AtomicU64,
+    bytes: AtomicU64,
+}
+
+const ZERO_COUNTERS: Counters = Counters { crossings: AtomicU64::new(0), bytes: AtomicU64::new(0) };
+
+static COUNTERS: [Counters; CALLBACK_COUNT] = [ZERO_COUNTERS; CALLBACK_COUNT];
+
+/// Counters of a single callback at the time of the snapshot.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct BoundaryStats {
+    pub callback: BoundaryCallback,
+    pub crossings: u64,
+    pub bytes_copied: u64,
+}
+
+impl fmt::Display for BoundaryStats {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "{:?}: crossings={} bytes_copied={}",
+            self.callback, self.crossings, self.bytes_copied
+        )
+    }
+}
+
+/// Records that |callback| crossed the boundary carrying |bytes| of payload.
+pub fn record(callback: BoundaryCallback, bytes: usize) {
+    let counters = &COUNTERS[callback as usize];
+    counters.crossings.fetch_add(1, Ordering::Relaxed);
+    counters.bytes.fetch_add(bytes as u64, Ordering::Relaxed);
+}
+
+/// Returns the counters of every callback that crossed the boundary at least once.
+pub fn snapshot() -> Vec<BoundaryStats> {
+    ALL_CALLBACKS
+        .iter()
+        .map(|callback| {
+            let counters = &COUNTERS[*callback as usize];
+            BoundaryStats {
+                callback: *callback,
+                crossings: counters.crossings.load(Ordering::Relaxed),
+                bytes_copied: counters.bytes.load(Ordering::Relaxed),
+            }
+        })
+        .filter(|stats| stats.crossings > 0)
+        .collect()
+}
+
+/// Copies a C byte buffer into a Vec with a single copy and records it against |callback|.
+///
+/// A null |start| is accepted and yields an empty Vec, as libbluetooth passes one for empty
+/// payloads.
+pub(crate) fn copy_bytes(callback: BoundaryCallback, start: *const u8, length: usize) -> Vec<u8> {
+    if start.is_null() || length == 0 {
+        record(callback, 0);
+        return Vec::new();
+    }
+    record(callback, length);
+    unsafe { std::slice::from_raw_parts(start, length).to_vec() }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn stats_of(callback: BoundaryCallback) -> BoundaryStats {
+        snapshot().into_iter().find(|stats| stats.callback == callback).unwrap()
+    }
+
+    #[test]
+    fn copy_bytes_counts_payload() {
+        let data = [1u8, 2, 3, 4];
+        let before = snapshot()
+            .into_iter()
+            .find(|stats| stats.callback == BoundaryCallback::BatchScanReports)
+            .map_or(0, |stats| stats.bytes_copied);
+
+        let copy = copy_bytes(BoundaryCallback::BatchScanReports, data.as_ptr(), data.len());
+
+        assert_eq!(copy, data.to_vec());
+        assert!(stats_of(BoundaryCallback::BatchScanReports).bytes_copied >= before + 4);
+    }
+
+    #[test]
+    fn copy_bytes_accepts_null() {
+        let copy = copy_bytes(BoundaryCallback::ScanResult, std::ptr::null(), 10);
+        assert!(copy.is_empty());
+        assert!(stats_of(BoundaryCallback::ScanResult).crossings >= 1);
+    }
+}
@@ -16,6 +16,9 @@ pub mod bindings;
 
 pub mod btif;
 
+/// Counters for the payloads copied from libbluetooth callbacks.
+pub mod boundary;
+
 /// Helper module for the topshim facade.
 pub mod controller;
 pub mod metrics;
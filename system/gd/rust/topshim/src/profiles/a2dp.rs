@@ -1,3 +1,4 @@
+use crate::boundary::{self, BoundaryCallback};
 use crate::btif::{BluetoothInterface, BtStatus, RawAddress, ToggleableProfile};
 use crate::topstack::get_dispatchers;
 
@@ -291,6 +292,10 @@ cb_variant!(A2dpCb, audio_config_callback -> A2dpCallbacks::AudioConfig,
 RawAddress, A2dpCodecConfig, &Vec<A2dpCodecConfig>, &Vec<A2dpCodecConfig>, {
     let _2: Vec<A2dpCodecConfig> = _2.to_vec();
     let _3: Vec<A2dpCodecConfig> = _3.to_vec();
+    boundary::record(
+        BoundaryCallback::A2dpAudioConfig,
+        std::mem::size_of::<A2dpCodecConfig>() * (1 + _2.len() + _3.len()),
+    );
 });
 
 pub struct A2dp {
@@ -1,4 +1,5 @@
 use crate::bindings::root as bindings;
+use crate::boundary::{self, BoundaryCallback};
 use crate::btif::{ptr_to_vec, BluetoothInterface, BtStatus, RawAddress, SupportedProfiles, Uuid};
 use crate::profiles::gatt::bindings::{
     btgatt_callbacks_t, btgatt_client_callbacks_t, btgatt_client_interface_t, btgatt_interface_t,
@@ -679,7 +680,9 @@ cb_variant!(
     GattClientCb,
     gc_notify_cb -> GattClientCallbacks::Notify,
     i32, *const BtGattNotifyParams, {
-        let _1 = unsafe { *_1.clone() };
+        let _1 = unsafe { *_1 };
+        // The value buffer is fixed size, so the whole struct is copied whatever the length.
+        boundary::record(BoundaryCallback::GattNotify, std::mem::size_of_val(&_1));
     }
 );
 
@@ -687,7 +690,8 @@ cb_variant!(
     GattClientCb,
     gc_read_characteristic_cb -> GattClientCallbacks::ReadCharacteristic,
     i32, i32 -> GattStatus, *mut BtGattReadParams, {
-        let _2 = unsafe { *_2.clone() };
+        let _2 = unsafe { *_2 };
+        boundary::record(BoundaryCallback::GattRead, std::mem::size_of_val(&_2));
     }
 );
 
@@ -935,7 +939,7 @@ cb_variant!(
         // Convert the vec! at the end. Since this cb is being called via cxx
         // ffi, we do the vector separation at the cxx layer. The usize is consumed during
         // conversion.
-        let _9 : Vec<u8> = ptr_to_vec(_9, _10);
+        let _9 : Vec<u8> = boundary::copy_bytes(BoundaryCallback::ScanResult, _9, _10);
     }
 );
 
@@ -949,7 +953,7 @@ cb_variant!(
     gdscan_on_batch_scan_reports -> GattScannerCallbacks::OnBatchScanReports,
     i32, i32, i32, i32, *const u8, usize -> _, {
         // Write the vector to the output and consume the usize in the input.
-        let _4 : Vec<u8> = ptr_to_vec(_4, _5);
+        let _4 : Vec<u8> = boundary::copy_bytes(BoundaryCallback::BatchScanReports, _4, _5);
     }
 );
 
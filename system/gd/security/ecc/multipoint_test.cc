@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <string.h>
+
 #include "security/ecc/p_256_ecc_pp.h"
 
 namespace bluetooth {
@@ -107,6 +109,48 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+// Compares the constant time multiplications with the generic NAF implementation
+TEST(SmpEccMultiplicationTest, test_fixed_base_and_windowed_match_naf) {
+  uint32_t scalars[][KEY_LENGTH_DWORDS_P256] = {
+      {0x00000001, 0, 0, 0, 0, 0, 0, 0},
+      {0x00000002, 0, 0, 0, 0, 0, 0, 0},
+      {0x0000000f, 0, 0, 0, 0, 0, 0, 0},
+      {0x00000010, 0, 0, 0, 0, 0, 0, 0},
+      {0x13152951, 0xb6ae573f, 0xf6522632, 0xf2031a53, 0xa08aa3c3, 0x7db8b47b, 0xb37576ba, 0x3ec82a32},
+      {0xfba107d8, 0xa2e678b6, 0x82f48f38, 0x6730ce5d, 0x8964167b, 0xb2ffc053, 0xc8fa4b45, 0xdd538491},
+      {0x12345678, 0x9abcdef0, 0x0fedcba9, 0x87654321, 0xdeadbeef, 0x00000000, 0xffffffff, 0x80000000},
+  };
+
+  Point peer;
+  uint32_t peer_scalar[KEY_LENGTH_DWORDS_P256] = {0x89abcdef, 0x01234567, 0, 0, 0, 0, 0, 0x40000000};
+  ECC_PointMult_Bin_NAF(&peer, &curve_p256.G, peer_scalar);
+  multiprecision_init(peer.z);
+  peer.z[0] = 1;
+  ASSERT_TRUE(ECC_ValidatePoint(peer));
+
+  for (const auto& scalar : scalars) {
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    Point expected;
+    Point actual;
+
+    multiprecision_copy(n, scalar);
+    ECC_PointMult_Bin_NAF(&expected, &curve_p256.G, n);
+    ECC_PointMult_Fixed_Base(&actual, scalar);
+    EXPECT_EQ(memcmp(expected.x, actual.x, sizeof(actual.x)), 0);
+    EXPECT_EQ(memcmp(expected.y, actual.y, sizeof(actual.y)), 0);
+
+    ECC_PointMult_Windowed(&actual, &curve_p256.G, scalar);
+    EXPECT_EQ(memcmp(expected.x, actual.x, sizeof(actual.x)), 0);
+    EXPECT_EQ(memcmp(expected.y, actual.y, sizeof(actual.y)), 0);
+
+    multiprecision_copy(n, scalar);
+    ECC_PointMult_Bin_NAF(&expected, &peer, n);
+    ECC_PointMult_Windowed(&actual, &peer, scalar);
+    EXPECT_EQ(memcmp(expected.x, actual.x, sizeof(actual.x)), 0);
+    EXPECT_EQ(memcmp(expected.y, actual.y, sizeof(actual.y)), 0);
+  }
+}
+
 }  // namespace ecc
 }  // namespace security
 }  // namespace bluetooth
@@ -0,0 +1,483 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  P-256 point multiplication with 64-bit limbs. Field elements are kept in
+ *  Montgomery form, and points in homogeneous projective coordinates with the
+ *  complete addition formulas of Renes, Costello and Batina (2016) for a = -3,
+ *  so that no operation branches on the scalar or on special points.
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <string.h>
+
+#include "security/ecc/p_256_ecc_pp.h"
+
+namespace bluetooth {
+namespace security {
+namespace ecc {
+
+namespace {
+
+constexpr int kLimbs = 4;
+using Fe = uint64_t[kLimbs];
+
+// p = 2^256 - 2^224 + 2^192 + 2^96 - 1
+constexpr uint64_t kP[kLimbs] = {0xFFFFFFFFFFFFFFFF, 0x00000000FFFFFFFF, 0x0000000000000000, 0xFFFFFFFF00000001};
+// R^2 mod p, with R = 2^256
+constexpr uint64_t kRR[kLimbs] = {0x0000000000000003, 0xFFFFFFFBFFFFFFFF, 0xFFFFFFFFFFFFFFFE, 0x00000004FFFFFFFD};
+// R mod p, 1 in Montgomery form
+constexpr uint64_t kMontOne[kLimbs] = {0x0000000000000001, 0xFFFFFFFF00000000, 0xFFFFFFFFFFFFFFFF, 0x00000000FFFFFFFE};
+constexpr uint64_t kOne[kLimbs] = {1, 0, 0, 0};
+
+// Scalars are processed in 4 bit windows by the fixed base multiplication
+constexpr int kWindowBits = 4;
+constexpr int kWindows = 256 / kWindowBits;
+constexpr int kWindowEntries = (1 << kWindowBits) - 1;
+
+// Returns the low 64 bits of a * b + c + d, and stores the high 64 bits in hi
+inline uint64_t MulAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t* hi) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 r = (unsigned __int128)a * b + c + d;
+  *hi = (uint64_t)(r >> 64);
+  return (uint64_t)r;
+#else
+  uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+  uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+  uint64_t p0 = a_lo * b_lo;
+  uint64_t p1 = a_lo * b_hi;
+  uint64_t p2 = a_hi * b_lo;
+  uint64_t p3 = a_hi * b_hi;
+  uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+  uint64_t lo = (mid << 32) | (uint32_t)p0;
+  uint64_t h = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+  lo += c;
+  h += (lo < c);
+  lo += d;
+  h += (lo < d);
+  *hi = h;
+  return lo;
+#endif
+}
+
+// Returns a + b + carry_in, and stores the carry in carry_out
+inline uint64_t AddCarry(uint64_t a, uint64_t b, uint64_t carry_in, uint64_t* carry_out) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 r = (unsigned __int128)a + b + carry_in;
+  *carry_out = (uint64_t)(r >> 64);
+  return (uint64_t)r;
+#else
+  uint64_t r = a + b;
+  uint64_t c = (r < a);
+  r += carry_in;
+  c |= (r < carry_in);
+  *carry_out = c;
+  return r;
+#endif
+}
+
+// Returns a - b - borrow_in, and stores the borrow in borrow_out
+inline uint64_t SubBorrow(uint64_t a, uint64_t b, uint64_t borrow_in, uint64_t* borrow_out) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 r = (unsigned __int128)a - b - borrow_in;
+  *borrow_out = (uint64_t)(r >> 64) & 1;
+  return (uint64_t)r;
+#else
+  uint64_t r = a - b;
+  uint64_t br = (r > a);
+  uint64_t r2 = r - borrow_in;
+  br |= (r2 > r);
+  *borrow_out = br;
+  return r2;
+#endif
+}
+
+void FeCopy(Fe r, const Fe a) {
+  for (int i = 0; i < kLimbs; i++) r[i] = a[i];
+}
+
+// r = a if mask is all ones, r unchanged if mask is zero
+void FeCopyMasked(Fe r, const Fe a, uint64_t mask) {
+  for (int i = 0; i < kLimbs; i++) r[i] ^= mask & (r[i] ^ a[i]);
+}
+
+// r = a + b mod p, a < p, b < p
+void FeAdd(Fe r, const Fe a, const Fe b) {
+  uint64_t sum[kLimbs];
+  uint64_t reduced[kLimbs];
+  uint64_t carry = 0;
+  uint64_t borrow = 0;
+  for (int i = 0; i < kLimbs; i++) sum[i] = AddCarry(a[i], b[i], carry, &carry);
+  for (int i = 0; i < kLimbs; i++) reduced[i] = SubBorrow(sum[i], kP[i], borrow, &borrow);
+  // Keep the unreduced sum only when it is below p
+  uint64_t keep_sum = 0 - (borrow & (carry ^ 1));
+  for (int i = 0; i < kLimbs; i++) r[i] = (sum[i] & keep_sum) | (reduced[i] & ~keep_sum);
+}
+
+// r = a - b mod p, a < p, b < p
+void FeSub(Fe r, const Fe a, const Fe b) {
+  uint64_t borrow = 0;
+  uint64_t carry = 0;
+  for (int i = 0; i < kLimbs; i++) r[i] = SubBorrow(a[i], b[i], borrow, &borrow);
+  uint64_t mask = 0 - borrow;
+  for (int i = 0; i < kLimbs; i++) r[i] = AddCarry(r[i], kP[i] & mask, carry, &carry);
+}
+
+// r = a * b / R mod p, interleaving the product and the reduction one limb at a time. Since p = -1 mod 2^64 the
+// Montgomery factor of each round is the low limb itself, and the zero limb of p is skipped.
+void FeMul(Fe r, const Fe a, const Fe b) {
+  uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+
+  for (int i = 0; i < kLimbs; i++) {
+    uint64_t carry = 0;
+    uint64_t t5;
+    t0 = MulAdd(a[i], b[0], t0, carry, &carry);
+    t1 = MulAdd(a[i], b[1], t1, carry, &carry);
+    t2 = MulAdd(a[i], b[2], t2, carry, &carry);
+    t3 = MulAdd(a[i], b[3], t3, carry, &carry);
+    t4 = AddCarry(t4, carry, 0, &t5);
+
+    // t += m * p, then shift down one limb. m * (2^64 - 1) + m = m * 2^64, so the low limb carries m.
+    uint64_t m = t0;
+    carry = m;
+    t0 = MulAdd(m, kP[1], t1, carry, &carry);
+    t1 = AddCarry(t2, carry, 0, &carry);
+    t2 = MulAdd(m, kP[3], t3, carry, &carry);
+    t3 = AddCarry(t4, carry, 0, &carry);
+    t4 = t5 + carry;
+  }
+
+  // The result is below 2p, subtract p once if needed
+  const uint64_t t[kLimbs] = {t0, t1, t2, t3};
+  uint64_t reduced[kLimbs];
+  uint64_t borrow = 0;
+  for (int i = 0; i < kLimbs; i++) reduced[i] = SubBorrow(t[i], kP[i], borrow, &borrow);
+  SubBorrow(t4, 0, borrow, &borrow);
+  uint64_t keep_t = 0 - borrow;
+  for (int i = 0; i < kLimbs; i++) r[i] = (t[i] & keep_t) | (reduced[i] & ~keep_t);
+}
+
+void FeSqr(Fe r, const Fe a) {
+  FeMul(r, a, a);
+}
+
+// r = a^-1 mod p, computed as a^(p-2). The exponent is public, so the branches only depend on p.
+void FeInv(Fe r, const Fe a) {
+  uint64_t e[kLimbs];
+  uint64_t borrow = 0;
+  const uint64_t two[kLimbs] = {2, 0, 0, 0};
+  for (int i = 0; i < kLimbs; i++) e[i] = SubBorrow(kP[i], two[i], borrow, &borrow);
+
+  uint64_t acc[kLimbs];
+  FeCopy(acc, kMontOne);
+  for (int bit = 255; bit >= 0; bit--) {
+    FeSqr(acc, acc);
+    if ((e[bit / 64] >> (bit % 64)) & 1) FeMul(acc, acc, a);
+  }
+  FeCopy(r, acc);
+}
+
+void FeToMont(Fe r, const uint32_t* a) {
+  uint64_t t[kLimbs];
+  for (int i = 0; i < kLimbs; i++) t[i] = (uint64_t)a[2 * i] | ((uint64_t)a[2 * i + 1] << 32);
+  FeMul(r, t, kRR);
+}
+
+void FeFromMont(uint32_t* r, const Fe a) {
+  uint64_t t[kLimbs];
+  FeMul(t, a, kOne);
+  for (int i = 0; i < kLimbs; i++) {
+    r[2 * i] = (uint32_t)t[i];
+    r[2 * i + 1] = (uint32_t)(t[i] >> 32);
+  }
+}
+
+struct ProjectivePoint {
+  Fe x;
+  Fe y;
+  Fe z;
+};
+
+struct AffinePoint {
+  Fe x;
+  Fe y;
+};
+
+// b in Montgomery form
+const uint64_t* CurveB() {
+  static const struct B {
+    B() {
+      FeToMont(value, curve_p256.b);
+    }
+    Fe value;
+  } b;
+  return b.value;
+}
+
+void PointSetInfinity(ProjectivePoint* p) {
+  memset(p->x, 0, sizeof(p->x));
+  FeCopy(p->y, kMontOne);
+  memset(p->z, 0, sizeof(p->z));
+}
+
+// r = p + q, Algorithm 4 of Renes-Costello-Batina. Complete, so p == q and infinity need no special case.
+// r may alias p or q.
+void PointAdd(ProjectivePoint* r, const ProjectivePoint* p, const ProjectivePoint* q) {
+  const uint64_t* b = CurveB();
+  uint64_t t0[kLimbs], t1[kLimbs], t2[kLimbs], t3[kLimbs], t4[kLimbs];
+  uint64_t x3[kLimbs], y3[kLimbs], z3[kLimbs];
+
+  FeMul(t0, p->x, q->x);
+  FeMul(t1, p->y, q->y);
+  FeMul(t2, p->z, q->z);
+  FeAdd(t3, p->x, p->y);
+  FeAdd(t4, q->x, q->y);
+  FeMul(t3, t3, t4);
+  FeAdd(t4, t0, t1);
+  FeSub(t3, t3, t4);
+  FeAdd(t4, p->y, p->z);
+  FeAdd(x3, q->y, q->z);
+  FeMul(t4, t4, x3);
+  FeAdd(x3, t1, t2);
+  FeSub(t4, t4, x3);
+  FeAdd(x3, p->x, p->z);
+  FeAdd(y3, q->x, q->z);
+  FeMul(x3, x3, y3);
+  FeAdd(y3, t0, t2);
+  FeSub(y3, x3, y3);
+  FeMul(z3, b, t2);
+  FeSub(x3, y3, z3);
+  FeAdd(z3, x3, x3);
+  FeAdd(x3, x3, z3);
+  FeSub(z3, t1, x3);
+  FeAdd(x3, t1, x3);
+  FeMul(y3, b, y3);
+  FeAdd(t1, t2, t2);
+  FeAdd(t2, t1, t2);
+  FeSub(y3, y3, t2);
+  FeSub(y3, y3, t0);
+  FeAdd(t1, y3, y3);
+  FeAdd(y3, t1, y3);
+  FeAdd(t1, t0, t0);
+  FeAdd(t0, t1, t0);
+  FeSub(t0, t0, t2);
+  FeMul(t1, t4, y3);
+  FeMul(t2, t0, y3);
+  FeMul(y3, x3, z3);
+  FeAdd(y3, y3, t2);
+  FeMul(x3, t3, x3);
+  FeSub(x3, x3, t1);
+  FeMul(z3, t4, z3);
+  FeMul(t1, t3, t0);
+  FeAdd(z3, z3, t1);
+
+  FeCopy(r->x, x3);
+  FeCopy(r->y, y3);
+  FeCopy(r->z, z3);
+}
+
+// r = 2p, Algorithm 6 of Renes-Costello-Batina. r may alias p.
+void PointDouble(ProjectivePoint* r, const ProjectivePoint* p) {
+  const uint64_t* b = CurveB();
+  uint64_t t0[kLimbs], t1[kLimbs], t2[kLimbs], t3[kLimbs];
+  uint64_t x3[kLimbs], y3[kLimbs], z3[kLimbs];
+
+  FeSqr(t0, p->x);
+  FeSqr(t1, p->y);
+  FeSqr(t2, p->z);
+  FeMul(t3, p->x, p->y);
+  FeAdd(t3, t3, t3);
+  FeMul(z3, p->x, p->z);
+  FeAdd(z3, z3, z3);
+  FeMul(y3, b, t2);
+  FeSub(y3, y3, z3);
+  FeAdd(x3, y3, y3);
+  FeAdd(y3, x3, y3);
+  FeSub(x3, t1, y3);
+  FeAdd(y3, t1, y3);
+  FeMul(y3, x3, y3);
+  FeMul(x3, x3, t3);
+  FeAdd(t3, t2, t2);
+  FeAdd(t2, t2, t3);
+  FeMul(z3, b, z3);
+  FeSub(z3, z3, t2);
+  FeSub(z3, z3, t0);
+  FeAdd(t3, z3, z3);
+  FeAdd(z3, z3, t3);
+  FeAdd(t3, t0, t0);
+  FeAdd(t0, t3, t0);
+  FeSub(t0, t0, t2);
+  FeMul(t0, t0, z3);
+  FeAdd(y3, y3, t0);
+  FeMul(t0, p->y, p->z);
+  FeAdd(t0, t0, t0);
+  FeMul(z3, t0, z3);
+  FeSub(x3, x3, z3);
+  FeMul(z3, t0, t1);
+  FeAdd(z3, z3, z3);
+  FeAdd(z3, z3, z3);
+
+  FeCopy(r->x, x3);
+  FeCopy(r->y, y3);
+  FeCopy(r->z, z3);
+}
+
+void PointToAffine(Point* q, const ProjectivePoint* p) {
+  uint64_t z_inv[kLimbs];
+  uint64_t t[kLimbs];
+
+  FeInv(z_inv, p->z);
+  FeMul(t, p->x, z_inv);
+  FeFromMont(q->x, t);
+  FeMul(t, p->y, z_inv);
+  FeFromMont(q->y, t);
+  multiprecision_init(q->z);
+  q->z[0] = 1;
+}
+
+// table[i][j] = (j + 1) * 16^i * G, in affine coordinates
+struct BaseTable {
+  AffinePoint table[kWindows][kWindowEntries];
+};
+
+const BaseTable* BuildBaseTable() {
+  BaseTable* base_table = new BaseTable;
+  ProjectivePoint base;
+  ProjectivePoint multiples[kWindowEntries];
+
+  FeToMont(base.x, curve_p256.G.x);
+  FeToMont(base.y, curve_p256.G.y);
+  FeCopy(base.z, kMontOne);
+
+  for (int i = 0; i < kWindows; i++) {
+    multiples[0] = base;
+    for (int j = 1; j < kWindowEntries; j++) PointAdd(&multiples[j], &multiples[j - 1], &base);
+
+    // Normalize the window with a single inversion: prefix[j] = z_0 * ... * z_j
+    uint64_t prefix[kWindowEntries][kLimbs];
+    uint64_t inv[kLimbs];
+    uint64_t z_inv[kLimbs];
+    FeCopy(prefix[0], multiples[0].z);
+    for (int j = 1; j < kWindowEntries; j++) FeMul(prefix[j], prefix[j - 1], multiples[j].z);
+    FeInv(inv, prefix[kWindowEntries - 1]);
+    for (int j = kWindowEntries - 1; j >= 0; j--) {
+      if (j > 0) {
+        FeMul(z_inv, inv, prefix[j - 1]);
+        FeMul(inv, inv, multiples[j].z);
+      } else {
+        FeCopy(z_inv, inv);
+      }
+      FeMul(base_table->table[i][j].x, multiples[j].x, z_inv);
+      FeMul(base_table->table[i][j].y, multiples[j].y, z_inv);
+    }
+
+    for (int k = 0; k < kWindowBits; k++) PointDouble(&base, &base);
+  }
+
+  return base_table;
+}
+
+void ScalarToLimbs(uint64_t* r, const uint32_t* n) {
+  for (int i = 0; i < kLimbs; i++) r[i] = (uint64_t)n[2 * i] | ((uint64_t)n[2 * i + 1] << 32);
+}
+
+// Returns the i-th window of the scalar k, starting from the least significant bits
+uint64_t ScalarDigit(const uint64_t* k, int i) {
+  constexpr int kWindowsPerLimb = 64 / kWindowBits;
+  return (k[i / kWindowsPerLimb] >> ((i % kWindowsPerLimb) * kWindowBits)) & kWindowEntries;
+}
+
+// Returns all ones if digit == value and zero otherwise, without branching. Both are below 2^kWindowBits.
+uint64_t DigitMask(uint64_t digit, uint64_t value) {
+  return 0 - (((digit ^ value) - 1) >> 63);
+}
+
+}  // namespace
+
+void ECC_PointMult_Fixed_Base(Point* q, const uint32_t* n) {
+  // Never freed, shared by all pairings for the lifetime of the process
+  static const BaseTable* base_table = BuildBaseTable();
+
+  uint64_t k[kLimbs];
+  ScalarToLimbs(k, n);
+
+  ProjectivePoint acc;
+  ProjectivePoint entry;
+  PointSetInfinity(&acc);
+
+  for (int i = 0; i < kWindows; i++) {
+    uint64_t digit = ScalarDigit(k, i);
+
+    // Read every entry of the window so the memory access pattern does not depend on the digit. A zero digit
+    // selects the point at infinity.
+    PointSetInfinity(&entry);
+    for (int j = 0; j < kWindowEntries; j++) {
+      uint64_t mask = DigitMask(digit, j + 1);
+      FeCopyMasked(entry.x, base_table->table[i][j].x, mask);
+      FeCopyMasked(entry.y, base_table->table[i][j].y, mask);
+      FeCopyMasked(entry.z, kMontOne, mask);
+    }
+    PointAdd(&acc, &acc, &entry);
+  }
+
+  PointToAffine(q, &acc);
+}
+
+void ECC_PointMult_Windowed(Point* q, const Point* p, const uint32_t* n) {
+  uint64_t k[kLimbs];
+  ScalarToLimbs(k, n);
+
+  // multiples[j] = (j + 1) * p
+  ProjectivePoint multiples[kWindowEntries];
+  FeToMont(multiples[0].x, p->x);
+  FeToMont(multiples[0].y, p->y);
+  FeCopy(multiples[0].z, kMontOne);
+  for (int j = 1; j < kWindowEntries; j++) {
+    if (j % 2) {
+      PointDouble(&multiples[j], &multiples[j / 2]);
+    } else {
+      PointAdd(&multiples[j], &multiples[j - 1], &multiples[0]);
+    }
+  }
+
+  ProjectivePoint acc;
+  ProjectivePoint entry;
+  PointSetInfinity(&acc);
+
+  // Every window does the same doublings and one addition, whatever its digit
+  for (int i = kWindows - 1; i >= 0; i--) {
+    for (int d = 0; d < kWindowBits; d++) PointDouble(&acc, &acc);
+
+    uint64_t digit = ScalarDigit(k, i);
+    PointSetInfinity(&entry);
+    for (int j = 0; j < kWindowEntries; j++) {
+      uint64_t mask = DigitMask(digit, j + 1);
+      FeCopyMasked(entry.x, multiples[j].x, mask);
+      FeCopyMasked(entry.y, multiples[j].y, mask);
+      FeCopyMasked(entry.z, multiples[j].z, mask);
+    }
+    PointAdd(&acc, &acc, &entry);
+  }
+
+  PointToAffine(q, &acc);
+}
+
+}  // namespace ecc
+}  // namespace security
+}  // namespace bluetooth
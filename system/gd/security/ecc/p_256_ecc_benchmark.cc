@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "security/ecc/p_256_ecc_pp.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace security {
+namespace ecc {
+namespace {
+
+// Private keys of the Bluetooth Core Specification sample data, Vol 2, Part G 7.1.2
+constexpr uint32_t kPrivateKeyA[KEY_LENGTH_DWORDS_P256] = {
+    0x13152951, 0xb6ae573f, 0xf6522632, 0xf2031a53, 0xa08aa3c3, 0x7db8b47b, 0xb37576ba, 0x3ec82a32};
+constexpr uint32_t kPrivateKeyB[KEY_LENGTH_DWORDS_P256] = {
+    0xfba107d8, 0xa2e678b6, 0x82f48f38, 0x6730ce5d, 0x8964167b, 0xb2ffc053, 0xc8fa4b45, 0xdd538491};
+
+// Public key of device B, as received by device A
+Point MakePeerPublicKey() {
+  uint32_t n[KEY_LENGTH_DWORDS_P256];
+  Point peer;
+  multiprecision_copy(n, kPrivateKeyB);
+  ECC_PointMult_Bin_NAF(&peer, &curve_p256.G, n);
+  multiprecision_init(peer.z);
+  peer.z[0] = 1;
+  return peer;
+}
+
+void BM_P256_PublicKey_BinNaf(State& state) {
+  Point q;
+  for (auto _ : state) {
+    // The NAF recoding consumes the scalar
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    multiprecision_copy(n, kPrivateKeyA);
+    ECC_PointMult_Bin_NAF(&q, &curve_p256.G, n);
+    ::benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_P256_PublicKey_FixedBase(State& state) {
+  Point q;
+  for (auto _ : state) {
+    ECC_PointMult_Fixed_Base(&q, kPrivateKeyA);
+    ::benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_P256_DhKey_BinNaf(State& state) {
+  Point peer = MakePeerPublicKey();
+  Point q;
+  for (auto _ : state) {
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    multiprecision_copy(n, kPrivateKeyA);
+    ECC_PointMult_Bin_NAF(&q, &peer, n);
+    ::benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_P256_DhKey_Windowed(State& state) {
+  Point peer = MakePeerPublicKey();
+  Point q;
+  for (auto _ : state) {
+    ECC_PointMult_Windowed(&q, &peer, kPrivateKeyA);
+    ::benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_P256_PublicKey_BinNaf);
+BENCHMARK(BM_P256_PublicKey_FixedBase);
+BENCHMARK(BM_P256_DhKey_BinNaf);
+BENCHMARK(BM_P256_DhKey_Windowed);
+
+}  // namespace ecc
+}  // namespace security
+}  // namespace bluetooth
@@ -71,6 +71,15 @@ void ECC_PointMult_Bin_NAF(Point* q, const Point* p, uint32_t* n);
 
 #define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
 
+// The functions below use 64-bit limbs with Montgomery arithmetic specialized for P-256, and run in time
+// independent of the scalar n. q is returned in affine coordinates, with q->z set to 1.
+
+// q = n * G, using a table of multiples of the base point built on first use
+void ECC_PointMult_Fixed_Base(Point* q, const uint32_t* n);
+
+// q = n * p with fixed 4 bit windows, p is in affine coordinates and must be on the curve
+void ECC_PointMult_Windowed(Point* q, const Point* p, const uint32_t* n);
+
 }  // namespace ecc
 }  // namespace security
 }  // namespace bluetooth
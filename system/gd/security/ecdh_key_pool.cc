@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "security/ecdh_key_pool.h"
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace security {
+
+EcdhKeyPool::EcdhKeyPool(os::Handler* handler, size_t pool_size, bool allow_key_reuse)
+    : handler_(handler), pool_size_(pool_size), allow_key_reuse_(allow_key_reuse) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ScheduleRefillLocked();
+}
+
+EcdhKeyPool::KeyPair EcdhKeyPool::GetKeyPair() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  key_pair_in_use_ = true;
+
+  if (allow_key_reuse_ && reused_key_pair_) {
+    return *reused_key_pair_;
+  }
+
+  KeyPair key_pair;
+  if (key_pairs_.empty()) {
+    LOG_INFO("No ECDH key pair ready, generating one");
+    key_pair = GenerateECDHKeyPair();
+  } else {
+    key_pair = key_pairs_.front();
+    key_pairs_.pop_front();
+  }
+  ScheduleRefillLocked();
+
+  if (allow_key_reuse_) {
+    reused_key_pair_ = key_pair;
+    reuse_score_ = 0;
+  }
+  return key_pair;
+}
+
+void EcdhKeyPool::OnPairingFinished(bool success) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!key_pair_in_use_) {
+    return;
+  }
+  key_pair_in_use_ = false;
+
+  if (!reused_key_pair_) {
+    return;
+  }
+  reuse_score_ += success ? 1 : kFailedPairingReuseScore;
+  if (reuse_score_ >= kMaxReuseScore) {
+    LOG_INFO("Retiring reused ECDH key pair");
+    reused_key_pair_.reset();
+  }
+}
+
+size_t EcdhKeyPool::GetReadyKeyPairCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return key_pairs_.size();
+}
+
+void EcdhKeyPool::ScheduleRefillLocked() {
+  if (refill_scheduled_ || key_pairs_.size() >= pool_size_) {
+    return;
+  }
+  refill_scheduled_ = true;
+  handler_->CallOn(this, &EcdhKeyPool::Refill);
+}
+
+void EcdhKeyPool::Refill() {
+  // Generate outside of the lock, so that a pairing starting meanwhile can take a ready key pair
+  KeyPair key_pair = GenerateECDHKeyPair();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  refill_scheduled_ = false;
+  if (key_pairs_.size() < pool_size_) {
+    key_pairs_.push_back(std::move(key_pair));
+  }
+  ScheduleRefillLocked();
+}
+
+}  // namespace security
+}  // namespace bluetooth
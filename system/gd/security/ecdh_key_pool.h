@@ -0,0 +1,79 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "os/handler.h"
+#include "security/ecdh_keys.h"
+
+namespace bluetooth {
+namespace security {
+
+/* Keeps a few ECDH key pairs ready so that LE Secure Connections pairing does not have to generate one before
+ * sending its Pairing Public Key. Used key pairs are replaced on the handler, one per task. */
+class EcdhKeyPool {
+ public:
+  using KeyPair = std::pair<std::array<uint8_t, 32>, EcdhPublicKey>;
+
+  static constexpr size_t kDefaultPoolSize = 2;
+
+  /* A reused key pair is retired once S + 3F >= 8, where S and F are the successful and failed pairings it was used
+   * for (Core Specification, Vol 3, Part H) */
+  static constexpr int kMaxReuseScore = 8;
+  static constexpr int kFailedPairingReuseScore = 3;
+
+  /* Without |allow_key_reuse| every key pair is used for a single pairing, which is what the spec recommends */
+  EcdhKeyPool(os::Handler* handler, size_t pool_size = kDefaultPoolSize, bool allow_key_reuse = false);
+
+  /* Returns the key pair to use for a new pairing, generating one if the pool is empty. Thread safe. */
+  KeyPair GetKeyPair();
+
+  /* Reports the outcome of the pairing that used the last key pair returned by GetKeyPair() */
+  void OnPairingFinished(bool success);
+
+  size_t GetReadyKeyPairCount();
+
+ private:
+  void ScheduleRefillLocked();
+  void Refill();
+
+  os::Handler* handler_;
+  const size_t pool_size_;
+  const bool allow_key_reuse_;
+
+  std::mutex mutex_;
+  std::deque<KeyPair> key_pairs_;
+  bool refill_scheduled_ = false;
+
+  /* Set while a pairing is using a key pair from the pool */
+  bool key_pair_in_use_ = false;
+
+  /* The key pair handed out again to each pairing, when reuse is allowed */
+  std::optional<KeyPair> reused_key_pair_;
+  int reuse_score_ = 0;
+};
+
+}  // namespace security
+}  // namespace bluetooth
@@ -53,10 +53,9 @@ namespace security {
 
 std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GenerateECDHKeyPair() {
   std::array<uint8_t, 32> private_key = GenerateRandom<32>();
-  std::array<uint8_t, 32> private_key_copy = private_key;
   ecc::Point public_key;
 
-  ECC_PointMult(&public_key, &(ecc::curve_p256.G), (uint32_t*)private_key_copy.data());
+  ECC_PointMult_Fixed_Base(&public_key, (const uint32_t*)private_key.data());
 
   EcdhPublicKey pk;
   memcpy(pk.x.data(), public_key.x, 32);
@@ -83,7 +82,7 @@ std::array<uint8_t, 32> ComputeDHKey(std::array<uint8_t, 32> my_private_key, Ecd
   memset(peer_publ_key.z, 0, 32);
   peer_publ_key.z[0] = 1;
 
-  ECC_PointMult(&new_publ_key, &peer_publ_key, (uint32_t*)private_key);
+  ECC_PointMult_Windowed(&new_publ_key, &peer_publ_key, private_key);
 
   std::array<uint8_t, 32> dhkey;
   memcpy(dhkey.data(), new_publ_key.x, 32);
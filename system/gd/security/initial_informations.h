@@ -29,6 +29,7 @@
 #include "os/handler.h"
 #include "packet/base_packet_builder.h"
 #include "packet/packet_view.h"
+#include "security/ecdh_key_pool.h"
 #include "security/ecdh_keys.h"
 #include "security/pairing_failure.h"
 #include "security/smp_packets.h"
@@ -124,6 +125,9 @@ struct InitialInformations {
 
   /* Callback to execute once the Pairing process is finished */
   std::function<void(PairingResultOrFailure)> OnPairingFinished;
+
+  /* Key pairs ready for Secure Connections. If not set, a key pair is generated when the pairing needs it. */
+  EcdhKeyPool* ecdh_key_pool = nullptr;
 };
 
 }  // namespace security
@@ -442,7 +442,7 @@ void SecurityManagerImpl::OnPairingHandlerComplete(hci::Address address, Pairing
   }
   auto record = this->security_database_.FindOrCreate(remote);
   record->CancelPairing();
-  security_database_.SaveRecordsToStorage();
+  security_database_.SaveRecordToStorage(record);
   // Only call update link if we need to
   auto policy_callback_entry = enforce_security_policy_callback_map_.find(remote);
   if (policy_callback_entry != enforce_security_policy_callback_map_.end()) {
@@ -560,6 +560,7 @@ void SecurityManagerImpl::OnSmpCommandLe(hci::AddressWithType device) {
         /* Callback to execute once the Pairing process is finished */
         // TODO: make it an common::OnceCallback ?
         .OnPairingFinished = std::bind(&SecurityManagerImpl::OnPairingFinished, this, std::placeholders::_1),
+        .ecdh_key_pool = &ecdh_key_pool_,
     };
     pending_le_pairing_.address_ = device;
     pending_le_pairing_.handler_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, initial_informations);
@@ -632,6 +633,7 @@ void SecurityManagerImpl::ConnectionIsReadyStartPairing(LeFixedChannelEntry* sto
       /* Callback to execute once the Pairing process is finished */
       // TODO: make it an common::OnceCallback ?
       .OnPairingFinished = std::bind(&SecurityManagerImpl::OnPairingFinished, this, std::placeholders::_1),
+      .ecdh_key_pool = &ecdh_key_pool_,
   };
   pending_le_pairing_.handler_ = std::make_unique<PairingHandlerLe>(PairingHandlerLe::PHASE1, initial_informations);
 }
@@ -682,6 +684,7 @@ SecurityManagerImpl::SecurityManagerImpl(
       storage_module_(storage_module),
       security_record_storage_(storage_module, security_handler),
       security_database_(security_record_storage_),
+      ecdh_key_pool_(security_handler),
       name_db_module_(name_db_module) {
   Init();
 
@@ -699,6 +702,8 @@ void SecurityManagerImpl::OnPairingFinished(security::PairingResultOrFailure pai
     stored_chan->channel_->Release();
   }
 
+  ecdh_key_pool_.OnPairingFinished(!std::holds_alternative<PairingFailure>(pairing_result));
+
   if (std::holds_alternative<PairingFailure>(pairing_result)) {
     PairingFailure failure = std::get<PairingFailure>(pairing_result);
     LOG_INFO(" ■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■■ failure message: %s",
@@ -724,7 +729,7 @@ void SecurityManagerImpl::OnPairingFinished(security::PairingResultOrFailure pai
   record->remote_signature_key = result.distributed_keys.remote_signature_key;
   if (result.distributed_keys.remote_link_key)
     record->SetLinkKey(*result.distributed_keys.remote_link_key, hci::KeyType::AUTHENTICATED_P256);
-  security_database_.SaveRecordsToStorage();
+  security_database_.SaveRecordToStorage(record);
 
   NotifyDeviceBonded(result.connection_address);
   // We also notify bond complete using identity address. That's what old stack used to do.
@@ -28,6 +28,7 @@
 #include "neighbor/name_db.h"
 #include "os/handler.h"
 #include "security/channel/security_manager_channel.h"
+#include "security/ecdh_key_pool.h"
 #include "security/initial_informations.h"
 #include "security/pairing/classic_pairing_handler.h"
 #include "security/pairing/oob_data.h"
@@ -256,6 +257,7 @@ class SecurityManagerImpl : public channel::ISecurityManagerChannelListener, pub
   storage::StorageModule* storage_module_ __attribute__((unused));
   record::SecurityRecordStorage security_record_storage_;
   record::SecurityRecordDatabase security_database_;
+  EcdhKeyPool ecdh_key_pool_;
   neighbor::NameDbModule* name_db_module_;
   std::unordered_map<hci::Address, std::shared_ptr<pairing::PairingHandler>> pairing_handler_map_;
   hci::IoCapability local_io_capability_ = kDefaultIoCapability;
@@ -184,7 +184,8 @@ void ClassicPairingHandler::OnReceive(hci::PinCodeRequestView packet) {
   GetNameDbModule()->ReadRemoteNameRequest(
       GetRecord()->GetPseudoAddress()->GetAddress(),
       common::BindOnce(&ClassicPairingHandler::OnNameRequestComplete, common::Unretained(this)),
-      security_handler_);
+      security_handler_,
+      neighbor::RemoteNamePriority::HIGH);
 }
 
 void ClassicPairingHandler::OnReceive(hci::LinkKeyRequestView packet) {
@@ -237,7 +238,8 @@ void ClassicPairingHandler::OnReceive(hci::IoCapabilityRequestView packet) {
   GetNameDbModule()->ReadRemoteNameRequest(
       GetRecord()->GetPseudoAddress()->GetAddress(),
       common::BindOnce(&ClassicPairingHandler::OnNameRequestComplete, common::Unretained(this)),
-      security_handler_);
+      security_handler_,
+      neighbor::RemoteNamePriority::HIGH);
 }
 
 void ClassicPairingHandler::OnReceive(hci::IoCapabilityResponseView packet) {
@@ -29,10 +29,11 @@ namespace security {
 
 std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublicKeys(const InitialInformations& i,
                                                                                      OobDataFlag remote_have_oob_data) {
-  // Generate ECDH, or use one that was used for OOB data
-  const auto [private_key, public_key] = (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
-                                             ? GenerateECDHKeyPair()
-                                             : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
+  // Take a ready ECDH key pair, or use the one that was used for OOB data
+  const auto [private_key, public_key] =
+      (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
+          ? (i.ecdh_key_pool != nullptr ? i.ecdh_key_pool->GetKeyPair() : GenerateECDHKeyPair())
+          : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
 
   LOG_INFO("Public key exchange start");
   std::unique_ptr<PairingPublicKeyBuilder> myPublicKey = PairingPublicKeyBuilder::Create(public_key.x, public_key.y);
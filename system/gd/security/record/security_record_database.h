@@ -16,7 +16,10 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "hci/address_with_type.h"
 #include "security/record/security_record.h"
@@ -34,13 +37,14 @@ class SecurityRecordDatabase {
   using iterator = std::set<std::shared_ptr<SecurityRecord>>::iterator;
 
   std::shared_ptr<SecurityRecord> FindOrCreate(hci::AddressWithType address) {
-    auto it = Find(address);
+    auto record = FindRecord(address);
     // Security record check
-    if (it != records_.end()) return *it;
+    if (record != nullptr) return record;
 
     // No security record, create one
     auto record_ptr = std::make_shared<SecurityRecord>(address);
     records_.insert(record_ptr);
+    pseudo_address_index_.emplace(address, record_ptr);
     return record_ptr;
   }
 
@@ -51,29 +55,78 @@ class SecurityRecordDatabase {
     if (it == records_.end()) return;
 
     records_.erase(it);
+    RebuildIndexes();
     security_record_storage_.RemoveDevice(address);
   }
 
   iterator Find(hci::AddressWithType address) {
-    for (auto it = records_.begin(); it != records_.end(); ++it) {
-      std::shared_ptr<SecurityRecord> record = *it;
-      if (record->identity_address_.has_value() && record->identity_address_.value() == address) return it;
-      if (record->GetPseudoAddress() == address) return it;
-      if (record->remote_irk.has_value() && address.IsRpaThatMatchesIrk(record->remote_irk.value())) return it;
-    }
-    return records_.end();
+    auto record = FindRecord(address);
+    return record != nullptr ? records_.find(record) : records_.end();
   }
 
   void LoadRecordsFromStorage() {
     security_record_storage_.LoadSecurityRecords(&records_);
+    RebuildIndexes();
   }
 
+  // Records are updated in place once a pairing completes, then saved. Saving also brings the indexes up to date with
+  // their addresses and keys.
   void SaveRecordsToStorage() {
+    RebuildIndexes();
     security_record_storage_.SaveSecurityRecords(&records_);
   }
 
+  // Queues a record that changed for the next write, which stores all the records that changed during the same
+  // Handler task.
+  void SaveRecordToStorage(std::shared_ptr<SecurityRecord> record) {
+    RebuildIndexes();
+    security_record_storage_.SaveSecurityRecord(record);
+  }
+
   std::set<std::shared_ptr<SecurityRecord>> records_;
   record::SecurityRecordStorage security_record_storage_;
+
+ private:
+  // RPAs resolved by the IRK of a record are remembered, up to this many, so that an RPA only has to be checked
+  // against every IRK once
+  static constexpr size_t kMaxResolvedRpas = 256;
+
+  // The identity address matches first, then the pseudo address, then the IRK of the record
+  std::shared_ptr<SecurityRecord> FindRecord(const hci::AddressWithType& address) {
+    auto it = identity_address_index_.find(address);
+    if (it != identity_address_index_.end()) return it->second;
+    it = pseudo_address_index_.find(address);
+    if (it != pseudo_address_index_.end()) return it->second;
+    if (!address.IsRpa()) return nullptr;
+
+    it = resolved_rpas_.find(address);
+    if (it != resolved_rpas_.end()) return it->second;
+    for (auto& record : records_with_irk_) {
+      if (address.IsRpaThatMatchesIrk(record->remote_irk.value())) {
+        if (resolved_rpas_.size() >= kMaxResolvedRpas) resolved_rpas_.clear();
+        resolved_rpas_.emplace(address, record);
+        return record;
+      }
+    }
+    return nullptr;
+  }
+
+  void RebuildIndexes() {
+    identity_address_index_.clear();
+    pseudo_address_index_.clear();
+    records_with_irk_.clear();
+    resolved_rpas_.clear();
+    for (auto& record : records_) {
+      if (record->identity_address_.has_value()) identity_address_index_.emplace(*record->identity_address_, record);
+      if (record->pseudo_address_.has_value()) pseudo_address_index_.emplace(*record->pseudo_address_, record);
+      if (record->remote_irk.has_value()) records_with_irk_.push_back(record);
+    }
+  }
+
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> identity_address_index_;
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> pseudo_address_index_;
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> resolved_rpas_;
+  std::vector<std::shared_ptr<SecurityRecord>> records_with_irk_;
 };
 
 }  // namespace record
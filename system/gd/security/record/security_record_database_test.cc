@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/record/security_record_database.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace security {
+namespace record {
+namespace {
+
+const crypto_toolbox::Octet16 kIrk = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+
+hci::AddressWithType MakeRpa(const crypto_toolbox::Octet16& irk, uint8_t prand_seed) {
+  hci::Address address;
+  address.address[3] = prand_seed;
+  address.address[4] = 0x22;
+  address.address[5] = 0x40 | (prand_seed & 0x3f);
+  crypto_toolbox::Octet16 hash = crypto_toolbox::aes_128(irk, &address.address[3], 3);
+  address.address[0] = hash[0];
+  address.address[1] = hash[1];
+  address.address[2] = hash[2];
+  return hci::AddressWithType(address, hci::AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+class SecurityRecordDatabaseTest : public ::testing::Test {
+ protected:
+  // Records are kept temporary, so that saving them only updates the indexes
+  std::shared_ptr<SecurityRecord> FindOrCreateTemporary(hci::AddressWithType address) {
+    auto record = database_.FindOrCreate(address);
+    record->SetIsTemporary(true);
+    return record;
+  }
+
+  SecurityRecordDatabase database_{SecurityRecordStorage(nullptr, nullptr)};
+  hci::AddressWithType public_address_{
+      hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}), hci::AddressType::PUBLIC_DEVICE_ADDRESS};
+  hci::AddressWithType identity_address_{
+      hci::Address({0x11, 0x12, 0x13, 0x14, 0x15, 0xc6}), hci::AddressType::RANDOM_DEVICE_ADDRESS};
+};
+
+TEST_F(SecurityRecordDatabaseTest, find_or_create_returns_the_same_record) {
+  ASSERT_EQ(database_.Find(public_address_), database_.records_.end());
+  auto record = FindOrCreateTemporary(public_address_);
+  ASSERT_EQ(database_.FindOrCreate(public_address_), record);
+  ASSERT_EQ(database_.records_.size(), 1u);
+  ASSERT_EQ(*database_.Find(public_address_), record);
+}
+
+TEST_F(SecurityRecordDatabaseTest, keys_distributed_by_pairing_are_indexed_once_saved) {
+  auto rpa = MakeRpa(kIrk, 0x01);
+  auto record = FindOrCreateTemporary(rpa);
+  record->identity_address_ = identity_address_;
+  record->remote_irk = kIrk;
+  database_.SaveRecordsToStorage();
+
+  ASSERT_EQ(*database_.Find(identity_address_), record);
+  ASSERT_EQ(*database_.Find(rpa), record);
+  // A new RPA of the device resolves with its IRK
+  auto next_rpa = MakeRpa(kIrk, 0x02);
+  ASSERT_NE(next_rpa, rpa);
+  ASSERT_EQ(database_.FindOrCreate(next_rpa), record);
+  ASSERT_EQ(database_.records_.size(), 1u);
+}
+
+TEST_F(SecurityRecordDatabaseTest, rpa_of_an_unknown_irk_is_a_new_record) {
+  auto record = FindOrCreateTemporary(public_address_);
+  record->remote_irk = kIrk;
+  database_.SaveRecordsToStorage();
+
+  crypto_toolbox::Octet16 other_irk = kIrk;
+  other_irk[0] ^= 0xff;
+  auto rpa = MakeRpa(other_irk, 0x03);
+  ASSERT_EQ(database_.Find(rpa), database_.records_.end());
+  ASSERT_NE(database_.FindOrCreate(rpa), record);
+  ASSERT_EQ(database_.records_.size(), 2u);
+}
+
+}  // namespace
+}  // namespace record
+}  // namespace security
+}  // namespace bluetooth
@@ -17,6 +17,10 @@
  */
 #include "security/record/security_record_storage.h"
 
+#include <utility>
+#include <vector>
+
+#include "common/bind.h"
 #include "storage/mutation.h"
 
 namespace bluetooth {
@@ -102,29 +106,67 @@ SecurityRecordStorage::SecurityRecordStorage(storage::StorageModule* storage_mod
     : storage_module_(storage_module), handler_(handler) {}
 
 void SecurityRecordStorage::SaveSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records) {
-  for (auto record : *records) {
+  WriteRecords(*records);
+}
+
+void SecurityRecordStorage::SaveSecurityRecord(std::shared_ptr<record::SecurityRecord> record) {
+  if (handler_ == nullptr) {
+    WriteRecords({record});
+    return;
+  }
+  dirty_records_.insert(record);
+  if (!flush_scheduled_) {
+    flush_scheduled_ = true;
+    handler_->Post(common::BindOnce(&SecurityRecordStorage::FlushDirtyRecords, common::Unretained(this)));
+  }
+}
+
+void SecurityRecordStorage::FlushDirtyRecords() {
+  flush_scheduled_ = false;
+  std::set<std::shared_ptr<record::SecurityRecord>> records;
+  records.swap(dirty_records_);
+  WriteRecords(records);
+}
+
+void SecurityRecordStorage::WriteRecords(const std::set<std::shared_ptr<record::SecurityRecord>>& records) {
+  // The classic and LE sections of a device can only be written once its type is stored, so the types go first in a
+  // mutation of their own
+  std::vector<std::pair<std::shared_ptr<record::SecurityRecord>, storage::Device>> devices;
+  auto type_mutation = storage_module_->Modify();
+  bool types_changed = false;
+  for (auto record : records) {
     if (record->IsTemporary()) continue;
     storage::Device device = storage_module_->GetDeviceByClassicMacAddress(record->GetPseudoAddress()->GetAddress());
-    auto mutation = storage_module_->Modify();
 
+    hci::DeviceType device_type;
     if (record->IsClassicLinkKeyValid() && !record->identity_address_) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::BR_EDR));
+      device_type = hci::DeviceType::BR_EDR;
     } else if (record->IsClassicLinkKeyValid() && record->remote_ltk) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::DUAL));
+      device_type = hci::DeviceType::DUAL;
     } else if (!record->IsClassicLinkKeyValid() && record->remote_ltk) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
+      device_type = hci::DeviceType::LE;
     } else {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
+      device_type = hci::DeviceType::LE;
       LOG_WARN(
           "Cannot determine device type from security record for '%s'; defaulting to LE",
           ADDRESS_TO_LOGGABLE_CSTR(*record->GetPseudoAddress()));
     }
-    mutation.Commit();
+    if (device.GetDeviceType() != device_type) {
+      type_mutation.Add(device.SetDeviceType(device_type));
+      types_changed = true;
+    }
+    devices.emplace_back(record, device);
+  }
+  if (devices.empty()) return;
+  if (types_changed) type_mutation.Commit();
+
+  auto mutation = storage_module_->Modify();
+  for (auto& [record, device] : devices) {
     SetClassicData(mutation, record, device);
     SetLeData(mutation, record, device);
     SetAuthenticationData(mutation, record, device);
-    mutation.Commit();
   }
+  mutation.Commit();
 }
 
 void SecurityRecordStorage::LoadSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records) {
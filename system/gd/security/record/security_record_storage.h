@@ -17,6 +17,8 @@
  */
 #pragma once
 
+#include <memory>
+#include <set>
 #include <unordered_map>
 
 #include "hci/hci_packets.h"
@@ -50,6 +52,14 @@ class SecurityRecordStorage {
    */
   void SaveSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records);
 
+  /**
+   * Queues a record that changed to be stored. The records queued while the Handler runs a task are all stored with
+   * the same mutation, once the task is done.
+   *
+   * @param record shared pointer to the record.
+   */
+  void SaveSecurityRecord(std::shared_ptr<record::SecurityRecord> record);
+
   /**
    * Reads the record metadata from disk and converts each item into a SecurityRecord.
    *
@@ -67,8 +77,13 @@ class SecurityRecordStorage {
   void RemoveDevice(hci::AddressWithType address);
 
  private:
+  void FlushDirtyRecords();
+  void WriteRecords(const std::set<std::shared_ptr<record::SecurityRecord>>& records);
+
   storage::StorageModule* storage_module_ __attribute__((unused));
-  os::Handler* handler_ __attribute__((unused));
+  os::Handler* handler_;
+  std::set<std::shared_ptr<record::SecurityRecord>> dirty_records_;
+  bool flush_scheduled_ = false;
 };
 
 }  // namespace record
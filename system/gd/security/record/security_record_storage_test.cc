@@ -78,6 +78,22 @@ TEST_F(DISABLED_SecurityRecordStorageTest, store_security_record) {
   }
 }
 
+TEST_F(DISABLED_SecurityRecordStorageTest, store_single_security_record) {
+  hci::AddressWithType remote(
+      hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x07}), hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  std::array<uint8_t, 16> link_key = {
+      0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0};
+  std::shared_ptr<record::SecurityRecord> record = std::make_shared<record::SecurityRecord>(remote);
+  record->SetLinkKey(link_key, hci::KeyType::DEBUG_COMBINATION);
+
+  // Without a handler the record is written right away
+  record_storage_->SaveSecurityRecord(record);
+
+  auto device = storage_module_->GetDeviceByClassicMacAddress(remote.GetAddress());
+  ASSERT_EQ(hci::DeviceType::BR_EDR, device.GetDeviceType());
+  ASSERT_EQ(device.Classic().GetLinkKeyType(), record->GetKeyType());
+}
+
 TEST_F(DISABLED_SecurityRecordStorageTest, store_le_security_record) {
   hci::AddressWithType identity_address(
       hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}), hci::AddressType::RANDOM_DEVICE_ADDRESS);
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "security/ecdh_key_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include "os/handler.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace security {
+
+class EcdhKeyPoolTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void TearDown() override {
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+  }
+
+  // Runs the handler until every task posted so far, including the refills they post, is done
+  void SyncHandler(EcdhKeyPool* pool, size_t expected_ready) {
+    for (int i = 0; i < 10 && pool->GetReadyKeyPairCount() < expected_ready; i++) {
+      std::promise<void> promise;
+      auto future = promise.get_future();
+      handler_->Post(common::BindOnce([](std::promise<void>* promise) { promise->set_value(); }, &promise));
+      future.wait();
+    }
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+};
+
+TEST_F(EcdhKeyPoolTest, fills_and_refills_pool) {
+  EcdhKeyPool pool(handler_, 2);
+  SyncHandler(&pool, 2);
+  ASSERT_EQ(pool.GetReadyKeyPairCount(), 2u);
+
+  auto [private_key_a, public_key_a] = pool.GetKeyPair();
+  auto [private_key_b, public_key_b] = pool.GetKeyPair();
+  EXPECT_NE(private_key_a, private_key_b);
+  EXPECT_TRUE(ValidateECDHPoint(public_key_a));
+  EXPECT_TRUE(ValidateECDHPoint(public_key_b));
+
+  SyncHandler(&pool, 2);
+  EXPECT_EQ(pool.GetReadyKeyPairCount(), 2u);
+}
+
+TEST_F(EcdhKeyPoolTest, generates_when_empty) {
+  EcdhKeyPool pool(handler_, 2);
+  handler_->Clear();
+
+  auto [private_key, public_key] = pool.GetKeyPair();
+  EXPECT_TRUE(ValidateECDHPoint(public_key));
+}
+
+TEST_F(EcdhKeyPoolTest, no_reuse_by_default) {
+  EcdhKeyPool pool(handler_, 2);
+  SyncHandler(&pool, 2);
+
+  auto [private_key_a, public_key_a] = pool.GetKeyPair();
+  pool.OnPairingFinished(true);
+  auto [private_key_b, public_key_b] = pool.GetKeyPair();
+  EXPECT_NE(private_key_a, private_key_b);
+}
+
+TEST_F(EcdhKeyPoolTest, reused_key_retired_by_score) {
+  EcdhKeyPool pool(handler_, 2, true);
+  SyncHandler(&pool, 2);
+
+  auto [private_key, public_key] = pool.GetKeyPair();
+  pool.OnPairingFinished(true);
+  EXPECT_EQ(pool.GetKeyPair().first, private_key);
+  pool.OnPairingFinished(true);
+  EXPECT_EQ(pool.GetKeyPair().first, private_key);
+  pool.OnPairingFinished(false);
+  EXPECT_EQ(pool.GetKeyPair().first, private_key);
+
+  // 2 successful and 2 failed pairings reach a score of 8
+  pool.OnPairingFinished(false);
+  EXPECT_NE(pool.GetKeyPair().first, private_key);
+}
+
+}  // namespace security
+}  // namespace bluetooth
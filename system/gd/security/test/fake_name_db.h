@@ -33,7 +33,10 @@ class FakeNameDbModule : public neighbor::NameDbModule {
   }
 
   void ReadRemoteNameRequest(
-      hci::Address address, neighbor::ReadRemoteNameDbCallback callback, os::Handler* handler) override {
+      hci::Address address,
+      neighbor::ReadRemoteNameDbCallback callback,
+      os::Handler* handler,
+      neighbor::RemoteNamePriority priority) override {
     handler->Call(std::move(callback), address, true);
   }
 
@@ -17,8 +17,10 @@
 
 #include "dumpsys/dumpsys.h"
 
+#include <chrono>
 #include <future>
 #include <string>
+#include <vector>
 
 #include "dumpsys/filter.h"
 #include "module.h"
@@ -31,6 +33,10 @@ namespace bluetooth {
 namespace shim {
 
 static const std::string kReadOnlyDebuggableProperty = "ro.debuggable";
+static const std::string kStreamingDumpsysProperty = "bluetooth.gd.dumpsys.streaming.enabled";
+static const std::string kModuleBudgetMsProperty = "bluetooth.gd.dumpsys.module_budget_ms";
+// Longest a streaming dumpsys waits for one module before reporting it without data
+static const uint32_t kDefaultModuleBudgetMs = 200;
 
 namespace {
 constexpr char kModuleName[] = "shim::Dumpsys";
@@ -40,6 +46,7 @@ constexpr char kDumpsysTitle[] = "----- Gd Dumpsys ------";
 struct Dumpsys::impl {
  public:
   void DumpWithArgsSync(int fd, const char** args, std::promise<void> promise);
+  void DumpIncrementally(int fd);
   int GetNumberOfBundledSchemas() const;
 
   impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema);
@@ -131,6 +138,35 @@ void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) {
   dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
 }
 
+void Dumpsys::impl::DumpIncrementally(int fd) {
+  const auto registry = dumpsys_module_.GetModuleRegistry();
+  auto budget = std::chrono::milliseconds(os::GetSystemPropertyUint32(kModuleBudgetMsProperty, kDefaultModuleBudgetMs));
+
+  std::vector<ModuleDumpsysSnapshot> timings;
+  ModuleDumper dumper(*registry, kDumpsysTitle);
+  dprintf(fd, " ----- Filtering as Developer -----\n");
+  dumper.DumpStateIncrementally(budget, [this, fd, budget, &timings](const ModuleDumpsysSnapshot& snapshot) {
+    if (snapshot.timed_out) {
+      dprintf(fd, "%s: no dumpsys data within %d ms\n", snapshot.name.c_str(), (int)budget.count());
+    } else {
+      std::string dumpsys_data = snapshot.data;
+      FilterAsDeveloper(&dumpsys_data);
+      dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
+    }
+    timings.push_back({snapshot.name, std::string(), snapshot.duration, snapshot.timed_out});
+  });
+
+  dprintf(fd, " ----- Module Dumpsys Time -----\n");
+  for (const auto& timing : timings) {
+    dprintf(
+        fd,
+        "%s: %lld us%s\n",
+        timing.name.c_str(),
+        (long long)timing.duration.count(),
+        timing.timed_out ? " (timed out)" : "");
+  }
+}
+
 void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
   DumpWithArgsAsync(fd, args);
   promise.set_value();
@@ -143,6 +179,11 @@ void Dumpsys::Dump(int fd, const char** args) {
   if (fd <= 0) {
     return;
   }
+  if (os::GetSystemPropertyBool(kStreamingDumpsysProperty, true)) {
+    // Runs on the calling thread so only the module handlers are held up, each while taking its own snapshot
+    pimpl_->DumpIncrementally(fd);
+    return;
+  }
   std::promise<void> promise;
   auto future = promise.get_future();
   CallOn(pimpl_.get(), &Dumpsys::impl::DumpWithArgsSync, fd, args, std::move(promise));
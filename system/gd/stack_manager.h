@@ -27,6 +27,12 @@ class StackManager {
   void StartUp(ModuleList *modules, os::Thread* stack_thread);
   void ShutDown();
 
+  // Runs the module on |thread| instead of the stack thread. Must be called before StartUp().
+  template <class T>
+  void SetModuleThread(os::Thread* thread) {
+    registry_.SetModuleThread(&T::Factory, thread);
+  }
+
   template <class T>
   T* GetInstance() const {
     return static_cast<T*>(registry_.Get(&T::Factory));
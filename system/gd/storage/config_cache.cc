@@ -16,6 +16,8 @@
 
 #include "storage/config_cache.h"
 
+#include <array>
+#include <atomic>
 #include <ios>
 #include <sstream>
 #include <utility>
@@ -43,6 +45,19 @@ bool InEncryptKeyNameList(std::string key) {
   return kEncryptKeyNameList.find(key) != kEncryptKeyNameList.end();
 }
 
+// Snapshots recently used by this thread, so that readers do not touch any shared reference count while a snapshot
+// stays current. A slot may keep the snapshot of a destroyed config cache alive until it is reused
+struct CachedSnapshot {
+  const void* owner = nullptr;
+  uint64_t generation = 0;
+  std::shared_ptr<const void> snapshot;
+};
+thread_local std::array<CachedSnapshot, 4> tls_cached_snapshots;
+thread_local size_t tls_next_cached_snapshot = 0;
+
+// Starts at 1 since generation 0 means stale
+std::atomic<uint64_t> next_snapshot_generation = 1;
+
 }  // namespace
 
 namespace bluetooth {
@@ -69,15 +84,149 @@ void ConfigCache::SetPersistentConfigChangedCallback(std::function<void()> persi
   persistent_config_changed_callback_ = std::move(persistent_config_changed_callback);
 }
 
+void ConfigCache::EnableSnapshotReads() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  InvalidateSnapshot();
+  snapshot_reads_enabled_ = true;
+}
+
+const ConfigCache::Snapshot* ConfigCache::GetSnapshot() const {
+  if (!snapshot_reads_enabled_.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  uint64_t generation = snapshot_generation_.load(std::memory_order_acquire);
+  if (generation != 0) {
+    for (const auto& cached : tls_cached_snapshots) {
+      if (cached.generation == generation && cached.owner == this) {
+        return static_cast<const Snapshot*>(cached.snapshot.get());
+      }
+    }
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  generation = snapshot_generation_.load(std::memory_order_relaxed);
+  if (generation == 0) {
+    auto copy_section = [](const common::ListMap<std::string, std::string>& section, bool is_persistent_device) {
+      auto snapshot_section = std::make_shared<SnapshotSection>();
+      snapshot_section->is_persistent_device = is_persistent_device;
+      snapshot_section->properties.reserve(section.size());
+      for (const auto& property : section) {
+        snapshot_section->properties.emplace(property.first, property.second);
+      }
+      return snapshot_section;
+    };
+    std::shared_ptr<Snapshot> new_snapshot;
+    if (all_sections_stale_ || last_snapshot_ == nullptr) {
+      new_snapshot = std::make_shared<Snapshot>();
+      new_snapshot->reserve(information_sections_.size() + persistent_devices_.size());
+      for (const auto& section : information_sections_) {
+        new_snapshot->emplace(section.first, copy_section(section.second, false));
+      }
+      for (const auto& section : persistent_devices_) {
+        new_snapshot->emplace(section.first, copy_section(section.second, true));
+      }
+    } else {
+      // Share every section that did not change with the previous snapshot
+      new_snapshot = std::make_shared<Snapshot>(*last_snapshot_);
+      for (const auto& section : stale_sections_) {
+        new_snapshot->erase(section);
+        auto section_iter = information_sections_.find(section);
+        if (section_iter != information_sections_.end()) {
+          new_snapshot->emplace(section, copy_section(section_iter->second, false));
+          continue;
+        }
+        section_iter = persistent_devices_.find(section);
+        if (section_iter != persistent_devices_.end()) {
+          new_snapshot->emplace(section, copy_section(section_iter->second, true));
+        }
+      }
+    }
+    all_sections_stale_ = false;
+    stale_sections_.clear();
+    last_snapshot_ = std::move(new_snapshot);
+    generation = next_snapshot_generation.fetch_add(1, std::memory_order_relaxed);
+    snapshot_generation_.store(generation, std::memory_order_release);
+  }
+
+  auto& cached = tls_cached_snapshots[tls_next_cached_snapshot];
+  tls_next_cached_snapshot = (tls_next_cached_snapshot + 1) % tls_cached_snapshots.size();
+  cached.owner = this;
+  cached.generation = generation;
+  cached.snapshot = last_snapshot_;
+  return last_snapshot_.get();
+}
+
+void ConfigCache::InvalidateSnapshot(const std::string& section) {
+  if (all_sections_stale_) {
+    return;
+  }
+  stale_sections_.insert(section);
+  snapshot_generation_.store(0, std::memory_order_release);
+}
+
+void ConfigCache::InvalidateSnapshot() {
+  all_sections_stale_ = true;
+  stale_sections_.clear();
+  last_snapshot_.reset();
+  snapshot_generation_.store(0, std::memory_order_release);
+}
+
+void ConfigCache::MarkSectionChanged(const std::string& section) {
+  InvalidateSnapshot(section);
+  if (change_tracking_enabled_ && !all_sections_changed_) {
+    changed_sections_.insert(section);
+  }
+}
+
+void ConfigCache::MarkAllSectionsChanged() {
+  InvalidateSnapshot();
+  all_sections_changed_ = true;
+  changed_sections_.clear();
+}
+
+void ConfigCache::EnableChangeTracking() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  change_tracking_enabled_ = true;
+  // Nothing is known about what was saved before, start with a full save
+  all_sections_changed_ = true;
+  changed_sections_.clear();
+}
+
+std::optional<std::vector<ConfigCache::SectionChange>> ConfigCache::TakePersistentChanges() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (!change_tracking_enabled_ || all_sections_changed_) {
+    all_sections_changed_ = false;
+    changed_sections_.clear();
+    return std::nullopt;
+  }
+  std::vector<SectionChange> changes;
+  changes.reserve(changed_sections_.size());
+  for (const auto& section : changed_sections_) {
+    SectionChange change{.section = section};
+    for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+      auto section_iter = config_section->find(section);
+      if (section_iter != config_section->end()) {
+        change.properties.emplace(section_iter->second.begin(), section_iter->second.end());
+        break;
+      }
+    }
+    changes.push_back(std::move(change));
+  }
+  changed_sections_.clear();
+  return changes;
+}
+
 ConfigCache::ConfigCache(ConfigCache&& other) noexcept
     : persistent_config_changed_callback_(nullptr),
       persistent_property_names_(std::move(other.persistent_property_names_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
-      temporary_devices_(std::move(other.temporary_devices_)) {
+      temporary_devices_(std::move(other.temporary_devices_)),
+      snapshot_reads_enabled_(other.snapshot_reads_enabled_.load()) {
   ASSERT_LOG(
       other.persistent_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
+  other.InvalidateSnapshot();
 }
 
 ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
@@ -94,6 +243,9 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
+  snapshot_reads_enabled_ = other.snapshot_reads_enabled_.load();
+  InvalidateSnapshot();
+  other.InvalidateSnapshot();
   return *this;
 }
 
@@ -111,6 +263,7 @@ bool ConfigCache::operator!=(const ConfigCache& rhs) const {
 
 void ConfigCache::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
+  MarkAllSectionsChanged();
   if (information_sections_.size() > 0) {
     information_sections_.clear();
     PersistentConfigChangedCallback();
@@ -125,12 +278,24 @@ void ConfigCache::Clear() {
 }
 
 bool ConfigCache::HasSection(const std::string& section) const {
+  auto snapshot = GetSnapshot();
+  if (snapshot != nullptr && snapshot->find(section) != snapshot->end()) {
+    return true;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   return information_sections_.contains(section) || persistent_devices_.contains(section) ||
          temporary_devices_.contains(section);
 }
 
 bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
+  auto snapshot = GetSnapshot();
+  if (snapshot != nullptr) {
+    auto snapshot_iter = snapshot->find(section);
+    if (snapshot_iter != snapshot->end()) {
+      const auto& properties = snapshot_iter->second->properties;
+      return properties.find(property) != properties.end();
+    }
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
@@ -148,6 +313,22 @@ bool ConfigCache::HasProperty(const std::string& section, const std::string& pro
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
+  auto snapshot = GetSnapshot();
+  if (snapshot != nullptr) {
+    auto snapshot_iter = snapshot->find(section);
+    if (snapshot_iter != snapshot->end()) {
+      const auto& properties = snapshot_iter->second->properties;
+      auto property_iter = properties.find(property);
+      if (property_iter == properties.end()) {
+        return std::nullopt;
+      }
+      if (snapshot_iter->second->is_persistent_device && os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
+          property_iter->second == kEncryptedStr) {
+        return os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + property);
+      }
+      return property_iter->second;
+    }
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
@@ -177,6 +358,73 @@ std::optional<std::string> ConfigCache::GetProperty(const std::string& section,
   return std::nullopt;
 }
 
+std::vector<std::optional<ConfigCache::SectionProperties>> ConfigCache::GetSections(
+    const std::vector<std::string>& sections) const {
+  auto keystore = os::ParameterProvider::GetBtKeystoreInterface();
+  auto decrypt = [keystore](const std::string& section, SectionProperties& properties) {
+    if (keystore == nullptr) {
+      return;
+    }
+    for (auto& [property, value] : properties) {
+      if (value == kEncryptedStr) {
+        value = keystore->get_key(section + "-" + property);
+      }
+    }
+  };
+  auto copy = [](const common::ListMap<std::string, std::string>& section_properties) {
+    SectionProperties properties;
+    properties.reserve(section_properties.size());
+    for (const auto& [property, value] : section_properties) {
+      properties.emplace(property, value);
+    }
+    return properties;
+  };
+
+  std::vector<std::optional<SectionProperties>> result(sections.size());
+  // Sections that are not in the snapshot are read under a single lock
+  std::vector<size_t> unresolved;
+  auto snapshot = GetSnapshot();
+  for (size_t i = 0; i < sections.size(); i++) {
+    if (snapshot == nullptr) {
+      unresolved.push_back(i);
+      continue;
+    }
+    auto snapshot_iter = snapshot->find(sections[i]);
+    if (snapshot_iter == snapshot->end()) {
+      unresolved.push_back(i);
+      continue;
+    }
+    result[i] = snapshot_iter->second->properties;
+    if (snapshot_iter->second->is_persistent_device) {
+      decrypt(sections[i], *result[i]);
+    }
+  }
+  if (unresolved.empty()) {
+    return result;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  for (size_t i : unresolved) {
+    const auto& section = sections[i];
+    auto section_iter = information_sections_.find(section);
+    if (section_iter != information_sections_.end()) {
+      result[i] = copy(section_iter->second);
+      continue;
+    }
+    section_iter = persistent_devices_.find(section);
+    if (section_iter != persistent_devices_.end()) {
+      result[i] = copy(section_iter->second);
+      decrypt(section, *result[i]);
+      continue;
+    }
+    section_iter = temporary_devices_.find(section);
+    if (section_iter != temporary_devices_.end()) {
+      result[i] = copy(section_iter->second);
+    }
+  }
+  return result;
+}
+
 void ConfigCache::SetProperty(std::string section, std::string property, std::string value) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   TrimAfterNewLine(section);
@@ -190,6 +438,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
     }
     section_iter->second.insert_or_assign(property, std::move(value));
+    MarkSectionChanged(section);
     PersistentConfigChangedCallback();
     return;
   }
@@ -213,6 +462,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       }
     }
     section_iter->second.insert_or_assign(property, std::move(value));
+    MarkSectionChanged(section);
     PersistentConfigChangedCallback();
     return;
   }
@@ -228,6 +478,7 @@ bool ConfigCache::RemoveSection(const std::string& section) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   // sections are unique among all three maps, hence removing from one of them is enough
   if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
+    MarkSectionChanged(section);
     PersistentConfigChangedCallback();
     return true;
   } else {
@@ -245,6 +496,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       information_sections_.erase(section_iter);
     }
     if (value.has_value()) {
+      MarkSectionChanged(section);
       PersistentConfigChangedCallback();
       return true;
     } else {
@@ -263,6 +515,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
     }
     if (value.has_value()) {
+      MarkSectionChanged(section);
       PersistentConfigChangedCallback();
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && os::ParameterProvider::IsCommonCriteriaMode() &&
           InEncryptKeyNameList(property)) {
@@ -328,6 +581,7 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     for (auto it = config_section->begin(); it != config_section->end();) {
       if (it->second.contains(property)) {
         LOG_INFO("Removing persistent section %s with property %s", it->first.c_str(), property.c_str());
+        MarkSectionChanged(it->first);
         it = config_section->erase(it);
         num_persistent_removed++;
         continue;
@@ -473,6 +727,7 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto& elem : *config_section) {
       if (FixDeviceTypeInconsistencyInSection(elem.first, elem.second)) {
+        MarkSectionChanged(elem.first);
         persistent_device_changed = true;
       }
     }
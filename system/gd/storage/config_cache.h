@@ -15,13 +15,17 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -73,6 +77,10 @@ class ConfigCache {
   virtual bool HasProperty(const std::string& section, const std::string& property) const;
   // Get property, return std::nullopt if section or property does not exist
   virtual std::optional<std::string> GetProperty(const std::string& section, const std::string& property) const;
+  // Get all properties of each of |sections| at once, std::nullopt for sections that do not exist. Like GetProperty(),
+  // encrypted values are returned decrypted
+  using SectionProperties = std::unordered_map<std::string, std::string>;
+  virtual std::vector<std::optional<SectionProperties>> GetSections(const std::vector<std::string>& sections) const;
   // Returns a copy of persistent device MAC addresses
   virtual std::vector<std::string> GetPersistentSections() const;
   // Return true if a section is persistent
@@ -111,6 +119,22 @@ class ConfigCache {
   virtual void Clear();
   // Set a callback to notify interested party that a persistent config change has just happened
   virtual void SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback);
+  // Serve HasSection(), HasProperty() and GetProperty() for information and persistent sections from an immutable
+  // snapshot instead of taking the config mutex. Writers stay serialized on the mutex and only mark the sections they
+  // touch as stale; the first reader after a write rebuilds those sections and shares the rest with the previous
+  // snapshot. Temporary devices are always read under the mutex since reads refresh their position in the LRU cache.
+  void EnableSnapshotReads();
+  // Record which information and persistent sections change from now on so that they can be saved incrementally. The
+  // first TakePersistentChanges() after this returns std::nullopt, as nothing is known about what was saved before
+  void EnableChangeTracking();
+  struct SectionChange {
+    std::string section;
+    // Current properties of |section|, std::nullopt if it was removed or is no longer persistent
+    std::optional<std::vector<std::pair<std::string, std::string>>> properties;
+  };
+  // Return the current content of every information or persistent section changed since the previous call, or
+  // std::nullopt if change tracking is off or the changes can only be saved by writing the whole config
+  virtual std::optional<std::vector<SectionChange>> TakePersistentChanges();
 
   // Device config specific methods
   // TODO: methods here should be moved to a device specific config cache if this config cache is supposed to be generic
@@ -139,6 +163,40 @@ class ConfigCache {
   // if capacity exceeds given value during initialization
   common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
 
+  // Immutable copy of an information or persistent section
+  struct SnapshotSection {
+    bool is_persistent_device;
+    std::unordered_map<std::string, std::string> properties;
+  };
+  using Snapshot = std::unordered_map<std::string, std::shared_ptr<const SnapshotSection>>;
+
+  std::atomic<bool> snapshot_reads_enabled_ = false;
+  // Generation of last_snapshot_, or 0 when it is stale. Generations are unique across all config caches so readers
+  // can cache the snapshot per thread and only need this one load to know it is still current
+  mutable std::atomic<uint64_t> snapshot_generation_ = 0;
+  // Last snapshot that was built and the sections that changed since then, guarded by mutex_
+  mutable std::shared_ptr<const Snapshot> last_snapshot_;
+  mutable std::unordered_set<std::string> stale_sections_;
+  mutable bool all_sections_stale_ = true;
+
+  // Returns the current snapshot, rebuilding it under the mutex if it is stale, or nullptr if snapshot reads are off.
+  // The snapshot stays valid until the calling thread asks for a snapshot again
+  const Snapshot* GetSnapshot() const;
+  // Must be called with mutex_ held after |section| is modified
+  void InvalidateSnapshot(const std::string& section);
+  // Must be called with mutex_ held after sections are modified in bulk
+  void InvalidateSnapshot();
+
+  // Sections changed since the last TakePersistentChanges(), guarded by mutex_
+  bool change_tracking_enabled_ = false;
+  bool all_sections_changed_ = true;
+  std::unordered_set<std::string> changed_sections_;
+
+  // Must be called with mutex_ held after an information or persistent section is modified
+  void MarkSectionChanged(const std::string& section);
+  // Must be called with mutex_ held after information or persistent sections are modified in bulk
+  void MarkAllSectionsChanged();
+
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
     if (persistent_config_changed_callback_) {
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "storage/config_cache.h"
+#include "storage/device.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace storage {
+namespace {
+
+constexpr int kNumBondedDevices = 300;
+
+std::string GetBondedAddress(int i) {
+  char address[18];
+  std::snprintf(address, sizeof(address), "AA:BB:CC:DD:%02X:%02X", (i >> 8) & 0xff, i & 0xff);
+  return address;
+}
+
+std::unique_ptr<ConfigCache> MakeConfigCache(bool snapshot_reads) {
+  auto config = std::make_unique<ConfigCache>(100, Device::kLinkKeyProperties);
+  if (snapshot_reads) {
+    config->EnableSnapshotReads();
+  }
+  config->SetProperty("Adapter", "Address", "01:02:03:04:05:06");
+  for (int i = 0; i < kNumBondedDevices; i++) {
+    auto address = GetBondedAddress(i);
+    config->SetProperty(address, "LinkKey", "0123456789abcdef0123456789abcdef");
+    config->SetProperty(address, "LinkKeyType", "4");
+    config->SetProperty(address, "DevType", "1");
+    config->SetProperty(address, "Name", "Device " + std::to_string(i));
+    config->SetProperty(address, "LE_KEY_PENC", "0123456789abcdef0123456789abcdef0123456789abcdef");
+  }
+  return config;
+}
+
+// Shared by all threads of a benchmark run, created and destroyed by thread 0
+std::unique_ptr<ConfigCache> g_config;
+std::vector<std::string> g_addresses;
+
+void SetUpConfig(State& state, bool snapshot_reads) {
+  if (state.thread_index() == 0) {
+    g_config = MakeConfigCache(snapshot_reads);
+    g_addresses.clear();
+    for (int i = 0; i < kNumBondedDevices; i++) {
+      g_addresses.push_back(GetBondedAddress(i));
+    }
+  }
+}
+
+void TearDownConfig(State& state) {
+  if (state.thread_index() == 0) {
+    g_config.reset();
+  }
+}
+
+void RunPropertyLookups(State& state, bool snapshot_reads) {
+  SetUpConfig(state, snapshot_reads);
+  size_t i = state.thread_index();
+  for (auto _ : state) {
+    const auto& address = g_addresses[i % g_addresses.size()];
+    ::benchmark::DoNotOptimize(g_config->GetProperty(address, "LinkKey"));
+    i += 7;
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownConfig(state);
+}
+
+// One writer thread keeps updating a property while the other threads look up link keys
+void RunPropertyLookupsWithWriter(State& state, bool snapshot_reads) {
+  SetUpConfig(state, snapshot_reads);
+  size_t i = state.thread_index();
+  for (auto _ : state) {
+    const auto& address = g_addresses[i % g_addresses.size()];
+    if (state.thread_index() == 0) {
+      g_config->SetProperty(address, "Name", std::to_string(i));
+    } else {
+      ::benchmark::DoNotOptimize(g_config->GetProperty(address, "LinkKey"));
+    }
+    i += 7;
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownConfig(state);
+}
+
+void BM_ConfigCache_GetProperty_Locked(State& state) {
+  RunPropertyLookups(state, false);
+}
+
+void BM_ConfigCache_GetProperty_Snapshot(State& state) {
+  RunPropertyLookups(state, true);
+}
+
+void BM_ConfigCache_GetPropertyWithWriter_Locked(State& state) {
+  RunPropertyLookupsWithWriter(state, false);
+}
+
+void BM_ConfigCache_GetPropertyWithWriter_Snapshot(State& state) {
+  RunPropertyLookupsWithWriter(state, true);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ConfigCache_GetProperty_Locked)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ConfigCache_GetProperty_Snapshot)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ConfigCache_GetPropertyWithWriter_Locked)->ThreadRange(2, 8)->UseRealTime();
+BENCHMARK(BM_ConfigCache_GetPropertyWithWriter_Snapshot)->ThreadRange(2, 8)->UseRealTime();
+
+}  // namespace storage
+}  // namespace bluetooth
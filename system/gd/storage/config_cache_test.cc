@@ -19,7 +19,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 #include "hci/enum_helper.h"
 #include "storage/device.h"
@@ -413,4 +416,113 @@ TEST(ConfigCacheTest, test_empty_persistent_properties) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre());
 }
 
+TEST(ConfigCacheTest, snapshot_reads_follow_writes_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.EnableSnapshotReads();
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Hello");
+  ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+  ASSERT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Hello")));
+  ASSERT_TRUE(config.HasProperty("AA:BB:CC:DD:EE:FF", "LinkKey"));
+  ASSERT_FALSE(config.HasProperty("AA:BB:CC:DD:EE:FF", "DevType"));
+
+  // Each write must be visible to the next read
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Hello 2");
+  ASSERT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Hello 2")));
+  ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+  ASSERT_TRUE(config.RemoveProperty("AA:BB:CC:DD:EE:FF", "Name"));
+  ASSERT_FALSE(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"));
+  ASSERT_TRUE(config.RemoveSection("A"));
+  ASSERT_FALSE(config.HasSection("A"));
+
+  // Removing the link key moves the device back to the temporary devices
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Hello 3");
+  ASSERT_TRUE(config.RemoveProperty("AA:BB:CC:DD:EE:FF", "LinkKey"));
+  ASSERT_FALSE(config.IsPersistentSection("AA:BB:CC:DD:EE:FF"));
+  ASSERT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Hello 3")));
+
+  config.Clear();
+  ASSERT_FALSE(config.HasSection("AA:BB:CC:DD:EE:FF"));
+}
+
+TEST(ConfigCacheTest, snapshot_reads_keep_warming_temporary_devices_test) {
+  ConfigCache config(2, Device::kLinkKeyProperties);
+  config.EnableSnapshotReads();
+  config.SetProperty("CC:DD:EE:FF:00:10", "Name", "Hello");
+  config.SetProperty("CC:DD:EE:FF:00:09", "Name", "Hello 2");
+  // Reading the oldest temporary device must keep it from being evicted next
+  ASSERT_TRUE(config.GetProperty("CC:DD:EE:FF:00:10", "Name"));
+  config.SetProperty("CC:DD:EE:FF:00:11", "Name", "Hello 3");
+  ASSERT_TRUE(config.HasSection("CC:DD:EE:FF:00:10"));
+  ASSERT_FALSE(config.HasSection("CC:DD:EE:FF:00:09"));
+}
+
+TEST(ConfigCacheTest, get_sections_test) {
+  for (bool snapshot_reads : {false, true}) {
+    ConfigCache config(100, Device::kLinkKeyProperties);
+    if (snapshot_reads) {
+      config.EnableSnapshotReads();
+    }
+    config.SetProperty("A", "B", "C");
+    config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+    config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Hello");
+    config.SetProperty("CC:DD:EE:FF:00:10", "Name", "Hello 2");
+
+    auto sections = config.GetSections({"AA:BB:CC:DD:EE:FF", "CC:DD:EE:FF:00:10", "A", "CC:DD:EE:FF:00:11"});
+    ASSERT_EQ(sections.size(), 4u);
+    ASSERT_TRUE(sections[0]);
+    ASSERT_THAT(*sections[0], UnorderedElementsAre(Pair("LinkKey", "AABBAABBCCDDEE"), Pair("Name", "Hello")));
+    ASSERT_TRUE(sections[1]);
+    ASSERT_THAT(*sections[1], UnorderedElementsAre(Pair("Name", "Hello 2")));
+    ASSERT_TRUE(sections[2]);
+    ASSERT_THAT(*sections[2], UnorderedElementsAre(Pair("B", "C")));
+    ASSERT_FALSE(sections[3]);
+
+    // Sections are read again after a write
+    config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Hello 3");
+    sections = config.GetSections({"AA:BB:CC:DD:EE:FF"});
+    ASSERT_THAT(*sections[0], Contains(Pair("Name", "Hello 3")));
+  }
+}
+
+TEST(ConfigCacheTest, snapshot_reads_concurrent_with_writes_test) {
+  constexpr int kNumDevices = 100;
+  constexpr int kNumWrites = 1000;
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.EnableSnapshotReads();
+  for (int i = 0; i < kNumDevices; i++) {
+    config.SetProperty(GetTestAddress(i), "LinkKey", "AABBAABBCCDDEE");
+    config.SetProperty(GetTestAddress(i), "Counter", "0");
+  }
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; r++) {
+    readers.emplace_back([&config, &done, r]() {
+      int last_seen = 0;
+      while (!done) {
+        auto value = config.GetProperty(GetTestAddress(r), "Counter");
+        ASSERT_TRUE(value);
+        int counter = std::stoi(*value);
+        // Writes to a single section are observed in order
+        ASSERT_GE(counter, last_seen);
+        last_seen = counter;
+        ASSERT_TRUE(config.HasProperty(GetTestAddress(kNumDevices - 1 - r), "LinkKey"));
+      }
+    });
+  }
+  for (int i = 1; i <= kNumWrites; i++) {
+    for (int r = 0; r < 4; r++) {
+      config.SetProperty(GetTestAddress(r), "Counter", std::to_string(i));
+    }
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  for (int r = 0; r < 4; r++) {
+    ASSERT_THAT(config.GetProperty(GetTestAddress(r), "Counter"), Optional(StrEq(std::to_string(kNumWrites))));
+  }
+}
+
 }  // namespace testing
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr char kHeaderPrefix[] = "#journal ";
+constexpr char kCommitLine[] = "#commit";
+
+std::string HeaderLine(uint64_t config_checksum) {
+  char checksum[17];
+  std::snprintf(checksum, sizeof(checksum), "%016" PRIx64, config_checksum);
+  return std::string(kHeaderPrefix) + checksum;
+}
+
+}  // namespace
+
+ConfigJournal::ConfigJournal(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+uint64_t ConfigJournal::Checksum(const std::string& serialized_config) {
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : serialized_config) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool ConfigJournal::Replay(uint64_t config_checksum, ConfigCache* cache) {
+  ASSERT(cache != nullptr);
+  auto journal = os::ReadSmallFile(path_);
+  if (!journal) {
+    return false;
+  }
+  std::istringstream stream(*journal);
+  std::string line;
+  if (!std::getline(stream, line) || line != HeaderLine(config_checksum)) {
+    LOG_WARN("journal at \"%s\" does not apply to the current config file", path_.c_str());
+    return false;
+  }
+
+  std::vector<ConfigCache::SectionChange> committed;
+  std::vector<ConfigCache::SectionChange> pending;
+  int line_num = 1;
+  while (std::getline(stream, line)) {
+    ++line_num;
+    line = common::StringTrim(std::move(line));
+    if (line.empty()) {
+      continue;
+    }
+    if (line == kCommitLine) {
+      std::move(pending.begin(), pending.end(), std::back_inserter(committed));
+      pending.clear();
+    } else if (line.front() == '[' || (line.front() == '-' && line.size() > 1 && line[1] == '[')) {
+      bool removed = line.front() == '-';
+      if (line.back() != ']') {
+        LOG_WARN("unterminated section name on line %d, discarding the rest of the journal", line_num);
+        break;
+      }
+      size_t start = removed ? 2 : 1;
+      ConfigCache::SectionChange change{.section = line.substr(start, line.size() - start - 1)};
+      if (!removed) {
+        change.properties.emplace();
+      }
+      pending.push_back(std::move(change));
+    } else {
+      auto tokens = common::StringSplit(line, "=", 2);
+      if (tokens.size() != 2 || pending.empty() || !pending.back().properties) {
+        LOG_WARN("unexpected record on line %d, discarding the rest of the journal", line_num);
+        break;
+      }
+      pending.back().properties->emplace_back(
+          common::StringTrim(std::move(tokens[0])), common::StringTrim(std::move(tokens[1])));
+    }
+  }
+  if (!pending.empty()) {
+    LOG_WARN("discarding %zu incomplete section records at the end of the journal", pending.size());
+  }
+
+  for (const auto& change : committed) {
+    cache->RemoveSection(change.section);
+    if (change.properties) {
+      for (const auto& [key, value] : *change.properties) {
+        cache->SetProperty(change.section, key, value);
+      }
+    }
+  }
+  size_ = journal->size();
+  LOG_INFO("replayed %zu section records from \"%s\"", committed.size(), path_.c_str());
+  return true;
+}
+
+bool ConfigJournal::Append(uint64_t config_checksum, const std::vector<ConfigCache::SectionChange>& changes) {
+  std::stringstream serialized;
+  if (size_ == 0) {
+    // Never append to a journal whose base is unknown
+    if (os::FileExists(path_) && !os::RemoveFile(path_)) {
+      return false;
+    }
+    serialized << HeaderLine(config_checksum) << "\n";
+  }
+  for (const auto& change : changes) {
+    if (change.properties) {
+      serialized << "[" << change.section << "]\n";
+      for (const auto& [key, value] : *change.properties) {
+        serialized << key << " = " << value << "\n";
+      }
+    } else {
+      serialized << "-[" << change.section << "]\n";
+    }
+  }
+  serialized << kCommitLine << "\n";
+  std::string data = serialized.str();
+  if (!os::AppendToFile(path_, data)) {
+    // The journal may now end with a partial record, start a new one next time
+    size_ = 0;
+    return false;
+  }
+  size_ += data.size();
+  return true;
+}
+
+bool ConfigJournal::Delete() {
+  size_ = 0;
+  if (!os::FileExists(path_)) {
+    return true;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Append-only log of the config sections changed since the config file was last written in full
+//
+// Each record is appended and synced on its own, so saving a change costs a write proportional to the sections that
+// changed instead of the whole config. The journal is tied to the exact config file content it applies on top of,
+// and is simply ignored if that file was rewritten since, so it is always safe to delete.
+//
+// Format, similar to INI:
+//   #journal <checksum>   first line, checksum of the config file this journal applies on top of
+//   [section]             replace |section| with the key = value lines that follow
+//   key = value
+//   -[section]            remove |section|
+//   #commit               end of an append; anything after the last one was cut by a crash and is discarded
+class ConfigJournal {
+ public:
+  explicit ConfigJournal(std::string path);
+
+  // Checksum of serialized config file content, stable across builds
+  static uint64_t Checksum(const std::string& serialized_config);
+
+  // Apply every complete append to |cache| if the journal was started on top of a config file with checksum
+  // |config_checksum|. Return false without touching |cache| if there is no such journal
+  bool Replay(uint64_t config_checksum, ConfigCache* cache);
+
+  // Append |changes| and sync them to disk, starting a new journal on top of |config_checksum| if there is none
+  bool Append(uint64_t config_checksum, const std::vector<ConfigCache::SectionChange>& changes);
+
+  // Remove the journal, if any
+  bool Delete();
+
+  // Bytes in the journal
+  size_t GetSize() const {
+    return size_;
+  }
+
+ private:
+  std::string path_;
+  size_t size_ = 0;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
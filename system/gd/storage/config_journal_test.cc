@@ -0,0 +1,143 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+
+namespace testing {
+
+using bluetooth::os::AppendToFile;
+using bluetooth::os::ReadSmallFile;
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
+using bluetooth::storage::Device;
+
+class ConfigJournalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    journal_path_ = std::filesystem::temp_directory_path() / "temp_config.journal";
+    std::filesystem::remove(journal_path_);
+    base_.EnableChangeTracking();
+    base_.SetProperty("Adapter", "Address", "01:02:03:04:05:06");
+    base_.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+    base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Keyboard");
+    base_.SetProperty("01:02:03:AA:BB:CC", "LinkKey", "CCDDCCDDEEFF");
+    // Changes up to here are in the base config file
+    EXPECT_FALSE(base_.TakePersistentChanges());
+    checksum_ = ConfigJournal::Checksum(base_.SerializeToLegacyFormat());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(journal_path_);
+  }
+
+  ConfigCache ReadBase() {
+    ConfigCache config(100, Device::kLinkKeyProperties);
+    config.SetProperty("Adapter", "Address", "01:02:03:04:05:06");
+    config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+    config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Keyboard");
+    config.SetProperty("01:02:03:AA:BB:CC", "LinkKey", "CCDDCCDDEEFF");
+    return config;
+  }
+
+  std::filesystem::path journal_path_;
+  ConfigCache base_{100, Device::kLinkKeyProperties};
+  uint64_t checksum_ = 0;
+};
+
+TEST_F(ConfigJournalTest, checksum_is_content_dependent) {
+  EXPECT_EQ(ConfigJournal::Checksum("[Adapter]\n"), ConfigJournal::Checksum("[Adapter]\n"));
+  EXPECT_NE(ConfigJournal::Checksum("[Adapter]\n"), ConfigJournal::Checksum("[Adapter] \n"));
+}
+
+TEST_F(ConfigJournalTest, append_and_replay_loop_back_test) {
+  ConfigJournal journal(journal_path_.string());
+  base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Mouse");
+  base_.SetProperty("11:22:33:44:55:66", "LinkKey", "0011223344");
+  auto changes = base_.TakePersistentChanges();
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(journal.Append(checksum_, *changes));
+
+  base_.RemoveSection("01:02:03:AA:BB:CC");
+  changes = base_.TakePersistentChanges();
+  ASSERT_TRUE(changes);
+  EXPECT_TRUE(journal.Append(checksum_, *changes));
+  EXPECT_EQ(journal.GetSize(), ReadSmallFile(journal_path_.string())->size());
+
+  auto config = ReadBase();
+  ConfigJournal replayed(journal_path_.string());
+  EXPECT_TRUE(replayed.Replay(checksum_, &config));
+  EXPECT_EQ(replayed.GetSize(), journal.GetSize());
+  // Replaced sections move to the end, so compare content rather than serialized order
+  EXPECT_THAT(config.GetPersistentSections(), UnorderedElementsAre("AA:BB:CC:DD:EE:FF", "11:22:33:44:55:66"));
+  EXPECT_THAT(config.GetProperty("11:22:33:44:55:66", "LinkKey"), Optional(StrEq("0011223344")));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Mouse")));
+  EXPECT_FALSE(config.HasSection("01:02:03:AA:BB:CC"));
+}
+
+TEST_F(ConfigJournalTest, replay_ignores_journal_of_other_config_file) {
+  ConfigJournal journal(journal_path_.string());
+  base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Mouse");
+  EXPECT_TRUE(journal.Append(checksum_, *base_.TakePersistentChanges()));
+
+  auto config = ReadBase();
+  EXPECT_FALSE(ConfigJournal(journal_path_.string()).Replay(checksum_ + 1, &config));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Keyboard")));
+
+  std::filesystem::remove(journal_path_);
+  EXPECT_FALSE(ConfigJournal(journal_path_.string()).Replay(checksum_, &config));
+}
+
+TEST_F(ConfigJournalTest, replay_discards_incomplete_append) {
+  ConfigJournal journal(journal_path_.string());
+  base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Mouse");
+  EXPECT_TRUE(journal.Append(checksum_, *base_.TakePersistentChanges()));
+  // Simulate a crash in the middle of an append
+  EXPECT_TRUE(AppendToFile(journal_path_.string(), "[AA:BB:CC:DD:EE:FF]\nName = Tra"));
+
+  auto config = ReadBase();
+  EXPECT_TRUE(ConfigJournal(journal_path_.string()).Replay(checksum_, &config));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Mouse")));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+}
+
+TEST_F(ConfigJournalTest, delete_starts_new_journal) {
+  ConfigJournal journal(journal_path_.string());
+  base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Mouse");
+  EXPECT_TRUE(journal.Append(checksum_, *base_.TakePersistentChanges()));
+  EXPECT_TRUE(journal.Delete());
+  EXPECT_FALSE(std::filesystem::exists(journal_path_));
+  EXPECT_EQ(journal.GetSize(), 0u);
+
+  uint64_t new_checksum = ConfigJournal::Checksum(base_.SerializeToLegacyFormat());
+  base_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Trackpad");
+  EXPECT_TRUE(journal.Append(new_checksum, *base_.TakePersistentChanges()));
+
+  auto config = ReadBase();
+  EXPECT_FALSE(ConfigJournal(journal_path_.string()).Replay(checksum_, &config));
+  EXPECT_TRUE(ConfigJournal(journal_path_.string()).Replay(new_checksum, &config));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "Name"), Optional(StrEq("Trackpad")));
+}
+
+}  // namespace testing
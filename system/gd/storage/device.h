@@ -184,6 +184,8 @@ class Device {
  public:
   // Macro generate getters, setters and removers
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER(Name, std::string, "Name");
+  // unix timestamp in seconds from epoch of the last time Name was learnt from the remote
+  GENERATE_PROPERTY_GETTER_SETTER_REMOVER(NameUnixTimestamp, int64_t, "NameTimestamp");
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER(ClassOfDevice, hci::ClassOfDevice, "DevClass");
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER_WITH_CUSTOM_SETTER(DeviceType, hci::DeviceType, "DevType", {
     return static_cast<hci::DeviceType>(value | GetDeviceType().value_or(hci::DeviceType::UNKNOWN));
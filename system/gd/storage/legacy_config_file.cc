@@ -16,14 +16,19 @@
 
 #include "storage/legacy_config_file.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <cerrno>
-#include <fstream>
-#include <sstream>
+#include <cstring>
+#include <string_view>
 
-#include "common/strings.h"
 #include "os/files.h"
 #include "os/log.h"
 #include "storage/device.h"
+#include "storage/legacy_config_parser.h"
 
 namespace bluetooth {
 namespace storage {
@@ -34,42 +39,45 @@ LegacyConfigFile::LegacyConfigFile(std::string path) : path_(std::move(path)) {
 
 std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity) {
   ASSERT(!path_.empty());
-  std::ifstream config_file(path_);
-  if (!config_file || !config_file.is_open()) {
+  int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG_ERROR("unable to open file '%s', error: %s", path_.c_str(), strerror(errno));
     return std::nullopt;
   }
-  [[maybe_unused]] int line_num = 0;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    LOG_ERROR("unable to stat file '%s', error: %s", path_.c_str(), strerror(errno));
+    close(fd);
+    return std::nullopt;
+  }
+  // The file is replaced by a rename when written, so the mapping cannot change under the parser
+  size_t size = file_stat.st_size;
+  void* data = nullptr;
+  if (size != 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG_ERROR("unable to map file '%s', error: %s", path_.c_str(), strerror(errno));
+    return std::nullopt;
+  }
+
   ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
-  std::string line;
   std::string section(ConfigCache::kDefaultSectionName);
-  while (std::getline(config_file, line)) {
-    ++line_num;
-    line = common::StringTrim(std::move(line));
-    if (line.empty()) {
-      continue;
-    }
-
-    if (line.front() == '\0' || line.front() == '#') {
-      continue;
-    }
-    if (line.front() == '[') {
-      if (line.back() != ']') {
-        LOG_WARN("unterminated section name on line %d", line_num);
-        return std::nullopt;
-      }
-      // Read 'test' from '[text]', hence -2
-      section = line.substr(1, line.size() - 2);
-    } else {
-      auto tokens = common::StringSplit(line, "=", 2);
-      if (tokens.size() != 2) {
-        LOG_WARN("no key/value separator found on line %d", line_num);
-        return std::nullopt;
-      }
-      tokens[0] = common::StringTrim(std::move(tokens[0]));
-      tokens[1] = common::StringTrim(std::move(tokens[1]));
-      cache.SetProperty(section, tokens[0], std::move(tokens[1]));
-    }
+  int error_line = 0;
+  bool parsed = ParseLegacyConfig(
+      std::string_view(static_cast<const char*>(data), size),
+      [&section](std::string_view name) { section = name; },
+      [&cache, &section](std::string_view key, std::string_view value) {
+        cache.SetProperty(section, std::string(key), std::string(value));
+      },
+      &error_line);
+  if (data != nullptr) {
+    munmap(data, size);
+  }
+  if (!parsed) {
+    LOG_WARN("malformed line %d in '%s'", error_line, path_.c_str());
+    return std::nullopt;
   }
   return cache;
 }
@@ -184,4 +184,29 @@ TEST(LegacyConfigFileTest, duplicate_section_and_key_test) {
   EXPECT_TRUE(std::filesystem::remove(temp_config));
 }
 
+TEST(LegacyConfigFileTest, read_empty_file_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_config = temp_dir / "temp_config.txt";
+  ASSERT_TRUE(WriteToFile(temp_config.string(), ""));
+
+  auto config_read = LegacyConfigFile::FromPath(temp_config.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  EXPECT_THAT(config_read->GetPersistentSections(), ElementsAre());
+
+  EXPECT_TRUE(std::filesystem::remove(temp_config));
+}
+
+TEST(LegacyConfigFileTest, read_malformed_file_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_config = temp_dir / "temp_config.txt";
+
+  ASSERT_TRUE(WriteToFile(temp_config.string(), "[Info]\nFileSource = Empty\n[Adapter\n"));
+  EXPECT_FALSE(LegacyConfigFile::FromPath(temp_config.string()).Read(100));
+
+  ASSERT_TRUE(WriteToFile(temp_config.string(), "[Info]\nFileSource Empty\n"));
+  EXPECT_FALSE(LegacyConfigFile::FromPath(temp_config.string()).Read(100));
+
+  EXPECT_TRUE(std::filesystem::remove(temp_config));
+}
+
 }  // namespace testing
\ No newline at end of file
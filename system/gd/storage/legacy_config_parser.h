@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string_view>
+
+namespace bluetooth {
+namespace storage {
+
+namespace legacy_config_parser_internal {
+
+inline std::string_view Trim(std::string_view text) {
+  constexpr std::string_view kWhitespaces = " \t\n\v\f\r";
+  auto begin = text.find_first_not_of(kWhitespaces);
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  auto end = text.find_last_not_of(kWhitespaces);
+  return text.substr(begin, end - begin + 1);
+}
+
+}  // namespace legacy_config_parser_internal
+
+// Parses the text of a config file in the legacy INI-like format, shared by the legacy and the GD stacks:
+//
+//   # comment
+//   [section]
+//   key = value
+//
+// |on_section(std::string_view name)| is called for each section header and |on_entry(std::string_view key,
+// std::string_view value)| for each entry, which belongs to the last section announced, or to the default section of
+// the caller before the first header. Names, keys and values are trimmed views into |text|, nothing is copied unless
+// the callbacks do.
+//
+// Returns false on the first malformed line, after setting |error_line| to its number if it is not null.
+template <typename OnSection, typename OnEntry>
+bool ParseLegacyConfig(std::string_view text, OnSection on_section, OnEntry on_entry, int* error_line = nullptr) {
+  int line_num = 0;
+  while (!text.empty()) {
+    auto line_end = text.find('\n');
+    auto line = legacy_config_parser_internal::Trim(text.substr(0, line_end));
+    text.remove_prefix(line_end == std::string_view::npos ? text.size() : line_end + 1);
+    ++line_num;
+
+    // Skip blank and comment lines
+    if (line.empty() || line.front() == '\0' || line.front() == '#') {
+      continue;
+    }
+
+    if (line.front() == '[') {
+      if (line.back() != ']') {
+        if (error_line != nullptr) {
+          *error_line = line_num;
+        }
+        return false;
+      }
+      on_section(line.substr(1, line.size() - 2));
+      continue;
+    }
+
+    auto split = line.find('=');
+    if (split == std::string_view::npos) {
+      if (error_line != nullptr) {
+        *error_line = line_num;
+      }
+      return false;
+    }
+    on_entry(
+        legacy_config_parser_internal::Trim(line.substr(0, split)),
+        legacy_config_parser_internal::Trim(line.substr(split + 1)));
+  }
+  return true;
+}
+
+}  // namespace storage
+}  // namespace bluetooth
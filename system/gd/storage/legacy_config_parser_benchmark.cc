@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "benchmark/benchmark.h"
+#include "os/files.h"
+#include "storage/legacy_config_file.h"
+#include "storage/legacy_config_parser.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace storage {
+namespace {
+
+constexpr int kNumBondedDevices = 300;
+
+std::string MakeConfigText() {
+  std::string text = "[Info]\nFileSource = Empty\n\n[Adapter]\nAddress = 01:02:03:04:05:06\n\n";
+  for (int i = 0; i < kNumBondedDevices; i++) {
+    char address[18];
+    std::snprintf(address, sizeof(address), "AA:BB:CC:DD:%02X:%02X", (i >> 8) & 0xff, i & 0xff);
+    text += "[" + std::string(address) + "]\n";
+    text += "Name = Device " + std::to_string(i) + "\n";
+    text += "DevType = 1\n";
+    text += "LinkKeyType = 4\n";
+    text += "LinkKey = 0123456789abcdef0123456789abcdef\n";
+    text += "LE_KEY_PENC = 0123456789abcdef0123456789abcdef0123456789abcdef\n\n";
+  }
+  return text;
+}
+
+void BM_ParseLegacyConfig(State& state) {
+  auto text = MakeConfigText();
+  for (auto _ : state) {
+    size_t entries = 0;
+    ParseLegacyConfig(
+        text, [](std::string_view name) { ::benchmark::DoNotOptimize(name); },
+        [&entries](std::string_view key, std::string_view value) {
+          ::benchmark::DoNotOptimize(value);
+          entries++;
+        });
+    ::benchmark::DoNotOptimize(entries);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_LegacyConfigFile_Read(State& state) {
+  auto temp_config = std::filesystem::temp_directory_path() / "legacy_config_parser_benchmark.conf";
+  auto text = MakeConfigText();
+  if (!os::WriteToFile(temp_config.string(), text)) {
+    state.SkipWithError("unable to write the config file");
+    return;
+  }
+  auto file = LegacyConfigFile::FromPath(temp_config.string());
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(file.Read(kNumBondedDevices));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+  std::filesystem::remove(temp_config);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseLegacyConfig);
+BENCHMARK(BM_LegacyConfigFile_Read);
+
+}  // namespace storage
+}  // namespace bluetooth
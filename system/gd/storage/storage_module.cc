@@ -16,6 +16,7 @@
 
 #include "storage/storage_module.h"
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -23,6 +24,7 @@
 #include <utility>
 
 #include "common/bind.h"
+#include "common/init_flags.h"
 #include "metrics/counter_metrics.h"
 #include "os/alarm.h"
 #include "os/files.h"
@@ -30,6 +32,7 @@
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/legacy_config_file.h"
 #include "storage/mutation.h"
 
@@ -49,6 +52,8 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine, and 20 ms if including backup file
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// Rewrite the config file in full once the journal grows past this size, or past the size of the config file itself
+static const size_t kMinJournalSizeToCompact = 64 * 1024;
 
 const int kConfigFileComparePass = 1;
 const int kConfigBackupComparePass = 2;
@@ -75,6 +80,8 @@ StorageModule::StorageModule(
       is_single_user_mode_(is_single_user_mode) {
   // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.bak"
   config_backup_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".bak";
+  // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.journal"
+  config_journal_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".journal";
   ASSERT_LOG(
       config_save_delay > kMinConfigSaveDelay,
       "Config save delay of %lld ms is not enough, must be at least %lld ms to avoid overwhelming the disk",
@@ -93,12 +100,20 @@ const ModuleFactory StorageModule::Factory = ModuleFactory([]() {
 });
 
 struct StorageModule::impl {
-  explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit)
-      : config_save_alarm_(handler), cache_(std::move(cache)), memory_only_cache_(in_memory_cache_size_limit, {}) {}
+  explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit, std::string journal_path)
+      : config_save_alarm_(handler),
+        cache_(std::move(cache)),
+        memory_only_cache_(in_memory_cache_size_limit, {}),
+        journal_(std::move(journal_path)) {}
   Alarm config_save_alarm_;
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  // Journal of changes since the config file was last written in full, see SaveToJournal()
+  ConfigJournal journal_;
+  bool journal_enabled_ = false;
+  uint64_t config_checksum_ = 0;
+  size_t config_size_ = 0;
 };
 
 Mutation StorageModule::Modify() {
@@ -122,15 +137,24 @@ void StorageModule::SaveImmediately() {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  if (pimpl_->journal_enabled_ && SaveToJournal()) {
+    return;
+  }
+  // Serialize once so that both files, and the checksum the journal is started on top of, match exactly
+  std::string config = pimpl_->cache_.SerializeToLegacyFormat();
   // 1. rename old config to backup name
   if (os::FileExists(config_file_path_)) {
     ASSERT(os::RenameFile(config_file_path_, config_backup_path_));
   }
   // 2. write in-memory config to disk, if failed, backup can still be used
-  ASSERT(LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_));
+  ASSERT(os::WriteToFile(config_file_path_, config));
   // 3. now write back up to disk as well
-  ASSERT(LegacyConfigFile::FromPath(config_backup_path_).Write(pimpl_->cache_));
-  // 4. save checksum if it is running in common criteria mode
+  ASSERT(os::WriteToFile(config_backup_path_, config));
+  // 4. changes in the journal are now in the config file
+  pimpl_->journal_.Delete();
+  pimpl_->config_checksum_ = ConfigJournal::Checksum(config);
+  pimpl_->config_size_ = config.size();
+  // 5. save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
@@ -138,6 +162,26 @@ void StorageModule::SaveImmediately() {
   }
 }
 
+bool StorageModule::SaveToJournal() {
+  // Must be taken before the config is serialized for a full save, so no change is missed by both
+  auto changes = pimpl_->cache_.TakePersistentChanges();
+  if (!changes) {
+    return false;
+  }
+  if (pimpl_->journal_.GetSize() > std::max(kMinJournalSizeToCompact, pimpl_->config_size_)) {
+    LOG_INFO("journal reached %zu bytes, compacting into config file", pimpl_->journal_.GetSize());
+    return false;
+  }
+  if (changes->empty()) {
+    return true;
+  }
+  if (!pimpl_->journal_.Append(pimpl_->config_checksum_, *changes)) {
+    LOG_WARN("unable to append to journal, saving whole config");
+    return false;
+  }
+  return true;
+}
+
 void StorageModule::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   pimpl_->cache_.Clear();
@@ -154,6 +198,7 @@ void StorageModule::Start() {
     LOG_INFO("%s is true, delete config files", kFactoryResetProperty.c_str());
     LegacyConfigFile::FromPath(config_file_path_).Delete();
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
+    ConfigJournal(config_journal_path_).Delete();
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
@@ -176,6 +221,20 @@ void StorageModule::Start() {
     config.emplace(temp_devices_capacity_, Device::kLinkKeyProperties);
     file_source = "Empty";
   }
+  // Replay changes saved since the config file was last written in full. This is done even if journaling is now
+  // disabled, so that those changes are not lost, and the next save compacts them into the config file
+  if (os::FileExists(config_journal_path_)) {
+    ConfigJournal journal(config_journal_path_);
+    std::optional<std::string> loaded_config;
+    if (file_source != "Empty") {
+      loaded_config = os::ReadSmallFile(file_source.empty() ? config_file_path_ : config_backup_path_);
+    }
+    if (loaded_config && journal.Replay(ConfigJournal::Checksum(*loaded_config), &config.value())) {
+      save_needed = true;
+    } else {
+      journal.Delete();
+    }
+  }
   if (!file_source.empty()) {
     config->SetProperty(kInfoSection, kFileSourceProperty, std::move(file_source));
   }
@@ -194,13 +253,22 @@ void StorageModule::Start() {
   }
   config->FixDeviceTypeInconsistencies();
   // TODO (b/158035889) Migrate metrics module to GD
-  pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
+  pimpl_ = std::make_unique<impl>(
+      GetHandler(), std::move(config.value()), temp_devices_capacity_, config_journal_path_);
+  // Common criteria mode checksums only cover the config file
+  if (common::InitFlags::IsStorageConfigJournalEnabled() && !os::ParameterProvider::IsCommonCriteriaMode()) {
+    pimpl_->journal_enabled_ = true;
+    pimpl_->cache_.EnableChangeTracking();
+  }
   if (save_needed) {
     // Set a timer and write the new config file to disk.
     SaveDelayed();
   }
   pimpl_->cache_.SetPersistentConfigChangedCallback(
       [this] { this->CallOn(this, &StorageModule::SaveDelayed); });
+  if (common::InitFlags::IsConfigCacheSnapshotReadsEnabled()) {
+    pimpl_->cache_.EnableSnapshotReads();
+  }
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->ConvertEncryptOrDecryptKeyIfNeeded();
   }
@@ -280,6 +348,12 @@ std::optional<std::string> StorageModule::GetProperty(
   return pimpl_->cache_.GetProperty(section, property);
 }
 
+std::vector<std::optional<ConfigCache::SectionProperties>> StorageModule::GetSections(
+    const std::vector<std::string>& sections) const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return pimpl_->cache_.GetSections(sections);
+}
+
 void StorageModule::SetProperty(std::string section, std::string property, std::string value) {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   pimpl_->cache_.SetProperty(section, property, value);
@@ -149,6 +149,9 @@ class StorageModule : public bluetooth::Module {
 
   std::optional<std::string> GetProperty(
       const std::string& section, const std::string& property) const;
+  // Get all properties of each of |sections| under a single lock, std::nullopt for sections that do not exist
+  std::vector<std::optional<ConfigCache::SectionProperties>> GetSections(
+      const std::vector<std::string>& sections) const;
   void SetProperty(std::string section, std::string property, std::string value);
 
   std::vector<std::string> GetPersistentSections() const;
@@ -180,11 +183,14 @@ class StorageModule : public bluetooth::Module {
   std::unique_ptr<impl> pimpl_;
   std::string config_file_path_;
   std::string config_backup_path_;
+  std::string config_journal_path_;
   std::chrono::milliseconds config_save_delay_;
   size_t temp_devices_capacity_;
   bool is_restricted_mode_;
   bool is_single_user_mode_;
   static bool is_config_checksum_pass(int check_bit);
+  // Append pending changes to the journal instead of writing the whole config, return false if a full save is needed
+  bool SaveToJournal();
 };
 
 }  // namespace storage
@@ -21,6 +21,7 @@
 #include <raw_address.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -75,6 +76,79 @@ class AdvertisingTrackInfo {
   std::vector<uint8_t> scan_response;
 };
 
+/**
+ * Scan results delivered together by OnScanResultBatch are packed back to
+ * back in a single buffer. Each result is encoded as follows, multi-octet
+ * fields in little endian order:
+ *   event_type (2), addr_type (1), bda (6), primary_phy (1),
+ *   secondary_phy (1), advertising_sid (1), tx_power (1), rssi (1),
+ *   periodic_adv_int (2), adv_data_len (2), adv_data (adv_data_len)
+ */
+class PackedScanResult {
+ public:
+  static constexpr size_t kHeaderSize = 18;
+
+  uint16_t event_type;
+  uint8_t addr_type;
+  RawAddress bda;
+  uint8_t primary_phy;
+  uint8_t secondary_phy;
+  uint8_t advertising_sid;
+  int8_t tx_power;
+  int8_t rssi;
+  uint16_t periodic_adv_int;
+  const uint8_t* adv_data;
+  uint16_t adv_data_len;
+
+  /** Append a scan result to the packed buffer */
+  static void Pack(std::vector<uint8_t>& buffer, uint16_t event_type,
+                   uint8_t addr_type, const RawAddress& bda,
+                   uint8_t primary_phy, uint8_t secondary_phy,
+                   uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+                   uint16_t periodic_adv_int,
+                   const std::vector<uint8_t>& adv_data) {
+    uint16_t adv_data_len = adv_data.size();
+    uint8_t header[kHeaderSize] = {
+        (uint8_t)event_type,       (uint8_t)(event_type >> 8),
+        addr_type,                 bda.address[0],
+        bda.address[1],            bda.address[2],
+        bda.address[3],            bda.address[4],
+        bda.address[5],            primary_phy,
+        secondary_phy,             advertising_sid,
+        (uint8_t)tx_power,         (uint8_t)rssi,
+        (uint8_t)periodic_adv_int, (uint8_t)(periodic_adv_int >> 8),
+        (uint8_t)adv_data_len,     (uint8_t)(adv_data_len >> 8)};
+    buffer.insert(buffer.end(), header, header + kHeaderSize);
+    buffer.insert(buffer.end(), adv_data.begin(),
+                  adv_data.begin() + adv_data_len);
+  }
+
+  /**
+   * Read the scan result at |offset| in the packed buffer, and advance
+   * |offset| to the next one. Returns false at the end of the buffer or if
+   * the result is truncated. |adv_data| points into the buffer.
+   */
+  bool Unpack(const std::vector<uint8_t>& buffer, size_t& offset) {
+    if (buffer.size() < offset + kHeaderSize) return false;
+    const uint8_t* p = buffer.data() + offset;
+    uint16_t len = p[16] | (p[17] << 8);
+    if (buffer.size() - offset - kHeaderSize < len) return false;
+    event_type = p[0] | (p[1] << 8);
+    addr_type = p[2];
+    std::copy(p + 3, p + 9, bda.address);
+    primary_phy = p[9];
+    secondary_phy = p[10];
+    advertising_sid = p[11];
+    tx_power = (int8_t)p[12];
+    rssi = (int8_t)p[13];
+    periodic_adv_int = p[14] | (p[15] << 8);
+    adv_data = p + kHeaderSize;
+    adv_data_len = len;
+    offset += kHeaderSize + len;
+    return true;
+  }
+};
+
 /**
  * LE Scanning related callbacks invoked from from the Bluetooth native stack
  * All callbacks are invoked on the JNI thread
@@ -92,6 +166,23 @@ class ScanningCallbacks {
                             int8_t tx_power, int8_t rssi,
                             uint16_t periodic_adv_int,
                             std::vector<uint8_t> adv_data) = 0;
+  /**
+   * Scan results accumulated by the stack, in the PackedScanResult format.
+   * The default implementation reports each result with OnScanResult.
+   */
+  virtual void OnScanResultBatch(int num_results,
+                                 std::vector<uint8_t> results) {
+    PackedScanResult result;
+    size_t offset = 0;
+    for (int i = 0; i < num_results && result.Unpack(results, offset); i++) {
+      OnScanResult(result.event_type, result.addr_type, result.bda,
+                   result.primary_phy, result.secondary_phy,
+                   result.advertising_sid, result.tx_power, result.rssi,
+                   result.periodic_adv_int,
+                   std::vector<uint8_t>(result.adv_data,
+                                        result.adv_data + result.adv_data_len));
+    }
+  }
   virtual void OnTrackAdvFoundLost(
       AdvertisingTrackInfo advertising_track_info) = 0;
   virtual void OnBatchScanReports(int client_if, int status, int report_format,
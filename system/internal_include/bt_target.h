@@ -255,10 +255,31 @@
 #define BTM_SCO_DATA_SIZE_MAX 240
 #endif
 
-/* The size in bytes of the BTM inquiry database. */
+/* The maximum number of received packets worth of SCO data that may be sent
+ * at once. SCO flow control is not used, so received packets are taken as
+ * the credit to send data on the in-band data path. */
+#ifndef BTM_SCO_TX_CREDIT_MAX_PKTS
+#define BTM_SCO_TX_CREDIT_MAX_PKTS 3
+#endif
+
+/* The default maximum number of entries of the BTM inquiry database. Entries
+ * are only allocated as devices are found, and the maximum can be changed at
+ * runtime with the bluetooth.core.classic.inq_db_size property. Builds for
+ * devices short of RAM define BT_LOW_MEMORY_PROFILE to get a compact default.
+ */
 #ifndef BTM_INQ_DB_SIZE
+#if (BT_LOW_MEMORY_PROFILE == TRUE)
+#define BTM_INQ_DB_SIZE 10
+#else
 #define BTM_INQ_DB_SIZE 40
 #endif
+#endif
+
+/* A device answering the same inquiry again is only reported again when its
+ * EIR changed or its RSSI moved by at least this many dBm. */
+#ifndef BTM_INQ_RSSI_REPORT_DELTA
+#define BTM_INQ_RSSI_REPORT_DELTA 5
+#endif
 
 /* Sets the Page_Scan_Window:  the length of time that the device is performing
  * a page scan. */
@@ -578,6 +599,11 @@
 #define SMP_MAX_ENC_KEY_SIZE 16
 #endif
 
+/* Number of LE Secure Connections key pairs generated ahead of pairing */
+#ifndef SMP_ECDH_KEY_POOL_SIZE
+#define SMP_ECDH_KEY_POOL_SIZE 2
+#endif
+
 /* minimum link timeout after SMP pairing is done, leave room for key exchange
    and racing condition for the following service connection.
    Prefer greater than 0 second, and no less than default inactivity link idle
@@ -614,6 +640,12 @@
 #define SDP_MAX_ATTR_LEN 400
 #endif
 
+/* How long, in seconds, a cached ServiceSearchAttribute response of a peer is
+ * served instead of querying it again. 0 disables the cache. */
+#ifndef SDP_CACHE_TTL_SECONDS
+#define SDP_CACHE_TTL_SECONDS (60 * 60)
+#endif
+
 /* The maximum number of attribute filters supported by SDP databases. */
 #ifndef SDP_MAX_ATTR_FILTERS
 #define SDP_MAX_ATTR_FILTERS 15
@@ -29,6 +29,9 @@
 #include <base/logging.h>
 #include <hardware/bluetooth.h>
 
+#include <deque>
+#include <mutex>
+
 #include "btcore/include/module.h"
 #include "btif/include/btif_config.h"
 #include "btu.h"
@@ -47,6 +50,12 @@
  ******************************************************************************/
 static const hci_t* hci;
 
+/* HCI messages waiting for the main thread. A drain task is only posted when
+ * the queue goes from empty to non-empty, so a burst of packets costs one
+ * posted closure instead of one heap allocated closure per packet. */
+static std::mutex hci_msg_queue_mutex;
+static std::deque<BT_HDR*> hci_msg_queue;
+
 /*******************************************************************************
  *  Externs
  ******************************************************************************/
@@ -56,6 +65,19 @@ void btu_hci_msg_process(BT_HDR* p_msg);
  *  Static functions
  ******************************************************************************/
 
+static void drain_hci_msg_queue() {
+  std::deque<BT_HDR*> msgs;
+  {
+    std::lock_guard<std::mutex> lock(hci_msg_queue_mutex);
+    msgs.swap(hci_msg_queue);
+  }
+  /* Messages arriving meanwhile post their own drain, after any task posted
+   * while processing these */
+  for (BT_HDR* p_msg : msgs) {
+    btu_hci_msg_process(p_msg);
+  }
+}
+
 /******************************************************************************
  *
  * Function         post_to_hci_message_loop
@@ -67,10 +89,21 @@ void btu_hci_msg_process(BT_HDR* p_msg);
  *****************************************************************************/
 static void post_to_main_message_loop(const base::Location& from_here,
                                       BT_HDR* p_msg) {
-  if (do_in_main_thread(from_here, base::Bind(&btu_hci_msg_process, p_msg)) !=
+  {
+    std::lock_guard<std::mutex> lock(hci_msg_queue_mutex);
+    hci_msg_queue.push_back(p_msg);
+    if (hci_msg_queue.size() > 1) return;
+  }
+  if (do_in_main_thread(from_here, base::BindOnce(&drain_hci_msg_queue)) !=
       BT_STATUS_SUCCESS) {
     LOG(ERROR) << __func__ << ": do_in_main_thread failed from "
                << from_here.ToString();
+    /* Nothing will drain the queue, drop it so later messages post again */
+    std::lock_guard<std::mutex> lock(hci_msg_queue_mutex);
+    for (BT_HDR* p_dropped : hci_msg_queue) {
+      osi_free(p_dropped);
+    }
+    hci_msg_queue.clear();
   }
 }
 
@@ -20,7 +20,9 @@
 #include <base/strings/stringprintf.h>
 #include <time.h>
 
+#include <array>
 #include <chrono>
+#include <cinttypes>
 #include <cstdint>
 #include <functional>
 #include <future>
@@ -45,6 +47,8 @@
 #include "gd/hci/acl_manager/le_acl_connection.h"
 #include "gd/hci/acl_manager/le_connection_management_callbacks.h"
 #include "gd/hci/acl_manager/le_impl.h"
+#include "gd/hci/acl_manager/le_connection_latency.h"
+#include "gd/hci/acl_manager/packet_latency.h"
 #include "gd/hci/address.h"
 #include "gd/hci/address_with_type.h"
 #include "gd/hci/class_of_device.h"
@@ -384,6 +388,25 @@ void ValidateAclInterface(const shim::legacy::acl_interface_t& acl_interface) {
 
 constexpr HciHandle kInvalidHciHandle = 0xffff;
 
+using hci::acl_manager::PacketLatencyStage;
+using hci::acl_manager::RecordPacketLatency;
+
+struct ReceivedAclPacket {
+  std::chrono::steady_clock::time_point received;
+  BT_HDR* p_buf;
+};
+
+void deliver_data_upwards(SendDataUpwards send_data_upwards, HciHandle handle,
+                          const std::vector<ReceivedAclPacket>& packets) {
+  for (const auto& packet : packets) {
+    RecordPacketLatency(handle, PacketLatencyStage::RX_MAIN_THREAD,
+                        packet.received);
+    send_data_upwards(packet.p_buf);
+    RecordPacketLatency(handle, PacketLatencyStage::RX_DELIVERED,
+                        packet.received);
+  }
+}
+
 class ShimAclConnection {
  public:
   ShimAclConnection(const HciHandle handle, SendDataUpwards send_data_upwards,
@@ -395,6 +418,7 @@ class ShimAclConnection {
         send_data_upwards_(send_data_upwards),
         queue_up_end_(queue_up_end),
         creation_time_(creation_time) {
+    hci::acl_manager::AddPacketLatencyLink(handle_);
     queue_up_end_->RegisterDequeue(
         handler_, common::Bind(&ShimAclConnection::data_ready_callback,
                                common::Unretained(this)));
@@ -407,6 +431,7 @@ class ShimAclConnection {
           handle_, queue_.size());
     ASSERT_LOG(is_disconnected_,
                "Shim Acl was not properly disconnected handle:0x%04x", handle_);
+    hci::acl_manager::RemovePacketLatencyLink(handle_);
   }
 
   void EnqueuePacket(std::unique_ptr<packet::RawBuilder> packet) {
@@ -421,27 +446,42 @@ class ShimAclConnection {
     if (queue_.empty()) {
       UnregisterEnqueue();
     }
+    RecordPacketLatency(handle_, PacketLatencyStage::TX_LINK_QUEUE,
+                        packet->GetTimestamp());
     return packet;
   }
 
+  // Drains every packet the connection queue holds at this wakeup and hands
+  // them to the main thread in a single batch
   void data_ready_callback() {
-    auto packet = queue_up_end_->TryDequeue();
-    uint16_t length = packet->size();
-    std::vector<uint8_t> preamble;
-    preamble.push_back(LowByte(handle_));
-    preamble.push_back(HighByte(handle_));
-    preamble.push_back(LowByte(length));
-    preamble.push_back(HighByte(length));
-    BT_HDR* p_buf = MakeLegacyBtHdrPacket(std::move(packet), preamble);
-    ASSERT_LOG(p_buf != nullptr,
-               "Unable to allocate BT_HDR legacy packet handle:%04x", handle_);
+    std::vector<ReceivedAclPacket> packets;
+    for (auto packet = queue_up_end_->TryDequeue(); packet != nullptr;
+         packet = queue_up_end_->TryDequeue()) {
+      auto received = packet->GetTimestamp();
+      RecordPacketLatency(handle_, PacketLatencyStage::RX_SHIM, received);
+      uint16_t length = packet->size();
+      const uint8_t preamble[HCI_DATA_PREAMBLE_SIZE] = {
+          LowByte(handle_), HighByte(handle_), LowByte(length),
+          HighByte(length)};
+      BT_HDR* p_buf =
+          MakeLegacyBtHdrPacket(std::move(packet), preamble, sizeof(preamble));
+      ASSERT_LOG(p_buf != nullptr,
+                 "Unable to allocate BT_HDR legacy packet handle:%04x",
+                 handle_);
+      packets.push_back({received, p_buf});
+    }
+    if (packets.empty()) return;
+
     if (send_data_upwards_ == nullptr) {
       LOG_WARN("Dropping ACL data with no callback");
-      osi_free(p_buf);
     } else if (do_in_main_thread(FROM_HERE,
-                                 base::Bind(send_data_upwards_, p_buf)) !=
-               BT_STATUS_SUCCESS) {
-      osi_free(p_buf);
+                                 base::Bind(deliver_data_upwards,
+                                            send_data_upwards_, handle_,
+                                            packets)) == BT_STATUS_SUCCESS) {
+      return;
+    }
+    for (auto& packet : packets) {
+      osi_free(packet.p_buf);
     }
   }
 
@@ -862,6 +902,10 @@ struct shim::legacy::Acl::impl {
       handle_to_classic_connection_map_;
   std::map<HciHandle, std::unique_ptr<LeShimAclConnection>>
       handle_to_le_connection_map_;
+  // The connections of both maps indexed by handle, for the per packet lookups
+  // of the data path
+  std::array<ShimAclConnection*, HCI_HANDLE_MAX + 1>
+      handle_to_data_connection_{};
 
   SyncMapCount<std::string> classic_acl_disconnect_reason_;
   SyncMapCount<std::string> le_acl_disconnect_reason_;
@@ -877,22 +921,28 @@ struct shim::legacy::Acl::impl {
            handle_to_classic_connection_map_.end();
   }
 
-  void EnqueueClassicPacket(HciHandle handle,
-                            std::unique_ptr<packet::RawBuilder> packet) {
-    ASSERT_LOG(IsClassicAcl(handle), "handle %d is not a classic connection",
-               handle);
-    handle_to_classic_connection_map_[handle]->EnqueuePacket(std::move(packet));
-  }
-
   bool IsLeAcl(HciHandle handle) {
     return handle_to_le_connection_map_.find(handle) !=
            handle_to_le_connection_map_.end();
   }
 
-  void EnqueueLePacket(HciHandle handle,
-                       std::unique_ptr<packet::RawBuilder> packet) {
-    ASSERT_LOG(IsLeAcl(handle), "handle %d is not a LE connection", handle);
-    handle_to_le_connection_map_[handle]->EnqueuePacket(std::move(packet));
+  void AddDataConnection(HciHandle handle, ShimAclConnection* connection) {
+    ASSERT_LOG(handle <= HCI_HANDLE_MAX, "Invalid handle:0x%04x", handle);
+    handle_to_data_connection_[handle] = connection;
+  }
+
+  void RemoveDataConnection(HciHandle handle) {
+    if (handle <= HCI_HANDLE_MAX) handle_to_data_connection_[handle] = nullptr;
+  }
+
+  bool EnqueuePacket(HciHandle handle,
+                     std::unique_ptr<packet::RawBuilder> packet) {
+    if (handle > HCI_HANDLE_MAX ||
+        handle_to_data_connection_[handle] == nullptr) {
+      return false;
+    }
+    handle_to_data_connection_[handle]->EnqueuePacket(std::move(packet));
+    return true;
   }
 
   void DisconnectClassicConnections(std::promise<void> promise) {
@@ -924,6 +974,7 @@ struct shim::legacy::Acl::impl {
     LOG_INFO("Shutdown gd acl shim classic connections");
     for (auto& connection : handle_to_classic_connection_map_) {
       connection.second->Shutdown();
+      RemoveDataConnection(connection.first);
     }
     handle_to_classic_connection_map_.clear();
     promise.set_value();
@@ -957,6 +1008,7 @@ struct shim::legacy::Acl::impl {
     LOG_INFO("Shutdown gd acl shim le connections");
     for (auto& connection : handle_to_le_connection_map_) {
       connection.second->Shutdown();
+      RemoveDataConnection(connection.first);
     }
     handle_to_le_connection_map_.clear();
     promise.set_value();
@@ -966,6 +1018,7 @@ struct shim::legacy::Acl::impl {
     if (!handle_to_classic_connection_map_.empty()) {
       for (auto& connection : handle_to_classic_connection_map_) {
         connection.second->Shutdown();
+        RemoveDataConnection(connection.first);
       }
       handle_to_classic_connection_map_.clear();
       LOG_INFO("Cleared all classic connections count:%zu",
@@ -975,6 +1028,7 @@ struct shim::legacy::Acl::impl {
     if (!handle_to_le_connection_map_.empty()) {
       for (auto& connection : handle_to_le_connection_map_) {
         connection.second->Shutdown();
+        RemoveDataConnection(connection.first);
       }
       handle_to_le_connection_map_.clear();
       LOG_INFO("Cleared all le connections count:%zu",
@@ -1284,6 +1338,36 @@ void DumpsysAcl(int fd) {
                   AddressTypeText(link.active_remote_addr_type).c_str());
     }
   }
+
+  LOG_DUMPSYS(fd, "Packet latency in usec, from the HAL for RX and from "
+                  "L2CAP for TX");
+  for (const auto& summary :
+       hci::acl_manager::GetPacketLatencySummaries()) {
+    LOG_DUMPSYS(
+        fd,
+        "  handle:0x%04x %-14s count:%-8" PRIu64 " p50:%-7" PRId64
+        " p90:%-7" PRId64 " p99:%-7" PRId64 " max:%" PRId64,
+        summary.handle,
+        hci::acl_manager::PacketLatencyStageText(summary.stage).c_str(),
+        summary.count, static_cast<int64_t>(summary.p50.count()),
+        static_cast<int64_t>(summary.p90.count()),
+        static_cast<int64_t>(summary.p99.count()),
+        static_cast<int64_t>(summary.max.count()));
+  }
+
+  LOG_DUMPSYS(fd, "LE connection attempts, latency in msec");
+  for (const auto& summary :
+       hci::acl_manager::GetLeConnectionAttemptSummaries()) {
+    LOG_DUMPSYS(
+        fd,
+        "  %-10s successes:%-6" PRIu64 " failures:%-6" PRIu64
+        " p50:%-7" PRId64 " p90:%-7" PRId64 " max:%" PRId64,
+        hci::acl_manager::LeConnectionAttemptTypeText(summary.type).c_str(),
+        summary.successes, summary.failures,
+        static_cast<int64_t>(summary.p50.count() / 1000),
+        static_cast<int64_t>(summary.p90.count() / 1000),
+        static_cast<int64_t>(summary.max.count() / 1000));
+  }
 }
 #undef DUMPSYS_TAG
 
@@ -1452,11 +1536,7 @@ void shim::legacy::Acl::on_incoming_acl_credits(uint16_t handle,
 
 void shim::legacy::Acl::write_data_sync(
     HciHandle handle, std::unique_ptr<packet::RawBuilder> packet) {
-  if (pimpl_->IsClassicAcl(handle)) {
-    pimpl_->EnqueueClassicPacket(handle, std::move(packet));
-  } else if (pimpl_->IsLeAcl(handle)) {
-    pimpl_->EnqueueLePacket(handle, std::move(packet));
-  } else {
+  if (!pimpl_->EnqueuePacket(handle, std::move(packet))) {
     LOG_ERROR("Unable to find destination to write data\n");
   }
 }
@@ -1512,6 +1592,7 @@ void shim::legacy::Acl::OnClassicLinkDisconnected(HciHandle handle,
 
   TeardownTime teardown_time = std::chrono::system_clock::now();
 
+  pimpl_->RemoveDataConnection(handle);
   pimpl_->handle_to_classic_connection_map_.erase(handle);
   TRY_POSTING_ON_MAIN(acl_interface_.connection.classic.on_disconnected,
                       ToLegacyHciErrorCode(hci::ErrorCode::SUCCESS), handle,
@@ -1564,6 +1645,7 @@ void shim::legacy::Acl::OnLeLinkDisconnected(HciHandle handle,
 
   TeardownTime teardown_time = std::chrono::system_clock::now();
 
+  pimpl_->RemoveDataConnection(handle);
   pimpl_->handle_to_le_connection_map_.erase(handle);
   TRY_POSTING_ON_MAIN(acl_interface_.connection.le.on_disconnected,
                       ToLegacyHciErrorCode(hci::ErrorCode::SUCCESS), handle,
@@ -1596,6 +1678,8 @@ void shim::legacy::Acl::OnConnectSuccess(
                             std::placeholders::_1, std::placeholders::_2),
                   acl_interface_.link.classic, handler_, std::move(connection),
                   std::chrono::system_clock::now()));
+  pimpl_->AddDataConnection(
+      handle, pimpl_->handle_to_classic_connection_map_[handle].get());
   pimpl_->handle_to_classic_connection_map_[handle]->RegisterCallbacks();
   pimpl_->handle_to_classic_connection_map_[handle]
       ->ReadRemoteControllerInformation();
@@ -1707,6 +1791,8 @@ void shim::legacy::Acl::OnLeConnectSuccess(
                             std::placeholders::_1, std::placeholders::_2),
                   acl_interface_.link.le, handler_, std::move(connection),
                   std::chrono::system_clock::now()));
+  pimpl_->AddDataConnection(
+      handle, pimpl_->handle_to_le_connection_map_[handle].get());
   pimpl_->handle_to_le_connection_map_[handle]->RegisterCallbacks();
 
   // Once an le connection has successfully been established
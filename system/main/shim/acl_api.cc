@@ -16,6 +16,7 @@
 
 #include "main/shim/acl_api.h"
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <future>
@@ -68,6 +69,7 @@ void bluetooth::shim::ACL_WriteData(uint16_t handle, BT_HDR* p_buf) {
   std::unique_ptr<bluetooth::packet::RawBuilder> packet = MakeUniquePacket(
       p_buf->data + p_buf->offset + HCI_DATA_PREAMBLE_SIZE,
       p_buf->len - HCI_DATA_PREAMBLE_SIZE, IsPacketFlushable(p_buf));
+  packet->SetTimestamp(std::chrono::steady_clock::now());
   Stack::GetInstance()->GetAcl()->WriteData(handle, std::move(packet));
   osi_free(p_buf);
 }
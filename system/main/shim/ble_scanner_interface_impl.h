@@ -19,8 +19,11 @@
  */
 #pragma once
 
+#include <chrono>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include "hci/le_scanning_callback.h"
 #include "include/hardware/ble_scanner.h"
@@ -157,6 +160,25 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
       ApcfCommand apcf_command);
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
                                 std::vector<uint8_t> advertising_data);
+  void batch_scan_result(uint16_t event_type, uint8_t address_type,
+                         RawAddress raw_address, tBLE_ADDR_TYPE ble_addr_type,
+                         uint8_t primary_phy, uint8_t secondary_phy,
+                         uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+                         uint16_t periodic_advertising_interval,
+                         const std::vector<uint8_t>& advertising_data);
+  void flush_scan_results();
+  void deliver_scan_results(std::vector<uint8_t> packed_results,
+                            std::vector<tBLE_ADDR_TYPE> ble_addr_types);
+
+  // Scan results are accumulated for up to the batch window, or until the
+  // batch holds the maximum number of results, and delivered to the JNI
+  // thread with a single OnScanResultBatch. A zero window disables batching.
+  std::chrono::milliseconds scan_result_batch_window_{0};
+  size_t scan_result_batch_max_results_{0};
+  // Accessed from the gd stack thread and the jni thread
+  std::mutex scan_result_batch_mutex_;
+  std::vector<uint8_t> scan_result_batch_;
+  std::vector<tBLE_ADDR_TYPE> scan_result_batch_addr_types_;
 
   class AddressCache {
    public:
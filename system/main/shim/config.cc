@@ -147,6 +147,11 @@ std::vector<std::string> BtifConfigInterface::GetPersistentDevices() {
   return GetStorage()->GetPersistentSections();
 }
 
+std::vector<std::optional<BtifConfigInterface::Section>>
+BtifConfigInterface::GetSections(const std::vector<std::string>& sections) {
+  return GetStorage()->GetSections(sections);
+}
+
 void BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {
   GetStorage()->ConvertEncryptOrDecryptKeyIfNeeded();
 }
@@ -19,6 +19,7 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace bluetooth {
@@ -53,6 +54,9 @@ class BtifConfigInterface {
   static bool RemoveProperty(const std::string& section,
                              const std::string& key);
   static std::vector<std::string> GetPersistentDevices();
+  using Section = std::unordered_map<std::string, std::string>;
+  static std::vector<std::optional<Section>> GetSections(
+      const std::vector<std::string>& sections);
   static void ConvertEncryptOrDecryptKeyIfNeeded();
   static void Clear();
 };
@@ -21,6 +21,7 @@
 #include <base/functional/bind.h>
 
 #include <algorithm>
+#include <bitset>
 #include <cstdint>
 
 #include "gd/common/init_flags.h"
@@ -264,6 +265,42 @@ static bool event_already_registered_in_le_scanning_manager(
   return false;
 }
 
+// The events and LE subevents the shim hands to the legacy stack, indexed by
+// their code: the valid ones that no Gd module handles already.
+struct ShimEventTable {
+  std::bitset<0x100> events;
+  std::bitset<0x100> subevents;
+};
+
+static ShimEventTable make_shim_event_table() {
+  ShimEventTable table;
+  for (uint16_t event_code_raw = 0; event_code_raw < 0x100; event_code_raw++) {
+    auto event_code = static_cast<bluetooth::hci::EventCode>(event_code_raw);
+    table.events[event_code_raw] =
+        is_valid_event_code(event_code) &&
+        !event_already_registered_in_acl_layer(event_code) &&
+        !event_already_registered_in_controller_layer(event_code) &&
+        !event_already_registered_in_hci_layer(event_code) &&
+        !event_already_registered_in_le_advertising_manager(event_code) &&
+        !event_already_registered_in_le_scanning_manager(event_code);
+  }
+  for (uint16_t subevent_code_raw = 0; subevent_code_raw < 0x100;
+       subevent_code_raw++) {
+    auto subevent_code =
+        static_cast<bluetooth::hci::SubeventCode>(subevent_code_raw);
+    table.subevents[subevent_code_raw] =
+        is_valid_subevent_code(subevent_code) &&
+        !subevent_already_registered_in_le_hci_layer(subevent_code);
+  }
+  return table;
+}
+
+// Built on first use, once the init flags it depends on are loaded
+static const ShimEventTable& shim_event_table() {
+  static const ShimEventTable table = make_shim_event_table();
+  return table;
+}
+
 }  // namespace
 
 namespace cpp {
@@ -527,21 +564,13 @@ static void on_shutting_down() {
     pending_iso_data = nullptr;
   }
   if (hci_queue_end != nullptr) {
+    const auto& table = shim_event_table();
     for (uint16_t event_code_raw = 0; event_code_raw < 0x100;
          event_code_raw++) {
-      auto event_code = static_cast<bluetooth::hci::EventCode>(event_code_raw);
-      if (!is_valid_event_code(event_code)) {
-        continue;
+      if (table.events[event_code_raw]) {
+        bluetooth::shim::GetHciLayer()->UnregisterEventHandler(
+            static_cast<bluetooth::hci::EventCode>(event_code_raw));
       }
-      if (event_already_registered_in_hci_layer(event_code)) {
-        continue;
-      } else if (event_already_registered_in_le_advertising_manager(
-                     event_code)) {
-        continue;
-      } else if (event_already_registered_in_le_scanning_manager(event_code)) {
-        continue;
-      }
-      bluetooth::shim::GetHciLayer()->UnregisterEventHandler(event_code);
     }
     hci_queue_end = nullptr;
   }
@@ -656,38 +685,20 @@ const hci_t* bluetooth::shim::hci_layer_get_interface() {
 void bluetooth::shim::hci_on_reset_complete() {
   ASSERT(send_data_upwards);
 
+  const auto& table = shim_event_table();
   for (uint16_t event_code_raw = 0; event_code_raw < 0x100; event_code_raw++) {
-    auto event_code = static_cast<bluetooth::hci::EventCode>(event_code_raw);
-    if (!is_valid_event_code(event_code)) {
-      continue;
-    }
-    if (event_already_registered_in_acl_layer(event_code)) {
-      continue;
-    } else if (event_already_registered_in_controller_layer(event_code)) {
-      continue;
-    } else if (event_already_registered_in_hci_layer(event_code)) {
-      continue;
-    } else if (event_already_registered_in_le_advertising_manager(event_code)) {
-      continue;
-    } else if (event_already_registered_in_le_scanning_manager(event_code)) {
-      continue;
+    if (table.events[event_code_raw]) {
+      cpp::register_event(
+          static_cast<bluetooth::hci::EventCode>(event_code_raw));
     }
-
-    cpp::register_event(event_code);
   }
 
   for (uint16_t subevent_code_raw = 0; subevent_code_raw < 0x100;
        subevent_code_raw++) {
-    auto subevent_code =
-        static_cast<bluetooth::hci::SubeventCode>(subevent_code_raw);
-    if (!is_valid_subevent_code(subevent_code)) {
-      continue;
+    if (table.subevents[subevent_code_raw]) {
+      cpp::register_le_event(
+          static_cast<bluetooth::hci::SubeventCode>(subevent_code_raw));
     }
-    if (subevent_already_registered_in_le_hci_layer(subevent_code)) {
-      continue;
-    }
-
-    cpp::register_le_event(subevent_code);
   }
 
   cpp::register_for_sco();
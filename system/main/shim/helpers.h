@@ -105,27 +105,30 @@ inline tBLE_BD_ADDR ToLegacyAddressWithType(
   return legacy_address_with_type;
 }
 
+// The data is copied once, straight into the payload of the builder
 inline std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len, bool is_flushable) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
+  auto payload = std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
   payload->SetFlushable(is_flushable);
   return payload;
 }
 
+// The packet is copied once, straight behind |preamble| in a buffer served by
+// the osi allocator pools
 inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
-    const std::vector<uint8_t>& preamble) {
-  std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
+    const uint8_t* preamble, size_t preamble_size) {
+  size_t packet_size = packet->size();
   BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
-  std::copy(preamble.begin(), preamble.end(), buffer->data);
-  std::copy(packet_vector.begin(), packet_vector.end(),
-            buffer->data + preamble.size());
-  buffer->len = preamble.size() + packet_vector.size();
+      osi_malloc(sizeof(BT_HDR) + preamble_size + packet_size));
+  buffer->event = 0;
+  buffer->offset = 0;
+  buffer->layer_specific = 0;
+  buffer->len = preamble_size + packet_size;
+  std::copy(preamble, preamble + preamble_size, buffer->data);
+  std::copy(packet->begin(), packet->end(), buffer->data + preamble_size);
   return buffer;
 }
 
@@ -24,6 +24,7 @@
 #include <hardware/bluetooth.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "advertise_data_parser.h"
@@ -38,6 +39,7 @@
 #include "main/shim/helpers.h"
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/btm_log_history.h"
 #include "storage/device.h"
@@ -54,6 +56,12 @@ extern tBTM_CB btm_cb;
 
 namespace {
 constexpr char kBtmLogTag[] = "SCAN";
+constexpr char kPropertyScanResultBatchWindowMs[] =
+    "bluetooth.core.le.scan_result_batch_window_ms";
+constexpr char kPropertyScanResultBatchMaxResults[] =
+    "bluetooth.core.le.scan_result_batch_max_results";
+constexpr int32_t kMaxScanResultBatchWindowMs = 1000;
+constexpr int32_t kDefaultScanResultBatchMaxResults = 32;
 constexpr uint16_t kAllowServiceDataFilter = 0x0040;
 // Bit 8 for enable AD Type Check
 constexpr uint16_t kAllowADTypeFilter = 0x100;
@@ -144,6 +152,18 @@ void BleScannerInterfaceImpl::Init() {
   LOG_INFO("init BleScannerInterfaceImpl");
   bluetooth::shim::GetScanning()->RegisterScanningCallback(this);
 
+  int32_t batch_window_ms =
+      osi_property_get_int32(kPropertyScanResultBatchWindowMs, 0);
+  int32_t batch_max_results = osi_property_get_int32(
+      kPropertyScanResultBatchMaxResults, kDefaultScanResultBatchMaxResults);
+  if (batch_window_ms > 0 && batch_max_results > 0) {
+    batch_window_ms = std::min(batch_window_ms, kMaxScanResultBatchWindowMs);
+    LOG_INFO("Batching scan results for up to %d ms or %d results",
+             batch_window_ms, batch_max_results);
+    scan_result_batch_window_ = std::chrono::milliseconds(batch_window_ms);
+    scan_result_batch_max_results_ = batch_max_results;
+  }
+
   if (bluetooth::shim::GetMsftExtensionManager()) {
     bluetooth::shim::GetMsftExtensionManager()->SetScanningCallback(this);
   }
@@ -330,10 +350,12 @@ void BleScannerInterfaceImpl::OnMsftAdvMonitorEnable(
     bool enable, bluetooth::hci::ErrorCode status) {
   LOG_INFO("in shim layer");
 
+  // The filter stays disabled while some monitors are matched on the host
   if (status == bluetooth::hci::ErrorCode::SUCCESS) {
     bluetooth::shim::GetScanning()->SetScanFilterPolicy(
-        enable ? bluetooth::hci::LeScanningFilterPolicy::FILTER_ACCEPT_LIST_ONLY
-               : bluetooth::hci::LeScanningFilterPolicy::ACCEPT_ALL);
+        bluetooth::shim::GetMsftExtensionManager()->IsAdvFilterEnabled()
+            ? bluetooth::hci::LeScanningFilterPolicy::FILTER_ACCEPT_LIST_ONLY
+            : bluetooth::hci::LeScanningFilterPolicy::ACCEPT_ALL);
   }
 
   msft_callbacks_.Enable.Run((uint8_t)status);
@@ -551,19 +573,32 @@ void BleScannerInterfaceImpl::OnScanResult(
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
   }
 
-  do_in_jni_thread(
-      FROM_HERE,
-      base::BindOnce(&BleScannerInterfaceImpl::handle_remote_properties,
-                     base::Unretained(this), raw_address, ble_addr_type,
-                     advertising_data));
+  auto msft_extension_manager = bluetooth::shim::GetMsftExtensionManager();
+  if (msft_extension_manager != nullptr &&
+      msft_extension_manager->HasHostAdvMonitors()) {
+    msft_extension_manager->OnAdvertisingReport(address_type, address, tx_power,
+                                                rssi, advertising_data);
+  }
 
-  do_in_jni_thread(
-      FROM_HERE,
-      base::BindOnce(&ScanningCallbacks::OnScanResult,
-                     base::Unretained(scanning_callbacks_), event_type,
-                     static_cast<uint8_t>(address_type), raw_address,
-                     primary_phy, secondary_phy, advertising_sid, tx_power,
-                     rssi, periodic_advertising_interval, advertising_data));
+  if (scan_result_batch_window_.count() > 0) {
+    batch_scan_result(event_type, address_type, raw_address, ble_addr_type,
+                      primary_phy, secondary_phy, advertising_sid, tx_power,
+                      rssi, periodic_advertising_interval, advertising_data);
+  } else {
+    do_in_jni_thread(
+        FROM_HERE,
+        base::BindOnce(&BleScannerInterfaceImpl::handle_remote_properties,
+                       base::Unretained(this), raw_address, ble_addr_type,
+                       advertising_data));
+
+    do_in_jni_thread(
+        FROM_HERE,
+        base::BindOnce(&ScanningCallbacks::OnScanResult,
+                       base::Unretained(scanning_callbacks_), event_type,
+                       static_cast<uint8_t>(address_type), raw_address,
+                       primary_phy, secondary_phy, advertising_sid, tx_power,
+                       rssi, periodic_advertising_interval, advertising_data));
+  }
 
   // TODO: Remove when StartInquiry in GD part implemented
   btm_ble_process_adv_pkt_cont_for_inquiry(
@@ -572,6 +607,84 @@ void BleScannerInterfaceImpl::OnScanResult(
       advertising_data);
 }
 
+void BleScannerInterfaceImpl::batch_scan_result(
+    uint16_t event_type, uint8_t address_type, RawAddress raw_address,
+    tBLE_ADDR_TYPE ble_addr_type, uint8_t primary_phy, uint8_t secondary_phy,
+    uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+    uint16_t periodic_advertising_interval,
+    const std::vector<uint8_t>& advertising_data) {
+  std::vector<uint8_t> packed_results;
+  std::vector<tBLE_ADDR_TYPE> ble_addr_types;
+  {
+    std::lock_guard<std::mutex> lock(scan_result_batch_mutex_);
+    // The first result of a batch schedules its delivery.
+    if (scan_result_batch_addr_types_.empty()) {
+      do_in_jni_thread_delayed(
+          FROM_HERE,
+          base::BindOnce(&BleScannerInterfaceImpl::flush_scan_results,
+                         base::Unretained(this)),
+#if BASE_VER < 931007
+          base::TimeDelta::FromMilliseconds(scan_result_batch_window_.count()));
+#else
+          base::Milliseconds(scan_result_batch_window_.count()));
+#endif
+    }
+    PackedScanResult::Pack(scan_result_batch_, event_type, address_type,
+                           raw_address, primary_phy, secondary_phy,
+                           advertising_sid, tx_power, rssi,
+                           periodic_advertising_interval, advertising_data);
+    scan_result_batch_addr_types_.push_back(ble_addr_type);
+    if (scan_result_batch_addr_types_.size() <
+        scan_result_batch_max_results_) {
+      return;
+    }
+    // The batch is full, deliver it now. The scheduled flush will deliver
+    // the next batch early, or find nothing to deliver.
+    packed_results.swap(scan_result_batch_);
+    ble_addr_types.swap(scan_result_batch_addr_types_);
+  }
+  do_in_jni_thread(
+      FROM_HERE,
+      base::BindOnce(&BleScannerInterfaceImpl::deliver_scan_results,
+                     base::Unretained(this), std::move(packed_results),
+                     std::move(ble_addr_types)));
+}
+
+void BleScannerInterfaceImpl::flush_scan_results() {
+  std::vector<uint8_t> packed_results;
+  std::vector<tBLE_ADDR_TYPE> ble_addr_types;
+  {
+    std::lock_guard<std::mutex> lock(scan_result_batch_mutex_);
+    packed_results.swap(scan_result_batch_);
+    ble_addr_types.swap(scan_result_batch_addr_types_);
+  }
+  deliver_scan_results(std::move(packed_results), std::move(ble_addr_types));
+}
+
+void BleScannerInterfaceImpl::deliver_scan_results(
+    std::vector<uint8_t> packed_results,
+    std::vector<tBLE_ADDR_TYPE> ble_addr_types) {
+  if (ble_addr_types.empty()) {
+    return;
+  }
+
+  PackedScanResult result;
+  size_t offset = 0;
+  for (tBLE_ADDR_TYPE ble_addr_type : ble_addr_types) {
+    if (!result.Unpack(packed_results, offset)) {
+      LOG_ERROR("Malformed scan result batch");
+      return;
+    }
+    handle_remote_properties(
+        result.bda, ble_addr_type,
+        std::vector<uint8_t>(result.adv_data,
+                             result.adv_data + result.adv_data_len));
+  }
+
+  scanning_callbacks_->OnScanResultBatch(ble_addr_types.size(),
+                                         std::move(packed_results));
+}
+
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
     bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) {
   AdvertisingTrackInfo track_info = {};
@@ -622,7 +735,7 @@ void BleScannerInterfaceImpl::OnBatchScanReports(int client_if, int status,
       FROM_HERE,
       base::BindOnce(&ScanningCallbacks::OnBatchScanReports,
                      base::Unretained(scanning_callbacks_), client_if, status,
-                     report_format, num_records, data));
+                     report_format, num_records, std::move(data)));
 }
 
 void BleScannerInterfaceImpl::OnBatchScanThresholdCrossed(int client_if) {
@@ -156,6 +156,14 @@ bool CountCounterMetrics(int32_t key, int64_t count) {
   return counter_metrics->Count(key, count);
 }
 
+bool CacheCounterMetrics(int32_t key, int64_t count) {
+  auto counter_metrics = GetCounterMetrics();
+  if (counter_metrics == nullptr) {
+    return false;
+  }
+  return counter_metrics->CacheCount(key, count);
+}
+
 void LogMetricBluetoothLEConnectionMetricEvent(
     const RawAddress& raw_address,
     android::bluetooth::le::LeConnectionOriginType origin_type,
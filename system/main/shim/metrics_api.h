@@ -223,6 +223,10 @@ void LogMetricManufacturerInfo(
 
 bool CountCounterMetrics(int32_t key, int64_t count);
 
+// Adds to the count logged when the counters are next drained. Cheap enough for
+// per packet paths.
+bool CacheCounterMetrics(int32_t key, int64_t count);
+
 void LogMetricBluetoothLEConnectionMetricEvent(
     const RawAddress& raw_address,
     android::bluetooth::le::LeConnectionOriginType origin_type,
@@ -161,6 +161,20 @@ void Stack::Start(ModuleList* modules) {
 
   stack_thread_ =
       new os::Thread("gd_stack_thread", os::Thread::Priority::REAL_TIME);
+  if (InitFlags::IsDataPathThreadEnabled()) {
+    // Keep the packet path off the thread that runs the control modules, so
+    // scanning, advertising or security work can't delay ACL traffic.
+    data_path_thread_ =
+        new os::Thread("gd_data_path_thread", os::Thread::Priority::REAL_TIME);
+    stack_manager_.SetModuleThread<hci::HciLayer>(data_path_thread_);
+    stack_manager_.SetModuleThread<hci::acl_manager::AclScheduler>(
+        data_path_thread_);
+    stack_manager_.SetModuleThread<hci::AclManager>(data_path_thread_);
+    stack_manager_.SetModuleThread<l2cap::classic::L2capClassicModule>(
+        data_path_thread_);
+    stack_manager_.SetModuleThread<l2cap::le::L2capLeModule>(
+        data_path_thread_);
+  }
   stack_manager_.StartUp(modules, stack_thread_);
 
   stack_handler_ = new os::Handler(stack_thread_);
@@ -198,6 +212,12 @@ void Stack::Stop() {
   delete stack_thread_;
   stack_thread_ = nullptr;
 
+  if (data_path_thread_ != nullptr) {
+    data_path_thread_->Stop();
+    delete data_path_thread_;
+    data_path_thread_ = nullptr;
+  }
+
   LOG_INFO("%s Successfully shut down Gd stack", __func__);
 }
 
@@ -66,6 +66,8 @@ class Stack {
   StackManager stack_manager_;
   bool is_running_ = false;
   os::Thread* stack_thread_ = nullptr;
+  // Runs the HCI, ACL and L2CAP modules when gd_data_path_thread is set
+  os::Thread* data_path_thread_ = nullptr;
   os::Handler* stack_handler_ = nullptr;
   legacy::Acl* acl_ = nullptr;
   Btm* btm_ = nullptr;
@@ -55,6 +55,7 @@
 #include "os/mock_queue.h"
 #include "os/queue.h"
 #include "os/thread.h"
+#include "packet/bit_inserter.h"
 #include "packet/packet_view.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/acl_hci_link_interface.h"
@@ -508,6 +509,29 @@ TEST_F(MainShimTest, helpers) {
   } while (++reason != 0);
 }
 
+TEST_F(MainShimTest, legacy_packet_helpers) {
+  const std::vector<uint8_t> payload = {0x01, 0x02, 0x03, 0x04, 0x05};
+  auto view = std::make_unique<hci::PacketView<hci::kLittleEndian>>(
+      std::make_shared<std::vector<uint8_t>>(payload));
+  const uint8_t preamble[] = {0x7b, 0x00, 0x05, 0x00};
+  BT_HDR* p_buf =
+      MakeLegacyBtHdrPacket(std::move(view), preamble, sizeof(preamble));
+  ASSERT_EQ(0, p_buf->offset);
+  ASSERT_EQ(0, p_buf->layer_specific);
+  ASSERT_EQ(sizeof(preamble) + payload.size(), p_buf->len);
+  ASSERT_EQ(0, memcmp(p_buf->data, preamble, sizeof(preamble)));
+  ASSERT_EQ(0, memcmp(p_buf->data + sizeof(preamble), payload.data(),
+                      payload.size()));
+  osi_free(p_buf);
+
+  auto packet = MakeUniquePacket(payload.data(), payload.size(), true);
+  ASSERT_TRUE(packet->IsFlushable());
+  std::vector<uint8_t> bytes;
+  packet::BitInserter inserter(bytes);
+  packet->Serialize(inserter);
+  ASSERT_EQ(payload, bytes);
+}
+
 TEST_F(MainShimTest, connect_and_disconnect) {
   hci::Address address({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
 
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Sampling allocation profiler. One in every |sample_interval| allocations
+// is recorded against its call site, and each sample stands for
+// |sample_interval| allocations of its size. Unlike the allocation tracker it
+// takes no lock and keeps no per-allocation state for unsampled allocations,
+// so it is cheap enough to leave enabled on production builds.
+
+// Sets the sample interval from the system property
+// "persist.bluetooth.allocation_profiler.sample_interval". The profiler is
+// disabled when the property is unset or zero.
+void allocation_profiler_init(void);
+
+// Enable sampling of one in |sample_interval| allocations, or disable the
+// profiler when it is zero. Changing the interval drops the collected samples.
+void allocation_profiler_set_sample_interval(uint32_t sample_interval);
+uint32_t allocation_profiler_get_sample_interval(void);
+
+// Notify the profiler of an allocation of |size| bytes at |ptr| made from
+// |call_site|, usually the return address of the allocator entry point.
+void allocation_profiler_notify_alloc(const void* call_site, const void* ptr,
+                                      size_t size);
+
+// Notify the profiler that |ptr| is being freed. Must be called before the
+// memory is released for reuse.
+void allocation_profiler_notify_free(const void* ptr);
+
+// Notify the profiler of an allocation it cannot see the release of, such as
+// a std::vector buffer. |site| must be a string with static storage duration
+// and is used as the call site. Only the allocation rate is tracked.
+void allocation_profiler_notify_transient_alloc(const char* site, size_t size);
+
+typedef struct {
+  const void* call_site;  // NULL for named sites
+  const char* name;       // NULL for call site addresses
+  uint64_t sample_count;
+  uint64_t estimated_bytes;
+  int64_t estimated_live_bytes;
+} allocation_profiler_site_t;
+
+// Copies up to |max_sites| call sites into |sites|, the most allocated bytes
+// first. Returns the number of sites copied.
+size_t allocation_profiler_get_sites(allocation_profiler_site_t* sites,
+                                     size_t max_sites);
+
+// Dumps the sites that allocated the most to |fd|.
+void allocation_profiler_debug_dump(int fd);
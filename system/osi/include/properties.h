@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #ifndef PROPERTY_VALUE_MAX
@@ -56,4 +58,47 @@ bool osi_property_get_bool(const char* key, bool default_value);
 // Helper function that returns the value of |key| coerced into a vector of
 // uint32_t. If the property is not set, then the |default_value| is used.
 std::vector<uint32_t> osi_property_get_uintlist(
-    const char* key, std::vector<uint32_t> default_value);
\ No newline at end of file
+    const char* key, std::vector<uint32_t> default_value);
+
+// Returns the serial number of the properties, which changes whenever one of
+// them is set.
+uint32_t osi_property_get_serial(void);
+
+// Value of a property as osi_property_get_bool() or osi_property_get_int32()
+// return it, read again only once a property has been set. Meant to be a
+// static of the paths that read the same property often, where a read then
+// costs a serial check instead of a lookup by name:
+//
+//   static osi_cached_property_t<bool> pts = {"vendor.bt.pts.certification",
+//                                             false};
+//   if (osi_property_get_cached(&pts)) ...
+template <typename T>
+struct osi_cached_property_t {
+  const char* key;
+  T default_value;
+  std::atomic<T> value{};
+  // The serial the value was read at plus one, 0 until the first read
+  std::atomic<uint32_t> serial{0};
+};
+
+template <typename T>
+T osi_property_get_cached(osi_cached_property_t<T>* property) {
+  // Read the serial first, so that a property set while the value is read is
+  // picked up by the next read
+  uint32_t serial = osi_property_get_serial() + 1;
+  if (property->serial.load(std::memory_order_acquire) != serial) {
+    if constexpr (std::is_same_v<T, bool>) {
+      property->value.store(
+          osi_property_get_bool(property->key, property->default_value),
+          std::memory_order_relaxed);
+    } else {
+      static_assert(std::is_same_v<T, int32_t>,
+                    "Only bool and int32_t properties can be cached");
+      property->value.store(
+          osi_property_get_int32(property->key, property->default_value),
+          std::memory_order_relaxed);
+    }
+    property->serial.store(serial, std::memory_order_release);
+  }
+  return property->value.load(std::memory_order_relaxed);
+}
@@ -25,7 +25,8 @@ typedef struct ringbuffer_t ringbuffer_t;
 // NOTE:
 // None of the functions below are thread safe when it comes to accessing the
 // *rb pointer. It is *NOT* possible to insert and pop/delete at the same time.
-// Callers must protect the *rb pointer separately.
+// Callers must protect the *rb pointer separately. A buffer shared by one
+// producer thread and one consumer thread can use |spsc_ringbuffer_t| instead.
 
 // Create a ringbuffer with the specified size
 // Returns NULL if memory allocation failed. Resulting pointer must be freed
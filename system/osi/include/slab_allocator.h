@@ -0,0 +1,49 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size-classed slab pools backing |osi_malloc| and |osi_calloc| for the
+// common packet buffer sizes (HCI events and commands, L2CAP MTU sized
+// payloads and BT_DEFAULT_BUFFER_SIZE buffers). Blocks are carved from a
+// single reserved region, so returning a block to its pool never touches the
+// system allocator. Requests that do not fit a class, or that arrive while a
+// class is exhausted, fall back to malloc.
+
+// Reserve the slab region and start serving allocations from it. If you do
+// not call this function, the other functions are safe to call and behave as
+// if every pool is empty. Calling it more than once has no effect.
+void slab_allocator_init(void);
+
+// Test function only. Releases the slab region. All slab blocks must have been
+// freed before calling this.
+void slab_allocator_uninit(void);
+
+// Returns a block of at least |size| bytes from the smallest class that fits,
+// or NULL if there is no such class or it is exhausted.
+void* slab_allocator_alloc(size_t size);
+
+// Returns true and recycles |ptr| if it belongs to the slab region. Returns
+// false and does nothing otherwise.
+bool slab_allocator_free(void* ptr);
+
+// Dump per-class usage and high-water marks to the |fd| file descriptor.
+void slab_allocator_debug_dump(int fd);
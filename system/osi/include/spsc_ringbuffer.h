@@ -0,0 +1,82 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A byte ring buffer shared by one producer thread and one consumer thread
+// without a lock. Unlike |ringbuffer_t|, the producer may write while the
+// consumer reads. Only the producer may call the functions marked as such, and
+// only the consumer the others. Creating and freeing the buffer happen while
+// neither side uses it.
+//
+// Besides copying in and out, either side can work on the buffer memory in
+// place. The bytes that can be written or read may wrap around the end of the
+// buffer, so they are handed out as up to two regions, the second one empty
+// when they don't wrap.
+typedef struct spsc_ringbuffer_t spsc_ringbuffer_t;
+
+typedef struct {
+  uint8_t* data;
+  size_t length;
+} spsc_ringbuffer_region_t;
+
+// Create a ringbuffer with the specified size. The resulting pointer must be
+// freed using |spsc_ringbuffer_free|.
+spsc_ringbuffer_t* spsc_ringbuffer_init(const size_t size);
+
+// Frees the ringbuffer structure and buffer. Safe to call with NULL.
+void spsc_ringbuffer_free(spsc_ringbuffer_t* rb);
+
+// Returns the room left in the buffer. Exact for the producer, a lower bound
+// for the consumer.
+size_t spsc_ringbuffer_available(const spsc_ringbuffer_t* rb);
+
+// Returns the size of the data in the buffer. Exact for the consumer, a lower
+// bound for the producer.
+size_t spsc_ringbuffer_size(const spsc_ringbuffer_t* rb);
+
+// Producer. Inserts up to |length| bytes of data at |p| into the buffer.
+// Returns the number of bytes added, less than |length| if the buffer is full.
+size_t spsc_ringbuffer_insert(spsc_ringbuffer_t* rb, const uint8_t* p,
+                              size_t length);
+
+// Producer. Fills |regions| with up to |length| bytes of room to write into,
+// and returns their total length. The bytes are handed to the consumer by
+// |spsc_ringbuffer_commit|.
+size_t spsc_ringbuffer_reserve(spsc_ringbuffer_t* rb, size_t length,
+                               spsc_ringbuffer_region_t regions[2]);
+
+// Producer. Makes the first |length| bytes of the last reserved regions
+// available to the consumer. |length| must not exceed the reserved length.
+void spsc_ringbuffer_commit(spsc_ringbuffer_t* rb, size_t length);
+
+// Consumer. Pops up to |length| bytes from the buffer into |p|. Returns the
+// number of bytes popped, less than |length| if there is less data.
+size_t spsc_ringbuffer_pop(spsc_ringbuffer_t* rb, uint8_t* p, size_t length);
+
+// Consumer. Fills |regions| with the data in the buffer, and returns its
+// total length. The data stays valid until it is consumed.
+size_t spsc_ringbuffer_peek(const spsc_ringbuffer_t* rb,
+                            spsc_ringbuffer_region_t regions[2]);
+
+// Consumer. Drops the first |length| bytes of the data, handing their room
+// back to the producer. |length| must not exceed the size of the data.
+void spsc_ringbuffer_consume(spsc_ringbuffer_t* rb, size_t length);
@@ -20,6 +20,7 @@
 
 #include <hardware/bluetooth.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Set the Bluetooth OS callouts to |callouts|.
 // This function should be called when native kernel wakelocks are not used
@@ -37,6 +38,14 @@ bool wakelock_acquire(void);
 // Return true on success, otherwise false.
 bool wakelock_release(void);
 
+// Keep the wakelock for |holdoff_ms| after wakelock_release() before actually
+// releasing it. An acquire within the hold-off cancels the pending release, so
+// bursts of activity don't take and drop the OS wakelock each time. The
+// deferred release runs on a timer thread rather than on the caller's thread.
+// Defaults to the "bluetooth.wakelock.release_holdoff_ms" property, or 0 for
+// an immediate release. Must be called before the first acquire.
+void wakelock_set_release_holdoff(uint32_t holdoff_ms);
+
 // Cleanup the wakelock internal state.
 // This function should be called by the OSI module cleanup during
 // graceful shutdown.
@@ -36,11 +36,13 @@
 #include <hardware/bluetooth.h>
 
 #include <mutex>
+#include <optional>
+#include <vector>
 
 #include "check.h"
+#include "common/timer_wheel.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/thread.h"
@@ -50,6 +52,7 @@
 
 using base::Bind;
 using base::CancelableClosure;
+using bluetooth::common::TimerWheel;
 
 // Callback and timer threads should run at RT priority in order to ensure they
 // meet audio deadlines.  Use this priority for all audio/timer related thread.
@@ -104,6 +107,7 @@ struct alarm_t {
 
   bool for_msg_loop;  // True, if the alarm should be processed on message loop
   CancelableClosureInStruct closure;  // posted to message loop for processing
+  TimerWheel::Entry wheel_entry;      // pending in |alarms| while scheduled
 };
 
 // If the next wakeup time is less than this threshold, we should acquire
@@ -113,11 +117,17 @@ struct alarm_t {
 int64_t TIMER_INTERVAL_FOR_WAKELOCK_IN_MS = 3000;
 static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 
+// One-shot alarms that wake the device up may expire up to 1/32 of their
+// interval late, so that alarms set around the same time share a wakeup.
+static const uint64_t WAKEUP_ALARM_SLACK_DIVISOR = 32;
+
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| timer wheel.
 static std::mutex alarms_mutex;
-static list_t* alarms;
+static TimerWheel* alarms;
+// The deadline |timer| or |wakeup_timer| is set for
+static std::optional<uint64_t> root_deadline_ms;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
@@ -141,6 +151,7 @@ static void alarm_cancel_internal(alarm_t* alarm);
 static void remove_pending_alarm(alarm_t* alarm);
 static void schedule_next_instance(alarm_t* alarm);
 static void reschedule_root_alarm(void);
+static void update_root_alarm(void);
 static void alarm_queue_ready(fixed_queue_t* queue, void* context);
 static void timer_callback(void* data);
 static void callback_dispatch(void* context);
@@ -181,6 +192,8 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
   ret->for_msg_loop = false;
   // placement new
   new (&ret->closure) CancelableClosureInStruct();
+  new (&ret->wheel_entry) TimerWheel::Entry();
+  ret->wheel_entry.context = ret;
 
   // NOTE: The stats were reset by osi_calloc() above
 
@@ -194,6 +207,7 @@ void alarm_free(alarm_t* alarm) {
 
   osi_free((void*)alarm->stats.name);
   alarm->closure.~CancelableClosureInStruct();
+  alarm->wheel_entry.~Entry();
   alarm->callback_mutex.reset();
   osi_free(alarm);
 }
@@ -260,9 +274,6 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
-
   remove_pending_alarm(alarm);
 
   alarm->deadline_ms = 0;
@@ -272,7 +283,7 @@ static void alarm_cancel_internal(alarm_t* alarm) {
   alarm->stats.canceled_count++;
   alarm->queue = NULL;
 
-  if (needs_reschedule) reschedule_root_alarm();
+  update_root_alarm();
 }
 
 bool alarm_is_scheduled(const alarm_t* alarm) {
@@ -301,8 +312,9 @@ void alarm_cleanup(void) {
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
+  root_deadline_ms.reset();
 }
 
 static bool lazy_initialize(void) {
@@ -315,11 +327,9 @@ static bool lazy_initialize(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  alarms = list_new(NULL);
-  if (!alarms) {
-    LOG_ERROR("%s unable to allocate alarm list.", __func__);
-    goto error;
-  }
+  // Start the wheel at the current time, so that it has nothing to catch up
+  alarms = new TimerWheel(0);
+  alarms->Advance(now_ms(), [](TimerWheel::Entry*) {});
 
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
@@ -380,7 +390,7 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
 
   return false;
@@ -398,10 +408,10 @@ static uint64_t now_ms(void) {
   return (ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
 }
 
-// Remove alarm from internal alarm list and the processing queue
+// Remove alarm from internal timer wheel and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  alarms->Cancel(&alarm->wheel_entry);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -416,10 +426,6 @@ static void remove_pending_alarm(alarm_t* alarm) {
 
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
-  // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -430,28 +436,21 @@ static void schedule_next_instance(alarm_t* alarm) {
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
   alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
-  } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
+  uint64_t slack_ms = 0;
+  if (!alarm->is_periodic &&
+      alarm->period_ms >= (uint64_t)TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
+    slack_ms = alarm->period_ms / WAKEUP_ALARM_SLACK_DIVISOR;
   }
+  alarms->Schedule(&alarm->wheel_entry, TimerWheel::CoalesceDeadline(
+                                            alarm->deadline_ms, slack_ms));
 
-  // If the new alarm has the earliest deadline, we need to re-evaluate our
-  // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
-    reschedule_root_alarm();
-  }
+  update_root_alarm();
+}
+
+// Re-evaluate our schedule if the earliest deadline changed.
+// NOTE: must be called with |alarms_mutex| held
+static void update_root_alarm(void) {
+  if (alarms->NextDeadlineMs() != root_deadline_ms) reschedule_root_alarm();
 }
 
 // NOTE: must be called with |alarms_mutex| held
@@ -459,17 +458,18 @@ static void reschedule_root_alarm(void) {
   CHECK(alarms != NULL);
 
   const bool timer_was_set = timer_set;
-  alarm_t* next;
+  uint64_t next_deadline_ms;
   int64_t next_expiration;
 
   // If used in a zeroed state, disarms the timer.
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  root_deadline_ms = alarms->NextDeadlineMs();
+  if (!root_deadline_ms) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
-  next_expiration = next->deadline_ms - now_ms();
+  next_deadline_ms = *root_deadline_ms;
+  next_expiration = next_deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
       if (!wakelock_acquire()) {
@@ -477,8 +477,8 @@ static void reschedule_root_alarm(void) {
       }
     }
 
-    timer_time.it_value.tv_sec = (next->deadline_ms / 1000);
-    timer_time.it_value.tv_nsec = (next->deadline_ms % 1000) * 1000000LL;
+    timer_time.it_value.tv_sec = (next_deadline_ms / 1000);
+    timer_time.it_value.tv_nsec = (next_deadline_ms % 1000) * 1000000LL;
 
     // It is entirely unsafe to call timer_settime(2) with a zeroed timerspec
     // for timers with *_ALARM clock IDs. Although the man page states that the
@@ -503,8 +503,8 @@ static void reschedule_root_alarm(void) {
     struct itimerspec wakeup_time;
     memset(&wakeup_time, 0, sizeof(wakeup_time));
 
-    wakeup_time.it_value.tv_sec = (next->deadline_ms / 1000);
-    wakeup_time.it_value.tv_nsec = (next->deadline_ms % 1000) * 1000000LL;
+    wakeup_time.it_value.tv_sec = (next_deadline_ms / 1000);
+    wakeup_time.it_value.tv_nsec = (next_deadline_ms % 1000) * 1000000LL;
     if (timer_settime(wakeup_timer, TIMER_ABSTIME, &wakeup_time, NULL) == -1)
       LOG_ERROR("%s unable to set wakeup timer: %s", __func__, strerror(errno));
   }
@@ -527,8 +527,7 @@ done:
   // milliseconds) and the timer expired normally before we called
   // |timer_gettime|. Worst case, |alarm_expired| is signaled twice for that
   // alarm. Nothing bad should happen in that case though since the callback
-  // dispatch function checks to make sure the timer at the head of the list
-  // actually expired.
+  // dispatch function only expires the alarms whose deadline has passed.
   if (timer_set) {
     struct itimerspec time_to_expire;
     timer_gettime(timer, &time_to_expire);
@@ -623,39 +622,38 @@ static void callback_dispatch(UNUSED_ATTR void* context) {
     if (!dispatcher_thread_active) break;
 
     std::lock_guard<std::mutex> lock(alarms_mutex);
-    alarm_t* alarm;
-
-    // Take into account that the alarm may get cancelled before we get to it.
-    // We're done here if there are no alarms or the alarm at the front is in
-    // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
-      reschedule_root_alarm();
-      continue;
-    }
 
-    list_remove(alarms, alarm);
-
-    if (alarm->is_periodic) {
-      alarm->prev_deadline_ms = alarm->deadline_ms;
-      schedule_next_instance(alarm);
-      alarm->stats.rescheduled_count++;
+    // Take into account that alarms may get cancelled before we get to them.
+    // Every alarm whose deadline has passed is dispatched at once, the others
+    // stay in the wheel.
+    std::vector<alarm_t*> expired;
+    alarms->Advance(now_ms(), [&expired](TimerWheel::Entry* entry) {
+      expired.push_back(static_cast<alarm_t*>(entry->context));
+    });
+
+    for (alarm_t* alarm : expired) {
+      if (alarm->is_periodic) {
+        alarm->prev_deadline_ms = alarm->deadline_ms;
+        schedule_next_instance(alarm);
+        alarm->stats.rescheduled_count++;
+      }
     }
     reschedule_root_alarm();
 
-    // Enqueue the alarm for processing
-    if (alarm->for_msg_loop) {
-      if (!get_main_thread()) {
-        LOG_ERROR("%s: message loop already NULL. Alarm: %s", __func__,
-                  alarm->stats.name);
-        continue;
+    // Enqueue the alarms for processing
+    for (alarm_t* alarm : expired) {
+      if (alarm->for_msg_loop) {
+        if (!get_main_thread()) {
+          LOG_ERROR("%s: message loop already NULL. Alarm: %s", __func__,
+                    alarm->stats.name);
+          continue;
+        }
+
+        alarm->closure.i.Reset(Bind(alarm_ready_mloop, alarm));
+        get_main_thread()->DoInThread(FROM_HERE, alarm->closure.i.callback());
+      } else {
+        fixed_queue_enqueue(alarm->queue, alarm);
       }
-
-      alarm->closure.i.Reset(Bind(alarm_ready_mloop, alarm));
-      get_main_thread()->DoInThread(FROM_HERE, alarm->closure.i.callback());
-    } else {
-      fixed_queue_enqueue(alarm->queue, alarm);
     }
   }
 
@@ -734,12 +732,11 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  dprintf(fd, "  Total Alarms: %zu\n\n", alarms->Size());
 
   // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
+  alarms->ForEach([fd, just_now_ms](TimerWheel::Entry* entry) {
+    alarm_t* alarm = static_cast<alarm_t*>(entry->context);
     alarm_stats_t* stats = &alarm->stats;
 
     dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
@@ -767,5 +764,5 @@ void alarm_debug_dump(int fd) {
               "    Premature scheduling time in ms (total/max/avg)");
 
     dprintf(fd, "\n");
-  }
+  });
 }
@@ -0,0 +1,299 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/allocation_profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "osi/include/properties.h"
+
+static const char* kSampleIntervalProperty =
+    "persist.bluetooth.allocation_profiler.sample_interval";
+
+// Call sites are looked up by address with linear probing. Samples from sites
+// that do not fit are counted as dropped.
+static const size_t kSiteTableSize = 512;
+// Sampled allocations that are still live, looked up by pointer within a
+// short probe window so that frees of unsampled allocations stay cheap.
+static const size_t kLiveTableSize = 4096;
+static const size_t kLiveProbeWindow = 8;
+static const size_t kDumpMaxSites = 20;
+
+// Marks a live table slot that is being written or cleared.
+static const uintptr_t kSlotBusy = 1;
+
+typedef struct {
+  std::atomic<uintptr_t> key;
+  std::atomic<const char*> name;
+  std::atomic<uint64_t> sample_count;
+  std::atomic<uint64_t> estimated_bytes;
+  std::atomic<int64_t> estimated_live_bytes;
+} site_t;
+
+typedef struct {
+  std::atomic<uintptr_t> ptr;
+  std::atomic<site_t*> site;
+  std::atomic<int64_t> estimated_bytes;
+} live_sample_t;
+
+static std::atomic<uint32_t> sample_interval(0);
+static std::atomic<uint64_t> enabled_time_ms(0);
+static std::atomic<uint64_t> dropped_samples(0);
+static std::atomic<size_t> live_sample_count(0);
+static site_t sites[kSiteTableSize];
+static live_sample_t live_samples[kLiveTableSize];
+
+static thread_local uint32_t allocations_until_sample;
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static size_t hash_address(uintptr_t address) {
+  // Fibonacci hashing; allocations and code are at least 8 byte aligned.
+  return static_cast<size_t>(((address >> 3) * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static void reset(void) {
+  for (size_t i = 0; i < kLiveTableSize; i++) {
+    live_samples[i].ptr.store(0, std::memory_order_relaxed);
+  }
+  live_sample_count.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < kSiteTableSize; i++) {
+    sites[i].sample_count.store(0, std::memory_order_relaxed);
+    sites[i].estimated_bytes.store(0, std::memory_order_relaxed);
+    sites[i].estimated_live_bytes.store(0, std::memory_order_relaxed);
+    sites[i].name.store(NULL, std::memory_order_relaxed);
+    sites[i].key.store(0, std::memory_order_release);
+  }
+  dropped_samples.store(0, std::memory_order_relaxed);
+}
+
+// Returns true when the current allocation should be sampled, and the number
+// of allocations the sample stands for in |interval|.
+static bool should_sample(uint32_t* interval) {
+  *interval = sample_interval.load(std::memory_order_relaxed);
+  if (*interval == 0) return false;
+  if (allocations_until_sample == 0 || allocations_until_sample > *interval)
+    allocations_until_sample = *interval;
+  return --allocations_until_sample == 0;
+}
+
+static site_t* find_site(uintptr_t key, const char* name) {
+  size_t start = hash_address(key);
+  for (size_t i = 0; i < kSiteTableSize; i++) {
+    site_t* site = &sites[(start + i) % kSiteTableSize];
+    uintptr_t current = site->key.load(std::memory_order_acquire);
+    if (current == key) return site;
+    if (current != 0) continue;
+    if (site->key.compare_exchange_strong(current, key,
+                                          std::memory_order_acq_rel)) {
+      site->name.store(name, std::memory_order_release);
+      return site;
+    }
+    if (current == key) return site;
+  }
+  dropped_samples.fetch_add(1, std::memory_order_relaxed);
+  return NULL;
+}
+
+static void record_sample(site_t* site, int64_t estimated_bytes) {
+  site->sample_count.fetch_add(1, std::memory_order_relaxed);
+  site->estimated_bytes.fetch_add(estimated_bytes, std::memory_order_relaxed);
+}
+
+void allocation_profiler_init(void) {
+  int32_t interval = osi_property_get_int32(kSampleIntervalProperty, 0);
+  allocation_profiler_set_sample_interval(interval > 0 ? interval : 0);
+}
+
+void allocation_profiler_set_sample_interval(uint32_t interval) {
+  sample_interval.store(0, std::memory_order_relaxed);
+  reset();
+  enabled_time_ms.store(now_ms(), std::memory_order_relaxed);
+  sample_interval.store(interval, std::memory_order_relaxed);
+}
+
+uint32_t allocation_profiler_get_sample_interval(void) {
+  return sample_interval.load(std::memory_order_relaxed);
+}
+
+void allocation_profiler_notify_alloc(const void* call_site, const void* ptr,
+                                      size_t size) {
+  uint32_t interval;
+  if (ptr == NULL || !should_sample(&interval)) return;
+
+  site_t* site = find_site(reinterpret_cast<uintptr_t>(call_site), NULL);
+  if (site == NULL) return;
+  int64_t estimated_bytes = static_cast<int64_t>(size) * interval;
+  record_sample(site, estimated_bytes);
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  size_t start = hash_address(address);
+  for (size_t i = 0; i < kLiveProbeWindow; i++) {
+    live_sample_t* sample = &live_samples[(start + i) % kLiveTableSize];
+    uintptr_t expected = 0;
+    if (!sample->ptr.compare_exchange_strong(expected, kSlotBusy,
+                                             std::memory_order_acquire))
+      continue;
+    sample->site.store(site, std::memory_order_relaxed);
+    sample->estimated_bytes.store(estimated_bytes, std::memory_order_relaxed);
+    site->estimated_live_bytes.fetch_add(estimated_bytes,
+                                         std::memory_order_relaxed);
+    live_sample_count.fetch_add(1, std::memory_order_relaxed);
+    sample->ptr.store(address, std::memory_order_release);
+    return;
+  }
+  // No room to follow the allocation; it still counts towards the rate.
+  dropped_samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void allocation_profiler_notify_free(const void* ptr) {
+  if (ptr == NULL ||
+      live_sample_count.load(std::memory_order_relaxed) == 0)
+    return;
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+  size_t start = hash_address(address);
+  for (size_t i = 0; i < kLiveProbeWindow; i++) {
+    live_sample_t* sample = &live_samples[(start + i) % kLiveTableSize];
+    uintptr_t expected = address;
+    if (!sample->ptr.compare_exchange_strong(expected, kSlotBusy,
+                                             std::memory_order_acquire))
+      continue;
+    site_t* site = sample->site.load(std::memory_order_relaxed);
+    site->estimated_live_bytes.fetch_sub(
+        sample->estimated_bytes.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    live_sample_count.fetch_sub(1, std::memory_order_relaxed);
+    sample->ptr.store(0, std::memory_order_release);
+    return;
+  }
+}
+
+void allocation_profiler_notify_transient_alloc(const char* site_name,
+                                                size_t size) {
+  uint32_t interval;
+  if (!should_sample(&interval)) return;
+
+  site_t* site = find_site(reinterpret_cast<uintptr_t>(site_name), site_name);
+  if (site == NULL) return;
+  record_sample(site, static_cast<int64_t>(size) * interval);
+}
+
+size_t allocation_profiler_get_sites(allocation_profiler_site_t* out,
+                                     size_t max_sites) {
+  allocation_profiler_site_t all[kSiteTableSize];
+  size_t count = 0;
+  for (size_t i = 0; i < kSiteTableSize; i++) {
+    const site_t& site = sites[i];
+    uintptr_t key = site.key.load(std::memory_order_acquire);
+    uint64_t sample_count = site.sample_count.load(std::memory_order_relaxed);
+    if (key == 0 || sample_count == 0) continue;
+    const char* name = site.name.load(std::memory_order_acquire);
+    all[count++] = {
+        .call_site = name ? NULL : reinterpret_cast<const void*>(key),
+        .name = name,
+        .sample_count = sample_count,
+        .estimated_bytes =
+            site.estimated_bytes.load(std::memory_order_relaxed),
+        .estimated_live_bytes =
+            site.estimated_live_bytes.load(std::memory_order_relaxed),
+    };
+  }
+
+  size_t copied = std::min(count, max_sites);
+  std::partial_sort(all, all + copied, all + count,
+                    [](const allocation_profiler_site_t& a,
+                       const allocation_profiler_site_t& b) {
+                      return a.estimated_bytes > b.estimated_bytes;
+                    });
+  std::copy(all, all + copied, out);
+  return copied;
+}
+
+// Formats |call_site| as "library+0xoffset (function)" where the dynamic
+// linker knows about it.
+static void describe_call_site(const void* call_site, char* buffer,
+                               size_t size) {
+  Dl_info info;
+  if (dladdr(call_site, &info) == 0 || info.dli_fname == NULL) {
+    snprintf(buffer, size, "%p", call_site);
+    return;
+  }
+  const char* library = strrchr(info.dli_fname, '/');
+  library = library ? library + 1 : info.dli_fname;
+  uintptr_t offset = reinterpret_cast<uintptr_t>(call_site) -
+                     reinterpret_cast<uintptr_t>(info.dli_fbase);
+  if (info.dli_sname == NULL) {
+    snprintf(buffer, size, "%s+0x%zx", library, static_cast<size_t>(offset));
+    return;
+  }
+  int status = 0;
+  char* demangled =
+      abi::__cxa_demangle(info.dli_sname, NULL, NULL, &status);
+  snprintf(buffer, size, "%s+0x%zx (%s)", library,
+           static_cast<size_t>(offset),
+           status == 0 && demangled ? demangled : info.dli_sname);
+  free(demangled);
+}
+
+void allocation_profiler_debug_dump(int fd) {
+  uint32_t interval = allocation_profiler_get_sample_interval();
+  dprintf(fd, "\nBluetooth Allocation Profile:\n");
+  if (interval == 0) {
+    dprintf(fd, "  Disabled, set %s to enable\n", kSampleIntervalProperty);
+    return;
+  }
+
+  uint64_t elapsed_ms =
+      now_ms() - enabled_time_ms.load(std::memory_order_relaxed);
+  if (elapsed_ms == 0) elapsed_ms = 1;
+  dprintf(fd, "  Sampling 1 in %u allocations for %llu s, %llu dropped\n",
+          interval, static_cast<unsigned long long>(elapsed_ms / 1000),
+          static_cast<unsigned long long>(
+              dropped_samples.load(std::memory_order_relaxed)));
+
+  allocation_profiler_site_t top[kDumpMaxSites];
+  size_t count = allocation_profiler_get_sites(top, kDumpMaxSites);
+  dprintf(fd, "  %12s  %12s  %8s  %s\n", "bytes/sec", "live bytes", "samples",
+          "call site");
+  for (size_t i = 0; i < count; i++) {
+    char call_site[256];
+    if (top[i].name) {
+      snprintf(call_site, sizeof(call_site), "%s", top[i].name);
+    } else {
+      describe_call_site(top[i].call_site, call_site, sizeof(call_site));
+    }
+    dprintf(fd, "  %12llu  %12lld  %8llu  %s\n",
+            static_cast<unsigned long long>(top[i].estimated_bytes * 1000 /
+                                            elapsed_ms),
+            static_cast<long long>(top[i].estimated_live_bytes),
+            static_cast<unsigned long long>(top[i].sample_count), call_site);
+  }
+}
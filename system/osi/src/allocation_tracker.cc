@@ -30,6 +30,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/slab_allocator.h"
 
 typedef struct {
   uint8_t allocator_id;
@@ -184,4 +185,7 @@ void osi_allocator_debug_dump(int fd) {
   dprintf(fd, "  Total allocated/free/used octets : %zu / %zu / %zu\n",
           alloc_total_size, free_total_size,
           alloc_total_size - free_total_size);
+  lock.unlock();
+
+  slab_allocator_debug_dump(fd);
 }
@@ -20,8 +20,10 @@
 #include <string.h>
 
 #include "check.h"
+#include "osi/include/allocation_profiler.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
+#include "osi/include/slab_allocator.h"
 
 static const allocator_id_t alloc_allocator_id = 42;
 
@@ -34,6 +36,8 @@ char* osi_strdup(const char* str) {
   char* new_string = static_cast<char*>(
       allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size));
   if (!new_string) return NULL;
+  allocation_profiler_notify_alloc(__builtin_return_address(0), new_string,
+                                   size);
 
   memcpy(new_string, str, size);
   return new_string;
@@ -50,6 +54,8 @@ char* osi_strndup(const char* str, size_t len) {
   char* new_string = static_cast<char*>(
       allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1));
   if (!new_string) return NULL;
+  allocation_profiler_notify_alloc(__builtin_return_address(0), new_string,
+                                   size + 1);
 
   memcpy(new_string, str, size);
   new_string[size] = '\0';
@@ -59,21 +65,33 @@ char* osi_strndup(const char* str, size_t len) {
 void* osi_malloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = malloc(real_size);
+  void* ptr = slab_allocator_alloc(real_size);
+  if (ptr == NULL) ptr = malloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  ptr = allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  allocation_profiler_notify_alloc(__builtin_return_address(0), ptr, size);
+  return ptr;
 }
 
 void* osi_calloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = calloc(1, real_size);
+  void* ptr = slab_allocator_alloc(real_size);
+  if (ptr != NULL) {
+    memset(ptr, 0, real_size);
+  } else {
+    ptr = calloc(1, real_size);
+  }
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  ptr = allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  allocation_profiler_notify_alloc(__builtin_return_address(0), ptr, size);
+  return ptr;
 }
 
 void osi_free(void* ptr) {
-  free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
+  allocation_profiler_notify_free(ptr);
+  void* real_ptr = allocation_tracker_notify_free(alloc_allocator_id, ptr);
+  if (!slab_allocator_free(real_ptr)) free(real_ptr);
 }
 
 void osi_free_and_reset(void** p_ptr) {
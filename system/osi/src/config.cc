@@ -28,13 +28,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include <sstream>
+#include <string_view>
 #include <type_traits>
+#include <unordered_map>
 
 #include "check.h"
+#include "storage/legacy_config_parser.h"
 
 void section_t::Set(std::string key, std::string value) {
   for (entry_t& entry : entries) {
@@ -68,7 +72,7 @@ bool config_t::Has(const std::string& key) {
   return Find(key) != sections.end();
 }
 
-static bool config_parse(FILE* fp, config_t* config);
+static bool config_parse(std::string_view text, config_t* config);
 
 template <typename T,
           class = typename std::enable_if<std::is_same<
@@ -101,18 +105,40 @@ std::unique_ptr<config_t> config_new(const char* filename) {
 
   std::unique_ptr<config_t> config = config_new_empty();
 
-  FILE* fp = fopen(filename, "rt");
-  if (!fp) {
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG(ERROR) << __func__ << ": unable to open file '" << filename
                << "': " << strerror(errno);
     return nullptr;
   }
 
-  if (!config_parse(fp, config.get())) {
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    LOG(ERROR) << __func__ << ": unable to stat file '" << filename
+               << "': " << strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+
+  size_t size = file_stat.st_size;
+  void* data = nullptr;
+  if (size != 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": unable to map file '" << filename
+               << "': " << strerror(errno);
+    return nullptr;
+  }
+
+  if (!config_parse(
+          std::string_view(static_cast<const char*>(data), size),
+          config.get())) {
     config.reset();
   }
 
-  fclose(fp);
+  if (data != nullptr) munmap(data, size);
   return config;
 }
 
@@ -477,54 +503,34 @@ error2:
   return false;
 }
 
-static char* trim(char* str) {
-  while (isspace(*str)) ++str;
-
-  if (!*str) return str;
-
-  char* end_str = str + strlen(str) - 1;
-  while (end_str > str && isspace(*end_str)) --end_str;
-
-  end_str[1] = '\0';
-  return str;
-}
-
-static bool config_parse(FILE* fp, config_t* config) {
-  CHECK(fp != nullptr);
+static bool config_parse(std::string_view text, config_t* config) {
   CHECK(config != nullptr);
 
+  // Look the sections up by name once per section header rather than once per
+  // entry. The names are owned by the sections, which never move in the list.
+  std::unordered_map<std::string_view, section_t*> sections;
+  for (section_t& sec : config->sections) sections.emplace(sec.name, &sec);
+  auto get_section = [config, &sections](std::string_view name) {
+    auto it = sections.find(name);
+    if (it != sections.end()) return it->second;
+    section_t* sec =
+        &config->sections.emplace_back(section_t{.name = std::string(name)});
+    sections.emplace(sec->name, sec);
+    return sec;
+  };
+
+  section_t* section = nullptr;
   int line_num = 0;
-  char line[4096];
-  char section[4096];
-  strcpy(section, CONFIG_DEFAULT_SECTION);
-
-  while (fgets(line, sizeof(line), fp)) {
-    char* line_ptr = trim(line);
-    ++line_num;
-
-    // Skip blank and comment lines.
-    if (*line_ptr == '\0' || *line_ptr == '#') continue;
-
-    if (*line_ptr == '[') {
-      size_t len = strlen(line_ptr);
-      if (line_ptr[len - 1] != ']') {
-        VLOG(1) << __func__ << ": unterminated section name on line "
-                << line_num;
-        return false;
-      }
-      strncpy(section, line_ptr + 1, len - 2);  // NOLINT (len < 4096)
-      section[len - 2] = '\0';
-    } else {
-      char* split = strchr(line_ptr, '=');
-      if (!split) {
-        VLOG(1) << __func__ << ": no key/value separator found on line "
-                << line_num;
-        return false;
-      }
-
-      *split = '\0';
-      config_set_string(config, section, trim(line_ptr), trim(split + 1));
-    }
-  }
-  return true;
+  bool parsed = bluetooth::storage::ParseLegacyConfig(
+      text,
+      [&](std::string_view name) { section = get_section(name); },
+      [&](std::string_view key, std::string_view value) {
+        if (section == nullptr) section = get_section(CONFIG_DEFAULT_SECTION);
+        section->Set(std::string(key), std::string(value));
+      },
+      &line_num);
+  if (!parsed) {
+    VLOG(1) << __func__ << ": malformed line " << line_num;
+  }
+  return parsed;
 }
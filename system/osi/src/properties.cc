@@ -73,6 +73,10 @@ bool osi_property_get_bool(const char* key, bool default_value) {
   }
 }
 
+uint32_t osi_property_get_serial(void) {
+  return bluetooth::os::GetSystemPropertiesSerial();
+}
+
 std::vector<uint32_t> osi_property_get_uintlist(
     const char* key, const std::vector<uint32_t> default_value) {
   std::optional<std::string> result = bluetooth::os::GetSystemProperty(key);
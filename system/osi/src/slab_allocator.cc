@@ -0,0 +1,223 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_slab_allocator"
+
+#include "osi/include/slab_allocator.h"
+
+#include <base/logging.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include <atomic>
+#include <mutex>
+
+#include "check.h"
+#include "osi/include/log.h"
+
+namespace {
+
+// Block sizes include room for a BT_HDR and the allocation tracker canaries.
+struct slab_class_config_t {
+  size_t block_size;
+  size_t block_count;
+};
+
+constexpr slab_class_config_t kSlabClassConfigs[] = {
+    // HCI commands/events and small control packets
+    {256, 128},
+    // BT_SMALL_BUFFER_SIZE (660)
+    {768, 128},
+    // L2CAP_MTU_SIZE (1691) plus headers
+    {2048, 64},
+    // BT_DEFAULT_BUFFER_SIZE (4096 + 16)
+    {4352, 64},
+};
+
+constexpr size_t kSlabClassCount =
+    sizeof(kSlabClassConfigs) / sizeof(kSlabClassConfigs[0]);
+
+struct free_block_t {
+  free_block_t* next;
+};
+
+struct slab_class_t {
+  uint8_t* base = nullptr;
+  size_t block_size = 0;
+  size_t block_count = 0;
+
+  std::mutex lock;
+  free_block_t* free_list = nullptr;
+  // Blocks at and past this index have never been handed out, so their pages
+  // may not be resident yet.
+  size_t next_unused = 0;
+
+  // Statistics
+  size_t in_use = 0;
+  size_t high_water = 0;
+  size_t alloc_counter = 0;
+  size_t fallback_counter = 0;
+};
+
+std::mutex init_lock;
+std::atomic<bool> enabled(false);
+uint8_t* region_base = nullptr;
+size_t region_size = 0;
+slab_class_t classes[kSlabClassCount];
+std::atomic<size_t> oversized_counter(0);
+
+slab_class_t* class_for_size(size_t size) {
+  for (auto& slab_class : classes) {
+    if (size <= slab_class.block_size) return &slab_class;
+  }
+  return nullptr;
+}
+
+slab_class_t* class_for_ptr(const void* ptr) {
+  const uint8_t* p = static_cast<const uint8_t*>(ptr);
+  if (p < region_base || p >= region_base + region_size) return nullptr;
+  for (auto& slab_class : classes) {
+    if (p < slab_class.base + slab_class.block_size * slab_class.block_count) {
+      CHECK((p - slab_class.base) % slab_class.block_size == 0);
+      return &slab_class;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+void slab_allocator_init(void) {
+  std::unique_lock<std::mutex> lock(init_lock);
+  if (enabled) return;
+
+  size_t size = 0;
+  for (const auto& config : kSlabClassConfigs) {
+    size += config.block_size * config.block_count;
+  }
+
+  // Only reserve address space here; pages become resident as blocks are
+  // first handed out.
+  void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (region == MAP_FAILED) {
+    LOG_ERROR("%s unable to reserve %zu bytes, slab pools disabled", __func__,
+              size);
+    return;
+  }
+
+  region_base = static_cast<uint8_t*>(region);
+  region_size = size;
+  uint8_t* base = region_base;
+  for (size_t i = 0; i < kSlabClassCount; i++) {
+    slab_class_t& slab_class = classes[i];
+    slab_class.base = base;
+    slab_class.block_size = kSlabClassConfigs[i].block_size;
+    slab_class.block_count = kSlabClassConfigs[i].block_count;
+    slab_class.free_list = nullptr;
+    slab_class.next_unused = 0;
+    slab_class.in_use = 0;
+    slab_class.high_water = 0;
+    slab_class.alloc_counter = 0;
+    slab_class.fallback_counter = 0;
+    base += slab_class.block_size * slab_class.block_count;
+  }
+  oversized_counter = 0;
+
+  LOG_INFO("%s reserved %zu bytes for %zu classes", __func__, size,
+           kSlabClassCount);
+  enabled.store(true, std::memory_order_release);
+}
+
+// Test function only. Do not call in the normal course of operations.
+void slab_allocator_uninit(void) {
+  std::unique_lock<std::mutex> lock(init_lock);
+  if (!enabled) return;
+
+  for (auto& slab_class : classes) {
+    std::unique_lock<std::mutex> class_lock(slab_class.lock);
+    CHECK(slab_class.in_use == 0);
+  }
+
+  enabled.store(false, std::memory_order_release);
+  munmap(region_base, region_size);
+  region_base = nullptr;
+  region_size = 0;
+}
+
+void* slab_allocator_alloc(size_t size) {
+  if (!enabled.load(std::memory_order_acquire)) return nullptr;
+
+  slab_class_t* slab_class = class_for_size(size);
+  if (slab_class == nullptr) {
+    oversized_counter.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  std::unique_lock<std::mutex> lock(slab_class->lock);
+  void* block = nullptr;
+  if (slab_class->free_list != nullptr) {
+    block = slab_class->free_list;
+    slab_class->free_list = slab_class->free_list->next;
+  } else if (slab_class->next_unused < slab_class->block_count) {
+    block = slab_class->base + slab_class->block_size * slab_class->next_unused;
+    slab_class->next_unused++;
+  } else {
+    slab_class->fallback_counter++;
+    return nullptr;
+  }
+
+  slab_class->alloc_counter++;
+  slab_class->in_use++;
+  if (slab_class->in_use > slab_class->high_water) {
+    slab_class->high_water = slab_class->in_use;
+  }
+  return block;
+}
+
+bool slab_allocator_free(void* ptr) {
+  if (ptr == nullptr || !enabled.load(std::memory_order_acquire)) return false;
+
+  slab_class_t* slab_class = class_for_ptr(ptr);
+  if (slab_class == nullptr) return false;
+
+  std::unique_lock<std::mutex> lock(slab_class->lock);
+  CHECK(slab_class->in_use > 0);
+  free_block_t* block = static_cast<free_block_t*>(ptr);
+  block->next = slab_class->free_list;
+  slab_class->free_list = block;
+  slab_class->in_use--;
+  return true;
+}
+
+void slab_allocator_debug_dump(int fd) {
+  if (!enabled.load(std::memory_order_acquire)) return;
+
+  dprintf(fd, "  Slab pools (block size: in use / high water / capacity,"
+              " allocations, fallbacks):\n");
+  for (auto& slab_class : classes) {
+    std::unique_lock<std::mutex> lock(slab_class.lock);
+    dprintf(fd, "    %5zu : %zu / %zu / %zu, %zu, %zu\n",
+            slab_class.block_size, slab_class.in_use, slab_class.high_water,
+            slab_class.block_count, slab_class.alloc_counter,
+            slab_class.fallback_counter);
+  }
+  dprintf(fd, "  Slab oversized allocations : %zu\n",
+          oversized_counter.load(std::memory_order_relaxed));
+}
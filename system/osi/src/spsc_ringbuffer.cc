@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/spsc_ringbuffer.h"
+
+#include <base/logging.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "check.h"
+#include "osi/include/allocator.h"
+
+// |head| and |tail| count the bytes ever read and written. Each is stored by
+// one side only, and their difference is the size of the data. They sit on
+// cache lines of their own so that the two sides don't contend on them.
+struct spsc_ringbuffer_t {
+  uint8_t* base;
+  size_t total;
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+namespace {
+
+// Splits |length| bytes starting at |position| into the part before the end of
+// the buffer and the part wrapped around to its start
+void split_regions(const spsc_ringbuffer_t* rb, size_t position, size_t length,
+                   spsc_ringbuffer_region_t regions[2]) {
+  const size_t offset = position % rb->total;
+  const size_t first = std::min(length, rb->total - offset);
+  regions[0] = {rb->base + offset, first};
+  regions[1] = {rb->base, length - first};
+}
+
+}  // namespace
+
+spsc_ringbuffer_t* spsc_ringbuffer_init(const size_t size) {
+  CHECK(size > 0);
+  spsc_ringbuffer_t* rb = new spsc_ringbuffer_t;
+  rb->base = static_cast<uint8_t*>(osi_calloc(size));
+  rb->total = size;
+  return rb;
+}
+
+void spsc_ringbuffer_free(spsc_ringbuffer_t* rb) {
+  if (rb == NULL) return;
+  osi_free(rb->base);
+  delete rb;
+}
+
+size_t spsc_ringbuffer_available(const spsc_ringbuffer_t* rb) {
+  CHECK(rb);
+  return rb->total - spsc_ringbuffer_size(rb);
+}
+
+size_t spsc_ringbuffer_size(const spsc_ringbuffer_t* rb) {
+  CHECK(rb);
+  return rb->tail.load(std::memory_order_acquire) -
+         rb->head.load(std::memory_order_acquire);
+}
+
+size_t spsc_ringbuffer_insert(spsc_ringbuffer_t* rb, const uint8_t* p,
+                              size_t length) {
+  CHECK(p);
+  spsc_ringbuffer_region_t regions[2];
+  length = spsc_ringbuffer_reserve(rb, length, regions);
+  memcpy(regions[0].data, p, regions[0].length);
+  memcpy(regions[1].data, p + regions[0].length, regions[1].length);
+  spsc_ringbuffer_commit(rb, length);
+  return length;
+}
+
+size_t spsc_ringbuffer_reserve(spsc_ringbuffer_t* rb, size_t length,
+                               spsc_ringbuffer_region_t regions[2]) {
+  CHECK(rb);
+  CHECK(regions);
+  const size_t tail = rb->tail.load(std::memory_order_relaxed);
+  // Acquire the consumer's reads of the bytes it handed back
+  const size_t head = rb->head.load(std::memory_order_acquire);
+  length = std::min(length, rb->total - (tail - head));
+  split_regions(rb, tail, length, regions);
+  return length;
+}
+
+void spsc_ringbuffer_commit(spsc_ringbuffer_t* rb, size_t length) {
+  CHECK(rb);
+  const size_t tail = rb->tail.load(std::memory_order_relaxed);
+  const size_t head = rb->head.load(std::memory_order_acquire);
+  CHECK(length <= rb->total - (tail - head));
+  rb->tail.store(tail + length, std::memory_order_release);
+}
+
+size_t spsc_ringbuffer_pop(spsc_ringbuffer_t* rb, uint8_t* p, size_t length) {
+  CHECK(p);
+  spsc_ringbuffer_region_t regions[2];
+  length = std::min(length, spsc_ringbuffer_peek(rb, regions));
+  const size_t first = std::min(length, regions[0].length);
+  memcpy(p, regions[0].data, first);
+  memcpy(p + first, regions[1].data, length - first);
+  spsc_ringbuffer_consume(rb, length);
+  return length;
+}
+
+size_t spsc_ringbuffer_peek(const spsc_ringbuffer_t* rb,
+                            spsc_ringbuffer_region_t regions[2]) {
+  CHECK(rb);
+  CHECK(regions);
+  const size_t head = rb->head.load(std::memory_order_relaxed);
+  // Acquire the producer's writes of the bytes it committed
+  const size_t length = rb->tail.load(std::memory_order_acquire) - head;
+  split_regions(rb, head, length, regions);
+  return length;
+}
+
+void spsc_ringbuffer_consume(spsc_ringbuffer_t* rb, size_t length) {
+  CHECK(rb);
+  const size_t head = rb->head.load(std::memory_order_relaxed);
+  CHECK(length <= rb->tail.load(std::memory_order_acquire) - head);
+  rb->head.store(head + length, std::memory_order_release);
+}
@@ -24,6 +24,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <pthread.h>
+#include <signal.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -40,6 +41,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/thread.h"
 #include "osi/include/wakelock.h"
 
@@ -59,6 +61,18 @@ static pthread_once_t initialized = PTHREAD_ONCE_INIT;
 static int wake_lock_fd = INVALID_FD;
 static int wake_unlock_fd = INVALID_FD;
 
+static const char* RELEASE_HOLDOFF_PROPERTY =
+    "bluetooth.wakelock.release_holdoff_ms";
+// -1 until set by wakelock_set_release_holdoff() or read from the property
+static int64_t release_holdoff_ms = -1;
+static timer_t release_timer;
+static bool release_timer_created = false;
+// A release held off until |release_deadline_ms|
+static bool release_pending = false;
+static uint64_t release_deadline_ms = 0;
+// Serializes acquires and releases with the deferred release of the timer
+static std::mutex wakelock_mutex;
+
 // Wakelock statistics for the "bluetooth_timer"
 typedef struct {
   bool is_acquired;
@@ -75,6 +89,8 @@ typedef struct {
   uint64_t last_reset_timestamp_ms;
   int last_acquired_error;
   int last_released_error;
+  // Acquires that cancelled a held off release instead of reaching the OS
+  size_t held_over_count;
 } wakelock_stats_t;
 
 static wakelock_stats_t wakelock_stats;
@@ -87,11 +103,15 @@ static bt_status_t wakelock_acquire_callout(void);
 static bt_status_t wakelock_acquire_native(void);
 static bt_status_t wakelock_release_callout(void);
 static bt_status_t wakelock_release_native(void);
+static bool wakelock_release_now(void);
+static void wakelock_release_timer_expired(union sigval sigval);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
 static void update_wakelock_acquired_stats(bt_status_t acquired_status);
 static void update_wakelock_released_stats(bt_status_t released_status);
+static void update_wakelock_held_over_stats(void);
+static uint64_t now_ms(void);
 
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   wakelock_os_callouts = callouts;
@@ -99,9 +119,22 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   LOG_INFO("%s set to %s", __func__, (is_native) ? "native" : "non-native");
 }
 
+void wakelock_set_release_holdoff(uint32_t holdoff_ms) {
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  release_holdoff_ms = holdoff_ms;
+}
+
 bool wakelock_acquire(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  if (release_pending) {
+    // Still held from the previous burst
+    release_pending = false;
+    update_wakelock_held_over_stats();
+    return true;
+  }
+
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -148,6 +181,25 @@ static bt_status_t wakelock_acquire_native(void) {
 bool wakelock_release(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  if (release_timer_created) {
+    release_pending = true;
+    release_deadline_ms = now_ms() + release_holdoff_ms;
+
+    struct itimerspec holdoff = {};
+    holdoff.it_value.tv_sec = release_holdoff_ms / 1000;
+    holdoff.it_value.tv_nsec = (release_holdoff_ms % 1000) * 1000000LL;
+    if (timer_settime(release_timer, 0, &holdoff, NULL) == 0) return true;
+
+    LOG_ERROR("%s unable to hold off the release: %s", __func__,
+              strerror(errno));
+    release_pending = false;
+  }
+  return wakelock_release_now();
+}
+
+// NOTE: must be called with |wakelock_mutex| held
+static bool wakelock_release_now(void) {
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -181,10 +233,37 @@ static bt_status_t wakelock_release_native(void) {
   return BT_STATUS_SUCCESS;
 }
 
+static void wakelock_release_timer_expired(union sigval /* sigval */) {
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  // The release may have been cancelled, or pushed back by a later one while
+  // this expiry was in flight.
+  if (!release_pending || now_ms() < release_deadline_ms) return;
+  release_pending = false;
+  wakelock_release_now();
+}
+
 static void wakelock_initialize(void) {
   reset_wakelock_stats();
 
   if (is_native) wakelock_initialize_native();
+
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  if (release_holdoff_ms < 0) {
+    release_holdoff_ms = osi_property_get_int32(RELEASE_HOLDOFF_PROPERTY, 0);
+  }
+  if (release_holdoff_ms > 0) {
+    struct sigevent sigevent = {};
+    sigevent.sigev_notify = SIGEV_THREAD;
+    sigevent.sigev_notify_function = wakelock_release_timer_expired;
+    if (timer_create(CLOCK_ID, &sigevent, &release_timer) == 0) {
+      release_timer_created = true;
+      LOG_INFO("%s releases held off for %" PRId64 " ms", __func__,
+               release_holdoff_ms);
+    } else {
+      LOG_ERROR("%s unable to create the release timer: %s", __func__,
+                strerror(errno));
+    }
+  }
 }
 
 static void wakelock_initialize_native(void) {
@@ -208,9 +287,18 @@ static void wakelock_initialize_native(void) {
 }
 
 void wakelock_cleanup(void) {
-  if (wakelock_stats.is_acquired) {
-    LOG_ERROR("%s releasing wake lock as part of cleanup", __func__);
-    wakelock_release();
+  {
+    std::lock_guard<std::mutex> lock(wakelock_mutex);
+    if (release_timer_created) {
+      timer_delete(release_timer);
+      release_timer_created = false;
+    }
+    release_pending = false;
+    if (wakelock_stats.is_acquired) {
+      LOG_ERROR("%s releasing wake lock as part of cleanup", __func__);
+      wakelock_release_now();
+    }
+    release_holdoff_ms = -1;
   }
   wake_lock_path.clear();
   wake_unlock_path.clear();
@@ -250,6 +338,7 @@ static void reset_wakelock_stats(void) {
   wakelock_stats.last_acquired_timestamp_ms = 0;
   wakelock_stats.last_released_timestamp_ms = 0;
   wakelock_stats.last_reset_timestamp_ms = now_ms();
+  wakelock_stats.held_over_count = 0;
 }
 
 //
@@ -324,6 +413,12 @@ static void update_wakelock_released_stats(bt_status_t released_status) {
       bluetooth::common::WAKE_EVENT_RELEASED, "", "", just_now_ms);
 }
 
+// This function is thread-safe.
+static void update_wakelock_held_over_stats(void) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  wakelock_stats.held_over_count++;
+}
+
 void wakelock_debug_dump(int fd) {
   const uint64_t just_now_ms = now_ms();
 
@@ -369,4 +464,15 @@ void wakelock_debug_dump(int fd) {
   dprintf(fd, "  Total run time (ms)            : %llu\n",
           (unsigned long long)(just_now_ms -
                                wakelock_stats.last_reset_timestamp_ms));
+
+  uint64_t run_time_ms = just_now_ms - wakelock_stats.last_reset_timestamp_ms;
+  if (run_time_ms > 0) {
+    dprintf(fd, "  Acquires per minute / held     : %.2f / %.1f%%\n",
+            wakelock_stats.acquired_count * 60000.0 / run_time_ms,
+            total_interval_ms * 100.0 / run_time_ms);
+  }
+  dprintf(fd, "  Release hold-off (ms)          : %lld\n",
+          (long long)release_holdoff_ms);
+  dprintf(fd, "  Releases held over             : %zu\n",
+          wakelock_stats.held_over_count);
 }
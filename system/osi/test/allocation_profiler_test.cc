@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "osi/include/allocation_profiler.h"
+
+static const char kSiteA = 0;
+static const char kSiteB = 0;
+
+class AllocationProfilerTest : public ::testing::Test {
+ protected:
+  void TearDown() override { allocation_profiler_set_sample_interval(0); }
+};
+
+TEST_F(AllocationProfilerTest, test_disabled_records_nothing) {
+  allocation_profiler_set_sample_interval(0);
+  int allocation;
+  allocation_profiler_notify_alloc(&kSiteA, &allocation, sizeof(allocation));
+  allocation_profiler_notify_free(&allocation);
+
+  allocation_profiler_site_t sites[4];
+  EXPECT_EQ(0U, allocation_profiler_get_sites(sites, 4));
+}
+
+TEST_F(AllocationProfilerTest, test_live_bytes_per_call_site) {
+  allocation_profiler_set_sample_interval(1);
+  int a1, a2, b1;
+  allocation_profiler_notify_alloc(&kSiteA, &a1, 100);
+  allocation_profiler_notify_alloc(&kSiteA, &a2, 100);
+  allocation_profiler_notify_alloc(&kSiteB, &b1, 10);
+  allocation_profiler_notify_free(&a1);
+
+  allocation_profiler_site_t sites[4];
+  ASSERT_EQ(2U, allocation_profiler_get_sites(sites, 4));
+  EXPECT_EQ(&kSiteA, sites[0].call_site);
+  EXPECT_EQ(2U, sites[0].sample_count);
+  EXPECT_EQ(200U, sites[0].estimated_bytes);
+  EXPECT_EQ(100, sites[0].estimated_live_bytes);
+  EXPECT_EQ(&kSiteB, sites[1].call_site);
+  EXPECT_EQ(10, sites[1].estimated_live_bytes);
+
+  allocation_profiler_notify_free(&a2);
+  allocation_profiler_notify_free(&b1);
+  ASSERT_EQ(2U, allocation_profiler_get_sites(sites, 4));
+  EXPECT_EQ(0, sites[0].estimated_live_bytes);
+  EXPECT_EQ(0, sites[1].estimated_live_bytes);
+}
+
+TEST_F(AllocationProfilerTest, test_samples_scale_by_interval) {
+  allocation_profiler_set_sample_interval(4);
+  int allocations[8];
+  for (int& allocation : allocations) {
+    allocation_profiler_notify_alloc(&kSiteA, &allocation, 16);
+  }
+
+  allocation_profiler_site_t sites[4];
+  ASSERT_EQ(1U, allocation_profiler_get_sites(sites, 4));
+  EXPECT_EQ(2U, sites[0].sample_count);
+  EXPECT_EQ(8U * 16, sites[0].estimated_bytes);
+
+  for (int& allocation : allocations) {
+    allocation_profiler_notify_free(&allocation);
+  }
+  ASSERT_EQ(1U, allocation_profiler_get_sites(sites, 4));
+  EXPECT_EQ(0, sites[0].estimated_live_bytes);
+}
+
+TEST_F(AllocationProfilerTest, test_transient_allocations_by_name) {
+  allocation_profiler_set_sample_interval(1);
+  allocation_profiler_notify_transient_alloc("acl rx", 27);
+  allocation_profiler_notify_transient_alloc("acl rx", 27);
+
+  allocation_profiler_site_t sites[4];
+  ASSERT_EQ(1U, allocation_profiler_get_sites(sites, 4));
+  EXPECT_STREQ("acl rx", sites[0].name);
+  EXPECT_EQ(nullptr, sites[0].call_site);
+  EXPECT_EQ(54U, sites[0].estimated_bytes);
+  EXPECT_EQ(0, sites[0].estimated_live_bytes);
+}
+
+TEST_F(AllocationProfilerTest, test_debug_dump) {
+  allocation_profiler_set_sample_interval(1);
+  allocation_profiler_notify_transient_alloc("acl rx", 27);
+
+  FILE* file = tmpfile();
+  ASSERT_NE(nullptr, file);
+  allocation_profiler_debug_dump(fileno(file));
+  rewind(file);
+  char contents[1024] = {};
+  fread(contents, 1, sizeof(contents) - 1, file);
+  fclose(file);
+  EXPECT_NE(nullptr, strstr(contents, "acl rx"));
+}
@@ -48,6 +48,15 @@ TEST_F(PropertiesTest, test_default_value_int32) {
   ASSERT_EQ(rvalue, value);
 }
 
+TEST_F(PropertiesTest, test_cached_value_follows_set) {
+  static osi_cached_property_t<bool> cached = {"very.useful.cached.test",
+                                               false};
+  ASSERT_EQ(0, osi_property_set("very.useful.cached.test", "false"));
+  ASSERT_FALSE(osi_property_get_cached(&cached));
+  ASSERT_EQ(0, osi_property_set("very.useful.cached.test", "true"));
+  ASSERT_TRUE(osi_property_get_cached(&cached));
+}
+
 TEST_F(PropertiesTest, test_successfull_set_and_get_value_int32) {
 #ifdef __ANDROID__
   char value[PROPERTY_VALUE_MAX] = "42";
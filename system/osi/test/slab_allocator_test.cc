@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/slab_allocator.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "AllocationTestHarness.h"
+#include "osi/include/allocator.h"
+
+class SlabAllocatorTest : public AllocationTestHarness {
+ protected:
+  void SetUp() override {
+    AllocationTestHarness::SetUp();
+    slab_allocator_init();
+  }
+  void TearDown() override {
+    slab_allocator_uninit();
+    AllocationTestHarness::TearDown();
+  }
+};
+
+TEST(SlabAllocatorUninitTest, no_allocations_when_not_initialized) {
+  EXPECT_EQ(nullptr, slab_allocator_alloc(16));
+
+  void* ptr = malloc(16);
+  EXPECT_FALSE(slab_allocator_free(ptr));
+  free(ptr);
+}
+
+TEST_F(SlabAllocatorTest, freed_block_is_reused) {
+  void* first = slab_allocator_alloc(100);
+  ASSERT_NE(nullptr, first);
+  EXPECT_TRUE(slab_allocator_free(first));
+
+  void* second = slab_allocator_alloc(200);
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(slab_allocator_free(second));
+}
+
+TEST_F(SlabAllocatorTest, oversized_request_is_not_served) {
+  EXPECT_EQ(nullptr, slab_allocator_alloc(64 * 1024));
+}
+
+TEST_F(SlabAllocatorTest, foreign_pointer_is_not_owned) {
+  void* ptr = malloc(16);
+  EXPECT_FALSE(slab_allocator_free(ptr));
+  free(ptr);
+}
+
+TEST_F(SlabAllocatorTest, exhausted_class_falls_back) {
+  std::vector<void*> blocks;
+  void* block;
+  while ((block = slab_allocator_alloc(4000)) != nullptr) {
+    blocks.push_back(block);
+    ASSERT_LT(blocks.size(), 1024U);
+  }
+  EXPECT_FALSE(blocks.empty());
+
+  // osi_malloc still succeeds once the class is exhausted
+  void* fallback = osi_malloc(4000);
+  ASSERT_NE(nullptr, fallback);
+  osi_free(fallback);
+
+  for (void* b : blocks) {
+    EXPECT_TRUE(slab_allocator_free(b));
+  }
+}
+
+TEST_F(SlabAllocatorTest, osi_calloc_clears_recycled_block) {
+  uint8_t* buffer = static_cast<uint8_t*>(osi_malloc(512));
+  memset(buffer, 0xa5, 512);
+  osi_free(buffer);
+
+  buffer = static_cast<uint8_t*>(osi_calloc(512));
+  for (size_t i = 0; i < 512; i++) {
+    ASSERT_EQ(0, buffer[i]);
+  }
+  osi_free(buffer);
+}
+
+TEST_F(SlabAllocatorTest, concurrent_alloc_and_free) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([]() {
+      for (int i = 0; i < 10000; i++) {
+        void* ptr = osi_malloc(1000);
+        memset(ptr, i, 1000);
+        osi_free(ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+
+#include "osi/include/spsc_ringbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+TEST(SpscRingbufferTest, test_insert_pop) {
+  spsc_ringbuffer_t* rb = spsc_ringbuffer_init(8);
+  EXPECT_EQ((size_t)8, spsc_ringbuffer_available(rb));
+
+  uint8_t data[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_EQ((size_t)6, spsc_ringbuffer_insert(rb, data, 6));
+  uint8_t out[10] = {0};
+  EXPECT_EQ((size_t)4, spsc_ringbuffer_pop(rb, out, 4));
+  EXPECT_EQ(0, memcmp(data, out, 4));
+
+  // Wraps around the end of the buffer, and stops once it is full
+  EXPECT_EQ((size_t)6, spsc_ringbuffer_insert(rb, data + 4, 6));
+  EXPECT_EQ((size_t)0, spsc_ringbuffer_insert(rb, data, 1));
+  EXPECT_EQ((size_t)8, spsc_ringbuffer_size(rb));
+  EXPECT_EQ((size_t)8, spsc_ringbuffer_pop(rb, out, 10));
+  EXPECT_EQ(0, memcmp(data + 4, out, 2));
+  EXPECT_EQ(0, memcmp(data + 4, out + 2, 6));
+
+  spsc_ringbuffer_free(rb);
+}
+
+TEST(SpscRingbufferTest, test_regions_wrap) {
+  spsc_ringbuffer_t* rb = spsc_ringbuffer_init(8);
+  spsc_ringbuffer_region_t regions[2];
+
+  ASSERT_EQ((size_t)5, spsc_ringbuffer_reserve(rb, 5, regions));
+  memset(regions[0].data, 0xAA, regions[0].length);
+  spsc_ringbuffer_commit(rb, 5);
+  ASSERT_EQ((size_t)5, spsc_ringbuffer_peek(rb, regions));
+  spsc_ringbuffer_consume(rb, 5);
+
+  ASSERT_EQ((size_t)6, spsc_ringbuffer_reserve(rb, 6, regions));
+  EXPECT_EQ((size_t)3, regions[0].length);
+  EXPECT_EQ((size_t)3, regions[1].length);
+  for (size_t i = 0; i < 3; i++) {
+    regions[0].data[i] = i;
+    regions[1].data[i] = 3 + i;
+  }
+  // Only what is committed reaches the consumer
+  spsc_ringbuffer_commit(rb, 4);
+
+  ASSERT_EQ((size_t)4, spsc_ringbuffer_peek(rb, regions));
+  ASSERT_EQ((size_t)3, regions[0].length);
+  ASSERT_EQ((size_t)1, regions[1].length);
+  EXPECT_EQ(2, regions[0].data[2]);
+  EXPECT_EQ(3, regions[1].data[0]);
+  spsc_ringbuffer_consume(rb, 2);
+  EXPECT_EQ((size_t)2, spsc_ringbuffer_size(rb));
+  EXPECT_EQ((size_t)6, spsc_ringbuffer_available(rb));
+
+  spsc_ringbuffer_free(rb);
+}
+
+TEST(SpscRingbufferTest, test_producer_and_consumer_threads) {
+  constexpr size_t kBytes = 1 << 16;
+  spsc_ringbuffer_t* rb = spsc_ringbuffer_init(61);
+
+  std::thread producer([rb]() {
+    uint8_t chunk[17];
+    size_t sent = 0;
+    while (sent < kBytes) {
+      size_t length = std::min(sizeof(chunk), kBytes - sent);
+      for (size_t i = 0; i < length; i++) chunk[i] = (sent + i) & 0xff;
+      size_t inserted = spsc_ringbuffer_insert(rb, chunk, length);
+      if (inserted == 0) std::this_thread::yield();
+      sent += inserted;
+    }
+  });
+
+  size_t received = 0;
+  bool in_order = true;
+  spsc_ringbuffer_region_t regions[2];
+  while (received < kBytes) {
+    size_t length = spsc_ringbuffer_peek(rb, regions);
+    for (const auto& region : regions) {
+      for (size_t i = 0; i < region.length; i++) {
+        in_order &= region.data[i] == (received++ & 0xff);
+      }
+    }
+    spsc_ringbuffer_consume(rb, length);
+    if (length == 0) std::this_thread::yield();
+  }
+  producer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ((size_t)0, spsc_ringbuffer_size(rb));
+  spsc_ringbuffer_free(rb);
+}
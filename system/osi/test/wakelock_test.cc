@@ -24,14 +24,20 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "osi/include/wakelock.h"
 
 #include "AllocationTestHarness.h"
 
-static bool is_wake_lock_acquired = false;
+static std::atomic<bool> is_wake_lock_acquired = false;
+static std::atomic<int> acquire_wake_lock_count = 0;
 
 static int acquire_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = true;
+  acquire_wake_lock_count++;
   return BT_STATUS_SUCCESS;
 }
 
@@ -74,6 +80,7 @@ class WakelockTest : public AllocationTestHarness {
 
   void TearDown() override {
     is_wake_lock_acquired = false;
+    acquire_wake_lock_count = 0;
     wakelock_cleanup();
     wakelock_set_os_callouts(NULL);
 
@@ -161,3 +168,22 @@ TEST_F(WakelockTest, test_set_paths) {
     ASSERT_FALSE(IsFileWakeLockAcquired());
   }
 }
+
+TEST_F(WakelockTest, test_release_holdoff) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_holdoff(50);
+
+  for (size_t i = 0; i < 10; i++) {
+    wakelock_acquire();
+    ASSERT_TRUE(is_wake_lock_acquired);
+    wakelock_release();
+    ASSERT_TRUE(is_wake_lock_acquired);
+  }
+  // The bursts after the first one reused the held wakelock
+  ASSERT_EQ(acquire_wake_lock_count, 1);
+
+  for (size_t i = 0; i < 100 && is_wake_lock_acquired; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_FALSE(is_wake_lock_acquired);
+}
@@ -1132,10 +1132,11 @@ void Device::HandleGetFolderItems(uint8_t label,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetVFSListResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      // A listing from the first item refreshes the folder, the pages after it
+      // are served from the same snapshot.
+      GetVFSFolderItems(pkt->GetStartItem() == 0,
+                        base::Bind(&Device::GetVFSListResponse,
+                                   weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     case Scope::NOW_PLAYING:
       media_interface_->GetNowPlayingList(
@@ -1169,10 +1170,9 @@ void Device::HandleGetTotalNumberOfItems(
       break;
     }
     case Scope::VFS:
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label));
+      GetVFSFolderItems(false,
+                        base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
+                                   weak_ptr_factory_.GetWeakPtr(), label));
       break;
     case Scope::NOW_PLAYING:
       media_interface_->GetNowPlayingList(
@@ -1194,8 +1194,8 @@ void Device::GetTotalNumberOfItemsMediaPlayersResponse(
   send_message(label, true, std::move(builder));
 }
 
-void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                              std::vector<ListItem> list) {
+void Device::GetTotalNumberOfItemsVFSResponse(
+    uint8_t label, const std::vector<ListItem>& list) {
   DEVICE_VLOG(2) << __func__ << ": num_items=" << list.size();
 
   auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
@@ -1253,15 +1253,14 @@ void Device::HandleChangePath(uint8_t label,
                    << "\"";
   }
 
-  media_interface_->GetFolderItems(
-      curr_browsed_player_id_, CurrentFolder(),
-      base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(),
-                 label, pkt));
+  GetVFSFolderItems(true, base::Bind(&Device::ChangePathResponse,
+                                     weak_ptr_factory_.GetWeakPtr(), label,
+                                     pkt));
 }
 
 void Device::ChangePathResponse(uint8_t label,
                                 std::shared_ptr<ChangePathRequest> pkt,
-                                std::vector<ListItem> list) {
+                                const std::vector<ListItem>& list) {
   // TODO (apanicke): Reconstruct the VFS ID's here. Right now it gets
   // reconstructed in GetFolderItemsVFS
   auto builder =
@@ -1300,10 +1299,9 @@ void Device::HandleGetItemAttributes(
       // then we can auto send the error without calling up. We do this check
       // later right now though in order to prevent race conditions with updates
       // on the media layer.
-      media_interface_->GetFolderItems(
-          curr_browsed_player_id_, CurrentFolder(),
-          base::Bind(&Device::GetItemAttributesVFSResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+      GetVFSFolderItems(false,
+                        base::Bind(&Device::GetItemAttributesVFSResponse,
+                                   weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     default:
       DEVICE_LOG(ERROR) << "UNKNOWN SCOPE FOR HANDLE GET ITEM ATTRIBUTES";
@@ -1364,7 +1362,7 @@ void Device::GetItemAttributesNowPlayingResponse(
 
 void Device::GetItemAttributesVFSResponse(
     uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-    std::vector<ListItem> item_list) {
+    const std::vector<ListItem>& item_list) {
   DEVICE_VLOG(2) << __func__ << ": uid=" << loghex(pkt->GetUid());
 
   auto media_id = vfs_ids_.get_media_id(pkt->GetUid());
@@ -1480,7 +1478,7 @@ std::set<AttributeEntry> filter_attributes_requested(
 
 void Device::GetVFSListResponse(uint8_t label,
                                 std::shared_ptr<GetFolderItemsRequest> pkt,
-                                std::vector<ListItem> items) {
+                                const std::vector<ListItem>& items) {
   DEVICE_VLOG(2) << __func__ << ": start_item=" << pkt->GetStartItem()
                  << " end_item=" << pkt->GetEndItem();
 
@@ -1490,12 +1488,17 @@ void Device::GetVFSListResponse(uint8_t label,
 
   // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
   // an operation.
-  for (const auto& item : items) {
-    if (item.type == ListItem::FOLDER) {
-      vfs_ids_.insert(item.folder.media_id);
-    } else if (item.type == ListItem::SONG) {
-      vfs_ids_.insert(item.song.media_id);
+  // |items| is the cached listing, whose ids only need inserting for the first
+  // page served from it.
+  if (!vfs_cache_.ids_inserted) {
+    for (const auto& item : items) {
+      if (item.type == ListItem::FOLDER) {
+        vfs_ids_.insert(item.folder.media_id);
+      } else if (item.type == ListItem::SONG) {
+        vfs_ids_.insert(item.song.media_id);
+      }
     }
+    vfs_cache_.ids_inserted = true;
   }
 
   // Add the elements retrieved in the last get folder items request and map
@@ -1506,7 +1509,7 @@ void Device::GetVFSListResponse(uint8_t label,
   for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
       FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
                              folder.is_playable, folder.name);
@@ -1583,6 +1586,35 @@ void Device::GetNowPlayingListResponse(
   send_message(label, true, std::move(builder));
 }
 
+void Device::GetVFSFolderItems(bool refresh, VFSFolderItemsCallback cb) {
+  if (!refresh && vfs_cache_.valid &&
+      vfs_cache_.player_id == curr_browsed_player_id_ &&
+      vfs_cache_.folder == CurrentFolder()) {
+    DEVICE_VLOG(3) << __func__ << ": using " << vfs_cache_.items.size()
+                   << " cached items";
+    cb.Run(vfs_cache_.items);
+    return;
+  }
+
+  media_interface_->GetFolderItems(
+      curr_browsed_player_id_, CurrentFolder(),
+      base::Bind(&Device::VFSFolderItemsFetched, weak_ptr_factory_.GetWeakPtr(),
+                 curr_browsed_player_id_, CurrentFolder(), cb));
+}
+
+void Device::VFSFolderItemsFetched(int player_id, std::string folder,
+                                   VFSFolderItemsCallback cb,
+                                   std::vector<ListItem> items) {
+  vfs_cache_.valid = true;
+  vfs_cache_.player_id = player_id;
+  vfs_cache_.folder = std::move(folder);
+  vfs_cache_.items = std::move(items);
+  vfs_cache_.ids_inserted = false;
+  cb.Run(vfs_cache_.items);
+}
+
+void Device::InvalidateVFSCache() { vfs_cache_ = VFSFolderCache(); }
+
 void Device::HandleSetBrowsedPlayer(
     uint8_t label, std::shared_ptr<SetBrowsedPlayerRequest> pkt) {
   if (!pkt->IsValid()) {
@@ -1621,6 +1653,7 @@ void Device::SetBrowsedPlayerResponse(
   }
 
   curr_browsed_player_id_ = pkt->GetPlayerId();
+  InvalidateVFSCache();
 
   // Clear the path and push the new root.
   current_path_ = std::stack<std::string>();
@@ -1658,6 +1691,10 @@ void Device::SendFolderUpdate(bool available_players, bool addressed_player,
   CHECK(media_interface_);
   DEVICE_VLOG(4) << __func__;
 
+  if (available_players || uids) {
+    InvalidateVFSCache();
+  }
+
   if (available_players) {
     HandleAvailablePlayerUpdate();
   }
@@ -1858,6 +1895,10 @@ std::ostream& operator<<(std::ostream& out, const Device& d) {
   out << "Current Volume: " << volumeToStr(d.volume_) << std::endl;
   out << "Current Browsed Player ID: " << d.curr_browsed_player_id_
       << std::endl;
+  if (d.vfs_cache_.valid) {
+    out << "Cached Folder: \"" << d.vfs_cache_.folder << "\" ("
+        << d.vfs_cache_.items.size() << " items)" << std::endl;
+  }
   out << "Registered Notifications:\n";
   {
     ScopedIndent indent(out);
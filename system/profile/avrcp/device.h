@@ -222,7 +222,7 @@ class Device {
       uint16_t curr_player, std::vector<MediaPlayerInfo> players);
   virtual void GetVFSListResponse(uint8_t label,
                                   std::shared_ptr<GetFolderItemsRequest> pkt,
-                                  std::vector<ListItem> items);
+                                  const std::vector<ListItem>& items);
   virtual void GetNowPlayingListResponse(
       uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
       std::string curr_song_id, std::vector<SongInfo> song_list);
@@ -232,8 +232,8 @@ class Device {
       uint8_t label, std::shared_ptr<GetTotalNumberOfItemsRequest> pkt);
   virtual void GetTotalNumberOfItemsMediaPlayersResponse(
       uint8_t label, uint16_t curr_player, std::vector<MediaPlayerInfo> list);
-  virtual void GetTotalNumberOfItemsVFSResponse(uint8_t label,
-                                                std::vector<ListItem> items);
+  virtual void GetTotalNumberOfItemsVFSResponse(
+      uint8_t label, const std::vector<ListItem>& items);
   virtual void GetTotalNumberOfItemsNowPlayingResponse(
       uint8_t label, std::string curr_song_id, std::vector<SongInfo> song_list);
 
@@ -245,7 +245,7 @@ class Device {
       std::string curr_media_id, std::vector<SongInfo> song_list);
   virtual void GetItemAttributesVFSResponse(
       uint8_t label, std::shared_ptr<GetItemAttributesRequest> pkt,
-      std::vector<ListItem> item_list);
+      const std::vector<ListItem>& item_list);
 
   // SET BROWSED PLAYER
   virtual void HandleSetBrowsedPlayer(
@@ -259,7 +259,7 @@ class Device {
                                 std::shared_ptr<ChangePathRequest> request);
   virtual void ChangePathResponse(uint8_t label,
                                   std::shared_ptr<ChangePathRequest> request,
-                                  std::vector<ListItem> list);
+                                  const std::vector<ListItem>& list);
 
   // PLAY ITEM
   virtual void HandlePlayItem(uint8_t label,
@@ -321,6 +321,17 @@ class Device {
     return current_path_.top();
   }
 
+  using VFSFolderItemsCallback =
+      base::Callback<void(const std::vector<ListItem>&)>;
+
+  // Runs |cb| with the items of the current folder, from the cache when it
+  // holds that folder and |refresh| is false.
+  void GetVFSFolderItems(bool refresh, VFSFolderItemsCallback cb);
+  void VFSFolderItemsFetched(int player_id, std::string folder,
+                             VFSFolderItemsCallback cb,
+                             std::vector<ListItem> items);
+  void InvalidateVFSCache();
+
   void send_message(uint8_t label, bool browse,
                     std::unique_ptr<::bluetooth::PacketBuilder> message) {
     active_labels_.erase(label);
@@ -359,6 +370,20 @@ class Device {
   MediaIdMap vfs_ids_;
   MediaIdMap now_playing_ids_;
 
+  // Last folder listing fetched from the media interface. Car kits page
+  // through a folder with one GetFolderItems per MTU worth of items, and the
+  // media interface only hands out whole folders, so later pages, item
+  // attributes and item counts are served from here instead.
+  struct VFSFolderCache {
+    bool valid = false;
+    int player_id = -1;
+    std::string folder;
+    std::vector<ListItem> items;
+    // Whether the items were already added to vfs_ids_
+    bool ids_inserted = false;
+  };
+  VFSFolderCache vfs_cache_;
+
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
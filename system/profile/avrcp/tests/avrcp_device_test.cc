@@ -1006,6 +1006,49 @@ TEST_F(AvrcpDeviceTest, getVFSFolderTest) {
   SendBrowseMessage(1, request);
 }
 
+TEST_F(AvrcpDeviceTest, getVFSFolderPagesFromCacheTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+
+  FolderInfo info0 = {"test_id0", true, "Test Folder0"};
+  FolderInfo info1 = {"test_id1", true, "Test Folder1"};
+  ListItem item0 = {ListItem::FOLDER, info0, SongInfo()};
+  ListItem item1 = {ListItem::FOLDER, info1, SongInfo()};
+  std::vector<ListItem> list = {item0, item1};
+
+  // Only the first page goes up to the media interface
+  EXPECT_CALL(interface, GetFolderItems(_, "", _))
+      .Times(1)
+      .WillOnce(InvokeCb<2>(list));
+
+  auto first_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  first_page->AddFolder(FolderItem(1, 0, true, "Test Folder0"));
+  EXPECT_CALL(response_cb, Call(1, true, matchPacket(std::move(first_page))))
+      .Times(1);
+
+  auto request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 0, 0, {});
+  auto request = TestBrowsePacket::Make();
+  request_builder->Serialize(request);
+  SendBrowseMessage(1, request);
+
+  auto second_page = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  second_page->AddFolder(FolderItem(2, 0, true, "Test Folder1"));
+  EXPECT_CALL(response_cb, Call(2, true, matchPacket(std::move(second_page))))
+      .Times(1);
+
+  request_builder =
+      GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 1, 1, {});
+  request = TestBrowsePacket::Make();
+  request_builder->Serialize(request);
+  SendBrowseMessage(2, request);
+}
+
 TEST_F(AvrcpDeviceTest, getFolderItemsMtuTest) {
   auto truncated_packet = GetFolderItemsResponseBuilder::MakeVFSBuilder(
       Status::NO_ERROR, 0x0000, 0xFFFF);
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "a2dp_aac.h"
+#include "a2dp_bitrate_controller.h"
 #include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -38,6 +39,10 @@
 // A2DP AAC encoder interval in milliseconds
 #define A2DP_AAC_ENCODER_INTERVAL_MS 20
 
+// Lowest bit rate and bit rate step of the adaptive bit rate
+#define A2DP_AAC_ADAPTIVE_MIN_BITRATE 96000  // 96 kbps
+#define A2DP_AAC_ADAPTIVE_BITRATE_STEP 32000  // 32 kbps
+
 // offset
 #if (BTA_AV_CO_CP_SCMS_T == TRUE)
 #define A2DP_AAC_OFFSET (AVDT_MEDIA_OFFSET + 1)
@@ -52,6 +57,8 @@ typedef struct {
   uint32_t frame_length;         // Samples per channel in a frame
   uint8_t input_channels_n;      // Number of channels
   int max_encoded_buffer_bytes;  // Max encoded bytes per frame
+  int bit_rate;                  // Bit rate set when the encoder was updated
+  bool is_vbr;                   // True if Variable Bit Rate is used
 } tA2DP_AAC_ENCODER_PARAMS;
 
 typedef struct {
@@ -87,6 +94,7 @@ typedef struct {
   tA2DP_FEEDING_PARAMS feeding_params;
   tA2DP_AAC_ENCODER_PARAMS aac_encoder_params;
   tA2DP_AAC_FEEDING_STATE aac_feeding_state;
+  tA2DP_BITRATE_CONTROLLER bitrate_controller;  // Adaptive AAC bit rate
 
   a2dp_aac_encoder_stats_t stats;
 } tA2DP_AAC_ENCODER_CB;
@@ -106,6 +114,8 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame);
 static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read);
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params);
+static void a2dp_aac_apply_target_bit_rate(void);
+static void a2dp_aac_encoder_reset_cb(void);
 
 bool A2DP_LoadEncoderAac(void) {
   // Nothing to do - the library is statically linked
@@ -123,9 +133,22 @@ void a2dp_aac_encoder_init(const tA2DP_ENCODER_INIT_PEER_PARAMS* p_peer_params,
                            A2dpCodecConfig* a2dp_codec_config,
                            a2dp_source_read_callback_t read_callback,
                            a2dp_source_enqueue_callback_t enqueue_callback) {
-  if (a2dp_aac_encoder_cb.has_aac_handle)
-    aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
-  memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
+  a2dp_aac_encoder_reset_cb();
+
+  // Reuse the encoder of the previous session: the parameters set below only
+  // reconfigure it if they changed. Its states and input buffer are reset so
+  // that no audio of that session ends up in the first frames of this one.
+  if (a2dp_aac_encoder_cb.has_aac_handle) {
+    AACENC_ERROR aac_error = aacEncoder_SetParam(
+        a2dp_aac_encoder_cb.aac_handle, AACENC_CONTROL_STATE,
+        AACENC_INIT_STATES | AACENC_RESET_INBUFFER);
+    if (aac_error != AACENC_OK) {
+      LOG_WARN("%s: Cannot reset the AAC encoder: AAC error 0x%x", __func__,
+               aac_error);
+      aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
+      a2dp_aac_encoder_cb.has_aac_handle = false;
+    }
+  }
 
   a2dp_aac_encoder_cb.stats.session_start_us =
       bluetooth::common::time_get_os_boottime_us();
@@ -306,6 +329,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
         __func__, aac_param_value, aac_error);
     return;  // TODO: Return an error?
   }
+  p_encoder_params->bit_rate = aac_param_value;
 
   // Set the encoder's parameters: PEAK Bit Rate
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
@@ -388,6 +412,8 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
     aac_param_value =
         static_cast<uint8_t>(bitrate_mode) & ~A2DP_AAC_VARIABLE_BIT_RATE_MASK;
   }
+  p_encoder_params->is_vbr =
+      (aac_param_value != A2DP_AAC_VARIABLE_BIT_RATE_DISABLED);
   LOG_INFO("%s: AACENC_BITRATEMODE: %d", __func__, aac_param_value);
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
                                   AACENC_BITRATEMODE, aac_param_value);
@@ -428,12 +454,33 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 
   // After encoder params ready, reset the feeding state and its interval.
   a2dp_aac_feeding_reset();
+
+  // The bit rate only drives the encoder in Constant Bit Rate mode
+  if (!p_encoder_params->is_vbr) {
+    int adaptive_min_bit_rate = std::max(A2DP_AAC_ADAPTIVE_MIN_BITRATE,
+                                         p_encoder_params->bit_rate / 2);
+    a2dp_bitrate_controller_init(
+        &a2dp_aac_encoder_cb.bitrate_controller,
+        std::min(adaptive_min_bit_rate, p_encoder_params->bit_rate),
+        p_encoder_params->bit_rate, A2DP_AAC_ADAPTIVE_BITRATE_STEP,
+        a2dp_aac_encoder_interval_ms);
+  } else {
+    memset(&a2dp_aac_encoder_cb.bitrate_controller, 0,
+           sizeof(a2dp_aac_encoder_cb.bitrate_controller));
+  }
 }
 
-void a2dp_aac_encoder_cleanup(void) {
-  if (a2dp_aac_encoder_cb.has_aac_handle)
-    aacEncClose(&a2dp_aac_encoder_cb.aac_handle);
+// The encoder handle is kept for the next session, and only closed when the
+// encoder is unloaded.
+void a2dp_aac_encoder_cleanup(void) { a2dp_aac_encoder_reset_cb(); }
+
+// Clears the encoder control block, except for the encoder handle.
+static void a2dp_aac_encoder_reset_cb(void) {
+  HANDLE_AACENCODER aac_handle = a2dp_aac_encoder_cb.aac_handle;
+  bool has_aac_handle = a2dp_aac_encoder_cb.has_aac_handle;
   memset(&a2dp_aac_encoder_cb, 0, sizeof(a2dp_aac_encoder_cb));
+  a2dp_aac_encoder_cb.aac_handle = aac_handle;
+  a2dp_aac_encoder_cb.has_aac_handle = has_aac_handle;
 }
 
 void a2dp_aac_feeding_reset(void) {
@@ -482,6 +529,37 @@ int a2dp_aac_get_effective_frame_size() {
   return a2dp_aac_encoder_cb.TxAaMtuSize;
 }
 
+// Applies the target bit rate of the adaptive bit rate controller on the fly.
+// The encoder is reconfigured with the new bit rate by the next aacEncEncode.
+static void a2dp_aac_apply_target_bit_rate(void) {
+  int bit_rate = a2dp_aac_encoder_cb.bitrate_controller.target_rate;
+
+  AACENC_ERROR aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
+                                               AACENC_BITRATE, bit_rate);
+  if (aac_error != AACENC_OK) {
+    LOG_ERROR(
+        "%s: Cannot set AAC parameter AACENC_BITRATE to %d: "
+        "AAC error 0x%x",
+        __func__, bit_rate, aac_error);
+    return;
+  }
+  LOG_INFO("%s: bit rate %d", __func__, bit_rate);
+}
+
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length) {
+  if (a2dp_bitrate_controller_set_transmit_queue_length(
+          &a2dp_aac_encoder_cb.bitrate_controller, transmit_queue_length)) {
+    a2dp_aac_apply_target_bit_rate();
+  }
+}
+
+void a2dp_aac_set_link_quality(const tA2DP_LINK_QUALITY* p_link_quality) {
+  if (a2dp_bitrate_controller_set_link_quality(
+          &a2dp_aac_encoder_cb.bitrate_controller, p_link_quality)) {
+    a2dp_aac_apply_target_bit_rate();
+  }
+}
+
 void a2dp_aac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -586,10 +664,7 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
   int written = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-    p_buf->offset = A2DP_AAC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
+    BT_HDR* p_buf = A2DP_AllocMediaPacket(A2DP_AAC_OFFSET);
     a2dp_aac_encoder_cb.stats.media_read_total_expected_packets++;
 
     count = 0;
@@ -725,6 +800,8 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_aac_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_aac_get_effective_frame_size());
+  a2dp_bitrate_controller_debug_dump(&a2dp_aac_encoder_cb.bitrate_controller,
+                                     fd);
   dprintf(fd,
           "  Packet counts (expected/dropped)                        : %zu / "
           "%zu\n",
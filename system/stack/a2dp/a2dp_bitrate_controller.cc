@@ -0,0 +1,184 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "a2dp_bitrate_controller"
+
+#include "a2dp_bitrate_controller.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "common/time_util.h"
+#include "osi/include/log.h"
+#include "osi/include/properties.h"
+
+#define A2DP_BITRATE_CONTROLLER_PROPERTY \
+  "persist.bluetooth.a2dp_source.adaptive_bitrate.enabled"
+
+// The TX queue is congested when it holds more packets than this
+#define A2DP_BITRATE_QUEUE_HIGH_LENGTH 3
+// The TX queue is uncongested when it holds at most this many packets
+#define A2DP_BITRATE_QUEUE_LOW_LENGTH 1
+// Consecutive congested ticks before the rate is decreased
+#define A2DP_BITRATE_DECREASE_TICKS 3
+// Time the TX queue must stay uncongested before the rate is increased
+#define A2DP_BITRATE_INCREASE_INTERVAL_MS 5000
+// The rate is not increased while the RSSI is below this value (in dBm)
+#define A2DP_BITRATE_WEAK_RSSI (-80)
+// Steps to decrease the rate by when packets are dropped on TX queue overrun
+#define A2DP_BITRATE_DROP_DECREASE_STEPS 2
+
+static bool a2dp_bitrate_controller_decrease(
+    tA2DP_BITRATE_CONTROLLER* p_controller, uint32_t steps) {
+  uint32_t delta = steps * p_controller->step;
+  uint32_t rate = p_controller->min_rate;
+  if (p_controller->target_rate > p_controller->min_rate + delta)
+    rate = p_controller->target_rate - delta;
+
+  // Restart the wait before the next increase in any case
+  p_controller->uncongested_ticks = 0;
+  if (rate == p_controller->target_rate) return false;
+
+  LOG_INFO("%s: target rate %u -> %u", __func__, p_controller->target_rate,
+           rate);
+  p_controller->target_rate = rate;
+  p_controller->total_decreases++;
+  p_controller->last_change_us = bluetooth::common::time_get_os_boottime_us();
+  return true;
+}
+
+static bool a2dp_bitrate_controller_increase(
+    tA2DP_BITRATE_CONTROLLER* p_controller) {
+  uint32_t rate = p_controller->max_rate;
+  if (p_controller->target_rate + p_controller->step < p_controller->max_rate)
+    rate = p_controller->target_rate + p_controller->step;
+
+  if (rate == p_controller->target_rate) return false;
+
+  LOG_INFO("%s: target rate %u -> %u", __func__, p_controller->target_rate,
+           rate);
+  p_controller->target_rate = rate;
+  p_controller->total_increases++;
+  p_controller->last_change_us = bluetooth::common::time_get_os_boottime_us();
+  return true;
+}
+
+void a2dp_bitrate_controller_init(tA2DP_BITRATE_CONTROLLER* p_controller,
+                                  uint32_t min_rate, uint32_t max_rate,
+                                  uint32_t step, uint64_t encoder_interval_ms) {
+  memset(p_controller, 0, sizeof(*p_controller));
+
+  p_controller->enabled =
+      osi_property_get_bool(A2DP_BITRATE_CONTROLLER_PROPERTY, false) &&
+      min_rate < max_rate && step > 0;
+  p_controller->min_rate = min_rate;
+  p_controller->max_rate = max_rate;
+  p_controller->step = step;
+  p_controller->target_rate = max_rate;
+  p_controller->increase_ticks =
+      A2DP_BITRATE_INCREASE_INTERVAL_MS /
+      (encoder_interval_ms > 0 ? encoder_interval_ms : 1);
+
+  LOG_INFO("%s: enabled=%s min_rate=%u max_rate=%u step=%u", __func__,
+           p_controller->enabled ? "true" : "false", min_rate, max_rate, step);
+}
+
+bool a2dp_bitrate_controller_set_transmit_queue_length(
+    tA2DP_BITRATE_CONTROLLER* p_controller, size_t transmit_queue_length) {
+  if (!p_controller->enabled) return false;
+
+  if (transmit_queue_length > A2DP_BITRATE_QUEUE_HIGH_LENGTH) {
+    p_controller->uncongested_ticks = 0;
+    if (++p_controller->congested_ticks < A2DP_BITRATE_DECREASE_TICKS)
+      return false;
+    p_controller->congested_ticks = 0;
+    return a2dp_bitrate_controller_decrease(p_controller, 1);
+  }
+
+  p_controller->congested_ticks = 0;
+  if (transmit_queue_length > A2DP_BITRATE_QUEUE_LOW_LENGTH) return false;
+
+  if (++p_controller->uncongested_ticks < p_controller->increase_ticks)
+    return false;
+  p_controller->uncongested_ticks = 0;
+
+  const tA2DP_LINK_QUALITY& link_quality = p_controller->link_quality;
+  if (link_quality.rssi_valid && link_quality.rssi < A2DP_BITRATE_WEAK_RSSI)
+    return false;
+  return a2dp_bitrate_controller_increase(p_controller);
+}
+
+bool a2dp_bitrate_controller_set_link_quality(
+    tA2DP_BITRATE_CONTROLLER* p_controller,
+    const tA2DP_LINK_QUALITY* p_link_quality) {
+  tA2DP_LINK_QUALITY* p_last = &p_controller->link_quality;
+  uint32_t steps = 0;
+
+  if (p_link_quality->tx_queue_dropped_messages >
+      p_last->tx_queue_dropped_messages) {
+    steps += A2DP_BITRATE_DROP_DECREASE_STEPS;
+  }
+  // The counter is only compared to the previous read of the same session
+  if (p_link_quality->failed_contact_counter_valid &&
+      p_last->failed_contact_counter_valid &&
+      p_link_quality->failed_contact_counter !=
+          p_last->failed_contact_counter) {
+    steps++;
+  }
+  *p_last = *p_link_quality;
+
+  if (!p_controller->enabled || steps == 0) return false;
+  return a2dp_bitrate_controller_decrease(p_controller, steps);
+}
+
+void a2dp_bitrate_controller_debug_dump(
+    const tA2DP_BITRATE_CONTROLLER* p_controller, int fd) {
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+  dprintf(fd,
+          "  Adaptive bit rate                                       : %s\n",
+          p_controller->enabled ? "Enabled" : "Disabled");
+  if (!p_controller->enabled) return;
+
+  dprintf(fd,
+          "  Adaptive bit rate (target/min/max)                      : %u / "
+          "%u / %u\n",
+          p_controller->target_rate, p_controller->min_rate,
+          p_controller->max_rate);
+  dprintf(fd,
+          "  Adaptive bit rate changes (decreases/increases)         : %zu / "
+          "%zu\n",
+          p_controller->total_decreases, p_controller->total_increases);
+  if (p_controller->last_change_us > 0) {
+    dprintf(fd,
+            "  Last adaptive bit rate change time ago (ms)             : "
+            "%" PRIu64 "\n",
+            (now_us - p_controller->last_change_us) / 1000);
+  }
+  if (p_controller->link_quality.rssi_valid) {
+    dprintf(fd,
+            "  Last RSSI (dBm)                                         : %d\n",
+            p_controller->link_quality.rssi);
+  }
+  if (p_controller->link_quality.failed_contact_counter_valid) {
+    dprintf(fd,
+            "  Last Failed Contact Counter                             : %u\n",
+            p_controller->link_quality.failed_contact_counter);
+  }
+}
@@ -41,13 +41,20 @@
 #endif
 #include "bta/av/bta_av_int.h"
 #include "device/include/device_iot_config.h"
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/hcidefs.h"
+#include "stack/include/l2cdefs.h"
 
 /* The Media Type offset within the codec info byte array */
 #define A2DP_MEDIA_TYPE_OFFSET 1
 
+/* The TX latency budget (in milliseconds) of the A2DP Source codecs */
+#define A2DP_TX_LATENCY_BUDGET_PROPERTY \
+  "persist.bluetooth.a2dp_source.tx_latency_budget_ms"
+
 // Initializes the codec config.
 // |codec_config| is the codec config to initialize.
 // |codec_index| and |codec_priority| are the codec type and priority to use
@@ -66,9 +73,16 @@ A2dpCodecConfig::A2dpCodecConfig(btav_a2dp_codec_index_t codec_index,
                                  btav_a2dp_codec_priority_t codec_priority)
     : codec_index_(codec_index),
       name_(name),
-      default_codec_priority_(codec_priority) {
+      default_codec_priority_(codec_priority),
+      tx_latency_budget_ms_(0) {
   setCodecPriority(codec_priority);
 
+  static osi_cached_property_t<int32_t> tx_latency_budget_property = {
+      A2DP_TX_LATENCY_BUDGET_PROPERTY, 0};
+  int32_t tx_latency_budget_ms =
+      osi_property_get_cached(&tx_latency_budget_property);
+  if (tx_latency_budget_ms > 0) tx_latency_budget_ms_ = tx_latency_budget_ms;
+
   init_btav_a2dp_codec_config(&codec_config_, codec_index_, codecPriority());
   init_btav_a2dp_codec_config(&codec_capability_, codec_index_,
                               codecPriority());
@@ -524,6 +538,11 @@ void A2dpCodecConfig::debug_codec_dump(int fd) {
 
   result = codecConfig2Str(getCodecLocalCapability());
   dprintf(fd, "  Local capability: %s\n", result.c_str());
+
+  if (tx_latency_budget_ms_ > 0) {
+    dprintf(fd, "  TX latency budget (ms): %" PRIu64 "\n",
+            tx_latency_budget_ms_);
+  }
 }
 
 int A2DP_IotGetPeerSinkCodecType(const uint8_t* p_codec_info) {
@@ -1381,6 +1400,21 @@ bool A2DP_BuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
   return false;
 }
 
+// AVDTP, L2CAP and HCI prepend their headers in place by moving the offset
+// back, which only works if the media offset leaves room for all of them.
+static_assert(AVDT_MEDIA_OFFSET >= AVDT_MEDIA_HDR_SIZE + L2CAP_PKT_OVERHEAD +
+                                       HCI_DATA_PREAMBLE_SIZE,
+              "AVDT_MEDIA_OFFSET is too small for the lower layer headers");
+
+BT_HDR* A2DP_AllocMediaPacket(uint16_t offset) {
+  CHECK(offset < BT_DEFAULT_BUFFER_SIZE - sizeof(BT_HDR));
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+  p_buf->offset = offset;
+  p_buf->len = 0;
+  p_buf->layer_specific = 0;
+  return p_buf;
+}
+
 const tA2DP_ENCODER_INTERFACE* A2DP_GetEncoderInterface(
     const uint8_t* p_codec_info) {
   tA2DP_CODEC_TYPE codec_type = A2DP_GetCodecType(p_codec_info);
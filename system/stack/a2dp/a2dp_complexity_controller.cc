@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "a2dp_complexity_controller"
+
+#include "a2dp_complexity_controller.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "common/time_util.h"
+#include "osi/include/log.h"
+#include "osi/include/properties.h"
+
+#define A2DP_COMPLEXITY_CONTROLLER_PROPERTY \
+  "persist.bluetooth.a2dp_source.adaptive_complexity.enabled"
+
+// Share of the frame duration a frame may take to encode. The rest is left to
+// the other frames of the tick, the audio HAL and the rest of the stack.
+#define A2DP_COMPLEXITY_BUDGET_PERCENT 25
+// Weight of the last frame in the moving average of the encode time (1/N)
+#define A2DP_COMPLEXITY_AVERAGE_WEIGHT 8
+// Consecutive frames with an average over the budget before a decrease
+#define A2DP_COMPLEXITY_DECREASE_FRAMES 4
+// Time the average must stay under half the budget before an increase
+#define A2DP_COMPLEXITY_INCREASE_INTERVAL_MS 5000
+// Highest multiplier of the increase interval after repeated decreases
+#define A2DP_COMPLEXITY_MAX_INCREASE_BACKOFF 8
+
+static void a2dp_complexity_controller_set(
+    tA2DP_COMPLEXITY_CONTROLLER* p_controller, uint32_t complexity) {
+  LOG_INFO("%s: complexity %u -> %u (average encode time %u us)", __func__,
+           p_controller->complexity, complexity,
+           p_controller->average_encode_us);
+  p_controller->complexity = complexity;
+  p_controller->last_change_us = bluetooth::common::time_get_os_boottime_us();
+  // Measure the new complexity on its own
+  p_controller->has_average = false;
+  p_controller->over_budget_frames = 0;
+  p_controller->under_budget_frames = 0;
+}
+
+void a2dp_complexity_controller_init(tA2DP_COMPLEXITY_CONTROLLER* p_controller,
+                                     uint32_t min_complexity,
+                                     uint32_t max_complexity,
+                                     uint32_t frame_duration_us) {
+  memset(p_controller, 0, sizeof(*p_controller));
+
+  p_controller->enabled =
+      osi_property_get_bool(A2DP_COMPLEXITY_CONTROLLER_PROPERTY, true) &&
+      min_complexity < max_complexity && frame_duration_us > 0;
+  p_controller->min_complexity = min_complexity;
+  p_controller->max_complexity = max_complexity;
+  p_controller->complexity = max_complexity;
+  p_controller->budget_us =
+      frame_duration_us * A2DP_COMPLEXITY_BUDGET_PERCENT / 100;
+  p_controller->increase_frames =
+      A2DP_COMPLEXITY_INCREASE_INTERVAL_MS * 1000 /
+      (frame_duration_us > 0 ? frame_duration_us : 1);
+  p_controller->increase_backoff = 1;
+
+  LOG_INFO("%s: enabled=%s min_complexity=%u max_complexity=%u budget_us=%u",
+           __func__, p_controller->enabled ? "true" : "false", min_complexity,
+           max_complexity, p_controller->budget_us);
+}
+
+bool a2dp_complexity_controller_on_frame_encoded(
+    tA2DP_COMPLEXITY_CONTROLLER* p_controller, uint32_t encode_time_us) {
+  p_controller->total_frames++;
+  if (encode_time_us > p_controller->max_encode_us)
+    p_controller->max_encode_us = encode_time_us;
+
+  if (!p_controller->has_average) {
+    p_controller->average_encode_us = encode_time_us;
+    p_controller->has_average = true;
+  } else {
+    int64_t delta = (int64_t)encode_time_us - p_controller->average_encode_us;
+    p_controller->average_encode_us += delta / A2DP_COMPLEXITY_AVERAGE_WEIGHT;
+  }
+
+  if (!p_controller->enabled) return false;
+
+  if (p_controller->average_encode_us > p_controller->budget_us) {
+    p_controller->under_budget_frames = 0;
+    if (++p_controller->over_budget_frames < A2DP_COMPLEXITY_DECREASE_FRAMES)
+      return false;
+    p_controller->over_budget_frames = 0;
+    if (p_controller->complexity == p_controller->min_complexity) return false;
+
+    // The complexity just left was too slow, try it again less eagerly
+    if (p_controller->increase_backoff < A2DP_COMPLEXITY_MAX_INCREASE_BACKOFF)
+      p_controller->increase_backoff *= 2;
+    a2dp_complexity_controller_set(p_controller, p_controller->complexity - 1);
+    p_controller->total_decreases++;
+    return true;
+  }
+
+  p_controller->over_budget_frames = 0;
+  if (p_controller->average_encode_us * 2 > p_controller->budget_us) {
+    p_controller->under_budget_frames = 0;
+    return false;
+  }
+  if (++p_controller->under_budget_frames <
+      p_controller->increase_frames * p_controller->increase_backoff)
+    return false;
+  p_controller->under_budget_frames = 0;
+  if (p_controller->complexity == p_controller->max_complexity) return false;
+
+  a2dp_complexity_controller_set(p_controller, p_controller->complexity + 1);
+  p_controller->total_increases++;
+  return true;
+}
+
+void a2dp_complexity_controller_debug_dump(
+    const tA2DP_COMPLEXITY_CONTROLLER* p_controller, int fd) {
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+  dprintf(fd,
+          "  Adaptive complexity                                     : %s\n",
+          p_controller->enabled ? "Enabled" : "Disabled");
+  dprintf(fd,
+          "  Encode time per frame (average/max/budget) (us)         : %u / "
+          "%u / %u\n",
+          p_controller->average_encode_us, p_controller->max_encode_us,
+          p_controller->budget_us);
+  if (!p_controller->enabled) return;
+
+  dprintf(fd,
+          "  Adaptive complexity (current/min/max)                   : %u / "
+          "%u / %u\n",
+          p_controller->complexity, p_controller->min_complexity,
+          p_controller->max_complexity);
+  dprintf(fd,
+          "  Adaptive complexity changes (decreases/increases)       : %zu / "
+          "%zu\n",
+          p_controller->total_decreases, p_controller->total_increases);
+  if (p_controller->last_change_us > 0) {
+    dprintf(fd,
+            "  Last adaptive complexity change time ago (ms)           : "
+            "%" PRIu64 "\n",
+            (now_us - p_controller->last_change_us) / 1000);
+  }
+}
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_bitrate_controller.h"
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
@@ -53,6 +54,9 @@
 /* Define the bitrate step when trying to match bitpool value */
 #define A2DP_SBC_BITRATE_STEP 5
 
+/* Define the bitpool step of the adaptive bit rate */
+#define A2DP_SBC_ADAPTIVE_BITPOOL_STEP 2
+
 /* Readability constants */
 #define A2DP_SBC_FRAME_HEADER_SIZE_BYTES 4  // A2DP Spec v1.3, 12.4, Table 12.12
 #define A2DP_SBC_SCALE_FACTOR_BITS 4        // A2DP Spec v1.3, 12.4, Table 12.13
@@ -102,6 +106,7 @@ typedef struct {
   tA2DP_FEEDING_PARAMS feeding_params;
   tA2DP_SBC_FEEDING_STATE feeding_state;
   int16_t pcmBuffer[SBC_MAX_PCM_BUFFER_SIZE];
+  tA2DP_BITRATE_CONTROLLER bitrate_controller; /* Adaptive SBC bitpool */
 
   a2dp_sbc_encoder_stats_t stats;
 } tA2DP_SBC_ENCODER_CB;
@@ -122,6 +127,7 @@ static uint16_t adjust_effective_mtu(
 static uint8_t calculate_max_frames_per_packet(void);
 static uint16_t a2dp_sbc_source_rate(bool is_peer_edr);
 static uint32_t a2dp_sbc_frame_length(void);
+static void a2dp_sbc_apply_target_bitpool(void);
 
 bool A2DP_LoadEncoderSbc(void) {
   // Nothing to do - the library is statically linked
@@ -337,6 +343,15 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   /* Reset the SBC encoder */
   SBC_Encoder_Init(&a2dp_sbc_encoder_cb.sbc_encoder_params);
   a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+
+  /* The adaptive bitpool goes down to half of the bitpool computed above */
+  int adaptive_min_bitpool = p_encoder_params->s16BitPool / 2;
+  if (adaptive_min_bitpool < min_bitpool) adaptive_min_bitpool = min_bitpool;
+  a2dp_bitrate_controller_init(&a2dp_sbc_encoder_cb.bitrate_controller,
+                               adaptive_min_bitpool,
+                               p_encoder_params->s16BitPool,
+                               A2DP_SBC_ADAPTIVE_BITPOOL_STEP,
+                               A2DP_SBC_ENCODER_INTERVAL_MS);
 }
 
 void a2dp_sbc_encoder_cleanup(void) {
@@ -497,12 +512,9 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
   uint8_t last_frame_len = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(A2DP_SBC_BUFFER_SIZE);
+    BT_HDR* p_buf = A2DP_AllocMediaPacket(A2DP_SBC_OFFSET);
     uint32_t bytes_read = 0;
 
-    p_buf->offset = A2DP_SBC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
     a2dp_sbc_encoder_cb.stats.media_read_total_expected_packets++;
 
     do {
@@ -868,6 +880,33 @@ static uint32_t a2dp_sbc_frame_length(void) {
   return frame_len;
 }
 
+// Applies the target bitpool of the adaptive bit rate controller on the fly.
+// The bitpool is read by the SBC encoder for each frame, only the number of
+// frames per packet depends on it.
+static void a2dp_sbc_apply_target_bitpool(void) {
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+
+  p_encoder_params->s16BitPool =
+      a2dp_sbc_encoder_cb.bitrate_controller.target_rate;
+  a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+  LOG_INFO("%s: bit pool %d, %d frames per packet", __func__,
+           p_encoder_params->s16BitPool, a2dp_sbc_encoder_cb.tx_sbc_frames);
+}
+
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  if (a2dp_bitrate_controller_set_transmit_queue_length(
+          &a2dp_sbc_encoder_cb.bitrate_controller, transmit_queue_length)) {
+    a2dp_sbc_apply_target_bitpool();
+  }
+}
+
+void a2dp_sbc_set_link_quality(const tA2DP_LINK_QUALITY* p_link_quality) {
+  if (a2dp_bitrate_controller_set_link_quality(
+          &a2dp_sbc_encoder_cb.bitrate_controller, p_link_quality)) {
+    a2dp_sbc_apply_target_bitpool();
+  }
+}
+
 uint32_t a2dp_sbc_get_bitrate() {
   SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
   LOG_INFO("%s: bit rate %d ", __func__, p_encoder_params->u16BitRate);
@@ -899,6 +938,8 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_sbc_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_sbc_get_effective_frame_size());
+  a2dp_bitrate_controller_debug_dump(&a2dp_sbc_encoder_cb.bitrate_controller,
+                                     fd);
   dprintf(fd,
           "  Packet counts (expected/dropped)                        : %zu / "
           "%zu\n",
@@ -310,10 +310,7 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
   tAPTX_FRAMING_PARAMS* framing_params = &a2dp_aptx_encoder_cb.framing_params;
 
   // Prepare the packet to send
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-  p_buf->offset = A2DP_APTX_OFFSET;
-  p_buf->len = 0;
-  p_buf->layer_specific = 0;
+  BT_HDR* p_buf = A2DP_AllocMediaPacket(A2DP_APTX_OFFSET);
 
   uint8_t* encoded_ptr = (uint8_t*)(p_buf + 1);
   encoded_ptr += p_buf->offset;
@@ -131,6 +131,10 @@ bool A2DP_VendorLoadEncoderLdac(void) {
 void A2DP_VendorUnloadEncoderLdac(void) {
   // Cleanup any LDAC-related state
   a2dp_vendor_ldac_encoder_cleanup();
+  if (a2dp_ldac_encoder_cb.has_ldac_handle) {
+    ldacBT_free_handle(a2dp_ldac_encoder_cb.ldac_handle);
+  }
+  memset(&a2dp_ldac_encoder_cb, 0, sizeof(a2dp_ldac_encoder_cb));
 }
 
 void a2dp_vendor_ldac_encoder_init(
@@ -326,14 +330,21 @@ static void a2dp_vendor_ldac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   }
 }
 
+// The encoder handle is only closed, so that the next session initializes it
+// again instead of allocating a new one. It is freed when the encoder is
+// unloaded.
 void a2dp_vendor_ldac_encoder_cleanup(void) {
   if (a2dp_ldac_encoder_cb.has_ldac_abr_handle) {
     ldac_ABR_free_handle(a2dp_ldac_encoder_cb.ldac_abr_handle);
   }
-  if (a2dp_ldac_encoder_cb.has_ldac_handle) {
-    ldacBT_free_handle(a2dp_ldac_encoder_cb.ldac_handle);
+  HANDLE_LDAC_BT ldac_handle = a2dp_ldac_encoder_cb.ldac_handle;
+  bool has_ldac_handle = a2dp_ldac_encoder_cb.has_ldac_handle;
+  if (has_ldac_handle) {
+    ldacBT_close_handle(ldac_handle);
   }
   memset(&a2dp_ldac_encoder_cb, 0, sizeof(a2dp_ldac_encoder_cb));
+  a2dp_ldac_encoder_cb.ldac_handle = ldac_handle;
+  a2dp_ldac_encoder_cb.has_ldac_handle = has_ldac_handle;
 }
 
 void a2dp_vendor_ldac_feeding_reset(void) {
@@ -462,10 +473,7 @@ static void a2dp_ldac_encode_frames(uint8_t nb_frame) {
 
   uint32_t bytes_read = 0;
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-    p_buf->offset = A2DP_LDAC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
+    BT_HDR* p_buf = A2DP_AllocMediaPacket(A2DP_LDAC_OFFSET);
     a2dp_ldac_encoder_cb.stats.media_read_total_expected_packets++;
 
     count = 0;
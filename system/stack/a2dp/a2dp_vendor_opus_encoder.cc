@@ -24,6 +24,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "a2dp_bitrate_controller.h"
+#include "a2dp_complexity_controller.h"
 #include "a2dp_vendor.h"
 #include "a2dp_vendor_opus.h"
 #include "common/time_util.h"
@@ -32,9 +36,13 @@
 #include "osi/include/osi.h"
 #include "stack/include/bt_hdr.h"
 
+// Lowest bit rate and bit rate step of the adaptive bit rate
+#define A2DP_OPUS_ADAPTIVE_MIN_BITRATE 96000  // 96 kbps
+#define A2DP_OPUS_ADAPTIVE_BITRATE_STEP 32000  // 32 kbps
+
 typedef struct {
   uint32_t sample_rate;
-  uint16_t bitrate;
+  uint32_t bitrate;
   uint16_t framesize;
   uint8_t channel_mode;
   uint8_t bits_per_sample;
@@ -79,6 +87,8 @@ typedef struct {
   tA2DP_FEEDING_PARAMS feeding_params;
   tA2DP_OPUS_ENCODER_PARAMS opus_encoder_params;
   tA2DP_OPUS_FEEDING_STATE opus_feeding_state;
+  tA2DP_BITRATE_CONTROLLER bitrate_controller;        // Adaptive Opus bit rate
+  tA2DP_COMPLEXITY_CONTROLLER complexity_controller;  // Adaptive complexity
 
   a2dp_opus_encoder_stats_t stats;
 } tA2DP_OPUS_ENCODER_CB;
@@ -95,6 +105,7 @@ static void a2dp_opus_get_num_frame_iteration(uint8_t* num_of_iterations,
                                               uint64_t timestamp_us);
 static void a2dp_opus_encode_frames(uint8_t nb_frame);
 static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read);
+static void a2dp_opus_apply_complexity(void);
 
 void a2dp_vendor_opus_encoder_cleanup(void) {
   if (a2dp_opus_encoder_cb.has_opus_handle) {
@@ -286,6 +297,22 @@ static bool a2dp_vendor_opus_encoder_update(uint16_t peer_mtu,
   else if (p_encoder_params->pcm_wlength == 4)
     p_encoder_params->pcm_fmt = 32;
 
+  uint32_t adaptive_min_bitrate = std::max<uint32_t>(
+      A2DP_OPUS_ADAPTIVE_MIN_BITRATE, p_encoder_params->bitrate / 2);
+  a2dp_bitrate_controller_init(
+      &a2dp_opus_encoder_cb.bitrate_controller,
+      std::min(adaptive_min_bitrate, p_encoder_params->bitrate),
+      p_encoder_params->bitrate, A2DP_OPUS_ADAPTIVE_BITRATE_STEP,
+      a2dp_vendor_opus_get_encoder_interval_ms());
+
+  // The quality mode index is the highest complexity, lowered on the fly when
+  // encoding at it does not keep up with the media ticks
+  a2dp_complexity_controller_init(
+      &a2dp_opus_encoder_cb.complexity_controller, 0,
+      p_encoder_params->quality_mode_index,
+      (uint64_t)p_encoder_params->framesize * 1000000 /
+          p_encoder_params->sample_rate);
+
   return true;
 }
 
@@ -380,10 +407,7 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
 
   uint32_t bytes_read = 0;
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-    p_buf->offset = A2DP_OPUS_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
+    BT_HDR* p_buf = A2DP_AllocMediaPacket(A2DP_OPUS_OFFSET);
     a2dp_opus_encoder_cb.stats.media_read_total_expected_packets++;
 
     do {
@@ -402,10 +426,18 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
           return;
         }
 
+        uint64_t encode_start_us =
+            bluetooth::common::time_get_os_boottime_us();
         written =
             opus_encode(a2dp_opus_encoder_cb.opus_handle,
                         (const opus_int16*)&read_buffer[0], opus_frame_size,
                         packet, (BT_DEFAULT_BUFFER_SIZE - p_buf->offset));
+        if (a2dp_complexity_controller_on_frame_encoded(
+                &a2dp_opus_encoder_cb.complexity_controller,
+                bluetooth::common::time_get_os_boottime_us() -
+                    encode_start_us)) {
+          a2dp_opus_apply_complexity();
+        }
 
         if (written <= 0) {
           LOG_ERROR("OPUS encoding error");
@@ -478,10 +510,50 @@ static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   return true;
 }
 
+// Applies the target bit rate of the adaptive bit rate controller on the fly.
+static void a2dp_opus_apply_target_bitrate(void) {
+  tA2DP_OPUS_ENCODER_PARAMS* p_encoder_params =
+      &a2dp_opus_encoder_cb.opus_encoder_params;
+  uint32_t bitrate = a2dp_opus_encoder_cb.bitrate_controller.target_rate;
+
+  if (!a2dp_opus_encoder_cb.has_opus_handle) return;
+  if (opus_encoder_ctl(a2dp_opus_encoder_cb.opus_handle,
+                       OPUS_SET_BITRATE(bitrate)) != OPUS_OK) {
+    LOG_ERROR("failed to set encoder bitrate to %u", bitrate);
+    return;
+  }
+  p_encoder_params->bitrate = bitrate;
+  LOG_INFO("bitrate %u", bitrate);
+}
+
+// Applies the complexity of the adaptive complexity controller on the fly.
+static void a2dp_opus_apply_complexity(void) {
+  uint32_t complexity = a2dp_opus_encoder_cb.complexity_controller.complexity;
+
+  if (!a2dp_opus_encoder_cb.has_opus_handle) return;
+  if (opus_encoder_ctl(a2dp_opus_encoder_cb.opus_handle,
+                       OPUS_SET_COMPLEXITY(complexity)) != OPUS_OK) {
+    LOG_ERROR("failed to set encoder complexity to %u", complexity);
+    return;
+  }
+  LOG_INFO("complexity %u", complexity);
+}
+
 void a2dp_vendor_opus_set_transmit_queue_length(size_t transmit_queue_length) {
   a2dp_opus_encoder_cb.TxQueueLength = transmit_queue_length;
 
-  return;
+  if (a2dp_bitrate_controller_set_transmit_queue_length(
+          &a2dp_opus_encoder_cb.bitrate_controller, transmit_queue_length)) {
+    a2dp_opus_apply_target_bitrate();
+  }
+}
+
+void a2dp_vendor_opus_set_link_quality(
+    const tA2DP_LINK_QUALITY* p_link_quality) {
+  if (a2dp_bitrate_controller_set_link_quality(
+          &a2dp_opus_encoder_cb.bitrate_controller, p_link_quality)) {
+    a2dp_opus_apply_target_bitrate();
+  }
 }
 
 uint64_t A2dpCodecConfigOpusSource::encoderIntervalMs() const {
@@ -518,12 +590,17 @@ void A2dpCodecConfigOpusSource::debug_codec_dump(int fd) {
           stats->media_read_total_actual_read_bytes);
 
   dprintf(fd,
-          "  OPUS transmission bitrate (Kbps)                        : %d\n",
-          p_encoder_params->bitrate);
+          "  OPUS transmission bitrate (Kbps)                        : %u\n",
+          p_encoder_params->bitrate / 1000);
 
   dprintf(fd,
           "  OPUS saved transmit queue length                        : %zu\n",
           a2dp_opus_encoder_cb.TxQueueLength);
 
+  a2dp_bitrate_controller_debug_dump(&a2dp_opus_encoder_cb.bitrate_controller,
+                                     fd);
+  a2dp_complexity_controller_debug_dump(
+      &a2dp_opus_encoder_cb.complexity_controller, fd);
+
   return;
 }
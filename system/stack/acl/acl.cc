@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "main/shim/dumpsys.h"
@@ -44,4 +45,28 @@ void tACL_CONN::Reset() {
   rs_disc_pending = BTM_SEC_RS_NOT_PENDING;
   switch_role_state_ = BTM_ACL_SWKEY_STATE_IDLE;
   sca = 0;
+  traffic_stats = {};
+}
+
+void tACL_CONN::RecordTraffic(uint64_t now_ms) {
+  tACL_TRAFFIC_STATS& stats = traffic_stats;
+  if (stats.last_packet_ms != 0 &&
+      now_ms >= stats.last_packet_ms + ACL_TRAFFIC_MIN_IDLE_GAP_MS) {
+    uint32_t gap_ms = static_cast<uint32_t>(
+        std::min<uint64_t>(now_ms - stats.last_packet_ms,
+                           ACL_TRAFFIC_MAX_IDLE_GAP_MS));
+    if (stats.num_idle_gaps == 0) {
+      stats.idle_gap_ms = gap_ms;
+      stats.idle_gap_var_ms = gap_ms / 2;
+    } else {
+      uint32_t error_ms = gap_ms > stats.idle_gap_ms
+                              ? gap_ms - stats.idle_gap_ms
+                              : stats.idle_gap_ms - gap_ms;
+      /* var = 3/4 var + 1/4 |error|, then mean = 7/8 mean + 1/8 gap */
+      stats.idle_gap_var_ms = (3 * stats.idle_gap_var_ms + error_ms) / 4;
+      stats.idle_gap_ms = (7 * stats.idle_gap_ms + gap_ms) / 8;
+    }
+    stats.num_idle_gaps++;
+  }
+  stats.last_packet_ms = now_ms;
 }
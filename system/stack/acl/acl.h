@@ -310,6 +310,9 @@ struct tACL_CONN {
  public:
   uint8_t sca; /* Sleep clock accuracy */
 
+  tACL_TRAFFIC_STATS traffic_stats;
+  void RecordTraffic(uint64_t now_ms);
+
   void Reset();
 
   struct tPolicy {
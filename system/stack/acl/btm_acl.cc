@@ -41,6 +41,7 @@
 #include "bta/sys/bta_sys.h"
 #include "btif/include/btif_acl.h"
 #include "common/metrics.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/device_iot_config.h"
 #include "device/include/interop.h"
@@ -2418,6 +2419,16 @@ bool acl_peer_supports_sniff_subrating(const RawAddress& remote_bda) {
   return HCI_SNIFF_SUB_RATE_SUPPORTED(p_acl->peer_lmp_feature_pages[0]);
 }
 
+bool acl_get_traffic_stats(const RawAddress& remote_bda,
+                           tACL_TRAFFIC_STATS* p_stats) {
+  tACL_CONN* p_acl = internal_.btm_bda_to_acl(remote_bda, BT_TRANSPORT_BR_EDR);
+  if (p_acl == nullptr) {
+    return false;
+  }
+  *p_stats = p_acl->traffic_stats;
+  return true;
+}
+
 bool acl_peer_supports_ble_connection_subrating(const RawAddress& remote_bda) {
   tACL_CONN* p_acl = internal_.btm_bda_to_acl(remote_bda, BT_TRANSPORT_LE);
   if (p_acl == nullptr) {
@@ -2830,6 +2841,7 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
       osi_free(p_buf);
       return;
     }
+    p_acl->RecordTraffic(bluetooth::common::time_get_os_boottime_ms());
     return bluetooth::shim::ACL_WriteData(p_acl->hci_handle, p_buf);
 }
 
@@ -2930,6 +2942,11 @@ void acl_rcv_acl_data(BT_HDR* p_msg) {
     osi_free(p_msg);
     return;
   }
+  tACL_CONN* p_acl =
+      internal_.acl_get_connection_from_handle(acl_header.handle);
+  if (p_acl != nullptr && p_acl->is_transport_br_edr()) {
+    p_acl->RecordTraffic(bluetooth::common::time_get_os_boottime_ms());
+  }
   l2c_rcv_acl_data(p_msg);
 }
 
@@ -62,6 +62,8 @@ bool btm_ble_init_pseudo_addr(tBTM_SEC_DEV_REC* p_dev_rec,
                               const RawAddress& new_pseudo_addr);
 void gatt_notify_phy_updated(tGATT_STATUS status, uint16_t handle,
                              uint8_t tx_phy, uint8_t rx_phy);
+static void btm_ble_ltk_reply(tBTM_SEC_DEV_REC* p_rec, bool use_stk,
+                              const Octet16& stk);
 
 #ifndef PROPERTY_BLE_PRIVACY_ENABLED
 #define PROPERTY_BLE_PRIVACY_ENABLED "bluetooth.core.gap.le.privacy.enabled"
@@ -1435,7 +1437,9 @@ void btm_ble_ltk_request(uint16_t handle, uint8_t rand[8], uint16_t ediv) {
 
   if (p_dev_rec != NULL) {
     if (!smp_proc_ltk_request(p_dev_rec->bd_addr)) {
-      btm_ble_ltk_request_reply(p_dev_rec->bd_addr, false, Octet16{0});
+      /* reconnection of a bonded device, answered from the record found by
+       * the handle without looking it up again */
+      btm_ble_ltk_reply(p_dev_rec, false, Octet16{0});
     }
   }
 }
@@ -1550,7 +1554,6 @@ void btm_ble_link_encrypted(const RawAddress& bd_addr, uint8_t encr_enable) {
 void btm_ble_ltk_request_reply(const RawAddress& bda, bool use_stk,
                                const Octet16& stk) {
   tBTM_SEC_DEV_REC* p_rec = btm_find_dev(bda);
-  tBTM_CB* p_cb = &btm_cb;
 
   if (p_rec == NULL) {
     BTM_TRACE_ERROR("btm_ble_ltk_request_reply received for unknown device");
@@ -1558,6 +1561,15 @@ void btm_ble_ltk_request_reply(const RawAddress& bda, bool use_stk,
   }
 
   BTM_TRACE_DEBUG("btm_ble_ltk_request_reply");
+  btm_ble_ltk_reply(p_rec, use_stk, stk);
+}
+
+/** This function sends the LTK request reply for the device of |p_rec|, with
+ * |stk| if |use_stk| is set, or with the LTK of the device otherwise. */
+static void btm_ble_ltk_reply(tBTM_SEC_DEV_REC* p_rec, bool use_stk,
+                              const Octet16& stk) {
+  tBTM_CB* p_cb = &btm_cb;
+  const RawAddress bda = p_rec->bd_addr;
   p_cb->enc_handle = p_rec->ble_hci_handle;
   p_cb->key_size = p_rec->ble.keys.key_size;
 
@@ -1869,8 +1881,9 @@ tBTM_STATUS btm_proc_smp_cback(tSMP_EVT event, const RawAddress& bd_addr,
 
           if (res == BTM_SUCCESS) {
             p_dev_rec->sec_state = BTM_SEC_STATE_IDLE;
-            /* add all bonded device into resolving list if IRK is available*/
-            btm_ble_resolving_list_load_dev(*p_dev_rec);
+            /* add all bonded device into resolving list if IRK is available,
+             * a device just bonded is likely to reconnect */
+            btm_ble_resolving_list_promote_dev(*p_dev_rec);
           }
 
           btm_sec_dev_rec_cback_event(p_dev_rec, res, true);
@@ -25,12 +25,17 @@
 #include <base/functional/bind.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "btm_ble_int.h"
+#include "common/lru_cache.h"
 #include "device/include/controller.h"
 #include "gap_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
 #include "stack/btm/btm_dev.h"
+#include "stack/crypto_toolbox/aes.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_octets.h"
@@ -154,25 +159,63 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
   return false;
 }
 
-/** This function match the random address to the appointed device record,
- * starting from calculating IRK. If the record index exceeds the maximum record
- * number, matching failed and send a callback. */
-static bool btm_ble_match_random_bda(void* data, void* context) {
-  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
-  RawAddress* random_bda = static_cast<RawAddress*>(context);
+namespace {
 
-  if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
-      !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
-    // Match fails preconditions
-    return true;
+/* IRK of a bonded LE device with its precomputed AES key schedule */
+typedef struct {
+  tBTM_SEC_DEV_REC* p_dev_rec;
+  Octet16 irk;
+  aes_context ctx;
+} tBTM_BLE_RPA_IRK;
 
-  if (rpa_matches_irk(*random_bda, p_dev_rec->ble.keys.irk)) {
-    // Matched
-    return false;
+/* Number of recent RPA resolution results kept */
+constexpr size_t kRpaCacheSize = 64;
+
+/* IRKs of the security records, in the order of |btm_cb.sec_dev_rec| */
+std::vector<tBTM_BLE_RPA_IRK> rpa_irks;
+
+/* Recent RPA resolution results, nullptr for the RPAs matching no IRK */
+bluetooth::common::LruCache<RawAddress, tBTM_SEC_DEV_REC*> rpa_cache(
+    kRpaCacheSize);
+
+}  // namespace
+
+/** This function brings |rpa_irks| in sync with the security records. The key
+ * schedule is only expanded for the new or changed IRKs, and the cached
+ * results are dropped if any IRK was added, changed or removed. */
+static void btm_ble_sync_rpa_irks(void) {
+  bool changed = false;
+  size_t count = 0;
+
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
+        !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
+      continue;
+
+    if (count == rpa_irks.size()) rpa_irks.emplace_back();
+    tBTM_BLE_RPA_IRK& entry = rpa_irks[count++];
+    if (entry.p_dev_rec == p_dev_rec && entry.irk == p_dev_rec->ble.keys.irk)
+      continue;
+
+    /* the key is reversed as in crypto_toolbox::aes_128() */
+    Octet16 key_reversed;
+    std::reverse_copy(p_dev_rec->ble.keys.irk.begin(),
+                      p_dev_rec->ble.keys.irk.end(), key_reversed.begin());
+    entry.p_dev_rec = p_dev_rec;
+    entry.irk = p_dev_rec->ble.keys.irk;
+    aes_set_key(key_reversed.data(), key_reversed.size(), &entry.ctx);
+    changed = true;
   }
 
-  // This item not a match, continue iteration
-  return true;
+  if (count != rpa_irks.size()) {
+    rpa_irks.resize(count);
+    changed = true;
+  }
+  if (changed) rpa_cache.clear();
 }
 
 /** This function is called to resolve a random address.
@@ -181,10 +224,34 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
-  list_node_t* n = list_foreach(btm_cb.sec_dev_rec, btm_ble_match_random_bda,
-                                (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+
+  btm_ble_sync_rpa_irks();
+  auto cached = rpa_cache.find(random_bda);
+  if (cached != rpa_cache.end()) return cached->second;
+
+  /* prand is the 3 MSB of the address, padded and reversed as in
+   * crypto_toolbox::aes_128(), the same block is encrypted with every IRK */
+  uint8_t prand[N_BLOCK] = {0};
+  prand[N_BLOCK - 1] = random_bda.address[2];
+  prand[N_BLOCK - 2] = random_bda.address[1];
+  prand[N_BLOCK - 3] = random_bda.address[0];
+
+  tBTM_SEC_DEV_REC* p_match = nullptr;
+  for (const tBTM_BLE_RPA_IRK& entry : rpa_irks) {
+    uint8_t x[N_BLOCK];
+    aes_encrypt(prand, x, &entry.ctx);
+
+    /* the hash is the 3 LSB of the address */
+    if (x[N_BLOCK - 1] == random_bda.address[5] &&
+        x[N_BLOCK - 2] == random_bda.address[4] &&
+        x[N_BLOCK - 3] == random_bda.address[3]) {
+      p_match = entry.p_dev_rec;
+      break;
+    }
+  }
+
+  rpa_cache.insert_or_assign(random_bda, p_match);
+  return p_match;
 }
 
 /*******************************************************************************
@@ -31,6 +31,7 @@
 #include "device/include/controller.h"
 #include "main/shim/acl_api.h"
 #include "main/shim/shim.h"
+#include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/btm/security_device_record.h"
@@ -196,8 +197,18 @@ bool BTM_AcceptlistAdd(const RawAddress& address, bool is_direct) {
 
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(address);
 
-  return bluetooth::shim::ACL_AcceptLeConnectionFrom(
+  // A device about to connect gets a place in the resolving list first, so
+  // that the controller can match its RPA against the accept list entry.
+  if (p_dev_rec != nullptr && p_dev_rec->is_device_type_has_ble()) {
+    p_dev_rec->ble.in_controller_list |= BTM_ACCEPT_LIST_BIT;
+    btm_ble_resolving_list_promote_dev(*p_dev_rec);
+  }
+
+  bool added = bluetooth::shim::ACL_AcceptLeConnectionFrom(
       convert_to_address_with_type(address, p_dev_rec), is_direct);
+  if (!added && p_dev_rec != nullptr)
+    p_dev_rec->ble.in_controller_list &= ~BTM_ACCEPT_LIST_BIT;
+  return added;
 }
 
 /** Removes the device from acceptlist */
@@ -208,6 +219,8 @@ void BTM_AcceptlistRemove(const RawAddress& address) {
   }
 
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(address);
+  if (p_dev_rec != nullptr)
+    p_dev_rec->ble.in_controller_list &= ~BTM_ACCEPT_LIST_BIT;
 
   bluetooth::shim::ACL_IgnoreLeConnectionFrom(
       convert_to_address_with_type(address, p_dev_rec));
@@ -220,5 +233,13 @@ void BTM_AcceptlistClear() {
     LOG_WARN("Controller does not support Le");
     return;
   }
+
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    p_dev_rec->ble.in_controller_list &= ~BTM_ACCEPT_LIST_BIT;
+  }
   bluetooth::shim::ACL_IgnoreAllLeConnections();
 }
@@ -105,6 +105,7 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
                              tBTM_SEC_DEV_REC* p_dev_rec);
 
 void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& p_dev_rec);
+void btm_ble_resolving_list_promote_dev(tBTM_SEC_DEV_REC& p_dev_rec);
 void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec);
 void btm_ble_resolving_list_init(uint8_t max_irk_list_sz);
 
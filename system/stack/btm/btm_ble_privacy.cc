@@ -538,7 +538,63 @@ static bool is_peer_identity_key_valid(const tBTM_SEC_DEV_REC& dev_rec) {
 
 static Octet16 get_local_irk() { return btm_cb.devcb.id_keys.irk; }
 
-void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
+/*******************************************************************************
+ *  Resolving list virtualization
+ *
+ *  The controller resolving list only holds a few devices, the others are
+ *  resolved by the host. When the list is full, the devices in the accept
+ *  list take the place of the ones which are not, and a device being
+ *  promoted takes the place of the least recently used one.
+ ******************************************************************************/
+
+/* Returns true if |a| is more likely to connect than |b| */
+static bool btm_ble_resolving_list_ranks_higher(const tBTM_SEC_DEV_REC& a,
+                                                const tBTM_SEC_DEV_REC& b,
+                                                bool by_recency) {
+  bool a_accepted = a.ble.in_controller_list & BTM_ACCEPT_LIST_BIT;
+  bool b_accepted = b.ble.in_controller_list & BTM_ACCEPT_LIST_BIT;
+  if (a_accepted != b_accepted) return a_accepted;
+  return by_recency && a.timestamp > b.timestamp;
+}
+
+/* Returns true if the controller resolving list is full, and stores its
+ * lowest ranked device in |p_lowest| */
+static bool btm_ble_resolving_list_is_full(tBTM_SEC_DEV_REC** p_lowest) {
+  size_t count = 0;
+  *p_lowest = nullptr;
+
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (!(p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT))
+      continue;
+
+    count++;
+    if (*p_lowest == nullptr ||
+        btm_ble_resolving_list_ranks_higher(**p_lowest, *p_dev_rec, true))
+      *p_lowest = p_dev_rec;
+  }
+
+  return count >=
+         controller_get_interface()->get_ble_resolving_list_max_size();
+}
+
+/* Removes |p_dev_rec| from the controller resolving list */
+static void btm_ble_resolving_list_unload_dev(tBTM_SEC_DEV_REC* p_dev_rec) {
+  if ((p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT) &&
+      !btm_ble_brcm_find_resolving_pending_entry(
+          p_dev_rec->bd_addr, BTM_BLE_META_REMOVE_IRK_ENTRY)) {
+    btm_ble_update_resolving_list(p_dev_rec->bd_addr, false);
+    btm_ble_remove_resolving_list_entry(p_dev_rec);
+  } else {
+    BTM_TRACE_DEBUG("Device not in resolving list");
+  }
+}
+
+static void btm_ble_resolving_list_load(tBTM_SEC_DEV_REC& dev_rec,
+                                        bool promote) {
   if (controller_get_interface()->get_ble_resolving_list_max_size() == 0) {
     LOG_INFO("Controller does not support RPA offloading or privacy 1.2");
     return;
@@ -561,6 +617,22 @@ void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
     return;
   }
 
+  tBTM_SEC_DEV_REC* p_lowest;
+  if (btm_ble_resolving_list_is_full(&p_lowest)) {
+    if (p_lowest == nullptr ||
+        !btm_ble_resolving_list_ranks_higher(dev_rec, *p_lowest, promote)) {
+      LOG_INFO(
+          "Address Resolving list full, host resolves device:%s",
+          ADDRESS_TO_LOGGABLE_CSTR(dev_rec.ble.identity_address_with_type));
+      return;
+    }
+
+    LOG_INFO(
+        "Address Resolving list full, replacing device:%s",
+        ADDRESS_TO_LOGGABLE_CSTR(p_lowest->ble.identity_address_with_type));
+    btm_ble_resolving_list_unload_dev(p_lowest);
+  }
+
   const Octet16& peer_irk = dev_rec.ble.keys.irk;
   const Octet16& local_irk = get_local_irk();
 
@@ -580,11 +652,67 @@ void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
   dev_rec.ble.in_controller_list |= BTM_RESOLVING_LIST_BIT;
 }
 
+/* Loads the highest ranked device the host resolves, if any, into the
+ * controller resolving list in place of |p_removed| */
+static void btm_ble_resolving_list_refill(const tBTM_SEC_DEV_REC* p_removed) {
+  tBTM_SEC_DEV_REC* p_highest = nullptr;
+
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+    if (p_dev_rec == p_removed ||
+        !(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
+        !is_peer_identity_key_valid(*p_dev_rec) ||
+        (p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT))
+      continue;
+
+    if (p_highest == nullptr ||
+        btm_ble_resolving_list_ranks_higher(*p_dev_rec, *p_highest, true))
+      p_highest = p_dev_rec;
+  }
+
+  if (p_highest != nullptr) btm_ble_resolving_list_load(*p_highest, false);
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_load_dev
+ *
+ * Description      This function adds a device to the resolving list. When
+ *                  the list is full, the device only replaces a device which
+ *                  is not in the accept list, if it is itself.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
+  btm_ble_resolving_list_load(dev_rec, false);
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_ble_resolving_list_promote_dev
+ *
+ * Description      This function adds a device about to connect to the
+ *                  resolving list. When the list is full, the device replaces
+ *                  the least recently used device ranked below it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_ble_resolving_list_promote_dev(tBTM_SEC_DEV_REC& dev_rec) {
+  btm_ble_resolving_list_load(dev_rec, true);
+}
+
 /*******************************************************************************
  *
  * Function         btm_ble_resolving_list_remove_dev
  *
- * Description      This function removes the device from resolving list
+ * Description      This function removes the device from resolving list, and
+ *                  loads the highest ranked device the host resolves in its
+ *                  place
  *
  * Parameters
  *
@@ -594,14 +722,11 @@ void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& dev_rec) {
 void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec) {
   BTM_TRACE_EVENT("%s", __func__);
 
-  if ((p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT) &&
-      !btm_ble_brcm_find_resolving_pending_entry(
-          p_dev_rec->bd_addr, BTM_BLE_META_REMOVE_IRK_ENTRY)) {
-    btm_ble_update_resolving_list(p_dev_rec->bd_addr, false);
-    btm_ble_remove_resolving_list_entry(p_dev_rec);
-  } else {
-    BTM_TRACE_DEBUG("Device not in resolving list");
-  }
+  bool loaded = p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT;
+  btm_ble_resolving_list_unload_dev(p_dev_rec);
+
+  if (loaded && controller_get_interface()->supports_ble_privacy())
+    btm_ble_resolving_list_refill(p_dev_rec);
 }
 
 /*******************************************************************************
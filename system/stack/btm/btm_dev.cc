@@ -29,6 +29,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <unordered_map>
+
 #include "btm_api.h"
 #include "btm_ble_int.h"
 #include "device/include/controller.h"
@@ -50,8 +52,43 @@ namespace {
 
 constexpr char kBtmLogTag[] = "BOND";
 
+/* Bound on the keys remembered by the lookup indexes, as every resolvable
+ * private address a record was looked up by gets a key of its own */
+constexpr size_t kBtmSecDevRecMaxIndexedKeys = 4 * BTM_SEC_MAX_DEVICE_RECORDS;
+
+/* The indexes only remember which record a lookup last found. Since record
+ * fields are updated all over the stack, an indexed record is checked against
+ * the key again before it is returned, and the list is scanned as before if it
+ * no longer matches. */
+template <typename Key>
+void btm_sec_dev_rec_index_update(
+    std::unordered_map<Key, tBTM_SEC_DEV_REC*>& index, const Key& key,
+    tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!btm_cb.sec_dev_rec_indexed) return;
+
+  if (p_dev_rec == nullptr) {
+    index.erase(key);
+    return;
+  }
+  if (index.size() >= kBtmSecDevRecMaxIndexedKeys) index.clear();
+  index[key] = p_dev_rec;
+}
+
+template <typename Key>
+void btm_sec_dev_rec_index_remove(
+    std::unordered_map<Key, tBTM_SEC_DEV_REC*>& index,
+    const tBTM_SEC_DEV_REC* p_dev_rec) {
+  for (auto it = index.begin(); it != index.end();) {
+    if (it->second == p_dev_rec) {
+      it = index.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
+}  // namespace
+
 /*******************************************************************************
  *
  * Function         BTM_SecAddDevice
@@ -142,6 +179,9 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->link_key.fill(0);
   memset(&p_dev_rec->ble.keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_sec_dev_rec_index_remove(btm_cb.sec_dev_rec_by_addr, p_dev_rec);
+  btm_sec_dev_rec_index_remove(btm_cb.sec_dev_rec_by_handle, p_dev_rec);
+  btm_sec_dev_rec_index_remove(btm_cb.sec_dev_rec_with_lenc, p_dev_rec);
   list_remove(btm_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -351,10 +391,23 @@ bool is_handle_equal(void* data, void* context) {
  *
  ******************************************************************************/
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
+  // Records of disconnected devices all share the invalid handle
+  const bool indexed = handle != HCI_INVALID_HANDLE;
+  if (indexed) {
+    auto it = btm_cb.sec_dev_rec_by_handle.find(handle);
+    if (it != btm_cb.sec_dev_rec_by_handle.end() &&
+        !is_handle_equal(it->second, &handle))
+      return it->second;
+  }
+
+  tBTM_SEC_DEV_REC* p_dev_rec = NULL;
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
 
-  return NULL;
+  if (indexed)
+    btm_sec_dev_rec_index_update(btm_cb.sec_dev_rec_by_handle, handle,
+                                 p_dev_rec);
+  return p_dev_rec;
 }
 
 bool is_address_equal(void* data, void* context) {
@@ -382,11 +435,18 @@ bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  auto it = btm_cb.sec_dev_rec_by_addr.find(bd_addr);
+  if (it != btm_cb.sec_dev_rec_by_addr.end() &&
+      !is_address_equal(it->second, (void*)&bd_addr))
+    return it->second;
+
+  tBTM_SEC_DEV_REC* p_dev_rec = NULL;
   list_node_t* n =
       list_foreach(btm_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
 
-  return NULL;
+  btm_sec_dev_rec_index_update(btm_cb.sec_dev_rec_by_addr, bd_addr, p_dev_rec);
+  return p_dev_rec;
 }
 
 static bool has_lenc_and_address_is_equal(void* data, void* context) {
@@ -409,11 +469,19 @@ static bool has_lenc_and_address_is_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev_with_lenc(const RawAddress& bd_addr) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  auto it = btm_cb.sec_dev_rec_with_lenc.find(bd_addr);
+  if (it != btm_cb.sec_dev_rec_with_lenc.end() &&
+      !has_lenc_and_address_is_equal(it->second, (void*)&bd_addr))
+    return it->second;
+
+  tBTM_SEC_DEV_REC* p_dev_rec = NULL;
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, has_lenc_and_address_is_equal,
                                 (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
 
-  return NULL;
+  btm_sec_dev_rec_index_update(btm_cb.sec_dev_rec_with_lenc, bd_addr,
+                               p_dev_rec);
+  return p_dev_rec;
 }
 /*******************************************************************************
  *
@@ -33,7 +33,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "advertise_data_parser.h"
 #include "common/time_util.h"
@@ -72,8 +75,11 @@ void btm_log_history_scan_mode(uint8_t scan_mode) {
 
 // Inquiry database lock
 std::mutex inq_db_lock_;
-// Inquiry database
-tINQ_DB_ENT inq_db_[BTM_INQ_DB_SIZE];
+// Inquiry database. Entries are allocated as devices are found, up to
+// inq_db_max_size_ of them, and are then reused. They are only freed on
+// shutdown as callers keep pointers to them.
+std::vector<std::unique_ptr<tINQ_DB_ENT>> inq_db_;
+size_t inq_db_max_size_ = BTM_INQ_DB_SIZE;
 
 // Inquiry bluetooth device database lock
 std::mutex bd_db_lock_;
@@ -129,6 +135,10 @@ using bluetooth::Uuid;
 #define PROPERTY_INQ_SCAN_WINDOW "bluetooth.core.classic.inq_scan_window"
 #endif
 
+#ifndef PROPERTY_INQ_DB_SIZE
+#define PROPERTY_INQ_DB_SIZE "bluetooth.core.classic.inq_db_size"
+#endif
+
 #define BTIF_DM_DEFAULT_INQ_MAX_DURATION 10
 
 /******************************************************************************/
@@ -502,10 +512,11 @@ void BTM_CancelInquiry(void) {
   BTM_LogHistory(
       kBtmLogTag, RawAddress::kEmpty, "Classic inquiry canceled",
       base::StringPrintf(
-          "duration_s:%6.3f results:%lu std:%u rssi:%u ext:%u",
+          "duration_s:%6.3f results:%lu suppressed:%lu std:%u rssi:%u ext:%u",
           (end_time_ms - btm_cb.neighbor.classic_inquiry.start_time_ms) /
               1000.0,
           btm_cb.neighbor.classic_inquiry.results,
+          btm_cb.neighbor.classic_inquiry.suppressed,
           p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_STANDARD],
           p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_WITH_RSSI],
           p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_EXTENDED]));
@@ -624,6 +635,7 @@ tBTM_STATUS BTM_StartInquiry(tBTM_INQ_RESULTS_CB* p_results_cb,
   btm_cb.neighbor.classic_inquiry = {
       .start_time_ms = timestamper_in_milliseconds.GetTimestamp(),
       .results = 0,
+      .suppressed = 0,
   };
 
   LOG_DEBUG("Starting device discovery inq_active:0x%02x",
@@ -779,11 +791,8 @@ tBTM_INQ_INFO* BTM_InqDbRead(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbFirst(void) {
-  uint16_t xx;
-
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (const auto& p_ent : inq_db_) {
     if (p_ent->in_use) return (&p_ent->inq_info);
   }
 
@@ -803,17 +812,16 @@ tBTM_INQ_INFO* BTM_InqDbFirst(void) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbNext(tBTM_INQ_INFO* p_cur) {
-  uint16_t inx;
-
   std::lock_guard<std::mutex> lock(inq_db_lock_);
 
   if (p_cur) {
-    tINQ_DB_ENT* p_ent =
+    tINQ_DB_ENT* p_cur_ent =
         (tINQ_DB_ENT*)((uint8_t*)p_cur - offsetof(tINQ_DB_ENT, inq_info));
-    inx = (uint16_t)((p_ent - inq_db_) + 1);
+    size_t inx = 0;
+    while (inx < inq_db_.size() && inq_db_[inx].get() != p_cur_ent) inx++;
 
-    for (p_ent = &inq_db_[inx]; inx < BTM_INQ_DB_SIZE; inx++, p_ent++) {
-      if (p_ent->in_use) return (&p_ent->inq_info);
+    for (inx++; inx < inq_db_.size(); inx++) {
+      if (inq_db_[inx]->in_use) return (&inq_db_[inx]->inq_info);
     }
 
     /* If here, more entries found */
@@ -858,11 +866,9 @@ tBTM_STATUS BTM_ClearInqDb(const RawAddress* p_bda) {
  *
  ******************************************************************************/
 void btm_clear_all_pending_le_entry(void) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (const auto& p_ent : inq_db_) {
     /* mark all pending LE entry as unused if an LE only device has scan
      * response outstanding */
     if ((p_ent->in_use) &&
@@ -959,10 +965,24 @@ void btm_inq_db_init(void) {
   btm_cb.btm_inq_vars.remote_name_timer =
       alarm_new("btm_inq.remote_name_timer");
   btm_cb.btm_inq_vars.no_inc_ssp = BTM_NO_SSP_ON_INQUIRY;
+
+  int32_t max_size =
+      osi_property_get_int32(PROPERTY_INQ_DB_SIZE, BTM_INQ_DB_SIZE);
+  if (max_size < 1) {
+    LOG_WARN("Invalid inquiry database size %d, using %d", max_size,
+             BTM_INQ_DB_SIZE);
+    max_size = BTM_INQ_DB_SIZE;
+  }
+  std::lock_guard<std::mutex> lock(inq_db_lock_);
+  inq_db_max_size_ = max_size;
 }
 
 void btm_inq_db_free(void) {
   alarm_free(btm_cb.btm_inq_vars.remote_name_timer);
+
+  std::lock_guard<std::mutex> lock(inq_db_lock_);
+  inq_db_.clear();
+  inq_db_.shrink_to_fit();
 }
 
 /*******************************************************************************
@@ -1023,15 +1043,12 @@ void btm_inq_clear_ssp(void) {
  *
  ******************************************************************************/
 void btm_clr_inq_db(const RawAddress* p_bda) {
-  uint16_t xx;
-
 #if (BTM_INQ_DEBUG == TRUE)
   BTM_TRACE_DEBUG("btm_clr_inq_db: inq_active:0x%x state:%d",
                   btm_cb.btm_inq_vars.inq_active, btm_cb.btm_inq_vars.state);
 #endif
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (const auto& p_ent : inq_db_) {
     if (p_ent->in_use) {
       /* If this is the specified BD_ADDR or clearing all devices */
       if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
@@ -1123,13 +1140,11 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (const auto& p_ent : inq_db_) {
     if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
+      return (p_ent.get());
   }
 
   /* If here, not found */
@@ -1141,35 +1156,39 @@ tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
  * Function         btm_inq_db_new
  *
  * Description      This function looks through the inquiry database for an
- *                  unused entry. If no entry is free, it allocates the oldest
- *                  entry.
+ *                  unused entry. If no entry is free, it allocates a new one
+ *                  while the database is below its maximum size, otherwise it
+ *                  reuses the oldest entry.
  *
  * Returns          pointer to entry
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
-  uint16_t xx;
   uint64_t ot = UINT64_MAX;
 
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  tINQ_DB_ENT* p_old = inq_db_;
+  tINQ_DB_ENT* p_old = nullptr;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (const auto& p_ent : inq_db_) {
     if (!p_ent->in_use) {
-      memset(p_ent, 0, sizeof(tINQ_DB_ENT));
+      memset(p_ent.get(), 0, sizeof(tINQ_DB_ENT));
       p_ent->inq_info.results.remote_bd_addr = p_bda;
       p_ent->in_use = true;
 
-      return (p_ent);
+      return (p_ent.get());
     }
 
     if (p_ent->time_of_resp < ot) {
-      p_old = p_ent;
+      p_old = p_ent.get();
       ot = p_ent->time_of_resp;
     }
   }
 
+  if (p_old == nullptr || inq_db_.size() < inq_db_max_size_) {
+    inq_db_.push_back(std::make_unique<tINQ_DB_ENT>());
+    p_old = inq_db_.back().get();
+  }
+
   /* If here, no free entry found. Return the oldest. */
 
   memset(p_old, 0, sizeof(tINQ_DB_ENT));
@@ -1179,6 +1198,42 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
   return (p_old);
 }
 
+/* FNV-1a over the EIR of an extended inquiry result */
+static uint32_t btm_inq_eir_hash(const uint8_t* p_eir) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < HCI_EXT_INQ_RESPONSE_LEN; i++) {
+    hash ^= p_eir[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_inq_is_unchanged_repeat
+ *
+ * Description      Checks whether a repeated BR/EDR response of a device that
+ *                  was already reported during the current inquiry carries
+ *                  the same EIR and an RSSI within BTM_INQ_RSSI_REPORT_DELTA
+ *                  of the last reported one, so it needs no new upcall.
+ *
+ * Returns          true if the response can be suppressed
+ *
+ ******************************************************************************/
+static bool btm_inq_is_unchanged_repeat(const tINQ_DB_ENT* p_i,
+                                        uint8_t inq_res_mode, int8_t rssi,
+                                        const uint8_t* p_eir) {
+  if (p_i->inq_count != btm_cb.btm_inq_vars.inq_counter ||
+      !(p_i->inq_info.results.device_type & BT_DEVICE_TYPE_BREDR)) {
+    return false;
+  }
+  if (inq_res_mode == BTM_INQ_RESULT_EXTENDED &&
+      btm_inq_eir_hash(p_eir) != p_i->eir_hash) {
+    return false;
+  }
+  return abs(rssi - p_i->reported_rssi) < BTM_INQ_RSSI_REPORT_DELTA;
+}
+
 /*******************************************************************************
  *
  * Function         btm_process_inq_results
@@ -1297,6 +1352,13 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
       /* If no update needed continue with next response (if any) */
       else
         continue;
+
+      /* Repeats that changed neither EIR nor RSSI noticeably are not reported
+       * again */
+      if (btm_inq_is_unchanged_repeat(p_i, inq_res_mode, (int8_t)rssi, p)) {
+        btm_cb.neighbor.classic_inquiry.suppressed++;
+        continue;
+      }
     }
 
     /* If existing entry, use that, else get a new one (possibly reusing the
@@ -1370,8 +1432,10 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
         /* set bit map of UUID list from received EIR */
         btm_set_eir_uuid(p, p_cur);
         p_eir_data = p;
+        p_i->eir_hash = btm_inq_eir_hash(p);
       } else
         p_eir_data = NULL;
+      p_i->reported_rssi = p_cur->rssi;
 
       /* If a callback is registered, call it with the results */
       if (p_inq_results_cb) {
@@ -1395,29 +1459,21 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
  *
  ******************************************************************************/
 void btm_sort_inq_result(void) {
-  uint8_t xx, yy, num_resp;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  tINQ_DB_ENT* p_next = inq_db_ + 1;
-  int size;
-  tINQ_DB_ENT* p_tmp = (tINQ_DB_ENT*)osi_malloc(sizeof(tINQ_DB_ENT));
-
-  num_resp = (btm_cb.btm_inq_vars.inq_cmpl_info.num_resp < BTM_INQ_DB_SIZE)
-                 ? btm_cb.btm_inq_vars.inq_cmpl_info.num_resp
-                 : BTM_INQ_DB_SIZE;
-
-  size = sizeof(tINQ_DB_ENT);
-  for (xx = 0; xx < num_resp - 1; xx++, p_ent++) {
-    for (yy = xx + 1, p_next = p_ent + 1; yy < num_resp; yy++, p_next++) {
-      if (p_ent->inq_info.results.rssi < p_next->inq_info.results.rssi) {
-        memcpy(p_tmp, p_next, size);
-        memcpy(p_next, p_ent, size);
-        memcpy(p_ent, p_tmp, size);
+
+  size_t num_resp = std::min<size_t>(
+      btm_cb.btm_inq_vars.inq_cmpl_info.num_resp, inq_db_.size());
+
+  /* Entries are swapped rather than copied, so that the pointers handed out
+   * keep designating the same devices */
+  for (size_t xx = 0; xx + 1 < num_resp; xx++) {
+    for (size_t yy = xx + 1; yy < num_resp; yy++) {
+      if (inq_db_[xx]->inq_info.results.rssi <
+          inq_db_[yy]->inq_info.results.rssi) {
+        std::swap(inq_db_[xx], inq_db_[yy]);
       }
     }
   }
-
-  osi_free(p_tmp);
 }
 
 /*******************************************************************************
@@ -1493,11 +1549,12 @@ void btm_process_inq_complete(tHCI_STATUS status, uint8_t mode) {
       BTM_LogHistory(
           kBtmLogTag, RawAddress::kEmpty, "Classic inquiry complete",
           base::StringPrintf(
-              "duration_s:%6.3f results:%lu inq_active:0x%02x std:%u rssi:%u "
-              "ext:%u status:%s",
+              "duration_s:%6.3f results:%lu suppressed:%lu inq_active:0x%02x "
+              "std:%u rssi:%u ext:%u status:%s",
               (end_time_ms - btm_cb.neighbor.classic_inquiry.start_time_ms) /
                   1000.0,
-              btm_cb.neighbor.classic_inquiry.results, inq_active,
+              btm_cb.neighbor.classic_inquiry.results,
+              btm_cb.neighbor.classic_inquiry.suppressed, inq_active,
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_STANDARD],
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_WITH_RSSI],
               p_inq->inq_cmpl_info.resp_type[BTM_INQ_RESULT_EXTENDED],
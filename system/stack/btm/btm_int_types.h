@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "gd/common/circular_buffer.h"
 #include "osi/include/allocator.h"
@@ -278,6 +279,13 @@ typedef struct tBTM_CB {
   uint8_t disc_reason{0};           /* for legacy devices */
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
   list_t* sec_dev_rec{nullptr}; /* list of tBTM_SEC_DEV_REC */
+  /* Records last found in |sec_dev_rec| by btm_find_dev(),
+   * btm_find_dev_by_handle() and btm_find_dev_with_lenc(), only kept while
+   * |sec_dev_rec_indexed| */
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_by_addr;
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> sec_dev_rec_by_handle;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_with_lenc;
+  bool sec_dev_rec_indexed{false};
   tBTM_SEC_SERV_REC* p_out_serv{nullptr};
   tBTM_MKEY_CALLBACK* mkey_cback{nullptr};
 
@@ -313,6 +321,7 @@ typedef struct tBTM_CB {
     struct {
       long long start_time_ms;
       unsigned long results;
+      unsigned long suppressed;
     } classic_inquiry, le_scan, le_inquiry, le_observe, le_legacy_scan;
     std::unique_ptr<
         bluetooth::common::TimestampedCircularBuffer<tBTM_INQUIRY_CMPL>>
@@ -359,6 +368,10 @@ typedef struct tBTM_CB {
       *((tBTM_SEC_DEV_REC*)ptr) = {};
       osi_free(ptr);
     });
+    sec_dev_rec_by_addr.clear();
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_with_lenc.clear();
+    sec_dev_rec_indexed = true;
 
     /* Initialize BTM component structures */
     btm_inq_vars.Init(); /* Inquiry Database and Structures */
@@ -385,6 +398,10 @@ typedef struct tBTM_CB {
     fixed_queue_free(sec_pending_q, nullptr);
     sec_pending_q = nullptr;
 
+    sec_dev_rec_indexed = false;
+    sec_dev_rec_by_addr.clear();
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_with_lenc.clear();
     list_free(sec_dev_rec);
     sec_dev_rec = nullptr;
 
@@ -31,6 +31,7 @@
 #include "btm_iso_api.h"
 #include "common/time_util.h"
 #include "device/include/controller.h"
+#include "gd/common/tracing.h"
 #include "hci/include/hci_layer.h"
 #include "internal_include/stack_config.h"
 #include "osi/include/allocator.h"
@@ -60,6 +61,27 @@ struct iso_sync_info {
   uint16_t seq_nb;
 };
 
+static constexpr uint8_t kTxSyncRefNone = 0x00;
+static constexpr uint8_t kTxSyncRefPending = 0x01;
+static constexpr uint8_t kTxSyncRefValid = 0x02;
+/* Attempts at reading the controller reference before giving up, the first
+ * SDU may not have reached the controller yet */
+static constexpr uint8_t kTxSyncRefMaxAttempts = 3;
+
+/* Scheduling of the SDUs sent to the controller */
+struct iso_tx_info {
+  bool started;
+  /* Sequence number of the last SDU sent */
+  uint16_t seq_nb;
+  /* Controller time stamp of the SDU sent with ref_seq_nb, read with
+   * HCI_LE_Read_ISO_TX_Sync */
+  uint8_t ref_state;
+  uint8_t ref_attempts;
+  uint16_t ref_seq_nb;
+  uint32_t ref_ts;
+  uint32_t ref_time_offset;
+};
+
 struct iso_base {
   union {
     uint8_t cig_id;
@@ -83,8 +105,18 @@ struct iso_base {
     uint64_t evt_last_lost_us = 0;
   };
 
+  struct sdu_stats {
+    size_t sdu_sent_count = 0;
+    size_t sdu_dropped_count = 0;
+    size_t sdu_late_count = 0;
+    size_t sdu_missed_intervals = 0;
+    uint64_t sdu_last_late_us = 0;
+  };
+
+  struct iso_tx_info tx_info;
   credits_stats cr_stats;
   event_stats evt_stats;
+  sdu_stats tx_stats;
 };
 
 typedef iso_base iso_cis;
@@ -532,8 +564,77 @@ struct iso_impl {
     bte_main_hci_send(packet, MSG_STACK_TO_HC_HCI_ISO | 0x0001);
   }
 
+  /* The sequence number of an SDU is the SDU interval it is sent in. The SDU
+   * goes in the interval nearest to its send time, but never before the one
+   * following the previous SDU, so that host scheduling jitter neither makes
+   * two SDUs share an interval nor skips one. An SDU more than half an
+   * interval late skips the intervals it missed.
+   */
+  uint16_t next_tx_seq_nb(iso_base* iso, uint32_t now_us) {
+    uint16_t nearest =
+        (now_us - iso->sync_info.first_sync_ts + iso->sdu_itv / 2) /
+        iso->sdu_itv;
+    if (!iso->tx_info.started) return nearest;
+
+    uint16_t next = iso->tx_info.seq_nb + 1;
+    int16_t missed = static_cast<int16_t>(nearest - next);
+    if (missed <= 0) return next;
+
+    iso->tx_stats.sdu_late_count++;
+    iso->tx_stats.sdu_missed_intervals += missed;
+    iso->tx_stats.sdu_last_late_us = now_us;
+    return nearest;
+  }
+
+  /* Once the controller told when it sends an SDU, the time stamps of the
+   * following ones are derived from it in the controller clock, one SDU
+   * interval apart, however late the host submits them.
+   */
+  uint32_t tx_time_stamp(const iso_base* iso, uint16_t seq_nb,
+                         uint32_t now_us) {
+    if (iso->tx_info.ref_state != kTxSyncRefValid) return now_us;
+
+    int64_t intervals =
+        static_cast<int16_t>(seq_nb - iso->tx_info.ref_seq_nb);
+    return iso->tx_info.ref_ts + intervals * iso->sdu_itv;
+  }
+
+  void on_iso_tx_sync_read(uint8_t* stream, uint16_t len) {
+    uint8_t status;
+    uint16_t conn_handle;
+
+    // 1 + 2 + 2 + 4 + 3
+    if (len < 12) {
+      LOG_ERROR("Malformed ISO TX sync, len=%hu", len);
+      return;
+    }
+
+    STREAM_TO_UINT8(status, stream);
+    STREAM_TO_UINT16(conn_handle, stream);
+
+    iso_base* iso = GetIsoIfKnown(conn_handle);
+    if (iso == nullptr) {
+      LOG_WARN("Invalid connection handle: 0x%04x", conn_handle);
+      return;
+    }
+
+    if (status != HCI_SUCCESS) {
+      LOG_WARN("Failed to read ISO TX sync of handle 0x%04x, status: 0x%02x",
+               conn_handle, status);
+      /* Time stamps stay in the host clock */
+      iso->tx_info.ref_state = kTxSyncRefNone;
+      return;
+    }
+
+    STREAM_TO_UINT16(iso->tx_info.ref_seq_nb, stream);
+    STREAM_TO_UINT32(iso->tx_info.ref_ts, stream);
+    STREAM_TO_UINT24(iso->tx_info.ref_time_offset, stream);
+    iso->tx_info.ref_state = kTxSyncRefValid;
+  }
+
   void send_iso_data(uint16_t iso_handle, const uint8_t* data,
                      uint16_t data_len) {
+    BT_TRACE_SCOPE("iso", "send_iso_data", iso_handle, 0);
     iso_base* iso = GetIsoIfKnown(iso_handle);
     LOG_ASSERT(iso != nullptr)
         << "No such iso connection handle: " << loghex(iso_handle);
@@ -552,12 +653,16 @@ struct iso_impl {
     }
 
     /* Calculate sequence number for the ISO data packet.
-     * It should be incremented by 1 every SDU Interval.
+     * It should be incremented by 1 every SDU Interval, even when the SDU
+     * is dropped.
      */
-    uint32_t ts = bluetooth::common::time_get_os_boottime_us();
-    iso->sync_info.seq_nb = (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
+    uint32_t now_us = bluetooth::common::time_get_os_boottime_us();
+    uint16_t seq_nb = next_tx_seq_nb(iso, now_us);
+    iso->tx_info.seq_nb = seq_nb;
+    iso->tx_info.started = true;
 
     if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
+      iso->tx_stats.sdu_dropped_count++;
       iso->cr_stats.credits_underflow_bytes += data_len;
       iso->cr_stats.credits_underflow_count++;
       iso->cr_stats.credits_last_underflow_us =
@@ -573,10 +678,21 @@ struct iso_impl {
     iso_credits_--;
     iso->used_credits++;
 
-    BT_HDR* packet =
-        prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
+    BT_HDR* packet = prepare_ts_hci_packet(
+        iso_handle, tx_time_stamp(iso, seq_nb, now_us), seq_nb, data_len);
     memcpy(packet->data + kIsoDataInTsBtHdrOffset, data, data_len);
     send_iso_data_hci_packet(packet);
+    iso->tx_stats.sdu_sent_count++;
+
+    /* The controller can only tell when it sends an SDU it was given */
+    if (iso->tx_info.ref_state == kTxSyncRefNone &&
+        iso->tx_info.ref_attempts < kTxSyncRefMaxAttempts) {
+      iso->tx_info.ref_state = kTxSyncRefPending;
+      iso->tx_info.ref_attempts++;
+      btsnd_hcic_read_iso_tx_sync(
+          iso_handle, base::BindOnce(&iso_impl::on_iso_tx_sync_read,
+                                     base::Unretained(this)));
+    }
   }
 
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
@@ -598,6 +714,7 @@ struct iso_impl {
                        hci_error_code_text((tHCI_STATUS)(evt.status)).c_str()));
 
     cis->sync_info.first_sync_ts = bluetooth::common::time_get_os_boottime_us();
+    cis->tx_info = {};
 
     STREAM_TO_UINT24(evt.cig_sync_delay, data);
     STREAM_TO_UINT24(evt.cis_sync_delay, data);
@@ -742,6 +859,7 @@ struct iso_impl {
         bis->big_handle = evt.big_id;
         bis->sdu_itv = last_big_create_req_sdu_itv_;
         bis->sync_info = {.first_sync_ts = ts, .seq_nb = 0};
+        bis->tx_info = {};
         bis->used_credits = 0;
         bis->state_flags = kStateFlagIsBroadcast;
         conn_hdl_to_bis_map_[conn_handle] = std::move(bis);
@@ -841,6 +959,7 @@ struct iso_impl {
   }
 
   void handle_iso_data(BT_HDR* p_msg) {
+    BT_TRACE_SCOPE("iso", "handle_iso_data", 0, 0);
     const uint8_t* stream = p_msg->data;
     cis_data_evt evt;
     uint16_t handle, seq_nb;
@@ -969,6 +1088,27 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_sdu_stats(int fd, const iso_base::sdu_stats& stats,
+                             const iso_tx_info& tx_info) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+    dprintf(fd, "        SDU Stats:\n");
+    dprintf(fd, "          Sent (count): %zu\n", stats.sdu_sent_count);
+    dprintf(fd, "          Dropped (count): %zu\n", stats.sdu_dropped_count);
+    dprintf(fd, "          Late (count): %zu\n", stats.sdu_late_count);
+    dprintf(fd, "          Missed intervals (count): %zu\n",
+            stats.sdu_missed_intervals);
+    dprintf(fd, "          Last late time ago (ms): %llu\n",
+            (stats.sdu_last_late_us > 0
+                 ? (unsigned long long)(now_us - stats.sdu_last_late_us) / 1000
+                 : 0llu));
+    if (tx_info.ref_state == kTxSyncRefValid) {
+      dprintf(fd,
+              "          Controller sync: seq_nb %hu at %u us, offset %u us\n",
+              tx_info.ref_seq_nb, tx_info.ref_ts, tx_info.ref_time_offset);
+    }
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
@@ -988,6 +1128,8 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_sdu_stats(fd, cis_pair.second->tx_stats,
+                     cis_pair.second->tx_info);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -1000,6 +1142,8 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_sdu_stats(fd, cis_pair.second->tx_stats,
+                     cis_pair.second->tx_info);
     }
     dprintf(fd, "  ----------------\n ");
   }
@@ -26,16 +26,19 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <string>
 
 #define LOG_TAG "btm_sco"
 
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/device_iot_config.h"
 #include "embdrv/sbc/decoder/include/oi_codec_sbc.h"
 #include "embdrv/sbc/decoder/include/oi_status.h"
+#include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -104,9 +107,27 @@ static int16_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
  * They are only used for WBS and the unit is byte. */
 static size_t btm_pcm_buf_read_offset = 0;
 static size_t btm_pcm_buf_write_offset = 0;
+
+/* Tx pacing for the in-band data path. SCO flow control is not enabled towards
+ * the controller, so every received SCO packet is taken as the credit to send
+ * the same number of bytes. The credit is capped so that a burst of received
+ * packets, e.g. after a USB stall, can not flood the controller. */
+static size_t btm_sco_tx_credit = 0;
+
+/* Statistics of the in-band data path, shown in dumpsys */
+static struct {
+  uint64_t last_rx_us;       /* Arrival time of the last received packet */
+  uint64_t last_interval_us; /* Interval between the last two packets */
+  uint64_t max_interval_us;  /* Longest interval between two packets */
+  uint64_t jitter_us;        /* Interarrival jitter estimate (RFC 3550) */
+  uint32_t rx_packets;
+  uint32_t tx_packets;
+  uint32_t tx_deferred; /* Times the Tx ran out of credit */
+} btm_sco_data_stats;
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
+static void btm_sco_send_data(const uint8_t* data, size_t len);
 static tBTM_STATUS BTM_ChangeEScoLinkParms(uint16_t sco_inx,
                                            tBTM_CHG_ESCO_PARAMS* p_parms);
 
@@ -251,6 +272,27 @@ void btm_route_sco_data(BT_HDR* p_msg) {
     return;
   }
 
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  if (btm_sco_data_stats.rx_packets > 0) {
+    uint64_t interval_us = now_us - btm_sco_data_stats.last_rx_us;
+    if (btm_sco_data_stats.rx_packets > 1) {
+      uint64_t delta_us =
+          interval_us > btm_sco_data_stats.last_interval_us
+              ? interval_us - btm_sco_data_stats.last_interval_us
+              : btm_sco_data_stats.last_interval_us - interval_us;
+      btm_sco_data_stats.jitter_us =
+          (btm_sco_data_stats.jitter_us * 15 + delta_us) / 16;
+    }
+    btm_sco_data_stats.last_interval_us = interval_us;
+    btm_sco_data_stats.max_interval_us =
+        std::max(btm_sco_data_stats.max_interval_us, interval_us);
+  }
+  btm_sco_data_stats.last_rx_us = now_us;
+  btm_sco_data_stats.rx_packets++;
+
+  btm_sco_tx_credit = std::min<size_t>(btm_sco_tx_credit + data_len,
+                                       BTM_SCO_TX_CREDIT_MAX_PKTS * data_len);
+
   const uint8_t* decoded = nullptr;
   size_t written = 0, rc = 0;
   if (active_sco->is_wbs()) {
@@ -281,6 +323,7 @@ void btm_route_sco_data(BT_HDR* p_msg) {
   const uint8_t* encoded = nullptr;
   if (active_sco->is_wbs()) {
     while (written) {
+      read = 0;
       avail = BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_write_offset;
       if (avail) {
         data_len = written < avail ? written : avail;
@@ -323,12 +366,19 @@ void btm_route_sco_data(BT_HDR* p_msg) {
           &btm_pcm_buf[btm_pcm_buf_read_offset / sizeof(*btm_pcm_buf)],
           btm_pcm_buf_write_offset - btm_pcm_buf_read_offset);
 
-      if (!rc)
+      if (!rc) {
         LOG_DEBUG(
             "Failed to encode data starting at ReadOffset:%lu to "
             "WriteOffset:%lu",
             (unsigned long)btm_pcm_buf_read_offset,
             (unsigned long)btm_pcm_buf_write_offset);
+        /* The packet queue is full of paced packets, stop reading more PCM
+         * data until the next received packet gives us credit. */
+        if (read == 0) {
+          btm_sco_data_stats.tx_deferred++;
+          break;
+        }
+      }
 
       /* The offsets should reset some time as the buffer length should always
        * divisible by BTM_MSBC_CODE_SIZE(240) and wbs::encode only returns
@@ -339,25 +389,23 @@ void btm_route_sco_data(BT_HDR* p_msg) {
         btm_pcm_buf_read_offset = 0;
       }
 
-      /* Send all of the available SCO packets buffered in the queue */
-      while (1) {
+      /* Send the SCO packets buffered in the queue as far as the credit
+       * allows, the rest is kept in place for the next received packet */
+      while (btm_sco_tx_credit > 0) {
         rc = bluetooth::audio::sco::wbs::dequeue_packet(&encoded);
         if (!rc) break;
 
-        auto data = std::vector<uint8_t>(encoded, encoded + rc);
-        btm_send_sco_packet(std::move(data));
+        btm_sco_send_data(encoded, rc);
       }
     }
   } else {
-    while (written) {
-      read = bluetooth::audio::sco::read(
-          (uint8_t*)btm_pcm_buf,
-          written < BTM_SCO_DATA_SIZE_MAX ? written : BTM_SCO_DATA_SIZE_MAX);
+    while (written && btm_sco_tx_credit > 0) {
+      size_t to_read = std::min<size_t>(
+          std::min<size_t>(written, BTM_SCO_DATA_SIZE_MAX), btm_sco_tx_credit);
+      read = bluetooth::audio::sco::read((uint8_t*)btm_pcm_buf, to_read);
       if (read == 0) {
         LOG_INFO("Failed to read %lu bytes of PCM data from audio server",
-                 (unsigned long)(written < BTM_SCO_DATA_SIZE_MAX
-                                     ? written
-                                     : BTM_SCO_DATA_SIZE_MAX));
+                 (unsigned long)to_read);
         break;
       }
       written -= read;
@@ -366,13 +414,42 @@ void btm_route_sco_data(BT_HDR* p_msg) {
        * send PCM data directly to SCO.
        * We don't maintain buffer read/write offset for NB as we send all data
        * that we read from the audio server. */
-      auto data = std::vector<uint8_t>((uint8_t*)btm_pcm_buf,
-                                       (uint8_t*)btm_pcm_buf + read);
-      btm_send_sco_packet(std::move(data));
+      btm_sco_send_data((const uint8_t*)btm_pcm_buf, read);
     }
+    if (written) btm_sco_data_stats.tx_deferred++;
   }
 }
 
+// Build a SCO packet straight from the payload, without an intermediate copy
+static BT_HDR* btm_sco_build_packet(const uint8_t* data, size_t len,
+                                    uint16_t sco_handle) {
+  ASSERT_LOG(len <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
+             (unsigned long)len);
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_SMALL_BUFFER_SIZE);
+  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
+  p_buf->offset = 0;
+  p_buf->layer_specific = 0;
+  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
+  p_buf->len = len + 3;
+  uint8_t* payload = p_buf->data;
+  UINT16_TO_STREAM(payload, sco_handle);
+  UINT8_TO_STREAM(payload, len);
+  ARRAY_TO_STREAM(payload, data, static_cast<int>(len));
+  return p_buf;
+}
+
+// Send SCO data of the in-band data path, consuming the Tx credit
+static void btm_sco_send_data(const uint8_t* data, size_t len) {
+  auto* active_sco = btm_get_active_sco();
+  if (active_sco == nullptr || len == 0) {
+    return;
+  }
+  btm_sco_tx_credit = len < btm_sco_tx_credit ? btm_sco_tx_credit - len : 0;
+  btm_sco_data_stats.tx_packets++;
+  bte_main_hci_send(btm_sco_build_packet(data, len, active_sco->hci_handle),
+                    BT_EVT_TO_LM_HCI_SCO);
+}
+
 void btm_send_sco_packet(std::vector<uint8_t> data) {
   auto* active_sco = btm_get_active_sco();
   if (active_sco == nullptr || data.empty()) {
@@ -384,18 +461,22 @@ void btm_send_sco_packet(std::vector<uint8_t> data) {
 
 // Build a SCO packet from uint8
 BT_HDR* btm_sco_make_packet(std::vector<uint8_t> data, uint16_t sco_handle) {
-  ASSERT_LOG(data.size() <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
-             (unsigned long)data.size());
-  BT_HDR* p_buf = (BT_HDR*)osi_calloc(BT_SMALL_BUFFER_SIZE);
-  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
-  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
-  p_buf->len = data.size() + 3;
-  uint8_t* payload = p_buf->data;
-  UINT16_TO_STREAM(payload, sco_handle);
-  UINT8_TO_STREAM(payload, data.size());
-  ARRAY_TO_STREAM(payload, data.data(), static_cast<int>(data.size()));
-  return p_buf;
+  return btm_sco_build_packet(data.data(), data.size(), sco_handle);
+}
+
+#define DUMPSYS_TAG "shim::legacy::btm::sco"
+void DumpsysBtmSco(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  LOG_DUMPSYS(fd, " rx_packets:%u tx_packets:%u tx_deferred:%u",
+              btm_sco_data_stats.rx_packets, btm_sco_data_stats.tx_packets,
+              btm_sco_data_stats.tx_deferred);
+  LOG_DUMPSYS(fd, " rx_interval_ms last:%.3f max:%.3f jitter_ms:%.3f",
+              btm_sco_data_stats.last_interval_us / 1000.0,
+              btm_sco_data_stats.max_interval_us / 1000.0,
+              btm_sco_data_stats.jitter_us / 1000.0);
+  LOG_DUMPSYS(fd, " tx_credit:%zu", btm_sco_tx_credit);
 }
+#undef DUMPSYS_TAG
 
 /*******************************************************************************
  *
@@ -939,6 +1020,8 @@ void btm_sco_connected(const RawAddress& bda, uint16_t hci_handle,
         }
 
         std::fill(std::begin(btm_pcm_buf), std::end(btm_pcm_buf), 0);
+        btm_sco_tx_credit = 0;
+        btm_sco_data_stats = {};
         bluetooth::audio::sco::open();
       }
       return;
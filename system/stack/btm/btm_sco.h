@@ -233,3 +233,6 @@ BT_HDR* btm_sco_make_packet(std::vector<uint8_t> data, uint16_t sco_handle);
 
 /* Send a SCO packet */
 void btm_send_sco_packet(std::vector<uint8_t> data);
+
+/* Dump the statistics of the in-band SCO data path */
+void DumpsysBtmSco(int fd);
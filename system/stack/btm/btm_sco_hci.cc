@@ -486,7 +486,15 @@ struct tBTM_MSBC_INFO {
 
   size_t write(const uint8_t* input, size_t len) {
     if (len > buf_size - decode_buf_wo) {
-      return 0;
+      /* Wrap around by moving the undecoded tail to the front of the buffer,
+       * so that a mSBC frame is always contiguous for the in-place decoder. */
+      size_t pending = decode_buf_wo - decode_buf_ro;
+      if (len > buf_size - pending) {
+        return 0;
+      }
+      memmove(msbc_decode_buf, msbc_decode_buf + decode_buf_ro, pending);
+      decode_buf_ro = 0;
+      decode_buf_wo = pending;
     }
 
     std::copy(input, input + len, msbc_decode_buf + decode_buf_wo);
@@ -528,12 +536,21 @@ struct tBTM_MSBC_INFO {
    * body for the caller to fill the encoded mSBC data if there is enough space
    * in the buffer to fill in a new packet, otherwise return a nullptr. */
   uint8_t* fill_msbc_pkt_template() {
-    uint8_t* wp = &msbc_encode_buf[encode_buf_wo];
     if (buf_size - encode_buf_wo < BTM_MSBC_PKT_LEN) {
-      LOG_DEBUG("Packet queue can't accommodate more packets.");
-      return nullptr;
+      /* Packets held back by the Tx pacing are still queued, move them to the
+       * front to make room at the tail. */
+      size_t pending = encode_buf_wo - encode_buf_ro;
+      if (buf_size - pending < BTM_MSBC_PKT_LEN) {
+        LOG_DEBUG("Packet queue can't accommodate more packets.");
+        return nullptr;
+      }
+      memmove(msbc_encode_buf, msbc_encode_buf + encode_buf_ro, pending);
+      encode_buf_ro = 0;
+      encode_buf_wo = pending;
     }
 
+    uint8_t* wp = &msbc_encode_buf[encode_buf_wo];
+
     wp[0] = BTM_MSBC_H2_HEADER_0;
     wp[1] = btm_h2_header_frames_count[num_encoded_msbc_pkts % 4];
     encode_buf_wo += BTM_MSBC_PKT_LEN;
@@ -172,6 +172,8 @@ typedef struct {
   tBTM_INQ_INFO inq_info;
   bool in_use;
   bool scan_rsp;
+  uint32_t eir_hash;    /* Hash of the last EIR reported to the caller */
+  int8_t reported_rssi; /* RSSI of the last result reported to the caller */
 } tINQ_DB_ENT;
 
 typedef struct /* contains the parameters passed to the inquiry functions */
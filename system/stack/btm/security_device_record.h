@@ -112,8 +112,9 @@ struct tBTM_SEC_BLE {
 
   tBLE_BD_ADDR identity_address_with_type;
 
+#define BTM_ACCEPT_LIST_BIT 0x01
 #define BTM_RESOLVING_LIST_BIT 0x02
-  uint8_t in_controller_list; /* in controller resolving list or not */
+  uint8_t in_controller_list; /* in controller accept/resolving list or not */
   uint8_t resolving_list_index;
   RawAddress cur_rand_addr; /* current random address */
 
@@ -221,15 +222,25 @@ struct tBTM_SEC_DEV_REC {
     BOND_TYPE_TEMPORARY = 2
   } tBTM_BOND_TYPE;
 
+  /* The fields read while walking |btm_cb.sec_dev_rec| to find a record are
+   * kept together at the start of the record, ahead of the names and keys,
+   * so that a walk only touches the first cache lines of each record. The
+   * LE addresses and key type lead |ble|, its keys come last. */
+  RawAddress bd_addr;         /* BD_ADDR of the device              */
+  uint16_t hci_handle;        /* Handle to connection when exists   */
+  uint16_t ble_hci_handle;    /* use in DUMO connection */
+  uint16_t sec_flags;         /* Current device security state      */
+  tSECURITY_STATE sec_state;  /* Operating state                    */
+  tBT_DEVICE_TYPE device_type;
+  uint32_t timestamp;         /* Timestamp of the last connection   */
+  tBTM_SEC_BLE ble;
+
   uint32_t required_security_flags_for_pairing;
   tBTM_SEC_CALLBACK* p_callback;
   void* p_ref_data;
-  uint32_t timestamp; /* Timestamp of the last connection   */
-  uint16_t hci_handle;     /* Handle to connection when exists   */
   uint16_t suggested_tx_octets; /* Recently suggested tx octects for data length
                                    extension */
   uint16_t clock_offset;   /* Latest known clock offset          */
-  RawAddress bd_addr;      /* BD_ADDR of the device              */
   DEV_CLASS dev_class;     /* DEV_CLASS of the device            */
   LinkKey link_key;        /* Device link key                    */
   tHCI_STATUS sec_status;  /* Status in encryption change event  */
@@ -261,7 +272,6 @@ struct tBTM_SEC_DEV_REC {
   uint8_t pin_code_length; /* Length of the pin_code used for paring */
 
  public:
-  uint16_t sec_flags; /* Current device security state      */
   bool is_device_authenticated() const {
     return sec_flags & BTM_SEC_AUTHENTICATED;
   }
@@ -329,7 +339,6 @@ struct tBTM_SEC_DEV_REC {
   tBTM_BD_NAME sec_bd_name; /* User friendly name of the device. (may be
                                truncated to save space in dev_rec table) */
 
-  tSECURITY_STATE sec_state; /* Operating state                    */
   bool is_security_state_idle() const {
     return sec_state == BTM_SEC_STATE_IDLE;
   }
@@ -429,13 +438,11 @@ struct tBTM_SEC_DEV_REC {
   bool remote_supports_ble;
   bool remote_feature_received = false;
 
-  uint16_t ble_hci_handle; /* use in DUMO connection */
   uint16_t get_ble_hci_handle() const { return ble_hci_handle; }
 
   uint8_t enc_key_size;    /* current link encryption key size */
   uint8_t get_encryption_key_size() const { return enc_key_size; }
 
-  tBT_DEVICE_TYPE device_type;
   bool is_device_type_br_edr() const {
     return device_type == BT_DEVICE_TYPE_BREDR;
   }
@@ -461,7 +468,6 @@ struct tBTM_SEC_DEV_REC {
     return bond_type == BOND_TYPE_TEMPORARY;
   }
 
-  tBTM_SEC_BLE ble;
   tBTM_LE_CONN_PRAMS conn_params;
 
   tREMOTE_VERSION_INFO remote_version_info;
@@ -32,6 +32,7 @@
 #include "btif/include/btif_common.h"
 #include "btm_iso_api.h"
 #include "common/message_loop_thread.h"
+#include "gd/os/thread_scheduling.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -120,7 +121,8 @@ void main_thread_start_up() {
   if (!main_thread.IsRunning()) {
     LOG(FATAL) << __func__ << ": unable to start btu message loop thread.";
   }
-  if (!main_thread.EnableRealTimeScheduling()) {
+  if (!bluetooth::os::ApplyThreadScheduling(main_thread.GetThreadId(),
+                                            main_thread.GetName(), true)) {
 #if defined(__ANDROID__)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
 #else
@@ -167,6 +167,11 @@ EattChannel* EattExtension::GetChannelAvailableForIndication(
   return pimpl_->eatt_impl_->get_channel_available_for_indication(bd_addr);
 }
 
+EattChannel* EattExtension::GetChannelAvailableForNotification(
+    const RawAddress& bd_addr) {
+  return pimpl_->eatt_impl_->get_channel_available_for_notification(bd_addr);
+}
+
 void EattExtension::FreeGattResources(const RawAddress& bd_addr) {
   pimpl_->eatt_impl_->free_gatt_resources(bd_addr);
 }
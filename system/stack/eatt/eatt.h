@@ -205,6 +205,17 @@ class EattExtension {
   virtual EattChannel* GetChannelAvailableForIndication(
       const RawAddress& bd_addr);
 
+  /**
+   * Get EATT channel to send a notification on. Spreads notifications over the
+   * open channels by L2CAP queue depth and peer credits.
+   *
+   * @param bd_addr peer device address
+   *
+   * @return pointer to EATT channel.
+   */
+  virtual EattChannel* GetChannelAvailableForNotification(
+      const RawAddress& bd_addr);
+
   /**
    * Free Resources.
    *
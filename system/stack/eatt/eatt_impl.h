@@ -52,8 +52,14 @@ class eatt_device {
 
   std::map<uint16_t, std::shared_ptr<EattChannel>> eatt_channels;
   bool collision;
+  /* Channel the last notification was sent on */
+  uint16_t last_notification_cid_;
   eatt_device(const RawAddress& bd_addr, uint16_t mtu, uint16_t mps)
-      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr), collision(false) {
+      : rx_mtu_(mtu),
+        rx_mps_(mps),
+        eatt_tcb_(nullptr),
+        collision(false),
+        last_notification_cid_(0) {
     bda_ = bd_addr;
   }
 };
@@ -698,6 +704,39 @@ struct eatt_impl {
                                                    : iter->second.get();
   }
 
+  /* Notifications need no response, so they can go on any open channel. Pick
+   * the one with the fewest buffers queued in L2CAP, then the one the peer
+   * gave the most credits to, starting after the channel used last time so
+   * that equally loaded channels take turns. */
+  EattChannel* get_channel_available_for_notification(
+      const RawAddress& bd_addr) {
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev) return nullptr;
+
+    auto& channels = eatt_dev->eatt_channels;
+    auto start = channels.upper_bound(eatt_dev->last_notification_cid_);
+    EattChannel* best = nullptr;
+    uint16_t best_queued = 0;
+    uint16_t best_credits = 0;
+    for (size_t i = 0; i < channels.size(); i++, start++) {
+      if (start == channels.end()) start = channels.begin();
+      EattChannel* channel = start->second.get();
+      if (channel->state_ != EattChannelState::EATT_CHANNEL_OPENED) continue;
+
+      uint16_t queued = L2CA_FlushChannel(channel->cid_, L2CAP_FLUSH_CHANS_GET);
+      uint16_t credits = L2CA_GetPeerLECocCredit(bd_addr, channel->cid_);
+      if (best == nullptr || queued < best_queued ||
+          (queued == best_queued && credits > best_credits)) {
+        best = channel;
+        best_queued = queued;
+        best_credits = credits;
+      }
+    }
+
+    if (best) eatt_dev->last_notification_cid_ = best->cid_;
+    return best;
+  }
+
   void free_gatt_resources(const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
     if (!eatt_dev) return;
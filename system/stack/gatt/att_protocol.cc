@@ -26,6 +26,7 @@
 
 #include "bt_target.h"
 #include "gatt_int.h"
+#include "gd/common/tracing.h"
 #include "l2c_api.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
@@ -448,6 +449,7 @@ BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code, tGATT_SR_MSG* p_msg,
  *
  ******************************************************************************/
 tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg) {
+  BT_TRACE_SCOPE("att", "send_server_msg", 0, cid);
   if (p_msg == NULL) {
     LOG_WARN("Unable to send empty message");
     return GATT_NO_RESOURCES;
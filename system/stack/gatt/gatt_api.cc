@@ -28,6 +28,7 @@
 #include <stdio.h>
 
 #include <string>
+#include <vector>
 
 #include "bt_target.h"
 #include "device/include/controller.h"
@@ -35,6 +36,7 @@
 #include "internal_include/stack_config.h"
 #include "l2c_api.h"
 #include "main/shim/dumpsys.h"
+#include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/list.h"
 #include "osi/include/log.h"
@@ -129,6 +131,7 @@ static bool is_gatt_attr_type(const Uuid& uuid) {
 
 /** Update the the last service info for the service list info */
 static void gatt_update_last_srv_info() {
+  gatt_sr_update_srv_handle_index();
   gatt_cb.last_service_handle = 0;
 
   for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
@@ -138,7 +141,9 @@ static void gatt_update_last_srv_info() {
 
 /** Update database hash and client status */
 static void gatt_update_for_database_change() {
-  gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  /* Services are often added one after the other, hash the database once when
+   * it is needed rather than on each change */
+  gatt_cb.database_hash_dirty = true;
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -424,6 +429,72 @@ void GATTS_StopService(uint16_t service_handle) {
   gatt_cb.srv_list_info->erase(it);
   gatt_update_last_srv_info();
 }
+
+/* How long a notification may wait for others to be sent with, 0 to send
+ * notifications right away */
+static uint32_t gatt_notif_coalescing_window_ms() {
+  static const uint32_t window_ms = bluetooth::os::GetSystemPropertyUint32(
+      "bluetooth.gatt.notification_coalescing_window_ms", 0);
+  return window_ms;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_flush_pending_notifs
+ *
+ * Description      Send the notifications held back on this link
+ *
+ ******************************************************************************/
+static void gatt_flush_pending_notifs(tGATT_TCB* p_tcb) {
+  alarm_cancel(p_tcb->notif_coalescing_timer);
+  if (p_tcb->pending_notifs.empty()) return;
+
+  std::vector<tGATT_VALUE> notifs;
+  std::swap(notifs, p_tcb->pending_notifs);
+  p_tcb->pending_notifs_len = 0;
+
+  tGATT_STATUS status = GATTS_HandleMultipleValueNotifications(
+      p_tcb->pending_notifs_conn_id, notifs);
+  if (status != GATT_SUCCESS && status != GATT_CONGESTED) {
+    LOG_WARN("Failed to send %zu notifications, status: %d", notifs.size(),
+             status);
+  }
+}
+
+static void gatt_notif_coalescing_timeout(void* data) {
+  gatt_flush_pending_notifs((tGATT_TCB*)data);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_coalesce_notif
+ *
+ * Description      Hold back a notification, to send it together with the
+ *                  ones following within the coalescing window. The
+ *                  notifications are sent early once they fill the ATT MTU.
+ *
+ ******************************************************************************/
+static tGATT_STATUS gatt_coalesce_notif(tGATT_TCB* p_tcb, uint16_t conn_id,
+                                        const tGATT_VALUE& notif) {
+  /* Handle and length of each value, after the opcode */
+  uint16_t len = 4 + notif.len;
+  if (!p_tcb->pending_notifs.empty() &&
+      (p_tcb->pending_notifs_conn_id != conn_id ||
+       1 + p_tcb->pending_notifs_len + len > p_tcb->payload_size)) {
+    gatt_flush_pending_notifs(p_tcb);
+  }
+
+  p_tcb->pending_notifs.push_back(notif);
+  p_tcb->pending_notifs_conn_id = conn_id;
+  p_tcb->pending_notifs_len += len;
+  if (!alarm_is_scheduled(p_tcb->notif_coalescing_timer)) {
+    alarm_set_on_mloop(p_tcb->notif_coalescing_timer,
+                       gatt_notif_coalescing_window_ms(),
+                       gatt_notif_coalescing_timeout, p_tcb);
+  }
+  return GATT_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         GATTs_HandleValueIndication
@@ -455,6 +526,9 @@ tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
 
   if (!GATT_HANDLE_IS_VALID(attr_handle)) return GATT_ILLEGAL_PARAMETER;
 
+  /* Keep the indication behind the notifications sent before it */
+  gatt_flush_pending_notifs(p_tcb);
+
   tGATT_VALUE indication;
   indication.conn_id = conn_id;
   indication.handle = attr_handle;
@@ -488,16 +562,17 @@ tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
   return cmd_status;
 }
 
-#if (GATT_UPPER_TESTER_MULT_VARIABLE_LENGTH_NOTIF == TRUE)
-static tGATT_STATUS GATTS_HandleMultileValueNotification(
-    tGATT_TCB* p_tcb, std::vector<tGATT_VALUE> gatt_notif_vector) {
-  LOG_INFO("");
-
-  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, true /* eatt support */);
-  uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
+/* Handle, length and value of one notification in a multiple handle value
+ * notification */
+static uint16_t gatt_multi_value_notif_tuple_len(const tGATT_VALUE& notif) {
+  return 4 + notif.len;
+}
 
-  /* TODO Handle too big packet size here. Not needed now for testing. */
-  /* Just build the message. */
+/* Build a multiple handle value notification carrying all of |notifs|, which
+ * must fit in |payload_size| */
+static BT_HDR* gatt_build_multi_value_notif(const tGATT_VALUE* notifs,
+                                            size_t count,
+                                            uint16_t payload_size) {
   BT_HDR* p_buf =
       (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
 
@@ -505,19 +580,40 @@ static tGATT_STATUS GATTS_HandleMultileValueNotification(
   UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
   p_buf->offset = L2CAP_MIN_OFFSET;
   p_buf->len = 1;
-  for (auto notif : gatt_notif_vector) {
-    LOG_INFO("Adding handle: 0x%04x, val len %d", notif.handle, notif.len);
+  for (size_t i = 0; i < count; i++) {
+    const tGATT_VALUE& notif = notifs[i];
+    CHECK(p_buf->len + gatt_multi_value_notif_tuple_len(notif) <=
+          payload_size);
     UINT16_TO_STREAM(p, notif.handle);
-    p_buf->len += 2;
     UINT16_TO_STREAM(p, notif.len);
-    p_buf->len += 2;
     ARRAY_TO_STREAM(p, notif.value, notif.len);
-    p_buf->len += notif.len;
+    p_buf->len += gatt_multi_value_notif_tuple_len(notif);
   }
+  return p_buf;
+}
+
+#if (GATT_UPPER_TESTER_MULT_VARIABLE_LENGTH_NOTIF == TRUE)
+static tGATT_STATUS GATTS_HandleMultileValueNotification(
+    tGATT_TCB* p_tcb, std::vector<tGATT_VALUE> gatt_notif_vector) {
+  LOG_INFO("");
 
-  LOG_INFO("Total len: %d", p_buf->len);
+  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, true /* eatt support */);
+  uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
 
-  return attp_send_sr_msg(*p_tcb, cid, p_buf);
+  uint16_t len = 1;
+  for (auto& notif : gatt_notif_vector) {
+    len += gatt_multi_value_notif_tuple_len(notif);
+  }
+  if (len > payload_size) {
+    LOG_ERROR("Total len: %d does not fit in %d", len, payload_size);
+    return GATT_NO_RESOURCES;
+  }
+
+  LOG_INFO("Total len: %d", len);
+  return attp_send_sr_msg(*p_tcb, cid,
+                          gatt_build_multi_value_notif(gatt_notif_vector.data(),
+                                                       gatt_notif_vector.size(),
+                                                       payload_size));
 }
 #endif
 /*******************************************************************************
@@ -603,11 +699,16 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   memcpy(notif.value, p_val, val_len);
   notif.auth_req = GATT_AUTH_REQ_NONE;
 
+  if (gatt_notif_coalescing_window_ms() > 0) {
+    return gatt_coalesce_notif(p_tcb, conn_id, notif);
+  }
+
   tGATT_STATUS cmd_sent;
   tGATT_SR_MSG gatt_sr_msg;
   gatt_sr_msg.attr_value = notif;
 
-  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+  uint16_t cid = gatt_tcb_get_att_cid_for_notification(*p_tcb,
+                                                       p_reg->eatt_support);
   uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
   BT_HDR* p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF,
                                     &gatt_sr_msg, payload_size);
@@ -620,6 +721,81 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return cmd_sent;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotifications
+ *
+ * Description      This function sends handle value notifications to a client.
+ *                  When the client supports multiple handle value
+ *                  notifications, as many as fit in a PDU are sent together.
+ *                  Each PDU goes on the least loaded bearer.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  notifs: handles and values to notify.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleMultipleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  if ((p_reg == NULL) || (p_tcb == NULL)) {
+    LOG(ERROR) << __func__ << "Unknown  conn_id: " << conn_id;
+    return (tGATT_STATUS)GATT_INVALID_CONN_ID;
+  }
+
+  for (const tGATT_VALUE& notif : notifs) {
+    if (!GATT_HANDLE_IS_VALID(notif.handle)) return GATT_ILLEGAL_PARAMETER;
+  }
+
+  gatt_flush_pending_notifs(p_tcb);
+
+  bool batching = gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+  tGATT_STATUS status = GATT_SUCCESS;
+  size_t i = 0;
+  while (i < notifs.size()) {
+    uint16_t cid =
+        gatt_tcb_get_att_cid_for_notification(*p_tcb, p_reg->eatt_support);
+    uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
+
+    size_t count = 0;
+    uint16_t len = 1;
+    while (batching && i + count < notifs.size() &&
+           len + gatt_multi_value_notif_tuple_len(notifs[i + count]) <=
+               payload_size) {
+      len += gatt_multi_value_notif_tuple_len(notifs[i + count]);
+      count++;
+    }
+
+    BT_HDR* p_buf;
+    if (count >= 2) {
+      p_buf = gatt_build_multi_value_notif(&notifs[i], count, payload_size);
+    } else {
+      /* A multiple handle value notification needs two values at least */
+      count = 1;
+      tGATT_SR_MSG gatt_sr_msg;
+      gatt_sr_msg.attr_value = notifs[i];
+      gatt_sr_msg.attr_value.auth_req = GATT_AUTH_REQ_NONE;
+      p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg,
+                                payload_size);
+      if (p_buf == NULL) return GATT_NO_RESOURCES;
+    }
+
+    tGATT_STATUS cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
+    if (cmd_sent == GATT_CONGESTED) {
+      status = GATT_CONGESTED;
+    } else if (cmd_sent != GATT_SUCCESS) {
+      return cmd_sent;
+    }
+    i += count;
+  }
+  return status;
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -977,13 +1153,15 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
       p_clcb->e_handle = p_read->service.e_handle;
       p_clcb->uuid = p_read->service.uuid;
       break;
-    case GATT_READ_MULTIPLE: {
+    case GATT_READ_MULTIPLE:
+    case GATT_READ_MULTIPLE_VAR_LEN: {
       p_clcb->s_handle = 0;
       /* copy multiple handles in CB */
       tGATT_READ_MULTI* p_read_multi =
           (tGATT_READ_MULTI*)osi_malloc(sizeof(tGATT_READ_MULTI));
       p_clcb->p_attr_buf = (uint8_t*)p_read_multi;
       memcpy(p_read_multi, &p_read->read_multiple, sizeof(tGATT_READ_MULTI));
+      p_read_multi->variable_len = (type == GATT_READ_MULTIPLE_VAR_LEN);
       break;
     }
     case GATT_READ_BY_HANDLE:
@@ -1160,6 +1338,48 @@ tGATT_STATUS GATTC_SendHandleValueConfirm(uint16_t conn_id, uint16_t cid) {
   return attp_send_cl_confirmation_msg(*p_tcb, cid);
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTC_GetNumberOfBearers
+ *
+ * Description      This function returns the number of ATT bearers the client
+ *                  requests of a connection can be sent on: the fixed ATT
+ *                  channel, and the opened EATT channels if the client
+ *                  registered with EATT support.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          number of bearers, 0 if the connection is unknown.
+ *
+ ******************************************************************************/
+uint8_t GATTC_GetNumberOfBearers(uint16_t conn_id) {
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_id));
+  tGATT_REG* p_reg = gatt_get_regcb(GATT_GET_GATT_IF(conn_id));
+  if (!p_tcb || !p_reg) return 0;
+
+  return 1 + (p_reg->eatt_support ? p_tcb->eatt : 0);
+}
+
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultipleVarLenSupported
+ *
+ * Description      This function checks if the server of a connection supports
+ *                  the Read Multiple Variable Length procedure. Servers that
+ *                  support EATT have to support it.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if the procedure is supported.
+ *
+ ******************************************************************************/
+bool GATTC_IsReadMultipleVarLenSupported(uint16_t conn_id) {
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_id));
+  if (!p_tcb) return false;
+
+  return gatt_profile_get_eatt_support(p_tcb->peer_bda);
+}
+
 /******************************************************************************/
 /*                                                                            */
 /*                  GATT  APIs                                                */
@@ -26,6 +26,7 @@
 #include <deque>
 #include <list>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -89,6 +90,13 @@ inline std::string gatt_security_action_text(const tGATT_SEC_ACTION& action) {
 #define GATT_WAIT_FOR_DISC_RSP_TIMEOUT_MS (5 * 1000)
 #define GATT_REQ_RETRY_LIMIT 2
 
+/* bytes of prepared writes the server queues per connection, unless set by
+ * the bluetooth.gatt.server.prepare_write_queue_quota property */
+#define GATT_PREP_WRITE_DEFAULT_QUOTA 65536
+/* prepared write segments queued per connection, each of them holds an
+ * application callback count until the Execute Write response */
+#define GATT_PREP_WRITE_MAX_SEGMENTS 254
+
 typedef struct {
   bool is_link_key_known;
   bool is_link_key_authed;
@@ -189,6 +197,11 @@ typedef struct {
   std::vector<tGATT_ATTR> attr_list; /* pointer to the attributes */
   uint16_t end_handle;       /* Last handle number           */
   uint16_t next_handle;      /* Next usable handle value     */
+  /* Positions in attr_list of the attributes of each type, in handle order */
+  std::unordered_map<bluetooth::Uuid, std::vector<uint16_t>> uuid_index;
+  /* The attributes as serialized for the database hash, empty until the hash
+   * is first computed with this service */
+  std::vector<uint8_t> hash_info;
 } tGATT_SVC_DB;
 
 /* Data Structure used for GATT server */
@@ -225,6 +238,16 @@ typedef uint16_t tGATT_APP_MASK;
 typedef uint32_t tGATT_APP_MASK;
 #endif
 
+/* prepared writes queued by the server, merged with the contiguous ones */
+typedef struct {
+  tGATT_IF gatt_if;
+  uint16_t handle;
+  uint16_t offset;
+  uint16_t len;
+  tGATTS_REQ_TYPE req_type; /* characteristic or descriptor write */
+  size_t buf_offset;        /* start of the value in the connection buffer */
+} tGATT_PREP_WRITE;
+
 /* command details for each connection */
 typedef struct {
   BT_HDR* p_rsp_msg;
@@ -327,11 +350,23 @@ typedef struct {
   alarm_t* conf_timer; /* peer confirm to indication timer */
 
   uint8_t prep_cnt[GATT_MAX_APPS];
+  /* Prepared writes queued until the Execute Write request, with their values
+   * stored back to back in |prep_write_buf|. The applications queue them
+   * instead when |prep_write_quota| is 0. */
+  std::vector<tGATT_PREP_WRITE> prep_write_q;
+  std::vector<uint8_t> prep_write_buf;
+  size_t prep_write_quota;
   uint8_t ind_count;
 
   std::deque<tGATT_CMD_Q> cl_cmd_q;
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
+  /* Notifications held back to be sent together */
+  std::vector<tGATT_VALUE> pending_notifs;
+  uint16_t pending_notifs_conn_id;
+  uint16_t pending_notifs_len; /* handles, lengths and values */
+  alarm_t* notif_coalescing_timer;
+
   // TODO(hylo): support byte array data
   /* Client supported feature*/
   uint8_t cl_supp_feat;
@@ -408,6 +443,12 @@ typedef struct {
   uint16_t e_handle;
 } tGATT_PROFILE_CLCB;
 
+typedef struct {
+  uint16_t s_hdl;
+  uint16_t e_hdl;
+  std::list<tGATT_SRV_LIST_ELEM>::iterator srv;
+} tGATT_SRV_HDL_RANGE;
+
 typedef struct {
   tGATT_TCB tcb[GATT_MAX_PHY_CHANNEL];
   fixed_queue_t* sign_op_queue;
@@ -418,6 +459,8 @@ typedef struct {
   tGATT_IF gatt_if;
   std::list<tGATT_HDL_LIST_ELEM>* hdl_list_info;
   std::list<tGATT_SRV_LIST_ELEM>* srv_list_info;
+  /* handle ranges of srv_list_info elements in order, for binary search */
+  std::vector<tGATT_SRV_HDL_RANGE> srv_handle_index;
 
   fixed_queue_t* srv_chg_clt_q; /* service change clients queue */
   tGATT_REG cl_rcb[GATT_MAX_APPS];
@@ -452,7 +495,10 @@ typedef struct {
   uint8_t gatt_cl_supported_feat_mask;
 
   uint16_t handle_of_database_hash;
+  /* Only valid while database_hash_dirty is false, read it with
+   * gatts_get_database_hash() */
   Octet16 database_hash;
+  bool database_hash_dirty;
 
   tGATT_APPL_INFO cb_info;
 
@@ -566,6 +612,9 @@ bool gatt_auto_connect_dev_remove(tGATT_IF gatt_if, const RawAddress& bd_addr);
 /* server function */
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle);
+std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_ending_after(
+    uint16_t handle);
+void gatt_sr_update_srv_handle_index();
 tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
                                      uint32_t trans_id, uint8_t op_code,
                                      tGATT_STATUS status, tGATTS_RSP* p_msg,
@@ -598,6 +647,8 @@ bool gatt_tcb_get_cid_available_for_indication(tGATT_TCB* p_tcb,
 bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
                                    uint16_t* indicated_handle_p);
 uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support);
+uint16_t gatt_tcb_get_att_cid_for_notification(tGATT_TCB& tcb,
+                                               bool eatt_support);
 uint16_t gatt_tcb_get_payload_size_tx(tGATT_TCB& tcb, uint16_t cid);
 uint16_t gatt_tcb_get_payload_size_rx(tGATT_TCB& tcb, uint16_t cid);
 void gatt_clcb_invalidate(tGATT_TCB* p_tcb, const tGATT_CLCB* p_clcb);
@@ -689,8 +740,12 @@ tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
                                         tGATT_SEC_FLAG sec_flag,
                                         uint8_t key_size);
 bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle);
 
 /* gatt_sr_hash.cc */
 Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr);
+/* The hash of the current database, computed when the database changed since
+ * it was last read */
+const Octet16& gatts_get_database_hash();
 
 #endif
@@ -31,6 +31,7 @@
 #include "connection_manager.h"
 #include "device/include/interop.h"
 #include "gd/common/init_flags.h"
+#include "gd/common/tracing.h"
 #include "hardware/bt_gatt_types.h"
 #include "internal_include/stack_config.h"
 #include "l2c_api.h"
@@ -183,6 +184,9 @@ void gatt_free(void) {
     alarm_free(gatt_cb.tcb[i].ind_ack_timer);
     gatt_cb.tcb[i].ind_ack_timer = NULL;
 
+    alarm_free(gatt_cb.tcb[i].notif_coalescing_timer);
+    gatt_cb.tcb[i].notif_coalescing_timer = NULL;
+
     fixed_queue_free(gatt_cb.tcb[i].sr_cmd.multi_rsp_q, NULL);
     gatt_cb.tcb[i].sr_cmd.multi_rsp_q = NULL;
 
@@ -196,6 +200,7 @@ void gatt_free(void) {
   gatt_cb.srv_list_info->clear();
   delete gatt_cb.srv_list_info;
   gatt_cb.srv_list_info = nullptr;
+  gatt_sr_update_srv_handle_index();
 
   EattExtension::GetInstance()->Stop();
 }
@@ -1007,6 +1012,7 @@ void gatt_consolidate(const RawAddress& identity_addr, const RawAddress& rpa) {
  *
  ******************************************************************************/
 void gatt_data_process(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_buf) {
+  BT_TRACE_SCOPE("att", "data_process", 0, cid);
   uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
   uint8_t op_code, pseudo_op_code;
 
@@ -342,6 +342,70 @@ tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
   return ret_code;
 }
 
+/**
+ * This function is called to execute or cancel the prepared writes queued by
+ * the server. They are replayed to their application as prepared writes
+ * followed by an execute write, and the Execute Write response waits for all
+ * the application responses.
+ */
+static void gatts_exec_prep_write_q(tGATT_TCB& tcb, uint16_t cid,
+                                    uint8_t op_code, uint8_t flag) {
+  std::vector<tGATT_PREP_WRITE> prep_write_q;
+  std::vector<uint8_t> prep_write_buf;
+  std::swap(prep_write_q, tcb.prep_write_q);
+  std::swap(prep_write_buf, tcb.prep_write_buf);
+
+  if (flag != GATT_PREP_WRITE_EXEC) {
+    /* the applications never saw the cancelled writes */
+    uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+    attp_send_sr_msg(
+        tcb, cid,
+        attp_build_sr_msg(tcb, GATT_RSP_EXEC_WRITE, NULL, payload_size));
+    return;
+  }
+
+  uint32_t trans_id = gatt_sr_enqueue_cmd(tcb, cid, op_code, 0);
+  if (trans_id == 0) {
+    LOG(ERROR) << __func__ << ": max pending command, send error";
+    gatt_send_error_rsp(tcb, cid, GATT_BUSY, op_code, 0, false);
+    return;
+  }
+
+  /* Count all the responses before the first callback, an application may
+   * respond from within it */
+  bool has_writes[GATT_MAX_APPS] = {};
+  for (const tGATT_PREP_WRITE& prep_write : prep_write_q) {
+    gatt_sr_update_cback_cnt(tcb, cid, prep_write.gatt_if, true, false);
+    has_writes[prep_write.gatt_if - 1] = true;
+  }
+  for (uint8_t i = 0; i < GATT_MAX_APPS; i++) {
+    if (has_writes[i])
+      gatt_sr_update_cback_cnt(tcb, cid, (tGATT_IF)(i + 1), true, false);
+  }
+
+  tGATTS_DATA sr_data;
+  for (const tGATT_PREP_WRITE& prep_write : prep_write_q) {
+    memset(&sr_data, 0, sizeof(tGATTS_DATA));
+    sr_data.write_req.handle = prep_write.handle;
+    sr_data.write_req.offset = prep_write.offset;
+    sr_data.write_req.len = prep_write.len;
+    memcpy(sr_data.write_req.value,
+           prep_write_buf.data() + prep_write.buf_offset, prep_write.len);
+    sr_data.write_req.need_rsp = true;
+    sr_data.write_req.is_prep = true;
+    gatt_sr_send_req_callback(
+        GATT_CREATE_CONN_ID(tcb.tcb_idx, prep_write.gatt_if), trans_id,
+        prep_write.req_type, &sr_data);
+  }
+  for (uint8_t i = 0; i < GATT_MAX_APPS; i++) {
+    if (!has_writes[i]) continue;
+    memset(&sr_data, 0, sizeof(tGATTS_DATA));
+    sr_data.exec_write = flag;
+    gatt_sr_send_req_callback(GATT_CREATE_CONN_ID(tcb.tcb_idx, i + 1),
+                              trans_id, GATTS_REQ_TYPE_WRITE_EXEC, &sr_data);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         gatt_process_exec_write_req
@@ -384,6 +448,11 @@ void gatt_process_exec_write_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
   /* mask the flag */
   flag &= GATT_PREP_WRITE_EXEC;
 
+  if (!tcb.prep_write_q.empty()) {
+    gatts_exec_prep_write_q(tcb, cid, op_code, flag);
+    return;
+  }
+
   /* no prep write is queued */
   if (!gatt_sr_is_prep_cnt_zero(tcb)) {
     trans_id = gatt_sr_enqueue_cmd(tcb, cid, op_code, 0);
@@ -602,11 +671,16 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
   uint8_t* p = (uint8_t*)(p_msg + 1) + L2CAP_MIN_OFFSET + p_msg->len;
 
-  for (auto& attr : el.p_db->attr_list) {
+  /* attributes are in handle order, skip the ones before the range */
+  auto first = std::lower_bound(el.p_db->attr_list.begin(),
+                                el.p_db->attr_list.end(), s_hdl,
+                                [](const tGATT_ATTR& attr, uint16_t handle) {
+                                  return attr.handle < handle;
+                                });
+  for (auto it = first; it != el.p_db->attr_list.end(); it++) {
+    tGATT_ATTR& attr = *it;
     if (attr.handle > e_hdl) break;
 
-    if (attr.handle < s_hdl) continue;
-
     uint8_t uuid_len = attr.uuid.GetShortestRepresentationSize();
     if (p_msg->offset == 0)
       p_msg->offset = (uuid_len == Uuid::kNumBytes16) ? GATT_INFO_TYPE_PAIR_16
@@ -774,13 +848,12 @@ static void gatts_process_find_info(tGATT_TCB& tcb, uint16_t cid,
 
   buf_len = payload_size - 2;
 
-  for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
-    if (el.s_hdl <= e_hdl && el.e_hdl >= s_hdl) {
-      reason = gatt_build_find_info_rsp(el, p_msg, buf_len, s_hdl, e_hdl);
-      if (reason == GATT_NO_RESOURCES) {
-        reason = GATT_SUCCESS;
-        break;
-      }
+  for (auto it = gatt_sr_find_first_srv_ending_after(s_hdl);
+       it != gatt_cb.srv_list_info->end() && it->s_hdl <= e_hdl; it++) {
+    reason = gatt_build_find_info_rsp(*it, p_msg, buf_len, s_hdl, e_hdl);
+    if (reason == GATT_NO_RESOURCES) {
+      reason = GATT_SUCCESS;
+      break;
     }
   }
 
@@ -912,24 +985,23 @@ static void gatts_process_read_by_type_req(tGATT_TCB& tcb, uint16_t cid,
   uint16_t buf_len = payload_size - 2;
 
   reason = GATT_NOT_FOUND;
-  for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
-    if (el.s_hdl <= e_hdl && el.e_hdl >= s_hdl) {
-      tGATT_SEC_FLAG sec_flag;
-      uint8_t key_size;
-      gatt_sr_get_sec_info(tcb.peer_bda, tcb.transport, &sec_flag, &key_size);
-
-      tGATT_STATUS ret = gatts_db_read_attr_value_by_type(
-          tcb, cid, el.p_db, op_code, p_msg, s_hdl, e_hdl, uuid, &buf_len,
-          sec_flag, key_size, 0, &err_hdl);
-      if (ret != GATT_NOT_FOUND) {
-        reason = ret;
-        if (ret == GATT_NO_RESOURCES) reason = GATT_SUCCESS;
-      }
+  for (auto it = gatt_sr_find_first_srv_ending_after(s_hdl);
+       it != gatt_cb.srv_list_info->end() && it->s_hdl <= e_hdl; it++) {
+    tGATT_SEC_FLAG sec_flag;
+    uint8_t key_size;
+    gatt_sr_get_sec_info(tcb.peer_bda, tcb.transport, &sec_flag, &key_size);
+
+    tGATT_STATUS ret = gatts_db_read_attr_value_by_type(
+        tcb, cid, it->p_db, op_code, p_msg, s_hdl, e_hdl, uuid, &buf_len,
+        sec_flag, key_size, 0, &err_hdl);
+    if (ret != GATT_NOT_FOUND) {
+      reason = ret;
+      if (ret == GATT_NO_RESOURCES) reason = GATT_SUCCESS;
+    }
 
-      if (ret != GATT_SUCCESS && ret != GATT_NOT_FOUND) {
-        s_hdl = err_hdl;
-        break;
-      }
+    if (ret != GATT_SUCCESS && ret != GATT_NOT_FOUND) {
+      s_hdl = err_hdl;
+      break;
     }
   }
   *p = (uint8_t)p_msg->offset;
@@ -949,6 +1021,71 @@ static void gatts_process_read_by_type_req(tGATT_TCB& tcb, uint16_t cid,
   attp_send_sr_msg(tcb, cid, p_msg);
 }
 
+/**
+ * This function is called to queue a prepared write until the Execute Write
+ * request, and to respond to it. A write continuing the last queued one for
+ * the same attribute is merged into it, so that a long write reaches the
+ * application in as few segments as possible.
+ */
+static tGATT_STATUS gatts_queue_prep_write(
+    tGATT_TCB& tcb, uint16_t cid, tGATT_IF gatt_if, uint16_t handle,
+    uint16_t offset, const uint8_t* p_value, uint16_t len,
+    bt_gatt_db_attribute_type_t gatt_type) {
+  tGATTS_REQ_TYPE req_type;
+  if (gatt_type == BTGATT_DB_DESCRIPTOR) {
+    req_type = GATTS_REQ_TYPE_WRITE_DESCRIPTOR;
+  } else if (gatt_type == BTGATT_DB_CHARACTERISTIC) {
+    req_type = GATTS_REQ_TYPE_WRITE_CHARACTERISTIC;
+  } else {
+    LOG(ERROR) << __func__
+               << ": Attempt to write attribute that's not tied with"
+                  " characteristic or descriptor value.";
+    return GATT_ERROR;
+  }
+
+  if (tcb.prep_write_buf.size() + len > tcb.prep_write_quota) {
+    LOG(WARNING) << __func__ << ": prepare write queue full, "
+                 << tcb.prep_write_buf.size() << " bytes queued";
+    return GATT_PREPARE_Q_FULL;
+  }
+
+  tGATT_PREP_WRITE* p_last =
+      tcb.prep_write_q.empty() ? nullptr : &tcb.prep_write_q.back();
+  if (p_last == nullptr || p_last->gatt_if != gatt_if ||
+      p_last->handle != handle || p_last->offset + p_last->len != offset ||
+      p_last->len + len > GATT_MAX_ATTR_LEN) {
+    if (tcb.prep_write_q.size() >= GATT_PREP_WRITE_MAX_SEGMENTS) {
+      LOG(WARNING) << __func__ << ": prepare write queue full, "
+                   << tcb.prep_write_q.size() << " segments queued";
+      return GATT_PREPARE_Q_FULL;
+    }
+    tcb.prep_write_q.push_back({.gatt_if = gatt_if,
+                                .handle = handle,
+                                .offset = offset,
+                                .len = 0,
+                                .req_type = req_type,
+                                .buf_offset = tcb.prep_write_buf.size()});
+    p_last = &tcb.prep_write_q.back();
+  }
+  if (len != 0) {
+    tcb.prep_write_buf.insert(tcb.prep_write_buf.end(), p_value,
+                              p_value + len);
+    p_last->len += len;
+  }
+
+  /* the response echoes the request */
+  tGATT_SR_MSG rsp;
+  rsp.attr_value.handle = handle;
+  rsp.attr_value.offset = offset;
+  rsp.attr_value.len = len;
+  if (len != 0) memcpy(rsp.attr_value.value, p_value, len);
+  uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+  attp_send_sr_msg(tcb, cid,
+                   attp_build_sr_msg(tcb, GATT_RSP_PREPARE_WRITE, &rsp,
+                                     payload_size));
+  return GATT_SUCCESS;
+}
+
 /**
  * This function is called to process the write request from client.
  */
@@ -1004,6 +1141,17 @@ static void gatts_process_write_req(tGATT_TCB& tcb, uint16_t cid,
                                        sr_data.write_req.offset, p, len,
                                        sec_flag, key_size);
 
+  if (status == GATT_SUCCESS && op_code == GATT_REQ_PREPARE_WRITE &&
+      tcb.prep_write_quota != 0) {
+    status = gatts_queue_prep_write(tcb, cid, el.gatt_if, handle,
+                                    sr_data.write_req.offset, p, len,
+                                    gatt_type);
+    if (status != GATT_SUCCESS) {
+      gatt_send_error_rsp(tcb, cid, status, op_code, handle, false);
+    }
+    return;
+  }
+
   if (status == GATT_SUCCESS) {
     trans_id = gatt_sr_enqueue_cmd(tcb, cid, op_code, handle);
     if (trans_id != 0) {
@@ -1131,35 +1279,32 @@ void gatts_process_attribute_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
 #endif
 
   if (GATT_HANDLE_IS_VALID(handle)) {
-    for (auto& el : *gatt_cb.srv_list_info) {
-      if (el.s_hdl <= handle && el.e_hdl >= handle) {
-        for (const auto& attr : el.p_db->attr_list) {
-          if (attr.handle == handle) {
-            switch (op_code) {
-              case GATT_REQ_READ: /* read char/char descriptor value */
-              case GATT_REQ_READ_BLOB:
-                gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
-                break;
-
-              case GATT_REQ_WRITE: /* write char/char descriptor value */
-              case GATT_CMD_WRITE:
-              case GATT_SIGN_CMD_WRITE:
-              case GATT_REQ_PREPARE_WRITE:
-                gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
-                                        attr.gatt_type);
-                break;
-              default:
-                break;
-            }
-            status = GATT_SUCCESS;
-            break;
-          }
-        }
-        break;
+    auto it = gatt_sr_find_i_rcb_by_handle(handle);
+    tGATT_ATTR* p_attr = it != gatt_cb.srv_list_info->end()
+                             ? find_attr_by_handle(it->p_db, handle)
+                             : nullptr;
+    if (p_attr != nullptr) {
+      switch (op_code) {
+        case GATT_REQ_READ: /* read char/char descriptor value */
+        case GATT_REQ_READ_BLOB:
+          gatts_process_read_req(tcb, cid, *it, op_code, handle, len, p);
+          break;
+
+        case GATT_REQ_WRITE: /* write char/char descriptor value */
+        case GATT_CMD_WRITE:
+        case GATT_SIGN_CMD_WRITE:
+        case GATT_REQ_PREPARE_WRITE:
+          gatts_process_write_req(tcb, cid, *it, handle, op_code, len, p,
+                                  p_attr->gatt_type);
+          break;
+        default:
+          break;
       }
+      status = GATT_SUCCESS;
     }
   }
 
+
   if (status != GATT_SUCCESS && op_code != GATT_CMD_WRITE &&
       op_code != GATT_SIGN_CMD_WRITE)
     gatt_send_error_rsp(tcb, cid, status, op_code, handle, false);
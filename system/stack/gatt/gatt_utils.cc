@@ -26,12 +26,14 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 #include "rust/src/connection/ffi/connection_shim.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/eatt/eatt.h"
@@ -447,6 +449,7 @@ tGATT_TCB* gatt_allocate_tcb_by_bdaddr(const RawAddress& bda,
     p_tcb->pending_ind_q = fixed_queue_new(SIZE_MAX);
     p_tcb->conf_timer = alarm_new("gatt.conf_timer");
     p_tcb->ind_ack_timer = alarm_new("gatt.ind_ack_timer");
+    p_tcb->notif_coalescing_timer = alarm_new("gatt.notif_coalescing_timer");
     p_tcb->in_use = true;
     p_tcb->tcb_idx = i;
     p_tcb->transport = transport;
@@ -455,6 +458,9 @@ tGATT_TCB* gatt_allocate_tcb_by_bdaddr(const RawAddress& bda,
     p_tcb->pending_user_mtu_exchange_value = 0;
     p_tcb->conn_ids_waiting_for_mtu_exchange = std::list<uint16_t>();
     p_tcb->max_user_mtu = 0;
+    p_tcb->prep_write_quota = osi_property_get_int32(
+        "bluetooth.gatt.server.prepare_write_queue_quota",
+        GATT_PREP_WRITE_DEFAULT_QUOTA);
     gatt_sr_init_cl_status(*p_tcb);
     gatt_cl_init_sr_status(*p_tcb);
 
@@ -772,15 +778,49 @@ void  gatt_ind_ack_timeout(void* data) {
  ******************************************************************************/
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle) {
-  auto it = gatt_cb.srv_list_info->begin();
-
-  for (; it != gatt_cb.srv_list_info->end(); it++) {
-    if (it->s_hdl <= handle && it->e_hdl >= handle) {
-      return it;
-    }
+  auto it = gatt_sr_find_first_srv_ending_after(handle);
+  if (it != gatt_cb.srv_list_info->end() && it->s_hdl <= handle) {
+    return it;
   }
 
-  return it;
+  return gatt_cb.srv_list_info->end();
+}
+
+/*******************************************************************************
+ *
+ * Description      Search for the first service whose handle range ends at or
+ *                  after a specific handle. Services do not overlap, the
+ *                  following services in the list are after the handle too.
+ *
+ * Returns          srv_list_info end if not found. Otherwise the service.
+ *
+ ******************************************************************************/
+std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_ending_after(
+    uint16_t handle) {
+  const auto& index = gatt_cb.srv_handle_index;
+  auto it = std::lower_bound(index.begin(), index.end(), handle,
+                             [](const tGATT_SRV_HDL_RANGE& range, uint16_t h) {
+                               return range.e_hdl < h;
+                             });
+
+  return it == index.end() ? gatt_cb.srv_list_info->end() : it->srv;
+}
+
+/*******************************************************************************
+ *
+ * Description      Rebuild the handle index of the started services, must be
+ *                  called whenever srv_list_info is modified.
+ *
+ ******************************************************************************/
+void gatt_sr_update_srv_handle_index() {
+  gatt_cb.srv_handle_index.clear();
+  if (gatt_cb.srv_list_info == nullptr) return;
+
+  /* srv_list_info is kept sorted by start handle */
+  for (auto it = gatt_cb.srv_list_info->begin();
+       it != gatt_cb.srv_list_info->end(); it++) {
+    gatt_cb.srv_handle_index.push_back({it->s_hdl, it->e_hdl, it});
+  }
 }
 
 /*******************************************************************************
@@ -1117,6 +1157,30 @@ uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
   return tcb.att_lcid;
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_get_att_cid_for_notification
+ *
+ * Description      This function gets cid to send a notification on. Unlike
+ *                  requests, notifications are spread over all open EATT
+ *                  channels.
+ *
+ * Returns          Available CID
+ *
+ ******************************************************************************/
+uint16_t gatt_tcb_get_att_cid_for_notification(tGATT_TCB& tcb,
+                                               bool eatt_support) {
+  if (eatt_support && tcb.eatt) {
+    EattChannel* channel =
+        EattExtension::GetInstance()->GetChannelAvailableForNotification(
+            tcb.peer_bda);
+    if (channel) {
+      return channel->cid_;
+    }
+  }
+  return tcb.att_lcid;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_tcb_get_payload_size_tx
@@ -1722,6 +1786,11 @@ void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
   p_tcb->ind_ack_timer = NULL;
   alarm_free(p_tcb->conf_timer);
   p_tcb->conf_timer = NULL;
+  alarm_free(p_tcb->notif_coalescing_timer);
+  p_tcb->notif_coalescing_timer = NULL;
+  p_tcb->pending_notifs.clear();
+  p_tcb->prep_write_q.clear();
+  p_tcb->prep_write_buf = std::vector<uint8_t>();
   gatt_free_pending_ind(p_tcb);
   fixed_queue_free(p_tcb->sr_cmd.multi_rsp_q, NULL);
   p_tcb->sr_cmd.multi_rsp_q = NULL;
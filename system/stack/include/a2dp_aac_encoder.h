@@ -80,4 +80,10 @@ int a2dp_aac_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_aac_send_frames(uint64_t timestamp_us);
 
+// Set transmit queue length for the A2DP AAC adaptive bit rate.
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length);
+
+// Set the link quality for the A2DP AAC adaptive bit rate.
+void a2dp_aac_set_link_quality(const tA2DP_LINK_QUALITY* p_link_quality);
+
 #endif  // A2DP_AAC_ENCODER_H
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+//
+// Codec-agnostic adaptive bit rate controller for the A2DP Source encoders.
+//
+// The controller picks a target rate between a minimum and a maximum, in the
+// units of the encoder using it (e.g. SBC bitpool or AAC bits per second).
+// The rate is stepped down when the TX queue keeps growing, when packets are
+// dropped on TX queue overrun or when the Failed Contact Counter of the link
+// increases. It is stepped back up once the TX queue stayed short for a while
+// and the RSSI of the link is not too low.
+//
+
+#ifndef A2DP_BITRATE_CONTROLLER_H
+#define A2DP_BITRATE_CONTROLLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "a2dp_codec_api.h"
+
+typedef struct {
+  bool enabled;          // True if the adaptive bit rate is enabled
+  uint32_t min_rate;     // The minimum rate
+  uint32_t max_rate;     // The maximum rate, used at the session start
+  uint32_t step;         // The rate step
+  uint32_t target_rate;  // The current target rate
+
+  uint32_t congested_ticks;    // Consecutive ticks with a long TX queue
+  uint32_t uncongested_ticks;  // Consecutive ticks with a short TX queue
+  uint32_t increase_ticks;     // Uncongested ticks before an increase
+
+  tA2DP_LINK_QUALITY link_quality;  // The last link quality reported
+
+  // Statistics
+  size_t total_decreases;
+  size_t total_increases;
+  uint64_t last_change_us;
+} tA2DP_BITRATE_CONTROLLER;
+
+// Initializes the adaptive bit rate controller |p_controller|.
+// |min_rate| and |max_rate| are the bounds of the target rate, which starts
+// at |max_rate| and moves by |step|. |encoder_interval_ms| is the interval
+// between two TX queue length updates.
+void a2dp_bitrate_controller_init(tA2DP_BITRATE_CONTROLLER* p_controller,
+                                  uint32_t min_rate, uint32_t max_rate,
+                                  uint32_t step, uint64_t encoder_interval_ms);
+
+// Updates |p_controller| with the current TX queue length.
+// Returns true if the target rate changed.
+bool a2dp_bitrate_controller_set_transmit_queue_length(
+    tA2DP_BITRATE_CONTROLLER* p_controller, size_t transmit_queue_length);
+
+// Updates |p_controller| with the current link quality.
+// Returns true if the target rate changed.
+bool a2dp_bitrate_controller_set_link_quality(
+    tA2DP_BITRATE_CONTROLLER* p_controller,
+    const tA2DP_LINK_QUALITY* p_link_quality);
+
+// Dumps the state of |p_controller| to the file descriptor |fd|.
+void a2dp_bitrate_controller_debug_dump(
+    const tA2DP_BITRATE_CONTROLLER* p_controller, int fd);
+
+#endif  // A2DP_BITRATE_CONTROLLER_H
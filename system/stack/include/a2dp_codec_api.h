@@ -120,6 +120,11 @@ class A2dpCodecConfig {
   // or 0 if not configured.
   uint8_t getAudioBitsPerSample();
 
+  // Gets the TX latency budget of the encoded audio data (in milliseconds).
+  // The packets that waited longer than the budget before being sent are
+  // dropped. Returns 0 if no budget is set.
+  uint64_t getTxLatencyBudgetMs() const { return tx_latency_budget_ms_; }
+
   // Checks whether the codec uses the RTP Header Marker bit (see RFC 6416).
   // NOTE: Even if the encoded data uses RTP headers, some codecs do not use
   // the Marker bit - that bit is expected to be set to 0.
@@ -258,6 +263,8 @@ class A2dpCodecConfig {
   uint8_t ota_codec_config_[AVDT_CODEC_SIZE];
   uint8_t ota_codec_peer_capability_[AVDT_CODEC_SIZE];
   uint8_t ota_codec_peer_config_[AVDT_CODEC_SIZE];
+
+  uint64_t tx_latency_budget_ms_;  // TX latency budget, or 0 if not set
 };
 
 class A2dpCodecs {
@@ -486,6 +493,18 @@ typedef uint32_t (*a2dp_source_read_callback_t)(uint8_t* p_buf, uint32_t len);
 typedef bool (*a2dp_source_enqueue_callback_t)(BT_HDR* p_buf, size_t frames_n,
                                                uint32_t num_bytes);
 
+/**
+ * Structure used to report the A2DP link quality to the encoder.
+ * The counters are cumulative since the audio session was started.
+ */
+typedef struct {
+  size_t tx_queue_dropped_messages;  // Packets dropped on TX queue overrun
+  bool rssi_valid;                   // True if |rssi| was read
+  int8_t rssi;                       // Last RSSI read (in dBm)
+  bool failed_contact_counter_valid;  // True if |failed_contact_counter| read
+  uint16_t failed_contact_counter;    // Last Failed Contact Counter read
+} tA2DP_LINK_QUALITY;
+
 //
 // A2DP encoder callbacks interface.
 //
@@ -521,6 +540,10 @@ typedef struct {
 
   // Set transmit queue length for the A2DP encoder.
   void (*set_transmit_queue_length)(size_t transmit_queue_length);
+
+  // Set the link quality for the A2DP encoder.
+  // |p_link_quality| is the current link quality of the A2DP peer.
+  void (*set_link_quality)(const tA2DP_LINK_QUALITY* p_link_quality);
 } tA2DP_ENCODER_INTERFACE;
 
 // Prototype for a callback to receive decoded audio data from a
@@ -673,6 +696,13 @@ bool A2DP_GetPacketTimestamp(const uint8_t* p_codec_info, const uint8_t* p_data,
 bool A2DP_BuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
                            uint16_t frames_per_packet);
 
+// Allocates an empty media packet for an encoder to write its payload into.
+// |offset| is where the payload starts. It must include |AVDT_MEDIA_OFFSET|
+// and the codec's own media payload header, so that the codec header, the
+// AVDTP media header and the L2CAP and HCI headers can all be prepended in
+// place without copying the payload.
+BT_HDR* A2DP_AllocMediaPacket(uint16_t offset);
+
 // Gets the A2DP encoder interface that can be used to encode and prepare
 // A2DP packets for transmission - see |tA2DP_ENCODER_INTERFACE|.
 // |p_codec_info| contains the codec information.
@@ -0,0 +1,77 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+//
+// Codec-agnostic adaptive complexity controller for the A2DP Source encoders.
+//
+// The controller measures the time taken to encode each frame and picks the
+// encoder complexity that keeps it under a budget, a fraction of the frame
+// duration. The complexity is stepped down when the average encode time stays
+// over the budget, so that the media tick does not fall behind on loaded or
+// slow CPUs. It is stepped back up once the encode time stayed well under the
+// budget for a while, and waits longer after each decrease so that the
+// complexity does not keep bouncing around the highest sustainable one.
+//
+
+#ifndef A2DP_COMPLEXITY_CONTROLLER_H
+#define A2DP_COMPLEXITY_CONTROLLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+  bool enabled;             // True if the adaptive complexity is enabled
+  uint32_t min_complexity;  // The minimum complexity
+  uint32_t max_complexity;  // The maximum complexity, used at session start
+  uint32_t complexity;      // The current complexity
+  uint32_t budget_us;       // The encode time budget of a frame
+
+  uint32_t average_encode_us;    // Moving average of the frame encode time
+  bool has_average;              // False until a frame was measured
+  uint32_t over_budget_frames;   // Consecutive frames over the budget
+  uint32_t under_budget_frames;  // Consecutive frames well under the budget
+  uint32_t increase_frames;      // Frames well under budget before increase
+  uint32_t increase_backoff;     // Multiplier of |increase_frames|
+
+  // Statistics
+  size_t total_frames;
+  uint32_t max_encode_us;
+  size_t total_decreases;
+  size_t total_increases;
+  uint64_t last_change_us;
+} tA2DP_COMPLEXITY_CONTROLLER;
+
+// Initializes the adaptive complexity controller |p_controller|.
+// |min_complexity| and |max_complexity| are the bounds of the complexity,
+// which starts at |max_complexity|. |frame_duration_us| is the duration of
+// the audio in one encoded frame.
+void a2dp_complexity_controller_init(tA2DP_COMPLEXITY_CONTROLLER* p_controller,
+                                     uint32_t min_complexity,
+                                     uint32_t max_complexity,
+                                     uint32_t frame_duration_us);
+
+// Updates |p_controller| with the time taken to encode one frame.
+// Returns true if the complexity changed.
+bool a2dp_complexity_controller_on_frame_encoded(
+    tA2DP_COMPLEXITY_CONTROLLER* p_controller, uint32_t encode_time_us);
+
+// Dumps the state of |p_controller| to the file descriptor |fd|.
+void a2dp_complexity_controller_debug_dump(
+    const tA2DP_COMPLEXITY_CONTROLLER* p_controller, int fd);
+
+#endif  // A2DP_COMPLEXITY_CONTROLLER_H
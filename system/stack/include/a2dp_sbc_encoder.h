@@ -68,4 +68,11 @@ void a2dp_sbc_send_frames(uint64_t timestamp_us);
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
+
+// Set transmit queue length for the A2DP SBC adaptive bit rate.
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length);
+
+// Set the link quality for the A2DP SBC adaptive bit rate.
+void a2dp_sbc_set_link_quality(const tA2DP_LINK_QUALITY* p_link_quality);
+
 #endif  // A2DP_SBC_ENCODER_H
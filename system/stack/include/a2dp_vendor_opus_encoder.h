@@ -53,6 +53,10 @@ void a2dp_vendor_opus_send_frames(uint64_t timestamp_us);
 // Set transmit queue length for the A2DP Opus (Dynamic Bit Rate) mechanism.
 void a2dp_vendor_opus_set_transmit_queue_length(size_t transmit_queue_length);
 
+// Set the link quality for the A2DP Opus (Dynamic Bit Rate) mechanism.
+void a2dp_vendor_opus_set_link_quality(
+    const tA2DP_LINK_QUALITY* p_link_quality);
+
 // Get the A2DP Opus encoded maximum frame size
 int a2dp_vendor_opus_get_effective_frame_size();
 
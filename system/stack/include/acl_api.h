@@ -300,6 +300,8 @@ void acl_disconnect_after_role_switch(uint16_t conn_handle, tHCI_STATUS reason,
                                       std::string comment);
 
 bool acl_peer_supports_sniff_subrating(const RawAddress& remote_bda);
+bool acl_get_traffic_stats(const RawAddress& remote_bda,
+                           tACL_TRAFFIC_STATS* p_stats);
 bool acl_peer_supports_ble_connection_subrating(const RawAddress& remote_bda);
 bool acl_peer_supports_ble_connection_subrating_host(
     const RawAddress& remote_bda);
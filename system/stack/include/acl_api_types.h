@@ -86,6 +86,20 @@ typedef struct {
   uint8_t link_quality;
 } tBTM_LINK_QUALITY_RESULT;
 
+/* Traffic statistics of a BR/EDR ACL link, returned by acl_get_traffic_stats.
+ * Packets closer together than ACL_TRAFFIC_MIN_IDLE_GAP_MS belong to the same
+ * burst; the idle gaps between bursts are smoothed like round trip times
+ * (RFC 6298), giving their mean and mean deviation.
+ */
+#define ACL_TRAFFIC_MIN_IDLE_GAP_MS 100
+#define ACL_TRAFFIC_MAX_IDLE_GAP_MS 60000
+typedef struct {
+  uint64_t last_packet_ms; /* boottime of the last packet, 0 if none */
+  uint32_t idle_gap_ms;
+  uint32_t idle_gap_var_ms;
+  uint32_t num_idle_gaps;
+} tACL_TRAFFIC_STATS;
+
 #define BTM_INQUIRY_STARTED 1
 #define BTM_INQUIRY_CANCELLED 2
 #define BTM_INQUIRY_COMPLETE 3
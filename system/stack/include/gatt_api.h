@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
@@ -942,6 +943,23 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
                                            uint16_t attr_handle,
                                            uint16_t val_len, uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotifications
+ *
+ * Description      This function sends handle value notifications to a client,
+ *                  batched in multiple handle value notifications when the
+ *                  client supports them.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  notifs: handles and values to notify.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleMultipleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1114,6 +1132,37 @@ tGATT_STATUS GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
  ******************************************************************************/
 tGATT_STATUS GATTC_SendHandleValueConfirm(uint16_t conn_id, uint16_t handle);
 
+/*******************************************************************************
+ *
+ * Function         GATTC_GetNumberOfBearers
+ *
+ * Description      This function returns the number of ATT bearers the client
+ *                  requests of a connection can be sent on: the fixed ATT
+ *                  channel, and the opened EATT channels if the client
+ *                  registered with EATT support.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          number of bearers, 0 if the connection is unknown.
+ *
+ ******************************************************************************/
+uint8_t GATTC_GetNumberOfBearers(uint16_t conn_id);
+
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultipleVarLenSupported
+ *
+ * Description      This function checks if the server of a connection supports
+ *                  the Read Multiple Variable Length procedure. Servers that
+ *                  support EATT have to support it.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if the procedure is supported.
+ *
+ ******************************************************************************/
+bool GATTC_IsReadMultipleVarLenSupported(uint16_t conn_id);
+
 /*******************************************************************************
  *
  * Function         GATT_SetIdleTimeout
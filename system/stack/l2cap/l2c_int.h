@@ -210,6 +210,11 @@ typedef enum : uint16_t {
 #define LE_DYNAMIC_PSM_END 0x00FF
 #define LE_DYNAMIC_PSM_RANGE (LE_DYNAMIC_PSM_END - LE_DYNAMIC_PSM_START + 1)
 
+/* HCI connection handles are 12 bits wide */
+#define L2C_LCB_HANDLE_TABLE_SIZE 0x1000
+static_assert(MAX_L2CAP_LINKS < 0xFF,
+              "LCB pool indexes must fit tL2C_CB::lcb_by_handle");
+
 /* Return values for l2cu_process_peer_cfg_req() */
 #define L2CAP_PEER_CFG_UNACCEPTABLE 0
 #define L2CAP_PEER_CFG_OK 1
@@ -612,6 +617,9 @@ typedef struct {
   tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];    /* Link Control Block pool */
   tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
   tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
+  /* Index + 1 in |lcb_pool| of the LCB last given each HCI handle, 0 if none.
+   * Looked up by l2cu_find_lcb_by_handle() for every received packet */
+  uint8_t lcb_by_handle[L2C_LCB_HANDLE_TABLE_SIZE];
 
   tL2C_CCB* p_free_ccb_first; /* Pointer to first free CCB */
   tL2C_CCB* p_free_ccb_last;  /* Pointer to last  free CCB */
@@ -108,6 +108,12 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
              p_lcb.Handle(), handle);
   }
   p_lcb.SetHandle(handle);
+
+  const ptrdiff_t index = &p_lcb - l2cb.lcb_pool;
+  if (handle < L2C_LCB_HANDLE_TABLE_SIZE && index >= 0 &&
+      index < MAX_L2CAP_LINKS) {
+    l2cb.lcb_by_handle[handle] = static_cast<uint8_t>(index + 1);
+  }
 }
 
 /*******************************************************************************
@@ -152,6 +158,10 @@ void l2cu_update_lcb_4_bonding(const RawAddress& p_bd_addr, bool is_bonding) {
 void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   tL2C_CCB* p_ccb;
 
+  if (p_lcb->Handle() < L2C_LCB_HANDLE_TABLE_SIZE &&
+      l2cb.lcb_by_handle[p_lcb->Handle()] == (p_lcb - l2cb.lcb_pool) + 1) {
+    l2cb.lcb_by_handle[p_lcb->Handle()] = 0;
+  }
   p_lcb->in_use = false;
   p_lcb->ResetBonding();
 
@@ -3374,7 +3384,15 @@ void l2cu_send_peer_ble_credit_based_disconn_req(tL2C_CCB* p_ccb) {
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle) {
   int xx;
-  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  tL2C_LCB* p_lcb;
+
+  /* The table entry may be stale if the handle was invalidated since */
+  if (handle < L2C_LCB_HANDLE_TABLE_SIZE && l2cb.lcb_by_handle[handle] != 0) {
+    p_lcb = &l2cb.lcb_pool[l2cb.lcb_by_handle[handle] - 1];
+    if (p_lcb->in_use && p_lcb->Handle() == handle) return (p_lcb);
+  }
+
+  p_lcb = &l2cb.lcb_pool[0];
 
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
     if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
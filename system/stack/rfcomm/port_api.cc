@@ -28,6 +28,7 @@
 
 #include <base/logging.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "osi/include/allocator.h"
@@ -926,41 +927,37 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
   if (available == 0) return PORT_SUCCESS;
   /* Length for each buffer is the smaller of GKI buffer, peer MTU, or max_len
    */
-  length = RFCOMM_DATA_BUF_SIZE -
-           (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + RFCOMM_DATA_OVERHEAD);
+  length = PORT_TX_BUF_DATA_SIZE;
 
-  /* If there are buffers scheduled for transmission check if requested */
-  /* data fits into the end of the queue */
+  /* If there are buffers scheduled for transmission top up the last one, so
+   * that several small writes leave as a single UIH frame and credit */
   mutex_global_lock();
 
   p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
-  if ((p_buf != NULL) &&
-      (((int)p_buf->len + available) <= (int)p_port->peer_mtu) &&
-      (((int)p_buf->len + available) <= (int)length)) {
-    // if(recv(fd, (uint8_t *)(p_buf + 1) + p_buf->offset + p_buf->len,
-    // available, 0) != available)
-    if (!p_port->p_data_co_callback(
-            handle, (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len,
-            available, DATA_CO_CALLBACK_TYPE_OUTGOING))
-
-    {
-      error(
-          "p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING failed, "
-          "available:%d",
-          available);
+  if (p_buf != NULL) {
+    int fill = std::min((int)p_port->peer_mtu, (int)length) - (int)p_buf->len;
+    if (fill > available) fill = available;
+    if (fill > 0) {
+      if (!p_port->p_data_co_callback(
+              handle, (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len, fill,
+              DATA_CO_CALLBACK_TYPE_OUTGOING)) {
+        error(
+            "p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING failed, "
+            "available:%d",
+            fill);
+        mutex_global_unlock();
+        return (PORT_UNKNOWN_ERROR);
+      }
+      p_port->tx.queue_size += (uint16_t)fill;
+
+      *p_len = fill;
+      p_buf->len += (uint16_t)fill;
+      available -= fill;
+    }
+    if (available == 0) {
       mutex_global_unlock();
-      return (PORT_UNKNOWN_ERROR);
+      return (PORT_SUCCESS);
     }
-    // memcpy ((uint8_t *)(p_buf + 1) + p_buf->offset + p_buf->len, p_data,
-    // max_len);
-    p_port->tx.queue_size += (uint16_t)available;
-
-    *p_len = available;
-    p_buf->len += (uint16_t)available;
-
-    mutex_global_unlock();
-
-    return (PORT_SUCCESS);
   }
 
   mutex_global_unlock();
@@ -1077,25 +1074,29 @@ int PORT_WriteData(uint16_t handle, const char* p_data, uint16_t max_len,
 
   /* Length for each buffer is the smaller of GKI buffer, peer MTU, or max_len
    */
-  length = RFCOMM_DATA_BUF_SIZE -
-           (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + RFCOMM_DATA_OVERHEAD);
+  length = PORT_TX_BUF_DATA_SIZE;
 
-  /* If there are buffers scheduled for transmission check if requested */
-  /* data fits into the end of the queue */
+  /* If there are buffers scheduled for transmission top up the last one, so
+   * that several small writes leave as a single UIH frame and credit */
   mutex_global_lock();
 
   p_buf = (BT_HDR*)fixed_queue_try_peek_last(p_port->tx.queue);
-  if ((p_buf != NULL) && ((p_buf->len + max_len) <= p_port->peer_mtu) &&
-      ((p_buf->len + max_len) <= length)) {
-    memcpy((uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len, p_data, max_len);
-    p_port->tx.queue_size += max_len;
-
-    *p_len = max_len;
-    p_buf->len += max_len;
-
-    mutex_global_unlock();
-
-    return (PORT_SUCCESS);
+  if (p_buf != NULL) {
+    int fill = std::min((int)p_port->peer_mtu, (int)length) - (int)p_buf->len;
+    if (fill > max_len) fill = max_len;
+    if (fill > 0) {
+      memcpy((uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len, p_data, fill);
+      p_port->tx.queue_size += fill;
+
+      *p_len = fill;
+      p_buf->len += fill;
+      p_data += fill;
+      max_len -= fill;
+    }
+    if (max_len == 0) {
+      mutex_global_unlock();
+      return (PORT_SUCCESS);
+    }
   }
 
   mutex_global_unlock();
@@ -52,6 +52,13 @@ typedef struct {
   tPORT_CALLBACK* p_callback; /* Address of the callback function */
 } tPORT_DATA;
 
+/* Payload capacity of a tx queue buffer. Data buffers are allocated as
+ * RFCOMM_DATA_BUF_SIZE with headroom for the L2CAP and UIH headers, so the
+ * frame is later built in place. */
+#define PORT_TX_BUF_DATA_SIZE                           \
+  (RFCOMM_DATA_BUF_SIZE - (uint16_t)(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + \
+                                     RFCOMM_DATA_OVERHEAD))
+
 /*
  * Port control structure used to pass modem info
 */
@@ -27,6 +27,7 @@
 #include <base/logging.h>
 #include <frameworks/proto_logging/stats/enums/bluetooth/enums.pb.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -927,6 +928,34 @@ void PORT_FlowInd(tRFC_MCB* p_mcb, uint8_t dlci, bool enable_data) {
  * Description      This function is when forward data can be sent to the peer
  *
  ******************************************************************************/
+/*******************************************************************************
+ *
+ * Function         port_rfc_coalesce_tx_data
+ *
+ * Description      Appends the data of the following tx queue buffers to
+ *                  |p_buf| while it still fits a single UIH frame, so data
+ *                  that queued up while waiting for credits is sent with one
+ *                  credit per peer MTU rather than one per write.
+ *                  Must be called with the global mutex held.
+ *
+ ******************************************************************************/
+static void port_rfc_coalesce_tx_data(tPORT* p_port, BT_HDR* p_buf) {
+  uint16_t max_len =
+      std::min<uint16_t>(p_port->peer_mtu, PORT_TX_BUF_DATA_SIZE);
+  BT_HDR* p_next;
+
+  while ((p_next = (BT_HDR*)fixed_queue_try_peek_first(p_port->tx.queue)) !=
+             NULL &&
+         p_buf->len + p_next->len <= max_len) {
+    fixed_queue_try_dequeue(p_port->tx.queue);
+    memcpy((uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len,
+           (uint8_t*)(p_next + 1) + p_next->offset, p_next->len);
+    p_buf->len += p_next->len;
+    p_port->tx.queue_size -= p_next->len;
+    osi_free(p_next);
+  }
+}
+
 uint32_t port_rfc_send_tx_data(tPORT* p_port) {
   uint32_t events = 0;
   BT_HDR* p_buf;
@@ -942,6 +971,7 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
       p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue);
       if (p_buf != NULL) {
         p_port->tx.queue_size -= p_buf->len;
+        port_rfc_coalesce_tx_data(p_port, p_buf);
 
         mutex_global_unlock();
 
@@ -169,6 +169,9 @@ bool SDP_ServiceSearchAttributeRequest(const RawAddress& p_bd_addr,
                                        tSDP_DISC_CMPL_CB* p_cb) {
   tCONN_CB* p_ccb;
 
+  if (sdp_cache_start_search_attr(p_bd_addr, p_db, p_cb, nullptr, nullptr))
+    return (true);
+
   /* Specific BD address */
   p_ccb = sdp_conn_originate(p_bd_addr);
 
@@ -202,6 +205,9 @@ bool SDP_ServiceSearchAttributeRequest2(const RawAddress& p_bd_addr,
                                         const void* user_data) {
   tCONN_CB* p_ccb;
 
+  if (sdp_cache_start_search_attr(p_bd_addr, p_db, nullptr, p_cb2, user_data))
+    return (true);
+
   /* Specific BD address */
   p_ccb = sdp_conn_originate(p_bd_addr);
 
@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  This file contains the cache of ServiceSearchAttribute responses. Complete
+ *  attribute lists received from a peer are stored in the device config, keyed
+ *  by the UUID and attribute filters of the request, and replayed into the
+ *  caller's discovery database while they are younger than
+ *  SDP_CACHE_TTL_SECONDS.
+ *
+ ******************************************************************************/
+
+#include <base/strings/stringprintf.h>
+#include <time.h>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bt_target.h"
+#include "btif/include/btif_config.h"
+#include "osi/include/alarm.h"
+#include "osi/include/allocator.h"
+#include "osi/include/log.h"
+#include "stack/include/sdp_api.h"
+#include "stack/sdp/sdpint.h"
+#include "types/raw_address.h"
+
+/* Blob layout: version, 8 byte store time, 2 byte filter length, filter, and
+ * the attribute lists of the response */
+#define SDP_CACHE_VERSION 1
+#define SDP_CACHE_HEADER_LEN (1 + 8 + 2)
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_filter
+ *
+ * Description      Serializes the UUID and attribute filters of a discovery
+ *                  database, which identify the cached request.
+ *
+ * Returns          the filter bytes
+ *
+ ******************************************************************************/
+static std::vector<uint8_t> sdp_cache_filter(const tSDP_DISCOVERY_DB* p_db) {
+  std::vector<uint8_t> filter;
+
+  filter.push_back((uint8_t)p_db->num_uuid_filters);
+  for (uint16_t xx = 0; xx < p_db->num_uuid_filters; xx++) {
+    const auto& uuid = p_db->uuid_filters[xx].To128BitBE();
+    filter.insert(filter.end(), uuid.begin(), uuid.end());
+  }
+  filter.push_back((uint8_t)p_db->num_attr_filters);
+  for (uint16_t xx = 0; xx < p_db->num_attr_filters; xx++) {
+    uint32_t attr = p_db->attr_filters[xx];
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      filter.push_back((uint8_t)(attr >> shift));
+    }
+  }
+  return filter;
+}
+
+static std::string sdp_cache_key(const std::vector<uint8_t>& filter) {
+  size_t hash = std::hash<std::string>{}(
+      std::string(filter.begin(), filter.end()));
+  return base::StringPrintf("SdpCache%08x", (uint32_t)hash);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_find
+ *
+ * Description      Looks up a fresh cached response of |bd_addr| for the
+ *                  filters of |p_db|.
+ *
+ * Returns          true and the attribute lists in |p_rsp| if found
+ *
+ ******************************************************************************/
+static bool sdp_cache_find(const RawAddress& bd_addr,
+                           const tSDP_DISCOVERY_DB* p_db,
+                           std::vector<uint8_t>* p_rsp) {
+  if (SDP_CACHE_TTL_SECONDS == 0) return false;
+
+  std::vector<uint8_t> filter = sdp_cache_filter(p_db);
+  std::string section = bd_addr.ToString();
+  std::string key = sdp_cache_key(filter);
+
+  size_t length = btif_config_get_bin_length(section, key);
+  if (length <= SDP_CACHE_HEADER_LEN + filter.size() ||
+      length > SDP_CACHE_HEADER_LEN + filter.size() + SDP_MAX_LIST_BYTE_COUNT)
+    return false;
+
+  std::vector<uint8_t> blob(length);
+  if (!btif_config_get_bin(section, key, blob.data(), &length)) return false;
+
+  const uint8_t* p = blob.data();
+  if (*p++ != SDP_CACHE_VERSION) return false;
+
+  uint64_t stored = 0;
+  for (int xx = 0; xx < 8; xx++) stored = (stored << 8) | *p++;
+  uint16_t filter_len = (p[0] << 8) | p[1];
+  p += 2;
+
+  /* Different requests may share a key, the filter tells them apart */
+  if (filter_len != filter.size() ||
+      memcmp(p, filter.data(), filter_len) != 0)
+    return false;
+  p += filter_len;
+
+  uint64_t now = (uint64_t)time(nullptr);
+  if (now < stored || now - stored > SDP_CACHE_TTL_SECONDS) {
+    LOG_DEBUG("Cached SDP response of %s expired",
+              ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
+    btif_config_remove(section, key);
+    return false;
+  }
+
+  const uint8_t* p_end = blob.data() + length;
+  p_rsp->assign(p, p_end);
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_store
+ *
+ * Description      Stores the complete attribute lists of a successful
+ *                  ServiceSearchAttribute request.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_store(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db,
+                     const uint8_t* p_rsp, uint32_t rsp_len) {
+  if (SDP_CACHE_TTL_SECONDS == 0 || rsp_len == 0 ||
+      rsp_len > SDP_MAX_LIST_BYTE_COUNT)
+    return;
+
+  std::vector<uint8_t> filter = sdp_cache_filter(p_db);
+  std::vector<uint8_t> blob;
+  blob.reserve(SDP_CACHE_HEADER_LEN + filter.size() + rsp_len);
+
+  blob.push_back(SDP_CACHE_VERSION);
+  uint64_t now = (uint64_t)time(nullptr);
+  for (int shift = 56; shift >= 0; shift -= 8) {
+    blob.push_back((uint8_t)(now >> shift));
+  }
+  blob.push_back((uint8_t)(filter.size() >> 8));
+  blob.push_back((uint8_t)filter.size());
+  blob.insert(blob.end(), filter.begin(), filter.end());
+  blob.insert(blob.end(), p_rsp, p_rsp + rsp_len);
+
+  btif_config_set_bin(bd_addr.ToString(), sdp_cache_key(filter), blob.data(),
+                      blob.size());
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_remove
+ *
+ * Description      Drops the cached response of |bd_addr| for the filters of
+ *                  |p_db|, e.g. when it could not be parsed into the database.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_cache_remove(const RawAddress& bd_addr,
+                      const tSDP_DISCOVERY_DB* p_db) {
+  btif_config_remove(bd_addr.ToString(),
+                     sdp_cache_key(sdp_cache_filter(p_db)));
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_cache_start_search_attr
+ *
+ * Description      Serves a ServiceSearchAttribute request from the cache.
+ *                  The request gets a CCB without an L2CAP channel, and the
+ *                  cached response is parsed and reported on the main loop,
+ *                  so the caller sees the same callback sequence as for a
+ *                  remote query.
+ *
+ * Returns          true if the request is served from the cache
+ *
+ ******************************************************************************/
+bool sdp_cache_start_search_attr(const RawAddress& bd_addr,
+                                 tSDP_DISCOVERY_DB* p_db,
+                                 tSDP_DISC_CMPL_CB* p_cb,
+                                 tSDP_DISC_CMPL_CB2* p_cb2,
+                                 const void* user_data) {
+  std::vector<uint8_t> rsp;
+  if (!sdp_cache_find(bd_addr, p_db, &rsp)) return false;
+
+  tCONN_CB* p_ccb = sdpu_allocate_ccb();
+  if (p_ccb == NULL) return false;
+
+  LOG_INFO("Serving SDP search of %s from cache, %zu bytes",
+           ADDRESS_TO_LOGGABLE_CSTR(bd_addr), rsp.size());
+
+  /* No channel is opened: like a request still setting up its connection, a
+   * cancel completes it right away */
+  p_ccb->con_state = SDP_STATE_CONN_SETUP;
+  p_ccb->disc_state = SDP_DISC_WAIT_SEARCH_ATTR;
+  p_ccb->device_address = bd_addr;
+  p_ccb->p_db = p_db;
+  p_ccb->p_cb = p_cb;
+  p_ccb->p_cb2 = p_cb2;
+  p_ccb->user_data = user_data;
+  p_ccb->is_attr_search = true;
+
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(SDP_MAX_LIST_BYTE_COUNT);
+  memcpy(p_ccb->rsp_list, rsp.data(), rsp.size());
+  p_ccb->list_len = rsp.size();
+
+  alarm_set_on_mloop(p_ccb->sdp_conn_timer, 0,
+                     sdp_process_cached_search_attr_rsp, p_ccb);
+  return true;
+}
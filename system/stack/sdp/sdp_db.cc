@@ -25,7 +25,11 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "bt_target.h"
 #include "osi/include/allocator.h"
@@ -35,12 +39,100 @@
 #include "stack/sdp/sdpint.h"
 #include "types/bluetooth/uuid.h"
 
+using bluetooth::Uuid;
+
+/* Inverted index over the UUIDs of the server database, rebuilt per record
+ * whenever one of its attributes changes, so a ServiceSearch costs a lookup
+ * per requested UUID instead of reparsing every record. */
+static std::unordered_map<Uuid, std::set<uint32_t>> sdp_db_uuid_records;
+static std::unordered_map<uint32_t, std::vector<Uuid>> sdp_db_record_uuids;
+
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_his_uuid, uint16_t his_len,
-                             int nest_level);
+static void collect_uuids_in_seq(uint8_t* p, uint32_t seq_len,
+                                 std::vector<Uuid>* p_uuids, int nest_level);
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_uuid_from_array
+ *
+ * Description      This function converts a big endian 2, 4 or 16 byte UUID
+ *                  into its 128-bit form.
+ *
+ * Returns          true if the length is valid, else false
+ *
+ ******************************************************************************/
+static bool sdp_db_uuid_from_array(const uint8_t* p, uint32_t len,
+                                   Uuid* p_uuid) {
+  switch (len) {
+    case Uuid::kNumBytes16:
+      *p_uuid = Uuid::From16Bit((p[0] << 8) | p[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_uuid = Uuid::From32Bit(((uint32_t)p[0] << 24) | (p[1] << 16) |
+                                (p[2] << 8) | p[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_uuid = Uuid::From128BitBE(p);
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_unindex_record
+ *
+ * Description      This function drops the UUID index entries of a record.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_unindex_record(uint32_t handle) {
+  auto it = sdp_db_record_uuids.find(handle);
+  if (it == sdp_db_record_uuids.end()) return;
+
+  for (const Uuid& uuid : it->second) {
+    auto records = sdp_db_uuid_records.find(uuid);
+    if (records == sdp_db_uuid_records.end()) continue;
+    records->second.erase(handle);
+    if (records->second.empty()) sdp_db_uuid_records.erase(records);
+  }
+  sdp_db_record_uuids.erase(it);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_record
+ *
+ * Description      This function (re)builds the UUID index entries of a server
+ *                  database record.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_record(const tSDP_RECORD* p_rec) {
+  std::vector<Uuid> uuids;
+  const tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
+  Uuid uuid;
+
+  for (uint16_t xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
+    if (p_attr->type == UUID_DESC_TYPE) {
+      if (sdp_db_uuid_from_array(p_attr->value_ptr, p_attr->len, &uuid))
+        uuids.push_back(uuid);
+    } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
+      collect_uuids_in_seq(p_attr->value_ptr, p_attr->len, &uuids, 0);
+    }
+  }
+
+  sdp_db_unindex_record(p_rec->record_handle);
+  for (const Uuid& u : uuids) {
+    sdp_db_uuid_records[u].insert(p_rec->record_handle);
+  }
+  sdp_db_record_uuids[p_rec->record_handle] = std::move(uuids);
+}
 
 /*******************************************************************************
  *
@@ -55,8 +147,9 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
  ******************************************************************************/
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          const tSDP_UUID_SEQ* p_seq) {
+  const std::set<uint32_t>* matches[MAX_UUIDS_PER_SEQ];
   uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
+  Uuid uuid;
   tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
 
   /* If NULL, start at the beginning, else start at the first specified record
@@ -66,30 +159,25 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
   else
     p_rec++;
 
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
+  /* The spec says that a match occurs if the record contains all the passed
+   * UUIDs in it. Collect the records holding each UUID first: if any UUID is
+   * in no record at all, there is nothing to scan. */
+  for (yy = 0; yy < p_seq->num_uids && yy < MAX_UUIDS_PER_SEQ; yy++) {
+    if (!sdp_db_uuid_from_array(&p_seq->uuid_entry[yy].value[0],
+                                p_seq->uuid_entry[yy].len, &uuid))
+      return (NULL);
+    auto it = sdp_db_uuid_records.find(uuid);
+    if (it == sdp_db_uuid_records.end()) return (NULL);
+    matches[yy] = &it->second;
+  }
+
   for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
-            break;
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
-                               &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0))
-            break;
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) break;
+    for (xx = 0; xx < yy; xx++) {
+      if (!matches[xx]->count(p_rec->record_handle)) break;
     }
 
     /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) return (p_rec);
+    if (xx == yy) return (p_rec);
   }
 
   /* If here, no more records found */
@@ -98,22 +186,23 @@ const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
 
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         collect_uuids_in_seq
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function collects the UUIDs of a data element
+ *                  sequence.
  *
- * Returns          true if found, else false
+ * Returns          void
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void collect_uuids_in_seq(uint8_t* p, uint32_t seq_len,
+                                 std::vector<Uuid>* p_uuids, int nest_level) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
+  Uuid uuid;
 
   /* A little safety check to avoid excessive recursion */
-  if (nest_level > 3) return (false);
+  if (nest_level > 3) return;
 
   while (p < p_end) {
     type = *p++;
@@ -124,16 +213,12 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) return (true);
+      if (sdp_db_uuid_from_array(p, len, &uuid)) p_uuids->push_back(uuid);
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1))
-        return (true);
+      collect_uuids_in_seq(p, len, p_uuids, nest_level + 1);
     }
     p = p + len;
   }
-
-  /* If here, failed to match */
-  return (false);
 }
 
 /*******************************************************************************
@@ -174,14 +259,14 @@ tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
 const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec,
                                               uint16_t start_attr,
                                               uint16_t end_attr) {
-  const tSDP_ATTRIBUTE* p_at;
-  uint16_t xx;
+  const tSDP_ATTRIBUTE* p_end = &p_rec->attribute[p_rec->num_attributes];
 
-  /* Note that the attributes in a record are assumed to be in sorted order */
-  for (xx = 0, p_at = &p_rec->attribute[0]; xx < p_rec->num_attributes;
-       xx++, p_at++) {
-    if ((p_at->id >= start_attr) && (p_at->id <= end_attr)) return (p_at);
-  }
+  /* The attributes in a record are kept in sorted order by
+   * SDP_AddAttributeToRecord, so binary search for the first one in range */
+  const tSDP_ATTRIBUTE* p_at = std::lower_bound(
+      &p_rec->attribute[0], p_end, start_attr,
+      [](const tSDP_ATTRIBUTE& attr, uint16_t id) { return attr.id < id; });
+  if ((p_at != p_end) && (p_at->id <= end_attr)) return (p_at);
 
   /* No matching attribute found */
   return (NULL);
@@ -306,11 +391,16 @@ bool SDP_DeleteRecord(uint32_t handle) {
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
 
+    sdp_db_uuid_records.clear();
+    sdp_db_record_uuids.clear();
+
     return (true);
   } else {
     /* Find the record in the database */
     for (xx = 0; xx < sdp_cb.server_db.num_records; xx++, p_rec++) {
       if (p_rec->record_handle == handle) {
+        sdp_db_unindex_record(handle);
+
         /* Found it. Shift everything up one */
         for (yy = xx; yy < sdp_cb.server_db.num_records - 1; yy++, p_rec++) {
           *p_rec = *(p_rec + 1);
@@ -417,8 +507,10 @@ bool SDP_AddAttribute(uint32_t handle, uint16_t attr_id, uint8_t attr_type,
         return (false);
       }
 
-      return SDP_AddAttributeToRecord(p_rec, attr_id, attr_type, attr_len,
-                                      p_val);
+      bool result = SDP_AddAttributeToRecord(p_rec, attr_id, attr_type,
+                                             attr_len, p_val);
+      sdp_db_index_record(p_rec);
+      return result;
     }
   }
   return (false);
@@ -860,7 +952,9 @@ bool SDP_DeleteAttribute(uint32_t handle, uint16_t attr_id) {
   for (uint16_t record_index = 0; record_index < sdp_cb.server_db.num_records; record_index++, p_rec++) {
     if (p_rec->record_handle == handle) {
       SDP_TRACE_API("Deleting attr_id 0x%04x for handle 0x%x", attr_id, handle);
-      return SDP_DeleteAttributeFromRecord(p_rec, attr_id);
+      bool result = SDP_DeleteAttributeFromRecord(p_rec, attr_id);
+      sdp_db_index_record(p_rec);
+      return result;
     }
   }
   /* If here, not found */
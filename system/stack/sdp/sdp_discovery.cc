@@ -49,6 +49,7 @@ static void process_service_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end);
 static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end);
+static tSDP_REASON sdp_parse_search_attr_rsp(tCONN_CB* p_ccb);
 static tSDP_DISC_REC* add_record(tSDP_DISCOVERY_DB* p_db,
                                  const RawAddress& p_bda);
 static uint8_t* add_attr(uint8_t* p, uint8_t* p_end, tSDP_DISCOVERY_DB* p_db,
@@ -666,10 +667,39 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 /* We now have the full response, which is a sequence of sequences */
 /*******************************************************************/
 
+  tSDP_REASON reason = sdp_parse_search_attr_rsp(p_ccb);
+  if (reason != SDP_SUCCESS) {
+    sdp_disconnect(p_ccb, reason);
+    return;
+  }
+
+  sdp_cache_store(p_ccb->device_address, p_ccb->p_db, p_ccb->rsp_list,
+                  p_ccb->list_len);
+
+  /* Since we got everything we need, disconnect the call */
+  sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_parse_search_attr_rsp
+ *
+ * Description      This function saves the complete attribute lists of a
+ *                  ServiceSearchAttribute response, held in the CCB, into the
+ *                  discovery database.
+ *
+ * Returns          SDP_SUCCESS, or the reason the response was rejected
+ *
+ ******************************************************************************/
+static tSDP_REASON sdp_parse_search_attr_rsp(tCONN_CB* p_ccb) {
+  uint8_t *p, *p_end;
+  uint8_t type;
+  uint32_t seq_len;
+
   if (!sdp_copy_raw_data(p_ccb, true)) {
     LOG_ERROR("sdp_copy_raw_data failed");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
 
   p = &p_ccb->rsp_list[0];
@@ -679,33 +709,51 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 
   if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) {
     LOG_WARN("Wrong element in attr_rsp type:0x%02x", type);
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
   p = sdpu_get_len_from_type(p, p + p_ccb->list_len, type, &seq_len);
   if (p == NULL || (p + seq_len) > (p + p_ccb->list_len)) {
     LOG_WARN("Illegal search attribute length");
-    sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
-    return;
+    return SDP_ILLEGAL_PARAMETER;
   }
   p_end = &p_ccb->rsp_list[p_ccb->list_len];
 
   if ((p + seq_len) != p_end) {
-    sdp_disconnect(p_ccb, SDP_INVALID_CONT_STATE);
-    return;
+    return SDP_INVALID_CONT_STATE;
   }
 
   while (p < p_end) {
     p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
     if (!p) {
-      sdp_disconnect(p_ccb, SDP_DB_FULL);
-      return;
+      return SDP_DB_FULL;
     }
   }
 
-  /* Since we got everything we need, disconnect the call */
-  sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
-  sdp_disconnect(p_ccb, SDP_SUCCESS);
+  return SDP_SUCCESS;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_process_cached_search_attr_rsp
+ *
+ * Description      This function completes a ServiceSearchAttribute request
+ *                  served from the cache, see sdp_cache_start_search_attr().
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_process_cached_search_attr_rsp(void* data) {
+  tCONN_CB* p_ccb = (tCONN_CB*)data;
+
+  tSDP_REASON reason = sdp_parse_search_attr_rsp(p_ccb);
+  if (reason != SDP_SUCCESS) {
+    LOG_WARN("Dropping unusable cached SDP response, reason:%s",
+             sdp_result_text(reason).c_str());
+    sdp_cache_remove(p_ccb->device_address, p_ccb->p_db);
+  }
+
+  sdpu_callback(*p_ccb, reason);
+  sdpu_release_ccb(*p_ccb);
 }
 
 /*******************************************************************************
@@ -70,6 +70,11 @@
 #define PBAP_1_2 0x0102
 #define PBAP_1_2_BL_LEN 14
 
+/* Read on every SDP request, cached until a property is set */
+static osi_cached_property_t<bool> sdp_pts_certification = {
+    "vendor.bt.pts.certification", false};
+static osi_cached_property_t<bool> sdp_pts_pbap = {SDP_ENABLE_PTS_PBAP, false};
+
 /* Used to set PBAP local SDP device record for PBAP 1.2 upgrade */
 typedef struct {
   int32_t rfcomm_channel_number;
@@ -173,7 +178,7 @@ bool sdp_dynamic_change_hfp_version(const tSDP_ATTRIBUTE* p_attr,
                                  &btif_storage_get_remote_device_property);
   /* For PTS we should update AG's HFP version as 1.7 */
   if (!(is_allowlisted_1_7) &&
-      !(osi_property_get_bool("vendor.bt.pts.certification", false))) {
+      !(osi_property_get_cached(&sdp_pts_certification))) {
     return false;
   }
   p_attr->value_ptr[PROFILE_VERSION_POSITION] = HFP_PROFILE_MINOR_VERSION_7;
@@ -1120,7 +1125,7 @@ static uint16_t sdp_pbap_pse_dynamic_attributes_len_update(
       is_device_in_allowlist_for_pbap(p_ccb->device_address, false);
   bool is_pbap_102_allowlisted =
       is_device_in_allowlist_for_pbap(p_ccb->device_address, true);
-  bool running_pts = osi_property_get_bool(SDP_ENABLE_PTS_PBAP, false);
+  bool running_pts = osi_property_get_cached(&sdp_pts_pbap);
 
   SDP_TRACE_DEBUG(
       "remote BD Addr : %s is_pbap_102_supported = %d "
@@ -1219,7 +1224,7 @@ static const tSDP_RECORD* sdp_upgrade_pse_record(const tSDP_RECORD* p_rec,
       is_device_in_allowlist_for_pbap(remote_address, false);
   bool is_pbap_102_allowlisted =
       is_device_in_allowlist_for_pbap(remote_address, true);
-  bool running_pts = osi_property_get_bool(SDP_ENABLE_PTS_PBAP, false);
+  bool running_pts = osi_property_get_cached(&sdp_pts_pbap);
 
   SDP_TRACE_DEBUG(
       "%s remote BD Addr : %s is_pbap_102_supported : %d "
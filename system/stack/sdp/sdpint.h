@@ -334,6 +334,18 @@ void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
  */
 void sdp_disc_connected(tCONN_CB* p_ccb);
 void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+void sdp_process_cached_search_attr_rsp(void* data);
+
+/* Functions provided by sdp_cache.cc
+ */
+bool sdp_cache_start_search_attr(const RawAddress& bd_addr,
+                                 tSDP_DISCOVERY_DB* p_db,
+                                 tSDP_DISC_CMPL_CB* p_cb,
+                                 tSDP_DISC_CMPL_CB2* p_cb2,
+                                 const void* user_data);
+void sdp_cache_store(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db,
+                     const uint8_t* p_rsp, uint32_t rsp_len);
+void sdp_cache_remove(const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db);
 
 void update_pce_entry_to_interop_database(RawAddress remote_addr);
 bool is_sdp_pbap_pce_disabled(RawAddress remote_addr);
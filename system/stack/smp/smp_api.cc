@@ -69,6 +69,7 @@ void SMP_Init(void) {
   smp_l2cap_if_init();
   /* initialization of P-256 parameters */
   p_256_init_curve();
+  smp_clear_ecdh_key_pool();
 
   /* Initialize failure case for certification */
   smp_cb.cert_failure = static_cast<tSMP_STATUS>(
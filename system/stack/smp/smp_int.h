@@ -464,4 +464,8 @@ void smp_xor_128(Octet16* a, const Octet16& b);
 void smp_save_local_oob_data(tSMP_CB* p_cb);
 void smp_clear_local_oob_data();
 bool smp_has_local_oob_data();
+
+/* Pool of LE Secure Connections key pairs generated between pairings */
+void smp_refill_ecdh_key_pool();
+void smp_clear_ecdh_key_pool();
 #endif /* SMP_INT_H */
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <deque>
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
@@ -53,6 +54,9 @@ using crypto_toolbox::aes_128;
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_calculate_public_key(const BT_OCTET32 private_key,
+                                     tSMP_PUBLIC_KEY* publ_key);
+static void smp_local_public_key_created(tSMP_CB* p_cb);
 
 #define SMP_PASSKEY_MASK 0xfff00000
 
@@ -73,6 +77,61 @@ static bool is_empty(tSMP_LOC_OOB_DATA* data) {
 
 bool smp_has_local_oob_data() { return !is_empty(&saved_local_oob_data); }
 
+// LE Secure Connections key pairs generated between pairings, so that a new
+// pairing can send its public key without waiting for the controller random
+// numbers and the point multiplication. A key pair is used only once.
+typedef struct {
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY publ_key;
+} tSMP_ECDH_KEY_PAIR;
+
+static std::deque<tSMP_ECDH_KEY_PAIR> ecdh_key_pool;
+static bool ecdh_key_pool_refilling = false;
+static BT_OCTET32 ecdh_key_pool_private_key;
+
+static void smp_ecdh_key_pool_rand_cback(uint8_t offset, BT_OCTET8 rand) {
+  memcpy(&ecdh_key_pool_private_key[offset], rand, BT_OCTET8_LEN);
+  offset += BT_OCTET8_LEN;
+  if (offset < BT_OCTET32_LEN) {
+    btsnd_hcic_ble_rand(Bind(&smp_ecdh_key_pool_rand_cback, offset));
+    return;
+  }
+
+  tSMP_ECDH_KEY_PAIR key_pair;
+  memcpy(key_pair.private_key, ecdh_key_pool_private_key, BT_OCTET32_LEN);
+  smp_calculate_public_key(key_pair.private_key, &key_pair.publ_key);
+  ecdh_key_pool.push_back(key_pair);
+  memset(ecdh_key_pool_private_key, 0, BT_OCTET32_LEN);
+
+  ecdh_key_pool_refilling = false;
+  smp_refill_ecdh_key_pool();
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_refill_ecdh_key_pool
+ *
+ * Description      Generates key pairs, one at a time, until
+ *                  SMP_ECDH_KEY_POOL_SIZE of them are ready. Called when no
+ *                  pairing is in progress.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_refill_ecdh_key_pool() {
+  if (ecdh_key_pool_refilling ||
+      ecdh_key_pool.size() >= SMP_ECDH_KEY_POOL_SIZE) {
+    return;
+  }
+  ecdh_key_pool_refilling = true;
+  btsnd_hcic_ble_rand(Bind(&smp_ecdh_key_pool_rand_cback, 0));
+}
+
+void smp_clear_ecdh_key_pool() {
+  ecdh_key_pool.clear();
+  ecdh_key_pool_refilling = false;
+}
+
 void smp_debug_print_nbyte_little_endian(uint8_t* p, const char* key_name,
                                          uint8_t len) {}
 
@@ -612,6 +671,15 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     LOG_WARN("OOB Association Model with no saved data present");
   }
 
+  if (!ecdh_key_pool.empty()) {
+    const tSMP_ECDH_KEY_PAIR& key_pair = ecdh_key_pool.front();
+    memcpy(p_cb->private_key, key_pair.private_key, BT_OCTET32_LEN);
+    p_cb->loc_publ_key = key_pair.publ_key;
+    ecdh_key_pool.pop_front();
+    smp_local_public_key_created(p_cb);
+    return;
+  }
+
   btsnd_hcic_ble_rand(Bind(
       [](tSMP_CB* p_cb, BT_OCTET8 rand) {
         memcpy((void*)p_cb->private_key, rand, BT_OCTET8_LEN);
@@ -706,16 +774,26 @@ void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
  *
  ******************************************************************************/
 void smp_process_private_key(tSMP_CB* p_cb) {
-  Point public_key;
-  BT_OCTET32 private_key;
-
   SMP_TRACE_DEBUG("%s", __func__);
 
-  memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
-  memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
-  memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
+  smp_calculate_public_key(p_cb->private_key, &p_cb->loc_publ_key);
+  smp_local_public_key_created(p_cb);
+}
+
+/* Calculates the public key of |private_key| */
+static void smp_calculate_public_key(const BT_OCTET32 private_key,
+                                     tSMP_PUBLIC_KEY* publ_key) {
+  Point public_key;
+  BT_OCTET32 scalar;
+
+  memcpy(scalar, private_key, BT_OCTET32_LEN);
+  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)scalar);
+  memcpy(publ_key->x, public_key.x, BT_OCTET32_LEN);
+  memcpy(publ_key->y, public_key.y, BT_OCTET32_LEN);
+}
 
+/* Notifies SM that the local private key / public key pair is ready */
+static void smp_local_public_key_created(tSMP_CB* p_cb) {
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
                                       BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
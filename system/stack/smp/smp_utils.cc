@@ -1008,6 +1008,9 @@ void smp_proc_pairing_cmpl(tSMP_CB* p_cb) {
   smp_reset_control_value(p_cb);
 
   if (p_callback) (*p_callback)(SMP_COMPLT_EVT, pairing_bda, &evt_data);
+
+  /* Prepare the key pairs of the next pairings while the link is idle */
+  smp_refill_ecdh_key_pool();
 }
 
 /*******************************************************************************
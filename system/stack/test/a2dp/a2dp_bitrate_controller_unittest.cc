@@ -0,0 +1,144 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/include/a2dp_bitrate_controller.h"
+
+#include <gtest/gtest.h>
+
+#include "osi/include/properties.h"
+
+namespace {
+constexpr char kEnabledProperty[] =
+    "persist.bluetooth.a2dp_source.adaptive_bitrate.enabled";
+constexpr uint32_t kMinRate = 26;
+constexpr uint32_t kMaxRate = 53;
+constexpr uint32_t kStep = 2;
+constexpr uint64_t kEncoderIntervalMs = 20;
+// Ticks of uncongested TX queue before the rate is increased
+constexpr size_t kIncreaseTicks = 5000 / kEncoderIntervalMs;
+}  // namespace
+
+namespace bluetooth {
+namespace testing {
+
+class A2dpBitrateControllerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    osi_property_set(kEnabledProperty, "true");
+    a2dp_bitrate_controller_init(&controller_, kMinRate, kMaxRate, kStep,
+                                 kEncoderIntervalMs);
+  }
+
+  void TearDown() override { osi_property_set(kEnabledProperty, "false"); }
+
+  // Returns the number of target rate changes over |ticks| ticks.
+  size_t Tick(size_t transmit_queue_length, size_t ticks) {
+    size_t changes = 0;
+    for (size_t i = 0; i < ticks; i++) {
+      if (a2dp_bitrate_controller_set_transmit_queue_length(
+              &controller_, transmit_queue_length)) {
+        changes++;
+      }
+    }
+    return changes;
+  }
+
+  tA2DP_BITRATE_CONTROLLER controller_;
+};
+
+TEST_F(A2dpBitrateControllerTest, disabled_by_default) {
+  osi_property_set(kEnabledProperty, "false");
+  a2dp_bitrate_controller_init(&controller_, kMinRate, kMaxRate, kStep,
+                               kEncoderIntervalMs);
+  ASSERT_FALSE(controller_.enabled);
+
+  tA2DP_LINK_QUALITY link_quality = {};
+  link_quality.tx_queue_dropped_messages = 10;
+  ASSERT_FALSE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  ASSERT_EQ(Tick(10, 100), 0u);
+  ASSERT_EQ(controller_.target_rate, kMaxRate);
+}
+
+TEST_F(A2dpBitrateControllerTest, decrease_on_long_transmit_queue) {
+  ASSERT_TRUE(controller_.enabled);
+  ASSERT_EQ(controller_.target_rate, kMaxRate);
+
+  // A short burst does not change the rate
+  ASSERT_EQ(Tick(5, 2), 0u);
+  ASSERT_EQ(Tick(1, 1), 0u);
+  ASSERT_EQ(Tick(5, 2), 0u);
+  ASSERT_EQ(controller_.target_rate, kMaxRate);
+
+  ASSERT_EQ(Tick(5, 1), 1u);
+  ASSERT_EQ(controller_.target_rate, kMaxRate - kStep);
+
+  // The rate never goes below the minimum
+  Tick(5, 1000);
+  ASSERT_EQ(controller_.target_rate, kMinRate);
+}
+
+TEST_F(A2dpBitrateControllerTest, increase_on_short_transmit_queue) {
+  Tick(5, 3 * 4);
+  ASSERT_EQ(controller_.target_rate, kMaxRate - 4 * kStep);
+
+  ASSERT_EQ(Tick(0, kIncreaseTicks - 1), 0u);
+  ASSERT_EQ(Tick(0, 1), 1u);
+  ASSERT_EQ(controller_.target_rate, kMaxRate - 3 * kStep);
+
+  // A medium TX queue holds the rate
+  ASSERT_EQ(Tick(2, 10 * kIncreaseTicks), 0u);
+
+  // The rate never goes above the maximum
+  Tick(0, 10 * kIncreaseTicks);
+  ASSERT_EQ(controller_.target_rate, kMaxRate);
+}
+
+TEST_F(A2dpBitrateControllerTest, link_quality) {
+  tA2DP_LINK_QUALITY link_quality = {};
+
+  // Dropped packets decrease the rate by two steps
+  link_quality.tx_queue_dropped_messages = 3;
+  ASSERT_TRUE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  ASSERT_EQ(controller_.target_rate, kMaxRate - 2 * kStep);
+
+  // The first Failed Contact Counter read is only a reference
+  link_quality.failed_contact_counter_valid = true;
+  link_quality.failed_contact_counter = 7;
+  ASSERT_FALSE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  link_quality.failed_contact_counter = 9;
+  ASSERT_TRUE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  ASSERT_EQ(controller_.target_rate, kMaxRate - 3 * kStep);
+
+  // A weak RSSI prevents increases
+  link_quality.rssi_valid = true;
+  link_quality.rssi = -90;
+  ASSERT_FALSE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  ASSERT_EQ(Tick(0, 10 * kIncreaseTicks), 0u);
+
+  link_quality.rssi = -50;
+  ASSERT_FALSE(
+      a2dp_bitrate_controller_set_link_quality(&controller_, &link_quality));
+  ASSERT_EQ(Tick(0, kIncreaseTicks), 1u);
+  ASSERT_EQ(controller_.target_rate, kMaxRate - 2 * kStep);
+}
+
+}  // namespace testing
+}  // namespace bluetooth
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/include/a2dp_complexity_controller.h"
+
+#include <gtest/gtest.h>
+
+#include "osi/include/properties.h"
+
+namespace {
+constexpr char kEnabledProperty[] =
+    "persist.bluetooth.a2dp_source.adaptive_complexity.enabled";
+constexpr uint32_t kMinComplexity = 0;
+constexpr uint32_t kMaxComplexity = 5;
+constexpr uint32_t kFrameDurationUs = 20000;
+// A quarter of the frame duration
+constexpr uint32_t kBudgetUs = 5000;
+// Frames well under the budget before the first increase
+constexpr size_t kIncreaseFrames = 5000000 / kFrameDurationUs;
+}  // namespace
+
+namespace bluetooth {
+namespace testing {
+
+class A2dpComplexityControllerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    osi_property_set(kEnabledProperty, "true");
+    a2dp_complexity_controller_init(&controller_, kMinComplexity,
+                                    kMaxComplexity, kFrameDurationUs);
+  }
+
+  // Restores the default for the other encoder tests
+  void TearDown() override { osi_property_set(kEnabledProperty, "true"); }
+
+  // Returns the number of complexity changes over |frames| frames.
+  size_t Encode(uint32_t encode_time_us, size_t frames) {
+    size_t changes = 0;
+    for (size_t i = 0; i < frames; i++) {
+      if (a2dp_complexity_controller_on_frame_encoded(&controller_,
+                                                      encode_time_us)) {
+        changes++;
+      }
+    }
+    return changes;
+  }
+
+  tA2DP_COMPLEXITY_CONTROLLER controller_;
+};
+
+TEST_F(A2dpComplexityControllerTest, disabled) {
+  osi_property_set(kEnabledProperty, "false");
+  a2dp_complexity_controller_init(&controller_, kMinComplexity, kMaxComplexity,
+                                  kFrameDurationUs);
+  ASSERT_FALSE(controller_.enabled);
+
+  ASSERT_EQ(Encode(2 * kBudgetUs, 100), 0u);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity);
+  // The encode time is still measured
+  ASSERT_EQ(controller_.max_encode_us, 2 * kBudgetUs);
+  ASSERT_EQ(controller_.total_frames, 100u);
+}
+
+TEST_F(A2dpComplexityControllerTest, decrease_on_slow_encoding) {
+  ASSERT_TRUE(controller_.enabled);
+  ASSERT_EQ(controller_.budget_us, kBudgetUs);
+
+  // A single slow frame does not lift the average over the budget
+  ASSERT_EQ(Encode(kBudgetUs / 2, 10), 0u);
+  ASSERT_EQ(Encode(4 * kBudgetUs, 1), 0u);
+  ASSERT_EQ(Encode(kBudgetUs / 2, 10), 0u);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity);
+
+  // The average reaches the budget on the third slow frame
+  ASSERT_EQ(Encode(2 * kBudgetUs, 5), 0u);
+  ASSERT_EQ(Encode(2 * kBudgetUs, 1), 1u);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity - 1);
+
+  // The new complexity is measured on its own
+  ASSERT_EQ(Encode(2 * kBudgetUs, 3), 0u);
+  ASSERT_EQ(Encode(2 * kBudgetUs, 1), 1u);
+
+  // The complexity never goes below the minimum
+  Encode(2 * kBudgetUs, 1000);
+  ASSERT_EQ(controller_.complexity, kMinComplexity);
+  ASSERT_EQ(controller_.total_decreases, kMaxComplexity - kMinComplexity);
+}
+
+TEST_F(A2dpComplexityControllerTest, increase_on_fast_encoding) {
+  Encode(2 * kBudgetUs, 4);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity - 1);
+
+  // The complexity that was just left waits twice as long
+  ASSERT_EQ(Encode(kBudgetUs / 4, 2 * kIncreaseFrames - 1), 0u);
+  ASSERT_EQ(Encode(kBudgetUs / 4, 1), 1u);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity);
+
+  // An encode time between half the budget and the budget holds it
+  Encode(2 * kBudgetUs, 4);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity - 1);
+  ASSERT_EQ(Encode(3 * kBudgetUs / 4, 10 * kIncreaseFrames), 0u);
+
+  // The complexity never goes above the maximum
+  Encode(kBudgetUs / 4, 10 * kIncreaseFrames);
+  ASSERT_EQ(controller_.complexity, kMaxComplexity);
+  ASSERT_EQ(controller_.total_increases, 2u);
+}
+
+}  // namespace testing
+}  // namespace bluetooth
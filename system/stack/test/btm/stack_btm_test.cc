@@ -31,11 +31,13 @@
 #include "internal_include/stack_config.h"
 #include "osi/include/allocator.h"
 #include "osi/include/osi.h"
+#include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/btm/btm_sco.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/btm/security_device_record.h"
+#include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/btm_client_interface.h"
@@ -43,6 +45,7 @@
 #include "stack/include/sec_hci_link_interface.h"
 #include "stack/l2cap/l2c_int.h"
 #include "test/common/mock_functions.h"
+#include "test/mock/mock_device_controller.h"
 #include "test/mock/mock_device_iot_config.h"
 #include "test/mock/mock_osi_list.h"
 #include "test/mock/mock_stack_hcic_hcicmds.h"
@@ -397,6 +400,109 @@ TEST_F(StackBtmWithInitFreeTest, btm_sec_allocate_dev_rec__all) {
   // Further, the memory for each record is reused when necessary.
 }
 
+namespace {
+// Returns the Resolvable Private Address built from |irk| and |prand|, the
+// two MSB of |prand[2]| must be 0b01
+RawAddress make_rpa(const Octet16& irk, const uint8_t prand[3]) {
+  Octet16 hash = crypto_toolbox::aes_128(irk, prand, 3);
+  return RawAddress(
+      {prand[2], prand[1], prand[0], hash[2], hash[1], hash[0]});
+}
+
+tBTM_SEC_DEV_REC* allocate_dev_rec_with_irk(const Octet16& irk) {
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_sec_allocate_dev_rec();
+  p_dev_rec->device_type = BT_DEVICE_TYPE_BLE;
+  p_dev_rec->ble.key_type = BTM_LE_KEY_PID;
+  p_dev_rec->ble.keys.irk = irk;
+  return p_dev_rec;
+}
+}  // namespace
+
+TEST_F(StackBtmWithInitFreeTest, btm_ble_resolve_random_addr) {
+  const Octet16 irk1 = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                        0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+  const Octet16 irk2 = {0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05,
+                        0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  const Octet16 irk3 = {0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8,
+                        0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0};
+  const uint8_t prand[3] = {0x94, 0x81, 0x70};
+  const RawAddress rpa2 = make_rpa(irk2, prand);
+
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa2));
+
+  tBTM_SEC_DEV_REC* device_record1 = allocate_dev_rec_with_irk(irk1);
+  tBTM_SEC_DEV_REC* device_record2 = allocate_dev_rec_with_irk(irk2);
+  ASSERT_EQ(device_record2, btm_ble_resolve_random_addr(rpa2));
+  // The second lookup is served from the cache
+  ASSERT_EQ(device_record2, btm_ble_resolve_random_addr(rpa2));
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(make_rpa(irk3, prand)));
+
+  // A changed IRK invalidates the cached results
+  device_record2->ble.keys.irk = irk3;
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa2));
+  ASSERT_EQ(device_record2,
+            btm_ble_resolve_random_addr(make_rpa(irk3, prand)));
+
+  device_record1->ble.keys.irk = irk2;
+  ASSERT_EQ(device_record1, btm_ble_resolve_random_addr(rpa2));
+
+  // So does a removed IRK
+  device_record1->ble.key_type = BTM_LE_KEY_NONE;
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa2));
+}
+
+TEST_F(StackBtmWithInitFreeTest, btm_ble_resolving_list_virtualization) {
+  test::mock::device_controller::ble_resolving_list_max_size = 2;
+  test::mock::device_controller::features_ble.as_array[0] |= 0x40;
+
+  tBTM_SEC_DEV_REC* records[3];
+  for (size_t i = 0; i < 3; i++) {
+    records[i] = btm_sec_allocate_dev_rec();
+    records[i]->bd_addr = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55,
+                                      static_cast<uint8_t>(i)});
+    records[i]->device_type = BT_DEVICE_TYPE_BLE;
+    records[i]->ble.key_type = BTM_LE_KEY_PID;
+  }
+  auto loaded = [](const tBTM_SEC_DEV_REC* p_dev_rec) {
+    return (p_dev_rec->ble.in_controller_list & BTM_RESOLVING_LIST_BIT) != 0;
+  };
+
+  // The host resolves the devices which do not fit
+  btm_ble_resolving_list_load_dev(*records[0]);
+  btm_ble_resolving_list_load_dev(*records[1]);
+  btm_ble_resolving_list_load_dev(*records[2]);
+  ASSERT_EQ(2, get_func_call_count("ACL_AddToAddressResolution"));
+  ASSERT_TRUE(loaded(records[0]));
+  ASSERT_TRUE(loaded(records[1]));
+  ASSERT_FALSE(loaded(records[2]));
+
+  // A promoted device replaces the least recently used one
+  btm_ble_resolving_list_promote_dev(*records[2]);
+  ASSERT_EQ(1, get_func_call_count("ACL_RemoveFromAddressResolution"));
+  ASSERT_FALSE(loaded(records[0]));
+  ASSERT_TRUE(loaded(records[2]));
+
+  // But not a device in the accept list, or a more recently used one
+  records[1]->ble.in_controller_list |= BTM_ACCEPT_LIST_BIT;
+  btm_ble_resolving_list_promote_dev(*records[0]);
+  ASSERT_FALSE(loaded(records[0]));
+
+  // A device in the accept list replaces one which is not
+  records[0]->ble.in_controller_list |= BTM_ACCEPT_LIST_BIT;
+  btm_ble_resolving_list_load_dev(*records[0]);
+  ASSERT_TRUE(loaded(records[0]));
+  ASSERT_FALSE(loaded(records[2]));
+
+  // A removed device leaves its place to the host resolved one
+  btm_ble_resolving_list_remove_dev(records[1]);
+  ASSERT_FALSE(loaded(records[1]));
+  ASSERT_TRUE(loaded(records[2]));
+  ASSERT_EQ(4, get_func_call_count("ACL_AddToAddressResolution"));
+
+  test::mock::device_controller::features_ble.as_array[0] &= ~0x40;
+  test::mock::device_controller::ble_resolving_list_max_size = 0;
+}
+
 TEST_F(StackBtmTest, btm_oob_data_text) {
   std::vector<std::pair<tBTM_OOB_DATA, std::string>> datas = {
       std::make_pair(BTM_OOB_NONE, "BTM_OOB_NONE"),
@@ -455,3 +561,39 @@ TEST_F(StackBtmWithInitFreeTest, wipe_secrets_and_remove) {
 
   wipe_secrets_and_remove(device_record);
 }
+
+TEST_F(StackBtmWithInitFreeTest, btm_find_dev__follows_record_changes) {
+  const RawAddress addr1 = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  const RawAddress addr2 = RawAddress({0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6});
+  const uint16_t handle = 0x0123;
+
+  tBTM_SEC_DEV_REC* record1 = btm_sec_allocate_dev_rec();
+  record1->bd_addr = addr1;
+  record1->hci_handle = handle;
+  record1->ble_hci_handle = HCI_INVALID_HANDLE;
+  tBTM_SEC_DEV_REC* record2 = btm_sec_allocate_dev_rec();
+  record2->bd_addr = addr2;
+  record2->hci_handle = HCI_INVALID_HANDLE;
+  record2->ble_hci_handle = HCI_INVALID_HANDLE;
+
+  // Repeated lookups are answered from the index
+  ASSERT_EQ(record1, btm_find_dev(addr1));
+  ASSERT_EQ(record1, btm_find_dev(addr1));
+  ASSERT_EQ(record2, btm_find_dev(addr2));
+  ASSERT_EQ(record1, btm_find_dev_by_handle(handle));
+  ASSERT_EQ(record1, btm_find_dev_by_handle(handle));
+
+  // Fields updated in place are picked up
+  record1->hci_handle = HCI_INVALID_HANDLE;
+  record2->hci_handle = handle;
+  ASSERT_EQ(record2, btm_find_dev_by_handle(handle));
+  record2->ble.pseudo_addr = addr1;
+  record1->bd_addr = RawAddress::kEmpty;
+  ASSERT_EQ(record2, btm_find_dev(addr1));
+
+  // Removed records are never returned
+  wipe_secrets_and_remove(record2);
+  ASSERT_EQ(nullptr, btm_find_dev(addr1));
+  ASSERT_EQ(nullptr, btm_find_dev(addr2));
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(handle));
+}
@@ -1957,6 +1957,66 @@ TEST_F(IsoManagerTest, SendIsoDataBigValid) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataFollowsControllerTxSync) {
+  constexpr uint32_t controller_ts = 0x10000000;
+  uint16_t handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& conn_handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({conn_handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  std::vector<std::pair<uint16_t, uint32_t>> sent;
+  EXPECT_CALL(bte_interface_, HciSend)
+      .Times(3)
+      .WillRepeatedly([&sent](BT_HDR* p_msg, uint16_t event) {
+        ASSERT_TRUE(p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS);
+        uint8_t* p = p_msg->data + 4;
+        uint32_t ts;
+        uint16_t seq_nb;
+        STREAM_TO_UINT32(ts, p);
+        STREAM_TO_UINT16(seq_nb, p);
+        sent.push_back({seq_nb, ts});
+      });
+
+  // The controller reference is read once, after the first SDU
+  EXPECT_CALL(hcic_interface_, ReadIsoTxSync(handle, _))
+      .WillOnce([&sent](uint16_t iso_handle,
+                        base::OnceCallback<void(uint8_t*, uint16_t)> cb) {
+        ASSERT_EQ(sent.size(), 1u);
+        std::vector<uint8_t> buf(12);
+        uint8_t* p = buf.data();
+        UINT8_TO_STREAM(p, HCI_SUCCESS);
+        UINT16_TO_STREAM(p, iso_handle);
+        UINT16_TO_STREAM(p, sent[0].first);
+        UINT32_TO_STREAM(p, controller_ts);
+        UINT24_TO_STREAM(p, 0);
+        std::move(cb).Run(buf.data(), buf.size());
+      });
+
+  std::vector<uint8_t> data_vec(108, 0);
+  for (int i = 0; i < 3; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+
+  /* Sent back to back, the SDUs still get consecutive sequence numbers, and
+   * time stamps one SDU interval apart in the controller clock */
+  ASSERT_EQ(sent.size(), 3u);
+  for (size_t i = 1; i < sent.size(); i++) {
+    uint16_t seq_nb_delta = sent[i].first - sent[0].first;
+    ASSERT_GE(seq_nb_delta, i);
+    ASSERT_EQ(sent[i].second,
+              controller_ts + seq_nb_delta * kDefaultCigParams.sdu_itv_mtos);
+  }
+}
+
 TEST_F(IsoManagerTest, SendIsoDataNoCredits) {
   uint8_t num_buffers = controller_interface_.GetIsoBufferCount();
   std::vector<uint8_t> data_vec(108, 0);
@@ -78,6 +78,11 @@ EattChannel* EattExtension::GetChannelAvailableForIndication(
   return pimpl_->GetChannelAvailableForIndication(bd_addr);
 }
 
+EattChannel* EattExtension::GetChannelAvailableForNotification(
+    const RawAddress& bd_addr) {
+  return pimpl_->GetChannelAvailableForNotification(bd_addr);
+}
+
 void EattExtension::FreeGattResources(const RawAddress& bd_addr) {
   pimpl_->FreeGattResources(bd_addr);
 }
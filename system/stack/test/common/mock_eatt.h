@@ -50,6 +50,8 @@ class MockEattExtension : public EattExtension {
               (const RawAddress& bd_addr, uint16_t indication_handle));
   MOCK_METHOD((EattChannel*), GetChannelAvailableForIndication,
               (const RawAddress& bd_addr));
+  MOCK_METHOD((EattChannel*), GetChannelAvailableForNotification,
+              (const RawAddress& bd_addr));
   MOCK_METHOD((void), FreeGattResources, (const RawAddress& bd_addr));
   MOCK_METHOD((bool), IsOutstandingMsgInSendQueue, (const RawAddress& bd_addr));
   MOCK_METHOD((EattChannel*), GetChannelWithQueuedDataToSend,
@@ -670,4 +670,34 @@ TEST_F(EattTest, ChannelUnavailableWhileReconfiguring) {
   ASSERT_EQ(available_channel_for_indication, nullptr);
 }
 
+TEST_F(EattTest, NotificationsSpreadOverChannels) {
+  ConnectDeviceEattSupported(/* num_of_accepted_connections = */ 3);
+
+  // Channel 61 has data queued, 63 has more credits than 62
+  ON_CALL(l2cap_interface_, FlushChannel(_, L2CAP_FLUSH_CHANS_GET))
+      .WillByDefault([](uint16_t cid, uint16_t) { return cid == 61 ? 2 : 0; });
+  ON_CALL(l2cap_interface_, GetPeerLECocCredit(test_address, _))
+      .WillByDefault(
+          [](const RawAddress&, uint16_t cid) { return cid == 63 ? 10 : 5; });
+  EattChannel* channel =
+      eatt_instance_->GetChannelAvailableForNotification(test_address);
+  ASSERT_NE(channel, nullptr);
+  ASSERT_EQ(channel->cid_, 63);
+
+  // Equally loaded channels take turns
+  ON_CALL(l2cap_interface_, FlushChannel(_, L2CAP_FLUSH_CHANS_GET))
+      .WillByDefault(Return(0));
+  ON_CALL(l2cap_interface_, GetPeerLECocCredit(test_address, _))
+      .WillByDefault(Return(5));
+  std::vector<uint16_t> cids;
+  for (int i = 0; i < 4; i++) {
+    cids.push_back(
+        eatt_instance_->GetChannelAvailableForNotification(test_address)
+            ->cid_);
+  }
+  ASSERT_EQ(cids, std::vector<uint16_t>({61, 62, 63, 61}));
+
+  DisconnectEattDevice(connected_cids_);
+}
+
 }  // namespace
@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include <cstdint>
+#include <vector>
 
 #include "osi/test/AllocationTestHarness.h"
 #include "stack/gatt/gatt_int.h"
@@ -45,6 +46,8 @@ struct TestMutables {
     uint32_t trans_id_{0};
     tGATTS_REQ_TYPE type_{0xff};
     tGATTS_DATA data_;
+    std::vector<tGATTS_REQ_TYPE> types_;
+    std::vector<tGATTS_DATA> datas_;
   } application_request_callback;
   struct {
     int access_count_{0};
@@ -133,6 +136,8 @@ void ApplicationRequestCallback(uint16_t conn_id, uint32_t trans_id,
   test_state_.application_request_callback.trans_id_ = trans_id;
   test_state_.application_request_callback.type_ = type;
   test_state_.application_request_callback.data_ = *p_data;
+  test_state_.application_request_callback.types_.push_back(type);
+  test_state_.application_request_callback.datas_.push_back(*p_data);
 }
 
 bool gatt_sr_is_cl_change_aware(tGATT_TCB& tcb) { return false; }
@@ -346,6 +351,85 @@ TEST_F(GattSrTest, gatts_process_write_req_request_write_typical) {
   CHECK(test_state_.application_request_callback.data_.write_req.len == length);
 }
 
+TEST_F(GattSrTest, gatts_process_write_req_prepare_write_queued_and_merged) {
+  tcb_.prep_write_quota = GATT_PREP_WRITE_DEFAULT_QUOTA;
+  uint8_t first[4] = {0x00, 0x00, 0x11, 0x22};
+  uint8_t second[4] = {0x02, 0x00, 0x33, 0x44};
+
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(first), first,
+                          kGattCharacteristicType);
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(second), second,
+                          kGattCharacteristicType);
+
+  // The server responds and the application does not see the writes yet
+  ASSERT_EQ(test_state_.attp_build_sr_msg.op_code_, GATT_RSP_PREPARE_WRITE);
+  ASSERT_TRUE(test_state_.application_request_callback.types_.empty());
+  ASSERT_EQ(tcb_.prep_write_q.size(), 1u);
+  ASSERT_EQ(tcb_.prep_write_q[0].len, 4);
+
+  uint8_t exec = GATT_PREP_WRITE_EXEC;
+  gatt_process_exec_write_req(tcb_, L2CAP_ATT_CID, GATT_REQ_EXEC_WRITE,
+                              sizeof(exec), &exec);
+
+  const auto& callback = test_state_.application_request_callback;
+  ASSERT_EQ(callback.types_.size(), 2u);
+  ASSERT_EQ(callback.types_[0], GATTS_REQ_TYPE_WRITE_CHARACTERISTIC);
+  const tGATT_WRITE_REQ& write_req = callback.datas_[0].write_req;
+  ASSERT_EQ(write_req.handle, kHandle);
+  ASSERT_EQ(write_req.offset, 0);
+  ASSERT_EQ(write_req.len, 4);
+  ASSERT_TRUE(write_req.is_prep);
+  uint8_t value[4] = {0x11, 0x22, 0x33, 0x44};
+  ASSERT_EQ(memcmp(write_req.value, value, sizeof(value)), 0);
+  ASSERT_EQ(callback.types_[1], GATTS_REQ_TYPE_WRITE_EXEC);
+  ASSERT_EQ(callback.datas_[1].exec_write, GATT_PREP_WRITE_EXEC);
+  ASSERT_TRUE(tcb_.prep_write_q.empty());
+  // One response per write and one for the execute write
+  ASSERT_EQ(tcb_.sr_cmd.cback_cnt[el_.gatt_if - 1], 2);
+}
+
+TEST_F(GattSrTest, gatts_process_write_req_prepare_write_cancelled) {
+  tcb_.prep_write_quota = GATT_PREP_WRITE_DEFAULT_QUOTA;
+  uint8_t first[4] = {0x00, 0x00, 0x11, 0x22};
+  uint8_t second[4] = {0x04, 0x00, 0x33, 0x44};
+
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(first), first,
+                          kGattCharacteristicType);
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(second), second,
+                          kGattCharacteristicType);
+  // Not contiguous
+  ASSERT_EQ(tcb_.prep_write_q.size(), 2u);
+
+  uint8_t cancel = GATT_PREP_WRITE_CANCEL;
+  gatt_process_exec_write_req(tcb_, L2CAP_ATT_CID, GATT_REQ_EXEC_WRITE,
+                              sizeof(cancel), &cancel);
+
+  ASSERT_EQ(test_state_.attp_build_sr_msg.op_code_, GATT_RSP_EXEC_WRITE);
+  ASSERT_TRUE(test_state_.application_request_callback.types_.empty());
+  ASSERT_TRUE(tcb_.prep_write_q.empty());
+  ASSERT_TRUE(tcb_.prep_write_buf.empty());
+}
+
+TEST_F(GattSrTest, gatts_process_write_req_prepare_write_queue_full) {
+  tcb_.prep_write_quota = 3;
+  uint8_t p_data[4] = {0x00, 0x00, 0x11, 0x22};
+
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(p_data), p_data,
+                          kGattCharacteristicType);
+  p_data[0] = 0x02;
+  gatts_process_write_req(tcb_, L2CAP_ATT_CID, el_, kHandle,
+                          GATT_REQ_PREPARE_WRITE, sizeof(p_data), p_data,
+                          kGattCharacteristicType);
+
+  ASSERT_EQ(test_state_.attp_build_sr_msg.op_code_, GATT_RSP_ERROR);
+  ASSERT_EQ(tcb_.prep_write_buf.size(), 2u);
+}
+
 TEST_F(GattSrRobustCachingTest,
        gatts_process_db_out_of_sync_for_gatt_req_read_by_grp_type) {
   tcb_.is_robust_cache_change_aware = false;
@@ -118,6 +118,31 @@ TEST_F(StackGattTest, gatt_init_free) {
   gatt_free();
 }
 
+TEST_F(StackGattTest, gatt_sr_find_by_handle) {
+  gatt_init();
+
+  // The GATT and GAP profile services are started by gatt_init
+  ASSERT_FALSE(gatt_cb.srv_list_info->empty());
+  ASSERT_EQ(gatt_cb.srv_list_info->end(), gatt_sr_find_i_rcb_by_handle(0));
+
+  for (auto& el : *gatt_cb.srv_list_info) {
+    ASSERT_EQ(&el, &*gatt_sr_find_i_rcb_by_handle(el.s_hdl));
+    ASSERT_EQ(&el, &*gatt_sr_find_i_rcb_by_handle(el.e_hdl));
+    for (auto& attr : el.p_db->attr_list) {
+      ASSERT_EQ(&el, &*gatt_sr_find_i_rcb_by_handle(attr.handle));
+      ASSERT_EQ(&attr, find_attr_by_handle(el.p_db, attr.handle));
+    }
+  }
+
+  const tGATT_SRV_LIST_ELEM& last = gatt_cb.srv_list_info->back();
+  if (last.e_hdl < 0xffff) {
+    ASSERT_EQ(gatt_cb.srv_list_info->end(),
+              gatt_sr_find_i_rcb_by_handle(last.e_hdl + 1));
+  }
+
+  gatt_free();
+}
+
 TEST_F(StackGattTest, GATT_Register_Deregister) {
   gatt_init();
 
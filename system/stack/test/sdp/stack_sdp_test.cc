@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cstddef>
 
 #include "stack/include/sdp_api.h"
@@ -227,3 +228,57 @@ TEST_F(StackSdpMainTest, sdp_flags_text) {
                                   std::numeric_limits<uint8_t>::max()))
                    .c_str());
 }
+
+TEST_F(StackSdpMainTest, sdp_db_service_search_uses_uuid_index) {
+  uint16_t spp = UUID_SERVCLASS_SERIAL_PORT;
+  uint16_t hfp = UUID_SERVCLASS_HF_HANDSFREE;
+  uint32_t spp_handle = SDP_CreateRecord();
+  uint32_t hfp_handle = SDP_CreateRecord();
+  ASSERT_TRUE(SDP_AddServiceClassIdList(spp_handle, 1, &spp));
+  ASSERT_TRUE(SDP_AddServiceClassIdList(hfp_handle, 1, &hfp));
+
+  tSDP_PROTOCOL_ELEM proto = {};
+  proto.protocol_uuid = UUID_PROTOCOL_RFCOMM;
+  proto.num_params = 1;
+  proto.params[0] = 3;
+  ASSERT_TRUE(SDP_AddProtocolList(spp_handle, 1, &proto));
+
+  // A 16-bit SPP UUID and a 128-bit RFCOMM UUID must both match
+  tSDP_UUID_SEQ seq = {};
+  seq.num_uids = 2;
+  seq.uuid_entry[0].len = 2;
+  seq.uuid_entry[0].value[0] = spp >> 8;
+  seq.uuid_entry[0].value[1] = spp & 0xff;
+  seq.uuid_entry[1].len = 16;
+  bluetooth::Uuid::UUID128Bit rfcomm =
+      bluetooth::Uuid::From16Bit(UUID_PROTOCOL_RFCOMM).To128BitBE();
+  std::copy(rfcomm.begin(), rfcomm.end(), seq.uuid_entry[1].value);
+
+  const tSDP_RECORD* p_rec = sdp_db_service_search(nullptr, &seq);
+  ASSERT_NE(nullptr, p_rec);
+  ASSERT_EQ(spp_handle, p_rec->record_handle);
+  ASSERT_EQ(nullptr, sdp_db_service_search(p_rec, &seq));
+
+  const tSDP_ATTRIBUTE* p_attr = sdp_db_find_attr_in_rec(
+      p_rec, ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_PROTOCOL_DESC_LIST);
+  ASSERT_NE(nullptr, p_attr);
+  ASSERT_EQ(ATTR_ID_SERVICE_CLASS_ID_LIST, p_attr->id);
+  ASSERT_EQ(nullptr, sdp_db_find_attr_in_rec(p_rec, ATTR_ID_SERVICE_ID,
+                                             ATTR_ID_SERVICE_ID));
+
+  // Removing the protocol list drops the record from the RFCOMM results
+  ASSERT_TRUE(SDP_DeleteAttribute(spp_handle, ATTR_ID_PROTOCOL_DESC_LIST));
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &seq));
+
+  // The HFP record is still found once the SPP record is deleted
+  seq.num_uids = 1;
+  seq.uuid_entry[0].value[0] = hfp >> 8;
+  seq.uuid_entry[0].value[1] = hfp & 0xff;
+  ASSERT_TRUE(SDP_DeleteRecord(spp_handle));
+  p_rec = sdp_db_service_search(nullptr, &seq);
+  ASSERT_NE(nullptr, p_rec);
+  ASSERT_EQ(hfp_handle, p_rec->record_handle);
+
+  ASSERT_TRUE(SDP_DeleteRecord(0));
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &seq));
+}
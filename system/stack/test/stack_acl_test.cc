@@ -126,3 +126,35 @@ TEST_F(StackAclTest, acl_process_extended_features) {
 
   btm_acl_removed(hci_handle);
 }
+
+TEST_F(StackAclTest, record_traffic_idle_gaps) {
+  tACL_CONN acl;
+  acl.Reset();
+
+  /* packets of the same burst are not idle gaps */
+  acl.RecordTraffic(1000);
+  acl.RecordTraffic(1000 + ACL_TRAFFIC_MIN_IDLE_GAP_MS - 1);
+  ASSERT_EQ(0u, acl.traffic_stats.num_idle_gaps);
+  ASSERT_EQ(1000u + ACL_TRAFFIC_MIN_IDLE_GAP_MS - 1,
+            acl.traffic_stats.last_packet_ms);
+
+  acl.RecordTraffic(2099);
+  ASSERT_EQ(1u, acl.traffic_stats.num_idle_gaps);
+  ASSERT_EQ(1000u, acl.traffic_stats.idle_gap_ms);
+  ASSERT_EQ(500u, acl.traffic_stats.idle_gap_var_ms);
+
+  acl.RecordTraffic(2899);
+  ASSERT_EQ(2u, acl.traffic_stats.num_idle_gaps);
+  ASSERT_EQ(975u, acl.traffic_stats.idle_gap_ms);
+  ASSERT_EQ(425u, acl.traffic_stats.idle_gap_var_ms);
+
+  /* very long silences are clamped */
+  acl.RecordTraffic(2899 + 10 * ACL_TRAFFIC_MAX_IDLE_GAP_MS);
+  ASSERT_EQ(3u, acl.traffic_stats.num_idle_gaps);
+  ASSERT_EQ((7 * 975u + ACL_TRAFFIC_MAX_IDLE_GAP_MS) / 8,
+            acl.traffic_stats.idle_gap_ms);
+
+  acl.Reset();
+  ASSERT_EQ(0u, acl.traffic_stats.num_idle_gaps);
+  ASSERT_EQ(0u, acl.traffic_stats.last_packet_ms);
+}
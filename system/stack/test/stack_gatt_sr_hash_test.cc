@@ -85,4 +85,10 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
   Octet16 result_hash = gatts_calculate_database_hash(&srv_list_info);
 
   ASSERT_EQ(result_hash, expected_hash);
+
+  // The services serialized above are reused when the list changes
+  srv_list_info.pop_back();
+  ASSERT_NE(gatts_calculate_database_hash(&srv_list_info), expected_hash);
+  add_item_to_list(srv_list_info, &local_db[3], false);
+  ASSERT_EQ(gatts_calculate_database_hash(&srv_list_info), expected_hash);
 }
@@ -80,6 +80,30 @@ TEST_F(StackL2capTest, l2cble_process_data_length_change_event) {
   ASSERT_EQ(0x001b, l2cb.lcb_pool[0].tx_data_len);
 }
 
+TEST_F(StackL2capTest, l2cu_find_lcb_by_handle) {
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0012));
+
+  l2cb.lcb_pool[0].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[0], 0x0012);
+  l2cb.lcb_pool[3].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[3], 0x0034);
+  ASSERT_EQ(&l2cb.lcb_pool[0], l2cu_find_lcb_by_handle(0x0012));
+  ASSERT_EQ(&l2cb.lcb_pool[3], l2cu_find_lcb_by_handle(0x0034));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0056));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(HCI_INVALID_HANDLE));
+
+  // Stale entries are not returned
+  l2cb.lcb_pool[0].InvalidateHandle();
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0012));
+  l2cb.lcb_pool[3].in_use = false;
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0034));
+
+  // Handles are reused by other links
+  l2cb.lcb_pool[5].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[5], 0x0012);
+  ASSERT_EQ(&l2cb.lcb_pool[5], l2cu_find_lcb_by_handle(0x0012));
+}
+
 class StackL2capChannelTest : public StackL2capTest {
  protected:
   void SetUp() override { StackL2capTest::SetUp(); }
@@ -56,6 +56,11 @@ const gatt::Descriptor* BTA_GATTC_GetDescriptor(uint16_t conn_id,
   inc_func_call_count(__func__);
   return nullptr;
 }
+bool BTA_GATTC_IsCccdWritten(uint16_t conn_id, uint16_t handle,
+                             uint16_t value) {
+  inc_func_call_count(__func__);
+  return false;
+}
 const gatt::Service* BTA_GATTC_GetOwningService(uint16_t conn_id,
                                                 uint16_t handle) {
   inc_func_call_count(__func__);
@@ -139,7 +144,8 @@ void BTA_GATTC_ReadCharacteristic(uint16_t conn_id, uint16_t handle,
   inc_func_call_count(__func__);
 }
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req) {
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   inc_func_call_count(__func__);
 }
 void BTA_GATTC_ReadUsingCharUuid(uint16_t conn_id, const bluetooth::Uuid& uuid,
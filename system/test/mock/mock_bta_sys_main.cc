@@ -45,6 +45,7 @@ struct bta_sys_is_register bta_sys_is_register;
 struct bta_sys_register bta_sys_register;
 struct bta_sys_sendmsg bta_sys_sendmsg;
 struct bta_sys_sendmsg_delayed bta_sys_sendmsg_delayed;
+struct bta_sys_discard_pending_msgs bta_sys_discard_pending_msgs;
 struct bta_sys_start_timer bta_sys_start_timer;
 
 }  // namespace bta_sys_main
@@ -88,6 +89,10 @@ void bta_sys_sendmsg_delayed(void* p_msg, const base::TimeDelta& delay) {
   inc_func_call_count(__func__);
   test::mock::bta_sys_main::bta_sys_sendmsg_delayed(p_msg, delay);
 }
+void bta_sys_discard_pending_msgs() {
+  inc_func_call_count(__func__);
+  test::mock::bta_sys_main::bta_sys_discard_pending_msgs();
+}
 void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
                          uint16_t layer_specific) {
   inc_func_call_count(__func__);
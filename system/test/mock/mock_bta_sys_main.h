@@ -142,6 +142,15 @@ struct bta_sys_sendmsg_delayed {
 };
 extern struct bta_sys_sendmsg_delayed bta_sys_sendmsg_delayed;
 
+// Name: bta_sys_discard_pending_msgs
+// Params:
+// Return: void
+struct bta_sys_discard_pending_msgs {
+  std::function<void()> body{[]() {}};
+  void operator()() { body(); };
+};
+extern struct bta_sys_discard_pending_msgs bta_sys_discard_pending_msgs;
+
 // Name: bta_sys_start_timer
 // Params: alarm_t* alarm, uint64_t interval_ms, uint16_t event, uint16_t
 // layer_specific Return: void
@@ -60,6 +60,9 @@ struct btif_config_get_bin btif_config_get_bin;
 struct btif_config_get_bin_length btif_config_get_bin_length;
 struct btif_config_set_bin btif_config_set_bin;
 struct btif_config_get_paired_devices btif_config_get_paired_devices;
+struct btif_config_get_sections btif_config_get_sections;
+struct btif_config_section_get_int btif_config_section_get_int;
+struct btif_config_section_get_str btif_config_section_get_str;
 struct btif_config_remove btif_config_remove;
 struct btif_config_clear btif_config_clear;
 struct btif_debug_config_dump btif_debug_config_dump;
@@ -125,6 +128,24 @@ std::vector<RawAddress> btif_config_get_paired_devices() {
   inc_func_call_count(__func__);
   return test::mock::btif_config::btif_config_get_paired_devices();
 }
+std::vector<std::optional<btif_config_section_t>> btif_config_get_sections(
+    const std::vector<std::string>& sections) {
+  inc_func_call_count(__func__);
+  return test::mock::btif_config::btif_config_get_sections(sections);
+}
+bool btif_config_section_get_int(const btif_config_section_t& section,
+                                 const std::string& key, int* value) {
+  inc_func_call_count(__func__);
+  return test::mock::btif_config::btif_config_section_get_int(section, key,
+                                                              value);
+}
+bool btif_config_section_get_str(const btif_config_section_t& section,
+                                 const std::string& key, char* value,
+                                 int* size_bytes) {
+  inc_func_call_count(__func__);
+  return test::mock::btif_config::btif_config_section_get_str(
+      section, key, value, size_bytes);
+}
 bool btif_config_remove(const std::string& section, const std::string& key) {
   inc_func_call_count(__func__);
   return test::mock::btif_config::btif_config_remove(section, key);
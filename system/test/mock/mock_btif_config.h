@@ -190,6 +190,52 @@ struct btif_config_get_paired_devices {
   std::vector<RawAddress> operator()() { return body(); };
 };
 extern struct btif_config_get_paired_devices btif_config_get_paired_devices;
+// Name: btif_config_get_sections
+// Params: const std::vector<std::string>& sections
+// Returns: std::vector<std::optional<btif_config_section_t>>
+struct btif_config_get_sections {
+  std::function<std::vector<std::optional<btif_config_section_t>>(
+      const std::vector<std::string>& sections)>
+      body{[](const std::vector<std::string>& sections) {
+        return std::vector<std::optional<btif_config_section_t>>(
+            sections.size());
+      }};
+  std::vector<std::optional<btif_config_section_t>> operator()(
+      const std::vector<std::string>& sections) {
+    return body(sections);
+  };
+};
+extern struct btif_config_get_sections btif_config_get_sections;
+// Name: btif_config_section_get_int
+// Params: const btif_config_section_t& section, const std::string& key,
+// int* value
+// Returns: bool
+struct btif_config_section_get_int {
+  std::function<bool(const btif_config_section_t& section,
+                     const std::string& key, int* value)>
+      body{[](const btif_config_section_t& section, const std::string& key,
+              int* value) { return false; }};
+  bool operator()(const btif_config_section_t& section, const std::string& key,
+                  int* value) {
+    return body(section, key, value);
+  };
+};
+extern struct btif_config_section_get_int btif_config_section_get_int;
+// Name: btif_config_section_get_str
+// Params: const btif_config_section_t& section, const std::string& key,
+// char* value, int* size_bytes
+// Returns: bool
+struct btif_config_section_get_str {
+  std::function<bool(const btif_config_section_t& section,
+                     const std::string& key, char* value, int* size_bytes)>
+      body{[](const btif_config_section_t& section, const std::string& key,
+              char* value, int* size_bytes) { return false; }};
+  bool operator()(const btif_config_section_t& section, const std::string& key,
+                  char* value, int* size_bytes) {
+    return body(section, key, value, size_bytes);
+  };
+};
+extern struct btif_config_section_get_str btif_config_section_get_str;
 // Name: btif_config_remove
 // Params: const std::string& section, const std::string& key
 // Returns: bool
@@ -72,6 +72,13 @@ bt_status_t do_in_jni_thread(const base::Location& from_here,
   do_in_jni_thread_task_queue.push(std::move(task));
   return BT_STATUS_SUCCESS;
 }
+bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                     base::OnceClosure task,
+                                     const base::TimeDelta& delay) {
+  inc_func_call_count(__func__);
+  do_in_jni_thread_task_queue.push(std::move(task));
+  return BT_STATUS_SUCCESS;
+}
 btbase::AbstractMessageLoop* get_jni_message_loop() {
   inc_func_call_count(__func__);
   return nullptr;
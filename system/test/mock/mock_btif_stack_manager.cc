@@ -26,6 +26,12 @@ static future_t* hack_future;
 
 future_t* stack_manager_get_hack_future() { return hack_future; }
 
+void stack_manager_run_start_up_step(const char* name, void (*step)(void)) {
+  step();
+}
+
+void stack_manager_debug_dump(int fd) {}
+
 namespace {
 
 auto interfaceToProfiles = MockCoreInterface{};
@@ -116,6 +116,15 @@ bt_status_t btif_storage_get_remote_device_property(
   inc_func_call_count(__func__);
   return BT_STATUS_SUCCESS;
 }
+bt_status_t btif_storage_get_remote_device_properties(
+    const RawAddress* remote_bd_addr, uint32_t num_props,
+    bt_property_t* properties, bt_status_t* statuses) {
+  inc_func_call_count(__func__);
+  for (uint32_t i = 0; statuses != nullptr && i < num_props; i++) {
+    statuses[i] = BT_STATUS_SUCCESS;
+  }
+  return BT_STATUS_SUCCESS;
+}
 bt_status_t btif_storage_load_bonded_devices(void) {
   inc_func_call_count(__func__);
   return BT_STATUS_SUCCESS;
@@ -44,7 +44,8 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name,
       linux_tid_(-1),
       weak_ptr_factory_(this),
       shutting_down_(false),
-      is_main_(is_main) {}
+      is_main_(is_main),
+      task_stats_(thread_name) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -130,6 +131,10 @@ base::PlatformThreadId MessageLoopThread::GetThreadId() const {
 
 std::string MessageLoopThread::GetName() const { return thread_name_; }
 
+const TaskStats& MessageLoopThread::GetTaskStats() const {
+  return task_stats_;
+}
+
 std::string MessageLoopThread::ToString() const {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return base::StringPrintf("%s(%d)", thread_name_.c_str(), thread_id_);
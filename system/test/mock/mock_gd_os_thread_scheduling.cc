@@ -0,0 +1,40 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/thread_scheduling.h"
+
+#include "test/common/mock_functions.h"
+
+namespace bluetooth {
+namespace os {
+
+ThreadSchedulingConfig GetThreadSchedulingConfig(const std::string& thread_name) {
+  inc_func_call_count(__func__);
+  return {};
+}
+
+std::vector<int> ParseCpuList(const std::string& cpus) {
+  inc_func_call_count(__func__);
+  return {};
+}
+
+bool ApplyThreadScheduling(pid_t linux_tid, const std::string& thread_name, bool real_time) {
+  inc_func_call_count(__func__);
+  return true;
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -85,6 +85,13 @@ std::vector<std::string>
 bluetooth::shim::BtifConfigInterface::GetPersistentDevices() {
   return std::vector<std::string>();
 }
+std::vector<std::optional<bluetooth::shim::BtifConfigInterface::Section>>
+bluetooth::shim::BtifConfigInterface::GetSections(
+    const std::vector<std::string>& sections) {
+  return std::vector<
+      std::optional<bluetooth::shim::BtifConfigInterface::Section>>(
+      sections.size());
+}
 void bluetooth::shim::BtifConfigInterface::
     ConvertEncryptOrDecryptKeyIfNeeded(){};
 void bluetooth::shim::BtifConfigInterface::Clear(){};
@@ -186,6 +186,10 @@ bool bluetooth::shim::CountCounterMetrics(int32_t key, int64_t count) {
   return false;
 
 }
+bool bluetooth::shim::CacheCounterMetrics(int32_t key, int64_t count) {
+  inc_func_call_count(__func__);
+  return false;
+}
 void bluetooth::shim::LogMetricBluetoothLEConnectionMetricEvent(
     const RawAddress& raw_address,
     android::bluetooth::le::LeConnectionOriginType origin_type,
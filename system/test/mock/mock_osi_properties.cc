@@ -64,6 +64,12 @@ std::vector<uint32_t> osi_property_get_uintlist(
   inc_func_call_count(__func__);
   return default_value;
 }
+uint32_t osi_property_get_serial(void) {
+  inc_func_call_count(__func__);
+  // Changes on every call so that cached properties follow the mocked values
+  static uint32_t serial = 0;
+  return serial++;
+}
 int osi_property_set(const char* key, const char* value) {
   inc_func_call_count(__func__);
   return test::mock::osi_properties::osi_property_set(key, value);
@@ -59,7 +59,8 @@ A2dpCodecConfig::A2dpCodecConfig(btav_a2dp_codec_index_t codec_index,
                                  btav_a2dp_codec_priority_t codec_priority)
     : codec_index_(codec_index),
       name_(name),
-      default_codec_priority_(codec_priority) {
+      default_codec_priority_(codec_priority),
+      tx_latency_budget_ms_(0) {
   inc_func_call_count(__func__);
 }
 A2dpCodecConfig::~A2dpCodecConfig() { inc_func_call_count(__func__); }
@@ -78,6 +79,10 @@ bool A2DP_BuildCodecHeader(const uint8_t* p_codec_info, BT_HDR* p_buf,
   inc_func_call_count(__func__);
   return false;
 }
+BT_HDR* A2DP_AllocMediaPacket(uint16_t offset) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
 bool A2DP_CodecEquals(const uint8_t* p_codec_info_a,
                       const uint8_t* p_codec_info_b) {
   inc_func_call_count(__func__);
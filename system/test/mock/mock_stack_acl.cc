@@ -67,6 +67,7 @@ struct acl_peer_supports_ble_connection_parameters_request
 struct acl_peer_supports_ble_packet_extension
     acl_peer_supports_ble_packet_extension;
 struct acl_peer_supports_sniff_subrating acl_peer_supports_sniff_subrating;
+struct acl_get_traffic_stats acl_get_traffic_stats;
 struct acl_peer_supports_ble_connection_subrating
     acl_peer_supports_ble_connection_subrating;
 struct acl_peer_supports_ble_connection_subrating_host
@@ -275,6 +276,11 @@ bool acl_peer_supports_sniff_subrating(const RawAddress& remote_bda) {
   inc_func_call_count(__func__);
   return test::mock::stack_acl::acl_peer_supports_sniff_subrating(remote_bda);
 }
+bool acl_get_traffic_stats(const RawAddress& remote_bda,
+                           tACL_TRAFFIC_STATS* p_stats) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_acl::acl_get_traffic_stats(remote_bda, p_stats);
+}
 bool acl_peer_supports_ble_connection_subrating(const RawAddress& remote_bda) {
   inc_func_call_count(__func__);
   return test::mock::stack_acl::acl_peer_supports_ble_connection_subrating(
@@ -272,6 +272,20 @@ struct acl_peer_supports_sniff_subrating {
 };
 extern struct acl_peer_supports_sniff_subrating
     acl_peer_supports_sniff_subrating;
+// Name: acl_get_traffic_stats
+// Params: const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats
+// Returns: bool
+struct acl_get_traffic_stats {
+  std::function<bool(const RawAddress& remote_bda,
+                     tACL_TRAFFIC_STATS* p_stats)>
+      body{[](const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats) {
+        return false;
+      }};
+  bool operator()(const RawAddress& remote_bda, tACL_TRAFFIC_STATS* p_stats) {
+    return body(remote_bda, p_stats);
+  };
+};
+extern struct acl_get_traffic_stats acl_get_traffic_stats;
 // Name: acl_peer_supports_ble_connection_subrating
 // Params: const RawAddress& remote_bda
 // Returns: bool
@@ -58,6 +58,7 @@ struct btm_ble_remove_resolving_list_entry btm_ble_remove_resolving_list_entry;
 struct btm_ble_clear_resolving_list btm_ble_clear_resolving_list;
 struct btm_ble_read_resolving_list_entry btm_ble_read_resolving_list_entry;
 struct btm_ble_resolving_list_load_dev btm_ble_resolving_list_load_dev;
+struct btm_ble_resolving_list_promote_dev btm_ble_resolving_list_promote_dev;
 struct btm_ble_resolving_list_remove_dev btm_ble_resolving_list_remove_dev;
 struct btm_ble_resolving_list_init btm_ble_resolving_list_init;
 
@@ -105,6 +106,9 @@ bool btm_ble_read_resolving_list_entry(tBTM_SEC_DEV_REC* p_dev_rec) {
 void btm_ble_resolving_list_load_dev(tBTM_SEC_DEV_REC& p_dev_rec) {
   inc_func_call_count(__func__);
 }
+void btm_ble_resolving_list_promote_dev(tBTM_SEC_DEV_REC& p_dev_rec) {
+  inc_func_call_count(__func__);
+}
 void btm_ble_resolving_list_remove_dev(tBTM_SEC_DEV_REC* p_dev_rec) {
   inc_func_call_count(__func__);
   test::mock::stack_btm_ble_privacy::btm_ble_resolving_list_remove_dev(
@@ -124,6 +124,16 @@ struct btm_ble_resolving_list_load_dev {
   void operator()(const tBTM_SEC_DEV_REC& p_dev_rec) { body(p_dev_rec); };
 };
 extern struct btm_ble_resolving_list_load_dev btm_ble_resolving_list_load_dev;
+// Name: btm_ble_resolving_list_promote_dev
+// Params: tBTM_SEC_DEV_REC* p_dev_rec
+// Returns: void
+struct btm_ble_resolving_list_promote_dev {
+  std::function<void(const tBTM_SEC_DEV_REC& p_dev_rec)> body{
+      [](const tBTM_SEC_DEV_REC& p_dev_rec) {}};
+  void operator()(const tBTM_SEC_DEV_REC& p_dev_rec) { body(p_dev_rec); };
+};
+extern struct btm_ble_resolving_list_promote_dev
+    btm_ble_resolving_list_promote_dev;
 // Name: btm_ble_resolving_list_remove_dev
 // Params: tBTM_SEC_DEV_REC* p_dev_rec
 // Returns: void
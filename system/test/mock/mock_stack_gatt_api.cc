@@ -47,11 +47,15 @@ struct GATTC_Discover GATTC_Discover;
 struct GATTC_ExecuteWrite GATTC_ExecuteWrite;
 struct GATTC_Read GATTC_Read;
 struct GATTC_SendHandleValueConfirm GATTC_SendHandleValueConfirm;
+struct GATTC_GetNumberOfBearers GATTC_GetNumberOfBearers;
+struct GATTC_IsReadMultipleVarLenSupported GATTC_IsReadMultipleVarLenSupported;
 struct GATTC_Write GATTC_Write;
 struct GATTS_AddService GATTS_AddService;
 struct GATTS_DeleteService GATTS_DeleteService;
 struct GATTS_HandleValueIndication GATTS_HandleValueIndication;
 struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
+struct GATTS_HandleMultipleValueNotifications
+    GATTS_HandleMultipleValueNotifications;
 struct GATTS_NVRegister GATTS_NVRegister;
 struct GATTS_SendRsp GATTS_SendRsp;
 struct GATTS_StopService GATTS_StopService;
@@ -86,11 +90,15 @@ tGATT_STATUS GATTC_Discover::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_ExecuteWrite::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Read::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_SendHandleValueConfirm::return_value = GATT_SUCCESS;
+uint8_t GATTC_GetNumberOfBearers::return_value = 1;
+bool GATTC_IsReadMultipleVarLenSupported::return_value = false;
 tGATT_STATUS GATTC_Write::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTS_AddService::return_value = GATT_SUCCESS;
 bool GATTS_DeleteService::return_value = false;
 tGATT_STATUS GATTS_HandleValueIndication::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTS_HandleValueNotification::return_value = GATT_SUCCESS;
+tGATT_STATUS GATTS_HandleMultipleValueNotifications::return_value =
+    GATT_SUCCESS;
 bool GATTS_NVRegister::return_value = false;
 tGATT_STATUS GATTS_SendRsp::return_value = GATT_SUCCESS;
 bool GATT_CancelConnect::return_value = false;
@@ -152,6 +160,15 @@ tGATT_STATUS GATTC_SendHandleValueConfirm(uint16_t conn_id, uint16_t cid) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTC_SendHandleValueConfirm(conn_id, cid);
 }
+uint8_t GATTC_GetNumberOfBearers(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTC_GetNumberOfBearers(conn_id);
+}
+bool GATTC_IsReadMultipleVarLenSupported(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTC_IsReadMultipleVarLenSupported(
+      conn_id);
+}
 tGATT_STATUS GATTC_Write(uint16_t conn_id, tGATT_WRITE_TYPE type,
                          tGATT_VALUE* p_write) {
   inc_func_call_count(__func__);
@@ -181,6 +198,12 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return test::mock::stack_gatt_api::GATTS_HandleValueNotification(
       conn_id, attr_handle, val_len, p_val);
 }
+tGATT_STATUS GATTS_HandleMultipleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTS_HandleMultipleValueNotifications(
+      conn_id, notifs);
+}
 bool GATTS_NVRegister(tGATT_APPL_INFO* p_cb_info) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTS_NVRegister(p_cb_info);
@@ -190,6 +190,29 @@ struct GATTC_SendHandleValueConfirm {
 };
 extern struct GATTC_SendHandleValueConfirm GATTC_SendHandleValueConfirm;
 
+// Name: GATTC_GetNumberOfBearers
+// Params: uint16_t conn_id
+// Return: uint8_t
+struct GATTC_GetNumberOfBearers {
+  static uint8_t return_value;
+  std::function<uint8_t(uint16_t conn_id)> body{
+      [](uint16_t conn_id) { return return_value; }};
+  uint8_t operator()(uint16_t conn_id) { return body(conn_id); };
+};
+extern struct GATTC_GetNumberOfBearers GATTC_GetNumberOfBearers;
+
+// Name: GATTC_IsReadMultipleVarLenSupported
+// Params: uint16_t conn_id
+// Return: bool
+struct GATTC_IsReadMultipleVarLenSupported {
+  static bool return_value;
+  std::function<bool(uint16_t conn_id)> body{
+      [](uint16_t conn_id) { return return_value; }};
+  bool operator()(uint16_t conn_id) { return body(conn_id); };
+};
+extern struct GATTC_IsReadMultipleVarLenSupported
+    GATTC_IsReadMultipleVarLenSupported;
+
 // Name: GATTC_Write
 // Params: uint16_t conn_id, tGATT_WRITE_TYPE type, tGATT_VALUE* p_write
 // Return: tGATT_STATUS
@@ -271,6 +294,24 @@ struct GATTS_HandleValueNotification {
 };
 extern struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
 
+// Name: GATTS_HandleMultipleValueNotifications
+// Params: uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs
+// Return: tGATT_STATUS
+struct GATTS_HandleMultipleValueNotifications {
+  static tGATT_STATUS return_value;
+  std::function<tGATT_STATUS(uint16_t conn_id,
+                             const std::vector<tGATT_VALUE>& notifs)>
+      body{[](uint16_t conn_id, const std::vector<tGATT_VALUE>& notifs) {
+        return return_value;
+      }};
+  tGATT_STATUS operator()(uint16_t conn_id,
+                          const std::vector<tGATT_VALUE>& notifs) {
+    return body(conn_id, notifs);
+  };
+};
+extern struct GATTS_HandleMultipleValueNotifications
+    GATTS_HandleMultipleValueNotifications;
+
 // Name: GATTS_NVRegister
 // Params: tGATT_APPL_INFO* p_cb_info
 // Return: bool
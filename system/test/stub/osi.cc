@@ -38,6 +38,7 @@
 #include "osi/include/log.h"
 #include "osi/include/reactor.h"
 #include "osi/include/ringbuffer.h"
+#include "osi/include/slab_allocator.h"
 #include "osi/include/socket.h"
 #include "osi/include/thread.h"
 #include "osi/include/wakelock.h"
@@ -55,6 +56,7 @@ struct StringComparison {
   }
 };
 std::map<const char*, bool, StringComparison> fake_osi_bool_props_map;
+uint32_t fake_osi_props_serial = 0;
 
 std::list<entry_t>::iterator section_t::Find(const std::string& key) {
   inc_func_call_count(__func__);
@@ -205,6 +207,18 @@ void* allocation_tracker_notify_free(UNUSED_ATTR uint8_t allocator_id,
   return nullptr;
 }
 
+void slab_allocator_init(void) { inc_func_call_count(__func__); }
+void slab_allocator_uninit(void) { inc_func_call_count(__func__); }
+void* slab_allocator_alloc(size_t size) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+bool slab_allocator_free(void* ptr) {
+  inc_func_call_count(__func__);
+  return false;
+}
+void slab_allocator_debug_dump(int fd) { inc_func_call_count(__func__); }
+
 bool reactor_change_registration(reactor_object_t* object,
                                  void (*read_ready)(void* context),
                                  void (*write_ready)(void* context)) {
@@ -611,6 +625,12 @@ bool osi_property_get_bool(const char* key, bool default_value) {
 
 void osi_property_set_bool(const char* key, bool value) {
   fake_osi_bool_props_map.insert_or_assign(key, value);
+  fake_osi_props_serial++;
+}
+
+uint32_t osi_property_get_serial(void) {
+  inc_func_call_count(__func__);
+  return fake_osi_props_serial;
 }
 
 int osi_property_get(const char* key, char* value, const char* default_value) {
@@ -24,6 +24,7 @@
 #include <mutex>
 
 #include "stack/include/bt_hdr.h"
+#include "uipc_ring.h"
 
 #define UIPC_CH_ID_AV_CTRL 0
 #define UIPC_CH_ID_AV_AUDIO 1
@@ -67,6 +68,9 @@ typedef struct {
   int read_poll_tmo_ms;
   int task_evt_flags; /* event flags pending to be processed in read task */
   tUIPC_RCV_CBACK* cback;
+  tUIPC_RING* ring; /* when set, data is read from the ring, not from fd */
+  uint32_t ring_size;
+  int ring_fd; /* memfd of the ring, until sent with UIPC_SendRing() */
 } tUIPC_CHAN;
 
 struct tUIPC_STATE {
@@ -131,6 +135,29 @@ bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint16_t msg_evt,
 uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
                    uint32_t len);
 
+/**
+ * Create a shared memory ring to receive the data of a UIPC channel, instead
+ * of the channel socket. The ring is destroyed when the channel is closed.
+ * Rings are only created when the persist.bluetooth.uipc.ring.enabled
+ * property is set.
+ *
+ * @param ch_id Channel ID
+ * @return true on success, otherwise false
+ */
+bool UIPC_OpenRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+
+/**
+ * Send the ring created with UIPC_OpenRing() to the peer of another
+ * channel, as 4 bytes of ring size with the ring file descriptor attached.
+ * The peer maps it with uipc_ring_receive().
+ *
+ * @param ch_id Channel ID to send the ring over
+ * @param ring_ch_id Channel ID of the ring
+ * @return true on success, otherwise false
+ */
+bool UIPC_SendRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                   tUIPC_CH_ID ring_ch_id);
+
 /**
  * Control the UIPC parameter
  *
@@ -0,0 +1,231 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/*****************************************************************************
+ *
+ *  Filename:      uipc_ring.h
+ *
+ *  Description:   Shared memory ring used by the audio HALs to hand PCM to
+ *                 a UIPC audio channel without going through the socket.
+ *
+ *                 The stack creates the ring in a memfd and sends it to the
+ *                 HAL over the control channel (see UIPC_SendRing()). The
+ *                 HAL is the only writer and the stack the only reader.
+ *                 |head| and |tail| count the bytes written and read modulo
+ *                 2^32; each side waits on the other side's counter with a
+ *                 futex, and is only woken when it advertised itself in
+ *                 |waiters|.
+ *
+ *                 The functions below only use the data size known locally
+ *                 by each side, never the one in the shared header.
+ *
+ *****************************************************************************/
+
+#ifndef UIPC_RING_H
+#define UIPC_RING_H
+
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#define UIPC_RING_MAGIC 0x55495247 /* "UIRG" */
+
+/* |waiters| flags */
+#define UIPC_RING_WAIT_WRITER 0x1 /* Writer waits for |tail| to change */
+#define UIPC_RING_WAIT_READER 0x2 /* Reader waits for |head| to change */
+
+typedef struct {
+  uint32_t magic;
+  uint32_t size; /* Data size, a power of 2 */
+  std::atomic<uint32_t> head;
+  std::atomic<uint32_t> tail;
+  std::atomic<uint32_t> waiters;
+  std::atomic<uint32_t> closed; /* Set by the stack when the channel closes */
+  uint8_t reserved[40];
+  /* Followed by |size| bytes of data */
+} tUIPC_RING;
+
+static_assert(sizeof(tUIPC_RING) == 64, "tUIPC_RING must be 64 bytes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "The ring counters are shared between processes");
+
+static inline size_t uipc_ring_map_size(uint32_t size) {
+  return sizeof(tUIPC_RING) + size;
+}
+
+static inline uint8_t* uipc_ring_data(tUIPC_RING* ring) {
+  return reinterpret_cast<uint8_t*>(ring + 1);
+}
+
+static inline void uipc_ring_wake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+/* Waits at most |timeout_ms| for |word| to differ from |value|, advertising
+ * |flag| to the other side meanwhile. May return early. */
+static inline void uipc_ring_wait(tUIPC_RING* ring,
+                                  std::atomic<uint32_t>* word, uint32_t value,
+                                  uint32_t flag, int timeout_ms) {
+  struct timespec ts = {.tv_sec = timeout_ms / 1000,
+                        .tv_nsec = (timeout_ms % 1000) * 1000000L};
+
+  ring->waiters.fetch_or(flag);
+  if (word->load() == value && !ring->closed.load()) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, value,
+            &ts, nullptr, 0);
+  }
+  ring->waiters.fetch_and(~flag);
+}
+
+/* Copies up to |len| bytes to the ring without waiting.
+ * Returns the number of bytes written, or -1 once the ring is closed. */
+static inline ssize_t uipc_ring_write_some(tUIPC_RING* ring, uint32_t size,
+                                           const void* p, size_t len) {
+  if (ring->closed.load()) return -1;
+
+  uint32_t head = ring->head.load(std::memory_order_relaxed);
+  uint32_t used = head - ring->tail.load(std::memory_order_acquire);
+  size_t n = std::min<size_t>(size - std::min(used, size), len);
+  if (n == 0) return 0;
+
+  uint32_t offset = head & (size - 1);
+  size_t first = std::min<size_t>(n, size - offset);
+  memcpy(uipc_ring_data(ring) + offset, p, first);
+  memcpy(uipc_ring_data(ring), static_cast<const uint8_t*>(p) + first,
+         n - first);
+
+  ring->head.store(head + n);
+  if (ring->waiters.load() & UIPC_RING_WAIT_READER) uipc_ring_wake(&ring->head);
+  return n;
+}
+
+/* Copies up to |len| bytes from the ring without waiting.
+ * Returns the number of bytes read. */
+static inline size_t uipc_ring_read_some(tUIPC_RING* ring, uint32_t size,
+                                         void* p, size_t len) {
+  uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  uint32_t used = ring->head.load(std::memory_order_acquire) - tail;
+  size_t n = std::min<size_t>(std::min(used, size), len);
+  if (n == 0) return 0;
+
+  uint32_t offset = tail & (size - 1);
+  size_t first = std::min<size_t>(n, size - offset);
+  memcpy(p, uipc_ring_data(ring) + offset, first);
+  memcpy(static_cast<uint8_t*>(p) + first, uipc_ring_data(ring), n - first);
+
+  ring->tail.store(tail + n);
+  if (ring->waiters.load() & UIPC_RING_WAIT_WRITER) uipc_ring_wake(&ring->tail);
+  return n;
+}
+
+/* Writes |len| bytes to the ring, waiting at most |timeout_ms| in total for
+ * the reader to make room. Returns the number of bytes written, which is
+ * less than |len| on timeout, or -1 once the ring is closed. */
+static inline ssize_t uipc_ring_write(tUIPC_RING* ring, uint32_t size,
+                                      const void* p, size_t len,
+                                      int timeout_ms) {
+  struct timespec start;
+  size_t count = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while (count < len) {
+    uint32_t tail = ring->tail.load();
+    ssize_t n = uipc_ring_write_some(
+        ring, size, static_cast<const uint8_t*>(p) + count, len - count);
+    if (n < 0) return -1;
+    count += n;
+    if (n > 0) continue;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
+                     (now.tv_nsec - start.tv_nsec) / 1000000;
+    if (elapsed_ms >= timeout_ms) break;
+    uipc_ring_wait(ring, &ring->tail, tail, UIPC_RING_WAIT_WRITER,
+                   timeout_ms - elapsed_ms);
+  }
+  return count;
+}
+
+/* Receives and maps a ring sent by UIPC_SendRing() on socket |fd|.
+ * Returns the ring and stores its data size in |p_size|, or returns nullptr
+ * on error. */
+static inline tUIPC_RING* uipc_ring_receive(int fd, uint32_t* p_size) {
+  uint32_t size = 0;
+  struct iovec iov = {.iov_base = &size, .iov_len = sizeof(size)};
+  union {
+    struct cmsghdr hdr;
+    char buf[CMSG_SPACE(sizeof(int))];
+  } control = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+
+  ssize_t ret;
+  do {
+    ret = recvmsg(fd, &msg, MSG_NOSIGNAL | MSG_CMSG_CLOEXEC);
+  } while (ret == -1 && errno == EINTR);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(int))) {
+    return nullptr;
+  }
+
+  int ring_fd;
+  memcpy(&ring_fd, CMSG_DATA(cmsg), sizeof(ring_fd));
+  if (ret != sizeof(size) || size == 0 || (size & (size - 1)) != 0) {
+    close(ring_fd);
+    return nullptr;
+  }
+
+  void* p = mmap(nullptr, uipc_ring_map_size(size), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, ring_fd, 0);
+  close(ring_fd);
+  if (p == MAP_FAILED) return nullptr;
+
+  tUIPC_RING* ring = static_cast<tUIPC_RING*>(p);
+  if (ring->magic != UIPC_RING_MAGIC || ring->size != size) {
+    munmap(p, uipc_ring_map_size(size));
+    return nullptr;
+  }
+
+  *p_size = size;
+  return ring;
+}
+
+static inline void uipc_ring_unmap(tUIPC_RING* ring, uint32_t size) {
+  munmap(ring, uipc_ring_map_size(size));
+}
+
+#endif /* UIPC_RING_H */
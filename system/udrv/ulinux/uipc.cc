@@ -47,6 +47,7 @@
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/socket_utils/sockets.h"
 #include "uipc.h"
 
@@ -66,6 +67,8 @@
 
 #define UIPC_FLUSH_BUFFER_SIZE 1024
 
+#define UIPC_RING_PROPERTY "persist.bluetooth.uipc.ring.enabled"
+
 /*****************************************************************************
  *  Local type definitions
  *****************************************************************************/
@@ -78,6 +81,8 @@ typedef enum {
  *  Static functions
  *****************************************************************************/
 static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+static void uipc_close_ring_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
+void uipc_close_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id);
 
 /*****************************************************************************
  *  Externs
@@ -200,6 +205,9 @@ static int uipc_main_init(tUIPC_STATE& uipc) {
     p->fd = UIPC_DISCONNECTED;
     p->task_evt_flags = 0;
     p->cback = NULL;
+    p->ring = NULL;
+    p->ring_size = 0;
+    p->ring_fd = UIPC_DISCONNECTED;
   }
 
   return 0;
@@ -245,6 +253,9 @@ static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
       uipc.ch[ch_id].fd = UIPC_DISCONNECTED;
     }
 
+    // A new peer starts on the socket until it asks for a ring
+    uipc_close_ring_locked(uipc, ch_id);
+
     uipc.ch[ch_id].fd = accept_server_socket(uipc.ch[ch_id].srvfd);
 
     LOG_DEBUG("NEW FD %d", uipc.ch[ch_id].fd);
@@ -331,6 +342,13 @@ static void uipc_flush_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     return;
   }
 
+  if (uipc.ch[ch_id].ring != NULL) {
+    while (uipc_ring_read_some(uipc.ch[ch_id].ring, uipc.ch[ch_id].ring_size,
+                               buf, UIPC_FLUSH_BUFFER_SIZE) > 0) {
+    }
+    return;
+  }
+
   while (1) {
     int ret;
     OSI_NO_INTR(ret = poll(&pfd, 1, 1));
@@ -370,6 +388,72 @@ static void uipc_flush_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   }
 }
 
+static void uipc_close_ring_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+
+  if (p->ring_fd != UIPC_DISCONNECTED) {
+    close(p->ring_fd);
+    p->ring_fd = UIPC_DISCONNECTED;
+  }
+
+  if (p->ring == NULL) return;
+
+  LOG_DEBUG("CLOSE RING ON CH %d", ch_id);
+
+  /* unblock the peer, which disconnects on the closed flag */
+  p->ring->closed.store(1);
+  uipc_ring_wake(&p->ring->head);
+  uipc_ring_wake(&p->ring->tail);
+
+  uipc_ring_unmap(p->ring, p->ring_size);
+  p->ring = NULL;
+  p->ring_size = 0;
+}
+
+static uint32_t uipc_read_ring_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                                      uint8_t* p_buf, uint32_t len) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  struct pollfd pfd;
+
+  /* data only goes through the ring, the socket is left to report the
+     remote detach */
+  pfd.fd = p->fd;
+  pfd.events = POLLHUP;
+  pfd.revents = 0;
+
+  int poll_ret;
+  OSI_NO_INTR(poll_ret = poll(&pfd, 1, 0));
+  if (poll_ret > 0 && (pfd.revents & (POLLHUP | POLLNVAL))) {
+    LOG_WARN("poll : channel detached remotely");
+    uipc_close_locked(uipc, ch_id);
+    return 0;
+  }
+
+  /* wait for the remaining data like the socket read does; the channel lock
+     is held meanwhile so that the ring can't be unmapped */
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  uint32_t n_read = 0;
+  while (true) {
+    uint32_t head = p->ring->head.load();
+    n_read += uipc_ring_read_some(p->ring, p->ring_size, p_buf + n_read,
+                                  len - n_read);
+    if (n_read == len) break;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int elapsed_ms = (now.tv_sec - start.tv_sec) * 1000 +
+                     (now.tv_nsec - start.tv_nsec) / 1000000;
+    if (elapsed_ms >= p->read_poll_tmo_ms) break;
+
+    uipc_ring_wait(p->ring, &p->ring->head, head, UIPC_RING_WAIT_READER,
+                   p->read_poll_tmo_ms - elapsed_ms);
+  }
+
+  return n_read;
+}
+
 static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   int wakeup = 0;
 
@@ -393,6 +477,8 @@ static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     wakeup = 1;
   }
 
+  uipc_close_ring_locked(uipc, ch_id);
+
   /* notify this connection is closed */
   if (uipc.ch[ch_id].cback) uipc.ch[ch_id].cback(ch_id, UIPC_CLOSE_EVT);
 
@@ -620,6 +706,13 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
     return 0;
   }
 
+  {
+    std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+    if (uipc.ch[ch_id].ring != NULL) {
+      return uipc_read_ring_locked(uipc, ch_id, p_buf, len);
+    }
+  }
+
   while (n_read < (int)len) {
     pfd.fd = fd;
     pfd.events = POLLIN | POLLHUP;
@@ -667,6 +760,125 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
   return n_read;
 }
 
+/*******************************************************************************
+ *
+ * Function         UIPC_OpenRing
+ *
+ * Description      Called to receive the data of a channel in a shared memory
+ *                  ring instead of the channel socket.
+ *
+ * Returns          true in case of success, false in case of failure.
+ *
+ ******************************************************************************/
+
+bool UIPC_OpenRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
+  LOG_DEBUG("UIPC_OpenRing : ch_id %d", ch_id);
+
+  if (ch_id >= UIPC_CH_NUM) return false;
+
+  if (!osi_property_get_bool(UIPC_RING_PROPERTY, false)) {
+    LOG_DEBUG("UIPC_OpenRing : rings are disabled");
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+
+  if (uipc.ch[ch_id].srvfd == UIPC_DISCONNECTED) {
+    LOG_ERROR("UIPC_OpenRing : channel %d closed", ch_id);
+    return false;
+  }
+
+  uipc_close_ring_locked(uipc, ch_id);
+
+  /* match the capacity of the socket buffer */
+  uint32_t size = 1;
+  while (size < AUDIO_STREAM_OUTPUT_BUFFER_SZ) size <<= 1;
+
+  int fd = memfd_create("uipc_ring", MFD_CLOEXEC);
+  if (fd < 0 || ftruncate(fd, uipc_ring_map_size(size)) < 0) {
+    LOG_ERROR("UIPC_OpenRing : failed to create ring (%s)", strerror(errno));
+    if (fd >= 0) close(fd);
+    return false;
+  }
+
+  void* p = mmap(NULL, uipc_ring_map_size(size), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    LOG_ERROR("UIPC_OpenRing : failed to map ring (%s)", strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  tUIPC_RING* ring = static_cast<tUIPC_RING*>(p);
+  ring->magic = UIPC_RING_MAGIC;
+  ring->size = size;
+
+  uipc.ch[ch_id].ring = ring;
+  uipc.ch[ch_id].ring_size = size;
+  uipc.ch[ch_id].ring_fd = fd;
+
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         UIPC_SendRing
+ *
+ * Description      Called to send the ring of a channel to the peer of
+ *                  another channel.
+ *
+ * Returns          true in case of success, false in case of failure.
+ *
+ ******************************************************************************/
+
+bool UIPC_SendRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                   tUIPC_CH_ID ring_ch_id) {
+  LOG_DEBUG("UIPC_SendRing : ch_id %d ring_ch_id %d", ch_id, ring_ch_id);
+
+  if (ch_id >= UIPC_CH_NUM || ring_ch_id >= UIPC_CH_NUM) return false;
+
+  std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+
+  tUIPC_CHAN* ring_ch = &uipc.ch[ring_ch_id];
+  if (ring_ch->ring_fd == UIPC_DISCONNECTED) {
+    LOG_ERROR("UIPC_SendRing : no ring to send on channel %d", ring_ch_id);
+    return false;
+  }
+
+  uint32_t size = ring_ch->ring_size;
+  struct iovec iov = {.iov_base = &size, .iov_len = sizeof(size)};
+  union {
+    struct cmsghdr hdr;
+    char buf[CMSG_SPACE(sizeof(int))];
+  } control = {};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &ring_ch->ring_fd, sizeof(int));
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = sendmsg(uipc.ch[ch_id].fd, &msg, MSG_NOSIGNAL));
+
+  /* the peer holds its own reference from now on */
+  close(ring_ch->ring_fd);
+  ring_ch->ring_fd = UIPC_DISCONNECTED;
+
+  if (ret != (ssize_t)sizeof(size)) {
+    LOG_ERROR("UIPC_SendRing : failed to send ring (%s)", strerror(errno));
+    uipc_close_ring_locked(uipc, ring_ch_id);
+    return false;
+  }
+
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         UIPC_Ioctl
@@ -59,6 +59,10 @@ void Beacon::Tick() {
   }
 }
 
+std::chrono::steady_clock::time_point Beacon::GetNextTickTime() const {
+  return advertising_last_ + advertising_interval_;
+}
+
 void Beacon::ReceiveLinkLayerPacket(LinkLayerPacketView packet,
                                     Phy::Type /*type*/, int8_t /*rssi*/) {
   if (packet.GetDestinationAddress() == address_ &&
@@ -39,6 +39,8 @@ class Beacon : public Device {
   virtual std::string GetTypeString() const override { return "beacon"; }
 
   virtual void Tick() override;
+  virtual std::chrono::steady_clock::time_point GetNextTickTime()
+      const override;
   virtual void ReceiveLinkLayerPacket(
       model::packets::LinkLayerPacketView packet, Phy::Type type,
       int8_t rssi) override;
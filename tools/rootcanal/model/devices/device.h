@@ -50,6 +50,12 @@ class Device {
   const Address& GetAddress() const { return address_; }
 
   virtual void Tick() {}
+
+  // Time at which Tick() next has work to do. Devices that don't know
+  // are ticked on every period of the test model timer.
+  virtual std::chrono::steady_clock::time_point GetNextTickTime() const {
+    return {};
+  }
   virtual void Close();
 
   virtual void ReceiveLinkLayerPacket(
@@ -47,6 +47,10 @@ class ScriptedBeacon : public Beacon {
   }
 
   void Tick() override;
+  // The playback state machine has work to do on every tick.
+  std::chrono::steady_clock::time_point GetNextTickTime() const override {
+    return {};
+  }
   void ReceiveLinkLayerPacket(model::packets::LinkLayerPacketView packet_view,
                               Phy::Type type, int8_t rssi) override;
 
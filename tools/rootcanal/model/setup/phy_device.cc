@@ -35,6 +35,10 @@ void PhyDevice::Unregister(PhyLayer* phy) { phy_layers_.erase(phy); }
 
 void PhyDevice::Tick() { device_->Tick(); }
 
+std::chrono::steady_clock::time_point PhyDevice::GetNextTickTime() const {
+  return device_->GetNextTickTime();
+}
+
 void PhyDevice::SetAddress(bluetooth::hci::Address address) {
   device_->SetAddress(std::move(address));
 }
@@ -54,8 +58,17 @@ void PhyDevice::Receive(std::vector<uint8_t> const& packet, Phy::Type type,
   }
 }
 
+void PhyDevice::Receive(model::packets::LinkLayerPacketView const& packet,
+                        Phy::Type type, int8_t rssi) {
+  device_->ReceiveLinkLayerPacket(packet, type, rssi);
+}
+
 void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
                      int8_t tx_power) {
+  if (defer_send_) {
+    deferred_packets_.push_back(DeferredPacket{packet, type, tx_power});
+    return;
+  }
   for (auto const& phy : phy_layers_) {
     if (phy->type == type) {
       phy->Send(packet, tx_power, id);
@@ -63,6 +76,15 @@ void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
   }
 }
 
+void PhyDevice::FlushDeferredPackets() {
+  defer_send_ = false;
+  std::vector<DeferredPacket> deferred_packets;
+  deferred_packets.swap(deferred_packets_);
+  for (auto const& deferred : deferred_packets) {
+    Send(deferred.packet, deferred.type, deferred.tx_power);
+  }
+}
+
 std::string PhyDevice::ToString() { return device_->ToString(); }
 
 }  // namespace rootcanal
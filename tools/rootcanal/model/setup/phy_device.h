@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 #include "model/devices/device.h"
 #include "phy.h"
@@ -39,10 +41,19 @@ class PhyDevice {
   void Unregister(PhyLayer* phy);
 
   void Tick();
+  std::chrono::steady_clock::time_point GetNextTickTime() const;
   void Receive(std::vector<uint8_t> const& packet, Phy::Type type, int8_t rssi);
+  void Receive(model::packets::LinkLayerPacketView const& packet,
+               Phy::Type type, int8_t rssi);
   void Send(std::vector<uint8_t> const& packet, Phy::Type type,
             int8_t tx_power);
 
+  // While deferring, packets sent by the device are held back until
+  // FlushDeferredPackets() sends them in order. Lets the device tick
+  // on another thread without reaching into the other devices.
+  void DeferSend() { defer_send_ = true; }
+  void FlushDeferredPackets();
+
   void SetAddress(bluetooth::hci::Address address);
   std::string ToString();
 
@@ -53,6 +64,14 @@ class PhyDevice {
  private:
   const std::shared_ptr<Device> device_;
   std::unordered_set<PhyLayer*> phy_layers_;
+
+  struct DeferredPacket {
+    std::vector<uint8_t> packet;
+    Phy::Type type;
+    int8_t tx_power;
+  };
+  bool defer_send_{false};
+  std::vector<DeferredPacket> deferred_packets_;
 };
 
 }  // namespace rootcanal
@@ -18,6 +18,8 @@
 
 #include <sstream>
 
+#include "log.h"
+
 namespace rootcanal {
 
 PhyLayer::PhyLayer(Identifier id, Phy::Type type) : id(id), type(type) {}
@@ -57,10 +59,20 @@ int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier sender_id,
 
 void PhyLayer::Send(std::vector<uint8_t> const& packet, int8_t tx_power,
                     PhyDevice::Identifier sender_id) {
+  // Copy and parse the packet once, all receivers share the same payload.
+  model::packets::LinkLayerPacketView packet_view =
+      model::packets::LinkLayerPacketView::Create(
+          bluetooth::packet::PacketView<bluetooth::packet::kLittleEndian>(
+              std::make_shared<std::vector<uint8_t>>(packet)));
+  if (!packet_view.IsValid()) {
+    LOG_WARN("dropping invalid LL packet from device %u", sender_id);
+    return;
+  }
+
   for (const auto& device : phy_devices_) {
     // Do not send the packet back to the sender.
     if (sender_id != device->id) {
-      device->Receive(packet, type,
+      device->Receive(packet_view, type,
                       ComputeRssi(sender_id, device->id, tx_power));
     }
   }
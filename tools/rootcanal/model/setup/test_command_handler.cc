@@ -46,6 +46,7 @@ TestCommandHandler::TestCommandHandler(TestModel& test_model)
   SET_HANDLER("list", List);
   SET_HANDLER("set_device_address", SetDeviceAddress);
   SET_HANDLER("set_timer_period", SetTimerPeriod);
+  SET_HANDLER("set_tick_workers", SetTickWorkers);
   SET_HANDLER("start_timer", StartTimer);
   SET_HANDLER("stop_timer", StopTimer);
   SET_HANDLER("reset", Reset);
@@ -252,6 +253,23 @@ void TestCommandHandler::SetTimerPeriod(const vector<std::string>& args) {
   send_response_(response_string_);
 }
 
+void TestCommandHandler::SetTickWorkers(const vector<std::string>& args) {
+  if (args.size() != 1) {
+    LOG_INFO("SetTickWorkers takes 1 argument");
+    return;
+  }
+  size_t workers = std::stoi(args[0]);
+  if (workers != 0) {
+    response_string_ = "set tick workers to ";
+    response_string_ += args[0];
+    model_.SetTickWorkers(workers);
+  } else {
+    response_string_ = "invalid tick workers ";
+    response_string_ += args[0];
+  }
+  send_response_(response_string_);
+}
+
 void TestCommandHandler::StartTimer(const vector<std::string>& args) {
   if (!args.empty()) {
     LOG_INFO("Unused args: arg[0] = %s", args[0].c_str());
@@ -75,6 +75,8 @@ class TestCommandHandler {
   // Timer management functions
   void SetTimerPeriod(const std::vector<std::string>& args);
 
+  void SetTickWorkers(const std::vector<std::string>& args);
+
   void StartTimer(const std::vector<std::string>& args);
 
   void StopTimer(const std::vector<std::string>& args);
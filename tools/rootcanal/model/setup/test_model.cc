@@ -18,6 +18,8 @@
 
 #include <stdlib.h>  // for size_t
 
+#include <algorithm>    // for max, min
+#include <future>       // for async, future
 #include <iomanip>      // for operator<<, setfill
 #include <iostream>     // for basic_ostream
 #include <memory>       // for shared_ptr, make...
@@ -259,9 +261,47 @@ const std::string& TestModel::List() {
   return list_string_;
 }
 
+void TestModel::SetTickWorkers(size_t workers) {
+  tick_workers_ = std::max<size_t>(workers, 1);
+}
+
 void TestModel::Tick() {
+  // Only tick the devices with work due, most beacons are idle between
+  // two advertising events.
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::vector<PhyDevice*> due_devices;
   for (auto& [_, device] : phy_devices_) {
-    device->Tick();
+    if (device->GetNextTickTime() <= now) {
+      due_devices.push_back(device.get());
+    }
+  }
+
+  size_t workers = std::min(tick_workers_, due_devices.size());
+  if (workers <= 1) {
+    for (auto* device : due_devices) {
+      device->Tick();
+    }
+    return;
+  }
+
+  // The devices only interact through the packets they send, which are
+  // held back until every worker is done with its shard.
+  for (auto* device : due_devices) {
+    device->DeferSend();
+  }
+  std::vector<std::future<void>> shards;
+  for (size_t worker = 0; worker < workers; worker++) {
+    shards.push_back(std::async(std::launch::async, [&, worker]() {
+      for (size_t i = worker; i < due_devices.size(); i += workers) {
+        due_devices[i]->Tick();
+      }
+    }));
+  }
+  for (auto& shard : shards) {
+    shard.wait();
+  }
+  for (auto* device : due_devices) {
+    device->FlushDeferredPackets();
   }
 }
 
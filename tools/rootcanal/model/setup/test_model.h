@@ -103,6 +103,11 @@ class TestModel {
   void StopTimer();
   void SetTimerPeriod(std::chrono::milliseconds new_period);
 
+  // Tick the devices on up to |workers| threads. Packets sent from the
+  // ticks are delivered once all the workers are done, in device order,
+  // so the simulation stays deterministic. 1 ticks on the timer thread.
+  void SetTickWorkers(size_t workers);
+
   // List the devices that the test knows about
   const std::string& List();
 
@@ -138,6 +143,7 @@ class TestModel {
   AsyncUserId model_user_id_;
   AsyncTaskId timer_tick_task_{kInvalidTaskId};
   std::chrono::milliseconds timer_period_{};
+  size_t tick_workers_{1};
 };
 
 }  // namespace rootcanal
@@ -225,6 +225,11 @@ class TestChannelShell(cmd.Cmd):
     """
         self._test_channel.send_command('set_timer_period', args.split())
 
+    def do_set_tick_workers(self, args):
+        """Arguments: workers Tick the devices on up to that many threads.
+    """
+        self._test_channel.send_command('set_tick_workers', args.split())
+
     def do_start_timer(self, args):
         """Arguments: None. Start the timer.
     """
@@ -0,0 +1,255 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput of the controller model, driven the way the HCI transport and
+// the PHY layers drive it. Each benchmark reports the packets handled per
+// second and the CPU time spent per packet.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "model/controller/dual_mode_controller.h"
+#include "model/setup/phy_device.h"
+#include "model/setup/phy_layer.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+namespace rootcanal {
+namespace {
+
+using namespace bluetooth::hci;
+
+std::shared_ptr<std::vector<uint8_t>> Serialize(
+    std::unique_ptr<bluetooth::packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet->size());
+  bluetooth::packet::BitInserter inserter(*bytes);
+  packet->Serialize(inserter);
+  return bytes;
+}
+
+void ReportPackets(benchmark::State& state, size_t packets) {
+  state.counters["packets"] =
+      benchmark::Counter(packets, benchmark::Counter::kIsRate);
+  state.counters["cpu_per_packet"] = benchmark::Counter(
+      packets, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// A controller with the HCI channels of its host connected to counters.
+struct Host {
+  explicit Host(PhyDevice::Identifier id, Address address)
+      : controller(std::make_shared<DualModeController>()),
+        phy_device(std::make_shared<PhyDevice>(id, "controller", controller)) {
+    controller->SetAddress(address);
+    controller->RegisterEventChannel(
+        [this](std::shared_ptr<std::vector<uint8_t>> event) {
+          OnEvent(std::move(event));
+        });
+    controller->RegisterAclChannel(
+        [this](std::shared_ptr<std::vector<uint8_t>>) { acl_packets++; });
+    controller->RegisterScoChannel([](std::shared_ptr<std::vector<uint8_t>>) {
+    });
+    controller->RegisterIsoChannel([](std::shared_ptr<std::vector<uint8_t>>) {
+    });
+  }
+
+  void OnEvent(std::shared_ptr<std::vector<uint8_t>> bytes) {
+    events++;
+    auto event = EventView::Create(PacketView<kLittleEndian>(bytes));
+    switch (event.GetEventCode()) {
+      case EventCode::CONNECTION_REQUEST: {
+        auto request = ConnectionRequestView::Create(event);
+        if (request.IsValid()) {
+          pending_commands.push_back(
+              Serialize(AcceptConnectionRequestBuilder::Create(
+                  request.GetBdAddr(),
+                  AcceptConnectionRequestRole::REMAIN_PERIPHERAL)));
+        }
+        break;
+      }
+      case EventCode::CONNECTION_COMPLETE: {
+        auto complete = ConnectionCompleteView::Create(event);
+        if (complete.IsValid() && complete.GetStatus() == ErrorCode::SUCCESS) {
+          connection_handle = complete.GetConnectionHandle();
+        }
+        break;
+      }
+      case EventCode::LE_META_EVENT: {
+        auto meta = LeMetaEventView::Create(event);
+        if (meta.IsValid() &&
+            meta.GetSubeventCode() == SubeventCode::ADVERTISING_REPORT) {
+          advertising_reports++;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  // Commands the host queued in response to events, run on the next tick
+  // so that the controller is not re-entered from its own event callback.
+  void Tick() {
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> commands;
+    commands.swap(pending_commands);
+    for (auto& command : commands) {
+      controller->HandleCommand(command);
+    }
+    controller->Tick();
+  }
+
+  std::shared_ptr<DualModeController> controller;
+  std::shared_ptr<PhyDevice> phy_device;
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> pending_commands;
+  std::optional<uint16_t> connection_handle;
+  size_t events{0};
+  size_t acl_packets{0};
+  size_t advertising_reports{0};
+};
+
+Address MakeAddress(uint32_t index) {
+  return Address(std::array<uint8_t, Address::kLength>{
+      static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8),
+      static_cast<uint8_t>(index >> 16), 0xbe, 0xbe, 0xda});
+}
+
+// Command dispatch and completion, with a cheap and a parameter-heavy
+// command.
+void BM_HandleCommand(benchmark::State& state) {
+  Host host(0, MakeAddress(0));
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> commands = {
+      Serialize(ReadBdAddrBuilder::Create()),
+      Serialize(LeSetAdvertisingDataRawBuilder::Create(
+          std::vector<uint8_t>(31, 0x42))),
+  };
+  size_t packets = 0;
+  for (auto _ : state) {
+    for (auto& command : commands) {
+      host.controller->HandleCommand(command);
+    }
+    packets += commands.size();
+  }
+  ReportPackets(state, packets);
+}
+BENCHMARK(BM_HandleCommand);
+
+// ACL forwarding between N pairs of controllers connected over a shared
+// BR/EDR PHY: HandleAcl on the sender, the link layer packet through the
+// PHY and the ACL packet out of the receiver.
+void BM_AclForwarding(benchmark::State& state) {
+  const size_t pairs = state.range(0);
+  PhyLayer phy(0, Phy::Type::BR_EDR);
+  std::vector<std::unique_ptr<Host>> centrals;
+  std::vector<std::unique_ptr<Host>> peripherals;
+  for (size_t i = 0; i < pairs; i++) {
+    centrals.push_back(std::make_unique<Host>(2 * i, MakeAddress(2 * i)));
+    peripherals.push_back(
+        std::make_unique<Host>(2 * i + 1, MakeAddress(2 * i + 1)));
+    phy.Register(centrals.back()->phy_device);
+    phy.Register(peripherals.back()->phy_device);
+    centrals.back()->controller->HandleCommand(
+        Serialize(CreateConnectionBuilder::Create(
+            MakeAddress(2 * i + 1), 0xcc18, PageScanRepetitionMode::R1, 0,
+            ClockOffsetValid::INVALID,
+            CreateConnectionRoleSwitch::REMAIN_CENTRAL)));
+  }
+
+  // Page and accept the connections.
+  for (int tick = 0; tick < 100; tick++) {
+    for (size_t i = 0; i < pairs; i++) {
+      centrals[i]->Tick();
+      peripherals[i]->Tick();
+    }
+  }
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> acl_packets;
+  for (size_t i = 0; i < pairs; i++) {
+    if (!centrals[i]->connection_handle.has_value() ||
+        !peripherals[i]->connection_handle.has_value()) {
+      state.SkipWithError("connection setup failed");
+      return;
+    }
+    acl_packets.push_back(Serialize(AclBuilder::Create(
+        *centrals[i]->connection_handle,
+        PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+        BroadcastFlag::POINT_TO_POINT,
+        std::make_unique<bluetooth::packet::RawBuilder>(
+            std::vector<uint8_t>(state.range(1), 0x42)))));
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < pairs; i++) {
+      centrals[i]->controller->HandleAcl(acl_packets[i]);
+      centrals[i]->Tick();
+      peripherals[i]->Tick();
+    }
+  }
+
+  size_t packets = 0;
+  for (auto& peripheral : peripherals) {
+    packets += peripheral->acl_packets;
+  }
+  ReportPackets(state, packets);
+}
+BENCHMARK(BM_AclForwarding)
+    ->ArgsProduct({{1, 8, 64}, {27, 1021}})
+    ->ArgNames({"pairs", "size"});
+
+// A scanner receiving the advertisements of N advertisers through the LE
+// PHY and reporting them to its host.
+void BM_AdvertisingReports(benchmark::State& state) {
+  const size_t advertisers = state.range(0);
+  PhyLayer phy(0, Phy::Type::LOW_ENERGY);
+  Host scanner(0, MakeAddress(0));
+  phy.Register(scanner.phy_device);
+  scanner.controller->HandleCommand(
+      Serialize(LeSetScanParametersBuilder::Create(
+          LeScanType::PASSIVE, 0x10, 0x10,
+          OwnAddressType::PUBLIC_DEVICE_ADDRESS,
+          LeScanningFilterPolicy::ACCEPT_ALL)));
+  scanner.controller->HandleCommand(Serialize(
+      LeSetScanEnableBuilder::Create(Enable::ENABLED, Enable::DISABLED)));
+
+  std::vector<std::vector<uint8_t>> advertisements;
+  for (size_t i = 1; i <= advertisers; i++) {
+    auto advertisement = Serialize(
+        model::packets::LeLegacyAdvertisingPduBuilder::Create(
+            MakeAddress(i), Address::kEmpty,
+            model::packets::AddressType::PUBLIC,
+            model::packets::AddressType::PUBLIC,
+            model::packets::LegacyAdvertisingType::ADV_NONCONN_IND,
+            std::vector<uint8_t>(31, static_cast<uint8_t>(i))));
+    advertisements.push_back(*advertisement);
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < advertisers; i++) {
+      phy.Send(advertisements[i], 0, i + 1);
+    }
+    scanner.Tick();
+  }
+  ReportPackets(state, scanner.advertising_reports);
+}
+BENCHMARK(BM_AdvertisingReports)->Arg(1)->Arg(64)->Arg(512)->ArgName(
+    "advertisers");
+
+}  // namespace
+}  // namespace rootcanal
+
+BENCHMARK_MAIN();